@@ -302,6 +302,46 @@ fdb_error_t fdb_future_get_keyvalue_array_v13(FDBFuture* f, FDBKeyValue const**
 	                 *out_count = rrr.size(););
 }
 
+static uint8_t* writeKeyValueBlockRef(uint8_t* out, StringRef s) {
+	uint32_t length = s.size();
+	for (int i = 0; i < 4; i++) {
+		*out++ = (length >> (8 * i)) & 0xff;
+	}
+	memcpy(out, s.begin(), s.size());
+	return out + s.size();
+}
+
+// Writes the block of fdb_future_get_keyvalue_block for rrr to block, if it is large enough, and returns its length
+static int getKeyValueBlock(RangeResultRef const& rrr, uint8_t* block, int blockLength) {
+	int64_t length = 0;
+	for (const auto& kv : rrr) {
+		length += 8 + kv.key.size() + kv.value.size();
+	}
+	if (length > std::numeric_limits<int>::max() || (block && blockLength < length)) {
+		throw client_invalid_operation();
+	}
+
+	if (block) {
+		for (const auto& kv : rrr) {
+			block = writeKeyValueBlockRef(block, kv.key);
+			block = writeKeyValueBlockRef(block, kv.value);
+		}
+	}
+	return length;
+}
+
+extern "C" DLLEXPORT fdb_error_t fdb_future_get_keyvalue_block(FDBFuture* f,
+                                                               uint8_t* block,
+                                                               int block_length,
+                                                               int* out_block_length,
+                                                               int* out_count,
+                                                               fdb_bool_t* out_more) {
+	CATCH_AND_RETURN(Standalone<RangeResultRef> rrr = TSAV(Standalone<RangeResultRef>, f)->get();
+	                 *out_block_length = getKeyValueBlock(rrr, block, block_length);
+	                 *out_count = rrr.size();
+	                 *out_more = rrr.more;);
+}
+
 extern "C" DLLEXPORT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDBFuture* f,
                                                                      FDBMappedKeyValue const** out_kvm,
                                                                      int* out_count,
@@ -800,6 +840,14 @@ extern "C" DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_database_get_client_statu
 	return (FDBFuture*)(DB(db)->getClientStatus().extractPtr());
 }
 
+extern "C" DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_database_get_metrics(FDBDatabase* db) {
+	return (FDBFuture*)(DB(db)->getMetrics().extractPtr());
+}
+
+extern "C" DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_database_get_transaction_profiles(FDBDatabase* db) {
+	return (FDBFuture*)(DB(db)->getTransactionProfiles().extractPtr());
+}
+
 extern "C" DLLEXPORT fdb_error_t fdb_tenant_create_transaction(FDBTenant* tenant, FDBTransaction** out_transaction) {
 	CATCH_AND_RETURN(*out_transaction = (FDBTransaction*)TENANT(tenant)->createTransaction().extractPtr(););
 }
@@ -968,6 +1016,43 @@ FDBFuture* fdb_transaction_get_key_v13(FDBTransaction* tr,
 	return fdb_transaction_get_key_impl(tr, key_name, key_name_length, or_equal, offset, false);
 }
 
+extern "C" DLLEXPORT FDBFuture* fdb_transaction_get_multi(FDBTransaction* tr,
+                                                          uint8_t const* const* key_names,
+                                                          int const* key_name_lengths,
+                                                          int count,
+                                                          fdb_bool_t snapshot) {
+	if (count < 0)
+		return TSAV_ERROR(Standalone<RangeResultRef>, client_invalid_operation);
+	std::vector<KeyRef> keys;
+	keys.reserve(count);
+	for (int i = 0; i < count; i++) {
+		keys.emplace_back(key_names[i], key_name_lengths[i]);
+	}
+	return (FDBFuture*)(TXN(tr)->getMulti(VectorRef<KeyRef>(keys.data(), keys.size()), snapshot).extractPtr());
+}
+
+extern "C" DLLEXPORT FDBFuture* fdb_transaction_batch(FDBTransaction* tr,
+                                                      FDBBatchOperation const* operations,
+                                                      int count,
+                                                      fdb_bool_t snapshot) {
+	if (count < 0)
+		return TSAV_ERROR(Standalone<RangeResultRef>, client_invalid_operation);
+	std::vector<BatchOperationRef> ops;
+	ops.reserve(count);
+	for (int i = 0; i < count; i++) {
+		FDBBatchOperation const& op = operations[i];
+		if (op.type < 0 || op.type > BatchOperationRef::MAX_TYPE)
+			return TSAV_ERROR(Standalone<RangeResultRef>, client_invalid_operation);
+		// param is not looked at, and so may not be set, for reads and single key clears
+		bool hasParam = op.type != FDB_BATCH_OPERATION_GET && op.type != FDB_BATCH_OPERATION_CLEAR;
+		ops.emplace_back((BatchOperationRef::Type)op.type,
+		                 KeyRef(op.key, op.key_length),
+		                 hasParam ? ValueRef(op.param, op.param_length) : ValueRef(),
+		                 (FDBMutationTypes::Option)op.operation_type);
+	}
+	return (FDBFuture*)(TXN(tr)->batch(VectorRef<BatchOperationRef>(ops.data(), ops.size()), snapshot).extractPtr());
+}
+
 extern "C" DLLEXPORT FDBFuture* fdb_transaction_get_addresses_for_key(FDBTransaction* tr,
                                                                       uint8_t const* key_name,
                                                                       int key_name_length) {
@@ -1093,6 +1178,77 @@ extern "C" DLLEXPORT FDBFuture* fdb_transaction_get_mapped_range(FDBTransaction*
 	                    .extractPtr());
 }
 
+// The future of a chunk of a range stream. It holds the stream, so that fdb_future_get_next_chunk can request the
+// stream's next chunk from it.
+class RangeStreamChunkVar final : public ThreadSingleAssignmentVar<RangeResult>, ThreadCallback {
+public:
+	explicit RangeStreamChunkVar(Reference<IRangeStream> stream) : stream(stream), source(stream->next()) {
+		ThreadSingleAssignmentVar<RangeResult>::addref();
+
+		int userParam;
+		source.callOrSetAsCallback(this, userParam, 0);
+	}
+
+	void cancel() override {
+		// Break the cyclic reference between this and the source future
+		if (source.clearCallback(this)) {
+			ThreadSingleAssignmentVar<RangeResult>::sendError(operation_cancelled());
+			ThreadSingleAssignmentVar<RangeResult>::delref();
+		}
+		source.getPtr()->addref(); // Cancel will delref the source future, but we don't want
+		                           // to destroy it until this callback gets destroyed
+		source.getPtr()->cancel();
+		ThreadSingleAssignmentVar<RangeResult>::cancel();
+	}
+
+	void cleanupUnsafe() override {
+		source.getPtr()->releaseMemory();
+		ThreadSingleAssignmentVar<RangeResult>::cleanupUnsafe();
+	}
+
+	bool canFire(int notMadeActive) const override { return true; }
+
+	void fire(const Void& unused, int& userParam) override {
+		ThreadSingleAssignmentVar<RangeResult>::send(source.get());
+		ThreadSingleAssignmentVar<RangeResult>::delref();
+	}
+
+	void error(const Error& e, int& userParam) override {
+		ThreadSingleAssignmentVar<RangeResult>::sendError(source.getError());
+		ThreadSingleAssignmentVar<RangeResult>::delref();
+	}
+
+	const Reference<IRangeStream> stream;
+
+private:
+	ThreadFuture<RangeResult> source;
+};
+
+extern "C" DLLEXPORT FDBFuture* fdb_transaction_get_range_stream(FDBTransaction* tr,
+                                                                 uint8_t const* begin_key_name,
+                                                                 int begin_key_name_length,
+                                                                 fdb_bool_t begin_or_equal,
+                                                                 int begin_offset,
+                                                                 uint8_t const* end_key_name,
+                                                                 int end_key_name_length,
+                                                                 fdb_bool_t end_or_equal,
+                                                                 int end_offset,
+                                                                 fdb_bool_t snapshot) {
+	Reference<IRangeStream> stream = TXN(tr)->getRangeStream(
+	    KeySelectorRef(KeyRef(begin_key_name, begin_key_name_length), begin_or_equal, begin_offset),
+	    KeySelectorRef(KeyRef(end_key_name, end_key_name_length), end_or_equal, end_offset),
+	    snapshot);
+	return (FDBFuture*)(ThreadFuture<RangeResult>(new RangeStreamChunkVar(stream)).extractPtr());
+}
+
+extern "C" DLLEXPORT FDBFuture* fdb_future_get_next_chunk(FDBFuture* f) {
+	auto chunk = dynamic_cast<RangeStreamChunkVar*>(TSAVB(f));
+	if (!chunk || !chunk->isReady() || chunk->isError() || !chunk->get().more) {
+		return TSAV_ERROR(RangeResult, client_invalid_operation);
+	}
+	return (FDBFuture*)(ThreadFuture<RangeResult>(new RangeStreamChunkVar(chunk->stream)).extractPtr());
+}
+
 FDBFuture* fdb_transaction_get_range_selector_v13(FDBTransaction* tr,
                                                   uint8_t const* begin_key_name,
                                                   int begin_key_name_length,
@@ -1170,6 +1326,18 @@ extern "C" DLLEXPORT FDBFuture* fdb_transaction_watch(FDBTransaction* tr,
 	return (FDBFuture*)(TXN(tr)->watch(KeyRef(key_name, key_name_length)).extractPtr());
 }
 
+extern "C" DLLEXPORT FDBFuture* fdb_transaction_watch_range(FDBTransaction* tr,
+                                                            uint8_t const* begin_key_name,
+                                                            int begin_key_name_length,
+                                                            uint8_t const* end_key_name,
+                                                            int end_key_name_length) {
+	KeyRef begin(begin_key_name, begin_key_name_length);
+	KeyRef end(end_key_name, end_key_name_length);
+	if (begin > end)
+		return TSAV_ERROR(Void, inverted_range);
+	return (FDBFuture*)(TXN(tr)->watchRange(KeyRangeRef(begin, end)).extractPtr());
+}
+
 extern "C" DLLEXPORT FDBFuture* fdb_transaction_commit(FDBTransaction* tr) {
 	return (FDBFuture*)(TXN(tr)->commit().extractPtr());
 }
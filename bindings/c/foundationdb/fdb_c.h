@@ -195,6 +195,27 @@ typedef struct granulesummary {
 } FDBGranuleSummary;
 #pragma pack(pop)
 
+typedef enum {
+	FDB_BATCH_OPERATION_GET = 0,
+	FDB_BATCH_OPERATION_SET = 1,
+	FDB_BATCH_OPERATION_CLEAR = 2,
+	FDB_BATCH_OPERATION_CLEAR_RANGE = 3,
+	FDB_BATCH_OPERATION_ATOMIC_OP = 4
+} FDBBatchOperationType;
+
+/* One operation of fdb_transaction_batch. param is the value of a set or of an atomic operation, or the end of the
+ * range of a range clear, and is ignored otherwise. operation_type is the FDBMutationType of an atomic operation. */
+#pragma pack(push, 4)
+typedef struct batchoperation {
+	FDBBatchOperationType type;
+	const uint8_t* key;
+	int key_length;
+	const uint8_t* param;
+	int param_length;
+	FDBMutationType operation_type;
+} FDBBatchOperation;
+#pragma pack(pop)
+
 typedef struct readgranulecontext {
 	/* User context to pass along to functions */
 	void* userContext;
@@ -321,6 +342,19 @@ DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_keyvalue_array(FDBFuture
                                                                        fdb_bool_t* out_more);
 #endif
 
+/*
+ * Copies the key-value pairs of a range read into block, one after another, each as the key's length, the key, the
+ * value's length and the value. Lengths are 4 byte little-endian integers. Bindings can slice their keys and values out
+ * of the block without allocating each one. With block NULL only the out parameters are set, so that a large enough
+ * block can be allocated.
+ */
+DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_keyvalue_block(FDBFuture* f,
+                                                                       uint8_t* block,
+                                                                       int block_length,
+                                                                       int* out_block_length,
+                                                                       int* out_count,
+                                                                       fdb_bool_t* out_more);
+
 DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_future_get_mappedkeyvalue_array(FDBFuture* f,
                                                                              FDBMappedKeyValue const** out_kv,
                                                                              int* out_count,
@@ -465,6 +499,14 @@ DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_database_flush_blob_range(FDBDatabas
 
 DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_database_get_client_status(FDBDatabase* db);
 
+/* Returns a FDBFuture of a key holding a JSON report of the database's client-side counters and latency histograms
+ * since it was created. */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_database_get_metrics(FDBDatabase* db);
+
+/* Returns a FDBFuture of a key holding a JSON list of the client-side latency profiles of the most recent transaction
+ * attempts, kept while the FDB_DB_OPTION_TRANSACTION_PROFILE_BUFFER_SIZE option is set. */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_database_get_transaction_profiles(FDBDatabase* db);
+
 DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_tenant_create_transaction(FDBTenant* tenant,
                                                                        FDBTransaction** out_transaction);
 
@@ -555,6 +597,27 @@ DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_key(FDBTransaction*
                                                                 fdb_bool_t snapshot);
 #endif
 
+/*
+ * Reads count keys at once. The keys served by the same storage servers are read with a single request. The future's
+ * result is retrieved with fdb_future_get_keyvalue_array and holds the keys which are present, in the order given.
+ */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_multi(FDBTransaction* tr,
+                                                                  uint8_t const* const* key_names,
+                                                                  int const* key_name_lengths,
+                                                                  int count,
+                                                                  fdb_bool_t snapshot);
+
+/*
+ * Applies count reads and writes in order, with a single hop to the network thread rather than one per call. Each read
+ * sees the writes before it in the batch. The future's result is retrieved with fdb_future_get_keyvalue_array and holds
+ * the keys read which are present, in the order given. An error in a write is also returned by the commit, as it would
+ * be if the write had been made on its own.
+ */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_batch(FDBTransaction* tr,
+                                                              FDBBatchOperation const* operations,
+                                                              int count,
+                                                              fdb_bool_t snapshot);
+
 DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_addresses_for_key(FDBTransaction* tr,
                                                                               uint8_t const* key_name,
                                                                               int key_name_length);
@@ -595,6 +658,29 @@ DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_mapped_range(FDBTran
                                                                          fdb_bool_t snapshot,
                                                                          fdb_bool_t reverse);
 
+/*
+ * Reads the range from begin to end as a stream of chunks, which the storage servers send as fast as they are consumed
+ * rather than a page per request. The future's result is the first chunk, retrieved with
+ * fdb_future_get_keyvalue_array. While a chunk has more set, fdb_future_get_next_chunk returns the future of the next
+ * one. Ranges which this transaction has written to are read a page at a time instead, so that the writes are seen.
+ */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_get_range_stream(FDBTransaction* tr,
+                                                                         uint8_t const* begin_key_name,
+                                                                         int begin_key_name_length,
+                                                                         fdb_bool_t begin_or_equal,
+                                                                         int begin_offset,
+                                                                         uint8_t const* end_key_name,
+                                                                         int end_key_name_length,
+                                                                         fdb_bool_t end_or_equal,
+                                                                         int end_offset,
+                                                                         fdb_bool_t snapshot);
+
+/*
+ * Returns the future of the chunk of a range stream after f, which must be a ready chunk of that stream with more set.
+ * f remains valid and must still be destroyed.
+ */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_future_get_next_chunk(FDBFuture* f);
+
 DLLEXPORT void fdb_transaction_set(FDBTransaction* tr,
                                    uint8_t const* key_name,
                                    int key_name_length,
@@ -620,6 +706,16 @@ DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_watch(FDBTransaction* tr
                                                               uint8_t const* key_name,
                                                               int key_name_length);
 
+/*
+ * Fires once any key in [begin_key_name, end_key_name) changes at a version after the transaction's read version. The
+ * transaction need not be committed.
+ */
+DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_watch_range(FDBTransaction* tr,
+                                                                    uint8_t const* begin_key_name,
+                                                                    int begin_key_name_length,
+                                                                    uint8_t const* end_key_name,
+                                                                    int end_key_name_length);
+
 DLLEXPORT WARN_UNUSED_RESULT FDBFuture* fdb_transaction_commit(FDBTransaction* tr);
 
 DLLEXPORT WARN_UNUSED_RESULT fdb_error_t fdb_transaction_get_committed_version(FDBTransaction* tr,
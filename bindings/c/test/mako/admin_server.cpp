@@ -26,12 +26,15 @@
 #include "utils.hpp"
 #include <map>
 #include <cerrno>
+#include <cstdio>
 #include <cstring> // strerror
 #include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 #include <thread>
 #include <tuple>
+#include <vector>
 
 #include <unistd.h>
 #include <sys/wait.h>
@@ -54,6 +57,87 @@ fdb::Database getOrCreateDatabase(std::map<std::string, fdb::Database>& db_map,
 	}
 }
 
+// keys of runs coordinated across mako instances with --coordinate, all under one prefix per name
+std::string coordinationKey(const std::string& name, std::string_view suffix) {
+	return fmt::format("mako_coordinate/{}/{}", name, suffix);
+}
+
+// counters are decimal strings, so that fdbcli can show how far a run has got. A missing counter is 0.
+int parseCounter(const std::optional<fdb::ValueRef>& value) {
+	return value ? std::stoi(std::string(fdb::toCharsRef(*value))) : 0;
+}
+
+// returns once the counter at key reaches target, or an error message
+boost::optional<std::string> waitForCounter(fdb::Database db,
+                                            const std::string& key,
+                                            int target,
+                                            std::string_view what) {
+	auto tx = db.createTransaction();
+	while (true) {
+		auto f = tx.get(fdb::toBytesRef(key), false /*snapshot*/);
+		auto rc = mako::waitAndHandleError(tx, f);
+		if (rc == mako::FutureRC::RETRY) {
+			continue;
+		} else if (rc == mako::FutureRC::ABORT) {
+			return fmt::format("unretryable error while reading {}: {}", key, f.error().what());
+		}
+		const auto count = parseCounter(f.get());
+		if (count >= target) {
+			return {};
+		}
+		logr.info("waiting for {} more agent(s) to {}", target - count, what);
+		auto watch = tx.watch(fdb::toBytesRef(key));
+		auto commit_future = tx.commit();
+		rc = mako::waitAndHandleError(tx, commit_future);
+		if (rc == mako::FutureRC::RETRY) {
+			continue;
+		} else if (rc == mako::FutureRC::ABORT) {
+			return fmt::format("unretryable error while watching {}: {}", key, commit_future.error().what());
+		}
+		if (auto err = watch.blockUntilReady()) {
+			return fmt::format("error while waiting for watch on {}: {}", key, err.what());
+		}
+		if (auto err = watch.error()) {
+			// e.g. too many watches; poll instead
+			logr.debug("watch on {} failed: {}", key, err.what());
+			usleep(100000);
+		}
+		tx.reset();
+	}
+}
+
+// reads all of [begin, end) into out, a page at a time
+mako::FutureRC readRange(fdb::Transaction& tx,
+                         const std::string& begin,
+                         const std::string& end,
+                         std::vector<std::pair<std::string, std::string>>& out) {
+	out.clear();
+	auto next = fdb::ByteString(fdb::toBytesRef(begin));
+	while (true) {
+		auto f = tx.getRange(fdb::key_select::firstGreaterOrEqual(next),
+		                     fdb::key_select::firstGreaterOrEqual(fdb::toBytesRef(end)),
+		                     0 /*limit*/,
+		                     0 /*target_bytes*/,
+		                     FDB_STREAMING_MODE_WANT_ALL,
+		                     0 /*iteration*/,
+		                     false /*snapshot*/,
+		                     false /*reverse*/);
+		const auto rc = mako::waitAndHandleError(tx, f);
+		if (rc != mako::FutureRC::OK) {
+			return rc;
+		}
+		const auto [kvs, count, more] = f.get();
+		for (auto i = 0; i < count; i++) {
+			out.emplace_back(std::string(fdb::toCharsRef(kvs[i].key())), std::string(fdb::toCharsRef(kvs[i].value())));
+		}
+		if (!more || count == 0) {
+			return rc;
+		}
+		next = fdb::ByteString(kvs[count - 1].key());
+		next.push_back('\0');
+	}
+}
+
 } // anonymous namespace
 
 namespace mako::ipc {
@@ -145,6 +229,19 @@ void AdminServer::start() {
 					                          fetchTenantIds(getOrCreateDatabase(databases, request.cluster_file),
 					                                         request.id_begin,
 					                                         request.id_end));
+				    } else if constexpr (std::is_same_v<ReqType, JoinAgentsRequest>) {
+					    logr.info("received request to join {} agents of '{}'", request.num_agents, request.name);
+					    auto db = getOrCreateDatabase(databases, request.cluster_file);
+					    sendResponse<ReqType>(pipe_to_client, joinAgents(db, request.name, request.num_agents));
+				    } else if constexpr (std::is_same_v<ReqType, PublishResultsRequest>) {
+					    logr.info(
+					        "received request to publish results of agent {} of '{}'", request.agent_id, request.name);
+					    auto err_msg = publishResults(getOrCreateDatabase(databases, request.cluster_file), request);
+					    sendResponse<ReqType>(pipe_to_client, DefaultResponse{ std::move(err_msg) });
+				    } else if constexpr (std::is_same_v<ReqType, CollectResultsRequest>) {
+					    logr.info("received request to collect results of '{}'", request.name);
+					    auto db = getOrCreateDatabase(databases, request.cluster_file);
+					    sendResponse<ReqType>(pipe_to_client, collectResults(db, request.name, request.num_agents));
 				    } else {
 					    logr.error("unknown request received, typename '{}'", typeid(ReqType).name());
 					    sendResponse<ReqType>(pipe_to_client, ReqType::ResponseType::makeError("unknown request type"));
@@ -357,6 +454,128 @@ TenantIdsResponse AdminServer::fetchTenantIds(fdb::Database db, int id_begin, in
 	}
 }
 
+AgentIdResponse AdminServer::joinAgents(fdb::Database db, const std::string& name, int num_agents) {
+	try {
+		const auto joined_key = coordinationKey(name, "joined");
+		auto tx = db.createTransaction();
+		auto agent_id = -1;
+		while (true) {
+			auto f = tx.get(fdb::toBytesRef(joined_key), false /*snapshot*/);
+			auto rc = waitAndHandleError(tx, f);
+			if (rc == FutureRC::RETRY) {
+				continue;
+			} else if (rc == FutureRC::ABORT) {
+				return AgentIdResponse::makeError(
+				    fmt::format("unretryable error while joining '{}': {}", name, f.error().what()));
+			}
+			// the agents that joined before this one take the ids below it
+			agent_id = parseCounter(f.get());
+			if (agent_id >= num_agents) {
+				return AgentIdResponse::makeError(fmt::format(
+				    "all {} agents of '{}' have already joined, so coordinate with another name", num_agents, name));
+			}
+			tx.set(fdb::toBytesRef(joined_key), fdb::toBytesRef(std::to_string(agent_id + 1)));
+			auto commit_future = tx.commit();
+			rc = waitAndHandleError(tx, commit_future);
+			if (rc == FutureRC::OK) {
+				break;
+			} else if (rc == FutureRC::ABORT) {
+				return AgentIdResponse::makeError(
+				    fmt::format("unretryable error while joining '{}': {}", name, commit_future.error().what()));
+			}
+		}
+		logr.info("joined '{}' as agent {} of {}", name, agent_id + 1, num_agents);
+		if (auto err_msg = waitForCounter(db, joined_key, num_agents, "join")) {
+			return AgentIdResponse::makeError(*err_msg);
+		}
+		return AgentIdResponse{ {}, agent_id };
+	} catch (const std::exception& e) {
+		return AgentIdResponse::makeError(fmt::format("unexpected exception: {}", e.what()));
+	}
+}
+
+boost::optional<std::string> AdminServer::publishResults(fdb::Database db, const PublishResultsRequest& request) {
+	// serialized statistics can be larger than the value size limit
+	constexpr size_t chunk_size = 90000;
+	try {
+		const auto results_prefix = coordinationKey(request.name, fmt::format("results/{:06d}/", request.agent_id));
+		const auto duration_key = coordinationKey(request.name, fmt::format("durations/{:06d}", request.agent_id));
+		const auto published_key = coordinationKey(request.name, "published");
+		auto tx = db.createTransaction();
+		while (true) {
+			auto f = tx.get(fdb::toBytesRef(published_key), false /*snapshot*/);
+			auto rc = waitAndHandleError(tx, f);
+			if (rc == FutureRC::RETRY) {
+				continue;
+			} else if (rc == FutureRC::ABORT) {
+				return fmt::format("unretryable error while publishing results: {}", f.error().what());
+			}
+			const auto published = parseCounter(f.get());
+			for (size_t offset = 0, chunk = 0; offset < request.stats.size(); offset += chunk_size, chunk++) {
+				tx.set(fdb::toBytesRef(fmt::format("{}{:06d}", results_prefix, chunk)),
+				       fdb::toBytesRef(request.stats.substr(offset, chunk_size)));
+			}
+			tx.set(fdb::toBytesRef(duration_key), fdb::toBytesRef(fmt::format("{}", request.duration)));
+			tx.set(fdb::toBytesRef(published_key), fdb::toBytesRef(std::to_string(published + 1)));
+			auto commit_future = tx.commit();
+			rc = waitAndHandleError(tx, commit_future);
+			if (rc == FutureRC::OK) {
+				return {};
+			} else if (rc == FutureRC::ABORT) {
+				return fmt::format("unretryable error while publishing results: {}", commit_future.error().what());
+			}
+		}
+	} catch (const std::exception& e) {
+		return std::string(e.what());
+	}
+}
+
+AgentResultsResponse AdminServer::collectResults(fdb::Database db, const std::string& name, int num_agents) {
+	try {
+		if (auto err_msg = waitForCounter(db, coordinationKey(name, "published"), num_agents, "publish results")) {
+			return AgentResultsResponse::makeError(*err_msg);
+		}
+		const auto prefix = coordinationKey(name, "");
+		const auto prefix_end = fdb::strinc(prefix);
+		auto tx = db.createTransaction();
+		while (true) {
+			auto kvs = std::vector<std::pair<std::string, std::string>>{};
+			auto rc = readRange(tx, prefix, prefix_end, kvs);
+			if (rc == FutureRC::RETRY) {
+				continue;
+			} else if (rc == FutureRC::ABORT) {
+				return AgentResultsResponse::makeError(
+				    fmt::format("unretryable error while reading results of '{}'", name));
+			}
+			auto response =
+			    AgentResultsResponse{ {}, std::vector<std::string>(num_agents), std::vector<double>(num_agents) };
+			for (const auto& [key, value] : kvs) {
+				auto agent_id = 0;
+				auto chunk = 0;
+				const auto suffix = key.c_str() + prefix.size();
+				if (sscanf(suffix, "results/%d/%d", &agent_id, &chunk) == 2 && agent_id < num_agents) {
+					// chunks are read in order
+					response.stats[agent_id] += value;
+				} else if (sscanf(suffix, "durations/%d", &agent_id) == 1 && agent_id < num_agents) {
+					response.durations[agent_id] = std::stod(value);
+				}
+			}
+			// the run is over, so the name can be used again
+			tx.clearRange(fdb::toBytesRef(prefix), fdb::toBytesRef(prefix_end));
+			auto commit_future = tx.commit();
+			rc = waitAndHandleError(tx, commit_future);
+			if (rc == FutureRC::OK) {
+				return response;
+			} else if (rc == FutureRC::ABORT) {
+				return AgentResultsResponse::makeError(
+				    fmt::format("unretryable error while clearing '{}': {}", name, commit_future.error().what()));
+			}
+		}
+	} catch (const std::exception& e) {
+		return AgentResultsResponse::makeError(fmt::format("unexpected exception: {}", e.what()));
+	}
+}
+
 AdminServer::~AdminServer() {
 	if (server_pid > 0) {
 		// may only be called from main process
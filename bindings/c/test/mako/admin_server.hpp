@@ -66,6 +66,34 @@ struct TenantIdsResponse {
 	}
 };
 
+struct AgentIdResponse {
+	boost::optional<std::string> error_message;
+	int agent_id = -1;
+
+	static AgentIdResponse makeError(std::string msg) { return AgentIdResponse{ msg, -1 }; }
+
+	template <class Ar>
+	void serialize(Ar& ar, unsigned int) {
+		ar& error_message;
+		ar& agent_id;
+	}
+};
+
+struct AgentResultsResponse {
+	boost::optional<std::string> error_message;
+	std::vector<std::string> stats; // serialized WorkflowStatistics of each agent
+	std::vector<double> durations; // seconds each agent ran for
+
+	static AgentResultsResponse makeError(std::string msg) { return AgentResultsResponse{ msg, {}, {} }; }
+
+	template <class Ar>
+	void serialize(Ar& ar, unsigned int) {
+		ar& error_message;
+		ar& stats;
+		ar& durations;
+	}
+};
+
 struct BatchCreateTenantRequest {
 	using ResponseType = DefaultResponse;
 	std::string cluster_file;
@@ -108,6 +136,54 @@ struct FetchTenantIdsRequest {
 	}
 };
 
+// Registers this mako instance as one of num_agents under the coordination name, and returns once all have joined
+struct JoinAgentsRequest {
+	using ResponseType = AgentIdResponse;
+	std::string cluster_file;
+	std::string name;
+	int num_agents = 0;
+
+	template <class Ar>
+	void serialize(Ar& ar, unsigned int) {
+		ar& cluster_file;
+		ar& name;
+		ar& num_agents;
+	}
+};
+
+struct PublishResultsRequest {
+	using ResponseType = DefaultResponse;
+	std::string cluster_file;
+	std::string name;
+	int agent_id = -1;
+	std::string stats;
+	double duration = 0;
+
+	template <class Ar>
+	void serialize(Ar& ar, unsigned int) {
+		ar& cluster_file;
+		ar& name;
+		ar& agent_id;
+		ar& stats;
+		ar& duration;
+	}
+};
+
+// Waits for all agents to publish their results, returns them and clears the coordination keys
+struct CollectResultsRequest {
+	using ResponseType = AgentResultsResponse;
+	std::string cluster_file;
+	std::string name;
+	int num_agents = 0;
+
+	template <class Ar>
+	void serialize(Ar& ar, unsigned int) {
+		ar& cluster_file;
+		ar& name;
+		ar& num_agents;
+	}
+};
+
 struct PingRequest {
 	using ResponseType = DefaultResponse;
 	template <class Ar>
@@ -120,8 +196,14 @@ struct StopRequest {
 	void serialize(Ar&, unsigned int) {}
 };
 
-using Request =
-    boost::variant<PingRequest, StopRequest, BatchCreateTenantRequest, BatchDeleteTenantRequest, FetchTenantIdsRequest>;
+using Request = boost::variant<PingRequest,
+                               StopRequest,
+                               BatchCreateTenantRequest,
+                               BatchDeleteTenantRequest,
+                               FetchTenantIdsRequest,
+                               JoinAgentsRequest,
+                               PublishResultsRequest,
+                               CollectResultsRequest>;
 
 class AdminServer {
 	const Arguments& args;
@@ -137,6 +219,9 @@ class AdminServer {
 	boost::optional<std::string> createTenant(fdb::Database db, int id_begin, int id_end);
 	boost::optional<std::string> deleteTenant(fdb::Database db, int id_begin, int id_end);
 	TenantIdsResponse fetchTenantIds(fdb::Database db, int id_begin, int id_end);
+	AgentIdResponse joinAgents(fdb::Database db, const std::string& name, int num_agents);
+	boost::optional<std::string> publishResults(fdb::Database db, const PublishResultsRequest& request);
+	AgentResultsResponse collectResults(fdb::Database db, const std::string& name, int num_agents);
 
 	template <class T>
 	static void sendObject(boost::process::pstream& pipe, T obj) {
@@ -18,6 +18,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
@@ -34,6 +35,7 @@
 #if defined(__linux__)
 #include <pthread.h>
 #endif
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -221,7 +223,7 @@ int populate(Database db, const ThreadArgs& thread_args, int thread_tps, Workflo
 			/* sequential keys */
 			genKey(keystr.data(), KEY_PREFIX, args, i);
 			/* random values */
-			randomString(valstr.data(), args.value_length);
+			randomValue(valstr, args);
 
 			while (thread_tps > 0 && xacts >= thread_tps /* throttle */) {
 				if (toIntegerSeconds(watch_throttle.stop().diff()) >= 1) {
@@ -311,9 +313,12 @@ int runOneTransaction(Transaction& tx,
                       WorkflowStatistics& stats,
                       ByteString& key1,
                       ByteString& key2,
-                      ByteString& val) {
+                      ByteString& val,
+                      std::optional<timepoint_t> scheduled_start = std::nullopt) {
 	const auto do_sample = (stats.getOpCount(OP_TRANSACTION) % args.sampling) == 0;
-	auto watch_tx = Stopwatch(StartAtCtor{});
+	// in open loop, the transaction latency includes the time it waited behind earlier ones to avoid coordinated
+	// omission
+	auto watch_tx = scheduled_start ? Stopwatch(*scheduled_start) : Stopwatch(StartAtCtor{});
 	auto watch_op = Stopwatch{};
 
 	auto op_iter = getOpBegin(args);
@@ -413,13 +418,17 @@ transaction_begin:
 	return 0;
 }
 
+/* with --phases, phase_thread_tps holds this thread's target TPS for each phase, and the latencies of each phase are
+ * moved to phase_stats when it ends */
 int runWorkload(Database db,
                 Arguments const& args,
                 int const thread_tps,
+                std::vector<int> const& phase_thread_tps,
                 std::atomic<double> const& throttle_factor,
                 int const thread_iters,
                 std::atomic<int> const& signal,
                 WorkflowStatistics& workflow_stats,
+                std::vector<WorkflowStatistics>& phase_stats,
                 int const dotrace,
                 int const dotagging) {
 	auto traceid = std::string{};
@@ -434,10 +443,22 @@ int runWorkload(Database db,
 	if (dotagging)
 		tagstr.reserve(16);
 
-	auto current_tps = static_cast<int>(thread_tps * throttle_factor.load());
+	/* the workload of the current phase, if any */
+	auto phase = 0;
+	auto phase_args = args.phases.empty() ? std::optional<Arguments>{} : std::optional<Arguments>(args);
+	auto const& run_args = phase_args ? *phase_args : args;
+	auto tps = args.phases.empty() ? thread_tps : phase_thread_tps[0];
+	if (phase_args) {
+		phase_args->txnspec = args.phases[0].txnspec;
+		phase_args->keydist = args.phases[0].keydist;
+	}
+
+	auto current_tps = static_cast<int>(tps * throttle_factor.load());
 
 	auto time_prev = steady_clock::now();
 	auto time_last_trace = time_prev;
+	auto time_phase_end = args.phases.empty() ? time_prev : time_prev + std::chrono::seconds(args.phases[0].seconds);
+	auto time_next_arrival = time_prev;
 
 	auto rc = 0;
 	auto xacts = 0;
@@ -455,7 +476,35 @@ int runWorkload(Database db,
 
 	/* main transaction loop */
 	while (1) {
-		if ((thread_tps > 0 /* iff throttling on */) && (xacts >= current_tps)) {
+		if (phase + 1 < static_cast<int>(args.phases.size()) && steady_clock::now() >= time_phase_end) {
+			/* the latencies so far belong to the phase that just ended */
+			phase_stats[phase].setLatencies(workflow_stats.getLatencies());
+			workflow_stats.clearLatencies();
+			phase++;
+			logr.debug("starting phase {}", phase + 1);
+			phase_args->txnspec = args.phases[phase].txnspec;
+			phase_args->keydist = args.phases[phase].keydist;
+			tps = phase_thread_tps[phase];
+			current_tps = static_cast<int>(tps * throttle_factor.load());
+			xacts = 0;
+			time_prev = steady_clock::now();
+			time_phase_end += std::chrono::seconds(args.phases[phase].seconds);
+		}
+
+		auto time_scheduled = std::optional<timepoint_t>{};
+		if (args.arrival == ARRIVAL_POISSON) {
+			/* open loop: start at the next arrival, or right away if earlier transactions made us fall behind */
+			const auto rate = tps * throttle_factor.load();
+			if (rate > 0) {
+				time_next_arrival += std::chrono::duration_cast<timediff_t>(
+				    std::chrono::duration<double>(exponentialInterval(rate)));
+				std::this_thread::sleep_until(time_next_arrival);
+				time_scheduled = time_next_arrival;
+			} else {
+				usleep(1000);
+				time_next_arrival = steady_clock::now();
+			}
+		} else if ((tps > 0 /* iff throttling on */) && (xacts >= current_tps)) {
 			/* throttle on */
 			auto time_now = steady_clock::now();
 			while (toDoubleSeconds(time_now - time_prev) < 1.0) {
@@ -468,10 +517,11 @@ int runWorkload(Database db,
 			time_prev = time_now;
 
 			/* update throttle rate */
-			current_tps = static_cast<int>(thread_tps * throttle_factor.load());
+			current_tps = static_cast<int>(tps * throttle_factor.load());
 		}
 
-		if (current_tps > 0 || thread_tps == 0 /* throttling off */) {
+		if (args.arrival == ARRIVAL_POISSON ? time_scheduled.has_value()
+		                                    : (current_tps > 0 || tps == 0 /* throttling off */)) {
 			auto [tx, token] = createNewTransaction(db, args, -1, tenants);
 			setTransactionTimeoutIfEnabled(args, tx);
 
@@ -509,7 +559,7 @@ int runWorkload(Database db,
 				}
 			}
 
-			rc = runOneTransaction(tx, token, args, workflow_stats, key1, key2, val);
+			rc = runOneTransaction(tx, token, run_args, workflow_stats, key1, key2, val, time_scheduled);
 			if (rc) {
 				logr.warn("runOneTransaction failed ({})", rc);
 			}
@@ -528,11 +578,16 @@ int runWorkload(Database db,
 			break;
 		}
 	}
+	if (!args.phases.empty()) {
+		phase_stats[phase].setLatencies(workflow_stats.getLatencies());
+	}
 	return rc;
 }
 
-std::string getStatsFilename(std::string_view dirname, int process_idx, int thread_id, int op) {
-
+std::string getStatsFilename(std::string_view dirname, int process_idx, int thread_id, int op, int phase = -1) {
+	if (phase >= 0)
+		return fmt::format(
+		    "{}/{}_{}_{}_phase{}", dirname, process_idx + 1, thread_id + 1, opTable[op].name(), phase + 1);
 	return fmt::format("{}/{}_{}_{}", dirname, process_idx + 1, thread_id + 1, opTable[op].name());
 }
 
@@ -545,16 +600,18 @@ void dumpThreadSamples(Arguments const& args,
                        int process_idx,
                        int thread_id,
                        const WorkflowStatistics& stats,
-                       bool overwrite = true) {
+                       bool overwrite = true,
+                       int phase = -1) {
 	const auto dirname = fmt::format("{}{}", TEMP_DATA_STORE, parent_id);
 	const auto rc = mkdir(dirname.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
 	if (rc < 0 && errno != EEXIST) {
 		logr.error("mkdir {}: {}", dirname, strerror(errno));
 		return;
 	}
+	const auto& txnspec = phase >= 0 ? args.phases[phase].txnspec : args.txnspec;
 	for (auto op = 0; op < MAX_OP; op++) {
-		if (args.txnspec.ops[op][OP_COUNT] > 0 || isAbstractOp(op)) {
-			stats.writeToFile(getStatsFilename(dirname, process_idx, thread_id, op), op);
+		if (txnspec.ops[op][OP_COUNT] > 0 || isAbstractOp(op)) {
+			stats.writeToFile(getStatsFilename(dirname, process_idx, thread_id, op, phase), op);
 		}
 	}
 }
@@ -665,6 +722,15 @@ void workerThread(const ThreadArgs& thread_args) {
 	// argument validation should ensure thread_tps > 0
 	assert(args.tpsmax == 0 || thread_tps > 0);
 
+	auto phase_thread_tps = std::vector<int>{};
+	for (const auto& phase : args.phases) {
+		const auto tps =
+		    phase.tps == 0 ? 0
+		                   : computeThreadTps(phase.tps, process_idx, thread_idx, args.num_processes, args.num_threads);
+		phase_thread_tps.push_back(tps);
+	}
+	auto phase_stats = std::vector<WorkflowStatistics>(args.phases.size());
+
 	const auto thread_iters =
 	    args.iteration == 0
 	        ? -1
@@ -690,14 +756,27 @@ void workerThread(const ThreadArgs& thread_args) {
 			logr.error("populate failed");
 		}
 	} else if (args.mode == MODE_RUN) {
-		auto rc = runWorkload(
-		    database, args, thread_tps, throttle_factor, thread_iters, signal, workflow_stats, dotrace, dotagging);
+		auto rc = runWorkload(database,
+		                      args,
+		                      thread_tps,
+		                      phase_thread_tps,
+		                      throttle_factor,
+		                      thread_iters,
+		                      signal,
+		                      workflow_stats,
+		                      phase_stats,
+		                      dotrace,
+		                      dotagging);
 		if (rc < 0) {
 			logr.error("runWorkload failed");
 		}
 	}
 
-	if (args.mode == MODE_BUILD || args.mode == MODE_RUN) {
+	if (!phase_stats.empty()) {
+		for (auto phase = 0; phase < static_cast<int>(phase_stats.size()); phase++) {
+			dumpThreadSamples(args, parent_id, process_idx, thread_idx, phase_stats[phase], true, phase);
+		}
+	} else if (args.mode == MODE_BUILD || args.mode == MODE_RUN) {
 		dumpThreadSamples(args, parent_id, process_idx, thread_idx, workflow_stats);
 	}
 
@@ -852,10 +931,12 @@ Arguments::Arguments() {
 	sampling = 1000;
 	key_length = 32;
 	value_length = 16;
+	value_length_min = -1;
 	active_tenants = 0;
 	total_tenants = 0;
 	tenant_batch_size = 10000;
-	zipf = 0;
+	keydist = KeyDistribution{ KEYDIST_UNIFORM, 0., 0. };
+	arrival = ARRIVAL_CLOSED;
 	commit_get = 0;
 	verbose = 1;
 	flatbuffers = 0; /* internal */
@@ -885,6 +966,8 @@ Arguments::Arguments() {
 	transaction_timeout_db = 0;
 	transaction_timeout_tx = 0;
 	num_report_files = 0;
+	phases_file[0] = '\0';
+	num_agents = 0;
 }
 
 int Arguments::setGlobalOptions() const {
@@ -1002,7 +1085,7 @@ bool Arguments::isAnyTimeoutEnabled() const {
 }
 
 /* parse transaction specification */
-int parseTransaction(Arguments& args, char const* optarg) {
+int parseTransaction(WorkloadSpec& txnspec, char const* optarg) {
 	char const* ptr = optarg;
 	int op = 0;
 	int rangeop = 0;
@@ -1010,8 +1093,8 @@ int parseTransaction(Arguments& args, char const* optarg) {
 	int error = 0;
 
 	for (op = 0; op < MAX_OP; op++) {
-		args.txnspec.ops[op][OP_COUNT] = 0;
-		args.txnspec.ops[op][OP_RANGE] = 0;
+		txnspec.ops[op][OP_COUNT] = 0;
+		txnspec.ops[op][OP_RANGE] = 0;
 	}
 
 	op = 0;
@@ -1085,7 +1168,7 @@ int parseTransaction(Arguments& args, char const* optarg) {
 			}
 		}
 		/* set count */
-		args.txnspec.ops[op][OP_COUNT] = num;
+		txnspec.ops[op][OP_COUNT] = num;
 
 		if (rangeop) {
 			if (*ptr != ':') {
@@ -1095,10 +1178,10 @@ int parseTransaction(Arguments& args, char const* optarg) {
 				ptr++; /* skip ':' */
 				/* check negative '-' sign */
 				if (*ptr == '-') {
-					args.txnspec.ops[op][OP_REVERSE] = 1;
+					txnspec.ops[op][OP_REVERSE] = 1;
 					ptr++;
 				} else {
-					args.txnspec.ops[op][OP_REVERSE] = 0;
+					txnspec.ops[op][OP_REVERSE] = 0;
 				}
 				num = 0;
 				if ((*ptr < '0') || (*ptr > '9')) {
@@ -1110,7 +1193,7 @@ int parseTransaction(Arguments& args, char const* optarg) {
 					ptr++;
 				}
 				/* set range */
-				args.txnspec.ops[op][OP_RANGE] = num;
+				txnspec.ops[op][OP_RANGE] = num;
 			}
 		}
 		rangeop = 0;
@@ -1121,8 +1204,15 @@ int parseTransaction(Arguments& args, char const* optarg) {
 		return -1;
 	}
 
+	return 0;
+}
+
+int parseTransaction(Arguments& args, char const* optarg) {
+	if (parseTransaction(args.txnspec, optarg) < 0)
+		return -1;
+
 	if (args.verbose == VERBOSE_DEBUG) {
-		for (op = 0; op < MAX_OP; op++) {
+		for (auto op = 0; op < MAX_OP; op++) {
 			logr.debug("OP: {}: {}: {}", op, args.txnspec.ops[op][0], args.txnspec.ops[op][1]);
 		}
 	}
@@ -1130,6 +1220,89 @@ int parseTransaction(Arguments& args, char const* optarg) {
 	return 0;
 }
 
+/* parse key distribution: uniform, zipf, hotspot:FRACTION:PROBABILITY, sequential or latest */
+int parseKeyDistribution(KeyDistribution& keydist, char const* optarg) {
+	if (strcmp(optarg, "uniform") == 0) {
+		keydist.kind = KEYDIST_UNIFORM;
+	} else if (strcmp(optarg, "zipf") == 0) {
+		keydist.kind = KEYDIST_ZIPF;
+	} else if (strcmp(optarg, "sequential") == 0) {
+		keydist.kind = KEYDIST_SEQUENTIAL;
+	} else if (strcmp(optarg, "latest") == 0) {
+		keydist.kind = KEYDIST_LATEST;
+	} else if (strncmp(optarg, "hotspot:", 8) == 0) {
+		auto fraction = 0.;
+		auto probability = 0.;
+		if (sscanf(optarg + 8, "%lf:%lf", &fraction, &probability) != 2 || fraction <= 0 || fraction > 1 ||
+		    probability < 0 || probability > 1) {
+			logr.error("hotspot key distribution must be hotspot:FRACTION:PROBABILITY with both in (0, 1]");
+			return -1;
+		}
+		keydist.kind = KEYDIST_HOTSPOT;
+		keydist.hot_fraction = fraction;
+		keydist.hot_probability = probability;
+	} else {
+		logr.error("Invalid key distribution {}", optarg);
+		return -1;
+	}
+	return 0;
+}
+
+/* parse the --phases file. Each line describes one phase as space-separated NAME=VALUE pairs:
+ *   seconds=SEC (required), tps=TPS, transaction=SPEC, keydist=DIST
+ * and anything omitted is taken from the command line. Blank lines and lines starting with '#' are ignored.
+ */
+int parsePhases(Arguments& args) {
+	std::ifstream ifs(args.phases_file);
+	if (!ifs) {
+		logr.error("Couldn't open phases file {}", args.phases_file);
+		return -1;
+	}
+	auto line = std::string{};
+	auto lineno = 0;
+	while (std::getline(ifs, line)) {
+		lineno++;
+		auto tokens = std::istringstream(line);
+		auto token = std::string{};
+		if (!(tokens >> token) || token[0] == '#')
+			continue;
+		auto phase = Phase{ 0, args.tpsmax, args.txnspec, args.keydist };
+		do {
+			const auto eq = token.find('=');
+			if (eq == std::string::npos) {
+				logr.error("{}:{}: expected NAME=VALUE, got {}", args.phases_file, lineno, token);
+				return -1;
+			}
+			const auto name = token.substr(0, eq);
+			const auto value = token.substr(eq + 1);
+			if (name == "seconds") {
+				phase.seconds = atoi(value.c_str());
+			} else if (name == "tps") {
+				phase.tps = atoi(value.c_str());
+			} else if (name == "transaction") {
+				if (parseTransaction(phase.txnspec, value.c_str()) < 0)
+					return -1;
+			} else if (name == "keydist") {
+				if (parseKeyDistribution(phase.keydist, value.c_str()) < 0)
+					return -1;
+			} else {
+				logr.error("{}:{}: unknown phase parameter {}", args.phases_file, lineno, name);
+				return -1;
+			}
+		} while (tokens >> token);
+		if (phase.seconds <= 0) {
+			logr.error("{}:{}: seconds must be a positive integer", args.phases_file, lineno);
+			return -1;
+		}
+		args.phases.push_back(phase);
+	}
+	if (args.phases.empty()) {
+		logr.error("No phases in {}", args.phases_file);
+		return -1;
+	}
+	return 0;
+}
+
 void usage() {
 	printf("Usage:\n");
 	printf("%-24s %s\n", "-h, --help", "Print this message");
@@ -1149,6 +1322,9 @@ void usage() {
 	printf("%-24s %s\n", "", "This option cannot be specified with --seconds.");
 	printf("%-24s %s\n", "    --keylen=LENGTH", "Specify the key lengths");
 	printf("%-24s %s\n", "    --vallen=LENGTH", "Specify the value lengths");
+	printf("%-24s %s\n",
+	       "    --vallen_min=LENGTH",
+	       "Make written value lengths uniformly distributed between LENGTH and --vallen");
 	printf("%-24s %s\n", "    --active_tenants=ACTIVE_TENANTS", "Specify the number of tenants to use");
 	printf("%-24s %s\n", "    --total_tenants=TOTAL_TENANTS", "Specify the number of tenants to create");
 	printf("%-24s %s\n", "    --tenant_batch_size=SIZE", "Specify how many tenants to create/delete per transaction");
@@ -1157,9 +1333,18 @@ void usage() {
 	printf("%-24s %s\n", "    --tpsmin=TPS", "Specify the target min TPS");
 	printf("%-24s %s\n", "    --tpsinterval=SEC", "Specify the TPS change interval (Default: 10 seconds)");
 	printf("%-24s %s\n", "    --tpschange=<sin|square|pulse>", "Specify the TPS change type (Default: sin)");
+	printf("%-24s %s\n",
+	       "    --arrival=<closed|poisson>",
+	       "Start transactions when the last one finishes, or at Poisson-distributed times (Default: closed)");
+	printf("%-24s %s\n",
+	       "    --phases=FILE",
+	       "Run the phases described in FILE one after another, reporting latencies for each");
 	printf("%-24s %s\n", "    --sampling=RATE", "Specify the sampling rate for latency stats");
 	printf("%-24s %s\n", "-m, --mode=MODE", "Specify the mode (build, run, clean, report)");
 	printf("%-24s %s\n", "-z, --zipf", "Use zipfian distribution instead of uniform distribution");
+	printf("%-24s %s\n",
+	       "    --keydist=DIST",
+	       "Key distribution: uniform (default), zipf, hotspot:FRACTION:PROBABILITY, sequential, latest");
 	printf("%-24s %s\n", "    --commitget", "Commit GETs");
 	printf("%-24s %s\n", "    --loggroup=LOGGROUP", "Set client logr group");
 	printf("%-24s %s\n", "    --prefix_padding", "Pad key by prefixing data (Default: postfix padding)");
@@ -1202,6 +1387,10 @@ void usage() {
 	printf("%-24s %s\n",
 	       "    --transaction_timeout_db=DURATION",
 	       "Duration in milliseconds after which a transaction times out in run mode. Set as database option.");
+	printf("%-24s %s\n",
+	       "    --coordinate=NAME",
+	       "Run in lockstep with the other mako instances coordinating under NAME, and report their merged results");
+	printf("%-24s %s\n", "    --agents=NUM", "Specify the number of mako instances coordinating under --coordinate");
 	printf("%-24s %s\n",
 	       "    --transaction_timeout_tx=DURATION",
 	       "Duration in milliseconds after which a transaction times out in run mode. Set as transaction option");
@@ -1259,6 +1448,12 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 			{ "authorization_private_key_pem_file", required_argument, NULL, ARG_AUTHORIZATION_PRIVATE_KEY_PEM_FILE },
 			{ "transaction_timeout_tx", required_argument, NULL, ARG_TRANSACTION_TIMEOUT_TX },
 			{ "transaction_timeout_db", required_argument, NULL, ARG_TRANSACTION_TIMEOUT_DB },
+			{ "keydist", required_argument, NULL, ARG_KEYDIST },
+			{ "vallen_min", required_argument, NULL, ARG_VALLEN_MIN },
+			{ "arrival", required_argument, NULL, ARG_ARRIVAL },
+			{ "phases", required_argument, NULL, ARG_PHASES },
+			{ "coordinate", required_argument, NULL, ARG_COORDINATE },
+			{ "agents", required_argument, NULL, ARG_AGENTS },
 			/* options which may or may not have an argument */
 			{ "json_report", optional_argument, NULL, ARG_JSON_REPORT },
 			{ "stats_export_path", optional_argument, NULL, ARG_EXPORT_PATH },
@@ -1339,7 +1534,7 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 			args.verbose = atoi(optarg);
 			break;
 		case 'z':
-			args.zipf = 1;
+			args.keydist.kind = KEYDIST_ZIPF;
 			break;
 		case 'm':
 			if (strcmp(optarg, "clean") == 0) {
@@ -1372,6 +1567,32 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 		case ARG_VALLEN:
 			args.value_length = atoi(optarg);
 			break;
+		case ARG_VALLEN_MIN:
+			args.value_length_min = atoi(optarg);
+			break;
+		case ARG_KEYDIST:
+			if (parseKeyDistribution(args.keydist, optarg) < 0)
+				return -1;
+			break;
+		case ARG_ARRIVAL:
+			if (strcmp(optarg, "closed") == 0) {
+				args.arrival = ARRIVAL_CLOSED;
+			} else if (strcmp(optarg, "poisson") == 0) {
+				args.arrival = ARRIVAL_POISSON;
+			} else {
+				logr.error("--arrival must be closed or poisson");
+				return -1;
+			}
+			break;
+		case ARG_PHASES:
+			strncpy(args.phases_file, optarg, std::min(sizeof(args.phases_file), strlen(optarg) + 1));
+			break;
+		case ARG_COORDINATE:
+			args.coordinate = std::string(optarg);
+			break;
+		case ARG_AGENTS:
+			args.num_agents = atoi(optarg);
+			break;
 		case ARG_ACTIVE_TENANTS:
 			args.active_tenants = atoi(optarg);
 			break;
@@ -1554,6 +1775,19 @@ int parseArguments(int argc, char* argv[], Arguments& args) {
 		args.tpsmin = args.tpsmax;
 	}
 
+	/* phases default to the command line workload, so they are read once it is all parsed */
+	if (args.phases_file[0] != '\0') {
+		if (args.seconds > 0 || args.iteration > 0) {
+			logr.error("--phases cannot be specified with --seconds or --iteration");
+			return -1;
+		}
+		if (parsePhases(args) < 0)
+			return -1;
+		for (const auto& phase : args.phases) {
+			args.seconds += phase.seconds;
+		}
+	}
+
 	return 0;
 }
 
@@ -1582,6 +1816,10 @@ int Arguments::validate() {
 		logr.error("--vallen must be a positive integer");
 		return -1;
 	}
+	if (value_length_min > value_length) {
+		logr.error("--vallen_min must be less than or equal to --vallen");
+		return -1;
+	}
 	if (num_fdb_clusters > NUM_CLUSTERS_MAX) {
 		logr.error("Mako is not supported to do work to more than {} clusters", NUM_CLUSTERS_MAX);
 		return -1;
@@ -1649,6 +1887,49 @@ int Arguments::validate() {
 			logr.error("--transaction_timeout_[tx|db] must be a non-negative integer");
 			return -1;
 		}
+		if (arrival == ARRIVAL_POISSON && tpsmax == 0 && phases.empty()) {
+			logr.error("--arrival=poisson needs a target rate set with --tps");
+			return -1;
+		}
+		if ((arrival == ARRIVAL_POISSON || !phases.empty()) && async_xacts > 0) {
+			logr.error("--arrival=poisson and --phases are not supported in async mode");
+			return -1;
+		}
+		if (!phases.empty() && tpsmin != tpsmax) {
+			logr.error("--phases sets the target TPS of each phase, so it cannot be used with --tpsmin");
+			return -1;
+		}
+		for (const auto& phase : phases) {
+			if (phase.tps > 0 && num_threads * num_processes > phase.tps) {
+				logr.error("--num_threads * --num_processes must be <= the tps of every phase");
+				return -1;
+			}
+			if (arrival == ARRIVAL_POISSON && phase.tps == 0) {
+				logr.error("--arrival=poisson needs a tps for every phase");
+				return -1;
+			}
+		}
+	} else if (arrival == ARRIVAL_POISSON || !phases.empty()) {
+		logr.error("--arrival and --phases are only supported in run mode");
+		return -1;
+	}
+
+	if (coordinate.has_value()) {
+		if (mode != MODE_RUN) {
+			logr.error("--coordinate is only supported in run mode");
+			return -1;
+		}
+		if (num_agents < 1) {
+			logr.error("--coordinate needs the number of agents set with --agents");
+			return -1;
+		}
+		if (coordinate->empty() || coordinate->find('/') != std::string::npos) {
+			logr.error("--coordinate must be a non-empty name without '/'");
+			return -1;
+		}
+	} else if (num_agents != 0) {
+		logr.error("--agents can only be used with --coordinate");
+		return -1;
 	}
 
 	if (mode != MODE_RUN && (transaction_timeout_db != 0 || transaction_timeout_tx != 0)) {
@@ -2078,9 +2359,14 @@ void printWorkerStats(WorkflowStatistics& final_stats, Arguments args, FILE* fp,
 	}
 }
 
-void loadSample(int pid_main, int op, std::vector<DDSketchMako>& data_points, int process_id, int thread_id) {
+void loadSample(int pid_main,
+                int op,
+                std::vector<DDSketchMako>& data_points,
+                int process_id,
+                int thread_id,
+                int phase = -1) {
 	const auto dirname = fmt::format("{}{}", TEMP_DATA_STORE, pid_main);
-	const auto filename = getStatsFilename(dirname, process_id, thread_id, op);
+	const auto filename = getStatsFilename(dirname, process_id, thread_id, op, phase);
 	std::ifstream fp{ filename };
 	std::ostringstream sstr;
 	sstr << fp.rdbuf();
@@ -2294,23 +2580,64 @@ void printReport(Arguments const& args,
 
 	// Get the sketches stored in file and merge them together
 	std::vector<DDSketchMako> data_points(MAX_OP);
+	// with --phases, each phase has its own files, and the overall latencies are those of all the phases
+	std::vector<std::vector<DDSketchMako>> phase_data_points(args.phases.size(), std::vector<DDSketchMako>(MAX_OP));
 	for (auto op = 0; op < MAX_OP; op++) {
 		for (auto i = 0; i < args.num_processes; i++) {
 
 			if (args.async_xacts == 0) {
 				for (auto j = 0; j < args.num_threads; j++) {
-					loadSample(pid_main, op, data_points, i, j);
+					if (args.phases.empty()) {
+						loadSample(pid_main, op, data_points, i, j);
+					}
+					for (auto phase = 0; phase < static_cast<int>(args.phases.size()); phase++) {
+						loadSample(pid_main, op, phase_data_points[phase], i, j, phase);
+					}
 				}
 			} else {
 				// async mode uses only one file per process
 				loadSample(pid_main, op, data_points, i, 0);
 			}
 		}
+		for (const auto& phase_points : phase_data_points) {
+			if (data_points[op].getPopulationSize() > 0) {
+				data_points[op].mergeWith(phase_points[op]);
+			} else {
+				data_points[op] = phase_points[op];
+			}
+		}
 	}
 	final_worker_stats.updateLatencies(data_points);
 
 	printWorkerStats(final_worker_stats, args, fp);
 
+	if (!args.phases.empty()) {
+		if (fp) {
+			fmt::fprintf(fp, ", \"phases\": [");
+		}
+		for (auto phase = 0; phase < static_cast<int>(args.phases.size()); phase++) {
+			auto phase_args = args;
+			phase_args.txnspec = args.phases[phase].txnspec;
+			auto phase_stats = WorkflowStatistics{};
+			phase_stats.setLatencies(phase_data_points[phase]);
+			fmt::printf("\n====== Phase %d: %d sec, Target TPS %d ======\n\n",
+			            phase + 1,
+			            args.phases[phase].seconds,
+			            args.phases[phase].tps);
+			if (fp) {
+				fmt::fprintf(fp,
+				             "%s{\"seconds\": %d, \"targetTPS\": %d, \"numSamples\": {",
+				             phase > 0 ? "," : "",
+				             args.phases[phase].seconds,
+				             args.phases[phase].tps);
+			}
+			printWorkerStats(phase_stats, phase_args, fp);
+		}
+		if (fp) {
+			fmt::fprintf(fp, "]");
+		}
+	}
+
 	// export the ddsketch if the flag was set
 	if (args.stats_export_path[0] != 0) {
 		std::ofstream f(args.stats_export_path);
@@ -2363,6 +2690,10 @@ int statsProcessMain(Arguments const& args,
 		fmt::fprintf(fp, "\"sampling\": %d,", args.sampling);
 		fmt::fprintf(fp, "\"key_length\": %d,", args.key_length);
 		fmt::fprintf(fp, "\"value_length\": %d,", args.value_length);
+		fmt::fprintf(fp, "\"value_length_min\": %d,", args.value_length_min);
+		fmt::fprintf(fp, "\"keydist\": %d,", args.keydist.kind);
+		fmt::fprintf(fp, "\"arrival\": %d,", args.arrival);
+		fmt::fprintf(fp, "\"phases_file\": \"%s\",", args.phases_file);
 		fmt::fprintf(fp, "\"active_tenants\": %d,", args.active_tenants);
 		fmt::fprintf(fp, "\"total_tenants\": %d,", args.total_tenants);
 		fmt::fprintf(fp, "\"commit_get\": %d,", args.commit_get);
@@ -2446,8 +2777,8 @@ int statsProcessMain(Arguments const& args,
 		fmt::fprintf(fp, "],");
 	}
 
-	/* print report */
-	if (args.verbose >= VERBOSE_DEFAULT) {
+	/* print report, which also exports the statistics that --coordinate publishes */
+	if (args.verbose >= VERBOSE_DEFAULT || args.coordinate.has_value()) {
 		auto time_now = steady_clock::now();
 		while (stopcount.load() < args.num_threads * args.num_processes) {
 			usleep(10000); /* 10ms */
@@ -2476,6 +2807,48 @@ WorkflowStatistics mergeSketchReport(Arguments& args) {
 	return stats;
 }
 
+/* publish the statistics of this instance to the others coordinating under --coordinate.
+ * The first agent then waits for all the others and prints their merged results. */
+int publishCoordinatedResults(ipc::AdminServer& coordinator, Arguments const& args, int agent_id, double duration_sec) {
+	std::ifstream f{ args.stats_export_path };
+	std::ostringstream sstr;
+	sstr << f.rdbuf();
+	auto res = coordinator.send(
+	    ipc::PublishResultsRequest{ args.cluster_files[0], *args.coordinate, agent_id, sstr.str(), duration_sec });
+	if (res.error_message) {
+		logr.error("failed to publish results: {}", *res.error_message);
+		return -1;
+	}
+	if (agent_id != 0) {
+		return 0;
+	}
+
+	auto results =
+	    coordinator.send(ipc::CollectResultsRequest{ args.cluster_files[0], *args.coordinate, args.num_agents });
+	if (results.error_message) {
+		logr.error("failed to collect results: {}", *results.error_message);
+		return -1;
+	}
+	auto stats = WorkflowStatistics{};
+	for (const auto& agent_stats : results.stats) {
+		auto tmp = WorkflowStatistics{};
+		tmp.deserialize(agent_stats);
+		stats.combine(tmp);
+	}
+	// the agents started together, so the slowest one bounds the run
+	const auto duration = *std::max_element(results.durations.begin(), results.durations.end());
+	const auto tps = duration > 0 ? static_cast<uint64_t>(stats.getOpCount(OP_TRANSACTION) / duration) : 0;
+
+	fmt::printf("\n====== Merged Results of %d Agents, %6.3f sec ======\n\n", args.num_agents, duration);
+	fmt::printf("Total Xacts:       %8lu\n", stats.getOpCount(OP_TRANSACTION));
+	fmt::printf("Total Conflicts:   %8lu\n", stats.getConflictCount());
+	fmt::printf("Total Errors:      %8lu\n", stats.getTotalErrorCount());
+	fmt::printf("Total Timeouts:    %8lu\n", stats.getTotalTimeoutCount());
+	fmt::printf("Overall TPS:       %8lu\n\n", tps);
+	printWorkerStats(stats, args, NULL, true);
+	return 0;
+}
+
 int populateTenants(ipc::AdminServer& admin, const Arguments& args) {
 	const auto num_dbs = std::min(args.num_fdb_clusters, args.num_databases);
 	logr.info("populating {} tenants for {} database(s)", args.total_tenants, num_dbs);
@@ -2608,6 +2981,36 @@ int main(int argc, char* argv[]) {
 		}
 	}
 
+	// with --coordinate, an admin server joins the other agents before the run starts and exchanges results after it
+	auto coordinator = std::optional<ipc::AdminServer>{};
+	auto agent_id = -1;
+	auto remove_stats_export = false;
+	if (args.coordinate.has_value()) {
+		if (args.stats_export_path[0] == '\0') {
+			// the statistics of this instance are published from the export of its report
+			const auto path = fmt::format("{}{}_agent.json", TEMP_DATA_STORE, getpid());
+			strncpy(args.stats_export_path, path.c_str(), sizeof(args.stats_export_path) - 1);
+			remove_stats_export = true;
+		}
+		coordinator.emplace(args);
+		if (!coordinator->isClient()) {
+			// admin server has finished running. exit immediately
+			return 0;
+		}
+		auto res =
+		    coordinator->send(ipc::JoinAgentsRequest{ args.cluster_files[0], *args.coordinate, args.num_agents });
+		if (res.error_message) {
+			logr.error("failed to join '{}': {}", *args.coordinate, *res.error_message);
+			return -1;
+		}
+		agent_id = res.agent_id;
+		logr.info("all {} agents have joined '{}', running as agent {}", args.num_agents, *args.coordinate, agent_id);
+	}
+	auto stats_export_guard = ExitGuard([&args, remove_stats_export]() {
+		if (remove_stats_export)
+			unlink(args.stats_export_path);
+	});
+
 	const auto pid_main = getpid();
 	/* create the shared memory for stats */
 	const auto shmpath = fmt::format("mako{}", pid_main);
@@ -2689,7 +3092,11 @@ int main(int argc, char* argv[]) {
 	srand(time(0) * getpid());
 
 	/* initialize zipfian if necessary (per-process) */
-	if (args.zipf) {
+	auto uses_zipf = [](KeyDistribution const& keydist) {
+		return keydist.kind == KEYDIST_ZIPF || keydist.kind == KEYDIST_LATEST;
+	};
+	if (uses_zipf(args.keydist) ||
+	    std::any_of(args.phases.begin(), args.phases.end(), [&](Phase const& p) { return uses_zipf(p.keydist); })) {
 		zipfian_generator(args.rows);
 	}
 
@@ -2722,6 +3129,7 @@ int main(int argc, char* argv[]) {
 		usleep(1000);
 	}
 	shm_hdr.signal.store(SIGNAL_GREEN);
+	const auto time_green = steady_clock::now();
 
 	if (args.mode == MODE_RUN) {
 		/* run the benchmark */
@@ -2757,6 +3165,7 @@ int main(int argc, char* argv[]) {
 		}
 		logr.debug("worker {} (PID:{}) exited", p + 1, worker_pids[p]);
 	}
+	const auto duration_sec = toDoubleSeconds(steady_clock::now() - time_green);
 
 	/* all worker threads finished, stop the stats */
 	if (args.mode == MODE_BUILD || args.iteration > 0) {
@@ -2769,5 +3178,8 @@ int main(int argc, char* argv[]) {
 		logr.error("waitpid failed for stats process PID {}", worker_pids[args.num_processes]);
 	}
 
+	if (coordinator) {
+		return publishCoordinatedResults(*coordinator, args, agent_id, duration_sec);
+	}
 	return 0;
 }
@@ -91,6 +91,12 @@ enum ArgKind {
 	ARG_ENABLE_TOKEN_BASED_AUTHORIZATION,
 	ARG_TRANSACTION_TIMEOUT_TX,
 	ARG_TRANSACTION_TIMEOUT_DB,
+	ARG_KEYDIST,
+	ARG_VALLEN_MIN,
+	ARG_ARRIVAL,
+	ARG_PHASES,
+	ARG_COORDINATE,
+	ARG_AGENTS,
 };
 
 constexpr const int OP_COUNT = 0;
@@ -120,6 +126,12 @@ enum OpKind {
 
 enum TPSChangeTypes { TPS_SIN, TPS_SQUARE, TPS_PULSE };
 
+enum KeyDistributionKind { KEYDIST_UNIFORM, KEYDIST_ZIPF, KEYDIST_HOTSPOT, KEYDIST_SEQUENTIAL, KEYDIST_LATEST };
+
+/* closed: each thread starts a transaction when the last one finishes.
+ * poisson: transactions are started at exponentially distributed intervals (open loop) */
+enum ArrivalKind { ARRIVAL_CLOSED, ARRIVAL_POISSON };
+
 enum DistributedTracerClient { DISABLED, NETWORK_LOSSY, LOG_FILE };
 
 /* we set WorkloadSpec and Arguments only once in the master process,
@@ -131,6 +143,22 @@ struct WorkloadSpec {
 	int ops[MAX_OP][3];
 };
 
+/* how row numbers are chosen for the keys of each operation */
+struct KeyDistribution {
+	int kind;
+	/* hotspot: hot_probability of the accesses go to the first hot_fraction of the rows */
+	double hot_fraction;
+	double hot_probability;
+};
+
+/* one step of a --phases scenario, run for the given number of seconds */
+struct Phase {
+	int seconds;
+	int tps; /* 0 means no throttling */
+	WorkloadSpec txnspec;
+	KeyDistribution keydist;
+};
+
 constexpr const int LOGGROUP_MAX = 256;
 constexpr const int KNOB_MAX = 256;
 constexpr const int TAGPREFIXLENGTH_MAX = 8;
@@ -172,10 +200,12 @@ struct Arguments {
 	int sampling;
 	int key_length;
 	int value_length;
+	int value_length_min; /* if less than value_length, value lengths are uniform in [min, value_length] */
 	int active_tenants;
 	int total_tenants;
 	int tenant_batch_size;
-	int zipf;
+	KeyDistribution keydist;
+	int arrival;
 	int commit_get;
 	int verbose;
 	WorkloadSpec txnspec;
@@ -213,6 +243,10 @@ struct Arguments {
 	std::vector<int64_t> tenant_ids; // maps tenant index to tenant id for signing tokens
 	int transaction_timeout_db;
 	int transaction_timeout_tx;
+	char phases_file[PATH_MAX];
+	std::vector<Phase> phases;
+	std::optional<std::string> coordinate; // name under which num_agents mako instances run in lockstep
+	int num_agents;
 };
 
 // helper functions
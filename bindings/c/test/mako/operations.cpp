@@ -124,7 +124,7 @@ const std::array<Operation, MAX_OP> opTable{
 	        } },
 	      { StepKind::IMM,
 	        [](Transaction& tx, Arguments const& args, ByteString& key, ByteString&, ByteString& value) {
-	            randomString(value.data(), args.value_length);
+	            randomValue(value, args);
 	            tx.set(key, value);
 	            return Future();
 	        } } },
@@ -135,7 +135,7 @@ const std::array<Operation, MAX_OP> opTable{
 	        [](Transaction& tx, Arguments const& args, ByteString& key, ByteString&, ByteString& value) {
 	            // key[0..args.key_length] := concat(key_prefix, random_string)
 	            randomString(key.data() + intSize(KEY_PREFIX), args.key_length - intSize(KEY_PREFIX));
-	            randomString(value.data(), args.value_length);
+	            randomValue(value, args);
 	            tx.set(key, value);
 	            return Future();
 	        } } },
@@ -144,7 +144,7 @@ const std::array<Operation, MAX_OP> opTable{
 	  { "INSERTRANGE",
 	    { { StepKind::IMM,
 	        [](Transaction& tx, Arguments const& args, ByteString& key, ByteString&, ByteString& value) {
-	            randomString(value.data(), args.value_length);
+	            randomValue(value, args);
 
 	            // key[0..args.key_length] := concat(prefix, random_string, num[0..range_digits])
 	            const auto range = args.txnspec.ops[OP_INSERTRANGE][OP_RANGE];
@@ -163,7 +163,7 @@ const std::array<Operation, MAX_OP> opTable{
 	  { "OVERWRITE",
 	    { { StepKind::IMM,
 	        [](Transaction& tx, Arguments const& args, ByteString& key, ByteString&, ByteString& value) {
-	            randomString(value.data(), args.value_length);
+	            randomValue(value, args);
 	            tx.set(key, value);
 	            return Future();
 	        } } },
@@ -181,7 +181,7 @@ const std::array<Operation, MAX_OP> opTable{
 	    { { StepKind::COMMIT,
 	        [](Transaction& tx, Arguments const& args, ByteString& key, ByteString&, ByteString& value) {
 	            randomString(&key[KEY_PREFIX.size()], args.key_length - intSize(KEY_PREFIX));
-	            randomString(value.data(), args.value_length);
+	            randomValue(value, args);
 	            tx.set(key, value);
 	            return tx.commit().eraseType();
 	        } },
@@ -203,7 +203,7 @@ const std::array<Operation, MAX_OP> opTable{
 	  { "SETCLEARRANGE",
 	    { { StepKind::COMMIT,
 	        [](Transaction& tx, Arguments const& args, ByteString& key_begin, ByteString& key, ByteString& value) {
-	            randomString(value.data(), args.value_length);
+	            randomValue(value, args);
 
 	            // key[0..args.key_length] := concat(prefix, random_string, num[0..range_digits])
 	            const auto range = args.txnspec.ops[OP_SETCLEARRANGE][OP_RANGE];
@@ -182,8 +182,29 @@ public:
 		f << ss.GetString();
 	}
 
+	// reads statistics serialized by operator<<
+	void deserialize(const std::string& json);
+
 	void updateLatencies(const std::vector<DDSketchMako> other_sketches) { sketches = other_sketches; }
 
+	const std::vector<DDSketchMako>& getLatencies() const noexcept { return sketches; }
+
+	// empties the sketches, e.g. at the end of a phase, but keeps the sample counts
+	void clearLatencies() {
+		for (auto& sketch : sketches) {
+			sketch.clear();
+		}
+	}
+
+	// for statistics that only hold latencies, e.g. those of one phase, takes the sample counts from the sketches too
+	void setLatencies(const std::vector<DDSketchMako>& other_sketches) {
+		sketches = other_sketches;
+		for (auto op = 0; op < MAX_OP; op++) {
+			latency_samples[op] = sketches[op].getPopulationSize();
+			latency_us_total[op] = static_cast<uint64_t>(sketches[op].mean() * latency_samples[op]);
+		}
+	}
+
 	friend std::ofstream& operator<<(std::ofstream& os, WorkflowStatistics& stats);
 	friend std::ifstream& operator>>(std::ifstream& is, WorkflowStatistics& stats);
 };
@@ -258,11 +279,19 @@ inline void populateArray(std::array<uint64_t, MAX_OP>& arr,
 inline std::ifstream& operator>>(std::ifstream& is, WorkflowStatistics& stats) {
 	std::stringstream buffer;
 	buffer << is.rdbuf();
+	stats.deserialize(buffer.str());
+	return is;
+}
+
+inline void WorkflowStatistics::deserialize(const std::string& json) {
 	rapidjson::Document doc;
-	doc.Parse(buffer.str().c_str());
-	stats.conflicts = doc["conflicts"].GetUint64();
-	stats.total_errors = doc["total_errors"].GetUint64();
-	stats.total_timeouts = doc["total_timeouts"].GetUint64();
+	doc.Parse(json.c_str());
+	if (doc.HasParseError()) {
+		return;
+	}
+	conflicts = doc["conflicts"].GetUint64();
+	total_errors = doc["total_errors"].GetUint64();
+	total_timeouts = doc["total_timeouts"].GetUint64();
 
 	auto jsonOps = doc["ops"].GetArray();
 	auto jsonErrors = doc["errors"].GetArray();
@@ -270,17 +299,18 @@ inline std::ifstream& operator>>(std::ifstream& is, WorkflowStatistics& stats) {
 	auto jsonLatencySamples = doc["latency_samples"].GetArray();
 	auto jsonLatencyUsTotal = doc["latency_us_total"].GetArray();
 
-	populateArray(stats.ops, jsonOps);
-	populateArray(stats.errors, jsonErrors);
-	populateArray(stats.timeouts, jsonTimeouts);
-	populateArray(stats.latency_samples, jsonLatencySamples);
-	populateArray(stats.latency_us_total, jsonLatencyUsTotal);
+	populateArray(ops, jsonOps);
+	populateArray(errors, jsonErrors);
+	populateArray(timeouts, jsonTimeouts);
+	populateArray(latency_samples, jsonLatencySamples);
+	populateArray(latency_us_total, jsonLatencyUsTotal);
 	for (int op = 0; op < MAX_OP; op++) {
 		const std::string op_name = getOpName(op);
-		stats.sketches[op].deserialize(doc[op_name.c_str()]);
+		// only the sketches with samples are serialized
+		if (doc.HasMember(op_name.c_str())) {
+			sketches[op].deserialize(doc[op_name.c_str()]);
+		}
 	}
-
-	return is;
 }
 
 enum TimerKind { THREAD, PROCESS };
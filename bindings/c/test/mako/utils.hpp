@@ -25,9 +25,12 @@
 #include "macro.hpp"
 #include "mako.hpp"
 #include "fdbclient/zipf.h"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <string>
 #include <string_view>
 #include <type_traits>
 
@@ -53,10 +56,41 @@ force_inline int urand(int low, int high) {
 	return (int)((r * range) + low);
 }
 
+/* return true with the given probability */
+force_inline bool brand(double probability) {
+	return rand() / (1.0 + RAND_MAX) < probability;
+}
+
+/* exponentially distributed random interval, in seconds, between events arriving at the given rate */
+force_inline double exponentialInterval(double rate) {
+	return -log(1.0 - rand() / (1.0 + RAND_MAX)) / rate;
+}
+
 force_inline int nextKey(Arguments const& args) {
-	if (args.zipf)
+	switch (args.keydist.kind) {
+	case KEYDIST_ZIPF:
 		return zipfian_next();
-	return urand(0, args.rows - 1);
+	case KEYDIST_HOTSPOT: {
+		const auto hot_rows = std::max(1, static_cast<int>(args.rows * args.keydist.hot_fraction));
+		if (hot_rows >= args.rows || brand(args.keydist.hot_probability))
+			return urand(0, hot_rows - 1);
+		return urand(hot_rows, args.rows - 1);
+	}
+	case KEYDIST_SEQUENTIAL: {
+		/* each thread walks the rows from its own random starting point */
+		static thread_local int next = -1;
+		if (next < 0 || next >= args.rows)
+			next = urand(0, args.rows - 1);
+		const auto key = next;
+		next = (next + 1) % args.rows;
+		return key;
+	}
+	case KEYDIST_LATEST:
+		/* zipfian from the highest row down, as if rows were numbered in the order they were inserted */
+		return args.rows - 1 - zipfian_next();
+	default:
+		return urand(0, args.rows - 1);
+	}
 }
 
 force_inline int intSize(std::string_view sv) {
@@ -87,6 +121,17 @@ force_inline void randomString(Char* str, int len) {
 	}
 }
 
+/* fill value with a random string, resizing it to a length chosen by --vallen_min and --vallen.
+ * value must have been sized to --vallen beforehand so that this never reallocates. */
+template <typename Char>
+force_inline void randomValue(std::basic_string<Char>& value, Arguments const& args) {
+	if (args.value_length_min >= 0 && args.value_length_min < args.value_length)
+		value.resize(urand(args.value_length_min, args.value_length));
+	else
+		value.resize(args.value_length);
+	randomString(value.data(), static_cast<int>(value.size()));
+}
+
 /* given the total number of rows to be inserted,
  * the worker process index p_idx and the thread index t_idx (both 0-based),
  * and the total number of processes, total_p, and threads, total_t,
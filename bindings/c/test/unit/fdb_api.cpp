@@ -102,6 +102,18 @@ void Future::cancel() {
 	return fdb_future_get_keyvalue_array(future_, out_kv, out_count, out_more);
 }
 
+[[nodiscard]] fdb_error_t KeyValueArrayFuture::get_block(uint8_t* block,
+                                                         int block_length,
+                                                         int* out_block_length,
+                                                         int* out_count,
+                                                         fdb_bool_t* out_more) {
+	return fdb_future_get_keyvalue_block(future_, block, block_length, out_block_length, out_count, out_more);
+}
+
+KeyValueArrayFuture KeyValueArrayFuture::get_next_chunk() {
+	return KeyValueArrayFuture(fdb_future_get_next_chunk(future_));
+}
+
 // MappedKeyValueArrayFuture
 
 [[nodiscard]] fdb_error_t MappedKeyValueArrayFuture::get(const FDBMappedKeyValue** out_kv,
@@ -161,6 +173,14 @@ EmptyFuture Database::wait_purge_granules_complete(FDBDatabase* db, std::string_
 	    fdb_database_wait_purge_granules_complete(db, (const uint8_t*)purge_key.data(), purge_key.size()));
 }
 
+KeyFuture Database::get_metrics(FDBDatabase* db) {
+	return KeyFuture(fdb_database_get_metrics(db));
+}
+
+KeyFuture Database::get_transaction_profiles(FDBDatabase* db) {
+	return KeyFuture(fdb_database_get_transaction_profiles(db));
+}
+
 // Tenant
 Tenant::Tenant(FDBDatabase* db, const uint8_t* name, int name_length) {
 	if (fdb_error_t err = fdb_database_open_tenant(db, name, name_length, &tenant)) {
@@ -265,6 +285,21 @@ StringArrayFuture Transaction::get_addresses_for_key(std::string_view key) {
 	return StringArrayFuture(fdb_transaction_get_addresses_for_key(tr_, (const uint8_t*)key.data(), key.size()));
 }
 
+KeyValueArrayFuture Transaction::get_multi(const std::vector<std::string>& keys, fdb_bool_t snapshot) {
+	std::vector<const uint8_t*> key_names;
+	std::vector<int> key_name_lengths;
+	for (const auto& key : keys) {
+		key_names.push_back((const uint8_t*)key.data());
+		key_name_lengths.push_back(key.size());
+	}
+	return KeyValueArrayFuture(
+	    fdb_transaction_get_multi(tr_, key_names.data(), key_name_lengths.data(), keys.size(), snapshot));
+}
+
+KeyValueArrayFuture Transaction::batch(const std::vector<FDBBatchOperation>& operations, fdb_bool_t snapshot) {
+	return KeyValueArrayFuture(fdb_transaction_batch(tr_, operations.data(), operations.size(), snapshot));
+}
+
 KeyValueArrayFuture Transaction::get_range(const uint8_t* begin_key_name,
                                            int begin_key_name_length,
                                            fdb_bool_t begin_or_equal,
@@ -296,6 +331,27 @@ KeyValueArrayFuture Transaction::get_range(const uint8_t* begin_key_name,
 	                                                     reverse));
 }
 
+KeyValueArrayFuture Transaction::get_range_stream(const uint8_t* begin_key_name,
+                                                  int begin_key_name_length,
+                                                  fdb_bool_t begin_or_equal,
+                                                  int begin_offset,
+                                                  const uint8_t* end_key_name,
+                                                  int end_key_name_length,
+                                                  fdb_bool_t end_or_equal,
+                                                  int end_offset,
+                                                  fdb_bool_t snapshot) {
+	return KeyValueArrayFuture(fdb_transaction_get_range_stream(tr_,
+	                                                            begin_key_name,
+	                                                            begin_key_name_length,
+	                                                            begin_or_equal,
+	                                                            begin_offset,
+	                                                            end_key_name,
+	                                                            end_key_name_length,
+	                                                            end_or_equal,
+	                                                            end_offset,
+	                                                            snapshot));
+}
+
 MappedKeyValueArrayFuture Transaction::get_mapped_range(const uint8_t* begin_key_name,
                                                         int begin_key_name_length,
                                                         fdb_bool_t begin_or_equal,
@@ -335,6 +391,11 @@ EmptyFuture Transaction::watch(std::string_view key) {
 	return EmptyFuture(fdb_transaction_watch(tr_, (const uint8_t*)key.data(), key.size()));
 }
 
+EmptyFuture Transaction::watch_range(std::string_view begin_key, std::string_view end_key) {
+	return EmptyFuture(fdb_transaction_watch_range(
+	    tr_, (const uint8_t*)begin_key.data(), begin_key.size(), (const uint8_t*)end_key.data(), end_key.size()));
+}
+
 EmptyFuture Transaction::commit() {
 	return EmptyFuture(fdb_transaction_commit(tr_));
 }
@@ -44,6 +44,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace fdb {
 
@@ -144,6 +145,19 @@ public:
 	// fdb_future_get_keyvalue_array.
 	fdb_error_t get(const FDBKeyValue** out_kv, int* out_count, fdb_bool_t* out_more);
 
+	// Call this function instead of fdb_future_get_keyvalue_block when using
+	// the KeyValueArrayFuture type. Its behavior is identical to
+	// fdb_future_get_keyvalue_block.
+	fdb_error_t get_block(uint8_t* block,
+	                      int block_length,
+	                      int* out_block_length,
+	                      int* out_count,
+	                      fdb_bool_t* out_more);
+
+	// Returns the future of the next chunk of the range stream this future is
+	// a ready chunk of. Its behavior is identical to fdb_future_get_next_chunk.
+	KeyValueArrayFuture get_next_chunk();
+
 private:
 	friend class Transaction;
 	KeyValueArrayFuture(FDBFuture* f) : Future(f) {}
@@ -236,6 +250,10 @@ public:
 	                                     fdb_bool_t force);
 
 	static EmptyFuture wait_purge_granules_complete(FDBDatabase* db, std::string_view purge_key);
+
+	static KeyFuture get_metrics(FDBDatabase* db);
+
+	static KeyFuture get_transaction_profiles(FDBDatabase* db);
 };
 
 class Tenant final {
@@ -312,6 +330,14 @@ public:
 	// Returns a future which will be set to an array of strings.
 	StringArrayFuture get_addresses_for_key(std::string_view key);
 
+	// Returns a future which will be set to an FDBKeyValue array of those of
+	// `keys` which are present, in the order given.
+	KeyValueArrayFuture get_multi(const std::vector<std::string>& keys, fdb_bool_t snapshot);
+
+	// Returns a future which will be set to an FDBKeyValue array of those of
+	// the keys read by `operations` which are present, in the order given.
+	KeyValueArrayFuture batch(const std::vector<FDBBatchOperation>& operations, fdb_bool_t snapshot);
+
 	// Returns a future which will be set to an FDBKeyValue array.
 	KeyValueArrayFuture get_range(const uint8_t* begin_key_name,
 	                              int begin_key_name_length,
@@ -328,6 +354,18 @@ public:
 	                              fdb_bool_t snapshot,
 	                              fdb_bool_t reverse);
 
+	// Returns a future which will be set to the FDBKeyValue array of the first
+	// chunk of a range stream.
+	KeyValueArrayFuture get_range_stream(const uint8_t* begin_key_name,
+	                                     int begin_key_name_length,
+	                                     fdb_bool_t begin_or_equal,
+	                                     int begin_offset,
+	                                     const uint8_t* end_key_name,
+	                                     int end_key_name_length,
+	                                     fdb_bool_t end_or_equal,
+	                                     int end_offset,
+	                                     fdb_bool_t snapshot);
+
 	// WARNING: This feature is considered experimental at this time. It is only allowed when using snapshot isolation
 	// AND disabling read-your-writes. Returns a future which will be set to an FDBKeyValue array.
 	MappedKeyValueArrayFuture get_mapped_range(const uint8_t* begin_key_name,
@@ -351,6 +389,10 @@ public:
 	// empty value.
 	EmptyFuture watch(std::string_view key);
 
+	// Wrapper around fdb_transaction_watch_range. Returns a future representing
+	// an empty value.
+	EmptyFuture watch_range(std::string_view begin_key, std::string_view end_key);
+
 	// Wrapper around fdb_transaction_commit. Returns a future representing an
 	// empty value.
 	EmptyFuture commit();
@@ -592,6 +592,234 @@ TEST_CASE("fdb_future_get_keyvalue_array") {
 	}
 }
 
+TEST_CASE("fdb_future_get_keyvalue_block") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "" }, { "c", "3" } });
+	insert_data(db, data);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		fdb::KeyValueArrayFuture f1 =
+		    tr.get_range(FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)key("a").c_str(), key("a").size()),
+		                 FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)key("d").c_str(), key("d").size()),
+		                 /* limit */ 0,
+		                 /* target_bytes */ 0,
+		                 /* FDBStreamingMode */ FDB_STREAMING_MODE_WANT_ALL,
+		                 /* iteration */ 0,
+		                 /* snapshot */ false,
+		                 /* reverse */ 0);
+
+		fdb_error_t err = wait_future(f1);
+		if (err) {
+			fdb::EmptyFuture f2 = tr.on_error(err);
+			fdb_check(wait_future(f2));
+			continue;
+		}
+
+		FDBKeyValue const* out_kv;
+		int out_count;
+		int out_more;
+		fdb_check(f1.get(&out_kv, &out_count, &out_more));
+
+		int block_length;
+		int block_count;
+		int block_more;
+		fdb_check(f1.get_block(nullptr, 0, &block_length, &block_count, &block_more));
+		CHECK(block_count == out_count);
+		CHECK(block_more == out_more);
+
+		// A block which is too small is rejected
+		std::vector<uint8_t> block(block_length);
+		CHECK(f1.get_block(block.data(), block_length - 1, &block_length, &block_count, &block_more) != 0);
+		fdb_check(f1.get_block(block.data(), block.size(), &block_length, &block_count, &block_more));
+
+		// The block holds each key and value after its little-endian length, in the order of the array
+		size_t pos = 0;
+		auto next = [&]() {
+			REQUIRE(pos + 4 <= block.size());
+			uint32_t length = block[pos] | (block[pos + 1] << 8) | (block[pos + 2] << 16) | (block[pos + 3] << 24);
+			pos += 4;
+			REQUIRE(pos + length <= block.size());
+			std::string s((const char*)block.data() + pos, length);
+			pos += length;
+			return s;
+		};
+		for (int i = 0; i < out_count; ++i) {
+			CHECK(next() == std::string((const char*)out_kv[i].key, out_kv[i].key_length));
+			CHECK(next() == std::string((const char*)out_kv[i].value, out_kv[i].value_length));
+		}
+		CHECK(pos == block.size());
+		break;
+	}
+}
+
+// Reads the chunks of a range stream from chunk on, returning the error which ended it or 0
+fdb_error_t read_range_stream_chunks(fdb::KeyValueArrayFuture& chunk,
+                                     std::vector<std::pair<std::string, std::string>>& results) {
+	fdb_error_t err = wait_future(chunk);
+	if (err) {
+		return err;
+	}
+
+	FDBKeyValue const* out_kv;
+	int out_count;
+	int out_more;
+	fdb_check(chunk.get(&out_kv, &out_count, &out_more));
+	for (int i = 0; i < out_count; ++i) {
+		results.emplace_back(std::string((const char*)out_kv[i].key, out_kv[i].key_length),
+		                     std::string((const char*)out_kv[i].value, out_kv[i].value_length));
+	}
+	if (!out_more) {
+		return 0;
+	}
+	fdb::KeyValueArrayFuture next = chunk.get_next_chunk();
+	return read_range_stream_chunks(next, results);
+}
+
+fdb_error_t read_range_stream(fdb::Transaction& tr,
+                              const std::string& begin,
+                              const std::string& end,
+                              std::vector<std::pair<std::string, std::string>>& results) {
+	results.clear();
+	fdb::KeyValueArrayFuture chunk =
+	    tr.get_range_stream(FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)begin.c_str(), begin.size()),
+	                        FDB_KEYSEL_FIRST_GREATER_OR_EQUAL((const uint8_t*)end.c_str(), end.size()),
+	                        /* snapshot */ false);
+	return read_range_stream_chunks(chunk, results);
+}
+
+TEST_CASE("fdb_transaction_get_range_stream") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "2" }, { "c", "3" }, { "d", "4" } });
+	insert_data(db, data);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		std::vector<std::pair<std::string, std::string>> results;
+		fdb_error_t err = read_range_stream(tr, key("a"), key("d"), results);
+		if (err) {
+			fdb::EmptyFuture f = tr.on_error(err);
+			fdb_check(wait_future(f));
+			continue;
+		}
+		std::vector<std::pair<std::string, std::string>> expected = { { key("a"), "1" },
+			                                                          { key("b"), "2" },
+			                                                          { key("c"), "3" } };
+		CHECK(results == expected);
+
+		// A range which has been written is read through the transaction's writes
+		tr.set(key("bb"), "5");
+		tr.clear(key("c"));
+		err = read_range_stream(tr, key("a"), key("d"), results);
+		if (err) {
+			fdb::EmptyFuture f = tr.on_error(err);
+			fdb_check(wait_future(f));
+			continue;
+		}
+		expected = { { key("a"), "1" }, { key("b"), "2" }, { key("bb"), "5" } };
+		CHECK(results == expected);
+		break;
+	}
+}
+
+TEST_CASE("fdb_transaction_get_multi") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "2" }, { "c", "3" } });
+	insert_data(db, data);
+
+	fdb::Transaction tr(db);
+	while (1) {
+		tr.set(key("d"), "4");
+		tr.clear(key("b"));
+		fdb::KeyValueArrayFuture f1 =
+		    tr.get_multi({ key("c"), key("missing"), key("a"), key("b"), key("d") }, /* snapshot */ false);
+
+		fdb_error_t err = wait_future(f1);
+		if (err) {
+			fdb::EmptyFuture f2 = tr.on_error(err);
+			fdb_check(wait_future(f2));
+			continue;
+		}
+
+		FDBKeyValue const* out_kv;
+		int out_count;
+		int out_more;
+		fdb_check(f1.get(&out_kv, &out_count, &out_more));
+
+		// Missing and cleared keys are left out, and written keys are read back
+		std::vector<std::pair<std::string, std::string>> expected = {
+			{ key("c"), "3" }, { key("a"), "1" }, { key("d"), "4" }
+		};
+		CHECK(out_count == expected.size());
+		for (int i = 0; i < out_count && i < expected.size(); ++i) {
+			CHECK(std::string((const char*)out_kv[i].key, out_kv[i].key_length) == expected[i].first);
+			CHECK(std::string((const char*)out_kv[i].value, out_kv[i].value_length) == expected[i].second);
+		}
+		break;
+	}
+}
+
+TEST_CASE("fdb_transaction_batch") {
+	std::map<std::string, std::string> data = create_data({ { "a", "1" }, { "b", "2" } });
+	insert_data(db, data);
+
+	std::string a = key("a"), b = key("b"), c = key("c"), d = key("d"), one = "1", three = "3", none;
+	auto op = [](FDBBatchOperationType type, const std::string& k, const std::string& param) {
+		return FDBBatchOperation{ type,
+			                      (const uint8_t*)k.data(),
+			                      (int)k.size(),
+			                      (const uint8_t*)param.data(),
+			                      (int)param.size(),
+			                      FDB_MUTATION_TYPE_BIT_OR };
+	};
+	std::vector<FDBBatchOperation> ops = {
+		op(FDB_BATCH_OPERATION_SET, c, three),     op(FDB_BATCH_OPERATION_GET, c, none),
+		op(FDB_BATCH_OPERATION_CLEAR, a, none),    op(FDB_BATCH_OPERATION_GET, a, none),
+		op(FDB_BATCH_OPERATION_GET, b, none),      op(FDB_BATCH_OPERATION_CLEAR_RANGE, b, c),
+		op(FDB_BATCH_OPERATION_GET, b, none),      op(FDB_BATCH_OPERATION_ATOMIC_OP, d, one),
+		op(FDB_BATCH_OPERATION_GET, d, none),
+	};
+
+	fdb::Transaction tr(db);
+	while (1) {
+		fdb::KeyValueArrayFuture f1 = tr.batch(ops, /* snapshot */ false);
+
+		fdb_error_t err = wait_future(f1);
+		if (err) {
+			fdb::EmptyFuture f2 = tr.on_error(err);
+			fdb_check(wait_future(f2));
+			continue;
+		}
+
+		FDBKeyValue const* out_kv;
+		int out_count;
+		int out_more;
+		fdb_check(f1.get(&out_kv, &out_count, &out_more));
+
+		// Each read sees the writes before it, and none of those after it
+		std::vector<std::pair<std::string, std::string>> expected = { { c, "3" }, { b, "2" }, { d, "1" } };
+		CHECK(out_count == expected.size());
+		for (int i = 0; i < out_count && i < expected.size(); ++i) {
+			CHECK(std::string((const char*)out_kv[i].key, out_kv[i].key_length) == expected[i].first);
+			CHECK(std::string((const char*)out_kv[i].value, out_kv[i].value_length) == expected[i].second);
+		}
+
+		fdb::EmptyFuture f2 = tr.commit();
+		err = wait_future(f2);
+		if (err) {
+			fdb::EmptyFuture f3 = tr.on_error(err);
+			fdb_check(wait_future(f3));
+			continue;
+		}
+		break;
+	}
+
+	// An inverted range is an error of the batch and of the commit
+	fdb::Transaction tr2(db);
+	std::vector<FDBBatchOperation> inverted = { op(FDB_BATCH_OPERATION_CLEAR_RANGE, c, a) };
+	fdb::KeyValueArrayFuture f4 = tr2.batch(inverted, /* snapshot */ false);
+	CHECK(wait_future(f4) == 2005); // inverted_range
+	fdb::EmptyFuture f5 = tr2.commit();
+	CHECK(wait_future(f5) == 2005);
+}
+
 TEST_CASE("cannot read system key") {
 	fdb::Transaction tr(db);
 
@@ -1970,6 +2198,67 @@ TEST_CASE("fdb_database_get_server_protocol") {
 	fdb_future_destroy(protocolFuture);
 }
 
+TEST_CASE("fdb_database_get_metrics") {
+	insert_data(db, { { key("metrics"), "1" } });
+
+	fdb::KeyFuture f = fdb::Database::get_metrics(db);
+	fdb_check(wait_future(f));
+	const uint8_t* metrics;
+	int metricsLength;
+	fdb_check(f.get(&metrics, &metricsLength));
+
+	rapidjson::Document metricsJson;
+	metricsJson.Parse(std::string((const char*)metrics, metricsLength).c_str());
+	REQUIRE(!metricsJson.HasParseError());
+	CHECK(metricsJson["Counters"]["CommitCompleted"].GetInt64() >= 1);
+
+	for (const char* name : { "Transaction", "GRV", "Read", "Commit" }) {
+		const auto& histogram = metricsJson["Latencies"][name];
+		int64_t samples = 0;
+		for (const auto& bucket : histogram["Buckets"].GetArray()) {
+			samples += bucket[1].GetInt64();
+		}
+		CHECK(samples == histogram["Count"].GetInt64());
+	}
+	CHECK(metricsJson["Latencies"]["Commit"]["Count"].GetInt64() >= 1);
+}
+
+TEST_CASE("fdb_database_get_transaction_profiles") {
+	int64_t bufferSize = 10;
+	fdb_check(fdb_database_set_option(
+	    db, FDB_DB_OPTION_TRANSACTION_PROFILE_BUFFER_SIZE, (const uint8_t*)&bufferSize, sizeof(bufferSize)));
+	insert_data(db, { { key("profile"), "1" } });
+	CHECK(get_value(key("profile"), /* snapshot */ false, {}) == "1");
+
+	fdb::KeyFuture f = fdb::Database::get_transaction_profiles(db);
+	fdb_check(wait_future(f));
+	const uint8_t* profiles;
+	int profilesLength;
+	fdb_check(f.get(&profiles, &profilesLength));
+
+	rapidjson::Document profilesJson;
+	profilesJson.Parse(std::string((const char*)profiles, profilesLength).c_str());
+	REQUIRE(!profilesJson.HasParseError());
+	const auto& transactions = profilesJson["Transactions"].GetArray();
+	CHECK(transactions.Size() <= 10);
+
+	bool committed = false;
+	bool read = false;
+	for (const auto& transaction : transactions) {
+		CHECK(transaction["Duration"].GetDouble() >= 0);
+		committed = committed || transaction.HasMember("CommitLatency");
+		for (const auto& r : transaction["Reads"].GetArray()) {
+			read = read || std::string(r["Type"].GetString()) == "Get";
+		}
+	}
+	CHECK(committed);
+	CHECK(read);
+
+	bufferSize = 0;
+	fdb_check(fdb_database_set_option(
+	    db, FDB_DB_OPTION_TRANSACTION_PROFILE_BUFFER_SIZE, (const uint8_t*)&bufferSize, sizeof(bufferSize)));
+}
+
 TEST_CASE("fdb_transaction_watch read_your_writes_disable") {
 	// Watches created on a transaction with the option READ_YOUR_WRITES_DISABLE
 	// should return a watches_disabled error.
@@ -2102,6 +2391,36 @@ TEST_CASE("fdb_transaction_watch") {
 	}
 }
 
+TEST_CASE("fdb_transaction_watch_range") {
+	insert_data(db, create_data({ { "foo", "foo" } }));
+
+	fdb::Transaction tr(db);
+	fdb::EmptyFuture f1 = tr.watch_range(key("foo"), key("fo"));
+	CHECK(wait_future(f1) == 2005); // inverted_range
+
+	while (1) {
+		// The watch fires on changes after the read version, so get one before making the change
+		fdb::Int64Future f2 = tr.get_read_version();
+		fdb_error_t err = wait_future(f2);
+		if (err) {
+			fdb::EmptyFuture f3 = tr.on_error(err);
+			fdb_check(wait_future(f3));
+			continue;
+		}
+		fdb::EmptyFuture f4 = tr.watch_range(key("foo"), key("fop"));
+
+		// Setting a key inside the range, without committing tr, triggers the watch
+		insert_data(db, create_data({ { "foo", "foo" }, { "foo1", "bar" } }));
+		err = wait_future(f4);
+		if (err) {
+			fdb::EmptyFuture f5 = tr.on_error(err);
+			fdb_check(wait_future(f5));
+			continue;
+		}
+		break;
+	}
+}
+
 TEST_CASE("fdb_transaction_cancel") {
 	// Cannot use transaction after cancelling it...
 	fdb::Transaction tr(db);
@@ -315,6 +315,42 @@ func ExampleRangeIterator() {
 	// cherry is baz
 }
 
+func ExampleRangeBatchIterator() {
+	fdb.MustAPIVersion(API_VERSION)
+	db := fdb.MustOpenDefault()
+
+	tr, e := db.CreateTransaction()
+	if e != nil {
+		fmt.Printf("Unable to create transaction: %v\n", e)
+		return
+	}
+
+	// Clear and initialize data in this transaction. In examples we do not
+	// commit transactions to avoid mutating a real database.
+	tr.ClearRange(fdb.KeyRange{fdb.Key(""), fdb.Key{0xFF}})
+	tr.Set(fdb.Key("apple"), []byte("foo"))
+	tr.Set(fdb.Key("cherry"), []byte("baz"))
+	tr.Set(fdb.Key("banana"), []byte("bar"))
+
+	rr := tr.GetRange(fdb.KeyRange{fdb.Key(""), fdb.Key{0xFF}}, fdb.RangeOptions{Limit: 2})
+	bi := rr.BatchIterator()
+	defer bi.Close()
+
+	// The keys and values of a batch are only valid until the next call to Next
+	for bi.Next() {
+		for _, kv := range bi.KeyValues() {
+			fmt.Printf("%s is %s\n", kv.Key, kv.Value)
+		}
+	}
+	if e := bi.Err(); e != nil {
+		fmt.Printf("Unable to read range: %v\n", e)
+	}
+
+	// Output:
+	// apple is foo
+	// banana is bar
+}
+
 func TestKeyToString(t *testing.T) {
 	cases := []struct {
 		key    fdb.Key
@@ -39,6 +39,7 @@ package fdb
 import "C"
 
 import (
+	"encoding/binary"
 	"runtime"
 	"sync"
 	"unsafe"
@@ -107,10 +108,21 @@ func fdb_future_block_until_ready(f *C.FDBFuture) {
 	//
 	// See https://groups.google.com/forum/#!topic/golang-nuts/SPjQEcsdORA
 	// for the history of why this pattern came to be used.
-	m := &sync.Mutex{}
-	m.Lock()
+	//
+	// The mutexes are pooled while locked, since that is the state the
+	// second call to lock leaves them in.
+	m := blockMutexes.Get().(*sync.Mutex)
 	C.go_set_callback(unsafe.Pointer(f), unsafe.Pointer(m))
 	m.Lock()
+	blockMutexes.Put(m)
+}
+
+var blockMutexes = sync.Pool{
+	New: func() interface{} {
+		m := &sync.Mutex{}
+		m.Lock()
+		return m
+	},
 }
 
 func (f *future) BlockUntilReady() {
@@ -300,26 +312,70 @@ func (f *futureKeyValueArray) Get() ([]KeyValue, bool, error) {
 
 	f.BlockUntilReady()
 
-	var kvs *C.FDBKeyValue
+	var length C.int
 	var count C.int
 	var more C.fdb_bool_t
 
-	if err := C.fdb_future_get_keyvalue_array(f.ptr, &kvs, &count, &more); err != 0 {
+	// The keys and values are copied out of the C library in a single block, and sliced from it
+	if err := C.fdb_future_get_keyvalue_block(f.ptr, nil, 0, &length, &count, &more); err != 0 {
 		return nil, false, Error{int(err)}
 	}
 
+	block := make([]byte, int(length))
+	if length > 0 {
+		ptr := (*C.uint8_t)(unsafe.Pointer(&block[0]))
+		if err := C.fdb_future_get_keyvalue_block(f.ptr, ptr, length, &length, &count, &more); err != 0 {
+			return nil, false, Error{int(err)}
+		}
+	}
+
 	ret := make([]KeyValue, int(count))
 
 	for i := 0; i < int(count); i++ {
-		kvptr := unsafe.Pointer(uintptr(unsafe.Pointer(kvs)) + uintptr(i*24))
-
-		ret[i].Key = stringRefToSlice(kvptr)
-		ret[i].Value = stringRefToSlice(unsafe.Pointer(uintptr(kvptr) + 12))
+		ret[i].Key, block = sliceKeyValueBlock(block)
+		ret[i].Value, block = sliceKeyValueBlock(block)
 	}
 
 	return ret, (more != 0), nil
 }
 
+// borrowKeyValues appends the count key-value pairs of the FDBKeyValue array
+// at ptr to kvs without copying them, so they are only valid as long as the
+// future that holds the array.
+//
+//go:nocheckptr
+func borrowKeyValues(kvs []KeyValue, ptr unsafe.Pointer, count int) []KeyValue {
+	// FDBKeyValue is packed, so its value is at offset 12 and it takes 24 bytes
+	for i := 0; i < count; i++ {
+		kv := unsafe.Pointer(uintptr(ptr) + uintptr(i*24))
+		kvs = append(kvs, KeyValue{borrowStringRef(kv), borrowStringRef(unsafe.Pointer(uintptr(kv) + 12))})
+	}
+	return kvs
+}
+
+// borrowStringRef is stringRefToSlice without the copy.
+//
+//go:nocheckptr
+func borrowStringRef(ptr unsafe.Pointer) []byte {
+	size := int(*((*C.int)(unsafe.Pointer(uintptr(ptr) + 8))))
+
+	if size == 0 {
+		return []byte{}
+	}
+
+	src := *(*unsafe.Pointer)(ptr)
+
+	return (*[1 << 30]byte)(src)[:size:size]
+}
+
+// sliceKeyValueBlock returns the length-prefixed key or value at the start of
+// a block from fdb_future_get_keyvalue_block, and the rest of the block.
+func sliceKeyValueBlock(block []byte) ([]byte, []byte) {
+	size := int(binary.LittleEndian.Uint32(block))
+	block = block[4:]
+	return block[:size:size], block[size:]
+}
+
 // FutureKeyArray represents the asynchronous result of a function
 // that returns an array of keys. FutureKeyArray is a lightweight object
 // that may be efficiently copied, and is safe for concurrent use by multiple goroutines.
@@ -362,6 +362,11 @@ func (o DatabaseOptions) SetDatacenterId(param string) error {
 	return o.setOpt(22, []byte(param))
 }
 
+// Read from storage servers in the same zone as this client, as given by the machine_id option, ahead of those in other zones of its datacenter. Another replica is still used while the local one is failed, has more than LOAD_BALANCE_ZONE_LOCAL_MAX_OUTSTANDING of this client's requests outstanding or is replying slower than LOAD_BALANCE_ZONE_LOCAL_MAX_LATENCY seconds. The bytes read in and outside of the zone are reported as ZoneLocalBytesRead and CrossZoneBytesRead in TransactionMetrics.
+func (o DatabaseOptions) SetPreferZoneLocalReads() error {
+	return o.setOpt(23, nil)
+}
+
 // Snapshot read operations will see the results of writes done in the same transaction. This is the default behavior.
 func (o DatabaseOptions) SetSnapshotRywEnable() error {
 	return o.setOpt(26, nil)
@@ -372,6 +377,13 @@ func (o DatabaseOptions) SetSnapshotRywDisable() error {
 	return o.setOpt(27, nil)
 }
 
+// Keeps a profile of the client-side latencies of each of the most recent transaction attempts made from this database, which can be read back with ``fdb_database_get_transaction_profiles``. Nothing is written to the cluster. The default of 0 disables profiling, and lowering the value discards the oldest profiles beyond it.
+//
+// Parameter: Number of transaction attempts to keep profiles for.
+func (o DatabaseOptions) SetTransactionProfileBufferSize(param int64) error {
+	return o.setOpt(30, int64ToBytes(param))
+}
+
 // Sets the maximum escaped length of key and value fields to be logged to the trace file via the LOG_TRANSACTION option. This sets the ``transaction_logging_max_field_length`` option of each transaction created by this database. See the transaction option description for more information.
 //
 // Parameter: Maximum length of escaped key and value fields.
@@ -709,6 +721,13 @@ func (o TransactionOptions) SetUseGrvCache() error {
 	return o.setOpt(1101, nil)
 }
 
+// Allows this transaction to use a cached GRV from the database context, as with use_grv_cache, but only if the cached read version was obtained no more than the given number of milliseconds ago. Otherwise the transaction gets a fresh read version. Values larger than the client's maximum version cache lag behave like use_grv_cache. Valid parameter values are ``[0, INT_MAX]``. The disable_client_bypass option must also be set.
+//
+// Parameter: value in milliseconds of the oldest acceptable cached read version
+func (o TransactionOptions) SetMaxGrvCacheStaleness(param int64) error {
+	return o.setOpt(1103, int64ToBytes(param))
+}
+
 // Attach given authorization token to the transaction such that subsequent tenant-aware requests are authorized
 //
 // Parameter: A JSON Web Token authorized to access data belonging to one or more tenants, indicated by 'tenants' claim of the token's payload.
@@ -850,6 +869,11 @@ func (t Transaction) CompareAndClear(key KeyConvertible, param []byte) {
 	t.atomicOp(key.FDBKey(), param, 20)
 }
 
+// Sets many keys under the versionstamp of the transaction, as one mutation with a single write conflict range, for appending to queues at a high rate. ``key`` is given as for ``set_versionstamped_key``, but must have two more bytes after the 10 byte versionstamp. The ``i``-th of the values in ``param``, counting from 0, is set at the key given by filling in the versionstamp and replacing those two bytes with ``i`` as a big-Endian 16-bit integer, which is where the Tuple layer stores the user version of a versionstamp. Up to 65536 values can be set this way, each within the usual value size limit.
+func (t Transaction) SetVersionstampedKeys(key KeyConvertible, param []byte) {
+	t.atomicOp(key.FDBKey(), param, 24)
+}
+
 type conflictRangeType int
 
 const (
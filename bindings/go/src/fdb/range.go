@@ -22,8 +22,14 @@
 
 package fdb
 
+// #define FDB_API_VERSION 740
+// #include <foundationdb/fdb_c.h>
+import "C"
+
 import (
 	"fmt"
+	"runtime"
+	"unsafe"
 )
 
 // KeyValue represents a single key-value pair in the database.
@@ -285,6 +291,135 @@ func (ri *RangeIterator) MustGet() KeyValue {
 	return kv
 }
 
+// BatchIterator returns a RangeBatchIterator over the key-value pairs
+// satisfying the range specified in the read that returned this RangeResult.
+func (rr RangeResult) BatchIterator() *RangeBatchIterator {
+	bi := &RangeBatchIterator{
+		t:         rr.t,
+		sr:        rr.sr,
+		options:   rr.options,
+		snapshot:  rr.snapshot,
+		iteration: 1,
+		first:     rr.f,
+		pending:   rr.f.ptr,
+	}
+	runtime.SetFinalizer(bi, (*RangeBatchIterator).Close)
+	return bi
+}
+
+// RangeBatchIterator returns the key-value pairs in the database satisfying
+// the range specified in a range read a batch at a time, without copying them
+// out of the FoundationDB client or allocating for each batch. The next batch
+// is read while the current one is being processed. RangeBatchIterator is
+// constructed with the (RangeResult).BatchIterator method.
+//
+// The keys and values returned by KeyValues refer to memory owned by the
+// client, and are only valid until the next call to Next or Close. They must
+// be copied to be kept any longer, and must never be modified.
+//
+// RangeBatchIterator should not be copied or used concurrently from multiple
+// goroutines, and should not be returned from a transactional function passed
+// to the Transact method of a Transactor. Calling Close once done with it
+// releases the client's memory right away instead of when it is garbage
+// collected.
+type RangeBatchIterator struct {
+	t         *transaction
+	sr        SelectorRange
+	options   RangeOptions
+	snapshot  bool
+	iteration int
+	// first keeps the read started by the RangeResult, which the iterator
+	// shares and so never destroys (every later one is its own), alive
+	first   *futureKeyValueArray
+	current *C.FDBFuture
+	pending *C.FDBFuture
+	kvs     []KeyValue
+	err     error
+}
+
+// Next waits for the next batch of key-value pairs, and returns true if there
+// is one, or false if the range has been exhausted or a read did not
+// successfully complete.
+func (bi *RangeBatchIterator) Next() bool {
+	defer runtime.KeepAlive(bi)
+
+	bi.releaseCurrent()
+	if bi.pending == nil {
+		return false
+	}
+	bi.current, bi.pending = bi.pending, nil
+
+	fdb_future_block_until_ready(bi.current)
+
+	var kvs *C.FDBKeyValue
+	var count C.int
+	var more C.fdb_bool_t
+
+	if err := C.fdb_future_get_keyvalue_array(bi.current, &kvs, &count, &more); err != 0 {
+		bi.err = Error{int(err)}
+		return false
+	}
+
+	bi.kvs = borrowKeyValues(bi.kvs[:0], unsafe.Pointer(kvs), int(count))
+	if count == 0 {
+		return false
+	}
+
+	if more != 0 && int(count) != bi.options.Limit {
+		if bi.options.Limit > 0 {
+			bi.options.Limit -= int(count)
+		}
+		// The selector's key is copied by the client before the batch it
+		// refers to can be released
+		if bi.options.Reverse {
+			bi.sr.End = FirstGreaterOrEqual(bi.kvs[count-1].Key)
+		} else {
+			bi.sr.Begin = FirstGreaterThan(bi.kvs[count-1].Key)
+		}
+		bi.iteration++
+		bi.pending = bi.t.startGetRange(bi.sr, bi.options, bi.snapshot, bi.iteration)
+	}
+
+	return true
+}
+
+// KeyValues returns the batch of key-value pairs read by the last call to
+// Next that returned true. They are only valid until the next call to Next or
+// Close.
+func (bi *RangeBatchIterator) KeyValues() []KeyValue {
+	return bi.kvs
+}
+
+// Err returns the error that made Next return false, or nil if the range was
+// exhausted.
+func (bi *RangeBatchIterator) Err() error {
+	return bi.err
+}
+
+// Close releases the current batch and cancels the read of the next one.
+func (bi *RangeBatchIterator) Close() {
+	bi.releaseCurrent()
+	if bi.pending != nil && (bi.first == nil || bi.pending != bi.first.ptr) {
+		C.fdb_future_destroy(bi.pending)
+	}
+	bi.pending = nil
+	bi.first = nil
+	runtime.SetFinalizer(bi, nil)
+}
+
+func (bi *RangeBatchIterator) releaseCurrent() {
+	bi.kvs = bi.kvs[:0]
+	if bi.current == nil {
+		return
+	}
+	if bi.first != nil && bi.current == bi.first.ptr {
+		bi.first = nil
+	} else {
+		C.fdb_future_destroy(bi.current)
+	}
+	bi.current = nil
+}
+
 // Strinc returns the first key that would sort outside the range prefixed by
 // prefix, or an error if prefix is empty or contains only 0xFF bytes.
 func Strinc(prefix []byte) ([]byte, error) {
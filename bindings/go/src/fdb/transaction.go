@@ -266,30 +266,35 @@ func (t Transaction) Get(key KeyConvertible) FutureByteSlice {
 }
 
 func (t *transaction) doGetRange(r Range, options RangeOptions, snapshot bool, iteration int) futureKeyValueArray {
+	return futureKeyValueArray{future: newFuture(t, t.startGetRange(r, options, snapshot, iteration))}
+}
+
+// startGetRange returns the bare C future of a range read, which the caller
+// must destroy.
+func (t *transaction) startGetRange(r Range, options RangeOptions, snapshot bool, iteration int) *C.FDBFuture {
 	begin, end := r.FDBRangeKeySelectors()
 	bsel := begin.FDBKeySelector()
 	esel := end.FDBKeySelector()
 	bkey := bsel.Key.FDBKey()
 	ekey := esel.Key.FDBKey()
 
-	return futureKeyValueArray{
-		future: newFuture(t, C.fdb_transaction_get_range(
-			t.ptr,
-			byteSliceToPtr(bkey),
-			C.int(len(bkey)),
-			C.fdb_bool_t(boolToInt(bsel.OrEqual)),
-			C.int(bsel.Offset),
-			byteSliceToPtr(ekey),
-			C.int(len(ekey)),
-			C.fdb_bool_t(boolToInt(esel.OrEqual)),
-			C.int(esel.Offset),
-			C.int(options.Limit),
-			C.int(0),
-			C.FDBStreamingMode(options.Mode-1),
-			C.int(iteration),
-			C.fdb_bool_t(boolToInt(snapshot)),
-			C.fdb_bool_t(boolToInt(options.Reverse)),
-		))}
+	return C.fdb_transaction_get_range(
+		t.ptr,
+		byteSliceToPtr(bkey),
+		C.int(len(bkey)),
+		C.fdb_bool_t(boolToInt(bsel.OrEqual)),
+		C.int(bsel.Offset),
+		byteSliceToPtr(ekey),
+		C.int(len(ekey)),
+		C.fdb_bool_t(boolToInt(esel.OrEqual)),
+		C.int(esel.Offset),
+		C.int(options.Limit),
+		C.int(0),
+		C.FDBStreamingMode(options.Mode-1),
+		C.int(iteration),
+		C.fdb_bool_t(boolToInt(snapshot)),
+		C.fdb_bool_t(boolToInt(options.Reverse)),
+	)
 }
 
 func (t *transaction) getRange(r Range, options RangeOptions, snapshot bool) RangeResult {
@@ -21,6 +21,7 @@
 #include <jni.h>
 #include <string.h>
 #include <functional>
+#include <vector>
 
 #include "com_apple_foundationdb_FDB.h"
 #include "com_apple_foundationdb_FDBDatabase.h"
@@ -180,23 +181,28 @@ void safeThrow(JNIEnv* jenv, jthrowable t) {
 	}
 }
 
-JNIEXPORT void JNICALL Java_com_apple_foundationdb_NativeFuture_Future_1registerCallback(JNIEnv* jenv,
-                                                                                         jobject cls,
-                                                                                         jlong future,
-                                                                                         jobject callback) {
+JNIEXPORT jboolean JNICALL Java_com_apple_foundationdb_NativeFuture_Future_1registerCallback(JNIEnv* jenv,
+                                                                                             jobject cls,
+                                                                                             jlong future,
+                                                                                             jobject callback) {
 	// SOMEDAY: Do this on module load instead. Can we cache method ids across threads?
 	if (!g_IFutureCallback_call_methodID) {
 		if (!findCallbackMethods(jenv)) {
-			return;
+			return JNI_FALSE;
 		}
 	}
 
 	if (!future || !callback) {
 		throwParamNotNull(jenv);
-		return;
+		return JNI_FALSE;
 	}
 	FDBFuture* f = (FDBFuture*)future;
 
+	// The caller completes a ready future itself, rather than through the callback and its executor
+	if (fdb_future_is_ready(f)) {
+		return JNI_FALSE;
+	}
+
 	// This is documented as not throwing, but simply returning null on OOM.
 	//  As belt and suspenders, we will check for pending exceptions and then,
 	//  if there are none and the result is null, we'll throw our own OOM.
@@ -204,7 +210,7 @@ JNIEXPORT void JNICALL Java_com_apple_foundationdb_NativeFuture_Future_1register
 	if (!callback) {
 		if (!jenv->ExceptionOccurred())
 			throwOutOfMem(jenv);
-		return;
+		return JNI_TRUE;
 	}
 
 	// Here we cache a thread-local reference to jenv
@@ -214,6 +220,7 @@ JNIEXPORT void JNICALL Java_com_apple_foundationdb_NativeFuture_Future_1register
 		jenv->DeleteGlobalRef(callback);
 		safeThrow(jenv, getThrowable(jenv, err));
 	}
+	return JNI_TRUE;
 }
 
 JNIEXPORT void JNICALL Java_com_apple_foundationdb_NativeFuture_Future_1blockUntilReady(JNIEnv* jenv,
@@ -1518,6 +1525,43 @@ JNIEXPORT jlong JNICALL Java_com_apple_foundationdb_FDBTransaction_Transaction_1
 	return (jlong)f;
 }
 
+JNIEXPORT jlong JNICALL Java_com_apple_foundationdb_FDBTransaction_Transaction_1getMulti(JNIEnv* jenv,
+                                                                                         jobject,
+                                                                                         jlong tPtr,
+                                                                                         jobjectArray keys,
+                                                                                         jboolean snapshot) {
+	if (!tPtr || !keys) {
+		throwParamNotNull(jenv);
+		return 0;
+	}
+	FDBTransaction* tr = (FDBTransaction*)tPtr;
+
+	// Every key is copied into one block, so that the whole read takes a single crossing
+	int count = jenv->GetArrayLength(keys);
+	std::vector<int> lengths(count);
+	std::vector<uint8_t> block;
+	for (int i = 0; i < count; i++) {
+		jbyteArray key = (jbyteArray)jenv->GetObjectArrayElement(keys, i);
+		if (!key) {
+			if (!jenv->ExceptionOccurred())
+				throwParamNotNull(jenv);
+			return 0;
+		}
+		lengths[i] = jenv->GetArrayLength(key);
+		block.resize(block.size() + lengths[i]);
+		jenv->GetByteArrayRegion(key, 0, lengths[i], (jbyte*)block.data() + block.size() - lengths[i]);
+		jenv->DeleteLocalRef(key);
+	}
+
+	std::vector<const uint8_t*> names(count);
+	for (int i = 0, offset = 0; i < count; offset += lengths[i++]) {
+		names[i] = block.data() + offset;
+	}
+
+	FDBFuture* f = fdb_transaction_get_multi(tr, names.data(), lengths.data(), count, (fdb_bool_t)snapshot);
+	return (jlong)f;
+}
+
 JNIEXPORT jlong JNICALL Java_com_apple_foundationdb_FDBTransaction_Transaction_1getKey(JNIEnv* jenv,
                                                                                        jobject,
                                                                                        jlong tPtr,
@@ -1954,6 +1998,28 @@ JNIEXPORT void JNICALL Java_com_apple_foundationdb_FDBTransaction_Transaction_1s
 	jenv->ReleaseByteArrayElements(valueBytes, (jbyte*)barrValue, JNI_ABORT);
 }
 
+JNIEXPORT void JNICALL Java_com_apple_foundationdb_FDBTransaction_Transaction_1setDirect(JNIEnv* jenv,
+                                                                                         jobject,
+                                                                                         jlong tPtr,
+                                                                                         jobject buffer,
+                                                                                         jint keyLength,
+                                                                                         jint valueLength) {
+	if (!tPtr || !buffer) {
+		throwParamNotNull(jenv);
+		return;
+	}
+	FDBTransaction* tr = (FDBTransaction*)tPtr;
+
+	uint8_t* data = (uint8_t*)jenv->GetDirectBufferAddress(buffer);
+	if (!data) {
+		if (!jenv->ExceptionOccurred())
+			throwRuntimeEx(jenv, "Error getting handle to native resources");
+		return;
+	}
+
+	fdb_transaction_set(tr, data, keyLength, data + keyLength, valueLength);
+}
+
 JNIEXPORT void JNICALL Java_com_apple_foundationdb_FDBTransaction_Transaction_1clear__J_3B(JNIEnv* jenv,
                                                                                            jobject,
                                                                                            jlong tPtr,
@@ -19,6 +19,8 @@
  */
 package com.apple.foundationdb;
 
+import java.util.Arrays;
+import java.util.List;
 import java.util.concurrent.CompletableFuture;
 import java.util.concurrent.CompletionException;
 import java.util.function.Consumer;
@@ -61,6 +63,33 @@ public class TransactionIntegrationTest {
         }
     }
 
+    @Test
+    public void testGetMultiAndDirectSet() throws Exception {
+        try (Database db = fdb.open()) {
+            for (boolean direct : new boolean[] { false, true }) {
+                fdb.enableDirectBufferQuery(direct);
+                try (Transaction tr = db.createTransaction()) {
+                    tr.clear(Range.startsWith("getMulti/".getBytes()));
+                    tr.set("getMulti/a".getBytes(), "1".getBytes());
+                    tr.set("getMulti/c".getBytes(), "3".getBytes());
+
+                    // Absent and repeated keys keep their places
+                    List<byte[]> values = tr.getMulti(Arrays.asList("getMulti/c".getBytes(), "getMulti/b".getBytes(),
+                                                                    "getMulti/a".getBytes(), "getMulti/c".getBytes()))
+                                              .join();
+                    Assertions.assertEquals(4, values.size());
+                    Assertions.assertArrayEquals("3".getBytes(), values.get(0));
+                    Assertions.assertNull(values.get(1));
+                    Assertions.assertArrayEquals("1".getBytes(), values.get(2));
+                    Assertions.assertArrayEquals("3".getBytes(), values.get(3));
+                    Assertions.assertArrayEquals("1".getBytes(), tr.get("getMulti/a".getBytes()).join());
+                } finally {
+                    fdb.enableDirectBufferQuery(false);
+                }
+            }
+        }
+    }
+
     private void doTestOperationsAfterCommit(Transaction tr) {
         tr.set("key1".getBytes(), "val1".getBytes());
         CompletableFuture<Void> commitFuture = tr.commit();
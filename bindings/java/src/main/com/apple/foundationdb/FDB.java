@@ -234,9 +234,10 @@ public class FDB {
 	}
 
 	/**
-	 * Enables or disables use of DirectByteBuffers for getRange() queries.
+	 * Enables or disables use of DirectByteBuffers for getRange() and getMulti() queries, and
+	 *  for passing keys and values to set().
 	 *
-	 *	@param enabled Whether DirectByteBuffer should be used for getRange() queries.
+	 *	@param enabled Whether DirectByteBuffer should be used for getRange(), getMulti() and set().
 	 */
 	public void enableDirectBufferQuery(boolean enabled) {
 		enableDirectBufferQueries = enabled;
@@ -20,6 +20,10 @@
 
 package com.apple.foundationdb;
 
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
 import java.util.concurrent.CompletableFuture;
 import java.util.concurrent.CompletionException;
 import java.util.concurrent.ExecutionException;
@@ -67,6 +71,11 @@ class FDBTransaction extends NativeObjectWrapper implements Transaction, OptionC
 			return get_internal(key, true);
 		}
 
+		@Override
+		public CompletableFuture<List<byte[]>> getMulti(List<byte[]> keys) {
+			return getMulti_internal(keys, true);
+		}
+
 		@Override
 		public CompletableFuture<byte[]> getKey(KeySelector selector) {
 			return getKey_internal(selector, true);
@@ -296,6 +305,45 @@ class FDBTransaction extends NativeObjectWrapper implements Transaction, OptionC
 		}
 	}
 
+	@Override
+	public CompletableFuture<List<byte[]>> getMulti(List<byte[]> keys) {
+		return getMulti_internal(keys, false);
+	}
+
+	private CompletableFuture<List<byte[]>> getMulti_internal(List<byte[]> keys, boolean isSnapshot) {
+		byte[][] keyArray = keys.toArray(new byte[0][]);
+		for (byte[] key : keyArray) {
+			if (key == null)
+				throw new IllegalArgumentException("Keys must be non-null");
+		}
+		if (eventKeeper != null) {
+			eventKeeper.increment(Events.JNI_CALL);
+		}
+		FutureResults f;
+		pointerReadLock.lock();
+		try {
+			f = new FutureResults(Transaction_getMulti(getPtr(), keyArray, isSnapshot),
+			                      FDB.instance().isDirectBufferQueriesEnabled(), executor, eventKeeper);
+		} finally {
+			pointerReadLock.unlock();
+		}
+		return f.thenApply(info -> matchValues(keyArray, info.get().values)).whenComplete((values, e) -> f.close());
+	}
+
+	// The results of a multi-get are the keys that are present, in the order they were asked for
+	private static List<byte[]> matchValues(byte[][] keys, List<KeyValue> results) {
+		List<byte[]> values = new ArrayList<>(keys.length);
+		int next = 0;
+		for (byte[] key : keys) {
+			if (next < results.size() && Arrays.equals(results.get(next).getKey(), key)) {
+				values.add(results.get(next++).getValue());
+			} else {
+				values.add(null);
+			}
+		}
+		return values;
+	}
+
 	/**
 	 * {@inheritDoc}
 	 */
@@ -565,11 +613,25 @@ class FDBTransaction extends NativeObjectWrapper implements Transaction, OptionC
 		if (eventKeeper != null) {
 			eventKeeper.increment(Events.JNI_CALL);
 		}
+		// Copying into a pooled direct buffer saves the JNI call from pinning or copying each array
+		ByteBuffer buffer = FDB.instance().isDirectBufferQueriesEnabled() &&
+		                            key.length + value.length <= DirectBufferPool.MIN_BUFFER_SIZE
+		                        ? DirectBufferPool.getInstance().poll()
+		                        : null;
 		pointerReadLock.lock();
 		try {
-			Transaction_set(getPtr(), key, value);
+			if (buffer != null) {
+				buffer.clear();
+				buffer.put(key).put(value);
+				Transaction_setDirect(getPtr(), buffer, key.length, value.length);
+			} else {
+				Transaction_set(getPtr(), key, value);
+			}
 		} finally {
 			pointerReadLock.unlock();
+			if (buffer != null) {
+				DirectBufferPool.getInstance().add(buffer);
+			}
 		}
 	}
 
@@ -835,7 +897,9 @@ class FDBTransaction extends NativeObjectWrapper implements Transaction, OptionC
 	                                               boolean isSnapshot, boolean reverse);
 	private native void Transaction_addConflictRange(long cPtr,
 			byte[] keyBegin, byte[] keyEnd, int conflictRangeType);
+	private native long Transaction_getMulti(long cPtr, byte[][] keys, boolean isSnapshot);
 	private native void Transaction_set(long cPtr, byte[] key, byte[] value);
+	private native void Transaction_setDirect(long cPtr, ByteBuffer buffer, int keyLength, int valueLength);
 	private native void Transaction_clear(long cPtr, byte[] key);
 	private native void Transaction_clear(long cPtr, byte[] beginKey, byte[] endKey);
 	private native void Transaction_mutate(long ptr, int code, byte[] key, byte[] value);
@@ -29,9 +29,9 @@ class FutureMappedResults extends NativeFuture<MappedRangeResultInfo> {
 	private final EventKeeper eventKeeper;
 	FutureMappedResults(long cPtr, boolean enableDirectBufferQueries, Executor executor, EventKeeper eventKeeper) {
 		super(cPtr);
-		registerMarshalCallback(executor);
 		this.enableDirectBufferQueries = enableDirectBufferQueries;
 		this.eventKeeper = eventKeeper;
+		registerMarshalCallback(executor);
 	}
 
 	@Override
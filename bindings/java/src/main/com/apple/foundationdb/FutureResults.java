@@ -29,9 +29,9 @@ class FutureResults extends NativeFuture<RangeResultInfo> {
 	private final EventKeeper eventKeeper;
 	FutureResults(long cPtr, boolean enableDirectBufferQueries, Executor executor, EventKeeper eventKeeper) {
 		super(cPtr);
-		registerMarshalCallback(executor);
 		this.enableDirectBufferQueries = enableDirectBufferQueries;
 		this.eventKeeper = eventKeeper;
+		registerMarshalCallback(executor);
 	}
 
 	@Override
@@ -47,9 +47,14 @@ abstract class NativeFuture<T> extends CompletableFuture<T> implements AutoClose
 	//
 	// Note: This function guarantees the callback will be executed **at most once**.
 	//
+	// A C-future that is already ready is marshalled right away on the calling
+	// thread instead, as no network thread is involved and so there is nothing to
+	// hop off of. This saves a thread switch (or a virtual thread's trip through
+	// the executor) for reads served from the transaction's own cache.
+	//
 	protected void registerMarshalCallback(Executor executor) {
-		if(cPtr != 0) {
-			Future_registerCallback(cPtr, () -> executor.execute(this::marshalWhenDone));
+		if(cPtr != 0 && !Future_registerCallback(cPtr, () -> executor.execute(this::marshalWhenDone))) {
+			marshalWhenDone();
 		}
 	}
 
@@ -133,7 +138,8 @@ abstract class NativeFuture<T> extends CompletableFuture<T> implements AutoClose
 		return cPtr;
 	}
 
-	private native void Future_registerCallback(long cPtr, Runnable callback);
+	// Returns false without registering the callback if the future is already ready
+	private native boolean Future_registerCallback(long cPtr, Runnable callback);
 	private native void Future_blockUntilReady(long cPtr);
 	private native boolean Future_isReady(long cPtr);
 	private native void Future_dispose(long cPtr);
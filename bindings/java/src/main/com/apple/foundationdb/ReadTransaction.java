@@ -20,6 +20,7 @@
 
 package com.apple.foundationdb;
 
+import java.util.List;
 import java.util.concurrent.CompletableFuture;
 
 import com.apple.foundationdb.async.AsyncIterable;
@@ -121,6 +122,18 @@ public interface ReadTransaction extends ReadTransactionContext {
 	 */
 	CompletableFuture<byte[]> get(byte[] key);
 
+	/**
+	 * Gets the values of several keys at once. All of the keys are handed to the native client
+	 *  in a single call, and the keys served by the same storage servers are read with a
+	 *  single request.
+	 *
+	 * @param keys the keys whose values to fetch from the database
+	 *
+	 * @return a {@code CompletableFuture} which will be set to the values corresponding to
+	 *  the keys, in the order given, with null for each key that does not exist.
+	 */
+	CompletableFuture<List<byte[]>> getMulti(List<byte[]> keys);
+
 	/**
 	 * Returns the key referenced by the specified {@code KeySelector}.
 	 *  By default, the key is cached for the duration of the transaction, providing
@@ -232,6 +232,10 @@ def transactional(*tr_args, **tr_kwargs):
     After the function is complete, the newly created transaction
     will be committed.
 
+    If the function is a coroutine function (defined with async def),
+    the wrapper is one too: it awaits the function, the commit and the
+    retries, so that the event loop is never blocked.
+
     It is important to note that the wrapped method may be called
     multiple times in the event of a commit failure, until the commit
     succeeds.  This restriction requires that the wrapped function
@@ -264,7 +268,25 @@ def transactional(*tr_args, **tr_kwargs):
         else:
             index = inspect.getargspec(wfunc).args.index(parameter)
 
-        if getattr(func, "_is_coroutine", False):
+        if inspect.iscoroutinefunction(func):
+
+            @functools.wraps(func)
+            async def wrapper(*args, **kwargs):
+                if isinstance(args[index], TransactionRead):
+                    return await func(*args, **kwargs)
+
+                largs = list(args)
+                tr = largs[index] = args[index].create_transaction()
+
+                while True:
+                    try:
+                        ret = await func(*largs, **kwargs)
+                        await tr.commit()
+                        return ret
+                    except FDBError as e:
+                        await tr.on_error(e.code)
+
+        elif getattr(func, "_is_coroutine", False):
 
             @functools.wraps(func)
             def wrapper(*args, **kwargs):
@@ -446,6 +468,40 @@ class FDBRange(object):
 
             yield result
 
+    def __aiter__(self):
+        return self._aiter()
+
+    async def _aiter(self):
+        bsel = self._bsel
+        esel = self._esel
+        limit = self._limit
+
+        iteration = 1
+        future = self._future
+
+        while future:
+            (kvs, count, more) = await future
+            if not count:
+                return
+
+            # Fire off the next read before handing out this batch, so that it
+            # is in flight while the batch is processed
+            future = None
+            if more and limit != count:
+                iteration += 1
+                if limit > 0:
+                    limit = limit - count
+                if self._reverse:
+                    esel = KeySelector.first_greater_or_equal(kvs[-1].key)
+                else:
+                    bsel = KeySelector.first_greater_than(kvs[-1].key)
+                future = self._tr._get_range(
+                    bsel, esel, limit, self._mode, iteration, self._reverse
+                )
+
+            for kv in kvs:
+                yield kv
+
 
 class TransactionRead(_FDBBase):
     def __init__(self, tpointer, db, snapshot):
@@ -809,6 +865,44 @@ class Future(_FDBBase):
     def remove_done_callback(self, fn):
         raise NotImplementedError()
 
+    # native asyncio support
+    def as_asyncio_future(self, loop=None):
+        """Returns an asyncio future on loop, by default the running event
+        loop, that gets the result of wait() once this future is ready.
+        Cancelling it cancels this future."""
+        import asyncio
+
+        if loop is None:
+            loop = asyncio.get_running_loop()
+        af = loop.create_future()
+
+        def resolve(f):
+            if af.cancelled():
+                return
+            try:
+                af.set_result(f.wait())
+            except Exception as e:
+                af.set_exception(e)
+
+        def wake(f):
+            # Called from the network thread, so the asyncio future is
+            # resolved from within the loop instead
+            try:
+                loop.call_soon_threadsafe(resolve, f)
+            except RuntimeError:
+                pass  # the loop was closed, so nobody is waiting any more
+
+        def cancel(af):
+            if af.cancelled():
+                self.cancel()
+
+        af.add_done_callback(cancel)
+        self.on_ready(wake)
+        return af
+
+    def __await__(self):
+        return self.as_asyncio_future().__await__()
+
 
 class FutureVoid(Future):
     def wait(self):
@@ -833,27 +927,51 @@ class FutureUInt64(Future):
         return value.value
 
 
+_block_length = struct.Struct("<i")
+
+
 class FutureKeyValueArray(Future):
     def wait(self):
         self.block_until_ready()
-        kvs = ctypes.pointer(KeyValueStruct())
+        # The results are copied out of the library in one length-prefixed
+        # block, which is much cheaper than reading each key and value through
+        # ctypes
+        length = ctypes.c_int()
         count = ctypes.c_int()
         more = ctypes.c_int()
-        self.capi.fdb_future_get_keyvalue_array(
-            self.fpointer, ctypes.byref(kvs), ctypes.byref(count), ctypes.byref(more)
+        self.capi.fdb_future_get_keyvalue_block(
+            self.fpointer,
+            None,
+            0,
+            ctypes.byref(length),
+            ctypes.byref(count),
+            ctypes.byref(more),
         )
-        return (
-            [
-                KeyValue(
-                    ctypes.string_at(x.key, x.key_length),
-                    ctypes.string_at(x.value, x.value_length),
-                )
-                for x in kvs[0 : count.value]
-            ],
-            count.value,
-            more.value,
+        block = ctypes.create_string_buffer(length.value)
+        self.capi.fdb_future_get_keyvalue_block(
+            self.fpointer,
+            block,
+            length.value,
+            ctypes.byref(length),
+            ctypes.byref(count),
+            ctypes.byref(more),
         )
 
+        view = memoryview(block)
+        unpack = _block_length.unpack_from
+        kvs = []
+        pos = 0
+        for _ in range(count.value):
+            (key_length,) = unpack(view, pos)
+            pos += 4
+            key = view[pos : pos + key_length].tobytes()
+            pos += key_length
+            (value_length,) = unpack(view, pos)
+            pos += 4
+            kvs.append(KeyValue(key, view[pos : pos + value_length].tobytes()))
+            pos += value_length
+        return (kvs, count.value, more.value)
+
         # Logically, we should self._release_memory() after extracting the
         # KVs but before returning, but then we would have to store
         # the KVs on the python side and in most cases we are about to
@@ -1051,6 +1169,11 @@ class FormerFuture(_FDBBase):
     def wait(self):
         return self
 
+    def __await__(self):
+        # already ready, so awaiting one never suspends
+        return self
+        yield
+
     def is_ready(self):
         return True
 
@@ -1676,6 +1799,17 @@ def init_c_api():
     _capi.fdb_future_get_keyvalue_array.restype = int
     _capi.fdb_future_get_keyvalue_array.errcheck = check_error_code
 
+    _capi.fdb_future_get_keyvalue_block.argtypes = [
+        ctypes.c_void_p,
+        ctypes.c_void_p,
+        ctypes.c_int,
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_int),
+        ctypes.POINTER(ctypes.c_int),
+    ]
+    _capi.fdb_future_get_keyvalue_block.restype = int
+    _capi.fdb_future_get_keyvalue_block.errcheck = check_error_code
+
     _capi.fdb_future_get_key_array.argtypes = [
         ctypes.c_void_p,
         ctypes.POINTER(ctypes.POINTER(KeyStruct)),
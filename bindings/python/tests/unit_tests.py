@@ -20,6 +20,7 @@
 #
 
 import argparse
+import asyncio
 import os
 import sys
 import time
@@ -227,6 +228,31 @@ def test_get_client_status(db):
     assert status["Healthy"]
 
 
+def test_asyncio(db):
+    prefix = b"asyncio_test/"
+    del db[prefix : prefix + b"\xff"]
+
+    @fdb.transactional
+    async def increment(tr, key):
+        value = await tr[key]
+        tr[key] = str(int(value) + 1 if value.present() else 1).encode()
+
+    @fdb.transactional
+    async def read_all(tr):
+        return [kv async for kv in tr.get_range_startswith(prefix)]
+
+    async def run():
+        # Many of these conflict, so this also covers retrying within the loop
+        keys = [prefix + bytes([i % 10]) for i in range(200)]
+        await asyncio.gather(*[increment(db, key) for key in keys])
+        return await read_all(db)
+
+    kvs = asyncio.run(run())
+    assert [kv.key for kv in kvs] == [prefix + bytes([i]) for i in range(10)]
+    assert all(kv.value == b"20" for kv in kvs)
+    del db[prefix : prefix + b"\xff"]
+
+
 def run_unit_tests(db):
     try:
         log("test_db_options")
@@ -257,6 +283,8 @@ def run_unit_tests(db):
         test_get_approximate_size(db)
         log("test_get_client_status")
         test_get_client_status(db)
+        log("test_asyncio")
+        test_asyncio(db)
 
         if fdb.get_api_version() >= 710:
             log("test_tenants")
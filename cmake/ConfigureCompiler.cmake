@@ -46,6 +46,7 @@ if(USE_SANITIZER OR WIN32 OR (CMAKE_SYSTEM_NAME STREQUAL "FreeBSD") OR APPLE)
 endif()
 env_set(USE_JEMALLOC ${jemalloc_default} BOOL "Link with jemalloc")
 env_set(USE_CUSTOM_JEMALLOC OFF BOOL "Manually download and build jemalloc")
+env_set(FAST_ALLOC_LARGE_OBJECTS ON BOOL "Allocate actor states and coroutine frames of up to 8KiB from FastAllocator")
 
 if(USE_LIBCXX AND STATIC_LINK_LIBCXX AND NOT USE_LD STREQUAL "LLD")
   message(FATAL_ERROR "Unsupported configuration: STATIC_LINK_LIBCXX with libc++ only works if USE_LD=LLD")
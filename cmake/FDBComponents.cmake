@@ -175,6 +175,22 @@ set(WITH_ROCKSDB ON CACHE BOOL "Build with experimental RocksDB support")
 set(PORTABLE_ROCKSDB 1 CACHE STRING "Minimum CPU arch to support (i.e. skylake, haswell, etc., or 0 = current CPU, 1 = baseline CPU)")
 set(ROCKSDB_TOOLS OFF CACHE BOOL "Compile RocksDB tools")
 set(WITH_LIBURING OFF CACHE BOOL "Build with liburing enabled") # Set this to ON to include liburing
+if(WITH_LIBURING)
+  # Used by RocksDB and by AsyncFileIOUring in fdbrpc
+  find_package(uring REQUIRED)
+endif()
+
+# Switches the boost::asio reactor under Net2 from epoll to io_uring, so socket readiness waits, timers and eventfd
+# reads are all submitted through one ring per process.
+set(USE_ASIO_IO_URING OFF CACHE BOOL "Use the io_uring backend of boost::asio for the Net2 reactor (requires WITH_LIBURING)")
+if(USE_ASIO_IO_URING)
+  if(NOT WITH_LIBURING)
+    message(FATAL_ERROR "USE_ASIO_IO_URING requires WITH_LIBURING")
+  endif()
+  # This has to be seen by every translation unit that includes boost::asio, otherwise the io_context layout differs
+  # between them.
+  add_compile_definitions(BOOST_ASIO_HAS_IO_URING=1 BOOST_ASIO_DISABLE_EPOLL=1)
+endif()
 
 ################################################################################
 # TOML11
@@ -249,6 +265,8 @@ function(print_components)
   message(STATUS "Build Python sdist (make package):    ${WITH_PYTHON_BINDING}")
   message(STATUS "Configure CTest (depends on Python):  ${WITH_PYTHON}")
   message(STATUS "Build with RocksDB:                   ${WITH_ROCKSDB}")
+  message(STATUS "Build with liburing:                  ${WITH_LIBURING}")
+  message(STATUS "Use io_uring for the Net2 reactor:    ${USE_ASIO_IO_URING}")
   message(STATUS "Build with AWS SDK:                   ${WITH_AWS_BACKUP}")
   message(STATUS "=========================================")
 endfunction()
@@ -173,13 +173,14 @@ struct MutationFilesReadProgress : public ReferenceCounted<MutationFilesReadProg
 		bool decodeBlock(const Standalone<StringRef>& buf, int len, Version minVersion, Version maxVersion) {
 			StringRef block(buf.begin(), len);
 			StringRefReader reader(block, restore_corrupted_data());
+			Standalone<StringRef> messages;
 			int count = 0, inserted = 0;
 			Version msgVersion = invalidVersion;
 
 			try {
-				// Read block header
-				if (reader.consume<int32_t>() != PARTITIONED_MLOG_VERSION)
-					throw restore_unsupported_file_version();
+				// Read the block's messages, decompressing them if needed
+				messages = fileBackup::decodePartitionedLogBlock(Standalone<StringRef>(block, buf.arena()));
+				reader = StringRefReader(messages, restore_corrupted_data());
 
 				while (1) {
 					// If eof reached or first key len bytes is 0xFF then end of block was reached.
@@ -193,7 +194,7 @@ struct MutationFilesReadProgress : public ReferenceCounted<MutationFilesReadProg
 					const uint8_t* message = reader.consume(msgSize);
 
 					ArenaReader rd(
-					    buf.arena(), StringRef(message, msgSize), AssumeVersion(g_network->protocolVersion()));
+					    messages.arena(), StringRef(message, msgSize), AssumeVersion(g_network->protocolVersion()));
 					MutationRef m;
 					rd >> m;
 					count++;
@@ -207,7 +208,7 @@ struct MutationFilesReadProgress : public ReferenceCounted<MutationFilesReadProg
 					}
 					if (msgVersion >= minVersion) {
 						mutations.emplace_back(
-						    LogMessageVersion(msgVersion, sub), StringRef(message, msgSize), buf.arena());
+						    LogMessageVersion(msgVersion, sub), StringRef(message, msgSize), messages.arena());
 						inserted++;
 					}
 				}
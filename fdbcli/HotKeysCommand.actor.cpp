@@ -0,0 +1,85 @@
+/*
+ * HotKeysCommand.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fmt/format.h"
+
+#include "fdbcli/fdbcli.actor.h"
+
+#include "fdbclient/FDBOptions.g.h"
+#include "fdbclient/IClientApi.h"
+#include "fdbclient/Knobs.h"
+
+#include "flow/Arena.h"
+#include "flow/FastRef.h"
+#include "flow/ThreadHelper.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace fdb_cli {
+
+const KeyRangeRef hotKeysSpecialKeyRange =
+    KeyRangeRef("\xff\xff/metrics/hot_keys/"_sr, "\xff\xff/metrics/hot_keys0"_sr);
+
+ACTOR Future<bool> hotKeysCommandActor(Reference<IDatabase> db, std::vector<StringRef> tokens) {
+	if (tokens.size() > 2 || (tokens.size() == 2 && !tokencmp(tokens[1], "reads") && !tokencmp(tokens[1], "writes"))) {
+		printUsage(tokens[0]);
+		return false;
+	}
+	state Optional<std::string> kind;
+	if (tokens.size() == 2) {
+		kind = tokencmp(tokens[1], "reads") ? "read" : "write";
+	}
+
+	state Reference<ITransaction> tr = db->createTransaction();
+	loop {
+		try {
+			state ThreadFuture<RangeResult> hotKeysFuture =
+			    tr->getRange(hotKeysSpecialKeyRange, CLIENT_KNOBS->TOO_MANY);
+			RangeResult hotKeys = wait(safeThreadFutureToFuture(hotKeysFuture));
+			int printed = 0;
+			for (auto const& kv : hotKeys) {
+				// <storage server id>/<read|write>/<rank>
+				std::string name = kv.key.removePrefix(hotKeysSpecialKeyRange.begin).toString();
+				if (kind.present() && name.find("/" + kind.get() + "/") == std::string::npos) {
+					continue;
+				}
+				fmt::print("{} {}\n", name, kv.value.toString());
+				printed++;
+			}
+			if (!printed) {
+				fmt::print("No hot keys were reported by the storage servers.\n");
+			}
+			return true;
+		} catch (Error& e) {
+			wait(safeThreadFutureToFuture(tr->onError(e)));
+		}
+	}
+}
+
+CommandFactory hotKeysFactory(
+    "hotkeys",
+    CommandHelp("hotkeys [reads|writes]",
+                "Show the keys and ranges read or written the most on each storage server",
+                "Each storage server counts the heaviest hitters among the keys and ranges read from and written to it "
+                "over a window of HOT_KEY_TRACKER_WINDOW seconds. Each line shows the storage server, whether it was "
+                "read or written, its rank, and the key or range with its tenant, if any, its number of operations, "
+                "the error bound on that number, and its rate. Counts are approximate: an operation count may "
+                "overstate the true count by up to its error.\n"));
+
+} // namespace fdb_cli
@@ -2262,6 +2262,14 @@ ACTOR Future<int> cli(CLIOptions opt, LineNoise* plinenoise, Reference<ClusterCo
 					continue;
 				}
 
+				if (tokencmp(tokens[0], "hotkeys")) {
+					bool _result = wait(makeInterruptable(hotKeysCommandActor(db, tokens)));
+					if (!_result) {
+						is_error = true;
+					}
+					continue;
+				}
+
 				if (tokencmp(tokens[0], "hotrange")) {
 					bool _result =
 					    wait(makeInterruptable(hotRangeCommandActor(localDb, db, tokens, &storage_interface)));
@@ -242,6 +242,8 @@ ACTOR Future<bool> blobKeyCommandActor(Database localDb,
                                        std::vector<StringRef> tokens);
 // blobrestore command
 ACTOR Future<bool> blobRestoreCommandActor(Database localDb, std::vector<StringRef> tokens);
+// hotkeys command
+ACTOR Future<bool> hotKeysCommandActor(Reference<IDatabase> db, std::vector<StringRef> tokens);
 // hotrange command
 ACTOR Future<bool> hotRangeCommandActor(Database localDb,
                                         Reference<IDatabase> db,
@@ -44,4 +44,45 @@ TEST_CASE("/Atomic/DoAppendIfFits") {
 	return Void();
 }
 
+TEST_CASE("/Atomic/ExpandVersionstampedKeys") {
+	Arena arena;
+	// "q/" then a 10 byte versionstamp and a 2 byte index, then "/x", then the offset of the versionstamp
+	Key keyTemplate = "q/0123456789ii/x"_sr.withSuffix("\x02\x00\x00\x00"_sr);
+	Standalone<VectorRef<ValueRef>> values;
+	values.push_back(values.arena(), "a"_sr);
+	values.push_back(values.arena(), ""_sr);
+	values.push_back(values.arena(), "ccc"_sr);
+	Value param = encodeVersionstampedKeysValues(values);
+	ASSERT_EQ(validateVersionstampedKeys(keyTemplate, param), 3);
+
+	VectorRef<MutationRef> out;
+	out.push_back(arena, MutationRef(MutationRef::ClearRange, "a"_sr, "b"_sr));
+	MutationRef m(MutationRef::SetVersionstampedKeys, keyTemplate, param);
+	ASSERT(expandVersionstampedKeys(arena, m, 0x0102030405060708, 0x090a, out));
+	ASSERT_EQ(out.size(), 4);
+	for (int i = 0; i < values.size(); i++) {
+		const MutationRef& set = out[i + 1];
+		ASSERT_EQ(set.type, MutationRef::SetValue);
+		ASSERT(set.param1 == "q/\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0a\x00"_sr.withSuffix(
+		                        StringRef(std::string(1, (char)i) + "/x")));
+		ASSERT(set.param2 == values[i]);
+	}
+
+	// No room for the index, or a value that runs past the end
+	ASSERT_EQ(parseVersionstampedKeysOffset("q/0123456789i\x02\x00\x00\x00"_sr), -1);
+	std::vector<StringRef> parsed;
+	ASSERT(!parseVersionstampedKeysValues(param.substr(0, param.size() - 1), &parsed));
+	Value truncatedParam = "\x05\x00\x00\x00"_sr.withSuffix("abc"_sr);
+	MutationRef truncated(MutationRef::SetVersionstampedKeys, keyTemplate, truncatedParam);
+	ASSERT(!expandVersionstampedKeys(arena, truncated, 1, 0, out));
+	ASSERT_EQ(out.size(), 4);
+	try {
+		validateVersionstampedKeys("q/0123456789i\x02\x00\x00\x00"_sr, param);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_client_invalid_operation);
+	}
+	return Void();
+}
+
 // TODO: Add more unit tests for atomic operations defined in Atomic.h
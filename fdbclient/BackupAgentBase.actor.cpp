@@ -328,129 +328,156 @@ ACTOR static Future<Void> decodeBackupLogValue(Arena* arena,
                                                bool provisionalProxy) {
 	try {
 		state uint64_t offset(0);
-		uint64_t protocolVersion = 0;
-		memcpy(&protocolVersion, value.begin(), sizeof(uint64_t));
-		offset += sizeof(uint64_t);
-		if (protocolVersion <= 0x0FDB00A200090001) {
-			TraceEvent(SevError, "DecodeBackupLogValue")
-			    .detail("IncompatibleProtocolVersion", protocolVersion)
-			    .detail("ValueSize", value.size())
-			    .detail("Value", value);
-			throw incompatible_protocol_version();
-		}
-
 		state uint32_t totalBytes = 0;
-		memcpy(&totalBytes, value.begin() + offset, sizeof(uint32_t));
-		offset += sizeof(uint32_t);
 		state uint32_t consumed = 0;
-
-		if (totalBytes + offset > value.size())
-			throw restore_missing_data();
-
-		state int originalOffset = offset;
+		state int originalOffset = 0;
 		state DatabaseConfiguration config = wait(getDatabaseConfiguration(cx));
 		state KeyRangeRef tenantMapRange = TenantMetadata::tenantMap().subspace;
 
-		while (consumed < totalBytes) {
-			uint32_t type = 0;
-			memcpy(&type, value.begin() + offset, sizeof(uint32_t));
-			offset += sizeof(uint32_t);
-			state uint32_t len1 = 0;
-			memcpy(&len1, value.begin() + offset, sizeof(uint32_t));
-			offset += sizeof(uint32_t);
-			state uint32_t len2 = 0;
-			memcpy(&len2, value.begin() + offset, sizeof(uint32_t));
-			offset += sizeof(uint32_t);
-
-			ASSERT(offset + len1 + len2 <= value.size() && isValidMutationType(type));
-
-			state MutationRef logValue;
-			state Arena tempArena;
-			logValue.type = type;
-			logValue.param1 = value.substr(offset, len1);
-			offset += len1;
-			logValue.param2 = value.substr(offset, len2);
-			offset += len2;
-			state Optional<MutationRef> encryptedLogValue = Optional<MutationRef>();
-			ASSERT(!config.encryptionAtRestMode.isEncryptionEnabled() || logValue.isEncrypted());
-
-			// Check for valid tenant in required tenant mode. If the tenant does not exist in our tenant map then
-			// we EXCLUDE the mutation (of that respective tenant) during the restore. NOTE: This simply allows a
-			// restore to make progress in the event of tenant deletion, but tenant deletion should be considered
-			// carefully so that we do not run into this case. We do this check here so if encrypted mutations are not
-			// found in the tenant map then we exit early without needing to reach out to the EKP.
-			if (config.tenantMode == TenantMode::REQUIRED &&
-			    config.encryptionAtRestMode.mode != EncryptionAtRestMode::CLUSTER_AWARE &&
-			    !validTenantAccess(tenantMap, logValue, provisionalProxy, version)) {
-				consumed += BackupAgentBase::logHeaderSize + len1 + len2;
-				continue;
+		// The value is one transaction's mutations, except for versions restored from partitioned logs, which have one
+		// encoding like this for each message, back to back
+		loop {
+			uint64_t protocolVersion = 0;
+			memcpy(&protocolVersion, value.begin() + offset, sizeof(uint64_t));
+			offset += sizeof(uint64_t);
+			if (protocolVersion <= 0x0FDB00A200090001) {
+				TraceEvent(SevError, "DecodeBackupLogValue")
+				    .detail("IncompatibleProtocolVersion", protocolVersion)
+				    .detail("ValueSize", value.size())
+				    .detail("Value", value);
+				throw incompatible_protocol_version();
 			}
 
-			// Decrypt mutation ref if encrypted
-			if (logValue.isEncrypted()) {
-				encryptedLogValue = logValue;
-				state EncryptCipherDomainId domainId = logValue.encryptDomainId();
-				Reference<AsyncVar<ClientDBInfo> const> dbInfo = cx->clientInfo;
-				try {
-					TextAndHeaderCipherKeys cipherKeys = wait(GetEncryptCipherKeys<ClientDBInfo>::getEncryptCipherKeys(
-					    dbInfo, logValue.configurableEncryptionHeader(), BlobCipherMetrics::RESTORE));
-					logValue = logValue.decrypt(cipherKeys, tempArena, BlobCipherMetrics::RESTORE);
-				} catch (Error& e) {
-					// It's possible a tenant was deleted and the encrypt key fetch failed
-					TraceEvent(SevWarnAlways, "MutationLogRestoreEncryptKeyFetchFailed")
-					    .detail("Version", version)
-					    .detail("TenantId", domainId);
-					if (e.code() == error_code_encrypt_keys_fetch_failed ||
-					    e.code() == error_code_encrypt_key_not_found) {
-						CODE_PROBE(true, "mutation log restore encrypt keys not found", probe::decoration::rare);
-						consumed += BackupAgentBase::logHeaderSize + len1 + len2;
-						continue;
-					} else {
-						throw;
-					}
+			memcpy(&totalBytes, value.begin() + offset, sizeof(uint32_t));
+			offset += sizeof(uint32_t);
+			consumed = 0;
+
+			if (totalBytes + offset > value.size())
+				throw restore_missing_data();
+
+			originalOffset = offset;
+			while (consumed < totalBytes) {
+				uint32_t type = 0;
+				memcpy(&type, value.begin() + offset, sizeof(uint32_t));
+				offset += sizeof(uint32_t);
+				state uint32_t len1 = 0;
+				memcpy(&len1, value.begin() + offset, sizeof(uint32_t));
+				offset += sizeof(uint32_t);
+				state uint32_t len2 = 0;
+				memcpy(&len2, value.begin() + offset, sizeof(uint32_t));
+				offset += sizeof(uint32_t);
+
+				ASSERT(offset + len1 + len2 <= value.size() && isValidMutationType(type));
+
+				state MutationRef logValue;
+				state Arena tempArena;
+				logValue.type = type;
+				logValue.param1 = value.substr(offset, len1);
+				offset += len1;
+				logValue.param2 = value.substr(offset, len2);
+				offset += len2;
+				state Optional<MutationRef> encryptedLogValue = Optional<MutationRef>();
+				ASSERT(!config.encryptionAtRestMode.isEncryptionEnabled() || logValue.isEncrypted());
+
+				// Check for valid tenant in required tenant mode. If the tenant does not exist in our tenant map then
+				// we EXCLUDE the mutation (of that respective tenant) during the restore. NOTE: This simply allows a
+				// restore to make progress in the event of tenant deletion, but tenant deletion should be considered
+				// carefully so that we do not run into this case. We do this check here so if encrypted mutations are
+				// not found in the tenant map then we exit early without needing to reach out to the EKP.
+				if (config.tenantMode == TenantMode::REQUIRED &&
+				    config.encryptionAtRestMode.mode != EncryptionAtRestMode::CLUSTER_AWARE &&
+				    !validTenantAccess(tenantMap, logValue, provisionalProxy, version)) {
+					consumed += BackupAgentBase::logHeaderSize + len1 + len2;
+					continue;
 				}
-			}
-			ASSERT(!logValue.isEncrypted());
-
-			// If the mutation was encrypted using cluster aware encryption then check after decryption
-			if (config.tenantMode == TenantMode::REQUIRED &&
-			    config.encryptionAtRestMode.mode == EncryptionAtRestMode::CLUSTER_AWARE &&
-			    !validTenantAccess(tenantMap, logValue, provisionalProxy, version)) {
-				consumed += BackupAgentBase::logHeaderSize + len1 + len2;
-				continue;
-			}
 
-			MutationRef originalLogValue = logValue;
-
-			if (logValue.type == MutationRef::ClearRange) {
-				KeyRangeRef range(logValue.param1, logValue.param2);
-				auto ranges = key_version->intersectingRanges(range);
-				for (auto r : ranges) {
-					if (version > r.value() && r.value() != invalidVersion) {
-						KeyRef minKey = std::min(r.range().end, range.end);
-						if (minKey == (removePrefix == StringRef() ? allKeys.end : strinc(removePrefix))) {
-							logValue.param1 = std::max(r.range().begin, range.begin);
-							if (removePrefix.size()) {
-								logValue.param1 = logValue.param1.removePrefix(removePrefix);
-							}
-							if (addPrefix.size()) {
-								logValue.param1 = logValue.param1.withPrefix(addPrefix, tempArena);
-							}
-							logValue.param2 = addPrefix == StringRef() ? allKeys.end : strinc(addPrefix, tempArena);
-							_addResult(tenantMapChanging, result, mutationSize, arena, logValue, tenantMapRange);
+				// Decrypt mutation ref if encrypted
+				if (logValue.isEncrypted()) {
+					encryptedLogValue = logValue;
+					state EncryptCipherDomainId domainId = logValue.encryptDomainId();
+					Reference<AsyncVar<ClientDBInfo> const> dbInfo = cx->clientInfo;
+					try {
+						TextAndHeaderCipherKeys cipherKeys =
+						    wait(GetEncryptCipherKeys<ClientDBInfo>::getEncryptCipherKeys(
+						        dbInfo, logValue.configurableEncryptionHeader(), BlobCipherMetrics::RESTORE));
+						logValue = logValue.decrypt(cipherKeys, tempArena, BlobCipherMetrics::RESTORE);
+					} catch (Error& e) {
+						// It's possible a tenant was deleted and the encrypt key fetch failed
+						TraceEvent(SevWarnAlways, "MutationLogRestoreEncryptKeyFetchFailed")
+						    .detail("Version", version)
+						    .detail("TenantId", domainId);
+						if (e.code() == error_code_encrypt_keys_fetch_failed ||
+						    e.code() == error_code_encrypt_key_not_found) {
+							CODE_PROBE(true, "mutation log restore encrypt keys not found", probe::decoration::rare);
+							consumed += BackupAgentBase::logHeaderSize + len1 + len2;
+							continue;
 						} else {
-							logValue.param1 = std::max(r.range().begin, range.begin);
-							logValue.param2 = minKey;
-							if (removePrefix.size()) {
-								logValue.param1 = logValue.param1.removePrefix(removePrefix);
-								logValue.param2 = logValue.param2.removePrefix(removePrefix);
+							throw;
+						}
+					}
+				}
+				ASSERT(!logValue.isEncrypted());
+
+				// If the mutation was encrypted using cluster aware encryption then check after decryption
+				if (config.tenantMode == TenantMode::REQUIRED &&
+				    config.encryptionAtRestMode.mode == EncryptionAtRestMode::CLUSTER_AWARE &&
+				    !validTenantAccess(tenantMap, logValue, provisionalProxy, version)) {
+					consumed += BackupAgentBase::logHeaderSize + len1 + len2;
+					continue;
+				}
+
+				MutationRef originalLogValue = logValue;
+
+				if (logValue.type == MutationRef::ClearRange) {
+					KeyRangeRef range(logValue.param1, logValue.param2);
+					auto ranges = key_version->intersectingRanges(range);
+					for (auto r : ranges) {
+						if (version > r.value() && r.value() != invalidVersion) {
+							KeyRef minKey = std::min(r.range().end, range.end);
+							if (minKey == (removePrefix == StringRef() ? allKeys.end : strinc(removePrefix))) {
+								logValue.param1 = std::max(r.range().begin, range.begin);
+								if (removePrefix.size()) {
+									logValue.param1 = logValue.param1.removePrefix(removePrefix);
+								}
+								if (addPrefix.size()) {
+									logValue.param1 = logValue.param1.withPrefix(addPrefix, tempArena);
+								}
+								logValue.param2 = addPrefix == StringRef() ? allKeys.end : strinc(addPrefix, tempArena);
+								_addResult(tenantMapChanging, result, mutationSize, arena, logValue, tenantMapRange);
+							} else {
+								logValue.param1 = std::max(r.range().begin, range.begin);
+								logValue.param2 = minKey;
+								if (removePrefix.size()) {
+									logValue.param1 = logValue.param1.removePrefix(removePrefix);
+									logValue.param2 = logValue.param2.removePrefix(removePrefix);
+								}
+								if (addPrefix.size()) {
+									logValue.param1 = logValue.param1.withPrefix(addPrefix, tempArena);
+									logValue.param2 = logValue.param2.withPrefix(addPrefix, tempArena);
+								}
+								_addResult(tenantMapChanging, result, mutationSize, arena, logValue, tenantMapRange);
 							}
-							if (addPrefix.size()) {
-								logValue.param1 = logValue.param1.withPrefix(addPrefix, tempArena);
-								logValue.param2 = logValue.param2.withPrefix(addPrefix, tempArena);
+							if (originalLogValue.param1 == logValue.param1 &&
+							    originalLogValue.param2 == logValue.param2) {
+								encryptedResult->push_back_deep(*arena, encryptedLogValue);
+							} else {
+								encryptedResult->push_back_deep(*arena, Optional<MutationRef>());
 							}
-							_addResult(tenantMapChanging, result, mutationSize, arena, logValue, tenantMapRange);
 						}
+					}
+				} else {
+					Version ver = key_version->rangeContaining(logValue.param1).value();
+					//TraceEvent("ApplyMutation").detail("LogValue", logValue).detail("Version", version).detail("Ver", ver).detail("Apply", version > ver && ver != invalidVersion);
+					if (version > ver && ver != invalidVersion) {
+						if (removePrefix.size()) {
+							logValue.param1 = logValue.param1.removePrefix(removePrefix);
+						}
+						if (addPrefix.size()) {
+							logValue.param1 = logValue.param1.withPrefix(addPrefix, tempArena);
+						}
+						_addResult(tenantMapChanging, result, mutationSize, arena, logValue, tenantMapRange);
+						// If we did not remove/add prefixes to the mutation then keep the original encrypted mutation
+						// so we do not have to re-encrypt unnecessarily
 						if (originalLogValue.param1 == logValue.param1 && originalLogValue.param2 == logValue.param2) {
 							encryptedResult->push_back_deep(*arena, encryptedLogValue);
 						} else {
@@ -458,31 +485,16 @@ ACTOR static Future<Void> decodeBackupLogValue(Arena* arena,
 						}
 					}
 				}
-			} else {
-				Version ver = key_version->rangeContaining(logValue.param1).value();
-				//TraceEvent("ApplyMutation").detail("LogValue", logValue).detail("Version", version).detail("Ver", ver).detail("Apply", version > ver && ver != invalidVersion);
-				if (version > ver && ver != invalidVersion) {
-					if (removePrefix.size()) {
-						logValue.param1 = logValue.param1.removePrefix(removePrefix);
-					}
-					if (addPrefix.size()) {
-						logValue.param1 = logValue.param1.withPrefix(addPrefix, tempArena);
-					}
-					_addResult(tenantMapChanging, result, mutationSize, arena, logValue, tenantMapRange);
-					// If we did not remove/add prefixes to the mutation then keep the original encrypted mutation so we
-					// do not have to re-encrypt unnecessarily
-					if (originalLogValue.param1 == logValue.param1 && originalLogValue.param2 == logValue.param2) {
-						encryptedResult->push_back_deep(*arena, encryptedLogValue);
-					} else {
-						encryptedResult->push_back_deep(*arena, Optional<MutationRef>());
-					}
-				}
+
+				consumed += BackupAgentBase::logHeaderSize + len1 + len2;
 			}
 
-			consumed += BackupAgentBase::logHeaderSize + len1 + len2;
+			ASSERT(consumed == totalBytes);
+			if (offset + sizeof(uint64_t) + sizeof(uint32_t) > value.size()) {
+				break;
+			}
+			CODE_PROBE(true, "decoding a backup log value of several messages");
 		}
-
-		ASSERT(consumed == totalBytes);
 		if (value.size() != offset) {
 			TraceEvent(SevError, "BA_DecodeBackupLogValue")
 			    .detail("UnexpectedExtraDataSize", value.size())
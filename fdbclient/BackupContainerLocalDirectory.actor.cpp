@@ -277,10 +277,18 @@ Future<Reference<IAsyncFile>> BackupContainerLocalDirectory::readFile(const std:
 		ASSERT(blockSize > 0);
 
 		return map(f, [=](Reference<IAsyncFile> fr) {
+			// Some files share a budget small enough to keep them from reading ahead at times
+			static Reference<AsyncFileReadAheadCache::ReadAheadBudget> readAheadBudget =
+			    makeReference<AsyncFileReadAheadCache::ReadAheadBudget>(2e6);
 			int readAhead = deterministicRandom()->randomInt(0, 3);
 			int reads = deterministicRandom()->randomInt(1, 3);
 			int cacheSize = deterministicRandom()->randomInt(0, 3);
-			return Reference<IAsyncFile>(new AsyncFileReadAheadCache(fr, blockSize, readAhead, reads, cacheSize));
+			Reference<AsyncFileReadAheadCache::ReadAheadBudget> budget;
+			if (deterministicRandom()->coinflip()) {
+				budget = readAheadBudget;
+			}
+			return Reference<IAsyncFile>(
+			    new AsyncFileReadAheadCache(fr, blockSize, readAhead, reads, cacheSize, budget));
 		});
 	}
 
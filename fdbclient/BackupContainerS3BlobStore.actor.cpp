@@ -189,11 +189,15 @@ Future<Reference<IAsyncFile>> BackupContainerS3BlobStore::readFile(const std::st
 		f = makeReference<AsyncFileEncrypted>(f, AsyncFileEncrypted::Mode::READ_ONLY);
 	}
 	if (m_bstore->knobs.enable_read_cache) {
+		// Every blob store file in the process reads ahead under the same budget
+		static Reference<AsyncFileReadAheadCache::ReadAheadBudget> readAheadBudget =
+		    makeReference<AsyncFileReadAheadCache::ReadAheadBudget>(CLIENT_KNOBS->BLOBSTORE_READ_AHEAD_CACHE_BYTES);
 		f = makeReference<AsyncFileReadAheadCache>(f,
 		                                           m_bstore->knobs.read_block_size,
 		                                           m_bstore->knobs.read_ahead_blocks,
 		                                           m_bstore->knobs.concurrent_reads_per_file,
-		                                           m_bstore->knobs.read_cache_blocks_per_file);
+		                                           m_bstore->knobs.read_cache_blocks_per_file,
+		                                           readAheadBudget);
 	}
 	return f;
 }
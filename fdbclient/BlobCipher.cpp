@@ -888,6 +888,64 @@ void BlobCipherDetails::validateCipherDetailsWithCipherKey(Reference<BlobCipherK
 	}
 }
 
+namespace {
+
+// Creating an OpenSSL context allocates, and an encryptor or decryptor is made for every page, mutation batch and file
+// that is encrypted, so freed contexts are kept on the thread that freed them for the next one made there to reuse,
+// without taking a lock. Contexts aren't tied to a thread, so one may be freed on a different thread than the one
+// it came from.
+template <class Ctx, Ctx* (*New)(), void (*Free)(Ctx*)>
+class ThreadLocalCtxPool {
+public:
+	// Returns nullptr if a new context could not be allocated
+	static Ctx* acquire() {
+		std::vector<Ctx*>& ctxs = local().ctxs;
+		if (ctxs.empty()) {
+			return New();
+		}
+		Ctx* ctx = ctxs.back();
+		ctxs.pop_back();
+		return ctx;
+	}
+
+	static void release(Ctx* ctx) {
+		std::vector<Ctx*>& ctxs = local().ctxs;
+		if (ctxs.size() < MAX_POOLED) {
+			ctxs.push_back(ctx);
+		} else {
+			Free(ctx);
+		}
+	}
+
+private:
+	static constexpr size_t MAX_POOLED = 16;
+
+	struct Local {
+		std::vector<Ctx*> ctxs;
+		~Local() {
+			for (Ctx* ctx : ctxs) {
+				Free(ctx);
+			}
+		}
+	};
+
+	static Local& local() {
+		thread_local Local l;
+		return l;
+	}
+};
+
+// Only ever set up for AES-256-CTR, in either direction, so a pooled context just needs its key and IV set again
+using CipherCtxPool = ThreadLocalCtxPool<EVP_CIPHER_CTX, EVP_CIPHER_CTX_new, EVP_CIPHER_CTX_free>;
+using HmacCtxPool = ThreadLocalCtxPool<HMAC_CTX, HMAC_CTX_new, HMAC_CTX_free>;
+using CmacCtxPool = ThreadLocalCtxPool<CMAC_CTX, CMAC_CTX_new, CMAC_CTX_free>;
+
+bool isAes256CtrCtx(EVP_CIPHER_CTX* ctx) {
+	return EVP_CIPHER_CTX_cipher(ctx) != nullptr && EVP_CIPHER_CTX_nid(ctx) == NID_aes_256_ctr;
+}
+
+} // namespace
+
 // EncryptBlobCipherAes265Ctr class methods
 
 EncryptBlobCipherAes265Ctr::EncryptBlobCipherAes265Ctr(Reference<BlobCipherKey> tCipherKey,
@@ -896,7 +954,7 @@ EncryptBlobCipherAes265Ctr::EncryptBlobCipherAes265Ctr(Reference<BlobCipherKey>
                                                        const int ivLen,
                                                        const EncryptAuthTokenMode mode,
                                                        BlobCipherMetrics::UsageType usageType)
-  : ctx(EVP_CIPHER_CTX_new()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode) {
+  : ctx(CipherCtxPool::acquire()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode) {
 	ASSERT_EQ(ivLen, AES_256_IV_LENGTH);
 	authTokenAlgo = getAuthTokenAlgoFromMode(authTokenMode);
 	memcpy(&iv[0], cipherIV, ivLen);
@@ -910,7 +968,7 @@ EncryptBlobCipherAes265Ctr::EncryptBlobCipherAes265Ctr(Reference<BlobCipherKey>
                                                        const EncryptAuthTokenMode mode,
                                                        const EncryptAuthTokenAlgo algo,
                                                        BlobCipherMetrics::UsageType usageType)
-  : ctx(EVP_CIPHER_CTX_new()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode),
+  : ctx(CipherCtxPool::acquire()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode),
     authTokenAlgo(algo) {
 	ASSERT_EQ(ivLen, AES_256_IV_LENGTH);
 	memcpy(&iv[0], cipherIV, ivLen);
@@ -921,7 +979,7 @@ EncryptBlobCipherAes265Ctr::EncryptBlobCipherAes265Ctr(Reference<BlobCipherKey>
                                                        Optional<Reference<BlobCipherKey>> hCipherKeyOpt,
                                                        const EncryptAuthTokenMode mode,
                                                        BlobCipherMetrics::UsageType usageType)
-  : ctx(EVP_CIPHER_CTX_new()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode) {
+  : ctx(CipherCtxPool::acquire()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode) {
 	authTokenAlgo = getAuthTokenAlgoFromMode(authTokenMode);
 	deterministicRandom()->randomBytes(iv, AES_256_IV_LENGTH);
 	init();
@@ -932,7 +990,7 @@ EncryptBlobCipherAes265Ctr::EncryptBlobCipherAes265Ctr(Reference<BlobCipherKey>
                                                        const EncryptAuthTokenMode mode,
                                                        const EncryptAuthTokenAlgo algo,
                                                        BlobCipherMetrics::UsageType usageType)
-  : ctx(EVP_CIPHER_CTX_new()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode),
+  : ctx(CipherCtxPool::acquire()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt), authTokenMode(mode),
     authTokenAlgo(algo) {
 	deterministicRandom()->randomBytes(iv, AES_256_IV_LENGTH);
 	init();
@@ -954,7 +1012,7 @@ void EncryptBlobCipherAes265Ctr::init() {
 	if (ctx == nullptr) {
 		throw encrypt_ops_error();
 	}
-	if (EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, nullptr, nullptr) != 1) {
+	if (!isAes256CtrCtx(ctx) && EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, nullptr, nullptr) != 1) {
 		throw encrypt_ops_error();
 	}
 	if (EVP_EncryptInit_ex(ctx, nullptr, nullptr, textCipherKey.getPtr()->data(), iv) != 1) {
@@ -1298,7 +1356,7 @@ void EncryptBlobCipherAes265Ctr::encryptInplace(uint8_t* plaintext,
 
 EncryptBlobCipherAes265Ctr::~EncryptBlobCipherAes265Ctr() {
 	if (ctx != nullptr) {
-		EVP_CIPHER_CTX_free(ctx);
+		CipherCtxPool::release(ctx);
 	}
 }
 
@@ -1308,12 +1366,12 @@ DecryptBlobCipherAes256Ctr::DecryptBlobCipherAes256Ctr(Reference<BlobCipherKey>
                                                        Optional<Reference<BlobCipherKey>> hCipherKeyOpt,
                                                        const uint8_t* iv,
                                                        BlobCipherMetrics::UsageType usageType)
-  : ctx(EVP_CIPHER_CTX_new()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt),
+  : ctx(CipherCtxPool::acquire()), textCipherKey(tCipherKey), headerCipherKeyOpt(hCipherKeyOpt),
     authTokensValidationDone(false) {
 	if (ctx == nullptr) {
 		throw encrypt_ops_error();
 	}
-	if (!EVP_DecryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, nullptr, nullptr)) {
+	if (!isAes256CtrCtx(ctx) && !EVP_DecryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, nullptr, nullptr)) {
 		throw encrypt_ops_error();
 	}
 	if (!EVP_DecryptInit_ex(ctx, nullptr, nullptr, tCipherKey.getPtr()->data(), iv)) {
@@ -1732,13 +1790,17 @@ void DecryptBlobCipherAes256Ctr::decryptInplace(uint8_t* ciphertext,
 
 DecryptBlobCipherAes256Ctr::~DecryptBlobCipherAes256Ctr() {
 	if (ctx != nullptr) {
-		EVP_CIPHER_CTX_free(ctx);
+		CipherCtxPool::release(ctx);
 	}
 }
 
 // HmacSha256DigestGen class methods
 
-HmacSha256DigestGen::HmacSha256DigestGen(const unsigned char* key, size_t len) : ctx(HMAC_CTX_new()) {
+HmacSha256DigestGen::HmacSha256DigestGen(const unsigned char* key, size_t len) : ctx(HmacCtxPool::acquire()) {
+	if (ctx == nullptr) {
+		throw encrypt_ops_error();
+	}
+	// Passing the digest again makes a pooled context start over with the new key
 	if (!HMAC_Init_ex(ctx, key, len, EVP_sha256(), nullptr)) {
 		throw encrypt_ops_error();
 	}
@@ -1746,7 +1808,7 @@ HmacSha256DigestGen::HmacSha256DigestGen(const unsigned char* key, size_t len) :
 
 HmacSha256DigestGen::~HmacSha256DigestGen() {
 	if (ctx != nullptr) {
-		HMAC_CTX_free(ctx);
+		HmacCtxPool::release(ctx);
 	}
 }
 
@@ -1772,7 +1834,7 @@ unsigned int HmacSha256DigestGen::digest(const std::vector<std::pair<const uint8
 }
 
 // Aes256CtrCmacDigestGen methods
-Aes256CmacDigestGen::Aes256CmacDigestGen(const unsigned char* key, size_t keylen) : ctx(CMAC_CTX_new()) {
+Aes256CmacDigestGen::Aes256CmacDigestGen(const unsigned char* key, size_t keylen) : ctx(CmacCtxPool::acquire()) {
 	ASSERT_EQ(keylen, AES_256_KEY_LENGTH);
 
 	if (ctx == nullptr) {
@@ -1804,7 +1866,7 @@ size_t Aes256CmacDigestGen::digest(const std::vector<std::pair<const uint8_t*, s
 
 Aes256CmacDigestGen::~Aes256CmacDigestGen() {
 	if (ctx != nullptr) {
-		CMAC_CTX_free(ctx);
+		CmacCtxPool::release(ctx);
 	}
 }
 
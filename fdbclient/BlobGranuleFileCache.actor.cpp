@@ -0,0 +1,224 @@
+/*
+ * BlobGranuleFileCache.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/BlobGranuleFileCache.h"
+#include "fdbclient/Knobs.h"
+#include "flow/IAsyncFile.h"
+#include "flow/Platform.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+std::string BlobGranuleFileCache::cacheKey(StringRef filename, int64_t offset, int64_t length) {
+	return format("%lld:%lld:", offset, length) + filename.toString();
+}
+
+Optional<Standalone<StringRef>> BlobGranuleFileCache::get(StringRef filename, int64_t offset, int64_t length) {
+	std::string key = cacheKey(filename, offset, length);
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = index.find(key);
+	if (it == index.end()) {
+		++misses;
+		return Optional<Standalone<StringRef>>();
+	}
+	++hits;
+	entries.splice(entries.begin(), entries, it->second);
+	return it->second->second;
+}
+
+void BlobGranuleFileCache::insert(StringRef filename, int64_t offset, int64_t length, Standalone<StringRef> data) {
+	std::string key = cacheKey(filename, offset, length);
+	if (data.size() + key.size() > capacityBytes) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = index.find(key);
+	if (it != index.end()) {
+		entries.splice(entries.begin(), entries, it->second);
+		return;
+	}
+	entries.emplace_front(key, data);
+	index[key] = entries.begin();
+	bytes += data.size() + key.size();
+	evict();
+}
+
+void BlobGranuleFileCache::evict() {
+	while (bytes > capacityBytes && !entries.empty()) {
+		auto& oldest = entries.back();
+		bytes -= oldest.second.size() + oldest.first.size();
+		index.erase(oldest.first);
+		entries.pop_back();
+	}
+}
+
+BlobGranuleFileCache* BlobGranuleFileCache::global() {
+	static BlobGranuleFileCache* cache =
+	    CLIENT_KNOBS->BG_FILE_CACHE_BYTES > 0 ? new BlobGranuleFileCache(CLIENT_KNOBS->BG_FILE_CACHE_BYTES) : nullptr;
+	return cache;
+}
+
+struct BlobGranuleDiskCacheImpl {
+	ACTOR static Future<Optional<Standalone<StringRef>>> read(std::string path, int64_t length) {
+		try {
+			state Reference<IAsyncFile> file = wait(IAsyncFileSystem::filesystem()->open(
+			    path, IAsyncFile::OPEN_NO_AIO | IAsyncFile::OPEN_READONLY | IAsyncFile::OPEN_UNCACHED, 0));
+			state Standalone<StringRef> data = makeString(length);
+			int readSize = wait(file->read(mutateString(data), length, 0));
+			if (readSize != length) {
+				return Optional<Standalone<StringRef>>();
+			}
+			return data;
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			// The file may have been evicted since the read started
+			TraceEvent(SevInfo, "BlobGranuleDiskCacheReadError").errorUnsuppressed(e).detail("Path", path);
+			return Optional<Standalone<StringRef>>();
+		}
+	}
+
+	// Cancelled, along with the rest of writers, when the cache is destroyed
+	ACTOR static Future<Void> write(BlobGranuleDiskCache* self, std::string path, Standalone<StringRef> data) {
+		try {
+			// The file only appears under its name once it is synced, so a crash never leaves a partial one behind
+			state Reference<IAsyncFile> file = wait(IAsyncFileSystem::filesystem()->open(
+			    path,
+			    IAsyncFile::OPEN_NO_AIO | IAsyncFile::OPEN_UNCACHED | IAsyncFile::OPEN_CREATE |
+			        IAsyncFile::OPEN_ATOMIC_WRITE_AND_CREATE | IAsyncFile::OPEN_READWRITE,
+			    0600));
+			wait(file->write(data.begin(), data.size(), 0));
+			wait(file->sync());
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			TraceEvent(SevWarnAlways, "BlobGranuleDiskCacheWriteError").errorUnsuppressed(e).detail("Path", path);
+			self->writing.erase(path);
+			return Void();
+		}
+		self->writing.erase(path);
+		self->entries.emplace_front(path, data.size());
+		self->index[path] = self->entries.begin();
+		self->bytes += data.size();
+		self->evict();
+		return Void();
+	}
+
+	ACTOR static Future<Void> remove(std::string path) {
+		try {
+			wait(IAsyncFileSystem::filesystem()->deleteFile(path, false));
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			TraceEvent(SevWarnAlways, "BlobGranuleDiskCacheDeleteError").errorUnsuppressed(e).detail("Path", path);
+		}
+		return Void();
+	}
+};
+
+BlobGranuleDiskCache::BlobGranuleDiskCache(std::string folder, int64_t capacityBytes)
+  : folder(folder), capacityBytes(capacityBytes) {
+	platform::eraseDirectoryRecursive(folder);
+	platform::createDirectory(folder);
+	TraceEvent("BlobGranuleDiskCacheCreated").detail("Folder", folder).detail("CapacityBytes", capacityBytes);
+}
+
+// Escapes everything but letters, digits, '.' and '-' in the file name, so that distinct ranges get distinct paths
+std::string BlobGranuleDiskCache::pathFor(StringRef filename, int64_t offset, int64_t length) const {
+	std::string name = format("%lld-%lld-", offset, length);
+	for (uint8_t c : filename) {
+		if (isalnum(c) || c == '.' || c == '-') {
+			name.push_back(c);
+		} else {
+			name += format("_%02x", c);
+		}
+	}
+	return joinPath(folder, name);
+}
+
+void BlobGranuleDiskCache::touch(const std::string& path) {
+	auto it = index.find(path);
+	if (it != index.end()) {
+		entries.splice(entries.begin(), entries, it->second);
+	}
+}
+
+void BlobGranuleDiskCache::evict() {
+	while (bytes > capacityBytes && !entries.empty()) {
+		auto& oldest = entries.back();
+		bytes -= oldest.second;
+		writers.add(BlobGranuleDiskCacheImpl::remove(oldest.first));
+		index.erase(oldest.first);
+		entries.pop_back();
+	}
+}
+
+Future<Optional<Standalone<StringRef>>> BlobGranuleDiskCache::read(StringRef filename, int64_t offset, int64_t length) {
+	std::string path = pathFor(filename, offset, length);
+	if (!index.count(path)) {
+		return Optional<Standalone<StringRef>>();
+	}
+	touch(path);
+	return BlobGranuleDiskCacheImpl::read(path, length);
+}
+
+void BlobGranuleDiskCache::write(StringRef filename, int64_t offset, int64_t length, Standalone<StringRef> data) {
+	if (data.size() > capacityBytes) {
+		return;
+	}
+	std::string path = pathFor(filename, offset, length);
+	if (index.count(path) || writing.count(path)) {
+		return;
+	}
+	writing.insert(path);
+	writers.add(BlobGranuleDiskCacheImpl::write(this, path, data));
+}
+
+TEST_CASE("/blobgranule/files/cache/lru") {
+	BlobGranuleFileCache cache(100);
+	Standalone<StringRef> data = makeString(30);
+	memset(mutateString(data), 'a', data.size());
+	int keyBytes = format("%lld:%lld:", 0LL, 30LL).size() + 1;
+
+	cache.insert("a"_sr, 0, 30, data);
+	cache.insert("b"_sr, 0, 30, data);
+	ASSERT_EQ(cache.getBytes(), 2 * (30 + keyBytes));
+	ASSERT(cache.get("a"_sr, 0, 30).present());
+	ASSERT(!cache.get("a"_sr, 30, 30).present());
+	ASSERT(!cache.get("c"_sr, 0, 30).present());
+
+	// b is now the least recently used, so it goes first
+	cache.insert("c"_sr, 0, 30, data);
+	ASSERT(!cache.get("b"_sr, 0, 30).present());
+	ASSERT(cache.get("a"_sr, 0, 30).present());
+	ASSERT(cache.get("c"_sr, 0, 30).present());
+	ASSERT_EQ(cache.getBytes(), 2 * (30 + keyBytes));
+	ASSERT_EQ(cache.getHits(), 3);
+	ASSERT_EQ(cache.getMisses(), 3);
+
+	// too large to ever fit
+	cache.insert("d"_sr, 0, 100, makeString(100));
+	ASSERT(!cache.get("d"_sr, 0, 100).present());
+	ASSERT(cache.get("a"_sr, 0, 30).present());
+
+	return Void();
+}
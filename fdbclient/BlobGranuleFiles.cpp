@@ -22,6 +22,7 @@
 
 #include "fdbclient/BlobCipher.h"
 #include "fdbclient/BlobGranuleCommon.h"
+#include "fdbclient/BlobGranuleFileCache.h"
 #include "fdbclient/ClientKnobs.h"
 #include "fdbclient/CommitTransaction.h"
 #include "fdbclient/Knobs.h"
@@ -52,9 +53,12 @@
 
 // File Format stuff
 
-// Version info for file format of chunked files.
-uint16_t LATEST_BG_FORMAT_VERSION = 1;
+// Version info for file format of chunked files. Delta files of COLUMNAR_DELTA_BG_FORMAT_VERSION store their chunks
+// column by column, see serializeColumnarDeltaChunk(). Everything else is still written with the first version.
+uint16_t LATEST_BG_FORMAT_VERSION = 2;
 uint16_t MIN_SUPPORTED_BG_FORMAT_VERSION = 1;
+const uint16_t ROW_BG_FORMAT_VERSION = 1;
+const uint16_t COLUMNAR_DELTA_BG_FORMAT_VERSION = 2;
 
 // TODO combine with SystemData? These don't actually have to match though
 
@@ -571,6 +575,181 @@ struct IndexBlobGranuleFileChunkRef {
 	}
 };
 
+namespace {
+
+// A columnar delta chunk holds the same boundaries as a serialized GranuleSortedDeltas, as
+//
+//   [boundary count][value count][base version][keys length][versions length][value lengths length]
+//   [keys][versions][value lengths][value bytes]
+//
+// where counts and lengths are varints and the base version, the lowest in the chunk, is a little endian int64.
+// - keys has (length shared with the previous key, suffix length, suffix) for each boundary
+// - versions has, for each boundary, the number of values and the clear version (0 for none, otherwise one more than
+//   its offset from the base version), followed by each value's version as its offset from the previous value's (the
+//   base version for the first) shifted left by one, with the low bit set for sets
+// - value lengths and value bytes are for the sets, in order
+// Keeping like data together makes the chunk smaller, particularly once compressed, and cheaper to parse.
+
+void appendVarint(std::string& out, uint64_t v) {
+	while (v >= 0x80) {
+		out.push_back((char)(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back((char)v);
+}
+
+struct ColumnReader {
+	const uint8_t* ptr;
+	const uint8_t* end;
+
+	ColumnReader(const uint8_t* ptr, const uint8_t* end) : ptr(ptr), end(end) {}
+
+	uint64_t varint() {
+		uint64_t v = 0;
+		for (int shift = 0;; shift += 7) {
+			ASSERT(ptr < end && shift < 64);
+			uint8_t b = *ptr++;
+			v |= (uint64_t)(b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				return v;
+			}
+		}
+	}
+
+	const uint8_t* bytes(uint64_t len) {
+		ASSERT(len <= end - ptr);
+		const uint8_t* begin = ptr;
+		ptr += len;
+		return begin;
+	}
+
+	ColumnReader column(uint64_t len) {
+		const uint8_t* begin = bytes(len);
+		return ColumnReader(begin, begin + len);
+	}
+};
+
+Value serializeColumnarDeltaChunk(const GranuleSortedDeltas& chunk) {
+	Version baseVersion = std::numeric_limits<Version>::max();
+	uint64_t valueCount = 0;
+	for (auto& b : chunk.boundaries) {
+		if (b.clearVersion.present()) {
+			baseVersion = std::min(baseVersion, b.clearVersion.get());
+		}
+		if (!b.values.empty()) {
+			baseVersion = std::min(baseVersion, b.values.front().version);
+		}
+		valueCount += b.values.size();
+	}
+	if (baseVersion == std::numeric_limits<Version>::max()) {
+		baseVersion = 0;
+	}
+
+	std::string keys, versions, valueLengths, valueBytes;
+	KeyRef prevKey;
+	for (auto& b : chunk.boundaries) {
+		int shared = commonPrefixLength(prevKey, b.key);
+		appendVarint(keys, shared);
+		appendVarint(keys, b.key.size() - shared);
+		keys.append((const char*)b.key.begin() + shared, b.key.size() - shared);
+		prevKey = b.key;
+
+		appendVarint(versions, b.values.size());
+		appendVarint(versions, b.clearVersion.present() ? b.clearVersion.get() - baseVersion + 1 : 0);
+		Version prevVersion = baseVersion;
+		for (auto& v : b.values) {
+			ASSERT(v.version >= prevVersion);
+			appendVarint(versions, ((uint64_t)(v.version - prevVersion) << 1) | (v.isSet() ? 1 : 0));
+			prevVersion = v.version;
+			if (v.isSet()) {
+				appendVarint(valueLengths, v.value.size());
+				valueBytes.append((const char*)v.value.begin(), v.value.size());
+			}
+		}
+	}
+
+	std::string out;
+	appendVarint(out, chunk.boundaries.size());
+	appendVarint(out, valueCount);
+	out.append((const char*)&baseVersion, sizeof(baseVersion));
+	appendVarint(out, keys.size());
+	appendVarint(out, versions.size());
+	appendVarint(out, valueLengths.size());
+	out.reserve(out.size() + keys.size() + versions.size() + valueLengths.size() + valueBytes.size());
+	out += keys;
+	out += versions;
+	out += valueLengths;
+	out += valueBytes;
+	return Value(StringRef(out));
+}
+
+// Keys that share no prefix with the previous one, and all values, point into chunkBytes
+Standalone<GranuleSortedDeltas> parseColumnarDeltaChunk(const Standalone<StringRef>& chunkBytes) {
+	Standalone<GranuleSortedDeltas> result;
+	Arena& arena = result.arena();
+	arena.dependsOn(chunkBytes.arena());
+
+	ColumnReader header(chunkBytes.begin(), chunkBytes.end());
+	uint64_t boundaryCount = header.varint();
+	uint64_t valueCount = header.varint();
+	Version baseVersion;
+	memcpy(&baseVersion, header.bytes(sizeof(baseVersion)), sizeof(baseVersion));
+	uint64_t keysLength = header.varint();
+	uint64_t versionsLength = header.varint();
+	uint64_t valueLengthsLength = header.varint();
+	ColumnReader keys = header.column(keysLength);
+	ColumnReader versions = header.column(versionsLength);
+	ColumnReader valueLengths = header.column(valueLengthsLength);
+	ColumnReader& valueBytes = header;
+
+	// Every boundary and value takes at least a byte, so these are bounded by the chunk's size
+	ASSERT(boundaryCount <= keysLength && valueCount <= versionsLength);
+	result.boundaries.resize(arena, boundaryCount);
+	ValueAndVersionRef* values = new (arena) ValueAndVersionRef[valueCount];
+	uint64_t valuesLeft = valueCount;
+	KeyRef prevKey;
+	for (auto& b : result.boundaries) {
+		uint64_t shared = keys.varint();
+		uint64_t suffixLength = keys.varint();
+		ASSERT(shared <= prevKey.size());
+		const uint8_t* suffix = keys.bytes(suffixLength);
+		if (shared == 0) {
+			b.key = KeyRef(suffix, suffixLength);
+		} else {
+			uint8_t* key = new (arena) uint8_t[shared + suffixLength];
+			memcpy(key, prevKey.begin(), shared);
+			memcpy(key + shared, suffix, suffixLength);
+			b.key = KeyRef(key, shared + suffixLength);
+		}
+		prevKey = b.key;
+
+		uint64_t count = versions.varint();
+		ASSERT(count <= valuesLeft);
+		uint64_t clear = versions.varint();
+		if (clear) {
+			b.clearVersion = baseVersion + (Version)(clear - 1);
+		}
+		Version version = baseVersion;
+		for (uint64_t i = 0; i < count; i++) {
+			uint64_t encoded = versions.varint();
+			version += (Version)(encoded >> 1);
+			if (encoded & 1) {
+				uint64_t len = valueLengths.varint();
+				values[i] = ValueAndVersionRef(version, ValueRef(valueBytes.bytes(len), len));
+			} else {
+				values[i] = ValueAndVersionRef(version);
+			}
+		}
+		b.values = VectorRef<ValueAndVersionRef>(values, count);
+		values += count;
+		valuesLeft -= count;
+	}
+	ASSERT(valuesLeft == 0);
+	return result;
+}
+
+} // namespace
+
 /*
  * A file header for a key-ordered file that is chunked on disk, where each chunk is a disjoint key range of data.
  */
@@ -588,7 +767,7 @@ struct IndexedBlobGranuleFile {
 	StringRef fileBytes;
 
 	void init(uint8_t fType, const Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx) {
-		formatVersion = LATEST_BG_FORMAT_VERSION;
+		formatVersion = ROW_BG_FORMAT_VERSION;
 		fileType = fType;
 		chunkStartOffset = -1;
 	}
@@ -641,11 +820,10 @@ struct IndexedBlobGranuleFile {
 		return startBlock;
 	}
 
-	// FIXME: implement some sort of iterator type interface?
-	template <class ChildType>
-	Standalone<ChildType> getChild(const ChildBlockPointerRef* childPointer,
-	                               Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
-	                               int startOffset) {
+	// Returns the decrypted and decompressed bytes of a chunk
+	Standalone<StringRef> getChildBytes(const ChildBlockPointerRef* childPointer,
+	                                    Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
+	                                    int startOffset) {
 		ASSERT(childPointer != indexBlockRef.block.children.end());
 		const ChildBlockPointerRef* nextPointer = childPointer + 1;
 		ASSERT(nextPointer != indexBlockRef.block.children.end());
@@ -665,14 +843,32 @@ struct IndexedBlobGranuleFile {
 		IndexBlobGranuleFileChunkRef chunkRef =
 		    IndexBlobGranuleFileChunkRef::fromBytes(cipherKeysCtx, childData, childArena);
 
-		// TODO implement some sort of decrypted+decompressed+deserialized cache, if this object gets reused?
+		return Standalone<StringRef>(chunkRef.chunkBytes.get(), childArena);
+	}
 
-		BinaryReader br(chunkRef.chunkBytes.get(), IncludeVersion());
+	// FIXME: implement some sort of iterator type interface?
+	template <class ChildType>
+	Standalone<ChildType> getChild(const ChildBlockPointerRef* childPointer,
+	                               Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
+	                               int startOffset) {
+		// TODO implement some sort of decrypted+decompressed+deserialized cache, if this object gets reused?
+		Standalone<StringRef> childBytes = getChildBytes(childPointer, cipherKeysCtx, startOffset);
+		BinaryReader br(childBytes, IncludeVersion());
 		Standalone<ChildType> child;
 		br >> child;
 		return child;
 	}
 
+	Standalone<GranuleSortedDeltas> getDeltaChild(const ChildBlockPointerRef* childPointer,
+	                                              Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
+	                                              int startOffset) {
+		ASSERT(fileType == DELTA_FILE_TYPE);
+		if (formatVersion >= COLUMNAR_DELTA_BG_FORMAT_VERSION) {
+			return parseColumnarDeltaChunk(getChildBytes(childPointer, cipherKeysCtx, startOffset));
+		}
+		return getChild<GranuleSortedDeltas>(childPointer, cipherKeysCtx, startOffset);
+	}
+
 	template <class Ar>
 	void serialize(Ar& ar) {
 		serializer(ar, formatVersion, fileType, filter, indexBlockRef, chunkStartOffset);
@@ -998,7 +1194,8 @@ Value serializeChunkedDeltaFile(const Standalone<StringRef>& fileNameRef,
                                 const KeyRangeRef& fileRange,
                                 int chunkSize,
                                 Optional<CompressionFilter> compressFilter,
-                                Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx) {
+                                Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
+                                bool columnar) {
 	if (BG_ENCRYPT_COMPRESS_DEBUG) {
 		TraceEvent(SevDebug, "SerializeChunkedDelta")
 		    .detail("Filename", fileNameRef.toString())
@@ -1013,6 +1210,9 @@ Value serializeChunkedDeltaFile(const Standalone<StringRef>& fileNameRef,
 	Standalone<IndexedBlobGranuleFile> file;
 
 	file.init(DELTA_FILE_TYPE, cipherKeysCtx);
+	if (columnar) {
+		file.formatVersion = COLUMNAR_DELTA_BG_FORMAT_VERSION;
+	}
 
 	// build in-memory version of boundaries - TODO separate functions
 	SortedDeltasT boundaries;
@@ -1041,7 +1241,8 @@ Value serializeChunkedDeltaFile(const Standalone<StringRef>& fileNameRef,
 
 		if (currentChunkBytesEstimate >= chunkSize || i == boundaries.size() - 1) {
 			Value serialized =
-			    BinaryWriter::toValue(currentChunk, IncludeVersion(ProtocolVersion::withBlobGranuleFile()));
+			    columnar ? serializeColumnarDeltaChunk(currentChunk)
+			             : BinaryWriter::toValue(currentChunk, IncludeVersion(ProtocolVersion::withBlobGranuleFile()));
 			Value chunkBytes =
 			    IndexBlobGranuleFileChunkRef::toBytes(cipherKeysCtx, compressFilter, serialized, file.arena());
 			chunks.push_back(chunkBytes);
@@ -1143,7 +1344,7 @@ Standalone<VectorRef<ParsedDeltaBoundaryRef>> loadChunkedDeltaFile(const Standal
 		lastBlock = (nextBlock == file.indexBlockRef.block.children.end() - 1) || keyRange.end <= nextBlock->key;
 
 		Standalone<GranuleSortedDeltas> deltaBlock =
-		    file.getChild<GranuleSortedDeltas>(currentBlock, cipherKeysCtx, file.chunkStartOffset);
+		    file.getDeltaChild(currentBlock, cipherKeysCtx, file.chunkStartOffset);
 		ASSERT(!deltaBlock.boundaries.empty());
 		ASSERT(currentBlock->key == deltaBlock.boundaries.front().key);
 
@@ -1320,32 +1521,25 @@ Standalone<VectorRef<ParsedDeltaBoundaryRef>> sortMemoryDeltas(const GranuleDelt
 	return deltas;
 }
 
-// does a sorted merge of the delta streams.
-// In terms of write precedence, streams[i] < streams[i+1]
-// Handles range clears by tracking the active clears when they start
-struct MergeStreamNext {
-	KeyRef key;
+// The first 8 bytes of the key after the common prefix, zero padded, so that for keys a and b, a < b implies
+// keyHead(a) <= keyHead(b). Comparing these integers, rather than the keys, is enough to order most keys.
+static uint64_t keyHead(KeyRef key, int prefixLen) {
+	uint64_t head = 0;
+	memcpy(&head, key.begin() + prefixLen, std::clamp<int>(key.size() - prefixLen, 0, sizeof(head)));
+	return bigEndian64(head);
+}
+
+// Position within one delta stream
+struct MergeStreamCursor {
 	int16_t streamIdx;
 	int dataIdx;
 };
 
-// the sort order is logically lower by key, and then higher by streamIdx
-// because a priority queue is backwards, we invert that
-struct OrderForPriorityQueue {
-	int commonPrefixLen;
-	OrderForPriorityQueue(int commonPrefixLen) : commonPrefixLen(commonPrefixLen) {}
-
-	bool operator()(MergeStreamNext const& a, MergeStreamNext const& b) const {
-		int keyCmp = a.key.compareSuffix(b.key, commonPrefixLen);
-		if (keyCmp != 0) {
-			return keyCmp > 0; // reverse
-		}
-		return a.streamIdx < b.streamIdx;
-	}
-};
-
-typedef std::priority_queue<MergeStreamNext, std::vector<MergeStreamNext>, OrderForPriorityQueue> MergePQ;
-
+// does a sorted merge of the delta streams.
+// In terms of write precedence, streams[i] < streams[i+1]
+// Handles range clears by tracking the active clears when they start
+// There are rarely more than a few dozen streams, so finding the next key by scanning every stream's cached key head
+// is cheaper than maintaining a priority queue of full keys.
 static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
                                      const std::vector<Standalone<VectorRef<ParsedDeltaBoundaryRef>>>& streams,
                                      const std::vector<bool> startClears,
@@ -1359,8 +1553,11 @@ static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
 
 	int prefixLen = commonPrefixLength(chunk.keyRange.begin, chunk.keyRange.end);
 
-	// next element for each stream
-	MergePQ next = MergePQ(OrderForPriorityQueue(prefixLen));
+	// streams with elements left, highest streamIdx first, and the key head of each one's next element
+	std::vector<MergeStreamCursor> active;
+	std::vector<uint64_t> heads;
+	active.reserve(streams.size());
+	heads.reserve(streams.size());
 
 	// efficiently find the highest stream's active clear
 	std::set<int16_t, std::greater<int16_t>> activeClears;
@@ -1382,34 +1579,50 @@ static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
 			// single clear that entirely encases partial read bounds
 			ASSERT(clearActive[i]);
 		} else {
-			MergeStreamNext item;
-			item.key = streams[i][0].key;
-			item.streamIdx = i;
-			item.dataIdx = 0;
-			next.push(item);
 			maxExpectedSize += streams[i].size();
 			result.arena().dependsOn(streams[i].arena());
 		}
 	}
+	for (int16_t i = streams.size() - 1; i >= 0; i--) {
+		if (!streams[i].empty()) {
+			active.push_back(MergeStreamCursor{ i, 0 });
+			heads.push_back(keyHead(streams[i][0].key, prefixLen));
+		}
+	}
 	result.reserve(result.arena(), maxExpectedSize);
 
-	std::vector<MergeStreamNext> cur;
+	// indexes into active of the streams at the next key, highest streamIdx first
+	std::vector<int> cur;
 	cur.reserve(streams.size());
-	while (!next.empty()) {
-		cur.clear();
-		cur.push_back(next.top());
-		next.pop();
+	while (!active.empty()) {
+		uint64_t minHead = heads[0];
+		for (int i = 1; i < heads.size(); i++) {
+			minHead = std::min(minHead, heads[i]);
+		}
 
-		// next.top().key == cur.front().key but with suffix comparison
-		while (!next.empty() && cur.front().key.compareSuffix(next.top().key, prefixLen) == 0) {
-			cur.push_back(next.top());
-			next.pop();
+		// only streams with the lowest head can be at the next key, and they usually all are
+		cur.clear();
+		KeyRef minKey;
+		for (int i = 0; i < heads.size(); i++) {
+			if (heads[i] != minHead) {
+				continue;
+			}
+			KeyRef key = streams[active[i].streamIdx][active[i].dataIdx].key;
+			int keyCmp = cur.empty() ? -1 : key.compareSuffix(minKey, prefixLen);
+			if (keyCmp < 0) {
+				cur.clear();
+				minKey = key;
+			}
+			if (keyCmp <= 0) {
+				cur.push_back(i);
+			}
 		}
 
 		// un-set clears and find latest value for key (if present)
 		bool foundValue = false;
-		bool includesSnapshot = cur.back().streamIdx == 0 && chunk.snapshotFile.present();
-		for (auto& it : cur) {
+		bool includesSnapshot = active[cur.back()].streamIdx == 0 && chunk.snapshotFile.present();
+		for (int i : cur) {
+			auto& it = active[i];
 			auto& v = streams[it.streamIdx][it.dataIdx];
 			if (clearActive[it.streamIdx]) {
 				clearActive[it.streamIdx] = false;
@@ -1440,7 +1653,9 @@ static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
 		}
 
 		// advance streams and start clearAfter
-		for (auto& it : cur) {
+		bool exhausted = false;
+		for (int i : cur) {
+			auto& it = active[i];
 			if (streams[it.streamIdx][it.dataIdx].clearAfter) {
 				clearActive[it.streamIdx] = true;
 				activeClears.insert(it.streamIdx);
@@ -1450,10 +1665,25 @@ static RangeResult mergeDeltaStreams(const BlobGranuleChunkRef& chunk,
 			// if (maxClearIdx > it.streamIdx) - skip
 			it.dataIdx++;
 			if (it.dataIdx < streams[it.streamIdx].size()) {
-				it.key = streams[it.streamIdx][it.dataIdx].key;
-				next.push(it);
+				heads[i] = keyHead(streams[it.streamIdx][it.dataIdx].key, prefixLen);
+			} else {
+				exhausted = true;
 			}
 		}
+
+		// drop finished streams, keeping the rest in order
+		if (exhausted) {
+			int kept = 0;
+			for (int i = 0; i < active.size(); i++) {
+				if (active[i].dataIdx < streams[active[i].streamIdx].size()) {
+					active[kept] = active[i];
+					heads[kept] = heads[i];
+					kept++;
+				}
+			}
+			active.resize(kept);
+			heads.resize(kept);
+		}
 	}
 
 	// FIXME: if memory assumption was wrong and result is significantly smaller than total input size, could copy it
@@ -1601,14 +1831,22 @@ struct GranuleLoadIds {
 	Optional<int64_t> snapshotId;
 	std::vector<int64_t> deltaIds;
 	std::vector<Reference<GranuleLoadFreeHandle>> freeHandles;
+	// files found in the cache, which are not loaded
+	Optional<Standalone<StringRef>> snapshotCached;
+	std::vector<Optional<Standalone<StringRef>>> deltaCached;
 };
 
 static void startLoad(const ReadBlobGranuleContext* granuleContext,
                       const BlobGranuleChunkRef& chunk,
                       GranuleLoadIds& loadIds) {
+	BlobGranuleFileCache* cache = BlobGranuleFileCache::global();
 
-	// Start load process for all files in chunk
-	if (chunk.snapshotFile.present()) {
+	// Start load process for all files in chunk that aren't already cached
+	if (chunk.snapshotFile.present() && cache) {
+		const BlobFilePointerRef& f = chunk.snapshotFile.get();
+		loadIds.snapshotCached = cache->get(f.filename, f.offset, f.length);
+	}
+	if (chunk.snapshotFile.present() && !loadIds.snapshotCached.present()) {
 		std::string snapshotFname = chunk.snapshotFile.get().filename.toString();
 		// FIXME: remove when we implement file multiplexing
 		ASSERT(chunk.snapshotFile.get().offset == 0);
@@ -1621,8 +1859,16 @@ static void startLoad(const ReadBlobGranuleContext* granuleContext,
 		                                                  granuleContext->userContext);
 		loadIds.freeHandles.push_back(makeReference<GranuleLoadFreeHandle>(granuleContext, loadIds.snapshotId.get()));
 	}
-	loadIds.deltaIds.reserve(chunk.deltaFiles.size());
+	loadIds.deltaIds.resize(chunk.deltaFiles.size());
+	loadIds.deltaCached.resize(chunk.deltaFiles.size());
 	for (int deltaFileIdx = 0; deltaFileIdx < chunk.deltaFiles.size(); deltaFileIdx++) {
+		if (cache) {
+			const BlobFilePointerRef& f = chunk.deltaFiles[deltaFileIdx];
+			loadIds.deltaCached[deltaFileIdx] = cache->get(f.filename, f.offset, f.length);
+			if (loadIds.deltaCached[deltaFileIdx].present()) {
+				continue;
+			}
+		}
 		std::string deltaFName = chunk.deltaFiles[deltaFileIdx].filename.toString();
 		// FIXME: remove when we implement file multiplexing
 		ASSERT(chunk.deltaFiles[deltaFileIdx].offset == 0);
@@ -1633,11 +1879,30 @@ static void startLoad(const ReadBlobGranuleContext* granuleContext,
 		                                                   chunk.deltaFiles[deltaFileIdx].length,
 		                                                   chunk.deltaFiles[deltaFileIdx].fullFileLength,
 		                                                   granuleContext->userContext);
-		loadIds.deltaIds.push_back(deltaLoadId);
+		loadIds.deltaIds[deltaFileIdx] = deltaLoadId;
 		loadIds.freeHandles.push_back(makeReference<GranuleLoadFreeHandle>(granuleContext, deltaLoadId));
 	}
 }
 
+// Returns the cached file, or the loaded one, which is then cached. Null data means the load failed.
+static StringRef getLoadedFile(const ReadBlobGranuleContext* granuleContext,
+                               const BlobFilePointerRef& f,
+                               int64_t loadId,
+                               Optional<Standalone<StringRef>>& cached) {
+	if (cached.present()) {
+		return cached.get();
+	}
+	StringRef data(granuleContext->get_load_f(loadId, granuleContext->userContext), f.length);
+	BlobGranuleFileCache* cache = BlobGranuleFileCache::global();
+	if (data.begin() && cache) {
+		// copy it, since the loaded data is freed once the granule is materialized
+		cached = Standalone<StringRef>(data);
+		cache->insert(f.filename, f.offset, f.length, cached.get());
+		return cached.get();
+	}
+	return data;
+}
+
 ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<BlobGranuleChunkRef>>& files,
                                                     const KeyRangeRef& keyRange,
                                                     Version beginVersion,
@@ -1671,9 +1936,10 @@ ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<B
 			// once all loads kicked off, load data for chunk
 			Optional<StringRef> snapshotData;
 			if (files[chunkIdx].snapshotFile.present()) {
-				snapshotData =
-				    StringRef(granuleContext.get_load_f(loadIds[chunkIdx].snapshotId.get(), granuleContext.userContext),
-				              files[chunkIdx].snapshotFile.get().length);
+				snapshotData = getLoadedFile(&granuleContext,
+				                             files[chunkIdx].snapshotFile.get(),
+				                             loadIds[chunkIdx].snapshotId.orDefault(0),
+				                             loadIds[chunkIdx].snapshotCached);
 				if (!snapshotData.get().begin()) {
 					return ErrorOr<RangeResult>(blob_granule_file_load_error());
 				}
@@ -1682,9 +1948,10 @@ ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<B
 			std::vector<StringRef> deltaData;
 			deltaData.resize(files[chunkIdx].deltaFiles.size());
 			for (int i = 0; i < files[chunkIdx].deltaFiles.size(); i++) {
-				deltaData[i] =
-				    StringRef(granuleContext.get_load_f(loadIds[chunkIdx].deltaIds[i], granuleContext.userContext),
-				              files[chunkIdx].deltaFiles[i].length);
+				deltaData[i] = getLoadedFile(&granuleContext,
+				                             files[chunkIdx].deltaFiles[i],
+				                             loadIds[chunkIdx].deltaIds[i],
+				                             loadIds[chunkIdx].deltaCached[i]);
 				// null data is error
 				if (!deltaData[i].begin()) {
 					return ErrorOr<RangeResult>(blob_granule_file_load_error());
@@ -1700,6 +1967,8 @@ ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<B
 
 			// free once done by forcing FreeHandles to trigger
 			loadIds[chunkIdx].freeHandles.clear();
+			loadIds[chunkIdx].snapshotCached.reset();
+			loadIds[chunkIdx].deltaCached.clear();
 		}
 		return ErrorOr<RangeResult>(results);
 	} catch (Error& e) {
@@ -1707,6 +1976,26 @@ ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<B
 	}
 }
 
+Standalone<VectorRef<KeyRef>> getSnapshotSplitKeys(const StringRef& snapshotData,
+                                                   Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
+                                                   int64_t targetBytes) {
+	Standalone<VectorRef<KeyRef>> splitKeys;
+	Standalone<IndexedBlobGranuleFile> file = IndexedBlobGranuleFile::fromFileBytes(snapshotData, cipherKeysCtx);
+	ASSERT(file.fileType == SNAPSHOT_FILE_TYPE);
+
+	// the last child only marks where the last chunk ends
+	const VectorRef<ChildBlockPointerRef>& children = file.indexBlockRef.block.children;
+	int64_t bytes = 0;
+	for (int i = 0; i + 1 < children.size(); i++) {
+		if (bytes >= targetBytes) {
+			splitKeys.push_back_deep(splitKeys.arena(), children[i].key);
+			bytes = 0;
+		}
+		bytes += children[i + 1].offset - children[i].offset;
+	}
+	return splitKeys;
+}
+
 // just for client passthrough. reads all key-value pairs from a snapshot file, and all mutations from a delta file
 RangeResult bgReadSnapshotFile(const StringRef& data,
                                Optional<KeyRef> tenantPrefix,
@@ -1759,7 +2048,7 @@ Standalone<VectorRef<GranuleMutationRef>> bgReadDeltaFile(const StringRef& delta
 		lastBlock = (nextBlock == file.indexBlockRef.block.children.end() - 1);
 
 		Standalone<GranuleSortedDeltas> deltaBlock =
-		    file.getChild<GranuleSortedDeltas>(currentBlock, encryptionCtx, file.chunkStartOffset);
+		    file.getDeltaChild(currentBlock, encryptionCtx, file.chunkStartOffset);
 		ASSERT(!deltaBlock.boundaries.empty());
 		ASSERT(currentBlock->key == deltaBlock.boundaries.front().key);
 
@@ -2422,19 +2711,22 @@ TEST_CASE("/blobgranule/files/validateEncryptionCompression") {
 	for (bool encryptionMode : encryptionModes) {
 		Optional<BlobGranuleCipherKeysCtx> keys = encryptionMode ? cipherKeys : Optional<BlobGranuleCipherKeysCtx>();
 		for (auto& compressionMode : compressionModes) {
-			Value v = serializeChunkedDeltaFile(
-			    fileNameRef, deltaData, kvGen.allRange, targetDeltaChunkSize, compressionMode, keys);
-			fmt::print("delta({0}, {1}): {2}\n",
-			           encryptionMode,
-			           compressionMode.present() ? CompressionUtils::toString(compressionMode.get()) : "",
-			           v.size());
-			for (auto& v2 : deltaValues) {
-				ASSERT(v != v2);
+			for (bool columnar : { false, true }) {
+				Value v = serializeChunkedDeltaFile(
+				    fileNameRef, deltaData, kvGen.allRange, targetDeltaChunkSize, compressionMode, keys, columnar);
+				fmt::print("delta({0}, {1}, {2}): {3}\n",
+				           encryptionMode,
+				           compressionMode.present() ? CompressionUtils::toString(compressionMode.get()) : "",
+				           columnar ? "columnar" : "row",
+				           v.size());
+				for (auto& v2 : deltaValues) {
+					ASSERT(v != v2);
+				}
+				deltaValues.push_back(v);
 			}
-			deltaValues.push_back(v);
 		}
 	}
-	fmt::print("Validated {0} encryption/compression combos for delta\n", deltaValues.size());
+	fmt::print("Validated {0} encryption/compression/format combos for delta\n", deltaValues.size());
 
 	return Void();
 }
@@ -2499,6 +2791,15 @@ TEST_CASE("/blobgranule/files/snapshotFormatUnitTest") {
 	checkSnapshotEmpty(serialized, keyAfter(data.back().key), normalKeys.end, kvGen.cipherKeys);
 	checkSnapshotEmpty(serialized, "\xfe"_sr, normalKeys.end, kvGen.cipherKeys);
 
+	fmt::print("Checking split keys\n");
+	Standalone<VectorRef<KeyRef>> everyChunk = getSnapshotSplitKeys(serialized, kvGen.cipherKeys, 1);
+	for (int i = 0; i < everyChunk.size(); i++) {
+		ASSERT(i == 0 || everyChunk[i - 1] < everyChunk[i]);
+		ASSERT(std::binary_search(
+		    data.begin(), data.end(), KeyValueRef(everyChunk[i], ValueRef()), KeyValueRef::OrderByKey()));
+	}
+	ASSERT(getSnapshotSplitKeys(serialized, kvGen.cipherKeys, serialized.size()).empty());
+
 	fmt::print("Snapshot format test done!\n");
 
 	return Void();
@@ -2609,8 +2910,10 @@ TEST_CASE("/blobgranule/files/deltaFormatUnitTest") {
 	        }
 	    }
 	}*/
+	bool columnar = deterministicRandom()->coinflip();
+	fmt::print("Delta file format: {0}\n", columnar ? "columnar" : "row");
 	Value serialized = serializeChunkedDeltaFile(
-	    fileNameRef, data, kvGen.allRange, targetChunkSize, kvGen.compressFilter, kvGen.cipherKeys);
+	    fileNameRef, data, kvGen.allRange, targetChunkSize, kvGen.compressFilter, kvGen.cipherKeys, columnar);
 	std::vector<StringRef> deltaPtr{ serialized };
 
 	// check whole file
@@ -2796,7 +3099,8 @@ TEST_CASE("/blobgranule/files/granuleReadUnitTest") {
 				                                                  kvGen.allRange,
 				                                                  targetDeltaChunkSize,
 				                                                  kvGen.compressFilter,
-				                                                  kvGen.cipherKeys);
+				                                                  kvGen.cipherKeys,
+				                                                  deterministicRandom()->coinflip());
 				serializedDeltaFiles.emplace_back(fileData.back().version, serializedDelta);
 			}
 		}
@@ -2928,7 +3232,8 @@ TEST_CASE("/blobgranule/files/bgReadDeltaFile") {
 		                                             KeyRangeRef(t_strA, t_strAfterE),
 		                                             chunkSize,
 		                                             kvGen.compressFilter,
-		                                             kvGen.cipherKeys);
+		                                             kvGen.cipherKeys,
+		                                             deterministicRandom()->coinflip());
 		Standalone<VectorRef<GranuleMutationRef>> actualMutations =
 		    bgReadDeltaFile(serialized, addTenantPrefix ? tenantPrefix : Optional<KeyRef>(), kvGen.cipherKeys);
 
@@ -24,6 +24,7 @@
 #include "fmt/format.h"
 #include "fdbclient/AsyncFileS3BlobStore.actor.h"
 #include "fdbclient/BlobGranuleCommon.h"
+#include "fdbclient/BlobGranuleFileCache.h"
 #include "fdbclient/BlobGranuleFiles.h"
 #include "fdbclient/BlobGranuleReader.actor.h"
 #include "fdbclient/BlobWorkerCommon.h"
@@ -31,8 +32,31 @@
 #include "fdbclient/FDBTypes.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
-ACTOR Future<Standalone<StringRef>> readFile(Reference<BlobConnectionProvider> bstoreProvider, BlobFilePointerRef f) {
+// Reads from the process's memory cache, then the disk cache if there is one, and then the blob store
+ACTOR Future<Standalone<StringRef>> readFile(Reference<BlobConnectionProvider> bstoreProvider,
+                                             BlobFilePointerRef f,
+                                             Reference<BlobGranuleDiskCache> diskCache,
+                                             Optional<BlobWorkerStats*> stats) {
 	try {
+		state BlobGranuleFileCache* cache = BlobGranuleFileCache::global();
+		if (cache) {
+			Optional<Standalone<StringRef>> cached = cache->get(f.filename, f.offset, f.length);
+			if (cached.present()) {
+				CODE_PROBE(true, "Blob granule file read from memory cache");
+				return cached.get();
+			}
+		}
+		if (diskCache) {
+			Optional<Standalone<StringRef>> onDisk = wait(diskCache->read(f.filename, f.offset, f.length));
+			if (onDisk.present()) {
+				CODE_PROBE(true, "Blob granule file read from disk cache");
+				if (cache) {
+					cache->insert(f.filename, f.offset, f.length, onDisk.get());
+				}
+				return onDisk.get();
+			}
+		}
+
 		state Arena arena;
 		std::string fname = f.filename.toString();
 		state Reference<BackupContainerFileSystem> bstore = bstoreProvider->getForRead(fname);
@@ -40,16 +64,54 @@ ACTOR Future<Standalone<StringRef>> readFile(Reference<BlobConnectionProvider> b
 
 		state uint8_t* data = new (arena) uint8_t[f.length];
 
+		if (stats.present()) {
+			++stats.get()->s3GetReqs;
+		}
 		int readSize = wait(reader->read(data, f.length, f.offset));
 		ASSERT(f.length == readSize);
 
-		StringRef dataRef(data, f.length);
-		return Standalone<StringRef>(dataRef, arena);
+		Standalone<StringRef> result(StringRef(data, f.length), arena);
+		if (cache) {
+			cache->insert(f.filename, f.offset, f.length, result);
+		}
+		if (diskCache) {
+			diskCache->write(f.filename, f.offset, f.length, result);
+		}
+		return result;
 	} catch (Error& e) {
 		throw e;
 	}
 }
 
+struct GranuleFileBytes {
+	Optional<Standalone<StringRef>> snapshot;
+	std::vector<Standalone<StringRef>> deltas;
+};
+
+ACTOR static Future<GranuleFileBytes> readChunkFiles(BlobGranuleChunkRef chunk,
+                                                     Reference<BlobConnectionProvider> bstore,
+                                                     Optional<BlobWorkerStats*> stats,
+                                                     Reference<BlobGranuleDiskCache> diskCache) {
+	state Future<Standalone<StringRef>> readSnapshotFuture;
+	if (chunk.snapshotFile.present()) {
+		readSnapshotFuture = readFile(bstore, chunk.snapshotFile.get(), diskCache, stats);
+	}
+	state std::vector<Future<Standalone<StringRef>>> readDeltaFutures;
+	readDeltaFutures.reserve(chunk.deltaFiles.size());
+	for (BlobFilePointerRef deltaFile : chunk.deltaFiles) {
+		readDeltaFutures.push_back(readFile(bstore, deltaFile, diskCache, stats));
+	}
+
+	state GranuleFileBytes files;
+	if (chunk.snapshotFile.present()) {
+		Standalone<StringRef> s = wait(readSnapshotFuture);
+		files.snapshot = s;
+	}
+	std::vector<Standalone<StringRef>> deltas = wait(getAll(readDeltaFutures));
+	files.deltas = std::move(deltas);
+	return files;
+}
+
 // TODO: improve the interface of this function so that it doesn't need
 //       to be passed the entire BlobWorkerStats object
 
@@ -60,48 +122,20 @@ ACTOR Future<RangeResult> readBlobGranule(BlobGranuleChunkRef chunk,
                                           Version beginVersion,
                                           Version readVersion,
                                           Reference<BlobConnectionProvider> bstore,
-                                          Optional<BlobWorkerStats*> stats) {
+                                          Optional<BlobWorkerStats*> stats,
+                                          Reference<BlobGranuleDiskCache> diskCache) {
 
 	// TODO REMOVE with early replying
 	ASSERT(readVersion == chunk.includedVersion);
 
-	state Arena arena;
-
 	try {
-		Future<Standalone<StringRef>> readSnapshotFuture;
-		if (chunk.snapshotFile.present()) {
-			readSnapshotFuture = readFile(bstore, chunk.snapshotFile.get());
-			if (stats.present()) {
-				++stats.get()->s3GetReqs;
-			}
-		}
-		state std::vector<Future<Standalone<StringRef>>> readDeltaFutures;
+		state GranuleFileBytes files = wait(readChunkFiles(chunk, bstore, stats, diskCache));
 
-		readDeltaFutures.reserve(chunk.deltaFiles.size());
-		for (BlobFilePointerRef deltaFile : chunk.deltaFiles) {
-			readDeltaFutures.push_back(readFile(bstore, deltaFile));
-			if (stats.present()) {
-				++stats.get()->s3GetReqs;
-			}
-		}
-
-		state Optional<StringRef> snapshotData; // not present if snapshotFile isn't present
-		if (chunk.snapshotFile.present()) {
-			state Standalone<StringRef> s = wait(readSnapshotFuture);
-			arena.dependsOn(s.arena());
-			snapshotData = s;
-		}
-
-		state int numDeltaFiles = chunk.deltaFiles.size();
-		state std::vector<StringRef> deltaData;
-		state int deltaIdx;
-
-		deltaData.reserve(numDeltaFiles);
-		for (deltaIdx = 0; deltaIdx < numDeltaFiles; deltaIdx++) {
-			Standalone<StringRef> data = wait(readDeltaFutures[deltaIdx]);
-			deltaData.push_back(data);
-			arena.dependsOn(data.arena());
+		Optional<StringRef> snapshotData; // not present if snapshotFile isn't present
+		if (files.snapshot.present()) {
+			snapshotData = files.snapshot.get();
 		}
+		std::vector<StringRef> deltaData(files.deltas.begin(), files.deltas.end());
 
 		// TODO do something useful with stats?
 		GranuleMaterializeStats stats;
@@ -112,6 +146,52 @@ ACTOR Future<RangeResult> readBlobGranule(BlobGranuleChunkRef chunk,
 	}
 }
 
+ACTOR Future<Void> streamBlobGranule(BlobGranuleChunkRef chunk,
+                                     KeyRange keyRange,
+                                     Version readVersion,
+                                     Reference<BlobConnectionProvider> bstore,
+                                     PromiseStream<RangeResult> results,
+                                     int64_t sliceBytes,
+                                     Optional<BlobWorkerStats*> stats,
+                                     Reference<BlobGranuleDiskCache> diskCache) {
+	ASSERT(readVersion == chunk.includedVersion);
+
+	state GranuleFileBytes files = wait(readChunkFiles(chunk, bstore, stats, diskCache));
+	state Optional<StringRef> snapshotData;
+	state Standalone<VectorRef<KeyRef>> splitKeys;
+	if (files.snapshot.present()) {
+		snapshotData = files.snapshot.get();
+		// the index keys include the tenant prefix, which keyRange doesn't
+		if (!chunk.tenantPrefix.present()) {
+			splitKeys = getSnapshotSplitKeys(snapshotData.get(), chunk.snapshotFile.get().cipherKeysCtx, sliceBytes);
+		}
+	}
+	state std::vector<StringRef> deltaData(files.deltas.begin(), files.deltas.end());
+
+	state Key sliceBegin = keyRange.begin;
+	state int splitIdx = 0;
+	loop {
+		while (splitIdx < splitKeys.size() && splitKeys[splitIdx] <= sliceBegin) {
+			splitIdx++;
+		}
+		state Key sliceEnd = splitIdx < splitKeys.size() && splitKeys[splitIdx] < keyRange.end
+		                         ? Key(splitKeys[splitIdx], splitKeys.arena())
+		                         : keyRange.end;
+
+		GranuleMaterializeStats materializeStats;
+		RangeResult rows = materializeBlobGranule(
+		    chunk, KeyRangeRef(sliceBegin, sliceEnd), 0, readVersion, snapshotData, deltaData, materializeStats);
+		if (!rows.empty()) {
+			results.send(std::move(rows));
+		}
+		if (sliceEnd == keyRange.end) {
+			return Void();
+		}
+		sliceBegin = sliceEnd;
+		wait(yield());
+	}
+}
+
 // TODO probably should add things like limit/bytelimit at some point?
 ACTOR Future<Void> readBlobGranules(BlobGranuleFileRequest request,
                                     BlobGranuleFileReply reply,
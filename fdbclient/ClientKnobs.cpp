@@ -22,6 +22,7 @@
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/SystemData.h"
 #include "fdbclient/Tenant.h"
+#include "flow/CompressionUtils.h"
 #include "flow/IRandom.h"
 #include "flow/UnitTest.h"
 #include "flow/flow.h"
@@ -64,6 +65,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( GRV_ERROR_RETRY_DELAY,                   5.0 ); if( randomize && BUGGIFY ) GRV_ERROR_RETRY_DELAY = 0.01 + 5 * deterministicRandom()->random01();
 	init( UNKNOWN_TENANT_RETRY_DELAY,              .01 ); if( randomize && BUGGIFY ) UNKNOWN_TENANT_RETRY_DELAY = 0.01 + deterministicRandom()->random01();
 	init( REPLY_BYTE_LIMIT,                      80000 );
+	init( GET_VALUES_MAX_KEYS,                     500 ); if( randomize && BUGGIFY ) GET_VALUES_MAX_KEYS = deterministicRandom()->randomInt(1, 10);
 	init( DEFAULT_BACKOFF,                         .01 ); if( randomize && BUGGIFY ) DEFAULT_BACKOFF = deterministicRandom()->random01();
 	init( DEFAULT_MAX_BACKOFF,                     1.0 );
 	init( BACKOFF_GROWTH_RATE,                     2.0 );
@@ -77,6 +79,8 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( SYSTEM_KEY_SIZE_LIMIT,                   3e4 );
 	init( VALUE_SIZE_LIMIT,                        1e5 );
 	init( SPLIT_KEY_SIZE_LIMIT,                    KEY_SIZE_LIMIT/2 );  if( randomize && BUGGIFY ) SPLIT_KEY_SIZE_LIMIT = KEY_SIZE_LIMIT - 31;//serverKeysPrefixFor(UID()).size() - 1;
+	init( RYW_LOG_BLIND_WRITES,                   true ); if( randomize && BUGGIFY ) RYW_LOG_BLIND_WRITES = false;
+	init( COMPACT_COMMIT_REQUESTS,                true ); if( randomize && BUGGIFY ) COMPACT_COMMIT_REQUESTS = false;
 	init( METADATA_VERSION_CACHE_SIZE,            1000 );
 	init( CHANGE_FEED_LOCATION_LIMIT,            10000 );
 	init( CHANGE_FEED_CACHE_SIZE,               100000 ); if( randomize && BUGGIFY ) CHANGE_FEED_CACHE_SIZE = 1;
@@ -92,13 +96,21 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( GRV_BATCH_TIMEOUT,                     0.005 ); if( randomize && BUGGIFY ) GRV_BATCH_TIMEOUT = 0.1;
 	init( BROADCAST_BATCH_SIZE,                     20 ); if( randomize && BUGGIFY ) BROADCAST_BATCH_SIZE = 1;
 	init( TRANSACTION_TIMEOUT_DELAY_INTERVAL,     10.0 ); if( randomize && BUGGIFY ) TRANSACTION_TIMEOUT_DELAY_INTERVAL = 1.0;
+	init( TRANSACTION_PROFILE_MAX_READS,           100 ); if( randomize && BUGGIFY ) TRANSACTION_PROFILE_MAX_READS = 2;
 
 	init( LOCATION_CACHE_EVICTION_SIZE,         600000 );
 	init( LOCATION_CACHE_EVICTION_SIZE_SIM,         10 ); if( randomize && BUGGIFY ) LOCATION_CACHE_EVICTION_SIZE_SIM = 3;
 	init( LOCATION_CACHE_ENDPOINT_FAILURE_GRACE_PERIOD,     60 );
 	init( LOCATION_CACHE_FAILED_ENDPOINT_RETRY_INTERVAL,    60 );
+	init( LOCATION_CACHE_SNAPSHOT_INTERVAL,       60.0 );
+	init( LOCATION_CACHE_SNAPSHOT_MAX_AGE,      3600.0 ); // Older snapshots are not loaded, since most of their storage server interfaces are likely to be stale
+	init( LOCATION_CACHE_SNAPSHOT_MAX_ENTRIES,  100000 );
+	init( LOCATION_CACHE_SNAPSHOT_MAX_BYTES,     100e6 );
+	init( LOCATION_CACHE_PREFETCH_SHARDS,            4 ); if( randomize && BUGGIFY ) LOCATION_CACHE_PREFETCH_SHARDS = deterministicRandom()->randomInt(0, 100); // The number of adjacent shards to also cache on a location cache miss for a key
 
 	init( GET_RANGE_SHARD_LIMIT,                     2 );
+	init( GET_RANGE_COMPRESSION_FILTER,         "NONE" ); if( randomize && BUGGIFY ) GET_RANGE_COMPRESSION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter()); // Compression storage servers may use for large range read replies, or NONE
+	init( MAX_RANGE_READ_PARALLELISM,               64 );
 	init( WARM_RANGE_SHARD_LIMIT,                  100 );
 	init( STORAGE_METRICS_SHARD_LIMIT,             100 ); if( randomize && BUGGIFY ) STORAGE_METRICS_SHARD_LIMIT = 10;
 	init( SHARD_COUNT_LIMIT,                        80 ); if( randomize && BUGGIFY ) SHARD_COUNT_LIMIT = 3;
@@ -107,6 +119,8 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( AGGREGATE_HEALTH_METRICS_MAX_STALENESS,  0.5 );
 	init( DETAILED_HEALTH_METRICS_MAX_STALENESS,   5.0 );
 	init( MID_SHARD_SIZE_MAX_STALENESS,           10.0 );
+	init( HOT_KEYS_REPORTED,                        10 );
+	init( HOT_KEYS_TIMEOUT,                        5.0 );
 	init( TAG_ENCODE_KEY_SERVERS,                false ); if( randomize && BUGGIFY ) TAG_ENCODE_KEY_SERVERS = true;
 	init( RANGESTREAM_FRAGMENT_SIZE,               1e6 );
 	init( RANGESTREAM_BUFFERED_FRAGMENTS_LIMIT,     20 );
@@ -145,6 +159,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( TASKBUCKET_CHECK_ACTIVE_AMOUNT,           10 );
 	init( TASKBUCKET_TIMEOUT_VERSIONS,     60*CORE_VERSIONSPERSECOND ); if( randomize && BUGGIFY ) TASKBUCKET_TIMEOUT_VERSIONS = 30*CORE_VERSIONSPERSECOND;
 	init( TASKBUCKET_MAX_TASK_KEYS,               1000 ); if( randomize && BUGGIFY ) TASKBUCKET_MAX_TASK_KEYS = 20;
+	init( TASKBUCKET_BATCH_CLAIM,                 true ); if( randomize && BUGGIFY ) TASKBUCKET_BATCH_CLAIM = false;
 
 	//Backup
 	init( BACKUP_LOCAL_FILE_WRITE_BLOCK,     1024*1024 );
@@ -180,6 +195,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( SIM_BACKUP_TASKS_PER_AGENT,               10 );
 	init( BACKUP_RANGEFILE_BLOCK_SIZE,      1024 * 1024);
 	init( BACKUP_LOGFILE_BLOCK_SIZE,        1024 * 1024);
+	init( BACKUP_COMPRESS_RANGE_FILES,            false ); if( randomize && BUGGIFY ) BACKUP_COMPRESS_RANGE_FILES = true; // Older clients can't restore compressed range files
 	init( BACKUP_DISPATCH_ADDTASK_SIZE,             50 );
 	init( RESTORE_DISPATCH_ADDTASK_SIZE,           150 );
 	init( RESTORE_DISPATCH_BATCH_SIZE,           30000 ); if( randomize && BUGGIFY ) RESTORE_DISPATCH_BATCH_SIZE = 20;
@@ -230,11 +246,16 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( BLOBSTORE_CONCURRENT_READS_PER_FILE,       3 );
 	init( BLOBSTORE_ENABLE_READ_CACHE,            true );
 	init( BLOBSTORE_READ_BLOCK_SIZE,       1024 * 1024 );
-	init( BLOBSTORE_READ_AHEAD_BLOCKS,               0 );
+	init( BLOBSTORE_READ_AHEAD_BLOCKS,               8 );
+	init( BLOBSTORE_READ_AHEAD_CACHE_BYTES,        256e6 ); // Bounds the blocks read ahead by all blob store files in the process
 	init( BLOBSTORE_READ_CACHE_BLOCKS_PER_FILE,      2 );
 	init( BLOBSTORE_MULTIPART_MAX_PART_SIZE,  20000000 );
 	init( BLOBSTORE_MULTIPART_MIN_PART_SIZE,   5242880 );
 	init( BLOBSTORE_GLOBAL_CONNECTION_POOL,      false );
+	init( BLOBSTORE_ADAPTIVE_UPLOADS,                0 );
+	init( BLOBSTORE_ADAPTIVE_PART_SECONDS,         2.0 );
+	init( BLOBSTORE_ADAPTIVE_MAX_WRITES_PER_FILE,   32 );
+	init( BLOBSTORE_ADAPTIVE_LATENCY_RATIO,        2.0 ); // Parts uploading this many times slower per byte than the best seen mean the link is congested
 	init( BLOBSTORE_ENABLE_LOGGING,               true );
 	init( BLOBSTORE_STATS_LOGGING_INTERVAL,       10.0 );
 	init( BLOBSTORE_LATENCY_LOGGING_INTERVAL,    120.0 );
@@ -267,6 +288,9 @@ void ClientKnobs::initialize(Randomize randomize) {
 		CSI_SIZE_LIMIT = deterministicRandom()->randomInt(1024 * 1024, 100 * 1024 * 1024); // 1 MB - 100 MB
 	}
 	init(CSI_STATUS_DELAY,						  10.0  );
+	init( TRANSACTION_CAPTURE_SAMPLING_PROBABILITY,     0.01 );
+	init( TRANSACTION_CAPTURE_FLUSH_INTERVAL,            1.0 );
+	init( TRANSACTION_CAPTURE_MAX_BYTES,                 1e9 ); // Capture stops once the file reaches this size
 
 	init( CONSISTENCY_CHECK_RATE_LIMIT_MAX,        50e6 ); // Limit in per sec
 	init( CONSISTENCY_CHECK_ONE_ROUND_TARGET_COMPLETION_TIME,	7 * 24 * 60 * 60 ); // 7 days
@@ -309,6 +333,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	// Blob granules
 	init( BG_MAX_GRANULE_PARALLELISM,                10 );
 	init( BG_TOO_MANY_GRANULES,                   20000 );
+	init( BG_FILE_CACHE_BYTES,               128 << 20 ); if( randomize && BUGGIFY ) BG_FILE_CACHE_BYTES = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(1, 1 << 20);
 	init( BLOB_METADATA_REFRESH_INTERVAL,          3600 ); if ( randomize && BUGGIFY ) { BLOB_METADATA_REFRESH_INTERVAL = deterministicRandom()->randomInt(5, 120); }
 	init( DETERMINISTIC_BLOB_METADATA,            false ); if( randomize && BUGGIFY_WITH_PROB(0.01) ) DETERMINISTIC_BLOB_METADATA = true;
 	init( ENABLE_BLOB_GRANULE_FILE_LOGICAL_SIZE,  false ); if ( randomize && BUGGIFY ) { ENABLE_BLOB_GRANULE_FILE_LOGICAL_SIZE = true; }
@@ -325,6 +350,7 @@ void ClientKnobs::initialize(Randomize randomize) {
 	init( METACLUSTER_ASSIGNMENT_FIRST_CHOICE_DELAY, 1.0 ); if ( randomize && BUGGIFY ) METACLUSTER_ASSIGNMENT_FIRST_CHOICE_DELAY = deterministicRandom()->random01() * 60;
 	init( METACLUSTER_ASSIGNMENT_AVAILABILITY_TIMEOUT, 10.0 ); if ( randomize && BUGGIFY ) METACLUSTER_ASSIGNMENT_AVAILABILITY_TIMEOUT = 1 + deterministicRandom()->random01() * 59;
 	init( METACLUSTER_RESTORE_BATCH_SIZE,          1000 ); if ( randomize && BUGGIFY ) METACLUSTER_RESTORE_BATCH_SIZE = 1 + deterministicRandom()->randomInt(0, 3);
+	init( METACLUSTER_TENANT_BATCH_CONCURRENCY,      20 ); if ( randomize && BUGGIFY ) METACLUSTER_TENANT_BATCH_CONCURRENCY = deterministicRandom()->randomInt(1, 4);
 	init( TENANT_ENTRY_CACHE_LIST_REFRESH_INTERVAL,   2 ); if( randomize && BUGGIFY ) TENANT_ENTRY_CACHE_LIST_REFRESH_INTERVAL = deterministicRandom()->randomInt(1, 10);
 	init( CLIENT_ENABLE_USING_CLUSTER_ID_KEY,     false );
 
@@ -164,8 +164,106 @@ private:
 	bool healthy;
 };
 
+json_spirit::mObject histogramReport(DDSketch<double> const& logged, DDSketch<double> const& current) {
+	DDSketch<double> sketch = logged;
+	sketch.mergeWith(current);
+
+	json_spirit::mObject histogram;
+	int64_t count = sketch.getPopulationSize();
+	histogram["Count"] = count;
+	histogram["Sum"] = sketch.getSum();
+	histogram["Min"] = count > 0 ? sketch.min() : 0.0;
+	histogram["Max"] = count > 0 ? sketch.max() : 0.0;
+	histogram["ErrorGuarantee"] = sketch.getErrorGuarantee();
+
+	json_spirit::mArray buckets;
+	std::vector<uint32_t> samples = sketch.getSamples();
+	int64_t zeros = count;
+	for (uint32_t s : samples) {
+		zeros -= s;
+	}
+	if (zeros > 0) {
+		buckets.push_back(json_spirit::mArray{ 0.0, zeros });
+	}
+	for (size_t i = 0; i < samples.size(); i++) {
+		if (samples[i] > 0) {
+			buckets.push_back(json_spirit::mArray{ sketch.getValue(i), static_cast<int64_t>(samples[i]) });
+		}
+	}
+	histogram["Buckets"] = buckets;
+	return histogram;
+}
+
 } // namespace
 
+// Get client-side counters and latency histograms
+Standalone<StringRef> DatabaseContext::getMetrics() {
+	json_spirit::mObject metricsObj;
+	if (isError()) {
+		metricsObj["InitializationError"] = deferredError.code();
+	} else {
+		json_spirit::mObject counters;
+		for (const ICounter* counter : cc.getCounters()) {
+			counters[counter->getName()] = counter->getValue();
+		}
+		metricsObj["Counters"] = counters;
+
+		json_spirit::mObject histograms;
+		histograms["Transaction"] = histogramReport(loggedLatencies, latencies);
+		histograms["GRV"] = histogramReport(loggedGRVLatencies, GRVLatencies);
+		histograms["Read"] = histogramReport(loggedReadLatencies, readLatencies);
+		histograms["Commit"] = histogramReport(loggedCommitLatencies, commitLatencies);
+		metricsObj["Latencies"] = histograms;
+	}
+	return StringRef(json_spirit::write_string(json_spirit::mValue(metricsObj)));
+}
+
+// Get the most recent transaction profiles
+Standalone<StringRef> DatabaseContext::getTransactionProfiles() {
+	json_spirit::mObject profilesObj;
+	if (isError()) {
+		profilesObj["InitializationError"] = deferredError.code();
+	} else {
+		json_spirit::mArray transactions;
+		for (const TransactionProfile& profile : transactionProfiles) {
+			json_spirit::mObject transaction;
+			transaction["StartTime"] = profile.startTime;
+			transaction["Duration"] = profile.endTime - profile.startTime;
+			if (!profile.debugIdentifier.empty()) {
+				transaction["DebugID"] = profile.debugIdentifier;
+			}
+			transaction["Retries"] = profile.retries;
+			if (profile.grvLatency.present()) {
+				transaction["GRVLatency"] = profile.grvLatency.get();
+			}
+			transaction["LocationLookups"] = profile.locationLookups;
+			transaction["LocationLatency"] = profile.locationLatency;
+
+			json_spirit::mArray reads;
+			for (const TransactionProfile::Read& read : profile.reads) {
+				json_spirit::mObject readObj;
+				readObj["Type"] = read.type == TransactionProfile::ReadType::GET ? "Get" : "GetRange";
+				readObj["StartTime"] = read.startTime - profile.startTime;
+				readObj["Latency"] = read.latency;
+				readObj["Bytes"] = read.bytes;
+				reads.push_back(readObj);
+			}
+			transaction["Reads"] = reads;
+			transaction["ReadsDropped"] = profile.readsDropped;
+
+			if (profile.commitLatency.present()) {
+				transaction["CommitLatency"] = profile.commitLatency.get();
+			}
+			if (profile.errorCode.present()) {
+				transaction["Error"] = profile.errorCode.get();
+			}
+			transactions.push_back(transaction);
+		}
+		profilesObj["Transactions"] = transactions;
+	}
+	return StringRef(json_spirit::write_string(json_spirit::mValue(profilesObj)));
+}
+
 // Get client-side status information
 Standalone<StringRef> DatabaseContext::getClientStatus() {
 	ClientReportGenerator generator(*this);
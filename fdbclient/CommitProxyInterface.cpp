@@ -1,6 +1,8 @@
 #include "fdbclient/CommitProxyInterface.h"
 #include "fdbclient/CoordinationInterface.h"
 #include "fdbclient/GetEncryptCipherKeys_impl.actor.h"
+#include "fdbclient/KeyRangeMap.h"
+#include "flow/UnitTest.h"
 
 // Instantiate ClientDBInfo related templates
 template class ReplyPromise<struct ClientDBInfo>;
@@ -12,4 +14,187 @@ template struct NetNotifiedQueue<OpenDatabaseCoordRequest, true>;
 
 // Instantiate GetKeyServerLocationsReply related templates
 template class ReplyPromise<GetKeyServerLocationsReply>;
-template struct NetSAV<GetKeyServerLocationsReply>;
\ No newline at end of file
+template struct NetSAV<GetKeyServerLocationsReply>;
+VectorRef<KeyValueRef> TxnStateRequest::getData(Arena& arena) const {
+	if (compressionFilter == CompressionFilter::NONE) {
+		return data;
+	}
+	return decodeData(CompressionUtils::decompress(compressionFilter, compressedData, arena), arena);
+}
+
+Standalone<StringRef> TxnStateRequest::encodeData(VectorRef<KeyValueRef> data) {
+	BinaryWriter wr(Unversioned());
+	wr << data.size();
+	KeyRef prev;
+	for (auto const& kv : data) {
+		int shared = commonPrefixLength(prev, kv.key);
+		wr << shared << kv.key.substr(shared) << kv.value;
+		prev = kv.key;
+	}
+	return wr.toValue();
+}
+
+VectorRef<KeyValueRef> TxnStateRequest::decodeData(StringRef encoded, Arena& arena) {
+	ArenaReader rd(arena, encoded, Unversioned());
+	int count;
+	rd >> count;
+	VectorRef<KeyValueRef> result;
+	result.reserve(arena, count);
+	KeyRef prev;
+	for (int i = 0; i < count; i++) {
+		int shared;
+		StringRef suffix;
+		ValueRef value;
+		rd >> shared >> suffix >> value;
+		KeyRef key = suffix;
+		if (shared) {
+			ASSERT(shared <= prev.size());
+			key = prev.substr(0, shared).withSuffix(suffix, arena);
+		}
+		result.push_back(arena, KeyValueRef(key, value));
+		prev = key;
+	}
+	return result;
+}
+
+namespace {
+
+// Sorts ranges and merges those within normal keys which touch or overlap, dropping empty and repeated ones
+void coalesceRanges(VectorRef<KeyRangeRef>& ranges) {
+	std::sort(ranges.begin(), ranges.end(), [](KeyRangeRef const& a, KeyRangeRef const& b) {
+		return a.begin < b.begin || (a.begin == b.begin && a.end < b.end);
+	});
+	int n = 0;
+	for (int i = 0; i < ranges.size(); i++) {
+		if (ranges[i].empty() || (n && ranges[i] == ranges[n - 1])) {
+			continue;
+		}
+		if (n && ranges[n - 1].end <= normalKeys.end && ranges[i].end <= normalKeys.end &&
+		    ranges[i].begin <= ranges[n - 1].end) {
+			if (ranges[n - 1].end < ranges[i].end) {
+				ranges[n - 1] = KeyRangeRef(ranges[n - 1].begin, ranges[i].end);
+			}
+		} else {
+			ranges[n++] = ranges[i];
+		}
+	}
+	while (ranges.size() > n) {
+		ranges.pop_back();
+	}
+}
+
+} // namespace
+
+void CommitTransactionRef::compact(Arena& arena) {
+	if (mutations.size() > 1 && encryptedMutations.empty()) {
+		// Walking backwards, a mutation whose keys are all set or cleared by a later one has no effect. Versionstamped
+		// keys are not known until the commit, and system keys may have side effects other than their contents.
+		CoalescedKeyRefRangeMap<bool> overwritten;
+		int kept = mutations.size();
+		for (int i = mutations.size() - 1; i >= 0; i--) {
+			MutationRef const& m = mutations[i];
+			bool superseded = false;
+			if (m.type == MutationRef::ClearRange) {
+				if (m.param1 >= m.param2) {
+					superseded = true;
+				} else if (m.param2 <= normalKeys.end) {
+					auto r = overwritten.rangeContaining(m.param1);
+					superseded = r.value() && r.end() >= m.param2;
+					if (!superseded) {
+						overwritten.insert(KeyRangeRef(m.param1, m.param2), true);
+					}
+				}
+			} else if (isSingleKeyMutation((MutationRef::Type)m.type) && m.type != MutationRef::SetVersionstampedKey &&
+			           m.param1 < normalKeys.end) {
+				superseded = overwritten[m.param1];
+				if (!superseded && m.type == MutationRef::SetValue) {
+					overwritten.insert(m.param1, true, arena);
+				}
+			}
+			if (!superseded) {
+				mutations[--kept] = m;
+			}
+		}
+		if (kept) {
+			CODE_PROBE(true, "Superseded mutations dropped from commit");
+			mutations = VectorRef<MutationRef>(mutations.begin() + kept, mutations.size() - kept);
+		}
+	}
+
+	if (!report_conflicting_keys) {
+		coalesceRanges(read_conflict_ranges);
+	}
+	coalesceRanges(write_conflict_ranges);
+}
+
+TEST_CASE("/CommitProxyInterface/TxnStateRequest/EncodeData") {
+	Standalone<VectorRef<KeyValueRef>> data;
+	for (int i = 0; i < 100; i++) {
+		std::string key = i ? format("\xff/keyServers/%d/%04d", deterministicRandom()->randomInt(0, 3), i) : "";
+		std::string value = format("value%d", i);
+		data.push_back_deep(data.arena(), KeyValueRef(StringRef(key), StringRef(value)));
+	}
+	std::sort(data.begin(), data.end(), KeyValueRef::OrderByKey());
+
+	Standalone<StringRef> encoded = TxnStateRequest::encodeData(data);
+	ASSERT_LT(encoded.size(), data.expectedSize());
+	Arena arena;
+	VectorRef<KeyValueRef> decoded = TxnStateRequest::decodeData(encoded, arena);
+	ASSERT(decoded == data);
+
+	TxnStateRequest req;
+	req.data = data;
+	ASSERT(req.getData(arena) == data);
+	if (CompressionUtils::supportedFilters.count(CompressionFilter::ZSTD)) {
+		req.compressedData = CompressionUtils::compress(CompressionFilter::ZSTD, encoded, req.arena);
+		req.compressionFilter = CompressionFilter::ZSTD;
+		req.data = VectorRef<KeyValueRef>();
+		ASSERT(req.getData(arena) == data);
+	}
+	return Void();
+}
+
+TEST_CASE("/CommitProxyInterface/CommitTransactionRef/compact") {
+	Arena arena;
+	CommitTransactionRef tr;
+	tr.set(arena, "a"_sr, "1"_sr);
+	tr.mutations.push_back_deep(arena, MutationRef(MutationRef::AddValue, "a"_sr, "\x01"_sr));
+	tr.set(arena, "b"_sr, "1"_sr);
+	tr.clear(arena, KeyRangeRef("a"_sr, "c"_sr));
+	tr.set(arena, "b"_sr, "2"_sr);
+	tr.mutations.push_back_deep(arena, MutationRef(MutationRef::AddValue, "b"_sr, "\x01"_sr));
+	tr.clear(arena, KeyRangeRef("c"_sr, "d"_sr));
+	tr.clear(arena, KeyRangeRef("x"_sr, "y"_sr));
+	tr.clear(arena, KeyRangeRef("x"_sr, "xa"_sr));
+	tr.set(arena, "\xff/x"_sr, "1"_sr);
+	tr.set(arena, "\xff/x"_sr, "2"_sr);
+	tr.read_conflict_ranges.push_back_deep(arena, KeyRangeRef("m"_sr, "n"_sr));
+	tr.read_conflict_ranges.push_back_deep(arena, KeyRangeRef("k"_sr, "m"_sr));
+	tr.read_conflict_ranges.push_back_deep(arena, KeyRangeRef("p"_sr, "p"_sr));
+	tr.read_conflict_ranges.push_back_deep(arena, KeyRangeRef("\xff/a"_sr, "\xff/c"_sr));
+	tr.read_conflict_ranges.push_back_deep(arena, KeyRangeRef("\xff/b"_sr, "\xff/d"_sr));
+	tr.compact(arena);
+
+	// Everything before the clear of [a, c) is overwritten by it or by the set of "b" after it. The clear of [x, y) is
+	// kept, since only part of it is cleared again, and so are the writes to system keys.
+	ASSERT_EQ(tr.mutations.size(), 8);
+	ASSERT(tr.mutations[0].type == MutationRef::ClearRange && tr.mutations[0].param1 == "a"_sr);
+	ASSERT(tr.mutations[1].type == MutationRef::SetValue && tr.mutations[1].param2 == "2"_sr);
+	ASSERT(tr.mutations[2].type == MutationRef::AddValue && tr.mutations[2].param1 == "b"_sr);
+	ASSERT(tr.mutations[3].param1 == "c"_sr && tr.mutations[3].param2 == "d"_sr);
+	ASSERT(tr.mutations[4].param1 == "x"_sr && tr.mutations[4].param2 == "y"_sr);
+	ASSERT(tr.mutations[5].param1 == "x"_sr && tr.mutations[5].param2 == "xa"_sr);
+	ASSERT(tr.mutations[6].param2 == "1"_sr && tr.mutations[7].param2 == "2"_sr);
+
+	ASSERT_EQ(tr.write_conflict_ranges.size(), 3);
+	ASSERT(tr.write_conflict_ranges[0] == KeyRangeRef("a"_sr, "d"_sr));
+	ASSERT(tr.write_conflict_ranges[1] == KeyRangeRef("x"_sr, "y"_sr));
+	ASSERT(tr.write_conflict_ranges[2] == singleKeyRange("\xff/x"_sr));
+
+	ASSERT_EQ(tr.read_conflict_ranges.size(), 3);
+	ASSERT(tr.read_conflict_ranges[0] == KeyRangeRef("k"_sr, "n"_sr));
+	ASSERT(tr.read_conflict_ranges[1] == KeyRangeRef("\xff/a"_sr, "\xff/c"_sr));
+	ASSERT(tr.read_conflict_ranges[2] == KeyRangeRef("\xff/b"_sr, "\xff/d"_sr));
+
+	return Void();
+}
@@ -26,6 +26,7 @@
 #include "fdbclient/BlobRestoreCommon.h"
 #include "fdbrpc/TenantInfo.h"
 #include "fdbrpc/simulator.h"
+#include "flow/CompressionUtils.h"
 #include "flow/EncryptUtils.h"
 #include "flow/FastRef.h"
 #include "flow/flow.h"
@@ -56,6 +57,8 @@
 #include "flow/IAsyncFile.h"
 #include "flow/genericactors.actor.h"
 #include "flow/Hash3.h"
+#include "flow/UnitTest.h"
+#include "flow/WorkerPool.h"
 #include "flow/xxhash.h"
 
 #include <memory>
@@ -1049,6 +1052,271 @@ private:
 	Key lastValue;
 };
 
+// Compressed range file blocks, written by CompressedRangeFileWriter, are laid out as
+//
+//   [version 1003][filter][kv count][begin key][end key][raw length][payload length][payload][padding]
+//
+// where the filter is one byte, counts and lengths are big endian uint32s and the keys are length prefixed as in the
+// other formats. The payload is the block's keys followed by its values, compressed together with the filter. Each key
+// is stored as the length of the prefix it shares with the key before it (the begin key, for the first) and the rest
+// of it, so the keys column compresses well even without a filter. The block's range is in its header, so a reader
+// knows what a block covers without decompressing it.
+//
+// Unlike the other formats, a block only holds the kv pairs in its own range, so nothing is repeated across blocks.
+
+static void appendNetworkUInt32(std::string& out, uint32_t v) {
+	v = bigEndian32(v);
+	out.append((const char*)&v, sizeof(v));
+}
+
+static void appendStringWithLen(std::string& out, StringRef s) {
+	appendNetworkUInt32(out, s.size());
+	out.append((const char*)s.begin(), s.size());
+}
+
+// Returns the uncompressed payload for kvs, the contents of a block beginning at begin
+static std::string encodeCompressedRangeFileBlockPayload(KeyRef begin, VectorRef<KeyValueRef> kvs) {
+	std::string raw;
+	KeyRef prevKey = begin;
+	for (auto const& kv : kvs) {
+		int shared = commonPrefixLength(prevKey, kv.key);
+		appendNetworkUInt32(raw, shared);
+		appendStringWithLen(raw, kv.key.substr(shared));
+		prevKey = kv.key;
+	}
+	for (auto const& kv : kvs) {
+		appendStringWithLen(raw, kv.value);
+	}
+	return raw;
+}
+
+// Returns the block for raw, the payload of count kv pairs in [begin, end), storing it as compressed with filter if
+// compressed is present and raw as is otherwise
+static std::string encodeCompressedRangeFileBlock(CompressionFilter filter,
+                                                  KeyRef begin,
+                                                  KeyRef end,
+                                                  int count,
+                                                  std::string const& raw,
+                                                  Optional<std::string> const& compressed) {
+	std::string const& payload = compressed.present() ? compressed.get() : raw;
+	std::string block;
+	uint32_t fileVersion = BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION;
+	block.append((const char*)&fileVersion, sizeof(fileVersion));
+	block.push_back((char)(compressed.present() ? filter : CompressionFilter::NONE));
+	appendNetworkUInt32(block, count);
+	appendStringWithLen(block, begin);
+	appendStringWithLen(block, end);
+	appendNetworkUInt32(block, raw.size());
+	appendNetworkUInt32(block, payload.size());
+	block.append(payload);
+	return block;
+}
+
+Future<Optional<std::string>> compressBackupBlockPayload(CompressionFilter filter, std::string raw) {
+	return onWorkerPool([filter, raw = std::move(raw)]() -> Optional<std::string> {
+		Arena arena;
+		StringRef compressed = CompressionUtils::compress(filter, StringRef(raw), arena);
+		if (compressed.size() >= raw.size()) {
+			return Optional<std::string>();
+		}
+		return compressed.toString();
+	});
+}
+
+CompressionFilter backupCompressionFilter() {
+	return CompressionUtils::supportedFilters.count(CompressionFilter::ZSTD) ? CompressionFilter::ZSTD
+	                                                                         : CompressionFilter::NONE;
+}
+
+// Compressed partitioned mutation log blocks, written by backup workers, are laid out as
+//
+//   [version 4111][filter][raw length][payload length][payload][padding]
+//
+// where the payload is, once decompressed with the filter, the sequence of messages that follows the version in an
+// uncompressed block.
+
+std::string encodeCompressedPartitionedLogBlock(CompressionFilter filter,
+                                                std::string const& raw,
+                                                Optional<std::string> const& compressed) {
+	std::string const& payload = compressed.present() ? compressed.get() : raw;
+	std::string block;
+	uint32_t fileVersion = PARTITIONED_MLOG_COMPRESSED_VERSION;
+	block.append((const char*)&fileVersion, sizeof(fileVersion));
+	block.push_back((char)(compressed.present() ? filter : CompressionFilter::NONE));
+	appendNetworkUInt32(block, raw.size());
+	appendNetworkUInt32(block, payload.size());
+	block.append(payload);
+	return block;
+}
+
+Standalone<StringRef> decodePartitionedLogBlock(const Standalone<StringRef>& buf) {
+	StringRefReader reader(buf, restore_corrupted_data());
+	int32_t fileVersion = reader.consume<int32_t>();
+	if (fileVersion == PARTITIONED_MLOG_VERSION) {
+		return Standalone<StringRef>(StringRef(reader.rptr, reader.end - reader.rptr), buf.arena());
+	}
+	if (fileVersion != PARTITIONED_MLOG_COMPRESSED_VERSION) {
+		throw restore_unsupported_file_version();
+	}
+
+	uint8_t filter = reader.consume<uint8_t>();
+	if (filter >= (uint8_t)CompressionFilter::LAST) {
+		throw restore_corrupted_data();
+	}
+	uint32_t rawLength = reader.consumeNetworkUInt32();
+	uint32_t len = reader.consumeNetworkUInt32();
+	StringRef payload(reader.consume(len), len);
+	for (auto b : reader.remainder())
+		if (b != 0xFF)
+			throw restore_corrupted_data_padding();
+
+	Standalone<StringRef> raw(payload, buf.arena());
+	if ((CompressionFilter)filter != CompressionFilter::NONE) {
+		CODE_PROBE(true, "decoding compressed partitioned log block");
+		raw = Standalone<StringRef>();
+		raw.contents() = CompressionUtils::decompress((CompressionFilter)filter, payload, raw.arena());
+	}
+	if (raw.size() != rawLength) {
+		throw restore_corrupted_data();
+	}
+	return raw;
+}
+
+// Writes pending kv pairs into as few blocks as possible. Since how well a block compresses is not known until it is
+// compressed, kv pairs are buffered until they reach a target size estimated from the previous block's compression
+// ratio, and a block that comes out too big is cut short, with the rest of its kv pairs starting the next block.
+//
+// CompressedRangeFileWriter must be used in the same order as RangeFileWriter.
+struct CompressedRangeFileWriter : public IRangeFileWriter {
+	CompressedRangeFileWriter(Reference<IBackupFile> file, int blockSize, CompressionFilter filter)
+	  : file(file), blockSize(blockSize), filter(filter), targetBytes(blockSize) {}
+
+	// Raw payloads are allowed this much bigger than a block, however well the last one compressed
+	static constexpr double MAX_RATIO = 10;
+	// And the estimate leaves this fraction of a block spare, for blocks that compress worse than the last
+	static constexpr double TARGET_FILL = 0.9;
+
+	ACTOR static Future<Void> padTo(Reference<IBackupFile> file, int64_t end) {
+		state int bytes = end - file->size();
+		if (bytes > 0) {
+			state Value paddingFFs = makePadding(bytes);
+			wait(file->append(paddingFFs.begin(), bytes));
+		}
+		return Void();
+	}
+
+	// Writes the first count pending kv pairs as a block ending at end, or returns false if they don't fit in one
+	ACTOR static Future<bool> writeBlock(CompressedRangeFileWriter* self, int count, Key end) {
+		state std::string raw =
+		    encodeCompressedRangeFileBlockPayload(self->blockBegin, self->pending.slice(0, count));
+		state Optional<std::string> compressed;
+		if (self->filter != CompressionFilter::NONE) {
+			wait(store(compressed, compressBackupBlockPayload(self->filter, raw)));
+		}
+		state std::string block =
+		    encodeCompressedRangeFileBlock(self->filter, self->blockBegin, end, count, raw, compressed);
+
+		double ratio = raw.empty() ? 1.0 : (double)raw.size() / block.size();
+		self->targetBytes = self->blockSize * std::clamp(ratio * TARGET_FILL, TARGET_FILL, MAX_RATIO);
+		self->lastBlockBytes = block.size();
+		if (block.size() > self->blockSize) {
+			return false;
+		}
+
+		wait(padTo(self->file, self->blockEnd));
+		wait(self->file->append(block.data(), block.size()));
+		self->blockEnd += self->blockSize;
+
+		Standalone<VectorRef<KeyValueRef>> rest;
+		self->pendingBytes = 0;
+		for (int i = count; i < self->pending.size(); i++) {
+			rest.push_back_deep(rest.arena(), self->pending[i]);
+			self->pendingBytes += self->pending[i].key.size() + self->pending[i].value.size();
+		}
+		self->pending = rest;
+		self->blockBegin = end;
+		return true;
+	}
+
+	// Writes out the pending kv pairs in blocks, all of them with a final block ending at end if final is set, or
+	// otherwise until what is left would not fill a block
+	ACTOR static Future<Void> flush(CompressedRangeFileWriter* self, Key end, bool final) {
+		loop {
+			bool wroteAll = wait(writeBlock(self, self->pending.size(), end));
+			if (wroteAll) {
+				return Void();
+			}
+			if (self->pending.size() < 2) {
+				throw backup_bad_block_size();
+			}
+
+			// Write as many as should fit, going by how far over the last try was
+			state int count = std::clamp<int>(self->pending.size() * TARGET_FILL * self->blockSize /
+			                                      std::max(self->lastBlockBytes, 1),
+			                                  1,
+			                                  self->pending.size() - 1);
+			loop {
+				bool wrote = wait(writeBlock(self, count, self->pending[count].key));
+				if (wrote) {
+					break;
+				}
+				if (count == 1) {
+					throw backup_bad_block_size();
+				}
+				count /= 2;
+			}
+			if (!final && self->pendingBytes < self->targetBytes) {
+				return Void();
+			}
+		}
+	}
+
+	// Used in simulation only to create backup file sizes which are an integer multiple of the block size
+	Future<Void> padEnd(bool final) {
+		ASSERT(g_network->isSimulated());
+		if (file->size() > 0) {
+			return padTo(file, blockEnd);
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> writeKV_impl(CompressedRangeFileWriter* self, Key k, Value v) {
+		if (!self->pending.empty() && self->pendingBytes + k.size() + v.size() > self->targetBytes) {
+			wait(flush(self, k, false));
+		}
+		self->pending.push_back_deep(self->pending.arena(), KeyValueRef(k, v));
+		self->pendingBytes += k.size() + v.size();
+		return Void();
+	}
+
+	Future<Void> writeKV(Key k, Value v) { return writeKV_impl(this, k, v); }
+
+	// The first key is the file's begin key and the second its end key, which ends its last block
+	Future<Void> writeKey(Key k) {
+		if (!started) {
+			started = true;
+			blockBegin = k;
+			return Void();
+		}
+		return flush(this, k, true);
+	}
+
+	Future<Void> finish() { return Void(); }
+
+	Reference<IBackupFile> file;
+	int blockSize;
+
+private:
+	CompressionFilter filter;
+	int64_t blockEnd = 0;
+	bool started = false;
+	Key blockBegin;
+	Standalone<VectorRef<KeyValueRef>> pending;
+	int64_t pendingBytes = 0;
+	int64_t targetBytes;
+	int lastBlockBytes = 0;
+};
+
 ACTOR static Future<Void> decodeKVPairs(StringRefReader* reader,
                                         Standalone<VectorRef<KeyValueRef>>* results,
                                         bool encryptedBlock,
@@ -1136,6 +1404,119 @@ ACTOR static Future<Void> decodeKVPairs(StringRefReader* reader,
 	return Void();
 }
 
+struct CompressedRangeFileBlockHeader {
+	CompressionFilter filter;
+	uint32_t count;
+	KeyRef begin;
+	KeyRef end;
+	uint32_t rawLength;
+	StringRef payload;
+};
+
+// Reads the rest of a compressed block after its version, checking that it is padded correctly
+static CompressedRangeFileBlockHeader readCompressedRangeFileBlockHeader(StringRefReader* reader) {
+	CompressedRangeFileBlockHeader header;
+	uint8_t filter = reader->consume<uint8_t>();
+	if (filter >= (uint8_t)CompressionFilter::LAST) {
+		throw restore_corrupted_data();
+	}
+	header.filter = (CompressionFilter)filter;
+	header.count = reader->consumeNetworkUInt32();
+	uint32_t len = reader->consumeNetworkUInt32();
+	header.begin = KeyRef(reader->consume(len), len);
+	len = reader->consumeNetworkUInt32();
+	header.end = KeyRef(reader->consume(len), len);
+	header.rawLength = reader->consumeNetworkUInt32();
+	len = reader->consumeNetworkUInt32();
+	header.payload = StringRef(reader->consume(len), len);
+
+	for (auto b : reader->remainder())
+		if (b != 0xFF)
+			throw restore_corrupted_data_padding();
+	return header;
+}
+
+// Appends the block's begin key, kv pairs and end key to results, given its uncompressed payload in results' arena
+static void decodeCompressedRangeFileBlockPayload(CompressedRangeFileBlockHeader const& header,
+                                                  StringRef raw,
+                                                  Standalone<VectorRef<KeyValueRef>>* results) {
+	if (raw.size() != header.rawLength) {
+		throw restore_corrupted_data();
+	}
+	StringRefReader reader(raw, restore_corrupted_data());
+	std::vector<KeyRef> keys;
+	keys.reserve(header.count);
+	KeyRef prevKey = header.begin;
+	for (int i = 0; i < header.count; i++) {
+		uint32_t shared = reader.consumeNetworkUInt32();
+		uint32_t suffixLen = reader.consumeNetworkUInt32();
+		const uint8_t* suffix = reader.consume(suffixLen);
+		if (shared > prevKey.size()) {
+			throw restore_corrupted_data();
+		}
+		uint8_t* key = new (results->arena()) uint8_t[shared + suffixLen];
+		memcpy(key, prevKey.begin(), shared);
+		memcpy(key + shared, suffix, suffixLen);
+		keys.push_back(KeyRef(key, shared + suffixLen));
+		prevKey = keys.back();
+	}
+
+	results->push_back(results->arena(), KeyValueRef(header.begin, ValueRef()));
+	for (auto const& key : keys) {
+		uint32_t vLen = reader.consumeNetworkUInt32();
+		results->push_back(results->arena(), KeyValueRef(key, ValueRef(reader.consume(vLen), vLen)));
+	}
+	results->push_back(results->arena(), KeyValueRef(header.end, ValueRef()));
+	if (!reader.eof()) {
+		throw restore_corrupted_data();
+	}
+}
+
+// Decompresses data with filter on the worker pool
+static Future<std::string> decompressBackupBlockPayload(CompressionFilter filter, std::string data) {
+	return onWorkerPool([filter, data = std::move(data)]() {
+		Arena arena;
+		return CompressionUtils::decompress(filter, StringRef(data), arena).toString();
+	});
+}
+
+// Decodes a compressed block after its version, decompressing it off the network thread, and leaves out the kv pairs
+// of tenants that no longer exist if tenantCache is present
+ACTOR static Future<Void> decodeCompressedKVPairs(StringRefReader* reader,
+                                                  Standalone<VectorRef<KeyValueRef>>* results,
+                                                  Optional<Reference<TenantEntryCache<Void>>> tenantCache) {
+	state CompressedRangeFileBlockHeader header = readCompressedRangeFileBlockHeader(reader);
+	state StringRef raw = header.payload;
+	if (header.filter != CompressionFilter::NONE) {
+		CODE_PROBE(true, "decoding compressed range file block");
+		std::string decompressed = wait(decompressBackupBlockPayload(header.filter, header.payload.toString()));
+		raw = StringRef(results->arena(), decompressed);
+	}
+	if (!tenantCache.present()) {
+		decodeCompressedRangeFileBlockPayload(header, raw, results);
+		return Void();
+	}
+
+	state Standalone<VectorRef<KeyValueRef>> decoded({}, results->arena());
+	decodeCompressedRangeFileBlockPayload(header, raw, &decoded);
+	results->push_back(results->arena(), decoded.front());
+	state int i = 1;
+	for (; i < decoded.size() - 1; i++) {
+		if (!isSystemKey(decoded[i].key)) {
+			state int64_t tenantId = TenantAPI::extractTenantIdFromKeyRef(decoded[i].key);
+			Optional<TenantEntryCachePayload<Void>> payload = wait(tenantCache.get()->getById(tenantId));
+			if (!payload.present()) {
+				TraceEvent(SevWarnAlways, "SnapshotRestoreTenantNotFound").detail("TenantId", tenantId);
+				CODE_PROBE(true, "Compressed snapshot restore tenant not found");
+				continue;
+			}
+		}
+		results->push_back(results->arena(), decoded[i]);
+	}
+	results->push_back(results->arena(), decoded.back());
+	return Void();
+}
+
 static Reference<IBackupContainer> getBackupContainerWithProxy(Reference<IBackupContainer> _bc) {
 	Reference<IBackupContainer> bc = IBackupContainer::openContainer(_bc->getURL(), fileBackupAgentProxy, {});
 	return bc;
@@ -1145,8 +1526,19 @@ Standalone<VectorRef<KeyValueRef>> decodeRangeFileBlock(const Standalone<StringR
 	Standalone<VectorRef<KeyValueRef>> results({}, buf.arena());
 	StringRefReader reader(buf, restore_corrupted_data());
 
-	// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION
-	if (reader.consume<int32_t>() != BACKUP_AGENT_SNAPSHOT_FILE_VERSION)
+	// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION or
+	// BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION
+	int32_t fileVersion = reader.consume<int32_t>();
+	if (fileVersion == BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION) {
+		CompressedRangeFileBlockHeader header = readCompressedRangeFileBlockHeader(&reader);
+		StringRef raw = header.payload;
+		if (header.filter != CompressionFilter::NONE) {
+			raw = CompressionUtils::decompress(header.filter, header.payload, results.arena());
+		}
+		decodeCompressedRangeFileBlockPayload(header, raw, &results);
+		return results;
+	}
+	if (fileVersion != BACKUP_AGENT_SNAPSHOT_FILE_VERSION)
 		throw restore_unsupported_file_version();
 
 	// Read begin key, if this fails then block was invalid.
@@ -1199,8 +1591,8 @@ ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<
 	state int64_t blockDomainId = TenantInfo::INVALID_TENANT;
 
 	try {
-		// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION or
-		// BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION
+		// Read header, currently only decoding BACKUP_AGENT_SNAPSHOT_FILE_VERSION,
+		// BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION or BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION
 		int32_t file_version = reader.consume<int32_t>();
 		ASSERT(!encryptMode.isEncryptionEnabled() || file_version == BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION);
 		if (file_version == BACKUP_AGENT_SNAPSHOT_FILE_VERSION) {
@@ -1233,6 +1625,8 @@ ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<
 			    wait(EncryptedRangeFileWriter::decrypt(cx, encryptHeader, dataPayloadStart, dataLen, &results.arena()));
 			reader = StringRefReader(decryptedData, restore_corrupted_data());
 			wait(decodeKVPairs(&reader, &results, true, encryptMode, blockDomainId, tenantCache));
+		} else if (file_version == BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION) {
+			wait(decodeCompressedKVPairs(&reader, &results, tenantCache));
 		} else {
 			throw restore_unsupported_file_version();
 		}
@@ -1333,15 +1727,99 @@ Standalone<VectorRef<KeyValueRef>> decodeMutationLogFileBlock(const Standalone<S
 	return results;
 }
 
+// Appends the mutation log value of one message's mutations to value, as a commit proxy would write them
+static void appendMutationLogValue(std::string& value, VectorRef<MutationRef> mutations) {
+	uint64_t protocolVersion = ProtocolVersion::withBackupMutations().version();
+	uint32_t totalBytes = 0;
+	for (auto& m : mutations) {
+		totalBytes += BackupAgentBase::logHeaderSize + m.param1.size() + m.param2.size();
+	}
+	value.append((const char*)&protocolVersion, sizeof(protocolVersion));
+	value.append((const char*)&totalBytes, sizeof(totalBytes));
+	for (auto& m : mutations) {
+		uint32_t header[3] = { m.type, (uint32_t)m.param1.size(), (uint32_t)m.param2.size() };
+		value.append((const char*)header, sizeof(header));
+		value.append((const char*)m.param1.begin(), m.param1.size());
+		value.append((const char*)m.param2.begin(), m.param2.size());
+	}
+}
+
+Standalone<VectorRef<KeyValueRef>> decodePartitionedLogFileBlock(const Standalone<StringRef>& buf,
+                                                                 Version beginVersion,
+                                                                 Version endVersion) {
+	Standalone<StringRef> messages = decodePartitionedLogBlock(buf);
+	Standalone<VectorRef<KeyValueRef>> results({}, messages.arena());
+	StringRefReader reader(messages, restore_corrupted_data());
+
+	// A clear can be split into several messages with the same version and subsequence, which become one value
+	LogMessageVersion pending;
+	Standalone<VectorRef<MutationRef>> pendingMutations;
+	auto flush = [&]() {
+		if (pendingMutations.empty()) {
+			return;
+		}
+		std::string value;
+		appendMutationLogValue(value, pendingMutations);
+		// Keep the hash the same as decodeMutationLogKey() expects
+		int32_t vblock = pending.version / CLIENT_KNOBS->LOG_RANGE_BLOCK_SIZE;
+		uint8_t hash = (uint8_t)hashlittle(&vblock, sizeof(vblock), 0);
+		ASSERT(pending.sub < (1 << 24));
+		int blockSize = CLIENT_KNOBS->MUTATION_BLOCK_SIZE;
+		for (uint32_t chunk = 0; chunk * blockSize < value.size(); chunk++) {
+			ASSERT(chunk < (1 << 8));
+			BinaryWriter wr(Unversioned());
+			wr << hash << bigEndian64(pending.version) << bigEndian32((pending.sub << 8) | chunk);
+			int offset = chunk * blockSize;
+			StringRef part = StringRef(value).substr(offset, std::min<int>(blockSize, value.size() - offset));
+			results.push_back_deep(results.arena(), KeyValueRef(wr.toValue(), part));
+		}
+		pendingMutations = Standalone<VectorRef<MutationRef>>();
+	};
+
+	// Messages are laid out as written by saveMutationsToFile() in the backup worker
+	while (!reader.eof() && *reader.rptr != 0xFF) {
+		LogMessageVersion msgVersion;
+		msgVersion.version = reader.consumeNetworkUInt64();
+		msgVersion.sub = reader.consumeNetworkUInt32();
+		int msgSize = reader.consumeNetworkInt32();
+		const uint8_t* message = reader.consume(msgSize);
+
+		// Files of different tags and epochs can overlap, and each only covers its own version range
+		if (msgVersion.version < beginVersion || msgVersion.version >= endVersion) {
+			continue;
+		}
+		if (!(msgVersion == pending)) {
+			flush();
+			pending = msgVersion;
+		}
+		ArenaReader rd(messages.arena(), StringRef(message, msgSize), AssumeVersion(g_network->protocolVersion()));
+		MutationRef m;
+		rd >> m;
+		pendingMutations.push_back_deep(pendingMutations.arena(), m);
+	}
+	flush();
+	return results;
+}
+
 ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeMutationLogFileBlock(Reference<IAsyncFile> file,
                                                                             int64_t offset,
-                                                                            int len) {
+                                                                            int len,
+                                                                            Version beginVersion,
+                                                                            Version endVersion) {
 	state Standalone<StringRef> buf = makeString(len);
 	int rLen = wait(file->read(mutateString(buf), len, offset));
 	if (rLen != len)
 		throw restore_bad_read();
 
 	try {
+		int32_t fileVersion = 0;
+		if (buf.size() >= sizeof(fileVersion)) {
+			memcpy(&fileVersion, buf.begin(), sizeof(fileVersion));
+		}
+		if (fileVersion == PARTITIONED_MLOG_VERSION || fileVersion == PARTITIONED_MLOG_COMPRESSED_VERSION) {
+			CODE_PROBE(true, "restoring a partitioned mutation log block");
+			return decodePartitionedLogFileBlock(buf, beginVersion, endVersion);
+		}
 		return decodeMutationLogFileBlock(buf);
 	} catch (Error& e) {
 		TraceEvent(SevWarn, "FileRestoreCorruptLogFileBlock")
@@ -1931,6 +2409,10 @@ struct BackupRangeTaskFunc : BackupTaskFuncBase {
 					CODE_PROBE(true, "using encrypted snapshot file writer", probe::decoration::rare);
 					rangeFile = std::make_unique<EncryptedRangeFileWriter>(
 					    cx, &arena, encryptMode, tenantCache, outFile, blockSize);
+				} else if (CLIENT_KNOBS->BACKUP_COMPRESS_RANGE_FILES) {
+					CODE_PROBE(true, "using compressed snapshot file writer");
+					rangeFile =
+					    std::make_unique<CompressedRangeFileWriter>(outFile, blockSize, backupCompressionFilter());
 				} else {
 					rangeFile = std::make_unique<RangeFileWriter>(outFile, blockSize);
 				}
@@ -4179,7 +4661,7 @@ struct RestoreLogDataTaskFunc : RestoreFileTaskFuncBase {
 		state Key mutationLogPrefix = restore.mutationLogPrefix();
 		state Reference<IAsyncFile> inFile = wait(bc->readFile(logFile.fileName));
 		state Standalone<VectorRef<KeyValueRef>> dataOriginal =
-		    wait(decodeMutationLogFileBlock(inFile, readOffset, readLen));
+		    wait(decodeMutationLogFileBlock(inFile, readOffset, readLen, logFile.version, logFile.endVersion));
 
 		// Filter the KV pairs extracted from the log file block to remove any records known to not be needed for
 		// this restore based on the restore range set.
@@ -7040,3 +7522,115 @@ void simulateBlobFailure() {
 		}
 	}
 }
+
+TEST_CASE("/backup/CompressedRangeFileBlock") {
+	std::vector<CompressionFilter> filters = { CompressionFilter::NONE };
+	if (fileBackup::backupCompressionFilter() != CompressionFilter::NONE) {
+		filters.push_back(fileBackup::backupCompressionFilter());
+	}
+	for (auto filter : filters) {
+		Standalone<VectorRef<KeyValueRef>> kvs;
+		int count = deterministicRandom()->randomInt(0, 200);
+		for (int i = 0; i < count; i++) {
+			Key key(format("key/%08d", i * 7));
+			Value value(deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 100)));
+			kvs.push_back_deep(kvs.arena(), KeyValueRef(key, value));
+		}
+		KeyRef begin = "key/"_sr;
+		KeyRef end = "key0"_sr;
+
+		std::string raw = fileBackup::encodeCompressedRangeFileBlockPayload(begin, kvs);
+		Optional<std::string> compressed;
+		if (filter != CompressionFilter::NONE) {
+			Arena arena;
+			compressed = CompressionUtils::compress(filter, StringRef(raw), arena).toString();
+		}
+		std::string block = fileBackup::encodeCompressedRangeFileBlock(filter, begin, end, count, raw, compressed);
+		block.append(deterministicRandom()->randomInt(0, 100), '\xff');
+
+		Standalone<VectorRef<KeyValueRef>> decoded = fileBackup::decodeRangeFileBlock(Standalone<StringRef>(block));
+		ASSERT_EQ(decoded.size(), count + 2);
+		ASSERT(decoded.front().key == begin && decoded.back().key == end);
+		for (int i = 0; i < count; i++) {
+			ASSERT(decoded[i + 1].key == kvs[i].key);
+			ASSERT(decoded[i + 1].value == kvs[i].value);
+		}
+	}
+	return Void();
+}
+
+TEST_CASE("/backup/CompressedPartitionedLogBlock") {
+	std::string raw;
+	for (int i = 0; i < 100; i++) {
+		int messageSize = deterministicRandom()->randomInt(0, 50);
+		raw += std::string(12, '\0') + deterministicRandom()->randomAlphaNumeric(messageSize);
+	}
+	CompressionFilter filter = fileBackup::backupCompressionFilter();
+	Optional<std::string> compressed;
+	if (filter != CompressionFilter::NONE && deterministicRandom()->coinflip()) {
+		Arena arena;
+		compressed = CompressionUtils::compress(filter, StringRef(raw), arena).toString();
+	}
+	std::string block = fileBackup::encodeCompressedPartitionedLogBlock(filter, raw, compressed);
+	block.append(deterministicRandom()->randomInt(0, 100), '\xff');
+	Standalone<StringRef> decoded = fileBackup::decodePartitionedLogBlock(Standalone<StringRef>(block));
+	ASSERT(decoded == StringRef(raw));
+
+	// Uncompressed blocks decode to what follows their version
+	std::string plain((const char*)&PARTITIONED_MLOG_VERSION, sizeof(PARTITIONED_MLOG_VERSION));
+	plain += raw;
+	ASSERT(fileBackup::decodePartitionedLogBlock(Standalone<StringRef>(plain)) == StringRef(raw));
+	return Void();
+}
+
+TEST_CASE("/backup/PartitionedLogFileBlockToMutationLog") {
+	// Messages as a backup worker writes them, with a clear split into two messages of the same subsequence
+	std::string largeValue(25000, 'x');
+	std::vector<std::pair<LogMessageVersion, MutationRef>> messages = {
+		{ LogMessageVersion(100, 1), MutationRef(MutationRef::SetValue, "a"_sr, "1"_sr) },
+		{ LogMessageVersion(100, 1), MutationRef(MutationRef::ClearRange, "b"_sr, "c"_sr) },
+		{ LogMessageVersion(100, 3), MutationRef(MutationRef::SetValue, "d"_sr, StringRef(largeValue)) },
+		{ LogMessageVersion(200, 0), MutationRef(MutationRef::SetValue, "e"_sr, "2"_sr) },
+	};
+	std::string raw;
+	for (auto& [msgVersion, m] : messages) {
+		BinaryWriter wr(AssumeVersion(g_network->protocolVersion()));
+		wr << m;
+		uint64_t version = bigEndian64(msgVersion.version);
+		uint32_t sub = bigEndian32(msgVersion.sub);
+		uint32_t size = bigEndian32(wr.getLength());
+		raw.append((const char*)&version, sizeof(version));
+		raw.append((const char*)&sub, sizeof(sub));
+		raw.append((const char*)&size, sizeof(size));
+		raw.append((const char*)wr.getData(), wr.getLength());
+	}
+	std::string block((const char*)&PARTITIONED_MLOG_VERSION, sizeof(PARTITIONED_MLOG_VERSION));
+	block += raw;
+	block.append(deterministicRandom()->randomInt(0, 100), '\xff');
+
+	// The message at version 200 is outside of the file's versions
+	Standalone<VectorRef<KeyValueRef>> kvs =
+	    fileBackup::decodePartitionedLogFileBlock(Standalone<StringRef>(block), 100, 200);
+	std::map<std::pair<Version, int32_t>, std::string> values;
+	for (auto& kv : kvs) {
+		values[fileBackup::decodeMutationLogKey(kv.key)] = kv.value.toString();
+	}
+	ASSERT_EQ(values.size(), 4);
+
+	std::vector<MutationRef> first = fileBackup::decodeMutationLogValue(values[std::make_pair(100, 1 << 8)]);
+	ASSERT_EQ(first.size(), 2);
+	auto same = [](MutationRef const& a, MutationRef const& b) {
+		return a.type == b.type && a.param1 == b.param1 && a.param2 == b.param2;
+	};
+	ASSERT(same(first[0], messages[0].second) && same(first[1], messages[1].second));
+
+	// The large message is cut into parts that follow each other
+	std::string second;
+	for (int chunk = 0; chunk < 3; chunk++) {
+		second += values[std::make_pair(100, (3 << 8) | chunk)];
+	}
+	std::vector<MutationRef> large = fileBackup::decodeMutationLogValue(StringRef(second));
+	ASSERT_EQ(large.size(), 1);
+	ASSERT(same(large[0], messages[2].second));
+	return Void();
+}
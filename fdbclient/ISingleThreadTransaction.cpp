@@ -71,3 +71,30 @@ Reference<ISingleThreadTransaction> ISingleThreadTransaction::create(Type type,
 	result->construct(cx, tenant);
 	return result;
 }
+
+Future<RangeResult> ISingleThreadTransaction::getMulti(Standalone<VectorRef<KeyRef>> const& keys, Snapshot snapshot) {
+	std::vector<Future<Optional<Value>>> values;
+	values.reserve(keys.size());
+	for (const auto& key : keys) {
+		values.push_back(get(Key(key, keys.arena()), snapshot));
+	}
+	return getMultiFromValues(keys, values);
+}
+
+Future<Void> ISingleThreadTransaction::getRangeStream(PromiseStream<RangeResult>& results,
+                                                      KeySelector const& begin,
+                                                      KeySelector const& end,
+                                                      Snapshot snapshot) {
+	Reference<ISingleThreadTransaction> self = Reference<ISingleThreadTransaction>::addRef(this);
+	return getRangeStreamFromPages(
+	    results,
+	    [self, snapshot](KeySelector const& begin, KeySelector const& end) {
+		    return self->getRange(
+		        begin,
+		        end,
+		        GetRangeLimits(GetRangeLimits::ROW_LIMIT_UNLIMITED, CLIENT_KNOBS->RANGESTREAM_FRAGMENT_SIZE),
+		        snapshot);
+	    },
+	    begin,
+	    end);
+}
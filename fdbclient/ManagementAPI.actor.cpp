@@ -2276,6 +2276,58 @@ ACTOR Future<bool> setHealthyZone(Database cx, StringRef zoneId, double seconds,
 	}
 }
 
+ACTOR Future<std::pair<UID, Version>> pinReadVersion(Database cx, double lifetimeSeconds) {
+	state Transaction tr(cx);
+	state UID pinId = deterministicRandom()->randomUniqueID();
+	state Version readVersion;
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+			wait(store(readVersion, tr.getReadVersion()));
+			RangeResult pins = wait(tr.getRange(pinnedReadVersionKeys, CLIENT_KNOBS->TOO_MANY));
+			// Pins whose owners went away without unpinning are cleared by the next one taken
+			for (auto const& pin : pins) {
+				if (decodePinnedReadVersionValue(pin.value).second <= readVersion) {
+					tr.clear(pin.key);
+				}
+			}
+			tr.set(pinnedReadVersionKeyFor(pinId),
+			       pinnedReadVersionValue(readVersion,
+			                              readVersion + lifetimeSeconds * CLIENT_KNOBS->CORE_VERSIONSPERSECOND));
+			tr.set(pinnedReadVersionsChangeKey, BinaryWriter::toValue(pinId, Unversioned()));
+			wait(tr.commit());
+			TraceEvent("PinnedReadVersion")
+			    .detail("PinID", pinId)
+			    .detail("Version", readVersion)
+			    .detail("LifetimeSeconds", lifetimeSeconds);
+			return std::make_pair(pinId, readVersion);
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+}
+
+ACTOR Future<Void> unpinReadVersion(Database cx, UID pinId) {
+	state Transaction tr(cx);
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+			tr.clear(pinnedReadVersionKeyFor(pinId));
+			tr.set(pinnedReadVersionsChangeKey,
+			       BinaryWriter::toValue(deterministicRandom()->randomUniqueID(), Unversioned()));
+			wait(tr.commit());
+			TraceEvent("UnpinnedReadVersion").detail("PinID", pinId);
+			return Void();
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+}
+
 ACTOR Future<int> setDDMode(Database cx, int mode) {
 	state Transaction tr(cx);
 	state int oldMode = -1;
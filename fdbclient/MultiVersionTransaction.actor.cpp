@@ -102,6 +102,55 @@ ThreadFuture<Optional<Value>> DLTransaction::get(const KeyRef& key, bool snapsho
 	});
 }
 
+ThreadFuture<RangeResult> DLTransaction::getMulti(const VectorRef<KeyRef>& keys, bool snapshot) {
+	if (!api->transactionGetMulti) {
+		return unsupported_operation();
+	}
+	std::vector<const uint8_t*> keyNames;
+	std::vector<int> keyNameLengths;
+	for (const auto& key : keys) {
+		keyNames.push_back(key.begin());
+		keyNameLengths.push_back(key.size());
+	}
+	FdbCApi::FDBFuture* f =
+	    api->transactionGetMulti(tr, keyNames.data(), keyNameLengths.data(), keys.size(), snapshot);
+
+	return toThreadFuture<RangeResult>(api, f, [](FdbCApi::FDBFuture* f, FdbCApi* api) {
+		const FdbCApi::FDBKeyValue* kvs;
+		int count;
+		FdbCApi::fdb_bool_t more;
+		FdbCApi::fdb_error_t error = api->futureGetKeyValueArray(f, &kvs, &count, &more);
+		ASSERT(!error);
+
+		// The memory for this is stored in the FDBFuture and is released when the future gets destroyed
+		return RangeResult(RangeResultRef(VectorRef<KeyValueRef>((KeyValueRef*)kvs, count), more), Arena());
+	});
+}
+
+ThreadFuture<RangeResult> DLTransaction::batch(const VectorRef<BatchOperationRef>& operations, bool snapshot) {
+	if (!api->transactionBatch) {
+		return unsupported_operation();
+	}
+	std::vector<FdbCApi::FDBBatchOperation> ops;
+	ops.reserve(operations.size());
+	for (const auto& op : operations) {
+		ops.push_back(
+		    { op.type, op.key.begin(), op.key.size(), op.param.begin(), op.param.size(), (int)op.operationType });
+	}
+	FdbCApi::FDBFuture* f = api->transactionBatch(tr, ops.data(), ops.size(), snapshot);
+
+	return toThreadFuture<RangeResult>(api, f, [](FdbCApi::FDBFuture* f, FdbCApi* api) {
+		const FdbCApi::FDBKeyValue* kvs;
+		int count;
+		FdbCApi::fdb_bool_t more;
+		FdbCApi::fdb_error_t error = api->futureGetKeyValueArray(f, &kvs, &count, &more);
+		ASSERT(!error);
+
+		// The memory for this is stored in the FDBFuture and is released when the future gets destroyed
+		return RangeResult(RangeResultRef(VectorRef<KeyValueRef>((KeyValueRef*)kvs, count), more), Arena());
+	});
+}
+
 ThreadFuture<Key> DLTransaction::getKey(const KeySelectorRef& key, bool snapshot) {
 	FdbCApi::FDBFuture* f =
 	    api->transactionGetKey(tr, key.getKey().begin(), key.getKey().size(), key.orEqual, key.offset, snapshot);
@@ -205,6 +254,50 @@ ThreadFuture<MappedRangeResult> DLTransaction::getMappedRange(const KeySelectorR
 	});
 }
 
+Reference<IRangeStream> DLTransaction::getRangeStream(const KeySelectorRef& begin,
+                                                      const KeySelectorRef& end,
+                                                      bool snapshot) {
+	if (!api->transactionGetRangeStream) {
+		return makeReference<DLRangeStream>(api, nullptr);
+	}
+	FdbCApi::FDBFuture* f = api->transactionGetRangeStream(tr,
+	                                                       begin.getKey().begin(),
+	                                                       begin.getKey().size(),
+	                                                       begin.orEqual,
+	                                                       begin.offset,
+	                                                       end.getKey().begin(),
+	                                                       end.getKey().size(),
+	                                                       end.orEqual,
+	                                                       end.offset,
+	                                                       snapshot);
+	return makeReference<DLRangeStream>(api, f);
+}
+
+ThreadFuture<RangeResult> DLRangeStream::next() {
+	if (!api->transactionGetRangeStream) {
+		return unsupported_operation();
+	}
+	if (!f) {
+		// The previous chunk is not ready yet, or was the last one
+		return client_invalid_operation();
+	}
+
+	Reference<DLRangeStream> self = Reference<DLRangeStream>::addRef(this);
+	return toThreadFuture<RangeResult>(api, std::exchange(f, nullptr), [self](FdbCApi::FDBFuture* f, FdbCApi* api) {
+		const FdbCApi::FDBKeyValue* kvs;
+		int count;
+		FdbCApi::fdb_bool_t more;
+		FdbCApi::fdb_error_t error = api->futureGetKeyValueArray(f, &kvs, &count, &more);
+		ASSERT(!error);
+		if (more) {
+			self->f = api->futureGetNextChunk(f);
+		}
+
+		// The memory for this is stored in the FDBFuture and is released when the future gets destroyed
+		return RangeResult(RangeResultRef(VectorRef<KeyValueRef>((KeyValueRef*)kvs, count), more), Arena());
+	});
+}
+
 ThreadFuture<Standalone<VectorRef<const char*>>> DLTransaction::getAddressesForKey(const KeyRef& key) {
 	FdbCApi::FDBFuture* f = api->transactionGetAddressesForKey(tr, key.begin(), key.size());
 
@@ -410,6 +503,16 @@ ThreadFuture<Void> DLTransaction::watch(const KeyRef& key) {
 	return toThreadFuture<Void>(api, f, [](FdbCApi::FDBFuture* f, FdbCApi* api) { return Void(); });
 }
 
+ThreadFuture<Void> DLTransaction::watchRange(const KeyRangeRef& range) {
+	if (!api->transactionWatchRange) {
+		return unsupported_operation();
+	}
+	FdbCApi::FDBFuture* f =
+	    api->transactionWatchRange(tr, range.begin.begin(), range.begin.size(), range.end.begin(), range.end.size());
+
+	return toThreadFuture<Void>(api, f, [](FdbCApi::FDBFuture* f, FdbCApi* api) { return Void(); });
+}
+
 void DLTransaction::addWriteConflictRange(const KeyRangeRef& keys) {
 	throwIfError(api->transactionAddConflictRange(
 	    tr, keys.begin.begin(), keys.begin.size(), keys.end.begin(), keys.end.size(), FDB_CONFLICT_RANGE_TYPE_WRITE));
@@ -914,6 +1017,38 @@ ThreadFuture<bool> DLDatabase::flushBlobRange(const KeyRangeRef& keyRange, bool
 	});
 }
 
+ThreadFuture<Standalone<StringRef>> DLDatabase::getMetrics() {
+	if (!api->databaseGetMetrics) {
+		return unsupported_operation();
+	}
+	FdbCApi::FDBFuture* f = api->databaseGetMetrics(db);
+	return toThreadFuture<Standalone<StringRef>>(api, f, [](FdbCApi::FDBFuture* f, FdbCApi* api) {
+		const uint8_t* str;
+		int strLength;
+		FdbCApi::fdb_error_t error = api->futureGetKey(f, &str, &strLength);
+		ASSERT(!error);
+
+		// The memory for this is stored in the FDBFuture and is released when the future gets destroyed
+		return Standalone<StringRef>(StringRef(str, strLength), Arena());
+	});
+}
+
+ThreadFuture<Standalone<StringRef>> DLDatabase::getTransactionProfiles() {
+	if (!api->databaseGetTransactionProfiles) {
+		return unsupported_operation();
+	}
+	FdbCApi::FDBFuture* f = api->databaseGetTransactionProfiles(db);
+	return toThreadFuture<Standalone<StringRef>>(api, f, [](FdbCApi::FDBFuture* f, FdbCApi* api) {
+		const uint8_t* str;
+		int strLength;
+		FdbCApi::fdb_error_t error = api->futureGetKey(f, &str, &strLength);
+		ASSERT(!error);
+
+		// The memory for this is stored in the FDBFuture and is released when the future gets destroyed
+		return Standalone<StringRef>(StringRef(str, strLength), Arena());
+	});
+}
+
 ThreadFuture<Standalone<StringRef>> DLDatabase::getClientStatus() {
 	if (!api->databaseGetClientStatus) {
 		return unsupported_operation();
@@ -1055,6 +1190,16 @@ void DLApi::init() {
 	                   fdbCPath,
 	                   "fdb_database_get_client_status",
 	                   headerVersion >= ApiVersion::withGetClientStatus().version());
+	loadClientFunction(&api->databaseGetMetrics,
+	                   lib,
+	                   fdbCPath,
+	                   "fdb_database_get_metrics",
+	                   headerVersion >= ApiVersion::withGetDatabaseMetrics().version());
+	loadClientFunction(&api->databaseGetTransactionProfiles,
+	                   lib,
+	                   fdbCPath,
+	                   "fdb_database_get_transaction_profiles",
+	                   headerVersion >= ApiVersion::withTransactionProfiles().version());
 	loadClientFunction(
 	    &api->tenantCreateTransaction, lib, fdbCPath, "fdb_tenant_create_transaction", headerVersion >= 710);
 	loadClientFunction(&api->tenantPurgeBlobGranules,
@@ -1112,6 +1257,26 @@ void DLApi::init() {
 	    &api->transactionGetReadVersion, lib, fdbCPath, "fdb_transaction_get_read_version", headerVersion >= 0);
 	loadClientFunction(&api->transactionGet, lib, fdbCPath, "fdb_transaction_get", headerVersion >= 0);
 	loadClientFunction(&api->transactionGetKey, lib, fdbCPath, "fdb_transaction_get_key", headerVersion >= 0);
+	loadClientFunction(&api->transactionGetMulti,
+	                   lib,
+	                   fdbCPath,
+	                   "fdb_transaction_get_multi",
+	                   headerVersion >= ApiVersion::withGetMulti().version());
+	loadClientFunction(&api->transactionBatch,
+	                   lib,
+	                   fdbCPath,
+	                   "fdb_transaction_batch",
+	                   headerVersion >= ApiVersion::withTransactionBatch().version());
+	loadClientFunction(&api->transactionGetRangeStream,
+	                   lib,
+	                   fdbCPath,
+	                   "fdb_transaction_get_range_stream",
+	                   headerVersion >= ApiVersion::withGetRangeStream().version());
+	loadClientFunction(&api->futureGetNextChunk,
+	                   lib,
+	                   fdbCPath,
+	                   "fdb_future_get_next_chunk",
+	                   headerVersion >= ApiVersion::withGetRangeStream().version());
 	loadClientFunction(&api->transactionGetAddressesForKey,
 	                   lib,
 	                   fdbCPath,
@@ -1148,6 +1313,11 @@ void DLApi::init() {
 	                   "fdb_transaction_get_approximate_size",
 	                   headerVersion >= 620);
 	loadClientFunction(&api->transactionWatch, lib, fdbCPath, "fdb_transaction_watch", headerVersion >= 0);
+	loadClientFunction(&api->transactionWatchRange,
+	                   lib,
+	                   fdbCPath,
+	                   "fdb_transaction_watch_range",
+	                   headerVersion >= ApiVersion::withWatchRange().version());
 	loadClientFunction(&api->transactionOnError, lib, fdbCPath, "fdb_transaction_on_error", headerVersion >= 0);
 	loadClientFunction(&api->transactionReset, lib, fdbCPath, "fdb_transaction_reset", headerVersion >= 0);
 	loadClientFunction(&api->transactionCancel, lib, fdbCPath, "fdb_transaction_cancel", headerVersion >= 0);
@@ -1472,6 +1642,15 @@ ThreadFuture<Optional<Value>> MultiVersionTransaction::get(const KeyRef& key, bo
 	return executeOperation(&ITransaction::get, key, std::forward<bool>(snapshot));
 }
 
+ThreadFuture<RangeResult> MultiVersionTransaction::getMulti(const VectorRef<KeyRef>& keys, bool snapshot) {
+	return executeOperation(&ITransaction::getMulti, keys, std::forward<bool>(snapshot));
+}
+
+ThreadFuture<RangeResult> MultiVersionTransaction::batch(const VectorRef<BatchOperationRef>& operations,
+                                                         bool snapshot) {
+	return executeOperation(&ITransaction::batch, operations, std::forward<bool>(snapshot));
+}
+
 ThreadFuture<Key> MultiVersionTransaction::getKey(const KeySelectorRef& key, bool snapshot) {
 	return executeOperation(&ITransaction::getKey, key, std::forward<bool>(snapshot));
 }
@@ -1539,6 +1718,26 @@ ThreadFuture<MappedRangeResult> MultiVersionTransaction::getMappedRange(const Ke
 	                        std::forward<bool>(reverse));
 }
 
+Reference<IRangeStream> MultiVersionTransaction::getRangeStream(const KeySelectorRef& begin,
+                                                                const KeySelectorRef& end,
+                                                                bool snapshot) {
+	auto tr = getTransaction();
+	if (tr.transaction) {
+		return makeReference<MultiVersionRangeStream>(tr.transaction->getRangeStream(begin, end, snapshot),
+		                                              tr.onChange);
+	}
+
+	// As for executeOperation, fail with the initialization error or when the transaction times out
+	auto dbError = db->dbState->getInitializationError();
+	ThreadFuture<RangeResult> failure =
+	    dbError.isError() ? ThreadFuture<RangeResult>(dbError.getError()) : makeTimeout<RangeResult>();
+	return makeReference<MultiVersionRangeStream>(failure, tr.onChange);
+}
+
+ThreadFuture<RangeResult> MultiVersionRangeStream::next() {
+	return abortableFuture(stream ? stream->next() : failure, onChange);
+}
+
 ThreadFuture<Standalone<StringRef>> MultiVersionTransaction::getVersionstamp() {
 	return executeOperation(&ITransaction::getVersionstamp);
 }
@@ -1664,6 +1863,10 @@ ThreadFuture<Void> MultiVersionTransaction::watch(const KeyRef& key) {
 	return executeOperation(&ITransaction::watch, key);
 }
 
+ThreadFuture<Void> MultiVersionTransaction::watchRange(const KeyRangeRef& range) {
+	return executeOperation(&ITransaction::watchRange, range);
+}
+
 void MultiVersionTransaction::addWriteConflictRange(const KeyRangeRef& keys) {
 	auto tr = getTransaction();
 	if (tr.transaction) {
@@ -2278,6 +2481,14 @@ ThreadFuture<Standalone<StringRef>> MultiVersionDatabase::getClientStatus() {
 	}
 }
 
+ThreadFuture<Standalone<StringRef>> MultiVersionDatabase::getMetrics() {
+	return executeOperation(&IDatabase::getMetrics);
+}
+
+ThreadFuture<Standalone<StringRef>> MultiVersionDatabase::getTransactionProfiles() {
+	return executeOperation(&IDatabase::getTransactionProfiles);
+}
+
 MultiVersionDatabase::DatabaseState::DatabaseState(ClusterConnectionRecord const& connectionRecord,
                                                    Reference<IDatabase> versionMonitorDb)
   : dbVar(new ThreadSafeAsyncVar<Reference<IDatabase>>(Reference<IDatabase>(nullptr))),
@@ -2708,6 +2919,136 @@ void MultiVersionDatabase::LegacyVersionMonitor::close() {
 	}
 }
 
+// DistributedTenant
+Reference<ITransaction> DistributedTenant::createTransaction() {
+	return tenants[nextTenant.fetch_add(1, std::memory_order_relaxed) % tenants.size()]->createTransaction();
+}
+
+// DistributedDatabase
+Reference<ITenant> DistributedDatabase::openTenant(TenantNameRef tenantName) {
+	std::vector<Reference<ITenant>> tenants;
+	tenants.reserve(dbs.size());
+	for (auto& db : dbs) {
+		tenants.push_back(db->openTenant(tenantName));
+	}
+	return makeReference<DistributedTenant>(std::move(tenants));
+}
+
+Reference<ITransaction> DistributedDatabase::createTransaction() {
+	return dbs[nextDb.fetch_add(1, std::memory_order_relaxed) % dbs.size()]->createTransaction();
+}
+
+void DistributedDatabase::setOption(FDBDatabaseOptions::Option option, Optional<StringRef> value) {
+	for (auto& db : dbs) {
+		db->setOption(option, value);
+	}
+}
+
+double DistributedDatabase::getMainThreadBusyness() {
+	double busyness = 0;
+	for (auto& db : dbs) {
+		busyness += db->getMainThreadBusyness();
+	}
+	return busyness / dbs.size();
+}
+
+// Adds the counters and histograms of src, a report of DatabaseContext::getMetrics(), to dst
+static void mergeDatabaseMetrics(json_spirit::mObject& dst, json_spirit::mObject const& src) {
+	for (const auto& [name, value] : src.at("Counters").get_obj()) {
+		json_spirit::mValue& counter = dst["Counters"].get_obj()[name];
+		counter = (counter.is_null() ? 0 : counter.get_int64()) + value.get_int64();
+	}
+	for (const auto& [name, value] : src.at("Latencies").get_obj()) {
+		json_spirit::mValue& histogramVal = dst["Latencies"].get_obj()[name];
+		if (histogramVal.is_null() || histogramVal.get_obj().at("Count").get_int64() == 0) {
+			histogramVal = value;
+			continue;
+		}
+		json_spirit::mObject& histogram = histogramVal.get_obj();
+		const json_spirit::mObject& other = value.get_obj();
+		int64_t otherCount = other.at("Count").get_int64();
+		if (otherCount == 0) {
+			continue;
+		}
+		int64_t count = histogram["Count"].get_int64();
+		histogram["Count"] = count + otherCount;
+		histogram["Sum"] = histogram["Sum"].get_real() + other.at("Sum").get_real();
+		histogram["Min"] = std::min(histogram["Min"].get_real(), other.at("Min").get_real());
+		histogram["Max"] = std::max(histogram["Max"].get_real(), other.at("Max").get_real());
+
+		// The databases use the same sketch parameters, so equal bucket values are the same bucket
+		std::map<double, int64_t> buckets;
+		auto addBuckets = [&buckets](const json_spirit::mArray& bucketArr) {
+			for (const auto& bucket : bucketArr) {
+				buckets[bucket.get_array()[0].get_real()] += bucket.get_array()[1].get_int64();
+			}
+		};
+		addBuckets(histogram["Buckets"].get_array());
+		addBuckets(other.at("Buckets").get_array());
+		json_spirit::mArray bucketArr;
+		for (const auto& [bucketValue, samples] : buckets) {
+			bucketArr.push_back(json_spirit::mArray{ bucketValue, samples });
+		}
+		histogram["Buckets"] = bucketArr;
+	}
+}
+
+ACTOR static Future<Standalone<StringRef>> getDistributedDatabaseMetrics(
+    std::vector<ThreadFuture<Standalone<StringRef>>> reports) {
+	state json_spirit::mValue merged;
+	state int i = 0;
+	for (; i < reports.size(); i++) {
+		Standalone<StringRef> report = wait(safeThreadFutureToFuture(reports[i]));
+		json_spirit::mValue reportVal;
+		json_spirit::read_string(report.toString(), reportVal);
+		if (i == 0 || reportVal.get_obj().count("InitializationError")) {
+			merged = reportVal;
+		} else if (!merged.get_obj().count("InitializationError")) {
+			mergeDatabaseMetrics(merged.get_obj(), reportVal.get_obj());
+		}
+	}
+	return StringRef(json_spirit::write_string(merged));
+}
+
+ThreadFuture<Standalone<StringRef>> DistributedDatabase::getMetrics() {
+	std::vector<ThreadFuture<Standalone<StringRef>>> reports;
+	for (auto& db : dbs) {
+		reports.push_back(db->getMetrics());
+	}
+	return onMainThread([reports]() { return getDistributedDatabaseMetrics(reports); });
+}
+
+ACTOR static Future<Standalone<StringRef>> getDistributedTransactionProfiles(
+    std::vector<ThreadFuture<Standalone<StringRef>>> reports) {
+	state json_spirit::mArray transactions;
+	state int i = 0;
+	for (; i < reports.size(); i++) {
+		Standalone<StringRef> report = wait(safeThreadFutureToFuture(reports[i]));
+		json_spirit::mValue reportVal;
+		json_spirit::read_string(report.toString(), reportVal);
+		if (reportVal.get_obj().count("InitializationError")) {
+			return report;
+		}
+		for (const auto& transaction : reportVal.get_obj().at("Transactions").get_array()) {
+			transactions.push_back(transaction);
+		}
+	}
+	std::stable_sort(transactions.begin(), transactions.end(), [](const auto& a, const auto& b) {
+		return a.get_obj().at("StartTime").get_real() < b.get_obj().at("StartTime").get_real();
+	});
+	json_spirit::mObject merged;
+	merged["Transactions"] = transactions;
+	return StringRef(json_spirit::write_string(json_spirit::mValue(merged)));
+}
+
+ThreadFuture<Standalone<StringRef>> DistributedDatabase::getTransactionProfiles() {
+	std::vector<ThreadFuture<Standalone<StringRef>>> reports;
+	for (auto& db : dbs) {
+		reports.push_back(db->getTransactionProfiles());
+	}
+	return onMainThread([reports]() { return getDistributedTransactionProfiles(reports); });
+}
+
 // MultiVersionApi
 void MultiVersionApi::runOnExternalClientsAllThreads(std::function<void(Reference<ClientInfo>)> func,
                                                      bool runOnFailedClients,
@@ -2882,6 +3223,23 @@ std::vector<std::pair<std::string, bool>> MultiVersionApi::copyExternalLibraryPe
 		for (int ii = 0; ii < threadCount; ++ii) {
 			std::string filename = basename(path);
 
+			// A cached copy is named after the size and modification time of the library it was copied from, so a
+			// replaced library is copied again
+			std::string cachedName;
+			if (cacheClientLibCopies) {
+				cachedName = joinPath(tmpDir,
+				                      format("%s-%lld-%lld-%d",
+				                             filename.c_str(),
+				                             (long long)fileSize(path),
+				                             (long long)fileModifiedTime(path),
+				                             ii));
+				if (fileExists(cachedName) && fileSize(cachedName) == fileSize(path)) {
+					TraceEvent("ReusingExternalClientCopy").detail("LibraryPath", path).detail("CopyPath", cachedName);
+					paths.push_back({ cachedName, false });
+					continue;
+				}
+			}
+
 			constexpr int MAX_TMP_NAME_LENGTH = PATH_MAX + 12;
 			char tempName[MAX_TMP_NAME_LENGTH];
 			snprintf(tempName, MAX_TMP_NAME_LENGTH, "%s/%s-XXXXXX", tmpDir.c_str(), filename.c_str());
@@ -2928,6 +3286,18 @@ std::vector<std::pair<std::string, bool>> MultiVersionApi::copyExternalLibraryPe
 			close(fd);
 			close(tempFd);
 
+			if (cacheClientLibCopies) {
+				// Only complete copies appear under the cached name, other processes may be loading it at any time
+				if (rename(tempName, cachedName.c_str()) == 0) {
+					paths.push_back({ cachedName, false });
+					continue;
+				}
+				TraceEvent(SevWarn, "ExternalClientCopyCacheFailed")
+				    .GetLastError()
+				    .detail("LibraryPath", path)
+				    .detail("CopyPath", cachedName);
+			}
+
 			paths.push_back({ tempName, true }); // use + delete temporary copies of the library.
 		}
 	}
@@ -3035,6 +3405,13 @@ void MultiVersionApi::setNetworkOptionInternal(FDBNetworkOptions::Option option,
 		// multiple client threads are not supported on windows.
 		threadCount = extractIntOption(value, 1, 1);
 #endif
+	} else if (option == FDBNetworkOptions::CLIENT_THREADS_DISTRIBUTE_TRANSACTIONS) {
+		MutexHolder holder(lock);
+		validateOption(value, false, true);
+		if (networkStartSetup) {
+			throw invalid_option();
+		}
+		distributeTransactions = true;
 	} else if (option == FDBNetworkOptions::CLIENT_TMP_DIR) {
 		validateOption(value, true, false, false);
 		tmpDir = abspath(value.get().toString());
@@ -3062,6 +3439,9 @@ void MultiVersionApi::setNetworkOptionInternal(FDBNetworkOptions::Option option,
 	} else if (option == FDBNetworkOptions::RETAIN_CLIENT_LIBRARY_COPIES) {
 		validateOption(value, false, true);
 		retainClientLibCopies = true;
+	} else if (option == FDBNetworkOptions::CACHE_CLIENT_LIBRARY_COPIES) {
+		validateOption(value, false, true);
+		cacheClientLibCopies = true;
 	} else {
 		forwardOption = true;
 	}
@@ -3301,6 +3681,18 @@ Reference<IDatabase> MultiVersionApi::createDatabase(ClusterConnectionRecord con
 		lock.leave();
 		throw network_not_setup();
 	}
+	if (localClientDisabled && distributeTransactions && threadCount > 1) {
+		ASSERT(!bypassMultiClientApi);
+		lock.leave();
+
+		std::vector<Reference<IDatabase>> dbs;
+		for (int threadIdx = 0; threadIdx < threadCount; ++threadIdx) {
+			Reference<IDatabase> localDb = connectionRecord.createDatabase(localClient->api);
+			dbs.push_back(Reference<IDatabase>(
+			    new MultiVersionDatabase(this, threadIdx, connectionRecord, Reference<IDatabase>(), localDb)));
+		}
+		return makeReference<DistributedDatabase>(std::move(dbs));
+	}
 	if (localClientDisabled) {
 		ASSERT(!bypassMultiClientApi);
 
@@ -3541,8 +3933,9 @@ void MultiVersionApi::loadEnvironmentVariableNetworkOptions() {
 MultiVersionApi::MultiVersionApi()
   : callbackOnMainThread(true), localClientDisabled(false), networkStartSetup(false), networkSetup(false),
     disableBypass(false), bypassMultiClientApi(false), externalClient(false), ignoreExternalClientFailures(false),
-    failIncompatibleClient(false), retainClientLibCopies(false), apiVersion(0), threadCount(0), tmpDir("/tmp"),
-    traceShareBaseNameAmongThreads(false), envOptionsLoaded(false) {}
+    failIncompatibleClient(false), retainClientLibCopies(false), cacheClientLibCopies(false), apiVersion(0),
+    threadCount(0), distributeTransactions(false), tmpDir("/tmp"), traceShareBaseNameAmongThreads(false),
+    envOptionsLoaded(false) {}
 
 MultiVersionApi* MultiVersionApi::api = new MultiVersionApi();
 
@@ -401,6 +401,15 @@ double DatabaseContext::getLastGrvTime() {
 	return lastGrvTime;
 }
 
+StorageServerInfo::StorageServerInfo(DatabaseContext* cx,
+                                     StorageServerInterface const& interf,
+                                     LocalityData const& locality)
+  : ReferencedInterface<StorageServerInterface>(interf, locality), cx(cx) {
+	if (cx->preferZoneLocalReads && locality.zoneId().present() && locality.zoneId() == interf.locality.zoneId()) {
+		distance = LBDistance::SAME_MACHINE;
+	}
+}
+
 Reference<StorageServerInfo> StorageServerInfo::getInterface(DatabaseContext* cx,
                                                              StorageServerInterface const& ssi,
                                                              LocalityData const& locality) {
@@ -512,6 +521,27 @@ std::string unprintable(std::string const& val) {
 	return s;
 }
 
+void DatabaseContext::recordReplicaRead(LoadBalancedReply const& reply, int64_t bytes) {
+	if (!preferZoneLocalReads) {
+		return;
+	}
+	if (reply.replicaDistance == LBDistance::SAME_MACHINE) {
+		transactionZoneLocalBytesRead += bytes;
+	} else {
+		transactionCrossZoneBytesRead += bytes;
+	}
+}
+
+// The bytes of the rows in a range read's reply, as counted by recordReplicaRead()
+template <class GetKeyValuesFamilyReply>
+static int64_t replicaReadRowBytes(GetKeyValuesFamilyReply const& reply) {
+	int64_t bytes = 0;
+	for (auto const& kv : reply.data) {
+		bytes += kv.key.size() + kv.value.size();
+	}
+	return bytes;
+}
+
 void DatabaseContext::validateVersion(Version version) const {
 	// Version could be 0 if the INITIALIZE_NEW_DATABASE option is set. In that case, it is illegal to perform any
 	// reads. We throw client_invalid_operation because the caller didn't directly set the version, so the
@@ -732,6 +762,10 @@ ACTOR Future<Void> databaseLogger(DatabaseContext* cx) {
 			    .detail("MaxBGGranulesPerRequest", cx->bgGranulesPerRequest.max());
 		}
 
+		cx->loggedLatencies.mergeWith(cx->latencies);
+		cx->loggedReadLatencies.mergeWith(cx->readLatencies);
+		cx->loggedGRVLatencies.mergeWith(cx->GRVLatencies);
+		cx->loggedCommitLatencies.mergeWith(cx->commitLatencies);
 		cx->latencies.clear();
 		cx->readLatencies.clear();
 		cx->GRVLatencies.clear();
@@ -1315,6 +1349,174 @@ ACTOR static Future<Void> backgroundGrvUpdater(DatabaseContext* cx) {
 	}
 }
 
+// The contents of the location cache, as saved to a location_cache_file. Each storage server which appears in it is
+// only saved once.
+struct LocationCacheSnapshot {
+	constexpr static FileIdentifier file_identifier = 3598016;
+	UID clusterId;
+	double time = 0;
+	std::vector<StorageServerInterface> servers;
+	// Each cached range, and the indices in servers of the storage servers for it
+	std::vector<std::pair<KeyRangeRef, std::vector<int>>> locations;
+	Arena arena;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, clusterId, time, servers, locations, arena);
+	}
+};
+
+static void saveLocationCache(DatabaseContext* cx) {
+	LocationCacheSnapshot snapshot;
+	snapshot.clusterId = cx->clientInfo->get().clusterId;
+	snapshot.time = timer();
+
+	std::unordered_map<UID, int> serverIndex;
+	for (auto r : cx->locationCache.ranges()) {
+		if (!r.value()) {
+			continue;
+		}
+		if (snapshot.locations.size() >= CLIENT_KNOBS->LOCATION_CACHE_SNAPSHOT_MAX_ENTRIES) {
+			break;
+		}
+		std::vector<int> team;
+		for (int i = 0; i < r.value()->size(); i++) {
+			const StorageServerInterface& ssi = r.value()->getInterface(i);
+			auto [it, inserted] = serverIndex.try_emplace(ssi.id(), snapshot.servers.size());
+			if (inserted) {
+				snapshot.servers.push_back(ssi);
+			}
+			team.push_back(it->second);
+		}
+		snapshot.locations.emplace_back(KeyRangeRef(snapshot.arena, r.range()), std::move(team));
+	}
+
+	Value data = ObjectWriter::toValue(snapshot, IncludeVersion());
+	atomicReplace(cx->locationCacheFile, data.toString(), false);
+	TraceEvent("LocationCacheSaved", cx->dbId)
+	    .detail("File", cx->locationCacheFile)
+	    .detail("Locations", snapshot.locations.size())
+	    .detail("Servers", snapshot.servers.size())
+	    .detail("Bytes", data.size());
+}
+
+// Only fills in parts of the cache which nothing has been learned about yet, and only with storage servers the client
+// doesn't already know, since anything learned from the cluster is newer than the snapshot. Interfaces which turn out
+// to be stale are dropped from the cache as usual when requests to them fail.
+static void loadLocationCache(DatabaseContext* cx) {
+	if (!fileExists(cx->locationCacheFile)) {
+		return;
+	}
+	LocationCacheSnapshot snapshot = ObjectReader::fromStringRef<LocationCacheSnapshot>(
+	    StringRef(readFileBytes(cx->locationCacheFile, CLIENT_KNOBS->LOCATION_CACHE_SNAPSHOT_MAX_BYTES)),
+	    IncludeVersion());
+	double age = timer() - snapshot.time;
+	if (snapshot.clusterId != cx->clientInfo->get().clusterId || age > CLIENT_KNOBS->LOCATION_CACHE_SNAPSHOT_MAX_AGE) {
+		TraceEvent("LocationCacheSnapshotIgnored", cx->dbId)
+		    .detail("File", cx->locationCacheFile)
+		    .detail("SnapshotClusterId", snapshot.clusterId)
+		    .detail("ClusterId", cx->clientInfo->get().clusterId)
+		    .detail("Age", age);
+		return;
+	}
+
+	int loaded = 0;
+	for (const auto& [range, team] : snapshot.locations) {
+		bool known = false;
+		for (auto r : cx->locationCache.intersectingRanges(range)) {
+			known = known || r.value();
+		}
+		std::vector<StorageServerInterface> servers;
+		for (int i : team) {
+			known = known || cx->server_interf.count(snapshot.servers[i].id());
+			servers.push_back(snapshot.servers[i]);
+		}
+		if (!known) {
+			cx->setCachedLocation(range, servers);
+			++loaded;
+		}
+	}
+	TraceEvent("LocationCacheLoaded", cx->dbId)
+	    .detail("File", cx->locationCacheFile)
+	    .detail("Locations", snapshot.locations.size())
+	    .detail("Loaded", loaded)
+	    .detail("Age", age);
+}
+
+ACTOR static Future<Void> persistLocationCache(DatabaseContext* cx) {
+	while (!cx->clientInfo->get().clusterId.isValid()) {
+		wait(cx->clientInfo->onChange());
+	}
+
+	try {
+		loadLocationCache(cx);
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarn, "LocationCacheLoadFailed", cx->dbId).error(e).detail("File", cx->locationCacheFile);
+	}
+
+	loop {
+		wait(delay(CLIENT_KNOBS->LOCATION_CACHE_SNAPSHOT_INTERVAL));
+		try {
+			saveLocationCache(cx);
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			TraceEvent(SevWarn, "LocationCacheSaveFailed", cx->dbId)
+			    .errorUnsuppressed(e)
+			    .suppressFor(60)
+			    .detail("File", cx->locationCacheFile);
+		}
+	}
+}
+
+// Appends the transactions buffered by captureTransaction() to the transaction_capture_file, until the option is
+// changed
+ACTOR static Future<Void> writeTransactionCapture(DatabaseContext* cx) {
+	state std::string fileName = cx->transactionCaptureFile;
+	state Reference<IAsyncFile> file;
+	state std::string data;
+	try {
+		wait(store(file,
+		           IAsyncFileSystem::filesystem()->open(fileName,
+		                                                IAsyncFile::OPEN_NO_AIO | IAsyncFile::OPEN_CREATE |
+		                                                    IAsyncFile::OPEN_READWRITE,
+		                                                0600)));
+		int64_t size = wait(file->size());
+		cx->transactionCaptureBytes = size;
+		TraceEvent("TransactionCaptureStarted", cx->dbId).detail("File", fileName).detail("Bytes", size);
+		state bool stopped = false;
+		while (!stopped) {
+			wait(delay(CLIENT_KNOBS->TRANSACTION_CAPTURE_FLUSH_INTERVAL));
+			stopped = cx->transactionCaptureFile != fileName;
+			if (cx->transactionCaptureBuffer.empty()) {
+				continue;
+			}
+			data = std::move(cx->transactionCaptureBuffer);
+			cx->transactionCaptureBuffer.clear();
+			wait(file->write(data.data(), data.size(), cx->transactionCaptureBytes));
+			cx->transactionCaptureBytes += data.size();
+		}
+		wait(file->sync());
+		TraceEvent("TransactionCaptureStopped", cx->dbId)
+		    .detail("File", fileName)
+		    .detail("Bytes", cx->transactionCaptureBytes);
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		TraceEvent(SevWarnAlways, "TransactionCaptureFailed", cx->dbId).errorUnsuppressed(e).detail("File", fileName);
+		if (cx->transactionCaptureFile == fileName) {
+			cx->transactionCaptureFile.clear();
+			cx->transactionCaptureBuffer.clear();
+		}
+	}
+	return Void();
+}
+
 inline HealthMetrics populateHealthMetrics(const HealthMetrics& detailedMetrics, bool detailedOutput) {
 	if (detailedOutput) {
 		return detailedMetrics;
@@ -1501,6 +1703,89 @@ Future<RangeResult> HealthMetricsRangeImpl::getRange(ReadYourWritesTransaction*
 	return healthMetricsGetRangeActor(ryw, kr);
 }
 
+class HotKeysRangeImpl : public SpecialKeyRangeAsyncImpl {
+public:
+	explicit HotKeysRangeImpl(KeyRangeRef kr) : SpecialKeyRangeAsyncImpl(kr) {}
+	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
+	                             KeyRangeRef kr,
+	                             GetRangeLimits limitsHint) const override;
+};
+
+// Each storage server's hottest reads and writes, as <prefix><storage server id>/<read|write>/<rank>. Servers that
+// don't answer in time are left out.
+ACTOR static Future<RangeResult> hotKeysGetRangeActor(ReadYourWritesTransaction* ryw, KeyRef prefix, KeyRangeRef kr) {
+	state Transaction tr(ryw->getDatabase());
+	state RangeResult serverList;
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			wait(store(serverList, tr.getRange(serverListKeys, CLIENT_KNOBS->TOO_MANY)));
+			ASSERT(!serverList.more && serverList.size() < CLIENT_KNOBS->TOO_MANY);
+			break;
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+
+	state std::vector<Key> serverPrefixes;
+	state std::vector<Future<ErrorOr<GetHotKeysReply>>> replies;
+	for (auto const& kv : serverList) {
+		StorageServerInterface ssi = decodeServerListValue(kv.value);
+		Key serverPrefix = prefix.withSuffix(ssi.id().toString() + "/");
+		if (!kr.intersects(prefixRange(serverPrefix))) {
+			continue;
+		}
+		serverPrefixes.push_back(serverPrefix);
+		replies.push_back(
+		    errorOr(timeoutError(ssi.getHotKeys.getReply(GetHotKeysRequest(CLIENT_KNOBS->HOT_KEYS_REPORTED)),
+		                         CLIENT_KNOBS->HOT_KEYS_TIMEOUT)));
+	}
+	wait(waitForAll(replies));
+
+	RangeResult result;
+	for (int i = 0; i < replies.size(); i++) {
+		if (replies[i].get().isError()) {
+			TraceEvent(SevWarn, "HotKeysRequestFailed")
+			    .error(replies[i].get().getError())
+			    .detail("Server", serverPrefixes[i].removePrefix(prefix));
+			continue;
+		}
+		int ranks[2] = { 0, 0 };
+		for (auto const& hotKey : replies[i].get().get().hotKeys) {
+			Key k = serverPrefixes[i].withSuffix(
+			    format("%s/%04d", hotKey.write ? "write" : "read", ranks[hotKey.write ? 1 : 0]++));
+			if (!kr.contains(k)) {
+				continue;
+			}
+			json_spirit::mObject statsObj;
+			if (hotKey.end.present()) {
+				statsObj["begin"] = printable(hotKey.begin);
+				statsObj["end"] = printable(hotKey.end.get());
+			} else {
+				statsObj["key"] = printable(hotKey.begin);
+			}
+			if (hotKey.tenantId != TenantInfo::INVALID_TENANT) {
+				statsObj["tenant_id"] = hotKey.tenantId;
+			}
+			statsObj["count"] = hotKey.count;
+			statsObj["error"] = hotKey.error;
+			statsObj["ops_per_second"] = hotKey.opsPerSecond;
+			std::string statsString =
+			    json_spirit::write_string(json_spirit::mValue(statsObj), json_spirit::Output_options::raw_utf8);
+			result.push_back_deep(result.arena(), KeyValueRef(k, StringRef(statsString)));
+		}
+	}
+	std::sort(result.begin(), result.end(), KeyValueRef::OrderByKey());
+	return result;
+}
+
+Future<RangeResult> HotKeysRangeImpl::getRange(ReadYourWritesTransaction* ryw,
+                                               KeyRangeRef kr,
+                                               GetRangeLimits limitsHint) const {
+	return hotKeysGetRangeActor(ryw, getKeyRange().begin, kr);
+}
+
 ACTOR Future<UID> getClusterId(Database db) {
 	while (!db->clientInfo->get().clusterId.isValid()) {
 		wait(db->clientInfo->onChange());
@@ -1531,6 +1816,7 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
     cc("TransactionMetrics", dbId.toString()), transactionReadVersions("ReadVersions", cc),
     transactionReadVersionsThrottled("ReadVersionsThrottled", cc),
     transactionReadVersionsCompleted("ReadVersionsCompleted", cc),
+    transactionGrvCacheHits("GrvCacheHits", cc), transactionGrvCacheMisses("GrvCacheMisses", cc),
     transactionReadVersionBatches("ReadVersionBatches", cc),
     transactionBatchReadVersions("BatchPriorityReadVersions", cc),
     transactionDefaultReadVersions("DefaultPriorityReadVersions", cc),
@@ -1545,7 +1831,9 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
     transactionGetMappedRangeRequests("GetMappedRangeRequests", cc),
     transactionGetRangeStreamRequests("GetRangeStreamRequests", cc), transactionWatchRequests("WatchRequests", cc),
     transactionGetAddressesForKeyRequests("GetAddressesForKeyRequests", cc), transactionBytesRead("BytesRead", cc),
-    transactionKeysRead("KeysRead", cc), transactionMetadataVersionReads("MetadataVersionReads", cc),
+    transactionKeysRead("KeysRead", cc), transactionZoneLocalBytesRead("ZoneLocalBytesRead", cc),
+    transactionCrossZoneBytesRead("CrossZoneBytesRead", cc),
+    transactionMetadataVersionReads("MetadataVersionReads", cc),
     transactionCommittedMutations("CommittedMutations", cc),
     transactionCommittedMutationBytes("CommittedMutationBytes", cc), transactionSetMutations("SetMutations", cc),
     transactionClearMutations("ClearMutations", cc), transactionAtomicMutations("AtomicMutations", cc),
@@ -1611,6 +1899,11 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
 		    std::make_unique<FaultToleranceMetricsImpl>(
 		        singleKeyRange("fault_tolerance_metrics_json"_sr)
 		            .withPrefix(SpecialKeySpace::getModuleRange(SpecialKeySpace::MODULE::METRICS).begin)));
+		registerSpecialKeysImpl(
+		    SpecialKeySpace::MODULE::METRICS,
+		    SpecialKeySpace::IMPLTYPE::READONLY,
+		    std::make_unique<HotKeysRangeImpl>(
+		        KeyRangeRef("\xff\xff/metrics/hot_keys/"_sr, "\xff\xff/metrics/hot_keys0"_sr)));
 	}
 
 	if (apiVersion.version() >= 700) {
@@ -1844,6 +2137,7 @@ DatabaseContext::DatabaseContext(const Error& err)
   : deferredError(err), internal(IsInternal::False), cc("TransactionMetrics"),
     transactionReadVersions("ReadVersions", cc), transactionReadVersionsThrottled("ReadVersionsThrottled", cc),
     transactionReadVersionsCompleted("ReadVersionsCompleted", cc),
+    transactionGrvCacheHits("GrvCacheHits", cc), transactionGrvCacheMisses("GrvCacheMisses", cc),
     transactionReadVersionBatches("ReadVersionBatches", cc),
     transactionBatchReadVersions("BatchPriorityReadVersions", cc),
     transactionDefaultReadVersions("DefaultPriorityReadVersions", cc),
@@ -1858,7 +2152,9 @@ DatabaseContext::DatabaseContext(const Error& err)
     transactionGetMappedRangeRequests("GetMappedRangeRequests", cc),
     transactionGetRangeStreamRequests("GetRangeStreamRequests", cc), transactionWatchRequests("WatchRequests", cc),
     transactionGetAddressesForKeyRequests("GetAddressesForKeyRequests", cc), transactionBytesRead("BytesRead", cc),
-    transactionKeysRead("KeysRead", cc), transactionMetadataVersionReads("MetadataVersionReads", cc),
+    transactionKeysRead("KeysRead", cc), transactionZoneLocalBytesRead("ZoneLocalBytesRead", cc),
+    transactionCrossZoneBytesRead("CrossZoneBytesRead", cc),
+    transactionMetadataVersionReads("MetadataVersionReads", cc),
     transactionCommittedMutations("CommittedMutations", cc),
     transactionCommittedMutationBytes("CommittedMutationBytes", cc), transactionSetMutations("SetMutations", cc),
     transactionClearMutations("ClearMutations", cc), transactionAtomicMutations("AtomicMutations", cc),
@@ -1917,6 +2213,8 @@ DatabaseContext::~DatabaseContext() {
 	clientDBInfoMonitor.cancel();
 	monitorTssInfoChange.cancel();
 	tssMismatchHandler.cancel();
+	locationCacheSnapshotter.cancel();
+	transactionCaptureWriter.cancel();
 	initializeChangeFeedCache = Void();
 	storage = nullptr;
 	changeFeedStorageCommitter = Void();
@@ -2126,6 +2424,20 @@ void DatabaseContext::setOption(FDBDatabaseOptions::Option option, Optional<Stri
 		case FDBDatabaseOptions::LOCATION_CACHE_SIZE:
 			locationCacheSize = (int)extractIntOption(value, 0, std::numeric_limits<int>::max());
 			break;
+		case FDBDatabaseOptions::LOCATION_CACHE_FILE:
+			validateOptionValuePresent(value);
+			locationCacheFile = value.get().toString();
+			locationCacheSnapshotter = persistLocationCache(this);
+			break;
+		case FDBDatabaseOptions::TRANSACTION_CAPTURE_FILE:
+			validateOptionValuePresent(value);
+			// Starting a new writer cancels the previous one, which leaves what it buffered to the new file. Given an
+			// empty path, the previous writer instead flushes what it has buffered and stops once it sees the change.
+			transactionCaptureFile = value.get().toString();
+			if (!transactionCaptureFile.empty()) {
+				transactionCaptureWriter = writeTransactionCapture(this);
+			}
+			break;
 		case FDBDatabaseOptions::MACHINE_ID:
 			clientLocality =
 			    LocalityData(clientLocality.processId(),
@@ -2139,6 +2451,12 @@ void DatabaseContext::setOption(FDBDatabaseOptions::Option option, Optional<Stri
 			server_interf.clear();
 			locationCache.insert(allKeys, Reference<LocationInfo>());
 			break;
+		case FDBDatabaseOptions::PREFER_ZONE_LOCAL_READS:
+			validateOptionValueNotPresent(value);
+			preferZoneLocalReads = true;
+			server_interf.clear();
+			locationCache.insert(allKeys, Reference<LocationInfo>());
+			break;
 		case FDBDatabaseOptions::MAX_WATCHES:
 			maxOutstandingWatches = (int)extractIntOption(value, 0, CLIENT_KNOBS->ABSOLUTE_MAX_WATCHES);
 			break;
@@ -2170,12 +2488,46 @@ void DatabaseContext::setOption(FDBDatabaseOptions::Option option, Optional<Stri
 		case FDBDatabaseOptions::TEST_CAUSAL_READ_RISKY:
 			verifyCausalReadsProp = double(extractIntOption(value, 0, 100)) / 100.0;
 			break;
+		case FDBDatabaseOptions::TRANSACTION_PROFILE_BUFFER_SIZE:
+			transactionProfileLimit = (int)extractIntOption(value, 0, std::numeric_limits<int>::max());
+			while (transactionProfiles.size() > (size_t)transactionProfileLimit) {
+				transactionProfiles.pop_front();
+			}
+			break;
 		default:
 			break;
 		}
 	}
 }
 
+void TransactionProfile::addRead(ReadType type, double startTime, double latency, int64_t bytes) {
+	if (reads.size() >= (size_t)CLIENT_KNOBS->TRANSACTION_PROFILE_MAX_READS) {
+		++readsDropped;
+		return;
+	}
+	reads.push_back(Read{ type, startTime, latency, bytes });
+}
+
+void DatabaseContext::captureTransaction(StringRef events) {
+	if (transactionCaptureFile.empty() ||
+	    transactionCaptureBytes + transactionCaptureBuffer.size() >= CLIENT_KNOBS->TRANSACTION_CAPTURE_MAX_BYTES) {
+		return;
+	}
+	int32_t length = littleEndian32(events.size());
+	transactionCaptureBuffer.append((const char*)&length, sizeof(length));
+	transactionCaptureBuffer.append((const char*)events.begin(), events.size());
+}
+
+void DatabaseContext::addTransactionProfile(TransactionProfile&& profile) {
+	if (transactionProfileLimit <= 0) {
+		return;
+	}
+	while (transactionProfiles.size() >= (size_t)transactionProfileLimit) {
+		transactionProfiles.pop_front();
+	}
+	transactionProfiles.push_back(std::move(profile));
+}
+
 void DatabaseContext::increaseWatchCounter() {
 	if (outstandingWatches >= maxOutstandingWatches)
 		throw too_many_watches();
@@ -3010,6 +3362,27 @@ void updateTagMappings(Database cx, const GetKeyServerLocationsReply& reply) {
 	}
 }
 
+// The request for the location of the shard containing `key`, or the key before it if isBackward. The locations of up
+// to LOCATION_CACHE_PREFETCH_SHARDS following (or preceding) shards are asked for in the same request, so that a scan
+// or a batch of nearby reads which starts with a cold cache does not go back to the commit proxies for each shard.
+GetKeyServerLocationsRequest keyLocationRequest(SpanContext spanContext,
+                                                TenantInfo const& tenant,
+                                                Key const& key,
+                                                Reverse isBackward,
+                                                Version version) {
+	if (CLIENT_KNOBS->LOCATION_CACHE_PREFETCH_SHARDS <= 0) {
+		return GetKeyServerLocationsRequest(
+		    spanContext, tenant, key, Optional<KeyRef>(), 100, isBackward, version, key.arena());
+	}
+	int limit = 1 + CLIENT_KNOBS->LOCATION_CACHE_PREFETCH_SHARDS;
+	if (isBackward) {
+		return GetKeyServerLocationsRequest(
+		    spanContext, tenant, allKeys.begin, Optional<KeyRef>(key), limit, isBackward, version, key.arena());
+	}
+	return GetKeyServerLocationsRequest(
+	    spanContext, tenant, key, Optional<KeyRef>(allKeys.end), limit, isBackward, version, key.arena());
+}
+
 // If isBackward == true, returns the shard containing the key before 'key' (an infinitely long, inexpressible key).
 // Otherwise returns the shard containing key
 ACTOR Future<KeyRangeLocationInfo> getKeyLocation_internal(Database cx,
@@ -3037,18 +3410,22 @@ ACTOR Future<KeyRangeLocationInfo> getKeyLocation_internal(Database cx,
 			++cx->transactionKeyServerLocationRequests;
 			choose {
 				when(wait(cx->onProxiesChanged())) {}
-				when(GetKeyServerLocationsReply rep = wait(basicLoadBalance(
-				         cx->getCommitProxies(useProvisionalProxies),
-				         &CommitProxyInterface::getKeyServersLocations,
-				         GetKeyServerLocationsRequest(
-				             span.context, tenant, key, Optional<KeyRef>(), 100, isBackward, version, key.arena()),
-				         TaskPriority::DefaultPromiseEndpoint))) {
+				when(GetKeyServerLocationsReply rep =
+				         wait(basicLoadBalance(cx->getCommitProxies(useProvisionalProxies),
+				                               &CommitProxyInterface::getKeyServersLocations,
+				                               keyLocationRequest(span.context, tenant, key, isBackward, version),
+				                               TaskPriority::DefaultPromiseEndpoint))) {
 					++cx->transactionKeyServerLocationRequestsCompleted;
 					if (debugID.present())
 						g_traceBatch.addEvent(
 						    "TransactionDebug", debugID.get().first(), "NativeAPI.getKeyLocation.After");
-					ASSERT(rep.results.size() == 1);
+					ASSERT(rep.results.size() >= 1);
 
+					// The first result is the shard asked for. It is cached last so that making room for the
+					// adjacent ones can't evict it.
+					for (int i = 1; i < rep.results.size(); i++) {
+						cx->setCachedLocation(rep.results[i].first, rep.results[i].second);
+					}
 					auto locationInfo = cx->setCachedLocation(rep.results[0].first, rep.results[0].second);
 					updateTssMappings(cx, rep);
 					updateTagMappings(cx, rep);
@@ -3135,6 +3512,24 @@ Future<KeyRangeLocationInfo> getKeyLocation(Database const& cx,
 	return locationInfo.get();
 }
 
+// Adds a location lookup that missed the cache to the transaction's profile
+ACTOR template <class T>
+Future<T> timeLocationLookup(std::shared_ptr<TransactionProfile> profile, Future<T> lookup) {
+	state double startTime = now();
+	T result = wait(lookup);
+	++profile->locationLookups;
+	profile->locationLatency += now() - startTime;
+	return result;
+}
+
+template <class T>
+Future<T> profileLocationLookup(Reference<TransactionState> const& trState, Future<T> lookup) {
+	if (!trState->profile || lookup.isReady()) {
+		return lookup;
+	}
+	return timeLocationLookup(trState->profile, lookup);
+}
+
 template <class F>
 Future<KeyRangeLocationInfo> getKeyLocation(Reference<TransactionState> trState,
                                             Key const& key,
@@ -3142,7 +3537,7 @@ Future<KeyRangeLocationInfo> getKeyLocation(Reference<TransactionState> trState,
                                             Reverse isBackward,
                                             UseTenant useTenant) {
 	CODE_PROBE(!useTenant, "Get key location ignoring tenant");
-	return getKeyLocation(trState->cx,
+	Future<KeyRangeLocationInfo> location = getKeyLocation(trState->cx,
 	                      useTenant ? trState->getTenantInfo() : TenantInfo(),
 	                      key,
 	                      member,
@@ -3153,6 +3548,7 @@ Future<KeyRangeLocationInfo> getKeyLocation(Reference<TransactionState> trState,
 	                      trState->readVersionFuture.isValid() && trState->readVersionFuture.isReady()
 	                          ? trState->readVersion()
 	                          : latestVersion);
+	return profileLocationLookup(trState, location);
 }
 
 void DatabaseContext::updateBackoff(const Error& err) {
@@ -3300,18 +3696,20 @@ Future<std::vector<KeyRangeLocationInfo>> getKeyRangeLocations(Reference<Transac
                                                                F StorageServerInterface::*member,
                                                                UseTenant useTenant) {
 	CODE_PROBE(!useTenant, "Get key range locations ignoring tenant");
-	return getKeyRangeLocations(trState->cx,
-	                            useTenant ? trState->getTenantInfo(AllowInvalidTenantID::True) : TenantInfo(),
-	                            keys,
-	                            limit,
-	                            reverse,
-	                            member,
-	                            trState->spanContext,
-	                            trState->readOptions.present() ? trState->readOptions.get().debugID : Optional<UID>(),
-	                            trState->useProvisionalProxies,
-	                            trState->readVersionFuture.isValid() && trState->readVersionFuture.isReady()
-	                                ? trState->readVersion()
-	                                : latestVersion);
+	Future<std::vector<KeyRangeLocationInfo>> locations =
+	    getKeyRangeLocations(trState->cx,
+	                         useTenant ? trState->getTenantInfo(AllowInvalidTenantID::True) : TenantInfo(),
+	                         keys,
+	                         limit,
+	                         reverse,
+	                         member,
+	                         trState->spanContext,
+	                         trState->readOptions.present() ? trState->readOptions.get().debugID : Optional<UID>(),
+	                         trState->useProvisionalProxies,
+	                         trState->readVersionFuture.isValid() && trState->readVersionFuture.isReady()
+	                             ? trState->readVersion()
+	                             : latestVersion);
+	return profileLocationLookup(trState, locations);
 }
 
 ACTOR Future<std::vector<std::pair<KeyRange, UID>>> getBlobGranuleLocations_internal(
@@ -3522,7 +3920,22 @@ TransactionState::TransactionState(Database cx,
                                    SpanContext spanContext,
                                    Reference<TransactionLogInfo> trLogInfo)
   : cx(cx), trLogInfo(trLogInfo), options(cx), taskID(taskID), spanContext(spanContext),
-    readVersionObtainedFromGrvProxy(true), tenant_(tenant), tenantSet(tenant.present()) {}
+    readVersionObtainedFromGrvProxy(true), tenant_(tenant), tenantSet(tenant.present()) {
+	if (cx->transactionProfileLimit > 0) {
+		profile = std::make_shared<TransactionProfile>(now());
+		if (trLogInfo) {
+			profile->debugIdentifier = trLogInfo->identifier;
+		}
+	}
+}
+
+TransactionState::~TransactionState() {
+	if (profile && !profile->empty()) {
+		profile->endTime = now();
+		profile->retries = numErrors;
+		cx->addTransactionProfile(std::move(*profile));
+	}
+}
 
 Reference<TransactionState> TransactionState::cloneAndReset(Reference<TransactionLogInfo> newTrLogInfo,
                                                             bool generateNewSpan) const {
@@ -3718,6 +4131,12 @@ ACTOR Future<Optional<Value>> getValue(Reference<TransactionState> trState,
 
 			double latency = now() - startTimeD;
 			trState->cx->readLatencies.addSample(latency);
+			if (trState->profile) {
+				trState->profile->addRead(TransactionProfile::ReadType::GET,
+				                          startTimeD,
+				                          latency,
+				                          reply.value.present() ? reply.value.get().size() : 0);
+			}
 			if (trState->trLogInfo && recordLogInfo) {
 				int valueSize = reply.value.present() ? reply.value.get().size() : 0;
 				trState->trLogInfo->addLog(FdbClientLogEvents::EventGet(startTimeD,
@@ -3743,6 +4162,7 @@ ACTOR Future<Optional<Value>> getValue(Reference<TransactionState> trState,
 			}
 
 			trState->cx->transactionBytesRead += reply.value.present() ? reply.value.get().size() : 0;
+			trState->cx->recordReplicaRead(reply, reply.value.present() ? reply.value.get().size() : 0);
 			++trState->cx->transactionKeysRead;
 			return reply.value;
 		} catch (Error& e) {
@@ -3775,6 +4195,177 @@ ACTOR Future<Optional<Value>> getValue(Reference<TransactionState> trState,
 	}
 }
 
+// Reads keys, all of which are in the shard served by locations, in a single GetValuesRequest
+ACTOR Future<std::vector<Optional<Value>>> getValuesFromTeam(Reference<TransactionState> trState,
+                                                             Standalone<VectorRef<KeyRef>> keys,
+                                                             Reference<LocationInfo> locations,
+                                                             UseTenant useTenant,
+                                                             SpanContext spanContext) {
+	state VersionVector ssLatestCommitVersions;
+	state double startTime = now();
+	trState->cx->getLatestCommitVersions(locations, trState, ssLatestCommitVersions);
+
+	++trState->cx->transactionPhysicalReads;
+	state GetValuesReply reply;
+	try {
+		if (CLIENT_BUGGIFY_WITH_PROB(.01)) {
+			throw deterministicRandom()->randomChoice(std::vector<Error>{ transaction_too_old(), future_version() });
+		}
+		choose {
+			when(wait(trState->cx->connectionFileChanged())) {
+				throw transaction_too_old();
+			}
+			when(GetValuesReply _reply = wait(
+			         loadBalance(trState->cx.getPtr(),
+			                     locations,
+			                     &StorageServerInterface::getValues,
+			                     GetValuesRequest(spanContext,
+			                                      useTenant ? trState->getTenantInfo() : TenantInfo(),
+			                                      keys,
+			                                      trState->readVersion(),
+			                                      trState->cx->sampleReadTags() ? trState->options.readTags
+			                                                                    : Optional<TagSet>(),
+			                                      trState->readOptions,
+			                                      ssLatestCommitVersions),
+			                     TaskPriority::DefaultPromiseEndpoint,
+			                     AtMostOnce::False,
+			                     trState->cx->enableLocalityLoadBalance ? &trState->cx->queueModel : nullptr,
+			                     trState->options.enableReplicaConsistencyCheck,
+			                     trState->options.requiredReplicas))) {
+				reply = _reply;
+			}
+		}
+		++trState->cx->transactionPhysicalReadsCompleted;
+	} catch (Error&) {
+		++trState->cx->transactionPhysicalReadsCompleted;
+		throw;
+	}
+	trState->cx->readLatencies.addSample(now() - startTime);
+
+	if (reply.values.size() != keys.size()) {
+		TraceEvent(SevError, "GetValuesReplySizeMismatch")
+		    .detail("Keys", keys.size())
+		    .detail("Values", reply.values.size());
+		throw internal_error();
+	}
+
+	std::vector<Optional<Value>> values;
+	values.reserve(keys.size());
+	int64_t bytes = 0;
+	for (int i = 0; i < keys.size(); i++) {
+		int valueSize = 0;
+		if (reply.values[i].present()) {
+			values.push_back(Value(reply.values[i].get(), reply.arena));
+			valueSize = reply.values[i].get().size();
+		} else {
+			values.push_back(Optional<Value>());
+		}
+		bytes += valueSize;
+		trState->totalCost += getReadOperationCost(keys[i].size() + valueSize);
+	}
+	trState->cx->transactionBytesRead += bytes;
+	trState->cx->recordReplicaRead(reply, bytes);
+	trState->cx->transactionKeysRead += keys.size();
+	return values;
+}
+
+// Reads a set of keys with one GetValuesRequest per storage team (and per GET_VALUES_MAX_KEYS keys) instead of one
+// GetValueRequest per key. The result holds the value of keys[i] at index i.
+ACTOR Future<std::vector<Optional<Value>>> getValues(Reference<TransactionState> trState,
+                                                     Standalone<VectorRef<KeyRef>> keys,
+                                                     UseTenant useTenant) {
+	wait(trState->startTransaction());
+
+	CODE_PROBE(trState->hasTenant(), "NativeAPI getValues has tenant");
+
+	state Span span("NAPI:getValues"_loc, trState->spanContext);
+	trState->cx->validateVersion(trState->readVersion());
+
+	state std::vector<Optional<Value>> results(keys.size());
+	state std::vector<int> pending;
+	for (int i = 0; i < keys.size(); i++) {
+		pending.push_back(i);
+	}
+	state std::vector<Future<KeyRangeLocationInfo>> locations;
+	state std::vector<std::vector<int>> batches;
+	state std::vector<Future<std::vector<Optional<Value>>>> batchResults;
+	state std::vector<Future<Optional<Value>>> fallbacks;
+	state std::vector<int> fallbackKeys;
+
+	loop {
+		locations.clear();
+		for (int i : pending) {
+			locations.push_back(
+			    getKeyLocation(trState, keys[i], &StorageServerInterface::getValues, Reverse::False, useTenant));
+		}
+		wait(waitForAll(locations));
+
+		// Keys in the same shard are served by the same team
+		std::map<KeyRef, std::vector<int>> byShard;
+		std::map<KeyRef, Reference<LocationInfo>> shardLocations;
+		for (int p = 0; p < pending.size(); p++) {
+			const KeyRangeLocationInfo& info = locations[p].get();
+			byShard[info.range.begin].push_back(pending[p]);
+			shardLocations[info.range.begin] = info.locations;
+		}
+
+		batches.clear();
+		batchResults.clear();
+		for (auto& [begin, indices] : byShard) {
+			for (int b = 0; b < indices.size(); b += CLIENT_KNOBS->GET_VALUES_MAX_KEYS) {
+				int end = std::min<int>(indices.size(), b + CLIENT_KNOBS->GET_VALUES_MAX_KEYS);
+				std::vector<int> batch(indices.begin() + b, indices.begin() + end);
+				Standalone<VectorRef<KeyRef>> batchKeys;
+				for (int i : batch) {
+					batchKeys.push_back(batchKeys.arena(), keys[i]);
+				}
+				batchKeys.arena().dependsOn(keys.arena());
+				batchResults.push_back(
+				    getValuesFromTeam(trState, batchKeys, shardLocations[begin], useTenant, span.context));
+				batches.push_back(std::move(batch));
+			}
+		}
+		wait(waitForAllReady(batchResults));
+
+		pending.clear();
+		fallbacks.clear();
+		fallbackKeys.clear();
+		for (int b = 0; b < batches.size(); b++) {
+			if (!batchResults[b].isError()) {
+				for (int i = 0; i < batches[b].size(); i++) {
+					results[batches[b][i]] = batchResults[b].get()[i];
+				}
+			} else if (batchResults[b].getError().code() == error_code_wrong_shard_server) {
+				for (int i : batches[b]) {
+					trState->cx->invalidateCache(
+					    useTenant ? trState->tenant().mapRef(&Tenant::prefix) : Optional<KeyRef>(), keys[i]);
+					pending.push_back(i);
+				}
+			} else if (batchResults[b].getError().code() == error_code_all_alternatives_failed) {
+				// Also the case for storage servers which predate GetValuesRequest. getValue() does its own retrying.
+				CODE_PROBE(true, "NativeAPI getValues falls back to getValue");
+				for (int i : batches[b]) {
+					fallbacks.push_back(getValue(trState, keys[i], useTenant, TransactionRecordLogInfo::False));
+					fallbackKeys.push_back(i);
+				}
+			} else {
+				throw batchResults[b].getError();
+			}
+		}
+
+		if (!fallbacks.empty()) {
+			wait(waitForAll(fallbacks));
+			for (int f = 0; f < fallbacks.size(); f++) {
+				results[fallbackKeys[f]] = fallbacks[f].get();
+			}
+		}
+		if (pending.empty()) {
+			return results;
+		}
+		wait(delay(CLIENT_KNOBS->WRONG_SHARD_SERVER_DELAY, trState->taskID));
+	}
+}
+
 ACTOR Future<Key> getKey(Reference<TransactionState> trState, KeySelector k, UseTenant useTenant = UseTenant::True) {
 	CODE_PROBE(!useTenant, "Get key ignoring tenant");
 	wait(trState->startTransaction());
@@ -4053,6 +4644,88 @@ ACTOR Future<Version> watchValue(Database cx, Reference<const WatchParameters> p
 	}
 }
 
+// Returns the version of the first change to range after version, watching each of its shards until one fires
+ACTOR Future<Version> watchRangeValue(Database cx,
+                                      TenantInfo tenant,
+                                      KeyRange range,
+                                      Version version,
+                                      Optional<TagSet> tags,
+                                      SpanContext spanContext,
+                                      TaskPriority taskID,
+                                      UseProvisionalProxies useProvisionalProxies) {
+	state Span span("NAPI:watchRange"_loc, spanContext);
+	state Version ver = version;
+	cx->validateVersion(version);
+	ASSERT(version != latestVersion);
+
+	loop {
+		state std::vector<KeyRangeLocationInfo> locations =
+		    wait(getKeyRangeLocations(cx,
+		                              tenant,
+		                              range,
+		                              CLIENT_KNOBS->TOO_MANY,
+		                              Reverse::False,
+		                              &StorageServerInterface::watchRange,
+		                              span.context,
+		                              Optional<UID>(),
+		                              useProvisionalProxies,
+		                              ver));
+		try {
+			state std::vector<Future<WatchRangeReply>> replies;
+			state WatchRangeReply resp;
+			replies.clear();
+			for (const auto& location : locations) {
+				replies.push_back(loadBalance(cx.getPtr(),
+				                              location.locations,
+				                              &StorageServerInterface::watchRange,
+				                              WatchRangeRequest(span.context,
+				                                                tenant,
+				                                                location.range,
+				                                                ver,
+				                                                cx->sampleReadTags() ? tags : Optional<TagSet>(),
+				                                                Optional<UID>()),
+				                              TaskPriority::DefaultPromiseEndpoint));
+			}
+			choose {
+				when(wait(waitForAny(replies))) {}
+				when(wait(cx->connectionRecord ? cx->connectionRecord->onChange() : Never())) {
+					wait(Never());
+				}
+			}
+			for (const auto& reply : replies) {
+				if (reply.isReady()) {
+					resp = reply.get();
+					break;
+				}
+			}
+			replies.clear();
+
+			// As in watchValue(), a version far behind the committed version points to a recovery, which may have
+			// rolled back the change
+			Version v = wait(waitForCommittedVersion(cx, resp.version, span.context));
+			if (v - resp.version < 50'000'000) {
+				return resp.version;
+			}
+			ver = v;
+		} catch (Error& e) {
+			if (e.code() == error_code_wrong_shard_server || e.code() == error_code_all_alternatives_failed) {
+				cx->invalidateCache(tenant.prefix, range);
+				wait(delay(CLIENT_KNOBS->WRONG_SHARD_SERVER_DELAY, taskID));
+			} else if (e.code() == error_code_watch_cancelled || e.code() == error_code_process_behind) {
+				CODE_PROBE(e.code() == error_code_watch_cancelled, "Too many watches for a range watch, poll instead");
+				wait(delay(CLIENT_KNOBS->WATCH_POLLING_TIME, taskID));
+			} else if (e.code() == error_code_timed_out) {
+				CODE_PROBE(true, "A range watch timed out");
+				wait(delay(CLIENT_KNOBS->FUTURE_VERSION_RETRY_DELAY, taskID));
+			} else {
+				state Error err = e;
+				wait(delay(CLIENT_KNOBS->FUTURE_VERSION_RETRY_DELAY, taskID));
+				throw err;
+			}
+		}
+	}
+}
+
 ACTOR Future<Void> watchStorageServerResp(int64_t tenantId, Key key, Database cx) {
 	loop {
 		try {
@@ -4279,6 +4952,12 @@ void transformRangeLimits(GetRangeLimits limits, Reverse reverse, GetKeyValuesFa
 	}
 }
 
+// The compression range reads ask storage servers to use for large replies
+static CompressionFilter getRangeCompressionFilter() {
+	CompressionFilter filter = CompressionUtils::fromFilterString(CLIENT_KNOBS->GET_RANGE_COMPRESSION_FILTER);
+	return CompressionUtils::supportedFilters.count(filter) ? filter : CompressionFilter::NONE;
+}
+
 template <class GetKeyValuesFamilyRequest>
 PublicRequestStream<GetKeyValuesFamilyRequest> StorageServerInterface::*getRangeRequestStream() {
 	if constexpr (std::is_same<GetKeyValuesFamilyRequest, GetKeyValuesRequest>::value) {
@@ -4296,7 +4975,8 @@ Future<RangeResultFamily> getExactRange(Reference<TransactionState> trState,
                                         Key mapper,
                                         GetRangeLimits limits,
                                         Reverse reverse,
-                                        UseTenant useTenant) {
+                                        UseTenant useTenant,
+                                        Optional<KeyValueFilter> filter = Optional<KeyValueFilter>()) {
 	state RangeResultFamily output;
 	// TODO - ljoswiak parent or link?
 	state Span span("NAPI:getExactRange"_loc, trState->spanContext);
@@ -4345,6 +5025,13 @@ Future<RangeResultFamily> getExactRange(Reference<TransactionState> trState,
 			req.tags = trState->cx->sampleReadTags() ? trState->options.readTags : Optional<TagSet>();
 
 			req.options = trState->readOptions;
+			if constexpr (std::is_same_v<GetKeyValuesFamilyRequest, GetKeyValuesRequest>) {
+				req.compressionFilter = getRangeCompressionFilter();
+				if (filter.present()) {
+					req.filter = filter.get().contents();
+					req.arena.dependsOn(filter.get().arena());
+				}
+			}
 
 			try {
 				if (trState->readOptions.present() && trState->readOptions.get().debugID.present()) {
@@ -4389,6 +5076,32 @@ Future<RangeResultFamily> getExactRange(Reference<TransactionState> trState,
 					g_traceBatch.addEvent("TransactionDebug",
 					                      trState->readOptions.get().debugID.get().first(),
 					                      "NativeAPI.getExactRange.After");
+				if constexpr (std::is_same_v<GetKeyValuesFamilyReply, GetKeyValuesReply>) {
+					rep.decompress();
+				}
+				if (trState->cx->preferZoneLocalReads) {
+					trState->cx->recordReplicaRead(rep, replicaReadRowBytes(rep));
+				}
+				// The last key the storage server read, which the next request to this shard continues from
+				Optional<KeyRef> lastRead;
+				if (rep.data.size()) {
+					lastRead = rep.data.back().key;
+				}
+				if constexpr (std::is_same_v<GetKeyValuesFamilyReply, GetKeyValuesReply>) {
+					if (filter.present()) {
+						if (rep.readThrough.present()) {
+							lastRead = rep.readThrough;
+						}
+						// Storage servers that don't know about filters return every row
+						VectorRef<KeyValueRef> matching;
+						for (auto& kv : rep.data) {
+							if (filter.get().matches(kv)) {
+								matching.push_back(rep.arena, kv);
+							}
+						}
+						rep.data = matching;
+					}
+				}
 				output.arena().dependsOn(rep.arena);
 				output.append(output.arena(), rep.data.begin(), rep.data.size());
 
@@ -4407,12 +5120,11 @@ Future<RangeResultFamily> getExactRange(Reference<TransactionState> trState,
 
 				bool more = rep.more;
 				// If the reply says there is more but we know that we finished the shard, then fix rep.more
-				if (reverse && more && rep.data.size() > 0 &&
-				    output[output.size() - 1].key == locations[shard].range.begin)
+				if (reverse && more && lastRead.present() && lastRead.get() == locations[shard].range.begin)
 					more = false;
 
 				if (more) {
-					if (!rep.data.size()) {
+					if (!lastRead.present()) {
 						TraceEvent(SevError, "GetExactRangeError")
 						    .detail("Reason", "More data indicated but no rows present")
 						    .detail("LimitBytes", limits.bytes)
@@ -4424,13 +5136,11 @@ Future<RangeResultFamily> getExactRange(Reference<TransactionState> trState,
 						ASSERT(false);
 					}
 					CODE_PROBE(true, "GetKeyValuesFamilyReply.more in getExactRange");
-					// Make next request to the same shard with a beginning key just after the last key returned
+					// Make next request to the same shard with a beginning key just after the last key read
 					if (reverse)
-						locations[shard].range =
-						    KeyRangeRef(locations[shard].range.begin, output[output.size() - 1].key);
+						locations[shard].range = KeyRangeRef(locations[shard].range.begin, lastRead.get());
 					else
-						locations[shard].range =
-						    KeyRangeRef(keyAfter(output[output.size() - 1].key), locations[shard].range.end);
+						locations[shard].range = KeyRangeRef(keyAfter(lastRead.get()), locations[shard].range.end);
 				}
 
 				bool redoKeyLocationRequest = false;
@@ -4596,6 +5306,10 @@ void getRangeFinished(Reference<TransactionState> trState,
 	trState->cx->transactionBytesRead += bytes;
 	trState->cx->transactionKeysRead += result.size();
 
+	if (trState->profile) {
+		trState->profile->addRead(TransactionProfile::ReadType::GET_RANGE, startTime, now() - startTime, bytes);
+	}
+
 	if (trState->trLogInfo) {
 		trState->trLogInfo->addLog(FdbClientLogEvents::EventGetRange(startTime,
 		                                                             trState->cx->clientLocality.dcId(),
@@ -4738,6 +5452,9 @@ Future<RangeResultFamily> getRange(Reference<TransactionState> trState,
 
 			req.tags = trState->cx->sampleReadTags() ? trState->options.readTags : Optional<TagSet>();
 			req.spanContext = span.context;
+			if constexpr (std::is_same_v<GetKeyValuesFamilyRequest, GetKeyValuesRequest>) {
+				req.compressionFilter = getRangeCompressionFilter();
+			}
 			if (trState->readOptions.present() && trState->readOptions.get().debugID.present()) {
 				getRangeID = nondeterministicRandom()->randomUniqueID();
 				g_traceBatch.addAttach(
@@ -4805,6 +5522,12 @@ Future<RangeResultFamily> getRange(Reference<TransactionState> trState,
 					}*/
 				}
 
+				if constexpr (std::is_same_v<GetKeyValuesFamilyReply, GetKeyValuesReply>) {
+					rep.decompress();
+				}
+				if (trState->cx->preferZoneLocalReads) {
+					trState->cx->recordReplicaRead(rep, replicaReadRowBytes(rep));
+				}
 				ASSERT(!rep.more || rep.data.size());
 				ASSERT(!limits.hasRowLimit() || rep.data.size() <= limits.rows);
 
@@ -5499,6 +6222,248 @@ Future<RangeResult> getRange(Reference<TransactionState> const& trState,
 	    trState, begin, end, ""_sr, limits, Promise<std::pair<Key, Key>>(), Snapshot::True, reverse, useTenant);
 }
 
+// Reads `keys` from up to rangeReadParallelism shards at once, each with all of the remaining limits, and returns their
+// results in order. Stops at the first shard which couldn't be read entirely within the limits, so the result is the
+// same as getRange's except that it may go on through shard boundaries where getRange would have stopped.
+ACTOR Future<RangeResult> getRangeParallel(Reference<TransactionState> trState,
+                                           KeyRange keys,
+                                           GetRangeLimits limits,
+                                           Promise<std::pair<Key, Key>> conflictRange,
+                                           Snapshot snapshot,
+                                           Reverse reverse) {
+	state std::vector<KeyRangeLocationInfo> locations;
+	state std::vector<Future<RangeResult>> pieces;
+	state RangeResult output;
+	state RangeResult piece;
+	state int i = 0;
+
+	wait(trState->startTransaction());
+	wait(store(locations,
+	           getKeyRangeLocations(trState,
+	                                keys,
+	                                trState->options.rangeReadParallelism,
+	                                reverse,
+	                                &StorageServerInterface::getKeyValues,
+	                                UseTenant::True)));
+	if (locations.size() <= 1) {
+		RangeResult result =
+		    wait(getRange<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(trState,
+		                                                                       firstGreaterOrEqual(keys.begin),
+		                                                                       firstGreaterOrEqual(keys.end),
+		                                                                       ""_sr,
+		                                                                       limits,
+		                                                                       conflictRange,
+		                                                                       snapshot,
+		                                                                       reverse));
+		return result;
+	}
+
+	CODE_PROBE(true, "NativeAPI parallel range read");
+	for (const auto& location : locations) {
+		KeyRangeRef pieceRange = location.range & keys;
+		pieces.push_back(getRange(trState,
+		                          firstGreaterOrEqual(pieceRange.begin),
+		                          firstGreaterOrEqual(pieceRange.end),
+		                          limits,
+		                          reverse,
+		                          UseTenant::True));
+	}
+
+	for (; i < pieces.size(); i++) {
+		wait(store(piece, pieces[i]));
+		output.arena().dependsOn(piece.arena());
+
+		int rows = 0;
+		while (rows < piece.size() && !limits.isReached()) {
+			limits.decrement(piece[rows]);
+			rows++;
+		}
+		output.append(output.arena(), piece.begin(), rows);
+		if (rows < piece.size()) {
+			output.more = true;
+			break;
+		}
+
+		output.readToBegin = output.readToBegin || piece.readToBegin;
+		output.readThroughEnd = output.readThroughEnd || piece.readThroughEnd;
+		if (piece.more) {
+			output.more = true;
+			output.readThrough = piece.readThrough;
+			break;
+		}
+
+		KeyRangeRef pieceRange = locations[i].range & keys;
+		KeyRef boundary = reverse ? pieceRange.begin : pieceRange.end;
+		bool last = i + 1 == pieces.size();
+		if (last ? boundary != (reverse ? keys.begin : keys.end)
+		         : limits.isReached() || limits.hasSatisfiedMinRows()) {
+			output.more = true;
+			output.arena().dependsOn(locations[i].range.arena());
+			output.arena().dependsOn(keys.arena());
+			output.setReadThrough(boundary);
+			break;
+		}
+	}
+
+	if (!snapshot) {
+		if (reverse) {
+			conflictRange.send(std::make_pair(output.more ? output.getReadThrough(true) : keys.begin, keys.end));
+		} else {
+			conflictRange.send(std::make_pair(keys.begin, output.more ? output.getReadThrough() : keys.end));
+		}
+	}
+	return output;
+}
+
+ACTOR Future<RangeResult> getFilteredRange(Reference<TransactionState> trState,
+                                           KeyRange keys,
+                                           KeyValueFilter filter,
+                                           GetRangeLimits limits,
+                                           Promise<std::pair<Key, Key>> conflictRange,
+                                           Snapshot snapshot,
+                                           Reverse reverse) {
+	try {
+		wait(trState->startTransaction());
+		state RangeResult output = wait(getExactRange<GetKeyValuesRequest, GetKeyValuesReply, RangeResult>(
+		    trState, keys, ""_sr, limits, reverse, UseTenant::True, filter));
+
+		// The rest of the range is read from just past the last row returned
+		if (!snapshot) {
+			if (output.more && reverse) {
+				conflictRange.send(std::make_pair(Key(output.back().key, output.arena()), keys.end));
+			} else if (output.more) {
+				conflictRange.send(std::make_pair(keys.begin, keyAfter(output.back().key)));
+			} else {
+				conflictRange.send(std::make_pair(keys.begin, keys.end));
+			}
+		}
+		return output;
+	} catch (Error& e) {
+		if (conflictRange.canBeSet()) {
+			conflictRange.send(std::make_pair(Key(), Key()));
+		}
+		throw;
+	}
+}
+
+ACTOR Future<RangeAggregate> getRangeAggregate(Reference<TransactionState> trState,
+                                               KeyRange keys,
+                                               Optional<KeyValueFilter> filter);
+
+// Adds up the rows of one shard's part of a range, on its storage servers unless they predate aggregate reads
+ACTOR Future<RangeAggregate> getShardAggregate(Reference<TransactionState> trState,
+                                               KeyRangeLocationInfo location,
+                                               Optional<KeyValueFilter> filter) {
+	state RangeAggregate total;
+	state KeyRange range = location.range;
+	state Span span("NAPI:getShardAggregate"_loc, trState->spanContext);
+	loop {
+		state GetKeyValuesRequest req;
+		req.tenantInfo = trState->getTenantInfo();
+		req.version = trState->readVersion();
+		req.begin = firstGreaterOrEqual(range.begin);
+		req.end = firstGreaterOrEqual(range.end);
+		req.arena.dependsOn(range.arena());
+		req.limit = CLIENT_KNOBS->REPLY_BYTE_LIMIT;
+		req.limitBytes = CLIENT_KNOBS->REPLY_BYTE_LIMIT;
+		req.spanContext = span.context;
+		req.tags = trState->cx->sampleReadTags() ? trState->options.readTags : Optional<TagSet>();
+		req.options = trState->readOptions;
+		req.compressionFilter = getRangeCompressionFilter();
+		req.aggregate = true;
+		if (filter.present()) {
+			req.filter = filter.get().contents();
+			req.arena.dependsOn(filter.get().arena());
+		}
+		trState->cx->getLatestCommitVersions(location.locations, trState, req.ssLatestCommitVersions);
+
+		try {
+			++trState->cx->transactionPhysicalReads;
+			state GetKeyValuesReply rep;
+			try {
+				wait(store(rep,
+				           loadBalance(trState->cx.getPtr(),
+				                       location.locations,
+				                       &StorageServerInterface::getKeyValues,
+				                       req,
+				                       TaskPriority::DefaultPromiseEndpoint,
+				                       AtMostOnce::False,
+				                       trState->cx->enableLocalityLoadBalance ? &trState->cx->queueModel : nullptr)));
+				++trState->cx->transactionPhysicalReadsCompleted;
+			} catch (Error&) {
+				++trState->cx->transactionPhysicalReadsCompleted;
+				throw;
+			}
+
+			rep.decompress();
+			if (rep.aggregate.present()) {
+				total.merge(rep.aggregate.get());
+			} else {
+				CODE_PROBE(true, "Aggregate read of a storage server that returned rows");
+				for (auto& kv : rep.data) {
+					if (!filter.present() || filter.get().matches(kv)) {
+						total.add(kv);
+					}
+				}
+			}
+			if (!rep.more) {
+				return total;
+			}
+			ASSERT(rep.readThrough.present() || rep.data.size());
+			range = KeyRangeRef(keyAfter(rep.readThrough.present() ? rep.readThrough.get() : rep.data.back().key),
+			                    range.end);
+			if (range.empty()) {
+				return total;
+			}
+		} catch (Error& e) {
+			if (e.code() != error_code_wrong_shard_server && e.code() != error_code_all_alternatives_failed) {
+				throw;
+			}
+			// The shard has moved, so find the servers for what is left of it again
+			trState->cx->invalidateCache(trState->tenant().mapRef(&Tenant::prefix), range);
+			wait(delay(CLIENT_KNOBS->WRONG_SHARD_SERVER_DELAY, trState->taskID));
+			RangeAggregate rest = wait(getRangeAggregate(trState, range, filter));
+			total.merge(rest);
+			return total;
+		}
+	}
+}
+
+// Adds up the rows of keys, or those of them that match filter, one batch of shards at a time with the shards in each
+// batch read in parallel
+ACTOR Future<RangeAggregate> getRangeAggregate(Reference<TransactionState> trState,
+                                               KeyRange keys,
+                                               Optional<KeyValueFilter> filter) {
+	state RangeAggregate total;
+	state std::vector<KeyRangeLocationInfo> locations;
+	state std::vector<Future<RangeAggregate>> shards;
+
+	wait(trState->startTransaction());
+	loop {
+		wait(store(locations,
+		           getKeyRangeLocations(trState,
+		                                keys,
+		                                CLIENT_KNOBS->GET_RANGE_SHARD_LIMIT,
+		                                Reverse::False,
+		                                &StorageServerInterface::getKeyValues,
+		                                UseTenant::True)));
+		shards.clear();
+		for (const auto& location : locations) {
+			shards.push_back(getShardAggregate(trState, location, filter));
+		}
+		wait(waitForAll(shards));
+		for (const auto& shard : shards) {
+			total.merge(shard.get());
+		}
+
+		KeyRef end = locations.back().range.end;
+		if (end >= keys.end) {
+			return total;
+		}
+		keys = KeyRangeRef(end, keys.end);
+	}
+}
+
 bool DatabaseContext::debugUseTags = false;
 const std::vector<std::string> DatabaseContext::debugTransactionTagChoices = { "a", "b", "c", "d", "e", "f", "g",
 	                                                                           "h", "i", "j", "k", "l", "m", "n",
@@ -5561,6 +6526,13 @@ void Transaction::operator=(Transaction&& r) noexcept {
 void Transaction::flushTrLogsIfEnabled() {
 	if (trState && trState->trLogInfo && trState->trLogInfo->logsAdded && trState->trLogInfo->trLogWriter.getData()) {
 		ASSERT(trState->trLogInfo->flushed == false);
+		if (trState->trLogInfo->logLocation & TransactionLogInfo::CAPTURE) {
+			trState->cx->captureTransaction(trState->trLogInfo->trLogWriter.toValue());
+		}
+		if (!(trState->trLogInfo->logLocation & TransactionLogInfo::DATABASE)) {
+			trState->trLogInfo->flushed = true;
+			return;
+		}
 		trState->cx->clientStatusUpdater.inStatusQ.push_back(
 		    { trState->trLogInfo->identifier, std::move(trState->trLogInfo->trLogWriter) });
 		trState->trLogInfo->flushed = true;
@@ -5642,6 +6614,104 @@ Future<Optional<Value>> Transaction::get(const Key& key, Snapshot snapshot) {
 	return getValue(trState, key, useTenant);
 }
 
+ACTOR static Future<std::vector<Optional<Value>>> mergeMultiGet(std::vector<Future<Optional<Value>>> singles,
+                                                                 std::vector<int> singleIndices,
+                                                                 Future<std::vector<Optional<Value>>> batched,
+                                                                 std::vector<int> batchedIndices,
+                                                                 int count) {
+	state std::vector<Optional<Value>> results(count);
+	std::vector<Optional<Value>> values = wait(batched);
+	for (int i = 0; i < values.size(); i++) {
+		results[batchedIndices[i]] = std::move(values[i]);
+	}
+	wait(waitForAll(singles));
+	for (int i = 0; i < singles.size(); i++) {
+		results[singleIndices[i]] = singles[i].get();
+	}
+	return results;
+}
+
+ACTOR Future<RangeResult> getMultiFromValues(Standalone<VectorRef<KeyRef>> keys,
+                                             std::vector<Future<Optional<Value>>> values) {
+	wait(waitForAll(values));
+	RangeResult result;
+	result.arena().dependsOn(keys.arena());
+	for (int i = 0; i < keys.size(); i++) {
+		if (values[i].get().present()) {
+			result.arena().dependsOn(values[i].get().get().arena());
+			result.push_back(result.arena(), KeyValueRef(keys[i], values[i].get().get()));
+		}
+	}
+	return result;
+}
+
+ACTOR Future<Void> getRangeStreamFromPages(
+    PromiseStream<RangeResult> results,
+    std::function<Future<RangeResult>(KeySelector const&, KeySelector const&)> getPage,
+    KeySelector begin,
+    KeySelector end) {
+	try {
+		loop {
+			state RangeResult page = wait(getPage(begin, end));
+			if (!page.more) {
+				if (!page.empty()) {
+					page.more = true;
+					results.send(page);
+				}
+				results.sendError(end_of_stream());
+				return Void();
+			}
+
+			begin = KeySelector(page.nextBeginKeySelector(), page.arena());
+			if (!page.empty()) {
+				results.send(page);
+				wait(results.onEmpty());
+			}
+		}
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		results.sendError(e);
+	}
+	return Void();
+}
+
+Future<std::vector<Optional<Value>>> Transaction::getMulti(Standalone<VectorRef<KeyRef>> const& keys,
+                                                          Snapshot snapshot) {
+	std::vector<Future<Optional<Value>>> singles;
+	std::vector<int> singleIndices;
+	Standalone<VectorRef<KeyRef>> batchedKeys;
+	std::vector<int> batchedIndices;
+	batchedKeys.arena().dependsOn(keys.arena());
+
+	for (int i = 0; i < keys.size(); i++) {
+		const KeyRef& key = keys[i];
+		if (key == metadataVersionKey) {
+			// Served from the metadata version cache where possible
+			singles.push_back(get(key, snapshot));
+			singleIndices.push_back(i);
+			continue;
+		}
+
+		++trState->cx->transactionLogicalReads;
+		++trState->cx->transactionGetValueRequests;
+		// There are no keys in the database with size greater than the max key size
+		if (key.size() > getMaxReadKeySize(key)) {
+			continue;
+		}
+		if (!snapshot)
+			tr.transaction.read_conflict_ranges.push_back(tr.arena, singleKeyRange(key, tr.arena));
+		batchedKeys.push_back(batchedKeys.arena(), key);
+		batchedIndices.push_back(i);
+	}
+
+	Future<std::vector<Optional<Value>>> batched = std::vector<Optional<Value>>();
+	if (!batchedKeys.empty())
+		batched = getValues(trState, batchedKeys, UseTenant::True);
+	return mergeMultiGet(singles, singleIndices, batched, batchedIndices, keys.size());
+}
+
 void Watch::setWatch(Future<Void> watchFuture) {
 	this->watchFuture = watchFuture;
 
@@ -5763,6 +6833,34 @@ Future<Void> Transaction::watch(Reference<Watch> watch) {
 	               trState->useProvisionalProxies);
 }
 
+ACTOR Future<Void> watchRange(Reference<TransactionState> trState, KeyRange range) {
+	try {
+		wait(trState->startTransaction());
+		CODE_PROBE(trState->hasTenant(), "NativeAPI watchRange has tenant");
+		wait(success(watchRangeValue(trState->cx,
+		                             trState->getTenantInfo(),
+		                             range,
+		                             trState->readVersion(),
+		                             trState->options.readTags,
+		                             trState->spanContext,
+		                             trState->taskID,
+		                             trState->useProvisionalProxies)));
+	} catch (Error& e) {
+		trState->cx->decreaseWatchCounter();
+		throw;
+	}
+
+	trState->cx->decreaseWatchCounter();
+	return Void();
+}
+
+Future<Void> Transaction::watchRange(KeyRange const& range) {
+	++trState->cx->transactionWatchRequests;
+
+	trState->cx->increaseWatchCounter();
+	return ::watchRange(trState, range);
+}
+
 ACTOR Future<Standalone<VectorRef<const char*>>> getAddressesForKeyActor(Reference<TransactionState> trState, Key key) {
 	state std::vector<StorageServerInterface> ssi;
 
@@ -5903,6 +7001,14 @@ Future<RangeResultFamily> Transaction::getRangeInternal(const KeySelector& begin
 		extraConflictRanges.push_back(conflictRange.getFuture());
 	}
 
+	if constexpr (std::is_same_v<GetKeyValuesFamilyRequest, GetKeyValuesRequest>) {
+		if (trState->options.rangeReadParallelism > 1 && b.isFirstGreaterOrEqual() && e.isFirstGreaterOrEqual() &&
+		    b.getKey() < e.getKey() && e.getKey() <= allKeys.end) {
+			return ::getRangeParallel(
+			    trState, KeyRangeRef(b.getKey(), e.getKey()), limits, conflictRange, snapshot, reverse);
+		}
+	}
+
 	return ::getRange<GetKeyValuesFamilyRequest, GetKeyValuesFamilyReply, RangeResultFamily>(
 	    trState, b, e, mapper, limits, conflictRange, snapshot, reverse);
 }
@@ -5934,6 +7040,43 @@ Future<RangeResult> Transaction::getRange(const KeySelector& begin,
 	return getRange(begin, end, GetRangeLimits(limit), snapshot, reverse);
 }
 
+Future<RangeResult> Transaction::getFilteredRange(const KeyRange& keys,
+                                                  const KeyValueFilter& filter,
+                                                  GetRangeLimits limits,
+                                                  Snapshot snapshot,
+                                                  Reverse reverse) {
+	++trState->cx->transactionLogicalReads;
+	++trState->cx->transactionGetRangeRequests;
+
+	if (limits.isReached() || keys.empty())
+		return RangeResult();
+
+	if (!limits.isValid())
+		return range_limits_invalid();
+
+	Promise<std::pair<Key, Key>> conflictRange;
+	if (!snapshot) {
+		extraConflictRanges.push_back(conflictRange.getFuture());
+	}
+	return ::getFilteredRange(trState, keys, filter, limits, conflictRange, snapshot, reverse);
+}
+
+Future<RangeAggregate> Transaction::getRangeAggregate(const KeyRange& keys,
+                                                     const Optional<KeyValueFilter>& filter,
+                                                     Snapshot snapshot) {
+	++trState->cx->transactionLogicalReads;
+	++trState->cx->transactionGetRangeRequests;
+
+	if (keys.empty())
+		return RangeAggregate();
+
+	// Every row of keys is read, so the whole range conflicts
+	if (!snapshot) {
+		tr.transaction.read_conflict_ranges.push_back_deep(tr.arena, keys);
+	}
+	return ::getRangeAggregate(trState, keys, filter);
+}
+
 // A method for streaming data from the storage server that is more efficient than getRange when reading large amounts
 // of data
 Future<Void> Transaction::getRangeStream(PromiseStream<RangeResult>& results,
@@ -6044,8 +7187,12 @@ void Transaction::atomicOp(const KeyRef& key,
 	++trState->cx->transactionAtomicMutations;
 	if (key.size() > getMaxWriteKeySize(key, trState->options.rawAccess))
 		throw key_too_large();
-	if (operand.size() > CLIENT_KNOBS->VALUE_SIZE_LIMIT)
+	int keysWritten = 1;
+	if (operationType == MutationRef::SetVersionstampedKeys) {
+		keysWritten = validateVersionstampedKeys(key, operand);
+	} else if (operand.size() > CLIENT_KNOBS->VALUE_SIZE_LIMIT) {
 		throw value_too_large();
+	}
 
 	if (apiVersionAtLeast(510)) {
 		if (operationType == MutationRef::Min)
@@ -6060,9 +7207,11 @@ void Transaction::atomicOp(const KeyRef& key,
 	auto v = ValueRef(req.arena, operand);
 
 	t.mutations.emplace_back(req.arena, operationType, r.begin, v);
-	trState->totalCost += getWriteOperationCost(key.expectedSize());
+	trState->totalCost += keysWritten * getWriteOperationCost(key.expectedSize());
 
-	if (addConflictRange && operationType != MutationRef::SetVersionstampedKey)
+	// The commit proxy adds the conflict ranges of versionstamped keys, once it knows what they are
+	if (addConflictRange && operationType != MutationRef::SetVersionstampedKey &&
+	    operationType != MutationRef::SetVersionstampedKeys)
 		t.write_conflict_ranges.push_back(req.arena, r);
 
 	CODE_PROBE(true, "NativeAPI atomic operation");
@@ -6191,6 +7340,9 @@ TransactionOptions::TransactionOptions(Database const& cx) {
 	if (BUGGIFY) {
 		commitOnFirstProxy = true;
 	}
+	if (BUGGIFY) {
+		rangeReadParallelism = deterministicRandom()->randomInt(2, 10);
+	}
 }
 
 void TransactionOptions::clear() {
@@ -6217,6 +7369,8 @@ void TransactionOptions::clear() {
 	bypassStorageQuota = false;
 	enableReplicaConsistencyCheck = false;
 	requiredReplicas = 0;
+	rangeReadParallelism = 0;
+	maxGrvCacheStaleness.reset();
 }
 
 TransactionOptions::TransactionOptions() {
@@ -6598,7 +7752,7 @@ void applyTenantPrefix(CommitTransactionRequest& req, Key tenantPrefix) {
 			param1 = m.param1.withPrefix(tenantPrefix, req.arena);
 			if (m.type == MutationRef::ClearRange) {
 				param2 = m.param2.withPrefix(tenantPrefix, req.arena);
-			} else if (m.type == MutationRef::SetVersionstampedKey) {
+			} else if (m.type == MutationRef::SetVersionstampedKey || m.type == MutationRef::SetVersionstampedKeys) {
 				uint8_t* key = mutateString(param1);
 				int* offset = reinterpret_cast<int*>(&key[param1.size() - 4]);
 				*offset += tenantPrefix.size();
@@ -6752,6 +7906,9 @@ ACTOR static Future<Void> tryCommit(Reference<TransactionState> trState, CommitT
 
 					double latency = now() - startTime;
 					trState->cx->commitLatencies.addSample(latency);
+					if (trState->profile) {
+						trState->profile->commitLatency = latency;
+					}
 					trState->cx->latencies.addSample(now() - trState->startTime);
 					if (trState->trLogInfo)
 						trState->trLogInfo->addLog(
@@ -6938,6 +8095,10 @@ Future<Void> Transaction::commitMutations() {
 			    tr.arena, tr.transaction.write_conflict_ranges.begin(), tr.transaction.write_conflict_ranges.size());
 		}
 
+		if (CLIENT_KNOBS->COMPACT_COMMIT_REQUESTS) {
+			tr.transaction.compact(tr.arena);
+		}
+
 		if (trState->options.debugDump) {
 			UID u = nondeterministicRandom()->randomUniqueID();
 			TraceEvent("TransactionDump", u).log();
@@ -7233,6 +8394,18 @@ void Transaction::setOption(FDBTransactionOptions::Option option, Optional<Strin
 		validateOptionValueNotPresent(value);
 		trState->options.skipGrvCache = true;
 		break;
+
+	case FDBTransactionOptions::MAX_GRV_CACHE_STALENESS: {
+		double staleness = extractIntOption(value, 0, std::numeric_limits<int>::max()) / 1000.0;
+		if (apiVersionAtLeast(ApiVersion::withGrvCache().version()) && !trState->cx->sharedStatePtr) {
+			throw invalid_option();
+		}
+		// Like USE_GRV_CACHE, a retried transaction gets a fresh read version
+		if (trState->numErrors == 0) {
+			trState->options.maxGrvCacheStaleness = staleness;
+		}
+		break;
+	}
 	case FDBTransactionOptions::READ_SYSTEM_KEYS:
 	case FDBTransactionOptions::ACCESS_SYSTEM_KEYS:
 	case FDBTransactionOptions::RAW_ACCESS:
@@ -7300,6 +8473,12 @@ void Transaction::setOption(FDBTransactionOptions::Option option, Optional<Strin
 		trState->readOptions.withDefault(ReadOptions()).type = ReadType::HIGH;
 		break;
 
+	case FDBTransactionOptions::RANGE_READ_PARALLELISM:
+		validateOptionValuePresent(value);
+		trState->options.rangeReadParallelism =
+		    extractIntOption(value, 0, CLIENT_KNOBS->MAX_RANGE_READ_PARALLELISM);
+		break;
+
 	case FDBTransactionOptions::ENABLE_REPLICA_CONSISTENCY_CHECK:
 		validateOptionValueNotPresent(value);
 		trState->options.enableReplicaConsistencyCheck = true;
@@ -7501,6 +8680,9 @@ ACTOR Future<Version> extractReadVersion(Reference<TransactionState> trState,
 		trState->cx->lastRkDefaultThrottleTime = replyTime;
 	}
 	trState->cx->GRVLatencies.addSample(latency);
+	if (trState->profile) {
+		trState->profile->grvLatency = latency;
+	}
 	if (trState->trLogInfo)
 		trState->trLogInfo->addLog(FdbClientLogEvents::EventGetVersion_V3(trState->startTime,
 		                                                                  trState->cx->clientLocality.dcId(),
@@ -7588,7 +8770,8 @@ Future<Version> TransactionState::getReadVersion(uint32_t flags) {
 	ASSERT(!readVersionFuture.isValid());
 
 	if (!CLIENT_KNOBS->FORCE_GRV_CACHE_OFF && !options.skipGrvCache &&
-	    (deterministicRandom()->random01() <= CLIENT_KNOBS->DEBUG_USE_GRV_CACHE_CHANCE || options.useGrvCache) &&
+	    (deterministicRandom()->random01() <= CLIENT_KNOBS->DEBUG_USE_GRV_CACHE_CHANCE || options.useGrvCache ||
+	     options.maxGrvCacheStaleness.present()) &&
 	    rkThrottlingCooledDown(cx.getPtr(), options.priority)) {
 		// Upon our first request to use cached RVs, start the background updater
 		if (!cx->grvUpdateHandler.isValid()) {
@@ -7597,10 +8780,16 @@ Future<Version> TransactionState::getReadVersion(uint32_t flags) {
 		Version rv = cx->getCachedReadVersion();
 		double lastTime = cx->getLastGrvTime();
 		double requestTime = now();
-		if (requestTime - lastTime <= CLIENT_KNOBS->MAX_VERSION_CACHE_LAG && rv != Version(0)) {
+		double maxStaleness = CLIENT_KNOBS->MAX_VERSION_CACHE_LAG;
+		if (options.maxGrvCacheStaleness.present()) {
+			maxStaleness = std::min(maxStaleness, options.maxGrvCacheStaleness.get());
+		}
+		if (requestTime - lastTime <= maxStaleness && rv != Version(0)) {
 			ASSERT(!debug_checkVersionTime(rv, requestTime, "CheckStaleness"));
+			++cx->transactionGrvCacheHits;
 			return rv;
 		} // else go through regular GRV path
+		++cx->transactionGrvCacheMisses;
 	}
 	++cx->transactionReadVersions;
 	flags |= options.getReadVersionFlags;
@@ -7826,6 +9015,9 @@ Future<Void> Transaction::onError(Error const& e) {
 	if (e.code() == error_code_success) {
 		return client_invalid_operation();
 	}
+	if (trState->profile) {
+		trState->profile->errorCode = e.code();
+	}
 	if (e.code() == error_code_not_committed || e.code() == error_code_commit_unknown_result ||
 	    e.code() == error_code_database_locked || e.code() == error_code_commit_proxy_memory_limit_exceeded ||
 	    e.code() == error_code_grv_proxy_memory_limit_exceeded || e.code() == error_code_process_behind ||
@@ -9079,10 +10271,18 @@ Reference<TransactionLogInfo> Transaction::createTrLogInfoProbabilistically(cons
 		double sampleRate =
 		    cx->globalConfig->get<double>(fdbClientInfoTxnSampleRate, std::numeric_limits<double>::infinity());
 		double clientSamplingProbability = std::isinf(sampleRate) ? CLIENT_KNOBS->CSI_SAMPLING_PROBABILITY : sampleRate;
+		int location = TransactionLogInfo::DONT_LOG;
 		if (((networkOptions.logClientInfo.present() && networkOptions.logClientInfo.get()) || BUGGIFY) &&
 		    deterministicRandom()->random01() < clientSamplingProbability &&
 		    (!g_network->isSimulated() || !g_simulator->speedUpSimulation)) {
-			return makeReference<TransactionLogInfo>(TransactionLogInfo::DATABASE);
+			location |= TransactionLogInfo::DATABASE;
+		}
+		if (!cx->transactionCaptureFile.empty() &&
+		    deterministicRandom()->random01() < CLIENT_KNOBS->TRANSACTION_CAPTURE_SAMPLING_PROBABILITY) {
+			location |= TransactionLogInfo::CAPTURE;
+		}
+		if (location != TransactionLogInfo::DONT_LOG) {
+			return makeReference<TransactionLogInfo>((TransactionLogInfo::LoggingLocation)location);
 		}
 	}
 
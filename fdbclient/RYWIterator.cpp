@@ -821,3 +821,110 @@ TEST_CASE("/fdbclient/WriteMap/random") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbclient/WriteMap/blindWriteLog") {
+	Arena arena = Arena();
+	BlindWriteLog log;
+	std::vector<BlindWriteLog::Entry> made;
+
+	for (int i = 0; i < 200; i++) {
+		bool addConflict = deterministicRandom()->random01() < 0.5;
+		KeyRef key = RandomTestImpl::getKeyForIndex(arena, deterministicRandom()->randomInt(0, 10));
+		ValueRef value = RandomTestImpl::getRandomValue(arena);
+		int r = deterministicRandom()->randomInt(0, 4);
+		if (r == 0) {
+			log.clear(key, addConflict);
+			made.push_back(BlindWriteLog::Entry{ key, ValueRef(), MutationRef::ClearRange, addConflict });
+		} else {
+			MutationRef::Type type = r == 1 ? MutationRef::SetValue : r == 2 ? MutationRef::AddValue : MutationRef::Xor;
+			log.mutate(key, type, value, addConflict);
+			made.push_back(BlindWriteLog::Entry{ key, value, type, addConflict });
+		}
+	}
+
+	// Applies writes on top of a value for every key that was written, as a commit would
+	auto apply = [&arena, &made](std::vector<BlindWriteLog::Entry> const& entries) {
+		std::map<KeyRef, Optional<ValueRef>> values;
+		for (const auto& w : made) {
+			values[w.key] = "initial"_sr;
+		}
+		std::set<KeyRef> conflicts;
+		for (const auto& w : entries) {
+			Optional<ValueRef>& value = values[w.key];
+			if (w.type == MutationRef::ClearRange) {
+				value = Optional<ValueRef>();
+			} else if (w.type == MutationRef::SetValue) {
+				value = w.param;
+			} else if (w.type == MutationRef::AddValue) {
+				value = doLittleEndianAdd(value, w.param, arena);
+			} else {
+				value = doXor(value, w.param, arena);
+			}
+			if (w.addConflict) {
+				conflicts.insert(w.key);
+			}
+		}
+		return std::make_pair(values, conflicts);
+	};
+
+	log.coalesce();
+	ASSERT_LE(log.getEntries().size(), made.size());
+	for (int i = 1; i < log.getEntries().size(); i++) {
+		ASSERT(log.getEntries()[i - 1].key <= log.getEntries()[i].key);
+	}
+	// What is left after coalescing must have the same effect and conflicts as all of the writes made
+	ASSERT(apply(log.getEntries()) == apply(made));
+
+	return Void();
+}
+
+TEST_CASE("/fdbclient/SnapshotCache/limit") {
+	Arena arena;
+	SnapshotCache cache(&arena);
+	cache.setValueBytesLimit(1000);
+	auto rangeFor = [&](int i) {
+		return KeyRangeRef(arena, KeyRangeRef(format("r%02d/a", i), format("r%02d/z", i)));
+	};
+
+	cache.insert(KeyRangeRef(arena, KeyRangeRef("empty/a"_sr, "empty/z"_sr)), VectorRef<KeyValueRef>(), Arena());
+	for (int i = 0; i < 20; i++) {
+		Standalone<VectorRef<KeyValueRef>> rows;
+		for (int j = 0; j < 2; j++) {
+			rows.push_back_deep(rows.arena(),
+			                    KeyValueRef(StringRef(format("r%02d/k%d", i, j)), StringRef(std::string(100, 'v'))));
+		}
+		cache.insert(rangeFor(i), rows, rows.arena());
+		ASSERT(cache.getValueBytes() <= 1000);
+
+		SnapshotCache::iterator it(&cache);
+		it.skip(StringRef(format("r%02d/k1", i)));
+		ASSERT(it.is_kv());
+		ASSERT(it.kv(arena)->value == StringRef(std::string(100, 'v')));
+
+		// Reading range 0 keeps it from being the least recently used
+		it.skip("r00/k0"_sr);
+		ASSERT(it.is_kv());
+	}
+
+	SnapshotCache::iterator it(&cache);
+	it.skip(StringRef(format("r%02d/k0", 1)));
+	ASSERT(it.is_unknown_range());
+	it.skip("empty/m"_sr);
+	ASSERT(it.is_empty_range());
+
+	// Ranges inserted before the limit is set are never dropped
+	SnapshotCache unlimited(&arena);
+	Standalone<VectorRef<KeyValueRef>> rows;
+	rows.push_back_deep(rows.arena(), KeyValueRef("r00/k0"_sr, "v"_sr));
+	unlimited.insert(rangeFor(0), rows, rows.arena());
+	unlimited.setValueBytesLimit(1);
+	Standalone<VectorRef<KeyValueRef>> limitedRows;
+	limitedRows.push_back_deep(limitedRows.arena(), KeyValueRef("r01/k0"_sr, "v"_sr));
+	unlimited.insert(rangeFor(1), limitedRows, limitedRows.arena());
+	ASSERT(unlimited.getValueBytes() == limitedRows.expectedSize());
+	SnapshotCache::iterator it2(&unlimited);
+	it2.skip("r00/k0"_sr);
+	ASSERT(it2.is_kv());
+
+	return Void();
+}
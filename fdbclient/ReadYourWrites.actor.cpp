@@ -114,8 +114,7 @@ public:
 			KeyRef k(ryw->arena, read.key);
 
 			if (res.present()) {
-				if (ryw->cache.insert(k, res.get()))
-					ryw->arena.dependsOn(res.get().arena());
+				ryw->cache.insert(k, res.get(), res.get().arena());
 				if (!dependent)
 					return res;
 			} else {
@@ -405,6 +404,62 @@ public:
 		return readWithConflictRangeRYW(ryw, req, snapshot);
 	}
 
+	// Reads the keys which are not yet known to the snapshot cache from the underlying transaction in one batch, and
+	// then resolves each key against the cache and the write map as get() would.
+	ACTOR static Future<RangeResult> getMulti(ReadYourWritesTransaction* ryw,
+	                                          Standalone<VectorRef<KeyRef>> keys,
+	                                          Snapshot snapshot) {
+		state std::vector<Future<Optional<Value>>> values;
+		if (ryw->options.readYourWritesDisabled) {
+			std::vector<Optional<Value>> fetched = wait(ryw->tr.getMulti(keys, snapshot));
+			for (auto& value : fetched) {
+				values.push_back(std::move(value));
+			}
+			RangeResult result = wait(getMultiFromValues(keys, values));
+			return result;
+		}
+
+		state Standalone<VectorRef<KeyRef>> unknown;
+		unknown.arena().dependsOn(keys.arena());
+		{
+			SnapshotCache::iterator it(&ryw->cache, &ryw->writes);
+			for (const auto& key : keys) {
+				if (key == metadataVersionKey || key.size() > getMaxReadKeySize(key)) {
+					continue;
+				}
+				it.skip(key);
+				if (it.is_unknown_range()) {
+					unknown.push_back(unknown.arena(), key);
+				}
+			}
+		}
+
+		if (!unknown.empty()) {
+			choose {
+				when(std::vector<Optional<Value>> prefetched = wait(ryw->tr.getMulti(unknown, Snapshot::True))) {
+					for (int i = 0; i < unknown.size(); i++) {
+						KeyRef k(ryw->arena, unknown[i]);
+						if (prefetched[i].present()) {
+							ryw->cache.insert(k, prefetched[i].get(), prefetched[i].get().arena());
+						} else {
+							ryw->cache.insert(k, Optional<ValueRef>());
+						}
+					}
+				}
+				when(wait(ryw->resetPromise.getFuture())) {
+					throw internal_error();
+				}
+			}
+		}
+
+		// Every key is now known to the cache, so these complete without further reads (and add conflict ranges)
+		for (const auto& key : keys) {
+			values.push_back(ryw->get(Key(key, keys.arena()), snapshot));
+		}
+		RangeResult result = wait(getMultiFromValues(keys, values));
+		return result;
+	}
+
 	template <class Iter>
 	static void resolveKeySelectorFromCache(KeySelector& key,
 	                                        Iter& it,
@@ -761,8 +816,7 @@ public:
 
 				//TraceEvent("RYWCacheInsert", randomID).detail("Range", range).detail("ExpectedSize", snapshot_read.expectedSize()).detail("Rows", snapshot_read.size()).detail("Results", snapshot_read).detail("More", snapshot_read.more).detail("ReadToBegin", snapshot_read.readToBegin).detail("ReadThroughEnd", snapshot_read.readThroughEnd).detail("ReadThrough", snapshot_read.readThrough);
 
-				if (ryw->cache.insert(range, snapshot_read))
-					ryw->arena.dependsOn(snapshot_read.arena());
+				ryw->cache.insert(range, snapshot_read, snapshot_read.arena());
 
 				// TODO: Is there a more efficient way to deal with invalidation?
 				resolveKeySelectorFromCache(
@@ -789,7 +843,10 @@ public:
 				itemsPastEnd += maxCount - count;
 
 				//TraceEvent("RYWaddKV", randomID).detail("Key", it.beginKey()).detail("Count", count).detail("MaxCount", maxCount).detail("ItemsPastEnd", itemsPastEnd);
-				if (count)
+				// A limited cache may drop these values before the result is returned, so they are copied
+				if (count && ryw->cache.isLimited())
+					result.append_deep(result.arena(), start, count);
+				else if (count)
 					result.append(result.arena(), start, count);
 				++it;
 			} else
@@ -1065,14 +1122,14 @@ public:
 
 				//TraceEvent("RYWCacheInsert", randomID).detail("Range", range).detail("ExpectedSize", snapshot_read.expectedSize()).detail("Rows", snapshot_read.size()).detail("Results", snapshot_read).detail("More", snapshot_read.more).detail("ReadToBegin", snapshot_read.readToBegin).detail("ReadThroughEnd", snapshot_read.readThroughEnd).detail("ReadThrough", snapshot_read.readThrough);
 
-				RangeResultRef reversed;
-				reversed.resize(ryw->arena, snapshot_read.size());
+				RangeResult reversed;
+				reversed.arena().dependsOn(snapshot_read.arena());
+				reversed.resize(reversed.arena(), snapshot_read.size());
 				for (int i = 0; i < snapshot_read.size(); i++) {
 					reversed[snapshot_read.size() - i - 1] = snapshot_read[i];
 				}
 
-				if (ryw->cache.insert(range, reversed))
-					ryw->arena.dependsOn(snapshot_read.arena());
+				ryw->cache.insert(range, reversed, reversed.arena());
 
 				// TODO: Is there a more efficient way to deal with invalidation?
 				resolveKeySelectorFromCache(
@@ -1098,7 +1155,9 @@ public:
 						int size = result.size();
 						result.resize(result.arena(), size + count);
 						for (int i = 0; i < count; i++) {
-							result[size + i] = start[maxCount - i - 1];
+							result[size + i] = ryw->cache.isLimited()
+							                       ? KeyValueRef(result.arena(), start[maxCount - i - 1])
+							                       : start[maxCount - i - 1];
 						}
 					}
 				}
@@ -1389,7 +1448,11 @@ public:
 				return Void();
 			}
 
-			ryw->writeRangeToNativeTransaction(KeyRangeRef(StringRef(), allKeys.end));
+			if (ryw->logBlindWrites) {
+				ryw->writeBlindWritesToNativeTransaction();
+			} else {
+				ryw->writeRangeToNativeTransaction(KeyRangeRef(StringRef(), allKeys.end));
+			}
 
 			auto conflictRanges = ryw->readConflicts.ranges();
 			for (auto iter = conflictRanges.begin(); iter != conflictRanges.end(); ++iter) {
@@ -1548,8 +1611,9 @@ public:
 };
 
 ReadYourWritesTransaction::ReadYourWritesTransaction(Database const& cx, Optional<Reference<Tenant>> const& tenant)
-  : ISingleThreadTransaction(cx->deferredError), tr(cx, tenant), cache(&arena), writes(&arena), retries(0),
-    approximateSize(0), creationTime(now()), commitStarted(false), versionStampFuture(tr.getVersionstamp()),
+  : ISingleThreadTransaction(cx->deferredError), tr(cx, tenant), cache(&arena), writes(&arena),
+    logBlindWrites(CLIENT_KNOBS->RYW_LOG_BLIND_WRITES), retries(0), approximateSize(0), creationTime(now()),
+    commitStarted(false), versionStampFuture(tr.getVersionstamp()),
     specialKeySpaceWriteMap(std::make_pair(false, Optional<Value>()), specialKeys.end), options(tr) {
 	std::copy(
 	    cx.getTransactionDefaults().begin(), cx.getTransactionDefaults().end(), std::back_inserter(persistentOptions));
@@ -1630,6 +1694,7 @@ ACTOR Future<RangeResult> getWorkerInterfaces(Reference<IClusterConnectionRecord
 
 Future<Optional<Value>> ReadYourWritesTransaction::get(const Key& key, Snapshot snapshot) {
 	CODE_PROBE(true, "ReadYourWritesTransaction::get");
+	useWriteMap();
 
 	if (getDatabase()->apiVersionAtLeast(630)) {
 		if (specialKeys.contains(key)) {
@@ -1692,7 +1757,34 @@ Future<Optional<Value>> ReadYourWritesTransaction::get(const Key& key, Snapshot
 	return result;
 }
 
+Future<RangeResult> ReadYourWritesTransaction::getMulti(Standalone<VectorRef<KeyRef>> const& keys, Snapshot snapshot) {
+	CODE_PROBE(true, "ReadYourWritesTransaction::getMulti");
+	useWriteMap();
+
+	if (checkUsedDuringCommit()) {
+		return used_during_commit();
+	}
+
+	if (resetPromise.isSet())
+		return resetPromise.getFuture().getError();
+
+	for (const auto& key : keys) {
+		if (key >= getMaxReadKey() && key != metadataVersionKey) {
+			if (specialKeys.contains(key) || !getDatabase()->apiVersionAtLeast(630)) {
+				// Special keys are served one at a time by the special key space
+				return ISingleThreadTransaction::getMulti(keys, snapshot);
+			}
+			return key_outside_legal_range();
+		}
+	}
+
+	Future<RangeResult> result = RYWImpl::getMulti(this, keys, snapshot);
+	reading.add(success(result));
+	return result;
+}
+
 Future<Key> ReadYourWritesTransaction::getKey(const KeySelector& key, Snapshot snapshot) {
+	useWriteMap();
 	if (checkUsedDuringCommit()) {
 		return used_during_commit();
 	}
@@ -1713,6 +1805,7 @@ Future<RangeResult> ReadYourWritesTransaction::getRange(KeySelector begin,
                                                         GetRangeLimits limits,
                                                         Snapshot snapshot,
                                                         Reverse reverse) {
+	useWriteMap();
 	if (getDatabase()->apiVersionAtLeast(630)) {
 		if (specialKeys.contains(begin.getKey()) && specialKeys.begin <= end.getKey() &&
 		    end.getKey() <= specialKeys.end) {
@@ -1782,6 +1875,7 @@ Future<MappedRangeResult> ReadYourWritesTransaction::getMappedRange(KeySelector
                                                                     GetRangeLimits limits,
                                                                     Snapshot snapshot,
                                                                     Reverse reverse) {
+	useWriteMap();
 	if (getDatabase()->apiVersionAtLeast(630)) {
 		if (specialKeys.contains(begin.getKey()) && specialKeys.begin <= end.getKey() &&
 		    end.getKey() <= specialKeys.end) {
@@ -1834,6 +1928,39 @@ Future<MappedRangeResult> ReadYourWritesTransaction::getMappedRange(KeySelector
 	return result;
 }
 
+Future<Void> ReadYourWritesTransaction::getRangeStream(PromiseStream<RangeResult>& results,
+                                                       KeySelector const& begin,
+                                                       KeySelector const& end,
+                                                       Snapshot snapshot) {
+	useWriteMap();
+	if (checkUsedDuringCommit()) {
+		return used_during_commit();
+	}
+
+	if (resetPromise.isSet())
+		return resetPromise.getFuture().getError();
+
+	// The storage servers' stream knows nothing of this transaction's writes, so it is only used for key ranges which
+	// haven't been written. Other ranges are read a page at a time through the write map.
+	bool useStorageStream = begin.isFirstGreaterOrEqual() && end.isFirstGreaterOrEqual() &&
+	                        begin.getKey() < end.getKey() && end.getKey() <= getMaxReadKey();
+	if (useStorageStream && !options.readYourWritesDisabled) {
+		WriteMap::iterator it(&writes);
+		for (it.skip(begin.getKey()); it.beginKey() < end.getKey(); ++it) {
+			if (!it.is_unmodified_range()) {
+				useStorageStream = false;
+				break;
+			}
+		}
+	}
+
+	if (!useStorageStream) {
+		return ISingleThreadTransaction::getRangeStream(results, begin, end, snapshot);
+	}
+	CODE_PROBE(true, "RYW range stream read from the storage servers");
+	return tr.getRangeStream(results, begin, end, GetRangeLimits(), snapshot);
+}
+
 Future<Standalone<VectorRef<const char*>>> ReadYourWritesTransaction::getAddressesForKey(const Key& key) {
 	if (checkUsedDuringCommit()) {
 		return used_during_commit();
@@ -1943,6 +2070,7 @@ void ReadYourWritesTransaction::addGranuleMaterializeStats(const GranuleMaterial
 }
 
 void ReadYourWritesTransaction::addReadConflictRange(KeyRangeRef const& keys) {
+	useWriteMap();
 	if (checkUsedDuringCommit()) {
 		throw used_during_commit();
 	}
@@ -2071,6 +2199,44 @@ void ReadYourWritesTransaction::writeRangeToNativeTransaction(KeyRangeRef const&
 	}
 }
 
+void ReadYourWritesTransaction::writeBlindWritesToNativeTransaction() {
+	blindWrites.coalesce();
+	for (const auto& w : blindWrites.getEntries()) {
+		if (w.addConflict) {
+			tr.addWriteConflictRange(singleKeyRange(w.key, arena));
+		}
+		if (w.type == MutationRef::SetValue) {
+			tr.set(w.key, w.param, AddConflictRange::False);
+		} else if (w.type == MutationRef::ClearRange) {
+			tr.clear(w.key, AddConflictRange::False);
+		} else {
+			tr.atomicOp(w.key, w.param, w.type, AddConflictRange::False);
+		}
+	}
+	for (const auto& range : blindWrites.getConflictRanges()) {
+		tr.addWriteConflictRange(range);
+	}
+}
+
+void ReadYourWritesTransaction::useWriteMap() {
+	if (!logBlindWrites) {
+		return;
+	}
+	logBlindWrites = false;
+	CODE_PROBE(!blindWrites.empty(), "Logged blind writes moved into the write map");
+	for (const auto& w : blindWrites.getEntries()) {
+		if (w.type == MutationRef::ClearRange) {
+			writes.clear(singleKeyRange(w.key, arena), w.addConflict);
+		} else {
+			writes.mutate(w.key, w.type, w.param, w.addConflict);
+		}
+	}
+	for (const auto& range : blindWrites.getConflictRanges()) {
+		writes.addConflictRange(range);
+	}
+	blindWrites = BlindWriteLog();
+}
+
 ReadYourWritesTransactionOptions::ReadYourWritesTransactionOptions(Transaction const& tr) {
 	reset(tr);
 }
@@ -2089,6 +2255,7 @@ bool ReadYourWritesTransactionOptions::getAndResetWriteConflictDisabled() {
 }
 
 void ReadYourWritesTransaction::getWriteConflicts(KeyRangeMap<bool>* result) {
+	useWriteMap();
 	WriteMap::iterator it(&writes);
 	it.skip(allKeys.begin);
 
@@ -2167,6 +2334,7 @@ RangeResult ReadYourWritesTransaction::getWriteConflictRangeIntersecting(KeyRang
 	CoalescedKeyRefRangeMap<ValueRef> writeConflicts{ "0"_sr, specialKeys.end };
 
 	if (!options.readYourWritesDisabled) {
+		useWriteMap();
 		KeyRangeRef strippedWriteRangePrefix = kr.removePrefix(writeConflictRangeKeysRange.begin);
 		WriteMap::iterator it(&writes);
 		it.skip(strippedWriteRangePrefix.begin);
@@ -2231,14 +2399,18 @@ void ReadYourWritesTransaction::atomicOp(const KeyRef& key, const ValueRef& oper
 		throw key_outside_legal_range();
 	}
 
-	if (!isValidMutationType(operationType) || !isAtomicOp((MutationRef::Type)operationType))
+	if (!isValidMutationType(operationType) ||
+	    (!isAtomicOp((MutationRef::Type)operationType) && operationType != MutationRef::SetVersionstampedKeys))
 		throw invalid_mutation_type();
 
 	if (key.size() > getMaxWriteKeySize(key, getTransactionState()->options.rawAccess)) {
 		throw key_too_large();
 	}
-	if (operand.size() > CLIENT_KNOBS->VALUE_SIZE_LIMIT)
+	if (operationType == MutationRef::SetVersionstampedKeys) {
+		validateVersionstampedKeys(key, operand);
+	} else if (operand.size() > CLIENT_KNOBS->VALUE_SIZE_LIMIT) {
 		throw value_too_large();
+	}
 
 	if (tr.apiVersionAtLeast(510)) {
 		if (operationType == MutationRef::Min)
@@ -2247,6 +2419,21 @@ void ReadYourWritesTransaction::atomicOp(const KeyRef& key, const ValueRef& oper
 			operationType = MutationRef::AndV2;
 	}
 
+	if (operationType == MutationRef::SetVersionstampedKeys) {
+		CODE_PROBE(options.readYourWritesDisabled, "SetVersionstampedKeys without ryw enabled");
+		// The keys are only known once committed, so rather than being kept in the write map the mutation goes
+		// straight to the native transaction, after whatever has already been written to where the keys may be
+		if (!options.readYourWritesDisabled) {
+			KeyRangeRef range =
+			    getVersionstampKeyRange(arena, key, tr.getCachedReadVersion().orDefault(0), getMaxReadKey());
+			useWriteMap();
+			writeRangeToNativeTransaction(range);
+			writes.addUnmodifiedAndUnreadableRange(range);
+		}
+		approximateSize += key.expectedSize() + operand.expectedSize() + sizeof(MutationRef);
+		return tr.atomicOp(key, operand, MutationRef::SetVersionstampedKeys, AddConflictRange::False);
+	}
+
 	KeyRef k;
 	if (!tr.apiVersionAtLeast(520) && operationType == MutationRef::SetVersionstampedKey) {
 		k = key.withSuffix("\x00\x00"_sr, arena);
@@ -2267,6 +2454,7 @@ void ReadYourWritesTransaction::atomicOp(const KeyRef& key, const ValueRef& oper
 		versionStampKeys.push_back(arena, k);
 		addWriteConflict = AddConflictRange::False;
 		if (!options.readYourWritesDisabled) {
+			useWriteMap();
 			writeRangeToNativeTransaction(range);
 			writes.addUnmodifiedAndUnreadableRange(range);
 		}
@@ -2292,6 +2480,11 @@ void ReadYourWritesTransaction::atomicOp(const KeyRef& key, const ValueRef& oper
 		return tr.atomicOp(k, v, (MutationRef::Type)operationType, addWriteConflict);
 	}
 
+	if (logBlindWrites) {
+		blindWrites.mutate(k, (MutationRef::Type)operationType, v, addWriteConflict);
+		return;
+	}
+
 	writes.mutate(k, (MutationRef::Type)operationType, v, addWriteConflict);
 	RYWImpl::triggerWatches(this, k, Optional<ValueRef>(), false);
 }
@@ -2350,6 +2543,11 @@ void ReadYourWritesTransaction::set(const KeyRef& key, const ValueRef& value) {
 	KeyRef k = KeyRef(arena, key);
 	ValueRef v = ValueRef(arena, value);
 
+	if (logBlindWrites) {
+		blindWrites.mutate(k, MutationRef::SetValue, v, addWriteConflict);
+		return;
+	}
+
 	writes.mutate(k, MutationRef::SetValue, v, addWriteConflict);
 	RYWImpl::triggerWatches(this, key, value);
 }
@@ -2399,6 +2597,7 @@ void ReadYourWritesTransaction::clear(const KeyRangeRef& range) {
 
 	r = KeyRangeRef(arena, r);
 
+	useWriteMap();
 	writes.clear(r, addWriteConflict);
 	RYWImpl::triggerWatches(this, r, Optional<ValueRef>());
 }
@@ -2431,6 +2630,11 @@ void ReadYourWritesTransaction::clear(const KeyRef& key) {
 	approximateSize +=
 	    r.expectedSize() + sizeof(KeyRangeRef) + (addWriteConflict ? sizeof(KeyRangeRef) + r.expectedSize() : 0);
 
+	if (logBlindWrites) {
+		blindWrites.clear(r.begin, addWriteConflict);
+		return;
+	}
+
 	// SOMEDAY: add an optimized single key clear to write map
 	writes.clear(r, addWriteConflict);
 
@@ -2438,6 +2642,7 @@ void ReadYourWritesTransaction::clear(const KeyRef& key) {
 }
 
 Future<Void> ReadYourWritesTransaction::watch(const Key& key) {
+	useWriteMap();
 	if (checkUsedDuringCommit()) {
 		return used_during_commit();
 	}
@@ -2458,6 +2663,23 @@ Future<Void> ReadYourWritesTransaction::watch(const Key& key) {
 	return RYWImpl::watch(this, key);
 }
 
+Future<Void> ReadYourWritesTransaction::watchRange(KeyRange const& range) {
+	if (checkUsedDuringCommit()) {
+		return used_during_commit();
+	}
+
+	if (resetPromise.isSet())
+		return resetPromise.getFuture().getError();
+
+	if (range.empty())
+		return client_invalid_operation();
+
+	if (range.end > allKeys.end || (range.end > getMaxReadKey() && tr.apiVersionAtLeast(300)))
+		return key_outside_legal_range();
+
+	return tr.watchRange(range);
+}
+
 void ReadYourWritesTransaction::addWriteConflictRange(KeyRangeRef const& keys) {
 	if (checkUsedDuringCommit()) {
 		throw used_during_commit();
@@ -2496,6 +2718,10 @@ void ReadYourWritesTransaction::addWriteConflictRange(KeyRangeRef const& keys) {
 	}
 
 	r = KeyRangeRef(arena, r);
+	if (logBlindWrites) {
+		blindWrites.addConflictRange(r);
+		return;
+	}
 	writes.addConflictRange(r);
 }
 
@@ -2537,12 +2763,17 @@ void ReadYourWritesTransaction::setOptionImpl(FDBTransactionOptions::Option opti
 	case FDBTransactionOptions::READ_YOUR_WRITES_DISABLE:
 		validateOptionValueNotPresent(value);
 
-		if (reading.getFutureCount() > 0 || !cache.empty() || !writes.empty())
+		if (reading.getFutureCount() > 0 || !cache.empty() || !writes.empty() || !blindWrites.empty())
 			throw client_invalid_operation();
 
 		options.readYourWritesDisabled = true;
 		break;
 
+	case FDBTransactionOptions::READ_YOUR_WRITES_CACHE_LIMIT:
+		validateOptionValuePresent(value);
+		cache.setValueBytesLimit(extractIntOption(value, 0));
+		break;
+
 	case FDBTransactionOptions::READ_AHEAD_DISABLE:
 		validateOptionValueNotPresent(value);
 
@@ -2625,6 +2856,8 @@ void ReadYourWritesTransaction::setOptionImpl(FDBTransactionOptions::Option opti
 void ReadYourWritesTransaction::operator=(ReadYourWritesTransaction&& r) noexcept {
 	cache = std::move(r.cache);
 	writes = std::move(r.writes);
+	blindWrites = std::move(r.blindWrites);
+	logBlindWrites = r.logBlindWrites;
 	arena = std::move(r.arena);
 	tr = std::move(r.tr);
 	readConflicts = std::move(r.readConflicts);
@@ -2654,10 +2887,10 @@ void ReadYourWritesTransaction::operator=(ReadYourWritesTransaction&& r) noexcep
 
 ReadYourWritesTransaction::ReadYourWritesTransaction(ReadYourWritesTransaction&& r) noexcept
   : ISingleThreadTransaction(std::move(r.deferredError)), arena(std::move(r.arena)), cache(std::move(r.cache)),
-    writes(std::move(r.writes)), resetPromise(std::move(r.resetPromise)), reading(std::move(r.reading)),
-    retries(r.retries), approximateSize(r.approximateSize), timeoutActor(std::move(r.timeoutActor)),
-    creationTime(r.creationTime), commitStarted(r.commitStarted), transactionDebugInfo(r.transactionDebugInfo),
-    options(r.options) {
+    writes(std::move(r.writes)), blindWrites(std::move(r.blindWrites)), logBlindWrites(r.logBlindWrites),
+    resetPromise(std::move(r.resetPromise)), reading(std::move(r.reading)), retries(r.retries),
+    approximateSize(r.approximateSize), timeoutActor(std::move(r.timeoutActor)), creationTime(r.creationTime),
+    commitStarted(r.commitStarted), transactionDebugInfo(r.transactionDebugInfo), options(r.options) {
 	cache.arena = &arena;
 	writes.arena = &arena;
 	tr = std::move(r.tr);
@@ -2707,6 +2940,8 @@ void ReadYourWritesTransaction::resetRyow() {
 	arena = Arena();
 	cache = SnapshotCache(&arena);
 	writes = WriteMap(&arena);
+	blindWrites = BlindWriteLog();
+	logBlindWrites = CLIENT_KNOBS->RYW_LOG_BLIND_WRITES;
 	readConflicts = CoalescedKeyRefRangeMap<bool>();
 	versionStampKeys = VectorRef<KeyRef>();
 	nativeReadRanges = Standalone<VectorRef<KeyRangeRef>>();
@@ -99,6 +99,7 @@ S3BlobStoreEndpoint::BlobKnobs::BlobKnobs() {
 	max_delay_connection_failed = CLIENT_KNOBS->BLOBSTORE_MAX_DELAY_CONNECTION_FAILED;
 	sdk_auth = false;
 	global_connection_pool = CLIENT_KNOBS->BLOBSTORE_GLOBAL_CONNECTION_POOL;
+	adaptive_uploads = CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_UPLOADS;
 }
 
 bool S3BlobStoreEndpoint::BlobKnobs::set(StringRef name, int value) {
@@ -140,6 +141,7 @@ bool S3BlobStoreEndpoint::BlobKnobs::set(StringRef name, int value) {
 	TRY_PARAM(max_delay_connection_failed, dcf);
 	TRY_PARAM(sdk_auth, sa);
 	TRY_PARAM(global_connection_pool, gcp);
+	TRY_PARAM(adaptive_uploads, au);
 #undef TRY_PARAM
 	return false;
 }
@@ -181,6 +183,7 @@ std::string S3BlobStoreEndpoint::BlobKnobs::getURLParameters() const {
 	_CHECK_PARAM(global_connection_pool, gcp);
 	_CHECK_PARAM(max_delay_retryable_error, dre);
 	_CHECK_PARAM(max_delay_connection_failed, dcf);
+	_CHECK_PARAM(adaptive_uploads, au);
 #undef _CHECK_PARAM
 	return r;
 }
@@ -735,8 +738,8 @@ ACTOR Future<S3BlobStoreEndpoint::ReusableConnection> connect_impl(Reference<S3B
 	// First try to get a connection from the pool
 	*reusingConn = false;
 	while (!b->connectionPool->pool.empty()) {
-		S3BlobStoreEndpoint::ReusableConnection rconn = b->connectionPool->pool.front();
-		b->connectionPool->pool.pop();
+		S3BlobStoreEndpoint::ReusableConnection rconn = b->connectionPool->pool.back();
+		b->connectionPool->pool.pop_back();
 
 		// If the connection expires in the future then return it
 		if (rconn.expirationTime > now()) {
@@ -803,11 +806,19 @@ Future<S3BlobStoreEndpoint::ReusableConnection> S3BlobStoreEndpoint::connect(boo
 void S3BlobStoreEndpoint::returnConnection(ReusableConnection& rconn) {
 	// If it expires in the future then add it to the pool in the front
 	if (rconn.expirationTime > now()) {
-		connectionPool->pool.push(rconn);
+		connectionPool->pool.push_back(rconn);
 	} else {
 		++blobStats->expiredConnections;
 	}
 	rconn.conn = Reference<IConnection>();
+
+	// The least recently returned connections are only reused when many are needed at once, so drop them here once
+	// they expire rather than holding them open
+	auto& pool = connectionPool->pool;
+	while (!pool.empty() && pool.front().expirationTime <= now()) {
+		pool.pop_front();
+		++blobStats->expiredConnections;
+	}
 }
 
 std::string awsCanonicalURI(const std::string& resource, std::vector<std::string>& queryParameters, bool isV4) {
@@ -1927,6 +1938,63 @@ Future<std::string> S3BlobStoreEndpoint::beginMultiPartUpload(std::string const&
 	return beginMultiPartUpload_impl(Reference<S3BlobStoreEndpoint>::addRef(this), bucket, object);
 }
 
+void S3BlobStoreEndpoint::UploadTuner::partUploaded(BlobKnobs const& knobs, int bytes, double seconds) {
+	if (bytes <= 0) {
+		return;
+	}
+	seconds = std::max(seconds, 1e-3);
+	double rate = bytes / seconds;
+	bytesPerSecond = bytesPerSecond == 0 ? rate : bytesPerSecond * 0.75 + rate * 0.25;
+
+	double secondsPerByte = seconds / bytes;
+	bestSecondsPerByte = bestSecondsPerByte == 0 ? secondsPerByte : std::min(secondsPerByte, bestSecondsPerByte * 1.01);
+
+	if (writesPerFile == 0) {
+		writesPerFile = knobs.concurrent_writes_per_file;
+	}
+	if (secondsPerByte <= bestSecondsPerByte * CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_LATENCY_RATIO) {
+		writesPerFile = std::min<double>(writesPerFile + 1.0 / writesPerFile, maxWritesPerFile(knobs));
+	} else {
+		backOff(knobs);
+	}
+}
+
+// Parts already in flight when the link slows down slow down too, so only back off once for each of them
+void S3BlobStoreEndpoint::UploadTuner::backOff(BlobKnobs const& knobs) {
+	if (writesPerFile == 0) {
+		writesPerFile = knobs.concurrent_writes_per_file;
+	}
+	if (now() - lastDecrease > CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_PART_SECONDS) {
+		writesPerFile = std::max(writesPerFile / 2, 1.0);
+		lastDecrease = now();
+	}
+}
+
+int S3BlobStoreEndpoint::UploadTuner::partSize(BlobKnobs const& knobs) const {
+	return std::clamp<double>(bytesPerSecond * CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_PART_SECONDS,
+	                          knobs.multipart_min_part_size,
+	                          std::max(knobs.multipart_min_part_size, knobs.multipart_max_part_size));
+}
+
+int S3BlobStoreEndpoint::UploadTuner::maxWritesPerFile(BlobKnobs const& knobs) {
+	return std::max(knobs.concurrent_writes_per_file, CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_MAX_WRITES_PER_FILE);
+}
+
+int S3BlobStoreEndpoint::uploadPartSize(std::string const& bucket) {
+	if (!knobs.adaptive_uploads) {
+		return knobs.multipart_min_part_size;
+	}
+	return uploadTuners[bucket].partSize(knobs);
+}
+
+int S3BlobStoreEndpoint::uploadWritesPerFile(std::string const& bucket) {
+	UploadTuner& tuner = uploadTuners[bucket];
+	if (!knobs.adaptive_uploads || tuner.writesPerFile == 0) {
+		return knobs.concurrent_writes_per_file;
+	}
+	return tuner.writesPerFile;
+}
+
 ACTOR Future<std::string> uploadPart_impl(Reference<S3BlobStoreEndpoint> bstore,
                                           std::string bucket,
                                           std::string object,
@@ -1944,8 +2012,17 @@ ACTOR Future<std::string> uploadPart_impl(Reference<S3BlobStoreEndpoint> bstore,
 	HTTP::Headers headers;
 	// Send MD5 sum for content so blobstore can verify it
 	headers["Content-MD5"] = contentMD5;
-	state Reference<HTTP::IncomingResponse> r =
-	    wait(bstore->doRequest("PUT", resource, headers, pContent, contentLen, { 200 }));
+	state double startTime = now();
+	state Reference<HTTP::IncomingResponse> r;
+	try {
+		wait(store(r, bstore->doRequest("PUT", resource, headers, pContent, contentLen, { 200 })));
+	} catch (Error& e) {
+		if (e.code() != error_code_actor_cancelled) {
+			bstore->uploadTuners[bucket].backOff(bstore->knobs);
+		}
+		throw;
+	}
+	bstore->uploadTuners[bucket].partUploaded(bstore->knobs, contentLen, now() - startTime);
 	// TODO:  In the event that the client times out just before the request completes (so the client is unaware) then
 	// the next retry will see error 400.  That could be detected and handled gracefully by retrieving the etag for the
 	// successful request.
@@ -2085,3 +2162,29 @@ TEST_CASE("/backup/s3/guess_region") {
 	}
 	return Void();
 }
+
+TEST_CASE("/backup/s3/uploadTuner") {
+	S3BlobStoreEndpoint::BlobKnobs knobs;
+	knobs.multipart_min_part_size = 5e6;
+	knobs.multipart_max_part_size = 100e6;
+	knobs.concurrent_writes_per_file = 4;
+	S3BlobStoreEndpoint::UploadTuner tuner;
+	ASSERT_EQ(tuner.partSize(knobs), knobs.multipart_min_part_size);
+
+	// Parts that upload at a steady rate grow to take BLOBSTORE_ADAPTIVE_PART_SECONDS, and raise the concurrency
+	for (int i = 0; i < 50; i++) {
+		tuner.partUploaded(knobs, 5e6, 0.1);
+	}
+	ASSERT(tuner.writesPerFile > knobs.concurrent_writes_per_file);
+	ASSERT(tuner.writesPerFile <= S3BlobStoreEndpoint::UploadTuner::maxWritesPerFile(knobs));
+	ASSERT_EQ(tuner.partSize(knobs),
+	          std::min<int>(knobs.multipart_max_part_size, 50e6 * CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_PART_SECONDS));
+
+	// A part that takes far longer per byte backs off
+	double writesPerFile = tuner.writesPerFile;
+	tuner.lastDecrease = now() - 2 * CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_PART_SECONDS;
+	tuner.partUploaded(knobs, 5e6, 10 * CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_LATENCY_RATIO);
+	ASSERT(tuner.writesPerFile < writesPerFile);
+	ASSERT(tuner.writesPerFile >= 1);
+	return Void();
+}
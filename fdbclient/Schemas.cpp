@@ -396,6 +396,23 @@ const KeyRef JSONSchemas::statusSchema = R"statusSchema(
                   "commit_latency_bands":{
                      "$map": 1
                   },
+                  "tenant_latencies":[
+                     {
+                        "tenant_id":0,
+                        "request_type":{
+                           "$enum":[
+                              "point_read",
+                              "range_read",
+                              "commit"
+                           ]
+                        },
+                        "count":0,
+                        "median":0.0,
+                        "p99":0.0,
+                        "max":0.0,
+                        "slo_misses":0
+                     }
+                  ],
                   "busiest_read_tag":{
                      "tag": "",
                      "fractional_cost": 0.0,
@@ -464,7 +481,9 @@ const KeyRef JSONSchemas::statusSchema = R"statusSchema(
             },
             "uptime_seconds":1234.2345,
             "cpu":{
-               "usage_cores":0.0
+               "usage_cores":0.0,
+               "network_thread_cpus":"0",
+               "helper_thread_cpus":"1-3,8"
             },
             "network":{
                "current_connections":0,
@@ -485,9 +504,35 @@ const KeyRef JSONSchemas::statusSchema = R"statusSchema(
                },
                "tls_policy_failures":{
                  "hz":0.0
-               }
+               },
+               "peer_count":0,
+               "slowest_peers":[
+                 {
+                   "address":"1.2.3.4:1234",
+                   "ping_latency":{
+                     "count":0,
+                     "p50_seconds":0.0,
+                     "p99_seconds":0.0
+                   },
+                   "ping_timeouts":0,
+                   "bytes_sent":{
+                     "hz":0.0
+                   },
+                   "bytes_received":{
+                     "hz":0.0
+                   },
+                   "queued_bytes":0
+                 }
+               ]
             },
-            "run_loop_busy":0.2
+            "run_loop_busy":0.2,
+            "run_loop_busy_by_priority":[
+               {
+                  "priority":8500,
+                  "busy":0.1,
+                  "tasks_per_second":1000.0
+               }
+            ]
          }
       },
       "logs":[
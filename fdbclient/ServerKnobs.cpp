@@ -73,6 +73,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( TLOG_MESSAGE_BLOCK_OVERHEAD_FACTOR,      double(TLOG_MESSAGE_BLOCK_BYTES) / (TLOG_MESSAGE_BLOCK_BYTES - MAX_MESSAGE_SIZE) ); //1.0121466709838096006362758832473
 	init( PEEK_TRACKER_EXPIRATION_TIME,                          600 ); if( randomize && BUGGIFY ) PEEK_TRACKER_EXPIRATION_TIME = 120; // Cannot be buggified lower without changing the following assert in LogSystemPeekCursor.actor.cpp: ASSERT_WE_THINK(e.code() == error_code_operation_obsolete || SERVER_KNOBS->PEEK_TRACKER_EXPIRATION_TIME < 10);
 	init( PEEK_USING_STREAMING,                                false ); if( randomize && isSimulated && BUGGIFY ) PEEK_USING_STREAMING = true;
+	init( PEEK_STREAM_WINDOW_BYTES,                             10e6 ); if( randomize && BUGGIFY ) PEEK_STREAM_WINDOW_BYTES = deterministicRandom()->randomInt(1, 1e6);
+	init( TLOG_PEEK_STREAM_REPLY_BYTES,                          2e6 ); if( randomize && BUGGIFY ) TLOG_PEEK_STREAM_REPLY_BYTES = deterministicRandom()->randomInt(0, 4 * DESIRED_TOTAL_BYTES);
+	init( TLOG_PEEK_STREAM_REPLY_TIME,                          0.01 ); if( randomize && BUGGIFY ) TLOG_PEEK_STREAM_REPLY_TIME = deterministicRandom()->random01() * 0.1;
 	init( PARALLEL_GET_MORE_REQUESTS,                             32 ); if( randomize && BUGGIFY ) PARALLEL_GET_MORE_REQUESTS = 2;
 	init( MULTI_CURSOR_PRE_FETCH_LIMIT,                           10 );
 	init( MAX_QUEUE_COMMIT_BYTES,                               15e6 ); if( randomize && BUGGIFY ) MAX_QUEUE_COMMIT_BYTES = 5000;
@@ -81,15 +84,30 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( CONCURRENT_LOG_ROUTER_READS,                             5 ); if( randomize && BUGGIFY ) CONCURRENT_LOG_ROUTER_READS = 1;
 	init( LOG_ROUTER_PEEK_FROM_SATELLITES_PREFERRED,               1 ); if( randomize && BUGGIFY ) LOG_ROUTER_PEEK_FROM_SATELLITES_PREFERRED = 0;
 	init( LOG_ROUTER_PEEK_SWITCH_DC_TIME,                       60.0 );
+	init( LOG_ROUTER_MAX_BUFFERED_BYTES,                         2e9 ); if( randomize && BUGGIFY ) LOG_ROUTER_MAX_BUFFERED_BYTES = deterministicRandom()->randomInt(1, 20e6);
+	init( LOG_ROUTER_PEEK_COMPRESSION_FILTER,                 "NONE" ); if( randomize && BUGGIFY ) LOG_ROUTER_PEEK_COMPRESSION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter());
 	init( DISK_QUEUE_ADAPTER_MIN_SWITCH_TIME,                    1.0 );
 	init( DISK_QUEUE_ADAPTER_MAX_SWITCH_TIME,                    5.0 );
 	init( TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES,            2e9 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES = 2e6;
 	init( TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK,           100 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK = 1;
 	init( TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH,           16<<10 ); if ( randomize && BUGGIFY ) TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH = 500;
+	init( TLOG_PEEK_REPLY_CACHE_BYTES,                          50e6 ); if ( randomize && BUGGIFY ) TLOG_PEEK_REPLY_CACHE_BYTES = deterministicRandom()->coinflip() ? 0 : 1e6;
+	init( TLOG_SPILL_INDEX_BYTES_PER_TAG,                       10e6 ); if ( randomize && BUGGIFY ) TLOG_SPILL_INDEX_BYTES_PER_TAG = deterministicRandom()->coinflip() ? 0 : 5000;
 	init( DISK_QUEUE_FILE_EXTENSION_BYTES,                    10<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_FILE_SHRINK_BYTES,                      100<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_MAX_TRUNCATE_BYTES,                     2LL<<30 ); if ( randomize && BUGGIFY ) DISK_QUEUE_MAX_TRUNCATE_BYTES = 0;
+	init( DISK_QUEUE_PREALLOCATED_BYTES,                           0 ); // BUGGIFYd per file within the DiskQueue
+	init( DISK_QUEUE_RECOVERY_READ_BYTES,                      1<<20 );
+	init( DISK_QUEUE_RECOVERY_READ_AHEAD,                          8 ); if ( randomize && BUGGIFY ) DISK_QUEUE_RECOVERY_READ_AHEAD = deterministicRandom()->randomInt(1, 4);
 	init( TLOG_DEGRADED_DURATION,                                5.0 );
+	init( TLOG_GROUP_COMMIT_MAX_DELAY,                           0.0 ); if ( randomize && BUGGIFY ) TLOG_GROUP_COMMIT_MAX_DELAY = deterministicRandom()->random01() * 0.005;
+	init( TLOG_GROUP_COMMIT_LATENCY_FRACTION,                    0.5 );
+	init( TLOG_GROUP_COMMIT_SMOOTHING_TIME,                      1.0 );
+	init( TLOG_COMPRESS_MESSAGE_BLOCKS,                        false ); if ( randomize && BUGGIFY ) TLOG_COMPRESS_MESSAGE_BLOCKS = true;
+	init( TLOG_COMPRESSION_SPILL_THRESHOLD_FRACTION,             0.5 ); if ( randomize && BUGGIFY ) TLOG_COMPRESSION_SPILL_THRESHOLD_FRACTION = deterministicRandom()->random01();
+	init( TLOG_COMPRESSION_FILTER,                            "ZSTD" ); if ( randomize && BUGGIFY ) TLOG_COMPRESSION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter());
+	init( TLOG_COMPRESSION_FRAME_BYTES,                       64<<10 ); if ( randomize && BUGGIFY ) TLOG_COMPRESSION_FRAME_BYTES = deterministicRandom()->randomInt(1, 64<<10);
+	init( TLOG_DECOMPRESSED_FRAME_CACHE_SIZE,                     16 ); if ( randomize && BUGGIFY ) TLOG_DECOMPRESSED_FRAME_CACHE_SIZE = 1;
 	init( MAX_CACHE_VERSIONS,                                   10e6 );
 	init( TLOG_IGNORE_POP_AUTO_ENABLE_DELAY,                   300.0 );
 	init( TXS_POPPED_MAX_DELAY,                                  1.0 ); if ( randomize && BUGGIFY ) TXS_POPPED_MAX_DELAY = deterministicRandom()->random01();
@@ -187,6 +205,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// TODO: choose a meaning value for real cluster
 	init( MAX_DEST_CPU_PERCENT, 		  					   100.0 );
 	init( DD_TEAM_PIVOT_UPDATE_DELAY,                            5.0 );
+	init( DD_PREDICTED_LOAD_WEIGHT,                              0.0 ); if( randomize && BUGGIFY ) DD_PREDICTED_LOAD_WEIGHT = deterministicRandom()->random01() * 2;
+	init( DD_LOAD_FORECAST_ALPHA,                                0.5 );
+	init( DD_LOAD_FORECAST_BETA,                                 0.2 );
 
 	init( ALLOW_LARGE_SHARD,                                   false ); if( randomize && BUGGIFY )  ALLOW_LARGE_SHARD = true;
 	init( MAX_LARGE_SHARD_BYTES,                          1000000000 ); // 1G
@@ -194,6 +215,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ENABLE_DD_PHYSICAL_SHARD,                            false ); // EXPERIMENTAL; If true, SHARD_ENCODE_LOCATION_METADATA must be true; When true, optimization of data move between DCs is disabled
 	init( DD_PHYSICAL_SHARD_MOVE_PROBABILITY,                    0.0 ); // FIXME: re-enable after ShardedRocksDB is well tested by simulation
 	init( ENABLE_PHYSICAL_SHARD_MOVE_EXPERIMENT,               false ); // FIXME: re-enable after ShardedRocksDB is well tested by simulation
+	init( DD_PHYSICAL_SHARD_MOVE_FOR_SHARDED_ROCKSDB,           true ); if( randomize && BUGGIFY ) DD_PHYSICAL_SHARD_MOVE_FOR_SHARDED_ROCKSDB = false;
 	init( MAX_PHYSICAL_SHARD_BYTES,                         10000000 ); // 10 MB; for ENABLE_DD_PHYSICAL_SHARD; smaller leads to larger number of physicalShard per storage server
  	init( PHYSICAL_SHARD_METRICS_DELAY,                        300.0 ); // 300 seconds; for ENABLE_DD_PHYSICAL_SHARD
 	init( ANONYMOUS_PHYSICAL_SHARD_TRANSITION_TIME,            600.0 ); if( randomize && BUGGIFY )  ANONYMOUS_PHYSICAL_SHARD_TRANSITION_TIME = 0.0; // 600 seconds; for ENABLE_DD_PHYSICAL_SHARD
@@ -236,6 +258,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 		Shard with a read bandwidth smaller than this value will never be too busy to handle the reads.
 	*/
 	init( SHARD_MAX_BYTES_READ_PER_KSEC_JITTER,     0.1 );
+	init( DD_CACHE_READ_HOT_RANGES,               false );
+	init( DD_CACHE_READ_HOT_RANGES_MAX,              10 ); if( randomize && BUGGIFY ) DD_CACHE_READ_HOT_RANGES_MAX = 1;
+	init( DD_SPLIT_READ_HOT_SHARDS,               false ); if( randomize && BUGGIFY ) DD_SPLIT_READ_HOT_SHARDS = true;
+	init( DD_CACHE_READ_HOT_RANGE_TTL,            600.0 ); if( randomize && BUGGIFY ) DD_CACHE_READ_HOT_RANGE_TTL = 10.0;
 	bool buggifySmallBandwidthSplit = randomize && BUGGIFY;
 	init( SHARD_MAX_BYTES_PER_KSEC,                 1LL*1000000*1000 ); if( buggifySmallBandwidthSplit ) SHARD_MAX_BYTES_PER_KSEC = 1LL*100000*1000;
 	/* 1*1MB/sec * 1000sec/ksec
@@ -277,6 +303,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 
 	init( DD_SHARD_USABLE_REGION_CHECK_RATE,                       2 );
 	init( ENABLE_WRITE_BASED_SHARD_SPLIT,                      false ); if( randomize && BUGGIFY ) ENABLE_WRITE_BASED_SHARD_SPLIT = true;
+	init( STORAGE_KVS_RANGE_SIZE_ESTIMATE,                     false ); if( randomize && BUGGIFY ) STORAGE_KVS_RANGE_SIZE_ESTIMATE = true;
 	init( STORAGE_METRIC_TIMEOUT,         isSimulated ? 60.0 : 600.0 ); if( randomize && BUGGIFY ) STORAGE_METRIC_TIMEOUT = deterministicRandom()->coinflip() ? 10.0 : 30.0;
 	init( METRIC_DELAY,                                          0.1 ); if( randomize && BUGGIFY ) METRIC_DELAY = 1.0;
 	init( ALL_DATA_REMOVED_DELAY,                                1.0 );
@@ -289,6 +316,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( PERPETUAL_WIGGLE_MIN_BYTES_BALANCE_RATIO,             0.85 );
 	init( PW_MAX_SS_LESSTHAN_MIN_BYTES_BALANCE_RATIO,              0 );
 	init( PERPETUAL_WIGGLE_DISABLE_REMOVER,                     true );
+	init( PERPETUAL_WIGGLE_MAX_SERVERS_PER_ZONE,                   1 ); if( randomize && BUGGIFY ) PERPETUAL_WIGGLE_MAX_SERVERS_PER_ZONE = deterministicRandom()->randomInt(2, 5);
+	init( PERPETUAL_WIGGLE_PREFER_SMALLER_SERVERS,              true ); if( randomize && BUGGIFY ) PERPETUAL_WIGGLE_PREFER_SMALLER_SERVERS = false;
 	init( LOG_ON_COMPLETION_DELAY,         DD_QUEUE_LOGGING_INTERVAL );
 	init( BEST_TEAM_MAX_TEAM_TRIES,                               10 );
 	init( BEST_TEAM_OPTION_COUNT,                                  4 );
@@ -375,6 +404,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( DD_BULKLOAD_TASK_METADATA_READ_SIZE,                   100 ); if( randomize && BUGGIFY ) DD_BULKLOAD_TASK_METADATA_READ_SIZE = deterministicRandom()->randomInt(2, 100);
 	init( DD_BULKLOAD_PARALLELISM,                                10 ); if( randomize && BUGGIFY ) DD_BULKLOAD_PARALLELISM = deterministicRandom()->randomInt(1, 10);
 	init( DD_BULKLOAD_SCHEDULE_MIN_INTERVAL_SEC,                 2.0 ); if( randomize && BUGGIFY ) DD_BULKLOAD_SCHEDULE_MIN_INTERVAL_SEC = deterministicRandom()->random01() * 10 + 1;
+	init( BULK_RESTORE_SHARD_BYTES,                            100e6 ); if( randomize && BUGGIFY ) BULK_RESTORE_SHARD_BYTES = deterministicRandom()->randomInt(1000, 1000000);
+	init( BULK_RESTORE_PARALLELISM,                                8 ); if( randomize && BUGGIFY ) BULK_RESTORE_PARALLELISM = deterministicRandom()->randomInt(1, 8);
+	init( BULK_RESTORE_LOG_BATCH_BYTES,                        100e6 ); if( randomize && BUGGIFY ) BULK_RESTORE_LOG_BATCH_BYTES = deterministicRandom()->randomInt(1000, 1000000);
+	init( BULK_RESTORE_TRANSACTION_BYTES,                        1e6 ); if( randomize && BUGGIFY ) BULK_RESTORE_TRANSACTION_BYTES = deterministicRandom()->randomInt(100, 100000);
 
 	// TeamRemover
 	init( TR_FLAG_DISABLE_MACHINE_TEAM_REMOVER,                false ); if( randomize && BUGGIFY ) TR_FLAG_DISABLE_MACHINE_TEAM_REMOVER = deterministicRandom()->random01() < 0.1 ? true : false; // false by default. disable the consistency check when it's true
@@ -451,6 +484,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 
 	// KeyValueStoreMemory
 	init( REPLACE_CONTENTS_BYTES,                                1e5 );
+	init( KVS_MEMORY_PARALLEL_RECOVERY,                         false ); if( randomize && BUGGIFY ) KVS_MEMORY_PARALLEL_RECOVERY = true;
+	init( KVS_MEMORY_SNAPSHOT_WRITE_RATIO,                        1.0 ); if( randomize && BUGGIFY ) KVS_MEMORY_SNAPSHOT_WRITE_RATIO = deterministicRandom()->randomChoice(std::vector<double>{ 0.1, 0.5, 2.0 });
+	init( KVS_MEMORY_RECOVERY_CHUNK_SETS,                      10000 ); if( randomize && BUGGIFY ) KVS_MEMORY_RECOVERY_CHUNK_SETS = deterministicRandom()->randomInt(1, 100);
 
 	// KeyValueStoreRocksDB
 	init( ROCKSDB_SET_READ_TIMEOUT,         		    !isSimulated );
@@ -491,6 +527,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ROCKSDB_READ_CHECKPOINT_TIMEOUT, isSimulated ? 300.0 : 5.0 );
 	init( ROCKSDB_CHECKPOINT_READ_AHEAD_SIZE,                2 << 20 ); // 2M
 	init( ROCKSDB_READ_QUEUE_WAIT,                               1.0 );
+	init( ROCKSDB_READ_VALUE_BATCH_SIZE,                          1 ); if( randomize && BUGGIFY ) ROCKSDB_READ_VALUE_BATCH_SIZE = deterministicRandom()->randomInt(2, 20);
+	init( ROCKSDB_READ_ASYNC_IO,                              false ); if( isSimulated ) ROCKSDB_READ_ASYNC_IO = deterministicRandom()->coinflip();
 	init( ROCKSDB_READ_QUEUE_HARD_MAX,                          1000 );
 	init( ROCKSDB_READ_QUEUE_SOFT_MAX,                           500 );
 	init( ROCKSDB_FETCH_QUEUE_HARD_MAX,                          100 );
@@ -561,6 +599,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ROCKSDB_EMPTY_RANGE_CHECK,       isSimulated ? true : false);
 	init( ROCKSDB_CREATE_BYTES_SAMPLE_FILE_RETRY_MAX,             50 );
 	init( ROCKSDB_ATOMIC_FLUSH,                                false );
+	init( ROCKSDB_DISABLE_WAL,                                 false ); if( randomize && BUGGIFY ) ROCKSDB_DISABLE_WAL = deterministicRandom()->coinflip();
  	init( ROCKSDB_IMPORT_MOVE_FILES,                           false );
  	init( ROCKSDB_CHECKPOINT_REPLAY_MARKER,                    false );
  	init( ROCKSDB_VERIFY_CHECKSUM_BEFORE_RESTORE,               true );
@@ -606,8 +645,12 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( SHARDED_ROCKSDB_TARGET_FILE_SIZE_BASE,            16 << 20 ); // 16MB
 	init( SHARDED_ROCKSDB_TARGET_FILE_SIZE_MULTIPLIER,             1 ); // RocksDB default.
 	init( SHARDED_ROCKSDB_SUGGEST_COMPACT_CLEAR_RANGE,          true );
+	init( SHARDED_ROCKSDB_CHEAP_SHARD_REMOVAL,                  true ); if( randomize && BUGGIFY ) SHARDED_ROCKSDB_CHEAP_SHARD_REMOVAL = false;
 	init( SHARDED_ROCKSDB_MAX_BACKGROUND_JOBS,                     4 );
 	init( SHARDED_ROCKSDB_BLOCK_CACHE_SIZE, isSimulated? 16 * 1024 : 134217728 /* 128MB */);
+	init( SHARDED_ROCKSDB_BLOCK_CACHE_HIGH_PRI_POOL_RATIO,       0.5 ); // RocksDB default.
+	init( SHARDED_ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS,       false ); if (isSimulated) SHARDED_ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS = deterministicRandom()->coinflip();
+	init( SHARDED_ROCKSDB_FETCH_FILL_CACHE,                     true ); if (isSimulated) SHARDED_ROCKSDB_FETCH_FILL_CACHE = deterministicRandom()->coinflip();
 	// Set to 0 to disable rocksdb write rate limiting. Rate limiter unit: bytes per second.
 	init( SHARDED_ROCKSDB_WRITE_RATE_LIMITER_BYTES_PER_SEC,        300 << 20 );
 	init( SHARDED_ROCKSDB_RATE_LIMITER_MODE,                       2 );
@@ -682,6 +725,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( ENFORCED_MIN_RECOVERY_DURATION,                       0.085 ); if( shortRecoveryDuration ) ENFORCED_MIN_RECOVERY_DURATION = 0.01;
 	init( REQUIRED_MIN_RECOVERY_DURATION,                       0.080 ); if( shortRecoveryDuration ) REQUIRED_MIN_RECOVERY_DURATION = 0.01;
 	init( ALWAYS_CAUSAL_READ_RISKY,                             false );
+	init( GRV_LEASE_DURATION,                                     0.0 );
 	init( MAX_COMMIT_UPDATES,                                    2000 ); if( randomize && BUGGIFY ) MAX_COMMIT_UPDATES = 1;
 	init( MAX_PROXY_COMPUTE,                                      2.0 );
 	init( MAX_COMPUTE_PER_OPERATION,                              0.1 );
@@ -691,6 +735,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( TXN_STATE_SEND_AMOUNT,                                    4 );
 	init( REPORT_TRANSACTION_COST_ESTIMATION_DELAY,               0.1 );
 	init( PROXY_REJECT_BATCH_QUEUED_TOO_LONG,                    true );
+	init( COMMIT_PROXY_ENCRYPTION_THREADS,                          0 ); if( randomize && BUGGIFY ) COMMIT_PROXY_ENCRYPTION_THREADS = deterministicRandom()->randomInt(1, 5);
+	init( COMMIT_PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS,          64 ); if( randomize && BUGGIFY ) COMMIT_PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS = 1;
+	init( COMMIT_PROXY_KEY_INFO_INDEX,                           true ); if( randomize && BUGGIFY ) COMMIT_PROXY_KEY_INFO_INDEX = false;
 
 	bool buggfyUseResolverPrivateMutations = randomize && BUGGIFY && !ENABLE_VERSION_VECTOR_TLOG_UNICAST;
 	init( PROXY_USE_RESOLVER_PRIVATE_MUTATIONS,                 false ); if( buggfyUseResolverPrivateMutations ) PROXY_USE_RESOLVER_PRIVATE_MUTATIONS = deterministicRandom()->coinflip();
@@ -717,6 +764,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( MIN_BALANCE_DIFFERENCE,                                1e6 ); if( fastBalancing ) MIN_BALANCE_DIFFERENCE = 1e4;
 	init( SECONDS_BEFORE_NO_FAILURE_DELAY,                  8 * 3600 );
 	init( MAX_TXS_SEND_MEMORY,                                   1e7 ); if( randomize && BUGGIFY ) MAX_TXS_SEND_MEMORY = 1e5;
+	init( TXN_STATE_COMPRESSION_FILTER,                       "NONE" ); if( randomize && BUGGIFY ) TXN_STATE_COMPRESSION_FILTER = CompressionUtils::toString(CompressionUtils::getRandomFilter());
 	init( MAX_RECOVERY_VERSIONS,           200 * VERSIONS_PER_SECOND );
 	init( MAX_RECOVERY_TIME,                                    20.0 ); if( randomize && BUGGIFY ) MAX_RECOVERY_TIME = 1.0;
 	init( PROVISIONAL_START_DELAY,                               1.0 );
@@ -730,6 +778,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( SAMPLE_EXPIRATION_TIME,                                1.0 );
 	init( SAMPLE_POLL_TIME,                                      0.1 );
 	init( RESOLVER_STATE_MEMORY_LIMIT,                           1e6 );
+	init( RESOLVER_CONFLICT_DETECTION_PARALLELISM,                 1 ); if( randomize && BUGGIFY ) RESOLVER_CONFLICT_DETECTION_PARALLELISM = deterministicRandom()->randomInt(2, 9);
+	init( RESOLVER_CONFLICT_DETECTION_MIN_RANGES_PER_PARTITION,  256 ); if( randomize && BUGGIFY ) RESOLVER_CONFLICT_DETECTION_MIN_RANGES_PER_PARTITION = deterministicRandom()->randomInt(1, 10);
+	init( RESOLVER_USE_COMPRESSED_CONFLICT_HISTORY,            false ); if( randomize && BUGGIFY ) RESOLVER_USE_COMPRESSED_CONFLICT_HISTORY = true;
 	init( LAST_LIMITED_RATIO,                                    2.0 );
 
 	// Backup Worker
@@ -738,6 +789,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BACKUP_FILE_BLOCK_BYTES,                       1024 * 1024 );
 	init( BACKUP_LOCK_BYTES,                                     3e9 ); if(randomize && BUGGIFY) BACKUP_LOCK_BYTES = deterministicRandom()->randomInt(1024, 4096) * 4096;
 	init( BACKUP_UPLOAD_DELAY,                                  10.0 ); if(randomize && BUGGIFY) BACKUP_UPLOAD_DELAY = deterministicRandom()->random01() * 60;
+	init( BACKUP_WORKER_MIN_FILE_BYTES,                            0 ); if(randomize && BUGGIFY) BACKUP_WORKER_MIN_FILE_BYTES = deterministicRandom()->randomInt(1, 10) * 1e6; // Mutation log files are saved once this many bytes of messages are buffered, or BACKUP_WORKER_MAX_FILE_DELAY after the last
+	init( BACKUP_WORKER_MAX_FILE_DELAY,                         60.0 ); if(randomize && BUGGIFY) BACKUP_WORKER_MAX_FILE_DELAY = deterministicRandom()->random01() * 120;
+	init( BACKUP_WORKER_COMPRESS_LOG_FILES,                    false ); if(randomize && BUGGIFY) BACKUP_WORKER_COMPRESS_LOG_FILES = true;
 
 	//Cluster Controller
 	init( CLUSTER_CONTROLLER_LOGGING_DELAY,                      5.0 );
@@ -840,6 +894,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( RATEKEEPER_DEFAULT_LIMIT,                              1e6 ); if( randomize && BUGGIFY ) RATEKEEPER_DEFAULT_LIMIT = 0;
 	init( RATEKEEPER_LIMIT_REASON_SAMPLE_RATE,                   0.1 );
 	init( RATEKEEPER_PRINT_LIMIT_REASON,                       false ); if( randomize && BUGGIFY ) RATEKEEPER_PRINT_LIMIT_REASON = true;
+	init( RATEKEEPER_RECORD_DIR,                                   "" );
+	init( RATEKEEPER_RECORD_MAX_BYTES,                           1e9 );
+	init( RATEKEEPER_RECORD_FLUSH_INTERVAL,                      1.0 );
 	init( RATEKEEPER_MIN_RATE,                                   0.0 );
 	init( RATEKEEPER_MAX_RATE,                                   1e9 );
 	init( RATEKEEPER_BATCH_MIN_RATE,                             0.0 );
@@ -857,10 +914,18 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( STORAGE_HARD_LIMIT_BYTES_SPEED_UP_SIM, STORAGE_HARD_LIMIT_BYTES ); if( smallStorageTarget ) STORAGE_HARD_LIMIT_BYTES_SPEED_UP_SIM *= 10;
 	init( STORAGE_HARD_LIMIT_BYTES_OVERAGE_SPEED_UP_SIM, STORAGE_HARD_LIMIT_BYTES_OVERAGE ); if( smallStorageTarget ) STORAGE_HARD_LIMIT_BYTES_OVERAGE_SPEED_UP_SIM *= 10;
 	init( STORAGE_HARD_LIMIT_VERSION_OVERAGE, VERSIONS_PER_SECOND / 4.0 );
+	init( STORAGE_MEMORY_BUDGET_BYTES,                             0 ); if ( randomize && BUGGIFY ) STORAGE_MEMORY_BUDGET_BYTES = deterministicRandom()->randomInt64(50e6, 1e9);
+	init( STORAGE_MEMORY_BUDGET_INTERVAL,                        1.0 );
+	init( STORAGE_MEMORY_BUDGET_MIN_CACHE_FRACTION,              0.2 ); if ( randomize && BUGGIFY ) STORAGE_MEMORY_BUDGET_MIN_CACHE_FRACTION = deterministicRandom()->random01();
+	init( STORAGE_MEMORY_BUDGET_MIN_QUEUE_FRACTION,              0.1 );
+	init( STORAGE_PINNED_READ_VERSION_MAX_LIFETIME,            120.0 ); if ( randomize && BUGGIFY ) STORAGE_PINNED_READ_VERSION_MAX_LIFETIME = deterministicRandom()->randomInt(5, 30);
+	init( STORAGE_PINNED_READ_VERSION_MAX_BYTES,               250e6 ); if( smallStorageTarget ) STORAGE_PINNED_READ_VERSION_MAX_BYTES = 1000e3;
 	init( STORAGE_DURABILITY_LAG_HARD_MAX,                    2000e6 ); if( smallStorageTarget ) STORAGE_DURABILITY_LAG_HARD_MAX = 100e6;
 	init( STORAGE_DURABILITY_LAG_SOFT_MAX,                     250e6 ); if( smallStorageTarget ) STORAGE_DURABILITY_LAG_SOFT_MAX = 10e6;
 	init( STORAGE_INCLUDE_FEED_STORAGE_QUEUE,                   true ); if ( randomize && BUGGIFY ) STORAGE_INCLUDE_FEED_STORAGE_QUEUE = false;
 	init( STORAGE_SHARD_CONSISTENCY_CHECK_INTERVAL,                     0.0); if ( isSimulated ) STORAGE_SHARD_CONSISTENCY_CHECK_INTERVAL = 5.0;
+	init( STORAGE_COLD_SHARD_AGE,                          7 * 86400.0 ); if ( randomize && BUGGIFY ) STORAGE_COLD_SHARD_AGE = deterministicRandom()->randomInt(1, 60);
+	init( STORAGE_COLD_SHARD_CHECK_INTERVAL,                     60.0 ); if ( randomize && BUGGIFY ) STORAGE_COLD_SHARD_CHECK_INTERVAL = 5.0;
 	init (STORAGE_FETCH_KEYS_DELAY,	                             0.0 ); if ( randomize && BUGGIFY ) { STORAGE_FETCH_KEYS_DELAY = deterministicRandom()->random01() * 5.0; }
 	init (STORAGE_FETCH_KEYS_USE_COMMIT_BUDGET,                false ); if (isSimulated) STORAGE_FETCH_KEYS_USE_COMMIT_BUDGET = deterministicRandom()->coinflip();
 	init (STORAGE_FETCH_KEYS_RATE_LIMIT,             			   0 ); if (isSimulated && BUGGIFY) STORAGE_FETCH_KEYS_RATE_LIMIT = 100 * 1024 * deterministicRandom()->randomInt(1, 10);  // In MB/s
@@ -949,6 +1014,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( HOT_SHARD_THROTTLING_EXPIRE_AFTER,                      3.0 );
 	init( HOT_SHARD_THROTTLING_TRACKED,                             1 );
 	init( HOT_SHARD_MONITOR_FREQUENCY,                            5.0 );
+	init( RATEKEEPER_LOCALIZED_THROTTLING,                      false ); if(randomize && BUGGIFY) RATEKEEPER_LOCALIZED_THROTTLING = true;
+	init( RATEKEEPER_LOCALIZED_THROTTLING_RATIO,                  0.5 );
 
 	init( GENERATE_DATA_ENABLED,                                false );
 	init( GENERATE_DATA_PER_VERSION_MAX,                        10000 );
@@ -974,12 +1041,18 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( STORAGE_SERVER_POLL_METRICS_DELAY,                     1.0 );
 	init( FUTURE_VERSION_DELAY,                                  1.0 );
 	init( STORAGE_LIMIT_BYTES,                                500000 );
+	init( RANGE_REPLY_COMPRESSION_MIN_BYTES,                   16384 ); if( randomize && BUGGIFY ) RANGE_REPLY_COMPRESSION_MIN_BYTES = deterministicRandom()->randomInt(0, 1000);
+	init( FILTERED_RANGE_READ_MAX_SCAN_BYTES,                    1e7 ); if( randomize && BUGGIFY ) FILTERED_RANGE_READ_MAX_SCAN_BYTES = deterministicRandom()->randomInt(1, 10000);
+	init( AGGREGATE_RANGE_READ_MAX_SCAN_BYTES,                   1e8 ); if( randomize && BUGGIFY ) AGGREGATE_RANGE_READ_MAX_SCAN_BYTES = deterministicRandom()->randomInt(1, 100000);
 	init( BUGGIFY_LIMIT_BYTES,                                  1000 );
 	init( FETCH_USING_STREAMING,                               false ); if( randomize && isSimulated && BUGGIFY ) FETCH_USING_STREAMING = true; //Determines if fetch keys uses streaming reads
 	init( FETCH_USING_BLOB,                                    false );
 	init( FETCH_BLOCK_BYTES,                                     2e6 );
 	init( FETCH_KEYS_PARALLELISM_BYTES,                          4e6 ); if( randomize && BUGGIFY ) FETCH_KEYS_PARALLELISM_BYTES = 3e6;
 	init( FETCH_KEYS_PARALLELISM,                                  2 );
+	init( FETCH_KEYS_SUBRANGE_PARALLELISM,                         4 ); if( randomize && BUGGIFY ) FETCH_KEYS_SUBRANGE_PARALLELISM = deterministicRandom()->randomInt(1, 9);
+	init( FETCH_KEYS_SUBRANGE_BYTES,                             5e7 ); if( randomize && BUGGIFY ) FETCH_KEYS_SUBRANGE_BYTES = deterministicRandom()->randomInt(10000, 1000000);
+	init( FETCH_KEYS_READ_AHEAD_BYTES,                           2e7 ); if( randomize && BUGGIFY ) FETCH_KEYS_READ_AHEAD_BYTES = FETCH_BLOCK_BYTES;
 	init( FETCH_KEYS_PARALLELISM_CHANGE_FEED,                      6 );
 	init( FETCH_KEYS_LOWER_PRIORITY,                               0 );
 	init( SERVE_FETCH_CHECKPOINT_PARALLELISM,                      4 );
@@ -991,6 +1064,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( AUDIT_DATAMOVE_POST_CHECK,                           false ); if ( isSimulated ) AUDIT_DATAMOVE_POST_CHECK = true;
 	init( AUDIT_DATAMOVE_POST_CHECK_RETRY_COUNT_MAX,              50 );
 	init( AUDIT_STORAGE_RATE_PER_SERVER_MAX,                    50e6 ); // per second
+	init( AUDIT_STORAGE_DIGEST_BYTES,                           10e6 ); if( randomize && BUGGIFY ) AUDIT_STORAGE_DIGEST_BYTES = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(1e5, 10e6);
+	init( AUDIT_STORAGE_DIGEST_FANOUT,                             8 ); if( randomize && BUGGIFY ) AUDIT_STORAGE_DIGEST_FANOUT = deterministicRandom()->randomInt(2, 17);
 	init( ENABLE_AUDIT_VERBOSE_TRACE,                          false );
 	init( LOGGING_STORAGE_COMMIT_WHEN_IO_TIMEOUT,               true );
 	init( LOGGING_RECENT_STORAGE_COMMIT_SIZE,                     20 );
@@ -1006,6 +1081,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( STORAGE_DURABILITY_LAG_REJECT_THRESHOLD,              0.25 );
 	init( STORAGE_DURABILITY_LAG_MIN_RATE,                       0.1 );
 	init( STORAGE_COMMIT_INTERVAL,                               0.5 ); if( randomize && BUGGIFY ) STORAGE_COMMIT_INTERVAL = 2.0;
+	init( STORAGE_RECLAIM_VERSIONS_IN_BACKGROUND,              false ); if( randomize && BUGGIFY ) STORAGE_RECLAIM_VERSIONS_IN_BACKGROUND = true;
+	init( STORAGE_COALESCE_VALUE_READS,                        false ); if( randomize && BUGGIFY ) STORAGE_COALESCE_VALUE_READS = true;
 
 	// Constants which affect the fraction of data which is sampled
 	// by storage severs to estimate key-range sizes and splits.
@@ -1031,6 +1108,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BYTE_SAMPLE_LOAD_PARALLELISM,                            8 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_LOAD_PARALLELISM = 1;
 	init( BYTE_SAMPLE_LOAD_DELAY,                                0.0 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_LOAD_DELAY = 0.1;
 	init( BYTE_SAMPLE_START_DELAY,                               1.0 ); if( randomize && BUGGIFY ) BYTE_SAMPLE_START_DELAY = 0.0;
+	init( STORAGE_LAZY_CHANGE_FEED_RESTORE,                    false ); if( randomize && BUGGIFY ) STORAGE_LAZY_CHANGE_FEED_RESTORE = true;
 	init( BEHIND_CHECK_DELAY,                                    2.0 );
 	init( BEHIND_CHECK_COUNT,                                      2 );
 	init( BEHIND_CHECK_VERSIONS,             5 * VERSIONS_PER_SECOND );
@@ -1045,6 +1123,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( MAX_STORAGE_COMMIT_TIME,                             200.0 ); //The max fsync stall time on the storage server and tlog before marking a disk as failed
 	init( RANGESTREAM_LIMIT_BYTES,                               2e6 ); if( randomize && BUGGIFY ) RANGESTREAM_LIMIT_BYTES = 1;
 	init( CHANGEFEEDSTREAM_LIMIT_BYTES,                          1e6 ); if( randomize && BUGGIFY ) CHANGEFEEDSTREAM_LIMIT_BYTES = 1;
+	init( CHANGE_FEED_DISK_READ_CACHE_BYTES,                    10e6 ); if( randomize && BUGGIFY ) CHANGE_FEED_DISK_READ_CACHE_BYTES = deterministicRandom()->coinflip() ? 0 : 1e5;
 	init( BLOBWORKERSTATUSSTREAM_LIMIT_BYTES,                    1e4 ); if( randomize && BUGGIFY ) BLOBWORKERSTATUSSTREAM_LIMIT_BYTES = 1;
 	init( ENABLE_CLEAR_RANGE_EAGER_READS,                       true ); if( randomize && BUGGIFY ) ENABLE_CLEAR_RANGE_EAGER_READS = deterministicRandom()->coinflip();
 	init( CHECKPOINT_TRANSFER_BLOCK_BYTES,                      40e6 );
@@ -1064,6 +1143,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// This exists for flexibility but assigning each ReadType to its own unique priority number makes the most sense
 	// The enumeration is currently: eager, fetch, low, normal, high
 	init( STORAGESERVER_READTYPE_PRIORITY_MAP,           "0,1,2,3,4" );
+	// While reads are queued, normal and high priority reads of a tag with at least this fraction of the busyness of
+	// the last interval are queued one priority lower, so that a noisy tag can't take every read slot. 0 disables this.
+	init( STORAGE_SERVER_BUSY_TAG_READ_FRACTION,                 0.5 ); if( randomize && BUGGIFY ) STORAGE_SERVER_BUSY_TAG_READ_FRACTION = deterministicRandom()->coinflip() ? 0.0 : 0.05;
+	init( STORAGE_READ_TAG_COST_PER_SECOND,                      0.0 );
 	init( SPLIT_METRICS_MAX_ROWS,                              10000 ); if( randomize && BUGGIFY ) SPLIT_METRICS_MAX_ROWS = 10;
 	init( PHYSICAL_SHARD_MOVE_LOG_SEVERITY,                        1 );
 	init( FETCH_SHARD_BUFFER_BYTE_LIMIT,                        20e6 ); if( randomize && BUGGIFY ) FETCH_SHARD_BUFFER_BYTE_LIMIT = 1;
@@ -1127,6 +1210,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// Status
 	init( STATUS_MIN_TIME_BETWEEN_REQUESTS,                      0.0 );
 	init( MAX_STATUS_REQUESTS_PER_SECOND,                      256.0 );
+	init( STATUS_WORKER_EVENT_REFRESH_INTERVAL,                  0.0 ); if( randomize && BUGGIFY ) STATUS_WORKER_EVENT_REFRESH_INTERVAL = deterministicRandom()->random01() * 5.0;
+	init( STATUS_WORKER_EVENT_IDLE_TIMEOUT,                     60.0 );
 	init( CONFIGURATION_ROWS_TO_FETCH,                         20000 );
 	init( DISABLE_DUPLICATE_LOG_WARNING,                       false );
 	init( HISTOGRAM_REPORT_INTERVAL,                           300.0 );
@@ -1187,11 +1272,13 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REDWOOD_DEFAULT_EXTENT_READ_SIZE,              1024 * 1024 );
 	init( REDWOOD_EXTENT_CONCURRENT_READS,                         4 );
 	init( REDWOOD_KVSTORE_RANGE_PREFETCH,                       true );
+	init( REDWOOD_KVSTORE_RANGE_PREFETCH_LEAVES,                  32 ); if( randomize && BUGGIFY ) REDWOOD_KVSTORE_RANGE_PREFETCH_LEAVES = deterministicRandom()->randomInt(1, 4);
 	init( REDWOOD_PAGE_REBUILD_MAX_SLACK,                       0.33 );
 	init( REDWOOD_PAGE_REBUILD_SLACK_DISTRIBUTION,              0.50 );
 	init( REDWOOD_LAZY_CLEAR_BATCH_SIZE_PAGES,                    10 );
 	init( REDWOOD_LAZY_CLEAR_MIN_PAGES,                            0 );
 	init( REDWOOD_LAZY_CLEAR_MAX_PAGES,                          1e6 );
+	init( REDWOOD_ENABLE_CLEAR_RANGE_EAGER_READS,               false ); if( randomize && BUGGIFY ) REDWOOD_ENABLE_CLEAR_RANGE_EAGER_READS = deterministicRandom()->coinflip();
 	init( REDWOOD_REMAP_CLEANUP_WINDOW_BYTES, 4LL * 1024 * 1024 * 1024 );
 	init( REDWOOD_REMAP_CLEANUP_TOLERANCE_RATIO,                0.05 );
 	init( REDWOOD_PAGEFILE_GROWTH_SIZE_PAGES,                  20000 ); if( randomize && BUGGIFY ) { REDWOOD_PAGEFILE_GROWTH_SIZE_PAGES = deterministicRandom()->randomInt(200, 1000); }
@@ -1199,13 +1286,28 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REDWOOD_HISTOGRAM_INTERVAL,                           30.0 );
 	init( REDWOOD_EVICT_UPDATED_PAGES,                          true ); if( randomize && BUGGIFY ) { REDWOOD_EVICT_UPDATED_PAGES = false; }
 	init( REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT,                    2 ); if( randomize && BUGGIFY ) { REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT = deterministicRandom()->randomInt(1, 7); }
+	init( REDWOOD_LEAF_SEARCH_INDEX,                           false ); if( randomize && BUGGIFY ) { REDWOOD_LEAF_SEARCH_INDEX = true; }
+	init( REDWOOD_PAGE_ENCODING_THREADS,                           0 ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_ENCODING_THREADS = deterministicRandom()->randomInt(1, 5); }
+	init( REDWOOD_PAGE_ALLOCATION_POOL_SIZE,                       0 ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_ALLOCATION_POOL_SIZE = deterministicRandom()->randomInt(2, 200); }
+	init( REDWOOD_LEAF_KEY_FILTER_MEMORY,                          0 ); if( randomize && BUGGIFY ) { REDWOOD_LEAF_KEY_FILTER_MEMORY = deterministicRandom()->randomInt(1, 1e6); }
+	init( REDWOOD_LEAF_KEY_FILTER_BITS_PER_KEY,                   10 ); if( randomize && BUGGIFY ) { REDWOOD_LEAF_KEY_FILTER_BITS_PER_KEY = deterministicRandom()->randomInt(1, 20); }
 	init( REDWOOD_NODE_MAX_UNBALANCE,                              2 );
 	init( REDWOOD_IO_PRIORITIES,                       "32,32,32,32" );
+	init( REDWOOD_PAGE_CACHE_SCAN_RESISTANT,                   false ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_CACHE_SCAN_RESISTANT = true; }
+	init( REDWOOD_PAGE_CACHE_PROTECTED_FRACTION,                0.75 ); if( randomize && BUGGIFY ) { REDWOOD_PAGE_CACHE_PROTECTED_FRACTION = deterministicRandom()->random01(); }
 
 	// Server request latency measurement
 	init( LATENCY_SKETCH_ACCURACY,                              0.01 );
 	init( FILE_LATENCY_SKETCH_ACCURACY,                         0.01 );
 	init( LATENCY_METRICS_LOGGING_INTERVAL,                     10.0 );
+	init( TENANT_LATENCY_MAX_TRACKED,                           1000 ); if( randomize && BUGGIFY ) TENANT_LATENCY_MAX_TRACKED = deterministicRandom()->randomInt(0, 10);
+	init( TENANT_LATENCY_SKETCH_ACCURACY,                       0.05 );
+	init( TENANT_LATENCY_EXPIRE_AFTER,                         240.0 );
+	init( TENANT_LATENCY_STATUS_TENANTS,                           5 );
+	init( TENANT_READ_LATENCY_SLO,                              0.01 );
+	init( TENANT_COMMIT_LATENCY_SLO,                             0.1 );
+	init( HOT_KEY_TRACKER_CAPACITY,                               64 ); if( randomize && BUGGIFY ) HOT_KEY_TRACKER_CAPACITY = deterministicRandom()->randomInt(0, 4);
+	init( HOT_KEY_TRACKER_WINDOW,                               60.0 ); if( randomize && BUGGIFY ) HOT_KEY_TRACKER_WINDOW = 1.0;
 
 	// Cluster recovery
 	init ( CLUSTER_RECOVERY_EVENT_NAME_PREFIX,              "Master" );
@@ -1213,6 +1315,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	// Encryption
 	init( SIM_KMS_MAX_KEYS,                                     4096 );
 	init( ENCRYPT_PROXY_MAX_DBG_TRACE_LENGTH,                 100000 );
+	init( ENCRYPT_PROXY_COALESCE_KMS_FETCHES,                   true ); if( randomize && BUGGIFY ) ENCRYPT_PROXY_COALESCE_KMS_FETCHES = false;
+	init( ENCRYPT_PROXY_SERVE_STALE_CIPHER_KEYS,                true ); if( randomize && BUGGIFY ) ENCRYPT_PROXY_SERVE_STALE_CIPHER_KEYS = false;
 
 	// encrypt key proxy
 	init( ENABLE_BLOB_GRANULE_COMPRESSION,                     false ); if ( randomize && BUGGIFY ) { ENABLE_BLOB_GRANULE_COMPRESSION = deterministicRandom()->coinflip(); }
@@ -1235,6 +1339,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BG_DELTA_BYTES_BEFORE_COMPACT, BG_SNAPSHOT_FILE_TARGET_BYTES/2 ); if ( randomize && BUGGIFY ) BG_DELTA_BYTES_BEFORE_COMPACT *= (1.0 + deterministicRandom()->random01() * 3.0)/2.0;
 	init( BG_DELTA_FILE_TARGET_BYTES,   BG_DELTA_BYTES_BEFORE_COMPACT/10 );
 	init( BG_DELTA_FILE_TARGET_CHUNK_BYTES,                  32*1024 ); if ( randomize && BUGGIFY ) BG_DELTA_FILE_TARGET_CHUNK_BYTES = BG_DELTA_FILE_TARGET_BYTES / (1 << deterministicRandom()->randomInt(0, 7));
+	init( BG_DELTA_FILE_COLUMNAR,                              false ); if ( randomize && BUGGIFY ) BG_DELTA_FILE_COLUMNAR = true;
+	init( BG_RESNAPSHOT_SLICE_BYTES,                         1<<20 ); if ( randomize && BUGGIFY ) BG_RESNAPSHOT_SLICE_BYTES = deterministicRandom()->coinflip() ? 1 : BG_SNAPSHOT_FILE_TARGET_CHUNK_BYTES * deterministicRandom()->randomInt(1, 4);
 	init( BG_MAX_SPLIT_FANOUT,                                    10 ); if( randomize && BUGGIFY ) BG_MAX_SPLIT_FANOUT = deterministicRandom()->randomInt(5, 15);
 	init( BG_MAX_MERGE_FANIN,                                     10 ); if( randomize && BUGGIFY ) BG_MAX_MERGE_FANIN = deterministicRandom()->randomInt(2, 15);
 	init( BG_HOT_SNAPSHOT_VERSIONS,                          5000000 );
@@ -1274,6 +1380,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( BLOB_WORKER_REJECT_WHEN_FULL_THRESHOLD,                0.9 );
 	init( BLOB_WORKER_FORCE_FLUSH_CLEANUP_DELAY,                30.0 ); if ( randomize && BUGGIFY ) BLOB_WORKER_FORCE_FLUSH_CLEANUP_DELAY = deterministicRandom()->randomInt(0, 10) - 1;
 	init( BLOB_WORKER_DISK_ENABLED,                            false ); if ( randomize && BUGGIFY ) BLOB_WORKER_DISK_ENABLED = true;
+	init( BLOB_WORKER_DISK_CACHE_BYTES,                            0 ); if ( randomize && BUGGIFY ) BLOB_WORKER_DISK_CACHE_BYTES = deterministicRandom()->randomInt(1, 10 << 20);
 	init( BLOB_WORKER_STORE_TYPE,                                  3 );
 	init( BLOB_WORKER_REJOIN_TIME,                              10.0 );
 
@@ -1337,6 +1444,10 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REST_KMS_STABILITY_CHECK_INTERVAL,                      5.0);
 
 	init( CONSISTENCY_SCAN_ACTIVE_THROTTLE_RATIO,                0.5 ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_ACTIVE_THROTTLE_RATIO = deterministicRandom()->random01();
+	init( CONSISTENCY_SCAN_CHECKSUM_BYTES,                       1e6 ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_CHECKSUM_BYTES = deterministicRandom()->coinflip() ? 0 : deterministicRandom()->randomInt(100, 1e6);
+	init( CONSISTENCY_SCAN_BUSYNESS_THRESHOLD,                   0.8 ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_BUSYNESS_THRESHOLD = deterministicRandom()->random01();
+	init( CONSISTENCY_SCAN_MIN_LOAD_FACTOR,                      0.1 ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_MIN_LOAD_FACTOR = 0.01;
+	init( CONSISTENCY_SCAN_LOAD_FACTOR_INCREASE,                 0.1 ); if( randomize && BUGGIFY ) CONSISTENCY_SCAN_LOAD_FACTOR_INCREASE = deterministicRandom()->random01();
 
 
 	init( FLOW_WITH_SWIFT,                                       false);
@@ -1351,6 +1462,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
  	init( IDEMPOTENCY_IDS_CLEANER_POLLING_INTERVAL,                10);
 	// Don't clean idempotency ids younger than this
  	init( IDEMPOTENCY_IDS_MIN_AGE_SECONDS,              3600 * 24 * 7);
+	// Hold expired idempotency id keys this long so that adjacent ones can be removed by a single range clear. 0
+	// clears each key as soon as all of its ids expire.
+	init( IDEMPOTENCY_ID_CLEAR_COALESCE_DELAY,                   0.5 ); if( randomize && BUGGIFY ) IDEMPOTENCY_ID_CLEAR_COALESCE_DELAY = deterministicRandom()->coinflip() ? 0 : 5;
 
 	// clang-format on
 
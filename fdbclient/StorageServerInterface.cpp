@@ -21,6 +21,7 @@
 // TODO this should really be renamed "TSSComparison.cpp"
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbclient/BlobWorkerInterface.h"
+#include "fdbclient/Tuple.h"
 #include "crc32/crc32c.h" // for crc32c_append, to checksum values in tss trace events
 
 // Includes template specializations for all tss operations on storage server types.
@@ -58,6 +59,37 @@ void TSS_traceMismatch(TraceEvent& event,
 	            tss.value.present() ? traceChecksumValue(tss.value.get()) : "missing");
 }
 
+// multi-key point reads
+template <>
+bool TSS_doCompare(const GetValuesReply& src, const GetValuesReply& tss) {
+	return src.values == tss.values;
+}
+
+template <>
+const char* LB_mismatchTraceName(const GetValuesRequest& req, const ComparisonType& type) {
+	return type == TSS_COMPARISON ? "TSSMismatchGetValues" : "ReplicaMismatchGetValues";
+}
+
+template <>
+void TSS_traceMismatch(TraceEvent& event,
+                       const GetValuesRequest& req,
+                       const GetValuesReply& src,
+                       const GetValuesReply& tss,
+                       const ComparisonType& type) {
+	int i = 0;
+	while (i < src.values.size() && i < tss.values.size() && src.values[i] == tss.values[i]) {
+		i++;
+	}
+	event.detail("Keys", req.keys.size())
+	    .detail("MismatchKey", i < req.keys.size() ? req.keys[i] : KeyRef())
+	    .detail("Tenant", req.tenantInfo.tenantId)
+	    .detail("Version", req.version)
+	    .detail(type == TSS_COMPARISON ? "SSReply" : "SourceSSReply",
+	            i < src.values.size() && src.values[i].present() ? traceChecksumValue(src.values[i].get()) : "missing")
+	    .detail(type == TSS_COMPARISON ? "TSSReply" : "ReplicaSSReply",
+	            i < tss.values.size() && tss.values[i].present() ? traceChecksumValue(tss.values[i].get()) : "missing");
+}
+
 // key selector reads
 template <>
 bool TSS_doCompare(const GetKeyReply& src, const GetKeyReply& tss) {
@@ -122,10 +154,115 @@ void TSS_traceMismatch(TraceEvent& event,
 	            format("%s%s:%d", tss.sel.orEqual ? "=" : "", tss.sel.getKey().printable().c_str(), tss.sel.offset));
 }
 
+void GetKeyValuesReply::compress(CompressionFilter filter) {
+	if (filter == CompressionFilter::NONE || compressionFilter != CompressionFilter::NONE || data.empty() ||
+	    !CompressionUtils::supportedFilters.count(filter)) {
+		return;
+	}
+	BinaryWriter wr(Unversioned());
+	wr << data;
+	StringRef compressed = CompressionUtils::compress(filter, wr.toValue(), arena);
+	if (compressed.size() >= wr.getLength()) {
+		return;
+	}
+	compressedData = compressed;
+	compressionFilter = filter;
+	data = VectorRef<KeyValueRef, VecSerStrategy::String>();
+}
+
+void GetKeyValuesReply::decompress() {
+	if (compressionFilter == CompressionFilter::NONE) {
+		return;
+	}
+	// Keys and values refer to the decompressed buffer, which is allocated in arena
+	ArenaReader rd(arena, CompressionUtils::decompress(compressionFilter, compressedData, arena), Unversioned());
+	rd >> data;
+	compressionFilter = CompressionFilter::NONE;
+	compressedData = StringRef();
+}
+
+void RangeAggregate::add(KeyValueRef const& kv) {
+	uint64_t value = 0;
+	for (int i = std::min(kv.value.size(), 8) - 1; i >= 0; i--) {
+		value = value << 8 | kv.value[i];
+	}
+	int64_t signedValue = static_cast<int64_t>(value);
+	count++;
+	bytes += kv.key.size() + kv.value.size();
+	sum = static_cast<int64_t>(static_cast<uint64_t>(sum) + value);
+	min = std::min(min.orDefault(signedValue), signedValue);
+	max = std::max(max.orDefault(signedValue), signedValue);
+}
+
+void RangeAggregate::merge(RangeAggregate const& other) {
+	count += other.count;
+	bytes += other.bytes;
+	sum = static_cast<int64_t>(static_cast<uint64_t>(sum) + static_cast<uint64_t>(other.sum));
+	if (other.min.present()) {
+		min = std::min(min.orDefault(other.min.get()), other.min.get());
+		max = std::max(max.orDefault(other.max.get()), other.max.get());
+	}
+}
+
+bool KeyValueFilterRef::matches(KeyValueRef const& kv) const {
+	if (kv.value.size() < minValueLength || kv.value.size() > maxValueLength) {
+		return false;
+	}
+	if (tupleElement < 0) {
+		return true;
+	}
+	if (kv.key.size() < tupleBegin) {
+		return false;
+	}
+	try {
+		Tuple tuple = Tuple::unpack(kv.key.substr(tupleBegin));
+		if (tupleElement >= tuple.size()) {
+			return false;
+		}
+		// The tuple encoding preserves order, so encoded elements compare as the elements do
+		StringRef element = tuple.subTupleRawString(tupleElement);
+		int c = element.compare(operand);
+		switch (comparison) {
+		case EQUAL:
+			return c == 0;
+		case NOT_EQUAL:
+			return c != 0;
+		case LESS:
+			return c < 0;
+		case LESS_OR_EQUAL:
+			return c <= 0;
+		case GREATER:
+			return c > 0;
+		case GREATER_OR_EQUAL:
+			return c >= 0;
+		case STARTS_WITH:
+			// A string element ends with a zero byte, which the prefix must not
+			return !operand.empty() && element.startsWith(operand.substr(0, operand.size() - 1));
+		default:
+			return false;
+		}
+	} catch (Error& e) {
+		// Keys that aren't tuples never match
+		return false;
+	}
+}
+
 // range reads
 template <>
 bool TSS_doCompare(const GetKeyValuesReply& src, const GetKeyValuesReply& tss) {
-	return src.more == tss.more && src.data == tss.data;
+	// Replicas compress the same data with the same filter the same way
+	if (src.aggregate.present() != tss.aggregate.present()) {
+		return false;
+	}
+	if (src.aggregate.present()) {
+		const RangeAggregate& a = src.aggregate.get();
+		const RangeAggregate& b = tss.aggregate.get();
+		if (a.count != b.count || a.bytes != b.bytes || a.sum != b.sum || a.min != b.min || a.max != b.max) {
+			return false;
+		}
+	}
+	return src.more == tss.more && src.data == tss.data && src.compressionFilter == tss.compressionFilter &&
+	       src.compressedData == tss.compressedData && src.readThrough == tss.readThrough;
 }
 
 template <>
@@ -311,6 +448,27 @@ void TSS_traceMismatch(TraceEvent& event,
 	ASSERT(false);
 }
 
+template <>
+bool TSS_doCompare(const WatchRangeReply& src, const WatchRangeReply& tss) {
+	// We duplicate watches just for load, no need to validate replies.
+	return true;
+}
+
+template <>
+const char* LB_mismatchTraceName(const WatchRangeRequest& req, const ComparisonType& type) {
+	ASSERT(false);
+	return "";
+}
+
+template <>
+void TSS_traceMismatch(TraceEvent& event,
+                       const WatchRangeRequest& req,
+                       const WatchRangeReply& src,
+                       const WatchRangeReply& tss,
+                       const ComparisonType& type) {
+	ASSERT(false);
+}
+
 template <>
 bool TSS_doCompare(const SplitMetricsReply& src, const SplitMetricsReply& tss) {
 	// We duplicate split metrics just for load, no need to validate replies.
@@ -449,6 +607,12 @@ void TSSMetrics::recordLatency(const GetValueRequest& req, double ssLatency, dou
 	TSSgetValueLatency.addSample(tssLatency);
 }
 
+template <>
+void TSSMetrics::recordLatency(const GetValuesRequest& req, double ssLatency, double tssLatency) {
+	SSgetValueLatency.addSample(ssLatency);
+	TSSgetValueLatency.addSample(tssLatency);
+}
+
 template <>
 void TSSMetrics::recordLatency(const GetKeyRequest& req, double ssLatency, double tssLatency) {
 	SSgetKeyLatency.addSample(ssLatency);
@@ -470,6 +634,9 @@ void TSSMetrics::recordLatency(const GetMappedKeyValuesRequest& req, double ssLa
 template <>
 void TSSMetrics::recordLatency(const WatchValueRequest& req, double ssLatency, double tssLatency) {}
 
+template <>
+void TSSMetrics::recordLatency(const WatchRangeRequest& req, double ssLatency, double tssLatency) {}
+
 template <>
 void TSSMetrics::recordLatency(const WaitMetricsRequest& req, double ssLatency, double tssLatency) {}
 
@@ -603,3 +770,163 @@ TEST_CASE("/StorageServerInterface/TSSCompare/TestComparison") {
 	ASSERT(checksumStart13 == traceChecksumValue(StringRef(s13)).substr(0, 4));
 	return Void();
 }
+
+TEST_CASE("/StorageServerInterface/GetKeyValuesReply/ZeroCopyDeserialize") {
+	std::string key = "key";
+	std::string value(1000, 'v');
+
+	GetKeyValuesReply in;
+	for (int i = 0; i < 10; i++) {
+		in.data.push_back_deep(in.arena, KeyValueRef(StringRef(key + std::to_string(i)), StringRef(value)));
+	}
+	in.more = true;
+
+	ObjectWriter writer(Unversioned());
+	writer.serialize(in);
+	Standalone<StringRef> packet = writer.toStringRef();
+
+	// Keys and values of the received reply must refer to the packet rather than to copies in the reply arena
+	GetKeyValuesReply out;
+	ArenaObjectReader reader(packet.arena(), packet, Unversioned());
+	reader.deserialize(out);
+	ASSERT(out.more);
+	ASSERT_EQ(out.data.size(), in.data.size());
+	for (int i = 0; i < out.data.size(); i++) {
+		ASSERT(out.data[i] == in.data[i]);
+		ASSERT(out.data[i].key.begin() >= packet.begin() && out.data[i].key.end() <= packet.end());
+		ASSERT(out.data[i].value.begin() >= packet.begin() && out.data[i].value.end() <= packet.end());
+	}
+	return Void();
+}
+
+TEST_CASE("/StorageServerInterface/GetKeyValuesReply/Compress") {
+	GetKeyValuesReply reply;
+	for (int i = 0; i < 100; i++) {
+		reply.data.push_back_deep(reply.arena,
+		                          KeyValueRef(StringRef("key" + std::to_string(i)), StringRef(std::string(100, 'v'))));
+	}
+	reply.more = true;
+	Standalone<VectorRef<KeyValueRef>> expected;
+	expected.append_deep(expected.arena(), reply.data.begin(), reply.data.size());
+
+	for (CompressionFilter filter : CompressionUtils::supportedFilters) {
+		GetKeyValuesReply in = reply;
+		in.compress(filter);
+		if (filter == CompressionFilter::NONE) {
+			ASSERT(in.compressionFilter == CompressionFilter::NONE);
+			continue;
+		}
+		ASSERT(in.compressionFilter == filter);
+		ASSERT(in.data.empty());
+
+		ObjectWriter writer(Unversioned());
+		writer.serialize(in);
+		Standalone<StringRef> packet = writer.toStringRef();
+		ASSERT_LT(packet.size(), expected.expectedSize());
+
+		GetKeyValuesReply out;
+		ArenaObjectReader reader(packet.arena(), packet, Unversioned());
+		reader.deserialize(out);
+		out.decompress();
+		ASSERT(out.compressionFilter == CompressionFilter::NONE);
+		ASSERT(out.more);
+		ASSERT(out.data.size() == expected.size());
+		for (int i = 0; i < expected.size(); i++) {
+			ASSERT(out.data[i] == expected[i]);
+		}
+	}
+	return Void();
+}
+
+TEST_CASE("/StorageServerInterface/KeyValueFilter/Matches") {
+	Arena arena;
+	auto row = [&arena](Tuple const& key, int valueLength) {
+		return KeyValueRef(StringRef(arena, "prefix/"_sr.withSuffix(key.pack())),
+		                   StringRef(arena, std::string(valueLength, 'v')));
+	};
+	KeyValueRef appleRow = row(Tuple::makeTuple("apple"_sr, 5), 10);
+	KeyValueRef pearRow = row(Tuple::makeTuple("pear"_sr, -3), 20);
+	KeyValueRef shortRow = row(Tuple::makeTuple("fig"_sr), 0);
+	KeyValueRef notTuple("prefix/\xff\xff"_sr, "v"_sr);
+
+	KeyValueFilterRef filter;
+	ASSERT(filter.matches(appleRow) && filter.matches(notTuple));
+	filter.minValueLength = 15;
+	ASSERT(!filter.matches(appleRow) && filter.matches(pearRow));
+	filter.minValueLength = 0;
+	filter.maxValueLength = 0;
+	ASSERT(!filter.matches(appleRow) && filter.matches(shortRow));
+
+	filter = KeyValueFilterRef();
+	filter.tupleBegin = 7;
+	filter.tupleElement = 1;
+	filter.operand = StringRef(arena, Tuple::makeTuple(0).pack());
+	filter.comparison = KeyValueFilterRef::GREATER;
+	ASSERT(filter.matches(appleRow) && !filter.matches(pearRow));
+	// Missing elements and keys that aren't tuples don't match
+	ASSERT(!filter.matches(shortRow) && !filter.matches(notTuple));
+	filter.comparison = KeyValueFilterRef::LESS_OR_EQUAL;
+	ASSERT(!filter.matches(appleRow) && filter.matches(pearRow));
+
+	filter.tupleElement = 0;
+	filter.operand = StringRef(arena, Tuple::makeTuple("pe"_sr).pack());
+	filter.comparison = KeyValueFilterRef::STARTS_WITH;
+	ASSERT(!filter.matches(appleRow) && filter.matches(pearRow));
+	filter.operand = StringRef(arena, Tuple::makeTuple("pear"_sr).pack());
+	filter.comparison = KeyValueFilterRef::EQUAL;
+	ASSERT(!filter.matches(appleRow) && filter.matches(pearRow));
+	filter.comparison = KeyValueFilterRef::NOT_EQUAL;
+	ASSERT(filter.matches(appleRow) && !filter.matches(pearRow));
+
+	// The filter survives serialization with the request
+	GetKeyValuesRequest req;
+	req.filter = KeyValueFilterRef(req.arena, filter);
+	ObjectWriter writer(Unversioned());
+	writer.serialize(req);
+	Standalone<StringRef> packet = writer.toStringRef();
+	GetKeyValuesRequest out;
+	ArenaObjectReader reader(packet.arena(), packet, Unversioned());
+	reader.deserialize(out);
+	ASSERT(out.filter.present() && out.filter.get().operand == filter.operand);
+	ASSERT(out.filter.get().tupleBegin == 7 && out.filter.get().comparison == KeyValueFilterRef::NOT_EQUAL);
+	ASSERT(!out.filter.get().matches(pearRow));
+	return Void();
+}
+
+TEST_CASE("/StorageServerInterface/RangeAggregate/AddAndMerge") {
+	Arena arena;
+	auto row = [&arena](const char* key, std::vector<uint8_t> value) {
+		return KeyValueRef(StringRef(arena, StringRef(key)),
+		                   StringRef(arena, StringRef(value.data(), value.size())));
+	};
+
+	RangeAggregate first;
+	first.add(row("a", { 5 }));
+	first.add(row("b", { 0, 1 }));
+	ASSERT_EQ(first.count, 2);
+	ASSERT_EQ(first.bytes, 5);
+	ASSERT_EQ(first.sum, 261);
+	ASSERT(first.min.get() == 5 && first.max.get() == 256);
+
+	// Empty values count as zero, and only the low 8 bytes of long values are added, as ADD does
+	RangeAggregate second;
+	second.add(row("c", {}));
+	second.add(row("d", { 1, 0, 0, 0, 0, 0, 0, 0, 9 }));
+	ASSERT_EQ(second.sum, 1);
+	ASSERT(second.min.get() == 0 && second.max.get() == 1);
+
+	first.merge(second);
+	first.merge(RangeAggregate());
+	ASSERT_EQ(first.count, 4);
+	ASSERT_EQ(first.bytes, 16);
+	ASSERT_EQ(first.sum, 262);
+	ASSERT(first.min.get() == 0 && first.max.get() == 256);
+
+	// Sums wrap around
+	RangeAggregate wrap;
+	wrap.add(row("e", { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff }));
+	wrap.add(row("f", { 2 }));
+	ASSERT_EQ(wrap.sum, 1);
+	ASSERT_EQ(wrap.min.get(), -1);
+	return Void();
+}
@@ -2029,6 +2029,39 @@ const Key blobManifestVersionKey = "\xff\x02/blobManifestVersion"_sr;
 const KeyRangeRef idempotencyIdKeys("\xff\x02/idmp/"_sr, "\xff\x02/idmp0"_sr);
 const KeyRef idempotencyIdsExpiredVersion("\xff\x02/idmpExpiredVersion"_sr);
 
+const KeyRangeRef pinnedReadVersionKeys("\xff\x02/pinnedReadVersions/"_sr, "\xff\x02/pinnedReadVersions0"_sr);
+const KeyRef pinnedReadVersionsChangeKey("\xff\x02/pinnedReadVersionsChange"_sr);
+
+const Key pinnedReadVersionKeyFor(UID id) {
+	BinaryWriter wr(Unversioned());
+	wr.serializeBytes(pinnedReadVersionKeys.begin);
+	wr << id;
+	return wr.toValue();
+}
+
+UID decodePinnedReadVersionKey(KeyRef const& key) {
+	UID id;
+	BinaryReader reader(key.removePrefix(pinnedReadVersionKeys.begin), Unversioned());
+	reader >> id;
+	return id;
+}
+
+const Value pinnedReadVersionValue(Version version, Version expireVersion) {
+	BinaryWriter wr(Unversioned());
+	wr << version;
+	wr << expireVersion;
+	return wr.toValue();
+}
+
+std::pair<Version, Version> decodePinnedReadVersionValue(ValueRef const& value) {
+	Version version;
+	Version expireVersion;
+	BinaryReader reader(value, Unversioned());
+	reader >> version;
+	reader >> expireVersion;
+	return std::make_pair(version, expireVersion);
+}
+
 // for tests
 void testSSISerdes(StorageServerInterface const& ssi) {
 	printf("ssi=\nid=%s\nlocality=%s\nisTss=%s\ntssId=%s\nacceptingRequests=%s\naddress=%s\ngetValue=%s\n\n\n",
@@ -240,8 +240,77 @@ public:
 		}
 
 		// Now we know the task key is present and we have the available space for the task's priority
-		state Tuple t = availableSpace.unpack(taskKey.get());
-		state Key taskUID = t.getString(0);
+		Key taskUID = availableSpace.unpack(taskKey.get()).getString(0);
+		Reference<Task> task = wait(claimTask(tr, taskBucket, availableSpace, taskUID));
+		return task;
+	}
+
+	// Claims up to maxTasks distinct tasks in a single transaction, highest priority first. Each wanted task gets its
+	// own random starting point in the available space, so concurrent agents mostly pick disjoint tasks and an agent
+	// pays for one commit per batch instead of one per task.
+	ACTOR static Future<std::vector<Reference<Task>>> getMany(Reference<ReadYourWritesTransaction> tr,
+	                                                          Reference<TaskBucket> taskBucket,
+	                                                          int maxTasks) {
+		if (taskBucket->priority_batch)
+			tr->setOption(FDBTransactionOptions::PRIORITY_BATCH);
+
+		taskBucket->setOptions(tr);
+
+		if (deterministicRandom()->random01() < CLIENT_KNOBS->TASKBUCKET_CHECK_TIMEOUT_CHANCE) {
+			bool anyTimeouts = wait(requeueTimedOutTasks(tr, taskBucket));
+			CODE_PROBE(anyTimeouts, "Found a task that timed out while claiming a batch");
+		}
+
+		// Samples that land on the same task collapse into a single claim
+		state std::vector<std::pair<Key, int>> taskUIDs;
+		state std::set<Key> seenUIDs;
+		state std::vector<Future<Optional<Key>>> samples;
+		state int pri;
+		for (pri = CLIENT_KNOBS->TASKBUCKET_MAX_PRIORITY; pri >= 0 && taskUIDs.size() < maxTasks; --pri) {
+			samples.clear();
+			for (int i = taskUIDs.size(); i < maxTasks; ++i)
+				samples.push_back(getTaskKey(tr, taskBucket, pri));
+			wait(waitForAll(samples));
+
+			Subspace availableSpace = taskBucket->getAvailableSpace(pri);
+			for (auto& sample : samples) {
+				if (!sample.get().present())
+					continue;
+				Key taskUID = availableSpace.unpack(sample.get().get()).getString(0);
+				if (seenUIDs.insert(taskUID).second)
+					taskUIDs.emplace_back(taskUID, pri);
+			}
+		}
+
+		if (taskUIDs.empty()) {
+			bool anyTimeouts = wait(requeueTimedOutTasks(tr, taskBucket));
+			if (anyTimeouts) {
+				CODE_PROBE(true, "Try to claim a batch of tasks from timeouts subspace");
+				std::vector<Reference<Task>> tasks = wait(getMany(tr, taskBucket, maxTasks));
+				return tasks;
+			}
+			return std::vector<Reference<Task>>();
+		}
+
+		CODE_PROBE(taskUIDs.size() > 1, "Claimed a batch of tasks in one transaction");
+		state std::vector<Future<Reference<Task>>> claims;
+		for (auto& [taskUID, taskPriority] : taskUIDs)
+			claims.push_back(claimTask(tr, taskBucket, taskBucket->getAvailableSpace(taskPriority), taskUID));
+		wait(waitForAll(claims));
+
+		std::vector<Reference<Task>> tasks;
+		tasks.reserve(claims.size());
+		for (auto& claim : claims)
+			tasks.push_back(claim.get());
+		return tasks;
+	}
+
+	// Moves the task out of the available space into the timeout space, which makes it owned by the caller until the
+	// timeout version is reached.
+	ACTOR static Future<Reference<Task>> claimTask(Reference<ReadYourWritesTransaction> tr,
+	                                               Reference<TaskBucket> taskBucket,
+	                                               Subspace availableSpace,
+	                                               Key taskUID) {
 		state Subspace taskAvailableSpace = availableSpace.get(taskUID);
 
 		state Reference<Task> task(new Task());
@@ -491,18 +560,41 @@ public:
 			availableSlots.push_back(i);
 
 		state std::vector<Future<Reference<Task>>> getTasks;
+		state Future<std::vector<Reference<Task>>> getBatch;
 		state unsigned int getBatchSize = 1;
+		state int wanted;
 
 		loop {
 			// Start running tasks while slots are available and we keep finding work to do
 			++taskBucket->dispatchSlotChecksStarted;
 			while (!availableSlots.empty()) {
+				wanted = std::min<unsigned int>(getBatchSize, availableSlots.size());
 				getTasks.clear();
-				for (int i = 0, imax = std::min<unsigned int>(getBatchSize, availableSlots.size()); i < imax; ++i)
-					getTasks.push_back(taskBucket->getOne(cx));
-				wait(waitForAllReady(getTasks));
+				if (CLIENT_KNOBS->TASKBUCKET_BATCH_CLAIM) {
+					getBatch = taskBucket->getMany(cx, wanted);
+					wait(ready(getBatch));
+				} else {
+					for (int i = 0; i < wanted; ++i)
+						getTasks.push_back(taskBucket->getOne(cx));
+					wait(waitForAllReady(getTasks));
+				}
 
 				bool done = false;
+				if (CLIENT_KNOBS->TASKBUCKET_BATCH_CLAIM) {
+					if (getBatch.isError()) {
+						++taskBucket->dispatchErrors;
+						done = true;
+					} else {
+						// A short batch only means samples collided, the bucket is drained once nothing was claimed
+						for (auto& task : getBatch.get())
+							getTasks.push_back(task);
+						if (getBatch.get().empty()) {
+							++taskBucket->dispatchEmptyTasks;
+							done = true;
+						}
+					}
+				}
+
 				for (int i = 0; i < getTasks.size(); ++i) {
 					if (getTasks[i].isError()) {
 						++taskBucket->dispatchErrors;
@@ -964,6 +1056,10 @@ Future<Reference<Task>> TaskBucket::getOne(Reference<ReadYourWritesTransaction>
 	return TaskBucketImpl::getOne(tr, Reference<TaskBucket>::addRef(this));
 }
 
+Future<std::vector<Reference<Task>>> TaskBucket::getMany(Reference<ReadYourWritesTransaction> tr, int maxTasks) {
+	return TaskBucketImpl::getMany(tr, Reference<TaskBucket>::addRef(this), maxTasks);
+}
+
 Future<bool> TaskBucket::doOne(Database cx, Reference<FutureBucket> futureBucket) {
 	return TaskBucketImpl::doOne(cx, Reference<TaskBucket>::addRef(this), futureBucket);
 }
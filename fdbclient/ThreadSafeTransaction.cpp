@@ -244,6 +244,16 @@ ThreadFuture<Standalone<StringRef>> ThreadSafeDatabase::getClientStatus() {
 	return onMainThread([db] { return Future<Standalone<StringRef>>(db->getClientStatus()); });
 }
 
+ThreadFuture<Standalone<StringRef>> ThreadSafeDatabase::getMetrics() {
+	DatabaseContext* db = this->db;
+	return onMainThread([db] { return Future<Standalone<StringRef>>(db->getMetrics()); });
+}
+
+ThreadFuture<Standalone<StringRef>> ThreadSafeDatabase::getTransactionProfiles() {
+	DatabaseContext* db = this->db;
+	return onMainThread([db] { return Future<Standalone<StringRef>>(db->getTransactionProfiles()); });
+}
+
 ThreadSafeDatabase::~ThreadSafeDatabase() {
 	DatabaseContext* db = this->db;
 	onMainThreadVoid([db]() { db->delref(); });
@@ -433,6 +443,83 @@ ThreadFuture<Optional<Value>> ThreadSafeTransaction::get(const KeyRef& key, bool
 	});
 }
 
+ThreadFuture<RangeResult> ThreadSafeTransaction::getMulti(const VectorRef<KeyRef>& keys, bool snapshot) {
+	Standalone<VectorRef<KeyRef>> k;
+	k.append_deep(k.arena(), keys.begin(), keys.size());
+
+	ISingleThreadTransaction* tr = this->tr;
+	return onMainThread([tr, k, snapshot]() -> Future<RangeResult> {
+		tr->checkDeferredError();
+		return tr->getMulti(k, Snapshot{ snapshot });
+	});
+}
+
+ThreadFuture<RangeResult> ThreadSafeTransaction::batch(const VectorRef<BatchOperationRef>& operations, bool snapshot) {
+	Standalone<VectorRef<BatchOperationRef>> ops;
+	ops.append_deep(ops.arena(), operations.begin(), operations.size());
+
+	ISingleThreadTransaction* tr = this->tr;
+	return onMainThread([tr, ops, snapshot]() -> Future<RangeResult> {
+		tr->checkDeferredError();
+
+		// A multi-get looks up its keys in the writes once their values are read, so the reads can only be combined
+		// into one if none of the writes come after them
+		int firstRead = ops.size(), lastWrite = -1;
+		for (int i = 0; i < ops.size(); i++) {
+			if (ops[i].type == BatchOperationRef::GET) {
+				firstRead = std::min(firstRead, i);
+			} else {
+				lastWrite = i;
+			}
+		}
+		bool multiGet = firstRead > lastWrite;
+
+		Standalone<VectorRef<KeyRef>> keys;
+		keys.arena().dependsOn(ops.arena());
+		std::vector<Future<Optional<Value>>> values;
+		for (auto const& op : ops) {
+			if (op.type == BatchOperationRef::GET) {
+				keys.push_back(keys.arena(), op.key);
+				if (!multiGet) {
+					values.push_back(tr->get(Key(op.key, ops.arena()), Snapshot{ snapshot }));
+				}
+				continue;
+			}
+			// As for writes made on their own, an error in one fails the commit as well
+			try {
+				switch (op.type) {
+				case BatchOperationRef::SET:
+					tr->set(op.key, op.param);
+					break;
+				case BatchOperationRef::CLEAR:
+					tr->clear(op.key);
+					break;
+				case BatchOperationRef::CLEAR_RANGE:
+					if (op.key > op.param)
+						throw inverted_range();
+					tr->clear(KeyRangeRef(op.key, op.param));
+					break;
+				case BatchOperationRef::ATOMIC_OP:
+					tr->atomicOp(op.key, op.param, op.operationType);
+					break;
+				default:
+					throw client_invalid_operation();
+				}
+			} catch (Error& e) {
+				tr->deferredError = e;
+				throw;
+			}
+		}
+		if (keys.empty()) {
+			return RangeResult();
+		}
+		if (multiGet) {
+			return tr->getMulti(keys, Snapshot{ snapshot });
+		}
+		return getMultiFromValues(keys, values);
+	});
+}
+
 ThreadFuture<Key> ThreadSafeTransaction::getKey(const KeySelectorRef& key, bool snapshot) {
 	KeySelector k = key;
 
@@ -511,6 +598,51 @@ ThreadFuture<MappedRangeResult> ThreadSafeTransaction::getMappedRange(const KeyS
 	});
 }
 
+ThreadSafeRangeStream::ThreadSafeRangeStream(ISingleThreadTransaction* tr,
+                                             KeySelector begin,
+                                             KeySelector end,
+                                             bool snapshot)
+  : state(new State()) {
+	State* state = this->state;
+	onMainThreadVoid([state, tr, begin, end, snapshot]() {
+		state->tr = Reference<ISingleThreadTransaction>::addRef(tr);
+		try {
+			tr->checkDeferredError();
+			state->reader =
+			    forwardErrors(tr->getRangeStream(state->results, begin, end, Snapshot{ snapshot }), state->results);
+		} catch (Error& e) {
+			state->results.sendError(e);
+		}
+	});
+}
+
+ThreadSafeRangeStream::~ThreadSafeRangeStream() {
+	State* state = this->state;
+	onMainThreadVoid([state]() { delete state; });
+}
+
+ThreadFuture<RangeResult> ThreadSafeRangeStream::next() {
+	State* state = this->state;
+	return onMainThread([state]() -> Future<RangeResult> {
+		return map(errorOr(waitAndForward(state->results.getFuture())), [](ErrorOr<RangeResult> chunk) {
+			if (chunk.isError()) {
+				if (chunk.getError().code() != error_code_end_of_stream) {
+					throw chunk.getError();
+				}
+				// The end of the range, as the chunks themselves always have more set
+				return RangeResult();
+			}
+			return chunk.get();
+		});
+	});
+}
+
+Reference<IRangeStream> ThreadSafeTransaction::getRangeStream(const KeySelectorRef& begin,
+                                                              const KeySelectorRef& end,
+                                                              bool snapshot) {
+	return makeReference<ThreadSafeRangeStream>(tr, KeySelector(begin), KeySelector(end), snapshot);
+}
+
 ThreadFuture<Standalone<VectorRef<const char*>>> ThreadSafeTransaction::getAddressesForKey(const KeyRef& key) {
 	Key k = key;
 
@@ -656,6 +788,16 @@ ThreadFuture<Void> ThreadSafeTransaction::watch(const KeyRef& key) {
 	});
 }
 
+ThreadFuture<Void> ThreadSafeTransaction::watchRange(const KeyRangeRef& range) {
+	KeyRange r = range;
+
+	ISingleThreadTransaction* tr = this->tr;
+	return onMainThread([tr, r]() -> Future<Void> {
+		tr->checkDeferredError();
+		return tr->watchRange(r);
+	});
+}
+
 void ThreadSafeTransaction::addWriteConflictRange(const KeyRangeRef& keys) {
 	KeyRange r = keys;
 
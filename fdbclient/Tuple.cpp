@@ -38,10 +38,21 @@ static double bigEndianDouble(double orig) {
 	return *(double*)&big;
 }
 
+// Strings are scanned for their escapes with memchr, which the C library vectorizes, so the bytes between them (usually
+// all of a string) are skipped many at a time rather than checked one by one.
 static size_t findStringTerminator(const StringRef data, size_t offset) {
+	size_t size = data.size();
 	size_t i = offset;
-	while (i < data.size() - 1 && !(data[i] == '\x00' && data[i + 1] != (uint8_t)'\xff')) {
-		i += (data[i] == '\x00' ? 2 : 1);
+	while (i + 1 < size) {
+		const uint8_t* zero = (const uint8_t*)memchr(data.begin() + i, '\x00', size - 1 - i);
+		if (!zero) {
+			return size - 1;
+		}
+		i = zero - data.begin();
+		if (data[i + 1] != (uint8_t)'\xff') {
+			return i;
+		}
+		i += 2;
 	}
 
 	return i;
@@ -174,17 +185,16 @@ Tuple& Tuple::append(StringRef const& str, bool utf8) {
 	const uint8_t utfChar = uint8_t(utf8 ? '\x02' : '\x01');
 	data.append(data.arena(), &utfChar, 1);
 
-	size_t lastPos = 0;
-	for (size_t pos = 0; pos < str.size(); ++pos) {
-		if (str[pos] == '\x00') {
-			data.append(data.arena(), str.begin() + lastPos, pos - lastPos);
-			data.push_back(data.arena(), (uint8_t)'\x00');
-			data.push_back(data.arena(), (uint8_t)'\xff');
-			lastPos = pos + 1;
-		}
+	const uint8_t* pos = str.begin();
+	const uint8_t* zero;
+	while (pos != str.end() && (zero = (const uint8_t*)memchr(pos, '\x00', str.end() - pos))) {
+		data.append(data.arena(), pos, zero - pos);
+		data.push_back(data.arena(), (uint8_t)'\x00');
+		data.push_back(data.arena(), (uint8_t)'\xff');
+		pos = zero + 1;
 	}
 
-	data.append(data.arena(), str.begin() + lastPos, str.size() - lastPos);
+	data.append(data.arena(), pos, str.end() - pos);
 	data.push_back(data.arena(), (uint8_t)'\x00');
 
 	return *this;
@@ -333,15 +343,17 @@ Standalone<StringRef> Tuple::getString(size_t index) const {
 	Standalone<StringRef> result;
 	VectorRef<uint8_t> staging;
 
-	for (size_t i = b; i < e; ++i) {
-		if (data[i] == '\x00') {
-			staging.append(result.arena(), data.begin() + b, i - b);
-			++i;
-			b = i + 1;
+	while (b < e) {
+		const uint8_t* zero = (const uint8_t*)memchr(data.begin() + b, '\x00', e - b);
+		if (!zero) {
+			break;
+		}
+		size_t i = zero - data.begin();
+		staging.append(result.arena(), data.begin() + b, i - b);
+		b = i + 2;
 
-			if (i < e) {
-				staging.push_back(result.arena(), '\x00');
-			}
+		if (i + 1 < e) {
+			staging.push_back(result.arena(), '\x00');
 		}
 	}
 
@@ -601,3 +613,32 @@ TEST_CASE("/fdbclient/Tuple/unpack") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbclient/Tuple/escapedStrings") {
+	const char bytes[] = { '\x00', '\xff', '\x01', 'a' };
+	for (int i = 0; i < 1000; i++) {
+		std::string s;
+		int length = deterministicRandom()->randomInt(0, 50);
+		for (int j = 0; j < length; j++) {
+			s.push_back(bytes[deterministicRandom()->randomInt(0, 4)]);
+		}
+		StringRef str(s);
+
+		std::string escaped = "\x01";
+		for (char c : s) {
+			escaped += c == '\x00' ? std::string("\x00\xff", 2) : std::string(1, c);
+		}
+		escaped.push_back('\x00');
+
+		Standalone<StringRef> packed = Tuple::makeTuple(str, 1, str).pack();
+		ASSERT(packed.substr(0, escaped.size()) == StringRef(escaped));
+
+		Tuple t = Tuple::unpack(packed);
+		ASSERT_EQ(t.size(), 3);
+		ASSERT(t.getString(0) == str);
+		ASSERT_EQ(t.getInt(1), 1);
+		ASSERT(t.getString(2) == str);
+	}
+
+	return Void();
+}
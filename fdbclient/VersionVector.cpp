@@ -375,6 +375,67 @@ TEST_CASE("/fdbclient/VersionVector/testI") {
 	return Void();
 }
 
+// The delta since a version must hold exactly the entries set after it, whether
+// the version vector tracked its updates or was deserialized.
+void checkDelta(const VersionVector& vv, Version refVersion) {
+	VersionVector delta;
+	vv.getDelta(refVersion, delta);
+	if (refVersion == vv.getMaxVersion()) {
+		ASSERT(delta.getMaxVersion() == invalidVersion);
+		return;
+	}
+	ASSERT(delta.getMaxVersion() == vv.getMaxVersion());
+	int expected = 0;
+	for (const auto& [tag, version] : vv.versions) {
+		if (version > refVersion) {
+			++expected;
+			ASSERT(delta.hasVersion(tag) && delta.getVersion(tag) == version);
+		}
+	}
+	ASSERT(delta.size() == expected);
+}
+
+TEST_CASE("/fdbclient/VersionVector/delta") {
+	Arena arena;
+	TestContextArena context{ arena };
+
+	VersionVector vv(100);
+	VersionVector cache; // a GRV proxy's copy, kept up to date with deltas
+	Version version = 100;
+	for (int i = 0; i < 1000; i++) {
+		Version cached = cache.getMaxVersion() == invalidVersion ? vv.getMaxVersion() : cache.getMaxVersion();
+		if (deterministicRandom()->coinflip()) {
+			vv.setVersion(Tag(deterministicRandom()->randomInt(0, 2), deterministicRandom()->randomInt(0, 50)),
+			              ++version);
+		} else {
+			std::set<Tag> tags;
+			for (int j = deterministicRandom()->randomInt(1, 5); j > 0; j--) {
+				tags.emplace(deterministicRandom()->randomInt(0, 2), deterministicRandom()->randomInt(0, 50));
+			}
+			vv.setVersion(tags, ++version);
+		}
+		VersionVector delta;
+		vv.getDelta(cached, delta);
+		cache.applyDelta(delta);
+		ASSERT(cache.compare(vv));
+
+		Version refVersion = deterministicRandom()->randomInt64(100, version + 1);
+		checkDelta(vv, refVersion);
+		checkDelta(cache, refVersion);
+	}
+
+	size_t size = dynamic_size_traits<VersionVector>::size(vv, context);
+	uint8_t* buf = context.allocate(size);
+	dynamic_size_traits<VersionVector>::save(buf, vv, context);
+	VersionVector deserializedVV;
+	dynamic_size_traits<VersionVector>::load(buf, size, deserializedVV, context);
+	for (Version refVersion = 100; refVersion <= version; refVersion += 7) {
+		checkDelta(deserializedVV, refVersion);
+	}
+
+	return Void();
+}
+
 } // namespace unit_tests
 
 void forceLinkVersionVectorTests() {}
@@ -19,12 +19,13 @@
  */
 
 #include "fdbclient/VersionedMap.h"
+#include "fdbclient/VersionedBTreeMap.h"
 #include "flow/TreeBenchmark.h"
 #include "flow/UnitTest.h"
 
-template <typename K>
+template <typename K, template <class, class> class Map = VersionedMap>
 struct VersionedMapHarness {
-	using map = VersionedMap<K, int>;
+	using map = Map<K, int>;
 	using key_type = K;
 
 	struct result {
@@ -74,4 +75,88 @@ TEST_CASE("performance/map/StringRef/VersionedMap") {
 	return Void();
 }
 
+TEST_CASE("performance/map/int/VersionedBTreeMap") {
+	VersionedMapHarness<int, VersionedBTreeMap> tree;
+
+	treeBenchmark(tree, *randomInt);
+
+	return Void();
+}
+
+TEST_CASE("performance/map/StringRef/VersionedBTreeMap") {
+	Arena arena;
+	VersionedMapHarness<StringRef, VersionedBTreeMap> tree;
+
+	treeBenchmark(tree, [&arena]() { return randomStr(arena); });
+
+	return Void();
+}
+
+// Applies the same random inserts and erases to a VersionedBTreeMap and a VersionedMap, and checks that every
+// retained version reads the same from both
+TEST_CASE("/fdbclient/VersionedBTreeMap/correctness") {
+	VersionedMap<int, int> expected;
+	VersionedBTreeMap<int, int> actual;
+	const int keySpace = deterministicRandom()->randomInt(10, 5000);
+	const int versions = deterministicRandom()->randomInt(10, 200);
+	const int window = deterministicRandom()->randomInt(1, 20);
+
+	auto check = [&](Version v) {
+		auto e = expected.at(v);
+		auto a = actual.at(v);
+		auto ei = e.begin();
+		auto ai = a.begin();
+		for (; ei != e.end(); ++ei, ++ai) {
+			ASSERT(ai != a.end());
+			ASSERT(ai.key() == ei.key() && *ai == *ei && ai.insertVersion() == ei.insertVersion());
+		}
+		ASSERT(ai == a.end());
+		a.validate();
+
+		for (int i = 0; i < 20; ++i) {
+			int k = deterministicRandom()->randomInt(-1, keySpace + 1);
+			auto same = [](auto const& ei, auto const& ai) {
+				return bool(ei) == bool(ai) && (!ei || ei.key() == ai.key());
+			};
+			ASSERT(same(e.lower_bound(k), a.lower_bound(k)));
+			ASSERT(same(e.upper_bound(k), a.upper_bound(k)));
+			ASSERT(same(e.lastLessOrEqual(k), a.lastLessOrEqual(k)));
+			ASSERT(same(e.lastLess(k), a.lastLess(k)));
+			ASSERT(bool(e.find(k)) == bool(a.find(k)));
+		}
+	};
+
+	for (Version v = 1; v <= versions; ++v) {
+		expected.createNewVersion(v);
+		actual.createNewVersion(v);
+		int changes = deterministicRandom()->randomInt(0, 200);
+		for (int i = 0; i < changes; ++i) {
+			int k = deterministicRandom()->randomInt(0, keySpace);
+			double r = deterministicRandom()->random01();
+			if (r < 0.8) {
+				int value = deterministicRandom()->randomInt(0, 1000);
+				expected.insert(k, value);
+				actual.insert(k, value);
+			} else if (r < 0.9) {
+				int end = k + deterministicRandom()->randomInt(1, std::max(2, keySpace / 10));
+				expected.erase(k, end);
+				actual.erase(k, end);
+			} else if (expected.atLatest().find(k)) {
+				expected.erase(k);
+				actual.erase(k);
+			}
+		}
+
+		Version oldest = std::max<Version>(0, v - window);
+		if (oldest > expected.getOldestVersion()) {
+			expected.forgetVersionsBefore(oldest);
+			actual.forgetVersionsBefore(oldest);
+		}
+		check(v);
+		check(deterministicRandom()->randomInt64(actual.getOldestVersion(), v + 1));
+	}
+
+	return Void();
+}
+
 void forceLinkVersionedMapTests() {}
@@ -594,3 +594,32 @@ void WriteMap::clearNoConflict(KeyRangeRef keys) {
 		    WriteMapEntry(
 		        keys.end, OperationStack(), end_cleared, end_conflict, end_conflict, end_unreadable, end_unreadable));
 }
+
+void BlindWriteLog::coalesce() {
+	std::stable_sort(entries.begin(), entries.end(), [](Entry const& a, Entry const& b) { return a.key < b.key; });
+
+	int out = 0;
+	for (int begin = 0; begin < entries.size();) {
+		int end = begin + 1;
+		while (end < entries.size() && entries[end].key == entries[begin].key) {
+			++end;
+		}
+		// Everything before the last write that doesn't depend on the value beneath it is overwritten by that write
+		int first = begin;
+		bool addConflict = false;
+		for (int i = begin; i < end; ++i) {
+			addConflict = addConflict || entries[i].addConflict;
+			if (entries[i].type == MutationRef::SetValue || entries[i].type == MutationRef::ClearRange ||
+			    entries[i].type == MutationRef::SetVersionstampedValue) {
+				first = i;
+			}
+		}
+		for (int i = first; i < end; ++i) {
+			entries[out] = entries[i];
+			entries[out].addConflict = i == first && addConflict;
+			++out;
+		}
+		begin = end;
+	}
+	entries.resize(out);
+}
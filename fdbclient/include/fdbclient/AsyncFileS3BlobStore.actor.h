@@ -54,7 +54,8 @@ static Future<T> joinErrorGroup(Future<T> f, Promise<Void> p) {
 // This class represents a write-only file that lives in an S3-style blob store.  It writes using the REST API,
 // using multi-part upload and beginning to transfer each part as soon as it is large enough.
 // All write operations file operations must be sequential and contiguous.
-// Limits on part sizes, upload speed, and concurrent uploads are taken from the S3BlobStoreEndpoint being used.
+// Limits on part sizes, upload speed, and concurrent uploads are taken from the S3BlobStoreEndpoint being used, which
+// also picks the size of each part and how many to upload at once when it tunes uploads adaptively.
 class AsyncFileS3BlobStoreWrite final : public IAsyncFile, public ReferenceCounted<AsyncFileS3BlobStoreWrite> {
 public:
 	void addref() override { ReferenceCounted<AsyncFileS3BlobStoreWrite>::addref(); }
@@ -63,8 +64,8 @@ public:
 	virtual StringRef getClassName() override { return "AsyncFileS3BlobStoreWrite"_sr; }
 
 	struct Part : ReferenceCounted<Part> {
-		Part(int n, int minSize)
-		  : number(n), writer(content.getWriteBuffer(minSize), nullptr, Unversioned()), length(0) {
+		Part(int n, int size)
+		  : number(n), writer(content.getWriteBuffer(size), nullptr, Unversioned()), length(0), size(size) {
 			etag = std::string();
 			::MD5_Init(&content_md5_buf);
 		}
@@ -75,6 +76,8 @@ public:
 		std::string md5string;
 		PacketWriter writer;
 		int length;
+		// The length at which the part is ended and uploaded
+		int size;
 		void write(const uint8_t* buf, int len) {
 			writer.serializeBytes(buf, len);
 			::MD5_Update(&content_md5_buf, buf, len);
@@ -99,11 +102,10 @@ public:
 
 	ACTOR static Future<Void> write_impl(Reference<AsyncFileS3BlobStoreWrite> f, const uint8_t* data, int length) {
 		state Part* p = f->m_parts.back().getPtr();
-		// If this write will cause the part to cross the min part size boundary then write to the boundary and start a
-		// new part.
-		while (p->length + length >= f->m_bstore->knobs.multipart_min_part_size) {
+		// If this write will cause the part to cross its size boundary then write to the boundary and start a new part.
+		while (p->length + length >= p->size) {
 			// Finish off this part
-			int finishlen = f->m_bstore->knobs.multipart_min_part_size - p->length;
+			int finishlen = p->size - p->length;
 			p->write((const uint8_t*)data, finishlen);
 
 			// Adjust source buffer args
@@ -229,6 +231,22 @@ private:
 		if (f->m_parts.back()->length == 0)
 			return Void();
 
+		// Adaptive uploads limit the parts in flight to fewer than the lock allows when the link is congested
+		if (f->m_bstore->knobs.adaptive_uploads) {
+			loop {
+				std::vector<Future<Void>> uploading;
+				for (auto& p : f->m_parts) {
+					if (!p->etag.isReady()) {
+						uploading.push_back(success(p->etag));
+					}
+				}
+				if (uploading.size() < f->m_bstore->uploadWritesPerFile(f->m_bucket)) {
+					break;
+				}
+				wait(quorum(uploading, 1) || f->m_error.getFuture());
+			}
+		}
+
 		// Wait for an upload slot to be available
 		wait(f->m_concurrentUploads.take());
 
@@ -241,7 +259,7 @@ private:
 		// Make a new part to write to
 		if (startNew)
 			f->m_parts.push_back(
-			    Reference<Part>(new Part(f->m_parts.size() + 1, f->m_bstore->knobs.multipart_min_part_size)));
+			    Reference<Part>(new Part(f->m_parts.size() + 1, f->m_bstore->uploadPartSize(f->m_bucket))));
 
 		return Void();
 	}
@@ -255,10 +273,12 @@ private:
 public:
 	AsyncFileS3BlobStoreWrite(Reference<S3BlobStoreEndpoint> bstore, std::string bucket, std::string object)
 	  : m_bstore(bstore), m_bucket(bucket), m_object(object), m_cursor(0),
-	    m_concurrentUploads(bstore->knobs.concurrent_writes_per_file) {
+	    m_concurrentUploads(bstore->knobs.adaptive_uploads
+	                            ? S3BlobStoreEndpoint::UploadTuner::maxWritesPerFile(bstore->knobs)
+	                            : bstore->knobs.concurrent_writes_per_file) {
 
 		// Add first part
-		m_parts.push_back(makeReference<Part>(1, m_bstore->knobs.multipart_min_part_size));
+		m_parts.push_back(makeReference<Part>(1, m_bstore->uploadPartSize(m_bucket)));
 	}
 };
 
@@ -314,4 +314,89 @@ inline void transformVersionstampMutation(MutationRef& mutation,
 	mutation.type = MutationRef::SetValue;
 }
 
+// A SetVersionstampedKeys mutation sets many keys under one versionstamp. Its param1 is a key with a versionstamp
+// offset, as for SetVersionstampedKey, and with two more bytes after the versionstamp. Its param2 is the values, each
+// after its length as a little-endian uint32. Value i is set at the key with the versionstamp filled in and the two
+// bytes after it replaced by i in big-endian order, which is what the tuple layer reads as a versionstamp's user
+// version.
+
+// Returns the position of the versionstamp in a SetVersionstampedKeys key, or -1 if it has no room for the index
+inline int32_t parseVersionstampedKeysOffset(StringRef key) {
+	if (key.size() < 4) {
+		return -1;
+	}
+	int32_t pos = parseVersionstampOffset(key);
+	return pos >= 0 && pos + 12 <= key.size() - 4 ? pos : -1;
+}
+
+// Splits the param2 of a SetVersionstampedKeys mutation into its values. Returns false if it is not encoded that way,
+// or if it holds more values than the index in their keys can tell apart.
+inline bool parseVersionstampedKeysValues(StringRef param, std::vector<StringRef>* values) {
+	values->clear();
+	while (param.size()) {
+		uint32_t length;
+		if (param.size() < sizeof(length) || values->size() > std::numeric_limits<uint16_t>::max()) {
+			return false;
+		}
+		memcpy(&length, param.begin(), sizeof(length));
+		length = littleEndian32(length);
+		param = param.substr(sizeof(length));
+		if (length > param.size()) {
+			return false;
+		}
+		values->push_back(param.substr(0, length));
+		param = param.substr(length);
+	}
+	return true;
+}
+
+inline Value encodeVersionstampedKeysValues(VectorRef<ValueRef> values) {
+	BinaryWriter wr(Unversioned());
+	for (const ValueRef& value : values) {
+		wr << littleEndian32((uint32_t)value.size());
+		wr.serializeBytes(value);
+	}
+	return wr.toValue();
+}
+
+// Checks a SetVersionstampedKeys mutation from a client, returning how many values it sets
+inline int validateVersionstampedKeys(StringRef key, StringRef param) {
+	std::vector<StringRef> values;
+	if (parseVersionstampedKeysOffset(key) < 0 || !parseVersionstampedKeysValues(param, &values)) {
+		throw client_invalid_operation();
+	}
+	for (const StringRef& value : values) {
+		if (value.size() > CLIENT_KNOBS->VALUE_SIZE_LIMIT) {
+			throw value_too_large();
+		}
+	}
+	return values.size();
+}
+
+// Appends the SetValues that a SetVersionstampedKeys mutation stands for to out, in increasing order of key. Their keys
+// are allocated in arena, while their values refer to the mutation's param2. Returns false, appending nothing, if the
+// mutation is malformed.
+inline bool expandVersionstampedKeys(Arena& arena,
+                                     MutationRef const& mutation,
+                                     Version version,
+                                     uint16_t transactionNumber,
+                                     VectorRef<MutationRef>& out) {
+	int32_t pos = parseVersionstampedKeysOffset(mutation.param1);
+	std::vector<StringRef> values;
+	if (pos < 0 || !parseVersionstampedKeysValues(mutation.param2, &values)) {
+		return false;
+	}
+	StringRef keyTemplate = mutation.param1.substr(0, mutation.param1.size() - 4);
+	out.reserve(arena, out.size() + values.size());
+	for (int i = 0; i < values.size(); i++) {
+		StringRef key(arena, keyTemplate);
+		placeVersionstamp(mutateString(key) + pos, version, transactionNumber);
+		uint16_t index = i;
+		index = bigEndian16(index);
+		memcpy(mutateString(key) + pos + 10, &index, sizeof(index));
+		out.push_back(arena, MutationRef(MutationRef::SetValue, key, values[i]));
+	}
+	return true;
+}
+
 #endif
@@ -34,6 +34,7 @@
 #include <ctime>
 #include <climits>
 #include "fdbclient/BackupContainer.h"
+#include "flow/CompressionUtils.h"
 #include "flow/actorcompiler.h" // has to be last include
 
 FDB_BOOLEAN_PARAM(LockDB);
@@ -1021,13 +1022,41 @@ ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeRangeFileBlock(Reference<
 
 Standalone<VectorRef<KeyValueRef>> decodeMutationLogFileBlock(const Standalone<StringRef>& buf);
 
-// Reads a mutation log block from file and parses into batch mutation blocks for further parsing.
+// Returns the mutations in [beginVersion, endVersion) of a partitioned mutation log block as the kv pairs of a
+// non-partitioned block. Each message gets its own value, split into parts numbered from its subsequence, so that once
+// the blocks of every tag are written to the same keyspace the parts of a version are in commit order. Writing a
+// message again, as when files overlap, writes the same keys and values.
+Standalone<VectorRef<KeyValueRef>> decodePartitionedLogFileBlock(const Standalone<StringRef>& buf,
+                                                                 Version beginVersion,
+                                                                 Version endVersion);
+
+// Reads a mutation log block from file and parses into batch mutation blocks for further parsing. Blocks of
+// partitioned logs are converted with decodePartitionedLogFileBlock(), keeping the mutations in
+// [beginVersion, endVersion).
 ACTOR Future<Standalone<VectorRef<KeyValueRef>>> decodeMutationLogFileBlock(Reference<IAsyncFile> file,
                                                                             int64_t offset,
-                                                                            int len);
+                                                                            int len,
+                                                                            Version beginVersion,
+                                                                            Version endVersion);
 
 // Return a block of contiguous padding bytes "\0xff" for backup files, growing if needed.
 Value makePadding(int size);
+
+// Compresses raw with filter on the worker pool, returning nothing if that does not make it smaller
+Future<Optional<std::string>> compressBackupBlockPayload(CompressionFilter filter, std::string raw);
+
+// The filter for new compressed backup files, which is the best one this build supports
+CompressionFilter backupCompressionFilter();
+
+// Returns an unpadded PARTITIONED_MLOG_COMPRESSED_VERSION block of the messages in raw, storing them as compressed with
+// filter if compressed is present and as they are otherwise
+std::string encodeCompressedPartitionedLogBlock(CompressionFilter filter,
+                                                std::string const& raw,
+                                                Optional<std::string> const& compressed);
+
+// Returns the messages in a partitioned mutation log block of either version, decompressing them if needed. They run
+// to the end of the result or up to 0xFF padding.
+Standalone<StringRef> decodePartitionedLogBlock(const Standalone<StringRef>& buf);
 } // namespace fileBackup
 
 // For fast restore simulation test
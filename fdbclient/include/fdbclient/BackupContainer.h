@@ -66,12 +66,18 @@ static const uint32_t BACKUP_AGENT_MLOG_VERSION = 2001;
 // Mutation log version written by BackupWorker
 static const uint32_t PARTITIONED_MLOG_VERSION = 4110;
 
+// Compressed mutation log version written by BackupWorker
+static const uint32_t PARTITIONED_MLOG_COMPRESSED_VERSION = 4111;
+
 // Snapshot file version written by FileBackupAgent
 static const uint32_t BACKUP_AGENT_SNAPSHOT_FILE_VERSION = 1001;
 
 // Encrypted Snapshot file version written by FileBackupAgent
 static const uint32_t BACKUP_AGENT_ENCRYPTED_SNAPSHOT_FILE_VERSION = 1002;
 
+// Compressed Snapshot file version written by FileBackupAgent
+static const uint32_t BACKUP_AGENT_COMPRESSED_SNAPSHOT_FILE_VERSION = 1003;
+
 struct LogFile {
 	Version beginVersion;
 	Version endVersion;
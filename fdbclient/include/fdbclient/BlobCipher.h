@@ -615,7 +615,8 @@ static_assert(sizeof(BlobCipherEncryptHeader) == BlobCipherEncryptHeader::header
 // It caches base encryption key properties as well as caches the 'derived encryption' key obtained by applying
 // HMAC-SHA-256 derivation technique.
 
-class BlobCipherKey : public ReferenceCounted<BlobCipherKey>, NonCopyable {
+// Reference counting is thread safe so commit proxies can encrypt on worker threads (COMMIT_PROXY_ENCRYPTION_THREADS).
+class BlobCipherKey : public ThreadSafeReferenceCounted<BlobCipherKey>, NonCopyable {
 public:
 	BlobCipherKey(const EncryptCipherDomainId& domainId,
 	              const EncryptCipherBaseKeyId& baseCiphId,
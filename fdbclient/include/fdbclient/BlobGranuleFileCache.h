@@ -0,0 +1,106 @@
+/*
+ * BlobGranuleFileCache.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBCLIENT_BLOBGRANULEFILECACHE_H
+#define FDBCLIENT_BLOBGRANULEFILECACHE_H
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "flow/ActorCollection.h"
+#include "flow/Arena.h"
+#include "flow/flow.h"
+
+// Granule files are never modified once written, so a range of one can be cached by its file name, offset and length
+// without ever going stale. Both caches keep the bytes as they are in the blob store, still encrypted and compressed,
+// since how a file is parsed depends on the range and versions being read.
+
+// A size-bounded, least recently used cache of granule file ranges in memory. It is thread safe, since the client
+// materializes granules on the thread that asked for them.
+class BlobGranuleFileCache : NonCopyable {
+public:
+	explicit BlobGranuleFileCache(int64_t capacityBytes) : capacityBytes(capacityBytes) {}
+
+	Optional<Standalone<StringRef>> get(StringRef filename, int64_t offset, int64_t length);
+
+	// Keeps a reference to data, so it must not be freed or reused by the caller
+	void insert(StringRef filename, int64_t offset, int64_t length, Standalone<StringRef> data);
+
+	int64_t getBytes() const { return bytes; }
+	int64_t getHits() const { return hits; }
+	int64_t getMisses() const { return misses; }
+
+	// The process's cache, sized by CLIENT_KNOBS->BG_FILE_CACHE_BYTES, or nullptr if that is 0
+	static BlobGranuleFileCache* global();
+
+private:
+	static std::string cacheKey(StringRef filename, int64_t offset, int64_t length);
+	void evict();
+
+	typedef std::list<std::pair<std::string, Standalone<StringRef>>> EntryList;
+
+	const int64_t capacityBytes;
+	std::mutex mutex;
+	EntryList entries; // most recently used first
+	std::unordered_map<std::string, EntryList::iterator> index;
+	std::atomic<int64_t> bytes = 0;
+	std::atomic<int64_t> hits = 0;
+	std::atomic<int64_t> misses = 0;
+};
+
+// A cache of granule file ranges on local disk, one file each within folder, for blob workers to put beneath the
+// memory cache. The folder is emptied when the cache is created, so nothing cached survives a restart. Only used from
+// the network thread.
+class BlobGranuleDiskCache : public ReferenceCounted<BlobGranuleDiskCache>, NonCopyable {
+public:
+	BlobGranuleDiskCache(std::string folder, int64_t capacityBytes);
+
+	// Returns the cached bytes, or nothing if the range is not cached or could not be read back
+	Future<Optional<Standalone<StringRef>>> read(StringRef filename, int64_t offset, int64_t length);
+
+	// Caches data in the background, evicting the least recently used ranges to stay within capacity
+	void write(StringRef filename, int64_t offset, int64_t length, Standalone<StringRef> data);
+
+	int64_t getBytes() const { return bytes; }
+
+private:
+	std::string pathFor(StringRef filename, int64_t offset, int64_t length) const;
+	void touch(const std::string& path);
+	void evict();
+
+	typedef std::list<std::pair<std::string, int64_t>> EntryList;
+
+	const std::string folder;
+	const int64_t capacityBytes;
+	EntryList entries; // completely written files and their sizes, most recently used first
+	std::unordered_map<std::string, EntryList::iterator> index;
+	std::set<std::string> writing;
+	int64_t bytes = 0;
+	ActorCollection writers;
+
+	friend struct BlobGranuleDiskCacheImpl;
+};
+
+#endif
@@ -39,7 +39,8 @@ Value serializeChunkedDeltaFile(const Standalone<StringRef>& fileNameRef,
                                 const KeyRangeRef& fileRange,
                                 int chunkSize,
                                 Optional<CompressionFilter> compressFilter,
-                                Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx = {});
+                                Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx = {},
+                                bool columnar = false);
 
 ErrorOr<RangeResult> loadAndMaterializeBlobGranules(const Standalone<VectorRef<BlobGranuleChunkRef>>& files,
                                                     const KeyRangeRef& keyRange,
@@ -56,6 +57,12 @@ RangeResult materializeBlobGranule(const BlobGranuleChunkRef& chunk,
                                    const std::vector<StringRef>& deltaFileData,
                                    GranuleMaterializeStats& stats);
 
+// Returns keys from the snapshot file's chunk index that split it into pieces of at least targetBytes each, so that a
+// granule can be materialized one piece at a time
+Standalone<VectorRef<KeyRef>> getSnapshotSplitKeys(const StringRef& snapshotData,
+                                                   Optional<BlobGranuleCipherKeysCtx> cipherKeysCtx,
+                                                   int64_t targetBytes);
+
 std::string randomBGFilename(UID blobWorkerID, UID granuleID, Version version, std::string suffix);
 
 // For benchmark testing only. It should never be called in prod.
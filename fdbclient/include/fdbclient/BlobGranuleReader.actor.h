@@ -31,6 +31,7 @@
 #include "fdbclient/BackupContainerFileSystem.h"
 #include "fdbclient/BlobConnectionProvider.h"
 #include "fdbclient/BlobGranuleCommon.h"
+#include "fdbclient/BlobGranuleFileCache.h"
 #include "fdbclient/BlobGranuleFiles.h"
 #include "fdbclient/BlobWorkerInterface.h"
 #include "fdbclient/BlobWorkerCommon.h"
@@ -38,13 +39,27 @@
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 // Reads the fileset in the reply using the provided blob store, and filters data and mutations by key + version from
-// the request
+// the request. Files are cached in memory, and in diskCache if one is given.
 ACTOR Future<RangeResult> readBlobGranule(BlobGranuleChunkRef chunk,
                                           KeyRangeRef keyRange,
                                           Version beginVersion,
                                           Version readVersion,
                                           Reference<BlobConnectionProvider> bstore,
-                                          Optional<BlobWorkerStats*> stats = Optional<BlobWorkerStats*>());
+                                          Optional<BlobWorkerStats*> stats = Optional<BlobWorkerStats*>(),
+                                          Reference<BlobGranuleDiskCache> diskCache =
+                                              Reference<BlobGranuleDiskCache>());
+
+// Reads the chunk's files like readBlobGranule, and sends the rows within keyRange to results in key order, merging
+// about sliceBytes of the snapshot with the deltas at a time. Only the files and one slice are in memory at once, and
+// there are yields between slices, instead of materializing the whole granule in one go.
+ACTOR Future<Void> streamBlobGranule(BlobGranuleChunkRef chunk,
+                                     KeyRange keyRange,
+                                     Version readVersion,
+                                     Reference<BlobConnectionProvider> bstore,
+                                     PromiseStream<RangeResult> results,
+                                     int64_t sliceBytes,
+                                     Optional<BlobWorkerStats*> stats = Optional<BlobWorkerStats*>(),
+                                     Reference<BlobGranuleDiskCache> diskCache = Reference<BlobGranuleDiskCache>());
 
 ACTOR Future<Void> readBlobGranules(BlobGranuleFileRequest request,
                                     BlobGranuleFileReply reply,
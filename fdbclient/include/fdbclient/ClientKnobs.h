@@ -60,6 +60,7 @@ public:
 	double GRV_ERROR_RETRY_DELAY;
 	double UNKNOWN_TENANT_RETRY_DELAY;
 	int REPLY_BYTE_LIMIT;
+	int GET_VALUES_MAX_KEYS; // The most keys sent to a storage server in one GetValuesRequest
 	double DEFAULT_BACKOFF;
 	double DEFAULT_MAX_BACKOFF;
 	double BACKOFF_GROWTH_RATE;
@@ -73,6 +74,8 @@ public:
 	int64_t SYSTEM_KEY_SIZE_LIMIT;
 	int64_t VALUE_SIZE_LIMIT;
 	int64_t SPLIT_KEY_SIZE_LIMIT;
+	bool RYW_LOG_BLIND_WRITES; // Buffer writes in an append-only log until a transaction reads or clears a range
+	bool COMPACT_COMMIT_REQUESTS; // Drop overwritten mutations and merge conflict ranges before sending a commit
 	int METADATA_VERSION_CACHE_SIZE;
 	int64_t CHANGE_FEED_LOCATION_LIMIT;
 	int64_t CHANGE_FEED_CACHE_SIZE;
@@ -88,14 +91,22 @@ public:
 	double GRV_BATCH_TIMEOUT;
 	int BROADCAST_BATCH_SIZE;
 	double TRANSACTION_TIMEOUT_DELAY_INTERVAL;
+	int TRANSACTION_PROFILE_MAX_READS; // Reads beyond this are only counted in a transaction's profile
 
 	// When locationCache in DatabaseContext gets to be this size, items will be evicted
 	int LOCATION_CACHE_EVICTION_SIZE;
 	int LOCATION_CACHE_EVICTION_SIZE_SIM;
 	double LOCATION_CACHE_ENDPOINT_FAILURE_GRACE_PERIOD;
 	double LOCATION_CACHE_FAILED_ENDPOINT_RETRY_INTERVAL;
+	double LOCATION_CACHE_SNAPSHOT_INTERVAL;
+	double LOCATION_CACHE_SNAPSHOT_MAX_AGE;
+	int LOCATION_CACHE_SNAPSHOT_MAX_ENTRIES;
+	int64_t LOCATION_CACHE_SNAPSHOT_MAX_BYTES;
+	int LOCATION_CACHE_PREFETCH_SHARDS;
 
 	int GET_RANGE_SHARD_LIMIT;
+	std::string GET_RANGE_COMPRESSION_FILTER;
+	int MAX_RANGE_READ_PARALLELISM;
 	int WARM_RANGE_SHARD_LIMIT;
 	int STORAGE_METRICS_SHARD_LIMIT;
 	int SHARD_COUNT_LIMIT;
@@ -104,6 +115,8 @@ public:
 	double AGGREGATE_HEALTH_METRICS_MAX_STALENESS;
 	double DETAILED_HEALTH_METRICS_MAX_STALENESS;
 	double MID_SHARD_SIZE_MAX_STALENESS;
+	int HOT_KEYS_REPORTED; // Of reads and of writes, per storage server, in \xff\xff/metrics/hot_keys/
+	double HOT_KEYS_TIMEOUT; // Storage servers not answering within this long are left out of the hot keys
 	bool TAG_ENCODE_KEY_SERVERS;
 	int64_t RANGESTREAM_FRAGMENT_SIZE;
 	int RANGESTREAM_BUFFERED_FRAGMENTS_LIMIT;
@@ -146,6 +159,7 @@ public:
 	int TASKBUCKET_CHECK_ACTIVE_AMOUNT;
 	int TASKBUCKET_TIMEOUT_VERSIONS;
 	int TASKBUCKET_MAX_TASK_KEYS;
+	bool TASKBUCKET_BATCH_CLAIM; // Dispatch claims a whole batch of tasks in one transaction
 
 	// Backup
 	int BACKUP_LOCAL_FILE_WRITE_BLOCK;
@@ -180,6 +194,7 @@ public:
 	int SIM_BACKUP_TASKS_PER_AGENT;
 	int BACKUP_RANGEFILE_BLOCK_SIZE;
 	int BACKUP_LOGFILE_BLOCK_SIZE;
+	bool BACKUP_COMPRESS_RANGE_FILES;
 	int BACKUP_DISPATCH_ADDTASK_SIZE;
 	int RESTORE_DISPATCH_ADDTASK_SIZE;
 	int RESTORE_DISPATCH_BATCH_SIZE;
@@ -223,6 +238,11 @@ public:
 	int64_t CSI_SIZE_LIMIT;
 	double CSI_STATUS_DELAY;
 
+	// Transaction capture, see the transaction_capture_file database option
+	double TRANSACTION_CAPTURE_SAMPLING_PROBABILITY;
+	double TRANSACTION_CAPTURE_FLUSH_INTERVAL;
+	int64_t TRANSACTION_CAPTURE_MAX_BYTES;
+
 	bool HTTP_REQUEST_AWS_V4_HEADER; // setting this knob to true will enable AWS V4 style header.
 	std::string BLOBSTORE_ENCRYPTION_TYPE;
 	int BLOBSTORE_CONNECT_TRIES;
@@ -245,10 +265,15 @@ public:
 	int BLOBSTORE_ENABLE_READ_CACHE;
 	int BLOBSTORE_READ_BLOCK_SIZE;
 	int BLOBSTORE_READ_AHEAD_BLOCKS;
+	int64_t BLOBSTORE_READ_AHEAD_CACHE_BYTES;
 	int BLOBSTORE_READ_CACHE_BLOCKS_PER_FILE;
 	int BLOBSTORE_MAX_SEND_BYTES_PER_SECOND;
 	int BLOBSTORE_MAX_RECV_BYTES_PER_SECOND;
 	bool BLOBSTORE_GLOBAL_CONNECTION_POOL;
+	int BLOBSTORE_ADAPTIVE_UPLOADS;
+	double BLOBSTORE_ADAPTIVE_PART_SECONDS;
+	int BLOBSTORE_ADAPTIVE_MAX_WRITES_PER_FILE;
+	double BLOBSTORE_ADAPTIVE_LATENCY_RATIO;
 	bool BLOBSTORE_ENABLE_LOGGING;
 	double BLOBSTORE_STATS_LOGGING_INTERVAL;
 	double BLOBSTORE_LATENCY_LOGGING_INTERVAL;
@@ -299,6 +324,7 @@ public:
 	// Blob Granules
 	int BG_MAX_GRANULE_PARALLELISM;
 	int BG_TOO_MANY_GRANULES;
+	int64_t BG_FILE_CACHE_BYTES; // Memory for caching loaded granule files in each process. 0 disables the cache.
 	int64_t BLOB_METADATA_REFRESH_INTERVAL;
 	bool DETERMINISTIC_BLOB_METADATA;
 	bool ENABLE_BLOB_GRANULE_FILE_LOGICAL_SIZE;
@@ -319,6 +345,7 @@ public:
 	double METACLUSTER_ASSIGNMENT_FIRST_CHOICE_DELAY;
 	double METACLUSTER_ASSIGNMENT_AVAILABILITY_TIMEOUT;
 	int METACLUSTER_RESTORE_BATCH_SIZE;
+	int METACLUSTER_TENANT_BATCH_CONCURRENCY; // How many tenant operations of a batch run at once
 	int TENANT_ENTRY_CACHE_LIST_REFRESH_INTERVAL; // How often the TenantEntryCache is refreshed
 	bool CLIENT_ENABLE_USING_CLUSTER_ID_KEY;
 
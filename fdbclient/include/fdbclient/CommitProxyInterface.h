@@ -38,6 +38,7 @@
 #include "fdbclient/VersionVector.h"
 #include "fdbrpc/Stats.h"
 #include "fdbrpc/TimedRequest.h"
+#include "flow/CompressionUtils.h"
 
 struct CommitProxyInterface {
 	constexpr static FileIdentifier file_identifier = 8954922;
@@ -604,10 +605,21 @@ struct TxnStateRequest {
 	bool last;
 	std::vector<Endpoint> broadcastInfo;
 	ReplyPromise<Void> reply;
+	// When set, data is empty and compressedData holds encodeData(data) compressed with compressionFilter
+	CompressionFilter compressionFilter = CompressionFilter::NONE;
+	StringRef compressedData;
+
+	// Returns the key-value pairs of this part, decompressing them into arena if need be
+	VectorRef<KeyValueRef> getData(Arena& arena) const;
+
+	// The pairs, which must be sorted by key, with each key stored as the length of the prefix it shares with the key
+	// before it followed by the rest of it. System keys have long common prefixes, so this is much smaller than data.
+	static Standalone<StringRef> encodeData(VectorRef<KeyValueRef> data);
+	static VectorRef<KeyValueRef> decodeData(StringRef encoded, Arena& arena);
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, data, sequence, last, broadcastInfo, reply, arena);
+		serializer(ar, data, sequence, last, broadcastInfo, reply, compressionFilter, compressedData, arena);
 	}
 };
 
@@ -61,7 +61,7 @@ static const char* typeString[] = { "SetValue",
 	                                "Reserved_For_SpanContextMessage",
 	                                "Reserved_For_OTELSpanContextMessage",
 	                                "Encrypted",
-	                                "AccumulativeChecksum",
+	                                "SetVersionstampedKeys",
 	                                "MAX_ATOMIC_OP" };
 
 struct MutationRef {
@@ -94,6 +94,7 @@ struct MutationRef {
 		Reserved_For_SpanContextMessage /* See fdbserver/SpanContextMessage.h */,
 		Reserved_For_OTELSpanContextMessage,
 		Encrypted, /* Represents an encrypted mutation and cannot be used directly before decrypting */
+		SetVersionstampedKeys, /* Expanded into SetValues by the commit proxy, see expandVersionstampedKeys() */
 		MAX_ATOMIC_OP
 	};
 
@@ -686,6 +687,12 @@ struct CommitTransactionRef {
 	size_t expectedSize() const {
 		return read_conflict_ranges.expectedSize() + write_conflict_ranges.expectedSize() + mutations.expectedSize();
 	}
+
+	// Drops the mutations of normal keys that a later set or clear in the transaction overwrites, and merges its
+	// overlapping and adjacent conflict ranges within normal keys. Neither changes what the transaction does or what
+	// it conflicts with. Read conflict ranges are kept as they are if conflicting keys are reported, since those are
+	// reported by the index of the range. Anything added to arena is used for bookkeeping only.
+	void compact(Arena& arena);
 };
 
 struct MutationsAndVersionRef {
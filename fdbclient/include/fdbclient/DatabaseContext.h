@@ -28,6 +28,7 @@
 #include "fdbclient/StorageServerInterface.h"
 #include "flow/IRandom.h"
 #include "flow/genericactors.actor.h"
+#include <deque>
 #include <vector>
 #include <unordered_map>
 #pragma once
@@ -57,8 +58,7 @@ public:
 
 private:
 	DatabaseContext* cx;
-	StorageServerInfo(DatabaseContext* cx, StorageServerInterface const& interf, LocalityData const& locality)
-	  : ReferencedInterface<StorageServerInterface>(interf, locality), cx(cx) {}
+	StorageServerInfo(DatabaseContext* cx, StorageServerInterface const& interf, LocalityData const& locality);
 };
 
 struct LocationInfo : MultiInterface<ReferencedInterface<StorageServerInterface>>, FastAllocated<LocationInfo> {
@@ -211,6 +211,41 @@ struct KeyRangeLocationInfo {
 	KeyRangeLocationInfo(KeyRange range, Reference<LocationInfo> locations) : range(range), locations(locations) {}
 };
 
+// Where the time went in one attempt at a transaction, as seen from the client. Kept in memory only when the
+// transaction_profile_buffer_size database option is set, so that it can be read back with getTransactionProfiles().
+struct TransactionProfile {
+	enum class ReadType { GET, GET_RANGE };
+
+	struct Read {
+		ReadType type;
+		double startTime;
+		double latency;
+		int64_t bytes;
+	};
+
+	std::string debugIdentifier;
+	double startTime = 0;
+	double endTime = 0;
+	int retries = 0;
+	Optional<double> grvLatency;
+	// Only the lookups that missed the location cache
+	int locationLookups = 0;
+	double locationLatency = 0;
+	std::vector<Read> reads;
+	int readsDropped = 0;
+	Optional<double> commitLatency;
+	Optional<int> errorCode;
+
+	explicit TransactionProfile(double startTime) : startTime(startTime) {}
+
+	void addRead(ReadType type, double startTime, double latency, int64_t bytes);
+
+	// Whether the attempt did anything worth keeping
+	bool empty() const {
+		return !grvLatency.present() && reads.empty() && !commitLatency.present() && !errorCode.present();
+	}
+};
+
 struct OverlappingChangeFeedsInfo {
 	Arena arena;
 	VectorRef<OverlappingChangeFeedEntry> feeds;
@@ -502,6 +537,12 @@ public:
 	LocalityData clientLocality;
 	QueueModel queueModel;
 	EnableLocalityLoadBalance enableLocalityLoadBalance{ EnableLocalityLoadBalance::False };
+	// Set by the prefer_zone_local_reads option: replicas in clientLocality's zone are read from ahead of the rest
+	bool preferZoneLocalReads = false;
+
+	// Counts the bytes of a read from a storage server towards the zone-local or cross-zone read bytes, when reads
+	// prefer the client's zone
+	void recordReplicaRead(LoadBalancedReply const& reply, int64_t bytes);
 
 	// The tenant used when none is specified for a transaction. Ordinarily this is unspecified, in which case the raw
 	// key-space is used.
@@ -543,6 +584,9 @@ public:
 	// Cache of location information
 	int locationCacheSize;
 	CoalescedKeyRangeMap<Reference<LocationInfo>> locationCache;
+	// Set by the location_cache_file option: warms locationCache from a snapshot on disk and keeps the snapshot updated
+	std::string locationCacheFile;
+	Future<Void> locationCacheSnapshotter;
 	std::unordered_map<Endpoint, EndpointFailureInfo> failedEndpointsOnHealthyServersInfo;
 
 	std::map<UID, StorageServerInfo*> server_interf;
@@ -587,6 +631,8 @@ public:
 	Counter transactionReadVersions;
 	Counter transactionReadVersionsThrottled;
 	Counter transactionReadVersionsCompleted;
+	Counter transactionGrvCacheHits;
+	Counter transactionGrvCacheMisses;
 	Counter transactionReadVersionBatches;
 	Counter transactionBatchReadVersions;
 	Counter transactionDefaultReadVersions;
@@ -606,6 +652,9 @@ public:
 	Counter transactionGetAddressesForKeyRequests;
 	Counter transactionBytesRead;
 	Counter transactionKeysRead;
+	// Bytes read from replicas in and outside of the client's zone, when it prefers reading in its zone
+	Counter transactionZoneLocalBytesRead;
+	Counter transactionCrossZoneBytesRead;
 	Counter transactionMetadataVersionReads;
 	Counter transactionCommittedMutations;
 	Counter transactionCommittedMutationBytes;
@@ -655,6 +704,8 @@ public:
 	Counter feedPopsFallback;
 
 	DDSketch<double> latencies, readLatencies, commitLatencies, GRVLatencies, mutationsPerCommit, bytesPerCommit;
+	// The samples of the intervals which databaseLogger has already logged and cleared from the sketches above
+	DDSketch<double> loggedLatencies, loggedReadLatencies, loggedCommitLatencies, loggedGRVLatencies;
 
 	int outstandingWatches;
 	int maxOutstandingWatches;
@@ -819,6 +870,48 @@ public:
 	// { "InitializationError" : <error code> }
 	Standalone<StringRef> getClientStatus();
 
+	// Get a JSON string with the counters of cc and the latency histograms of this database since it was created:
+	//
+	// { "Counters" : { <counter name> : <value>, ... },
+	//   "Latencies" : { "Transaction" | "GRV" | "Read" | "Commit" : <histogram>, ... } }
+	//
+	// where each histogram is a DDSketch
+	//
+	// { "Count" : <samples>, "Sum" : <seconds>, "Min" : <seconds>, "Max" : <seconds>,
+	//   "ErrorGuarantee" : <relative accuracy of the bucket values>,
+	//   "Buckets" : [ [ <bucket value in seconds>, <samples> ], ... ] }
+	//
+	// with only the non-empty buckets listed, in increasing order. If the database context is initialized with an
+	// error, the JSON contains just the error code, as for getClientStatus().
+	Standalone<StringRef> getMetrics();
+
+	// Get the profiles of the most recent transaction attempts, oldest first, as JSON
+	//
+	// { "Transactions" : [ { "StartTime" : <seconds>, "Duration" : <seconds>, "DebugID" : <identifier>,
+	//                        "Retries" : <errors before this attempt>, "GRVLatency" : <seconds>,
+	//                        "LocationLookups" : <count>, "LocationLatency" : <seconds>,
+	//                        "Reads" : [ { "Type" : "Get" | "GetRange", "StartTime" : <seconds>,
+	//                                      "Latency" : <seconds>, "Bytes" : <bytes> }, ... ],
+	//                        "ReadsDropped" : <count>, "CommitLatency" : <seconds>, "Error" : <code> }, ... ] }
+	//
+	// where the times within a transaction are relative to its StartTime, and GRVLatency, CommitLatency and Error are
+	// only present if the attempt got that far. Profiles are only kept while the transaction_profile_buffer_size
+	// database option is non-zero. As for getMetrics(), an initialization error is reported instead, if any.
+	Standalone<StringRef> getTransactionProfiles();
+
+	// Keeps at most transactionProfileLimit profiles, dropping the oldest
+	void addTransactionProfile(TransactionProfile&& profile);
+	std::deque<TransactionProfile> transactionProfiles;
+	int transactionProfileLimit = 0;
+
+	// Set by the transaction_capture_file option. Each sampled transaction's client log events are appended to the
+	// file as a little endian 32 bit length followed by the events, serialized as for fdbClientInfo.
+	void captureTransaction(StringRef events);
+	std::string transactionCaptureFile;
+	std::string transactionCaptureBuffer; // not yet written to the file
+	int64_t transactionCaptureBytes = 0;
+	Future<Void> transactionCaptureWriter;
+
 	// Gets a database level backoff delay future, time in seconds.
 	Future<Void> getBackoff() const { return backoffDelay > 0.0 ? delay(backoffDelay) : Future<Void>(Void()); }
 
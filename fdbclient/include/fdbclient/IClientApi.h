@@ -32,6 +32,40 @@
 
 struct VersionVector;
 
+// A forward range read whose results are streamed from the storage servers a chunk at a time, rather than requested a
+// page at a time
+class IRangeStream {
+public:
+	virtual ~IRangeStream() {}
+
+	// Returns the next chunk of the range. It must not be called until the previous chunk is ready. The last chunk has
+	// more set to false, and may be empty.
+	virtual ThreadFuture<RangeResult> next() = 0;
+
+	virtual void addref() = 0;
+	virtual void delref() = 0;
+};
+
+// One of the operations submitted together with ITransaction::batch. param is the value of a set or of an atomic
+// operation, or the end of the range of a range clear, and operationType is the FDBMutationTypes::Option of an atomic
+// operation.
+struct BatchOperationRef {
+	enum Type : int { GET = 0, SET = 1, CLEAR = 2, CLEAR_RANGE = 3, ATOMIC_OP = 4, MAX_TYPE = ATOMIC_OP };
+
+	Type type = GET;
+	KeyRef key;
+	ValueRef param;
+	uint32_t operationType = 0;
+
+	BatchOperationRef() = default;
+	BatchOperationRef(Type type, KeyRef key, ValueRef param = ValueRef(), uint32_t operationType = 0)
+	  : type(type), key(key), param(param), operationType(operationType) {}
+	BatchOperationRef(Arena& a, BatchOperationRef const& copyFrom)
+	  : type(copyFrom.type), key(a, copyFrom.key), param(a, copyFrom.param), operationType(copyFrom.operationType) {}
+
+	int expectedSize() const { return key.expectedSize() + param.expectedSize(); }
+};
+
 // An interface that represents a transaction created by a client
 class ITransaction {
 public:
@@ -45,6 +79,11 @@ public:
 	// own memory. It is guaranteed, however, that the ThreadFuture will hold a reference to the memory. It will persist
 	// until the ThreadFuture's ThreadSingleAssignmentVar has its memory released or it is destroyed.
 	virtual ThreadFuture<Optional<Value>> get(const KeyRef& key, bool snapshot = false) = 0;
+	// Returns the key-value pairs of those keys which are present, in the order of keys
+	virtual ThreadFuture<RangeResult> getMulti(const VectorRef<KeyRef>& keys, bool snapshot = false) = 0;
+	// Applies operations in order with a single hop to the network thread, each read seeing the writes before it.
+	// Returns the key-value pairs of the keys read which are present, in the order of operations.
+	virtual ThreadFuture<RangeResult> batch(const VectorRef<BatchOperationRef>& operations, bool snapshot = false) = 0;
 	virtual ThreadFuture<Key> getKey(const KeySelectorRef& key, bool snapshot = false) = 0;
 	virtual ThreadFuture<RangeResult> getRange(const KeySelectorRef& begin,
 	                                           const KeySelectorRef& end,
@@ -70,6 +109,9 @@ public:
 	                                                       GetRangeLimits limits,
 	                                                       bool snapshot = false,
 	                                                       bool reverse = false) = 0;
+	virtual Reference<IRangeStream> getRangeStream(const KeySelectorRef& begin,
+	                                               const KeySelectorRef& end,
+	                                               bool snapshot = false) = 0;
 	virtual ThreadFuture<Standalone<VectorRef<const char*>>> getAddressesForKey(const KeyRef& key) = 0;
 	virtual ThreadFuture<Standalone<StringRef>> getVersionstamp() = 0;
 
@@ -109,6 +151,8 @@ public:
 	virtual void clear(const KeyRef& key) = 0;
 
 	virtual ThreadFuture<Void> watch(const KeyRef& key) = 0;
+	// Fires once a key in range changes after the read version, which unlike watch() needs no commit
+	virtual ThreadFuture<Void> watchRange(const KeyRangeRef& range) = 0;
 
 	virtual void addWriteConflictRange(const KeyRangeRef& keys) = 0;
 
@@ -225,6 +269,12 @@ public:
 	// Return a JSON string containing database client-side status information
 	virtual ThreadFuture<Standalone<StringRef>> getClientStatus() = 0;
 
+	// Return a JSON string containing database client-side counters and latency histograms
+	virtual ThreadFuture<Standalone<StringRef>> getMetrics() = 0;
+
+	// Return a JSON string containing the profiles of the most recent transaction attempts
+	virtual ThreadFuture<Standalone<StringRef>> getTransactionProfiles() = 0;
+
 	// used in template functions as the Transaction type that can be created through createTransaction()
 	using TransactionT = ITransaction;
 };
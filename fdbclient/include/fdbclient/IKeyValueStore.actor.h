@@ -55,6 +55,11 @@ ACTOR static Future<Void> replaceRange_impl(class IKeyValueStore* self,
                                             KeyRange range,
                                             Standalone<VectorRef<KeyValueRef>> data);
 
+ACTOR static Future<std::vector<Optional<Value>>> readValues_impl(class IKeyValueStore* self,
+                                                                  Standalone<VectorRef<KeyRef>> keys,
+                                                                  std::vector<int> maxLengths,
+                                                                  Optional<ReadOptions> options);
+
 class IKeyValueStore : public IClosable {
 public:
 	virtual KeyValueStoreType getType() const = 0;
@@ -74,6 +79,15 @@ public:
 	                                                int maxLength,
 	                                                Optional<ReadOptions> options = Optional<ReadOptions>()) = 0;
 
+	// Reads the values of a batch of keys, sorted ascending, where result[i] is the value of keys[i]. If maxLengths is
+	// not empty, only the first maxLengths[i] bytes of the value of keys[i] are returned as by readValuePrefix().
+	// Engines can serve the batch more cheaply than separate reads, the default implementation doesn't.
+	virtual Future<std::vector<Optional<Value>>> readValues(Standalone<VectorRef<KeyRef>> keys,
+	                                                        std::vector<int> maxLengths = std::vector<int>(),
+	                                                        Optional<ReadOptions> options = Optional<ReadOptions>()) {
+		return readValues_impl(this, keys, maxLengths, options);
+	}
+
 	// If rowLimit>=0, reads first rows sorted ascending, otherwise reads last rows sorted descending
 	// The total size of the returned value (less the last entry) will be less than byteLimit
 	virtual Future<RangeResult> readRange(KeyRangeRef keys,
@@ -81,6 +95,10 @@ public:
 	                                      int byteLimit = 1 << 30,
 	                                      Optional<ReadOptions> options = Optional<ReadOptions>()) = 0;
 
+	// Returns an estimate of the bytes of the keys and values in keys, from the engine's own structures rather than by
+	// reading them all, or nothing if the engine can't estimate it cheaply. Only data already committed is counted.
+	virtual Future<Optional<int64_t>> estimateRangeBytes(KeyRangeRef keys) { return Optional<int64_t>(); }
+
 	// Shard management APIs.
 	// Adds key range to a physical shard.
 	virtual Future<Void> addRange(KeyRangeRef range, std::string id, bool active = true) { return Void(); }
@@ -110,6 +128,17 @@ public:
 	// Returns the amount of free and total space for this store, in bytes
 	virtual StorageBytes getStorageBytes() const = 0;
 
+	// Returns the size the engine's page or block cache was configured with, or 0 if it has none which can be resized.
+	// The cache may be shared with the process's other stores of the same type.
+	virtual int64_t getConfiguredCacheSize() const { return 0; }
+
+	// Resizes the engine's cache, which evicts from it as needed to get within the new limit
+	virtual void setCacheSizeLimit(int64_t bytes) {}
+
+	// Returns true if the store was created with settings which can't be changed in place and differ from the ones a
+	// new store would be created with, so it should be replaced when convenient.
+	virtual bool isWrongConfigured() const { return false; }
+
 	virtual void logRecentRocksDBBackgroundWorkStats(UID ssId, std::string logReason) { throw not_implemented(); }
 
 	virtual void resyncLog() {}
@@ -180,5 +209,19 @@ ACTOR static Future<Void> replaceRange_impl(IKeyValueStore* self,
 	return Void();
 }
 
+ACTOR static Future<std::vector<Optional<Value>>> readValues_impl(IKeyValueStore* self,
+                                                                  Standalone<VectorRef<KeyRef>> keys,
+                                                                  std::vector<int> maxLengths,
+                                                                  Optional<ReadOptions> options) {
+	state std::vector<Future<Optional<Value>>> values;
+	values.reserve(keys.size());
+	for (int i = 0; i < keys.size(); i++) {
+		values.push_back(maxLengths.empty() ? self->readValue(keys[i], options)
+		                                    : self->readValuePrefix(keys[i], maxLengths[i], options));
+	}
+	std::vector<Optional<Value>> result = wait(getAll(values));
+	return result;
+}
+
 #include "flow/unactorcompiler.h"
 #endif
@@ -59,6 +59,8 @@ public:
 	virtual Future<Version> getReadVersion() = 0;
 	virtual Optional<Version> getCachedReadVersion() const = 0;
 	virtual Future<Optional<Value>> get(const Key& key, Snapshot = Snapshot::False) = 0;
+	// Returns the key-value pairs of those keys which are present, in the order of keys
+	virtual Future<RangeResult> getMulti(Standalone<VectorRef<KeyRef>> const& keys, Snapshot = Snapshot::False);
 	virtual Future<Key> getKey(const KeySelector& key, Snapshot = Snapshot::False) = 0;
 	virtual Future<RangeResult> getRange(const KeySelector& begin,
 	                                     const KeySelector& end,
@@ -76,6 +78,13 @@ public:
 	                                                 GetRangeLimits limits,
 	                                                 Snapshot = Snapshot::False,
 	                                                 Reverse = Reverse::False) = 0;
+	// Sends the key-value pairs from begin to end to results in order, as they are read, and then end_of_stream. A
+	// chunk is only read once the previous one has been taken from results. By default the range is read a page at a
+	// time with getRange.
+	virtual Future<Void> getRangeStream(PromiseStream<RangeResult>& results,
+	                                    KeySelector const& begin,
+	                                    KeySelector const& end,
+	                                    Snapshot = Snapshot::False);
 	virtual Future<Standalone<VectorRef<const char*>>> getAddressesForKey(Key const& key) = 0;
 	virtual Future<Standalone<VectorRef<KeyRef>>> getRangeSplitPoints(KeyRange const& range, int64_t chunkSize) = 0;
 	virtual Future<int64_t> getEstimatedRangeSizeBytes(KeyRange const& keys) = 0;
@@ -95,6 +104,8 @@ public:
 	virtual void clear(const KeyRangeRef& range) = 0;
 	virtual void clear(KeyRef const& key) = 0;
 	virtual Future<Void> watch(Key const& key) = 0;
+	// Fires once a key in range changes after the read version. Only supported by ReadYourWritesTransaction.
+	virtual Future<Void> watchRange(KeyRange const& range) { return client_invalid_operation(); }
 	virtual void addWriteConflictRange(KeyRangeRef const& keys) = 0;
 	virtual Future<Void> commit() = 0;
 	virtual Version getCommittedVersion() const = 0;
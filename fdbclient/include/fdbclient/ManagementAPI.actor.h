@@ -193,6 +193,15 @@ ACTOR Future<Void> printHealthyZone(Database cx);
 ACTOR Future<bool> clearHealthyZone(Database cx, bool printWarning = false, bool clearSSFailureZoneString = false);
 ACTOR Future<bool> setHealthyZone(Database cx, StringRef zoneId, double seconds, bool printWarning = false);
 
+// Pins a snapshot at a new read version, which storage servers keep readable for up to lifetimeSeconds (capped by
+// STORAGE_PINNED_READ_VERSION_MAX_LIFETIME) so that transactions can read at it with setVersion() long after the MVCC
+// window has moved on. Returns the pin's ID and its read version. A storage server gives up a pin early if the
+// mutations it holds in memory for it outgrow its budget, after which reads at the version fail with
+// transaction_too_old as usual.
+ACTOR Future<std::pair<UID, Version>> pinReadVersion(Database cx, double lifetimeSeconds);
+// Releases a pin taken by pinReadVersion()
+ACTOR Future<Void> unpinReadVersion(Database cx, UID pinId);
+
 ACTOR Future<Void> waitForPrimaryDC(Database cx, StringRef dcId);
 
 // Gets the cluster connection string
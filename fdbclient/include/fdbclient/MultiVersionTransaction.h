@@ -99,6 +99,15 @@ struct FdbCApi : public ThreadSafeReferenceCounted<FdbCApi> {
 		int64_t delta_version;
 		int64_t delta_size;
 	} FDBGranuleSummary;
+
+	typedef struct batchoperation {
+		int type;
+		const void* key;
+		int keyLength;
+		const void* param;
+		int paramLength;
+		int operationType;
+	} FDBBatchOperation;
 #pragma pack(pop)
 
 	typedef struct readgranulecontext {
@@ -222,6 +231,8 @@ struct FdbCApi : public ThreadSafeReferenceCounted<FdbCApi> {
 	                                     int64_t version);
 
 	FDBFuture* (*databaseGetClientStatus)(FDBDatabase* db);
+	FDBFuture* (*databaseGetMetrics)(FDBDatabase* db);
+	FDBFuture* (*databaseGetTransactionProfiles)(FDBDatabase* db);
 
 	// Tenant
 	fdb_error_t (*tenantCreateTransaction)(FDBTenant* tenant, FDBTransaction** outTransaction);
@@ -292,6 +303,15 @@ struct FdbCApi : public ThreadSafeReferenceCounted<FdbCApi> {
 	FDBFuture* (*transactionGetReadVersion)(FDBTransaction* tr);
 
 	FDBFuture* (*transactionGet)(FDBTransaction* tr, uint8_t const* keyName, int keyNameLength, fdb_bool_t snapshot);
+	FDBFuture* (*transactionGetMulti)(FDBTransaction* tr,
+	                                  uint8_t const* const* keyNames,
+	                                  int const* keyNameLengths,
+	                                  int count,
+	                                  fdb_bool_t snapshot);
+	FDBFuture* (*transactionBatch)(FDBTransaction* tr,
+	                               FDBBatchOperation const* operations,
+	                               int count,
+	                               fdb_bool_t snapshot);
 	FDBFuture* (*transactionGetKey)(FDBTransaction* tr,
 	                                uint8_t const* keyName,
 	                                int keyNameLength,
@@ -331,6 +351,16 @@ struct FdbCApi : public ThreadSafeReferenceCounted<FdbCApi> {
 	                                        int iteration,
 	                                        fdb_bool_t snapshot,
 	                                        fdb_bool_t reverse);
+	FDBFuture* (*transactionGetRangeStream)(FDBTransaction* tr,
+	                                        uint8_t const* beginKeyName,
+	                                        int beginKeyNameLength,
+	                                        fdb_bool_t beginOrEqual,
+	                                        int beginOffset,
+	                                        uint8_t const* endKeyName,
+	                                        int endKeyNameLength,
+	                                        fdb_bool_t endOrEqual,
+	                                        int endOffset,
+	                                        fdb_bool_t snapshot);
 	FDBFuture* (*transactionGetVersionstamp)(FDBTransaction* tr);
 
 	void (*transactionSet)(FDBTransaction* tr,
@@ -412,6 +442,11 @@ struct FdbCApi : public ThreadSafeReferenceCounted<FdbCApi> {
 	FDBFuture* (*transactionGetTotalCost)(FDBTransaction* tr);
 	FDBFuture* (*transactionGetApproximateSize)(FDBTransaction* tr);
 	FDBFuture* (*transactionWatch)(FDBTransaction* tr, uint8_t const* keyName, int keyNameLength);
+	FDBFuture* (*transactionWatchRange)(FDBTransaction* tr,
+	                                    uint8_t const* beginKeyName,
+	                                    int beginKeyNameLength,
+	                                    uint8_t const* endKeyName,
+	                                    int endKeyNameLength);
 	FDBFuture* (*transactionOnError)(FDBTransaction* tr, fdb_error_t error);
 	void (*transactionReset)(FDBTransaction* tr);
 	void (*transactionCancel)(FDBTransaction* tr);
@@ -442,6 +477,7 @@ struct FdbCApi : public ThreadSafeReferenceCounted<FdbCApi> {
 	                                            fdb_bool_t* outMore);
 	fdb_error_t (*futureGetGranuleSummaryArray)(FDBFuture* f, const FDBGranuleSummary** out_summaries, int* outCount);
 	fdb_error_t (*futureGetSharedState)(FDBFuture* f, DatabaseSharedState** outPtr);
+	FDBFuture* (*futureGetNextChunk)(FDBFuture* f);
 	fdb_error_t (*futureSetCallback)(FDBFuture* f, FDBCallback callback, void* callback_parameter);
 	void (*futureCancel)(FDBFuture* f);
 	void (*futureDestroy)(FDBFuture* f);
@@ -456,6 +492,29 @@ struct FdbCApi : public ThreadSafeReferenceCounted<FdbCApi> {
 	fdb_error_t (*futureGetCluster)(FDBFuture* f, FDBCluster** outCluster);
 };
 
+// An implementation of IRangeStream that wraps a range stream read through an externally loaded client library
+class DLRangeStream : public IRangeStream, ThreadSafeReferenceCounted<DLRangeStream> {
+public:
+	DLRangeStream(Reference<FdbCApi> api, FdbCApi::FDBFuture* f) : api(api), f(f) {}
+	~DLRangeStream() override {
+		if (f) {
+			api->futureDestroy(f);
+		}
+	}
+
+	ThreadFuture<RangeResult> next() override;
+
+	void addref() override { ThreadSafeReferenceCounted<DLRangeStream>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<DLRangeStream>::delref(); }
+
+private:
+	const Reference<FdbCApi> api;
+
+	// The future of the next chunk. The library only gives it out from the ready future of the previous chunk, so it
+	// is requested as soon as that chunk is extracted.
+	FdbCApi::FDBFuture* f;
+};
+
 // An implementation of ITransaction that wraps a transaction object created on an externally loaded client library.
 // All API calls to that transaction are routed through the external library.
 class DLTransaction : public ITransaction, ThreadSafeReferenceCounted<DLTransaction> {
@@ -468,6 +527,8 @@ public:
 	ThreadFuture<Version> getReadVersion() override;
 
 	ThreadFuture<Optional<Value>> get(const KeyRef& key, bool snapshot = false) override;
+	ThreadFuture<RangeResult> getMulti(const VectorRef<KeyRef>& keys, bool snapshot = false) override;
+	ThreadFuture<RangeResult> batch(const VectorRef<BatchOperationRef>& operations, bool snapshot = false) override;
 	ThreadFuture<Key> getKey(const KeySelectorRef& key, bool snapshot = false) override;
 	ThreadFuture<RangeResult> getRange(const KeySelectorRef& begin,
 	                                   const KeySelectorRef& end,
@@ -493,6 +554,9 @@ public:
 	                                               GetRangeLimits limits,
 	                                               bool snapshot,
 	                                               bool reverse) override;
+	Reference<IRangeStream> getRangeStream(const KeySelectorRef& begin,
+	                                       const KeySelectorRef& end,
+	                                       bool snapshot = false) override;
 	ThreadFuture<Standalone<VectorRef<const char*>>> getAddressesForKey(const KeyRef& key) override;
 	ThreadFuture<Standalone<StringRef>> getVersionstamp() override;
 	ThreadFuture<int64_t> getEstimatedRangeSizeBytes(const KeyRangeRef& keys) override;
@@ -531,6 +595,7 @@ public:
 	void clear(const KeyRef& key) override;
 
 	ThreadFuture<Void> watch(const KeyRef& key) override;
+	ThreadFuture<Void> watchRange(const KeyRangeRef& range) override;
 
 	void addWriteConflictRange(const KeyRangeRef& keys) override;
 
@@ -645,6 +710,10 @@ public:
 	// Return a JSON string containing database client-side status information
 	ThreadFuture<Standalone<StringRef>> getClientStatus() override;
 
+	ThreadFuture<Standalone<StringRef>> getMetrics() override;
+
+	ThreadFuture<Standalone<StringRef>> getTransactionProfiles() override;
+
 private:
 	const Reference<FdbCApi> api;
 	FdbCApi::FDBDatabase*
@@ -690,6 +759,28 @@ private:
 class MultiVersionDatabase;
 class MultiVersionTenant;
 
+// An implementation of IRangeStream that reads a stream of a MultiVersionTransaction's underlying transaction. Like
+// the transaction's other operations, its chunks fail with cluster_version_changed if that transaction is replaced.
+class MultiVersionRangeStream : public IRangeStream, ThreadSafeReferenceCounted<MultiVersionRangeStream> {
+public:
+	MultiVersionRangeStream(Reference<IRangeStream> stream, ThreadFuture<Void> onChange)
+	  : stream(stream), onChange(onChange) {}
+
+	// A stream with no underlying transaction to read from, whose only chunk is failure
+	MultiVersionRangeStream(ThreadFuture<RangeResult> failure, ThreadFuture<Void> onChange)
+	  : failure(failure), onChange(onChange) {}
+
+	ThreadFuture<RangeResult> next() override;
+
+	void addref() override { ThreadSafeReferenceCounted<MultiVersionRangeStream>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<MultiVersionRangeStream>::delref(); }
+
+private:
+	const Reference<IRangeStream> stream;
+	const ThreadFuture<RangeResult> failure;
+	const ThreadFuture<Void> onChange;
+};
+
 // An implementation of ITransaction that wraps a transaction created either locally or through a dynamically loaded
 // external client. When needed (e.g on cluster version change), the MultiVersionTransaction can automatically replace
 // its wrapped transaction with one from another client.
@@ -706,6 +797,8 @@ public:
 	ThreadFuture<Version> getReadVersion() override;
 
 	ThreadFuture<Optional<Value>> get(const KeyRef& key, bool snapshot = false) override;
+	ThreadFuture<RangeResult> getMulti(const VectorRef<KeyRef>& keys, bool snapshot = false) override;
+	ThreadFuture<RangeResult> batch(const VectorRef<BatchOperationRef>& operations, bool snapshot = false) override;
 	ThreadFuture<Key> getKey(const KeySelectorRef& key, bool snapshot = false) override;
 	ThreadFuture<RangeResult> getRange(const KeySelectorRef& begin,
 	                                   const KeySelectorRef& end,
@@ -731,6 +824,9 @@ public:
 	                                               GetRangeLimits limits,
 	                                               bool snapshot,
 	                                               bool reverse) override;
+	Reference<IRangeStream> getRangeStream(const KeySelectorRef& begin,
+	                                       const KeySelectorRef& end,
+	                                       bool snapshot = false) override;
 	ThreadFuture<Standalone<VectorRef<const char*>>> getAddressesForKey(const KeyRef& key) override;
 	ThreadFuture<Standalone<StringRef>> getVersionstamp() override;
 
@@ -770,6 +866,7 @@ public:
 	void clear(const KeyRef& key) override;
 
 	ThreadFuture<Void> watch(const KeyRef& key) override;
+	ThreadFuture<Void> watchRange(const KeyRangeRef& range) override;
 
 	void addWriteConflictRange(const KeyRangeRef& keys) override;
 
@@ -1051,6 +1148,13 @@ public:
 	// Return a JSON string containing database client-side status information
 	ThreadFuture<Standalone<StringRef>> getClientStatus() override;
 
+	// Return the metrics of the database currently connected to the cluster, which start over when the cluster's
+	// protocol version changes
+	ThreadFuture<Standalone<StringRef>> getMetrics() override;
+
+	// Return the transaction profiles of the database currently connected to the cluster
+	ThreadFuture<Standalone<StringRef>> getTransactionProfiles() override;
+
 	// private:
 
 	struct LegacyVersionMonitor;
@@ -1165,6 +1269,124 @@ public:
 	friend class MultiVersionTransaction;
 };
 
+// An implementation of ITenant that opens the tenant in each database of a DistributedDatabase and creates its
+// transactions in each of them in turn.
+class DistributedTenant final : public ITenant, ThreadSafeReferenceCounted<DistributedTenant> {
+public:
+	explicit DistributedTenant(std::vector<Reference<ITenant>> tenants) : tenants(std::move(tenants)), nextTenant(0) {}
+
+	Reference<ITransaction> createTransaction() override;
+
+	ThreadFuture<int64_t> getId() override { return tenants[0]->getId(); }
+	ThreadFuture<Key> purgeBlobGranules(const KeyRangeRef& keyRange, Version purgeVersion, bool force) override {
+		return tenants[0]->purgeBlobGranules(keyRange, purgeVersion, force);
+	}
+	ThreadFuture<Void> waitPurgeGranulesComplete(const KeyRef& purgeKey) override {
+		return tenants[0]->waitPurgeGranulesComplete(purgeKey);
+	}
+
+	ThreadFuture<bool> blobbifyRange(const KeyRangeRef& keyRange) override {
+		return tenants[0]->blobbifyRange(keyRange);
+	}
+	ThreadFuture<bool> blobbifyRangeBlocking(const KeyRangeRef& keyRange) override {
+		return tenants[0]->blobbifyRangeBlocking(keyRange);
+	}
+	ThreadFuture<bool> unblobbifyRange(const KeyRangeRef& keyRange) override {
+		return tenants[0]->unblobbifyRange(keyRange);
+	}
+	ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> listBlobbifiedRanges(const KeyRangeRef& keyRange,
+	                                                                      int rangeLimit) override {
+		return tenants[0]->listBlobbifiedRanges(keyRange, rangeLimit);
+	}
+	ThreadFuture<Version> verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) override {
+		return tenants[0]->verifyBlobRange(keyRange, version);
+	}
+	ThreadFuture<bool> flushBlobRange(const KeyRangeRef& keyRange, bool compact, Optional<Version> version) override {
+		return tenants[0]->flushBlobRange(keyRange, compact, version);
+	}
+
+	void addref() override { ThreadSafeReferenceCounted<DistributedTenant>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<DistributedTenant>::delref(); }
+
+private:
+	const std::vector<Reference<ITenant>> tenants;
+	std::atomic<uint32_t> nextTenant;
+};
+
+// An implementation of IDatabase that spreads its transactions over one database per client thread, so that a single
+// database object can use all of the threads started by CLIENT_THREADS_PER_VERSION. Operations other than transactions
+// and options go through the first database.
+class DistributedDatabase final : public IDatabase, ThreadSafeReferenceCounted<DistributedDatabase> {
+public:
+	explicit DistributedDatabase(std::vector<Reference<IDatabase>> dbs) : dbs(std::move(dbs)), nextDb(0) {}
+
+	Reference<ITenant> openTenant(TenantNameRef tenantName) override;
+	Reference<ITransaction> createTransaction() override;
+	void setOption(FDBDatabaseOptions::Option option, Optional<StringRef> value = Optional<StringRef>()) override;
+	// Returns the average busyness of the client threads
+	double getMainThreadBusyness() override;
+
+	ThreadFuture<ProtocolVersion> getServerProtocol(
+	    Optional<ProtocolVersion> expectedVersion = Optional<ProtocolVersion>()) override {
+		return dbs[0]->getServerProtocol(expectedVersion);
+	}
+
+	void addref() override { ThreadSafeReferenceCounted<DistributedDatabase>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<DistributedDatabase>::delref(); }
+
+	ThreadFuture<int64_t> rebootWorker(const StringRef& address, bool check, int duration) override {
+		return dbs[0]->rebootWorker(address, check, duration);
+	}
+	ThreadFuture<Void> forceRecoveryWithDataLoss(const StringRef& dcid) override {
+		return dbs[0]->forceRecoveryWithDataLoss(dcid);
+	}
+	ThreadFuture<Void> createSnapshot(const StringRef& uid, const StringRef& snapshot_command) override {
+		return dbs[0]->createSnapshot(uid, snapshot_command);
+	}
+
+	ThreadFuture<Key> purgeBlobGranules(const KeyRangeRef& keyRange, Version purgeVersion, bool force) override {
+		return dbs[0]->purgeBlobGranules(keyRange, purgeVersion, force);
+	}
+	ThreadFuture<Void> waitPurgeGranulesComplete(const KeyRef& purgeKey) override {
+		return dbs[0]->waitPurgeGranulesComplete(purgeKey);
+	}
+
+	ThreadFuture<bool> blobbifyRange(const KeyRangeRef& keyRange) override { return dbs[0]->blobbifyRange(keyRange); }
+	ThreadFuture<bool> blobbifyRangeBlocking(const KeyRangeRef& keyRange) override {
+		return dbs[0]->blobbifyRangeBlocking(keyRange);
+	}
+	ThreadFuture<bool> unblobbifyRange(const KeyRangeRef& keyRange) override {
+		return dbs[0]->unblobbifyRange(keyRange);
+	}
+	ThreadFuture<Standalone<VectorRef<KeyRangeRef>>> listBlobbifiedRanges(const KeyRangeRef& keyRange,
+	                                                                      int rangeLimit) override {
+		return dbs[0]->listBlobbifiedRanges(keyRange, rangeLimit);
+	}
+	ThreadFuture<Version> verifyBlobRange(const KeyRangeRef& keyRange, Optional<Version> version) override {
+		return dbs[0]->verifyBlobRange(keyRange, version);
+	}
+	ThreadFuture<bool> flushBlobRange(const KeyRangeRef& keyRange, bool compact, Optional<Version> version) override {
+		return dbs[0]->flushBlobRange(keyRange, compact, version);
+	}
+
+	// The databases live on different client threads, so they manage their shared state themselves
+	ThreadFuture<DatabaseSharedState*> createSharedState() override { return dbs[0]->createSharedState(); }
+	void setSharedState(DatabaseSharedState* p) override { dbs[0]->setSharedState(p); }
+
+	// Return a JSON string containing database client-side status information
+	ThreadFuture<Standalone<StringRef>> getClientStatus() override { return dbs[0]->getClientStatus(); }
+
+	// Return the metrics of all of the databases, with their counters and histograms added up
+	ThreadFuture<Standalone<StringRef>> getMetrics() override;
+
+	// Return the transaction profiles of all of the databases, ordered by start time
+	ThreadFuture<Standalone<StringRef>> getTransactionProfiles() override;
+
+private:
+	const std::vector<Reference<IDatabase>> dbs;
+	std::atomic<uint32_t> nextDb;
+};
+
 // An implementation of IClientApi that can choose between multiple different client implementations either provided
 // locally within the primary loaded fdb_c client or through any number of dynamically loaded clients.
 //
@@ -1227,7 +1449,8 @@ private:
 	void addExternalLibrary(std::string path, bool useFutureVersion);
 	void addExternalLibraryDirectory(std::string path);
 	// Return a vector of (pathname, unlink_on_close) pairs.  Makes threadCount - 1 copies of the library stored in
-	// path, and returns a vector of length threadCount.
+	// path, and returns a vector of length threadCount. With cacheClientLibCopies, copies left by an earlier process
+	// are reused.
 	std::vector<std::pair<std::string, bool>> copyExternalLibraryPerThread(std::string path);
 	void disableLocalClient();
 	void setSupportedClientVersions(Standalone<StringRef> versions);
@@ -1246,10 +1469,12 @@ private:
 	bool ignoreExternalClientFailures;
 	bool failIncompatibleClient;
 	bool retainClientLibCopies;
+	bool cacheClientLibCopies;
 	ApiVersion apiVersion;
 
 	int nextThread = 0;
 	int threadCount;
+	bool distributeTransactions;
 	std::string tmpDir;
 	bool traceShareBaseNameAmongThreads;
 	std::string traceFileIdentifier;
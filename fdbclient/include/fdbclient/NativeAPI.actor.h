@@ -149,6 +149,7 @@ void runNetwork();
 void stopNetwork();
 
 struct StorageMetrics;
+struct TransactionProfile;
 
 struct TransactionOptions {
 	double maxBackoff;
@@ -171,6 +172,10 @@ struct TransactionOptions {
 	bool bypassStorageQuota : 1;
 	bool enableReplicaConsistencyCheck : 1;
 	int requiredReplicas;
+	// The number of shards a range read may read from at once
+	int rangeReadParallelism;
+	// If present, a cached read version may be used if it was obtained no more than this many seconds ago
+	Optional<double> maxGrvCacheStaleness;
 
 	TransactionPriority priority;
 
@@ -191,7 +196,7 @@ private:
 class ReadYourWritesTransaction; // workaround cyclic dependency
 
 struct TransactionLogInfo : public ReferenceCounted<TransactionLogInfo>, NonCopyable {
-	enum LoggingLocation { DONT_LOG = 0, TRACE_LOG = 1, DATABASE = 2 };
+	enum LoggingLocation { DONT_LOG = 0, TRACE_LOG = 1, DATABASE = 2, CAPTURE = 4 };
 
 	TransactionLogInfo() : logLocation(DONT_LOG), maxFieldLength(0) {}
 	TransactionLogInfo(LoggingLocation location) : logLocation(location), maxFieldLength(0) {}
@@ -212,7 +217,7 @@ struct TransactionLogInfo : public ReferenceCounted<TransactionLogInfo>, NonCopy
 			return;
 		}
 
-		if (logLocation & DATABASE) {
+		if (logLocation & (DATABASE | CAPTURE)) {
 			logsAdded = true;
 			static_assert(std::is_base_of<FdbClientLogEvents::Event, T>::value,
 			              "Event should be derived class of FdbClientLogEvents::Event");
@@ -317,6 +322,9 @@ struct TransactionState : ReferenceCounted<TransactionState> {
 
 	Future<Void> startFuture;
 
+	// Present if the database is keeping transaction profiles, and added to them when this attempt is destroyed
+	std::shared_ptr<TransactionProfile> profile;
+
 	// Only available so that Transaction can have a default constructor, for use in state variables
 	TransactionState(TaskPriority taskID, SpanContext spanContext)
 	  : taskID(taskID), spanContext(spanContext), tenantSet(false) {}
@@ -327,6 +335,7 @@ struct TransactionState : ReferenceCounted<TransactionState> {
 	                 TaskPriority taskID,
 	                 SpanContext spanContext,
 	                 Reference<TransactionLogInfo> trLogInfo);
+	~TransactionState();
 
 	Reference<TransactionState> cloneAndReset(Reference<TransactionLogInfo> newTrLogInfo, bool generateNewSpan) const;
 
@@ -367,7 +376,14 @@ public:
 	Optional<Version> getCachedReadVersion() const;
 
 	[[nodiscard]] Future<Optional<Value>> get(const Key& key, Snapshot = Snapshot::False);
+	// Reads several keys at once, batching the keys served by the same storage team into one request. The result holds
+	// the value of keys[i] at index i.
+	[[nodiscard]] Future<std::vector<Optional<Value>>> getMulti(Standalone<VectorRef<KeyRef>> const& keys,
+	                                                            Snapshot = Snapshot::False);
 	[[nodiscard]] Future<Void> watch(Reference<Watch> watch);
+	// Fires once a key in range changes at a version after the read version, or, rarely, without a change. Unlike
+	// watch(), it does not wait for the transaction to commit.
+	[[nodiscard]] Future<Void> watchRange(KeyRange const& range);
 	[[nodiscard]] Future<Key> getKey(const KeySelector& key, Snapshot = Snapshot::False);
 	// Future< Optional<KeyValue> > get( const KeySelectorRef& key );
 	[[nodiscard]] Future<RangeResult> getRange(const KeySelector& begin,
@@ -408,6 +424,21 @@ public:
 	                                                       Snapshot = Snapshot::False,
 	                                                       Reverse = Reverse::False);
 
+	// Returns the rows of keys that match filter. The storage servers apply the filter, so rows that don't match are
+	// not sent back and don't count against limits. Reads do not see this transaction's writes.
+	[[nodiscard]] Future<RangeResult> getFilteredRange(const KeyRange& keys,
+	                                                   const KeyValueFilter& filter,
+	                                                   GetRangeLimits limits,
+	                                                   Snapshot = Snapshot::False,
+	                                                   Reverse = Reverse::False);
+
+	// Returns the count, bytes, and the sum, minimum and maximum of the little-endian integer values, of the rows of
+	// keys that match filter, or of all of them. The storage servers add up their shards, so the rows are not sent
+	// back. Reads do not see this transaction's writes.
+	[[nodiscard]] Future<RangeAggregate> getRangeAggregate(const KeyRange& keys,
+	                                                       const Optional<KeyValueFilter>& filter = {},
+	                                                       Snapshot = Snapshot::False);
+
 private:
 	template <class GetKeyValuesFamilyRequest, class GetKeyValuesFamilyReply, class RangeResultFamily>
 	Future<RangeResultFamily> getRangeInternal(const KeySelector& begin,
@@ -685,6 +716,19 @@ int64_t getMaxWriteKeySize(KeyRef const& key, bool hasRawAccess);
 // Returns the maximum legal size of a key that can be cleared. Keys larger than this will be assumed not to exist.
 int64_t getMaxClearKeySize(KeyRef const& key);
 
+// Returns the present values among values, where values[i] is the value of keys[i], as key-value pairs in the order of
+// keys. This is the result of a multi-get.
+ACTOR Future<RangeResult> getMultiFromValues(Standalone<VectorRef<KeyRef>> keys,
+                                             std::vector<Future<Optional<Value>>> values);
+
+// Streams the range from begin to end to results a page at a time, reading each page with getPage once the previous one
+// has been taken from results. This is the stream of a range that the storage servers can't stream themselves.
+ACTOR Future<Void> getRangeStreamFromPages(
+    PromiseStream<RangeResult> results,
+    std::function<Future<RangeResult>(KeySelector const&, KeySelector const&)> getPage,
+    KeySelector begin,
+    KeySelector end);
+
 struct KeyRangeLocationInfo;
 // Return the aggregated StorageMetrics of range keys to the caller. The locations tell which interface should
 // serve the request. The final result is within (min-permittedError/2, max + permittedError/2) if valid.
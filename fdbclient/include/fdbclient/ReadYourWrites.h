@@ -80,6 +80,7 @@ public:
 	Future<Version> getReadVersion() override;
 	Optional<Version> getCachedReadVersion() const override { return tr.getCachedReadVersion(); }
 	Future<Optional<Value>> get(const Key& key, Snapshot = Snapshot::False) override;
+	Future<RangeResult> getMulti(Standalone<VectorRef<KeyRef>> const& keys, Snapshot = Snapshot::False) override;
 	Future<Key> getKey(const KeySelector& key, Snapshot = Snapshot::False) override;
 	Future<RangeResult> getRange(const KeySelector& begin,
 	                             const KeySelector& end,
@@ -117,6 +118,10 @@ public:
 	                                         GetRangeLimits limits,
 	                                         Snapshot = Snapshot::False,
 	                                         Reverse = Reverse::False) override;
+	Future<Void> getRangeStream(PromiseStream<RangeResult>& results,
+	                            KeySelector const& begin,
+	                            KeySelector const& end,
+	                            Snapshot = Snapshot::False) override;
 
 	[[nodiscard]] Future<Standalone<VectorRef<const char*>>> getAddressesForKey(const Key& key) override;
 	Future<Standalone<VectorRef<KeyRef>>> getRangeSplitPoints(const KeyRange& range, int64_t chunkSize) override;
@@ -142,6 +147,7 @@ public:
 	void clear(const KeyRef& key) override;
 
 	[[nodiscard]] Future<Void> watch(const Key& key) override;
+	[[nodiscard]] Future<Void> watchRange(KeyRange const& range) override;
 
 	void addWriteConflictRange(KeyRangeRef const& keys) override;
 
@@ -160,7 +166,7 @@ public:
 	[[nodiscard]] Future<Void> onError(Error const& e) override;
 
 	// These are to permit use as state variables in actors:
-	ReadYourWritesTransaction() : cache(&arena), writes(&arena) {}
+	ReadYourWritesTransaction() : cache(&arena), writes(&arena), logBlindWrites(false) {}
 	void operator=(ReadYourWritesTransaction&& r) noexcept;
 	ReadYourWritesTransaction(ReadYourWritesTransaction&& r) noexcept;
 
@@ -234,6 +240,9 @@ private:
 	Transaction tr;
 	SnapshotCache cache;
 	WriteMap writes;
+	// Until the transaction first needs the write map, single key writes are only appended to blindWrites
+	BlindWriteLog blindWrites;
+	bool logBlindWrites;
 	CoalescedKeyRefRangeMap<bool> readConflicts;
 	Map<Key, std::vector<Reference<Watch>>> watchMap; // Keys that are being watched in this transaction
 	Promise<Void> resetPromise;
@@ -263,6 +272,8 @@ private:
 	    KeyRangeRef const& keys,
 	    WriteMap::iterator& it); // pre: it.segmentContains(keys.begin), keys are already inside this->arena
 	void writeRangeToNativeTransaction(KeyRangeRef const& keys);
+	void writeBlindWritesToNativeTransaction();
+	void useWriteMap(); // moves any logged blind writes into the write map, which is used for every write after
 
 	void resetRyow(); // doesn't reset the encapsulated transaction, or creation time/retry state
 	KeyRef getMaxReadKey();
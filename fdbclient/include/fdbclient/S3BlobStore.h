@@ -147,7 +147,7 @@ public:
 		    concurrent_uploads, concurrent_lists, concurrent_reads_per_file, concurrent_writes_per_file,
 		    enable_read_cache, read_block_size, read_ahead_blocks, read_cache_blocks_per_file,
 		    max_send_bytes_per_second, max_recv_bytes_per_second, sdk_auth, global_connection_pool,
-		    max_delay_retryable_error, max_delay_connection_failed;
+		    max_delay_retryable_error, max_delay_connection_failed, adaptive_uploads;
 
 		bool set(StringRef name, int value);
 		std::string getURLParameters() const;
@@ -177,7 +177,8 @@ public:
 				"concurrent_writes_per_file (or cwps)  Max concurrent uploads in progress for any one file.",
 				"enable_read_cache (or erc)            Whether read block caching is enabled.",
 				"read_block_size (or rbs)              Block size in bytes to be used for reads.",
-				"read_ahead_blocks (or rab)            Number of blocks to read ahead of requested offset.",
+				"read_ahead_blocks (or rab)            Max number of blocks to read ahead of requested offset, for "
+				"sequential reads.",
 				"read_cache_blocks_per_file (or rcb)   Size of the read cache for a file in blocks.",
 				"max_send_bytes_per_second (or sbps)   Max send bytes per second for all requests combined.",
 				"max_recv_bytes_per_second (or rbps)   Max receive bytes per second for all requests combined (NOT YET "
@@ -187,7 +188,9 @@ public:
 				"failure.",
 				"sdk_auth (or sa)                      Use AWS SDK to resolve credentials. Only valid if "
 				"BUILD_AWS_BACKUP is enabled.",
-				"global_connection_pool (or gcp)       Enable shared connection pool between all blobstore instances."
+				"global_connection_pool (or gcp)       Enable shared connection pool between all blobstore instances.",
+				"adaptive_uploads (or au)              Set 1 to size multipart upload parts and set per-file upload "
+				"concurrency from the throughput and latency of earlier uploads to the bucket."
 			};
 		}
 
@@ -199,9 +202,28 @@ public:
 		double expirationTime;
 	};
 
-	// basically, reference counted queue with option to add other fields
+	// basically, reference counted stack with option to add other fields. Connections are reused most recently returned
+	// first, since a connection that has been idle for long has to ramp its TCP congestion window up again.
 	struct ConnectionPoolData : NonCopyable, ReferenceCounted<ConnectionPoolData> {
-		std::queue<ReusableConnection> pool;
+		std::deque<ReusableConnection> pool;
+	};
+
+	// Tunes multipart uploads to a bucket, when knobs.adaptive_uploads is set, from how the parts uploaded so far did.
+	// Parts are sized so that each takes about CLIENT_KNOBS->BLOBSTORE_ADAPTIVE_PART_SECONDS at the throughput of a
+	// single upload, and how many parts of a file are uploaded at once is raised by about one for each round of parts
+	// that upload about as fast per byte as the best seen, and halved when they slow down or fail.
+	struct UploadTuner {
+		// Smoothed throughput of a single part upload
+		double bytesPerSecond = 0;
+		// The least time a byte of a part has taken to upload, slowly decaying so that it follows lasting changes
+		double bestSecondsPerByte = 0;
+		double writesPerFile = 0;
+		double lastDecrease = 0;
+
+		void partUploaded(BlobKnobs const& knobs, int bytes, double seconds);
+		void backOff(BlobKnobs const& knobs);
+		int partSize(BlobKnobs const& knobs) const;
+		static int maxWritesPerFile(BlobKnobs const& knobs);
 	};
 
 	// global connection pool for multiple blobstore endpoints with same connection settings and request destination
@@ -305,6 +327,11 @@ public:
 	FlowLock concurrentRequests;
 	FlowLock concurrentUploads;
 	FlowLock concurrentLists;
+	std::unordered_map<std::string, UploadTuner> uploadTuners;
+
+	// The size parts of the next multipart upload to bucket should be, and how many of them may be uploaded at once
+	int uploadPartSize(std::string const& bucket);
+	int uploadWritesPerFile(std::string const& bucket);
 
 	Future<Void> updateSecret();
 
@@ -49,6 +49,9 @@ public:
 
 	// TLogs
 	bool PEEK_USING_STREAMING;
+	int PEEK_STREAM_WINDOW_BYTES; // Reply bytes a peek stream may have outstanding before the TLog waits for acks
+	int TLOG_PEEK_STREAM_REPLY_BYTES; // Target size of a peek stream reply to a cursor that is behind
+	double TLOG_PEEK_STREAM_REPLY_TIME; // Longest time spent collecting one peek stream reply
 	double TLOG_TIMEOUT; // tlog OR commit proxy failure - master's reaction time
 	double TLOG_SLOW_REJOIN_WARN_TIMEOUT_SECS; // Warns if a tlog takes too long to rejoin
 	double TLOG_STORAGE_MIN_UPDATE_INTERVAL;
@@ -83,15 +86,39 @@ public:
 	int CONCURRENT_LOG_ROUTER_READS;
 	int LOG_ROUTER_PEEK_FROM_SATELLITES_PREFERRED; // 0==peek from primary, non-zero==peek from satellites
 	double LOG_ROUTER_PEEK_SWITCH_DC_TIME;
+	int64_t LOG_ROUTER_MAX_BUFFERED_BYTES; // A log router stops pulling while it holds this many unpopped bytes
+	std::string LOG_ROUTER_PEEK_COMPRESSION_FILTER; // Compression of TLog replies to log router peeks, or NONE
 	double DISK_QUEUE_ADAPTER_MIN_SWITCH_TIME;
 	double DISK_QUEUE_ADAPTER_MAX_SWITCH_TIME;
 	int64_t TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES;
 	int64_t TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK;
 	int64_t TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH;
+	int64_t TLOG_PEEK_REPLY_CACHE_BYTES; // Bytes of peek replies that were cut short by size which each tlog generation
+	                                     // keeps for other cursors peeking the same tag from the same version
+	int64_t TLOG_SPILL_INDEX_BYTES_PER_TAG; // Bytes of a tag's latest spilled references kept in memory, so that peeks
+	                                        // and pops need not read them back from persistentData. 0 disables.
 	int64_t DISK_QUEUE_FILE_EXTENSION_BYTES; // When we grow the disk queue, by how many bytes should it grow?
 	int64_t DISK_QUEUE_FILE_SHRINK_BYTES; // When we shrink the disk queue, by how many bytes should it shrink?
 	int64_t DISK_QUEUE_MAX_TRUNCATE_BYTES; // A truncate larger than this will cause the file to be replaced instead.
+	int64_t DISK_QUEUE_PREALLOCATED_BYTES; // Each disk queue file is grown to at least this size the first time it is
+	                                       // extended and is never shrunk below it, so that once both files reach it
+	                                       // pushes do not change file sizes. 0 disables preallocation.
+	int DISK_QUEUE_RECOVERY_READ_BYTES; // Size of each sequential read of the disk queue files during recovery
+	int DISK_QUEUE_RECOVERY_READ_AHEAD; // Number of those reads kept in flight ahead of the pages being recovered
 	double TLOG_DEGRADED_DURATION;
+	// With DiskQueue commits arriving back to back, a tlog delays starting the next one by this fraction of the
+	// smoothed commit duration, at most TLOG_GROUP_COMMIT_MAX_DELAY, so that more versions share its fsync. 0 disables.
+	double TLOG_GROUP_COMMIT_MAX_DELAY;
+	double TLOG_GROUP_COMMIT_LATENCY_FRACTION;
+	double TLOG_GROUP_COMMIT_SMOOTHING_TIME;
+	// Once a tlog's volatile bytes pass this fraction of its spill threshold, its oldest message blocks are compacted
+	// to the messages some tag has not popped yet and compressed in frames of about TLOG_COMPRESSION_FRAME_BYTES,
+	// which are decompressed on peek, so that it holds more of a lagging storage server's data before spilling.
+	bool TLOG_COMPRESS_MESSAGE_BLOCKS;
+	double TLOG_COMPRESSION_SPILL_THRESHOLD_FRACTION;
+	std::string TLOG_COMPRESSION_FILTER;
+	int TLOG_COMPRESSION_FRAME_BYTES;
+	int TLOG_DECOMPRESSED_FRAME_CACHE_SIZE; // The number of decompressed frames each tlog generation keeps for peeks
 	int64_t MAX_CACHE_VERSIONS;
 	double TXS_POPPED_MAX_DELAY;
 	double TLOG_MAX_CREATE_DURATION;
@@ -215,6 +242,12 @@ public:
 	// The constant interval DD update pivot values for team selection. It should be >=
 	// min(STORAGE_METRICS_POLLING_DELAY,DETAILED_METRIC_UPDATE_RATE)  otherwise the pivot won't change;
 	double DD_TEAM_PIVOT_UPDATE_DELAY;
+	// When positive, a team's load bytes are scaled by 1 + DD_PREDICTED_LOAD_WEIGHT * its predicted utilization, so
+	// that teams forecast to be busy are less likely to be chosen as a destination, and more likely as a source
+	double DD_PREDICTED_LOAD_WEIGHT;
+	// Smoothing factors for the level and the trend of the per-server load forecasts, between 0 and 1
+	double DD_LOAD_FORECAST_ALPHA;
+	double DD_LOAD_FORECAST_BETA;
 
 	bool ALLOW_LARGE_SHARD;
 	int MAX_LARGE_SHARD_BYTES;
@@ -223,6 +256,8 @@ public:
 	bool ENABLE_DD_PHYSICAL_SHARD; // EXPERIMENTAL; If true, SHARD_ENCODE_LOCATION_METADATA must be true.
 	double DD_PHYSICAL_SHARD_MOVE_PROBABILITY; // Percentage of physical shard move, in the range of [0, 1].
 	bool ENABLE_PHYSICAL_SHARD_MOVE_EXPERIMENT;
+	bool DD_PHYSICAL_SHARD_MOVE_FOR_SHARDED_ROCKSDB; // If true, data moves are physical when the configured storage
+	                                                 // engine is ShardedRocksDB, regardless of the probability above
 	int64_t MAX_PHYSICAL_SHARD_BYTES;
 	double PHYSICAL_SHARD_METRICS_DELAY;
 	double ANONYMOUS_PHYSICAL_SHARD_TRANSITION_TIME;
@@ -254,6 +289,11 @@ public:
 	double SHARD_MAX_READ_DENSITY_RATIO;
 	int64_t SHARD_READ_HOT_BANDWIDTH_MIN_PER_KSECONDS;
 	double SHARD_MAX_BYTES_READ_PER_KSEC_JITTER;
+	bool DD_CACHE_READ_HOT_RANGES; // Assign the read hot ranges that DD detects to storage cache servers
+	int DD_CACHE_READ_HOT_RANGES_MAX; // The most read hot ranges DD keeps cached at once
+	bool DD_SPLIT_READ_HOT_SHARDS; // Split a read hot shard around the hot ranges within it and move them elsewhere
+	double DD_CACHE_READ_HOT_RANGE_TTL; // A range DD cached is uncached once it has not been read hot for this long
+	bool STORAGE_KVS_RANGE_SIZE_ESTIMATE; // Answer range size estimates from the storage engine when it supports them
 	double STORAGE_METRIC_TIMEOUT;
 	double METRIC_DELAY;
 	double ALL_DATA_REMOVED_DELAY;
@@ -271,6 +311,8 @@ public:
 	                                                // balanced/filledup before starting the next wiggle.
 	double PERPETUAL_WIGGLE_DELAY; // The max interval between the last wiggle finish and the next wiggle start
 	bool PERPETUAL_WIGGLE_DISABLE_REMOVER; // Whether the start of perpetual wiggle replace team remover
+	int PERPETUAL_WIGGLE_MAX_SERVERS_PER_ZONE; // Max number of storage servers of one zone wiggled together
+	bool PERPETUAL_WIGGLE_PREFER_SMALLER_SERVERS; // Wiggle misconfigured storage servers with the least data first
 	double LOG_ON_COMPLETION_DELAY;
 	int BEST_TEAM_MAX_TEAM_TRIES;
 	int BEST_TEAM_OPTION_COUNT;
@@ -387,6 +429,10 @@ public:
 	int DD_BULKLOAD_PARALLELISM; // the maximum number of running bulk load tasks
 	double DD_BULKLOAD_SCHEDULE_MIN_INTERVAL_SEC; // the minimal seconds that the bulk load scheduler has to wait
 	                                              // between two rounds
+	int BULK_RESTORE_SHARD_BYTES; // the target bytes of range files a bulk restore converts into each bulk loaded shard
+	int BULK_RESTORE_PARALLELISM; // the maximum number of shards a bulk restore converts or applies logs to at once
+	int BULK_RESTORE_LOG_BATCH_BYTES; // the bytes of mutation logs a bulk restore decodes before applying them
+	int BULK_RESTORE_TRANSACTION_BYTES; // the bytes of mutation logs a bulk restore applies per transaction
 
 	// Run storage engine on a child process on the same machine with storage process
 	bool REMOTE_KV_STORE;
@@ -434,6 +480,11 @@ public:
 
 	// KeyValueStoreMemory
 	int64_t REPLACE_CONTENTS_BYTES;
+	bool KVS_MEMORY_PARALLEL_RECOVERY; // Copy recovered sets on the worker pool
+	int KVS_MEMORY_RECOVERY_CHUNK_SETS; // Sets copied by each worker pool task
+	// Bytes of snapshot written per byte committed. Less writes less in the background, and keeps more of the log on
+	// disk, to be replayed on recovery, between two snapshots.
+	double KVS_MEMORY_SNAPSHOT_WRITE_RATIO;
 
 	// KeyValueStoreRocksDB
 	bool ROCKSDB_SET_READ_TIMEOUT;
@@ -466,6 +517,10 @@ public:
 	double ROCKSDB_READ_CHECKPOINT_TIMEOUT;
 	int64_t ROCKSDB_CHECKPOINT_READ_AHEAD_SIZE;
 	double ROCKSDB_READ_QUEUE_WAIT;
+	// Point reads of one type started during the same flow task are read together with MultiGet, this many at a
+	// time. 1 reads each with its own Get.
+	int ROCKSDB_READ_VALUE_BATCH_SIZE;
+	bool ROCKSDB_READ_ASYNC_IO; // Lets a MultiGet read data blocks from several files at once
 	int ROCKSDB_READ_QUEUE_SOFT_MAX;
 	int ROCKSDB_READ_QUEUE_HARD_MAX;
 	int ROCKSDB_FETCH_QUEUE_SOFT_MAX;
@@ -525,6 +580,7 @@ public:
 	bool ROCKSDB_EMPTY_RANGE_CHECK;
 	int ROCKSDB_CREATE_BYTES_SAMPLE_FILE_RETRY_MAX;
 	bool ROCKSDB_ATOMIC_FLUSH;
+	bool ROCKSDB_DISABLE_WAL; // Commit without the RocksDB WAL, flushing the memtables written by each commit instead
 	bool ROCKSDB_IMPORT_MOVE_FILES;
 	bool ROCKSDB_CHECKPOINT_REPLAY_MARKER;
 	bool ROCKSDB_VERIFY_CHECKSUM_BEFORE_RESTORE; // Conduct block-level checksum when rocksdb injecting data
@@ -570,8 +626,15 @@ public:
 	int SHARDED_ROCKSDB_TARGET_FILE_SIZE_BASE;
 	int SHARDED_ROCKSDB_TARGET_FILE_SIZE_MULTIPLIER;
 	bool SHARDED_ROCKSDB_SUGGEST_COMPACT_CLEAR_RANGE;
+	bool SHARDED_ROCKSDB_CHEAP_SHARD_REMOVAL; // Clear whole physical shards with one tombstone and no compaction, they
+	                                          // are dropped with their column family once removed
 	int SHARDED_ROCKSDB_MAX_BACKGROUND_JOBS;
 	int64_t SHARDED_ROCKSDB_BLOCK_CACHE_SIZE;
+	// The share of the block cache kept for high priority blocks. With SHARDED_ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS,
+	// those are every physical shard's index and filter blocks.
+	double SHARDED_ROCKSDB_BLOCK_CACHE_HIGH_PRI_POOL_RATIO;
+	bool SHARDED_ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
+	bool SHARDED_ROCKSDB_FETCH_FILL_CACHE; // False keeps data moves' reads out of the block cache
 	int64_t SHARDED_ROCKSDB_WRITE_RATE_LIMITER_BYTES_PER_SEC;
 	int64_t SHARDED_ROCKSDB_RATE_LIMITER_MODE;
 	int SHARDED_ROCKSDB_BACKGROUND_PARALLELISM;
@@ -639,6 +702,8 @@ public:
 	double ENFORCED_MIN_RECOVERY_DURATION;
 	double REQUIRED_MIN_RECOVERY_DURATION;
 	bool ALWAYS_CAUSAL_READ_RISKY;
+	double GRV_LEASE_DURATION; // If positive, causal-read-risky GRVs may be served from a read version the GRV proxy
+	                           // fetched at most this many seconds ago, instead of asking the master again
 	int MAX_COMMIT_UPDATES;
 	double MAX_PROXY_COMPUTE;
 	double MAX_COMPUTE_PER_OPERATION;
@@ -648,6 +713,12 @@ public:
 	int TXN_STATE_SEND_AMOUNT;
 	double REPORT_TRANSACTION_COST_ESTIMATION_DELAY;
 	bool PROXY_REJECT_BATCH_QUEUED_TOO_LONG;
+	// Number of threads a commit proxy uses to encrypt the mutations of a batch before tagging them. 0 encrypts on the
+	// network thread as each mutation is written.
+	int COMMIT_PROXY_ENCRYPTION_THREADS;
+	// Batches with fewer mutations to encrypt than this are encrypted on the network thread
+	int COMMIT_PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS;
+	bool COMMIT_PROXY_KEY_INFO_INDEX; // Look up the shards of mutations with a flattened copy of the proxy's shard map
 	bool PROXY_USE_RESOLVER_PRIVATE_MUTATIONS;
 	bool BURSTINESS_METRICS_ENABLED;
 	// Interval on which to emit burstiness metrics on the commit proxy (in
@@ -669,6 +740,7 @@ public:
 	int64_t MIN_BALANCE_DIFFERENCE;
 	double SECONDS_BEFORE_NO_FAILURE_DELAY;
 	int64_t MAX_TXS_SEND_MEMORY;
+	std::string TXN_STATE_COMPRESSION_FILTER; // Compression of the txnStateStore sent to new commit proxies, or NONE
 	int64_t MAX_RECOVERY_VERSIONS;
 	double MAX_RECOVERY_TIME;
 	double PROVISIONAL_START_DELAY;
@@ -683,6 +755,14 @@ public:
 	double SAMPLE_EXPIRATION_TIME;
 	double SAMPLE_POLL_TIME;
 	int64_t RESOLVER_STATE_MEMORY_LIMIT;
+	// Number of key space partitions (and threads, outside simulation) the resolver uses to check and insert the
+	// conflict ranges of a batch. 1 disables partitioning.
+	int RESOLVER_CONFLICT_DETECTION_PARALLELISM;
+	// Batches with fewer read or write conflict ranges per partition than this are processed on the calling thread
+	int RESOLVER_CONFLICT_DETECTION_MIN_RANGES_PER_PARTITION;
+	// Keep the resolver's write history in a prefix-compressed block index instead of the SkipList, trading some CPU
+	// for much less memory when MAX_WRITE_TRANSACTION_LIFE_VERSIONS is large
+	bool RESOLVER_USE_COMPRESSED_CONFLICT_HISTORY;
 
 	// Backup Worker
 	double BACKUP_TIMEOUT; // master's reaction time for backup failure
@@ -690,6 +770,9 @@ public:
 	int BACKUP_FILE_BLOCK_BYTES;
 	int64_t BACKUP_LOCK_BYTES;
 	double BACKUP_UPLOAD_DELAY;
+	int64_t BACKUP_WORKER_MIN_FILE_BYTES;
+	double BACKUP_WORKER_MAX_FILE_DELAY;
+	bool BACKUP_WORKER_COMPRESS_LOG_FILES;
 
 	// Cluster Controller
 	double CLUSTER_CONTROLLER_LOGGING_DELAY;
@@ -815,6 +898,9 @@ public:
 	double RATEKEEPER_DEFAULT_LIMIT;
 	double RATEKEEPER_LIMIT_REASON_SAMPLE_RATE;
 	bool RATEKEEPER_PRINT_LIMIT_REASON;
+	std::string RATEKEEPER_RECORD_DIR; // Where ratekeeper records its inputs and decisions for replay, if set
+	int64_t RATEKEEPER_RECORD_MAX_BYTES; // Recording stops once the file reaches this size
+	double RATEKEEPER_RECORD_FLUSH_INTERVAL;
 	double RATEKEEPER_MIN_RATE;
 	double RATEKEEPER_MAX_RATE;
 	double RATEKEEPER_BATCH_MIN_RATE;
@@ -831,6 +917,18 @@ public:
 	int64_t STORAGE_HARD_LIMIT_BYTES_SPEED_UP_SIM;
 	int64_t STORAGE_HARD_LIMIT_BYTES_OVERAGE_SPEED_UP_SIM;
 	int64_t STORAGE_HARD_LIMIT_VERSION_OVERAGE;
+	// If positive, the bytes a storage server's queue, its storage engine's cache and free FastAllocator memory are
+	// kept within by shrinking the cache and then throttling ingestion. The cache is never shrunk below
+	// STORAGE_MEMORY_BUDGET_MIN_CACHE_FRACTION of its configured size, and ingestion is never throttled below a queue
+	// of STORAGE_MEMORY_BUDGET_MIN_QUEUE_FRACTION of the budget.
+	int64_t STORAGE_MEMORY_BUDGET_BYTES;
+	double STORAGE_MEMORY_BUDGET_INTERVAL;
+	double STORAGE_MEMORY_BUDGET_MIN_CACHE_FRACTION;
+	double STORAGE_MEMORY_BUDGET_MIN_QUEUE_FRACTION;
+	// Pinned read versions are kept readable for at most this many seconds, and only while the storage queue they hold
+	// in memory is below STORAGE_PINNED_READ_VERSION_MAX_BYTES. Pins past the budget are released oldest first.
+	double STORAGE_PINNED_READ_VERSION_MAX_LIFETIME;
+	int64_t STORAGE_PINNED_READ_VERSION_MAX_BYTES;
 	int64_t STORAGE_DURABILITY_LAG_HARD_MAX;
 	int64_t STORAGE_DURABILITY_LAG_SOFT_MAX;
 	bool STORAGE_INCLUDE_FEED_STORAGE_QUEUE;
@@ -910,6 +1008,11 @@ public:
 	double HOT_SHARD_THROTTLING_EXPIRE_AFTER;
 	int64_t HOT_SHARD_THROTTLING_TRACKED;
 	double HOT_SHARD_MONITOR_FREQUENCY;
+	// Throttle the hot shards of a single storage server that limits the cluster, rather than the whole cluster, while
+	// its queue stays within its target and spring bytes
+	bool RATEKEEPER_LOCALIZED_THROTTLING;
+	// Throttling is localized only when the storage server's rate limit is below this fraction of everyone else's
+	double RATEKEEPER_LOCALIZED_THROTTLING_RATIO;
 
 	// allow generating synthetic data for test clusters
 	bool GENERATE_DATA_ENABLED;
@@ -991,12 +1094,18 @@ public:
 	double STORAGE_SERVER_POLL_METRICS_DELAY;
 	double FUTURE_VERSION_DELAY;
 	int STORAGE_LIMIT_BYTES;
+	int RANGE_REPLY_COMPRESSION_MIN_BYTES; // Range read replies at least this big are compressed if the client asks
+	int FILTERED_RANGE_READ_MAX_SCAN_BYTES; // Bytes a filtered range read scans before it replies with what it has
+	int AGGREGATE_RANGE_READ_MAX_SCAN_BYTES; // Bytes an aggregate range read adds up before it replies with a total
 	int BUGGIFY_LIMIT_BYTES;
 	bool FETCH_USING_STREAMING;
 	bool FETCH_USING_BLOB;
 	int FETCH_BLOCK_BYTES;
 	int FETCH_KEYS_PARALLELISM_BYTES;
 	int FETCH_KEYS_PARALLELISM;
+	int FETCH_KEYS_SUBRANGE_PARALLELISM; // Pieces of a shard one fetchKeys reads at once
+	int64_t FETCH_KEYS_SUBRANGE_BYTES; // Roughly how much of a shard each piece fetchKeys reads holds
+	int FETCH_KEYS_READ_AHEAD_BYTES; // Fetched blocks the pieces fetchKeys reads ahead may hold between them
 	int FETCH_KEYS_PARALLELISM_CHANGE_FEED;
 	int FETCH_KEYS_LOWER_PRIORITY;
 	int SERVE_FETCH_CHECKPOINT_PARALLELISM;
@@ -1008,6 +1117,8 @@ public:
 	bool AUDIT_DATAMOVE_POST_CHECK;
 	int AUDIT_DATAMOVE_POST_CHECK_RETRY_COUNT_MAX;
 	int AUDIT_STORAGE_RATE_PER_SERVER_MAX;
+	int AUDIT_STORAGE_DIGEST_BYTES; // Most bytes of a range a replica audit compares by digest at once; 0 disables
+	int AUDIT_STORAGE_DIGEST_FANOUT; // Factor a replica audit shrinks its digest range by after a mismatch
 	bool ENABLE_AUDIT_VERBOSE_TRACE;
 	bool LOGGING_STORAGE_COMMIT_WHEN_IO_TIMEOUT;
 	double LOGGING_COMPLETE_STORAGE_COMMIT_PROBABILITY;
@@ -1023,6 +1134,10 @@ public:
 	int STORAGE_FETCH_BYTES;
 	int STORAGE_ROCKSDB_FETCH_BYTES;
 	double STORAGE_COMMIT_INTERVAL;
+	// Free the versioned map nodes left behind by forgotten versions on a separate thread
+	bool STORAGE_RECLAIM_VERSIONS_IN_BACKGROUND;
+	// Let concurrent getValue requests for the same key share one storage engine read
+	bool STORAGE_COALESCE_VALUE_READS;
 	int BYTE_SAMPLING_FACTOR;
 	int BYTE_SAMPLING_OVERHEAD;
 	double MIN_BYTE_SAMPLING_PROBABILITY; // Adjustable only for test of PhysicalShardMove. Should always be 0 for other
@@ -1033,6 +1148,9 @@ public:
 	int BYTE_SAMPLE_LOAD_PARALLELISM;
 	double BYTE_SAMPLE_LOAD_DELAY;
 	double BYTE_SAMPLE_START_DELAY;
+	// Restore change feed metadata in the background while the storage server starts up. Updates and change feed
+	// requests wait for it to finish.
+	bool STORAGE_LAZY_CHANGE_FEED_RESTORE;
 	double BEHIND_CHECK_DELAY;
 	int BEHIND_CHECK_COUNT;
 	int64_t BEHIND_CHECK_VERSIONS;
@@ -1053,6 +1171,7 @@ public:
 	double MAX_STORAGE_COMMIT_TIME;
 	int64_t RANGESTREAM_LIMIT_BYTES;
 	int64_t CHANGEFEEDSTREAM_LIMIT_BYTES;
+	int64_t CHANGE_FEED_DISK_READ_CACHE_BYTES; // Recent change feed disk reads kept for other streams of the same feed
 	int64_t BLOBWORKERSTATUSSTREAM_LIMIT_BYTES;
 	bool ENABLE_CLEAR_RANGE_EAGER_READS;
 	bool QUICK_GET_VALUE_FALLBACK;
@@ -1067,8 +1186,14 @@ public:
 	std::string STORAGESERVER_READ_PRIORITIES;
 	int STORAGE_SERVER_READ_CONCURRENCY;
 	std::string STORAGESERVER_READTYPE_PRIORITY_MAP;
+	double STORAGE_SERVER_BUSY_TAG_READ_FRACTION;
+	// Read cost, in bytes, charged to a tag for each second a storage server spends serving one of its reads, when
+	// that is more than the bytes read cost. 0 charges by bytes read only.
+	double STORAGE_READ_TAG_COST_PER_SECOND;
 	int SPLIT_METRICS_MAX_ROWS;
 	double STORAGE_SHARD_CONSISTENCY_CHECK_INTERVAL;
+	double STORAGE_COLD_SHARD_AGE; // Seconds without writes after which a readable shard is reported as cold
+	double STORAGE_COLD_SHARD_CHECK_INTERVAL; // How often cold shards are counted, or never if not positive
 	int PHYSICAL_SHARD_MOVE_LOG_SEVERITY;
 	int FETCH_SHARD_BUFFER_BYTE_LIMIT;
 	int FETCH_SHARD_UPDATES_BYTE_LIMIT;
@@ -1144,6 +1269,10 @@ public:
 	// Status
 	double STATUS_MIN_TIME_BETWEEN_REQUESTS;
 	double MAX_STATUS_REQUESTS_PER_SECOND;
+	// While status is being requested, the cluster controller refreshes the events it needs from every worker this
+	// often, and answers requests from them rather than asking every worker each time. 0 disables this.
+	double STATUS_WORKER_EVENT_REFRESH_INTERVAL;
+	double STATUS_WORKER_EVENT_IDLE_TIMEOUT; // Refreshing stops when status hasn't been requested for this long
 	int CONFIGURATION_ROWS_TO_FETCH;
 	bool DISABLE_DUPLICATE_LOG_WARNING;
 	double HISTOGRAM_REPORT_INTERVAL;
@@ -1210,6 +1339,7 @@ public:
 	int REDWOOD_DEFAULT_EXTENT_READ_SIZE; // Extent read size for Redwood files
 	int REDWOOD_EXTENT_CONCURRENT_READS; // Max number of simultaneous extent disk reads in progress.
 	bool REDWOOD_KVSTORE_RANGE_PREFETCH; // Whether to use range read prefetching
+	int REDWOOD_KVSTORE_RANGE_PREFETCH_LEAVES; // Max leaves ahead of a range read's cursor to prefetch at once
 	double REDWOOD_PAGE_REBUILD_MAX_SLACK; // When rebuilding pages, max slack to allow in page before extending it
 	double REDWOOD_PAGE_REBUILD_SLACK_DISTRIBUTION; // When rebuilding pages, use this ratio of slack distribution
 	                                                // between the rightmost (new) page and the previous page. Defaults
@@ -1224,6 +1354,7 @@ public:
 	                                  // queue is empty
 	int REDWOOD_LAZY_CLEAR_MAX_PAGES; // Maximum number of pages to free before ending a lazy clear cycle, unless the
 	                                  // queue is empty
+	bool REDWOOD_ENABLE_CLEAR_RANGE_EAGER_READS; // Whether storage servers on Redwood expand clears with eager reads
 	int64_t REDWOOD_REMAP_CLEANUP_WINDOW_BYTES; // Total size of remapped pages to keep before being removed by
 	                                            // remap cleanup
 	double REDWOOD_REMAP_CLEANUP_TOLERANCE_RATIO; // Maximum ratio of the remap cleanup window that remap cleanup is
@@ -1233,14 +1364,37 @@ public:
 	double REDWOOD_HISTOGRAM_INTERVAL;
 	bool REDWOOD_EVICT_UPDATED_PAGES; // Whether to prioritize eviction of updated pages from cache.
 	int REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT; // Minimum height for which to keep and reuse page decode caches
+	bool REDWOOD_LEAF_SEARCH_INDEX; // Whether to keep leaf page decode caches along with a search index for each page
+	// Number of threads each Redwood pager uses to encrypt the pages it writes. 0 encrypts on the network thread.
+	int REDWOOD_PAGE_ENCODING_THREADS;
+	// Number of free pages Redwood takes from its free list at a time to allocate new pages from in page ID order, so
+	// that pages written together are placed together. 0 or 1 allocates directly from the free list.
+	int REDWOOD_PAGE_ALLOCATION_POOL_SIZE;
+	// Memory each Redwood pager may use for Bloom filters over the keys of leaf pages, which let point reads of missing
+	// keys skip reading the leaf page. 0 disables the filters.
+	int64_t REDWOOD_LEAF_KEY_FILTER_MEMORY;
+	int REDWOOD_LEAF_KEY_FILTER_BITS_PER_KEY; // Size of leaf page key filters, a 1% false positive rate needs 10
 	int REDWOOD_NODE_MAX_UNBALANCE; // Maximum imbalance in a node before it should be rebuilt instead of updated
 
 	std::string REDWOOD_IO_PRIORITIES;
+	// Whether the page cache uses a segmented LRU, where pages must be hit again after insertion to reach the protected
+	// segment, so that a large scan can only push out other pages which have not been reused. Reads at FETCH or LOW
+	// priority, or which do not cache their results, never count as hits under this policy.
+	bool REDWOOD_PAGE_CACHE_SCAN_RESISTANT;
+	double REDWOOD_PAGE_CACHE_PROTECTED_FRACTION; // Fraction of the page cache size limit the protected segment may use
 
 	// Server request latency measurement
 	double LATENCY_SKETCH_ACCURACY;
 	double FILE_LATENCY_SKETCH_ACCURACY;
 	double LATENCY_METRICS_LOGGING_INTERVAL;
+	int TENANT_LATENCY_MAX_TRACKED; // Tenant and request type pairs whose latencies a role tracks, 0 to disable
+	double TENANT_LATENCY_SKETCH_ACCURACY;
+	double TENANT_LATENCY_EXPIRE_AFTER; // Tenants with no requests for this long stop being tracked
+	int TENANT_LATENCY_STATUS_TENANTS; // The tenants missing their objectives the most that are reported in status
+	double TENANT_READ_LATENCY_SLO; // Per point read, and per KB returned by range reads
+	double TENANT_COMMIT_LATENCY_SLO;
+	int HOT_KEY_TRACKER_CAPACITY; // Reads and writes each counted by a storage server's hot key sketch, 0 to disable
+	double HOT_KEY_TRACKER_WINDOW;
 
 	// Cluster recovery
 	std::string CLUSTER_RECOVERY_EVENT_NAME_PREFIX;
@@ -1248,6 +1402,10 @@ public:
 	// Encryption
 	int SIM_KMS_MAX_KEYS;
 	int ENCRYPT_PROXY_MAX_DBG_TRACE_LENGTH;
+	bool ENCRYPT_PROXY_COALESCE_KMS_FETCHES; // Latest cipher key lookups wait on in-flight KMS fetches for the same
+	                                         // domains instead of issuing their own
+	bool ENCRYPT_PROXY_SERVE_STALE_CIPHER_KEYS; // Keys past their refresh time but not yet expired are served from the
+	                                            // cache while being refreshed in the background
 	double ENCRYPTION_LOGGING_INTERVAL;
 	double DISABLED_ENCRYPTION_PROBABILITY_SIM; // Probability that encryption is forced to be disabled in simulation
 
@@ -1271,6 +1429,8 @@ public:
 	int BG_SNAPSHOT_FILE_TARGET_CHUNK_BYTES;
 	int BG_DELTA_FILE_TARGET_BYTES;
 	int BG_DELTA_FILE_TARGET_CHUNK_BYTES;
+	bool BG_DELTA_FILE_COLUMNAR; // Write delta file chunks column by column. Older versions cannot read these files.
+	int BG_RESNAPSHOT_SLICE_BYTES; // Bytes of the old snapshot to merge with the deltas at a time when re-snapshotting
 	int BG_DELTA_BYTES_BEFORE_COMPACT;
 	int BG_MAX_SPLIT_FANOUT;
 	int BG_MAX_MERGE_FANIN;
@@ -1310,6 +1470,7 @@ public:
 	double BLOB_WORKER_REJECT_WHEN_FULL_THRESHOLD;
 	double BLOB_WORKER_FORCE_FLUSH_CLEANUP_DELAY;
 	bool BLOB_WORKER_DISK_ENABLED;
+	int64_t BLOB_WORKER_DISK_CACHE_BYTES; // Local disk for caching granule files read from the blob store. 0 disables.
 	int BLOB_WORKER_STORE_TYPE;
 	double BLOB_WORKER_REJOIN_TIME;
 
@@ -1363,11 +1524,16 @@ public:
 	double REST_KMS_STABILITY_CHECK_INTERVAL;
 
 	double CONSISTENCY_SCAN_ACTIVE_THROTTLE_RATIO;
+	int CONSISTENCY_SCAN_CHECKSUM_BYTES; // Bytes of a range compared by checksum per request; if 0, replicas send data
+	double CONSISTENCY_SCAN_BUSYNESS_THRESHOLD; // Replica run loop busyness above which the scan backs off
+	double CONSISTENCY_SCAN_MIN_LOAD_FACTOR; // Smallest fraction of the configured rate the scan backs off to
+	double CONSISTENCY_SCAN_LOAD_FACTOR_INCREASE; // Fraction of the configured rate regained per unloaded iteration
 
 	// Idempotency ids
 	double IDEMPOTENCY_ID_IN_MEMORY_LIFETIME;
 	double IDEMPOTENCY_IDS_CLEANER_POLLING_INTERVAL;
 	double IDEMPOTENCY_IDS_MIN_AGE_SECONDS;
+	double IDEMPOTENCY_ID_CLEAR_COALESCE_DELAY;
 
 	// Swift: Enable the Swift runtime hooks and use Swift implementations where possible
 	bool FLOW_WITH_SWIFT;
@@ -156,6 +156,10 @@ private:
 		KeyRef beginKey;
 		ExtStringRef endKey;
 		VectorRef<KeyValueRef> values;
+		// Only set when the cache is limited, in which case the entry keeps the memory of its values alive
+		Arena valuesArena;
+		int64_t valueBytes = 0;
+		mutable uint64_t lastUsed = 0;
 
 		Entry(KeyRef const& beginKey, ExtStringRef const& endKey, VectorRef<KeyValueRef> const& values)
 		  : beginKey(beginKey), endKey(endKey), values(values) {}
@@ -170,6 +174,47 @@ private:
 	friend class ReadYourWritesTransaction;
 	Arena* arena;
 	IndexedSet<Entry, NoMetric> entries;
+	int64_t valueBytesLimit = 0;
+	int64_t valueBytes = 0; // of the entries holding valuesArena
+	uint64_t useClock = 0;
+
+	// Values read are normally kept alive by the cache's arena for as long as it lives. Once the cache is limited, each
+	// entry instead holds on to the arena its values came from, so that dropping the entry frees them.
+	void keepValues(IndexedSet<Entry, NoMetric>::iterator entry, Arena const& valuesArena) {
+		if (!valueBytesLimit) {
+			arena->dependsOn(valuesArena);
+			return;
+		}
+		entry->valuesArena = valuesArena;
+		entry->valueBytes = entry->values.expectedSize();
+		entry->lastUsed = ++useClock;
+		valueBytes += entry->valueBytes;
+		if (valueBytes > valueBytesLimit) {
+			compact(entry);
+		}
+	}
+
+	// Drops the least recently used entries holding values, other than keep, until the values left take up half of
+	// the limit, so that looking for what to drop is spread over many reads. Known-empty ranges cost next to nothing
+	// and are always kept.
+	void compact(IndexedSet<Entry, NoMetric>::iterator keep) {
+		std::vector<IndexedSet<Entry, NoMetric>::iterator> candidates;
+		for (auto i = entries.begin(); i != entries.end(); ++i) {
+			if (i->valueBytes > 0 && i != keep) {
+				candidates.push_back(i);
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(), [](auto const& a, auto const& b) {
+			return a->lastUsed < b->lastUsed;
+		});
+		for (auto& i : candidates) {
+			if (valueBytes <= valueBytesLimit / 2) {
+				break;
+			}
+			valueBytes -= i->valueBytes;
+			entries.erase(i);
+		}
+	}
 
 public:
 	struct iterator {
@@ -268,6 +313,9 @@ public:
 				offset = 0;
 				++it;
 			} else {
+				if (parent->valueBytesLimit) {
+					it->lastUsed = ++parent->useClock;
+				}
 				int idx = std::lower_bound(it->values.begin(), it->values.end(), key, KeyValueRef::OrderByKey()) -
 				          it->values.begin();
 				offset = idx * 2 + 1 + (idx < it->values.size() && it->values[idx].key == key);
@@ -311,13 +359,24 @@ public:
 		entries.insert(Entry(allKeys.end, afterAllKeys, VectorRef<KeyValueRef>()), NoMetric(), true);
 	}
 	// Visual Studio refuses to generate these, apparently despite the standard
-	SnapshotCache(SnapshotCache&& r) noexcept : arena(r.arena), entries(std::move(r.entries)) {}
+	SnapshotCache(SnapshotCache&& r) noexcept
+	  : arena(r.arena), entries(std::move(r.entries)), valueBytesLimit(r.valueBytesLimit), valueBytes(r.valueBytes),
+	    useClock(r.useClock) {}
 	SnapshotCache& operator=(SnapshotCache&& r) noexcept {
 		entries = std::move(r.entries);
 		arena = r.arena;
+		valueBytesLimit = r.valueBytesLimit;
+		valueBytes = r.valueBytes;
+		useClock = r.useClock;
 		return *this;
 	}
 
+	// Bounds the memory of the values cached to about limitBytes, by dropping the least recently used ranges of them,
+	// which then have to be read again. 0, the default, keeps everything read. Only values inserted afterwards count.
+	void setValueBytesLimit(int64_t limitBytes) { valueBytesLimit = limitBytes; }
+	bool isLimited() const { return valueBytesLimit > 0; }
+	int64_t getValueBytes() const { return valueBytes; }
+
 	bool empty() const {
 		// Returns true iff anything is known about the contents of the snapshot
 		for (auto i = entries.begin(); i != entries.end(); ++i)
@@ -342,11 +401,38 @@ public:
 		return false;
 	}
 
+	// As above, for a value whose memory is in valueArena
+	void insert(KeyRef key, Optional<ValueRef> value, Arena const& valueArena) {
+		iterator it(this);
+		it.skip(key);
+
+		if (it.is_unknown_range()) {
+			if (value.present())
+				keepValues(entries.insert(Entry(KeyValueRef(key, value.get()), *arena), NoMetric(), true), valueArena);
+			else
+				entries.insert(Entry(key, ExtStringRef(key, 1), VectorRef<KeyValueRef>()), NoMetric(), true);
+		}
+	}
+
 	bool insert(KeyRangeRef keys, VectorRef<KeyValueRef> values) {
 		// Asserts that, in the snapshot, the given ranges of keys contains (only) the given key/value pairs
 		// The returned iterator points to the first key in the range, or after the range if !values.size()
+		return insertRange(keys, values) != entries.end();
+	}
+
+	// As above, for values whose memory is in valuesArena
+	void insert(KeyRangeRef keys, VectorRef<KeyValueRef> values, Arena const& valuesArena) {
+		auto inserted = insertRange(keys, values);
+		if (inserted != entries.end()) {
+			keepValues(inserted, valuesArena);
+		}
+	}
+
+private:
+	// Returns the entry added for keys, or entries.end() if everything in keys was already known
+	IndexedSet<Entry, NoMetric>::iterator insertRange(KeyRangeRef keys, VectorRef<KeyValueRef> values) {
 		if (keys.empty())
-			return false;
+			return entries.end();
 
 		iterator itb(this);
 		itb.skip(keys.begin);
@@ -372,15 +458,19 @@ public:
 
 		if (begin < end) {
 			bool addBegin = begin != allKeys.begin && itb.it->beginKey == allKeys.begin;
+			for (auto i = itb.it; i != ite.it; ++i) {
+				valueBytes -= i->valueBytes;
+			}
 			entries.erase(itb.it, ite.it);
-			entries.insert(Entry(begin, end, values), NoMetric(), true);
+			auto inserted = entries.insert(Entry(begin, end, values), NoMetric(), true);
 			if (addBegin)
 				entries.insert(Entry(allKeys.begin, allKeys.begin, VectorRef<KeyValueRef>()), NoMetric(), true);
-			return true;
+			return inserted;
 		}
-		return false;
+		return entries.end();
 	}
 
+public:
 	void dump() {
 		for (auto it = entries.begin(); it != entries.end(); ++it) {
 			TraceEvent("CacheDump")
@@ -40,6 +40,7 @@
 #include "fdbclient/Tracing.h"
 #include "flow/UnitTest.h"
 #include "fdbclient/VersionVector.h"
+#include "flow/CompressionUtils.h"
 
 // Dead code, removed in the next protocol version
 struct VersionReply {
@@ -125,6 +126,13 @@ struct StorageServerInterface {
 	RequestStream<struct AuditStorageRequest> auditStorage;
 	RequestStream<struct GetHotShardsRequest> getHotShards;
 	RequestStream<struct GetStorageCheckSumRequest> getCheckSum;
+	// Reads several keys at one version. Throws wrong_shard_server if any of the keys is not readable on this server.
+	PublicRequestStream<struct GetValuesRequest> getValues;
+	// Fires on the first mutation to a range after a version. Throws wrong_shard_server unless the whole range is
+	// readable on this server.
+	PublicRequestStream<struct WatchRangeRequest> watchRange;
+	// The keys and ranges read or written the most on this server lately
+	RequestStream<struct GetHotKeysRequest> getHotKeys;
 
 private:
 	bool acceptingRequests;
@@ -204,6 +212,11 @@ public:
 				    RequestStream<struct GetHotShardsRequest>(getValue.getEndpoint().getAdjustedEndpoint(24));
 				getCheckSum =
 				    RequestStream<struct GetStorageCheckSumRequest>(getValue.getEndpoint().getAdjustedEndpoint(25));
+				getValues =
+				    PublicRequestStream<struct GetValuesRequest>(getValue.getEndpoint().getAdjustedEndpoint(26));
+				watchRange =
+				    PublicRequestStream<struct WatchRangeRequest>(getValue.getEndpoint().getAdjustedEndpoint(27));
+				getHotKeys = RequestStream<struct GetHotKeysRequest>(getValue.getEndpoint().getAdjustedEndpoint(28));
 			}
 		} else {
 			ASSERT(Ar::isDeserializing);
@@ -258,6 +271,9 @@ public:
 		streams.push_back(auditStorage.getReceiver());
 		streams.push_back(getHotShards.getReceiver());
 		streams.push_back(getCheckSum.getReceiver());
+		streams.push_back(getValues.getReceiver(TaskPriority::LoadBalancedEndpoint));
+		streams.push_back(watchRange.getReceiver());
+		streams.push_back(getHotKeys.getReceiver());
 		FlowTransport::transport().addEndpoints(streams);
 	}
 };
@@ -305,7 +321,13 @@ struct GetValueReply : public LoadBalancedReply {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, value, cached);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           value,
+		           cached,
+		           LoadBalancedReply::versionLag,
+		           LoadBalancedReply::busyness);
 	}
 };
 
@@ -341,6 +363,61 @@ struct GetValueRequest : TimedRequest {
 	}
 };
 
+struct GetValuesReply : public LoadBalancedReply {
+	constexpr static FileIdentifier file_identifier = 1378930;
+	Arena arena;
+	// values[i] is the value of the request's keys[i]
+	VectorRef<Optional<ValueRef>> values;
+	bool cached = false;
+
+	GetValuesReply() = default;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           values,
+		           cached,
+		           LoadBalancedReply::versionLag,
+		           LoadBalancedReply::busyness,
+		           arena);
+	}
+};
+
+struct GetValuesRequest : TimedRequest {
+	constexpr static FileIdentifier file_identifier = 8454531;
+	SpanContext spanContext;
+	TenantInfo tenantInfo;
+	Arena arena;
+	VectorRef<KeyRef> keys;
+	Version version;
+	Optional<TagSet> tags;
+	ReplyPromise<GetValuesReply> reply;
+	Optional<ReadOptions> options;
+	VersionVector ssLatestCommitVersions; // includes the latest commit versions, as known
+	                                      // to this client, of all storage replicas that
+	                                      // serve the given keys
+	GetValuesRequest() {}
+
+	bool verify() const { return tenantInfo.isAuthorized(); }
+
+	GetValuesRequest(SpanContext spanContext,
+	                 const TenantInfo& tenantInfo,
+	                 VectorRef<KeyRef> keys,
+	                 Version ver,
+	                 Optional<TagSet> tags,
+	                 Optional<ReadOptions> options,
+	                 VersionVector latestCommitVersions)
+	  : spanContext(spanContext), tenantInfo(tenantInfo), keys(arena, keys), version(ver), tags(tags),
+	    options(options), ssLatestCommitVersions(latestCommitVersions) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, keys, version, tags, reply, spanContext, tenantInfo, options, ssLatestCommitVersions, arena);
+	}
+};
+
 struct WatchValueReply {
 	constexpr static FileIdentifier file_identifier = 3;
 
@@ -386,19 +463,142 @@ struct WatchValueRequest {
 	}
 };
 
+struct WatchRangeReply {
+	constexpr static FileIdentifier file_identifier = 5530667;
+
+	// The version of a mutation to the range, or the storage server's version if the watch fired without one
+	Version version;
+	bool cached = false;
+	WatchRangeReply() = default;
+	explicit WatchRangeReply(Version version) : version(version) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, version, cached);
+	}
+};
+
+// Replies once a mutation to any key in range is applied at a version greater than version. The watch may also fire
+// without one, such as when the range moves off the storage server.
+struct WatchRangeRequest {
+	constexpr static FileIdentifier file_identifier = 9165288;
+	SpanContext spanContext;
+	TenantInfo tenantInfo;
+	KeyRange range;
+	Version version;
+	Optional<TagSet> tags;
+	Optional<UID> debugID;
+	ReplyPromise<WatchRangeReply> reply;
+
+	WatchRangeRequest() {}
+
+	WatchRangeRequest(SpanContext spanContext,
+	                  TenantInfo tenantInfo,
+	                  const KeyRange& range,
+	                  Version ver,
+	                  Optional<TagSet> tags,
+	                  Optional<UID> debugID)
+	  : spanContext(spanContext), tenantInfo(tenantInfo), range(range), version(ver), tags(tags), debugID(debugID) {}
+
+	bool verify() const { return tenantInfo.isAuthorized(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, range, version, tags, debugID, reply, spanContext, tenantInfo);
+	}
+};
+
+// A condition on the rows of a range read. The storage server evaluates it and returns only the rows that meet it,
+// and the read's row and byte limits count those rows alone.
+struct KeyValueFilterRef {
+	constexpr static FileIdentifier file_identifier = 2246180;
+	enum Comparison : uint8_t { EQUAL, NOT_EQUAL, LESS, LESS_OR_EQUAL, GREATER, GREATER_OR_EQUAL, STARTS_WITH };
+
+	// When tupleElement >= 0, the key after its first tupleBegin bytes must be a tuple with that element, which must
+	// compare with operand, a packed one element tuple, as comparison says. Elements compare in tuple order, and
+	// STARTS_WITH needs a string or bytes operand.
+	int tupleBegin = 0;
+	int tupleElement = -1;
+	uint8_t comparison = EQUAL;
+	StringRef operand;
+	int minValueLength = 0;
+	int maxValueLength = std::numeric_limits<int>::max();
+
+	KeyValueFilterRef() {}
+	KeyValueFilterRef(Arena& a, const KeyValueFilterRef& copyFrom)
+	  : tupleBegin(copyFrom.tupleBegin), tupleElement(copyFrom.tupleElement), comparison(copyFrom.comparison),
+	    operand(a, copyFrom.operand), minValueLength(copyFrom.minValueLength),
+	    maxValueLength(copyFrom.maxValueLength) {}
+
+	bool matches(KeyValueRef const& kv) const;
+
+	int expectedSize() const { return operand.expectedSize(); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, tupleBegin, tupleElement, comparison, operand, minValueLength, maxValueLength);
+	}
+};
+using KeyValueFilter = Standalone<KeyValueFilterRef>;
+
+// Totals over the rows of a range. Values are read as little-endian integers the way the ADD atomic op reads them:
+// shorter values are zero extended, only the low 8 bytes of longer ones count, and sum wraps around.
+struct RangeAggregate {
+	constexpr static FileIdentifier file_identifier = 2246181;
+	int64_t count = 0;
+	int64_t bytes = 0; // Of keys and values
+	int64_t sum = 0;
+	Optional<int64_t> min, max;
+
+	void add(KeyValueRef const& kv);
+	void merge(RangeAggregate const& other);
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, count, bytes, sum, min, max);
+	}
+};
+
 struct GetKeyValuesReply : public LoadBalancedReply {
 	constexpr static FileIdentifier file_identifier = 1783066;
 	Arena arena;
+	// When received, only the KeyValueRef array is built: keys and values point into the packet, which arena holds
 	VectorRef<KeyValueRef, VecSerStrategy::String> data;
 	Version version; // useful when latestVersion was requested
 	bool more;
 	bool cached = false;
+	// When not NONE, data is empty and compressedData holds it, serialized and compressed with this filter
+	CompressionFilter compressionFilter = CompressionFilter::NONE;
+	StringRef compressedData;
+	// For a filtered or aggregate read with more, the last key read. It may be past the last row returned, so reads
+	// continue after it, or before it when reading in reverse.
+	Optional<KeyRef> readThrough;
+	// For an aggregate read, the totals over the rows read, which are not returned
+	Optional<RangeAggregate> aggregate;
 
 	GetKeyValuesReply() : version(invalidVersion), more(false), cached(false) {}
 
+	// Replaces data with its compressed form, unless compressing it does not make it smaller
+	void compress(CompressionFilter filter);
+	// Restores data from its compressed form, if it has one
+	void decompress();
+
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, data, version, more, cached, arena);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           data,
+		           version,
+		           more,
+		           cached,
+		           LoadBalancedReply::versionLag,
+		           LoadBalancedReply::busyness,
+		           compressionFilter,
+		           compressedData,
+		           readThrough,
+		           aggregate,
+		           arena);
 	}
 };
 
@@ -419,6 +619,16 @@ struct GetKeyValuesRequest : TimedRequest {
 	VersionVector ssLatestCommitVersions; // includes the latest commit versions, as known
 	                                      // to this client, of all storage replicas that
 	                                      // serve the given key
+	// The compression the client would like a large reply in. Storage servers that predate it, or that do not support
+	// the filter, reply uncompressed.
+	CompressionFilter compressionFilter = CompressionFilter::NONE;
+	// Only the rows meeting filter are returned. Storage servers that predate it return every row, so the client
+	// checks the rows again.
+	Optional<KeyValueFilterRef> filter;
+	// Reply with the aggregate of the rows rather than the rows themselves. limit and limitBytes don't apply, other
+	// than limit's sign giving the direction. Storage servers that predate it return the rows, which the client adds
+	// up.
+	bool aggregate = false;
 
 	GetKeyValuesRequest() {}
 
@@ -438,6 +648,9 @@ struct GetKeyValuesRequest : TimedRequest {
 		           tenantInfo,
 		           options,
 		           ssLatestCommitVersions,
+		           compressionFilter,
+		           filter,
+		           aggregate,
 		           arena);
 	}
 };
@@ -456,7 +669,16 @@ struct GetMappedKeyValuesReply : public LoadBalancedReply {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, data, version, more, cached, arena);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           data,
+		           version,
+		           more,
+		           cached,
+		           LoadBalancedReply::versionLag,
+		           LoadBalancedReply::busyness,
+		           arena);
 	}
 };
 
@@ -573,7 +795,13 @@ struct GetKeyReply : public LoadBalancedReply {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, LoadBalancedReply::penalty, LoadBalancedReply::error, sel, cached);
+		serializer(ar,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           sel,
+		           cached,
+		           LoadBalancedReply::versionLag,
+		           LoadBalancedReply::busyness);
 	}
 };
 
@@ -1166,12 +1394,23 @@ struct GetStorageMetricsReply {
 	int64_t versionLag = 0;
 	double lastUpdate = 0;
 	int64_t bytesDurable = 0, bytesInput = 0;
+	// Whether the storage engine should be replaced to pick up new settings, see IKeyValueStore::isWrongConfigured()
+	bool storageEngineWrongConfigured = false;
 
 	GetStorageMetricsReply() = default;
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, load, available, capacity, bytesInputRate, versionLag, lastUpdate, bytesDurable, bytesInput);
+		serializer(ar,
+		           load,
+		           available,
+		           capacity,
+		           bytesInputRate,
+		           versionLag,
+		           lastUpdate,
+		           bytesDurable,
+		           bytesInput,
+		           storageEngineWrongConfigured);
 	}
 };
 
@@ -1271,15 +1510,60 @@ struct GetHotShardsRequest {
 	}
 };
 
+// A key, or range if end is present, that was read or written often on a storage server. count overstates the
+// operations on it by at most error.
+struct HotKeyMetrics {
+	constexpr static FileIdentifier file_identifier = 7241603;
+	Key begin;
+	Optional<Key> end;
+	bool write = false;
+	int64_t tenantId = TenantInfo::INVALID_TENANT;
+	int64_t count = 0;
+	int64_t error = 0;
+	double opsPerSecond = 0;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, begin, end, write, tenantId, count, error, opsPerSecond);
+	}
+};
+
+struct GetHotKeysReply {
+	constexpr static FileIdentifier file_identifier = 7241604;
+	std::vector<HotKeyMetrics> hotKeys; // the hottest reads, then the hottest writes, each hottest first
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, hotKeys);
+	}
+};
+
+struct GetHotKeysRequest {
+	constexpr static FileIdentifier file_identifier = 7241605;
+	int limit; // of reads and of writes
+	ReplyPromise<GetHotKeysReply> reply;
+
+	GetHotKeysRequest() : limit(0) {}
+	explicit GetHotKeysRequest(int limit) : limit(limit) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, limit, reply);
+	}
+};
+
 enum class CheckSumMethod : uint8_t {
 	Invalid = 0,
+	// XXH3 64 bit hash of each key and value in key order, each seeded with the hash before it
+	XXH3 = 1,
 };
 
 struct CheckSumMetaData {
 	constexpr static FileIdentifier file_identifier = 3828142;
-	KeyRange range;
+	KeyRange range; // the part of the requested range the checksum covers, which is all of it unless limitBytes was hit
 	Version version;
 	StringRef checkSumValue;
+	int64_t bytes = 0; // key and value bytes covered
 
 	CheckSumMetaData() {}
 	CheckSumMetaData(KeyRange range, Version version, StringRef checkSumValue)
@@ -1287,12 +1571,13 @@ struct CheckSumMetaData {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, range, version, checkSumValue);
+		serializer(ar, range, version, checkSumValue, bytes);
 	}
 };
 
-struct GetStorageCheckSumReply {
+struct GetStorageCheckSumReply : public LoadBalancedReply {
 	constexpr static FileIdentifier file_identifier = 3828143;
+	Arena arena;
 	std::vector<CheckSumMetaData> checkSums;
 	uint8_t checkSumMethod;
 
@@ -1302,16 +1587,27 @@ struct GetStorageCheckSumReply {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, checkSums, checkSumMethod);
+		serializer(ar,
+		           checkSums,
+		           checkSumMethod,
+		           LoadBalancedReply::penalty,
+		           LoadBalancedReply::error,
+		           LoadBalancedReply::versionLag,
+		           LoadBalancedReply::busyness,
+		           arena);
 	}
 };
 
+// Checksums the data of each range at its version, or the latest one. Replicas with the same data stop at the same
+// key when limitBytes is hit, so their checksums can be compared without reading the data itself.
 struct GetStorageCheckSumRequest {
 	constexpr static FileIdentifier file_identifier = 3828144;
 	std::vector<std::pair<KeyRange, Optional<Version>>> ranges;
 	Optional<UID> actionId;
 	uint8_t checkSumMethod;
 	ReplyPromise<GetStorageCheckSumReply> reply;
+	Optional<ReadOptions> options;
+	int limitBytes = 0; // most key and value bytes checksummed per range, unlimited if 0
 
 	GetStorageCheckSumRequest() {}
 	GetStorageCheckSumRequest(const std::vector<std::pair<KeyRange, Optional<Version>>>& ranges,
@@ -1321,7 +1617,7 @@ struct GetStorageCheckSumRequest {
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, ranges, actionId, checkSumMethod, reply);
+		serializer(ar, ranges, actionId, checkSumMethod, reply, options, limitBytes);
 	}
 };
 
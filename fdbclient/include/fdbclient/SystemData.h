@@ -848,6 +848,17 @@ extern const Key blobManifestVersionKey;
 extern const KeyRangeRef idempotencyIdKeys;
 extern const KeyRef idempotencyIdsExpiredVersion;
 
+// "\xff\x02/pinnedReadVersions/[[PinID]]" := "[[Version]][[ExpireVersion]]"
+// Read versions that storage servers keep readable past the MVCC window, until their expire version
+extern const KeyRangeRef pinnedReadVersionKeys;
+// Changed along with pinnedReadVersionKeys, so that storage servers can watch one key for new and removed pins
+extern const KeyRef pinnedReadVersionsChangeKey;
+
+const Key pinnedReadVersionKeyFor(UID id);
+UID decodePinnedReadVersionKey(KeyRef const& key);
+const Value pinnedReadVersionValue(Version version, Version expireVersion);
+std::pair<Version, Version> decodePinnedReadVersionValue(ValueRef const& value);
+
 #pragma clang diagnostic pop
 
 #endif
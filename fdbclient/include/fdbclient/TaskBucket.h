@@ -195,6 +195,13 @@ public:
 		return runRYWTransaction(cx, [=](Reference<ReadYourWritesTransaction> tr) { return getOne(tr); });
 	}
 
+	// Claims up to maxTasks tasks in one transaction, fewer (possibly none) if the bucket runs short.
+	Future<std::vector<Reference<Task>>> getMany(Reference<ReadYourWritesTransaction> tr, int maxTasks);
+	Future<std::vector<Reference<Task>>> getMany(Database cx, int maxTasks) {
+		return runRYWTransaction(cx,
+		                         [=](Reference<ReadYourWritesTransaction> tr) { return getMany(tr, maxTasks); });
+	}
+
 	Future<bool> doTask(Database cx, Reference<FutureBucket> futureBucket, Reference<Task> task);
 
 	Future<bool> doOne(Database cx, Reference<FutureBucket> futureBucket);
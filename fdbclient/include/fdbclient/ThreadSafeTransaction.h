@@ -78,6 +78,12 @@ public:
 	// Return a JSON string containing database client-side status information
 	ThreadFuture<Standalone<StringRef>> getClientStatus() override;
 
+	// Return a JSON string containing database client-side counters and latency histograms
+	ThreadFuture<Standalone<StringRef>> getMetrics() override;
+
+	// Return a JSON string containing the profiles of the most recent transaction attempts
+	ThreadFuture<Standalone<StringRef>> getTransactionProfiles() override;
+
 private:
 	friend class ThreadSafeTenant;
 	friend class ThreadSafeTransaction;
@@ -120,6 +126,27 @@ private:
 	Tenant* tenant;
 };
 
+// An implementation of IRangeStream that reads the stream of an ISingleThreadTransaction on the network thread
+class ThreadSafeRangeStream : public IRangeStream, ThreadSafeReferenceCounted<ThreadSafeRangeStream>, NonCopyable {
+public:
+	ThreadSafeRangeStream(ISingleThreadTransaction* tr, KeySelector begin, KeySelector end, bool snapshot);
+	~ThreadSafeRangeStream() override;
+
+	ThreadFuture<RangeResult> next() override;
+
+	void addref() override { ThreadSafeReferenceCounted<ThreadSafeRangeStream>::addref(); }
+	void delref() override { ThreadSafeReferenceCounted<ThreadSafeRangeStream>::delref(); }
+
+private:
+	// Only accessed on the network thread
+	struct State {
+		Reference<ISingleThreadTransaction> tr;
+		PromiseStream<RangeResult> results;
+		Future<Void> reader;
+	};
+	State* state;
+};
+
 // An implementation of ITransaction that serializes operations onto the network thread and interacts with the
 // lower-level client APIs exposed by ISingleThreadTransaction
 class ThreadSafeTransaction : public ITransaction, ThreadSafeReferenceCounted<ThreadSafeTransaction>, NonCopyable {
@@ -138,6 +165,8 @@ public:
 	ThreadFuture<Version> getReadVersion() override;
 
 	ThreadFuture<Optional<Value>> get(const KeyRef& key, bool snapshot = false) override;
+	ThreadFuture<RangeResult> getMulti(const VectorRef<KeyRef>& keys, bool snapshot = false) override;
+	ThreadFuture<RangeResult> batch(const VectorRef<BatchOperationRef>& operations, bool snapshot = false) override;
 	ThreadFuture<Key> getKey(const KeySelectorRef& key, bool snapshot = false) override;
 	ThreadFuture<RangeResult> getRange(const KeySelectorRef& begin,
 	                                   const KeySelectorRef& end,
@@ -167,6 +196,9 @@ public:
 	                                               GetRangeLimits limits,
 	                                               bool snapshot,
 	                                               bool reverse) override;
+	Reference<IRangeStream> getRangeStream(const KeySelectorRef& begin,
+	                                       const KeySelectorRef& end,
+	                                       bool snapshot = false) override;
 	ThreadFuture<Standalone<VectorRef<const char*>>> getAddressesForKey(const KeyRef& key) override;
 	ThreadFuture<Standalone<StringRef>> getVersionstamp() override;
 	ThreadFuture<int64_t> getEstimatedRangeSizeBytes(const KeyRangeRef& keys) override;
@@ -207,6 +239,7 @@ public:
 	void clear(const KeyRef& key) override;
 
 	ThreadFuture<Void> watch(const KeyRef& key) override;
+	ThreadFuture<Void> watchRange(const KeyRangeRef& range) override;
 
 	void addWriteConflictRange(const KeyRangeRef& keys) override;
 
@@ -23,8 +23,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/container/flat_map.hpp>
 #include <set>
+#include <vector>
 
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/Knobs.h"
@@ -46,11 +48,34 @@ struct VersionVector {
 	VersionVector(Version version) : maxVersion(version), cachedEncodedSize(InvalidEncodedSize) {}
 
 private:
-	// Only invoked by getDelta() and applyDelta(), where tag has been validated
-	// and version is guaranteed to be larger than the existing value.
+	// Only invoked when deserializing, where tag has been validated and version
+	// is guaranteed to be larger than the existing value.
 	inline void setVersionNoCheck(const Tag& tag, Version version) {
 		versions[tag] = version;
 		invalidateCachedEncodedSize();
+		updatesTracked = false;
+	}
+
+	// Records that tag was set to version, which is at least as large as every
+	// version recorded before, so that getDelta() only has to look at the entries
+	// that changed since its reference version.
+	inline void trackUpdate(const Tag& tag, Version version) {
+		if (updatesTracked) {
+			updates.emplace_back(version, tag);
+		}
+	}
+
+	// Drops the updates that have since been overwritten once they outnumber the
+	// entries, so that updates never holds more than about twice the entries.
+	void compactUpdates() {
+		if (updates.size() <= 2 * versions.size() + 16) {
+			return;
+		}
+		auto isCurrent = [this](const std::pair<Version, Tag>& update) {
+			auto iter = versions.find(update.second);
+			return iter != versions.end() && iter->second == update.first;
+		};
+		updates.erase(std::stable_partition(updates.begin(), updates.end(), isCurrent), updates.end());
 	}
 
 	inline void invalidateCachedEncodedSize() { cachedEncodedSize = InvalidEncodedSize; }
@@ -62,6 +87,13 @@ private:
 	// vector size is not cached.
 	size_t cachedEncodedSize;
 
+	// <version, tag> in the order the versions were set, possibly including
+	// versions that have been overwritten since.
+	std::vector<std::pair<Version, Tag>> updates;
+	// Whether updates covers every entry, which it does unless the entries were
+	// deserialized rather than set.
+	bool updatesTracked = true;
+
 public:
 	Version getMaxVersion() const { return maxVersion; }
 
@@ -76,6 +108,8 @@ public:
 		ASSERT(tag.locality > tagLocalityInvalid);
 		ASSERT(version > maxVersion);
 		versions[tag] = version;
+		trackUpdate(tag, version);
+		compactUpdates();
 		maxVersion = version;
 		invalidateCachedEncodedSize();
 	}
@@ -87,8 +121,10 @@ public:
 			ASSERT(tag.locality > tagLocalityInvalid);
 			if (localityFilter == tagLocalityInvalid || tag.locality == localityFilter) {
 				versions[tag] = version;
+				trackUpdate(tag, version);
 			}
 		}
+		compactUpdates();
 		maxVersion = version;
 		invalidateCachedEncodedSize();
 	}
@@ -108,6 +144,8 @@ public:
 
 	void clear() {
 		versions.clear();
+		updates.clear();
+		updatesTracked = true;
 		maxVersion = invalidVersion;
 		invalidateCachedEncodedSize();
 	}
@@ -127,11 +165,27 @@ public:
 		if (CLIENT_KNOBS->SEND_ENTIRE_VERSION_VECTOR) {
 			delta = *this;
 		} else {
-			for (const auto& [tag, version] : versions) {
-				if (version > refVersion) {
-					delta.setVersionNoCheck(tag, version);
+			// The entries newer than refVersion are gathered in tag order and
+			// inserted at once, rather than one by one into the sorted map.
+			std::vector<std::pair<Tag, Version>> changed;
+			if (updatesTracked) {
+				for (auto iter = updates.rbegin(); iter != updates.rend() && iter->first > refVersion; ++iter) {
+					auto current = versions.find(iter->second);
+					if (current != versions.end() && current->second == iter->first) {
+						changed.emplace_back(iter->second, iter->first);
+					}
+				}
+				std::sort(changed.begin(), changed.end());
+			} else {
+				for (const auto& [tag, version] : versions) {
+					if (version > refVersion) {
+						changed.emplace_back(tag, version);
+					}
 				}
 			}
+			delta.versions.insert(boost::container::ordered_unique_range, changed.begin(), changed.end());
+			delta.invalidateCachedEncodedSize();
+			delta.updatesTracked = false;
 			delta.maxVersion = maxVersion;
 		}
 	}
@@ -151,11 +205,18 @@ public:
 		if (CLIENT_KNOBS->SEND_ENTIRE_VERSION_VECTOR) {
 			*this = delta;
 		} else {
+			size_t tracked = updates.size();
 			for (const auto& [tag, version] : delta.versions) {
 				if (version > maxVersion) {
-					setVersionNoCheck(tag, version);
+					versions[tag] = version;
+					trackUpdate(tag, version);
 				}
 			}
+			// Every applied version is above the old maxVersion, so sorting them
+			// keeps updates in version order.
+			std::sort(updates.begin() + tracked, updates.end());
+			compactUpdates();
+			invalidateCachedEncodedSize();
 			maxVersion = delta.maxVersion;
 		}
 	}
@@ -424,6 +485,7 @@ public:
 
 		size_t pairCount; // number of serialized <tag id, commit version> pairs
 		deserialize<size_t>(data, pairCount);
+		versions.reserve(versions.size() + pairCount);
 
 		T tagId;
 		V versionDelta;
@@ -505,8 +567,8 @@ struct dynamic_size_traits<VersionVector> : std::true_type {
 		size_t encodedSize;
 		if (vv.isEncodedSizeCached()) {
 			encodedSize = vv.getCachedEncodedSize();
-			// @todo remove this assert before doing performance tests
-			ASSERT(encodedSize == vv.getEncodedSize());
+			// Recomputing the size walks every entry again, so it is only checked in simulation
+			ASSERT(!g_network->isSimulated() || encodedSize == vv.getEncodedSize());
 		} else {
 			encodedSize = vv.getEncodedSize();
 			const_cast<VersionVector&>(vv).setCachedEncodedSize(encodedSize);
@@ -532,8 +594,7 @@ struct dynamic_size_traits<VersionVector> : std::true_type {
 		// Serialize vv::maxVersion.
 		vv.serialize<Version>(out, (vv.getMaxVersion()));
 
-		// @todo remove this assert before doing performance tests
-		ASSERT(out - begin == vv.getEncodedSize());
+		ASSERT(!g_network->isSimulated() || out - begin == vv.getEncodedSize());
 	}
 
 	template <class Context>
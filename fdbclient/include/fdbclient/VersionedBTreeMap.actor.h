@@ -0,0 +1,65 @@
+/*
+ * VersionedBTreeMap.actor.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#if defined(NO_INTELLISENSE) && !defined(FDBCLIENT_VERSIONEDBTREEMAP_ACTOR_G_H)
+#define FDBCLIENT_VERSIONEDBTREEMAP_ACTOR_G_H
+#include "fdbclient/VersionedBTreeMap.actor.g.h"
+#elif !defined(FDBCLIENT_VERSIONEDBTREEMAP_ACTOR_H)
+#define FDBCLIENT_VERSIONEDBTREEMAP_ACTOR_H
+
+#include "flow/flow.h"
+#include "fdbclient/VersionedMap.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Frees the nodes of trees which are no longer referenced by any version, a few at a time. With a reclaimThread, the
+// nodes are only detached from the nodes still in use here, and destroyed on that thread.
+ACTOR template <class Tree>
+Future<Void> deferredBTreeCleanupActor(std::vector<Tree> toFree,
+                                       TaskPriority taskID = TaskPriority::DefaultYield,
+                                       Reference<IThreadPool> reclaimThread = Reference<IThreadPool>()) {
+	state int freeCount = 0;
+	state std::vector<Tree> detached;
+	while (!toFree.empty()) {
+		Tree a = std::move(toFree.back());
+		toFree.pop_back();
+		a->releaseChildren(toFree);
+
+		if (reclaimThread) {
+			detached.push_back(std::move(a));
+			if (detached.size() >= VERSIONED_MAP_RECLAIM_BATCH) {
+				reclaimThread->post(new ReclaimTreeNodesAction<Tree>(std::move(detached)));
+				detached.clear();
+			}
+		}
+
+		if (++freeCount % 100 == 0)
+			wait(yield(taskID));
+	}
+
+	if (!detached.empty()) {
+		reclaimThread->post(new ReclaimTreeNodesAction<Tree>(std::move(detached)));
+	}
+	return Void();
+}
+
+#include "flow/unactorcompiler.h"
+#endif
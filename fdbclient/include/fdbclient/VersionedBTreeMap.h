@@ -0,0 +1,725 @@
+/*
+ * VersionedBTreeMap.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBCLIENT_VERSIONEDBTREEMAP_H
+#define FDBCLIENT_VERSIONEDBTREEMAP_H
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "flow/flow.h"
+#include "flow/IndexedSet.h"
+#include "fdbclient/FDBTypes.h"
+#include "fdbclient/VersionedMap.h"
+#include "fdbclient/VersionedBTreeMap.actor.h"
+
+// VersionedBTreeMap has the same interface and semantics as VersionedMap, but each version is a copy-on-write B+-tree
+// with wide nodes instead of a treap of separately allocated nodes, so finding or scanning keys touches a few arrays
+// instead of chasing a pointer per key.
+//
+// Nodes are immutable once a newer version has been created. The first change to a node in the latest version
+// replaces it and its ancestors with copies, and later changes in the same version update those copies in place.
+// Nodes are not rebalanced on erase, but a node left small by an erase is merged with a neighbor when they fit in
+// one node.
+template <class K, class T>
+class VersionedBTreeMap : NonCopyable {
+public:
+	static constexpr int LeafCapacity = 16;
+	static constexpr int InternalCapacity = 32;
+	static constexpr int MaxHeight = 24;
+
+	typedef MapPair<K, std::pair<T, Version>> Item;
+
+	struct Node;
+	struct Leaf;
+	struct Internal;
+	typedef Reference<Node> Tree;
+
+	struct Node : NonCopyable {
+		Node(bool leaf, Version version) : version(version), leaf(leaf) {}
+
+		void addref() { ++referenceCount; }
+		void delref() {
+			if (--referenceCount == 0) {
+				if (leaf) {
+					delete static_cast<Leaf*>(this);
+				} else {
+					delete static_cast<Internal*>(this);
+				}
+			}
+		}
+		bool isSoleOwner() const { return referenceCount == 1; }
+
+		// Moves the children only referenced by this node to toFree, so they can be freed incrementally, and drops the
+		// references to the rest
+		void releaseChildren(std::vector<Tree>& toFree) {
+			if (!leaf) {
+				Internal* n = static_cast<Internal*>(this);
+				for (int i = 0; i < count; ++i) {
+					if (n->children[i]->isSoleOwner()) {
+						toFree.push_back(std::move(n->children[i]));
+					} else {
+						n->children[i].clear();
+					}
+				}
+			}
+		}
+
+		// The version the node was created in
+		Version version;
+		int referenceCount = 1;
+		int count = 0;
+		bool leaf;
+	};
+
+	struct Leaf : Node, FastAllocated<Leaf> {
+		explicit Leaf(Version version) : Node(true, version) {}
+		Leaf(const Leaf& from, Version version) : Node(true, version) {
+			std::uninitialized_copy_n(from.items(), from.count, items());
+			this->count = from.count;
+		}
+		~Leaf() { std::destroy_n(items(), this->count); }
+
+		Item* items() { return reinterpret_cast<Item*>(storage); }
+		const Item* items() const { return reinterpret_cast<const Item*>(storage); }
+
+		// Index of the first item whose key is not less than key, or greater than key if upper
+		template <class X>
+		int search(const X& key, bool upper) const {
+			const Item* begin = items();
+			return std::partition_point(begin,
+			                            begin + this->count,
+			                            [&](const Item& i) { return upper ? !(key < i.key) : i.key < key; }) -
+			       begin;
+		}
+
+		void insert(int i, const Item& item) {
+			Item* begin = items();
+			if (i == this->count) {
+				new (begin + i) Item(item);
+			} else {
+				new (begin + this->count) Item(std::move(begin[this->count - 1]));
+				std::move_backward(begin + i, begin + this->count - 1, begin + this->count);
+				begin[i] = item;
+			}
+			++this->count;
+		}
+
+		void remove(int first, int last) {
+			Item* begin = items();
+			std::move(begin + last, begin + this->count, begin + first);
+			std::destroy_n(begin + this->count - (last - first), last - first);
+			this->count -= last - first;
+		}
+
+		// Moves the items from first on to the end of to
+		void moveTo(Leaf* to, int first) {
+			std::uninitialized_move_n(items() + first, this->count - first, to->items() + to->count);
+			to->count += this->count - first;
+			std::destroy_n(items() + first, this->count - first);
+			this->count = first;
+		}
+
+		alignas(Item) uint8_t storage[sizeof(Item) * LeafCapacity];
+	};
+
+	struct Internal : Node, FastAllocated<Internal> {
+		explicit Internal(Version version) : Node(false, version) {}
+		Internal(const Internal& from, Version version) : Node(false, version) {
+			std::copy_n(from.keys, from.count, keys);
+			std::copy_n(from.children, from.count, children);
+			this->count = from.count;
+		}
+
+		// Index of the child which would contain key
+		template <class X>
+		int search(const X& key) const {
+			return std::partition_point(keys + 1, keys + this->count, [&](const K& k) { return !(key < k); }) - keys -
+			       1;
+		}
+
+		// Index of the last child which could contain a key less than key
+		template <class X>
+		int searchBefore(const X& key) const {
+			return std::max<int>(
+			    0, std::partition_point(keys + 1, keys + this->count, [&](const K& k) { return k < key; }) - keys - 1);
+		}
+
+		void insert(int i, const K& key, Tree child) {
+			std::move_backward(keys + i, keys + this->count, keys + this->count + 1);
+			std::move_backward(children + i, children + this->count, children + this->count + 1);
+			keys[i] = key;
+			children[i] = std::move(child);
+			++this->count;
+		}
+
+		void remove(int first, int last) {
+			std::move(keys + last, keys + this->count, keys + first);
+			std::move(children + last, children + this->count, children + first);
+			for (int i = this->count - (last - first); i < this->count; ++i) {
+				children[i].clear();
+			}
+			this->count -= last - first;
+		}
+
+		// For i > 0, keys[i] is no greater than any key in children[i] and greater than any key in children[i - 1].
+		// keys[0] is only meaningful in a node created by a split, where it is the key the node was split at.
+		K keys[InternalCapacity];
+		Tree children[InternalCapacity];
+	};
+
+	// A change normally copies the leaf holding the item, and the other items changed in the same version share it
+	static const int overheadPerItem = sizeof(Item) + nextFastAllocatedSize(sizeof(Leaf)) / 4;
+
+	Version oldestVersion, latestVersion;
+
+	// Roots of the tree at each version, sorted by version as in VersionedMap
+	std::deque<std::pair<Version, Tree>> roots;
+
+	struct rootsComparator {
+		bool operator()(const std::pair<Version, Tree>& value, const Version& key) { return (value.first < key); }
+		bool operator()(const Version& key, const std::pair<Version, Tree>& value) { return (key < value.first); }
+	};
+
+	Tree const& getRoot(Version v) const {
+		auto r = upper_bound(roots.begin(), roots.end(), v, rootsComparator());
+		--r;
+		return r->second;
+	}
+
+	struct iterator;
+
+	VersionedBTreeMap() : oldestVersion(0), latestVersion(0) { roots.emplace_back(0, Tree()); }
+	VersionedBTreeMap(VersionedBTreeMap&& v) noexcept
+	  : oldestVersion(v.oldestVersion), latestVersion(v.latestVersion), roots(std::move(v.roots)) {}
+	void operator=(VersionedBTreeMap&& v) noexcept {
+		oldestVersion = v.oldestVersion;
+		latestVersion = v.latestVersion;
+		roots = std::move(v.roots);
+	}
+
+	Version getLatestVersion() const { return latestVersion; }
+	Version getOldestVersion() const { return oldestVersion; }
+
+	// front element should be the oldest version in the deque, hence the next oldest should be at index 1
+	Version getNextOldestVersion() const { return roots[1].first; }
+
+	void forgetVersionsBefore(Version newOldestVersion) {
+		ASSERT(newOldestVersion <= latestVersion);
+		auto r = upper_bound(roots.begin(), roots.end(), newOldestVersion, rootsComparator());
+		auto upper = r;
+		--r;
+		// if the specified newOldestVersion does not exist, insert a new
+		// entry-pair with newOldestVersion and the root from next lower version
+		if (r->first != newOldestVersion) {
+			r = roots.emplace(upper, newOldestVersion, getRoot(newOldestVersion));
+		}
+
+		UNSTOPPABLE_ASSERT(r->first == newOldestVersion);
+		roots.erase(roots.begin(), r);
+		oldestVersion = newOldestVersion;
+	}
+
+	Future<Void> forgetVersionsBeforeAsync(Version newOldestVersion, TaskPriority taskID = TaskPriority::DefaultYield) {
+		return forgetAndFreeVersionsBefore(newOldestVersion, taskID, Reference<IThreadPool>());
+	}
+
+	// As above, but if reclaimThread is set the forgotten nodes are destroyed on it. Its threads must be
+	// VersionedMapReclaimers.
+	Future<Void> forgetVersionsBeforeAsync(Version newOldestVersion,
+	                                       TaskPriority taskID,
+	                                       Reference<IThreadPool> reclaimThread) {
+		static_assert(std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<T>,
+		              "Items destroyed on another thread must not own shared memory");
+		return forgetAndFreeVersionsBefore(newOldestVersion, taskID, reclaimThread);
+	}
+
+private:
+	Future<Void> forgetAndFreeVersionsBefore(Version newOldestVersion,
+	                                         TaskPriority taskID,
+	                                         Reference<IThreadPool> reclaimThread) {
+		ASSERT_LE(newOldestVersion, latestVersion);
+		auto r = upper_bound(roots.begin(), roots.end(), newOldestVersion, rootsComparator());
+		auto upper = r;
+		--r;
+		if (r->first != newOldestVersion) {
+			r = roots.emplace(upper, newOldestVersion, getRoot(newOldestVersion));
+		}
+
+		UNSTOPPABLE_ASSERT(r->first == newOldestVersion);
+
+		std::vector<Tree> toFree;
+		auto newBegin = r;
+		for (auto root = roots.begin(); root != newBegin; ++root) {
+			if (root->second) {
+				toFree.push_back(std::move(root->second));
+			}
+		}
+
+		roots.erase(roots.begin(), newBegin);
+		oldestVersion = newOldestVersion;
+
+		// Roots still shared with newer versions are dropped here, the rest are freed incrementally
+		toFree.erase(std::remove_if(toFree.begin(), toFree.end(), [](Tree& t) { return !t->isSoleOwner(); }),
+		             toFree.end());
+		return deferredBTreeCleanupActor(toFree, taskID, reclaimThread);
+	}
+
+public:
+
+	// following sets and erases are into the given version, which may now be passed to at(). Must be called in
+	// monotonically increasing order.
+	void createNewVersion(Version version) {
+		if (version > latestVersion) {
+			latestVersion = version;
+			Tree r = getRoot(version);
+			roots.emplace_back(version, r);
+		} else
+			ASSERT(version == latestVersion);
+	}
+
+	// insert() and erase() invalidate atLatest() and all iterators into it
+	void insert(const K& k, const T& t) { insert(k, t, latestVersion); }
+	void insert(const K& k, const T& t, Version insertAt) {
+		Item item(k, std::make_pair(t, insertAt));
+		Tree& root = roots.back().second;
+		if (!root) {
+			root = Tree(new Leaf(latestVersion));
+		}
+		Optional<std::pair<K, Tree>> split = insertInto(root, item);
+		if (split.present()) {
+			Internal* newRoot = new Internal(latestVersion);
+			newRoot->children[0] = std::move(root);
+			newRoot->keys[1] = split.get().first;
+			newRoot->children[1] = std::move(split.get().second);
+			newRoot->count = 2;
+			root = Tree(newRoot);
+		}
+	}
+	void erase(const K& begin, const K& end) { erase(begin, end, false); }
+	void erase(const K& key) { // key must be present
+		erase(key, key, true);
+	}
+	void erase(iterator const& item) { // iterator must be in latest version!
+		ASSERT_EQ(item.at, latestVersion);
+		K key = item.key();
+		erase(key, key, true);
+	}
+
+	void printDetail() { printTree(latestVersion); }
+
+	void printTree(Version at) { printNode(getRoot(at).getPtr(), 0); }
+
+	// Nodes don't keep any state for old versions, so there is nothing to compact
+	void compact(Version newOldestVersion) { ASSERT(newOldestVersion <= latestVersion); }
+
+	struct iterator {
+		explicit iterator(Tree const& root, Version at) : root(root), at(at) {}
+
+		K const& key() const { return item().key; }
+		// Returns the version at which the current item was inserted
+		Version insertVersion() const { return item().value.second; }
+		operator bool() const { return depth != 0; }
+		bool operator<(const K& key) const { return this->key() < key; }
+
+		T const& operator*() { return item().value.first; }
+		T const* operator->() { return &item().value.first; }
+		void operator++() {
+			if (depth)
+				next();
+			else
+				first(false);
+		}
+		void operator--() {
+			if (depth)
+				previous();
+			else
+				first(true);
+		}
+		bool operator==(const iterator& r) const {
+			if (depth && r.depth)
+				return path[depth - 1] == r.path[r.depth - 1] && index[depth - 1] == r.index[r.depth - 1];
+			else
+				return depth == r.depth;
+		}
+		bool operator!=(const iterator& r) const { return !(*this == r); }
+
+	private:
+		friend class VersionedBTreeMap<K, T>;
+
+		const Item& item() const { return static_cast<const Leaf*>(path[depth - 1])->items()[index[depth - 1]]; }
+
+		// Descends from the end of the path to the first or last item below it
+		void descend(bool last) {
+			while (!path[depth - 1]->leaf) {
+				ASSERT(depth < MaxHeight);
+				const Node* child =
+				    static_cast<const Internal*>(path[depth - 1])->children[index[depth - 1]].getPtr();
+				path[depth] = child;
+				index[depth] = last ? child->count - 1 : 0;
+				++depth;
+			}
+		}
+
+		void first(bool last) {
+			depth = 0;
+			if (root) {
+				path[0] = root.getPtr();
+				index[0] = last ? root->count - 1 : 0;
+				depth = 1;
+				descend(last);
+			}
+		}
+
+		void next() {
+			int d = depth;
+			while (d > 0 && index[d - 1] + 1 >= path[d - 1]->count) {
+				--d;
+			}
+			depth = d;
+			if (d != 0) {
+				++index[d - 1];
+				descend(false);
+			}
+		}
+
+		void previous() {
+			int d = depth;
+			while (d > 0 && index[d - 1] == 0) {
+				--d;
+			}
+			depth = d;
+			if (d != 0) {
+				--index[d - 1];
+				descend(true);
+			}
+		}
+
+		// Moves to the first item not less than key, or greater than key if upper
+		template <class X>
+		void seek(const X& key, bool upper) {
+			depth = 0;
+			const Node* n = root.getPtr();
+			while (n != nullptr) {
+				ASSERT(depth < MaxHeight);
+				path[depth] = n;
+				if (n->leaf) {
+					int i = static_cast<const Leaf*>(n)->search(key, upper);
+					index[depth++] = i - (i == n->count);
+					if (i == n->count) {
+						next();
+					}
+					return;
+				}
+				const Internal* in = static_cast<const Internal*>(n);
+				int i = in->search(key);
+				index[depth++] = i;
+				n = in->children[i].getPtr();
+			}
+		}
+
+		Tree root;
+		Version at;
+		int depth = 0;
+		const Node* path[MaxHeight];
+		int index[MaxHeight];
+	};
+
+	class ViewAtVersion {
+	public:
+		ViewAtVersion(Tree const& root, Version at) : root(root), at(at) {}
+
+		iterator begin() const {
+			iterator i(root, at);
+			i.first(false);
+			return i;
+		}
+		iterator end() const { return iterator(root, at); }
+
+		// Returns x such that key==*x, or end()
+		template <class X>
+		iterator find(const X& key) const {
+			iterator i(root, at);
+			i.seek(key, false);
+			if (i && i.key() == key)
+				return i;
+			else
+				return end();
+		}
+
+		// Returns the smallest x such that *x>=key, or end()
+		template <class X>
+		iterator lower_bound(const X& key) const {
+			iterator i(root, at);
+			i.seek(key, false);
+			return i;
+		}
+
+		// Returns the smallest x such that *x>key, or end()
+		template <class X>
+		iterator upper_bound(const X& key) const {
+			iterator i(root, at);
+			i.seek(key, true);
+			return i;
+		}
+
+		// Returns the largest x such that *x<=key, or end()
+		template <class X>
+		iterator lastLessOrEqual(const X& key) const {
+			iterator i(root, at);
+			i.seek(key, true);
+			--i;
+			return i;
+		}
+
+		// Returns the largest x such that *x<key, or end()
+		template <class X>
+		iterator lastLess(const X& key) const {
+			iterator i(root, at);
+			i.seek(key, false);
+			--i;
+			return i;
+		}
+
+		void validate() {
+			int height = validateNode(root.getPtr(), nullptr, nullptr);
+			if (height > 10)
+				TraceEvent(SevWarnAlways, "DiabolicalBTreeMapHeight").detail("Height", height);
+		}
+
+	private:
+		Tree root;
+		Version at;
+	};
+
+	ViewAtVersion at(Version v) const {
+		if (v == ::latestVersion) {
+			return atLatest();
+		}
+
+		return ViewAtVersion(getRoot(v), v);
+	}
+	ViewAtVersion atLatest() const { return ViewAtVersion(roots.back().second, latestVersion); }
+
+	bool isClearContaining(ViewAtVersion const& view, KeyRef key) {
+		auto i = view.lastLessOrEqual(key);
+		return i && i->isClearTo() && i->getEndKey() > key;
+	}
+
+private:
+	// Returns the node at ref, first replacing it with a copy if it can't be changed in the latest version
+	Node* mutableNode(Tree& ref) {
+		if (ref->version != latestVersion) {
+			if (ref->leaf) {
+				ref = Tree(new Leaf(*static_cast<const Leaf*>(ref.getPtr()), latestVersion));
+			} else {
+				ref = Tree(new Internal(*static_cast<const Internal*>(ref.getPtr()), latestVersion));
+			}
+		}
+		return ref.getPtr();
+	}
+
+	// Inserts item below ref, returning the key and node to add after ref if ref had to be split
+	Optional<std::pair<K, Tree>> insertInto(Tree& ref, const Item& item) {
+		Node* n = mutableNode(ref);
+		if (n->leaf) {
+			Leaf* leaf = static_cast<Leaf*>(n);
+			int i = leaf->search(item.key, false);
+			if (i < leaf->count && !(item.key < leaf->items()[i].key)) {
+				leaf->items()[i] = item;
+				return {};
+			}
+			if (leaf->count < LeafCapacity) {
+				leaf->insert(i, item);
+				return {};
+			}
+			Leaf* right = new Leaf(latestVersion);
+			int half = leaf->count / 2;
+			leaf->moveTo(right, half);
+			if (i <= half) {
+				leaf->insert(i, item);
+			} else {
+				right->insert(i - half, item);
+			}
+			return std::make_pair(right->items()[0].key, Tree(right));
+		}
+
+		Internal* in = static_cast<Internal*>(n);
+		int i = in->search(item.key);
+		Optional<std::pair<K, Tree>> split = insertInto(in->children[i], item);
+		if (!split.present()) {
+			return {};
+		}
+		if (in->count < InternalCapacity) {
+			in->insert(i + 1, split.get().first, std::move(split.get().second));
+			return {};
+		}
+		Internal* right = new Internal(latestVersion);
+		int half = in->count / 2;
+		std::move(in->keys + half, in->keys + in->count, right->keys);
+		std::move(in->children + half, in->children + in->count, right->children);
+		right->count = in->count - half;
+		in->count = half;
+		if (i + 1 <= half) {
+			in->insert(i + 1, split.get().first, std::move(split.get().second));
+		} else {
+			right->insert(i + 1 - half, split.get().first, std::move(split.get().second));
+		}
+		return std::make_pair(right->keys[0], Tree(right));
+	}
+
+	// Erases the items in [begin, end), or [begin, end] if inclusive
+	void erase(const K& begin, const K& end, bool inclusive) {
+		Tree& root = roots.back().second;
+
+		// Don't copy any nodes if there is nothing to erase
+		iterator i(root, latestVersion);
+		i.seek(begin, false);
+		if (!i || (inclusive ? end < i.key() : !(i.key() < end))) {
+			return;
+		}
+
+		eraseFrom(root, begin, end, inclusive);
+		if (root->count == 0) {
+			root.clear();
+		}
+		while (root && !root->leaf && root->count == 1) {
+			Tree child = static_cast<Internal*>(root.getPtr())->children[0];
+			root = std::move(child);
+		}
+	}
+
+	void eraseFrom(Tree& ref, const K& begin, const K& end, bool inclusive) {
+		Node* n = mutableNode(ref);
+		if (n->leaf) {
+			Leaf* leaf = static_cast<Leaf*>(n);
+			int first = leaf->search(begin, false);
+			int last = leaf->search(end, inclusive);
+			if (last > first) {
+				leaf->remove(first, last);
+			}
+			return;
+		}
+
+		Internal* in = static_cast<Internal*>(n);
+		int first = in->search(begin);
+		int last = inclusive ? in->search(end) : in->searchBefore(end);
+		// Children between the first and last are entirely in the range
+		if (last > first + 1) {
+			in->remove(first + 1, last);
+			last = first + 1;
+		}
+		if (last != first) {
+			eraseFrom(in->children[last], begin, end, inclusive);
+			fixChild(in, last);
+		}
+		eraseFrom(in->children[first], begin, end, inclusive);
+		fixChild(in, first);
+	}
+
+	// Removes child i of in if it is empty, or merges it with a neighbor if they fit comfortably in one node
+	void fixChild(Internal* in, int i) {
+		if (in->children[i]->count == 0) {
+			in->remove(i, i + 1);
+			return;
+		}
+		if (i + 1 < in->count && merge(in, i)) {
+			return;
+		}
+		if (i > 0) {
+			merge(in, i - 1);
+		}
+	}
+
+	// Merges child i + 1 of in into child i if the result would be at most three quarters full
+	bool merge(Internal* in, int i) {
+		const Node* right = in->children[i + 1].getPtr();
+		int capacity = right->leaf ? LeafCapacity : InternalCapacity;
+		if (in->children[i]->count + right->count > capacity * 3 / 4) {
+			return false;
+		}
+		Node* left = mutableNode(in->children[i]);
+		if (left->leaf) {
+			const Leaf* from = static_cast<const Leaf*>(right);
+			Leaf* to = static_cast<Leaf*>(left);
+			std::uninitialized_copy_n(from->items(), from->count, to->items() + to->count);
+			to->count += from->count;
+		} else {
+			const Internal* from = static_cast<const Internal*>(right);
+			Internal* to = static_cast<Internal*>(left);
+			// The right node's first key may not be set, but the parent's key for it is always a valid separator
+			to->keys[to->count] = in->keys[i + 1];
+			std::copy_n(from->keys + 1, from->count - 1, to->keys + to->count + 1);
+			std::copy_n(from->children, from->count, to->children + to->count);
+			to->count += from->count;
+		}
+		in->remove(i + 1, i + 2);
+		return true;
+	}
+
+	static void printNode(const Node* n, int depth) {
+		if (n == nullptr) {
+			return;
+		}
+		if (n->leaf) {
+			const Leaf* leaf = static_cast<const Leaf*>(n);
+			for (int i = 0; i < leaf->count; ++i) {
+				printf("%*s%s\n", depth * 2, "", describe(leaf->items()[i].key).c_str());
+			}
+			return;
+		}
+		const Internal* in = static_cast<const Internal*>(n);
+		for (int i = 0; i < in->count; ++i) {
+			printf("%*s[%d] @%" PRId64 "\n", depth * 2, "", i, in->children[i]->version);
+			printNode(in->children[i].getPtr(), depth + 1);
+		}
+	}
+
+	// Checks that the keys below n are ordered and within [min, max), and returns the height of n
+	static int validateNode(const Node* n, const K* min, const K* max) {
+		if (n == nullptr) {
+			return 0;
+		}
+		ASSERT(n->count > 0);
+		if (n->leaf) {
+			const Leaf* leaf = static_cast<const Leaf*>(n);
+			for (int i = 0; i < leaf->count; ++i) {
+				const K& k = leaf->items()[i].key;
+				ASSERT((i == 0 || leaf->items()[i - 1].key < k) && (!min || !(k < *min)) && (!max || k < *max));
+			}
+			return 1;
+		}
+		const Internal* in = static_cast<const Internal*>(n);
+		int height = 0;
+		for (int i = 0; i < in->count; ++i) {
+			ASSERT(i < 2 || in->keys[i - 1] < in->keys[i]);
+			int h = validateNode(
+			    in->children[i].getPtr(), i == 0 ? min : &in->keys[i], i + 1 == in->count ? max : &in->keys[i + 1]);
+			ASSERT(height == 0 || h == height);
+			height = h;
+		}
+		return height + 1;
+	}
+};
+
+#endif
@@ -29,11 +29,40 @@
 #define FDBCLIENT_VERSIONEDMAP_ACTOR_H
 
 #include "flow/flow.h"
+#include "flow/IThreadPool.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
+// Destroys tree nodes which are no longer reachable from any version of a map, off the thread which updates the map.
+struct VersionedMapReclaimer final : IThreadPoolReceiver {
+	void init() override {}
+
+	template <class Action>
+	void action(Action& a) {
+		a.nodes.clear();
+	}
+};
+
+// The nodes must be detached, holding no references to nodes which are still reachable, and their items must not
+// own anything which could be shared with the map (such as an arena).
+template <class Tree>
+struct ReclaimTreeNodesAction final : TypedAction<VersionedMapReclaimer, ReclaimTreeNodesAction<Tree>> {
+	std::vector<Tree> nodes;
+
+	explicit ReclaimTreeNodesAction(std::vector<Tree>&& nodes) : nodes(std::move(nodes)) {}
+	double getTimeEstimate() const override { return 0; }
+};
+
+// Number of detached nodes handed to the reclaim thread at a time
+constexpr int VERSIONED_MAP_RECLAIM_BATCH = 10000;
+
+// Frees the nodes of trees which are no longer referenced by any version, a few at a time. With a reclaimThread, the
+// nodes are only detached from the nodes still in use here, and destroyed on that thread.
 ACTOR template <class Tree>
-Future<Void> deferredCleanupActor(std::vector<Tree> toFree, TaskPriority taskID = TaskPriority::DefaultYield) {
+Future<Void> deferredCleanupActor(std::vector<Tree> toFree,
+                                  TaskPriority taskID = TaskPriority::DefaultYield,
+                                  Reference<IThreadPool> reclaimThread = Reference<IThreadPool>()) {
 	state int freeCount = 0;
+	state std::vector<Tree> detached;
 	while (!toFree.empty()) {
 		Tree a = std::move(toFree.back());
 		toFree.pop_back();
@@ -41,12 +70,25 @@ Future<Void> deferredCleanupActor(std::vector<Tree> toFree, TaskPriority taskID
 		for (int c = 0; c < 3; c++) {
 			if (a->pointer[c] && a->pointer[c]->isSoleOwner())
 				toFree.push_back(std::move(a->pointer[c]));
+			else if (reclaimThread)
+				a->pointer[c].clear();
+		}
+
+		if (reclaimThread) {
+			detached.push_back(std::move(a));
+			if (detached.size() >= VERSIONED_MAP_RECLAIM_BATCH) {
+				reclaimThread->post(new ReclaimTreeNodesAction<Tree>(std::move(detached)));
+				detached.clear();
+			}
 		}
 
 		if (++freeCount % 100 == 0)
 			wait(yield(taskID));
 	}
 
+	if (!detached.empty()) {
+		reclaimThread->post(new ReclaimTreeNodesAction<Tree>(std::move(detached)));
+	}
 	return Void();
 }
 
@@ -723,6 +723,23 @@ public:
 	}
 
 	Future<Void> forgetVersionsBeforeAsync(Version newOldestVersion, TaskPriority taskID = TaskPriority::DefaultYield) {
+		return forgetAndFreeVersionsBefore(newOldestVersion, taskID, Reference<IThreadPool>());
+	}
+
+	// As above, but if reclaimThread is set the forgotten nodes are destroyed on it. Its threads must be
+	// VersionedMapReclaimers.
+	Future<Void> forgetVersionsBeforeAsync(Version newOldestVersion,
+	                                       TaskPriority taskID,
+	                                       Reference<IThreadPool> reclaimThread) {
+		static_assert(std::is_trivially_destructible_v<K> && std::is_trivially_destructible_v<T>,
+		              "Items destroyed on another thread must not own shared memory");
+		return forgetAndFreeVersionsBefore(newOldestVersion, taskID, reclaimThread);
+	}
+
+private:
+	Future<Void> forgetAndFreeVersionsBefore(Version newOldestVersion,
+	                                         TaskPriority taskID,
+	                                         Reference<IThreadPool> reclaimThread) {
 		ASSERT_LE(newOldestVersion, latestVersion);
 		auto r = upper_bound(roots.begin(), roots.end(), newOldestVersion, rootsComparator());
 		auto upper = r;
@@ -753,7 +770,7 @@ public:
 
 		roots.erase(roots.begin(), newBegin);
 		oldestVersion = newOldestVersion;
-		return deferredCleanupActor(toFree, taskID);
+		return deferredCleanupActor(toFree, taskID, reclaimThread);
 	}
 
 public:
@@ -227,6 +227,42 @@ private:
 	void clearNoConflict(KeyRangeRef keys);
 };
 
+// Writes to single keys and write conflict ranges, in the order they were made, for a transaction which hasn't yet done
+// anything that needs them in a WriteMap, such as reading. Appending to the log is far cheaper than inserting into a
+// WriteMap, so transactions that only write many keys spend much less time buffering them, and the log is sorted
+// only once, when the transaction commits.
+class BlindWriteLog {
+public:
+	struct Entry {
+		KeyRef key;
+		ValueRef param;
+		MutationRef::Type type; // ClearRange for a clear of just key
+		bool addConflict;
+	};
+
+	void mutate(KeyRef key, MutationRef::Type type, ValueRef param, bool addConflict) {
+		ASSERT(type != MutationRef::SetVersionstampedKey);
+		entries.push_back(Entry{ key, param, type, addConflict });
+	}
+	void clear(KeyRef key, bool addConflict) {
+		entries.push_back(Entry{ key, ValueRef(), MutationRef::ClearRange, addConflict });
+	}
+	void addConflictRange(KeyRangeRef keys) { conflictRanges.push_back(keys); }
+
+	// Sorts the writes by key, keeping those to the same key in the order they were made, and drops every write that
+	// is followed by a set or clear of the same key. The writes left have the same effect as all of them did, and
+	// the first one for each key adds a conflict range if any of the writes to it did.
+	void coalesce();
+
+	bool empty() const { return entries.empty() && conflictRanges.empty(); }
+	std::vector<Entry> const& getEntries() const { return entries; }
+	std::vector<KeyRangeRef> const& getConflictRanges() const { return conflictRanges; }
+
+private:
+	std::vector<Entry> entries;
+	std::vector<KeyRangeRef> conflictRanges;
+};
+
 /*
 
     for write in writes:   # write.type in [ 'none', 'clear', 'independent', 'dependent' ]
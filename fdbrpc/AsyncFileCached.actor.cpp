@@ -19,6 +19,8 @@
  */
 
 #include "fdbrpc/AsyncFileCached.actor.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
 
 // Page caches used in non-simulated environments
 Optional<Reference<EvictablePageCache>> pc4k, pc64k;
@@ -134,6 +136,41 @@ Future<Void> AsyncFileCached::read_write_impl(AsyncFileCached* self,
 	return waitForAll(actors);
 }
 
+void AsyncFileCached::readAhead(int64_t offset) {
+	int64_t pageSize = pageCache->pageSize;
+	int64_t begin = (offset + pageSize - 1) / pageSize * pageSize;
+	int64_t end = std::min(prevLength, begin + FLOW_KNOBS->PAGE_CACHE_READ_AHEAD_PAGES * pageSize);
+	for (int64_t pageOffset = begin; pageOffset < end; pageOffset += pageSize) {
+		if (pages.count(pageOffset))
+			continue;
+		AFCPage* page = new AFCPage(this, pageOffset);
+		pages.insert(std::make_pair(pageOffset, page));
+		page->readAhead();
+		++countFileCachePageReadAheads;
+		++countCachePageReadAheads;
+	}
+}
+
+bool AsyncFileCached::canBypassCache(void const* data, int length, int64_t offset) const {
+	if (FLOW_KNOBS->PAGE_CACHE_BYPASS_READ_BYTES <= 0 || length < FLOW_KNOBS->PAGE_CACHE_BYPASS_READ_BYTES)
+		return false;
+
+	// The uncached file is opened unbuffered, which needs whole aligned pages
+	int64_t pageSize = pageCache->pageSize;
+	if (offset % pageSize || length % pageSize || reinterpret_cast<uintptr_t>(data) % 4096)
+		return false;
+
+	// Anything written past prevLength, or being truncated, is only right in the cache
+	if (offset + length > prevLength || !currentTruncate.isReady())
+		return false;
+
+	for (int64_t pageOffset = offset; pageOffset < offset + length; pageOffset += pageSize) {
+		if (pages.count(pageOffset))
+			return false;
+	}
+	return true;
+}
+
 Future<Void> AsyncFileCached::readZeroCopy(void** data, int* length, int64_t offset) {
 	++countFileCacheReads;
 	++countCacheReads;
@@ -289,3 +326,58 @@ AsyncFileCached::~AsyncFileCached() {
 	}
 	openFiles.erase(filename);
 }
+
+namespace {
+
+struct TestEvictablePage : EvictablePage {
+	std::set<int>* evicted;
+
+	TestEvictablePage(Reference<EvictablePageCache> pageCache, int id, std::set<int>* evicted)
+	  : EvictablePage(pageCache), evicted(evicted), id(id) {
+		pageCache->allocate(this);
+	}
+
+	bool evict() override {
+		evicted->insert(id);
+		delete this;
+		return true;
+	}
+
+	int id;
+};
+
+} // namespace
+
+TEST_CASE("/fdbrpc/AsyncFileCached/ClockEviction") {
+	Reference<EvictablePageCache> cache = makeReference<EvictablePageCache>(4096, 4 * 4096, EvictablePageCache::CLOCK);
+	std::set<int> evicted;
+	std::vector<TestEvictablePage*> pages;
+	for (int i = 0; i < 4; i++) {
+		pages.push_back(new TestEvictablePage(cache, i, &evicted));
+	}
+	ASSERT(evicted.empty());
+
+	// Each eviction below takes at most two attempts, the least MAX_EVICT_ATTEMPTS is BUGGIFYed to
+
+	// The referenced page at the hand gets a second chance, so the one after it goes
+	cache->updateHit(pages[0]);
+	pages.push_back(new TestEvictablePage(cache, 4, &evicted));
+	ASSERT(evicted == std::set<int>({ 1 }));
+	ASSERT_EQ(cache->lruPages.size(), 4);
+
+	pages.push_back(new TestEvictablePage(cache, 5, &evicted));
+	ASSERT(evicted == std::set<int>({ 1, 2 }));
+
+	// Page 0 has used up its second chance, so it goes after the newly referenced page 3 is passed over
+	cache->updateHit(pages[3]);
+	pages.push_back(new TestEvictablePage(cache, 6, &evicted));
+	ASSERT(evicted == std::set<int>({ 0, 1, 2 }));
+
+	for (auto page : pages) {
+		if (!evicted.count(page->id)) {
+			delete page;
+		}
+	}
+	ASSERT(cache->lruPages.empty());
+	return Void();
+}
@@ -19,11 +19,71 @@
  */
 
 #include "fdbrpc/AsyncFileEncrypted.h"
+#include "fdbrpc/simulator.h"
+#include "flow/IThreadPool.h"
 #include "flow/StreamCipher.h"
 #include "flow/UnitTest.h"
 #include "flow/xxhash.h"
 #include "flow/actorcompiler.h" // must be last include
 
+namespace {
+
+// Whole blocks to encrypt, starting at the block each cipher was set up for. StreamCipher is not thread safe to create
+// or destroy, so the ciphers are made and freed on the network thread, and only used to encrypt on a worker.
+struct BlockEncryptionJob {
+	std::vector<std::unique_ptr<EncryptionStreamCipher>> ciphers;
+	Standalone<StringRef> plaintext;
+	Standalone<StringRef> ciphertext;
+
+	void run() {
+		const int blockSize = FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE;
+		uint8_t* out = mutateString(ciphertext);
+		for (int i = 0; i < ciphers.size(); i++) {
+			Arena arena;
+			int offset = i * blockSize;
+			StringRef encrypted = ciphers[i]->encrypt(plaintext.begin() + offset, blockSize, arena);
+			ASSERT_EQ(encrypted.size(), blockSize);
+			memcpy(out + offset, encrypted.begin(), encrypted.size());
+		}
+	}
+};
+
+struct BlockEncryptionWorker final : IThreadPoolReceiver {
+	void init() override {}
+
+	struct EncryptAction final : TypedAction<BlockEncryptionWorker, EncryptAction> {
+		BlockEncryptionJob* job; // kept alive by the writer until result is sent
+		ThreadReturnPromise<Void> result;
+
+		explicit EncryptAction(BlockEncryptionJob* job) : job(job) {}
+		double getTimeEstimate() const override { return 0; }
+	};
+
+	void action(EncryptAction& a) {
+		a.job->run();
+		a.result.send(Void());
+	}
+};
+
+// The threads shared by every encrypted file in the process, or null to encrypt on the network thread. Simulation
+// only uses threads when they can't change its outcome.
+Reference<IThreadPool> encryptionThreads() {
+	static Reference<IThreadPool> threads;
+	static bool initialized = false;
+	if (!initialized) {
+		initialized = true;
+		if (FLOW_KNOBS->ENCRYPTION_THREADS > 0 && (!g_network->isSimulated() || FLOW_KNOBS->SIM_POOL_THREADS > 0)) {
+			threads = g_network->isSimulated() ? createDeterministicThreadPool() : createGenericThreadPool();
+			for (int i = 0; i < FLOW_KNOBS->ENCRYPTION_THREADS; i++) {
+				threads->addThread(new BlockEncryptionWorker(), "fdb-file-encrypt");
+			}
+		}
+	}
+	return threads;
+}
+
+} // namespace
+
 class AsyncFileEncryptedImpl {
 public:
 	// Determine the initialization for the first block of a file based on a hash of
@@ -64,17 +124,17 @@ public:
 		state uint32_t block;
 		state unsigned char* output = reinterpret_cast<unsigned char*>(data);
 		state int bytesRead = 0;
+		state std::vector<Future<Standalone<StringRef>>> blocks;
 		ASSERT(self->mode == AsyncFileEncrypted::Mode::READ_ONLY);
-		for (block = firstBlock; block <= lastBlock; ++block) {
-			state Standalone<StringRef> plaintext;
-
+		// Every block that isn't cached is read at once, rather than one after another
+		for (block = firstBlock; block <= lastBlock && length > 0; ++block) {
 			auto cachedBlock = self->readBuffers.get(block);
-			if (cachedBlock.present()) {
-				plaintext = cachedBlock.get();
-			} else {
-				wait(store(plaintext, readBlock(self.getPtr(), block)));
-				self->readBuffers.insert(block, plaintext);
-			}
+			blocks.push_back(cachedBlock.present() ? Future<Standalone<StringRef>>(cachedBlock.get())
+			                                       : readBlock(self.getPtr(), block));
+		}
+		for (block = firstBlock; block - firstBlock < blocks.size(); ++block) {
+			state Standalone<StringRef> plaintext = wait(blocks[block - firstBlock]);
+			self->readBuffers.insert(block, plaintext);
 			auto start = (block == firstBlock) ? plaintext.begin() + (offset % FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE)
 			                                   : plaintext.begin();
 			auto end = (block == lastBlock)
@@ -98,39 +158,106 @@ public:
 		return bytesRead;
 	}
 
-	ACTOR static Future<Void> write(Reference<AsyncFileEncrypted> self, void const* data, int length, int64_t offset) {
-		ASSERT(self->mode == AsyncFileEncrypted::Mode::APPEND_ONLY);
-		// All writes must append to the end of the file:
-		ASSERT_EQ(offset, self->currentBlock * FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE + self->offsetInBlock);
-		state unsigned char const* input = reinterpret_cast<unsigned char const*>(data);
+	// Encrypts whole blocks starting at firstBlock and writes them to the file together
+	ACTOR static Future<Void> writeBlocks(Reference<AsyncFileEncrypted> self,
+	                                      uint32_t firstBlock,
+	                                      Standalone<StringRef> plaintext) {
+		state std::unique_ptr<BlockEncryptionJob> job = std::make_unique<BlockEncryptionJob>();
+		state Reference<IThreadPool> threads = encryptionThreads();
+		job->plaintext = plaintext;
+		job->ciphertext = makeString(plaintext.size());
+		for (int i = 0; i < plaintext.size() / FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE; i++) {
+			ASSERT_LT(firstBlock + i, std::numeric_limits<uint32_t>::max());
+			job->ciphers.push_back(std::make_unique<EncryptionStreamCipher>(StreamCipherKey::getGlobalCipherKey(),
+			                                                                self->getIV(firstBlock + i)));
+		}
+		if (threads) {
+			auto action = new BlockEncryptionWorker::EncryptAction(job.get());
+			Future<Void> encrypted = action->result.getFuture();
+			threads->post(action);
+			wait(encrypted);
+		} else {
+			job->run();
+		}
+		wait(self->file->write(
+		    job->ciphertext.begin(), job->ciphertext.size(), (int64_t)firstBlock * FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE));
+		return Void();
+	}
+
+	// Starts writing whole blocks from input, which is copied, so that the caller's buffer may be reused at once
+	static void startWrite(AsyncFileEncrypted* self, unsigned char const* input, int blocks) {
+		Standalone<StringRef> plaintext(StringRef(input, blocks * FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE));
+		// Uncancellable, since the job must outlive its encryption on a worker
+		self->pendingWrites.push_back(
+		    uncancellable(writeBlocks(Reference<AsyncFileEncrypted>::addRef(self), self->currentBlock, plaintext)));
+		self->currentBlock += blocks;
+	}
+
+	// Waits until at most maxPending block writes are in flight, throwing the error of any that failed. A failed
+	// write is left in place, so that every later write and sync fails too.
+	ACTOR static Future<Void> waitForWrites(Reference<AsyncFileEncrypted> self, int maxPending) {
+		loop {
+			auto& pending = self->pendingWrites;
+			while (!pending.empty() && pending.front().isReady() && !pending.front().isError()) {
+				pending.pop_front();
+			}
+			if (!pending.empty() && pending.front().isError()) {
+				throw pending.front().getError();
+			}
+			if (pending.size() <= maxPending) {
+				return Void();
+			}
+			wait(ready(pending.front()));
+		}
+	}
+
+	// Buffers the plaintext of a partial block and starts writing any whole blocks, all before returning, so that
+	// appends are assigned their blocks in the order they were made
+	static void appendBlocks(AsyncFileEncrypted* self, unsigned char const* input, int length) {
+		const int blockSize = FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE;
 		while (length > 0) {
-			const auto chunkSize = std::min(length, FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE - self->offsetInBlock);
-			Arena arena;
-			auto encrypted = self->encryptor->encrypt(input, chunkSize, arena);
-			std::copy(encrypted.begin(), encrypted.end(), &self->writeBuffer[self->offsetInBlock]);
-			offset += encrypted.size();
+			if (self->offsetInBlock == 0 && length >= blockSize) {
+				CODE_PROBE(length >= 2 * blockSize, "Multiple encrypted blocks written at once");
+				int blocks = std::min(length / blockSize, std::max(FLOW_KNOBS->ENCRYPTION_WRITE_BATCH_BLOCKS, 1));
+				startWrite(self, input, blocks);
+				input += blocks * blockSize;
+				length -= blocks * blockSize;
+				continue;
+			}
+			const auto chunkSize = std::min(length, blockSize - self->offsetInBlock);
+			std::copy(input, input + chunkSize, &self->writeBuffer[self->offsetInBlock]);
 			self->offsetInBlock += chunkSize;
 			length -= chunkSize;
 			input += chunkSize;
-			if (self->offsetInBlock == FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE) {
-				wait(self->writeLastBlockToFile());
+			if (self->offsetInBlock == blockSize) {
+				startWrite(self, &self->writeBuffer[0], 1);
 				self->offsetInBlock = 0;
-				ASSERT_LT(self->currentBlock, std::numeric_limits<uint32_t>::max());
-				++self->currentBlock;
-				self->encryptor = std::make_unique<EncryptionStreamCipher>(StreamCipherKey::getGlobalCipherKey(),
-				                                                           self->getIV(self->currentBlock));
 			}
 		}
-		return Void();
+	}
+
+	static Future<Void> write(Reference<AsyncFileEncrypted> self, void const* data, int length, int64_t offset) {
+		ASSERT(self->mode == AsyncFileEncrypted::Mode::APPEND_ONLY);
+		// All writes must append to the end of the file:
+		ASSERT_EQ(offset, (int64_t)self->currentBlock * FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE + self->offsetInBlock);
+		appendBlocks(self.getPtr(), reinterpret_cast<unsigned char const*>(data), length);
+		return waitForWrites(self, FLOW_KNOBS->ENCRYPTION_MAX_PENDING_WRITES);
 	}
 
 	ACTOR static Future<Void> sync(Reference<AsyncFileEncrypted> self) {
 		ASSERT(self->mode == AsyncFileEncrypted::Mode::APPEND_ONLY);
+		wait(waitForWrites(self, 0));
 		wait(self->writeLastBlockToFile());
 		wait(self->file->sync());
 		return Void();
 	}
 
+	ACTOR static Future<Void> truncate(Reference<AsyncFileEncrypted> self, int64_t size) {
+		wait(waitForWrites(self, 0));
+		wait(self->file->truncate(size));
+		return Void();
+	}
+
 	ACTOR static Future<Void> zeroRange(AsyncFileEncrypted* self, int64_t offset, int64_t length) {
 		ASSERT(self->mode == AsyncFileEncrypted::Mode::APPEND_ONLY);
 		// TODO: Could optimize this
@@ -146,8 +273,6 @@ AsyncFileEncrypted::AsyncFileEncrypted(Reference<IAsyncFile> file, Mode mode)
   : file(file), mode(mode), readBuffers(FLOW_KNOBS->MAX_DECRYPTED_BLOCKS), currentBlock(0) {
 	firstBlockIV = AsyncFileEncryptedImpl::getFirstBlockIV(file->getFilename());
 	if (mode == Mode::APPEND_ONLY) {
-		encryptor =
-		    std::make_unique<EncryptionStreamCipher>(StreamCipherKey::getGlobalCipherKey(), getIV(currentBlock));
 		writeBuffer = std::vector<unsigned char>(FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE, 0);
 	}
 }
@@ -174,7 +299,7 @@ Future<Void> AsyncFileEncrypted::zeroRange(int64_t offset, int64_t length) {
 
 Future<Void> AsyncFileEncrypted::truncate(int64_t size) {
 	ASSERT(mode == Mode::APPEND_ONLY);
-	return file->truncate(size);
+	return AsyncFileEncryptedImpl::truncate(Reference<AsyncFileEncrypted>::addRef(this), size);
 }
 
 Future<Void> AsyncFileEncrypted::sync() {
@@ -218,12 +343,18 @@ StreamCipher::IV AsyncFileEncrypted::getIV(uint32_t block) const {
 	return iv;
 }
 
+// Writes what there is of the current block, which is written again in full once it fills up. A block's ciphertext
+// does not depend on how its plaintext was split up, so the prefix written here is the same as the full block's.
 Future<Void> AsyncFileEncrypted::writeLastBlockToFile() {
-	// The source buffer for the write is owned by *this so this must be kept alive by reference count until the write
-	// is finished.
-	return uncancellable(
+	Arena arena;
+	EncryptionStreamCipher encryptor(StreamCipherKey::getGlobalCipherKey(), getIV(currentBlock));
+	StringRef encrypted = encryptor.encrypt(&writeBuffer[0], offsetInBlock, arena);
+	return uncancellable(holdWhile(
+	    arena,
 	    holdWhile(Reference<AsyncFileEncrypted>::addRef(this),
-	              file->write(&writeBuffer[0], offsetInBlock, currentBlock * FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE)));
+	              file->write(encrypted.begin(),
+	                          encrypted.size(),
+	                          (int64_t)currentBlock * FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE))));
 }
 
 size_t AsyncFileEncrypted::RandomCache::evict() {
@@ -258,8 +389,8 @@ Optional<Standalone<StringRef>> AsyncFileEncrypted::RandomCache::get(uint32_t bl
 	}
 }
 
-// This test writes random data into an encrypted file in random increments,
-// then reads this data back from the file in random increments, then confirms that
+// This test writes random data into an encrypted file in random increments, some spanning several blocks and some
+// followed by a sync, then reads this data back from the file in random increments, then confirms that
 // the bytes read match the bytes written.
 TEST_CASE("fdbrpc/AsyncFileEncrypted") {
 	state const int bytes = FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE * deterministicRandom()->randomInt(0, 1000);
@@ -275,15 +406,21 @@ TEST_CASE("fdbrpc/AsyncFileEncrypted") {
 	    wait(IAsyncFileSystem::filesystem()->open(joinPath(params.getDataDir(), "test-encrypted-file"), flags, 0600));
 	state int bytesWritten = 0;
 	state int chunkSize;
+	state int maxChunkSize = 5 * FLOW_KNOBS->ENCRYPTION_BLOCK_SIZE;
 	while (bytesWritten < bytes) {
-		chunkSize = std::min(deterministicRandom()->randomInt(0, 100), bytes - bytesWritten);
+		chunkSize = deterministicRandom()->randomInt(0, deterministicRandom()->random01() < 0.9 ? 100 : maxChunkSize);
+		chunkSize = std::min(chunkSize, bytes - bytesWritten);
 		wait(file->write(&writeBuffer[bytesWritten], chunkSize, bytesWritten));
 		bytesWritten += chunkSize;
+		if (deterministicRandom()->random01() < 0.01) {
+			wait(file->sync());
+		}
 	}
 	wait(file->sync());
 	state int bytesRead = 0;
 	while (bytesRead < bytes) {
-		chunkSize = std::min(deterministicRandom()->randomInt(0, 100), bytes - bytesRead);
+		chunkSize = deterministicRandom()->randomInt(0, deterministicRandom()->random01() < 0.9 ? 100 : maxChunkSize);
+		chunkSize = std::min(chunkSize, bytes - bytesRead);
 		int bytesReadInChunk = wait(file->read(&readBuffer[bytesRead], chunkSize, bytesRead));
 		ASSERT_EQ(bytesReadInChunk, chunkSize);
 		bytesRead += bytesReadInChunk;
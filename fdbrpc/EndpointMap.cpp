@@ -0,0 +1,133 @@
+/*
+ * EndpointMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbrpc/EndpointMap.h"
+
+#include "fdbrpc/fdbrpc.h"
+#include "flow/Trace.h"
+
+EndpointMap::EndpointMap(int wellKnownEndpointCount)
+  : wellKnownEndpointCount(wellKnownEndpointCount), data(wellKnownEndpointCount), firstFree(-1) {}
+
+void EndpointMap::realloc() {
+	int oldSize = data.size();
+	data.resize(std::max(128, oldSize * 2));
+	for (int i = oldSize; i < data.size(); i++) {
+		data[i].receiver = 0;
+		data[i].nextFree = i + 1;
+	}
+	data[data.size() - 1].nextFree = firstFree;
+	firstFree = oldSize;
+}
+
+void EndpointMap::insertWellKnown(NetworkMessageReceiver* r, const Endpoint::Token& token, TaskPriority priority) {
+	int index = token.second();
+	ASSERT(index <= wellKnownEndpointCount);
+	ASSERT(data[index].receiver == nullptr);
+	data[index].receiver = r;
+	data[index].token() =
+	    Endpoint::Token(token.first(), (token.second() & 0xffffffff00000000LL) | static_cast<uint32_t>(priority));
+}
+
+void EndpointMap::insert(NetworkMessageReceiver* r, Endpoint::Token& token, TaskPriority priority) {
+	if (firstFree == uint32_t(-1))
+		realloc();
+	int index = firstFree;
+	firstFree = data[index].nextFree;
+	token = Endpoint::Token(token.first(), (token.second() & 0xffffffff00000000LL) | index);
+	data[index].token() =
+	    Endpoint::Token(token.first(), (token.second() & 0xffffffff00000000LL) | static_cast<uint32_t>(priority));
+	data[index].receiver = r;
+}
+
+const Endpoint& EndpointMap::insert(NetworkAddressList localAddresses,
+                                    std::vector<std::pair<FlowReceiver*, TaskPriority>> const& streams) {
+	int adjacentFree = 0;
+	int adjacentStart = -1;
+	firstFree = -1;
+	for (int i = wellKnownEndpointCount; i < data.size(); i++) {
+		if (data[i].receiver) {
+			adjacentFree = 0;
+		} else {
+			data[i].nextFree = firstFree;
+			firstFree = i;
+			if (adjacentStart == -1 && ++adjacentFree == streams.size()) {
+				adjacentStart = i + 1 - adjacentFree;
+				firstFree = data[adjacentStart].nextFree;
+			}
+		}
+	}
+	if (adjacentStart == -1) {
+		data.resize(data.size() + streams.size() - adjacentFree);
+		adjacentStart = data.size() - streams.size();
+		if (adjacentFree > 0) {
+			firstFree = data[adjacentStart].nextFree;
+		}
+	}
+
+	UID base = deterministicRandom()->randomUniqueID();
+	for (uint64_t i = 0; i < streams.size(); i++) {
+		int index = adjacentStart + i;
+		uint64_t first = (base.first() + (i << 32)) | TOKEN_STREAM_FLAG;
+		streams[i].first->setEndpoint(
+		    Endpoint(localAddresses, UID(first, (base.second() & 0xffffffff00000000LL) | index)));
+		data[index].token() =
+		    Endpoint::Token(first, (base.second() & 0xffffffff00000000LL) | static_cast<uint32_t>(streams[i].second));
+		data[index].receiver = (NetworkMessageReceiver*)streams[i].first;
+	}
+
+	return streams[0].first->getEndpoint(TaskPriority::DefaultEndpoint);
+}
+
+NetworkMessageReceiver* EndpointMap::get(Endpoint::Token const& token) {
+	uint32_t index = token.second();
+	if (index < wellKnownEndpointCount && data[index].receiver == nullptr) {
+		TraceEvent(SevWarnAlways, "WellKnownEndpointNotAdded")
+		    .detail("Token", token)
+		    .detail("Index", index)
+		    .backtrace();
+	}
+	if (matches(index, token))
+		return data[index].receiver;
+	return 0;
+}
+
+TaskPriority EndpointMap::getPriority(Endpoint::Token const& token) {
+	uint32_t index = token.second();
+	if (matches(index, token)) {
+		auto res = static_cast<TaskPriority>(data[index].token().second());
+		// we don't allow this priority to be "misused" for other stuff as we won't even
+		// attempt to find an endpoint if UnknownEndpoint is returned here
+		ASSERT(res != TaskPriority::UnknownEndpoint);
+		return res;
+	}
+	return TaskPriority::UnknownEndpoint;
+}
+
+void EndpointMap::remove(Endpoint::Token const& token, NetworkMessageReceiver* r) {
+	uint32_t index = token.second();
+	if (index < wellKnownEndpointCount) {
+		data[index].receiver = nullptr;
+	} else if (matches(index, token) && data[index].receiver == r) {
+		data[index].receiver = 0;
+		data[index].nextFree = firstFree;
+		firstFree = index;
+	}
+}
@@ -30,6 +30,7 @@
 
 #include <boost/unordered_map.hpp>
 
+#include "fdbrpc/EndpointMap.h"
 #include "fdbrpc/TokenSign.h"
 #include "fdbrpc/fdbrpc.h"
 #include "fdbrpc/FailureMonitor.h"
@@ -67,153 +68,10 @@ Future<Void> g_currentDeliveryPeerDisconnect;
 } // namespace
 
 constexpr int PACKET_LEN_WIDTH = sizeof(uint32_t);
-const uint64_t TOKEN_STREAM_FLAG = 1;
 
 FDB_BOOLEAN_PARAM(InReadSocket);
 FDB_BOOLEAN_PARAM(IsStableConnection);
 
-class EndpointMap : NonCopyable {
-public:
-	// Reserve space for this many wellKnownEndpoints
-	explicit EndpointMap(int wellKnownEndpointCount);
-	void insertWellKnown(NetworkMessageReceiver* r, const Endpoint::Token& token, TaskPriority priority);
-	void insert(NetworkMessageReceiver* r, Endpoint::Token& token, TaskPriority priority);
-	const Endpoint& insert(NetworkAddressList localAddresses,
-	                       std::vector<std::pair<FlowReceiver*, TaskPriority>> const& streams);
-	NetworkMessageReceiver* get(Endpoint::Token const& token);
-	TaskPriority getPriority(Endpoint::Token const& token);
-	void remove(Endpoint::Token const& token, NetworkMessageReceiver* r);
-
-private:
-	void realloc();
-
-	struct Entry {
-		union {
-			uint64_t
-			    uid[2]; // priority packed into lower 32 bits; actual lower 32 bits of token are the index in data[]
-			uint32_t nextFree;
-		};
-		NetworkMessageReceiver* receiver = nullptr;
-		Endpoint::Token& token() { return *(Endpoint::Token*)uid; }
-	};
-	int wellKnownEndpointCount;
-	std::vector<Entry> data;
-	uint32_t firstFree;
-};
-
-EndpointMap::EndpointMap(int wellKnownEndpointCount)
-  : wellKnownEndpointCount(wellKnownEndpointCount), data(wellKnownEndpointCount), firstFree(-1) {}
-
-void EndpointMap::realloc() {
-	int oldSize = data.size();
-	data.resize(std::max(128, oldSize * 2));
-	for (int i = oldSize; i < data.size(); i++) {
-		data[i].receiver = 0;
-		data[i].nextFree = i + 1;
-	}
-	data[data.size() - 1].nextFree = firstFree;
-	firstFree = oldSize;
-}
-
-void EndpointMap::insertWellKnown(NetworkMessageReceiver* r, const Endpoint::Token& token, TaskPriority priority) {
-	int index = token.second();
-	ASSERT(index <= wellKnownEndpointCount);
-	ASSERT(data[index].receiver == nullptr);
-	data[index].receiver = r;
-	data[index].token() =
-	    Endpoint::Token(token.first(), (token.second() & 0xffffffff00000000LL) | static_cast<uint32_t>(priority));
-}
-
-void EndpointMap::insert(NetworkMessageReceiver* r, Endpoint::Token& token, TaskPriority priority) {
-	if (firstFree == uint32_t(-1))
-		realloc();
-	int index = firstFree;
-	firstFree = data[index].nextFree;
-	token = Endpoint::Token(token.first(), (token.second() & 0xffffffff00000000LL) | index);
-	data[index].token() =
-	    Endpoint::Token(token.first(), (token.second() & 0xffffffff00000000LL) | static_cast<uint32_t>(priority));
-	data[index].receiver = r;
-}
-
-const Endpoint& EndpointMap::insert(NetworkAddressList localAddresses,
-                                    std::vector<std::pair<FlowReceiver*, TaskPriority>> const& streams) {
-	int adjacentFree = 0;
-	int adjacentStart = -1;
-	firstFree = -1;
-	for (int i = wellKnownEndpointCount; i < data.size(); i++) {
-		if (data[i].receiver) {
-			adjacentFree = 0;
-		} else {
-			data[i].nextFree = firstFree;
-			firstFree = i;
-			if (adjacentStart == -1 && ++adjacentFree == streams.size()) {
-				adjacentStart = i + 1 - adjacentFree;
-				firstFree = data[adjacentStart].nextFree;
-			}
-		}
-	}
-	if (adjacentStart == -1) {
-		data.resize(data.size() + streams.size() - adjacentFree);
-		adjacentStart = data.size() - streams.size();
-		if (adjacentFree > 0) {
-			firstFree = data[adjacentStart].nextFree;
-		}
-	}
-
-	UID base = deterministicRandom()->randomUniqueID();
-	for (uint64_t i = 0; i < streams.size(); i++) {
-		int index = adjacentStart + i;
-		uint64_t first = (base.first() + (i << 32)) | TOKEN_STREAM_FLAG;
-		streams[i].first->setEndpoint(
-		    Endpoint(localAddresses, UID(first, (base.second() & 0xffffffff00000000LL) | index)));
-		data[index].token() =
-		    Endpoint::Token(first, (base.second() & 0xffffffff00000000LL) | static_cast<uint32_t>(streams[i].second));
-		data[index].receiver = (NetworkMessageReceiver*)streams[i].first;
-	}
-
-	return streams[0].first->getEndpoint(TaskPriority::DefaultEndpoint);
-}
-
-NetworkMessageReceiver* EndpointMap::get(Endpoint::Token const& token) {
-	uint32_t index = token.second();
-	if (index < wellKnownEndpointCount && data[index].receiver == nullptr) {
-		TraceEvent(SevWarnAlways, "WellKnownEndpointNotAdded")
-		    .detail("Token", token)
-		    .detail("Index", index)
-		    .backtrace();
-	}
-	if (index < data.size() && data[index].token().first() == token.first() &&
-	    ((data[index].token().second() & 0xffffffff00000000LL) | index) == token.second())
-		return data[index].receiver;
-	return 0;
-}
-
-TaskPriority EndpointMap::getPriority(Endpoint::Token const& token) {
-	uint32_t index = token.second();
-	if (index < data.size() && data[index].token().first() == token.first() &&
-	    ((data[index].token().second() & 0xffffffff00000000LL) | index) == token.second()) {
-		auto res = static_cast<TaskPriority>(data[index].token().second());
-		// we don't allow this priority to be "misused" for other stuff as we won't even
-		// attempt to find an endpoint if UnknownEndpoint is returned here
-		ASSERT(res != TaskPriority::UnknownEndpoint);
-		return res;
-	}
-	return TaskPriority::UnknownEndpoint;
-}
-
-void EndpointMap::remove(Endpoint::Token const& token, NetworkMessageReceiver* r) {
-	uint32_t index = token.second();
-	if (index < wellKnownEndpointCount) {
-		data[index].receiver = nullptr;
-	} else if (index < data.size() && data[index].token().first() == token.first() &&
-	           ((data[index].token().second() & 0xffffffff00000000LL) | index) == token.second() &&
-	           data[index].receiver == r) {
-		data[index].receiver = 0;
-		data[index].nextFree = firstFree;
-		firstFree = index;
-	}
-}
-
 struct EndpointNotFoundReceiver final : NetworkMessageReceiver {
 	EndpointNotFoundReceiver(EndpointMap& endpoints) {
 		endpoints.insertWellKnown(
@@ -349,6 +207,7 @@ public:
 
 	Future<Void> multiVersionCleanup;
 	Future<Void> pingLogger;
+	Future<Void> peerMetricsLogger;
 	Future<Void> publicKeyFileWatch;
 
 	std::unordered_map<Standalone<StringRef>, PublicKey> publicKeys;
@@ -388,6 +247,8 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 				    .detail("Count", peer->pingLatencies.getPopulationSize())
 				    .detail("BytesReceived", peer->bytesReceived - peer->lastLoggedBytesReceived)
 				    .detail("BytesSent", peer->bytesSent - peer->lastLoggedBytesSent)
+				    .detail("Writes", peer->writes - peer->lastLoggedWrites)
+				    .detail("CoalesceDelay", peer->coalesceDelay)
 				    .detail("TimeoutCount", peer->timeoutCount)
 				    .detail("ConnectOutgoingCount", peer->connectOutgoingCount)
 				    .detail("ConnectIncomingCount", peer->connectIncomingCount)
@@ -405,6 +266,7 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 				peer->connectLatencies.clear();
 				peer->lastLoggedBytesReceived = peer->bytesReceived;
 				peer->lastLoggedBytesSent = peer->bytesSent;
+				peer->lastLoggedWrites = peer->writes;
 				peer->timeoutCount = 0;
 				wait(delay(FLOW_KNOBS->PING_LOGGING_INTERVAL));
 			} else if (it == self->orderedAddresses.begin()) {
@@ -416,12 +278,81 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 	}
 }
 
+struct PeerNetworkMetrics {
+	NetworkAddress address;
+	uint64_t pingCount;
+	double pingP50;
+	double pingP99;
+	int timeouts;
+	double bytesSentHz;
+	double bytesReceivedHz;
+	int64_t queuedBytes;
+};
+
+// Logs, for status, the public peers that have been slowest to answer pings over the last elapsed seconds
+static void logPeerNetworkMetrics(TransportData* self, double elapsed) {
+	std::vector<PeerNetworkMetrics> metrics;
+	for (auto& [address, peer] : self->peers) {
+		if (!address.isPublic()) {
+			continue;
+		}
+		PeerNetworkMetrics m;
+		m.address = address;
+		m.pingCount = peer->recentPingLatencies.getPopulationSize();
+		m.pingP50 = m.pingCount ? peer->recentPingLatencies.median() : 0;
+		m.pingP99 = m.pingCount ? peer->recentPingLatencies.percentile(0.99) : 0;
+		m.timeouts = peer->recentTimeouts;
+		m.bytesSentHz = (peer->bytesSent - peer->lastReportedBytesSent) / elapsed;
+		m.bytesReceivedHz = (peer->bytesReceived - peer->lastReportedBytesReceived) / elapsed;
+		m.queuedBytes = peer->unsent.unsentBytes() + peer->unsentPriority.unsentBytes();
+		metrics.push_back(m);
+
+		peer->recentPingLatencies.clear();
+		peer->recentTimeouts = 0;
+		peer->lastReportedBytesSent = peer->bytesSent;
+		peer->lastReportedBytesReceived = peer->bytesReceived;
+	}
+
+	// Timeouts first, since a peer that has stopped answering pings has no latency to compare
+	int reported = std::min<int>(metrics.size(), FLOW_KNOBS->PEER_METRICS_MAX_PEERS);
+	std::partial_sort(
+	    metrics.begin(), metrics.begin() + reported, metrics.end(), [](auto const& a, auto const& b) {
+		    return std::make_pair(a.timeouts, a.pingP99) > std::make_pair(b.timeouts, b.pingP99);
+	    });
+
+	TraceEvent ev("PeerNetworkMetrics");
+	ev.detail("Elapsed", elapsed).detail("Peers", metrics.size()).detail("ReportedPeers", reported);
+	for (int i = 0; i < reported; i++) {
+		const PeerNetworkMetrics& m = metrics[i];
+		std::string prefix = format("Peer%d", i);
+		ev.detail(prefix + "Address", m.address)
+		    .detail(prefix + "PingCount", m.pingCount)
+		    .detail(prefix + "PingP50", m.pingP50)
+		    .detail(prefix + "PingP99", m.pingP99)
+		    .detail(prefix + "Timeouts", m.timeouts)
+		    .detail(prefix + "BytesSentHz", m.bytesSentHz)
+		    .detail(prefix + "BytesReceivedHz", m.bytesReceivedHz)
+		    .detail(prefix + "QueuedBytes", m.queuedBytes);
+	}
+	ev.trackLatest("PeerNetworkMetrics");
+}
+
+ACTOR Future<Void> peerNetworkMetricsLogger(TransportData* self) {
+	state double lastLoggedTime = now();
+	loop {
+		wait(delay(FLOW_KNOBS->PEER_METRICS_LOGGING_INTERVAL));
+		logPeerNetworkMetrics(self, now() - lastLoggedTime);
+		lastLoggedTime = now();
+	}
+}
+
 TransportData::TransportData(uint64_t transportId, int maxWellKnownEndpoints, IPAllowList const* allowList)
   : endpoints(maxWellKnownEndpoints), endpointNotFoundReceiver(endpoints), pingReceiver(endpoints),
     numIncompatibleConnections(0), lastIncompatibleMessage(0), transportId(transportId),
     allowList(allowList == nullptr ? IPAllowList() : *allowList) {
 	degraded = makeReference<AsyncVar<bool>>(false);
 	pingLogger = pingLatencyLogger(this);
+	peerMetricsLogger = peerNetworkMetricsLogger(this);
 }
 
 #define CONNECT_PACKET_V0 0x0FDB00A444020001LL
@@ -536,7 +467,7 @@ ACTOR Future<Void> connectionMonitor(Reference<Peer> peer) {
 		// cancelled.
 		wait(delay(0, TaskPriority::ReadSocket));
 
-		if (peer->reliable.empty() && peer->unsent.empty() && peer->outstandingReplies == 0) {
+		if (peer->reliable.empty() && !peer->hasUnsent() && peer->outstandingReplies == 0) {
 			if (peer->peerReferences == 0 &&
 			    (peer->lastDataPacketSentTime < now() - FLOW_KNOBS->CONNECTION_MONITOR_UNREFERENCED_CLOSE_DELAY)) {
 				// TODO: What about when peerReference == -1?
@@ -561,9 +492,11 @@ ACTOR Future<Void> connectionMonitor(Reference<Peer> peer) {
 			choose {
 				when(wait(delay(FLOW_KNOBS->CONNECTION_MONITOR_TIMEOUT))) {
 					peer->timeoutCount++;
+					peer->recentTimeouts++;
 					if (startingBytes == peer->bytesReceived) {
 						if (peer->destination.isPublic()) {
 							peer->pingLatencies.addSample(now() - startTime);
+							peer->recentPingLatencies.addSample(now() - startTime);
 						}
 						TraceEvent("ConnectionTimeout").suppressFor(1.0).detail("WithAddr", peer->destination);
 						throw connection_failed();
@@ -580,6 +513,7 @@ ACTOR Future<Void> connectionMonitor(Reference<Peer> peer) {
 				when(wait(pingRequest.reply.getFuture())) {
 					if (peer->destination.isPublic()) {
 						peer->pingLatencies.addSample(now() - startTime);
+						peer->recentPingLatencies.addSample(now() - startTime);
 					}
 					break;
 				}
@@ -596,34 +530,51 @@ ACTOR Future<Void> connectionWriter(Reference<Peer> self, Reference<IConnection>
 	loop {
 		// wait( delay(0, TaskPriority::WriteSocket) );
 		wait(delayJittered(
-		    std::max<double>(FLOW_KNOBS->MIN_COALESCE_DELAY, FLOW_KNOBS->MAX_COALESCE_DELAY - (now() - lastWriteTime)),
+		    std::max<double>(FLOW_KNOBS->MIN_COALESCE_DELAY, self->coalesceDelay - (now() - lastWriteTime)),
 		    TaskPriority::WriteSocket));
 		// wait( delay(500e-6, TaskPriority::WriteSocket) );
 		// wait( yield(TaskPriority::WriteSocket) );
 
+		state int64_t flushBytes = self->bytesSent;
+		state int64_t flushPackets = self->packetsQueued;
+
 		// Send until there is nothing left to send
 		loop {
 			lastWriteTime = now();
 
-			int sent = conn->write(self->unsent.getUnsent(), /* limit= */ FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
+			bool priority = self->priorityReady();
+			int limit = priority ? FLOW_KNOBS->MAX_PACKET_SEND_BYTES
+			                     : self->unsentWriteLimit(FLOW_KNOBS->MAX_PACKET_SEND_BYTES);
+			int sent = conn->write(priority ? self->unsentPriority.getUnsent() : self->unsent.getUnsent(), limit);
+			++self->writes;
 			if (sent) {
 				self->bytesSent += sent;
 				self->transport->bytesSent += sent;
-				self->unsent.sent(sent);
+				if (priority) {
+					self->unsentPriority.sent(sent);
+				} else {
+					self->unsent.sent(sent);
+					self->sentUnsent(sent);
+				}
 			}
 
-			if (self->unsent.empty()) {
+			if (!self->hasUnsent()) {
 				break;
 			}
+			if (!priority && sent == limit && !self->unsentPriority.empty()) {
+				// Stopped at a packet boundary so that the priority packets go next
+				continue;
+			}
 
 			CODE_PROBE(
 			    true, "We didn't write everything, so apparently the write buffer is full.  Wait for it to be nonfull");
 			wait(conn->onWritable());
 			wait(yield(TaskPriority::WriteSocket));
 		}
+		self->adaptCoalesceDelay(self->bytesSent - flushBytes, self->packetsQueued - flushPackets);
 
 		// Wait until there is something to send
-		while (self->unsent.empty())
+		while (!self->hasUnsent())
 			wait(self->dataToSend.onTrigger());
 	}
 }
@@ -671,7 +622,7 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 			if (!conn) { // Always, except for the first loop with an incoming connection
 				self->outgoingConnectionIdle = true;
 				// Wait until there is something to send.
-				while (self->unsent.empty()) {
+				while (!self->hasUnsent()) {
 					// Override waiting, if we are in failed state to update failure monitoring status.
 					Future<Void> retryConnectF = Never();
 					if (retryConnect) {
@@ -714,7 +665,7 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 							if (FlowTransport::isClient()) {
 								IFailureMonitor::failureMonitor().setStatus(self->destination, FailureStatus(false));
 							}
-							if (self->unsent.empty()) {
+							if (!self->hasUnsent()) {
 								delayedHealthUpdateF =
 								    delayedHealthUpdate(self->destination, &tooManyConnectionsClosed);
 								choose {
@@ -890,7 +841,7 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 				throw;
 			// Try to recover, even from serious errors, by retrying
 
-			if (self->peerReferences <= 0 && self->reliable.empty() && self->unsent.empty() &&
+			if (self->peerReferences <= 0 && self->reliable.empty() && !self->hasUnsent() &&
 			    self->outstandingReplies == 0) {
 				TraceEvent("PeerDestroy")
 				    .errorUnsuppressed(e)
@@ -909,23 +860,108 @@ ACTOR Future<Void> connectionKeeper(Reference<Peer> self,
 Peer::Peer(TransportData* transport, NetworkAddress const& destination)
   : transport(transport), destination(destination), compatible(true), connected(false), outgoingConnectionIdle(true),
     lastConnectTime(0.0), reconnectionDelay(FLOW_KNOBS->INITIAL_RECONNECTION_TIME), peerReferences(-1),
-    bytesReceived(0), bytesSent(0), lastDataPacketSentTime(now()), outstandingReplies(0),
+    bytesReceived(0), bytesSent(0), packetsQueued(0), writes(0), coalesceDelay(FLOW_KNOBS->MAX_COALESCE_DELAY),
+    lastDataPacketSentTime(now()), outstandingReplies(0),
     pingLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1), lastLoggedTime(0.0),
-    lastLoggedBytesReceived(0), lastLoggedBytesSent(0), timeoutCount(0),
+    lastLoggedBytesReceived(0), lastLoggedBytesSent(0), lastLoggedWrites(0), timeoutCount(0),
+    recentPingLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1), lastReportedBytesReceived(0),
+    lastReportedBytesSent(0), recentTimeouts(0),
     protocolVersion(Reference<AsyncVar<Optional<ProtocolVersion>>>(new AsyncVar<Optional<ProtocolVersion>>())),
     connectOutgoingCount(0), connectIncomingCount(0), connectFailedCount(0),
     connectLatencies(destination.isPublic() ? FLOW_KNOBS->PING_SKETCH_ACCURACY : 0.1) {
 	IFailureMonitor::failureMonitor().setStatus(destination, FailureStatus(false));
 }
 
-void Peer::send(PacketBuffer* pb, ReliablePacket* rp, bool firstUnsent) {
-	unsent.setWriteBuffer(pb);
+UnsentPacketQueue& Peer::queueFor(Endpoint::Token const& token) {
+	if (FLOW_KNOBS->PEER_PRIORITY_LANE_MIN_PRIORITY > 0 && connected &&
+	    g_network->getCurrentTask() >= static_cast<TaskPriority>(FLOW_KNOBS->PEER_PRIORITY_LANE_MIN_PRIORITY) &&
+	    !unsentPacketsByToken.contains(token)) {
+		return unsentPriority;
+	}
+	return unsent;
+}
+
+void Peer::send(UnsentPacketQueue& queue,
+                PacketBuffer* pb,
+                ReliablePacket* rp,
+                bool firstUnsent,
+                Endpoint::Token const& token,
+                int bytes) {
+	queue.setWriteBuffer(pb);
+	++packetsQueued;
+	if (&queue == &unsent && FLOW_KNOBS->PEER_PRIORITY_LANE_MIN_PRIORITY > 0) {
+		unsentBytesQueued += bytes;
+		unsentPacketEnds.emplace_back(unsentBytesQueued, token);
+		++unsentPacketsByToken[token];
+	}
 	if (rp)
 		reliable.insert(rp);
 	if (firstUnsent)
 		dataToSend.trigger();
 }
 
+bool Peer::priorityReady() const {
+	if (unsentPriority.empty()) {
+		return false;
+	}
+	// Only between whole packets of unsent, and never ahead of bytes not sent through send()
+	return unsent.empty() || (!unsentPacketEnds.empty() && unsentBytesSent == unsentPacketBegin &&
+	                          unsentPacketEnds.front().second.present());
+}
+
+int Peer::unsentWriteLimit(int limit) const {
+	if (unsentPriority.empty() || unsentPacketEnds.empty()) {
+		return limit;
+	}
+	return std::min<int64_t>(limit, unsentPacketEnds.front().first - unsentBytesSent);
+}
+
+void Peer::sentUnsent(int bytes) {
+	if (FLOW_KNOBS->PEER_PRIORITY_LANE_MIN_PRIORITY <= 0) {
+		return;
+	}
+	unsentBytesSent += bytes;
+	while (!unsentPacketEnds.empty() && unsentPacketEnds.front().first <= unsentBytesSent) {
+		unsentPacketBegin = unsentPacketEnds.front().first;
+		if (unsentPacketEnds.front().second.present()) {
+			auto it = unsentPacketsByToken.find(unsentPacketEnds.front().second.get());
+			if (--it->second == 0) {
+				unsentPacketsByToken.erase(it);
+			}
+		}
+		unsentPacketEnds.pop_front();
+	}
+}
+
+void Peer::adaptCoalesceDelay(int64_t bytes, int64_t packets) {
+	if (FLOW_KNOBS->ADAPTIVE_COALESCE_MAX_DELAY <= FLOW_KNOBS->MAX_COALESCE_DELAY) {
+		coalesceDelay = FLOW_KNOBS->MAX_COALESCE_DELAY;
+	} else if (packets > 1 && bytes < FLOW_KNOBS->ADAPTIVE_COALESCE_TARGET_BYTES) {
+		// Waiting gathered several packets but still too few bytes to fill a write, so wait a little longer
+		coalesceDelay = std::min(FLOW_KNOBS->ADAPTIVE_COALESCE_MAX_DELAY, coalesceDelay * 1.25 + 1e-6);
+	} else {
+		// Either writes are already full, or packets come too rarely for waiting to gather more of them
+		coalesceDelay = std::max(FLOW_KNOBS->MAX_COALESCE_DELAY, coalesceDelay * 0.5);
+	}
+}
+
+void Peer::resetUnsentPackets() {
+	if (FLOW_KNOBS->PEER_PRIORITY_LANE_MIN_PRIORITY <= 0) {
+		return;
+	}
+	int64_t bytes = 0;
+	for (PacketBuffer* pb = unsent.getUnsent(); pb; pb = pb->nextPacketBuffer()) {
+		bytes += pb->bytes_unsent();
+	}
+	unsentPacketEnds.clear();
+	unsentPacketsByToken.clear();
+	unsentPacketBegin = unsentBytesSent;
+	unsentBytesQueued = unsentBytesSent + bytes;
+	if (bytes) {
+		unsentPacketEnds.emplace_back(unsentBytesQueued, Optional<Endpoint::Token>());
+	}
+}
+
 void Peer::prependConnectPacket() {
 	// Send the ConnectPacket expected at the beginning of a new connection
 	ConnectPacket pkt;
@@ -960,12 +996,14 @@ void Peer::prependConnectPacket() {
 	}
 #endif
 	unsent.prependWriteBuffer(pb_first, pb_end);
+	resetUnsentPackets();
 }
 
 void Peer::discardUnreliablePackets() {
 	// Throw away the current unsent list, dropping the reference count on each PacketBuffer that accounts for presence
 	// in the unsent list
 	unsent.discardAll();
+	unsentPriority.discardAll();
 
 	// If there are reliable packets, compact reliable packets into a new unsent range
 	if (!reliable.empty()) {
@@ -973,6 +1011,7 @@ void Peer::discardUnreliablePackets() {
 		pb = reliable.compact(pb, nullptr);
 		unsent.setWriteBuffer(pb);
 	}
+	resetUnsentPackets();
 }
 
 void Peer::onIncomingConnection(Reference<Peer> self, Reference<IConnection> conn, Future<Void> reader) {
@@ -1178,6 +1217,10 @@ static void scanPackets(TransportData* transport,
 			}
 		}
 
+		// The packet starts with its token, whose lower 32 bits index the endpoint table. Start loading that entry
+		// now so that it is in cache by the time the packet has been checksummed and the token is looked up.
+		transport->endpoints.prefetch(*(uint32_t*)(p + sizeof(uint64_t)));
+
 		if (checksumEnabled) {
 			bool isBuggifyEnabled = false;
 			if (g_network->isSimulated() && !isStableConnection &&
@@ -1267,6 +1310,19 @@ static void scanPackets(TransportData* transport,
 	}
 }
 
+// True if the unprocessed bytes [begin, end) of the buffer starting at bufferBegin would survive being moved to the
+// front of a new buffer of the given length allocated in the same place
+static bool canMoveIntoPacketBuffer(const uint8_t* bufferBegin, const uint8_t* begin, const uint8_t* end, int len) {
+	if (!bufferBegin)
+		return false;
+#if VALGRIND
+	// Resetting the arena marks its old contents inaccessible, so only reuse a buffer with nothing to move
+	return begin == end;
+#else
+	return end <= bufferBegin + len;
+#endif
+}
+
 // Given unprocessed buffer [begin, end), check if next packet size is known and return
 // enough size for the next packet, whose format is: {size, optional_checksum, data} +
 // next_packet_size.
@@ -1297,6 +1353,7 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
                                            Promise<Reference<Peer>> onConnected) {
 
 	state Arena arena;
+	state uint8_t* buffer_begin = nullptr;
 	state uint8_t* unprocessed_begin = nullptr;
 	state uint8_t* unprocessed_end = nullptr;
 	state uint8_t* buffer_end = nullptr;
@@ -1316,15 +1373,30 @@ ACTOR static Future<Void> connectionReader(TransportData* transport,
 			loop {
 				state int readAllBytes = buffer_end - unprocessed_end;
 				if (readAllBytes < FLOW_KNOBS->MIN_PACKET_BUFFER_FREE_BYTES) {
-					Arena newArena;
 					const int unproc_len = unprocessed_end - unprocessed_begin;
 					const int len =
 					    getNewBufferSize(unprocessed_begin, unprocessed_end, peerAddress, peerProtocolVersion);
-					uint8_t* const newBuffer = new (newArena) uint8_t[len];
-					if (unproc_len > 0) {
-						memcpy(newBuffer, unprocessed_begin, unproc_len);
+					uint8_t* newBuffer = nullptr;
+					// Every message delivered out of the buffer holds a reference to its arena. Once they have all
+					// been dropped the same block can take the next buffer, with any partial packet moved down to the
+					// front of it, instead of allocating a new one per buffer.
+					if (FLOW_KNOBS->REUSE_PACKET_BUFFERS &&
+					    canMoveIntoPacketBuffer(buffer_begin, unprocessed_begin, unprocessed_end, len) &&
+					    arena.tryReset() && arena.hasFree(len, buffer_begin)) {
+						newBuffer = new (arena) uint8_t[len];
+						ASSERT(newBuffer == buffer_begin);
+						if (unproc_len > 0) {
+							memmove(newBuffer, unprocessed_begin, unproc_len);
+						}
+					} else {
+						Arena newArena;
+						newBuffer = new (newArena) uint8_t[len];
+						if (unproc_len > 0) {
+							memcpy(newBuffer, unprocessed_begin, unproc_len);
+						}
+						arena = newArena;
 					}
-					arena = newArena;
+					buffer_begin = newBuffer;
 					unprocessed_begin = newBuffer;
 					unprocessed_end = newBuffer + unproc_len;
 					buffer_end = newBuffer + len;
@@ -1740,7 +1812,7 @@ void FlowTransport::removePeerReference(const Endpoint& endpoint, bool isStream)
 			    .detail("Address", endpoint.getPrimaryAddress())
 			    .detail("Token", endpoint.token);
 		}
-		if (peer->peerReferences == 0 && peer->reliable.empty() && peer->unsent.empty() &&
+		if (peer->peerReferences == 0 && peer->reliable.empty() && !peer->hasUnsent() &&
 		    peer->outstandingReplies == 0 &&
 		    peer->lastDataPacketSentTime < now() - FLOW_KNOBS->CONNECTION_MONITOR_UNREFERENCED_CLOSE_DELAY) {
 			peer->resetPing.trigger();
@@ -1815,9 +1887,10 @@ static ReliablePacket* sendPacket(TransportData* self,
 		return nullptr;
 	}
 
-	bool firstUnsent = peer->unsent.empty();
+	bool firstUnsent = !peer->hasUnsent();
 
-	PacketBuffer* pb = peer->unsent.getWriteBuffer();
+	UnsentPacketQueue& queue = peer->queueFor(destination.token);
+	PacketBuffer* pb = queue.getWriteBuffer();
 	ReliablePacket* rp = reliable ? new ReliablePacket : 0;
 
 	int prevBytesWritten = pb->bytes_written;
@@ -1926,7 +1999,7 @@ static ReliablePacket* sendPacket(TransportData* self,
 	}
 #endif
 
-	peer->send(pb, rp, firstUnsent);
+	peer->send(queue, pb, rp, firstUnsent, destination.token, len + packetInfoSize);
 	if (destination.token != Endpoint::wellKnownToken(WLTOKEN_PING_PACKET)) {
 		peer->lastDataPacketSentTime = now();
 	}
@@ -0,0 +1,191 @@
+/*
+ * MetricsHttpServer.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbrpc/MetricsHttpServer.h"
+#include "fdbrpc/HTTP.h"
+#include "fdbrpc/Stats.h"
+#include "flow/Histogram.h"
+#include "flow/Trace.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace {
+
+// "StorageMetrics" -> "storage_metrics", "DDTracker" -> "dd_tracker". Anything that isn't valid in a metric name
+// becomes an underscore.
+std::string metricNamePart(std::string const& name) {
+	std::string result;
+	for (int i = 0; i < name.size(); i++) {
+		uint8_t c = name[i];
+		if (isupper(c)) {
+			bool afterLower = i > 0 && (islower((uint8_t)name[i - 1]) || isdigit((uint8_t)name[i - 1]));
+			bool endsAcronym =
+			    i > 0 && isupper((uint8_t)name[i - 1]) && i + 1 < name.size() && islower((uint8_t)name[i + 1]);
+			if (afterLower || endsAcronym) {
+				result.push_back('_');
+			}
+			result.push_back(tolower(c));
+		} else if (islower(c) || isdigit(c)) {
+			result.push_back(c);
+		} else {
+			result.push_back('_');
+		}
+	}
+	return result;
+}
+
+std::string escapeLabelValue(std::string const& value) {
+	std::string result;
+	for (char c : value) {
+		if (c == '\\' || c == '"') {
+			result.push_back('\\');
+			result.push_back(c);
+		} else if (c == '\n') {
+			result += "\\n";
+		} else {
+			result.push_back(c);
+		}
+	}
+	return result;
+}
+
+struct MetricFamily {
+	std::string type;
+	std::vector<std::string> samples;
+};
+
+} // namespace
+
+std::string renderOpenMetrics() {
+	// Several collections (e.g. one per storage server) share a family, which must be written out in one piece
+	std::map<std::string, MetricFamily> families;
+
+	for (auto const& [_, traced] : getTracedCounterCollections()) {
+		std::string prefix = "fdb_" + metricNamePart(traced.traceEventName) + "_";
+		std::string labels = format("{id=\"%s\"}", escapeLabelValue(traced.traceEventID.toString()).c_str());
+		for (ICounter const* counter : traced.counters->getCounters()) {
+			std::string name = prefix + metricNamePart(counter->getName());
+			MetricFamily& family = families[name];
+			if (counter->hasRate()) {
+				family.type = "counter";
+				family.samples.push_back(name + "_total" + labels + format(" %lld", (long long)counter->getValue()));
+			} else {
+				family.type = "gauge";
+				family.samples.push_back(name + labels + format(" %lld", (long long)counter->getValue()));
+			}
+		}
+	}
+
+	for (auto const& [_, histogram] : GetHistogramRegistry().getHistograms()) {
+		std::string name = "fdb_histogram_" + metricNamePart(histogram->group) + "_" + metricNamePart(histogram->op);
+		std::string unit = Histogram::UnitToStringMapper[(size_t)histogram->unit];
+		MetricFamily& family = families[name];
+		family.type = "histogram";
+		uint64_t cumulative = 0;
+		for (uint32_t i = 0; i < 32; i++) {
+			cumulative += histogram->cumulativeCount(i);
+			family.samples.push_back(name +
+			                         format("_bucket{unit=\"%s\",le=\"%s\"} %" PRIu64,
+			                                unit.c_str(),
+			                                histogram->bucketUpperBound(i).c_str(),
+			                                cumulative));
+		}
+		family.samples.push_back(name + format("_bucket{unit=\"%s\",le=\"+Inf\"} %" PRIu64, unit.c_str(), cumulative));
+		family.samples.push_back(name + format("_count{unit=\"%s\"} %" PRIu64, unit.c_str(), cumulative));
+	}
+
+	std::string result;
+	for (auto const& [name, family] : families) {
+		result += "# TYPE " + name + " " + family.type + "\n";
+		for (auto const& sample : family.samples) {
+			result += sample + "\n";
+		}
+	}
+	result += "# EOF\n";
+	return result;
+}
+
+struct MetricsRequestHandler final : HTTP::IRequestHandler, ReferenceCounted<MetricsRequestHandler> {
+	Future<Void> handleRequest(Reference<HTTP::IncomingRequest> req,
+	                           Reference<HTTP::OutgoingResponse> response) override {
+		std::string body;
+		bool metricsPage = req->resource == "/metrics" || req->resource.rfind("/metrics?", 0) == 0;
+		if (req->verb == HTTP::HTTP_VERB_GET && metricsPage) {
+			body = renderOpenMetrics();
+			response->code = 200;
+			response->data.headers["Content-Type"] = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+		} else {
+			body = "Not Found\n";
+			response->code = 404;
+			response->data.headers["Content-Type"] = "text/plain";
+		}
+		PacketWriter pw(response->data.content->getWriteBuffer(body.size()), nullptr, Unversioned());
+		pw.serializeBytes(body);
+		response->data.contentLen = body.size();
+		return Void();
+	}
+	Reference<HTTP::IRequestHandler> clone() override { return makeReference<MetricsRequestHandler>(); }
+
+	void addref() override { ReferenceCounted<MetricsRequestHandler>::addref(); }
+	void delref() override { ReferenceCounted<MetricsRequestHandler>::delref(); }
+};
+
+ACTOR Future<Void> metricsHttpServer(NetworkAddress address) {
+	state Reference<HTTP::SimServerContext> server = makeReference<HTTP::SimServerContext>();
+	try {
+		server->registerNewServer(address, makeReference<MetricsRequestHandler>());
+		TraceEvent("MetricsHttpServerStarted", server->dbgid).detail("Address", address);
+		wait(server->actors.getResult());
+	} catch (Error& e) {
+		if (e.code() != error_code_actor_cancelled) {
+			TraceEvent(SevWarnAlways, "MetricsHttpServerError", server->dbgid)
+			    .errorUnsuppressed(e)
+			    .detail("Address", address);
+		}
+		server->stop();
+		throw;
+	}
+	return Void();
+}
+
+TEST_CASE("/fdbrpc/MetricsHttpServer/render") {
+	state CounterCollection cc("TestMetrics");
+	state Counter requests("Requests", cc);
+	specialCounter(cc, "QueueSize", []() { return 7; });
+	requests += 3;
+	state UID id(1, 2);
+	state Future<Void> traced = cc.traceCounters("TestMetrics", id, 1000.0);
+
+	std::string metrics = renderOpenMetrics();
+	std::string labels = format("{id=\"%s\"}", id.toString().c_str());
+	ASSERT(metrics.find("# TYPE fdb_test_metrics_requests counter\n") != std::string::npos);
+	ASSERT(metrics.find("\nfdb_test_metrics_requests_total" + labels + " 3\n") != std::string::npos);
+	ASSERT(metrics.find("# TYPE fdb_test_metrics_queue_size gauge\n") != std::string::npos);
+	ASSERT(metrics.find("\nfdb_test_metrics_queue_size" + labels + " 7\n") != std::string::npos);
+	ASSERT(metrics.size() >= 6 && metrics.substr(metrics.size() - 6) == "# EOF\n");
+
+	ASSERT_EQ(metricNamePart("DDTrackerStats"), "dd_tracker_stats");
+	ASSERT_EQ(metricNamePart("Read.Latency"), "read_latency");
+
+	// The collection drops out once it is no longer being traced
+	traced.cancel();
+	ASSERT(renderOpenMetrics().find("fdb_test_metrics_requests") == std::string::npos);
+	return Void();
+}
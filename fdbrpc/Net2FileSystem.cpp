@@ -41,10 +41,24 @@
 #include "fdbrpc/AsyncFileEncrypted.h"
 #include "fdbrpc/AsyncFileWinASIO.actor.h"
 #include "fdbrpc/AsyncFileKAIO.actor.h"
+#include "fdbrpc/AsyncFileIOUring.actor.h"
 #include "flow/AsioReactor.h"
 #include "flow/Platform.h"
 #include "fdbrpc/AsyncFileWriteChecker.actor.h"
 
+#if defined(__linux__) && defined(WITH_LIBURING)
+// Both native backends batch their submissions once per run loop iteration
+static void launchNativeAsyncIO() {
+	AsyncFileKAIO::launch();
+	AsyncFileIOUring::launch();
+}
+
+static bool useIOUring(int64_t flags) {
+	return AsyncFileIOUring::isInitialized() &&
+	       (FLOW_KNOBS->USE_IO_URING >= 2 || (flags & IAsyncFile::OPEN_IO_URING));
+}
+#endif
+
 // Opens a file for asynchronous I/O
 Future<Reference<class IAsyncFile>> Net2FileSystem::open(const std::string& filename, int64_t flags, int64_t mode) {
 #ifdef __linux__
@@ -71,8 +85,15 @@ Future<Reference<class IAsyncFile>> Net2FileSystem::open(const std::string& file
 	// cases, DISABLE_POSIX_KERNEL_AIO knob can be enabled to fallback to EIO instead
 	// of Kernel AIO. And EIO_USE_ODIRECT can be used to turn on or off O_DIRECT within
 	// EIO.
-	if ((flags & IAsyncFile::OPEN_UNBUFFERED) && !(flags & IAsyncFile::OPEN_NO_AIO) &&
-	    !FLOW_KNOBS->DISABLE_POSIX_KERNEL_AIO)
+	// USE_IO_URING selects AsyncFileIOUring instead, either for every such file or only for those opened with
+	// OPEN_IO_URING.
+	bool nativeAIO = (flags & IAsyncFile::OPEN_UNBUFFERED) && !(flags & IAsyncFile::OPEN_NO_AIO);
+#ifdef WITH_LIBURING
+	if (nativeAIO && useIOUring(flags))
+		f = AsyncFileIOUring::open(filename, flags, mode, nullptr);
+	else
+#endif
+	if (nativeAIO && !FLOW_KNOBS->DISABLE_POSIX_KERNEL_AIO)
 		f = AsyncFileKAIO::open(filename, flags, mode, nullptr);
 	else
 #endif
@@ -120,6 +141,21 @@ Net2FileSystem::Net2FileSystem(double ioTimeout, const std::string& fileSystemPa
 	if (!FLOW_KNOBS->DISABLE_POSIX_KERNEL_AIO)
 		AsyncFileKAIO::init(Reference<IEventFD>(N2::ASIOReactor::getEventFD()), ioTimeout);
 
+#ifdef WITH_LIBURING
+	if (FLOW_KNOBS->USE_IO_URING) {
+		// The ring gets its own eventfd so that KAIO and io_uring completions can be reaped independently
+		try {
+			AsyncFileIOUring::init(Reference<IEventFD>(N2::ASIOReactor::newEventFD(*static_cast<boost::asio::io_service*>(
+			                           (void*)g_network->global(INetwork::enASIOService)))),
+			                       ioTimeout);
+			g_network->setGlobal(INetwork::enRunCycleFunc, (flowGlobalType)&launchNativeAsyncIO);
+		} catch (Error& e) {
+			// Older kernels (or seccomp profiles) may not allow io_uring; keep using KAIO/EIO in that case
+			TraceEvent(SevWarnAlways, "IOUringUnavailable").error(e);
+		}
+	}
+#endif
+
 	if (fileSystemPath.empty()) {
 		checkFileSystem = false;
 	} else {
@@ -20,6 +20,25 @@
 
 #include "fdbrpc/QueueModel.h"
 #include "fdbrpc/LoadBalance.h"
+#include "flow/UnitTest.h"
+
+// Finding a quantile walks all of the sketch's buckets, so the hedge latency is only recomputed every
+// LOAD_BALANCE_HEDGE_MIN_SAMPLES replies. The sketch is restarted after a full window so old latencies age out, while
+// the last computed hedge latency stays in use until the new window has enough samples.
+static void addLatencySample(QueueData& d, double latency) {
+	if (!d.latencySketch) {
+		d.latencySketch = std::make_unique<DDSketch<double>>(FLOW_KNOBS->LOAD_BALANCE_HEDGE_SKETCH_ERROR);
+	}
+	d.latencySketch->addSample(latency);
+
+	uint64_t samples = d.latencySketch->getPopulationSize();
+	if (samples % FLOW_KNOBS->LOAD_BALANCE_HEDGE_MIN_SAMPLES == 0) {
+		d.hedgeLatency = d.latencySketch->percentile(FLOW_KNOBS->LOAD_BALANCE_HEDGE_QUANTILE);
+		if (samples >= FLOW_KNOBS->LOAD_BALANCE_HEDGE_WINDOW_SAMPLES) {
+			d.latencySketch->clear();
+		}
+	}
+}
 
 void QueueModel::endRequest(uint64_t id, double latency, double penalty, double delta, bool clean, bool futureVersion) {
 	auto& d = data[id];
@@ -29,6 +48,9 @@ void QueueModel::endRequest(uint64_t id, double latency, double penalty, double
 
 	if (clean) {
 		d.latency = latency;
+		if (FLOW_KNOBS->LOAD_BALANCE_HEDGE_QUANTILE > 0) {
+			addLatencySample(d, latency);
+		}
 	} else {
 		d.latency = std::max(d.latency, latency);
 	}
@@ -60,6 +82,22 @@ double QueueModel::addRequest(uint64_t id) {
 	return d.penalty;
 }
 
+void QueueModel::updateLoad(uint64_t id, int64_t versionLag, double busyness) {
+	auto& d = data[id];
+	d.versionLag = versionLag;
+	d.busyness = busyness;
+	d.loadTime = now();
+}
+
+double QueueData::loadPenalty() const {
+	if (now() - loadTime > FLOW_KNOBS->LOAD_BALANCE_SERVER_LOAD_EXPIRATION) {
+		return 0;
+	}
+	double lag = std::min(1.0, std::max<double>(0, versionLag) / FLOW_KNOBS->LOAD_BALANCE_LAGGING_VERSIONS);
+	double busy = std::min(1.0, std::max(0.0, busyness));
+	return lag * FLOW_KNOBS->LOAD_BALANCE_LAGGING_PENALTY + busy * FLOW_KNOBS->LOAD_BALANCE_BUSYNESS_PENALTY;
+}
+
 void QueueModel::updateTssEndpoint(uint64_t endpointId, const TSSEndpointData& tssData) {
 	auto& d = data[endpointId];
 	d.tssData = tssData;
@@ -82,6 +120,12 @@ Optional<LoadBalancedReply> getLoadBalancedReply(const void*) {
 	return Optional<LoadBalancedReply>();
 }
 
+void setReplicaDistance(LoadBalancedReply* reply, LBDistance::Type distance) {
+	reply->replicaDistance = distance;
+}
+
+void setReplicaDistance(void*, LBDistance::Type distance) {}
+
 Optional<BasicLoadBalancedReply> getBasicLoadBalancedReply(const BasicLoadBalancedReply* reply) {
 	return *reply;
 }
@@ -90,6 +134,77 @@ Optional<BasicLoadBalancedReply> getBasicLoadBalancedReply(const void*) {
 	return Optional<BasicLoadBalancedReply>();
 }
 
+TEST_CASE("/fdbrpc/QueueModel/hedgeLatency") {
+	if (FLOW_KNOBS->LOAD_BALANCE_HEDGE_QUANTILE <= 0) {
+		return Void();
+	}
+
+	QueueModel model;
+	const uint64_t id = 1;
+	const int window = FLOW_KNOBS->LOAD_BALANCE_HEDGE_WINDOW_SAMPLES;
+	const double tolerance = 2 * FLOW_KNOBS->LOAD_BALANCE_HEDGE_SKETCH_ERROR;
+	ASSERT_EQ(model.getMeasurement(id).hedgeLatency, 0.0);
+
+	// Latencies uniform in (0, 10ms]
+	for (int i = 1; i <= window; i++) {
+		model.endRequest(id, 0.01 * deterministicRandom()->random01() + 1e-6, 1.0, model.addRequest(id), true, false);
+	}
+	double expected = 0.01 * FLOW_KNOBS->LOAD_BALANCE_HEDGE_QUANTILE;
+	double hedgeLatency = model.getMeasurement(id).hedgeLatency;
+	ASSERT(hedgeLatency > expected * (1 - tolerance) - 0.001 && hedgeLatency < expected * (1 + tolerance) + 0.001);
+
+	// Errors are not measured, and the last hedge latency is kept until the next window has enough samples
+	for (int i = 0; i < window; i++) {
+		model.endRequest(id, 1.0, 1.0, model.addRequest(id), false, false);
+	}
+	for (int i = 1; i < FLOW_KNOBS->LOAD_BALANCE_HEDGE_MIN_SAMPLES; i++) {
+		model.endRequest(id, 0.1, 1.0, model.addRequest(id), true, false);
+	}
+	ASSERT_EQ(model.getMeasurement(id).hedgeLatency, hedgeLatency);
+
+	// Once it does, only the new window's latencies count
+	model.endRequest(id, 0.1, 1.0, model.addRequest(id), true, false);
+	hedgeLatency = model.getMeasurement(id).hedgeLatency;
+	ASSERT(hedgeLatency > 0.1 * (1 - tolerance) && hedgeLatency < 0.1 * (1 + tolerance));
+
+	return Void();
+}
+
+TEST_CASE("/fdbrpc/QueueModel/loadPenalty") {
+	QueueModel model;
+	ASSERT_EQ(model.getMeasurement(1).loadPenalty(), 0.0);
+
+	model.updateLoad(1, 0, 0.0);
+	ASSERT_EQ(model.getMeasurement(1).loadPenalty(), 0.0);
+
+	// Version lag counts in proportion up to LOAD_BALANCE_LAGGING_VERSIONS
+	model.updateLoad(1, FLOW_KNOBS->LOAD_BALANCE_LAGGING_VERSIONS / 2, 0.0);
+	model.updateLoad(2, FLOW_KNOBS->LOAD_BALANCE_LAGGING_VERSIONS * 10, 0.0);
+	model.updateLoad(3, 0, 1.0);
+	ASSERT_EQ(model.getMeasurement(1).loadPenalty(), FLOW_KNOBS->LOAD_BALANCE_LAGGING_PENALTY / 2);
+	ASSERT_EQ(model.getMeasurement(2).loadPenalty(), FLOW_KNOBS->LOAD_BALANCE_LAGGING_PENALTY);
+	ASSERT_EQ(model.getMeasurement(3).loadPenalty(), FLOW_KNOBS->LOAD_BALANCE_BUSYNESS_PENALTY);
+
+	return Void();
+}
+
+TEST_CASE("/fdbrpc/QueueModel/replicaDistance") {
+	struct TestReply : LoadBalancedReply {
+		int value = 0;
+	};
+	TestReply reply;
+	ASSERT_EQ(reply.replicaDistance, LBDistance::DISTANT);
+	setReplicaDistance(&reply, LBDistance::SAME_MACHINE);
+	ASSERT_EQ(reply.replicaDistance, LBDistance::SAME_MACHINE);
+
+	// Replies which aren't load balanced are left alone
+	int other = 1;
+	setReplicaDistance(&other, LBDistance::SAME_MACHINE);
+	ASSERT_EQ(other, 1);
+
+	return Void();
+}
+
 /*
 void QueueModel::addMeasurement( uint64_t id, QueueDetails qd ){
     if (data[new_index].count(id))
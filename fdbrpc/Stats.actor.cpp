@@ -107,12 +107,14 @@ void CounterCollection::logToTraceEvent(TraceEvent& te) {
 				metrics->sumMap[c->id].points.back().addAttribute("ip", ip_str);
 				metrics->sumMap[c->id].points.back().addAttribute("port", port_str);
 				metrics->sumMap[c->id].points.back().startTime = logTime;
+				break;
 			}
 			case MetricsDataModel::STATSD: {
 				std::vector<std::pair<std::string, std::string>> statsd_attributes{ { "ip", ip_str },
 					                                                                { "port", port_str } };
 				metrics->statsd_message.push_back(createStatsdMessage(
-				    c->getName(), StatsDMetric::COUNTER, std::to_string(val) /*, statsd_attributes*/));
+				    name + "." + c->getName(), StatsDMetric::COUNTER, std::to_string(val) /*, statsd_attributes*/));
+				break;
 			}
 			case MetricsDataModel::NONE:
 			default: {
@@ -126,6 +128,29 @@ void CounterCollection::logToTraceEvent(TraceEvent& te) {
 	}
 }
 
+static std::map<uint64_t, TracedCounterCollection>& tracedCounterCollections() {
+	static std::map<uint64_t, TracedCounterCollection>* collections = new std::map<uint64_t, TracedCounterCollection>();
+	return *collections;
+}
+
+std::map<uint64_t, TracedCounterCollection> const& getTracedCounterCollections() {
+	return tracedCounterCollections();
+}
+
+// Keeps a collection listed for as long as the traceCounters() actor logging it is alive
+struct TracedCounterCollectionRegistration : NonCopyable {
+	uint64_t key;
+
+	TracedCounterCollectionRegistration(CounterCollection const* counters,
+	                                    std::string const& traceEventName,
+	                                    UID traceEventID) {
+		static uint64_t nextKey = 0;
+		key = ++nextKey;
+		tracedCounterCollections()[key] = TracedCounterCollection{ counters, traceEventName, traceEventID };
+	}
+	~TracedCounterCollectionRegistration() { tracedCounterCollections().erase(key); }
+};
+
 class CounterCollectionImpl {
 public:
 	ACTOR static Future<Void> traceCounters(CounterCollection* counters,
@@ -134,6 +159,7 @@ public:
 	                                        double interval,
 	                                        std::string trackLatestName,
 	                                        std::function<void(TraceEvent&)> decorator) {
+		state TracedCounterCollectionRegistration registration(counters, traceEventName, traceEventID);
 		wait(delay(0)); // Give an opportunity for all members used in special counters to be initialized
 
 		for (ICounter* c : counters->counters)
@@ -289,6 +315,7 @@ void LatencySample::logSample() {
 			createOtelGauge(p95id, name + "p95", p95);
 			createOtelGauge(p99id, name + "p99", p99);
 			createOtelGauge(p999id, name + "p99_9", p99_9);
+			break;
 		}
 		case MetricsDataModel::STATSD: {
 			std::vector<std::pair<std::string, std::string>> statsd_attributes{ { "ip", ip_str },
@@ -303,6 +330,12 @@ void LatencySample::logSample() {
 			    createStatsdMessage(name + "p99", StatsDMetric::GAUGE, std::to_string(p99) /*, statsd_attributes*/);
 			auto p999_gauge =
 			    createStatsdMessage(name + "p99.9", StatsDMetric::GAUGE, std::to_string(p99_9) /*, statsd_attributes*/);
+			metrics->statsd_message.push_back(std::move(median_gauge));
+			metrics->statsd_message.push_back(std::move(p90_gauge));
+			metrics->statsd_message.push_back(std::move(p95_gauge));
+			metrics->statsd_message.push_back(std::move(p99_gauge));
+			metrics->statsd_message.push_back(std::move(p999_gauge));
+			break;
 		}
 		case MetricsDataModel::NONE:
 		default: {
@@ -42,37 +42,44 @@ namespace bi = boost::intrusive;
 struct EvictablePage {
 	void* data;
 	int index;
+	bool referenced; // hit since the CLOCK hand last passed it
 	class Reference<struct EvictablePageCache> pageCache;
 	bi::list_member_hook<> member_hook;
 
 	virtual bool evict() = 0; // true if page was evicted, false if it isn't immediately evictable (but will be evicted
 	                          // regardless if possible)
 
-	EvictablePage(Reference<EvictablePageCache> pageCache) : data(0), index(-1), pageCache(pageCache) {}
+	EvictablePage(Reference<EvictablePageCache> pageCache)
+	  : data(0), index(-1), referenced(false), pageCache(pageCache) {}
 	virtual ~EvictablePage();
 };
 
 struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 	using List =
 	    bi::list<EvictablePage, bi::member_hook<EvictablePage, bi::list_member_hook<>, &EvictablePage::member_hook>>;
-	enum CacheEvictionType { RANDOM = 0, LRU = 1 };
+	// CLOCK keeps its pages in lruPages like LRU does, but a hit only marks the page as referenced instead of moving it
+	enum CacheEvictionType { RANDOM = 0, LRU = 1, CLOCK = 2 };
 
 	static CacheEvictionType evictionPolicyStringToEnum(const std::string& policy) {
 		std::string cep = policy;
 		std::transform(cep.begin(), cep.end(), cep.begin(), ::tolower);
-		if (cep != "random" && cep != "lru")
+		if (cep != "random" && cep != "lru" && cep != "clock")
 			throw invalid_cache_eviction_policy();
 
 		if (cep == "random")
 			return RANDOM;
+		if (cep == "clock")
+			return CLOCK;
 		return LRU;
 	}
 
 	EvictablePageCache() : pageSize(0), maxPages(0), cacheEvictionType(RANDOM) {}
 
 	explicit EvictablePageCache(int pageSize, int64_t maxSize)
-	  : pageSize(pageSize), maxPages(maxSize / pageSize),
-	    cacheEvictionType(evictionPolicyStringToEnum(FLOW_KNOBS->CACHE_EVICTION_POLICY)) {
+	  : EvictablePageCache(pageSize, maxSize, evictionPolicyStringToEnum(FLOW_KNOBS->CACHE_EVICTION_POLICY)) {}
+
+	EvictablePageCache(int pageSize, int64_t maxSize, CacheEvictionType cacheEvictionType)
+	  : pageSize(pageSize), maxPages(maxSize / pageSize), cacheEvictionType(cacheEvictionType) {
 		cacheEvictions.init("EvictablePageCache.CacheEvictions"_sr);
 	}
 
@@ -91,10 +98,12 @@ struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 	}
 
 	void updateHit(EvictablePage* page) {
-		if (RANDOM != cacheEvictionType) {
+		if (LRU == cacheEvictionType) {
 			// on a hit, update page's location in the LRU so that it's most recent (tail)
 			lruPages.erase(List::s_iterator_to(*page));
 			lruPages.push_back(*page);
+		} else if (CLOCK == cacheEvictionType) {
+			page->referenced = true;
 		}
 	}
 
@@ -110,8 +119,25 @@ struct EvictablePageCache : ReferenceCounted<EvictablePageCache> {
 					}
 				}
 			}
+		} else if (CLOCK == cacheEvictionType) {
+			if (lruPages.size() >= (uint64_t)maxPages) {
+				// The hand sits at the head of the list. Referenced pages, and pages that can't be evicted right now,
+				// go around to the tail, so a referenced page is only evicted if it is not hit again before the hand
+				// comes back to it.
+				for (int i = 0; i < FLOW_KNOBS->MAX_EVICT_ATTEMPTS && !lruPages.empty();
+				     i++) { // If we don't manage to evict anything, just go ahead and exceed the cache limit
+					EvictablePage& page = lruPages.front();
+					if (page.referenced) {
+						page.referenced = false;
+					} else if (page.evict()) {
+						++cacheEvictions;
+						break;
+					}
+					lruPages.pop_front();
+					lruPages.push_back(page);
+				}
+			}
 		} else {
-			// For now, LRU is the only other CACHE_EVICTION option
 			if (lruPages.size() >= (uint64_t)maxPages) {
 				int i = 0;
 				// try the least recently used pages first (starting at head of the LRU list)
@@ -171,7 +197,16 @@ public:
 			length = int(this->length - offset);
 			ASSERT(length >= 0);
 		}
+		sequentialReads = offset == nextSequentialOffset ? sequentialReads + 1 : 0;
+		nextSequentialOffset = offset + length;
+		if (canBypassCache(data, length, offset)) {
+			++countFileCacheReadsBypassed;
+			++countCacheReadsBypassed;
+			return uncached->read(data, length, offset);
+		}
 		auto f = read_write_impl<false>(this, static_cast<uint8_t*>(data), length, offset);
+		if (FLOW_KNOBS->PAGE_CACHE_READ_AHEAD_PAGES > 0 && sequentialReads >= FLOW_KNOBS->PAGE_CACHE_READ_AHEAD_AFTER)
+			readAhead(offset + length);
 		if (f.isReady() && !f.isError())
 			return length;
 		++countFileCacheReadsBlocked;
@@ -274,6 +309,10 @@ private:
 	int64_t currentTruncateSize;
 	Reference<IRateControl> rateControl;
 
+	// Where the next read starts if it carries on from the last one, and how many reads in a row have done so
+	int64_t nextSequentialOffset;
+	int sequentialReads;
+
 	// Map of pointers which hold page buffers for pages which have been overwritten
 	// but at the time of write there were still readZeroCopy holders.
 	std::unordered_map<void*, int> orphanedPages;
@@ -287,6 +326,8 @@ private:
 	Int64MetricHandle countFileCachePageReadsMissed;
 	Int64MetricHandle countFileCachePageReadsMerged;
 	Int64MetricHandle countFileCacheReadBytes;
+	Int64MetricHandle countFileCachePageReadAheads;
+	Int64MetricHandle countFileCacheReadsBypassed;
 
 	Int64MetricHandle countCacheFinds;
 	Int64MetricHandle countCacheReads;
@@ -297,13 +338,16 @@ private:
 	Int64MetricHandle countCachePageReadsMissed;
 	Int64MetricHandle countCachePageReadsMerged;
 	Int64MetricHandle countCacheReadBytes;
+	Int64MetricHandle countCachePageReadAheads;
+	Int64MetricHandle countCacheReadsBypassed;
 
 	AsyncFileCached(Reference<IAsyncFile> uncached,
 	                const std::string& filename,
 	                int64_t length,
 	                Reference<EvictablePageCache> pageCache)
 	  : filename(filename), uncached(uncached), length(length), prevLength(length), pageCache(pageCache),
-	    currentTruncate(Void()), currentTruncateSize(0), rateControl(nullptr) {
+	    currentTruncate(Void()), currentTruncateSize(0), rateControl(nullptr), nextSequentialOffset(-1),
+	    sequentialReads(0) {
 		if (!g_network->isSimulated()) {
 			countFileCacheWrites.init("AsyncFile.CountFileCacheWrites"_sr, filename);
 			countFileCacheReads.init("AsyncFile.CountFileCacheReads"_sr, filename);
@@ -314,6 +358,8 @@ private:
 			countFileCachePageReadsMerged.init("AsyncFile.CountFileCachePageReadsMerged"_sr, filename);
 			countFileCacheFinds.init("AsyncFile.CountFileCacheFinds"_sr, filename);
 			countFileCacheReadBytes.init("AsyncFile.CountFileCacheReadBytes"_sr, filename);
+			countFileCachePageReadAheads.init("AsyncFile.CountFileCachePageReadAheads"_sr, filename);
+			countFileCacheReadsBypassed.init("AsyncFile.CountFileCacheReadsBypassed"_sr, filename);
 
 			countCacheWrites.init("AsyncFile.CountCacheWrites"_sr);
 			countCacheReads.init("AsyncFile.CountCacheReads"_sr);
@@ -324,6 +370,8 @@ private:
 			countCachePageReadsMerged.init("AsyncFile.CountCachePageReadsMerged"_sr);
 			countCacheFinds.init("AsyncFile.CountCacheFinds"_sr);
 			countCacheReadBytes.init("AsyncFile.CountCacheReadBytes"_sr);
+			countCachePageReadAheads.init("AsyncFile.CountCachePageReadAheads"_sr);
+			countCacheReadsBypassed.init("AsyncFile.CountCacheReadsBypassed"_sr);
 		}
 	}
 
@@ -369,6 +417,12 @@ private:
 	                                    int length,
 	                                    int64_t offset);
 
+	// Starts reading in the pages that follow offset, so that a sequential reader finds them already cached
+	void readAhead(int64_t offset);
+
+	// True if a read can go straight to the uncached file without missing anything that is only in the cache
+	bool canBypassCache(void const* data, int length, int64_t offset) const;
+
 	void remove_page(AFCPage* page);
 };
 
@@ -493,6 +547,11 @@ struct AFCPage : public EvictablePage, public FastAllocated<AFCPage> {
 		return Void();
 	}
 
+	void readAhead() {
+		ASSERT(!valid && notReading.isReady());
+		notReading = readThrough(this);
+	}
+
 	ACTOR static Future<Void> readThrough(AFCPage* self) {
 		ASSERT(!self->valid);
 		state void* dst = self->data;
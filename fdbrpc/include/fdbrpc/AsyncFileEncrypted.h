@@ -27,6 +27,7 @@
 #include "flow/StreamCipher.h"
 
 #include <array>
+#include <deque>
 
 /*
  * Append-only file encrypted using AES-128-GCM.
@@ -59,10 +60,11 @@ private:
 	} readBuffers;
 
 	// Writing (append only):
-	std::unique_ptr<EncryptionStreamCipher> encryptor;
 	uint32_t currentBlock{ 0 };
 	int offsetInBlock{ 0 };
-	std::vector<unsigned char> writeBuffer;
+	std::vector<unsigned char> writeBuffer; // plaintext of currentBlock, up to offsetInBlock
+	// Writes of whole blocks, oldest first, which are encrypted off the network thread and may finish in any order
+	std::deque<Future<Void>> pendingWrites;
 	Future<Void> initialize();
 
 public:
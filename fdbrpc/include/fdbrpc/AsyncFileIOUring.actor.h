@@ -0,0 +1,699 @@
+/*
+ * AsyncFileIOUring.actor.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "flow/Platform.h"
+#if defined(__linux__) && defined(WITH_LIBURING)
+
+// When actually compiled (NO_INTELLISENSE), include the generated version of this file.  In intellisense use the source
+// version.
+#if defined(NO_INTELLISENSE) && !defined(FLOW_ASYNCFILEIOURING_ACTOR_G_H)
+#define FLOW_ASYNCFILEIOURING_ACTOR_G_H
+#include "fdbrpc/AsyncFileIOUring.actor.g.h"
+#elif !defined(FLOW_ASYNCFILEIOURING_ACTOR_H)
+#define FLOW_ASYNCFILEIOURING_ACTOR_H
+
+#include "flow/IAsyncFile.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <liburing.h>
+#include "flow/Knobs.h"
+#include "fdbrpc/Stats.h"
+#include "fdbrpc/AsyncFileEIO.actor.h"
+#include "flow/UnitTest.h"
+#include "flow/genericactors.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// An IAsyncFile on top of a single io_uring instance shared by the whole process. It follows the structure of
+// AsyncFileKAIO: operations are queued by priority, submitted in one batch per Net2 run loop iteration (see launch()),
+// and completions are reaped when the ring's registered eventfd becomes readable. Unlike KAIO, fdatasync is issued
+// through the ring instead of a helper thread, and the submission queue can optionally be drained by a kernel polling
+// thread (IO_URING_SQPOLL) so that a busy process issues no io_uring_enter() calls at all.
+class AsyncFileIOUring final : public IAsyncFile, public ReferenceCounted<AsyncFileIOUring> {
+public:
+	virtual StringRef getClassName() override { return "AsyncFileIOUring"_sr; }
+
+	struct AsyncFileIOUringMetrics {
+		LatencySample readLatencySample = { "AsyncFileIOUringReadLatency",
+			                                UID(),
+			                                FLOW_KNOBS->KAIO_LATENCY_LOGGING_INTERVAL,
+			                                FLOW_KNOBS->KAIO_LATENCY_SKETCH_ACCURACY };
+		LatencySample writeLatencySample = { "AsyncFileIOUringWriteLatency",
+			                                 UID(),
+			                                 FLOW_KNOBS->KAIO_LATENCY_LOGGING_INTERVAL,
+			                                 FLOW_KNOBS->KAIO_LATENCY_SKETCH_ACCURACY };
+		LatencySample syncLatencySample = { "AsyncFileIOUringSyncLatency",
+			                                UID(),
+			                                FLOW_KNOBS->KAIO_LATENCY_LOGGING_INTERVAL,
+			                                FLOW_KNOBS->KAIO_LATENCY_SKETCH_ACCURACY };
+	};
+
+	static AsyncFileIOUringMetrics& getMetrics() {
+		static AsyncFileIOUringMetrics metrics;
+		return metrics;
+	}
+
+	static bool isInitialized() { return ctx.initialized; }
+
+	static Future<Reference<IAsyncFile>> open(std::string filename, int flags, int mode, void* ignore) {
+		ASSERT(ctx.initialized);
+		ASSERT(flags & OPEN_UNBUFFERED);
+
+		if (flags & OPEN_LOCK)
+			mode |= 02000; // Enable mandatory locking for this file if it is supported by the filesystem
+
+		std::string open_filename = filename;
+		if (flags & OPEN_ATOMIC_WRITE_AND_CREATE) {
+			ASSERT((flags & OPEN_CREATE) && (flags & OPEN_READWRITE) && !(flags & OPEN_EXCLUSIVE));
+			open_filename = filename + ".part";
+		}
+
+		int fd = ::open(open_filename.c_str(), openFlags(flags), mode);
+		if (fd < 0) {
+			Error e = errno == ENOENT ? file_not_found() : io_error();
+			TraceEvent("AsyncFileIOUringOpenFailed")
+			    .error(e)
+			    .detail("Filename", filename)
+			    .detailf("Flags", "%x", flags)
+			    .detailf("OSFlags", "%x", openFlags(flags))
+			    .detailf("Mode", "0%o", mode)
+			    .GetLastError();
+			return e;
+		} else {
+			TraceEvent("AsyncFileIOUringOpen")
+			    .detail("Filename", filename)
+			    .detail("Flags", flags)
+			    .detail("Mode", mode)
+			    .detail("Fd", fd);
+		}
+
+		Reference<AsyncFileIOUring> r(new AsyncFileIOUring(fd, flags, filename));
+
+		if (flags & OPEN_LOCK) {
+			// Acquire a "write" lock for the entire file
+			flock lockDesc;
+			lockDesc.l_type = F_WRLCK;
+			lockDesc.l_whence = SEEK_SET;
+			lockDesc.l_start = 0;
+			lockDesc.l_len = 0;
+			lockDesc.l_pid = 0;
+			if (fcntl(fd, F_SETLK, &lockDesc) == -1) {
+				TraceEvent(SevWarn, "UnableToLockFile").detail("Filename", filename).GetLastError();
+				return lock_file_failure();
+			}
+		}
+
+		struct stat buf;
+		if (fstat(fd, &buf)) {
+			TraceEvent("AsyncFileIOUringFStatError").detail("Fd", fd).detail("Filename", filename).GetLastError();
+			return io_error();
+		}
+
+		r->lastFileSize = r->nextFileSize = buf.st_size;
+		return Reference<IAsyncFile>(std::move(r));
+	}
+
+	// Sets up the process-wide ring. ev must be an eventfd which is not shared with any other completion source; it is
+	// registered with the ring and signalled by the kernel whenever completions are posted.
+	static void init(Reference<IEventFD> ev, double ioTimeout) {
+		ASSERT(!ctx.initialized);
+		if (!g_network->isSimulated()) {
+			ctx.countSubmit.init("AsyncFile.CountIOUringSubmit"_sr);
+			ctx.countCollect.init("AsyncFile.CountIOUringCollect"_sr);
+			ctx.countPreSubmitTruncate.init("AsyncFile.CountPreIOUringSubmitTruncate"_sr);
+			ctx.preSubmitTruncateBytes.init("AsyncFile.PreIOUringSubmitTruncateBytes"_sr);
+		}
+
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		if (FLOW_KNOBS->IO_URING_SQPOLL) {
+			params.flags |= IORING_SETUP_SQPOLL;
+			params.sq_thread_idle = FLOW_KNOBS->IO_URING_SQPOLL_IDLE_MS;
+		}
+
+		int rc = io_uring_queue_init_params(FLOW_KNOBS->IO_URING_QUEUE_DEPTH, &ctx.ring, &params);
+		if (rc < 0) {
+			errno = -rc;
+			TraceEvent(SevWarnAlways, "IOUringSetupError")
+			    .detail("QueueDepth", FLOW_KNOBS->IO_URING_QUEUE_DEPTH)
+			    .detail("SQPoll", FLOW_KNOBS->IO_URING_SQPOLL)
+			    .GetLastError();
+			throw io_error();
+		}
+		ctx.sqPoll = (params.flags & IORING_SETUP_SQPOLL) != 0;
+		// With SQPOLL the kernel thread may be consuming entries while we are adding them, so never keep more in
+		// flight than the completion queue can hold.
+		ctx.maxOutstanding = std::min<int>(FLOW_KNOBS->IO_URING_QUEUE_DEPTH, params.cq_entries);
+
+		rc = io_uring_register_eventfd(&ctx.ring, ev->getFD());
+		if (rc < 0) {
+			errno = -rc;
+			TraceEvent(SevWarnAlways, "IOUringRegisterEventFDError").GetLastError();
+			io_uring_queue_exit(&ctx.ring);
+			throw io_error();
+		}
+
+		setTimeout(ioTimeout);
+		ctx.initialized = true;
+		TraceEvent("IOUringInitialized")
+		    .detail("QueueDepth", FLOW_KNOBS->IO_URING_QUEUE_DEPTH)
+		    .detail("CQEntries", params.cq_entries)
+		    .detail("SQPoll", ctx.sqPoll);
+		poll(ev);
+	}
+
+	static void setTimeout(double ioTimeout) { ctx.setIOTimeout(ioTimeout); }
+
+	void addref() override { ReferenceCounted<AsyncFileIOUring>::addref(); }
+	void delref() override { ReferenceCounted<AsyncFileIOUring>::delref(); }
+
+	Future<int> read(void* data, int length, int64_t offset) override {
+		++countFileLogicalReads;
+		++countLogicalReads;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		IOBlock* io = new IOBlock(IORING_OP_READ, fd);
+		io->buf = data;
+		io->nbytes = length;
+		io->offset = offset;
+
+		enqueue(io, this);
+		return io->result.getFuture();
+	}
+
+	Future<Void> write(void const* data, int length, int64_t offset) override {
+		++countFileLogicalWrites;
+		++countLogicalWrites;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		IOBlock* io = new IOBlock(IORING_OP_WRITE, fd);
+		io->buf = (void*)data;
+		io->nbytes = length;
+		io->offset = offset;
+
+		nextFileSize = std::max(nextFileSize, offset + length);
+
+		enqueue(io, this);
+		return success(io->result.getFuture());
+	}
+
+#ifndef FALLOC_FL_ZERO_RANGE
+#define FALLOC_FL_ZERO_RANGE 0x10
+#endif
+	Future<Void> zeroRange(int64_t offset, int64_t length) override {
+		bool success = false;
+		if (ctx.fallocateZeroSupported) {
+			int rc = fallocate(fd, FALLOC_FL_ZERO_RANGE, offset, length);
+			if (rc == EOPNOTSUPP) {
+				ctx.fallocateZeroSupported = false;
+			}
+			if (rc == 0) {
+				success = true;
+			}
+		}
+		return success ? Void() : IAsyncFile::zeroRange(offset, length);
+	}
+
+	Future<Void> truncate(int64_t size) override {
+		++countFileLogicalWrites;
+		++countLogicalWrites;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		int result = -1;
+		bool completed = false;
+		double begin = timer_monotonic();
+
+		if (ctx.fallocateSupported && size >= lastFileSize) {
+			result = fallocate(fd, 0, 0, size);
+			if (result != 0) {
+				int fallocateErrCode = errno;
+				TraceEvent("AsyncFileIOUringAllocateError")
+				    .detail("Fd", fd)
+				    .detail("Filename", filename)
+				    .detail("Size", size)
+				    .GetLastError();
+				if (fallocateErrCode == EOPNOTSUPP) {
+					// Mark fallocate as unsupported. Try again with truncate.
+					ctx.fallocateSupported = false;
+				} else {
+					return io_error();
+				}
+			} else {
+				completed = true;
+			}
+		}
+		if (!completed)
+			result = ftruncate(fd, size);
+
+		double end = timer_monotonic();
+		if (nondeterministicRandom()->random01() < end - begin) {
+			TraceEvent("SlowIOUringTruncate")
+			    .detail("TruncateTime", end - begin)
+			    .detail("TruncateBytes", size - lastFileSize);
+		}
+
+		if (result != 0) {
+			TraceEvent("AsyncFileIOUringTruncateError").detail("Fd", fd).detail("Filename", filename).GetLastError();
+			return io_error();
+		}
+
+		lastFileSize = nextFileSize = size;
+
+		return Void();
+	}
+
+	ACTOR static Future<Void> throwErrorIfFailed(Reference<AsyncFileIOUring> self, Future<Void> sync) {
+		wait(sync);
+		if (self->failed) {
+			throw io_timeout();
+		}
+		return Void();
+	}
+
+	Future<Void> sync() override {
+		++countFileLogicalWrites;
+		++countLogicalWrites;
+
+		if (failed) {
+			return io_timeout();
+		}
+
+		double start_time = timer();
+
+		// Unlike KAIO, io_uring implements fdatasync natively, so there is no need to hop through the EIO thread pool.
+		// The IOBlock holds a reference to this file, so the fd stays open until the sync completes.
+		IOBlock* io = new IOBlock(IORING_OP_FSYNC, fd);
+		enqueue(io, this);
+
+		Future<Void> fsync = throwErrorIfFailed(Reference<AsyncFileIOUring>::addRef(this), success(io->result.getFuture()));
+		fsync = map(fsync, [=](Void r) mutable {
+			getMetrics().syncLatencySample.addMeasurement(timer() - start_time);
+			return r;
+		});
+
+		if (flags & OPEN_ATOMIC_WRITE_AND_CREATE) {
+			flags &= ~OPEN_ATOMIC_WRITE_AND_CREATE;
+
+			return AsyncFileEIO::waitAndAtomicRename(fsync, filename + ".part", filename);
+		}
+
+		return fsync;
+	}
+
+	Future<int64_t> size() const override { return nextFileSize; }
+	int64_t debugFD() const override { return fd; }
+	std::string getFilename() const override { return filename; }
+	~AsyncFileIOUring() override { close(fd); }
+
+	// Called once per Net2 run loop iteration. Moves as many queued operations as the ring has room for into the
+	// submission queue and submits them with a single io_uring_submit().
+	static void launch() {
+		if (!ctx.initialized) {
+			return;
+		}
+		bool unsubmitted = !ctx.sqPoll && io_uring_sq_ready(&ctx.ring) > 0;
+		if (!unsubmitted &&
+		    (ctx.queue.empty() || ctx.outstanding >= ctx.maxOutstanding - FLOW_KNOBS->IO_URING_MIN_SUBMIT)) {
+			return;
+		}
+
+		double begin = timer_monotonic();
+		if (!ctx.outstanding)
+			ctx.ioStallBegin = begin;
+
+		int n = std::min<size_t>(ctx.maxOutstanding - ctx.outstanding, ctx.queue.size());
+		double start = timer();
+		int queued = 0;
+		for (; queued < n; queued++) {
+			io_uring_sqe* sqe = io_uring_get_sqe(&ctx.ring);
+			if (!sqe) {
+				// The kernel has not consumed earlier entries yet (only possible with SQPOLL); try again next loop.
+				break;
+			}
+
+			IOBlock* io = ctx.queue.top();
+			ctx.queue.pop();
+			io->startTime = start;
+
+			if (io->owner->lastFileSize != io->owner->nextFileSize) {
+				++ctx.countPreSubmitTruncate;
+				int64_t truncateSize = io->owner->nextFileSize - io->owner->lastFileSize;
+				ASSERT(truncateSize > 0);
+				ctx.preSubmitTruncateBytes += truncateSize;
+				io->owner->truncate(io->owner->nextFileSize);
+			}
+
+			switch (io->opcode) {
+			case IORING_OP_READ:
+				io_uring_prep_read(sqe, io->fd, io->buf, io->nbytes, io->offset);
+				break;
+			case IORING_OP_WRITE:
+				io_uring_prep_write(sqe, io->fd, io->buf, io->nbytes, io->offset);
+				break;
+			case IORING_OP_FSYNC:
+				io_uring_prep_fsync(sqe, io->fd, IORING_FSYNC_DATASYNC);
+				break;
+			default:
+				UNREACHABLE();
+			}
+			io_uring_sqe_set_data(sqe, io);
+
+			if (ctx.ioTimeout > 0) {
+				ctx.appendToRequestList(io);
+			}
+		}
+
+		if (!queued && !unsubmitted)
+			return;
+
+		int rc = io_uring_submit(&ctx.ring);
+		++ctx.countSubmit;
+		if (rc < 0 && rc != -EAGAIN && rc != -EBUSY) {
+			errno = -rc;
+			TraceEvent(SevError, "IOUringSubmitError").detail("Queued", queued).GetLastError();
+			throw io_error();
+		}
+		// Entries which were placed in the submission queue but not yet consumed by io_uring_submit() (e.g. because
+		// of EAGAIN) stay in the ring and get submitted with the next batch, so all of them count as outstanding.
+		ctx.outstanding += queued;
+
+		double elapsed = timer_monotonic() - begin;
+		g_network->networkInfo.metrics.secSquaredSubmit += elapsed * elapsed / 2;
+		if (elapsed > FLOW_KNOBS->SLOW_LOOP_CUTOFF && nondeterministicRandom()->random01() < elapsed) {
+			TraceEvent("SlowIOUringLaunch").detail("Elapsed", elapsed).detail("Queued", queued);
+		}
+	}
+
+	bool failed;
+
+private:
+	int fd, flags;
+	int64_t lastFileSize, nextFileSize;
+	std::string filename;
+	Int64MetricHandle countFileLogicalWrites;
+	Int64MetricHandle countFileLogicalReads;
+
+	Int64MetricHandle countLogicalWrites;
+	Int64MetricHandle countLogicalReads;
+
+	struct IOBlock : FastAllocated<IOBlock> {
+		Promise<int> result;
+		Reference<AsyncFileIOUring> owner;
+		int opcode;
+		int fd;
+		void* buf;
+		unsigned nbytes;
+		int64_t offset;
+		int64_t prio;
+		IOBlock* prev;
+		IOBlock* next;
+		double startTime;
+
+		struct indirect_order_by_priority {
+			bool operator()(IOBlock* a, IOBlock* b) { return a->prio < b->prio; }
+		};
+
+		IOBlock(int opcode, int fd)
+		  : opcode(opcode), fd(fd), buf(nullptr), nbytes(0), offset(0), prio(0), prev(nullptr), next(nullptr),
+		    startTime(0) {}
+
+		TaskPriority getTask() const { return static_cast<TaskPriority>((prio >> 32) + 1); }
+
+		ACTOR static void deliver(Promise<int> result, bool failed, int r, TaskPriority task) {
+			wait(delay(0, task));
+			if (failed)
+				result.sendError(io_timeout());
+			else if (r < 0)
+				result.sendError(io_error());
+			else
+				result.send(r);
+		}
+
+		void setResult(int r) {
+			if (r < 0) {
+				errno = -r;
+				TraceEvent("AsyncFileIOUringIOError")
+				    .GetLastError()
+				    .detail("Fd", fd)
+				    .detail("Op", opcode)
+				    .detail("Nbytes", nbytes)
+				    .detail("Offset", offset)
+				    .detail("Ptr", int64_t(buf))
+				    .detail("Filename", owner->filename);
+			}
+			deliver(result, owner->failed, r, getTask());
+			delete this;
+		}
+
+		void timeout(bool warnOnly) {
+			TraceEvent(SevWarnAlways, "AsyncFileIOUringTimeout")
+			    .detail("Fd", fd)
+			    .detail("Op", opcode)
+			    .detail("Nbytes", nbytes)
+			    .detail("Offset", offset)
+			    .detail("Ptr", int64_t(buf))
+			    .detail("Filename", owner->filename);
+			g_network->setGlobal(INetwork::enASIOTimedOut, (flowGlobalType) true);
+
+			if (!warnOnly)
+				owner->failed = true;
+		}
+	};
+
+	struct Context {
+		io_uring ring;
+		bool initialized;
+		bool sqPoll;
+		int maxOutstanding;
+		int outstanding;
+		double ioStallBegin;
+		bool fallocateSupported;
+		bool fallocateZeroSupported;
+		std::priority_queue<IOBlock*, std::vector<IOBlock*>, IOBlock::indirect_order_by_priority> queue;
+		Int64MetricHandle countSubmit;
+		Int64MetricHandle countCollect;
+
+		double ioTimeout;
+		bool timeoutWarnOnly;
+		IOBlock* submittedRequestList;
+
+		Int64MetricHandle countPreSubmitTruncate;
+		Int64MetricHandle preSubmitTruncateBytes;
+
+		uint32_t opsIssued;
+		Context()
+		  : initialized(false), sqPoll(false), maxOutstanding(0), outstanding(0), ioStallBegin(0),
+		    fallocateSupported(true), fallocateZeroSupported(true), submittedRequestList(nullptr), opsIssued(0) {
+			memset(&ring, 0, sizeof(ring));
+			setIOTimeout(0);
+		}
+
+		void setIOTimeout(double timeout) {
+			ioTimeout = fabs(timeout);
+			timeoutWarnOnly = timeout < 0;
+		}
+
+		void appendToRequestList(IOBlock* io) {
+			ASSERT(!io->next && !io->prev);
+
+			if (submittedRequestList) {
+				io->prev = submittedRequestList->prev;
+				io->prev->next = io;
+
+				submittedRequestList->prev = io;
+				io->next = submittedRequestList;
+			} else {
+				submittedRequestList = io;
+				io->next = io->prev = io;
+			}
+		}
+
+		void removeFromRequestList(IOBlock* io) {
+			if (io->next == nullptr) {
+				ASSERT(io->prev == nullptr);
+				return;
+			}
+
+			ASSERT(io->prev != nullptr);
+
+			if (io == io->next) {
+				ASSERT(io == submittedRequestList && io == io->prev);
+				submittedRequestList = nullptr;
+			} else {
+				io->next->prev = io->prev;
+				io->prev->next = io->next;
+
+				if (submittedRequestList == io) {
+					submittedRequestList = io->next;
+				}
+			}
+
+			io->next = io->prev = nullptr;
+		}
+	};
+	static Context ctx;
+
+	explicit AsyncFileIOUring(int fd, int flags, std::string const& filename)
+	  : failed(false), fd(fd), flags(flags), filename(filename) {
+		if (!g_network->isSimulated()) {
+			countFileLogicalWrites.init("AsyncFile.CountFileLogicalWrites"_sr, filename);
+			countFileLogicalReads.init("AsyncFile.CountFileLogicalReads"_sr, filename);
+			countLogicalWrites.init("AsyncFile.CountLogicalWrites"_sr);
+			countLogicalReads.init("AsyncFile.CountLogicalReads"_sr);
+		}
+	}
+
+	void enqueue(IOBlock* io, AsyncFileIOUring* owner) {
+		ASSERT(io->opcode == IORING_OP_FSYNC ||
+		       (int64_t(io->buf) % 4096 == 0 && io->offset % 4096 == 0 && io->nbytes % 4096 == 0));
+
+		io->prio = (int64_t(g_network->getCurrentTask()) << 32) - (++ctx.opsIssued);
+		io->owner = Reference<AsyncFileIOUring>::addRef(owner);
+
+		ctx.queue.push(io);
+	}
+
+	static int openFlags(int flags) {
+		int oflags = O_DIRECT | O_CLOEXEC;
+		ASSERT(bool(flags & OPEN_READONLY) != bool(flags & OPEN_READWRITE)); // readonly xor readwrite
+		if (flags & OPEN_EXCLUSIVE)
+			oflags |= O_EXCL;
+		if (flags & OPEN_CREATE)
+			oflags |= O_CREAT;
+		if (flags & OPEN_READONLY)
+			oflags |= O_RDONLY;
+		if (flags & OPEN_READWRITE)
+			oflags |= O_RDWR;
+		if (flags & OPEN_ATOMIC_WRITE_AND_CREATE)
+			oflags |= O_TRUNC;
+		return oflags;
+	}
+
+	ACTOR static void poll(Reference<IEventFD> ev) {
+		loop {
+			wait(success(ev->read()));
+
+			wait(delay(0, TaskPriority::DiskIOComplete));
+
+			io_uring_cqe* cqes[FLOW_KNOBS->IO_URING_QUEUE_DEPTH];
+			int n = io_uring_peek_batch_cqe(&ctx.ring, cqes, FLOW_KNOBS->IO_URING_QUEUE_DEPTH);
+			double currentTime = timer();
+
+			++ctx.countCollect;
+			if (n) {
+				double t = timer_monotonic();
+				double elapsed = t - ctx.ioStallBegin;
+				ctx.ioStallBegin = t;
+				g_network->networkInfo.metrics.secSquaredDiskStall += elapsed * elapsed / 2;
+			}
+
+			ctx.outstanding -= n;
+
+			if (ctx.ioTimeout > 0) {
+				while (ctx.submittedRequestList && currentTime - ctx.submittedRequestList->startTime > ctx.ioTimeout) {
+					ctx.submittedRequestList->timeout(ctx.timeoutWarnOnly);
+					ctx.removeFromRequestList(ctx.submittedRequestList);
+				}
+			}
+
+			for (int i = 0; i < n; i++) {
+				IOBlock* iob = static_cast<IOBlock*>(io_uring_cqe_get_data(cqes[i]));
+				int res = cqes[i]->res;
+
+				if (ctx.ioTimeout > 0) {
+					ctx.removeFromRequestList(iob);
+				}
+
+				switch (iob->opcode) {
+				case IORING_OP_READ:
+					getMetrics().readLatencySample.addMeasurement(currentTime - iob->startTime);
+					break;
+				case IORING_OP_WRITE:
+					getMetrics().writeLatencySample.addMeasurement(currentTime - iob->startTime);
+					break;
+				}
+
+				iob->setResult(res);
+			}
+			io_uring_cq_advance(&ctx.ring, n);
+		}
+	}
+};
+
+TEST_CASE("/fdbrpc/AsyncFileIOUring/ReadWriteSync") {
+	// This test does nothing in simulation because simulation doesn't support AsyncFileIOUring
+	if (!g_network->isSimulated() && AsyncFileIOUring::isInitialized()) {
+		state Reference<IAsyncFile> f;
+		state void* buf = FastAllocator<4096>::allocate();
+		state void* readBuf = FastAllocator<4096>::allocate();
+		try {
+			Reference<IAsyncFile> f_ = wait(AsyncFileIOUring::open(
+			    "/tmp/__IOURING_TEST_FILE__",
+			    IAsyncFile::OPEN_UNBUFFERED | IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_CREATE,
+			    0666,
+			    nullptr));
+			f = f_;
+			state int page = 0;
+			for (; page < 16; ++page) {
+				memset(buf, page, 4096);
+				wait(f->write(buf, 4096, page * 4096));
+			}
+			wait(f->sync());
+			int64_t fileSize = wait(f->size());
+			ASSERT_EQ(fileSize, 16 * 4096);
+			for (page = 0; page < 16; ++page) {
+				int n = wait(f->read(readBuf, 4096, page * 4096));
+				ASSERT_EQ(n, 4096);
+				memset(buf, page, 4096);
+				ASSERT(memcmp(buf, readBuf, 4096) == 0);
+			}
+		} catch (Error& e) {
+			state Error err = e;
+			if (f) {
+				wait(AsyncFileEIO::deleteFile(f->getFilename(), true));
+			}
+			FastAllocator<4096>::release(buf);
+			FastAllocator<4096>::release(readBuf);
+			throw err;
+		}
+
+		wait(AsyncFileEIO::deleteFile(f->getFilename(), true));
+		FastAllocator<4096>::release(buf);
+		FastAllocator<4096>::release(readBuf);
+	}
+
+	return Void();
+}
+
+AsyncFileIOUring::Context AsyncFileIOUring::ctx;
+
+#include "flow/unactorcompiler.h"
+#endif
+#endif
@@ -33,7 +33,8 @@
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 // Read-only file type that wraps another file instance, reads in large blocks, and reads ahead of the actual range
-// requested
+// requested. Reading ahead starts at one block for a read that continues from where the last one ended, and doubles
+// with each read that does so up to the read ahead limit, so files read at random are not read ahead at all.
 class AsyncFileReadAheadCache final : public IAsyncFile, public ReferenceCounted<AsyncFileReadAheadCache> {
 public:
 	void addref() override { ReferenceCounted<AsyncFileReadAheadCache>::addref(); }
@@ -41,18 +42,42 @@ public:
 
 	virtual StringRef getClassName() override { return "AsyncFileReadAheadCache"_sr; }
 
+	// Bounds the memory of the blocks read ahead by all of the files sharing it. Files only start reading a block ahead
+	// while the blocks read ahead that are still cached, by any of them, take up less than limit bytes.
+	struct ReadAheadBudget : ReferenceCounted<ReadAheadBudget> {
+		explicit ReadAheadBudget(int64_t limit) : limit(limit) {}
+		int64_t limit;
+		int64_t used = 0;
+	};
+
 	struct CacheBlock : ReferenceCounted<CacheBlock> {
 		CacheBlock(int size = 0) : data(new uint8_t[size]), len(size) {}
-		~CacheBlock() { delete[] data; }
+		~CacheBlock() {
+			delete[] data;
+			if (budget) {
+				budget->used -= charged;
+			}
+		}
 		uint8_t* data;
 		int len;
+		// The budget this block was read ahead under, if any, and what it charged to it
+		Reference<ReadAheadBudget> budget;
+		int charged = 0;
 	};
 
-	// Read from the underlying file to a CacheBlock
-	ACTOR static Future<Reference<CacheBlock>> readBlock(AsyncFileReadAheadCache* f, int length, int64_t offset) {
-		wait(f->m_max_concurrent_reads.take());
-
+	// Read from the underlying file to a CacheBlock, charging it to budget if given
+	ACTOR static Future<Reference<CacheBlock>> readBlock(AsyncFileReadAheadCache* f,
+	                                                     int length,
+	                                                     int64_t offset,
+	                                                     Reference<ReadAheadBudget> budget) {
 		state Reference<CacheBlock> block(new CacheBlock(length));
+		if (budget) {
+			block->budget = budget;
+			block->charged = length;
+			budget->used += length;
+		}
+
+		wait(f->m_max_concurrent_reads.take());
 		try {
 			int len = wait(uncancellable(holdWhile(block, f->m_f->read(block->data, length, offset))));
 			block->len = len;
@@ -79,6 +104,13 @@ public:
 		if (offset + length > fileSize)
 			length = fileSize - offset; // Length is at least 1 since offset < fileSize
 
+		if (offset == f->m_next_offset) {
+			f->m_read_ahead_window = std::min(std::max(1, f->m_read_ahead_window * 2), f->m_read_ahead_blocks);
+		} else {
+			f->m_read_ahead_window = 0;
+		}
+		f->m_next_offset = offset + length;
+
 		// Calculate block range for the blocks that contain this data
 		state int firstBlockNum = offset / f->m_block_size;
 		ASSERT(f->m_block_size > 0);
@@ -93,7 +125,7 @@ public:
 		// Start blocks up to the read ahead size beyond the last needed block but don't go past the end of the file
 		state int lastBlockNumInFile = ((fileSize + f->m_block_size - 1) / f->m_block_size) - 1;
 		ASSERT(lastBlockNum <= lastBlockNumInFile);
-		int lastBlockToStart = std::min<int>(lastBlockNum + f->m_read_ahead_blocks, lastBlockNumInFile);
+		int lastBlockToStart = std::min<int>(lastBlockNum + f->m_read_ahead_window, lastBlockNumInFile);
 
 		state int blockNum;
 		for (blockNum = firstBlockNum; blockNum <= lastBlockToStart; ++blockNum) {
@@ -103,8 +135,16 @@ public:
 			auto i = f->m_blocks.find(blockNum);
 			// If not found, start the read.
 			if (i == f->m_blocks.end() || (i->second.isValid() && i->second.isError())) {
+				bool readAhead = blockNum > lastBlockNum;
+				if (readAhead && f->m_budget && f->m_budget->used + f->m_block_size > f->m_budget->limit) {
+					CODE_PROBE(true, "Read ahead held back by its budget");
+					break;
+				}
 				// printf("starting read of %s block %d\n", f->getFilename().c_str(), blockNum);
-				fblock = readBlock(f.getPtr(), f->m_block_size, (int64_t)f->m_block_size * blockNum);
+				fblock = readBlock(f.getPtr(),
+				                   f->m_block_size,
+				                   (int64_t)f->m_block_size * blockNum,
+				                   readAhead ? f->m_budget : Reference<ReadAheadBudget>());
 				f->m_blocks[blockNum] = fblock;
 			} else
 				fblock = i->second;
@@ -204,6 +244,10 @@ public:
 	int m_read_ahead_blocks;
 	int m_cache_block_limit;
 	FlowLock m_max_concurrent_reads;
+	Reference<ReadAheadBudget> m_budget;
+	// Where a sequential read would continue from, and how far such a read would read ahead
+	int64_t m_next_offset = 0;
+	int m_read_ahead_window = 0;
 
 	// Map block numbers to future
 	std::map<int, Future<Reference<CacheBlock>>> m_blocks;
@@ -212,9 +256,12 @@ public:
 	                        int blockSize,
 	                        int readAheadBlocks,
 	                        int maxConcurrentReads,
-	                        int cacheSizeBlocks)
+	                        int cacheSizeBlocks,
+	                        Reference<ReadAheadBudget> budget = Reference<ReadAheadBudget>())
 	  : m_f(f), m_block_size(blockSize), m_read_ahead_blocks(readAheadBlocks),
-	    m_cache_block_limit(std::max<int>(1, cacheSizeBlocks)), m_max_concurrent_reads(maxConcurrentReads) {}
+	    // Leave room for the blocks read ahead, so they are not evicted before they are read
+	    m_cache_block_limit(std::max<int>({ 1, cacheSizeBlocks, readAheadBlocks + 1 })),
+	    m_max_concurrent_reads(maxConcurrentReads), m_budget(budget) {}
 };
 
 #include "flow/unactorcompiler.h"
@@ -88,6 +88,7 @@ public:
 		auto self = Reference<AsyncFileWriteChecker>::addRef(this);
 		return map(m_f->sync(), [self](Void r) {
 			self->syncedTime = AsyncFileWriteChecker::transformTime(now());
+			++self->sampleRotation;
 			return r;
 		});
 	}
@@ -196,6 +197,8 @@ public:
 		pageBuffer = (void*)new char[checksumHistoryPageSize];
 		totalCheckedSucceed = 0;
 		totalCheckedFail = 0;
+		totalSampledOut = 0;
+		sampleRotation = 0;
 		lru = LRU(m_f->getFilename());
 		checksumWorker = AsyncFileWriteChecker::sweep(this);
 		checksumLogger = runChecksumLogger(this);
@@ -212,7 +215,9 @@ private:
 	Future<Void> checksumLogger;
 	LRU lru;
 	void* pageBuffer;
-	uint64_t totalCheckedFail, totalCheckedSucceed;
+	uint64_t totalCheckedFail, totalCheckedSucceed, totalSampledOut;
+	// Advanced on every sync, so that which written pages are sampled keeps changing
+	uint32_t sampleRotation;
 	// transform from unixTime(double) to uint64_t, to retain ms precision.
 	uint64_t syncedTime;
 	// to avoid concurrent operation, so that the continuous reader will skip a page if it is being written
@@ -247,6 +252,8 @@ private:
 			    .detail("Filename", self->getFilename())
 			    .detail("TotalCheckedSucceed", self->totalCheckedSucceed)
 			    .detail("TotalCheckedFail", self->totalCheckedFail)
+			    .detail("TotalSampledOut", self->totalSampledOut)
+			    .detail("SamplePages", FLOW_KNOBS->PAGE_WRITE_CHECKSUM_SAMPLE_PAGES)
 			    .detail("CurrentSize", self->lru.size());
 		}
 	}
@@ -284,8 +291,14 @@ private:
 		}
 	}
 
+	bool isSampled(uint32_t page) const {
+		return FLOW_KNOBS->PAGE_WRITE_CHECKSUM_SAMPLE_PAGES <= 1 ||
+		       (page + sampleRotation) % FLOW_KNOBS->PAGE_WRITE_CHECKSUM_SAMPLE_PAGES == 0;
+	}
+
 	// Update or check checksum(s) in history for any full pages covered by this operation
 	// return the updated pages when updateChecksum is true
+	// Only pages with a history are checksummed when read, and only a sample of the rest when written
 	std::vector<uint32_t> updateChecksumHistory(bool updateChecksum, int64_t offset, int len, uint8_t* buf) {
 		std::vector<uint32_t> pages;
 		// Check or set each full block in the the range
@@ -300,7 +313,18 @@ private:
 		}
 		uint32_t startPage = page;
 		uint32_t pageEnd = (offset + len) / checksumHistoryPageSize; // Last page plus 1
-		while (page < pageEnd) {
+		for (; page < pageEnd; start += checksumHistoryPageSize, ++page) {
+			if (!lru.exist(page)) {
+				if (!updateChecksum) {
+					// never written while checked, or already verified
+					continue;
+				}
+				// A page with a history is always updated, so that it never goes stale
+				if (!isSampled(page)) {
+					++totalSampledOut;
+					continue;
+				}
+			}
 			uint32_t checksum = crc32c_append(0xab12fd93, start, checksumHistoryPageSize);
 #if VALGRIND
 			// It's possible we'll read or write a page where not all of the data is defined, but the checksum of the
@@ -332,8 +356,6 @@ private:
 					break;
 				}
 			}
-			start += checksumHistoryPageSize;
-			++page;
 		}
 		return pages;
 	}
@@ -0,0 +1,83 @@
+/*
+ * EndpointMap.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBRPC_ENDPOINTMAP_H
+#define FDBRPC_ENDPOINTMAP_H
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "fdbrpc/FlowTransport.h"
+#include "flow/Platform.h"
+
+class FlowReceiver;
+
+constexpr uint64_t TOKEN_STREAM_FLAG = 1;
+
+// The local endpoints of a process, looked up once for every message it receives. The lower 32 bits of a token are the
+// index of its entry, and the rest of the token, which the entry keeps, tells a live endpoint from an earlier one that
+// used the same entry. Lookups therefore touch one entry and nothing else.
+class EndpointMap : NonCopyable {
+public:
+	// Reserve space for this many wellKnownEndpoints
+	explicit EndpointMap(int wellKnownEndpointCount);
+	void insertWellKnown(NetworkMessageReceiver* r, const Endpoint::Token& token, TaskPriority priority);
+	void insert(NetworkMessageReceiver* r, Endpoint::Token& token, TaskPriority priority);
+	const Endpoint& insert(NetworkAddressList localAddresses,
+	                       std::vector<std::pair<FlowReceiver*, TaskPriority>> const& streams);
+	NetworkMessageReceiver* get(Endpoint::Token const& token);
+	TaskPriority getPriority(Endpoint::Token const& token);
+	void remove(Endpoint::Token const& token, NetworkMessageReceiver* r);
+
+	// Starts loading the entry for the endpoint whose token has the given lower 32 bits, so that a lookup of it after
+	// other work does not wait on memory. Harmless for indices that are not in use.
+	void prefetch(uint32_t index) const {
+		if (index < data.size())
+			_mm_prefetch((const char*)&data[index], _MM_HINT_T0);
+	}
+
+private:
+	void realloc();
+
+	// An entry is aligned to half a cache line so that no entry straddles two of them
+	struct alignas(32) Entry {
+		union {
+			uint64_t
+			    uid[2]; // priority packed into lower 32 bits; actual lower 32 bits of token are the index in data[]
+			uint32_t nextFree;
+		};
+		NetworkMessageReceiver* receiver = nullptr;
+		Endpoint::Token& token() { return *(Endpoint::Token*)uid; }
+	};
+	static_assert(sizeof(Entry) == 32);
+
+	// True if data[index] is the entry of the endpoint with the given token, rather than of one that has been removed
+	bool matches(uint32_t index, Endpoint::Token const& token) {
+		return index < data.size() && data[index].token().first() == token.first() &&
+		       ((data[index].token().second() & 0xffffffff00000000LL) | index) == token.second();
+	}
+
+	int wellKnownEndpointCount;
+	std::vector<Entry> data;
+	uint32_t firstFree;
+};
+
+#endif
@@ -23,7 +23,9 @@
 #pragma once
 
 #include <algorithm>
+#include <deque>
 #include <map>
+#include <unordered_map>
 
 #include "fdbrpc/DDSketch.h"
 #include "fdbrpc/HealthMonitor.h"
@@ -148,8 +150,13 @@ struct Peer : public ReferenceCounted<Peer> {
 	TransportData* transport;
 	NetworkAddress destination;
 	UnsentPacketQueue unsent;
+	// With FLOW_KNOBS->PEER_PRIORITY_LANE_MIN_PRIORITY set, packets sent at that priority or higher over an established
+	// connection queue here instead, and are written ahead of unsent at its next packet boundary rather than behind a
+	// bulk transfer. A packet only goes here when none for the same endpoint is waiting in unsent, so that each
+	// endpoint still receives its packets in the order they were sent.
+	UnsentPacketQueue unsentPriority;
 	ReliablePacketList reliable;
-	AsyncTrigger dataToSend; // Triggered when unsent.empty() becomes false
+	AsyncTrigger dataToSend; // Triggered when hasUnsent() becomes true
 	Future<Void> connect;
 	AsyncTrigger resetPing;
 	AsyncTrigger resetConnection;
@@ -162,13 +169,24 @@ struct Peer : public ReferenceCounted<Peer> {
 	int peerReferences;
 	int64_t bytesReceived;
 	int64_t bytesSent;
+	int64_t packetsQueued;
+	int64_t writes;
+	// How long connectionWriter waits after a write for more packets to write with the next one, between
+	// MAX_COALESCE_DELAY and ADAPTIVE_COALESCE_MAX_DELAY
+	double coalesceDelay;
 	double lastDataPacketSentTime;
 	int outstandingReplies;
 	DDSketch<double> pingLatencies;
 	double lastLoggedTime;
 	int64_t lastLoggedBytesReceived;
 	int64_t lastLoggedBytesSent;
+	int64_t lastLoggedWrites;
 	int timeoutCount;
+	// The same, since the last PeerNetworkMetrics event, which reports the peers with the slowest pings to status
+	DDSketch<double> recentPingLatencies;
+	int64_t lastReportedBytesReceived;
+	int64_t lastReportedBytesSent;
+	int recentTimeouts;
 
 	Reference<AsyncVar<Optional<ProtocolVersion>>> protocolVersion;
 
@@ -179,14 +197,49 @@ struct Peer : public ReferenceCounted<Peer> {
 	DDSketch<double> connectLatencies;
 	Promise<Void> disconnect;
 
+	// While PEER_PRIORITY_LANE_MIN_PRIORITY is set, where each packet in unsent ends, counted in bytes ever queued
+	// there, and its endpoint. An entry without an endpoint covers bytes that came some other way, such as a connect
+	// packet, which unsentPriority must not overtake.
+	std::deque<std::pair<int64_t, Optional<Endpoint::Token>>> unsentPacketEnds;
+	std::unordered_map<Endpoint::Token, int> unsentPacketsByToken;
+	int64_t unsentBytesQueued = 0;
+	int64_t unsentBytesSent = 0;
+	int64_t unsentPacketBegin = 0; // Where the first packet in unsentPacketEnds begins
+
 	explicit Peer(TransportData* transport, NetworkAddress const& destination);
 
-	void send(PacketBuffer* pb, ReliablePacket* rp, bool firstUnsent);
+	bool hasUnsent() const { return !unsent.empty() || !unsentPriority.empty(); }
+
+	// The queue a packet for token sent now should be written to
+	UnsentPacketQueue& queueFor(Endpoint::Token const& token);
+
+	// Call after writing a packet of the given size to queue, which was returned by queueFor()
+	void send(UnsentPacketQueue& queue,
+	          PacketBuffer* pb,
+	          ReliablePacket* rp,
+	          bool firstUnsent,
+	          Endpoint::Token const& token,
+	          int bytes);
+
+	// True if unsentPriority should be written next
+	bool priorityReady() const;
+
+	// The number of bytes of unsent that may be written now, up to limit
+	int unsentWriteLimit(int limit) const;
+
+	// Call after sending bytes from unsent
+	void sentUnsent(int bytes);
+
+	// Call after connectionWriter has written everything queued, with how much that was
+	void adaptCoalesceDelay(int64_t bytes, int64_t packets);
 
 	void prependConnectPacket();
 
 	void discardUnreliablePackets();
 
+	// Call after unsent has changed other than by send(), since which packets it holds is no longer known
+	void resetUnsentPackets();
+
 	void onIncomingConnection(Reference<Peer> self, Reference<IConnection> conn, Future<Void> reader);
 };
 
@@ -68,6 +68,12 @@ struct ModelHolder : NonCopyable, public ReferenceCounted<ModelHolder> {
 		}
 	}
 
+	void updateLoad(int64_t versionLag, double busyness) {
+		if (model) {
+			model->updateLoad(token, versionLag, busyness);
+		}
+	}
+
 	~ModelHolder() { release(false, false, -1.0, false); }
 };
 
@@ -76,11 +82,19 @@ struct ModelHolder : NonCopyable, public ReferenceCounted<ModelHolder> {
 struct LoadBalancedReply {
 	double penalty;
 	Optional<Error> error;
-	LoadBalancedReply() : penalty(1.0) {}
+	// The server's view of its own load when it replied, used along with the queue model to choose replicas: how many
+	// versions it is behind the tlogs, and the fraction of the time its run loop was busy. Zero if unknown.
+	int64_t versionLag;
+	double busyness;
+	// Not sent: set by loadBalance() on the client to how far the replica that answered is from it, one of LBDistance
+	int8_t replicaDistance;
+	LoadBalancedReply() : penalty(1.0), versionLag(0), busyness(0), replicaDistance(LBDistance::DISTANT) {}
 };
 
 Optional<LoadBalancedReply> getLoadBalancedReply(const LoadBalancedReply* reply);
 Optional<LoadBalancedReply> getLoadBalancedReply(const void*);
+void setReplicaDistance(LoadBalancedReply* reply, LBDistance::Type distance);
+void setReplicaDistance(void*, LBDistance::Type distance);
 
 ACTOR template <class Req, class Resp, class Interface, class Multi, bool P>
 Future<Void> tssComparison(Req req,
@@ -421,6 +435,7 @@ struct RequestData : NonCopyable {
 	Reference<ModelHolder> modelHolder;
 	TriedAllOptions triedAllOptions{ false };
 	RequestStream<Request, P> const* requestStream = nullptr;
+	LBDistance::Type distance = LBDistance::DISTANT;
 
 	bool requestStarted = false; // true once the request has been sent to an alternative
 	bool requestProcessed = false; // true once a response has been received and handled by checkAndProcessResult
@@ -481,17 +496,26 @@ struct RequestData : NonCopyable {
 		return Void();
 	}
 
+	// The successful reply, marked with the distance of the replica it came from
+	REPLY_TYPE(Request) getReply() const {
+		REPLY_TYPE(Request) reply = response.get().get();
+		setReplicaDistance(&reply, distance);
+		return reply;
+	}
+
 	// Initializes the request state and starts it, possibly after a backoff delay
 	void startRequest(
 	    double backoff,
 	    TriedAllOptions triedAllOptions,
 	    RequestStream<Request, P> const* stream,
+	    LBDistance::Type distance,
 	    Request& request,
 	    QueueModel* model,
 	    Reference<MultiInterface<Multi>> alternatives, // alternatives and channel passed through for TSS check
 	    RequestStream<Request, P> Interface::*channel) {
 		modelHolder = Reference<ModelHolder>();
 		requestStream = stream;
+		this->distance = distance;
 		requestStarted = false;
 
 		if (backoff > 0) {
@@ -543,6 +567,9 @@ struct RequestData : NonCopyable {
 		receivedResponse = receivedResponse || (!maybeDelivered && errCode != error_code_process_behind);
 		bool futureVersion = errCode == error_code_future_version || errCode == error_code_process_behind;
 
+		if (loadBalancedReply.present()) {
+			modelHolder->updateLoad(loadBalancedReply.get().versionLag, loadBalancedReply.get().busyness);
+		}
 		modelHolder->release(
 		    receivedResponse, futureVersion, loadBalancedReply.present() ? loadBalancedReply.get().penalty : -1.0);
 
@@ -653,6 +680,8 @@ Future<REPLY_TYPE(Request)> loadBalance(
 
 	state Optional<uint64_t> firstRequestEndpoint;
 	state Future<Void> secondDelay = Never();
+	// Whether secondDelay comes from the best server's latency distribution rather than the adaptive multiplier
+	state bool latencyAwareHedge = false;
 
 	state Promise<Void> requestFinished;
 	state double startTime = now();
@@ -698,13 +727,19 @@ Future<REPLY_TYPE(Request)> loadBalance(
 			if (!IFailureMonitor::failureMonitor().getState(thisStream->getEndpoint()).failed) {
 				auto const& qd = model->getMeasurement(thisStream->getEndpoint().token.first());
 				if (now() > qd.failedUntil) {
-					double thisMetric = qd.smoothOutstanding.smoothTotal();
+					double thisMetric = qd.smoothOutstanding.smoothTotal() + qd.loadPenalty();
 					double thisTime = qd.latency;
 					if (FLOW_KNOBS->LOAD_BALANCE_PENALTY_IS_BAD && qd.penalty > 1.001) {
 						// When a server wants to penalize itself (the default
 						// penalty value is 1.0), consider this server as bad.
 						// penalty is sent from server.
 						++badServers;
+					} else if (alternatives->getDistance(i) == LBDistance::SAME_MACHINE &&
+					           (thisMetric > FLOW_KNOBS->LOAD_BALANCE_ZONE_LOCAL_MAX_OUTSTANDING ||
+					            thisTime > FLOW_KNOBS->LOAD_BALANCE_ZONE_LOCAL_MAX_LATENCY)) {
+						// A busy or slow replica in the client's zone is still a candidate, but no longer keeps the
+						// replicas in other zones from being considered
+						++badServers;
 					}
 
 					if (thisMetric < bestMetric) {
@@ -737,7 +772,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 				if (!IFailureMonitor::failureMonitor().getState(thisStream->getEndpoint()).failed) {
 					auto const& qd = model->getMeasurement(thisStream->getEndpoint().token.first());
 					if (now() > qd.failedUntil) {
-						double thisMetric = qd.smoothOutstanding.smoothTotal();
+						double thisMetric = qd.smoothOutstanding.smoothTotal() + qd.loadPenalty();
 						double thisTime = qd.latency;
 
 						if (thisMetric < nextMetric) {
@@ -751,12 +786,30 @@ Future<REPLY_TYPE(Request)> loadBalance(
 		}
 
 		if (nextTime < 1e9) {
-			// Decide when to send the request to the second best choice.
-			if (bestTime > FLOW_KNOBS->INSTANT_SECOND_REQUEST_MULTIPLIER *
-			                   (model->secondMultiplier * (nextTime) + FLOW_KNOBS->BASE_SECOND_REQUEST_TIME)) {
+			// Decide when to send the request to the second best choice. Once enough replies from the best choice
+			// have been measured, that is when the request has taken longer than the LOAD_BALANCE_HEDGE_QUANTILE of
+			// them. Every such request adds LOAD_BALANCE_MAX_HEDGE_RATE to the shared second request budget, which
+			// caps the fraction of them that are actually hedged however slow the servers get.
+			double hedgeLatency = 0;
+			if (FLOW_KNOBS->LOAD_BALANCE_HEDGE_QUANTILE > 0) {
+				hedgeLatency =
+				    model->getMeasurement(alternatives->get(bestAlt, channel).getEndpoint().token.first()).hedgeLatency;
+			}
+
+			double secondTime;
+			if (hedgeLatency > 0) {
+				latencyAwareHedge = true;
+				model->secondBudget = std::min(model->secondBudget + FLOW_KNOBS->LOAD_BALANCE_MAX_HEDGE_RATE,
+				                               FLOW_KNOBS->SECOND_REQUEST_MAX_BUDGET);
+				secondTime = hedgeLatency + FLOW_KNOBS->BASE_SECOND_REQUEST_TIME;
+			} else {
+				secondTime = model->secondMultiplier * nextTime + FLOW_KNOBS->BASE_SECOND_REQUEST_TIME;
+			}
+
+			if (bestTime > FLOW_KNOBS->INSTANT_SECOND_REQUEST_MULTIPLIER * secondTime) {
 				secondDelay = Void();
 			} else {
-				secondDelay = delay(model->secondMultiplier * nextTime + FLOW_KNOBS->BASE_SECOND_REQUEST_TIME);
+				secondDelay = delay(secondTime);
 			}
 		} else {
 			secondDelay = Never();
@@ -845,7 +898,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 				    firstRequestData.maybeDoReplicaComparison(request, model, alternatives, channel, requiredReplicas));
 
 				ASSERT(firstRequestData.response.isReady());
-				return firstRequestData.response.get().get();
+				return firstRequestData.getReply();
 			}
 
 			firstRequestEndpoint = Optional<uint64_t>();
@@ -863,7 +916,8 @@ Future<REPLY_TYPE(Request)> loadBalance(
 				    .detail("Best", alternatives->countBest())
 				    .detail("Attempts", numAttempts);
 			}
-			secondRequestData.startRequest(backoff, triedAllOptions, stream, request, model, alternatives, channel);
+			secondRequestData.startRequest(
+			    backoff, triedAllOptions, stream, distance, request, model, alternatives, channel);
 
 			state bool firstRequestSuccessful = false;
 			state bool secondRequestSuccessful = false;
@@ -893,7 +947,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 				wait(requestData->maybeDoReplicaComparison(request, model, alternatives, channel, requiredReplicas));
 
 				ASSERT(requestData->response.isReady());
-				return requestData->response.get().get();
+				return requestData->getReply();
 			}
 
 			if (++numAttempts >= alternatives->size()) {
@@ -915,13 +969,14 @@ Future<REPLY_TYPE(Request)> loadBalance(
 				    .detail("Best", alternatives->countBest())
 				    .detail("Attempts", numAttempts);
 			}
-			firstRequestData.startRequest(backoff, triedAllOptions, stream, request, model, alternatives, channel);
+			firstRequestData.startRequest(
+			    backoff, triedAllOptions, stream, distance, request, model, alternatives, channel);
 			firstRequestEndpoint = stream->getEndpoint().token.first();
 
 			loop {
 				choose {
 					when(wait(success(firstRequestData.response))) {
-						if (model) {
+						if (model && !latencyAwareHedge) {
 							model->secondMultiplier =
 							    std::max(model->secondMultiplier - FLOW_KNOBS->SECOND_REQUEST_MULTIPLIER_DECAY, 1.0);
 							model->secondBudget =
@@ -935,7 +990,7 @@ Future<REPLY_TYPE(Request)> loadBalance(
 							    request, model, alternatives, channel, requiredReplicas));
 
 							ASSERT(firstRequestData.response.isReady());
-							return firstRequestData.response.get().get();
+							return firstRequestData.getReply();
 						}
 
 						firstRequestEndpoint = Optional<uint64_t>();
@@ -944,7 +999,9 @@ Future<REPLY_TYPE(Request)> loadBalance(
 					when(wait(secondDelay)) {
 						secondDelay = Never();
 						if (model && model->secondBudget >= 1.0) {
-							model->secondMultiplier += FLOW_KNOBS->SECOND_REQUEST_MULTIPLIER_GROWTH;
+							if (!latencyAwareHedge) {
+								model->secondMultiplier += FLOW_KNOBS->SECOND_REQUEST_MULTIPLIER_GROWTH;
+							}
 							model->secondBudget -= 1.0;
 							break;
 						}
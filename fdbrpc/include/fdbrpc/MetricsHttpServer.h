@@ -0,0 +1,38 @@
+/*
+ * MetricsHttpServer.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBRPC_METRICS_HTTP_SERVER_H
+#define FDBRPC_METRICS_HTTP_SERVER_H
+#pragma once
+
+#include <string>
+
+#include "flow/flow.h"
+
+// Renders every traced CounterCollection and every registered Histogram of this process in the OpenMetrics text
+// format. Counters become "counter" families, special counters become gauges and histograms keep their power of two
+// buckets as cumulative "le" buckets.
+std::string renderOpenMetrics();
+
+// Serves renderOpenMetrics() on GET /metrics at the given address until cancelled. The page is built from in-memory
+// state on each scrape, so nothing is computed between scrapes.
+Future<Void> metricsHttpServer(NetworkAddress address);
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "flow/flow.h"
 #include "fdbrpc/Smoother.h"
+#include "fdbrpc/DDSketch.h"
 #include "flow/Knobs.h"
 #include "flow/ActorCollection.h"
 #include "fdbrpc/TSSComparison.h" // For TSS Metrics
@@ -74,9 +75,31 @@ struct QueueData {
 	// a bit of a hack to store this here, but it's the only centralized place for per-endpoint tracking
 	Optional<TSSEndpointData> tssData;
 
+	// The latencies of the clean replies from this storage server in the current window of
+	// LOAD_BALANCE_HEDGE_WINDOW_SAMPLES replies. Only allocated once the server has replied, since a client may know of
+	// many more endpoints than it talks to.
+	std::unique_ptr<DDSketch<double>> latencySketch;
+
+	// The LOAD_BALANCE_HEDGE_QUANTILE of the latencies in `latencySketch`, as of the last time it was computed. A
+	// request to this storage server which takes longer than this is hedged to another one. Zero until enough replies
+	// have been measured.
+	double hedgeLatency;
+
+	// The load last reported by this storage server along with a reply, and when: how many versions it is behind the
+	// tlogs, and the fraction of time its run loop is busy.
+	int64_t versionLag;
+	double busyness;
+	double loadTime;
+
 	QueueData()
 	  : smoothOutstanding(FLOW_KNOBS->QUEUE_MODEL_SMOOTHING_AMOUNT), latency(0.001), penalty(1.0), failedUntil(0),
-	    futureVersionBackoff(FLOW_KNOBS->FUTURE_VERSION_INITIAL_BACKOFF), increaseBackoffTime(0) {}
+	    futureVersionBackoff(FLOW_KNOBS->FUTURE_VERSION_INITIAL_BACKOFF), increaseBackoffTime(0), hedgeLatency(0),
+	    versionLag(0), busyness(0), loadTime(0) {}
+
+	// The number of outstanding requests the reported load of this storage server is worth when choosing a replica, so
+	// that reads steer away from servers which are catching up on the tlogs, e.g. after a recovery, or are busy. A
+	// report older than LOAD_BALANCE_SERVER_LOAD_EXPIRATION is ignored, so an avoided server gets tried again.
+	double loadPenalty() const;
 };
 
 typedef double TimeEstimate;
@@ -100,6 +123,9 @@ public:
 	// penalty. The returned penalty should be passed as `delta` to `endRequest`
 	// to make `smoothOutstanding` to reflect the real storage queue size.
 	double addRequest(uint64_t id);
+
+	// Records the load reported by storage server `id` along with a reply.
+	void updateLoad(uint64_t id, int64_t versionLag, double busyness);
 	double secondMultiplier;
 	double secondBudget;
 	PromiseStream<Future<Void>> addActor;
@@ -102,6 +102,8 @@ public:
 
 	std::string const& getId() const { return id; }
 
+	std::vector<ICounter*> const& getCounters() const { return counters; }
+
 	void logToTraceEvent(TraceEvent& te);
 
 	Future<Void> traceCounters(
@@ -112,6 +114,17 @@ public:
 	    std::function<void(TraceEvent&)> const& decorator = [](auto& te) {});
 };
 
+// A CounterCollection that is currently being logged by traceCounters(), along with the event it is logged as
+struct TracedCounterCollection {
+	CounterCollection const* counters;
+	std::string traceEventName;
+	UID traceEventID;
+};
+
+// Every CounterCollection being traced in this process, so that their current values can be read straight from memory
+// rather than from the trace logs. Only accessed on the network thread.
+std::map<uint64_t, TracedCounterCollection> const& getTracedCounterCollections();
+
 struct Counter final : public ICounter, NonCopyable {
 public:
 	typedef int64_t Value;
@@ -939,6 +939,8 @@ public:
 	bool operator!=(const RequestStream<T, IsPublic>& rhs) const { return !(*this == rhs); }
 	bool isEmpty() const { return !queue->isReady(); }
 	uint32_t size() const { return queue->size(); }
+	// True if requests are serialized on their way to the receiver rather than handed to it directly
+	bool isRemoteEndpoint() const { return queue->isRemoteEndpoint(); }
 
 	std::pair<FlowReceiver*, TaskPriority> getReceiver(TaskPriority taskID = TaskPriority::DefaultEndpoint) {
 		return std::make_pair((FlowReceiver*)queue, taskID);
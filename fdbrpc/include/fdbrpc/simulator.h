@@ -464,6 +464,14 @@ struct DiskParameters : ReferenceCounted<DiskParameters> {
 // Simulates delays for performing operations on disk
 extern Future<Void> waitUntilDiskReady(Reference<DiskParameters> parameters, int64_t size, bool sync = false);
 
+class IThreadPool;
+
+// Returns a thread pool for simulation whose actions run on FLOW_KNOBS->SIM_POOL_THREADS real threads, in parallel
+// with the simulation, but whose results reach the network thread in the order the actions were posted and at a
+// point in simulated time that only depends on when they were posted. Actions must be pure: they may only read what
+// the poster keeps alive for them and their own receiver, and send results through ThreadReturnPromises.
+Reference<IThreadPool> createDeterministicThreadPool();
+
 // Enables connection failures, i.e., clogging, in simulation
 void enableConnectionFailures(std::string const& context);
 
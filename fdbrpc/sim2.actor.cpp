@@ -19,7 +19,10 @@
  */
 
 #include <cinttypes>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -41,6 +44,7 @@
 #include "flow/IRandom.h"
 #include "flow/IThreadPool.h"
 #include "flow/ProtocolVersion.h"
+#include "flow/UnitTest.h"
 #include "flow/Util.h"
 #include "flow/WriteOnlySet.h"
 #include "flow/IAsyncFile.h"
@@ -72,6 +76,10 @@
 ISimulator* g_simulator = nullptr;
 thread_local ISimulator::ProcessInfo* ISimulator::currentProcess = nullptr;
 
+// While a deterministic thread pool thread runs an action, what the action sends to the network thread is held here
+// until the simulation reaches the point at which the action is delivered
+static thread_local std::vector<std::pair<Promise<Void>, TaskPriority>>* deferredThreadSignals = nullptr;
+
 ISimulator::ISimulator()
   : desiredCoordinators(1), physicalDatacenters(1), processesPerMachine(0), listenersPerProcess(1), usableRegions(1),
     allowLogSetKills(true), tssMode(TSSMode::Disabled), configDBType(ConfigDBType::DISABLED), isStopped(false),
@@ -2616,7 +2624,7 @@ public:
 	}
 
 	// Implementation
-	struct PromiseTask final : public FastAllocated<PromiseTask> {
+	struct PromiseTask final : public TaskQueueNode, public FastAllocated<PromiseTask> {
 		Promise<Void> promise;
 		ProcessInfo* machine;
 		swift::Job* _Nullable swiftJob = nullptr;
@@ -2658,6 +2666,10 @@ public:
 	}
 
 	void onMainThread(Promise<Void>&& signal, TaskPriority taskID) override {
+		if (deferredThreadSignals) {
+			deferredThreadSignals->emplace_back(std::move(signal), taskID);
+			return;
+		}
 		// This is presumably coming from either a "fake" thread pool thread, i.e. it is actually on this thread
 		// or a thread created with g_network->startThread
 		ASSERT(getCurrentProcess());
@@ -2908,6 +2920,235 @@ Future<Reference<IUDPSocket>> Sim2::createUDPSocket(bool isV6) {
 	return Reference<IUDPSocket>(new UDPSimSocket(localAddress, Optional<NetworkAddress>{}));
 }
 
+namespace {
+
+class DeterministicThreadPool;
+
+struct DeterministicThreadJob {
+	DeterministicThreadPool* pool;
+	PThreadAction action;
+	ISimulator::ProcessInfo* process;
+	// Seeds deterministicRandom() for the action, so that what it draws does not depend on the thread running it
+	uint32_t seed;
+	std::vector<std::pair<Promise<Void>, TaskPriority>> signals;
+	bool done = false;
+
+	DeterministicThreadJob(DeterministicThreadPool* pool, PThreadAction action)
+	  : pool(pool), action(action), process(g_simulator->getCurrentProcess()),
+	    seed(deterministicRandom()->randomUInt32()) {}
+};
+
+// The real threads that run the actions of every deterministic thread pool, shared so that a simulation of many
+// processes does not start threads for each of their pools. A job runs once a thread and one of its pool's receivers
+// are both idle, so no receiver ever runs two actions at once.
+class DeterministicThreadExecutor {
+public:
+	static DeterministicThreadExecutor& instance() {
+		// Never destroyed, the threads wait for work until the process exits
+		static DeterministicThreadExecutor* executor = new DeterministicThreadExecutor(FLOW_KNOBS->SIM_POOL_THREADS);
+		return *executor;
+	}
+
+	void post(std::shared_ptr<DeterministicThreadJob> job);
+
+	// Blocks the network thread until job has run
+	void waitFor(DeterministicThreadJob* job) {
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [job] { return job->done; });
+	}
+
+	std::mutex mutex;
+	std::condition_variable changed;
+
+private:
+	explicit DeterministicThreadExecutor(int threadCount) {
+		for (int i = 0; i < std::max(threadCount, 1); i++) {
+			startThread(start, this, 0, "fdb-sim-pool");
+		}
+	}
+
+	THREAD_FUNC start(void* executor) {
+		((DeterministicThreadExecutor*)executor)->run();
+		THREAD_RETURN;
+	}
+
+	void run();
+
+	std::deque<std::shared_ptr<DeterministicThreadJob>> queue;
+};
+
+class DeterministicThreadPool final : public IThreadPool, public ReferenceCounted<DeterministicThreadPool> {
+public:
+	~DeterministicThreadPool() override { stop(); }
+
+	Future<Void> getError() const override { return Never(); }
+
+	// The receiver is initialized here on the network thread, since actions run on whichever thread is idle
+	void addThread(IThreadPoolReceiver* userData, const char* name) override {
+		userData->init();
+		std::unique_lock<std::mutex> lock(executor.mutex);
+		receivers.push_back(userData);
+		idleReceivers.push_back(userData);
+	}
+
+	void post(PThreadAction action) override {
+		if (stopped) {
+			action->cancel();
+			return;
+		}
+		auto job = std::make_shared<DeterministicThreadJob>(this, action);
+		{
+			std::unique_lock<std::mutex> lock(executor.mutex);
+			++pending;
+		}
+		executor.post(job);
+		lastDelivery = deliver(lastDelivery, job);
+	}
+
+	// Waits for every posted action to run, rather than cancelling those not yet started, since which those are
+	// depends on the real threads
+	Future<Void> stop(Error const& e = success()) override {
+		if (!stopped) {
+			stopped = true;
+			std::unique_lock<std::mutex> lock(executor.mutex);
+			executor.changed.wait(lock, [this] { return pending == 0; });
+			for (auto receiver : receivers) {
+				delete receiver;
+			}
+			receivers.clear();
+			idleReceivers.clear();
+		}
+		return Void();
+	}
+
+	void addref() override { ReferenceCounted<DeterministicThreadPool>::addref(); }
+	void delref() override { ReferenceCounted<DeterministicThreadPool>::delref(); }
+
+private:
+	friend class DeterministicThreadExecutor;
+
+	// Delivers what each action sent in the order they were posted, with the network thread waiting for an action
+	// still running at that point
+	ACTOR static Future<Void> deliver(Future<Void> previous, std::shared_ptr<DeterministicThreadJob> job) {
+		wait(previous);
+		wait(delay(0, TaskPriority::Low));
+		DeterministicThreadExecutor::instance().waitFor(job.get());
+		for (auto& [signal, taskID] : job->signals) {
+			g_simulator->onMainThread(std::move(signal), taskID);
+		}
+		job->signals.clear();
+		return Void();
+	}
+
+	DeterministicThreadExecutor& executor = DeterministicThreadExecutor::instance();
+	std::vector<IThreadPoolReceiver*> receivers;
+	// Guarded by the executor's mutex
+	std::vector<IThreadPoolReceiver*> idleReceivers;
+	int pending = 0;
+	bool stopped = false;
+	Future<Void> lastDelivery = Void();
+};
+
+void DeterministicThreadExecutor::post(std::shared_ptr<DeterministicThreadJob> job) {
+	std::unique_lock<std::mutex> lock(mutex);
+	queue.push_back(std::move(job));
+	changed.notify_all();
+}
+
+void DeterministicThreadExecutor::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	loop {
+		auto next = queue.end();
+		changed.wait(lock, [&] {
+			next = std::find_if(queue.begin(), queue.end(), [](auto const& job) {
+				return !job->pool->idleReceivers.empty();
+			});
+			return next != queue.end();
+		});
+		std::shared_ptr<DeterministicThreadJob> job = std::move(*next);
+		queue.erase(next);
+		DeterministicThreadPool* pool = job->pool;
+		IThreadPoolReceiver* receiver = pool->idleReceivers.back();
+		pool->idleReceivers.pop_back();
+		lock.unlock();
+
+		ISimulator::currentProcess = job->process;
+		setThreadLocalDeterministicRandom(makeReference<DeterministicRandom>(job->seed, true));
+		deferredThreadSignals = &job->signals;
+		(*job->action)(receiver);
+		deferredThreadSignals = nullptr;
+		setThreadLocalDeterministicRandom(Reference<IRandom>());
+		ISimulator::currentProcess = nullptr;
+
+		lock.lock();
+		pool->idleReceivers.push_back(receiver);
+		job->done = true;
+		// Released before the pool can see the job done, so that its signals are always destroyed on the network thread
+		job.reset();
+		--pool->pending;
+		changed.notify_all();
+	}
+}
+
+} // namespace
+
+Reference<IThreadPool> createDeterministicThreadPool() {
+	return Reference<IThreadPool>(new DeterministicThreadPool());
+}
+
+namespace {
+
+struct SleepingReceiver final : IThreadPoolReceiver {
+	void init() override {}
+
+	struct SleepAction final : TypedAction<SleepingReceiver, SleepAction> {
+		int index;
+		ThreadReturnPromise<int> result;
+
+		explicit SleepAction(int index) : index(index) {}
+		double getTimeEstimate() const override { return 0; }
+	};
+
+	void action(SleepAction& a) {
+		threadSleep(nondeterministicRandom()->random01() * 0.001);
+		a.result.send(a.index);
+	}
+};
+
+ACTOR Future<Void> recordCompletion(Future<int> result, std::vector<int>* completed) {
+	int index = wait(result);
+	completed->push_back(index);
+	return Void();
+}
+
+} // namespace
+
+TEST_CASE("/fdbrpc/sim2/DeterministicThreadPool") {
+	if (!g_network->isSimulated()) {
+		return Void();
+	}
+	state Reference<IThreadPool> pool = createDeterministicThreadPool();
+	state std::vector<int> completed;
+	state std::vector<Future<Void>> done;
+	for (int i = 0; i < 4; i++) {
+		pool->addThread(new SleepingReceiver(), "test");
+	}
+
+	// However long each action takes, results arrive in the order the actions were posted
+	for (int i = 0; i < 100; i++) {
+		auto* action = new SleepingReceiver::SleepAction(i);
+		done.push_back(recordCompletion(action->result.getFuture(), &completed));
+		pool->post(action);
+	}
+	wait(waitForAll(done));
+	ASSERT_EQ(completed.size(), 100);
+	for (int i = 0; i < completed.size(); i++) {
+		ASSERT_EQ(completed[i], i);
+	}
+	wait(pool->stop());
+	return Void();
+}
+
 void startNewSimulator(bool printSimTime) {
 	ASSERT(!g_network);
 	ASSERT(!g_simulator);
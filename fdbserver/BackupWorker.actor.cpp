@@ -34,6 +34,7 @@
 #include "fdbserver/ServerDBInfo.h"
 #include "fdbserver/WaitFailure.h"
 #include "fdbserver/WorkerInterface.actor.h"
+#include "flow/CompressionUtils.h"
 #include "flow/Error.h"
 
 #include "flow/IRandom.h"
@@ -664,9 +665,117 @@ ACTOR Future<Void> saveProgress(BackupData* self, Version backupVersion) {
 	}
 }
 
-// Write a mutation to a log file. Note the mutation can be different from
+// Writes the messages of a log file as PARTITIONED_MLOG_COMPRESSED_VERSION blocks. Since how well a block compresses is
+// not known until it is compressed, messages are buffered until they reach a target size estimated from the previous
+// block's compression ratio, and a block that comes out too big is cut short at a message, with the rest of its
+// messages starting the next block.
+struct CompressedLogFileWriter {
+	CompressedLogFileWriter(Reference<IBackupFile> file, int blockSize)
+	  : file(file), blockSize(blockSize), filter(fileBackup::backupCompressionFilter()), targetBytes(blockSize) {}
+
+	// Raw blocks are allowed this much bigger than a block, however well the last one compressed
+	static constexpr double MAX_RATIO = 10;
+	// And the estimate leaves this fraction of a block spare, for blocks that compress worse than the last
+	static constexpr double TARGET_FILL = 0.9;
+
+	Reference<IBackupFile> file;
+	int blockSize;
+	CompressionFilter filter;
+	int64_t blockEnd = 0;
+	std::string pending;
+	// Where each message in pending ends
+	std::vector<int> messageEnds;
+	int64_t targetBytes;
+	int lastBlockBytes = 0;
+
+	// Writes the first count pending messages as a block, or returns false if they don't fit in one
+	ACTOR static Future<bool> writeBlock(CompressedLogFileWriter* self, int count) {
+		state std::string raw = self->pending.substr(0, self->messageEnds[count - 1]);
+		state Optional<std::string> compressed;
+		if (self->filter != CompressionFilter::NONE) {
+			wait(store(compressed, fileBackup::compressBackupBlockPayload(self->filter, raw)));
+		}
+		state std::string block = fileBackup::encodeCompressedPartitionedLogBlock(self->filter, raw, compressed);
+
+		double ratio = (double)raw.size() / block.size();
+		self->targetBytes = self->blockSize * std::clamp(ratio * TARGET_FILL, TARGET_FILL, MAX_RATIO);
+		self->lastBlockBytes = block.size();
+		if (block.size() > self->blockSize) {
+			return false;
+		}
+
+		const int bytesLeft = self->blockEnd - self->file->size();
+		if (bytesLeft > 0) {
+			state Value paddingFFs = fileBackup::makePadding(bytesLeft);
+			wait(self->file->append(paddingFFs.begin(), bytesLeft));
+		}
+		wait(self->file->append(block.data(), block.size()));
+		self->blockEnd += self->blockSize;
+
+		int written = raw.size();
+		self->pending.erase(0, written);
+		self->messageEnds.erase(self->messageEnds.begin(), self->messageEnds.begin() + count);
+		for (auto& end : self->messageEnds) {
+			end -= written;
+		}
+		return true;
+	}
+
+	// Writes out the pending messages in blocks, all of them if final is set, or otherwise until what is left would
+	// not fill a block
+	ACTOR static Future<Void> flush(CompressedLogFileWriter* self, bool final) {
+		while (!self->messageEnds.empty()) {
+			bool wroteAll = wait(writeBlock(self, self->messageEnds.size()));
+			if (wroteAll) {
+				break;
+			}
+			if (self->messageEnds.size() < 2) {
+				throw backup_bad_block_size();
+			}
+
+			// Write as many as should fit, going by how far over the last try was
+			state int count = std::clamp<int>(self->messageEnds.size() * TARGET_FILL * self->blockSize /
+			                                      std::max(self->lastBlockBytes, 1),
+			                                  1,
+			                                  self->messageEnds.size() - 1);
+			loop {
+				bool wrote = wait(writeBlock(self, count));
+				if (wrote) {
+					break;
+				}
+				if (count == 1) {
+					throw backup_bad_block_size();
+				}
+				count /= 2;
+			}
+			if (!final && self->pending.size() < self->targetBytes) {
+				break;
+			}
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> add(CompressedLogFileWriter* self, Standalone<StringRef> header, StringRef mutation) {
+		self->pending.append((const char*)header.begin(), header.size());
+		self->pending.append((const char*)mutation.begin(), mutation.size());
+		self->messageEnds.push_back(self->pending.size());
+		if (self->pending.size() >= self->targetBytes) {
+			wait(flush(self, false));
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> finish(CompressedLogFileWriter* self) {
+		wait(flush(self, true));
+		wait(self->file->finish());
+		return Void();
+	}
+};
+
+// Write a mutation to a log file, through compressedWriter if it is given. Note the mutation can be different from
 // message.message for clear mutations.
 ACTOR Future<Void> addMutation(Reference<IBackupFile> logFile,
+                               CompressedLogFileWriter* compressedWriter,
                                VersionedMessage message,
                                StringRef mutation,
                                int64_t* blockEnd,
@@ -681,6 +790,11 @@ ACTOR Future<Void> addMutation(Reference<IBackupFile> logFile,
 	wr << bigEndian64(message.version.version) << bigEndian32(message.version.sub) << bigEndian32(mutation.size());
 	state Standalone<StringRef> header = wr.toValue();
 
+	if (compressedWriter) {
+		wait(CompressedLogFileWriter::add(compressedWriter, header, mutation));
+		return Void();
+	}
+
 	// Start a new block if needed
 	if (logFile->size() + bytes > *blockEnd) {
 		// Write padding if needed
@@ -738,6 +852,7 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 	state std::vector<UID> activeUids; // active Backups' UIDs
 	state std::vector<Version> beginVersions; // logFiles' begin versions
 	state KeyRangeMap<std::set<int>> keyRangeMap; // range to index in logFileFutures, logFiles, & blockEnds
+	state std::vector<std::unique_ptr<CompressedLogFileWriter>> compressedWriters; // empty unless compressing
 	state std::vector<Standalone<StringRef>> mutations;
 	state std::unordered_map<BlobCipherDetails, Reference<BlobCipherKey>> cipherKeys;
 	state int idx;
@@ -800,6 +915,12 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 	}
 
 	blockEnds = std::vector<int64_t>(logFiles.size(), 0);
+	if (SERVER_KNOBS->BACKUP_WORKER_COMPRESS_LOG_FILES) {
+		CODE_PROBE(true, "Backup worker compressing mutation log files");
+		for (const auto& file : logFiles) {
+			compressedWriters.push_back(std::make_unique<CompressedLogFileWriter>(file, blockSize));
+		}
+	}
 	for (idx = 0; idx < numMsg; idx++) {
 		auto& message = self->messages[idx];
 		MutationRef m;
@@ -814,8 +935,12 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 		if (m.type != MutationRef::Type::ClearRange) {
 			for (int index : keyRangeMap[m.param1]) {
 				if (message.getVersion() >= beginVersions[index]) {
-					adds.push_back(
-					    addMutation(logFiles[index], message, message.message, &blockEnds[index], blockSize));
+					adds.push_back(addMutation(logFiles[index],
+					                           compressedWriters.empty() ? nullptr : compressedWriters[index].get(),
+					                           message,
+					                           message.message,
+					                           &blockEnds[index],
+					                           blockSize));
 				}
 			}
 		} else {
@@ -832,8 +957,12 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 				mutations.push_back(wr.toValue());
 				for (int index : range.value()) {
 					if (message.getVersion() >= beginVersions[index]) {
-						adds.push_back(
-						    addMutation(logFiles[index], message, mutations.back(), &blockEnds[index], blockSize));
+						adds.push_back(addMutation(logFiles[index],
+						                           compressedWriters.empty() ? nullptr : compressedWriters[index].get(),
+						                           message,
+						                           mutations.back(),
+						                           &blockEnds[index],
+						                           blockSize));
 					}
 				}
 			}
@@ -843,9 +972,10 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 	}
 
 	std::vector<Future<Void>> finished;
-	std::transform(logFiles.begin(), logFiles.end(), std::back_inserter(finished), [](const Reference<IBackupFile>& f) {
-		return f->finish();
-	});
+	for (int i = 0; i < logFiles.size(); i++) {
+		finished.push_back(compressedWriters.empty() ? logFiles[i]->finish()
+		                                             : CompressedLogFileWriter::finish(compressedWriters[i].get()));
+	}
 
 	wait(waitForAll(finished));
 
@@ -866,6 +996,7 @@ ACTOR Future<Void> saveMutationsToFile(BackupData* self,
 // Uploads self->messages to cloud storage and updates savedVersion.
 ACTOR Future<Void> uploadData(BackupData* self) {
 	state Version popVersion = invalidVersion;
+	state double lastSaveTime = now();
 
 	loop {
 		// Too large uploadDelay will delay popping tLog data for too long.
@@ -903,7 +1034,13 @@ ACTOR Future<Void> uploadData(BackupData* self) {
 			// queuing more, then we are stuck. This could suggest the lock capacity is too small.
 			ASSERT(numMsg > 0 || self->lock->waiters() == 0);
 		}
-		if (((numMsg > 0 || popVersion > lastPopVersion) && self->pulling) || self->pullFinished()) {
+		// Batch messages into fewer, larger files, unless holding on to them would block pulling more
+		const bool batchFull = self->lock->activePermits() >= SERVER_KNOBS->BACKUP_WORKER_MIN_FILE_BYTES ||
+		                       now() - lastSaveTime >= SERVER_KNOBS->BACKUP_WORKER_MAX_FILE_DELAY ||
+		                       self->lock->waiters() > 0;
+		if (self->pulling && !batchFull && !self->pullFinished()) {
+			popVersion = lastPopVersion;
+		} else if (((numMsg > 0 || popVersion > lastPopVersion) && self->pulling) || self->pullFinished()) {
 			TraceEvent("BackupWorkerSave", self->myId)
 			    .detail("Version", popVersion)
 			    .detail("LastPopVersion", lastPopVersion)
@@ -914,6 +1051,7 @@ ACTOR Future<Void> uploadData(BackupData* self) {
 			// save an empty file for old epochs so that log file versions are continuous
 			wait(saveMutationsToFile(self, popVersion, numMsg, cipherDetails));
 			self->eraseMessages(numMsg);
+			lastSaveTime = now();
 		}
 
 		// If transition into NOOP mode, should clear messages
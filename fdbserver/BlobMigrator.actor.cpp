@@ -670,6 +670,18 @@ private:
 						dprint("Unsupported GetValueRequest\n");
 						req.reply.sendError(unsupported_operation());
 					}
+					when(GetValuesRequest req = waitNext(ssi.getValues.getFuture())) {
+						dprint("Unsupported GetValuesRequest\n");
+						req.reply.sendError(unsupported_operation());
+					}
+					when(WatchRangeRequest req = waitNext(ssi.watchRange.getFuture())) {
+						dprint("Unsupported WatchRangeRequest\n");
+						req.reply.sendError(unsupported_operation());
+					}
+					when(GetHotKeysRequest req = waitNext(ssi.getHotKeys.getFuture())) {
+						dprint("Unsupported GetHotKeysRequest\n");
+						req.reply.sendError(unsupported_operation());
+					}
 					when(GetCheckpointRequest req = waitNext(ssi.checkpoint.getFuture())) {
 						dprint("Unsupported GetCheckpoint \n");
 						req.reply.sendError(unsupported_operation());
@@ -152,6 +152,14 @@ void GranuleRangeMetadata::cancel() {
  * It is responsible for managing the change feeds for those granules, and for consuming the mutations from
  * those change feeds and writing them out as files to blob storage.
  */
+void BlobWorkerData::initDiskCache(const std::string& folder) {
+	if (SERVER_KNOBS->BLOB_WORKER_DISK_CACHE_BYTES > 0) {
+		// There is only ever one blob worker per process, so it can reuse the last one's folder
+		diskCache = makeReference<BlobGranuleDiskCache>(joinPath(folder, "blobcache"),
+		                                                SERVER_KNOBS->BLOB_WORKER_DISK_CACHE_BYTES);
+	}
+}
+
 bool BlobWorkerData::managerEpochOk(int64_t epoch) {
 	if (epoch < currentManagerEpoch) {
 		if (BW_DEBUG) {
@@ -716,7 +724,8 @@ ACTOR Future<BlobFileIndex> writeDeltaFile(Reference<BlobWorkerData> bwData,
 	                                                   keyRange,
 	                                                   SERVER_KNOBS->BG_DELTA_FILE_TARGET_CHUNK_BYTES,
 	                                                   compressFilter,
-	                                                   cipherKeysCtx);
+	                                                   cipherKeysCtx,
+	                                                   SERVER_KNOBS->BG_DELTA_FILE_COLUMNAR);
 	state size_t logicalSize = deltasToWrite.expectedSize();
 	state size_t serializedSize = serialized.size();
 	bwData->stats.compressionBytesRaw += logicalSize;
@@ -1265,7 +1274,7 @@ ACTOR Future<BlobFileIndex> compactFromBlob(Reference<BlobWorkerData> bwData,
 	}
 
 	state Arena filenameArena;
-	state std::vector<Future<RangeResult>> chunksToRead;
+	state std::vector<BlobGranuleChunkRef> chunksToRead;
 	state int64_t compactBytesRead = 0;
 	state double resnapshotStartTimer = g_network->timer();
 
@@ -1338,7 +1347,7 @@ ACTOR Future<BlobFileIndex> compactFromBlob(Reference<BlobWorkerData> bwData,
 		}
 		ASSERT(lastDeltaVersion >= version);
 		chunk.includedVersion = version;
-		chunksToRead.push_back(readBlobGranule(chunk, metadata->keyRange, 0, version, bstore, &bwData->stats));
+		chunksToRead.push_back(chunk);
 	}
 
 	if (BW_DEBUG) {
@@ -1359,10 +1368,18 @@ ACTOR Future<BlobFileIndex> compactFromBlob(Reference<BlobWorkerData> bwData,
 		                                                           version,
 		                                                           rowsStream,
 		                                                           false);
+		// Merge the old snapshot with the deltas a slice at a time, one granule at a time, rather than materializing
+		// every granule being compacted at once
 		state int resultIdx;
 		for (resultIdx = 0; resultIdx < chunksToRead.size(); resultIdx++) {
-			RangeResult newGranuleChunk = wait(chunksToRead[resultIdx]);
-			rowsStream.send(std::move(newGranuleChunk));
+			wait(streamBlobGranule(chunksToRead[resultIdx],
+			                       metadata->keyRange,
+			                       version,
+			                       bstore,
+			                       rowsStream,
+			                       SERVER_KNOBS->BG_RESNAPSHOT_SLICE_BYTES,
+			                       &bwData->stats,
+			                       bwData->diskCache));
 		}
 
 		bwData->stats.bytesReadFromS3ForCompaction += compactBytesRead;
@@ -5619,12 +5636,14 @@ ACTOR Future<Void> checkUpdateEncryptionAtRestMode(Reference<BlobWorkerData> sel
 ACTOR Future<Void> blobWorker(BlobWorkerInterface bwInterf,
                               ReplyPromise<InitializeBlobWorkerReply> recruitReply,
                               Reference<AsyncVar<ServerDBInfo> const> dbInfo,
-                              IKeyValueStore* persistentData) {
+                              IKeyValueStore* persistentData,
+                              std::string folder) {
 
 	state Database cx = openDBOnServer(dbInfo, TaskPriority::DefaultEndpoint, LockAware::True);
 	state Reference<BlobWorkerData> self(new BlobWorkerData(bwInterf.id(), dbInfo, cx, persistentData));
 	self->id = bwInterf.id();
 	self->locality = bwInterf.locality;
+	self->initDiskCache(folder);
 
 	TraceEvent("BlobWorkerInitStart", self->id).detail("Recovering", false).log();
 
@@ -5714,12 +5733,14 @@ ACTOR Future<UID> restorePersistentState(Reference<BlobWorkerData> self) {
 ACTOR Future<Void> blobWorker(BlobWorkerInterface bwInterf,
                               Promise<Void> recovered,
                               Reference<AsyncVar<ServerDBInfo> const> dbInfo,
-                              IKeyValueStore* persistentData) {
+                              IKeyValueStore* persistentData,
+                              std::string folder) {
 
 	state Database cx = openDBOnServer(dbInfo, TaskPriority::DefaultEndpoint, LockAware::True);
 	state Reference<BlobWorkerData> self(new BlobWorkerData(bwInterf.id(), dbInfo, cx, persistentData));
 	self->id = bwInterf.id();
 	self->locality = bwInterf.locality;
+	self->initDiskCache(folder);
 	TraceEvent("BlobWorkerInitStart", self->id).detail("Recovering", true).log();
 
 	try {
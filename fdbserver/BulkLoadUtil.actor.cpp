@@ -25,6 +25,7 @@
 #include "fdbserver/RocksDBCheckpointUtils.actor.h"
 #include "fdbserver/StorageMetrics.actor.h"
 #include <fmt/format.h>
+#include <queue>
 #include "flow/actorcompiler.h" // has to be last include
 
 std::string generateRandomBulkLoadDataFileName() {
@@ -172,3 +173,105 @@ void checkContent(std::unordered_set<std::string> dataFiles, UID logId) {
 	}
 	return;
 }
+
+namespace {
+
+// Merges the pairs of several SST files, each sorted by key, into one sorted stream
+class SSTFileMerger {
+public:
+	explicit SSTFileMerger(const std::unordered_set<std::string>& dataFiles) {
+		for (const auto& filePath : dataFiles) {
+			std::unique_ptr<IRocksDBSstFileReader> reader = newRocksDBSstFileReader();
+			if (!reader) {
+				throw not_implemented();
+			}
+			reader->open(abspath(filePath));
+			readers.push_back(std::move(reader));
+			advance(readers.size() - 1);
+		}
+	}
+
+	bool hasNext() const { return !heads.empty(); }
+
+	// A key found in more than one file is returned once, with its value from whichever file comes first
+	KeyValue next() {
+		Head head = heads.top();
+		heads.pop();
+		advance(head.reader);
+		while (!heads.empty() && heads.top().kv.key == head.kv.key) {
+			int duplicate = heads.top().reader;
+			heads.pop();
+			advance(duplicate);
+		}
+		return head.kv;
+	}
+
+private:
+	struct Head {
+		KeyValue kv;
+		int reader;
+
+		// Reversed, so that the priority queue returns the smallest key first
+		bool operator<(const Head& r) const { return kv.key != r.kv.key ? kv.key > r.kv.key : reader > r.reader; }
+	};
+
+	std::vector<std::unique_ptr<IRocksDBSstFileReader>> readers;
+	std::priority_queue<Head> heads;
+
+	void advance(int reader) {
+		if (readers[reader]->hasNext()) {
+			heads.push(Head{ readers[reader]->next(), reader });
+		}
+	}
+};
+
+} // namespace
+
+ACTOR Future<Void> bulkLoadReadSSTFiles(PromiseStream<RangeResult> results,
+                                        std::unordered_set<std::string> dataFiles,
+                                        KeyRange range,
+                                        int blockBytes,
+                                        UID logId) {
+	state std::unique_ptr<SSTFileMerger> merger;
+	state bool more = true;
+	try {
+		merger = std::make_unique<SSTFileMerger>(dataFiles);
+		while (more) {
+			{
+				RangeResult block;
+				while (block.expectedSize() < blockBytes) {
+					if (!merger->hasNext()) {
+						more = false;
+						break;
+					}
+					KeyValue kv = merger->next();
+					if (kv.key >= range.end) {
+						more = false;
+						break;
+					}
+					if (kv.key >= range.begin) {
+						block.push_back_deep(block.arena(), kv);
+					}
+				}
+				block.more = more;
+				results.send(block);
+			}
+			if (more) {
+				wait(yield(TaskPriority::FetchKeys));
+			}
+		}
+		results.sendError(end_of_stream());
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw e;
+		}
+		TraceEvent(SevWarn, "SSBulkLoadTaskReadSSTFileError", logId)
+		    .errorUnsuppressed(e)
+		    .detail("Range", range)
+		    .detail("DataFiles", describe(dataFiles));
+		// fetchKeys() retries, so don't let it spin on files that can't be read
+		wait(delay(5.0));
+		results.sendError(bulkload_task_failed());
+	}
+	return Void();
+}
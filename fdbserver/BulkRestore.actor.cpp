@@ -0,0 +1,603 @@
+/*
+ * BulkRestore.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/BulkRestore.actor.h"
+
+#include "fdbclient/BackupAgent.actor.h"
+#include "fdbclient/BulkLoading.h"
+#include "fdbclient/KeyRangeMap.h"
+#include "fdbclient/ManagementAPI.actor.h"
+#include "fdbclient/SystemData.h"
+#include "fdbserver/BulkLoadUtil.actor.h"
+#include "fdbserver/Knobs.h"
+#include "fdbserver/RocksDBCheckpointUtils.actor.h"
+#include "fdbserver/StorageMetrics.actor.h"
+#include "flow/Platform.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace {
+
+// Under each restore's ID, the number of transactions of log mutations applied to each shard, so that a transaction
+// retried after commit_unknown_result is not applied twice
+const KeyRef bulkRestoreProgressPrefix = "\xff\x02/bulkRestoreProgress/"_sr;
+
+struct BulkRestoreShard {
+	KeyRange range;
+	std::vector<RangeFile> files; // In key order
+	int64_t bytes = 0;
+};
+
+struct VersionedMutation {
+	Version version;
+	MutationRef mutation;
+};
+
+// Decoded log mutations waiting to be applied, by shard and in version order
+struct BulkRestoreLogBatch {
+	Arena arena;
+	std::vector<std::vector<VersionedMutation>> mutations;
+	int64_t bytes = 0;
+
+	explicit BulkRestoreLogBatch(int shards) : mutations(shards) {}
+};
+
+struct BulkRestoreData {
+	UID id;
+	Database cx;
+	Reference<IBackupContainer> container;
+	KeyRange restoreRange;
+	Version targetVersion;
+	std::string dataFolder; // Where this restore's SST files go
+	Key progressPrefix;
+
+	std::vector<BulkRestoreShard> shards;
+	KeyRangeMap<int> shardIndex;
+	KeyRangeMap<Version> rangeVersions; // The version of the range file each key is restored from
+	std::vector<int64_t> transactionsApplied; // By shard
+	FlowLock parallelism;
+
+	int64_t snapshotKeys = 0;
+	int64_t snapshotBytes = 0;
+	int64_t loadedShards = 0;
+	int64_t logMutations = 0;
+	int64_t skippedMutations = 0;
+	int64_t transactions = 0;
+
+	BulkRestoreData(Database cx,
+	                Reference<IBackupContainer> container,
+	                KeyRange restoreRange,
+	                Version targetVersion,
+	                std::string folder)
+	  : id(deterministicRandom()->randomUniqueID()), cx(cx), container(container), restoreRange(restoreRange),
+	    targetVersion(targetVersion), dataFolder(joinPath(folder, id.toString())),
+	    progressPrefix(bulkRestoreProgressPrefix.withSuffix(BinaryWriter::toValue(id, Unversioned()))),
+	    rangeVersions(invalidVersion), parallelism(SERVER_KNOBS->BULK_RESTORE_PARALLELISM) {}
+
+	Key progressKey(int shard) const {
+		return progressPrefix.withSuffix(BinaryWriter::toValue(bigEndian32(shard), Unversioned()));
+	}
+};
+
+} // namespace
+
+// Splits restoreRange at range file boundaries into shards with about shardBytes of range files each, or one file if
+// it is bigger. The shards cover all of restoreRange, so that every log mutation in it falls in one of them.
+static std::vector<BulkRestoreShard> planBulkRestoreShards(std::vector<RangeFile> files,
+                                                           std::map<std::string, KeyRange> const& keyRanges,
+                                                           KeyRangeRef restoreRange,
+                                                           int64_t shardBytes) {
+	std::sort(files.begin(), files.end(), [&keyRanges](RangeFile const& a, RangeFile const& b) {
+		return keyRanges.at(a.fileName).begin < keyRanges.at(b.fileName).begin;
+	});
+	std::vector<BulkRestoreShard> shards(1);
+	Key begin = restoreRange.begin;
+	for (auto const& file : files) {
+		KeyRange fileRange = keyRanges.at(file.fileName) & restoreRange;
+		if (fileRange.empty()) {
+			continue;
+		}
+		if (shards.back().bytes >= shardBytes) {
+			shards.back().range = KeyRangeRef(begin, fileRange.begin);
+			begin = fileRange.begin;
+			shards.emplace_back();
+		}
+		shards.back().files.push_back(file);
+		shards.back().bytes += file.fileSize;
+	}
+	shards.back().range = KeyRangeRef(begin, restoreRange.end);
+	return shards;
+}
+
+// Maps each key of restoreRange to its shard, and to the version of the range file it is restored from
+static void indexBulkRestoreShards(std::vector<BulkRestoreShard> const& shards,
+                                   std::map<std::string, KeyRange> const& keyRanges,
+                                   KeyRangeRef restoreRange,
+                                   KeyRangeMap<int>* shardIndex,
+                                   KeyRangeMap<Version>* rangeVersions) {
+	for (int i = 0; i < shards.size(); i++) {
+		shardIndex->insert(shards[i].range, i);
+		for (auto const& file : shards[i].files) {
+			rangeVersions->insert(keyRanges.at(file.fileName) & restoreRange, file.version);
+		}
+	}
+}
+
+// Adds the parts of m, committed at version, that are in restoreRange and newer than the range files there to batch,
+// split by shard. Returns false if there are none.
+static bool addLogMutation(BulkRestoreLogBatch* batch,
+                           KeyRangeMap<Version> const& rangeVersions,
+                           KeyRangeMap<int> const& shardIndex,
+                           KeyRangeRef restoreRange,
+                           Version version,
+                           MutationRef const& m) {
+	if (m.type != MutationRef::ClearRange) {
+		if (!restoreRange.contains(m.param1) || rangeVersions[m.param1] >= version) {
+			return false;
+		}
+		batch->mutations[shardIndex[m.param1]].push_back({ version, MutationRef(batch->arena, m) });
+		batch->bytes += m.expectedSize();
+		return true;
+	}
+
+	KeyRangeRef cleared = KeyRangeRef(m.param1, m.param2) & restoreRange;
+	if (cleared.empty()) {
+		return false;
+	}
+	bool added = false;
+	for (auto r : rangeVersions.intersectingRanges(cleared)) {
+		if (r.value() >= version) {
+			continue;
+		}
+		KeyRangeRef unloaded = r.range() & cleared;
+		for (auto s : shardIndex.intersectingRanges(unloaded)) {
+			KeyRangeRef piece = s.range() & unloaded;
+			batch->mutations[s.value()].push_back(
+			    { version, MutationRef(batch->arena, MutationRef::ClearRange, piece.begin, piece.end) });
+			batch->bytes += piece.expectedSize();
+			added = true;
+		}
+	}
+	return added;
+}
+
+static void applyLogMutation(Transaction* tr, MutationRef const& m) {
+	if (m.type == MutationRef::SetValue) {
+		tr->set(m.param1, m.param2);
+	} else if (m.type == MutationRef::ClearRange) {
+		tr->clear(KeyRangeRef(m.param1, m.param2));
+	} else if (isAtomicOp((MutationRef::Type)m.type)) {
+		tr->atomicOp(m.param1, m.param2, (MutationRef::Type)m.type);
+	} else {
+		TraceEvent(SevWarnAlways, "BulkRestoreUnexpectedMutation").detail("Mutation", m);
+		throw restore_corrupted_data();
+	}
+}
+
+ACTOR static Future<Void> checkDestinationEmpty(Database cx, KeyRange range) {
+	state Transaction tr(cx);
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			RangeResult existing = wait(tr.getRange(range, 1));
+			if (!existing.empty()) {
+				throw restore_destination_not_empty();
+			}
+			return Void();
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+}
+
+// Writes the key-values of a shard, which come out of its range files in key order, to an SST file, and their byte
+// sample to another. Returns the bulk load task for them, or nothing if the shard is empty.
+ACTOR static Future<Optional<BulkLoadState>> convertShard(BulkRestoreData* self, int shard) {
+	wait(self->parallelism.take());
+	state FlowLock::Releaser releaser(self->parallelism);
+
+	state BulkRestoreShard const* s = &self->shards[shard];
+	state std::string dataFile = joinPath(self->dataFolder, generateRandomBulkLoadDataFileName());
+	state std::string bytesSampleFile = joinPath(self->dataFolder, generateRandomBulkLoadBytesSampleFileName());
+	state std::unique_ptr<IRocksDBSstFileWriter> writer = newRocksDBSstFileWriter();
+	state std::vector<KeyValue> bytesSample;
+	state Key lastKey;
+	state int64_t keys = 0;
+	state int fileIndex = 0;
+
+	writer->open(abspath(dataFile));
+	for (; fileIndex < s->files.size(); fileIndex++) {
+		state RangeFile file = s->files[fileIndex];
+		state Reference<IAsyncFile> inFile = wait(self->container->readFile(file.fileName));
+		state int64_t offset = 0;
+		for (; offset < file.fileSize; offset += file.blockSize) {
+			state Standalone<VectorRef<KeyValueRef>> block;
+			wait(store(block,
+			           fileBackup::decodeRangeFileBlock(
+			               inFile, offset, std::min<int64_t>(file.blockSize, file.fileSize - offset), self->cx)));
+			// The first and last keys are the range of the block
+			for (int i = 1; i < int(block.size()) - 1; i++) {
+				KeyValueRef kv = block[i];
+				if (!s->range.contains(kv.key)) {
+					continue;
+				}
+				if (keys > 0 && kv.key <= lastKey) {
+					TraceEvent(SevWarnAlways, "BulkRestoreUnsortedRangeFile", self->id)
+					    .detail("File", file.fileName)
+					    .detail("Key", kv.key)
+					    .detail("PreviousKey", lastKey);
+					throw restore_corrupted_data();
+				}
+				writer->write(kv.key, kv.value);
+				ByteSampleInfo sampleInfo = isKeyValueInSample(kv);
+				if (sampleInfo.inSample) {
+					bytesSample.push_back(KeyValue(
+					    KeyValueRef(kv.key, BinaryWriter::toValue(sampleInfo.sampledSize, Unversioned()))));
+				}
+				lastKey = kv.key;
+				keys++;
+				self->snapshotBytes += kv.expectedSize();
+			}
+			wait(yield());
+		}
+	}
+	self->snapshotKeys += keys;
+
+	TraceEvent("BulkRestoreShardConverted", self->id)
+	    .detail("Range", s->range)
+	    .detail("RangeFiles", s->files.size())
+	    .detail("RangeFileBytes", s->bytes)
+	    .detail("Keys", keys)
+	    .detail("BytesSampleKeys", bytesSample.size());
+	if (!writer->finish()) {
+		deleteFile(abspath(dataFile));
+		return Optional<BulkLoadState>();
+	}
+	if (!bytesSample.empty()) {
+		writer->open(abspath(bytesSampleFile));
+		for (auto const& kv : bytesSample) {
+			writer->write(kv.key, kv.value);
+		}
+		ASSERT(writer->finish());
+	}
+	return newBulkLoadTaskLocalSST(s->range, self->dataFolder, dataFile, bytesSampleFile);
+}
+
+// Converts a shard and bulk loads it
+ACTOR static Future<Void> loadShard(BulkRestoreData* self, int shard) {
+	state Optional<BulkLoadState> task = wait(convertShard(self, shard));
+	if (!task.present()) {
+		return Void();
+	}
+
+	wait(submitBulkLoadTask(self->cx, task.get()));
+	loop {
+		state Transaction tr(self->cx);
+		try {
+			tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			BulkLoadState current = wait(
+			    getBulkLoadTask(&tr, task.get().getRange(), task.get().getTaskId(), std::vector<BulkLoadPhase>()));
+			if (current.phase == BulkLoadPhase::Complete) {
+				break;
+			}
+			wait(delay(SERVER_KNOBS->DD_BULKLOAD_SCHEDULE_MIN_INTERVAL_SEC));
+		} catch (Error& e) {
+			if (e.code() == error_code_bulkload_task_outdated) {
+				// Someone else has submitted a bulk load task over this one
+				TraceEvent(SevWarnAlways, "BulkRestoreTaskOverwritten", self->id)
+				    .detail("Task", task.get().toString());
+				throw bulkload_task_failed();
+			}
+			wait(tr.onError(e));
+		}
+	}
+	wait(acknowledgeBulkLoadTask(self->cx, task.get().getRange(), task.get().getTaskId()));
+	self->loadedShards++;
+	return Void();
+}
+
+// Applies a shard's part of a batch of log mutations in version order, in transactions of about
+// SERVER_KNOBS->BULK_RESTORE_TRANSACTION_BYTES
+ACTOR static Future<Void> applyShardMutations(BulkRestoreData* self,
+                                              int shard,
+                                              std::vector<VersionedMutation> const* mutations) {
+	wait(self->parallelism.take());
+	state FlowLock::Releaser releaser(self->parallelism);
+
+	state Key progressKey = self->progressKey(shard);
+	state int begin = 0;
+	while (begin < mutations->size()) {
+		state int end = begin;
+		{
+			int64_t bytes = 0;
+			while (end < mutations->size() && (end == begin || bytes < SERVER_KNOBS->BULK_RESTORE_TRANSACTION_BYTES)) {
+				bytes += (*mutations)[end++].mutation.expectedSize();
+			}
+		}
+
+		state int64_t transaction = self->transactionsApplied[shard] + 1;
+		state Transaction tr(self->cx);
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+				Optional<Value> progress = wait(tr.get(progressKey));
+				if (progress.present() && BinaryReader::fromStringRef<int64_t>(progress.get(), Unversioned()) >=
+				                              transaction) {
+					// Committed by an earlier attempt that ended in commit_unknown_result
+					break;
+				}
+				for (int i = begin; i < end; i++) {
+					applyLogMutation(&tr, (*mutations)[i].mutation);
+				}
+				tr.set(progressKey, BinaryWriter::toValue(transaction, Unversioned()));
+				wait(tr.commit());
+				break;
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+		self->transactionsApplied[shard] = transaction;
+		self->transactions++;
+		begin = end;
+	}
+	return Void();
+}
+
+ACTOR static Future<Void> applyLogBatch(BulkRestoreData* self, BulkRestoreLogBatch* batch, Version version) {
+	state std::vector<Future<Void>> appliers;
+	for (int i = 0; i < batch->mutations.size(); i++) {
+		if (!batch->mutations[i].empty()) {
+			appliers.push_back(applyShardMutations(self, i, &batch->mutations[i]));
+		}
+	}
+	wait(waitForAll(appliers));
+	TraceEvent("BulkRestoreLogBatchApplied", self->id)
+	    .detail("Version", version)
+	    .detail("Bytes", batch->bytes)
+	    .detail("Shards", appliers.size());
+	return Void();
+}
+
+// Adds the chunks of mutation log in block to pending and moves the versions that are complete, in order, to batch
+static void decodeLogBlock(BulkRestoreData* self,
+                           VectorRef<KeyValueRef> block,
+                           std::map<Version, fileBackup::AccumulatedMutations>* pending,
+                           Version* lastVersion,
+                           BulkRestoreLogBatch* batch) {
+	for (auto const& kv : block) {
+		auto [version, part] = fileBackup::decodeMutationLogKey(kv.key);
+		// A version can also be in an earlier file that overlaps this one
+		if (version > self->targetVersion || version <= *lastVersion) {
+			continue;
+		}
+		(*pending)[version].addChunk(part, kv);
+	}
+
+	while (!pending->empty() && pending->begin()->second.isComplete()) {
+		Version version = pending->begin()->first;
+		for (auto const& m : fileBackup::decodeMutationLogValue(pending->begin()->second.serializedMutations)) {
+			if (m.type == MutationRef::Encrypted) {
+				TraceEvent(SevWarnAlways, "BulkRestoreEncryptedMutationLog", self->id).detail("Version", version);
+				throw restore_unsupported_file_version();
+			}
+			if (addLogMutation(batch, self->rangeVersions, self->shardIndex, self->restoreRange, version, m)) {
+				self->logMutations++;
+			} else {
+				self->skippedMutations++;
+			}
+		}
+		*lastVersion = version;
+		pending->erase(pending->begin());
+	}
+}
+
+// Reads the mutation logs in version order and applies them in batches of about
+// SERVER_KNOBS->BULK_RESTORE_LOG_BATCH_BYTES
+ACTOR static Future<Void> applyLogs(BulkRestoreData* self, std::vector<LogFile> logs) {
+	state std::map<Version, fileBackup::AccumulatedMutations> pending;
+	state Version lastVersion = invalidVersion;
+	state std::unique_ptr<BulkRestoreLogBatch> batch = std::make_unique<BulkRestoreLogBatch>(self->shards.size());
+	state int fileIndex = 0;
+
+	std::sort(logs.begin(), logs.end());
+	for (; fileIndex < logs.size() && logs[fileIndex].beginVersion <= self->targetVersion; fileIndex++) {
+		state LogFile file = logs[fileIndex];
+		state Reference<IAsyncFile> inFile = wait(self->container->readFile(file.fileName));
+		state int64_t offset = 0;
+		for (; offset < file.fileSize; offset += file.blockSize) {
+			state Standalone<VectorRef<KeyValueRef>> block;
+			wait(store(block,
+			           fileBackup::decodeMutationLogFileBlock(
+			               inFile, offset, std::min<int64_t>(file.blockSize, file.fileSize - offset))));
+			decodeLogBlock(self, block, &pending, &lastVersion, batch.get());
+			if (batch->bytes >= SERVER_KNOBS->BULK_RESTORE_LOG_BATCH_BYTES) {
+				wait(applyLogBatch(self, batch.get(), lastVersion));
+				batch = std::make_unique<BulkRestoreLogBatch>(self->shards.size());
+			}
+		}
+	}
+	if (!pending.empty()) {
+		TraceEvent(SevWarnAlways, "BulkRestoreIncompleteMutationLog", self->id)
+		    .detail("Version", pending.begin()->first)
+		    .detail("IncompleteVersions", pending.size());
+		throw restore_missing_data();
+	}
+	wait(applyLogBatch(self, batch.get(), lastVersion));
+	return Void();
+}
+
+ACTOR static Future<Void> clearProgress(BulkRestoreData* self) {
+	state Transaction tr(self->cx);
+	loop {
+		try {
+			tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+			tr.clear(prefixRange(self->progressPrefix));
+			wait(tr.commit());
+			return Void();
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+}
+
+ACTOR Future<Void> bulkRestore(Database cx,
+                               Reference<IBackupContainer> container,
+                               KeyRange restoreRange,
+                               Version targetVersion,
+                               std::string folder) {
+	state BulkRestoreData self(cx, container, restoreRange, targetVersion, folder);
+	state double startTime = now();
+	state Standalone<VectorRef<KeyRangeRef>> keyRangesFilter;
+	state Optional<RestorableFileSet> restoreSet;
+	state int previousBulkLoadMode = 0;
+	state std::vector<Future<Void>> loads;
+
+	if (restoreRange.empty() || !normalKeys.contains(restoreRange)) {
+		throw client_invalid_operation();
+	}
+	if (!newRocksDBSstFileWriter()) {
+		// Built without RocksDB
+		throw not_implemented();
+	}
+
+	TraceEvent("BulkRestoreStart", self.id)
+	    .detail("Container", container->getURL())
+	    .detail("Range", restoreRange)
+	    .detail("TargetVersion", targetVersion)
+	    .detail("Folder", self.dataFolder);
+
+	keyRangesFilter.push_back_deep(keyRangesFilter.arena(), restoreRange);
+	wait(store(restoreSet, container->getRestoreSet(targetVersion, keyRangesFilter)));
+	if (!restoreSet.present()) {
+		throw restore_missing_data();
+	}
+	for (auto const& log : restoreSet.get().logs) {
+		if (log.isPartitionedLog()) {
+			TraceEvent(SevWarnAlways, "BulkRestorePartitionedLogs", self.id).detail("File", log.fileName);
+			throw restore_unsupported_file_version();
+		}
+	}
+	for (auto const& file : restoreSet.get().ranges) {
+		if (!restoreSet.get().keyRanges.count(file.fileName)) {
+			// Backups from before 6.3 don't record the range of each range file
+			TraceEvent(SevWarnAlways, "BulkRestoreUnknownRangeFileRange", self.id).detail("File", file.fileName);
+			throw restore_unsupported_file_version();
+		}
+	}
+	wait(checkDestinationEmpty(cx, restoreRange));
+
+	self.shards = planBulkRestoreShards(
+	    restoreSet.get().ranges, restoreSet.get().keyRanges, restoreRange, SERVER_KNOBS->BULK_RESTORE_SHARD_BYTES);
+	indexBulkRestoreShards(
+	    self.shards, restoreSet.get().keyRanges, restoreRange, &self.shardIndex, &self.rangeVersions);
+	self.transactionsApplied.resize(self.shards.size());
+	platform::createDirectory(self.dataFolder);
+
+	wait(store(previousBulkLoadMode, setBulkLoadMode(cx, 1)));
+	try {
+		for (int i = 0; i < self.shards.size(); i++) {
+			loads.push_back(loadShard(&self, i));
+		}
+		wait(waitForAll(loads));
+		TraceEvent("BulkRestoreSnapshotLoaded", self.id)
+		    .detail("Shards", self.shards.size())
+		    .detail("LoadedShards", self.loadedShards)
+		    .detail("Keys", self.snapshotKeys)
+		    .detail("Bytes", self.snapshotBytes)
+		    .detail("Duration", now() - startTime);
+
+		wait(applyLogs(&self, restoreSet.get().logs));
+		wait(clearProgress(&self));
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		state Error err = e;
+		TraceEvent(SevWarnAlways, "BulkRestoreFailed", self.id).error(err);
+		if (previousBulkLoadMode != 1) {
+			wait(success(setBulkLoadMode(cx, previousBulkLoadMode)));
+		}
+		throw err;
+	}
+	if (previousBulkLoadMode != 1) {
+		wait(success(setBulkLoadMode(cx, previousBulkLoadMode)));
+	}
+	platform::eraseDirectoryRecursive(self.dataFolder);
+
+	TraceEvent("BulkRestoreComplete", self.id)
+	    .detail("Range", restoreRange)
+	    .detail("TargetVersion", targetVersion)
+	    .detail("Shards", self.shards.size())
+	    .detail("LoadedShards", self.loadedShards)
+	    .detail("SnapshotKeys", self.snapshotKeys)
+	    .detail("SnapshotBytes", self.snapshotBytes)
+	    .detail("LogMutations", self.logMutations)
+	    .detail("SkippedLogMutations", self.skippedMutations)
+	    .detail("Transactions", self.transactions)
+	    .detail("Duration", now() - startTime);
+	return Void();
+}
+
+TEST_CASE("/fdbserver/BulkRestore/SplitLogMutations") {
+	std::map<std::string, KeyRange> keyRanges;
+	keyRanges["f1"] = KeyRangeRef("a"_sr, "m"_sr);
+	keyRanges["f2"] = KeyRangeRef("m"_sr, "z"_sr);
+	std::vector<RangeFile> files = { RangeFile{ 20, 1000, "f2", 10 }, RangeFile{ 10, 1000, "f1", 10 } };
+	KeyRange restoreRange = KeyRangeRef("b"_sr, "y"_sr);
+
+	// With room for one file per shard, the shards split at the second file, and cover the whole restore range
+	ASSERT_EQ(planBulkRestoreShards(files, keyRanges, restoreRange, 100).size(), 1);
+	std::vector<BulkRestoreShard> shards = planBulkRestoreShards(files, keyRanges, restoreRange, 10);
+	ASSERT_EQ(shards.size(), 2);
+	ASSERT(shards[0].range == KeyRangeRef("b"_sr, "m"_sr));
+	ASSERT(shards[1].range == KeyRangeRef("m"_sr, "y"_sr));
+	ASSERT(shards[0].files.size() == 1 && shards[0].files[0].fileName == "f1");
+
+	KeyRangeMap<int> shardIndex;
+	KeyRangeMap<Version> rangeVersions(invalidVersion);
+	indexBulkRestoreShards(shards, keyRanges, restoreRange, &shardIndex, &rangeVersions);
+	BulkRestoreLogBatch batch(shards.size());
+
+	auto add = [&](Version version, MutationRef::Type type, StringRef param1, StringRef param2) {
+		return addLogMutation(
+		    &batch, rangeVersions, shardIndex, restoreRange, version, MutationRef(type, param1, param2));
+	};
+
+	// Mutations outside the restore range, or already in the range files, are skipped
+	ASSERT(!add(15, MutationRef::SetValue, "a"_sr, "1"_sr));
+	ASSERT(!add(10, MutationRef::SetValue, "c"_sr, "1"_sr));
+	ASSERT(!add(15, MutationRef::SetValue, "n"_sr, "1"_sr));
+	ASSERT(add(15, MutationRef::AddValue, "c"_sr, "1"_sr));
+	ASSERT(!add(5, MutationRef::ClearRange, "a"_sr, "z"_sr));
+
+	// Clears are cut down to the parts of the restore range whose range files are older, and split by shard
+	ASSERT(add(15, MutationRef::ClearRange, "a"_sr, "p"_sr));
+	ASSERT(add(25, MutationRef::ClearRange, "c"_sr, "z"_sr));
+	ASSERT_EQ(batch.mutations[0].size(), 3);
+	ASSERT_EQ(batch.mutations[1].size(), 1);
+	ASSERT(batch.mutations[0][1].mutation.param1 == "b"_sr && batch.mutations[0][1].mutation.param2 == "m"_sr);
+	ASSERT(batch.mutations[0][2].mutation.param1 == "c"_sr && batch.mutations[0][2].mutation.param2 == "m"_sr);
+	ASSERT(batch.mutations[1][0].mutation.param1 == "m"_sr && batch.mutations[1][0].mutation.param2 == "y"_sr);
+	ASSERT_EQ(batch.mutations[1][0].version, 25);
+	return Void();
+}
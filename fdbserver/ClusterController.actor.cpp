@@ -1451,6 +1451,29 @@ ACTOR Future<Void> timeKeeper(ClusterControllerData* self) {
 	}
 }
 
+// Keeps the cache's worker events up to date while status is being requested
+ACTOR Future<Void> refreshStatusWorkerEvents(ClusterControllerData* self, StatusWorkerEventCache* cache) {
+	loop {
+		while (now() - cache->lastRequested > SERVER_KNOBS->STATUS_WORKER_EVENT_IDLE_TIMEOUT) {
+			wait(cache->requested.onTrigger());
+		}
+
+		state double start = now();
+		state std::vector<WorkerDetails> workers;
+		for (auto& it : self->id_worker) {
+			workers.push_back(it.second.details);
+		}
+		StatusWorkerEvents events = wait(getStatusWorkerEvents(workers));
+		cache->events = std::move(events);
+		cache->addresses.clear();
+		for (auto const& worker : workers) {
+			cache->addresses.insert(worker.interf.address());
+		}
+		cache->updated = start;
+		wait(delay(SERVER_KNOBS->STATUS_WORKER_EVENT_REFRESH_INTERVAL));
+	}
+}
+
 ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
                                 ClusterControllerData* self,
                                 ServerCoordinators coordinators,
@@ -1461,12 +1484,19 @@ ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
 	// Place to accumulate a batch of requests to respond to
 	state std::vector<StatusRequest> requests_batch;
 
+	state StatusWorkerEventCache workerEventCache;
+	state Future<Void> workerEventRefresher = SERVER_KNOBS->STATUS_WORKER_EVENT_REFRESH_INTERVAL > 0
+	                                              ? refreshStatusWorkerEvents(self, &workerEventCache)
+	                                              : Never();
+
 	loop {
 		try {
 			// Wait til first request is ready
 			StatusRequest req = waitNext(requests);
 			++self->statusRequests;
 			requests_batch.push_back(req);
+			workerEventCache.lastRequested = now();
+			workerEventCache.requested.trigger();
 
 			// Earliest time at which we may begin a new request
 			double next_allowed_request_time = last_request_time + SERVER_KNOBS->STATUS_MIN_TIME_BETWEEN_REQUESTS;
@@ -1527,7 +1557,8 @@ ACTOR Future<Void> statusServer(FutureStream<StatusRequest> requests,
 			                                                                  self->dcStorageServerVersionDifference,
 			                                                                  configBroadcaster,
 			                                                                  self->db.metaclusterRegistration,
-			                                                                  self->db.metaclusterMetrics)));
+			                                                                  self->db.metaclusterMetrics,
+			                                                                  workerEventCache.get(workers))));
 
 			if (result.isError() && result.getError().code() == error_code_actor_cancelled)
 				throw result.getError();
@@ -27,7 +27,9 @@
 #include "fdbserver/Knobs.h"
 #include "fdbserver/MasterInterface.h"
 #include "fdbserver/WaitFailure.h"
+#include "flow/CompressionUtils.h"
 #include "flow/ProtocolVersion.h"
+#include "flow/WorkerPool.h"
 
 #include "flow/actorcompiler.h" // This must be the last #include.
 
@@ -1041,17 +1043,21 @@ ACTOR Future<std::vector<Standalone<CommitTransactionRef>>> recruitEverything(
 	// up so that the recruitment part happens above (in parallel with recruiting the transaction servers?).
 	wait(newSeedServers(self, recruits, seedServers));
 	state std::vector<Standalone<CommitTransactionRef>> confChanges;
-	wait(newCommitProxies(self, recruits) && newGrvProxies(self, recruits) && newResolvers(self, recruits) &&
-	     newTLogServers(self, recruits, oldLogSystem, &confChanges));
-
-	// Update recovery related information to the newly elected sequencer (master) process.
-	wait(brokenPromiseToNever(
-	    self->masterInterface.updateRecoveryData.getReply(UpdateRecoveryDataRequest(self->recoveryTransactionVersion,
-	                                                                                self->lastEpochEnd,
-	                                                                                self->commitProxies,
-	                                                                                self->resolvers,
-	                                                                                self->versionEpoch,
-	                                                                                self->primaryLocality))));
+	// newTLogServers picks the primary locality before it first waits, so it is known once this returns
+	state Future<Void> newTLogs = newTLogServers(self, recruits, oldLogSystem, &confChanges);
+	wait(newCommitProxies(self, recruits) && newGrvProxies(self, recruits) && newResolvers(self, recruits));
+
+	// Update recovery related information to the newly elected sequencer (master) process. It needs nothing from the
+	// new TLogs, so this overlaps with recruiting them, which is usually the slowest part of recruitment.
+	CODE_PROBE(!newTLogs.isReady(), "Sequencer updated while new TLogs are recruited");
+	wait(brokenPromiseToNever(self->masterInterface.updateRecoveryData.getReply(
+	         UpdateRecoveryDataRequest(self->recoveryTransactionVersion,
+	                                   self->lastEpochEnd,
+	                                   self->commitProxies,
+	                                   self->resolvers,
+	                                   self->versionEpoch,
+	                                   self->primaryLocality))) &&
+	     newTLogs);
 
 	return confChanges;
 }
@@ -1253,6 +1259,25 @@ ACTOR Future<Void> readTransactionSystemState(Reference<ClusterRecoveryData> sel
 	return Void();
 }
 
+// Compresses the part on the worker pool, so that parts are compressed in parallel with each other and with reading the
+// txnStateStore, and then broadcasts it
+ACTOR static Future<Void> compressAndBroadcastTxnState(TxnStateRequest req, CompressionFilter filter) {
+	Standalone<StringRef> compressed =
+	    wait(onWorkerPool([encoded = TxnStateRequest::encodeData(req.data).toString(), filter = filter]() {
+		    Standalone<StringRef> result;
+		    result.contents() = CompressionUtils::compress(filter, StringRef(encoded), result.arena());
+		    return result;
+	    }));
+	if (compressed.size() < req.data.expectedSize()) {
+		req.arena.dependsOn(compressed.arena());
+		req.compressedData = compressed;
+		req.compressionFilter = filter;
+		req.data = VectorRef<KeyValueRef>();
+	}
+	wait(broadcastTxnRequest(req, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, false));
+	return Void();
+}
+
 ACTOR Future<Void> sendInitialCommitToResolvers(Reference<ClusterRecoveryData> self) {
 	state KeyRange txnKeys = allKeys;
 	state Sequence txnSequence = 0;
@@ -1264,6 +1289,11 @@ ACTOR Future<Void> sendInitialCommitToResolvers(Reference<ClusterRecoveryData> s
 	        .get();
 	state std::vector<Future<Void>> txnReplies;
 	state int64_t dataOutstanding = 0;
+	state CompressionFilter compressionFilter =
+	    CompressionUtils::fromFilterString(SERVER_KNOBS->TXN_STATE_COMPRESSION_FILTER);
+	if (!CompressionUtils::supportedFilters.count(compressionFilter)) {
+		compressionFilter = CompressionFilter::NONE;
+	}
 
 	state std::vector<Endpoint> endpoints;
 	for (auto& it : self->commitProxies) {
@@ -1290,7 +1320,12 @@ ACTOR Future<Void> sendInitialCommitToResolvers(Reference<ClusterRecoveryData> s
 		req.sequence = txnSequence;
 		req.last = !nextData.size();
 		req.broadcastInfo = endpoints;
-		txnReplies.push_back(broadcastTxnRequest(req, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, false));
+		if (compressionFilter != CompressionFilter::NONE) {
+			CODE_PROBE(true, "Compressed txnStateStore part sent to commit proxies");
+			txnReplies.push_back(compressAndBroadcastTxnState(req, compressionFilter));
+		} else {
+			txnReplies.push_back(broadcastTxnRequest(req, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, false));
+		}
 		dataOutstanding += SERVER_KNOBS->TXN_STATE_SEND_AMOUNT * data.arena().getSize();
 		data = nextData;
 		txnSequence++;
@@ -0,0 +1,284 @@
+/*
+ * CommitPipelineBench.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbrpc/DDSketch.h"
+#include "fdbserver/ConflictSet.h"
+#include "fdbserver/Knobs.h"
+#include "fdbserver/LogSystem.h"
+#include "fdbserver/ResolverInterface.h"
+#include "fdbserver/ServerDBInfo.actor.h"
+#include "fdbserver/WorkerInterface.actor.h"
+#include "fdbserver/TestTLogServer.actor.h"
+#include "flow/genericactors.actor.h"
+#include "flow/IRandom.h"
+#include "flow/Platform.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace {
+
+// Measures the commit path behind the commit proxy, with a real resolver and real tLogs running in this process and
+// no storage servers. The benchmark plays the master and the commit proxy: it assigns versions, sends batches of
+// synthetic transactions to the resolver, tags the mutations of the committed ones and pushes them to the tLogs in
+// version order, keeping up to pipelineDepth batches in flight. Storage servers are stood in for by popping every tag
+// up to the last committed version now and then. Read snapshots are the last committed version when a batch is made,
+// as a client's read version would be, so concurrent batches writing the same keys conflict.
+struct CommitPipelineBench {
+	int batches;
+	int transactionsPerBatch;
+	int mutationsPerTransaction;
+	int readsPerTransaction;
+	int64_t keyCount;
+	int valueSize;
+	int pipelineDepth;
+	int popInterval;
+	Version versionsPerBatch;
+
+	Reference<TLogTestContext> tLogs;
+	ResolverInterface resolver;
+	Standalone<StringRef> valueSource;
+
+	Version committedVersion = 0;
+	Version lastReceivedVersion = 0;
+	int64_t committed = 0, conflicted = 0, mutations = 0, bytes = 0;
+	DDSketch<double> resolveLatency, tagLatency, logQueueLatency, logLatency, batchLatency;
+
+	explicit CommitPipelineBench(UnitTestParameters const& params)
+	  : batches(params.getInt("batches").orDefault(10000)),
+	    transactionsPerBatch(params.getInt("transactionsPerBatch").orDefault(100)),
+	    mutationsPerTransaction(params.getInt("mutationsPerTransaction").orDefault(5)),
+	    readsPerTransaction(params.getInt("readsPerTransaction").orDefault(5)),
+	    keyCount(params.getInt("keyCount").orDefault(1e6)), valueSize(params.getInt("valueSize").orDefault(100)),
+	    pipelineDepth(params.getInt("pipelineDepth").orDefault(4)),
+	    popInterval(params.getInt("popInterval").orDefault(100)),
+	    versionsPerBatch(params.getInt("versionsPerBatch").orDefault(SERVER_KNOBS->VERSIONS_PER_SECOND / 1000)) {
+		valueSource = makeString(valueSize);
+		deterministicRandom()->randomBytes(mutateString(valueSource), valueSize);
+	}
+
+	KeyRef randomKey(Arena& arena) const {
+		return KeyRef(arena, format("commitPipeline/%012" PRId64, deterministicRandom()->randomInt64(0, keyCount)));
+	}
+
+	// Each transaction reads some keys and writes others, one single key conflict range per key
+	void makeTransactions(Arena& arena, VectorRef<CommitTransactionRef>& transactions, Version readSnapshot) const {
+		for (int t = 0; t < transactionsPerBatch; t++) {
+			CommitTransactionRef tr;
+			tr.read_snapshot = readSnapshot;
+			for (int r = 0; r < readsPerTransaction; r++) {
+				KeyRef key = randomKey(arena);
+				tr.read_conflict_ranges.push_back(arena, KeyRangeRef(key, keyAfter(key, arena)));
+			}
+			for (int m = 0; m < mutationsPerTransaction; m++) {
+				KeyRef key = randomKey(arena);
+				tr.write_conflict_ranges.push_back(arena, KeyRangeRef(key, keyAfter(key, arena)));
+				tr.mutations.push_back(arena, MutationRef(MutationRef::SetValue, key, valueSource));
+			}
+			transactions.push_back(arena, tr);
+		}
+	}
+
+	// A storage tag for every key, spread over the tLogs by the log system as the proxy's would be
+	Tag tagFor(KeyRef key) const {
+		return Tag(tLogs->tagLocality, hashlittle(key.begin(), key.size(), 0) % tLogs->numTags);
+	}
+
+	ACTOR static Future<Void> commitBatch(CommitPipelineBench* self,
+	                                      FlowLock* inFlight,
+	                                      Version prevVersion,
+	                                      Version version,
+	                                      Future<Void> previousLogging,
+	                                      Promise<Void> logging) {
+		state FlowLock::Releaser releaser(*inFlight);
+		state double start = timer();
+		state ResolveTransactionBatchRequest req;
+
+		// The master sends the first batch, which the resolver knows by it having no previous version
+		req.prevVersion = prevVersion == self->tLogs->initVersion - 1 ? invalidVersion : prevVersion;
+		req.version = version;
+		req.lastReceivedVersion = self->lastReceivedVersion;
+		self->makeTransactions(req.arena, req.transactions, self->committedVersion);
+
+		state ResolveTransactionBatchReply reply = wait(self->resolver.resolve.getReply(req));
+		self->lastReceivedVersion = std::max(self->lastReceivedVersion, version);
+		state double resolved = timer();
+		self->resolveLatency.addSample(resolved - start);
+
+		state std::unique_ptr<LogPushData> toCommit =
+		    std::make_unique<LogPushData>(self->tLogs->ls, self->tLogs->numLogServers);
+		toCommit->addTransactionInfo(SpanContext());
+		for (int t = 0; t < req.transactions.size(); t++) {
+			if (reply.committed[t] != ConflictBatch::TransactionCommitted) {
+				++self->conflicted;
+				continue;
+			}
+			++self->committed;
+			for (auto& m : req.transactions[t].mutations) {
+				toCommit->addTags(std::vector<Tag>{ self->tagFor(m.param1) });
+				toCommit->writeTypedMessage(m);
+				++self->mutations;
+				self->bytes += m.expectedSize();
+			}
+		}
+		state double tagged = timer();
+		self->tagLatency.addSample(tagged - resolved);
+
+		// Pushes are made in version order, as in the proxy's logging phase
+		wait(previousLogging);
+		state double logStart = timer();
+		self->logQueueLatency.addSample(logStart - tagged);
+		state Future<Version> pushed =
+		    self->tLogs->ls->push(ILogSystem::PushVersionSet{ prevVersion, version, self->committedVersion,
+		                                                      self->committedVersion },
+		                          *toCommit,
+		                          SpanContext());
+		logging.send(Void());
+		wait(success(pushed));
+
+		const double end = timer();
+		self->logLatency.addSample(end - logStart);
+		self->batchLatency.addSample(end - start);
+		self->committedVersion = std::max(self->committedVersion, version);
+		return Void();
+	}
+
+	void pop() {
+		for (uint32_t tagID = 0; tagID < tLogs->numTags; tagID++) {
+			tLogs->ls->pop(committedVersion, Tag(tLogs->tagLocality, tagID));
+		}
+	}
+
+	ACTOR static Future<Void> run(CommitPipelineBench* self) {
+		state FlowLock inFlight(self->pipelineDepth);
+		state std::vector<Future<Void>> commits;
+		state Future<Void> previousLogging = Void();
+		state Version prevVersion = self->tLogs->initVersion - 1;
+		state Version version = self->tLogs->initVersion;
+		state double start = timer();
+		state int i = 0;
+
+		for (; i < self->batches; i++) {
+			wait(inFlight.take());
+			Promise<Void> logging;
+			commits.push_back(commitBatch(self, &inFlight, prevVersion, version, previousLogging, logging));
+			previousLogging = logging.getFuture();
+			prevVersion = version;
+			version += self->versionsPerBatch;
+			if (i % self->popInterval == 0) {
+				self->pop();
+			}
+		}
+		wait(waitForAll(commits));
+
+		const double elapsed = timer() - start;
+		printf("Commit pipeline: %d batches of %d transactions, pipeline depth %d, %u tLogs, %u tags\n",
+		       self->batches,
+		       self->transactionsPerBatch,
+		       self->pipelineDepth,
+		       self->tLogs->numLogServers,
+		       self->tLogs->numTags);
+		printf("Committed %.0f transactions/s  %.0f batches/s  %.0f mutations/s  %.2f MB/s  conflict rate %.4f\n",
+		       self->committed / elapsed,
+		       self->batches / elapsed,
+		       self->mutations / elapsed,
+		       self->bytes / elapsed / 1e6,
+		       (double)self->conflicted / std::max<int64_t>(1, self->committed + self->conflicted));
+		TraceEvent("CommitPipelineBenchThroughput")
+		    .detail("Elapsed", elapsed)
+		    .detail("Batches", self->batches)
+		    .detail("Committed", self->committed)
+		    .detail("Conflicted", self->conflicted)
+		    .detail("Mutations", self->mutations)
+		    .detail("Bytes", self->bytes)
+		    .detail("CommitsPerSecond", self->committed / elapsed);
+		self->printLatency("resolve", self->resolveLatency);
+		self->printLatency("tag", self->tagLatency);
+		self->printLatency("logQueue", self->logQueueLatency);
+		self->printLatency("log", self->logLatency);
+		self->printLatency("batch", self->batchLatency);
+		return Void();
+	}
+
+	void printLatency(const char* phase, DDSketch<double>& latency) {
+		printf("%-8s latency ms: mean %.3f  p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f\n",
+		       phase,
+		       latency.mean() * 1e3,
+		       latency.percentile(0.5) * 1e3,
+		       latency.percentile(0.9) * 1e3,
+		       latency.percentile(0.99) * 1e3,
+		       latency.percentile(0.999) * 1e3,
+		       latency.max() * 1e3);
+		TraceEvent("CommitPipelineBenchLatency")
+		    .detail("Phase", phase)
+		    .detail("Mean", latency.mean())
+		    .detail("P50", latency.percentile(0.5))
+		    .detail("P90", latency.percentile(0.9))
+		    .detail("P99", latency.percentile(0.99))
+		    .detail("P999", latency.percentile(0.999))
+		    .detail("Max", latency.max());
+	}
+};
+
+} // namespace
+
+// Run with
+//   fdbserver -r unittests -f :/fdbserver/performance/commitPipeline --test-batches=100000 --test-pipelineDepth=8
+// numLogServers and numTags set the shape of the log system, as for the tLog tests.
+TEST_CASE(":/fdbserver/performance/commitPipeline") {
+	state CommitPipelineBench bench(params);
+	state std::vector<Future<Void>> tLogActors;
+	state uint16_t tLogIdx = 0;
+
+	TestTLogOptions tLogOptions(params);
+	tLogOptions.numTags = params.getInt("numTags").orDefault(8);
+	tLogOptions.dataFolder = params.get("dataFolder").orDefault(joinPath(params.getDataDir(), "commitpipeline"));
+	bench.tLogs = initTLogTestContext(tLogOptions, Optional<Reference<TLogTestContext>>());
+	for (; tLogIdx < bench.tLogs->numLogServers; tLogIdx++) {
+		bench.tLogs->pTLogContextList.push_back(makeReference<TLogContext>(tLogIdx));
+		tLogActors.push_back(getTLogCreateActor(bench.tLogs, bench.tLogs->tLogOptions, tLogIdx));
+	}
+	wait(buildTLogSet(bench.tLogs));
+	state PromiseStream<Future<Void>> logSystemActors;
+	bench.tLogs->ls = ILogSystem::fromServerDBInfo(bench.tLogs->logID, bench.tLogs->dbInfo, false, logSystemActors);
+
+	// The resolver starts once the recovery it belongs to has reached the recovery transaction, and stops if it is no
+	// longer among the cluster's resolvers
+	bench.resolver.initEndpoints();
+	state InitializeResolverRequest initResolver;
+	initResolver.recoveryCount = 0;
+	initResolver.commitProxyCount = 1;
+	initResolver.resolverCount = 1;
+	initResolver.encryptMode = EncryptionAtRestMode::DISABLED;
+	ServerDBInfo resolverDbInfo = bench.tLogs->dbInfo;
+	resolverDbInfo.recoveryState = RecoveryState::FULLY_RECOVERED;
+	resolverDbInfo.masterLifetime = initResolver.masterLifetime;
+	resolverDbInfo.resolvers = { bench.resolver };
+	state Reference<AsyncVar<ServerDBInfo>> resolverDb = makeReference<AsyncVar<ServerDBInfo>>(resolverDbInfo);
+	state Future<Void> resolverActor = resolver(bench.resolver, initResolver, resolverDb);
+
+	wait(CommitPipelineBench::run(&bench));
+
+	resolverActor.cancel();
+	for (tLogIdx = 0; tLogIdx < bench.tLogs->numLogServers; tLogIdx++) {
+		bench.tLogs->pTLogContextList[tLogIdx]->TestTLogServerCompleted.send(true);
+	}
+	wait(waitForAll(tLogActors));
+	return Void();
+}
@@ -45,6 +45,7 @@
 #include "fdbserver/AccumulativeChecksumUtil.h"
 #include "fdbserver/ApplyMetadataMutation.h"
 #include "fdbserver/ConflictSet.h"
+#include "fdbserver/CoroFlow.h"
 #include "fdbserver/DataDistributorInterface.h"
 #include "fdbserver/FDBExecHelper.actor.h"
 #include "fdbclient/GetEncryptCipherKeys.h"
@@ -66,6 +67,7 @@
 #include "flow/EncryptUtils.h"
 #include "flow/Error.h"
 #include "flow/IRandom.h"
+#include "flow/IThreadPool.h"
 #include "flow/Knobs.h"
 #include "flow/Trace.h"
 #include "flow/network.h"
@@ -198,6 +200,38 @@ struct ResolutionRequestBuilder {
 		}
 	}
 
+	// Replaces each SetVersionstampedKeys mutation with the SetValues it stands for, so that nothing past this point
+	// needs to know about them, and adds one write conflict range for all of their keys
+	void expandVersionstampedKeys(CommitTransactionRequest& trRequest, int transactionNumberInBatch) {
+		auto& trIn = trRequest.transaction;
+		if (std::none_of(trIn.mutations.begin(), trIn.mutations.end(), [](MutationRef const& m) {
+			    return m.type == MutationRef::SetVersionstampedKeys;
+		    })) {
+			return;
+		}
+		CODE_PROBE(true, "Commit proxy expanding versionstamped keys");
+		VectorRef<MutationRef> expanded;
+		for (auto& m : trIn.mutations) {
+			if (m.type != MutationRef::SetVersionstampedKeys) {
+				expanded.push_back(trRequest.arena, m);
+				continue;
+			}
+			int first = expanded.size();
+			if (!::expandVersionstampedKeys(
+			        trRequest.arena, m, requests[0].version, transactionNumberInBatch, expanded)) {
+				// The client checks this, so only a misbehaving one gets here
+				TraceEvent(SevWarnAlways, "InvalidVersionstampedKeys", self->dbgid)
+				    .suppressFor(60)
+				    .detail("Key", m.param1);
+			} else if (expanded.size() > first) {
+				trIn.write_conflict_ranges.push_back(
+				    requests[0].arena,
+				    KeyRangeRef(expanded[first].param1, keyAfter(expanded.back().param1, requests[0].arena)));
+			}
+		}
+		trIn.mutations = expanded;
+	}
+
 	void addTransaction(CommitTransactionRequest& trRequest, Version ver, int transactionNumberInBatch) {
 		auto& trIn = trRequest.transaction;
 		// SOMEDAY: There are a couple of unnecessary O( # resolvers ) steps here
@@ -208,6 +242,7 @@ struct ResolutionRequestBuilder {
 		DisabledTraceEvent("AddTransaction", self->dbgid).detail("TenantMode", (int)self->getTenantMode());
 		bool needParseTenantId = !trRequest.tenantInfo.hasTenant() && self->getTenantMode() == TenantMode::REQUIRED;
 		VectorRef<int64_t> tenantIds;
+		expandVersionstampedKeys(trRequest, transactionNumberInBatch);
 		for (auto& m : trIn.mutations) {
 			DEBUG_MUTATION("AddTr", ver, m, self->dbgid).detail("Idx", transactionNumberInBatch);
 			if (m.type == MutationRef::SetVersionstampedKey) {
@@ -318,7 +353,8 @@ bool verifyTenantPrefix(ProxyCommitData* const commitData, const CommitTransacti
 					    .detail("Key", m.param2);
 					CODE_PROBE(true, "Committed mutation clear range prefix mismatch", probe::decoration::rare);
 					return false;
-				} else if (m.type == MutationRef::SetVersionstampedKey) {
+				} else if (m.type == MutationRef::SetVersionstampedKey ||
+				           m.type == MutationRef::SetVersionstampedKeys) {
 					ASSERT(m.param1.size() >= 4);
 					uint8_t* key = const_cast<uint8_t*>(m.param1.begin());
 					int* offset = reinterpret_cast<int*>(&key[m.param1.size() - 4]);
@@ -739,6 +775,9 @@ struct CommitBatchContext {
 	std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>> cipherKeys;
 
 	IdempotencyIdKVBuilder idempotencyKVBuilder;
+	// For each idempotency key written by this batch, by high order byte of batch index, the key written just before it
+	// if nothing else can lie between them
+	std::unordered_map<uint8_t, std::pair<Version, uint8_t>> previousIdempotencyKeys;
 
 	CommitBatchContext(ProxyCommitData*, const std::vector<CommitTransactionRequest>*, const int);
 
@@ -843,22 +882,10 @@ std::set<Tag> CommitBatchContext::getWrittenTagsPreResolution() {
 				}
 			} else if (m.type == MutationRef::ClearRange) {
 				KeyRangeRef clearRange(KeyRangeRef(m.param1, m.param2));
-				auto ranges = pProxyCommitData->keyInfo.intersectingRanges(clearRange);
-				auto firstRange = ranges.begin();
-				++firstRange;
-				if (firstRange == ranges.end()) {
-					std::set<Tag> filteredTags;
-					ranges.begin().value().populateTags();
-					filteredTags.insert(ranges.begin().value().tags.begin(), ranges.begin().value().tags.end());
-					transactionTags.insert(ranges.begin().value().tags.begin(), ranges.begin().value().tags.end());
-				} else {
-					std::set<Tag> allSources;
-					for (auto r : ranges) {
-						r.value().populateTags();
-						allSources.insert(r.value().tags.begin(), r.value().tags.end());
-						transactionTags.insert(r.value().tags.begin(), r.value().tags.end());
-					}
-				}
+				pProxyCommitData->forEachShardInfo(clearRange, [&](ServerCacheInfo& info) {
+					info.populateTags();
+					transactionTags.insert(info.tags.begin(), info.tags.end());
+				});
 				if (pProxyCommitData->needsCacheTag(clearRange)) {
 					transactionTags.insert(cacheTag);
 				}
@@ -1006,7 +1033,8 @@ ACTOR Future<Void> preresolutionProcessing(CommitBatchContext* self) {
 		self->writtenTagsPreResolution = self->getWrittenTagsPreResolution();
 	}
 
-	if (SERVER_KNOBS->HOT_SHARD_THROTTLING_ENABLED && !pProxyCommitData->hotShards.empty()) {
+	if ((SERVER_KNOBS->HOT_SHARD_THROTTLING_ENABLED || SERVER_KNOBS->RATEKEEPER_LOCALIZED_THROTTLING) &&
+	    !pProxyCommitData->hotShards.empty()) {
 		self->checkHotShards();
 	}
 
@@ -2017,12 +2045,139 @@ void addAccumulativeChecksumMutations(CommitBatchContext* self) {
 
 /// This second pass through committed transactions assigns the actual mutations to the appropriate storage servers'
 /// tags
+// A slice of a batch's mutations to be encrypted on one of the commit proxy's encryption threads. The job owns copies
+// of everything it touches, so it stays valid on the worker even if the commit batch is cancelled meanwhile.
+struct MutationEncryptionJob : ThreadSafeReferenceCounted<MutationEncryptionJob> {
+	std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>> cipherKeys;
+	std::vector<std::pair<MutationRef, EncryptCipherDomainId>> mutations;
+	Arena inputArena;
+
+	std::vector<MutationRef> encrypted;
+	Arena outputArena;
+	double encryptionTime = 0;
+};
+
+struct MutationEncryptionWorker final : IThreadPoolReceiver {
+	void init() override {}
+
+	struct EncryptAction final : TypedAction<MutationEncryptionWorker, EncryptAction> {
+		Reference<MutationEncryptionJob> job;
+		ThreadReturnPromise<Void> result;
+
+		explicit EncryptAction(Reference<MutationEncryptionJob> job) : job(job) {}
+		double getTimeEstimate() const override { return 0; }
+	};
+
+	void action(EncryptAction& a) {
+		MutationEncryptionJob& job = *a.job;
+		try {
+			job.encrypted.reserve(job.mutations.size());
+			for (const auto& [m, domainId] : job.mutations) {
+				double encryptionTime = 0;
+				job.encrypted.push_back(
+				    m.encrypt(job.cipherKeys, domainId, job.outputArena, BlobCipherMetrics::TLOG, &encryptionTime));
+				job.encryptionTime += encryptionTime;
+			}
+			a.result.send(Void());
+		} catch (Error& e) {
+			a.result.sendError(e);
+		}
+	}
+};
+
+// Encrypts the mutations of every committed transaction on the commit proxy's encryption threads and stores them as
+// the transactions' encryptedMutations, so assignMutationsToStorageServers() only has to tag and serialize them.
+// Tagging stays on the network thread in batch order: it reads the proxy's shard map, which metadata mutations of
+// earlier batches change, and the order of messages in LogPushData must follow the commit order.
+// Returns the time spent encrypting.
+ACTOR Future<double> encryptMutationsInParallel(CommitBatchContext* self) {
+	state ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
+	state std::vector<Optional<MutationRef>*> destinations;
+	state std::vector<Reference<MutationEncryptionJob>> jobs;
+	state std::vector<Future<Void>> done;
+
+	std::vector<std::pair<MutationRef, EncryptCipherDomainId>> pending;
+	for (int t = 0; t < self->trs.size(); t++) {
+		if (!(self->committed[t] == ConflictBatch::TransactionCommitted &&
+		      (!self->locked || self->trs[t].isLockAware()))) {
+			continue;
+		}
+		CommitTransactionRef& tr = self->trs[t].transaction;
+		if (tr.encryptedMutations.empty()) {
+			tr.encryptedMutations.resize(self->arena, tr.mutations.size());
+		}
+		ASSERT_EQ(tr.encryptedMutations.size(), tr.mutations.size());
+
+		// Same domain selection as assignMutationsToStorageServers() and writeMutation()
+		int64_t encryptDomain = self->trs[t].tenantInfo.tenantId;
+		if (pProxyCommitData->encryptMode.mode == EncryptionAtRestMode::CLUSTER_AWARE &&
+		    encryptDomain != SYSTEM_KEYSPACE_ENCRYPT_DOMAIN_ID) {
+			encryptDomain = FDB_DEFAULT_ENCRYPT_DOMAIN_ID;
+		}
+		for (int i = 0; i < tr.mutations.size(); i++) {
+			const MutationRef& m = tr.mutations[i];
+			if (tr.encryptedMutations[i].present() ||
+			    !(isSingleKeyMutation((MutationRef::Type)m.type) || m.type == MutationRef::ClearRange)) {
+				continue;
+			}
+			EncryptCipherDomainId domainId = encryptDomain;
+			if (domainId == INVALID_ENCRYPT_DOMAIN_ID) {
+				domainId = getEncryptDetailsFromMutationRef(pProxyCommitData, m);
+			}
+			ASSERT(self->cipherKeys.count(domainId) > 0);
+			pending.emplace_back(m, domainId);
+			destinations.push_back(&tr.encryptedMutations[i]);
+		}
+	}
+	if (pending.size() < SERVER_KNOBS->COMMIT_PROXY_PARALLEL_ENCRYPTION_MIN_MUTATIONS) {
+		// Leave the remaining mutations to writeMutation()
+		return 0.0;
+	}
+
+	const int jobCount = std::min<int>(SERVER_KNOBS->COMMIT_PROXY_ENCRYPTION_THREADS, pending.size());
+	for (int j = 0; j < jobCount; j++) {
+		Reference<MutationEncryptionJob> job = makeReference<MutationEncryptionJob>();
+		job->cipherKeys = self->cipherKeys;
+		const int begin = (int64_t)j * pending.size() / jobCount;
+		const int end = (int64_t)(j + 1) * pending.size() / jobCount;
+		job->mutations.reserve(end - begin);
+		for (int i = begin; i < end; i++) {
+			job->mutations.emplace_back(MutationRef(job->inputArena, pending[i].first), pending[i].second);
+		}
+		auto action = new MutationEncryptionWorker::EncryptAction(job);
+		done.push_back(action->result.getFuture());
+		pProxyCommitData->encryptionThreads->post(action);
+		jobs.push_back(job);
+	}
+	wait(waitForAll(done));
+
+	double encryptionTime = 0;
+	int next = 0;
+	for (const auto& job : jobs) {
+		self->arena.dependsOn(job->outputArena);
+		for (const MutationRef& m : job->encrypted) {
+			*destinations[next++] = m;
+		}
+		encryptionTime += job->encryptionTime;
+	}
+	ASSERT_EQ(next, destinations.size());
+	CODE_PROBE(true, "Commit batch mutations encrypted in parallel");
+	return encryptionTime;
+}
+
 ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 	state ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
 	state std::vector<CommitTransactionRequest>& trs = self->trs;
 	state double curEncryptionTime = 0;
 	state double totalEncryptionTime = 0;
 
+	// Mutations are encrypted as they are written unless they can be encrypted up front; the accumulative checksum
+	// (only used without encryption today) rewrites mutations while tagging, so it rules that out
+	if (pProxyCommitData->encryptionThreads && pProxyCommitData->acsBuilder == nullptr && self->transactionNum == 0) {
+		double encryptionTime = wait(encryptMutationsInParallel(self));
+		totalEncryptionTime += encryptionTime;
+	}
+
 	for (; self->transactionNum < trs.size(); self->transactionNum++) {
 		if (!(self->committed[self->transactionNum] == ConflictBatch::TransactionCommitted &&
 		      (!self->locked || trs[self->transactionNum].isLockAware()))) {
@@ -2082,7 +2237,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 					double prob = mul * cost / totalCosts;
 
 					if (deterministicRandom()->random01() < prob) {
-						const auto& storageServers = pProxyCommitData->keyInfo[m.param1].src_info;
+						const auto& storageServers = pProxyCommitData->shardInfoForKey(m.param1).src_info;
 						for (const auto& ssInfo : storageServers) {
 							auto id = ssInfo->interf.id();
 							// scale cost
@@ -2131,21 +2286,19 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 				writtenMutation = std::get<MutationRef>(var);
 			} else if (m.type == MutationRef::ClearRange) {
 				KeyRangeRef clearRange(KeyRangeRef(m.param1, m.param2));
-				auto ranges = pProxyCommitData->keyInfo.intersectingRanges(clearRange);
-				auto firstRange = ranges.begin();
-				++firstRange;
-				if (firstRange == ranges.end()) {
+				ServerCacheInfo* shard = pProxyCommitData->singleShardInfo(clearRange);
+				if (shard) {
 					// Fast path
 					DEBUG_MUTATION("ProxyCommit", self->commitVersion, m, pProxyCommitData->dbgid)
-					    .detail("To", ranges.begin().value().tags);
-					ranges.begin().value().populateTags();
-					self->toCommit.addTags(ranges.begin().value().tags);
+					    .detail("To", shard->tags);
+					shard->populateTags();
+					self->toCommit.addTags(shard->tags);
 
 					if (pProxyCommitData->acsBuilder != nullptr) {
 						updateMutationWithAcsAndAddMutationToAcsBuilder(
 						    pProxyCommitData->acsBuilder,
 						    m,
-						    ranges.begin().value().tags,
+						    shard->tags,
 						    getCommitProxyAccumulativeChecksumIndex(pProxyCommitData->commitProxyIndex),
 						    pProxyCommitData->epoch,
 						    self->commitVersion,
@@ -2155,7 +2308,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 					// check whether clear is sampled
 					if (checkSample && !trCost->get().clearIdxCosts.empty() &&
 					    trCost->get().clearIdxCosts[0].first == mutationNum) {
-						auto const& ssInfos = ranges.begin().value().src_info;
+						auto const& ssInfos = shard->src_info;
 						for (auto const& ssInfo : ssInfos) {
 							auto id = ssInfo->interf.id();
 							pProxyCommitData->updateSSTagCost(id,
@@ -2168,14 +2321,14 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 				} else {
 					CODE_PROBE(true, "A clear range extends past a shard boundary");
 					std::set<Tag> allSources;
-					for (auto r : ranges) {
-						r.value().populateTags();
-						allSources.insert(r.value().tags.begin(), r.value().tags.end());
+					pProxyCommitData->forEachShardInfo(clearRange, [&](ServerCacheInfo& info) {
+						info.populateTags();
+						allSources.insert(info.tags.begin(), info.tags.end());
 
 						// check whether clear is sampled
 						if (checkSample && !trCost->get().clearIdxCosts.empty() &&
 						    trCost->get().clearIdxCosts[0].first == mutationNum) {
-							auto const& ssInfos = r.value().src_info;
+							auto const& ssInfos = info.src_info;
 							for (auto const& ssInfo : ssInfos) {
 								auto id = ssInfo->interf.id();
 								pProxyCommitData->updateSSTagCost(id,
@@ -2186,7 +2339,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 							}
 							trCost->get().clearIdxCosts.pop_front();
 						}
-					}
+					});
 
 					DEBUG_MUTATION("ProxyCommit", self->commitVersion, m)
 					    .detail("Dbgid", pProxyCommitData->dbgid)
@@ -2324,6 +2477,11 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 		                        &self->computeStart));
 	}
 
+	if (self->prevVersion != pProxyCommitData->lastPostResolutionVersion) {
+		// Another proxy committed since our last batch, and may have written idempotency keys after ours
+		pProxyCommitData->lastIdempotencyKeyVersion = invalidVersion;
+	}
+	pProxyCommitData->lastPostResolutionVersion = self->commitVersion;
 	buildIdempotencyIdMutations(
 	    self->trs,
 	    self->idempotencyKVBuilder,
@@ -2332,6 +2490,14 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 	    ConflictBatch::TransactionCommitted,
 	    self->locked,
 	    [&](const KeyValue& kv) {
+		    Version keyVersion;
+		    uint8_t highOrderBatchIndex;
+		    decodeIdempotencyKey(kv.key, keyVersion, highOrderBatchIndex);
+		    self->previousIdempotencyKeys[highOrderBatchIndex] = {
+			    pProxyCommitData->lastIdempotencyKeyVersion, pProxyCommitData->lastIdempotencyKeyBatchIndexHighByte
+		    };
+		    pProxyCommitData->lastIdempotencyKeyVersion = keyVersion;
+		    pProxyCommitData->lastIdempotencyKeyBatchIndexHighByte = highOrderBatchIndex;
 		    MutationRef idempotencyIdSet;
 		    idempotencyIdSet.type = MutationRef::Type::SetValue;
 		    idempotencyIdSet.param1 = kv.key;
@@ -2362,7 +2528,13 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 	    });
 	state int i = 0;
 	for (i = 0; i < pProxyCommitData->idempotencyClears.size(); i++) {
-		auto& tags = pProxyCommitData->tagsForKey(pProxyCommitData->idempotencyClears[i].param1);
+		// A clear may cover a run of adjacent idempotency keys, which can span shards
+		std::set<Tag> tags;
+		for (auto r : pProxyCommitData->keyInfo.intersectingRanges(KeyRangeRef(
+		         pProxyCommitData->idempotencyClears[i].param1, pProxyCommitData->idempotencyClears[i].param2))) {
+			r.value().populateTags();
+			tags.insert(r.value().tags.begin(), r.value().tags.end());
+		}
 		self->toCommit.addTags(tags);
 		// We already have an arena with an appropriate lifetime handy
 		Arena& arena = pProxyCommitData->idempotencyClears.arena();
@@ -2696,11 +2868,20 @@ ACTOR Future<Void> reply(CommitBatchContext* self) {
 			                  std::numeric_limits<int>::max());
 			pProxyCommitData->stats.commitLatencyBands.addMeasurement(duration, 1, Filtered(filter));
 		}
+		if (tr.tenantInfo.hasTenant()) {
+			pProxyCommitData->stats.tenantCommitLatencies.addMeasurement(
+			    tr.tenantInfo.tenantId, TenantLatencyMap::RequestType::Commit, duration);
+		}
 	}
 
 	for (auto [highOrderBatchIndex, count] : idCountsForKey) {
-		pProxyCommitData->expectedIdempotencyIdCountForKey.send(
-		    ExpectedIdempotencyIdCountForKey{ self->commitVersion, count, highOrderBatchIndex });
+		std::pair<Version, uint8_t> previous = { invalidVersion, 0 };
+		auto it = self->previousIdempotencyKeys.find(highOrderBatchIndex);
+		if (it != self->previousIdempotencyKeys.end()) {
+			previous = it->second;
+		}
+		pProxyCommitData->expectedIdempotencyIdCountForKey.send(ExpectedIdempotencyIdCountForKey{
+		    self->commitVersion, count, highOrderBatchIndex, previous.first, previous.second });
 	}
 
 	if (self->pProxyCommitData->encryptMode.isEncryptionEnabled() && self->encryptionTime.present()) {
@@ -3556,19 +3737,16 @@ ACTOR Future<Void> monitorTenantsOverStorageQuota(UID myID,
 }
 
 namespace {
-struct ExpireServerEntry {
-	int64_t timeReceived;
-	int expectedCount = 0;
-	int receivedCount = 0;
-	bool initialized = false;
-};
-
 struct IdempotencyKey {
 	Version version;
 	uint8_t highOrderBatchIndex;
 	bool operator==(const IdempotencyKey& other) const {
 		return version == other.version && highOrderBatchIndex == other.highOrderBatchIndex;
 	}
+	// Same order as the keys themselves
+	bool operator<(const IdempotencyKey& other) const {
+		return std::tie(version, highOrderBatchIndex) < std::tie(other.version, other.highOrderBatchIndex);
+	}
 };
 
 } // namespace
@@ -3586,6 +3764,37 @@ struct hash<IdempotencyKey> {
 
 } // namespace std
 
+namespace {
+struct ExpireServerEntry {
+	int64_t timeReceived;
+	int expectedCount = 0;
+	int receivedCount = 0;
+	bool initialized = false;
+	Optional<IdempotencyKey> previous; // The key just before this one, if nothing else can lie between them
+};
+
+// Clears the expired keys, with one range clear for each run of keys in which every key directly follows the one
+// before it
+void clearExpiredIdempotencyKeys(std::map<IdempotencyKey, Optional<IdempotencyKey>>& expired,
+                                 Standalone<VectorRef<MutationRef>>* idempotencyClears) {
+	Arena& arena = idempotencyClears->arena();
+	auto it = expired.begin();
+	while (it != expired.end()) {
+		IdempotencyKey first = it->first;
+		IdempotencyKey last = it->first;
+		for (++it; it != expired.end() && it->second.present() && it->second.get() == last; ++it) {
+			last = it->first;
+		}
+		CODE_PROBE(!(first == last), "Cleared adjacent idempotency keys with one range clear");
+		KeyRef begin = makeIdempotencySingleKeyRange(arena, first.version, first.highOrderBatchIndex).begin;
+		KeyRef end = makeIdempotencySingleKeyRange(arena, last.version, last.highOrderBatchIndex).end;
+		idempotencyClears->push_back(arena, MutationRef(MutationRef::ClearRange, begin, end));
+	}
+	expired.clear();
+}
+
+} // namespace
+
 ACTOR static Future<Void> idempotencyIdsExpireServer(
     Database db,
     PublicRequestStream<ExpireIdempotencyIdRequest> expireIdempotencyId,
@@ -3597,6 +3806,9 @@ ACTOR static Future<Void> idempotencyIdsExpireServer(
 	state IdempotencyKey key;
 	state ExpireServerEntry* status = nullptr;
 	state Future<Void> purgeOld = Void();
+	// Keys whose ids have all expired, waiting to be cleared together with their neighbors
+	state std::map<IdempotencyKey, Optional<IdempotencyKey>> expired;
+	state Future<Void> clearExpired = Never();
 	loop {
 		choose {
 			when(ExpireIdempotencyIdRequest req = waitNext(expireIdempotencyId.getFuture())) {
@@ -3613,6 +3825,14 @@ ACTOR static Future<Void> idempotencyIdsExpireServer(
 				status = &idStatus[key];
 				ASSERT_EQ(status->expectedCount, 0);
 				status->expectedCount = req.idempotencyIdCount;
+				if (req.previousKeyVersion != invalidVersion) {
+					status->previous = IdempotencyKey{ req.previousKeyVersion, req.previousKeyBatchIndexHighByte };
+				}
+			}
+			when(wait(clearExpired)) {
+				clearExpired = Never();
+				clearExpiredIdempotencyKeys(expired, idempotencyClears);
+				continue;
 			}
 			when(wait(purgeOld)) {
 				purgeOld = delay(SERVER_KNOBS->IDEMPOTENCY_ID_IN_MEMORY_LIFETIME);
@@ -3632,10 +3852,10 @@ ACTOR static Future<Void> idempotencyIdsExpireServer(
 		}
 		if (status->initialized) {
 			if (status->receivedCount == status->expectedCount) {
-				auto keyRange =
-				    makeIdempotencySingleKeyRange(idempotencyClears->arena(), key.version, key.highOrderBatchIndex);
-				idempotencyClears->push_back(idempotencyClears->arena(),
-				                             MutationRef(MutationRef::ClearRange, keyRange.begin, keyRange.end));
+				if (expired.empty()) {
+					clearExpired = delay(SERVER_KNOBS->IDEMPOTENCY_ID_CLEAR_COALESCE_DELAY);
+				}
+				expired[key] = status->previous;
 				idStatus.erase(key);
 			}
 		} else {
@@ -3645,6 +3865,80 @@ ACTOR static Future<Void> idempotencyIdsExpireServer(
 	}
 }
 
+TEST_CASE("/CommitProxy/IdempotencyIds/CoalesceClears") {
+	auto key = [](Version version, uint8_t highOrderBatchIndex) {
+		return IdempotencyKey{ version, highOrderBatchIndex };
+	};
+	std::map<IdempotencyKey, Optional<IdempotencyKey>> expired;
+	expired[key(10, 0)] = Optional<IdempotencyKey>();
+	expired[key(10, 1)] = key(10, 0);
+	expired[key(12, 0)] = key(10, 1);
+	// Another proxy may have written keys between 12 and 15
+	expired[key(15, 0)] = Optional<IdempotencyKey>();
+	// 18 has not expired yet, so 20 can't be cleared with 15
+	expired[key(20, 0)] = key(18, 0);
+
+	Standalone<VectorRef<MutationRef>> clears;
+	clearExpiredIdempotencyKeys(expired, &clears);
+	ASSERT(expired.empty());
+	ASSERT_EQ(clears.size(), 3);
+
+	Arena arena;
+	auto expectClear = [&](const MutationRef& m, IdempotencyKey first, IdempotencyKey last) {
+		ASSERT(m.type == MutationRef::ClearRange);
+		ASSERT(m.param1 == makeIdempotencySingleKeyRange(arena, first.version, first.highOrderBatchIndex).begin);
+		ASSERT(m.param2 == makeIdempotencySingleKeyRange(arena, last.version, last.highOrderBatchIndex).end);
+	};
+	expectClear(clears[0], key(10, 0), key(12, 0));
+	expectClear(clears[1], key(15, 0), key(15, 0));
+	expectClear(clears[2], key(20, 0), key(20, 0));
+	return Void();
+}
+
+TEST_CASE("/CommitProxy/KeyInfoIndex") {
+	// Boundaries from a handful of characters, so that many share their first 8 bytes
+	auto randomKey = []() {
+		const char chars[] = { '\0', 'a', 'b', '\xff' };
+		std::string k;
+		int length = deterministicRandom()->randomInt(0, 12);
+		for (int i = 0; i < length; ++i) {
+			// Keys stay below allKeys.end, which is where the map ends
+			k.push_back(chars[deterministicRandom()->randomInt(0, i == 0 ? 3 : 4)]);
+		}
+		return Key(k);
+	};
+
+	KeyRangeMap<ServerCacheInfo> keyInfo;
+	KeyInfoIndex index;
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < 50; ++i) {
+			Key a = randomKey();
+			Key b = randomKey();
+			if (a != b) {
+				ServerCacheInfo info;
+				info.tags.push_back(Tag(0, round * 50 + i));
+				keyInfo.insert(KeyRangeRef(std::min(a, b), std::max(a, b)), info);
+			}
+		}
+		index.rebuild(keyInfo, round);
+		ASSERT(index.isCurrent(round) && !index.isCurrent(round + 1));
+		int shards = 0;
+		for (auto r : keyInfo.ranges()) {
+			++shards;
+		}
+		ASSERT_EQ(index.size(), shards);
+
+		for (int i = 0; i < 1000; ++i) {
+			Key k = randomKey();
+			auto r = keyInfo.rangeContaining(k);
+			int shard = index.find(k);
+			ASSERT(&index.info(shard) == &r.value());
+			ASSERT(index.begin(shard) == r.begin() && index.end(shard) == r.end());
+		}
+	}
+	return Void();
+}
+
 namespace {
 
 struct TransactionStateResolveContext {
@@ -3750,6 +4044,7 @@ ACTOR Future<Void> processCompleteTransactionStateRequest(TransactionStateResolv
 		// insert keyTag data separately from metadata mutations so that we can do one bulk insert which
 		// avoids a lot of map lookups.
 		pContext->pCommitData->keyInfo.rawInsert(keyInfoData);
+		++pContext->pCommitData->keyInfoGeneration;
 
 		Arena arena;
 		bool confChanges;
@@ -3806,7 +4101,7 @@ ACTOR Future<Void> processTransactionStateRequestPart(TransactionStateResolveCon
 	// (sequence 0) resolution request, which it doesn't do until we have acknowledged all TxnStateRequests
 	ASSERT(!pContext->pCommitData->validState.isSet());
 
-	for (auto& kv : request.data) {
+	for (auto& kv : request.getData(request.arena)) {
 		pContext->pTxnStateStore->set(kv, &request.arena);
 	}
 	pContext->pTxnStateStore->commit(true);
@@ -3957,6 +4252,13 @@ ACTOR Future<Void> commitProxyServerCore(CommitProxyInterface proxy,
 	    commitData.logAdapter, commitData.db, proxy.id(), 2e9, true, true, true, encryptMode.isEncryptionEnabled());
 	createWhitelistBinPathVec(whitelistBinPaths, commitData.whitelistedBinPathVec);
 
+	if (commitData.encryptMode.isEncryptionEnabled() && SERVER_KNOBS->COMMIT_PROXY_ENCRYPTION_THREADS > 0) {
+		commitData.encryptionThreads = createPureWorkThreadPool();
+		for (int i = 0; i < SERVER_KNOBS->COMMIT_PROXY_ENCRYPTION_THREADS; i++) {
+			commitData.encryptionThreads->addThread(new CommitBatch::MutationEncryptionWorker(), "fdb-cp-encrypt");
+		}
+	}
+
 	commitData.updateLatencyBandConfig(commitData.db->get().latencyBandConfig);
 
 	// ((SERVER_MEM_LIMIT * COMMIT_BATCHES_MEM_FRACTION_OF_TOTAL) / COMMIT_BATCHES_MEM_TO_TOTAL_MEM_SCALE_FACTOR) is
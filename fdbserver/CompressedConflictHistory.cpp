@@ -0,0 +1,381 @@
+/*
+ * CompressedConflictHistory.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/CompressedConflictHistory.h"
+
+#include <algorithm>
+
+#include "flow/UnitTest.h"
+
+namespace {
+
+void appendVarint(std::string& out, uint64_t v) {
+	while (v >= 0x80) {
+		out.push_back(char(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back(char(v));
+}
+
+uint64_t readVarint(const uint8_t*& p) {
+	uint64_t v = 0;
+	for (int shift = 0;; shift += 7) {
+		uint8_t b = *p++;
+		v |= uint64_t(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			return v;
+	}
+}
+
+// Walks the entries of an encoded block in key order without allocating per entry
+class BlockReader {
+public:
+	BlockReader(const std::string& data, Version maxVersion)
+	  : p((const uint8_t*)data.data()), end(p + data.size()), maxVersion(maxVersion) {}
+
+	bool next() {
+		if (p == end)
+			return false;
+		int shared = readVarint(p);
+		int suffix = readVarint(p);
+		buffer.resize(shared);
+		buffer.append((const char*)p, suffix);
+		p += suffix;
+		currentVersion = maxVersion - (Version)readVarint(p);
+		return true;
+	}
+
+	StringRef key() const { return StringRef((const uint8_t*)buffer.data(), buffer.size()); }
+	Version version() const { return currentVersion; }
+
+private:
+	const uint8_t* p;
+	const uint8_t* end;
+	Version maxVersion;
+	std::string buffer;
+	Version currentVersion = 0;
+};
+
+} // namespace
+
+CompressedConflictHistory::CompressedConflictHistory(Version version) {
+	Block block;
+	block.count = 1;
+	block.minVersion = block.maxVersion = version;
+	appendVarint(block.data, 0);
+	appendVarint(block.data, 0);
+	appendVarint(block.data, 0);
+	blocks.emplace(Key(), std::move(block));
+}
+
+CompressedConflictHistory::BlockMap::const_iterator CompressedConflictHistory::blockContaining(StringRef key) const {
+	auto it = blocks.upper_bound(key);
+	ASSERT(it != blocks.begin());
+	return --it;
+}
+
+void CompressedConflictHistory::decode(const Block& block, std::vector<Entry>& entries, Arena& arena) {
+	BlockReader reader(block.data, block.maxVersion);
+	while (reader.next())
+		entries.push_back(Entry{ StringRef(arena, reader.key()), reader.version() });
+}
+
+bool CompressedConflictHistory::anyWriteAfter(StringRef begin, StringRef end, Version version) const {
+	// The entry covering begin is the last one at or before it, which is always in the block containing begin
+	bool checkedBegin = false;
+	Version covering = 0;
+	for (auto it = blockContaining(begin); it != blocks.end(); ++it) {
+		if (checkedBegin && !(it->first < end))
+			break;
+		const Block& block = it->second;
+		if (block.maxVersion <= version) {
+			checkedBegin = true;
+			continue;
+		}
+
+		BlockReader reader(block.data, block.maxVersion);
+		while (reader.next()) {
+			if (!checkedBegin) {
+				if (!(begin < reader.key())) {
+					covering = reader.version();
+					continue;
+				}
+				checkedBegin = true;
+				if (covering > version)
+					return true;
+			}
+			if (!(reader.key() < end))
+				return false;
+			if (reader.version() > version)
+				return true;
+		}
+		if (!checkedBegin) {
+			checkedBegin = true;
+			if (covering > version)
+				return true;
+		}
+	}
+	return false;
+}
+
+CompressedConflictHistory::BlockMap::iterator CompressedConflictHistory::replaceBlocks(
+    BlockMap::iterator first,
+    BlockMap::iterator last,
+    const std::vector<Entry>& entries) {
+	ASSERT(!entries.empty() && entries[0].key == first->first);
+	auto next = blocks.erase(first, last);
+
+	// Split evenly rather than filling blocks to the brim, so the next insertion into a block rarely splits it again
+	const int blockCount = (entries.size() + MaxBlockEntries - 1) / MaxBlockEntries;
+	BlockMap::iterator result = next;
+	for (int b = 0; b < blockCount; b++) {
+		const int lo = (int64_t)b * entries.size() / blockCount;
+		const int hi = (int64_t)(b + 1) * entries.size() / blockCount;
+
+		Block block;
+		block.count = hi - lo;
+		block.minVersion = block.maxVersion = entries[lo].version;
+		for (int i = lo + 1; i < hi; i++) {
+			block.minVersion = std::min(block.minVersion, entries[i].version);
+			block.maxVersion = std::max(block.maxVersion, entries[i].version);
+		}
+		StringRef prev;
+		for (int i = lo; i < hi; i++) {
+			const StringRef key = entries[i].key;
+			const int shared = i == lo ? 0 : commonPrefixLength(prev, key);
+			appendVarint(block.data, shared);
+			appendVarint(block.data, key.size() - shared);
+			block.data.append((const char*)key.begin() + shared, key.size() - shared);
+			appendVarint(block.data, block.maxVersion - entries[i].version);
+			prev = key;
+		}
+		block.data.shrink_to_fit();
+
+		auto it = blocks.emplace_hint(next, Key(entries[lo].key), std::move(block));
+		if (b == 0)
+			result = it;
+	}
+	return result;
+}
+
+void CompressedConflictHistory::pushEntry(std::vector<Entry>& out, StringRef key, Version version) {
+	if (!out.empty() && out.back().key == key) {
+		// Never drop the first entry, it is the key the block is indexed by
+		out.back().version = version;
+		if (out.size() > 1 && out[out.size() - 2].version == version)
+			out.pop_back();
+		return;
+	}
+	if (!out.empty() && out.back().version == version)
+		return;
+	out.push_back(Entry{ key, version });
+}
+
+void CompressedConflictHistory::addConflictRanges(const std::pair<StringRef, StringRef>* ranges,
+                                                  int count,
+                                                  Version version) {
+	Arena arena;
+	std::vector<Entry> entries, merged;
+	int i = 0;
+	while (i < count) {
+		// Decode the block holding the start of range i, then keep taking ranges that start before the next block
+		// (decoding more blocks whenever a range extends past them) so consecutive ranges share one rewrite
+		auto first = blocks.upper_bound(ranges[i].first);
+		--first;
+		auto last = std::next(first);
+		entries.clear();
+		decode(first->second, entries, arena);
+		int j = i;
+		while (j < count && (last == blocks.end() || ranges[j].first < last->first)) {
+			while (last != blocks.end() && last->first < ranges[j].second) {
+				decode(last->second, entries, arena);
+				++last;
+			}
+			j++;
+		}
+		// When a range ends exactly at the next block's first key, the entry at its end already exists
+		const StringRef regionEnd = last == blocks.end() ? StringRef() : StringRef(last->first);
+		const bool hasRegionEnd = last != blocks.end();
+
+		merged.clear();
+		size_t k = 0;
+		Version current = entries[0].version;
+		for (int r = i; r < j; r++) {
+			const StringRef begin = ranges[r].first, end = ranges[r].second;
+			if (!(begin < end))
+				continue;
+			for (; k < entries.size() && entries[k].key < begin; k++) {
+				current = entries[k].version;
+				pushEntry(merged, entries[k].key, entries[k].version);
+			}
+			for (; k < entries.size() && entries[k].key < end; k++)
+				current = entries[k].version;
+			pushEntry(merged, begin, version);
+			const bool endExists =
+			    (k < entries.size() && entries[k].key == end) || (hasRegionEnd && k == entries.size() && end == regionEnd);
+			if (!endExists)
+				pushEntry(merged, end, current);
+		}
+		for (; k < entries.size(); k++)
+			pushEntry(merged, entries[k].key, entries[k].version);
+
+		replaceBlocks(first, last, merged);
+		i = j;
+	}
+}
+
+void CompressedConflictHistory::removeBefore(Version oldestVersion, int maxEntries) {
+	Arena arena;
+	std::vector<Entry> entries, kept;
+	auto it = blocks.lower_bound(removalCursor);
+	while (maxEntries > 0 && it != blocks.end()) {
+		maxEntries -= it->second.count;
+		auto next = std::next(it);
+		const bool small = it->second.count < MaxBlockEntries / 4 && next != blocks.end();
+		if (it->second.minVersion >= oldestVersion && !small) {
+			it = next;
+			continue;
+		}
+
+		// Merge a small block with its successor so removals don't leave the index full of tiny blocks
+		entries.clear();
+		decode(it->second, entries, arena);
+		auto last = next;
+		if (small) {
+			maxEntries -= next->second.count;
+			decode(next->second, entries, arena);
+			++last;
+		}
+
+		// Entries older than oldestVersion are interchangeable, so keep only the first of each run of them
+		kept.clear();
+		for (const Entry& e : entries) {
+			if (!kept.empty() && kept.back().version < oldestVersion && e.version < oldestVersion)
+				continue;
+			pushEntry(kept, e.key, e.version);
+		}
+		it = replaceBlocks(it, last, kept);
+		// A merged block may still be small; only move on once it has been examined at its final size
+		if (!small || it->second.count >= MaxBlockEntries / 4)
+			++it;
+		arena = Arena();
+	}
+	removalCursor = it == blocks.end() ? Key() : it->first;
+}
+
+int64_t CompressedConflictHistory::entryCount() const {
+	int64_t count = 0;
+	for (const auto& [key, block] : blocks)
+		count += block.count;
+	return count;
+}
+
+int64_t CompressedConflictHistory::bytes() const {
+	// std::map nodes carry three pointers and a color on top of the value
+	constexpr int64_t mapNodeOverhead = 4 * sizeof(void*);
+	int64_t total = sizeof(*this);
+	for (const auto& [key, block] : blocks)
+		total += mapNodeOverhead + sizeof(key) + sizeof(block) + key.expectedSize() + block.data.capacity();
+	return total;
+}
+
+namespace {
+// The step function as a plain map, for checking CompressedConflictHistory against
+struct NaiveConflictHistory {
+	std::map<std::string, Version> entries;
+
+	explicit NaiveConflictHistory(Version version) { entries[""] = version; }
+
+	Version at(const std::string& key) const { return std::prev(entries.upper_bound(key))->second; }
+
+	bool anyWriteAfter(const std::string& begin, const std::string& end, Version version) const {
+		if (at(begin) > version)
+			return true;
+		for (auto it = entries.upper_bound(begin); it != entries.end() && it->first < end; ++it)
+			if (it->second > version)
+				return true;
+		return false;
+	}
+
+	void add(const std::string& begin, const std::string& end, Version version) {
+		Version atEnd = at(end);
+		entries.erase(entries.lower_bound(begin), entries.lower_bound(end));
+		entries[begin] = version;
+		if (!entries.count(end))
+			entries[end] = atEnd;
+	}
+};
+
+std::string randomConflictKey(int keySpace) {
+	// Long shared prefixes, as with tuple-encoded keys, and varying lengths so prefix compression is exercised
+	std::string key = "prefix/table/";
+	key += std::to_string(deterministicRandom()->randomInt(0, keySpace));
+	if (deterministicRandom()->coinflip())
+		key += "/" + std::to_string(deterministicRandom()->randomInt(0, 100));
+	return key;
+}
+} // namespace
+
+TEST_CASE("/fdbserver/CompressedConflictHistory/matchesNaive") {
+	const int keySpace = deterministicRandom()->randomInt(10, 5000);
+	CompressedConflictHistory history(1);
+	NaiveConflictHistory naive(1);
+	Version oldest = 0;
+
+	for (Version version = 2; version < 300; version++) {
+		const int writes = deterministicRandom()->randomInt(0, 200);
+		std::vector<std::pair<std::string, std::string>> ranges;
+		for (int i = 0; i < writes; i++) {
+			std::string a = randomConflictKey(keySpace), b = randomConflictKey(keySpace);
+			if (b < a)
+				std::swap(a, b);
+			if (a == b)
+				b.push_back('\x00');
+			ranges.emplace_back(a, b);
+		}
+		// Make them sorted and disjoint, like combined write conflict ranges
+		std::sort(ranges.begin(), ranges.end());
+		std::vector<std::pair<StringRef, StringRef>> disjoint;
+		for (const auto& r : ranges) {
+			if (!disjoint.empty() && !(disjoint.back().second < StringRef(r.first)))
+				continue;
+			disjoint.emplace_back(StringRef(r.first), StringRef(r.second));
+		}
+		for (const auto& r : disjoint)
+			naive.add(r.first.toString(), r.second.toString(), version);
+		history.addConflictRanges(disjoint.data(), disjoint.size(), version);
+
+		if (deterministicRandom()->random01() < 0.3) {
+			oldest = std::max(oldest, version - deterministicRandom()->randomInt(1, 50));
+			history.removeBefore(oldest, deterministicRandom()->randomInt(1, 1000));
+		}
+
+		for (int i = 0; i < 100; i++) {
+			std::string a = randomConflictKey(keySpace), b = randomConflictKey(keySpace);
+			if (b < a)
+				std::swap(a, b);
+			Version readVersion = deterministicRandom()->randomInt(oldest, version + 1);
+			ASSERT_EQ(history.anyWriteAfter(StringRef(a), StringRef(b), readVersion),
+			          naive.anyWriteAfter(a, b, readVersion));
+		}
+	}
+	ASSERT(history.entryCount() <= naive.entries.size());
+	return Void();
+}
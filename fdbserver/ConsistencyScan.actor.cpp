@@ -61,17 +61,22 @@ struct ConsistencyScanStats {
 	Counter inconsistencies;
 	Counter databasePollSuccesses;
 	Counter databasePollErrors;
+	Counter checkSumMatches;
+	Counter checkSumMismatches;
 
 	bool waitingBetweenRounds = false;
 	int targetRate = 0;
+	int loadPercent = 100;
 
 	explicit ConsistencyScanStats(UID id, double interval)
 	  : cc("ConsistencyScanStats", id.toString()), logicalBytesScanned("LogicalBytesScanned", cc),
 	    replicatedBytesRead("ReplicatedBytesRead", cc), requests("Requests", cc), failedRequests("FailedRequests", cc),
 	    scanLoops("ScanLoops", cc), inconsistencies("Inconsistencies", cc),
-	    databasePollSuccesses("DatabasePollSuccesses", cc), databasePollErrors("DatabasePollErrors", cc) {
+	    databasePollSuccesses("DatabasePollSuccesses", cc), databasePollErrors("DatabasePollErrors", cc),
+	    checkSumMatches("CheckSumMatches", cc), checkSumMismatches("CheckSumMismatches", cc) {
 		specialCounter(cc, "WaitingBetweenRounds", [this]() { return this->waitingBetweenRounds; });
 		specialCounter(cc, "TargetRate", [this]() { return this->targetRate; });
+		specialCounter(cc, "LoadPercent", [this]() { return this->loadPercent; });
 		logger = cc.traceCounters("ConsistencyScanMetrics", id, interval, "ConsistencyScanMetrics");
 	}
 };
@@ -83,11 +88,35 @@ struct ConsistencyScanMemoryState : public ReferenceCounted<ConsistencyScanMemor
 	AsyncVar<int64_t> databaseSize = -1;
 	Reference<AsyncVar<ServerDBInfo> const> dbInfo;
 	ConsistencyScanStats stats;
+	// Fraction of the configured rate to read at. Halved after a scan loop iteration in which a replica reported being
+	// loaded, and raised by CONSISTENCY_SCAN_LOAD_FACTOR_INCREASE after one in which none did.
+	double loadFactor = 1.0;
 
 	explicit ConsistencyScanMemoryState(Reference<AsyncVar<ServerDBInfo> const> dbInfo, UID csId)
 	  : dbInfo(dbInfo), csId(csId), stats(csId, SERVER_KNOBS->WORKER_LOGGING_INTERVAL) {}
+
+	void updateLoadFactor(bool loaded) {
+		double factor = loaded ? loadFactor / 2 : loadFactor + SERVER_KNOBS->CONSISTENCY_SCAN_LOAD_FACTOR_INCREASE;
+		loadFactor = std::clamp(factor, std::min(SERVER_KNOBS->CONSISTENCY_SCAN_MIN_LOAD_FACTOR, 1.0), 1.0);
+		stats.loadPercent = (int)(loadFactor * 100);
+	}
 };
 
+// Whether a replica's reply shows it is busy enough with live traffic that the scan should slow down
+static bool replyShowsLoad(const LoadBalancedReply& reply) {
+	return reply.penalty > 1.0 || reply.busyness > SERVER_KNOBS->CONSISTENCY_SCAN_BUSYNESS_THRESHOLD;
+}
+
+// Set read options to minimize interference with live traffic
+// TODO: also use batch priority transaction?
+static ReadOptions consistencyScanReadOptions(Optional<Version> consistencyCheckStartVersion) {
+	ReadOptions readOptions;
+	readOptions.cacheResult = CacheResult::False;
+	readOptions.type = ReadType::LOW;
+	readOptions.consistencyCheckStartVersion = consistencyCheckStartVersion;
+	return readOptions;
+}
+
 // TODO: test the test and write a canary key that the storage servers intentionally get wrong
 // Get database KV bytes size from Status JSON at cluster.data.total_kv_size_bytes
 ACTOR Future<Void> pollDatabaseSize(Reference<ConsistencyScanMemoryState> memState, double interval) {
@@ -206,14 +235,7 @@ ACTOR Future<int> consistencyCheckReadData(UID myId,
 		}
 	}
 
-	// Set read options to minimize interference with live traffic
-	// TODO: also use batch priority transaction?
-	ReadOptions readOptions;
-	readOptions.cacheResult = CacheResult::False;
-	readOptions.type = ReadType::LOW;
-	readOptions.consistencyCheckStartVersion = consistencyCheckStartVersion;
-
-	req.options = readOptions;
+	req.options = consistencyScanReadOptions(consistencyCheckStartVersion);
 
 	DisabledTraceEvent("ConsistencyCheck_ReadDataStart", myId)
 	    .detail("Range", range)
@@ -510,6 +532,51 @@ ACTOR Future<int> consistencyCheckReadData(UID myId,
 	return 0;
 }
 
+// Asks every replica for a checksum of the same range, up to CONSISTENCY_SCAN_CHECKSUM_BYTES of it, so that ranges that
+// agree are compared without sending their data. Returns the checksum all replicas agreed on, or nothing if any failed
+// or they disagreed, in which case the caller reads the data to find the differences.
+ACTOR Future<Optional<CheckSumMetaData>> consistencyCheckCompareCheckSums(
+    UID myId,
+    KeyRange range,
+    Version version,
+    std::vector<StorageServerInterface>* storageServerInterfaces,
+    std::vector<Future<ErrorOr<GetStorageCheckSumReply>>>* checkSumFutures,
+    Optional<Version> consistencyCheckStartVersion) {
+	ASSERT(!range.empty());
+	state GetStorageCheckSumRequest req({ { range, version } }, myId, CheckSumMethod::XXH3);
+	req.limitBytes = SERVER_KNOBS->CONSISTENCY_SCAN_CHECKSUM_BYTES;
+	req.options = consistencyScanReadOptions(consistencyCheckStartVersion);
+
+	for (const auto& ssi : *storageServerInterfaces) {
+		resetReply(req);
+		checkSumFutures->push_back(ssi.getCheckSum.getReplyUnlessFailedFor(req, 2, 0));
+	}
+	wait(waitForAll(*checkSumFutures));
+
+	Optional<CheckSumMetaData> reference;
+	for (int j = 0; j < checkSumFutures->size(); j++) {
+		ErrorOr<GetStorageCheckSumReply> reply = (*checkSumFutures)[j].get();
+		if (!reply.present() || reply.get().error.present() || reply.get().checkSums.size() != 1) {
+			return Optional<CheckSumMetaData>();
+		}
+		const CheckSumMetaData& current = reply.get().checkSums[0];
+		if (!reference.present()) {
+			reference = current;
+		} else if (current.range != reference.get().range ||
+		           current.checkSumValue != reference.get().checkSumValue) {
+			TraceEvent("ConsistencyCheck_CheckSumMismatch", myId)
+			    .detail("Range", range)
+			    .detail("Version", version)
+			    .detail(format("StorageServer%d", j).c_str(), (*storageServerInterfaces)[j].id())
+			    .detail("StorageServer0", (*storageServerInterfaces)[0].id())
+			    .detail(format("Server%dRangeEnd", j).c_str(), current.range.end)
+			    .detail("Server0RangeEnd", reference.get().range.end);
+			return Optional<CheckSumMetaData>();
+		}
+	}
+	return reference;
+}
+
 ACTOR Future<Void> consistencyScanCore(Database db,
                                        Reference<ConsistencyScanMemoryState> memState,
                                        ConsistencyScanState cs) {
@@ -660,7 +727,8 @@ ACTOR Future<Void> consistencyScanCore(Database db,
 				configuredRate = std::min<int>(config.maxReadByteRate, bytesPerSecTarget);
 			}
 
-			configuredRate = std::max<int>(100e3, configuredRate);
+			// Back off while the replicas are loaded
+			configuredRate = std::max<int>(100e3, configuredRate * memState->loadFactor);
 
 			// FIXME: speed up scan if speedUpSimulation set?
 
@@ -679,6 +747,8 @@ ACTOR Future<Void> consistencyScanCore(Database db,
 			// because that's what our bandwidth limiting should be based on. We will wait on the rate control *after*
 			// reading using the actual amount that we read
 			state int totalReadBytesFromStorageServers = 0;
+			// Whether any replica reported load in this iteration
+			state bool replicasLoaded = false;
 
 			// We only want to update initialRoundState with *durable* progress, so if the loop below retries it must
 			// start from the same initial state, so save it here and restore it at the start of the transaction.
@@ -842,97 +912,178 @@ ACTOR Future<Void> consistencyScanCore(Database db,
 						// TODO: Also read from blob as one of the replicas?  If so, maybe separately track blob errors
 						// where blob disagrees from the other replicas, which would also be a general ++error
 
+						// Compare checksums first and only read the data of the parts whose checksums differ, up to
+						// checkSumMismatchEnd. Injected corruption is only in the data replies, so it needs reads.
+						state bool useCheckSums =
+						    SERVER_KNOBS->CONSISTENCY_SCAN_CHECKSUM_BYTES > 0 && storageServerInterfaces.size() > 1 &&
+						    !(g_network->isSimulated() &&
+						      g_simulator->consistencyScanState ==
+						          ISimulator::SimConsistencyScanState::Enabled_InjectCorruption);
+						state Key checkSumMismatchEnd = targetRange.begin;
+
 						loop {
-							state std::vector<Future<ErrorOr<GetKeyValuesReply>>> keyValueFutures;
-							state Optional<int> firstValidServer;
-							memState->stats.requests += storageServerInterfaces.size();
-							state int64_t replicatedBytesReadThisLoop = 0;
-							int newErrors = wait(consistencyCheckReadData(memState->csId,
-							                                              db,
-							                                              targetRange,
-							                                              tr->getReadVersion().get(),
-							                                              &storageServerInterfaces,
-							                                              &keyValueFutures,
-							                                              &firstValidServer,
-							                                              &replicatedBytesReadThisLoop,
-							                                              statsCurrentRound.startVersion));
-							errors += newErrors;
-							memState->stats.inconsistencies += newErrors;
-
-							// If any shard experienced an error, retry this key range
-							for (int i = 0; i < storageServerInterfaces.size(); i++) {
-								ErrorOr<GetKeyValuesReply> rangeResult = keyValueFutures[i].get();
-								if (!rangeResult.present()) {
-									failedRequest = rangeResult.getError();
-									break;
-								} else if (rangeResult.get().error.present()) {
-									failedRequest = rangeResult.get().error.get();
-									break;
+							if (useCheckSums && targetRange.begin >= checkSumMismatchEnd) {
+								state std::vector<Future<ErrorOr<GetStorageCheckSumReply>>> checkSumFutures;
+								memState->stats.requests += storageServerInterfaces.size();
+								Optional<CheckSumMetaData> agreed =
+								    wait(consistencyCheckCompareCheckSums(memState->csId,
+								                                          targetRange,
+								                                          tr->getReadVersion().get(),
+								                                          &storageServerInterfaces,
+								                                          &checkSumFutures,
+								                                          statsCurrentRound.startVersion));
+
+								// Replicas that cannot checksum, like ones not yet upgraded, send their data instead
+								bool checkSumUnsupported = false;
+								int64_t checkSumBytes = 0;
+								Key mismatchEnd = targetRange.begin;
+								for (int i = 0; i < storageServerInterfaces.size(); i++) {
+									ErrorOr<GetStorageCheckSumReply> reply = checkSumFutures[i].get();
+									if (!reply.present()) {
+										if (reply.getError().code() == error_code_not_implemented) {
+											checkSumUnsupported = true;
+										} else {
+											failedRequest = reply.getError();
+											break;
+										}
+									} else if (reply.get().error.present()) {
+										failedRequest = reply.get().error.get();
+										break;
+									} else {
+										replicasLoaded = replicasLoaded || replyShowsLoad(reply.get());
+										for (const auto& checkSum : reply.get().checkSums) {
+											checkSumBytes += checkSum.bytes;
+											mismatchEnd = std::max<Key>(mismatchEnd, checkSum.range.end);
+										}
+									}
 								}
-							}
 
-							// throttle always includes replicated bytes read in total read bytes for throttling
-							totalReadBytesFromStorageServers += replicatedBytesReadThisLoop;
-							if (!failedRequest.present() && !newErrors) {
-								ASSERT(firstValidServer.present());
-								GetKeyValuesReply rangeResult = keyValueFutures[firstValidServer.get()].get().get();
-								logicalBytesRead += rangeResult.data.expectedSize();
-								replicatedBytesRead += replicatedBytesReadThisLoop;
-								if (!rangeResult.more) {
-									statsCurrentRound.lastEndKey = targetRange.end;
-									noMoreRecords = statsCurrentRound.lastEndKey == allKeys.end;
+								if (failedRequest.present()) {
+									CODE_PROBE(failedRequest.get().code() == error_code_transaction_too_old,
+									           "consistency scan checksum of shard too large for one transaction");
+									if (failedRequest.get().code() != error_code_transaction_too_old) {
+										TraceEvent("ConsistencyScan_FailedCheckSumRequest", memState->csId)
+										    .errorUnsuppressed(failedRequest.get())
+										    .suppressFor(5.0);
+										++memState->stats.failedRequests;
+									}
+									totalReadBytesFromStorageServers += 100000;
 									break;
-								} else {
-									VectorRef<KeyValueRef> result =
-									    keyValueFutures[firstValidServer.get()].get().get().data;
-									ASSERT(result.size() > 0);
-									statsCurrentRound.lastEndKey = keyAfter(result.back().key);
-									targetRange = KeyRangeRef(statsCurrentRound.lastEndKey, targetRange.end);
-									if (targetRange.empty()) {
+								}
+								// storage servers read the bytes they checksum, so throttle on them too
+								totalReadBytesFromStorageServers += checkSumBytes;
+								if (agreed.present()) {
+									++memState->stats.checkSumMatches;
+									logicalBytesRead += agreed.get().bytes;
+									replicatedBytesRead += checkSumBytes;
+									statsCurrentRound.lastEndKey = agreed.get().range.end;
+									if (agreed.get().range.end >= targetRange.end) {
 										noMoreRecords = targetRange.end == allKeys.end;
 										break;
 									}
+									targetRange = KeyRangeRef(statsCurrentRound.lastEndKey, targetRange.end);
+								} else if (checkSumUnsupported) {
+									CODE_PROBE(true, "consistency scan replica cannot checksum");
+									checkSumMismatchEnd = targetRange.end;
+								} else {
+									CODE_PROBE(true, "consistency scan checksum mismatch");
+									++memState->stats.checkSumMismatches;
+									checkSumMismatchEnd =
+									    mismatchEnd > targetRange.begin ? mismatchEnd : Key(targetRange.end);
 								}
-							} else if (!failedRequest.present() && newErrors) {
-								// responses will disagree on the next key, just take the max of the possible ones to
-								// ensure we can make progress past this corruption
-								Key nextKey = statsCurrentRound.lastEndKey;
+							} else {
+								state std::vector<Future<ErrorOr<GetKeyValuesReply>>> keyValueFutures;
+								state Optional<int> firstValidServer;
+								memState->stats.requests += storageServerInterfaces.size();
+								state int64_t replicatedBytesReadThisLoop = 0;
+								int newErrors = wait(consistencyCheckReadData(memState->csId,
+								                                              db,
+								                                              targetRange,
+								                                              tr->getReadVersion().get(),
+								                                              &storageServerInterfaces,
+								                                              &keyValueFutures,
+								                                              &firstValidServer,
+								                                              &replicatedBytesReadThisLoop,
+								                                              statsCurrentRound.startVersion));
+								errors += newErrors;
+								memState->stats.inconsistencies += newErrors;
+
+								// If any shard experienced an error, retry this key range
 								for (int i = 0; i < storageServerInterfaces.size(); i++) {
-									GetKeyValuesReply rangeResult = keyValueFutures[i].get().get();
-									if (i == firstValidServer.get()) {
-										logicalBytesRead += rangeResult.data.expectedSize();
-									}
-									Key storageNextKey = (rangeResult.more && rangeResult.data.size() > 0)
-									                         ? keyAfter(rangeResult.data.back().key)
-									                         : targetRange.end;
-									if (storageNextKey > nextKey) {
-										nextKey = storageNextKey;
+									ErrorOr<GetKeyValuesReply> rangeResult = keyValueFutures[i].get();
+									if (!rangeResult.present()) {
+										failedRequest = rangeResult.getError();
+										break;
+									} else if (rangeResult.get().error.present()) {
+										failedRequest = rangeResult.get().error.get();
+										break;
 									}
+									replicasLoaded = replicasLoaded || replyShowsLoad(rangeResult.get());
 								}
-								replicatedBytesRead += replicatedBytesReadThisLoop;
-								statsCurrentRound.lastEndKey = nextKey;
-								if (nextKey == targetRange.end) {
-									noMoreRecords = nextKey == allKeys.end;
-									break;
+
+								// throttle always includes replicated bytes read in total read bytes for throttling
+								totalReadBytesFromStorageServers += replicatedBytesReadThisLoop;
+								if (!failedRequest.present() && !newErrors) {
+									ASSERT(firstValidServer.present());
+									GetKeyValuesReply rangeResult = keyValueFutures[firstValidServer.get()].get().get();
+									logicalBytesRead += rangeResult.data.expectedSize();
+									replicatedBytesRead += replicatedBytesReadThisLoop;
+									if (!rangeResult.more) {
+										statsCurrentRound.lastEndKey = targetRange.end;
+										noMoreRecords = statsCurrentRound.lastEndKey == allKeys.end;
+										break;
+									} else {
+										VectorRef<KeyValueRef> result =
+										    keyValueFutures[firstValidServer.get()].get().get().data;
+										ASSERT(result.size() > 0);
+										statsCurrentRound.lastEndKey = keyAfter(result.back().key);
+										targetRange = KeyRangeRef(statsCurrentRound.lastEndKey, targetRange.end);
+										if (targetRange.empty()) {
+											noMoreRecords = targetRange.end == allKeys.end;
+											break;
+										}
+									}
+								} else if (!failedRequest.present() && newErrors) {
+									// responses will disagree on the next key, just take the max of the possible ones
+									// to ensure we can make progress past this corruption
+									Key nextKey = statsCurrentRound.lastEndKey;
+									for (int i = 0; i < storageServerInterfaces.size(); i++) {
+										GetKeyValuesReply rangeResult = keyValueFutures[i].get().get();
+										if (i == firstValidServer.get()) {
+											logicalBytesRead += rangeResult.data.expectedSize();
+										}
+										Key storageNextKey = (rangeResult.more && rangeResult.data.size() > 0)
+										                         ? keyAfter(rangeResult.data.back().key)
+										                         : targetRange.end;
+										if (storageNextKey > nextKey) {
+											nextKey = storageNextKey;
+										}
+									}
+									replicatedBytesRead += replicatedBytesReadThisLoop;
+									statsCurrentRound.lastEndKey = nextKey;
+									if (nextKey == targetRange.end) {
+										noMoreRecords = nextKey == allKeys.end;
+										break;
+									} else {
+										targetRange = KeyRangeRef(nextKey, targetRange.end);
+									}
 								} else {
-									targetRange = KeyRangeRef(nextKey, targetRange.end);
-								}
-							} else {
-								// transaction too old expected here for large shards
-								CODE_PROBE(failedRequest.get().code() == error_code_transaction_too_old,
-								           "consistency scan loop shard too large for one transaction");
-								if (failedRequest.get().code() != error_code_transaction_too_old) {
-									TraceEvent("ConsistencyScan_FailedRequest", memState->csId)
-									    .errorUnsuppressed(failedRequest.get())
-									    .suppressFor(5.0);
-									++memState->stats.failedRequests;
+									// transaction too old expected here for large shards
+									CODE_PROBE(failedRequest.get().code() == error_code_transaction_too_old,
+									           "consistency scan loop shard too large for one transaction");
+									if (failedRequest.get().code() != error_code_transaction_too_old) {
+										TraceEvent("ConsistencyScan_FailedRequest", memState->csId)
+										    .errorUnsuppressed(failedRequest.get())
+										    .suppressFor(5.0);
+										++memState->stats.failedRequests;
+									}
+									// FIXME: increment failed request count if error present
+									ASSERT(failedRequest.get().code() != error_code_operation_cancelled);
+									// don't include replicated bytes this loop in metrics to avoid getting replication
+									// factor wrong, but make sure we still throttle based on it
+									totalReadBytesFromStorageServers += 100000;
+									break;
 								}
-								// FIXME: increment failed request count if error present
-								ASSERT(failedRequest.get().code() != error_code_operation_cancelled);
-								// don't include replicated bytes this loop in metrics to avoid getting replication
-								// factor wrong, but make sure we still throttle based on it
-								totalReadBytesFromStorageServers += 100000;
-								break;
 							}
 
 							// we want to make a decent amount of progress per transaction here to reduce overhead, but
@@ -1061,6 +1212,7 @@ ACTOR Future<Void> consistencyScanCore(Database db,
 
 			// Wait for the rate control to generate enough budget to match what we read.
 			wait(readRateControl->getAllowance(totalReadBytesFromStorageServers));
+			memState->updateLoadFactor(replicasLoaded);
 
 			if (DEBUG_SCAN_PROGRESS) {
 				TraceEvent(SevDebug, "ConsistencyScanProgressRateLimited", memState->csId);
@@ -321,6 +321,9 @@ ACTOR Future<Void> leaderRegister(LeaderElectionRegInterface interf, Key key) {
 	state Reference<AsyncVar<Optional<LeaderInfo>>> currentElectedLeader =
 	    makeReference<AsyncVar<Optional<LeaderInfo>>>();
 	state LivenessChecker canConnectToLeader(SERVER_KNOBS->COORDINATOR_LEADER_CONNECTION_TIMEOUT);
+	// Shared by every waiting openDatabase request. A check per request would wake once per waiting client on every
+	// leader heartbeat.
+	state Future<Void> leaderStuck;
 	state Future<Void> hasConnectedClientsOnChange = hasConnectedClients->onChange();
 
 	loop choose {
@@ -334,8 +337,10 @@ ACTOR Future<Void> leaderRegister(LeaderElectionRegInterface interf, Key key) {
 					leaderMon = monitorLeaderAndGetClientInfo(
 					    req.clusterKey, req.hostnames, req.coordinators, &clientData, currentElectedLeader);
 				}
-				actors.add(
-				    openDatabase(&clientData, &clientCount, hasConnectedClients, req, canConnectToLeader.checkStuck()));
+				if (!leaderStuck.isValid() || leaderStuck.isReady()) {
+					leaderStuck = canConnectToLeader.checkStuck();
+				}
+				actors.add(openDatabase(&clientData, &clientCount, hasConnectedClients, req, leaderStuck));
 			}
 		}
 		when(ElectionResultRequest req = waitNext(interf.electionResult.getFuture())) {
@@ -584,6 +584,7 @@ DDQueue::DDQueue(DDQueueInitParams const& params)
     cleanUpDataMoveParallelismLock(SERVER_KNOBS->DD_MOVE_KEYS_PARALLELISM),
     fetchSourceLock(new FlowLock(SERVER_KNOBS->DD_FETCH_SOURCE_PARALLELISM)), activeRelocations(0),
     queuedRelocations(0), bytesWritten(0), teamSize(params.teamSize), singleRegionTeamSize(params.singleRegionTeamSize),
+    storageServerStoreType(params.storageServerStoreType),
     output(params.relocationProducer), input(params.relocationConsumer), getShardMetrics(params.getShardMetrics),
     getTopKMetrics(params.getTopKMetrics), lastInterval(0), suppressIntervals(0),
     rawProcessingUnhealthy(new AsyncVar<bool>(false)), rawProcessingWiggle(new AsyncVar<bool>(false)),
@@ -987,9 +988,14 @@ void DDQueue::launchQueuedWork(RelocateData launchData, const DDEnabledState* dd
 	launchQueuedWork(combined, ddEnabledState);
 }
 
-DataMoveType newDataMoveType(bool doBulkLoading) {
+// Moves between ShardedRocksDB storage servers can ship checkpoints of the source shard instead of reading and writing
+// it key by key. Destination servers that are not shard aware fall back to a logical move of the same data move.
+DataMoveType newDataMoveType(bool doBulkLoading, KeyValueStoreType storeType) {
 	DataMoveType type = DataMoveType::LOGICAL;
-	if (deterministicRandom()->random01() < SERVER_KNOBS->DD_PHYSICAL_SHARD_MOVE_PROBABILITY) {
+	if (storeType == KeyValueStoreType::SSD_SHARDED_ROCKSDB &&
+	    SERVER_KNOBS->DD_PHYSICAL_SHARD_MOVE_FOR_SHARDED_ROCKSDB) {
+		type = DataMoveType::PHYSICAL;
+	} else if (deterministicRandom()->random01() < SERVER_KNOBS->DD_PHYSICAL_SHARD_MOVE_PROBABILITY) {
 		type = DataMoveType::PHYSICAL;
 	}
 	if (type != DataMoveType::PHYSICAL && SERVER_KNOBS->ENABLE_PHYSICAL_SHARD_MOVE_EXPERIMENT) {
@@ -1177,7 +1183,7 @@ void DDQueue::launchQueuedWork(std::set<RelocateData, std::greater<RelocateData>
 					} else {
 						rrs.dataMoveId = newDataMoveId(deterministicRandom()->randomUInt64(),
 						                               AssignEmptyRange::False,
-						                               newDataMoveType(doBulkLoading),
+						                               newDataMoveType(doBulkLoading, storageServerStoreType),
 						                               rrs.dmReason);
 						TraceEvent(SevInfo, "NewDataMoveWithRandomDestID", this->distributorId)
 						    .detail("DataMoveID", rrs.dataMoveId.toString())
@@ -1387,6 +1393,9 @@ void traceRelocateDecision(TraceEvent& ev, const UID& pairId, const RelocateDeci
 		    .detail("ParentShardWriteBytes", decision.parentMetrics.get().bytesWrittenPerKSecond);
 	} else if (decision.rd.reason == RelocateReason::SIZE_SPLIT) {
 		ev.detail("ShardSize", decision.metrics.bytes).detail("ParentShardSize", decision.parentMetrics.get().bytes);
+	} else if (decision.rd.reason == RelocateReason::READ_SPLIT) {
+		ev.detail("ShardReadBytes", decision.metrics.bytesReadPerKSecond)
+		    .detail("ParentShardReadBytes", decision.parentMetrics.get().bytesReadPerKSecond);
 	}
 }
 
@@ -1837,8 +1846,10 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 					} else {
 						self->moveCreateNewPhysicalShard++;
 					}
-					rd.dataMoveId = newDataMoveId(
-					    physicalShardIDCandidate, AssignEmptyRange::False, newDataMoveType(doBulkLoading), rd.dmReason);
+					rd.dataMoveId = newDataMoveId(physicalShardIDCandidate,
+					                              AssignEmptyRange::False,
+					                              newDataMoveType(doBulkLoading, self->storageServerStoreType),
+					                              rd.dmReason);
 					TraceEvent(SevInfo, "NewDataMoveWithPhysicalShard")
 					    .detail("DataMoveID", rd.dataMoveId.toString())
 					    .detail("Reason", rd.reason.toString())
@@ -350,11 +350,82 @@ ACTOR Future<Void> trackShardMetrics(DataDistributionTracker::SafeAccessor self,
 	}
 }
 
+// Assigns keys to the storage cache servers, unless it overlaps a range that is cached already, in which case that
+// range is kept cached for longer
+ACTOR Future<Void> cacheReadHotRange(DataDistributionTracker* self, KeyRange keys) {
+	bool overlaps = false;
+	for (auto& [range, lastHot] : self->cachedReadHotRanges) {
+		if (range.intersects(keys)) {
+			lastHot = now();
+			overlaps = true;
+		}
+	}
+	if (overlaps || self->cachedReadHotRanges.size() >= SERVER_KNOBS->DD_CACHE_READ_HOT_RANGES_MAX) {
+		return Void();
+	}
+
+	self->cachedReadHotRanges.emplace_back(keys, now());
+	bool cached = wait(self->db->changeCachedRange(keys, true));
+	if (!cached) {
+		// No cache servers to assign it to
+		auto& cachedRanges = self->cachedReadHotRanges;
+		for (auto it = cachedRanges.begin(); it != cachedRanges.end(); ++it) {
+			if (it->first == keys) {
+				cachedRanges.erase(it);
+				break;
+			}
+		}
+		return Void();
+	}
+	TraceEvent("DDCacheReadHotRange", self->distributorId).detail("Begin", keys.begin).detail("End", keys.end);
+	return Void();
+}
+
+// Removes the cached read hot ranges that have not been read hot for DD_CACHE_READ_HOT_RANGE_TTL
+ACTOR Future<Void> uncacheColdRanges(DataDistributionTracker* self) {
+	state std::vector<KeyRange> expired;
+	state int i;
+	loop {
+		wait(delay(SERVER_KNOBS->DD_CACHE_READ_HOT_RANGE_TTL / 2));
+		expired.clear();
+		auto& cached = self->cachedReadHotRanges;
+		for (auto it = cached.begin(); it != cached.end();) {
+			if (now() - it->second > SERVER_KNOBS->DD_CACHE_READ_HOT_RANGE_TTL) {
+				expired.push_back(it->first);
+				it = cached.erase(it);
+			} else {
+				++it;
+			}
+		}
+		for (i = 0; i < expired.size(); i++) {
+			wait(success(self->db->changeCachedRange(expired[i], false)));
+			TraceEvent("DDUncacheColdRange", self->distributorId)
+			    .detail("Begin", expired[i].begin)
+			    .detail("End", expired[i].end);
+		}
+	}
+}
+
+void splitReadHotShard(DataDistributionTracker* self,
+                       KeyRange keys,
+                       Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges);
+
 ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
+	state Future<Void> uncacheCold = SERVER_KNOBS->DD_CACHE_READ_HOT_RANGES ? uncacheColdRanges(self) : Never();
+	state KeyRange keys;
+	state Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges;
+	state int i;
 	try {
 		loop {
-			state KeyRange keys = waitNext(self->readHotShard.getFuture());
-			Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges = wait(self->db->getReadHotRanges(keys));
+			choose {
+				when(KeyRange readHotShard = waitNext(self->readHotShard.getFuture())) {
+					keys = readHotShard;
+				}
+				when(wait(uncacheCold)) {
+					UNREACHABLE();
+				}
+			}
+			wait(store(readHotRanges, self->db->getReadHotRanges(keys)));
 
 			for (const auto& keyRange : readHotRanges) {
 				TraceEvent("ReadHotRangeLog")
@@ -364,6 +435,16 @@ ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
 				    .detail("KeyRangeBegin", keyRange.keys.begin)
 				    .detail("KeyRangeEnd", keyRange.keys.end);
 			}
+
+			if (SERVER_KNOBS->DD_SPLIT_READ_HOT_SHARDS && !readHotRanges.empty()) {
+				splitReadHotShard(self, keys, readHotRanges);
+			}
+
+			if (SERVER_KNOBS->DD_CACHE_READ_HOT_RANGES) {
+				for (i = 0; i < readHotRanges.size(); i++) {
+					wait(cacheReadHotRange(self, readHotRanges[i].keys));
+				}
+			}
 		}
 	} catch (Error& e) {
 		if (e.code() != error_code_actor_cancelled) {
@@ -494,17 +575,22 @@ void traceSplit(KeyRange keys, Standalone<VectorRef<KeyRef>>& splitKeys) {
 	TraceEvent(SevInfo, "ExecutingShardSplit").detail("AtKeys", s);
 }
 
+// Splits keys at splitKeys, and relocates every piece except the one at skipRange, or a random one if it is negative
 void executeShardSplit(DataDistributionTracker* self,
                        KeyRange keys,
                        Standalone<VectorRef<KeyRef>> splitKeys,
                        Reference<AsyncVar<Optional<ShardMetrics>>> shardSize,
                        bool relocate,
-                       RelocateReason reason) {
+                       RelocateReason reason,
+                       int skipRange = -1) {
 
 	int numShards = splitKeys.size() - 1;
 	ASSERT(numShards > 1);
 
-	int skipRange = deterministicRandom()->randomInt(0, numShards);
+	if (skipRange < 0) {
+		skipRange = deterministicRandom()->randomInt(0, numShards);
+	}
+	ASSERT(skipRange < numShards);
 
 	auto s = describeSplit(keys, splitKeys);
 	TraceEvent(SevInfo, "ExecutingShardSplit").suppressFor(0.5).detail("Splitting", s).detail("NumShards", numShards);
@@ -539,6 +625,57 @@ void executeShardSplit(DataDistributionTracker* self,
 	self->actors.add(changeSizes(self, keys, shardSize->get().get().metrics.bytes, "ShardSplit"));
 }
 
+void splitReadHotShard(DataDistributionTracker* self,
+                       KeyRange keys,
+                       Standalone<VectorRef<ReadHotRangeWithMetrics>> readHotRanges) {
+	auto shard = self->shards->rangeContaining(keys.begin);
+	// The shard may have been split or merged since it was found to be read hot
+	if (shard->range() != keys || !shard->value().stats->get().present() || keys.begin >= keyServersKeys.begin ||
+	    (self->bulkLoadEnabled && self->bulkLoadTaskCollection->overlappingTask(keys))) {
+		return;
+	}
+
+	// Cut the hot ranges out of the shard, so that they can move to other teams while the cold rest stays put
+	std::set<KeyRef> boundaries;
+	for (const auto& hot : readHotRanges) {
+		for (KeyRef key : { hot.keys.begin, hot.keys.end }) {
+			if (key > keys.begin && key < keys.end) {
+				boundaries.insert(key);
+			}
+		}
+	}
+	if (boundaries.empty()) {
+		return;
+	}
+	Standalone<VectorRef<KeyRef>> splitKeys;
+	splitKeys.push_back_deep(splitKeys.arena(), keys.begin);
+	for (KeyRef key : boundaries) {
+		splitKeys.push_back_deep(splitKeys.arena(), key);
+	}
+	splitKeys.push_back_deep(splitKeys.arena(), keys.end);
+
+	// Keep the first piece that is not hot where it is, or else the last piece
+	int skipRange = splitKeys.size() - 2;
+	for (int i = 0; i < splitKeys.size() - 1; i++) {
+		KeyRangeRef piece(splitKeys[i], splitKeys[i + 1]);
+		if (std::none_of(readHotRanges.begin(), readHotRanges.end(), [&](const ReadHotRangeWithMetrics& hot) {
+			    return hot.keys.intersects(piece);
+		    })) {
+			skipRange = i;
+			break;
+		}
+	}
+
+	CODE_PROBE(true, "Split read hot shard");
+	TraceEvent("RelocateShardStartReadSplit", self->distributorId)
+	    .suppressFor(1.0)
+	    .detail("Begin", keys.begin)
+	    .detail("End", keys.end)
+	    .detail("HotRanges", readHotRanges.size())
+	    .detail("NumShards", splitKeys.size() - 1);
+	executeShardSplit(self, keys, splitKeys, shard->value().stats, true, RelocateReason::READ_SPLIT, skipRange);
+}
+
 struct RangeToSplit {
 	RangeMap<Standalone<StringRef>, ShardTrackedData, KeyRangeRef>::iterator shard;
 	Standalone<VectorRef<KeyRef>> faultLines;
@@ -1246,7 +1383,11 @@ ACTOR Future<Void> shardEvaluator(DataDistributionTracker* self,
 	if (keys.end < allKeys.end)
 		++nextIter;
 
-	bool shouldMerge = stats.bytes < shardBounds.min.bytes && bandwidthStatus == BandwidthStatusLow &&
+	// A shard split off because it was read hot is not merged back while it stays hot
+	bool readHot = SERVER_KNOBS->DD_SPLIT_READ_HOT_SHARDS &&
+	               (getReadBandwidthStatus(stats) == ReadBandwidthStatusHigh ||
+	                stats.opsReadPerKSecond > SERVER_KNOBS->SHARD_MAX_READ_OPS_PER_KSEC);
+	bool shouldMerge = stats.bytes < shardBounds.min.bytes && bandwidthStatus == BandwidthStatusLow && !readHot &&
 	                   (shardForwardMergeFeasible(self, keys, nextIter.range()) ||
 	                    shardBackwardMergeFeasible(self, keys, prevIter.range()));
 	if (onBulkLoading && shouldMerge) {
@@ -323,6 +323,28 @@ public:
 		return threshold;
 	}
 
+	// The average predicted write bandwidth and read ops, over the servers with metrics
+	static std::pair<double, double> getAveragePredictedLoad(DDTeamCollection const* self) {
+		double writeBandwidth = 0, readOps = 0;
+		int count = 0;
+		for (const auto& [id, server] : self->server_info) {
+			if (server->metricsPresent()) {
+				writeBandwidth += server->predictedWriteBandwidth();
+				readOps += server->predictedReadOps();
+				count++;
+			}
+		}
+		return count ? std::make_pair(writeBandwidth / count, readOps / count) : std::make_pair(0.0, 0.0);
+	}
+
+	// Scales a team's load bytes by its predicted utilization, with DD_PREDICTED_LOAD_WEIGHT > 0
+	static int64_t withPredictedLoad(int64_t loadBytes,
+	                                 Reference<TCTeamInfo> const& team,
+	                                 std::pair<double, double> const& averageLoad) {
+		return loadBytes * (1 + SERVER_KNOBS->DD_PREDICTED_LOAD_WEIGHT *
+		                            team->getPredictedUtilization(averageLoad.first, averageLoad.second));
+	}
+
 	// Returns the overall best team that matches the requirement from `req`. When preferWithinShardLimit is true, it
 	// also tries to select a team whose existing shard is less than SERVER_KNOBS->DESIRED_MAX_SHARDS_PER_TEAM.
 	static Optional<Reference<IDataDistributionTeam>> getBestTeam(DDTeamCollection* self,
@@ -340,6 +362,8 @@ public:
 		int64_t bestLoadBytes = 0;
 		bool wigglingBestOption = false; // best option contains server in paused wiggle state
 		int bestIndex = startIndex;
+		bool usePredictedLoad = SERVER_KNOBS->DD_PREDICTED_LOAD_WEIGHT > 0;
+		std::pair<double, double> averageLoad = usePredictedLoad ? getAveragePredictedLoad(self) : std::pair(0.0, 0.0);
 		for (int i = 0; i < self->teams.size(); i++) {
 			int currentIndex = (startIndex + i) % self->teams.size();
 			if (self->teams[currentIndex]->isHealthy()) {
@@ -350,6 +374,9 @@ public:
 				}
 
 				int64_t loadBytes = self->teams[currentIndex]->getLoadBytes(true, req.inflightPenalty);
+				if (usePredictedLoad) {
+					loadBytes = withPredictedLoad(loadBytes, self->teams[currentIndex], averageLoad);
+				}
 				if (req.storageQueueAware) {
 					Optional<int64_t> storageQueueSize = self->teams[currentIndex]->getLongestStorageQueueSize();
 					if (!storageQueueSize.present()) {
@@ -404,8 +431,13 @@ public:
 		Optional<Reference<IDataDistributionTeam>> bestOption;
 		int64_t bestLoadBytes = 0;
 		bool wigglingBestOption = false; // best option contains server in paused wiggle state
+		bool usePredictedLoad = SERVER_KNOBS->DD_PREDICTED_LOAD_WEIGHT > 0;
+		std::pair<double, double> averageLoad = usePredictedLoad ? getAveragePredictedLoad(self) : std::pair(0.0, 0.0);
 		for (int i = 0; i < candidates.size(); i++) {
 			int64_t loadBytes = candidates[i]->getLoadBytes(true, req.inflightPenalty);
+			if (usePredictedLoad) {
+				loadBytes = withPredictedLoad(loadBytes, candidates[i], averageLoad);
+			}
 			if (!bestOption.present() || req.lessCompare(bestOption.get(), candidates[i], bestLoadBytes, loadBytes)) {
 
 				// bestOption doesn't contain wiggling SS while current team does. Don't replace bestOption
@@ -1681,6 +1713,10 @@ public:
 						server->wakeUpTracker = Promise<Void>();
 					}
 					when(wait(storageMetadataTracker)) {}
+					when(wait(server->storageEngineWrongConfigured.onChange())) {
+						// Update wrongConfigured in the server's metadata so the wiggler prioritizes it
+						storageMetadataTracker = self->updateStorageMetadata(server);
+					}
 					when(wait(server->ssVersionTooFarBehind.onChange())) {}
 					when(wait(self->disableFailingLaggingServers.onChange())) {}
 					when(wait(server->longStorageQueue.onChange())) {
@@ -3304,7 +3340,8 @@ public:
 		    !(server->isCorrectStoreType(isTss ? self->configuration.testingStorageServerStoreType
 		                                       : self->configuration.storageServerStoreType) ||
 		      server->isCorrectStoreType(isTss ? self->configuration.testingStorageServerStoreType
-		                                       : self->configuration.perpetualStoreType)));
+		                                       : self->configuration.perpetualStoreType)) ||
+		        server->storageEngineWrongConfigured.get());
 
 		// read storage metadata
 		loop {
@@ -5985,27 +6022,68 @@ void DDTeamCollection::removeServer(UID removedServer) {
 	    .detail("DesiredTeamsPerServer", SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER);
 }
 
+Optional<Future<Void>> DDTeamCollection::excludeStorageServerForWiggle(const Reference<TCServerInfo>& info) {
+	AddressExclusion addr(info->getLastKnownInterface().address().ip, info->getLastKnownInterface().address().port);
+
+	// don't overwrite the value set by actor trackExcludedServer
+	bool abnormal =
+	    this->excludedServers.count(addr) && this->excludedServers.get(addr) != DDTeamCollection::Status::NONE;
+
+	if (info->getLastKnownInterface().secondaryAddress().present()) {
+		AddressExclusion addr2(info->getLastKnownInterface().secondaryAddress().get().ip,
+		                       info->getLastKnownInterface().secondaryAddress().get().port);
+		abnormal |=
+		    this->excludedServers.count(addr2) && this->excludedServers.get(addr2) != DDTeamCollection::Status::NONE;
+	}
+
+	if (abnormal) {
+		return {};
+	}
+	this->wiggleAddresses.push_back(addr);
+	this->excludedServers.set(addr, DDTeamCollection::Status::WIGGLING);
+	return info->onRemoved;
+}
+
 Future<Void> DDTeamCollection::excludeStorageServersForWiggle(const UID& id) {
 	Future<Void> moveFuture = Void();
 	if (this->server_info.count(id) != 0) {
 		auto& info = server_info.at(id);
-		AddressExclusion addr(info->getLastKnownInterface().address().ip, info->getLastKnownInterface().address().port);
+		Optional<Future<Void>> removed = excludeStorageServerForWiggle(info);
+		if (removed.present()) {
+			std::vector<Future<Void>> removedFutures{ removed.get() };
 
-		// don't overwrite the value set by actor trackExcludedServer
-		bool abnormal =
-		    this->excludedServers.count(addr) && this->excludedServers.get(addr) != DDTeamCollection::Status::NONE;
-
-		if (info->getLastKnownInterface().secondaryAddress().present()) {
-			AddressExclusion addr2(info->getLastKnownInterface().secondaryAddress().get().ip,
-			                       info->getLastKnownInterface().secondaryAddress().get().port);
-			abnormal |= this->excludedServers.count(addr2) &&
-			            this->excludedServers.get(addr2) != DDTeamCollection::Status::NONE;
-		}
-
-		if (!abnormal) {
-			this->wiggleAddresses.push_back(addr);
-			this->excludedServers.set(addr, DDTeamCollection::Status::WIGGLING);
-			moveFuture = info->onRemoved;
+			// Teams never hold two servers of the same zone, so wiggling more servers of the wiggled server's zone at
+			// once costs no more fault tolerance than wiggling it alone, and cuts the number of wiggle rounds
+			Optional<Standalone<StringRef>> zoneId = info->getLastKnownInterface().locality.zoneId();
+			std::vector<std::pair<Optional<Value>, Optional<Value>>> localityKeyValues;
+			if (configuration.perpetualStorageWiggleLocality != "0") {
+				localityKeyValues = ParsePerpetualStorageWiggleLocality(configuration.perpetualStorageWiggleLocality);
+			}
+			for (auto& [otherId, other] : server_info) {
+				if (!zoneId.present() || removedFutures.size() >= SERVER_KNOBS->PERPETUAL_WIGGLE_MAX_SERVERS_PER_ZONE) {
+					break;
+				}
+				if (otherId == id || other->getLastKnownInterface().locality.zoneId() != zoneId ||
+				    other->getLastKnownInterface().address() == info->getLastKnownInterface().address() ||
+				    !storageWiggler->necessary(otherId) ||
+				    (!localityKeyValues.empty() &&
+				     !localityMatchInList(localityKeyValues, other->getLastKnownInterface().locality))) {
+					continue;
+				}
+				removed = excludeStorageServerForWiggle(other);
+				if (removed.present()) {
+					removedFutures.push_back(removed.get());
+				}
+			}
+			if (removedFutures.size() > 1) {
+				CODE_PROBE(true, "Perpetual wiggle excluded several servers of one zone");
+				TraceEvent("PerpetualStorageWiggleZone", distributorId)
+				    .detail("Primary", primary)
+				    .detail("ServerId", id)
+				    .detail("ZoneId", zoneId.get())
+				    .detail("NumServers", removedFutures.size());
+			}
+			moveFuture = waitForAll(removedFutures);
 			this->restartRecruiting.trigger();
 		}
 	}
@@ -6789,6 +6867,30 @@ public:
 	}
 
 	// Cut off high Cpu teams
+	static void StorageWiggler_PreferSmallerServers() {
+		std::unique_ptr<DDTeamCollection> collection =
+		    testMachineTeamCollection(1, Reference<IReplicationPolicy>(new PolicyOne()), 4);
+		Reference<StorageWiggler> wiggler = makeReference<StorageWiggler>(collection.get());
+		double startTime = now() - SERVER_KNOBS->DD_STORAGE_WIGGLE_MIN_SS_AGE_SEC - 10.0;
+		std::vector<int64_t> loadBytes{ 300, 100, 200, 50 };
+		for (int i = 0; i < loadBytes.size(); ++i) {
+			GetStorageMetricsReply metrics;
+			metrics.load.bytes = loadBytes[i];
+			collection->server_info[UID(i + 1, 0)]->setMetrics(metrics);
+		}
+		// the smallest server is correctly configured, so it still goes after every misconfigured one
+		wiggler->addServer(UID(1, 0), StorageMetadataType(startTime, KeyValueStoreType::SSD_BTREE_V2, true));
+		wiggler->addServer(UID(2, 0), StorageMetadataType(startTime + 1.0, KeyValueStoreType::SSD_BTREE_V2, true));
+		wiggler->addServer(UID(3, 0), StorageMetadataType(startTime + 2.0, KeyValueStoreType::SSD_BTREE_V2, true));
+		wiggler->addServer(UID(4, 0), StorageMetadataType(startTime + 3.0, KeyValueStoreType::SSD_BTREE_V2));
+
+		std::vector<UID> correctOrder{ UID(2, 0), UID(3, 0), UID(1, 0), UID(4, 0) };
+		for (int i = 0; i < correctOrder.size(); ++i) {
+			ASSERT(wiggler->getNextServerId() == correctOrder[i]);
+		}
+		ASSERT(!wiggler->getNextServerId().present());
+	}
+
 	ACTOR static Future<Void> GetTeam_CutOffByCpu() {
 		Reference<IReplicationPolicy> policy = makeReference<PolicyAcross>(1, "zoneid", makeReference<PolicyOne>());
 		state int processSize = 4;
@@ -7072,6 +7174,14 @@ TEST_CASE("/DataDistribution/StorageWiggler/NextIdWithTSS") {
 	return Void();
 }
 
+TEST_CASE("/DataDistribution/StorageWiggler/PreferSmallerServers") {
+	if (!SERVER_KNOBS->PERPETUAL_WIGGLE_PREFER_SMALLER_SERVERS) {
+		return Void();
+	}
+	DDTeamCollectionUnitTest::StorageWiggler_PreferSmallerServers();
+	return Void();
+}
+
 TEST_CASE("/DataDistribution/GetTeam/CutOffByCpu") {
 	wait(DDTeamCollectionUnitTest::GetTeam_CutOffByCpu());
 	return Void();
@@ -7083,4 +7193,22 @@ TEST_CASE("/DataDistribution/GetTeam/PreferWithinShardRange") {
 	}
 	wait(DDTeamCollectionUnitTest::GetTeam_PreferShardsWithinLimit());
 	return Void();
-}
\ No newline at end of file
+}
+TEST_CASE("/DataDistribution/LoadForecast") {
+	LoadForecast steady, rising;
+	ASSERT_EQ(steady.predict(), 0.0);
+	for (int i = 0; i < 20; i++) {
+		steady.update(100, 0.5, 0.2);
+		rising.update(100 + 10 * i, 0.5, 0.2);
+	}
+	ASSERT(std::abs(steady.predict() - 100) < 1e-6);
+	// A rising load is forecast to keep rising, so it is predicted above its latest sample
+	ASSERT_GT(rising.predict(), 100 + 10 * 19);
+
+	LoadForecast falling;
+	for (int i = 0; i < 20; i++) {
+		falling.update(std::max(0, 100 - 20 * i), 0.5, 0.2);
+	}
+	ASSERT_GE(falling.predict(), 0.0);
+	return Void();
+}
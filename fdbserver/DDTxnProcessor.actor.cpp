@@ -616,6 +616,29 @@ class DDTxnProcessorImpl {
 		}
 	}
 
+	ACTOR static Future<bool> changeCachedRange(Database cx, KeyRange keys, bool add) {
+		if (add) {
+			state Transaction tr(cx);
+			loop {
+				try {
+					tr.setOption(FDBTransactionOptions::READ_LOCK_AWARE);
+					tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+					tr.setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+
+					RangeResult cacheServers = wait(tr.getRange(storageCacheServerKeys, 1));
+					if (cacheServers.empty()) {
+						return false;
+					}
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+		wait(ManagementAPI::changeCachedRange(cx.getReference(), keys, add));
+		return true;
+	}
+
 	ACTOR static Future<Void> waitDDTeamInfoPrintSignal(Database cx) {
 		state ReadYourWritesTransaction tr(cx);
 		loop {
@@ -745,6 +768,10 @@ Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> DDTxnProcessor::getReadHo
 	return cx->getReadHotRanges(keys);
 }
 
+Future<bool> DDTxnProcessor::changeCachedRange(const KeyRange& keys, bool add) const {
+	return DDTxnProcessorImpl::changeCachedRange(cx, keys, add);
+}
+
 Future<HealthMetrics> DDTxnProcessor::getHealthMetrics(bool detailed) const {
 	return cx->getHealthMetrics(detailed);
 }
@@ -66,7 +66,8 @@ DataMoveType getDataMoveTypeFromDataMoveId(const UID& dataMoveId) {
 }
 
 void RelocateShard::setParentRange(KeyRange const& parent) {
-	ASSERT(reason == RelocateReason::WRITE_SPLIT || reason == RelocateReason::SIZE_SPLIT);
+	ASSERT(reason == RelocateReason::WRITE_SPLIT || reason == RelocateReason::SIZE_SPLIT ||
+	       reason == RelocateReason::READ_SPLIT);
 	parent_range = parent;
 }
 
@@ -235,14 +236,45 @@ bool StorageWiggler::necessary(const UID& serverId, const StorageMetadataType& m
 	return metadata.wrongConfigured || (now() - metadata.createdTime > SERVER_KNOBS->DD_STORAGE_WIGGLE_MIN_SS_AGE_SEC);
 }
 
+bool StorageWiggler::necessary(const UID& serverId) const {
+	return contains(serverId) && necessary(serverId, (*pq_handles.at(serverId)).first);
+}
+
+Optional<int64_t> StorageWiggler::estimatedWiggleBytes(const UID& serverId) const {
+	if (teamCollection == nullptr) {
+		return {};
+	}
+	auto it = teamCollection->server_info.find(serverId);
+	if (it == teamCollection->server_info.end() || !it->second->metricsPresent()) {
+		return {};
+	}
+	return it->second->loadBytes();
+}
+
 Optional<UID> StorageWiggler::getNextServerId(bool necessaryOnly) {
 	if (!wiggle_pq.empty()) {
 		auto [metadata, id] = wiggle_pq.top();
 		if (necessaryOnly && !necessary(id, metadata)) {
 			return {};
 		}
-		wiggle_pq.pop();
-		pq_handles.erase(id);
+		// Wiggling any misconfigured server migrates exactly one server, so drain the cheapest ones first to get the
+		// most servers onto the right configuration per byte moved
+		Optional<int64_t> bestBytes;
+		if (metadata.wrongConfigured && SERVER_KNOBS->PERPETUAL_WIGGLE_PREFER_SMALLER_SERVERS &&
+		    (bestBytes = estimatedWiggleBytes(id)).present()) {
+			for (auto it = wiggle_pq.begin(); it != wiggle_pq.end(); ++it) {
+				if (!it->first.wrongConfigured) {
+					continue;
+				}
+				Optional<int64_t> bytes = estimatedWiggleBytes(it->second);
+				if (bytes.present() && bytes.get() < bestBytes.get()) {
+					bestBytes = bytes;
+					id = it->second;
+				}
+			}
+			CODE_PROBE(id != wiggle_pq.top().second, "Perpetual wiggle picked a smaller misconfigured server first");
+		}
+		removeServer(id);
 		return Optional<UID>(id);
 	}
 	return Optional<UID>();
@@ -1448,6 +1480,7 @@ ACTOR Future<Void> dataDistribution(Reference<DataDistributor> self,
 			                       .getAverageShardBytes = getAverageShardBytes,
 			                       .teamSize = replicaSize,
 			                       .singleRegionTeamSize = self->configuration.storageTeamSize,
+			                       .storageServerStoreType = self->configuration.storageServerStoreType,
 			                       .relocationProducer = self->relocationProducer,
 			                       .relocationConsumer = self->relocationConsumer.getFuture(),
 			                       .getShardMetrics = getShardMetrics,
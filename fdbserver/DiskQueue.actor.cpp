@@ -70,6 +70,11 @@ struct StringBuffer {
 		str.contents() = StringRef(str.begin(), str.size() + bytes);
 		return p;
 	}
+	// Takes over data, which must be aligned as needed, instead of copying it
+	void assign(Standalone<StringRef> data) {
+		str = data;
+		reserved = data.size();
+	}
 	StringRef pop_front(int bytes) {
 		ASSERT(bytes <= str.size());
 		StringRef result = str.substr(0, bytes);
@@ -172,11 +177,14 @@ public:
 	    fileSizeWarningLimit(fileSizeWarningLimit), onError(delayed(error.getFuture())), onStopped(stopped.getFuture()),
 	    readyToPush(Void()), lastCommit(Void()), isFirstCommit(true), readingBuffer(dbgid), readingFile(-1),
 	    readingPage(-1), writingPos(-1), fileExtensionBytes(SERVER_KNOBS->DISK_QUEUE_FILE_EXTENSION_BYTES),
-	    fileShrinkBytes(SERVER_KNOBS->DISK_QUEUE_FILE_SHRINK_BYTES) {
+	    fileShrinkBytes(SERVER_KNOBS->DISK_QUEUE_FILE_SHRINK_BYTES),
+	    preallocatedBytes(pageCeiling(SERVER_KNOBS->DISK_QUEUE_PREALLOCATED_BYTES)) {
 		if (BUGGIFY)
 			fileExtensionBytes = _PAGE_SIZE * deterministicRandom()->randomSkewedUInt32(1, 10 << 10);
 		if (BUGGIFY)
 			fileShrinkBytes = _PAGE_SIZE * deterministicRandom()->randomSkewedUInt32(1, 10 << 10);
+		if (BUGGIFY)
+			preallocatedBytes = _PAGE_SIZE * deterministicRandom()->randomSkewedUInt32(1, 10 << 10);
 		files[0].dbgFilename = filename(0);
 		files[1].dbgFilename = filename(1);
 		// We issue reads into firstPages, so it needs to be 4k aligned.
@@ -286,10 +294,22 @@ public:
 	                 // files[readingFile]. readingFile = 2 if recovery is complete (all files have been read).
 	int64_t readingPage; // Page within readingFile that is the next page after readingBuffer
 
+	// Reads already started for the pages after readingBuffer, in file order, so that recovery keeps the disk busy
+	// while earlier pages are parsed. readAheadFile and readAheadPage are where the next one starts.
+	struct ReadAheadChunk {
+		int file;
+		int64_t endPage;
+		Future<Standalone<StringRef>> data;
+	};
+	std::deque<ReadAheadChunk> readAhead;
+	int readAheadFile = 0;
+	int64_t readAheadPage = 0;
+
 	int64_t writingPos; // Position within files[1] that will be next written
 
 	int64_t fileExtensionBytes;
 	int64_t fileShrinkBytes;
+	int64_t preallocatedBytes; // Files are never shrunk below this size, see DISK_QUEUE_PREALLOCATED_BYTES
 
 	Int64MetricHandle stallCount;
 
@@ -369,10 +389,20 @@ public:
 
 				const int64_t activeDataVolume = pageCeiling(self->files[0].size - self->files[0].popped +
 				                                             self->fileExtensionBytes + self->fileShrinkBytes);
-				const int64_t desiredMaxFileSize =
-				    pageCeiling(std::max(activeDataVolume, SERVER_KNOBS->TLOG_HARD_LIMIT_BYTES * 2));
-				const bool frivolouslyTruncate = BUGGIFY_WITH_PROB(0.1);
-				if (self->files[1].size > desiredMaxFileSize || frivolouslyTruncate) {
+				const int64_t desiredMaxFileSize = pageCeiling(std::max(
+				    { activeDataVolume, SERVER_KNOBS->TLOG_HARD_LIMIT_BYTES * 2, self->preallocatedBytes }));
+				const bool frivolouslyTruncate =
+				    BUGGIFY_WITH_PROB(0.1) && self->files[1].size > self->preallocatedBytes;
+				if (self->files[1].size < self->preallocatedBytes) {
+					// The first time this file becomes files[1], grow it to its preallocated size all at once
+					CODE_PROBE(true, "Preallocating DiskQueue file");
+					TraceEvent("DiskQueuePreallocate", self->dbgid)
+					    .detail("Filename", self->files[1].f->getFilename())
+					    .detail("OldFileSize", self->files[1].size)
+					    .detail("NewFileSize", self->preallocatedBytes);
+					self->files[1].size = self->preallocatedBytes;
+					waitfor.push_back(self->files[1].f->truncate(self->files[1].size));
+				} else if (self->files[1].size > desiredMaxFileSize || frivolouslyTruncate) {
 					// Either shrink self->files[1] to the size of self->files[0], or chop off fileShrinkBytes
 					int64_t maxShrink =
 					    pageFloor(std::max(self->files[1].size - desiredMaxFileSize, self->fileShrinkBytes));
@@ -385,13 +415,14 @@ public:
 						    .detail("ElidedTruncateSize", maxShrink);
 						Reference<IAsyncFile> newFile = wait(replaceFile(self->files[1].f));
 						self->files[1].setFile(newFile);
-						waitfor.push_back(self->files[1].f->truncate(self->fileExtensionBytes));
-						self->files[1].size = self->fileExtensionBytes;
+						self->files[1].size = std::max(self->fileExtensionBytes, self->preallocatedBytes);
+						waitfor.push_back(self->files[1].f->truncate(self->files[1].size));
 					} else {
 						CODE_PROBE(true, "Truncating DiskQueue file");
 						const int64_t startingSize = self->files[1].size;
 						self->files[1].size -= std::min(maxShrink, self->files[1].size);
-						self->files[1].size = std::max(self->files[1].size, self->fileExtensionBytes);
+						self->files[1].size =
+						    std::max({ self->files[1].size, self->fileExtensionBytes, self->preallocatedBytes });
 						TraceEvent("DiskQueueTruncate", self->dbgid)
 						    .detail("Filename", self->files[1].f->getFilename())
 						    .detail("OldFileSize", startingSize)
@@ -401,12 +432,13 @@ public:
 				}
 			} else {
 				// Extend self->files[1] to accomodate the new write and about 10MB or 2x current size for future
-				// writes.
+				// writes, or straight to its preallocated size if it is not there yet.
 				/*TraceEvent("RDQExtend", this->dbgid).detail("File1name", self->files[1].dbgFilename).detail("File1size", self->files[1].size)
 				    .detail("ExtensionBytes", fileExtensionBytes);*/
 				int64_t minExtension = pageData.size() + self->writingPos - self->files[1].size;
 				self->files[1].size += std::min(std::max(self->fileExtensionBytes, minExtension),
 				                                self->files[0].size + self->files[1].size + minExtension);
+				self->files[1].size = std::max(self->files[1].size, self->preallocatedBytes);
 				waitfor.push_back(self->files[1].f->truncate(self->files[1].size));
 
 				if (self->fileSizeWarningLimit > 0 && self->files[1].size > self->fileSizeWarningLimit) {
@@ -758,31 +790,69 @@ public:
 		return result;
 	}
 
-	Future<int> fillReadingBuffer() {
-		// If we're right at the end of a file...
-		if (readingPage * sizeof(Page) >= (size_t)files[readingFile].size) {
-			readingFile++;
-			readingPage = 0;
-			if (readingFile >= 2) {
-				// Recovery complete
-				readingBuffer.clear();
-				writingPos = files[1].size;
-				return 0;
+	// Like read(), but without assuming that recovery has found where files[1] ends
+	ACTOR static UNCANCELLABLE Future<Standalone<StringRef>> readAheadChunk(RawDiskQueue_TwoFiles* self,
+	                                                                        int file,
+	                                                                        int64_t pageOffset,
+	                                                                        int nPages) {
+		state TrackMe trackMe(self);
+		state const size_t bytesRequested = nPages * sizeof(Page);
+		state Standalone<StringRef> result = makeAlignedString(sizeof(Page), bytesRequested);
+		int bytesRead =
+		    wait(self->files[file].f->read(mutateString(result), bytesRequested, pageOffset * sizeof(Page)));
+		ASSERT(bytesRead == bytesRequested);
+		return result;
+	}
+
+	// Starts reading the pages after the last read-ahead chunk until DISK_QUEUE_RECOVERY_READ_AHEAD reads are in
+	// flight or both files have been requested
+	void issueReadAhead() {
+		if (readAhead.empty()) {
+			readAheadFile = readingFile;
+			readAheadPage = readingPage;
+		}
+		while (readAhead.size() < std::max(1, SERVER_KNOBS->DISK_QUEUE_RECOVERY_READ_AHEAD) && readAheadFile < 2) {
+			// If we're right at the end of a file...
+			if (readAheadPage * sizeof(Page) >= (size_t)files[readAheadFile].size) {
+				readAheadFile++;
+				readAheadPage = 0;
+				continue;
 			}
+
+			int64_t nPages = std::min<int64_t>(files[readAheadFile].size / sizeof(Page) - readAheadPage,
+			                                   BUGGIFY_WITH_PROB(1.0)
+			                                       ? deterministicRandom()->randomInt(1, 4)
+			                                       : SERVER_KNOBS->DISK_QUEUE_RECOVERY_READ_BYTES / sizeof(Page));
+			nPages = std::max<int64_t>(nPages, 1);
+			readAhead.push_back(ReadAheadChunk{
+			    readAheadFile, readAheadPage + nPages, readAheadChunk(this, readAheadFile, readAheadPage, nPages) });
+			readAheadPage += nPages;
 		}
+	}
 
-		// Read up to 1MB into readingBuffer
-		int len = std::min<int64_t>((files[readingFile].size / sizeof(Page) - readingPage) * sizeof(Page),
-		                            BUGGIFY_WITH_PROB(1.0) ? sizeof(Page) * deterministicRandom()->randomInt(1, 4)
-		                                                   : (1 << 20));
+	// Stops recovery reads. Chunks still being read keep their own memory, so they can just be dropped.
+	void clearReadAhead() {
+		readAhead.clear();
 		readingBuffer.clear();
-		readingBuffer.alignReserve(sizeof(Page), len);
-		void* p = readingBuffer.append(len);
+	}
+
+	ACTOR static Future<Void> fillReadingBuffer(RawDiskQueue_TwoFiles* self) {
+		self->issueReadAhead();
+		if (self->readAhead.empty()) {
+			// Recovery complete
+			self->readingFile = 2;
+			self->clearReadAhead();
+			self->writingPos = self->files[1].size;
+			return Void();
+		}
 
-		auto pos = readingPage * sizeof(Page);
-		readingPage += len / sizeof(Page);
-		ASSERT(int64_t(p) % sizeof(Page) == 0);
-		return files[readingFile].f->read(p, len, pos);
+		Standalone<StringRef> data = wait(self->readAhead.front().data);
+		self->readingBuffer.assign(data);
+		self->readingFile = self->readAhead.front().file;
+		self->readingPage = self->readAhead.front().endPage;
+		self->readAhead.pop_front();
+		self->issueReadAhead();
+		return Void();
 	}
 
 	ACTOR static UNCANCELLABLE Future<Standalone<StringRef>> readNextPage(RawDiskQueue_TwoFiles* self) {
@@ -796,8 +866,7 @@ public:
 				state Future<Void> f = Void();
 				// if (BUGGIFY) f = delay( deterministicRandom()->random01() * 0.1 );
 
-				int read = wait(self->fillReadingBuffer());
-				ASSERT(read == self->readingBuffer.size());
+				wait(fillReadingBuffer(self));
 
 				wait(f);
 			}
@@ -847,7 +916,7 @@ public:
 			CODE_PROBE(file == 1 && pos != self->files[1].size, "truncate before last read page on file 1");
 
 			self->readingFile = 2;
-			self->readingBuffer.clear();
+			self->clearReadAhead();
 			self->writingPos = pos;
 
 			while (file < 2) {
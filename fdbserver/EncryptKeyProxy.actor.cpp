@@ -216,6 +216,16 @@ using EncryptBaseCipherDomainIdKeyIdCache = std::unordered_map<EncryptBaseCipher
                                                                EncryptBaseCipherDomainIdKeyIdCacheKeyHash>;
 using BlobMetadataDomainIdCache = std::unordered_map<BlobMetadataDomainId, BlobMetadataCacheEntry>;
 
+// A KMS fetch of the latest cipher keys that is currently outstanding, shared by every lookup of its domains
+struct InflightCipherKeyFetch {
+	uint64_t fetchId;
+	Future<Void> fetched;
+
+	InflightCipherKeyFetch() : fetchId(0) {}
+	InflightCipherKeyFetch(uint64_t fetchId, Future<Void> fetched) : fetchId(fetchId), fetched(fetched) {}
+};
+using InflightCipherKeyFetchMap = std::unordered_map<EncryptCipherDomainId, InflightCipherKeyFetch>;
+
 struct EncryptKeyProxyData : NonCopyable, ReferenceCounted<EncryptKeyProxyData> {
 public:
 	UID myId;
@@ -229,6 +239,9 @@ public:
 	EncryptBaseCipherDomainIdKeyIdCache baseCipherDomainIdKeyIdCache;
 	BlobMetadataDomainIdCache blobMetadataDomainIdCache;
 
+	InflightCipherKeyFetchMap inflightDomainIdFetches;
+	uint64_t nextInflightFetchId = 0;
+
 	std::unique_ptr<KmsConnector> kmsConnector;
 
 	bool canConnectToKms = true;
@@ -241,6 +254,8 @@ public:
 	Counter baseCipherDomainIdCacheMisses;
 	Counter baseCipherDomainIdCacheHits;
 	Counter baseCipherKeysRefreshed;
+	Counter baseCipherKeysServedStale;
+	Counter baseCipherDomainIdFetchesCoalesced;
 	Counter numResponseWithErrors;
 	Counter numEncryptionKeyRefreshErrors;
 	Counter blobMetadataCacheHits;
@@ -261,6 +276,8 @@ public:
 	    baseCipherDomainIdCacheMisses("EKPCipherDomainIdCacheMisses", ekpCacheMetrics),
 	    baseCipherDomainIdCacheHits("EKPCipherDomainIdCacheHits", ekpCacheMetrics),
 	    baseCipherKeysRefreshed("EKPCipherKeysRefreshed", ekpCacheMetrics),
+	    baseCipherKeysServedStale("EKPCipherKeysServedStale", ekpCacheMetrics),
+	    baseCipherDomainIdFetchesCoalesced("EKPCipherDomainIdFetchesCoalesced", ekpCacheMetrics),
 	    numResponseWithErrors("EKPNumResponseWithErrors", ekpCacheMetrics),
 	    numEncryptionKeyRefreshErrors("EKPNumEncryptionKeyRefreshErrors", ekpCacheMetrics),
 	    blobMetadataCacheHits("EKPBlobMetadataCacheHits", ekpCacheMetrics),
@@ -290,6 +307,25 @@ public:
 		canConnectToKmsLastUpdatedTS = now();
 	}
 
+	// Records 'fetched' as the outstanding KMS fetch of the given domains, returns an id to unregister it with
+	uint64_t registerInflightFetch(const std::vector<EncryptCipherDomainId>& domainIds, Future<Void> fetched) {
+		const uint64_t fetchId = ++nextInflightFetchId;
+		for (const auto domainId : domainIds) {
+			inflightDomainIdFetches[domainId] = InflightCipherKeyFetch(fetchId, fetched);
+		}
+		return fetchId;
+	}
+
+	// Domains picked up by a newer fetch in the meantime are left alone
+	void unregisterInflightFetch(const std::vector<EncryptCipherDomainId>& domainIds, uint64_t fetchId) {
+		for (const auto domainId : domainIds) {
+			auto itr = inflightDomainIdFetches.find(domainId);
+			if (itr != inflightDomainIdFetches.end() && itr->second.fetchId == fetchId) {
+				inflightDomainIdFetches.erase(itr);
+			}
+		}
+	}
+
 	static EncryptBaseCipherDomainIdKeyIdCacheKey getBaseCipherDomainIdKeyIdCacheKey(
 	    const EncryptCipherDomainId domainId,
 	    const EncryptCipherBaseKeyId baseCipherId) {
@@ -529,12 +565,16 @@ std::unordered_set<EncryptCipherDomainId> getLookupDetailsLatest(
     Optional<TraceEvent>& dbgTrace,
     EKPGetLatestBaseCipherKeysReply& latestCipherReply,
     int& numHits,
-    std::unordered_set<EncryptCipherDomainId> dedupedDomainIds) {
+    std::unordered_set<EncryptCipherDomainId> dedupedDomainIds,
+    bool serveStale,
+    std::unordered_set<EncryptCipherDomainId>& staleCipherDomainIds) {
 	std::unordered_set<EncryptCipherDomainId> lookupCipherDomainIds;
 	for (const auto domainId : dedupedDomainIds) {
 		const auto itr = ekpProxyData->baseCipherDomainIdCache.find(domainId);
-		if (itr != ekpProxyData->baseCipherDomainIdCache.end() && !itr->second.needsRefresh() &&
-		    !itr->second.isExpired()) {
+		// A key past its refresh time is still valid until it expires, it can be handed out while the refresh happens
+		// in the background rather than holding up the request on a KMS round trip
+		if (itr != ekpProxyData->baseCipherDomainIdCache.end() && !itr->second.isExpired() &&
+		    (serveStale || !itr->second.needsRefresh())) {
 			latestCipherReply.baseCipherDetails.emplace_back(domainId,
 			                                                 itr->second.baseCipherId,
 			                                                 itr->second.baseCipherKey,
@@ -542,6 +582,9 @@ std::unordered_set<EncryptCipherDomainId> getLookupDetailsLatest(
 			                                                 itr->second.refreshAt,
 			                                                 itr->second.expireAt);
 			numHits++;
+			if (serveStale && itr->second.needsRefresh()) {
+				staleCipherDomainIds.emplace(domainId);
+			}
 
 			if (dbgTrace.present()) {
 				// {encryptDomainId, baseCipherId} forms a unique tuple across encryption domains
@@ -561,9 +604,84 @@ std::unordered_set<EncryptCipherDomainId> getLookupDetailsLatest(
 
 	ekpProxyData->baseCipherDomainIdCacheHits += numHits;
 	ekpProxyData->baseCipherDomainIdCacheMisses += lookupCipherDomainIds.size();
+	ekpProxyData->baseCipherKeysServedStale += staleCipherDomainIds.size();
 	return lookupCipherDomainIds;
 }
 
+// Fetches the latest cipher keys of 'domainIds' from KMS into the domainId cache. While outstanding, the fetch is
+// registered against each of its domains so that concurrent lookups of them wait on it instead of going to KMS again.
+ACTOR Future<Void> fetchLatestCipherKeys(Reference<EncryptKeyProxyData> ekpProxyData,
+                                         KmsConnectorInterface kmsConnectorInf,
+                                         std::vector<EncryptCipherDomainId> domainIds,
+                                         Optional<UID> debugId) {
+	state Promise<Void> fetched;
+	state uint64_t fetchId = ekpProxyData->registerInflightFetch(domainIds, fetched.getFuture());
+
+	try {
+		KmsConnLookupEKsByDomainIdsReq keysByDomainIdReq;
+		keysByDomainIdReq.encryptDomainIds = domainIds;
+		keysByDomainIdReq.debugId = debugId;
+
+		state double startTime = now();
+		KmsConnLookupEKsByDomainIdsRep keysByDomainIdRep =
+		    wait(kmsConnectorInf.ekLookupByDomainIds.getReply(keysByDomainIdReq));
+		ekpProxyData->kmsLookupByDomainIdsReqLatency.addMeasurement(now() - startTime);
+
+		for (auto& item : keysByDomainIdRep.cipherKeyDetails) {
+			if (std::find(domainIds.begin(), domainIds.end(), item.encryptDomainId) == domainIds.end()) {
+				TraceEvent(SevError, "GetLatestCipherKeysDomainIdNotFound", ekpProxyData->myId)
+				    .detail("DomainId", item.encryptDomainId);
+				throw encrypt_keys_fetch_failed();
+			}
+
+			// Record the fetched cipher details to the local cache for the future references
+			CipherKeyValidityTS validityTS = getCipherKeyValidityTS(item.refreshAfterSec, item.expireAfterSec);
+			ekpProxyData->insertIntoBaseDomainIdCache(item.encryptDomainId,
+			                                          item.encryptKeyId,
+			                                          item.encryptKey,
+			                                          item.encryptKCV,
+			                                          validityTS.refreshAtTS,
+			                                          validityTS.expAtTS);
+		}
+		if (keysByDomainIdRep.cipherKeyDetails.size() > 0) {
+			ekpProxyData->setKMSHealthiness(true);
+		}
+	} catch (Error& e) {
+		ekpProxyData->unregisterInflightFetch(domainIds, fetchId);
+		if (isKmsConnectionError(e)) {
+			ekpProxyData->setKMSHealthiness(false);
+		}
+		// Waiters see a broken_promise if the fetch is cancelled
+		if (e.code() != error_code_actor_cancelled) {
+			fetched.sendError(e);
+		}
+		throw;
+	}
+
+	ekpProxyData->unregisterInflightFetch(domainIds, fetchId);
+	fetched.send(Void());
+	return Void();
+}
+
+// Refreshes cipher keys that were served past their refresh time, errors are left to the periodic refresh to retry
+ACTOR Future<Void> refreshStaleCipherKeys(Reference<EncryptKeyProxyData> ekpProxyData,
+                                          KmsConnectorInterface kmsConnectorInf,
+                                          std::vector<EncryptCipherDomainId> domainIds) {
+	try {
+		wait(fetchLatestCipherKeys(ekpProxyData, kmsConnectorInf, domainIds, Optional<UID>()));
+		ekpProxyData->baseCipherKeysRefreshed += domainIds.size();
+		CODE_PROBE(true, "EKP refreshed stale cipherKeys in the background");
+	} catch (Error& e) {
+		if (!canReplyWith(e)) {
+			TraceEvent(SevWarn, "RefreshStaleEKsError", ekpProxyData->myId).error(e);
+			throw;
+		}
+		TraceEvent("RefreshStaleEKs", ekpProxyData->myId).detail("ErrorCode", e.code());
+		++ekpProxyData->numEncryptionKeyRefreshErrors;
+	}
+	return Void();
+}
+
 ACTOR Future<Void> getLatestCipherKeys(Reference<EncryptKeyProxyData> ekpProxyData,
                                        KmsConnectorInterface kmsConnectorInf,
                                        EKPGetLatestBaseCipherKeysRequest req) {
@@ -597,62 +715,37 @@ ACTOR Future<Void> getLatestCipherKeys(Reference<EncryptKeyProxyData> ekpProxyDa
 
 	// First, check if the requested information is already cached by the server.
 	// Ensure the cached information is within FLOW_KNOBS->ENCRYPT_CIPHER_KEY_CACHE_TTL time window.
+	state std::unordered_set<EncryptCipherDomainId> staleCipherDomainIds;
 	state std::unordered_set<EncryptCipherDomainId> lookupCipherDomainIds =
-	    getLookupDetailsLatest(ekpProxyData, dbgTrace, latestCipherReply, numHits, dedupedDomainIds);
+	    getLookupDetailsLatest(ekpProxyData,
+	                           dbgTrace,
+	                           latestCipherReply,
+	                           numHits,
+	                           dedupedDomainIds,
+	                           SERVER_KNOBS->ENCRYPT_PROXY_SERVE_STALE_CIPHER_KEYS,
+	                           staleCipherDomainIds);
 	if (!lookupCipherDomainIds.empty()) {
 		try {
-			KmsConnLookupEKsByDomainIdsReq keysByDomainIdReq;
+			// Domains already being fetched for another request share that fetch, only the rest go to KMS
+			std::vector<Future<Void>> fetches;
+			std::vector<EncryptCipherDomainId> fetchDomainIds;
 			for (const auto domainId : lookupCipherDomainIds) {
-				keysByDomainIdReq.encryptDomainIds.emplace_back(domainId);
-			}
-			keysByDomainIdReq.debugId = latestKeysReq.debugId;
-
-			state double startTime = now();
-			KmsConnLookupEKsByDomainIdsRep keysByDomainIdRep =
-			    wait(kmsConnectorInf.ekLookupByDomainIds.getReply(keysByDomainIdReq));
-			ekpProxyData->kmsLookupByDomainIdsReqLatency.addMeasurement(now() - startTime);
-
-			for (auto& item : keysByDomainIdRep.cipherKeyDetails) {
-				CipherKeyValidityTS validityTS = getCipherKeyValidityTS(item.refreshAfterSec, item.expireAfterSec);
-
-				latestCipherReply.baseCipherDetails.emplace_back(item.encryptDomainId,
-				                                                 item.encryptKeyId,
-				                                                 item.encryptKey,
-				                                                 item.encryptKCV,
-				                                                 validityTS.refreshAtTS,
-				                                                 validityTS.expAtTS);
-
-				// Record the fetched cipher details to the local cache for the future references
-				const auto itr = lookupCipherDomainIds.find(item.encryptDomainId);
-				if (itr == lookupCipherDomainIds.end()) {
-					TraceEvent(SevError, "GetLatestCipherKeysDomainIdNotFound", ekpProxyData->myId)
-					    .detail("DomainId", item.encryptDomainId);
-					throw encrypt_keys_fetch_failed();
-				}
-				ekpProxyData->insertIntoBaseDomainIdCache(item.encryptDomainId,
-				                                          item.encryptKeyId,
-				                                          item.encryptKey,
-				                                          item.encryptKCV,
-				                                          validityTS.refreshAtTS,
-				                                          validityTS.expAtTS);
-
-				if (dbgTrace.present()) {
-					// {encryptDomainId, baseCipherId} forms a unique tuple across encryption domains
-					dbgTrace.get().detail(getEncryptDbgTraceKeyWithTS(ENCRYPT_DBG_TRACE_INSERT_PREFIX,
-					                                                  item.encryptDomainId,
-					                                                  item.encryptKeyId,
-					                                                  validityTS.refreshAtTS,
-					                                                  validityTS.expAtTS),
-					                      "");
+				const auto itr = ekpProxyData->inflightDomainIdFetches.find(domainId);
+				if (SERVER_KNOBS->ENCRYPT_PROXY_COALESCE_KMS_FETCHES &&
+				    itr != ekpProxyData->inflightDomainIdFetches.end()) {
+					fetches.push_back(itr->second.fetched);
+				} else {
+					fetchDomainIds.push_back(domainId);
 				}
 			}
-			if (keysByDomainIdRep.cipherKeyDetails.size() > 0) {
-				ekpProxyData->setKMSHealthiness(true);
+			ekpProxyData->baseCipherDomainIdFetchesCoalesced += lookupCipherDomainIds.size() - fetchDomainIds.size();
+			CODE_PROBE(fetchDomainIds.size() < lookupCipherDomainIds.size(), "EKP coalesced cipherKey fetches");
+			if (!fetchDomainIds.empty()) {
+				fetches.push_back(
+				    fetchLatestCipherKeys(ekpProxyData, kmsConnectorInf, fetchDomainIds, latestKeysReq.debugId));
 			}
+			wait(waitForAll(fetches));
 		} catch (Error& e) {
-			if (isKmsConnectionError(e)) {
-				ekpProxyData->setKMSHealthiness(false);
-			}
 			if (!canReplyWith(e)) {
 				TraceEvent("GetLatestCipherKeys", ekpProxyData->myId).error(e);
 				throw;
@@ -661,6 +754,30 @@ ACTOR Future<Void> getLatestCipherKeys(Reference<EncryptKeyProxyData> ekpProxyDa
 			ekpProxyData->sendErrorResponse(latestKeysReq.reply, e);
 			return Void();
 		}
+
+		// Every fetch has landed in the cache by now; domains KMS did not return a key for are left out of the reply
+		for (const auto domainId : lookupCipherDomainIds) {
+			const auto itr = ekpProxyData->baseCipherDomainIdCache.find(domainId);
+			if (itr == ekpProxyData->baseCipherDomainIdCache.end() || itr->second.isExpired()) {
+				continue;
+			}
+			latestCipherReply.baseCipherDetails.emplace_back(domainId,
+			                                                 itr->second.baseCipherId,
+			                                                 itr->second.baseCipherKey,
+			                                                 itr->second.baseCipherKCV,
+			                                                 itr->second.refreshAt,
+			                                                 itr->second.expireAt);
+
+			if (dbgTrace.present()) {
+				// {encryptDomainId, baseCipherId} forms a unique tuple across encryption domains
+				dbgTrace.get().detail(getEncryptDbgTraceKeyWithTS(ENCRYPT_DBG_TRACE_INSERT_PREFIX,
+				                                                  domainId,
+				                                                  itr->second.baseCipherId,
+				                                                  itr->second.refreshAt,
+				                                                  itr->second.expireAt),
+				                      "");
+			}
+		}
 	}
 
 	latestCipherReply.numHits = numHits;
@@ -668,6 +785,16 @@ ACTOR Future<Void> getLatestCipherKeys(Reference<EncryptKeyProxyData> ekpProxyDa
 
 	CODE_PROBE(!lookupCipherDomainIds.empty(), "EKP fetch latest cipherKeys from KMS");
 
+	std::vector<EncryptCipherDomainId> refreshDomainIds;
+	for (const auto domainId : staleCipherDomainIds) {
+		if (!ekpProxyData->inflightDomainIdFetches.count(domainId)) {
+			refreshDomainIds.push_back(domainId);
+		}
+	}
+	if (!refreshDomainIds.empty()) {
+		ekpProxyData->addActor.send(refreshStaleCipherKeys(ekpProxyData, kmsConnectorInf, refreshDomainIds));
+	}
+
 	return Void();
 }
 
@@ -784,25 +911,29 @@ ACTOR Future<Void> refreshEncryptionKeysImpl(Reference<EncryptKeyProxyData> ekpP
 	t.detail("KmsConnInf", kmsConnectorInf.id());
 	t.detail("DebugId", debugId);
 
+	state KmsConnLookupEKsByDomainIdsReq req;
+	state Promise<Void> refreshed;
+	state uint64_t fetchId = 0;
 	try {
-		KmsConnLookupEKsByDomainIdsReq req;
 		req.debugId = debugId;
 		// req.encryptDomainInfos.reserve(req.arena, ekpProxyData->baseCipherDomainIdCache.size());
 
 		int64_t currTS = (int64_t)now();
 		for (auto itr = ekpProxyData->baseCipherDomainIdCache.begin();
 		     itr != ekpProxyData->baseCipherDomainIdCache.end();) {
-			if (isCipherKeyEligibleForRefresh(itr->second, currTS)) {
-				TraceEvent("RefreshEKs").detail("Id", itr->first);
-				req.encryptDomainIds.push_back(itr->first);
-			}
-
 			// Garbage collect expired cached CipherKeys
 			if (itr->second.isExpired()) {
 				itr = ekpProxyData->baseCipherDomainIdCache.erase(itr);
-			} else {
-				itr++;
+				continue;
 			}
+
+			// Domains already being fetched on behalf of a lookup are refreshed by that fetch
+			if (isCipherKeyEligibleForRefresh(itr->second, currTS) &&
+			    !ekpProxyData->inflightDomainIdFetches.count(itr->first)) {
+				TraceEvent("RefreshEKs").detail("Id", itr->first);
+				req.encryptDomainIds.push_back(itr->first);
+			}
+			itr++;
 		}
 
 		if (req.encryptDomainIds.empty()) {
@@ -811,6 +942,9 @@ ACTOR Future<Void> refreshEncryptionKeysImpl(Reference<EncryptKeyProxyData> ekpP
 			return Void();
 		}
 
+		// Lookups of the refreshed domains that miss the cache meanwhile wait for this refresh
+		fetchId = ekpProxyData->registerInflightFetch(req.encryptDomainIds, refreshed.getFuture());
+
 		state double startTime = now();
 		KmsConnLookupEKsByDomainIdsRep rep = wait(kmsConnectorInf.ekLookupByDomainIds.getReply(req));
 		ekpProxyData->kmsLookupByDomainIdsReqLatency.addMeasurement(now() - startTime);
@@ -845,7 +979,13 @@ ACTOR Future<Void> refreshEncryptionKeysImpl(Reference<EncryptKeyProxyData> ekpP
 		}
 		t.detail("NumKeys", rep.cipherKeyDetails.size());
 		CODE_PROBE(!rep.cipherKeyDetails.empty(), "EKP refresh cipherKeys");
+		ekpProxyData->unregisterInflightFetch(req.encryptDomainIds, fetchId);
+		refreshed.send(Void());
 	} catch (Error& e) {
+		ekpProxyData->unregisterInflightFetch(req.encryptDomainIds, fetchId);
+		if (e.code() != error_code_actor_cancelled) {
+			refreshed.sendError(e);
+		}
 		if (isKmsConnectionError(e)) {
 			ekpProxyData->setKMSHealthiness(false);
 		}
@@ -1134,9 +1274,11 @@ void testLookupLatestCipherDetails() {
 	ekpProxyData->baseCipherDomainIdCache[3] =
 	    EncryptBaseCipherKey(3, 3, "dom3"_sr, 0, startTime + 300, startTime - 10);
 
-	std::unordered_set<EncryptCipherDomainId> lookupCipherDomainIds =
-	    getLookupDetailsLatest(ekpProxyData, dbgTrace, latestCipherReply, numHits, dedupedDomainIds);
+	std::unordered_set<EncryptCipherDomainId> staleCipherDomainIds;
+	std::unordered_set<EncryptCipherDomainId> lookupCipherDomainIds = getLookupDetailsLatest(
+	    ekpProxyData, dbgTrace, latestCipherReply, numHits, dedupedDomainIds, false, staleCipherDomainIds);
 	std::unordered_set<EncryptCipherDomainId> expectedLookupCipherDomainIds = { 2, 3, 4 };
+	ASSERT(staleCipherDomainIds.empty());
 
 	ASSERT_EQ(numHits, 1);
 	if (lookupCipherDomainIds != expectedLookupCipherDomainIds) {
@@ -1150,6 +1292,59 @@ void testLookupLatestCipherDetails() {
 	ASSERT_EQ(ekpProxyData->baseCipherDomainIdCacheMisses.getValue(), 3);
 }
 
+void testLookupLatestCipherDetailsServeStale() {
+	Reference<EncryptKeyProxyData> ekpProxyData =
+	    makeReference<EncryptKeyProxyData>(deterministicRandom()->randomUniqueID());
+	Optional<TraceEvent> dbgTrace;
+	int numHits = 0;
+	EKPGetLatestBaseCipherKeysReply latestCipherReply;
+	std::unordered_set<EncryptCipherDomainId> dedupedDomainIds = { 1, 2, 3, 4 };
+	double startTime = now();
+	ekpProxyData->baseCipherDomainIdCache[1] =
+	    EncryptBaseCipherKey(1, 1, "dom1"_sr, 0, startTime + 300, startTime + 300);
+	// key needs refresh, but is served until it expires
+	ekpProxyData->baseCipherDomainIdCache[2] =
+	    EncryptBaseCipherKey(2, 2, "dom2"_sr, 0, startTime - 10, startTime + 300);
+	// key is expired
+	ekpProxyData->baseCipherDomainIdCache[3] =
+	    EncryptBaseCipherKey(3, 3, "dom3"_sr, 0, startTime - 20, startTime - 10);
+
+	std::unordered_set<EncryptCipherDomainId> staleCipherDomainIds;
+	std::unordered_set<EncryptCipherDomainId> lookupCipherDomainIds = getLookupDetailsLatest(
+	    ekpProxyData, dbgTrace, latestCipherReply, numHits, dedupedDomainIds, true, staleCipherDomainIds);
+	std::unordered_set<EncryptCipherDomainId> expectedLookupCipherDomainIds = { 3, 4 };
+	std::unordered_set<EncryptCipherDomainId> expectedStaleCipherDomainIds = { 2 };
+
+	ASSERT_EQ(numHits, 2);
+	ASSERT(lookupCipherDomainIds == expectedLookupCipherDomainIds);
+	ASSERT(staleCipherDomainIds == expectedStaleCipherDomainIds);
+	ASSERT_EQ(latestCipherReply.baseCipherDetails.size(), 2);
+	ASSERT_EQ(ekpProxyData->baseCipherKeysServedStale.getValue(), 1);
+	ASSERT_EQ(ekpProxyData->baseCipherDomainIdCacheMisses.getValue(), 2);
+}
+
+void testInflightFetchRegistration() {
+	Reference<EncryptKeyProxyData> ekpProxyData =
+	    makeReference<EncryptKeyProxyData>(deterministicRandom()->randomUniqueID());
+	Promise<Void> first;
+	Promise<Void> second;
+	std::vector<EncryptCipherDomainId> firstDomainIds = { 1, 2 };
+	std::vector<EncryptCipherDomainId> secondDomainIds = { 2, 3 };
+
+	uint64_t firstId = ekpProxyData->registerInflightFetch(firstDomainIds, first.getFuture());
+	uint64_t secondId = ekpProxyData->registerInflightFetch(secondDomainIds, second.getFuture());
+	ASSERT_NE(firstId, secondId);
+	ASSERT_EQ(ekpProxyData->inflightDomainIdFetches.size(), 3);
+
+	// Domain 2 now belongs to the second fetch, finishing the first one must not drop it
+	ekpProxyData->unregisterInflightFetch(firstDomainIds, firstId);
+	ASSERT_EQ(ekpProxyData->inflightDomainIdFetches.size(), 2);
+	ASSERT_EQ(ekpProxyData->inflightDomainIdFetches[2].fetchId, secondId);
+
+	ekpProxyData->unregisterInflightFetch(secondDomainIds, secondId);
+	ASSERT(ekpProxyData->inflightDomainIdFetches.empty());
+}
+
 void testLookupCipherDetails() {
 	Reference<EncryptKeyProxyData> ekpProxyData =
 	    makeReference<EncryptKeyProxyData>(deterministicRandom()->randomUniqueID());
@@ -1196,6 +1391,8 @@ void testLookupCipherDetails() {
 
 TEST_CASE("/EncryptKeyProxy") {
 	testLookupLatestCipherDetails();
+	testLookupLatestCipherDetailsServeStale();
 	testLookupCipherDetails();
+	testInflightFetchRegistration();
 	return Void();
 }
@@ -43,7 +43,7 @@
 struct GrvProxyStats {
 	CounterCollection cc;
 	Counter txnRequestIn, txnRequestOut, txnRequestErrors;
-	Counter txnStartIn, txnStartOut, txnStartBatch;
+	Counter txnStartIn, txnStartOut, txnStartBatch, txnStartLeased;
 	Counter txnSystemPriorityStartIn, txnSystemPriorityStartOut;
 	Counter txnBatchPriorityStartIn, txnBatchPriorityStartOut;
 	Counter txnDefaultPriorityStartIn, txnDefaultPriorityStartOut;
@@ -124,6 +124,7 @@ struct GrvProxyStats {
 
 	    txnRequestIn("TxnRequestIn", cc), txnRequestOut("TxnRequestOut", cc), txnRequestErrors("TxnRequestErrors", cc),
 	    txnStartIn("TxnStartIn", cc), txnStartOut("TxnStartOut", cc), txnStartBatch("TxnStartBatch", cc),
+	    txnStartLeased("TxnStartLeased", cc),
 	    txnSystemPriorityStartIn("TxnSystemPriorityStartIn", cc),
 	    txnSystemPriorityStartOut("TxnSystemPriorityStartOut", cc),
 	    txnBatchPriorityStartIn("TxnBatchPriorityStartIn", cc),
@@ -211,6 +212,23 @@ struct GrvProxyData {
 	// Cache of the latest commit versions of storage servers.
 	VersionVector ssVersionVectorCache;
 
+	// The latest reply from getLiveCommittedVersion(), and when the request for it was sent. Its version is at least
+	// every version reported committed by then, so for GRV_LEASE_DURATION afterwards it may be handed out again to
+	// causal-read-risky transactions without another round trip to the master and tlogs.
+	Optional<GetReadVersionReply> leasedReply;
+	double leaseStart;
+	// When the rates last sent by ratekeeper expire
+	double ratekeeperLeaseExpiry;
+
+	// The lease is only used while ratekeeper is controlling this proxy's rate and the epoch is known to have been
+	// live recently enough that it can't have been recovered, the same condition causal-read-risky GRVs wait for.
+	bool canUseReadVersionLease() const {
+		return SERVER_KNOBS->GRV_LEASE_DURATION > 0 && leasedReply.present() &&
+		       now() - leaseStart <= SERVER_KNOBS->GRV_LEASE_DURATION && now() < ratekeeperLeaseExpiry &&
+		       (SERVER_KNOBS->REQUIRED_MIN_RECOVERY_DURATION <= 0 ||
+		        now() - SERVER_KNOBS->REQUIRED_MIN_RECOVERY_DURATION <= lastCommitTime.get());
+	}
+
 	void updateLatencyBandConfig(Optional<LatencyBandConfig> newLatencyBandConfig) {
 		if (newLatencyBandConfig.present() != latencyBandConfig.present() ||
 		    (newLatencyBandConfig.present() &&
@@ -236,7 +254,7 @@ struct GrvProxyData {
 	    cx(openDBOnServer(db, TaskPriority::DefaultEndpoint, LockAware::True)), db(db), lastStartCommit(0),
 	    lastCommitLatency(SERVER_KNOBS->REQUIRED_MIN_RECOVERY_DURATION), updateCommitRequests(0), lastCommitTime(0),
 	    version(0), minKnownCommittedVersion(invalidVersion),
-	    tagThrottler(CLIENT_KNOBS->PROXY_MAX_TAG_THROTTLE_DURATION) {
+	    tagThrottler(CLIENT_KNOBS->PROXY_MAX_TAG_THROTTLE_DURATION), leaseStart(0), ratekeeperLeaseExpiry(0) {
 		if (SERVER_KNOBS->ENABLE_VERSION_VECTOR) {
 			versionVectorSizeOnGRVReply =
 			    std::make_unique<LatencySample>("VersionVectorSizeOnGRVReply",
@@ -443,6 +461,7 @@ ACTOR Future<Void> getRate(UID myID,
 			//TraceEvent("GrvProxyRate", myID).detail("Rate", rep.transactionRate).detail("BatchRate", rep.batchTransactionRate).detail("Lease", rep.leaseDuration).detail("ReleasedTransactions", *inTransactionCount - lastTC);
 			// lastTC = *inTransactionCount;
 			leaseTimeout = delay(rep.leaseDuration);
+			proxyData->ratekeeperLeaseExpiry = now() + rep.leaseDuration;
 			nextRequestTimer = delayJittered(rep.leaseDuration / 2);
 			healthMetricsReply->update(rep.healthMetrics, expectingDetailedReply, true);
 			if (expectingDetailedReply) {
@@ -639,6 +658,28 @@ ACTOR Future<Void> lastCommitUpdater(GrvProxyData* self, PromiseStream<Future<Vo
 	}
 }
 
+// Fills in the parts of a reply that don't depend on where its read version came from, and counts the transactions
+// it starts.
+void finishReadVersionReply(GrvProxyData* grvProxyData,
+                            GetReadVersionReply& rep,
+                            int transactionCount,
+                            int systemTransactionCount,
+                            int defaultPriTransactionCount,
+                            int batchPriTransactionCount) {
+	rep.processBusyTime =
+	    FLOW_KNOBS->BASIC_LOAD_BALANCE_COMPUTE_PRECISION *
+	    std::min((std::numeric_limits<int>::max() / FLOW_KNOBS->BASIC_LOAD_BALANCE_COMPUTE_PRECISION) - 1,
+	             grvProxyData->stats.getRecentRequests());
+	rep.processBusyTime += FLOW_KNOBS->BASIC_LOAD_BALANCE_COMPUTE_PRECISION *
+	                       (g_network->isSimulated() ? deterministicRandom()->random01()
+	                                                 : g_network->networkInfo.metrics.lastRunLoopBusyness);
+
+	grvProxyData->stats.txnStartOut += transactionCount;
+	grvProxyData->stats.txnSystemPriorityStartOut += systemTransactionCount;
+	grvProxyData->stats.txnDefaultPriorityStartOut += defaultPriTransactionCount;
+	grvProxyData->stats.txnBatchPriorityStartOut += batchPriTransactionCount;
+}
+
 ACTOR Future<GetReadVersionReply> getLiveCommittedVersion(std::vector<SpanContext> spanContexts,
                                                           GrvProxyData* grvProxyData,
                                                           uint32_t flags,
@@ -692,23 +733,24 @@ ACTOR Future<GetReadVersionReply> getLiveCommittedVersion(std::vector<SpanContex
 	rep.version = repFromMaster.version;
 	rep.locked = repFromMaster.locked;
 	rep.metadataVersion = repFromMaster.metadataVersion;
-	rep.processBusyTime =
-	    FLOW_KNOBS->BASIC_LOAD_BALANCE_COMPUTE_PRECISION *
-	    std::min((std::numeric_limits<int>::max() / FLOW_KNOBS->BASIC_LOAD_BALANCE_COMPUTE_PRECISION) - 1,
-	             grvProxyData->stats.getRecentRequests());
-	rep.processBusyTime += FLOW_KNOBS->BASIC_LOAD_BALANCE_COMPUTE_PRECISION *
-	                       (g_network->isSimulated() ? deterministicRandom()->random01()
-	                                                 : g_network->networkInfo.metrics.lastRunLoopBusyness);
+
+	// A higher version covers everything an older lease did, so the lease can only move forward
+	if (!grvProxyData->leasedReply.present() || rep.version >= grvProxyData->leasedReply.get().version) {
+		grvProxyData->leasedReply = rep;
+		grvProxyData->leaseStart = std::max(grvProxyData->leaseStart, grvStart);
+	}
 
 	if (debugID.present()) {
 		g_traceBatch.addEvent(
 		    "TransactionDebug", debugID.get().first(), "GrvProxyServer.getLiveCommittedVersion.After");
 	}
 
-	grvProxyData->stats.txnStartOut += transactionCount;
-	grvProxyData->stats.txnSystemPriorityStartOut += systemTransactionCount;
-	grvProxyData->stats.txnDefaultPriorityStartOut += defaultPriTransactionCount;
-	grvProxyData->stats.txnBatchPriorityStartOut += batchPriTransactionCount;
+	finishReadVersionReply(grvProxyData,
+	                       rep,
+	                       transactionCount,
+	                       systemTransactionCount,
+	                       defaultPriTransactionCount,
+	                       batchPriTransactionCount);
 
 	return rep;
 }
@@ -1062,14 +1104,34 @@ ACTOR static Future<Void> transactionStarter(GrvProxyInterface proxy,
 					spanContexts.push_back(request.spanContext);
 				}
 
-				Future<GetReadVersionReply> readVersionReply = getLiveCommittedVersion(spanContexts,
-				                                                                       grvProxyData,
-				                                                                       i,
-				                                                                       debugID,
-				                                                                       transactionsStarted[i],
-				                                                                       systemTransactionsStarted[i],
-				                                                                       defaultPriTransactionsStarted[i],
-				                                                                       batchPriTransactionsStarted[i]);
+				Future<GetReadVersionReply> readVersionReply;
+				if ((i == 1 || SERVER_KNOBS->ALWAYS_CAUSAL_READ_RISKY) && grvProxyData->canUseReadVersionLease()) {
+					// Leased versions are handed out only after the rate limiting above, so ratekeeper's limits
+					// apply to them as to any other
+					GetReadVersionReply rep = grvProxyData->leasedReply.get();
+					finishReadVersionReply(grvProxyData,
+					                       rep,
+					                       transactionsStarted[i],
+					                       systemTransactionsStarted[i],
+					                       defaultPriTransactionsStarted[i],
+					                       batchPriTransactionsStarted[i]);
+					grvProxyData->stats.txnStartLeased += transactionsStarted[i];
+					if (debugID.present()) {
+						g_traceBatch.addEvent("TransactionDebug",
+						                      debugID.get().first(),
+						                      "GrvProxyServer.transactionStarter.ReadVersionLease");
+					}
+					readVersionReply = rep;
+				} else {
+					readVersionReply = getLiveCommittedVersion(spanContexts,
+					                                           grvProxyData,
+					                                           i,
+					                                           debugID,
+					                                           transactionsStarted[i],
+					                                           systemTransactionsStarted[i],
+					                                           defaultPriTransactionsStarted[i],
+					                                           batchPriTransactionsStarted[i]);
+				}
 				addActor.send(sendGrvReplies(readVersionReply,
 				                             start[i],
 				                             grvProxyData,
@@ -0,0 +1,129 @@
+/*
+ * HotKeyTracker.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/HotKeyTracker.h"
+#include "fdbserver/Knobs.h"
+#include "flow/UnitTest.h"
+
+void SpaceSavingSketch::add(KeyRef begin, KeyRef end, int64_t weight) {
+	if (capacity <= 0) {
+		return;
+	}
+	total += weight;
+	auto it = counts.find(std::make_pair(begin, end));
+	if (it != counts.end()) {
+		byCount.erase(std::make_pair(it->second.first, it->first));
+		it->second.first += weight;
+		byCount.emplace(it->second.first, it->first);
+		return;
+	}
+	int64_t error = 0;
+	if (counts.size() >= static_cast<size_t>(capacity)) {
+		auto least = byCount.begin();
+		error = least->first;
+		counts.erase(least->second);
+		byCount.erase(least);
+	}
+	Range range(begin, end);
+	counts.emplace(range, std::make_pair(error + weight, error));
+	byCount.emplace(error + weight, range);
+}
+
+std::vector<SpaceSavingSketch::Item> SpaceSavingSketch::top(int n) const {
+	std::vector<Item> items;
+	for (auto it = byCount.rbegin(); it != byCount.rend() && items.size() < n; ++it) {
+		auto const& [count, error] = counts.find(it->second)->second;
+		items.push_back(Item{ it->second.first, it->second.second, count, error });
+	}
+	return items;
+}
+
+void SpaceSavingSketch::clear() {
+	total = 0;
+	counts.clear();
+	byCount.clear();
+}
+
+HotKeyTracker::HotKeyTracker()
+  : enabled(SERVER_KNOBS->HOT_KEY_TRACKER_CAPACITY > 0), windowStart(now()),
+    reads{ SpaceSavingSketch(SERVER_KNOBS->HOT_KEY_TRACKER_CAPACITY),
+	       SpaceSavingSketch(SERVER_KNOBS->HOT_KEY_TRACKER_CAPACITY) },
+    writes{ SpaceSavingSketch(SERVER_KNOBS->HOT_KEY_TRACKER_CAPACITY),
+	        SpaceSavingSketch(SERVER_KNOBS->HOT_KEY_TRACKER_CAPACITY) } {}
+
+void HotKeyTracker::rotate() {
+	double elapsed = now() - windowStart;
+	if (elapsed < SERVER_KNOBS->HOT_KEY_TRACKER_WINDOW) {
+		return;
+	}
+	std::swap(reads[0], reads[1]);
+	std::swap(writes[0], writes[1]);
+	reads[0].clear();
+	writes[0].clear();
+	lastWindowLength = elapsed;
+	windowStart = now();
+}
+
+void HotKeyTracker::add(bool write, KeyRef begin, KeyRef end) {
+	if (!enabled) {
+		return;
+	}
+	rotate();
+	(write ? writes : reads)[0].add(begin, end);
+}
+
+std::vector<SpaceSavingSketch::Item> HotKeyTracker::top(bool write, int n, double* elapsed) {
+	rotate();
+	SpaceSavingSketch* sketches = write ? writes : reads;
+	if (lastWindowLength > 0) {
+		*elapsed = lastWindowLength;
+		return sketches[1].top(n);
+	}
+	*elapsed = now() - windowStart;
+	return sketches[0].top(n);
+}
+
+TEST_CASE("/fdbserver/HotKeyTracker/SpaceSaving") {
+	SpaceSavingSketch sketch(8);
+	int64_t hot = 0;
+	for (int i = 0; i < 10000; i++) {
+		if (deterministicRandom()->random01() < 0.3) {
+			sketch.add("hot"_sr, KeyRef());
+			hot++;
+		} else if (deterministicRandom()->random01() < 0.3) {
+			sketch.add("a"_sr, "b"_sr);
+		} else {
+			sketch.add(StringRef(format("cold%d", deterministicRandom()->randomInt(0, 1000))), KeyRef());
+		}
+	}
+	ASSERT_EQ(sketch.getTotal(), 10000);
+	ASSERT_EQ(sketch.size(), 8);
+
+	std::vector<SpaceSavingSketch::Item> top = sketch.top(2);
+	ASSERT_EQ(top.size(), 2);
+	ASSERT(top[0].begin == "hot"_sr && top[0].end.empty());
+	ASSERT(top[0].count >= hot && top[0].count - top[0].error <= hot);
+	ASSERT(top[1].begin == "a"_sr && top[1].end == "b"_sr);
+
+	sketch.clear();
+	ASSERT_EQ(sketch.size(), 0);
+	ASSERT(sketch.top(2).empty());
+	return Void();
+}
@@ -0,0 +1,337 @@
+/*
+ * KVStoreBench.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbrpc/DDSketch.h"
+#include "fdbserver/IKeyValueStore.h"
+#include "fdbserver/ServerDBInfo.actor.h"
+#include "flow/IRandom.h"
+#include "flow/Platform.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace {
+
+// Drives a storage engine directly on a real disk: loads a dataset, then runs clients issuing a mix of point reads,
+// range reads and writes for a while, and reports throughput, latencies, write amplification and memory. Writes are
+// buffered and applied by a single committer, as the storage server does with its versioned data, so that the engine
+// never sees a write while it is committing.
+struct KVStoreBench {
+	KeyValueStoreType storeType;
+	std::string directory;
+	int64_t keyCount;
+	int keySize;
+	int valueSize;
+	bool load;
+	bool keep;
+	double seconds;
+	int clients;
+	double readFraction;
+	double scanFraction;
+	int scanLength;
+	int commitSize;
+	double commitInterval;
+	int64_t memoryLimit;
+	int64_t pageCacheBytes;
+
+	IKeyValueStore* store = nullptr;
+	Standalone<StringRef> valueSource;
+	bool running = false;
+
+	Standalone<VectorRef<KeyValueRef>> pendingWrites;
+	Promise<Void> pendingCommitted;
+	AsyncTrigger commitSizeReached;
+
+	int64_t reads = 0, scans = 0, rowsScanned = 0, writes = 0, commits = 0;
+	int64_t logicalBytesWritten = 0;
+	DDSketch<double> readLatency, scanLatency, writeLatency, commitLatency;
+	uint64_t peakResidentMemory = 0;
+
+	KVStoreBench(std::string const& folder, UnitTestParameters const& params)
+	  : storeType(KeyValueStoreType::fromString(params.get("storeType").orDefault("ssd-redwood-1"))),
+	    directory(joinPath(folder, "kvstorebench")), keyCount(params.getInt("keyCount").orDefault(1e6)),
+	    keySize(params.getInt("keySize").orDefault(32)), valueSize(params.getInt("valueSize").orDefault(100)),
+	    load(params.getInt("load").orDefault(1)), keep(params.getInt("keep").orDefault(0)),
+	    seconds(params.getDouble("seconds").orDefault(60)), clients(params.getInt("clients").orDefault(64)),
+	    readFraction(params.getDouble("readFraction").orDefault(0.8)),
+	    scanFraction(params.getDouble("scanFraction").orDefault(0.1)),
+	    scanLength(params.getInt("scanLength").orDefault(100)),
+	    commitSize(params.getInt("commitSize").orDefault(1000)),
+	    commitInterval(params.getDouble("commitInterval").orDefault(0.1)),
+	    memoryLimit(params.getInt("memoryLimit").orDefault(2e9)),
+	    pageCacheBytes(params.getInt("pageCacheBytes").orDefault(0)) {
+		valueSource = makeString(std::max(valueSize * 2, 1 << 20));
+		deterministicRandom()->randomBytes(mutateString(valueSource), valueSource.size());
+	}
+
+	std::string filename() const { return joinPath(directory, "store"); }
+
+	// Keys are zero padded so that they sort by index, and share a prefix like the keys of one application do
+	Key keyFor(int64_t i) const {
+		std::string key = format("kvstorebench/%012lld", (long long)i);
+		if (key.size() < keySize) {
+			key.resize(keySize, '.');
+		}
+		return Key(key);
+	}
+
+	int64_t randomIndex() const { return deterministicRandom()->randomInt64(0, keyCount); }
+
+	ValueRef randomValue() const {
+		return valueSource.substr(deterministicRandom()->randomInt(0, valueSource.size() - valueSize), valueSize);
+	}
+
+	// Bytes written to the device holding the store so far, or 0 where that is not known
+	uint64_t deviceBytesWritten() const {
+		uint64_t currentIOs = 0, readMilliSecs = 0, writeMilliSecs = 0, IOMilliSecs = 0, readCount = 0,
+		         writeCount = 0, writeSectors = 0;
+		getDiskStatistics(
+		    directory, currentIOs, readMilliSecs, writeMilliSecs, IOMilliSecs, readCount, writeCount, writeSectors);
+		return writeSectors * 512;
+	}
+
+	ACTOR static Future<Void> sampleMemory(KVStoreBench* self) {
+		loop {
+			self->peakResidentMemory = std::max(self->peakResidentMemory, getResidentMemoryUsage());
+			wait(delay(1.0));
+		}
+	}
+
+	ACTOR static Future<Void> loadData(KVStoreBench* self) {
+		state double start = timer();
+		state uint64_t deviceStart = self->deviceBytesWritten();
+		state int64_t i = 0;
+		state int64_t bytes = 0;
+		while (i < self->keyCount) {
+			for (int n = 0; n < self->commitSize && i < self->keyCount; n++, i++) {
+				Key key = self->keyFor(i);
+				KeyValueRef kv(key, self->randomValue());
+				self->store->set(kv);
+				bytes += kv.expectedSize();
+			}
+			wait(self->store->commit());
+		}
+		const double elapsed = timer() - start;
+		printf("Loaded %lld keys in %.1f seconds: %.0f keys/s, %.1f MB/s\n",
+		       (long long)self->keyCount,
+		       elapsed,
+		       self->keyCount / elapsed,
+		       bytes / elapsed / 1e6);
+		self->printWriteAmplification("Load", bytes, self->deviceBytesWritten() - deviceStart);
+		return Void();
+	}
+
+	// Waits for the writes queued so far to be committed then passes on the next ones, until the run is over and
+	// every client has stopped
+	ACTOR static Future<Void> committer(KVStoreBench* self) {
+		loop {
+			wait(self->commitSizeReached.onTrigger() || delay(self->commitInterval));
+			if (self->pendingWrites.empty()) {
+				continue;
+			}
+			state Standalone<VectorRef<KeyValueRef>> writes = std::move(self->pendingWrites);
+			state Promise<Void> committed = std::move(self->pendingCommitted);
+			self->pendingWrites = Standalone<VectorRef<KeyValueRef>>();
+			self->pendingCommitted = Promise<Void>();
+			for (const auto& kv : writes) {
+				self->store->set(kv);
+			}
+			state double start = timer();
+			wait(self->store->commit());
+			self->commitLatency.addSample(timer() - start);
+			self->commits++;
+			committed.send(Void());
+		}
+	}
+
+	ACTOR static Future<Void> client(KVStoreBench* self) {
+		state double r;
+		state double start;
+		state int64_t index;
+		state Key key;
+		state Key end;
+		while (self->running) {
+			r = deterministicRandom()->random01();
+			index = self->randomIndex();
+			key = self->keyFor(index);
+			start = timer();
+			if (r < self->readFraction) {
+				Optional<Value> value = wait(self->store->readValue(key));
+				self->readLatency.addSample(timer() - start);
+				self->reads++;
+			} else if (r < self->readFraction + self->scanFraction) {
+				end = self->keyFor(index + self->scanLength);
+				RangeResult result = wait(self->store->readRange(KeyRangeRef(key, end), self->scanLength));
+				self->scanLatency.addSample(timer() - start);
+				self->scans++;
+				self->rowsScanned += result.size();
+			} else {
+				KeyValueRef kv(key, self->randomValue());
+				self->pendingWrites.push_back_deep(self->pendingWrites.arena(), kv);
+				self->logicalBytesWritten += kv.expectedSize();
+				if (self->pendingWrites.size() >= self->commitSize) {
+					self->commitSizeReached.trigger();
+				}
+				wait(self->pendingCommitted.getFuture());
+				self->writeLatency.addSample(timer() - start);
+				self->writes++;
+			}
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> run(KVStoreBench* self) {
+		state std::vector<Future<Void>> clients;
+		state Future<Void> committing = committer(self);
+		state uint64_t deviceStart = self->deviceBytesWritten();
+		state double start = timer();
+		self->running = true;
+		for (int i = 0; i < self->clients; i++) {
+			clients.push_back(client(self));
+		}
+		wait(delay(self->seconds));
+		self->running = false;
+		wait(waitForAll(clients));
+		const double elapsed = timer() - start;
+		const uint64_t deviceWritten = self->deviceBytesWritten() - deviceStart;
+
+		printf("Ran %d clients for %.1f seconds\n", self->clients, elapsed);
+		self->printLatency("Read", self->reads, elapsed, self->readLatency);
+		self->printLatency("Scan", self->scans, elapsed, self->scanLatency);
+		self->printLatency("Write", self->writes, elapsed, self->writeLatency);
+		self->printLatency("Commit", self->commits, elapsed, self->commitLatency);
+		if (self->scans > 0) {
+			printf("Scanned %.0f rows/s\n", self->rowsScanned / elapsed);
+		}
+		self->printWriteAmplification("Run", self->logicalBytesWritten, deviceWritten);
+		return Void();
+	}
+
+	void printLatency(const char* op, int64_t count, double elapsed, DDSketch<double>& latency) {
+		if (count == 0) {
+			return;
+		}
+		printf("%-6s %10.0f ops/s  latency ms: mean %.3f  p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f\n",
+		       op,
+		       count / elapsed,
+		       latency.mean() * 1e3,
+		       latency.percentile(0.5) * 1e3,
+		       latency.percentile(0.9) * 1e3,
+		       latency.percentile(0.99) * 1e3,
+		       latency.percentile(0.999) * 1e3,
+		       latency.max() * 1e3);
+		TraceEvent("KVStoreBenchLatency")
+		    .detail("Op", op)
+		    .detail("Count", count)
+		    .detail("OpsPerSecond", count / elapsed)
+		    .detail("Mean", latency.mean())
+		    .detail("P50", latency.percentile(0.5))
+		    .detail("P90", latency.percentile(0.9))
+		    .detail("P99", latency.percentile(0.99))
+		    .detail("P999", latency.percentile(0.999))
+		    .detail("Max", latency.max());
+	}
+
+	// The device counters include every other writer to the same device, so this is only meaningful on a disk the
+	// benchmark has to itself
+	void printWriteAmplification(const char* phase, int64_t logicalBytes, uint64_t deviceBytes) {
+		if (deviceBytes == 0 || logicalBytes == 0) {
+			printf("%s write amplification: unknown\n", phase);
+			return;
+		}
+		printf("%s write amplification: %.2f (%.1f MB written to the device for %.1f MB of keys and values)\n",
+		       phase,
+		       (double)deviceBytes / logicalBytes,
+		       deviceBytes / 1e6,
+		       logicalBytes / 1e6);
+		TraceEvent("KVStoreBenchWriteAmplification")
+		    .detail("Phase", phase)
+		    .detail("LogicalBytes", logicalBytes)
+		    .detail("DeviceBytes", deviceBytes)
+		    .detail("WriteAmplification", (double)deviceBytes / logicalBytes);
+	}
+
+	void printStorage() {
+		StorageBytes sb = store->getStorageBytes();
+		const int64_t dataset = keyCount * (keySize + valueSize);
+		printf("Storage used %.1f MB for %.1f MB of keys and values, resident memory peaked at %.1f MB\n",
+		       sb.used / 1e6,
+		       dataset / 1e6,
+		       peakResidentMemory / 1e6);
+		TraceEvent("KVStoreBenchStorage")
+		    .detail("UsedBytes", sb.used)
+		    .detail("DatasetBytes", dataset)
+		    .detail("PeakResidentMemory", peakResidentMemory);
+	}
+};
+
+} // namespace
+
+ACTOR Future<Void> kvStoreBench(std::string folder, UnitTestParameters params) {
+	state KVStoreBench self(folder, params);
+	if (self.readFraction < 0 || self.scanFraction < 0 || self.readFraction + self.scanFraction > 1) {
+		fprintf(stderr, "ERROR: readFraction and scanFraction must be non-negative and add up to at most 1\n");
+		throw invalid_option_value();
+	}
+	if (self.keyCount <= 0 || self.clients <= 0 || self.commitSize <= 0) {
+		fprintf(stderr, "ERROR: keyCount, clients and commitSize must be positive\n");
+		throw invalid_option_value();
+	}
+
+	printf("Benchmarking %s in %s with %lld keys of %d bytes and values of %d bytes\n",
+	       self.storeType.toString().c_str(),
+	       self.directory.c_str(),
+	       (long long)self.keyCount,
+	       self.keySize,
+	       self.valueSize);
+	if (self.load) {
+		platform::eraseDirectoryRecursive(self.directory);
+	}
+	platform::createDirectory(self.directory);
+
+	state Future<Void> memorySampler = KVStoreBench::sampleMemory(&self);
+	self.store = openKVStore(self.storeType,
+	                         self.filename(),
+	                         deterministicRandom()->randomUniqueID(),
+	                         self.memoryLimit,
+	                         false,
+	                         false,
+	                         false,
+	                         {},
+	                         {},
+	                         self.pageCacheBytes);
+	wait(self.store->init());
+	if (self.load) {
+		wait(KVStoreBench::loadData(&self));
+	}
+	if (self.seconds > 0) {
+		wait(KVStoreBench::run(&self));
+	}
+	self.peakResidentMemory = std::max(self.peakResidentMemory, getResidentMemoryUsage());
+	self.printStorage();
+
+	state Future<Void> closed = self.store->onClosed();
+	if (self.keep) {
+		self.store->close();
+	} else {
+		self.store->dispose();
+	}
+	wait(closed);
+	return Void();
+}
@@ -33,6 +33,7 @@
 #include "flow/ActorCollection.h"
 #include "flow/EncryptUtils.h"
 #include "flow/Knobs.h"
+#include "flow/WorkerPool.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 #define OP_DISK_OVERHEAD (sizeof(OpHeader) + 1)
@@ -461,6 +462,91 @@ private:
 		return total;
 	}
 
+	// With KVS_MEMORY_PARALLEL_RECOVERY, recovery commits each transaction of at least KVS_MEMORY_RECOVERY_CHUNK_SETS
+	// sets with commitRecoveredQueue() instead of commit_queue(). The copies of the sets' keys and values, which are
+	// most of the work, are made on the worker pool a chunk at a time. The container is a single tree, so the network
+	// thread then inserts them itself, in runs as in a sequential commit.
+	typedef std::vector<std::pair<KeyValueMapPair, uint64_t>> DataSets;
+
+	bool recoversInParallel(OpQueue& ops) {
+		// Only IKeyValueContainer can insert a run of sets at once
+		if (!std::is_same_v<Container, IKeyValueContainer> || !SERVER_KNOBS->KVS_MEMORY_PARALLEL_RECOVERY) {
+			return false;
+		}
+		int sets = 0;
+		for (auto o = ops.begin(); o != ops.end(); ++o) {
+			sets += o->op == OpSet;
+		}
+		return sets >= SERVER_KNOBS->KVS_MEMORY_RECOVERY_CHUNK_SETS;
+	}
+
+	ACTOR static Future<Void> commitRecoveredQueue(KeyValueStoreMemory* self, OpQueue* ops) {
+		state std::vector<Future<DataSets>> chunks;
+		std::vector<KeyValueRef> chunk;
+		uint64_t elementBytes = self->data.getElementBytes();
+		// The keys and values stay in ops' arenas, which nothing changes, until every chunk has been copied
+		for (auto o = ops->begin(); o != ops->end(); ++o) {
+			if (o->op == OpSet) {
+				chunk.emplace_back(o->p1, o->p2);
+			}
+			if (chunk.size() == SERVER_KNOBS->KVS_MEMORY_RECOVERY_CHUNK_SETS || (o + 1 == ops->end() && chunk.size())) {
+				chunks.push_back(onWorkerPool([chunk = std::move(chunk), elementBytes]() {
+					DataSets pairs;
+					pairs.reserve(chunk.size());
+					for (auto const& kv : chunk) {
+						KeyValueMapPair pair(kv.key, kv.value);
+						pairs.emplace_back(pair, pair.arena.getSize() + elementBytes);
+					}
+					return pairs;
+				}));
+				chunk = std::vector<KeyValueRef>();
+			}
+		}
+		wait(waitForAll(chunks));
+		self->commitRecoveredSets(*ops, chunks);
+		return Void();
+	}
+
+	void commitRecoveredSets(OpQueue& ops, std::vector<Future<DataSets>> const& chunks) {
+		auto chunk = chunks.begin();
+		size_t next = 0;
+		KeyRef setsFirst, setsLast; // The least and greatest keys in dataSets
+		for (auto o = ops.begin(); o != ops.end(); ++o) {
+			if (o->op == OpSet) {
+				if (next == chunk->get().size()) {
+					++chunk;
+					next = 0;
+				}
+				dataSets.push_back(chunk->get()[next++]);
+				KeyRef key = dataSets.back().first.key;
+				if (dataSets.size() == 1 || key < setsFirst) {
+					setsFirst = key;
+				}
+				if (dataSets.size() == 1 || key > setsLast) {
+					setsLast = key;
+				}
+				continue;
+			}
+			// A clear has to follow the sets before it, unless it misses all of them, as does the clear recovered with
+			// each snapshot item, which begins after the keys of the items before it
+			bool missesSets = o->p1 > setsLast || (o->op == OpClear && o->p2 <= setsFirst);
+			if (!dataSets.empty() && !missesSets) {
+				data.insert(dataSets);
+				dataSets.clear();
+			}
+			if (o->op == OpClear) {
+				data.erase(data.lower_bound(o->p1), data.lower_bound(o->p2));
+			} else if (o->op == OpClearToEnd) {
+				data.erase(data.lower_bound(o->p1), data.end());
+			} else
+				ASSERT(false);
+		}
+		ASSERT(chunk == chunks.end() || (chunk + 1 == chunks.end() && next == chunk->get().size()));
+		data.insert(dataSets);
+		dataSets.clear();
+		ops.clear();
+	}
+
 	static bool isOpEncrypted(OpHeader* header) { return header->op >> ENCRYPTION_ENABLED_BIT == 1; }
 
 	static void setEncryptFlag(OpHeader* header, bool set) {
@@ -728,7 +814,11 @@ private:
 						} else if (h.op == OpClearToEnd) { // clear all data from begin key to end
 							recoveryQueue.clear_to_end(p1, &data.arena());
 						} else if (h.op == OpCommit) { // commit previous transaction
-							self->commit_queue(recoveryQueue, false);
+							if (self->recoversInParallel(recoveryQueue)) {
+								wait(commitRecoveredQueue(self, &recoveryQueue));
+							} else {
+								self->commit_queue(recoveryQueue, false);
+							}
 							++dbgCommitCount;
 							self->recoveredSnapshotKey = uncommittedNextKey;
 							self->previousSnapshotEnd = uncommittedPrevSnapshotEnd;
@@ -837,12 +927,19 @@ private:
 		currentSnapshotEnd = log_op(OpSnapshotEnd, StringRef(), StringRef());
 	}
 
+	// The committed bytes it takes to pay for writing bytes of snapshot
+	static uint64_t snapshotCost(uint64_t bytes, double writeRatio) {
+		return std::max<uint64_t>(1, bytes / writeRatio);
+	}
+
 	ACTOR static Future<Void> snapshot(KeyValueStoreMemory* self) {
 		wait(self->recovering);
 
 		state Key nextKey = self->recoveredSnapshotKey;
 		state bool nextKeyAfter = false; // setting this to true is equilvent to setting nextKey = keyAfter(nextKey)
+		// The committed bytes that paid for the snapshot written so far, at KVS_MEMORY_SNAPSHOT_WRITE_RATIO
 		state uint64_t snapshotTotalWrittenBytes = 0;
+		state double writeRatio = SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_WRITE_RATIO;
 		state int lastDiff = 0;
 		state int snapItems = 0;
 		state uint64_t snapshotBytes = 0;
@@ -909,7 +1006,7 @@ private:
 
 					snapItems = 0;
 					snapshotBytes = 0;
-					snapshotTotalWrittenBytes += OP_DISK_OVERHEAD;
+					snapshotTotalWrittenBytes += snapshotCost(OP_DISK_OVERHEAD, writeRatio);
 
 					// If we're not stopping now, reset next
 					if (snapshotTotalWrittenBytes < self->notifiedCommittedWriteBytes.get()) {
@@ -975,7 +1072,7 @@ private:
 					snapItems++;
 					uint64_t opBytes = opKeySize + next.getValue().size() + OP_DISK_OVERHEAD;
 					snapshotBytes += opBytes;
-					snapshotTotalWrittenBytes += opBytes;
+					snapshotTotalWrittenBytes += snapshotCost(opBytes, writeRatio);
 					lastSnapshotKeyUsingA = !lastSnapshotKeyUsingA;
 
 					// If we're not stopping now, increment next
@@ -105,6 +105,7 @@ public:
 	rocksdb::ColumnFamilyOptions getCfOptions() const { return this->cfOptions; }
 	rocksdb::Options getOptions() const { return rocksdb::Options(this->dbOptions, this->cfOptions); }
 	rocksdb::ReadOptions getReadOptions() { return this->readOptions; }
+	std::shared_ptr<rocksdb::Cache> getBlockCache() const { return this->blockCache; }
 
 private:
 	const UID id;
@@ -113,6 +114,8 @@ private:
 	rocksdb::ReadOptions initialReadOptions();
 
 	bool closing;
+	// Set by initialCfOptions(), so it must be initialized before cfOptions
+	std::shared_ptr<rocksdb::Cache> blockCache;
 	rocksdb::DBOptions dbOptions;
 	rocksdb::ColumnFamilyOptions cfOptions;
 	rocksdb::ReadOptions readOptions;
@@ -204,11 +207,11 @@ rocksdb::ColumnFamilyOptions SharedRocksDBState::initialCfOptions() {
 	}
 
 	if (SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE > 0) {
-		bbOpts.block_cache =
-		    rocksdb::NewLRUCache(SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE,
-		                         -1, /* num_shard_bits, default value:-1*/
-		                         false, /* strict_capacity_limit, default value:false */
-		                         SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO /* high_pri_pool_ratio */);
+		blockCache = rocksdb::NewLRUCache(SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE,
+		                                  -1, /* num_shard_bits, default value:-1*/
+		                                  false, /* strict_capacity_limit, default value:false */
+		                                  SERVER_KNOBS->ROCKSDB_CACHE_HIGH_PRI_POOL_RATIO /* high_pri_pool_ratio */);
+		bbOpts.block_cache = blockCache;
 		bbOpts.cache_index_and_filter_blocks = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
 		bbOpts.pin_l0_filter_and_index_blocks_in_cache = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
 		bbOpts.cache_index_and_filter_blocks_with_high_priority = SERVER_KNOBS->ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS;
@@ -288,6 +291,7 @@ rocksdb::ReadOptions SharedRocksDBState::initialReadOptions() {
 	rocksdb::ReadOptions options;
 	options.background_purge_on_iterator_cleanup = true;
 	options.auto_prefix_mode = (SERVER_KNOBS->ROCKSDB_PREFIX_LEN > 0);
+	options.async_io = SERVER_KNOBS->ROCKSDB_READ_ASYNC_IO;
 	return options;
 }
 
@@ -1400,10 +1404,15 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			}
 
 			rocksdb::WriteOptions options;
-			options.sync = !SERVER_KNOBS->ROCKSDB_UNSAFE_AUTO_FSYNC;
+			options.disableWAL = SERVER_KNOBS->ROCKSDB_DISABLE_WAL;
+			options.sync = !SERVER_KNOBS->ROCKSDB_UNSAFE_AUTO_FSYNC && !options.disableWAL;
 
 			double writeBeginTime = timer_monotonic();
 			rocksdb::Status s = db->Write(options, a.batchToCommit.get());
+			if (s.ok() && options.disableWAL) {
+				// Without the WAL the batch is only durable once the memtable holding it is flushed
+				s = db->Flush(rocksdb::FlushOptions(), cf);
+			}
 			readIterPool->update();
 			double currTime = timer_monotonic();
 			if (a.getHistograms) {
@@ -1714,6 +1723,87 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			}
 		}
 
+		struct ReadValuesAction : TypedAction<Reader, ReadValuesAction> {
+			Standalone<VectorRef<KeyRef>> keys;
+			std::vector<int> maxLengths;
+			ReadType type;
+			double startTime;
+			bool getHistograms;
+			ThreadReturnPromise<std::vector<Optional<Value>>> result;
+			ReadValuesAction(VectorRef<KeyRef> keys, std::vector<int> maxLengths, ReadType type)
+			  : maxLengths(std::move(maxLengths)), type(type), startTime(timer_monotonic()),
+			    getHistograms(deterministicRandom()->random01() < SERVER_KNOBS->ROCKSDB_HISTOGRAMS_SAMPLE_RATE) {
+				// The keys are read on another thread, so they can't refer to the caller's memory
+				this->keys.append_deep(this->keys.arena(), keys.begin(), keys.size());
+			}
+			double getTimeEstimate() const override { return SERVER_KNOBS->READ_VALUE_TIME_ESTIMATE * keys.size(); }
+		};
+		void action(ReadValuesAction& a) {
+			ASSERT(cf != nullptr);
+			const double readBeginTime = timer_monotonic();
+			if (a.getHistograms) {
+				metricPromiseStream->send(
+				    std::make_pair(ROCKSDB_READVALUE_QUEUEWAIT_HISTOGRAM.toString(), readBeginTime - a.startTime));
+			}
+			bool throttled = !a.keys.empty() && shouldThrottle(a.type, a.keys.front());
+			if (throttled && SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT && readBeginTime - a.startTime > readValueTimeout) {
+				TraceEvent(SevWarn, "KVSTimeout", id)
+				    .detail("Error", "Read values request timedout")
+				    .detail("Method", "ReadValuesAction")
+				    .detail("TimeoutValue", readValueTimeout);
+				a.result.sendError(transaction_too_old());
+				return;
+			}
+
+			rocksdb::ReadOptions readOptions = sharedState->getReadOptions();
+			if (throttled && SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT) {
+				uint64_t deadlineMircos =
+				    db->GetEnv()->NowMicros() + (readValueTimeout - (readBeginTime - a.startTime)) * 1000000;
+				std::chrono::seconds deadlineSeconds(deadlineMircos / 1000000);
+				readOptions.deadline = std::chrono::duration_cast<std::chrono::microseconds>(deadlineSeconds);
+			}
+
+			// One MultiGet shares the memtable and SST lookups (and batches block reads) across the keys
+			std::vector<rocksdb::Slice> keys;
+			keys.reserve(a.keys.size());
+			for (const auto& key : a.keys) {
+				keys.push_back(toSlice(key));
+			}
+			std::vector<rocksdb::PinnableSlice> values(keys.size());
+			std::vector<rocksdb::Status> statuses(keys.size());
+			double dbGetBeginTime = a.getHistograms ? timer_monotonic() : 0;
+			db->MultiGet(readOptions, cf, keys.size(), keys.data(), values.data(), statuses.data());
+			if (a.getHistograms) {
+				metricPromiseStream->send(
+				    std::make_pair(ROCKSDB_READVALUE_GET_HISTOGRAM.toString(), timer_monotonic() - dbGetBeginTime));
+			}
+
+			std::vector<Optional<Value>> result;
+			result.reserve(keys.size());
+			for (int i = 0; i < keys.size(); i++) {
+				if (statuses[i].ok()) {
+					size_t length = a.maxLengths.empty() ? values[i].size()
+					                                     : std::min(values[i].size(), size_t(a.maxLengths[i]));
+					result.push_back(Value(StringRef(reinterpret_cast<const uint8_t*>(values[i].data()), length)));
+				} else if (statuses[i].IsNotFound()) {
+					result.push_back(Optional<Value>());
+				} else {
+					logRocksDBError(id, statuses[i], "ReadValues");
+					a.result.sendError(statusToError(statuses[i]));
+					return;
+				}
+			}
+			a.result.send(std::move(result));
+
+			const double endTime = timer_monotonic();
+			if (a.getHistograms) {
+				metricPromiseStream->send(
+				    std::make_pair(ROCKSDB_READVALUE_ACTION_HISTOGRAM.toString(), endTime - readBeginTime));
+				metricPromiseStream->send(
+				    std::make_pair(ROCKSDB_READVALUE_LATENCY_HISTOGRAM.toString(), endTime - a.startTime));
+			}
+		}
+
 		struct ReadRangeAction : TypedAction<Reader, ReadRangeAction>, FastAllocated<ReadRangeAction> {
 			KeyRange keys;
 			int rowLimit, byteLimit;
@@ -2225,6 +2315,10 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 			debugID = options.get().debugID;
 		}
 
+		if (SERVER_KNOBS->ROCKSDB_READ_VALUE_BATCH_SIZE > 1 && !debugID.present()) {
+			return readValueInBatch(key, type);
+		}
+
 		if (!shouldThrottle(type, key)) {
 			auto a = new Reader::ReadValueAction(key, type, debugID);
 			auto res = a->result.getFuture();
@@ -2240,6 +2334,62 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		return read(a.release(), &semaphore, readThreads.getPtr(), &counters.failedToAcquire);
 	}
 
+	// Queues a point read to be read with any others of its kind started before this task ends, in one
+	// ReadValuesAction
+	Future<Optional<Value>> readValueInBatch(KeyRef key, ReadType type) {
+		std::pair<ReadType, bool> kind(type, shouldThrottle(type, key));
+		ReadBatch& batch = readBatches[kind];
+		if (batch.keys.empty()) {
+			batch.sender = sendReadBatchSoon(this, kind);
+		}
+		batch.keys.push_back_deep(batch.keys.arena(), key);
+		batch.results.emplace_back();
+		Future<Optional<Value>> result = batch.results.back().getFuture();
+		if (batch.keys.size() >= SERVER_KNOBS->ROCKSDB_READ_VALUE_BATCH_SIZE) {
+			sendReadBatch(kind);
+		}
+		return result;
+	}
+
+	ACTOR static Future<Void> sendReadBatchSoon(RocksDBKeyValueStore* self, std::pair<ReadType, bool> kind) {
+		wait(delay(0));
+		self->sendReadBatch(kind);
+		return Void();
+	}
+
+	void sendReadBatch(std::pair<ReadType, bool> kind) {
+		ReadBatch& batch = readBatches[kind];
+		if (batch.keys.empty()) {
+			return;
+		}
+		Standalone<VectorRef<KeyRef>> keys = batch.keys;
+		std::vector<Promise<Optional<Value>>> results = std::move(batch.results);
+		batch.keys = Standalone<VectorRef<KeyRef>>();
+		batch.results.clear();
+
+		Future<std::vector<Optional<Value>>> values;
+		try {
+			values = readValues(keys, {}, ReadOptions(kind.first));
+		} catch (Error& e) {
+			values = e;
+		}
+		deliverReadBatch(values, std::move(results));
+	}
+
+	ACTOR static void deliverReadBatch(Future<std::vector<Optional<Value>>> values,
+	                                   std::vector<Promise<Optional<Value>>> results) {
+		try {
+			std::vector<Optional<Value>> v = wait(values);
+			for (int i = 0; i < results.size(); i++) {
+				results[i].send(v[i]);
+			}
+		} catch (Error& e) {
+			for (auto& result : results) {
+				result.sendError(e);
+			}
+		}
+	}
+
 	Future<Optional<Value>> readValuePrefix(KeyRef key, int maxLength, Optional<ReadOptions> options) override {
 		ReadType type = ReadType::NORMAL;
 		Optional<UID> debugID;
@@ -2264,6 +2414,46 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		return read(a.release(), &semaphore, readThreads.getPtr(), &counters.failedToAcquire);
 	}
 
+	ACTOR static Future<std::vector<Optional<Value>>> read(Reader::ReadValuesAction* action,
+	                                                       FlowLock* semaphore,
+	                                                       IThreadPool* pool,
+	                                                       Counter* counter) {
+		state std::unique_ptr<Reader::ReadValuesAction> a(action);
+		state Optional<Void> slot = wait(timeout(semaphore->take(), SERVER_KNOBS->ROCKSDB_READ_QUEUE_WAIT));
+		if (!slot.present()) {
+			++(*counter);
+			throw server_overloaded();
+		}
+
+		state FlowLock::Releaser release(*semaphore);
+
+		auto fut = a->result.getFuture();
+		pool->post(a.release());
+		std::vector<Optional<Value>> result = wait(fut);
+
+		return result;
+	}
+
+	Future<std::vector<Optional<Value>>> readValues(Standalone<VectorRef<KeyRef>> keys,
+	                                                std::vector<int> maxLengths,
+	                                                Optional<ReadOptions> options) override {
+		ReadType type = options.present() ? options.get().type : ReadType::NORMAL;
+
+		if (keys.empty() || !shouldThrottle(type, keys.front())) {
+			auto a = new Reader::ReadValuesAction(keys, std::move(maxLengths), type);
+			auto res = a->result.getFuture();
+			readThreads->post(a);
+			return res;
+		}
+
+		auto& semaphore = (type == ReadType::FETCH) ? fetchSemaphore : readSemaphore;
+		int maxWaiters = (type == ReadType::FETCH) ? numFetchWaiters : numReadWaiters;
+
+		checkWaiters(semaphore, maxWaiters);
+		auto a = std::make_unique<Reader::ReadValuesAction>(keys, std::move(maxLengths), type);
+		return read(a.release(), &semaphore, readThreads.getPtr(), &counters.failedToAcquire);
+	}
+
 	ACTOR static Future<Standalone<RangeResultRef>> read(Reader::ReadRangeAction* action,
 	                                                     FlowLock* semaphore,
 	                                                     IThreadPool* pool,
@@ -2320,6 +2510,18 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 		return StorageBytes(free, total, live, free);
 	}
 
+	int64_t getConfiguredCacheSize() const override {
+		return sharedState->getBlockCache() ? SERVER_KNOBS->ROCKSDB_BLOCK_CACHE_SIZE : 0;
+	}
+
+	// RocksDB resizes its caches safely while they are in use by the reader threads
+	void setCacheSizeLimit(int64_t bytes) override {
+		auto blockCache = sharedState->getBlockCache();
+		if (blockCache) {
+			blockCache->SetCapacity(bytes);
+		}
+	}
+
 	Future<CheckpointMetaData> checkpoint(const CheckpointRequest& request) override {
 		auto a = new Writer::CheckpointAction(request);
 
@@ -2391,6 +2593,13 @@ struct RocksDBKeyValueStore : IKeyValueStore {
 	int numReadWaiters;
 	FlowLock fetchSemaphore;
 	int numFetchWaiters;
+	// Point reads waiting for readValueInBatch() to send them, by type and by whether they are throttled
+	struct ReadBatch {
+		Standalone<VectorRef<KeyRef>> keys;
+		std::vector<Promise<Optional<Value>>> results;
+		Future<Void> sender;
+	};
+	std::map<std::pair<ReadType, bool>, ReadBatch> readBatches;
 	std::shared_ptr<ReadIteratorPool> readIterPool;
 	std::vector<std::unique_ptr<ThreadReturnPromiseStream<std::pair<std::string, double>>>> metricPromiseStreams;
 	// ThreadReturnPromiseStream pair.first stores the histogram name and
@@ -745,6 +745,9 @@ struct RawCursor {
 	KeyInfo keyInfo;
 	bool valid;
 	int64_t kvBytesRead = 0;
+	// A forward getRange() leaves the cursor on the first row at or after this key, so a read which carries on from
+	// there, as the next page of a scan does, needn't seek again. Not present once the cursor has been moved.
+	Optional<Key> positionedAt;
 
 	operator bool() const { return valid; }
 
@@ -1203,9 +1206,11 @@ struct RawCursor {
 
 		if (db.fragment_values) {
 			if (rowLimit > 0) {
-				int r = moveTo(keys.begin);
-				if (r < 0)
-					moveNext();
+				if (!continuesFrom(keys.begin)) {
+					int r = moveTo(keys.begin);
+					if (r < 0)
+						moveNext();
+				}
 
 				DefragmentingReader i(*this, result.arena(), true);
 				Optional<KeyRef> nextKey = i.peek();
@@ -1216,6 +1221,8 @@ struct RawCursor {
 					accumulatedBytes += sizeof(KeyValueRef) + kv.get().expectedSize();
 					nextKey = i.peek();
 				}
+				// peek() has moved the cursor past the fragments of the last pair returned
+				setPositionedAfter(result, keys.begin);
 			} else {
 				int r = moveTo(keys.end);
 				if (r >= 0)
@@ -1233,9 +1240,11 @@ struct RawCursor {
 			}
 		} else {
 			if (rowLimit > 0) {
-				int r = moveTo(keys.begin);
-				if (r < 0)
-					moveNext();
+				if (!continuesFrom(keys.begin)) {
+					int r = moveTo(keys.begin);
+					if (r < 0)
+						moveNext();
+				}
 				while (this->valid && rowLimit != 0 && accumulatedBytes < byteLimit) {
 					KeyValueRef kv = decodeKV(getEncodedRow(result.arena()));
 					if (kv.key >= keys.end)
@@ -1245,6 +1254,7 @@ struct RawCursor {
 					result.push_back(result.arena(), kv);
 					moveNext();
 				}
+				setPositionedAfter(result, keys.begin);
 			} else {
 				int r = moveTo(keys.end);
 				if (r >= 0)
@@ -1266,7 +1276,21 @@ struct RawCursor {
 		return result;
 	}
 
+	// True if a forward range read from begin can start wherever the last one left the cursor. Rows can't change
+	// under a read cursor, since its transaction keeps the same snapshot for as long as it lives.
+	bool continuesFrom(KeyRef begin) {
+		bool continues = positionedAt.present() && positionedAt.get() == begin;
+		positionedAt.reset();
+		return continues;
+	}
+
+	// Records where a forward range read from begin which returned result has left the cursor
+	void setPositionedAfter(const RangeResult& result, KeyRef begin) {
+		positionedAt = result.empty() ? Key(begin) : keyAfter(result.back().key);
+	}
+
 	int moveTo(KeyRef key, bool ignore_fragment_mode = false) {
+		positionedAt.reset();
 		UnpackedRecord r;
 		r.pKeyInfo = &keyInfo;
 		r.flags =
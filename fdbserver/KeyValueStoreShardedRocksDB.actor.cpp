@@ -564,10 +564,21 @@ rocksdb::ColumnFamilyOptions getCFOptions() {
 	options.level0_slowdown_writes_trigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_SLOWDOWN_WRITES_TRIGGER;
 	options.level0_stop_writes_trigger = SERVER_KNOBS->SHARDED_ROCKSDB_LEVEL0_STOP_WRITES_TRIGGER;
 
+	// Every physical shard shares the block cache. Index and filter blocks, which every read of a shard needs, can be
+	// kept in its high priority pool, where a shard scanning through data blocks cannot evict them.
 	if (rocksdb_block_cache == nullptr && SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE > 0) {
-		rocksdb_block_cache = rocksdb::NewLRUCache(SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE);
+		rocksdb_block_cache =
+		    rocksdb::NewLRUCache(SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE,
+		                         -1, // num_shard_bits
+		                         false, // strict_capacity_limit
+		                         SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_HIGH_PRI_POOL_RATIO);
 	}
 	bbOpts.block_cache = rocksdb_block_cache;
+	if (SERVER_KNOBS->SHARDED_ROCKSDB_CACHE_INDEX_AND_FILTER_BLOCKS && rocksdb_block_cache != nullptr) {
+		bbOpts.cache_index_and_filter_blocks = true;
+		bbOpts.cache_index_and_filter_blocks_with_high_priority = true;
+		bbOpts.pin_l0_filter_and_index_blocks_in_cache = true;
+	}
 
 	options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(bbOpts));
 
@@ -609,7 +620,8 @@ rocksdb::DBOptions getOptions() {
 	rocksdb::DBOptions options;
 	options.avoid_unnecessary_blocking_io = true;
 	options.create_if_missing = true;
-	options.atomic_flush = SERVER_KNOBS->ROCKSDB_ATOMIC_FLUSH;
+	// Without the WAL, a commit's writes to several column families must be flushed together to stay atomic
+	options.atomic_flush = SERVER_KNOBS->ROCKSDB_ATOMIC_FLUSH || SERVER_KNOBS->ROCKSDB_DISABLE_WAL;
 	if (SERVER_KNOBS->SHARDED_ROCKSDB_BACKGROUND_PARALLELISM > 0) {
 		options.IncreaseParallelism(SERVER_KNOBS->SHARDED_ROCKSDB_BACKGROUND_PARALLELISM);
 	}
@@ -659,11 +671,13 @@ rocksdb::DBOptions getOptions() {
 }
 
 // Set some useful defaults desired for all reads.
-rocksdb::ReadOptions getReadOptions() {
+rocksdb::ReadOptions getReadOptions(ReadType type = ReadType::NORMAL) {
 	rocksdb::ReadOptions options;
 	options.background_purge_on_iterator_cleanup = true;
 	options.auto_prefix_mode = (SERVER_KNOBS->SHARDED_ROCKSDB_PREFIX_LEN > 0);
 	options.async_io = SERVER_KNOBS->SHARDED_ROCKSDB_READ_ASYNC_IO;
+	// A data move reads each block once, and would otherwise push the blocks other shards are reading out of the cache
+	options.fill_cache = type != ReadType::FETCH || SERVER_KNOBS->SHARDED_ROCKSDB_FETCH_FILL_CACHE;
 	return options;
 }
 
@@ -677,9 +691,13 @@ struct ReadIterator {
 
 	ReadIterator(rocksdb::ColumnFamilyHandle* cf, uint64_t index, rocksdb::DB* db)
 	  : index(index), inUse(true), creationTime(now()), iter(db->NewIterator(getReadOptions(), cf)) {}
-	ReadIterator(rocksdb::ColumnFamilyHandle* cf, uint64_t index, rocksdb::DB* db, const KeyRange& range)
+	ReadIterator(rocksdb::ColumnFamilyHandle* cf,
+	             uint64_t index,
+	             rocksdb::DB* db,
+	             const KeyRange& range,
+	             ReadType type = ReadType::NORMAL)
 	  : index(index), inUse(true), creationTime(now()), keyRange(range) {
-		auto options = getReadOptions();
+		auto options = getReadOptions(type);
 		beginSlice = std::shared_ptr<rocksdb::Slice>(new rocksdb::Slice(toSlice(keyRange.begin)));
 		options.iterate_lower_bound = beginSlice.get();
 		endSlice = std::shared_ptr<rocksdb::Slice>(new rocksdb::Slice(toSlice(keyRange.end)));
@@ -721,9 +739,9 @@ public:
 	}
 
 	// Called on every read operation.
-	ReadIterator getIterator(const KeyRange& range) {
-		// Shared iterators are not bounded.
-		if (SERVER_KNOBS->SHARDED_ROCKSDB_REUSE_ITERATORS) {
+	ReadIterator getIterator(const KeyRange& range, ReadType type = ReadType::NORMAL) {
+		// Shared iterators are not bounded, and fill the block cache
+		if (SERVER_KNOBS->SHARDED_ROCKSDB_REUSE_ITERATORS && getReadOptions(type).fill_cache) {
 			std::lock_guard<std::mutex> lock(mutex);
 			for (it = iteratorsMap.begin(); it != iteratorsMap.end(); it++) {
 				if (!it->second.inUse) {
@@ -737,8 +755,9 @@ public:
 			iteratorsMap.insert({ index, iter });
 			return iter;
 		} else {
+			std::lock_guard<std::mutex> lock(mutex);
 			index++;
-			ReadIterator iter(cf, index, db, range);
+			ReadIterator iter(cf, index, db, range, type);
 			return iter;
 		}
 	}
@@ -968,11 +987,20 @@ struct PhysicalShard {
 	bool deletePending = false;
 	std::atomic<bool> isInitialized;
 	uint64_t numRangeDeletions = 0;
+	// Set when a write batch clears every data shard of this physical shard, so the commit can skip compacting it.
+	std::atomic<bool> clearedInFull = false;
+	// Set when auto compactions were turned off because the shard became empty and is waiting to be dropped.
+	bool compactionDisabledForRemoval = false;
 	double deleteTimeSec = 0.0;
 	double lastCompactionTime = 0.0;
 };
 
-int readRangeInDb(PhysicalShard* shard, const KeyRangeRef range, int rowLimit, int byteLimit, RangeResult* result) {
+int readRangeInDb(PhysicalShard* shard,
+                  const KeyRangeRef range,
+                  int rowLimit,
+                  int byteLimit,
+                  RangeResult* result,
+                  ReadType type = ReadType::NORMAL) {
 	if (rowLimit == 0 || byteLimit == 0) {
 		return 0;
 	}
@@ -983,7 +1011,7 @@ int readRangeInDb(PhysicalShard* shard, const KeyRangeRef range, int rowLimit, i
 	// When using a prefix extractor, ensure that keys are returned in order even if they cross
 	// a prefix boundary.
 	if (rowLimit >= 0) {
-		ReadIterator readIter = shard->readIterPool->getIterator(range);
+		ReadIterator readIter = shard->readIterPool->getIterator(range, type);
 		auto cursor = readIter.iter;
 		cursor->Seek(toSlice(range.begin));
 		while (cursor->Valid() && toStringRef(cursor->key()) < range.end) {
@@ -999,7 +1027,7 @@ int readRangeInDb(PhysicalShard* shard, const KeyRangeRef range, int rowLimit, i
 		s = cursor->status();
 		shard->readIterPool->returnIterator(readIter);
 	} else {
-		ReadIterator readIter = shard->readIterPool->getIterator(range);
+		ReadIterator readIter = shard->readIterPool->getIterator(range, type);
 		auto cursor = readIter.iter;
 		cursor->SeekForPrev(toSlice(range.end));
 		if (cursor->Valid() && toStringRef(cursor->key()) == range.end) {
@@ -1033,10 +1061,11 @@ struct Counters {
 	Counter immediateThrottle;
 	Counter failedToAcquire;
 	Counter convertedRangeDeletions;
+	Counter fullShardClears;
 
 	Counters()
 	  : cc("RocksDBCounters"), immediateThrottle("ImmediateThrottle", cc), failedToAcquire("FailedToAcquire", cc),
-	    convertedRangeDeletions("ConvertedRangeDeletions", cc) {}
+	    convertedRangeDeletions("ConvertedRangeDeletions", cc), fullShardClears("FullShardClears", cc) {}
 };
 
 // Manages physical shards and maintains logical shard mapping.
@@ -1411,6 +1440,14 @@ public:
 
 		activePhysicalShardIds.emplace(id);
 
+		if (shard->compactionDisabledForRemoval) {
+			// The shard is reused before being dropped, undo removeRange().
+			shard->compactionDisabledForRemoval = false;
+			if (active && shard->initialized()) {
+				db->SetOptions(shard->cf, { { "disable_auto_compactions", "false" } });
+			}
+		}
+
 		auto dataShard = std::make_unique<DataShard>(range, shard.get());
 		dataShardMap.insert(range, dataShard.get());
 		shard->dataShards[range.begin.toString()] = std::move(dataShard);
@@ -1471,6 +1508,11 @@ public:
 					existingShard->deleteTimeSec = now();
 					pendingDeletionShards.push_back(existingShard->id);
 					activePhysicalShardIds.erase(existingShard->id);
+					if (SERVER_KNOBS->SHARDED_ROCKSDB_CHEAP_SHARD_REMOVAL && existingShard->initialized()) {
+						// Whatever is left in the column family is dropped with it, compacting it is wasted work.
+						db->SetOptions(existingShard->cf, { { "disable_auto_compactions", "true" } });
+						existingShard->compactionDisabledForRemoval = true;
+					}
 				}
 				continue;
 			}
@@ -1599,6 +1641,16 @@ public:
 		dirtyShards->insert(it.value()->physicalShard);
 	}
 
+	// Returns true if range covers every data shard of physicalShard, i.e. the clear empties its column family.
+	static bool clearsEntirePhysicalShard(const PhysicalShard* physicalShard, KeyRangeRef range) {
+		for (const auto& [_, dataShard] : physicalShard->dataShards) {
+			if (!range.contains(dataShard->range)) {
+				return false;
+			}
+		}
+		return !physicalShard->dataShards.empty();
+	}
+
 	void clearRange(KeyRangeRef range, std::set<Key>* keysSet) {
 		auto rangeIterator = dataShardMap.intersectingRanges(range);
 
@@ -1610,6 +1662,18 @@ public:
 
 			auto physicalShard = it.value()->physicalShard;
 
+			if (SERVER_KNOBS->SHARDED_ROCKSDB_CHEAP_SHARD_REMOVAL &&
+			    clearsEntirePhysicalShard(physicalShard, range)) {
+				// Typically a shard moving away, whose column family is dropped once its ranges are removed. A
+				// single tombstone hides the data until then, there is no point in scanning for point deletes or in
+				// compacting it away.
+				writeBatch->DeleteRange(physicalShard->cf, toSlice(it.range().begin), toSlice(it.range().end));
+				physicalShard->clearedInFull = true;
+				dirtyShards->insert(physicalShard);
+				++counters->fullShardClears;
+				continue;
+			}
+
 			// TODO: Disable this once RocksDB is upgraded to a version with range delete improvement.
 			if (SERVER_KNOBS->ROCKSDB_USE_POINT_DELETE_FOR_SYSTEM_KEYS && systemKeys.contains(range)) {
 				auto scanRange = it.range() & range;
@@ -1642,7 +1706,6 @@ public:
 				++physicalShard->numRangeDeletions;
 			}
 
-			// TODO: Skip clear range and compaction when entire CF is cleared.
 			dirtyShards->insert(it.value()->physicalShard);
 		}
 	}
@@ -2756,6 +2819,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 
 		rocksdb::Status doCommit(rocksdb::WriteBatch* batch,
 		                         rocksdb::DB* db,
+		                         const std::set<PhysicalShard*>& dirtyShards,
 		                         std::vector<std::pair<uint32_t, KeyRange>>* deletes,
 		                         bool sample) {
 			if (SERVER_KNOBS->SHARDED_ROCKSDB_SUGGEST_COMPACT_CLEAR_RANGE) {
@@ -2771,10 +2835,20 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			}
 
 			rocksdb::WriteOptions options;
-			options.sync = !SERVER_KNOBS->ROCKSDB_UNSAFE_AUTO_FSYNC;
+			options.disableWAL = SERVER_KNOBS->ROCKSDB_DISABLE_WAL;
+			options.sync = !SERVER_KNOBS->ROCKSDB_UNSAFE_AUTO_FSYNC && !options.disableWAL;
 
 			double writeBeginTime = sample ? timer_monotonic() : 0;
 			rocksdb::Status s = db->Write(options, batch);
+			if (s.ok() && options.disableWAL) {
+				// Without the WAL the batch is only durable once the memtables holding it are flushed, which
+				// atomic_flush does for all of the batch's column families at once
+				std::vector<rocksdb::ColumnFamilyHandle*> cfs;
+				for (auto shard : dirtyShards) {
+					cfs.push_back(shard->cf);
+				}
+				s = db->Flush(rocksdb::FlushOptions(), cfs);
+			}
 			if (sample) {
 				rocksDBMetrics->getWriteHistogram()->sampleSeconds(timer_monotonic() - writeBeginTime);
 			}
@@ -2793,7 +2867,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 				rocksDBMetrics->getCommitQueueWaitHistogram()->sampleSeconds(commitBeginTime - a.startTime);
 			}
 			std::vector<std::pair<uint32_t, KeyRange>> deletes;
-			auto s = doCommit(a.writeBatch.get(), a.db, &deletes, a.getHistograms);
+			auto s = doCommit(a.writeBatch.get(), a.db, *a.dirtyShards, &deletes, a.getHistograms);
 			if (!s.ok()) {
 				TraceEvent(SevError, "CommitError").detail("Status", s.ToString());
 				a.done.sendError(statusToError(s));
@@ -2806,8 +2880,20 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 				}
 			}
 
+			// Column families emptied by this batch are about to be dropped, leave their tombstones alone.
+			std::unordered_set<uint32_t> clearedInFull;
+			for (auto shard : *(a.dirtyShards)) {
+				if (shard->clearedInFull.exchange(false)) {
+					clearedInFull.insert(shard->cf->GetID());
+					shard->numRangeDeletions = 0;
+				}
+			}
+
 			if (SERVER_KNOBS->SHARDED_ROCKSDB_SUGGEST_COMPACT_CLEAR_RANGE) {
 				for (const auto& [id, range] : deletes) {
+					if (clearedInFull.count(id)) {
+						continue;
+					}
 					auto cf = columnFamilyMap->find(id);
 					ASSERT(cf != columnFamilyMap->end());
 					auto begin = toSlice(range.begin);
@@ -3325,7 +3411,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			}
 
 			rocksdb::PinnableSlice value;
-			auto options = getReadOptions();
+			auto options = getReadOptions(a.type);
 
 			auto db = a.shard->db;
 			if (shouldThrottle(a.type, a.key) && SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT) {
@@ -3413,7 +3499,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			}
 
 			rocksdb::PinnableSlice value;
-			auto options = getReadOptions();
+			auto options = getReadOptions(a.type);
 			auto db = a.shard->db;
 			if (shouldThrottle(a.type, a.key) && SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT) {
 				uint64_t deadlineMircos =
@@ -3454,6 +3540,105 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 			sample();
 		}
 
+		struct ReadValuesAction : TypedAction<Reader, ReadValuesAction> {
+			Standalone<VectorRef<KeyRef>> keys;
+			// The physical shard of each key, or nullptr if the key isn't in one
+			std::vector<PhysicalShard*> shards;
+			std::vector<int> maxLengths;
+			ReadType type;
+			double startTime;
+			bool getHistograms;
+			ThreadReturnPromise<std::vector<Optional<Value>>> result;
+
+			ReadValuesAction(VectorRef<KeyRef> keys,
+			                 std::vector<PhysicalShard*> shards,
+			                 std::vector<int> maxLengths,
+			                 ReadType type)
+			  : shards(std::move(shards)), maxLengths(std::move(maxLengths)), type(type), startTime(timer_monotonic()),
+			    getHistograms(deterministicRandom()->random01() < SERVER_KNOBS->ROCKSDB_HISTOGRAMS_SAMPLE_RATE) {
+				// The keys are read on another thread, so they can't refer to the caller's memory
+				this->keys.append_deep(this->keys.arena(), keys.begin(), keys.size());
+			}
+
+			double getTimeEstimate() const override { return SERVER_KNOBS->READ_VALUE_TIME_ESTIMATE * keys.size(); }
+		};
+
+		void action(ReadValuesAction& a) {
+			double readBeginTime = timer_monotonic();
+			if (a.getHistograms) {
+				rocksDBMetrics->getReadValueQueueWaitHistogram(threadIndex)->sampleSeconds(readBeginTime - a.startTime);
+			}
+			bool throttled = !a.keys.empty() && shouldThrottle(a.type, a.keys.front());
+			if (throttled && SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT && readBeginTime - a.startTime > readValueTimeout) {
+				TraceEvent(SevWarn, "ShardedRocksDBError")
+				    .detail("Error", "Read values request timedout")
+				    .detail("Method", "ReadValuesAction")
+				    .detail("Timeout value", readValueTimeout);
+				if (SERVER_KNOBS->ROCKSDB_RETURN_OVERLOADED_ON_TIMEOUT) {
+					a.result.sendError(server_overloaded());
+				} else {
+					a.result.sendError(key_value_store_deadline_exceeded());
+				}
+				return;
+			}
+
+			// All physical shards are column families of the same DB, so one MultiGet covers every shard
+			rocksdb::DB* db = nullptr;
+			std::vector<rocksdb::ColumnFamilyHandle*> cfs;
+			std::vector<rocksdb::Slice> keys;
+			std::vector<int> indices;
+			for (int i = 0; i < a.keys.size(); i++) {
+				if (a.shards[i] != nullptr) {
+					db = a.shards[i]->db;
+					cfs.push_back(a.shards[i]->cf);
+					keys.push_back(toSlice(a.keys[i]));
+					indices.push_back(i);
+				}
+			}
+
+			std::vector<Optional<Value>> result(a.keys.size());
+			if (db != nullptr) {
+				auto options = getReadOptions(a.type);
+				if (throttled && SERVER_KNOBS->ROCKSDB_SET_READ_TIMEOUT) {
+					uint64_t deadlineMircos =
+					    db->GetEnv()->NowMicros() + (readValueTimeout - (timer_monotonic() - a.startTime)) * 1000000;
+					std::chrono::seconds deadlineSeconds(deadlineMircos / 1000000);
+					options.deadline = std::chrono::duration_cast<std::chrono::microseconds>(deadlineSeconds);
+				}
+
+				std::vector<rocksdb::PinnableSlice> values(keys.size());
+				std::vector<rocksdb::Status> statuses(keys.size());
+				double dbGetBeginTime = a.getHistograms ? timer_monotonic() : 0;
+				db->MultiGet(options, keys.size(), cfs.data(), keys.data(), values.data(), statuses.data());
+				if (a.getHistograms) {
+					rocksDBMetrics->getReadValueGetHistogram(threadIndex)
+					    ->sampleSeconds(timer_monotonic() - dbGetBeginTime);
+				}
+
+				for (int j = 0; j < keys.size(); j++) {
+					int i = indices[j];
+					if (statuses[j].ok()) {
+						size_t length = a.maxLengths.empty() ? values[j].size()
+						                                     : std::min(values[j].size(), size_t(a.maxLengths[i]));
+						result[i] = Value(StringRef(reinterpret_cast<const uint8_t*>(values[j].data()), length));
+					} else if (!statuses[j].IsNotFound()) {
+						logRocksDBError(statuses[j], "ReadValues");
+						a.result.sendError(statusToError(statuses[j]));
+						return;
+					}
+				}
+			}
+			a.result.send(std::move(result));
+
+			if (a.getHistograms) {
+				double currTime = timer_monotonic();
+				rocksDBMetrics->getReadValueActionHistogram(threadIndex)->sampleSeconds(currTime - readBeginTime);
+				rocksDBMetrics->getReadValueLatencyHistogram(threadIndex)->sampleSeconds(currTime - a.startTime);
+			}
+
+			sample();
+		}
+
 		struct ReadRangeAction : TypedAction<Reader, ReadRangeAction>, FastAllocated<ReadRangeAction> {
 			KeyRange keys;
 			std::vector<std::pair<PhysicalShard*, KeyRange>> shardRanges;
@@ -3527,7 +3712,7 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 					    .detail("Reason", shard == nullptr ? "Not Exist" : "Not Initialized");
 					continue;
 				}
-				auto bytesRead = readRangeInDb(shard, range, rowLimit, byteLimit, &result);
+				auto bytesRead = readRangeInDb(shard, range, rowLimit, byteLimit, &result, a.type);
 				if (bytesRead < 0) {
 					// Error reading an instance.
 					a.result.sendError(internal_error());
@@ -3848,6 +4033,61 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		return read(a.release(), &semaphore, readThreads.getPtr(), &counters.failedToAcquire);
 	}
 
+	ACTOR static Future<std::vector<Optional<Value>>> read(Reader::ReadValuesAction* action,
+	                                                       FlowLock* semaphore,
+	                                                       IThreadPool* pool,
+	                                                       Counter* counter) {
+		state std::unique_ptr<Reader::ReadValuesAction> a(action);
+		state Optional<Void> slot = wait(timeout(semaphore->take(), SERVER_KNOBS->ROCKSDB_READ_QUEUE_WAIT));
+		if (!slot.present()) {
+			++(*counter);
+			throw server_overloaded();
+		}
+
+		state FlowLock::Releaser release(*semaphore);
+
+		auto fut = a->result.getFuture();
+		pool->post(a.release());
+		std::vector<Optional<Value>> result = wait(fut);
+
+		return result;
+	}
+
+	Future<std::vector<Optional<Value>>> readValues(Standalone<VectorRef<KeyRef>> keys,
+	                                                std::vector<int> maxLengths,
+	                                                Optional<ReadOptions> options) override {
+		std::vector<PhysicalShard*> shards;
+		shards.reserve(keys.size());
+		for (const auto& key : keys) {
+			auto* shard = shardManager.getDataShard(key);
+			if (shard == nullptr || !shard->physicalShard->initialized()) {
+				// TODO: read non-exist system key range should not cause an error.
+				TraceEvent(SevWarn, "ShardedRocksDB", this->id)
+				    .detail("Detail", "Read non-exist key range")
+				    .detail("ReadKey", key);
+				shards.push_back(nullptr);
+			} else {
+				shards.push_back(shard->physicalShard);
+			}
+		}
+
+		ReadType type = options.present() ? options.get().type : ReadType::NORMAL;
+
+		if (keys.empty() || !shouldThrottle(type, keys.front())) {
+			auto a = new Reader::ReadValuesAction(keys, std::move(shards), std::move(maxLengths), type);
+			auto res = a->result.getFuture();
+			readThreads->post(a);
+			return res;
+		}
+
+		auto& semaphore = (type == ReadType::FETCH) ? fetchSemaphore : readSemaphore;
+		int maxWaiters = (type == ReadType::FETCH) ? numFetchWaiters : numReadWaiters;
+
+		checkWaiters(semaphore, maxWaiters);
+		auto a = std::make_unique<Reader::ReadValuesAction>(keys, std::move(shards), std::move(maxLengths), type);
+		return read(a.release(), &semaphore, readThreads.getPtr(), &counters.failedToAcquire);
+	}
+
 	ACTOR static Future<Standalone<RangeResultRef>> read(Reader::ReadRangeAction* action,
 	                                                     FlowLock* semaphore,
 	                                                     IThreadPool* pool,
@@ -4000,6 +4240,17 @@ struct ShardedRocksDBKeyValueStore : IKeyValueStore {
 		return StorageBytes(free, total, live, free);
 	}
 
+	// The block cache is shared by every physical shard, and by the process's other sharded stores
+	int64_t getConfiguredCacheSize() const override {
+		return rocksdb_block_cache ? SERVER_KNOBS->SHARDED_ROCKSDB_BLOCK_CACHE_SIZE : 0;
+	}
+
+	void setCacheSizeLimit(int64_t bytes) override {
+		if (rocksdb_block_cache) {
+			rocksdb_block_cache->SetCapacity(bytes);
+		}
+	}
+
 	Future<CheckpointMetaData> checkpoint(const CheckpointRequest& request) override {
 		auto a = new Writer::CheckpointAction(&shardManager, request);
 
@@ -81,7 +81,9 @@ struct LogRouterData {
 	                                  // A LR's durable version is the maximum version of mutations that have been
 	                                  // popped by remote tLog.
 	Version poppedVersion;
+	// Messages are copied once into these blocks, which every tag and peek cursor then shares by reference
 	Deque<std::pair<Version, Standalone<VectorRef<uint8_t>>>> messageBlocks;
+	int64_t bufferedBytes = 0; // The message bytes in messageBlocks
 	Tag routerTag;
 	bool allowPops;
 	LogSet logSet;
@@ -159,6 +161,7 @@ struct LogRouterData {
 		});
 		specialCounter(cc, "MinKnownCommittedVersion", [this]() { return this->minKnownCommittedVersion; });
 		specialCounter(cc, "PoppedVersion", [this]() { return this->poppedVersion; });
+		specialCounter(cc, "BufferedBytes", [this]() { return this->bufferedBytes; });
 		specialCounter(cc, "FoundEpochEnd", [this]() { return this->foundEpochEnd; });
 		specialCounter(cc, "WaitForVersionMS", [this]() {
 			double val = this->waitForVersionTime;
@@ -250,6 +253,8 @@ void LogRouterData::commitMessages(Version version, const std::vector<TagsAndMes
 		msgSize += i.message.size();
 	}
 
+	// Messages are copied out of the peek reply so that the buffered bytes are only those still needed by some tag,
+	// rather than whole replies pinned until their last message is popped.
 	// Grab the last block in the blocks list so we can share its arena
 	// We pop all of the elements of it to create a "fresh" vector that starts at the end of the previous vector
 	Standalone<VectorRef<uint8_t>> block;
@@ -264,6 +269,7 @@ void LogRouterData::commitMessages(Version version, const std::vector<TagsAndMes
 
 	for (const auto& msg : taggedMessages) {
 		if (msg.message.size() > block.capacity() - block.size()) {
+			bufferedBytes += block.size();
 			messageBlocks.emplace_back(version, block);
 			block = Standalone<VectorRef<uint8_t>>();
 			block.reserve(block.arena(), std::max<int64_t>(SERVER_KNOBS->TLOG_MESSAGE_BLOCK_BYTES, msgSize));
@@ -288,6 +294,7 @@ void LogRouterData::commitMessages(Version version, const std::vector<TagsAndMes
 
 		msgSize -= msg.message.size();
 	}
+	bufferedBytes += block.size();
 	messageBlocks.emplace_back(version, block);
 }
 
@@ -328,6 +335,12 @@ Future<Void> LogRouterData::waitForVersion(Version ver) {
 			}
 		}
 	}
+	// A lagging remote region is also bounded by the bytes held here. The messages that are not pulled yet stay in the
+	// satellite or primary tLogs, which spill them to disk, rather than in the log router's memory.
+	while (bufferedBytes > SERVER_KNOBS->LOG_ROUTER_MAX_BUFFERED_BYTES && minPopped.get() < version.get()) {
+		CODE_PROBE(true, "Log router waits for remote tLogs to pop buffered bytes");
+		co_await minPopped.whenAtLeast(minPopped.get() + 1);
+	}
 	if (ver >= startVersion + SERVER_KNOBS->MAX_VERSIONS_IN_FLIGHT) {
 		foundEpochEnd = true;
 	}
@@ -349,6 +362,7 @@ Future<Void> LogRouterData::waitForVersionAndLog(Version ver) {
 			              .detail("StartVersion", startVersion)
 			              .detail("Version", version.get())
 			              .detail("MinPopped", minPopped.get())
+			              .detail("BufferedBytes", bufferedBytes)
 			              .detail("FoundEpochEnd", foundEpochEnd);
 		          })
 		    .run();
@@ -782,6 +796,7 @@ Future<Void> logRouterPop(LogRouterData* self, TLogPopRequest req) {
 	}
 
 	while (!self->messageBlocks.empty() && self->messageBlocks.front().first < minPopped) {
+		self->bufferedBytes -= self->messageBlocks.front().second.size();
 		self->messageBlocks.pop_front();
 		co_await yield(TaskPriority::TLogPop);
 	}
@@ -272,11 +272,13 @@ void LogSet::getPushLocations(VectorRef<Tag> tags, std::vector<int>& locations,
 	//	.detail("Included", alsoServers.size()).detail("Duration", timer() - t);
 }
 
-LogPushData::LogPushData(Reference<ILogSystem> logSystem, int tlogCount) : logSystem(logSystem), subsequence(1) {
+LogPushData::LogPushData(Reference<ILogSystem> logSystem, int tlogCount)
+  : logSystem(logSystem), messages(AssumeVersion(g_network->protocolVersion())), subsequence(1) {
 	ASSERT(tlogCount > 0);
-	messagesWriter.reserve(tlogCount);
-	for (int i = 0; i < tlogCount; i++) {
-		messagesWriter.emplace_back(AssumeVersion(g_network->protocolVersion()));
+	headerLength = messages.getLength();
+	locationSpans.resize(tlogCount);
+	for (auto& spans : locationSpans) {
+		spans.push_back(Span{ 0, headerLength });
 	}
 	messagesWritten = std::vector<bool>(tlogCount, false);
 }
@@ -312,31 +314,71 @@ void LogPushData::writeMessage(StringRef rawMessageWithoutLength, bool usePrevio
 	uint32_t subseq = this->subsequence++;
 	uint32_t msgsize =
 	    rawMessageWithoutLength.size() + sizeof(subseq) + sizeof(uint16_t) + sizeof(Tag) * prev_tags.size();
+	if (msg_locations.empty()) {
+		return;
+	}
+	int offset = messages.getLength();
+	messages << msgsize << subseq << uint16_t(prev_tags.size());
+	for (auto& tag : prev_tags)
+		messages << tag;
+	messages.serializeBytes(rawMessageWithoutLength);
+	int length = messages.getLength() - offset;
 	for (int loc : msg_locations) {
-		BinaryWriter& wr = messagesWriter[loc];
-		wr << msgsize << subseq << uint16_t(prev_tags.size());
-		for (auto& tag : prev_tags)
-			wr << tag;
-		wr.serializeBytes(rawMessageWithoutLength);
+		appendSpan(loc, offset, length);
+	}
+}
+
+void LogPushData::appendSpan(int location, int offset, int length) {
+	std::vector<Span>& spans = locationSpans[location];
+	if (spans.back().offset + spans.back().length == offset) {
+		spans.back().length += length;
+	} else {
+		spans.push_back(Span{ offset, length });
+	}
+}
+
+int LogPushData::getMessagesLength(int location) const {
+	int length = 0;
+	for (const auto& span : locationSpans[location]) {
+		length += span.length;
 	}
+	return length;
+}
+
+Standalone<StringRef> LogPushData::getMessages(int loc) const {
+	StringRef data = messages.toValue();
+	Standalone<StringRef> result = makeString(getMessagesLength(loc));
+	uint8_t* out = mutateString(result);
+	for (const auto& span : locationSpans[loc]) {
+		memcpy(out, data.begin() + span.offset, span.length);
+		out += span.length;
+	}
+	return result;
+}
+
+Standalone<VectorRef<StringRef>> LogPushData::getMessageSegments(int loc) const {
+	Standalone<StringRef> data = messages.toValue();
+	Standalone<VectorRef<StringRef>> segments;
+	segments.arena().dependsOn(data.arena());
+	segments.reserve(segments.arena(), locationSpans[loc].size());
+	for (const auto& span : locationSpans[loc]) {
+		segments.push_back(segments.arena(), data.substr(span.offset, span.length));
+	}
+	return segments;
 }
 
 std::vector<Standalone<StringRef>> LogPushData::getAllMessages() const {
 	std::vector<Standalone<StringRef>> results;
-	results.reserve(messagesWriter.size());
-	for (int loc = 0; loc < messagesWriter.size(); loc++) {
+	results.reserve(locationSpans.size());
+	for (int loc = 0; loc < locationSpans.size(); loc++) {
 		results.push_back(getMessages(loc));
 	}
 	return results;
 }
 
-void LogPushData::recordEmptyMessage(int loc, const Standalone<StringRef>& value) {
-	if (!messagesWritten[loc]) {
-		BinaryWriter w(AssumeVersion(g_network->protocolVersion()));
-		Standalone<StringRef> v = w.toValue();
-		if (value.size() > v.size()) {
-			messagesWritten[loc] = true;
-		}
+void LogPushData::recordEmptyMessage(int loc) {
+	if (!messagesWritten[loc] && getMessagesLength(loc) > headerLength) {
+		messagesWritten[loc] = true;
 	}
 }
 
@@ -355,7 +397,7 @@ bool LogPushData::writeTransactionInfo(int location, uint32_t subseq) {
 	CODE_PROBE(true, "Wrote SpanContextMessage to a transaction log");
 	writtenLocations.insert(location);
 
-	BinaryWriter& wr = messagesWriter[location];
+	BinaryWriter& wr = messages;
 	int offset = wr.getLength();
 	wr << uint32_t(0) << subseq << uint16_t(prev_tags.size());
 	for (auto& tag : prev_tags)
@@ -385,6 +427,7 @@ bool LogPushData::writeTransactionInfo(int location, uint32_t subseq) {
 	}
 	int length = wr.getLength() - offset;
 	*(uint32_t*)((uint8_t*)wr.getData() + offset) = length - sizeof(uint32_t);
+	appendSpan(location, offset, length);
 	return true;
 }
 
@@ -392,12 +435,12 @@ void LogPushData::setMutations(uint32_t totalMutations, VectorRef<StringRef> mut
 	ASSERT_EQ(subsequence, 1);
 	subsequence = totalMutations + 1; // set to next mutation number
 
-	ASSERT_EQ(messagesWriter.size(), mutations.size());
-	BinaryWriter w(AssumeVersion(g_network->protocolVersion()));
-	Standalone<StringRef> v = w.toValue();
-	const int header = v.size();
+	ASSERT_EQ(locationSpans.size(), mutations.size());
 	for (int i = 0; i < mutations.size(); i++) {
-		BinaryWriter& wr = messagesWriter[i];
-		wr.serializeBytes(mutations[i].substr(header));
+		int offset = messages.getLength();
+		messages.serializeBytes(mutations[i].substr(headerLength));
+		if (messages.getLength() > offset) {
+			appendSpan(i, offset, messages.getLength() - offset);
+		}
 	}
 }
@@ -26,6 +26,16 @@
 #include "flow/DebugTrace.h"
 #include "flow/actorcompiler.h" // has to be last include
 
+// Log routers pull their router tag from the TLogs of another region, so those peeks have their replies compressed to
+// save WAN bandwidth
+static CompressionFilter peekCompressionFilter(Tag tag) {
+	if (tag.locality != tagLocalityLogRouter) {
+		return CompressionFilter::NONE;
+	}
+	CompressionFilter filter = CompressionUtils::fromFilterString(SERVER_KNOBS->LOG_ROUTER_PEEK_COMPRESSION_FILTER);
+	return CompressionUtils::supportedFilters.count(filter) ? filter : CompressionFilter::NONE;
+}
+
 // create a peek stream for cursor when it's possible
 ACTOR Future<Void> tryEstablishPeekStream(ILogSystem::ServerPeekCursor* self) {
 	if (self->peekReplyStream.present())
@@ -37,8 +47,11 @@ ACTOR Future<Void> tryEstablishPeekStream(ILogSystem::ServerPeekCursor* self) {
 	wait(IFailureMonitor::failureMonitor().onStateEqual(self->interf->get().interf().peekStreamMessages.getEndpoint(),
 	                                                    FailureStatus(false)));
 
-	auto req = TLogPeekStreamRequest(
-	    self->messageVersion.version, self->tag, self->returnIfBlocked, std::numeric_limits<int>::max());
+	auto req = TLogPeekStreamRequest(self->messageVersion.version,
+	                                 self->tag,
+	                                 self->returnIfBlocked,
+	                                 SERVER_KNOBS->PEEK_STREAM_WINDOW_BYTES,
+	                                 self->compressionFilter);
 	self->peekReplyStream = self->interf->get().interf().peekStreamMessages.getReplyStream(req);
 	DebugLogTraceEvent(SevDebug, "SPC_StreamCreated", self->randomID)
 	    .detail("Tag", self->tag)
@@ -57,8 +70,8 @@ ILogSystem::ServerPeekCursor::ServerPeekCursor(Reference<AsyncVar<OptionalInterf
   : interf(interf), tag(tag), rd(results.arena, results.messages, Unversioned()), messageVersion(begin), end(end),
     poppedVersion(0), hasMsg(false), randomID(deterministicRandom()->randomUniqueID()),
     returnIfBlocked(returnIfBlocked), onlySpilled(false), parallelGetMore(parallelGetMore),
-    usePeekStream(SERVER_KNOBS->PEEK_USING_STREAMING), sequence(0), lastReset(0), resetCheck(Void()), slowReplies(0),
-    fastReplies(0), unknownReplies(0) {
+    usePeekStream(SERVER_KNOBS->PEEK_USING_STREAMING), compressionFilter(peekCompressionFilter(tag)), sequence(0),
+    lastReset(0), resetCheck(Void()), slowReplies(0), fastReplies(0), unknownReplies(0) {
 	this->results.maxKnownVersion = 0;
 	this->results.minKnownCommittedVersion = 0;
 	DebugLogTraceEvent(SevDebug, "SPC_Starting", randomID)
@@ -80,8 +93,8 @@ ILogSystem::ServerPeekCursor::ServerPeekCursor(TLogPeekReply const& results,
   : tag(tag), results(results), rd(results.arena, results.messages, Unversioned()), messageVersion(messageVersion),
     end(end), poppedVersion(poppedVersion), messageAndTags(message), hasMsg(hasMsg),
     randomID(deterministicRandom()->randomUniqueID()), returnIfBlocked(false), onlySpilled(false),
-    parallelGetMore(false), usePeekStream(false), sequence(0), lastReset(0), resetCheck(Void()), slowReplies(0),
-    fastReplies(0), unknownReplies(0) {
+    parallelGetMore(false), usePeekStream(false), compressionFilter(CompressionFilter::NONE), sequence(0), lastReset(0),
+    resetCheck(Void()), slowReplies(0), fastReplies(0), unknownReplies(0) {
 	//TraceEvent("SPC_Clone", randomID);
 	this->results.maxKnownVersion = 0;
 	this->results.minKnownCommittedVersion = 0;
@@ -191,6 +204,11 @@ void ILogSystem::ServerPeekCursor::advanceTo(LogMessageVersion n) {
 // in getMore helper functions.
 void updateCursorWithReply(ILogSystem::ServerPeekCursor* self, const TLogPeekReply& res) {
 	self->results = res;
+	if (res.compressionFilter != CompressionFilter::NONE) {
+		self->results.messages =
+		    CompressionUtils::decompress(res.compressionFilter, res.messages, self->results.arena);
+		self->results.compressionFilter = CompressionFilter::NONE;
+	}
 	self->onlySpilled = res.onlySpilled;
 	if (res.popped.present())
 		self->poppedVersion = std::min(std::max(self->poppedVersion, res.popped.get()), self->end.version);
@@ -288,7 +306,8 @@ ACTOR Future<Void> serverPeekParallelGetMore(ILogSystem::ServerPeekCursor* self,
 					                        self->tag,
 					                        self->returnIfBlocked,
 					                        self->onlySpilled,
-					                        std::make_pair(self->randomID, self->sequence++)),
+					                        std::make_pair(self->randomID, self->sequence++),
+					                        self->compressionFilter),
 					        taskID)));
 				}
 				if (self->sequence == std::numeric_limits<decltype(self->sequence)>::max()) {
@@ -444,7 +463,9 @@ ACTOR Future<Void> serverPeekGetMore(ILogSystem::ServerPeekCursor* self, TaskPri
 				                        TLogPeekRequest(self->messageVersion.version,
 				                                        self->tag,
 				                                        self->returnIfBlocked,
-				                                        self->onlySpilled),
+				                                        self->onlySpilled,
+				                                        Optional<std::pair<UID, int>>(),
+				                                        self->compressionFilter),
 				                        taskID))
 				                  : Never())) {
 					updateCursorWithReply(self, res);
@@ -50,10 +50,37 @@ UDPMetricClient::UDPMetricClient()
 // ifndef guard here to avoid any compilation issues
 void UDPMetricClient::send_packet(int fd, const void* data, size_t len) {
 #ifndef WIN32
-	::send(fd, data, len, MSG_DONTWAIT);
+	if (::send(fd, data, len, MSG_DONTWAIT) < 0) {
+		int error = errno;
+		TraceEvent(SevWarn, "MetricsUdpSendError").suppressFor(60.0).detail("Errno", error).detail("Bytes", len);
+	}
 #endif
 }
 
+// Groups metrics into batches that each fit in a single packet. A metric bigger than a packet on its own still gets
+// one to itself.
+template <class T>
+static std::vector<std::vector<T>> batchForPackets(std::unordered_map<UID, T>& metricMap, uint32_t maxPacketBytes) {
+	std::vector<std::vector<T>> batches;
+	std::vector<T> current;
+	uint32_t currentBytes = 0;
+	for (auto& [_, m] : metricMap) {
+		uint32_t bytes = m.getMsgpackBytes();
+		if (!current.empty() && currentBytes + bytes > maxPacketBytes) {
+			batches.push_back(std::move(current));
+			current.clear();
+			currentBytes = 0;
+		}
+		currentBytes += bytes;
+		current.push_back(std::move(m));
+	}
+	if (!current.empty()) {
+		batches.push_back(std::move(current));
+	}
+	metricMap.clear();
+	return batches;
+}
+
 void UDPMetricClient::send(MetricCollection* metrics) {
 	if (!socket.isReady()) {
 		return;
@@ -62,9 +89,6 @@ void UDPMetricClient::send(MetricCollection* metrics) {
 	if (socket_fd == -1)
 		return;
 	if (model == OTLP) {
-		std::vector<std::vector<OTEL::OTELSum>> sums;
-		std::vector<OTEL::OTELGauge> gauges;
-
 		// Define custom serialize functions
 		auto f_sums = [](const std::vector<OTEL::OTELSum>& vec, MsgpackBuffer& buf) {
 			typedef void (*func_ptr)(const OTEL::OTELSum&, MsgpackBuffer&);
@@ -84,66 +108,41 @@ void UDPMetricClient::send(MetricCollection* metrics) {
 			serialize_vector(vec, buf, f);
 		};
 
-		std::vector<OTEL::OTELSum> currentSums;
-		size_t current_msgpack = 0;
-		for (const auto& [_, s] : metrics->sumMap) {
-			if (current_msgpack < MAX_OTELSUM_PACKET_SIZE) {
-				currentSums.push_back(std::move(s));
-				current_msgpack += s.getMsgpackBytes();
-			} else {
-				sums.push_back(std::move(currentSums));
-				currentSums.clear();
-				current_msgpack = 0;
-			}
-		}
-		if (!sums.empty()) {
-			for (const auto& currSums : sums) {
-				serialize_ext(currSums, buf, OTEL::OTELMetricType::Sum, f_sums);
-				send_packet(socket_fd, buf.buffer.get(), buf.data_size);
-				int error = errno;
-				TraceEvent("MetricsSumUdpErrno", UID()).detail("Errno", error);
-				buf.reset();
-			}
-			metrics->sumMap.clear();
+		for (const auto& currSums : batchForPackets(metrics->sumMap, MAX_OTELSUM_PACKET_SIZE)) {
+			serialize_ext(currSums, buf, OTEL::OTELMetricType::Sum, f_sums);
+			send_packet(socket_fd, buf.buffer.get(), buf.data_size);
+			buf.reset();
 		}
 
 		// Each histogram should be in a separate because of their large sizes
 		// Expected DDSketch size is ~4200 entries * 9 bytes = 37800
-		for (const auto& [_, h] : metrics->histMap) {
+		for (auto& [_, h] : metrics->histMap) {
 			const std::vector<OTEL::OTELHistogram> singleHist{ std::move(h) };
 			serialize_ext(singleHist, buf, OTEL::OTELMetricType::Hist, f_hists);
 			send_packet(socket_fd, buf.buffer.get(), buf.data_size);
-			int error = errno;
-			TraceEvent("MetricsHistUdpErrno", UID()).detail("Errno", error);
 			buf.reset();
 		}
-
 		metrics->histMap.clear();
 
-		for (const auto& [_, g] : metrics->gaugeMap) {
-			gauges.push_back(std::move(g));
-		}
-		if (!gauges.empty()) {
+		for (const auto& gauges : batchForPackets(metrics->gaugeMap, MAX_OTELSUM_PACKET_SIZE)) {
 			serialize_ext(gauges, buf, OTEL::OTELMetricType::Gauge, f_gauge);
 			send_packet(socket_fd, buf.buffer.get(), buf.data_size);
-			int error = errno;
-			TraceEvent("MetricsGaugeUdpErrno", UID()).detail("Errno", error);
-			metrics->gaugeMap.clear();
 			buf.reset();
 		}
 	} else if (model == MetricsDataModel::STATSD) {
 		std::string messages;
 		for (const auto& msg : metrics->statsd_message) {
 			// Account for max udp packet size (+1 since we add '\n')
-			if (messages.size() + msg.size() + 1 < IUDPSocket::MAX_PACKET_SIZE) {
-				messages += (std::move(msg) + '\n');
-			} else {
-				send_packet(socket_fd, buf.buffer.get(), buf.data_size);
+			if (!messages.empty() && messages.size() + msg.size() + 1 >= IUDPSocket::MAX_PACKET_SIZE) {
+				send_packet(socket_fd, messages.data(), messages.size());
+				messages.clear();
 			}
+			messages += msg;
+			messages += '\n';
 		}
 		if (!messages.empty()) {
 			send_packet(socket_fd, messages.data(), messages.size());
 		}
 		metrics->statsd_message.clear();
 	}
-}
\ No newline at end of file
+}
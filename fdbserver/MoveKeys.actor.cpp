@@ -1014,6 +1014,16 @@ ACTOR static Future<Void> startMoveKeys(Database occ,
 						loadedTssMapping = true;
 					}
 
+					// Get all existing shards overlapping keys (exclude any that have been processed in a previous
+					// iteration of the outer loop), reading them and the tags while the server list is checked
+					state KeyRange currentKeys = KeyRangeRef(begin, keys.end);
+					state Future<RangeResult> fOld = krmGetRanges(tr,
+					                                              keyServersPrefix,
+					                                              currentKeys,
+					                                              SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
+					                                              SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES);
+					state Future<RangeResult> fUIDtoTagMap = tr->getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY);
+
 					std::vector<Future<Optional<Value>>> serverListEntries;
 					serverListEntries.reserve(servers.size());
 					for (int s = 0; s < servers.size(); s++)
@@ -1028,15 +1038,7 @@ ACTOR static Future<Void> startMoveKeys(Database occ,
 						}
 					}
 
-					// Get all existing shards overlapping keys (exclude any that have been processed in a previous
-					// iteration of the outer loop)
-					state KeyRange currentKeys = KeyRangeRef(begin, keys.end);
-
-					state RangeResult old = wait(krmGetRanges(tr,
-					                                          keyServersPrefix,
-					                                          currentKeys,
-					                                          SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
-					                                          SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES));
+					state RangeResult old = wait(fOld);
 
 					// Determine the last processed key (which will be the beginning for the next iteration)
 					state Key endKey = old.end()[-1].key;
@@ -1051,7 +1053,7 @@ ACTOR static Future<Void> startMoveKeys(Database occ,
 					// 	printf("'%s': '%s'\n", old[i].key.toString().c_str(), old[i].value.toString().c_str());
 
 					// Check that enough servers for each shard are in the correct state
-					state RangeResult UIDtoTagMap = wait(tr->getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY));
+					state RangeResult UIDtoTagMap = wait(fUIDtoTagMap);
 					ASSERT(!UIDtoTagMap.more && UIDtoTagMap.size() < CLIENT_KNOBS->TOO_MANY);
 					std::vector<std::vector<UID>> addAsSource = wait(additionalSources(
 					    old, tr, servers.size(), SERVER_KNOBS->MAX_ADDED_SOURCES_MULTIPLIER * servers.size()));
@@ -1312,13 +1314,16 @@ ACTOR static Future<Void> finishMoveKeys(Database occ,
 					wait(checkMoveKeysLock(&tr, lock, ddEnabledState));
 
 					state KeyRange currentKeys = KeyRangeRef(begin, keys.end);
-					state RangeResult UIDtoTagMap = wait(tr.getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY));
+					state RangeResult UIDtoTagMap;
+					state RangeResult keyServers;
+					wait(store(UIDtoTagMap, tr.getRange(serverTagKeys, CLIENT_KNOBS->TOO_MANY)) &&
+					     store(keyServers,
+					           krmGetRanges(&tr,
+					                        keyServersPrefix,
+					                        currentKeys,
+					                        SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
+					                        SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES)));
 					ASSERT(!UIDtoTagMap.more && UIDtoTagMap.size() < CLIENT_KNOBS->TOO_MANY);
-					state RangeResult keyServers = wait(krmGetRanges(&tr,
-					                                                 keyServersPrefix,
-					                                                 currentKeys,
-					                                                 SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT,
-					                                                 SERVER_KNOBS->MOVE_KEYS_KRM_LIMIT_BYTES));
 
 					// Determine the last processed key (which will be the beginning for the next iteration)
 					endKey = keyServers.end()[-1].key;
@@ -1554,13 +1559,13 @@ ACTOR static Future<Void> finishMoveKeys(Database occ,
 
 					if (count == dest.size()) {
 						// update keyServers, serverKeys
-						// SOMEDAY: Doing these in parallel is safe because none of them overlap or touch (one per
+						// These are done in parallel, which is safe because none of them overlap or touch (one per
 						// server)
-						wait(krmSetRangeCoalescing(
+						std::vector<Future<Void>> actors;
+						actors.push_back(krmSetRangeCoalescing(
 						    &tr, keyServersPrefix, currentKeys, keys, keyServersValue(UIDtoTagMap, dest)));
 
 						std::set<UID>::iterator asi = allServers.begin();
-						std::vector<Future<Void>> actors;
 						while (asi != allServers.end()) {
 							bool destHasServer = std::find(dest.begin(), dest.end(), *asi) != dest.end();
 							actors.push_back(krmSetRangeCoalescing(&tr,
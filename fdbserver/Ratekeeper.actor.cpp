@@ -25,7 +25,9 @@
 #include "fdbserver/TagThrottler.h"
 #include "fdbserver/WaitFailure.h"
 #include "fdbserver/QuietDatabase.h"
+#include "flow/IAsyncFile.h"
 #include "flow/OwningResource.h"
+#include "flow/UnitTest.h"
 
 #include "flow/actorcompiler.h" // must be last include
 
@@ -91,6 +93,7 @@ public:
 					ASSERT(!results.more && results.size() < CLIENT_KNOBS->TOO_MANY);
 
 					self->configuration.fromKeyValues((VectorRef<KeyValueRef>)results);
+					self->recordConfiguration();
 
 					state Future<Void> watchFuture =
 					    tr.watch(moveKeysLockOwnerKey) || tr.watch(excludedServersVersionKey) ||
@@ -159,6 +162,11 @@ public:
 	                                                      StorageServerInterface ssi) {
 		self->storageQueueInfo.insert(mapPair(ssi.id(), StorageQueueInfo(self->id, ssi.id(), ssi.locality)));
 		self->healthMetrics.storageStats[ssi.id()] = HealthMetrics::StorageStats();
+		if (self->recording) {
+			RatekeeperRecord r(RatekeeperRecord::StorageAdded, ssi.id());
+			r.locality = ssi.locality;
+			self->record(std::move(r));
+		}
 		TraceEvent("RkTrackStorageStart", self->id)
 		    .detail("StorageServer", ssi.id())
 		    .detail("Locality", ssi.locality.toString());
@@ -172,6 +180,12 @@ public:
 				if (reply.present()) {
 					myQueueInfo->value.update(reply.get(), self->smoothTotalDurableBytes);
 					myQueueInfo->value.acceptingRequests = ssi.isAcceptingRequests();
+					if (self->recording) {
+						RatekeeperRecord r(RatekeeperRecord::StorageQueue, ssi.id());
+						r.storageReply = reply.get();
+						r.acceptingRequests = ssi.isAcceptingRequests();
+						self->record(std::move(r));
+					}
 
 					// Update health stats.
 					auto ssMetrics = self->healthMetrics.storageStats.find(ssi.id());
@@ -185,6 +199,7 @@ public:
 						TraceEvent("RkStorageServerDidNotRespond", self->id).detail("StorageServer", ssi.id());
 					}
 					myQueueInfo->value.valid = false;
+					self->record(RatekeeperRecord(RatekeeperRecord::StorageFailed, ssi.id()));
 				}
 
 				wait(delayJittered(SERVER_KNOBS->METRIC_UPDATE_RATE) &&
@@ -192,6 +207,7 @@ public:
 				                                                    FailureStatus(false)));
 			} catch (Error& e) {
 				if (e.code() == error_code_actor_cancelled) {
+					self->record(RatekeeperRecord(RatekeeperRecord::StorageRemoved, ssi.id()));
 					self->storageQueueInfo.erase(ssi.id());
 					self->healthMetrics.storageStats.erase(ssi.id());
 					throw;
@@ -200,6 +216,7 @@ public:
 				Map<UID, StorageQueueInfo>::iterator myQueueInfo = self->storageQueueInfo.find(ssi.id());
 				ASSERT(myQueueInfo != self->storageQueueInfo.end());
 				myQueueInfo->value.valid = false;
+				self->record(RatekeeperRecord(RatekeeperRecord::StorageFailed, ssi.id()));
 				TraceEvent("RkTrackStorageError", self->id)
 				    .detail("StorageServer", ssi.id())
 				    .detail("Locality", ssi.locality.toString())
@@ -261,6 +278,7 @@ public:
 		self->tlogQueueInfo.insert(mapPair(tli.id(), TLogQueueInfo(tli.id())));
 		state Map<UID, TLogQueueInfo>::iterator myQueueInfo = self->tlogQueueInfo.find(tli.id());
 		TraceEvent("RkTrackTlog", self->id).detail("TransactionLog", tli.id());
+		self->record(RatekeeperRecord(RatekeeperRecord::TLogAdded, tli.id()));
 		try {
 			loop {
 				ErrorOr<TLogQueuingMetricsReply> reply = wait(tli.getQueuingMetrics.getReplyUnlessFailedFor(
@@ -268,11 +286,17 @@ public:
 				if (reply.present()) {
 					myQueueInfo->value.update(reply.get(), self->smoothTotalDurableBytes);
 					myQueueInfo->value.valid = true;
+					if (self->recording) {
+						RatekeeperRecord r(RatekeeperRecord::TLogQueue, tli.id());
+						r.tlogReply = reply.get();
+						self->record(std::move(r));
+					}
 				} else {
 					if (myQueueInfo->value.valid) {
 						TraceEvent("RkTLogDidNotRespond", self->id).detail("TransactionLog", tli.id());
 					}
 					myQueueInfo->value.valid = false;
+					self->record(RatekeeperRecord(RatekeeperRecord::TLogFailed, tli.id()));
 				}
 
 				wait(delayJittered(SERVER_KNOBS->METRIC_UPDATE_RATE) &&
@@ -282,6 +306,7 @@ public:
 		} catch (Error& e) {
 			// including cancellation
 			self->tlogQueueInfo.erase(myQueueInfo);
+			self->record(RatekeeperRecord(RatekeeperRecord::TLogRemoved, tli.id()));
 			if (e.code() != error_code_actor_cancelled) {
 				TraceEvent("RkTrackTlogError", self->id).detail("TransactionLog", tli.id()).errorUnsuppressed(e);
 			}
@@ -339,12 +364,19 @@ public:
 
 	ACTOR static Future<Void> monitorHotShards(Ratekeeper* self, Reference<AsyncVar<ServerDBInfo> const> dbInfo) {
 		loop {
-			wait(delay(SERVER_KNOBS->HOT_SHARD_MONITOR_FREQUENCY));
-			if (!self->ssHighWriteQueue.present()) {
+			// A locally throttled storage server is only protected while its hot shards are, so refresh them before
+			// they expire
+			state double monitorDelay = SERVER_KNOBS->HOT_SHARD_MONITOR_FREQUENCY;
+			if (self->ssLocallyThrottled.present()) {
+				monitorDelay = std::min(monitorDelay, SERVER_KNOBS->HOT_SHARD_THROTTLING_EXPIRE_AFTER / 2);
+			}
+			wait(delay(monitorDelay));
+			if (!self->ssLocallyThrottled.present() && !self->ssHighWriteQueue.present()) {
 				continue;
 			}
 
-			state UID ssi = self->ssHighWriteQueue.get();
+			state UID ssi =
+			    self->ssLocallyThrottled.present() ? self->ssLocallyThrottled.get() : self->ssHighWriteQueue.get();
 			state SetThrottledShardRequest setReq;
 
 			// TraceEvent(SevDebug, "SendGetHotShardsRequest");
@@ -498,12 +530,17 @@ public:
 			self.addActor.send(self.monitorBlobWorkers(dbInfo));
 		}
 
-		if (SERVER_KNOBS->HOT_SHARD_THROTTLING_ENABLED) {
+		if (SERVER_KNOBS->HOT_SHARD_THROTTLING_ENABLED || SERVER_KNOBS->RATEKEEPER_LOCALIZED_THROTTLING) {
 			self.addActor.send(self.monitorHotShards(dbInfo));
 		}
 
 		self.addActor.send(self.refreshStorageServerCommitCosts());
 
+		if (!SERVER_KNOBS->RATEKEEPER_RECORD_DIR.empty()) {
+			self.recording = true;
+			self.addActor.send(self.writeRecording());
+		}
+
 		TraceEvent("RkTLogQueueSizeParameters", rkInterf.id())
 		    .detail("Target", SERVER_KNOBS->TARGET_BYTES_PER_TLOG)
 		    .detail("Spring", SERVER_KNOBS->SPRING_BYTES_TLOG)
@@ -530,6 +567,7 @@ public:
 		}
 
 		self.remoteDC = dbInfo->get().logSystemConfig.getRemoteDcId();
+		self.recordConfiguration();
 
 		state bool recovering = dbInfo->get().recoveryState < RecoveryState::ACCEPTING_COMMITS;
 		state Version recoveryVersion = std::numeric_limits<Version>::max();
@@ -541,15 +579,7 @@ public:
 			state bool lastLimited = false;
 			loop choose {
 				when(wait(timeout)) {
-					double actualTps = self.smoothReleasedTransactions.smoothRate();
-					actualTps =
-					    std::max(std::max(1.0, actualTps),
-					             self.smoothTotalDurableBytes.smoothRate() / CLIENT_KNOBS->TRANSACTION_SIZE_LIMIT);
-
-					if (self.actualTpsHistory.size() > SERVER_KNOBS->MAX_TPS_HISTORY_SAMPLES) {
-						self.actualTpsHistory.pop_front();
-					}
-					self.actualTpsHistory.push_back(actualTps);
+					self.updateTpsHistory();
 
 					if (self.configuration.blobGranulesEnabled && SERVER_KNOBS->BW_THROTTLING_ENABLED) {
 						Version maxVersion = 0;
@@ -582,6 +612,7 @@ public:
 
 					self.updateRate(&self.normalLimits);
 					self.updateRate(&self.batchLimits);
+					self.recordDecision();
 
 					lastLimited = self.smoothReleasedTransactions.smoothRate() >
 					              SERVER_KNOBS->LAST_LIMITED_RATIO * self.batchLimits.tpsLimit;
@@ -599,8 +630,10 @@ public:
 
 					auto& p = self.grvProxyInfo[req.requesterID];
 					//TraceEvent("RKMPU", req.requesterID).detail("TRT", req.totalReleasedTransactions).detail("Last", p.totalTransactions).detail("Delta", req.totalReleasedTransactions - p.totalTransactions);
+					RatekeeperRecord released(RatekeeperRecord::Released, req.requesterID);
 					if (p.totalTransactions > 0) {
 						self.smoothReleasedTransactions.addDelta(req.totalReleasedTransactions - p.totalTransactions);
+						released.released = req.totalReleasedTransactions - p.totalTransactions;
 
 						for (auto const& [tag, count] : req.throttledTagCounts) {
 							self.tagThrottler->addRequests(tag, count);
@@ -609,6 +642,10 @@ public:
 					if (p.batchTransactions > 0) {
 						self.smoothBatchReleasedTransactions.addDelta(req.batchReleasedTransactions -
 						                                              p.batchTransactions);
+						released.batchReleased = req.batchReleasedTransactions - p.batchTransactions;
+					}
+					if (released.released || released.batchReleased) {
+						self.record(std::move(released));
 					}
 
 					p.totalTransactions = req.totalReleasedTransactions;
@@ -703,6 +740,7 @@ public:
 							tlogTrackers.push_back(splitError(self.trackTLogQueueInfo(tlogInterfs[i]), err));
 					}
 					self.remoteDC = dbInfo->get().logSystemConfig.getRemoteDcId();
+		self.recordConfiguration();
 				}
 				when(wait(collection)) {
 					ASSERT(false);
@@ -715,6 +753,172 @@ public:
 		return Void();
 	}
 
+	ACTOR static Future<Void> writeRecording(Ratekeeper* self) {
+		state std::string fileName = joinPath(SERVER_KNOBS->RATEKEEPER_RECORD_DIR,
+		                                      format("ratekeeper.%s.rkrecord", self->id.toString().c_str()));
+		state Reference<IAsyncFile> file;
+		state int64_t offset = 0;
+		try {
+			wait(store(file,
+			           IAsyncFileSystem::filesystem()->open(fileName,
+			                                                IAsyncFile::OPEN_READWRITE | IAsyncFile::OPEN_CREATE |
+			                                                    IAsyncFile::OPEN_UNCACHED | IAsyncFile::OPEN_NO_AIO,
+			                                                0600)));
+			wait(file->truncate(0));
+			// The records are written with this process's protocol version, which leads the file
+			state Standalone<StringRef> chunk = BinaryWriter(IncludeVersion()).toValue();
+			TraceEvent("RatekeeperRecordingStart", self->id).detail("File", fileName);
+			loop {
+				wait(file->write(chunk.begin(), chunk.size(), offset));
+				offset += chunk.size();
+				if (offset >= SERVER_KNOBS->RATEKEEPER_RECORD_MAX_BYTES) {
+					TraceEvent(SevWarnAlways, "RatekeeperRecordingFull", self->id)
+					    .detail("File", fileName)
+					    .detail("Bytes", offset);
+					break;
+				}
+
+				wait(delay(SERVER_KNOBS->RATEKEEPER_RECORD_FLUSH_INTERVAL));
+				BinaryWriter wr(AssumeVersion(g_network->protocolVersion()));
+				for (auto const& r : self->pendingRecords) {
+					wr << r;
+				}
+				self->pendingRecords.clear();
+				chunk = wr.toValue();
+			}
+			wait(file->sync());
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			TraceEvent(SevWarnAlways, "RatekeeperRecordingError", self->id)
+			    .errorUnsuppressed(e)
+			    .detail("File", fileName);
+		}
+		self->recording = false;
+		self->pendingRecords.clear();
+		return Void();
+	}
+
+	static void replayRecord(Ratekeeper* self, RatekeeperRecord const& r, RatekeeperReplaySummary* summary) {
+		switch (r.type) {
+		case RatekeeperRecord::StorageAdded:
+			self->storageQueueInfo.insert(mapPair(r.id, StorageQueueInfo(self->id, r.id, r.locality)));
+			break;
+		case RatekeeperRecord::StorageQueue:
+			if (auto it = self->storageQueueInfo.find(r.id); it != self->storageQueueInfo.end()) {
+				it->value.update(r.storageReply, self->smoothTotalDurableBytes);
+				it->value.acceptingRequests = r.acceptingRequests;
+			}
+			break;
+		case RatekeeperRecord::StorageFailed:
+			if (auto it = self->storageQueueInfo.find(r.id); it != self->storageQueueInfo.end()) {
+				it->value.valid = false;
+			}
+			break;
+		case RatekeeperRecord::StorageRemoved:
+			self->storageQueueInfo.erase(r.id);
+			break;
+		case RatekeeperRecord::TLogAdded:
+			self->tlogQueueInfo.insert(mapPair(r.id, TLogQueueInfo(r.id)));
+			break;
+		case RatekeeperRecord::TLogQueue:
+			if (auto it = self->tlogQueueInfo.find(r.id); it != self->tlogQueueInfo.end()) {
+				it->value.update(r.tlogReply, self->smoothTotalDurableBytes);
+				it->value.valid = true;
+			}
+			break;
+		case RatekeeperRecord::TLogFailed:
+			if (auto it = self->tlogQueueInfo.find(r.id); it != self->tlogQueueInfo.end()) {
+				it->value.valid = false;
+			}
+			break;
+		case RatekeeperRecord::TLogRemoved:
+			self->tlogQueueInfo.erase(r.id);
+			break;
+		case RatekeeperRecord::Released:
+			if (r.released) {
+				self->smoothReleasedTransactions.addDelta(r.released);
+			}
+			if (r.batchReleased) {
+				self->smoothBatchReleasedTransactions.addDelta(r.batchReleased);
+			}
+			break;
+		case RatekeeperRecord::Configuration:
+			self->configuration.storageTeamSize = r.storageTeamSize;
+			self->remoteDC = r.remoteDC;
+			break;
+		case RatekeeperRecord::Decision: {
+			self->updateTpsHistory();
+			self->updateRate(&self->normalLimits);
+			self->updateRate(&self->batchLimits);
+
+			double recordedLimit = std::min(r.tpsLimit, 1e6);
+			double limit = std::min(self->normalLimits.tpsLimit, 1e6);
+			++summary->decisions;
+			if (std::abs(limit - recordedLimit) > 0.01 * std::max(recordedLimit, 1.0) ||
+			    self->normalLimits.reason != r.reason) {
+				++summary->changedDecisions;
+			}
+			summary->recordedLimitedDecisions += r.reason != limitReason_t::unlimited;
+			summary->limitedDecisions += self->normalLimits.reason != limitReason_t::unlimited;
+			summary->recordedMeanTPSLimit += recordedLimit;
+			summary->meanTPSLimit += limit;
+
+			TraceEvent("RatekeeperReplayDecision", self->id)
+			    .detail("RecordedTime", r.time)
+			    .detail("RecordedTPSLimit", r.tpsLimit)
+			    .detail("TPSLimit", self->normalLimits.tpsLimit)
+			    .detail("RecordedReason", r.reason)
+			    .detail("Reason", self->normalLimits.reason)
+			    .detail("RecordedBatchTPSLimit", r.batchTpsLimit)
+			    .detail("BatchTPSLimit", self->batchLimits.tpsLimit)
+			    .detail("RecordedBatchReason", r.batchReason)
+			    .detail("BatchReason", self->batchLimits.reason);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	ACTOR static Future<RatekeeperReplaySummary> replay(Database db, std::string recordFile) {
+		state ActorOwningSelfRef<Ratekeeper> pSelf(new Ratekeeper(deterministicRandom()->randomUniqueID(), db));
+		state Ratekeeper& self = *pSelf;
+		state Future<Void> collection = actorCollection(self.addActor.getFuture());
+		state std::string bytes = readFileBytes(recordFile, std::numeric_limits<int>::max());
+		state BinaryReader reader(bytes, IncludeVersion());
+		state RatekeeperReplaySummary summary;
+		state double start = now();
+		state double recordingStart = 0;
+
+		TraceEvent("RatekeeperReplayStart", self.id).detail("File", recordFile).detail("Bytes", bytes.size());
+		while (!reader.empty()) {
+			state RatekeeperRecord r;
+			reader >> r;
+			if (summary.records++ == 0) {
+				recordingStart = r.time;
+			}
+			// The smoothers see the same times as when the record was made, relative to the start
+			wait(delayUntil(start + r.time - recordingStart));
+			replayRecord(&self, r, &summary);
+		}
+
+		if (summary.decisions) {
+			summary.recordedMeanTPSLimit /= summary.decisions;
+			summary.meanTPSLimit /= summary.decisions;
+		}
+		TraceEvent("RatekeeperReplayEnd", self.id)
+		    .detail("Records", summary.records)
+		    .detail("Decisions", summary.decisions)
+		    .detail("ChangedDecisions", summary.changedDecisions)
+		    .detail("RecordedLimitedDecisions", summary.recordedLimitedDecisions)
+		    .detail("LimitedDecisions", summary.limitedDecisions)
+		    .detail("RecordedMeanTPSLimit", summary.recordedMeanTPSLimit)
+		    .detail("MeanTPSLimit", summary.meanTPSLimit);
+		return summary;
+	}
+
 	ACTOR static Future<Void> refreshStorageServerCommitCosts(Ratekeeper* self) {
 		state double lastBusiestCommitTagPick;
 		state std::vector<Future<Void>> replies;
@@ -765,6 +969,45 @@ Future<Void> Ratekeeper::run(RatekeeperInterface rkInterf, Reference<AsyncVar<Se
 	return RatekeeperImpl::run(rkInterf, dbInfo);
 }
 
+Future<RatekeeperReplaySummary> Ratekeeper::replay(Database db, std::string recordFile) {
+	return RatekeeperImpl::replay(db, recordFile);
+}
+
+Future<Void> Ratekeeper::writeRecording() {
+	return RatekeeperImpl::writeRecording(this);
+}
+
+void Ratekeeper::recordConfiguration() {
+	if (recording) {
+		RatekeeperRecord r(RatekeeperRecord::Configuration, id);
+		r.storageTeamSize = configuration.storageTeamSize;
+		r.remoteDC = remoteDC;
+		record(std::move(r));
+	}
+}
+
+void Ratekeeper::recordDecision() {
+	if (recording) {
+		RatekeeperRecord r(RatekeeperRecord::Decision, id);
+		r.tpsLimit = normalLimits.tpsLimit;
+		r.batchTpsLimit = batchLimits.tpsLimit;
+		r.reason = normalLimits.reason;
+		r.batchReason = batchLimits.reason;
+		record(std::move(r));
+	}
+}
+
+void Ratekeeper::updateTpsHistory() {
+	double actualTps = smoothReleasedTransactions.smoothRate();
+	actualTps =
+	    std::max(std::max(1.0, actualTps), smoothTotalDurableBytes.smoothRate() / CLIENT_KNOBS->TRANSACTION_SIZE_LIMIT);
+
+	if (actualTpsHistory.size() > SERVER_KNOBS->MAX_TPS_HISTORY_SAMPLES) {
+		actualTpsHistory.pop_front();
+	}
+	actualTpsHistory.push_back(actualTps);
+}
+
 Ratekeeper::Ratekeeper(UID id, Database db)
   : id(id), db(db), smoothReleasedTransactions(SERVER_KNOBS->SMOOTHING_AMOUNT),
     smoothBatchReleasedTransactions(SERVER_KNOBS->SMOOTHING_AMOUNT),
@@ -787,7 +1030,7 @@ Ratekeeper::Ratekeeper(UID id, Database db)
                 SERVER_KNOBS->MAX_TL_SS_VERSION_DIFFERENCE_BATCH,
                 SERVER_KNOBS->TARGET_DURABILITY_LAG_VERSIONS_BATCH,
                 SERVER_KNOBS->TARGET_BW_LAG_BATCH),
-    maxVersion(0), blobWorkerTime(now()), unblockedAssignmentTime(now()), anyBlobRanges(false) {
+    maxVersion(0), blobWorkerTime(now()), unblockedAssignmentTime(now()), anyBlobRanges(false), recording(false) {
 	if (SERVER_KNOBS->GLOBAL_TAG_THROTTLING) {
 		tagThrottler = std::make_unique<GlobalTagThrottler>(
 		    db, id, SERVER_KNOBS->MAX_MACHINES_FALLING_BEHIND, SERVER_KNOBS->GLOBAL_TAG_THROTTLING_LIMITING_THRESHOLD);
@@ -822,6 +1065,14 @@ static std::string getIgnoredZonesReasons(
 	return ignoredZoneReasons.length() ? ignoredZoneReasons : "None";
 }
 
+// A storage server whose write queue limits the cluster can be left out of the default priority limit, with its hot
+// shards throttled at the commit proxies instead, until its queue grows past its target and spring bytes
+static bool canThrottleLocally(RatekeeperLimits const* limits, StorageQueueInfo const& ss, limitReason_t reason) {
+	return SERVER_KNOBS->RATEKEEPER_LOCALIZED_THROTTLING && limits->priority == TransactionPriority::DEFAULT &&
+	       reason == limitReason_t::storage_server_write_queue_size &&
+	       ss.getStorageQueueBytes() < limits->storageTargetBytes + limits->storageSpringBytes;
+}
+
 void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 	// double controlFactor = ;  // dt / eFoldingTime
 
@@ -991,6 +1242,7 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 	tagThrottler->updateThrottling(storageQueueInfo);
 
 	std::set<Optional<Standalone<StringRef>>> ignoredMachines;
+	Optional<StorageQueueInfo const*> locallyThrottled;
 	for (auto ss = storageTpsLimitReverseIndex.begin();
 	     ss != storageTpsLimitReverseIndex.end() && ss->first < limits->tpsLimit;
 	     ++ss) {
@@ -999,9 +1251,27 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 			ignoredMachines.insert(ss->second->locality.zoneId());
 			continue;
 		}
-		if (ignoredMachines.count(ss->second->locality.zoneId()) > 0) {
+		if (ignoredMachines.count(ss->second->locality.zoneId()) > 0 ||
+		    (locallyThrottled.present() &&
+		     locallyThrottled.get()->locality.zoneId() == ss->second->locality.zoneId())) {
 			continue;
 		}
+		if (!locallyThrottled.present() && canThrottleLocally(limits, *ss->second, ssReasons[ss->second->id])) {
+			// Only throttle locally if the rest of the cluster could go much faster without this storage server
+			double othersLimit = limits->tpsLimit;
+			for (auto next = std::next(ss); next != storageTpsLimitReverseIndex.end(); ++next) {
+				auto zoneId = next->second->locality.zoneId();
+				if (!ignoredMachines.count(zoneId) && zoneId != ss->second->locality.zoneId()) {
+					othersLimit = std::min(othersLimit, next->first);
+					break;
+				}
+			}
+			if (ss->first < othersLimit * SERVER_KNOBS->RATEKEEPER_LOCALIZED_THROTTLING_RATIO) {
+				CODE_PROBE(true, "Ratekeeper throttles a single storage server locally");
+				locallyThrottled = ss->second;
+				continue;
+			}
+		}
 
 		limitingStorageQueueStorageServer = ss->second->lastReply.bytesInput - ss->second->getSmoothDurableBytes();
 		limits->tpsLimit = ss->first;
@@ -1397,6 +1667,7 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 
 	limits->tpsLimitMetric = std::min(limits->tpsLimit, 1e6);
 	limits->reasonMetric = limitReason;
+	limits->reason = limitReason;
 
 	if (limits->priority == TransactionPriority::DEFAULT) {
 		limits->tpsLimit = std::max(limits->tpsLimit, SERVER_KNOBS->RATEKEEPER_MIN_RATE);
@@ -1429,6 +1700,8 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 		    .detail("WorstStorageServerDurabilityLag", worstDurabilityLag)
 		    .detail("LimitingStorageServerDurabilityLag", limitingDurabilityLag)
 		    .detail("IgnoredZonesReasons", getIgnoredZonesReasons(ignoredMachines, zoneReasons))
+		    .detail("LocallyThrottledStorageServer",
+		            locallyThrottled.present() ? locallyThrottled.get()->id.toString() : std::string())
 		    .detail("TagsAutoThrottled", tagThrottler->autoThrottleCount())
 		    .detail("TagsAutoThrottledBusyRead", tagThrottler->busyReadTagCount())
 		    .detail("TagsAutoThrottledBusyWrite", tagThrottler->busyWriteTagCount())
@@ -1440,6 +1713,19 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 	if (limitReason == limitReason_t::storage_server_write_queue_size) {
 		ssHighWriteQueue = reasonID;
 	}
+	if (limits->priority == TransactionPriority::DEFAULT) {
+		if (locallyThrottled.present() && ssLocallyThrottled != locallyThrottled.get()->id) {
+			TraceEvent("RatekeeperLocalThrottlingStart", id)
+			    .detail("SS", locallyThrottled.get()->id)
+			    .detail("StorageQueue", locallyThrottled.get()->getStorageQueueBytes());
+		} else if (!locallyThrottled.present() && ssLocallyThrottled.present()) {
+			TraceEvent("RatekeeperLocalThrottlingStop", id).detail("SS", ssLocallyThrottled.get());
+		}
+		ssLocallyThrottled.reset();
+		if (locallyThrottled.present()) {
+			ssLocallyThrottled = locallyThrottled.get()->id;
+		}
+	}
 }
 
 Future<Void> Ratekeeper::refreshStorageServerCommitCosts() {
@@ -1619,5 +1905,60 @@ RatekeeperLimits::RatekeeperLimits(TransactionPriority priority,
                                                                                    // are expected to not
     // be durable on the storage servers
     lastDurabilityLag(0), durabilityLagLimit(std::numeric_limits<double>::infinity()), bwLagTarget(bwLagTarget),
-    priority(priority), context(context),
+    reason(limitReason_t::unlimited), priority(priority), context(context),
     rkUpdateEventCacheHolder(makeReference<EventCacheHolder>("RkUpdate" + context)) {}
+
+TEST_CASE("/fdbserver/Ratekeeper/Record") {
+	std::vector<RatekeeperRecord> records;
+	RatekeeperRecord added(RatekeeperRecord::StorageAdded, deterministicRandom()->randomUniqueID());
+	added.locality.set("zoneid"_sr, "zone1"_sr);
+	records.push_back(added);
+	RatekeeperRecord queue(RatekeeperRecord::StorageQueue, added.id);
+	queue.storageReply.bytesInput = 12345;
+	queue.storageReply.version = 678;
+	queue.acceptingRequests = true;
+	records.push_back(queue);
+	RatekeeperRecord released(RatekeeperRecord::Released, UID());
+	released.released = 100;
+	records.push_back(released);
+	RatekeeperRecord decision(RatekeeperRecord::Decision, UID());
+	decision.tpsLimit = 1000.5;
+	decision.reason = limitReason_t::storage_server_write_queue_size;
+	records.push_back(decision);
+	records.push_back(RatekeeperRecord(RatekeeperRecord::TLogRemoved, deterministicRandom()->randomUniqueID()));
+	for (int i = 0; i < records.size(); i++) {
+		records[i].time = i;
+	}
+
+	std::string file = BinaryWriter(IncludeVersion()).toValue().toString();
+	BinaryWriter wr(AssumeVersion(g_network->protocolVersion()));
+	for (auto const& r : records) {
+		wr << r;
+	}
+	file += wr.toValue().toString();
+
+	BinaryReader reader(file, IncludeVersion());
+	for (auto const& expected : records) {
+		RatekeeperRecord r;
+		reader >> r;
+		ASSERT_EQ(r.time, expected.time);
+		ASSERT_EQ(r.type, expected.type);
+		ASSERT(r.id == expected.id);
+	}
+	ASSERT(reader.empty());
+
+	BinaryReader fieldReader(file, IncludeVersion());
+	RatekeeperRecord r;
+	fieldReader >> r;
+	ASSERT(r.locality.zoneId() == added.locality.zoneId());
+	fieldReader >> r;
+	ASSERT_EQ(r.storageReply.bytesInput, 12345);
+	ASSERT_EQ(r.storageReply.version, 678);
+	ASSERT(r.acceptingRequests);
+	fieldReader >> r;
+	ASSERT_EQ(r.released, 100);
+	fieldReader >> r;
+	ASSERT_EQ(r.tpsLimit, 1000.5);
+	ASSERT_EQ(r.reason, limitReason_t::storage_server_write_queue_size);
+	return Void();
+}
@@ -191,7 +191,9 @@ struct Resolver : ReferenceCounted<Resolver> {
 
 	Resolver(UID dbgid, int commitProxyCount, int resolverCount, EncryptionAtRestMode encryptMode)
 	  : dbgid(dbgid), commitProxyCount(commitProxyCount), resolverCount(resolverCount), encryptMode(encryptMode),
-	    version(-1), conflictSet(newConflictSet()), iopsSample(SERVER_KNOBS->KEY_BYTES_PER_SAMPLE),
+	    version(-1), conflictSet(newConflictSet(SERVER_KNOBS->RESOLVER_CONFLICT_DETECTION_PARALLELISM,
+	                                           SERVER_KNOBS->RESOLVER_USE_COMPRESSED_CONFLICT_HISTORY)),
+	    iopsSample(SERVER_KNOBS->KEY_BYTES_PER_SAMPLE),
 	    cc("Resolver", dbgid.toString()), resolveBatchIn("ResolveBatchIn", cc),
 	    resolveBatchStart("ResolveBatchStart", cc), resolvedTransactions("ResolvedTransactions", cc),
 	    resolvedBytes("ResolvedBytes", cc), resolvedReadConflictRanges("ResolvedReadConflictRanges", cc),
@@ -681,7 +683,7 @@ ACTOR Future<Void> processTransactionStateRequestPart(Reference<Resolver> self,
 
 	// ASSERT(!pContext->pResolverData->validState.isSet());
 
-	for (auto& kv : request.data) {
+	for (auto& kv : request.getData(request.arena)) {
 		pContext->pTxnStateStore->set(kv, &request.arena);
 	}
 	pContext->pTxnStateStore->commit(true);
@@ -408,11 +408,12 @@ ACTOR static Future<Void> _parsePartitionedLogFileOnLoader(
 	    .detail("Length", asset.len);
 
 	state Arena tempArena;
+	state Standalone<StringRef> messages;
 	state StringRefReader reader(buf, restore_corrupted_data());
 	try {
-		// Read block header
-		if (reader.consume<int32_t>() != PARTITIONED_MLOG_VERSION)
-			throw restore_unsupported_file_version();
+		// Read the block's messages, decompressing them if needed
+		messages = fileBackup::decodePartitionedLogBlock(buf);
+		reader = StringRefReader(messages, restore_corrupted_data());
 
 		state VersionedMutationsMap* kvOps = &kvOpsIter->second;
 		while (1) {
@@ -441,7 +442,8 @@ ACTOR static Future<Void> _parsePartitionedLogFileOnLoader(
 			// only one clear mutation is generated (i.e., always inserted).
 			ASSERT(inserted);
 
-			ArenaReader rd(buf.arena(), StringRef(message, msgSize), AssumeVersion(g_network->protocolVersion()));
+			ArenaReader rd(
+			    messages.arena(), StringRef(message, msgSize), AssumeVersion(g_network->protocolVersion()));
 			state MutationRef mutation;
 			rd >> mutation;
 			if (mutation.isEncrypted()) {
@@ -178,6 +178,51 @@ static Future<Optional<std::pair<WorkerEvents, std::set<std::string>>>> latestEr
 	return latestEventOnWorkers(workers, "");
 }
 
+Future<StatusWorkerEvents> getStatusWorkerEvents(std::vector<WorkerDetails> const& workers) {
+	// WorkerEvents is a map of worker's NetworkAddress to its event string
+	// The pair represents worker responses and a set of worker NetworkAddress strings which did not respond.
+	std::vector<Future<Optional<std::pair<WorkerEvents, std::set<std::string>>>>> futures;
+	futures.push_back(latestEventOnWorkers(workers, "MachineMetrics"));
+	futures.push_back(latestEventOnWorkers(workers, "ProcessMetrics"));
+	futures.push_back(latestEventOnWorkers(workers, "NetworkMetrics"));
+	futures.push_back(latestErrorOnWorkers(workers)); // Get all latest errors.
+	futures.push_back(latestEventOnWorkers(workers, "TraceFileOpenError"));
+	futures.push_back(latestEventOnWorkers(workers, "ProgramStart"));
+	futures.push_back(latestEventOnWorkers(workers, "PeerNetworkMetrics"));
+	return getAll(futures);
+}
+
+Optional<StatusWorkerEvents> StatusWorkerEventCache::get(std::vector<WorkerDetails> const& workers) const {
+	if (now() - updated > 2 * SERVER_KNOBS->STATUS_WORKER_EVENT_REFRESH_INTERVAL) {
+		return Optional<StatusWorkerEvents>();
+	}
+	std::set<NetworkAddress> current;
+	std::set<std::string> currentNames;
+	for (auto const& worker : workers) {
+		if (!addresses.count(worker.interf.address())) {
+			// A new worker, which the cache knows nothing about
+			return Optional<StatusWorkerEvents>();
+		}
+		current.insert(worker.interf.address());
+		currentNames.insert(worker.interf.address().toString());
+	}
+
+	// Leave out the workers that have gone since
+	StatusWorkerEvents result = events;
+	for (auto& e : result) {
+		if (!e.present()) {
+			continue;
+		}
+		for (auto it = e.get().first.begin(); it != e.get().first.end();) {
+			it = current.count(it->first) ? std::next(it) : e.get().first.erase(it);
+		}
+		for (auto it = e.get().second.begin(); it != e.get().second.end();) {
+			it = currentNames.count(*it) ? std::next(it) : e.get().second.erase(it);
+		}
+	}
+	return result;
+}
+
 static Optional<WorkerDetails> getWorker(std::vector<WorkerDetails> const& workers, NetworkAddress const& address) {
 	try {
 		for (int c = 0; c < workers.size(); c++)
@@ -498,6 +543,25 @@ struct RolesInfo {
 		return latencyBands;
 	}
 
+	// The tenants that missed their latency objectives the most in the last interval, as summarized by
+	// TenantLatencyMap
+	JsonBuilderArray addTenantLatencies(TraceEventFields const& summary) {
+		JsonBuilderArray tenants;
+		int reported = summary.getInt("Reported");
+		for (int i = 0; i < reported; i++) {
+			JsonBuilderObject tenant;
+			tenant["tenant_id"] = summary.getInt64(format("Tenant%d", i));
+			tenant["request_type"] = summary.getValue(format("Type%d", i));
+			tenant.setKeyRawNumber("count", summary.getValue(format("Count%d", i)));
+			tenant.setKeyRawNumber("median", summary.getValue(format("Median%d", i)));
+			tenant.setKeyRawNumber("p99", summary.getValue(format("P99%d", i)));
+			tenant.setKeyRawNumber("max", summary.getValue(format("Max%d", i)));
+			tenant.setKeyRawNumber("slo_misses", summary.getValue(format("SLOMisses%d", i)));
+			tenants.push_back(tenant);
+		}
+		return tenants;
+	}
+
 	JsonBuilderObject& addRole(NetworkAddress address, std::string const& role, UID id) {
 		JsonBuilderObject obj;
 		obj["id"] = id.shortString();
@@ -575,6 +639,11 @@ struct RolesInfo {
 				obj["read_latency_bands"] = addLatencyBandInfo(readLatencyBands);
 			}
 
+			TraceEventFields const& tenantReadLatencies = metrics.at("TenantReadLatenciesSummary");
+			if (tenantReadLatencies.size()) {
+				obj["tenant_latencies"] = addTenantLatencies(tenantReadLatencies);
+			}
+
 			obj["data_lag"] = getLagObject(versionLag);
 			obj["durability_lag"] = getLagObject(version - durableVersion);
 			dataLagSeconds = versionLag / (double)SERVER_KNOBS->VERSIONS_PER_SECOND;
@@ -688,6 +757,11 @@ struct RolesInfo {
 				obj["commit_latency_bands"] = addLatencyBandInfo(commitLatencyBands);
 			}
 
+			TraceEventFields const& tenantCommitLatencies = metrics.at("TenantCommitLatenciesSummary");
+			if (tenantCommitLatencies.size()) {
+				obj["tenant_latencies"] = addTenantLatencies(tenantCommitLatencies);
+			}
+
 			TraceEventFields const& commitBatchingWindowSize = metrics.at("CommitBatchingWindowSize");
 			if (commitBatchingWindowSize.size()) {
 				obj["commit_batching_window_size"] = addLatencyStatistics(commitBatchingWindowSize);
@@ -798,12 +872,39 @@ struct RolesInfo {
 	}
 };
 
+// The fraction of the time the run loop spent running tasks at each priority that was busy enough to be logged in
+// NetworkMetrics
+static JsonBuilderArray getRunLoopBusyByPriority(const TraceEventFields& networkMetrics) {
+	JsonBuilderArray busyByPriority;
+	double elapsed;
+	if (!networkMetrics.tryGetDouble("Elapsed", elapsed) || elapsed <= 0) {
+		return busyByPriority;
+	}
+	const std::string cpuPrefix = "PriorityCPU";
+	for (auto const& [name, value] : networkMetrics) {
+		if (!StringRef(name).startsWith(StringRef(cpuPrefix))) {
+			continue;
+		}
+		const std::string priority = name.substr(cpuPrefix.size());
+		JsonBuilderObject priorityObj;
+		priorityObj["priority"] = atoi(priority.c_str());
+		priorityObj["busy"] = atof(value.c_str()) / elapsed;
+		int64_t tasks;
+		if (networkMetrics.tryGetInt64("PriorityTasks" + priority, tasks)) {
+			priorityObj["tasks_per_second"] = tasks / elapsed;
+		}
+		busyByPriority.push_back(priorityObj);
+	}
+	return busyByPriority;
+}
+
 ACTOR static Future<JsonBuilderObject> processStatusFetcher(
     Reference<AsyncVar<ServerDBInfo>> db,
     std::vector<WorkerDetails> workers,
     WorkerEvents pMetrics,
     WorkerEvents mMetrics,
     WorkerEvents nMetrics,
+    WorkerEvents peerNetworkMetrics,
     WorkerEvents errors,
     WorkerEvents traceFileOpenErrors,
     WorkerEvents programStarts,
@@ -1019,6 +1120,14 @@ ACTOR static Future<JsonBuilderObject> processStatusFetcher(
 				if (processMetricsElapsed > 0) {
 					JsonBuilderObject cpuObj;
 					cpuObj["usage_cores"] = std::max(0.0, cpuSeconds / processMetricsElapsed);
+					// Only present when the process was started with --cpu-affinity or --helper-cpu-affinity
+					std::string cpus;
+					if (processMetrics.tryGetValue("NetworkThreadCPUs", cpus) && !cpus.empty()) {
+						cpuObj["network_thread_cpus"] = cpus;
+					}
+					if (processMetrics.tryGetValue("HelperThreadCPUs", cpus) && !cpus.empty()) {
+						cpuObj["helper_thread_cpus"] = cpus;
+					}
 					statusObj["cpu"] = cpuObj;
 
 					diskObj["busy"] =
@@ -1069,6 +1178,34 @@ ACTOR static Future<JsonBuilderObject> processStatusFetcher(
 				tls_policy_failures.setKeyRawNumber("hz", processMetrics.getValue("TLSPolicyFailures"));
 				networkObj["tls_policy_failures"] = tls_policy_failures;
 
+				const TraceEventFields& peerMetrics = peerNetworkMetrics[address];
+				if (peerMetrics.size() > 0) {
+					JsonBuilderArray peersArr;
+					int reported = peerMetrics.getInt("ReportedPeers");
+					for (int i = 0; i < reported; i++) {
+						std::string prefix = format("Peer%d", i);
+						JsonBuilderObject peerObj;
+						peerObj["address"] = peerMetrics.getValue(prefix + "Address");
+						JsonBuilderObject pingObj;
+						pingObj.setKeyRawNumber("count", peerMetrics.getValue(prefix + "PingCount"));
+						pingObj.setKeyRawNumber("p50_seconds", peerMetrics.getValue(prefix + "PingP50"));
+						pingObj.setKeyRawNumber("p99_seconds", peerMetrics.getValue(prefix + "PingP99"));
+						peerObj["ping_latency"] = pingObj;
+						peerObj.setKeyRawNumber("ping_timeouts", peerMetrics.getValue(prefix + "Timeouts"));
+						JsonBuilderObject bytesSent;
+						bytesSent.setKeyRawNumber("hz", peerMetrics.getValue(prefix + "BytesSentHz"));
+						peerObj["bytes_sent"] = bytesSent;
+						JsonBuilderObject bytesReceived;
+						bytesReceived.setKeyRawNumber("hz", peerMetrics.getValue(prefix + "BytesReceivedHz"));
+						peerObj["bytes_received"] = bytesReceived;
+						peerObj.setKeyRawNumber("queued_bytes", peerMetrics.getValue(prefix + "QueuedBytes"));
+						peersArr.push_back(peerObj);
+					}
+					// The peers this process has been slowest to hear back from, out of peer_count
+					networkObj.setKeyRawNumber("peer_count", peerMetrics.getValue("Peers"));
+					networkObj["slowest_peers"] = peersArr;
+				}
+
 				statusObj["network"] = networkObj;
 
 				memoryObj.setKeyRawNumber("used_bytes", processMetrics.getValue("Memory"));
@@ -1157,6 +1294,7 @@ ACTOR static Future<JsonBuilderObject> processStatusFetcher(
 
 			const TraceEventFields& networkMetrics = nMetrics[workerItr->interf.address()];
 			double networkMetricsElapsed = networkMetrics.getDouble("Elapsed");
+			statusObj["run_loop_busy_by_priority"] = getRunLoopBusyByPriority(networkMetrics);
 
 			try {
 				double runLoopBusy = networkMetrics.getDouble("PriorityStarvedBelow1");
@@ -2033,8 +2171,10 @@ static Future<std::vector<std::pair<iface, EventMap>>> getServerMetrics(
 
 namespace {
 
-const std::vector<std::string> STORAGE_SERVER_METRICS_LIST{ "StorageMetrics", "ReadLatencyMetrics", "ReadLatencyBands",
-	                                                        "BusiestReadTag", "BusiestWriteTag",    "RocksDBMetrics" };
+const std::vector<std::string> STORAGE_SERVER_METRICS_LIST{ "StorageMetrics",  "ReadLatencyMetrics",
+	                                                        "ReadLatencyBands", "TenantReadLatenciesSummary",
+	                                                        "BusiestReadTag",   "BusiestWriteTag",
+	                                                        "RocksDBMetrics" };
 
 } // namespace
 
@@ -2074,6 +2214,7 @@ ACTOR static Future<std::vector<std::pair<CommitProxyInterface, EventMap>>> getC
 	                          address_workers,
 	                          std::vector<std::string>{ "CommitLatencyMetrics",
 	                                                    "CommitLatencyBands",
+	                                                    "TenantCommitLatenciesSummary",
 	                                                    "CommitBatchingWindowSize",
 	                                                    "CommitBatchTransactions",
 	                                                    "CommitBatchBytes",
@@ -3096,7 +3237,8 @@ ACTOR Future<StatusReply> clusterGetStatus(
     Version dcStorageServerVersionDifference,
     ConfigBroadcaster const* configBroadcaster,
     Optional<UnversionedMetaclusterRegistrationEntry> metaclusterRegistration,
-    metacluster::MetaclusterMetrics metaclusterMetrics) {
+    metacluster::MetaclusterMetrics metaclusterMetrics,
+    Optional<StatusWorkerEvents> cachedWorkerEvents) {
 
 	state double tStart = timer();
 
@@ -3197,20 +3339,13 @@ ACTOR Future<StatusReply> clusterGetStatus(
 			csWorker = _csWorker.get();
 		}
 
-		// Get latest events for various event types from ALL workers
-		// WorkerEvents is a map of worker's NetworkAddress to its event string
-		// The pair represents worker responses and a set of worker NetworkAddress strings which did not respond.
-		std::vector<Future<Optional<std::pair<WorkerEvents, std::set<std::string>>>>> futures;
-		futures.push_back(latestEventOnWorkers(workers, "MachineMetrics"));
-		futures.push_back(latestEventOnWorkers(workers, "ProcessMetrics"));
-		futures.push_back(latestEventOnWorkers(workers, "NetworkMetrics"));
-		futures.push_back(latestErrorOnWorkers(workers)); // Get all latest errors.
-		futures.push_back(latestEventOnWorkers(workers, "TraceFileOpenError"));
-		futures.push_back(latestEventOnWorkers(workers, "ProgramStart"));
-
-		// Wait for all response pairs.
-		state std::vector<Optional<std::pair<WorkerEvents, std::set<std::string>>>> workerEventsVec =
-		    wait(getAll(futures));
+		// Get latest events for various event types from ALL workers, unless the cluster controller has them already
+		state StatusWorkerEvents workerEventsVec;
+		if (cachedWorkerEvents.present()) {
+			workerEventsVec = cachedWorkerEvents.get();
+		} else {
+			wait(store(workerEventsVec, getStatusWorkerEvents(workers)));
+		}
 
 		// Create a unique set of all workers who were unreachable for 1 or more of the event requests above.
 		// Since each event request is independent and to all workers, workers can have responded to some
@@ -3267,6 +3402,8 @@ ACTOR Future<StatusReply> clusterGetStatus(
 		    workerEventsVec[4].present() ? workerEventsVec[4].get().first : WorkerEvents();
 		state WorkerEvents programStarts =
 		    workerEventsVec[5].present() ? workerEventsVec[5].get().first : WorkerEvents();
+		state WorkerEvents peerNetworkMetrics =
+		    workerEventsVec[6].present() ? workerEventsVec[6].get().first : WorkerEvents();
 
 		if (db->get().recoveryCount > 0) {
 			statusObj["generation"] = db->get().recoveryCount;
@@ -3585,6 +3722,7 @@ ACTOR Future<StatusReply> clusterGetStatus(
 		                              pMetrics,
 		                              mMetrics,
 		                              networkMetrics,
+		                              peerNetworkMetrics,
 		                              latestError,
 		                              traceFileOpenErrors,
 		                              programStarts,
@@ -61,6 +61,11 @@ bool canReplyWith(Error e) {
 		return false;
 	};
 }
+
+// Whether a read failed because its keys are not, or not yet, cached here
+bool isCacheMiss(Error e) {
+	return e.code() == error_code_wrong_shard_server || e.code() == error_code_future_version;
+}
 } // namespace
 
 class StorageCacheUpdater;
@@ -224,6 +229,7 @@ public:
 		Counter updateBatches, updateVersions;
 		Counter loops;
 		Counter readsRejected;
+		Counter cacheHits, cacheMisses;
 
 		// LatencyBands readLatencyBands;
 
@@ -235,7 +241,8 @@ public:
 		    bytesFetched("BytesFetched", cc), mutationBytes("MutationBytes", cc), mutations("Mutations", cc),
 		    setMutations("SetMutations", cc), clearRangeMutations("ClearRangeMutations", cc),
 		    atomicMutations("AtomicMutations", cc), updateBatches("UpdateBatches", cc),
-		    updateVersions("UpdateVersions", cc), loops("Loops", cc), readsRejected("ReadsRejected", cc) {
+		    updateVersions("UpdateVersions", cc), loops("Loops", cc), readsRejected("ReadsRejected", cc),
+		    cacheHits("CacheHits", cc), cacheMisses("CacheMisses", cc) {
 			specialCounter(cc, "LastTLogVersion", [self]() { return self->lastTLogVersion; });
 			specialCounter(cc, "Version", [self]() { return self->version.get(); });
 			specialCounter(cc, "VersionLag", [self]() { return self->versionLag; });
@@ -537,11 +544,14 @@ ACTOR Future<Void> getValueQ(StorageCacheData* data, GetValueRequest req) {
 
 		GetValueReply reply(v, true);
 		req.reply.send(reply);
+		++data->counters.cacheHits;
 	} catch (Error& e) {
 		//TraceEvent(SevWarn, "SCGetValueQError", data->thisServerID).detail("Code",e.code()).detail("ReqKey",req.key)
 		//	.detail("ReqVersion", req.version).detail("DataVersion", data->version.get());
 		if (!canReplyWith(e))
 			throw;
+		if (isCacheMiss(e))
+			++data->counters.cacheMisses;
 		req.reply.sendError(e);
 	}
 
@@ -834,6 +844,7 @@ ACTOR Future<Void> getKeyValues(StorageCacheData* data, GetKeyValuesRequest req)
 			}
 
 			req.reply.send(r);
+			++data->counters.cacheHits;
 
 			resultSize = req.limitBytes - remainingLimitBytes;
 			data->counters.bytesQueried += resultSize;
@@ -848,6 +859,8 @@ ACTOR Future<Void> getKeyValues(StorageCacheData* data, GetKeyValuesRequest req)
 		    .detail("DataVersion", data->version.get());
 		if (!canReplyWith(e))
 			throw;
+		if (isCacheMiss(e))
+			++data->counters.cacheMisses;
 		req.reply.sendError(e);
 	}
 
@@ -896,11 +909,14 @@ ACTOR Future<Void> getKey(StorageCacheData* data, GetKeyRequest req) {
 
 		GetKeyReply reply(updated, true);
 		req.reply.send(reply);
+		++data->counters.cacheHits;
 	} catch (Error& e) {
 		// if (e.code() == error_code_wrong_shard_server) TraceEvent("SCWrongCacheRangeServer").detail("In","getKey");
 		// if (e.code() == error_code_future_version) TraceEvent("SCColdCacheRangeServer").detail("In","getKey");
 		if (!canReplyWith(e))
 			throw;
+		if (isCacheMiss(e))
+			++data->counters.cacheMisses;
 		req.reply.sendError(e);
 	}
 
@@ -2254,9 +2270,20 @@ ACTOR Future<Void> storageCacheServer(StorageServerInterface ssi,
 				// actors.add(self->readGuard(req , getValueQ));
 				actors.add(getValueQ(&self, req));
 			}
+			when(GetValuesRequest req = waitNext(ssi.getValues.getFuture())) {
+				// Cache servers don't serve multi-key reads. Simulate endpoint not found so that the requester will
+				// try a storage server instead.
+				req.reply.sendError(broken_promise());
+			}
 			when(WatchValueRequest req = waitNext(ssi.watchValue.getFuture())) {
 				ASSERT(false);
 			}
+			when(WatchRangeRequest req = waitNext(ssi.watchRange.getFuture())) {
+				ASSERT(false);
+			}
+			when(GetHotKeysRequest req = waitNext(ssi.getHotKeys.getFuture())) {
+				ASSERT(false);
+			}
 			when(GetKeyRequest req = waitNext(ssi.getKey.getFuture())) {
 				actors.add(getKey(&self, req));
 			}
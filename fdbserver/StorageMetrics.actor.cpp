@@ -366,7 +366,8 @@ void StorageServerMetrics::getStorageMetrics(GetStorageMetricsRequest req,
                                              int64_t versionLag,
                                              double lastUpdate,
                                              int64_t bytesDurable,
-                                             int64_t bytesInput) const {
+                                             int64_t bytesInput,
+                                             bool storageEngineWrongConfigured) const {
 	GetStorageMetricsReply rep;
 
 	// SOMEDAY: make bytes dynamic with hard disk space
@@ -398,6 +399,7 @@ void StorageServerMetrics::getStorageMetrics(GetStorageMetricsRequest req,
 
 	rep.bytesDurable = bytesDurable;
 	rep.bytesInput = bytesInput;
+	rep.storageEngineWrongConfigured = storageEngineWrongConfigured;
 
 	req.reply.send(rep);
 }
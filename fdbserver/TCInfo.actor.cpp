@@ -38,6 +38,7 @@ public:
 				when(ErrorOr<GetStorageMetricsReply> rep = wait(metricsRequest)) {
 					if (rep.present()) {
 						server->metrics = rep;
+						server->updateLoadForecasts();
 						if (server->updated.canBeSet()) {
 							server->updated.send(Void());
 						}
@@ -93,6 +94,13 @@ public:
 			}
 		}
 
+		if (server->metrics.get().storageEngineWrongConfigured != server->storageEngineWrongConfigured.get()) {
+			TraceEvent("StorageEngineWrongConfigured", server->collection->getDistributorId())
+			    .detail("ServerId", server->id.toString())
+			    .detail("WrongConfigured", server->metrics.get().storageEngineWrongConfigured);
+			server->storageEngineWrongConfigured.set(server->metrics.get().storageEngineWrongConfigured);
+		}
+
 		// Detect any storage server with a too long storage queue and notify team tracker
 		// with a minimal interval
 		if (SERVER_KNOBS->ENABLE_REBALANCE_STORAGE_QUEUE) {
@@ -276,6 +284,26 @@ int64_t TCServerInfo::loadBytes() const {
 	return getMetrics().load.bytes;
 }
 
+void LoadForecast::update(double sample, double alpha, double beta) {
+	if (!level.present()) {
+		level = sample;
+		return;
+	}
+	double previous = level.get();
+	level = alpha * sample + (1 - alpha) * (previous + trend);
+	trend = beta * (level.get() - previous) + (1 - beta) * trend;
+}
+
+void TCServerInfo::updateLoadForecasts() {
+	auto const& load = getMetrics().load;
+	double alpha = SERVER_KNOBS->DD_LOAD_FORECAST_ALPHA, beta = SERVER_KNOBS->DD_LOAD_FORECAST_BETA;
+	writeBandwidthForecast.update(load.bytesWrittenPerKSecond, alpha, beta);
+	readOpsForecast.update(load.opsReadPerKSecond, alpha, beta);
+	if (storageStats.present()) {
+		cpuForecast.update(storageStats.get().cpuUsage, alpha, beta);
+	}
+}
+
 int64_t TCServerInfo::getStorageQueueSize() const {
 	return getMetrics().bytesInput - getMetrics().bytesDurable;
 }
@@ -494,6 +522,17 @@ double TCTeamInfo::getAverageCPU() const {
 	return servers.empty() ? 0.0 : sum / servers.size();
 }
 
+double TCTeamInfo::getPredictedUtilization(double avgWriteBandwidth, double avgReadOps) const {
+	double utilization = 0;
+	for (const auto& server : servers) {
+		double sum = server->predictedCpu() / 100.0;
+		sum += avgWriteBandwidth > 0 ? server->predictedWriteBandwidth() / avgWriteBandwidth : 0;
+		sum += avgReadOps > 0 ? server->predictedReadOps() / avgReadOps : 0;
+		utilization = std::max(utilization, sum / 3);
+	}
+	return utilization;
+}
+
 int64_t TCTeamInfo::getMinAvailableSpace(bool includeInFlight) const {
 	int64_t minAvailableSpace = std::numeric_limits<int64_t>::max();
 	for (const auto& server : servers) {
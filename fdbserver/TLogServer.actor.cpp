@@ -33,10 +33,12 @@
 #include "fdbserver/IKeyValueStore.h"
 #include "fdbserver/MutationTracking.h"
 #include "flow/ActorCollection.h"
+#include "flow/CompressionUtils.h"
 #include "fdbrpc/FailureMonitor.h"
 #include "fdbserver/IDiskQueue.h"
 #include "fdbrpc/sim_validation.h"
 #include "fdbrpc/simulator.h"
+#include "fdbrpc/Smoother.h"
 #include "fdbrpc/Stats.h"
 #include "fdbserver/ServerDBInfo.h"
 #include "fdbserver/LogSystem.h"
@@ -327,6 +329,12 @@ struct TLogData : NonCopyable {
 	NotifiedVersion queueCommitEnd;
 	Version queueCommitBegin;
 
+	// For group commit: the smoothed duration of the DiskQueue commits, when the last one finished, and the number of
+	// versions pushed since the last one started
+	Smoother queueCommitDuration;
+	double lastQueueCommitEnd;
+	int64_t queueCommitVersions;
+
 	int64_t instanceID;
 	int64_t bytesInput;
 	int64_t bytesDurable;
@@ -373,6 +381,10 @@ struct TLogData : NonCopyable {
 	// and ends when the data is flushed and durable.
 	Reference<Histogram> timeUntilDurableDist;
 
+	// Distributions of the number of versions and bytes made durable by each DiskQueue commit.
+	Reference<Histogram> queueCommitBatchVersionsDist;
+	Reference<Histogram> queueCommitBatchBytesDist;
+
 	// Controls whether the health monitoring running in this TLog force checking any other processes are degraded.
 	Reference<AsyncVar<bool>> enablePrimaryTxnSystemHealthCheck;
 
@@ -387,7 +399,9 @@ struct TLogData : NonCopyable {
 	  : dbgid(dbgid), workerID(workerID), persistentData(persistentData), rawPersistentQueue(persistentQueue),
 	    persistentQueue(new TLogQueue(persistentQueue, dbgid)), diskQueueCommitBytes(0),
 	    largeDiskQueueCommitBytes(false), dbInfo(dbInfo), queueCommitEnd(0), queueCommitBegin(0),
-	    instanceID(deterministicRandom()->randomUniqueID().first()), bytesInput(0), bytesDurable(0),
+	    queueCommitDuration(SERVER_KNOBS->TLOG_GROUP_COMMIT_SMOOTHING_TIME), lastQueueCommitEnd(0),
+	    queueCommitVersions(0), instanceID(deterministicRandom()->randomUniqueID().first()), bytesInput(0),
+	    bytesDurable(0),
 	    targetVolatileBytes(SERVER_KNOBS->TLOG_SPILL_THRESHOLD), overheadBytesInput(0), overheadBytesDurable(0),
 	    peekMemoryLimiter(SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_PEEK_MEMORY_BYTES),
 	    concurrentLogRouterReads(SERVER_KNOBS->CONCURRENT_LOG_ROUTER_READS), ignorePopDeadline(0), dataFolder(folder),
@@ -395,9 +409,28 @@ struct TLogData : NonCopyable {
 	    commitLatencyDist(Histogram::getHistogram("tLog"_sr, "commit"_sr, Histogram::Unit::milliseconds)),
 	    queueWaitLatencyDist(Histogram::getHistogram("tLog"_sr, "QueueWait"_sr, Histogram::Unit::milliseconds)),
 	    timeUntilDurableDist(Histogram::getHistogram("tLog"_sr, "TimeUntilDurable"_sr, Histogram::Unit::milliseconds)),
+	    queueCommitBatchVersionsDist(
+	        Histogram::getHistogram("tLog"_sr, "QueueCommitBatchVersions"_sr, Histogram::Unit::countLinear)),
+	    queueCommitBatchBytesDist(
+	        Histogram::getHistogram("tLog"_sr, "QueueCommitBatchBytes"_sr, Histogram::Unit::bytes)),
 	    enablePrimaryTxnSystemHealthCheck(enablePrimaryTxnSystemHealthCheck) {
 		cx = openDBOnServer(dbInfo, TaskPriority::DefaultEndpoint, LockAware::True);
 	}
+
+	// How long commitQueue should wait for more versions before starting a DiskQueue commit when none is in flight.
+	// It only waits while commits are following each other closely, so that an idle log commits at once.
+	double groupCommitDelay() const {
+		if (SERVER_KNOBS->TLOG_GROUP_COMMIT_MAX_DELAY <= 0 || queueCommitBegin != queueCommitEnd.get() ||
+		    largeDiskQueueCommitBytes.get()) {
+			return 0;
+		}
+		double duration = queueCommitDuration.smoothTotal();
+		if (now() - lastQueueCommitEnd > duration) {
+			return 0;
+		}
+		return std::min(SERVER_KNOBS->TLOG_GROUP_COMMIT_MAX_DELAY,
+		                SERVER_KNOBS->TLOG_GROUP_COMMIT_LATENCY_FRACTION * duration);
+	}
 };
 
 struct LogData : NonCopyable, public ReferenceCounted<LogData> {
@@ -413,6 +446,14 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 		bool unpoppedRecovered;
 		Tag tag;
 
+		// The batches of spilled references of this tag in persistentData, by the version in their keys, for every
+		// batch with a key version >= spillIndexBegin (see LogData::spillIndexCovers()). Batches written by an
+		// updatePersistentData() wait in spillIndexPending until its commit is durable.
+		std::deque<std::pair<Version, Standalone<StringRef>>> spillIndex;
+		std::vector<std::pair<Version, Standalone<StringRef>>> spillIndexPending;
+		Version spillIndexBegin;
+		int64_t spillIndexBytes;
+
 		TagData(Tag tag,
 		        Version popped,
 		        IDiskQueue::location poppedLocation,
@@ -421,13 +462,15 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 		        bool unpoppedRecovered)
 		  : nothingPersistent(nothingPersistent), poppedRecently(poppedRecently), popped(popped), persistentPopped(0),
 		    versionForPoppedLocation(0), poppedLocation(poppedLocation), unpoppedRecovered(unpoppedRecovered),
-		    tag(tag) {}
+		    tag(tag), spillIndexBegin(0), spillIndexBytes(0) {}
 
 		TagData(TagData&& r) noexcept
 		  : versionMessages(std::move(r.versionMessages)), nothingPersistent(r.nothingPersistent),
 		    poppedRecently(r.poppedRecently), popped(r.popped), persistentPopped(r.persistentPopped),
 		    versionForPoppedLocation(r.versionForPoppedLocation), poppedLocation(r.poppedLocation),
-		    unpoppedRecovered(r.unpoppedRecovered), tag(r.tag) {}
+		    unpoppedRecovered(r.unpoppedRecovered), tag(r.tag), spillIndex(std::move(r.spillIndex)),
+		    spillIndexPending(std::move(r.spillIndexPending)), spillIndexBegin(r.spillIndexBegin),
+		    spillIndexBytes(r.spillIndexBytes) {}
 		void operator=(TagData&& r) noexcept {
 			versionMessages = std::move(r.versionMessages);
 			nothingPersistent = r.nothingPersistent;
@@ -438,6 +481,22 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 			poppedLocation = r.poppedLocation;
 			tag = r.tag;
 			unpoppedRecovered = r.unpoppedRecovered;
+			spillIndex = std::move(r.spillIndex);
+			spillIndexPending = std::move(r.spillIndexPending);
+			spillIndexBegin = r.spillIndexBegin;
+			spillIndexBytes = r.spillIndexBytes;
+		}
+
+		// Drops the batches that a clear of persistentData's spilled references before popped removes
+		void popSpillIndex(Version popped) {
+			while (!spillIndex.empty() && spillIndex.front().first < popped) {
+				spillIndexBytes -= spillIndex.front().second.size();
+				spillIndex.pop_front();
+			}
+			spillIndexPending.erase(std::remove_if(spillIndexPending.begin(),
+			                                       spillIndexPending.end(),
+			                                       [popped](const auto& b) { return b.first < popped; }),
+			                        spillIndexPending.end());
 		}
 
 		// Erase messages not needed to update *from* versions >= before (thus, messages with toversion <= before)
@@ -530,6 +589,77 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	std::deque<UnknownCommittedVersions> unknownCommittedVersions;
 
 	Deque<std::pair<Version, Standalone<VectorRef<uint8_t>>>> messageBlocks;
+
+	// The oldest messageBlocks, once the TLog passes its compression threshold, are replaced by a block holding only
+	// the messages some tag had not popped, compressed in frames (see compressMessageBlock()). The versionMessages
+	// entries for its versions point at the length of their Message, so that expectedSize() keeps working on them,
+	// and getMessage() decompresses their data.
+	struct CompressedMessageBlock {
+		struct Message {
+			uint32_t length; // Must be the first member
+			uint32_t offset; // Within the concatenation of the uncompressed frames
+		};
+		struct Frame {
+			uint32_t offset; // Of the first message in the frame
+			StringRef data;
+		};
+
+		Version version; // The latest version with messages in this block
+		CompressionFilter filter;
+		Arena arena;
+		VectorRef<Message> messages;
+		VectorRef<Frame> frames;
+		int64_t bytes; // Counted in bytesInput until this block is popped
+	};
+	std::deque<CompressedMessageBlock> compressedMessageBlocks;
+	Version compressedVersion; // Messages at versions <= compressedVersion are in compressedMessageBlocks
+
+	// Spill indexes were not kept for batches of spilled references with key versions before this, i.e. those
+	// recovered from persistentData
+	Version spillIndexBegin;
+
+	// Whether tagData->spillIndex holds every batch of spilled references with a key version >= begin
+	bool spillIndexCovers(const Reference<TagData>& tagData, Version begin) const {
+		return SERVER_KNOBS->TLOG_SPILL_INDEX_BYTES_PER_TAG > 0 && tagData &&
+		       begin >= std::max(spillIndexBegin, tagData->spillIndexBegin);
+	}
+	// Recently decompressed frames, keyed by their compressed data
+	std::deque<std::pair<const uint8_t*, Standalone<StringRef>>> decompressedFrames;
+
+	// Returns the data of a versionMessages entry at the given version, valid until the next call.
+	StringRef getMessage(Version version, LengthPrefixedStringRef message) {
+		if (version > compressedVersion) {
+			return message.toStringRef();
+		}
+
+		auto block = std::lower_bound(
+		    compressedMessageBlocks.begin(),
+		    compressedMessageBlocks.end(),
+		    version,
+		    [](const CompressedMessageBlock& b, Version v) -> bool { return b.version < v; });
+		ASSERT(block != compressedMessageBlocks.end());
+		auto const* m = reinterpret_cast<const CompressedMessageBlock::Message*>(message.length);
+		ASSERT(m >= block->messages.begin() && m < block->messages.end());
+		auto byOffset = [](uint32_t offset, const CompressedMessageBlock::Frame& f) -> bool {
+			return offset < f.offset;
+		};
+		auto const* frame = std::upper_bound(block->frames.begin(), block->frames.end(), m->offset, byOffset) - 1;
+
+		auto cached = std::find_if(decompressedFrames.begin(), decompressedFrames.end(), [frame](const auto& f) {
+			return f.first == frame->data.begin();
+		});
+		if (cached == decompressedFrames.end()) {
+			if (decompressedFrames.size() >= SERVER_KNOBS->TLOG_DECOMPRESSED_FRAME_CACHE_SIZE) {
+				decompressedFrames.pop_front();
+			}
+			Standalone<StringRef> data;
+			data.contents() = CompressionUtils::decompress(block->filter, frame->data, data.arena());
+			decompressedFrames.emplace_back(frame->data.begin(), data);
+			cached = decompressedFrames.end() - 1;
+		}
+		return cached->second.substr(m->offset - frame->offset, m->length);
+	}
+
 	std::vector<std::vector<Reference<TagData>>> tag_data; // tag.locality | tag.id
 	int unpoppedRecoveredTagCount;
 	std::set<Tag> unpoppedRecoveredTags;
@@ -572,9 +702,38 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	Counter blockingPeekTimeouts;
 	Counter emptyPeeks;
 	Counter nonEmptyPeeks;
+	Counter cachedPeeks;
 	std::map<Tag, LatencySample> blockingPeekLatencies;
 	std::map<Tag, LatencySample> peekVersionCounts;
 
+	// Peek replies that stopped at DESIRED_TOTAL_BYTES, by tag, begin version and onlySpilled of their request. The
+	// messages at a version never change, so when several log routers or storage servers catch up on the same tag,
+	// the first to peek a range serializes it for all of them.
+	struct CachedPeekReply {
+		Standalone<StringRef> messages;
+		Version end;
+		bool onlySpilled;
+	};
+	typedef std::tuple<Tag, Version, bool> PeekReplyCacheKey;
+	std::map<PeekReplyCacheKey, CachedPeekReply> peekReplyCache;
+	std::deque<PeekReplyCacheKey> peekReplyCacheOrder; // Oldest first
+	int64_t peekReplyCacheBytes = 0;
+
+	void cachePeekReply(const PeekReplyCacheKey& key, const CachedPeekReply& reply) {
+		if (reply.messages.size() > SERVER_KNOBS->TLOG_PEEK_REPLY_CACHE_BYTES ||
+		    !peekReplyCache.emplace(key, reply).second) {
+			return;
+		}
+		peekReplyCacheOrder.push_back(key);
+		peekReplyCacheBytes += reply.messages.size();
+		while (peekReplyCacheBytes > SERVER_KNOBS->TLOG_PEEK_REPLY_CACHE_BYTES) {
+			auto evicted = peekReplyCache.find(peekReplyCacheOrder.front());
+			peekReplyCacheBytes -= evicted->second.messages.size();
+			peekReplyCache.erase(evicted);
+			peekReplyCacheOrder.pop_front();
+		}
+	}
+
 	UID logId;
 	ProtocolVersion protocolVersion;
 	Version newPersistentDataVersion;
@@ -658,10 +817,11 @@ struct LogData : NonCopyable, public ReferenceCounted<LogData> {
 	                 std::string context)
 	  : initialized(false), queueCommittingVersion(0), knownCommittedVersion(0), durableKnownCommittedVersion(0),
 	    minKnownCommittedVersion(0), queuePoppedVersion(0), minPoppedTagVersion(0), minPoppedTag(invalidTag),
-	    unpoppedRecoveredTagCount(0), cc("TLog", interf.id().toString()), bytesInput("BytesInput", cc),
-	    bytesDurable("BytesDurable", cc), blockingPeeks("BlockingPeeks", cc),
-	    blockingPeekTimeouts("BlockingPeekTimeouts", cc), emptyPeeks("EmptyPeeks", cc),
-	    nonEmptyPeeks("NonEmptyPeeks", cc), logId(interf.id()), protocolVersion(protocolVersion),
+	    compressedVersion(invalidVersion), spillIndexBegin(0), unpoppedRecoveredTagCount(0),
+	    cc("TLog", interf.id().toString()), bytesInput("BytesInput", cc), bytesDurable("BytesDurable", cc),
+	    blockingPeeks("BlockingPeeks", cc), blockingPeekTimeouts("BlockingPeekTimeouts", cc),
+	    emptyPeeks("EmptyPeeks", cc), nonEmptyPeeks("NonEmptyPeeks", cc), cachedPeeks("CachedPeeks", cc),
+	    logId(interf.id()), protocolVersion(protocolVersion),
 	    newPersistentDataVersion(invalidVersion), tLogData(tLogData), unrecoveredBefore(1), recoveredAt(1),
 	    recoveryTxnVersion(1), logSystem(new AsyncVar<Reference<ILogSystem>>()), remoteTag(remoteTag),
 	    isPrimary(isPrimary), logRouterTags(logRouterTags), logRouterPoppedVersion(0), logRouterPopToVersion(0),
@@ -885,6 +1045,7 @@ void updatePersistentPopped(TLogData* self, Reference<LogData> logData, Referenc
 	} else {
 		self->persistentData->clear(KeyRangeRef(persistTagMessageRefsKey(logData->logId, data->tag, Version(0)),
 		                                        persistTagMessageRefsKey(logData->logId, data->tag, data->popped)));
+		data->popSpillIndex(data->popped);
 	}
 
 	if (data->popped > logData->persistentDataVersion) {
@@ -905,18 +1066,32 @@ ACTOR Future<Void> updatePoppedLocation(TLogData* self, Reference<LogData> logDa
 	// Use persistentPopped and not popped, so that a pop update received after spilling doesn't cause
 	// us to remove data that still is pointed to by SpilledData in the btree.
 	if (data->persistentPopped <= logData->persistentDataVersion) {
-		// Recover the next needed location in the Disk Queue from the index.
-		RangeResult kvrefs = wait(self->persistentData->readRange(
-		    KeyRangeRef(persistTagMessageRefsKey(logData->logId, data->tag, data->persistentPopped),
-		                persistTagMessageRefsKey(logData->logId, data->tag, logData->persistentDataVersion + 1)),
-		    1));
+		// Recover the next needed location in the Disk Queue from the index. Batches still waiting for their commit
+		// are newer than any in the spill index, so only when it has none at or after persistentPopped does this need
+		// to read persistentData.
+		state Standalone<StringRef> refs;
+		auto batch = std::lower_bound(data->spillIndex.begin(),
+		                              data->spillIndex.end(),
+		                              std::make_pair(data->persistentPopped, Standalone<StringRef>()),
+		                              [](const auto& l, const auto& r) -> bool { return l.first < r.first; });
+		if (logData->spillIndexCovers(data, data->persistentPopped) && batch != data->spillIndex.end()) {
+			refs = batch->second;
+		} else {
+			RangeResult kvrefs = wait(self->persistentData->readRange(
+			    KeyRangeRef(persistTagMessageRefsKey(logData->logId, data->tag, data->persistentPopped),
+			                persistTagMessageRefsKey(logData->logId, data->tag, logData->persistentDataVersion + 1)),
+			    1));
+			if (!kvrefs.empty()) {
+				refs = Standalone<StringRef>(kvrefs[0].value, kvrefs.arena());
+			}
+		}
 
-		if (kvrefs.empty()) {
+		if (refs.empty()) {
 			// Nothing was persistent after all.
 			data->nothingPersistent = true;
 		} else {
 			VectorRef<SpilledData> spilledData;
-			BinaryReader r(kvrefs[0].value, AssumeVersion(logData->protocolVersion));
+			BinaryReader r(refs, AssumeVersion(logData->protocolVersion));
 			r >> spilledData;
 
 			for (const SpilledData& sd : spilledData) {
@@ -1045,7 +1220,7 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 					if (logData->shouldSpillByValue(tagData->tag)) {
 						wr = BinaryWriter(Unversioned());
 						for (; msg != tagData->versionMessages.end() && msg->first == currentVersion; ++msg) {
-							wr << msg->second.toStringRef();
+							wr << logData->getMessage(currentVersion, msg->second);
 						}
 						self->persistentData->set(KeyValueRef(
 						    persistTagMessagesKey(logData->logId, tagData->tag, currentVersion), wr.toValue()));
@@ -1072,8 +1247,12 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 						if ((wr.getLength() + sizeof(SpilledData) >
 						     SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BYTES_PER_BATCH)) {
 							*(uint32_t*)wr.getData() = refSpilledTagCount;
-							self->persistentData->set(KeyValueRef(
-							    persistTagMessageRefsKey(logData->logId, tagData->tag, lastVersion), wr.toValue()));
+							Standalone<StringRef> refs = wr.toValue();
+							self->persistentData->set(
+							    KeyValueRef(persistTagMessageRefsKey(logData->logId, tagData->tag, lastVersion), refs));
+							if (SERVER_KNOBS->TLOG_SPILL_INDEX_BYTES_PER_TAG > 0) {
+								tagData->spillIndexPending.emplace_back(lastVersion, refs);
+							}
 							tagData->poppedLocation = std::min(tagData->poppedLocation, firstLocation);
 							refSpilledTagCount = 0;
 							wr = BinaryWriter(AssumeVersion(logData->protocolVersion));
@@ -1093,8 +1272,12 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 				}
 				if (refSpilledTagCount > 0) {
 					*(uint32_t*)wr.getData() = refSpilledTagCount;
+					Standalone<StringRef> refs = wr.toValue();
 					self->persistentData->set(
-					    KeyValueRef(persistTagMessageRefsKey(logData->logId, tagData->tag, lastVersion), wr.toValue()));
+					    KeyValueRef(persistTagMessageRefsKey(logData->logId, tagData->tag, lastVersion), refs));
+					if (SERVER_KNOBS->TLOG_SPILL_INDEX_BYTES_PER_TAG > 0) {
+						tagData->spillIndexPending.emplace_back(lastVersion, refs);
+					}
 					tagData->poppedLocation = std::min(tagData->poppedLocation, firstLocation);
 				}
 
@@ -1135,6 +1318,25 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 
 	CODE_PROBE(anyData, "TLog moved data to persistentData");
 	logData->persistentDataDurableVersion = newPersistentDataVersion;
+	for (const auto& tags : logData->tag_data) {
+		for (const auto& tagData : tags) {
+			if (!tagData || tagData->spillIndexPending.empty()) {
+				continue;
+			}
+			for (auto& batch : tagData->spillIndexPending) {
+				tagData->spillIndexBytes += batch.second.size();
+				tagData->spillIndex.push_back(std::move(batch));
+			}
+			tagData->spillIndexPending.clear();
+			// Peeks from before what is kept fall back to reading persistentData
+			while (tagData->spillIndexBytes > SERVER_KNOBS->TLOG_SPILL_INDEX_BYTES_PER_TAG) {
+				CODE_PROBE(true, "TLog spill index trimmed");
+				tagData->spillIndexBegin = tagData->spillIndex.front().first + 1;
+				tagData->spillIndexBytes -= tagData->spillIndex.front().second.size();
+				tagData->spillIndex.pop_front();
+			}
+		}
+	}
 	for (tagLocality = 0; tagLocality < logData->tag_data.size(); tagLocality++) {
 		for (tagId = 0; tagId < logData->tag_data[tagLocality].size(); tagId++) {
 			if (logData->tag_data[tagLocality][tagId]) {
@@ -1150,6 +1352,16 @@ ACTOR Future<Void> updatePersistentData(TLogData* self, Reference<LogData> logDa
 
 	wait(yield(TaskPriority::UpdateStorage));
 
+	while (!logData->compressedMessageBlocks.empty() &&
+	       logData->compressedMessageBlocks.front().version <= newPersistentDataVersion) {
+		int64_t bytesErased = logData->compressedMessageBlocks.front().bytes;
+		logData->bytesDurable += bytesErased;
+		self->bytesDurable += bytesErased;
+		logData->compressedMessageBlocks.pop_front();
+		// The cache is keyed by addresses that may now be reused
+		logData->decompressedFrames.clear();
+	}
+
 	while (!logData->messageBlocks.empty() && logData->messageBlocks.front().first <= newPersistentDataVersion) {
 		int64_t bytesErased =
 		    int64_t(logData->messageBlocks.front().second.size()) * SERVER_KNOBS->TLOG_MESSAGE_BLOCK_OVERHEAD_FACTOR;
@@ -1496,6 +1708,162 @@ ACTOR Future<Void> updateStorageLoop(TLogData* self) {
 	}
 }
 
+// Replaces the oldest run of logData->messageBlocks that ends at a version boundary, not counting the block commits are
+// still appending to, with a CompressedMessageBlock holding just the messages that some tag has not popped yet.
+// Returns false if there is no such run. The caller holds persistentDataCommitLock, so that the run is not popped
+// and updatePersistentData() is not walking versionMessages while their entries are redirected.
+ACTOR Future<bool> compressMessageBlock(TLogData* self, Reference<LogData> logData, CompressionFilter filter) {
+	state int blocks = 0; // The run is messageBlocks[0, blocks)
+	state Version firstVersion;
+	state LogData::CompressedMessageBlock compressed;
+	state std::vector<const uint32_t*> messages;
+	state std::string frame;
+	state uint32_t offset = 0;
+	state int i = 0;
+
+	loop {
+		// Blocks are appended to in place and share an arena until it is full, so only whole arenas can be freed
+		if (blocks == logData->messageBlocks.size()) {
+			return false;
+		}
+		const Arena& arena = logData->messageBlocks[blocks].second.arena();
+		int end = blocks;
+		while (end < logData->messageBlocks.size() && logData->messageBlocks[end].second.arena().sameArena(arena)) {
+			++end;
+		}
+		if (end == logData->messageBlocks.size()) {
+			return false;
+		}
+		blocks = end;
+		if (logData->messageBlocks[blocks - 1].first < logData->messageBlocks[blocks].first) {
+			break;
+		}
+	}
+
+	firstVersion = logData->messageBlocks[0].first;
+	compressed.version = logData->messageBlocks[blocks - 1].first;
+	compressed.filter = filter;
+	for (const auto& tags : logData->tag_data) {
+		for (const auto& tagData : tags) {
+			if (!tagData) {
+				continue;
+			}
+			auto it = std::lower_bound(tagData->versionMessages.begin(),
+			                           tagData->versionMessages.end(),
+			                           std::make_pair(firstVersion, LengthPrefixedStringRef()),
+			                           [](const auto& l, const auto& r) -> bool { return l.first < r.first; });
+			for (; it != tagData->versionMessages.end() && it->first <= compressed.version; ++it) {
+				messages.push_back(it->second.length);
+			}
+		}
+	}
+	// Messages with several tags are only kept once. Sorting by address also keeps them in commit order.
+	std::sort(messages.begin(), messages.end());
+	messages.erase(std::unique(messages.begin(), messages.end()), messages.end());
+
+	compressed.messages.resize(compressed.arena, messages.size());
+	for (i = 0; i < messages.size(); i++) {
+		compressed.messages[i].length = *messages[i];
+		compressed.messages[i].offset = offset;
+		frame.append(reinterpret_cast<const char*>(messages[i] + 1), *messages[i]);
+		offset += *messages[i];
+		if (frame.size() >= SERVER_KNOBS->TLOG_COMPRESSION_FRAME_BYTES || i + 1 == messages.size()) {
+			compressed.frames.push_back(
+			    compressed.arena,
+			    LogData::CompressedMessageBlock::Frame{
+			        static_cast<uint32_t>(offset - frame.size()),
+			        CompressionUtils::compress(filter, StringRef(frame), compressed.arena) });
+			frame.clear();
+			wait(yield(TaskPriority::UpdateStorage));
+		}
+	}
+
+	// Entries may have been popped, but not added, while compressing
+	for (const auto& tags : logData->tag_data) {
+		for (const auto& tagData : tags) {
+			if (!tagData) {
+				continue;
+			}
+			auto it = std::lower_bound(tagData->versionMessages.begin(),
+			                           tagData->versionMessages.end(),
+			                           std::make_pair(firstVersion, LengthPrefixedStringRef()),
+			                           [](const auto& l, const auto& r) -> bool { return l.first < r.first; });
+			for (; it != tagData->versionMessages.end() && it->first <= compressed.version; ++it) {
+				auto m = std::lower_bound(messages.begin(), messages.end(), it->second.length);
+				ASSERT(m != messages.end() && *m == it->second.length);
+				it->second = LengthPrefixedStringRef(&compressed.messages[m - messages.begin()].length);
+			}
+		}
+	}
+
+	int64_t bytes = 0;
+	for (i = 0; i < blocks; i++) {
+		bytes += int64_t(int64_t(logData->messageBlocks.front().second.size()) *
+		                 SERVER_KNOBS->TLOG_MESSAGE_BLOCK_OVERHEAD_FACTOR);
+		logData->messageBlocks.pop_front();
+	}
+	compressed.bytes = std::min<int64_t>(bytes, compressed.arena.getSize());
+	logData->bytesDurable += bytes - compressed.bytes;
+	self->bytesDurable += bytes - compressed.bytes;
+
+	CODE_PROBE(true, "TLog compressed message blocks");
+	TraceEvent("TLogCompressedMessageBlocks", logData->logId)
+	    .suppressFor(1.0)
+	    .detail("BeginVersion", firstVersion)
+	    .detail("EndVersion", compressed.version)
+	    .detail("Messages", messages.size())
+	    .detail("Frames", compressed.frames.size())
+	    .detail("Bytes", bytes)
+	    .detail("CompressedBytes", compressed.bytes);
+
+	logData->compressedVersion = compressed.version;
+	logData->compressedMessageBlocks.push_back(std::move(compressed));
+	return true;
+}
+
+// Compresses the oldest message blocks, oldest generation first, while the TLog's volatile bytes are above
+// TLOG_COMPRESSION_SPILL_THRESHOLD_FRACTION of its spill threshold.
+ACTOR Future<Void> compressMessageBlocksLoop(TLogData* self) {
+	state CompressionFilter filter = CompressionUtils::fromFilterString(SERVER_KNOBS->TLOG_COMPRESSION_FILTER);
+	state std::vector<Reference<LogData>> logs;
+	state FlowLock::Releaser commitLockReleaser;
+	state bool compressed = false;
+	state int i = 0;
+
+	if (!CompressionUtils::supportedFilters.count(filter)) {
+		TraceEvent(SevWarnAlways, "TLogCompressionFilterNotSupported", self->dbgid)
+		    .detail("Filter", SERVER_KNOBS->TLOG_COMPRESSION_FILTER);
+		filter = CompressionFilter::NONE;
+	}
+
+	loop {
+		wait(delay(BUGGIFY ? SERVER_KNOBS->BUGGIFY_TLOG_STORAGE_MIN_UPDATE_INTERVAL
+		                   : SERVER_KNOBS->TLOG_STORAGE_MIN_UPDATE_INTERVAL,
+		           TaskPriority::UpdateStorage));
+
+		logs.clear();
+		for (int j = 0; j < self->spillOrder.size(); j++) {
+			auto it = self->id_data.find(self->spillOrder[j]);
+			if (it != self->id_data.end()) {
+				logs.push_back(it->second);
+			}
+		}
+
+		for (i = 0; i < logs.size(); i++) {
+			while (self->bytesInput - self->bytesDurable >=
+			       self->targetVolatileBytes * SERVER_KNOBS->TLOG_COMPRESSION_SPILL_THRESHOLD_FRACTION) {
+				wait(self->persistentDataCommitLock.take(TaskPriority::UpdateStorage));
+				commitLockReleaser = FlowLock::Releaser(self->persistentDataCommitLock);
+				wait(store(compressed, compressMessageBlock(self, logs[i], filter)));
+				commitLockReleaser.release();
+				if (!compressed) {
+					break;
+				}
+			}
+		}
+	}
+}
+
 void commitMessages(TLogData* self,
                     Reference<LogData> logData,
                     Version version,
@@ -1694,7 +2062,7 @@ void peekMessagesFromMemory(Reference<LogData> self,
 		// We need the 4 byte length prefix to be a TagsAndMessage format, but that prefix is added as part of StringRef
 		// serialization.
 		int offset = messages.getLength();
-		messages << it->second.toStringRef();
+		messages << self->getMessage(it->first, it->second);
 		void* data = messages.getData();
 		DEBUG_TAGS_AND_MESSAGE(
 		    "TLogPeek", currentVersion, StringRef((uint8_t*)data + offset, messages.getLength() - offset), self->logId)
@@ -1741,6 +2109,16 @@ ACTOR Future<std::vector<StringRef>> parseMessagesForTag(StringRef commitBlob, T
 	return relevantMessages;
 }
 
+// Compresses the messages of a reply whose peer asked for them compressed, i.e. a log router in another region
+void compressPeekReply(TLogPeekReply& reply, CompressionFilter filter) {
+	if (filter == CompressionFilter::NONE || !reply.messages.size() ||
+	    !CompressionUtils::supportedFilters.count(filter)) {
+		return;
+	}
+	reply.messages = CompressionUtils::compress(filter, reply.messages, reply.arena);
+	reply.compressionFilter = filter;
+}
+
 // Common logics to peek TLog and create TLogPeekReply that serves both streaming peek or normal peek request
 ACTOR template <typename PromiseType>
 Future<Void> tLogPeekMessages(PromiseType replyPromise,
@@ -1750,7 +2128,8 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
                               Tag reqTag,
                               bool reqReturnIfBlocked = false,
                               bool reqOnlySpilled = false,
-                              Optional<std::pair<UID, int>> reqSequence = Optional<std::pair<UID, int>>()) {
+                              Optional<std::pair<UID, int>> reqSequence = Optional<std::pair<UID, int>>(),
+                              CompressionFilter reqCompressionFilter = CompressionFilter::NONE) {
 	state BinaryWriter messages(Unversioned());
 	state BinaryWriter messages2(Unversioned());
 	state int sequence = -1;
@@ -1882,6 +2261,7 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 	state Version poppedVer;
 	state Version endVersion;
 	state bool onlySpilled;
+	state Optional<Standalone<StringRef>> cachedMessages;
 
 	// Run the peek logic in a loop to account for the case where there is no data to return to the caller, and we may
 	// want to wait a little bit instead of just sending back an empty message. This feature is controlled by a knob.
@@ -1957,6 +2337,17 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 		endVersion = logData->version.get() + 1;
 		onlySpilled = false;
 
+		if (SERVER_KNOBS->TLOG_PEEK_REPLY_CACHE_BYTES > 0 && !clusterRecoveryVersion.present()) {
+			auto cached = logData->peekReplyCache.find(std::make_tuple(reqTag, reqBegin, reqOnlySpilled));
+			if (cached != logData->peekReplyCache.end()) {
+				cachedMessages = cached->second.messages;
+				endVersion = cached->second.end;
+				onlySpilled = cached->second.onlySpilled;
+				++logData->cachedPeeks;
+				break;
+			}
+		}
+
 		// grab messages from disk
 		DebugLogTraceEvent("TLogPeekMessages3", self->dbgid)
 		    .detail("ReqBegin", reqBegin)
@@ -1996,11 +2387,30 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 				}
 			} else {
 				// FIXME: Limit to approximately DESIRED_TOTATL_BYTES somehow.
-				RangeResult kvrefs = wait(self->persistentData->readRange(
-				    KeyRangeRef(
-				        persistTagMessageRefsKey(logData->logId, reqTag, reqBegin),
-				        persistTagMessageRefsKey(logData->logId, reqTag, logData->persistentDataDurableVersion + 1)),
-				    SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1));
+				state std::vector<Standalone<StringRef>> kvrefs;
+				if (logData->spillIndexCovers(logData->getTagData(reqTag), reqBegin)) {
+					// Every batch in the spill index is durable, i.e. has a key version <= persistentDataDurableVersion
+					auto tagData = logData->getTagData(reqTag);
+					auto batch = std::lower_bound(
+					    tagData->spillIndex.begin(),
+					    tagData->spillIndex.end(),
+					    std::make_pair(reqBegin, Standalone<StringRef>()),
+					    [](const auto& l, const auto& r) -> bool { return l.first < r.first; });
+					for (; batch != tagData->spillIndex.end() &&
+					       kvrefs.size() < SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1;
+					     ++batch) {
+						kvrefs.push_back(batch->second);
+					}
+				} else {
+					RangeResult kvs = wait(self->persistentData->readRange(
+					    KeyRangeRef(persistTagMessageRefsKey(logData->logId, reqTag, reqBegin),
+					                persistTagMessageRefsKey(
+					                    logData->logId, reqTag, logData->persistentDataDurableVersion + 1)),
+					    SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK + 1));
+					for (const auto& kv : kvs) {
+						kvrefs.emplace_back(kv.value, kvs.arena());
+					}
+				}
 
 				//TraceEvent("TLogPeekResults", self->dbgid).detail("ForAddress", replyPromise.getEndpoint().getPrimaryAddress()).detail("Tag1Results", s1).detail("Tag2Results", s2).detail("Tag1ResultsLim", kv1.size()).detail("Tag2ResultsLim", kv2.size()).detail("Tag1ResultsLast", kv1.size() ? kv1[0].key : "").detail("Tag2ResultsLast", kv2.size() ? kv2[0].key : "").detail("Limited", limited).detail("NextEpoch", next_pos.epoch).detail("NextSeq", next_pos.sequence).detail("NowEpoch", self->epoch()).detail("NowSeq", self->sequence.getNextSequence());
 
@@ -2010,9 +2420,8 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 				state uint64_t commitBytes = 0;
 				state Version firstVersion = std::numeric_limits<Version>::max();
 				for (int i = 0; i < kvrefs.size() && i < SERVER_KNOBS->TLOG_SPILL_REFERENCE_MAX_BATCHES_PER_PEEK; i++) {
-					auto& kv = kvrefs[i];
 					VectorRef<SpilledData> spilledData;
-					BinaryReader r(kv.value, AssumeVersion(logData->protocolVersion));
+					BinaryReader r(kvrefs[i], AssumeVersion(logData->protocolVersion));
 					r >> spilledData;
 					for (const SpilledData& sd : spilledData) {
 						if (mutationBytes >= SERVER_KNOBS->DESIRED_TOTAL_BYTES) {
@@ -2117,12 +2526,20 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 	TLogPeekReply reply;
 	reply.maxKnownVersion = logData->version.get();
 	reply.minKnownCommittedVersion = logData->minKnownCommittedVersion;
-	auto messagesValue = messages.toValue();
+	auto messagesValue = cachedMessages.present() ? cachedMessages.get() : messages.toValue();
 	reply.arena.dependsOn(messagesValue.arena());
 	reply.messages = messagesValue;
 	reply.end = clusterRecoveryVersion.present() ? clusterRecoveryVersion.get() : endVersion;
 	reply.onlySpilled = onlySpilled;
 
+	// Only replies that were cut short are cached, as the next peek of a shorter one may well find more data
+	if (SERVER_KNOBS->TLOG_PEEK_REPLY_CACHE_BYTES > 0 && !cachedMessages.present() &&
+	    !clusterRecoveryVersion.present() &&
+	    (onlySpilled || messagesValue.size() >= SERVER_KNOBS->DESIRED_TOTAL_BYTES)) {
+		logData->cachePeekReply(std::make_tuple(reqTag, reqBegin, reqOnlySpilled),
+		                        LogData::CachedPeekReply{ messagesValue, endVersion, onlySpilled });
+	}
+
 	DebugLogTraceEvent("TLogPeekMessages4", self->dbgid)
 	    .detail("LogId", logData->logId)
 	    .detail("Tag", reqTag.toString())
@@ -2177,10 +2594,47 @@ Future<Void> tLogPeekMessages(PromiseType replyPromise,
 		reply.begin = reqBegin;
 	}
 
+	compressPeekReply(reply, reqCompressionFilter);
 	replyPromise.send(reply);
 	return Void();
 }
 
+// Appends the peeks that follow reply to it while the tag has more data, until it holds TLOG_PEEK_STREAM_REPLY_BYTES or
+// has been collected for TLOG_PEEK_STREAM_REPLY_TIME. A cursor that is far behind then catches up at the rate the log
+// can be read, rather than at one DESIRED_TOTAL_BYTES reply per stream round trip.
+ACTOR Future<Void> extendPeekStreamReply(TLogData* self, Reference<LogData> logData, Tag tag, TLogPeekReply* reply) {
+	state double start = now();
+	state BinaryWriter messages(Unversioned());
+	state Promise<TLogPeekReply> promise;
+	state TLogPeekReply next;
+
+	while (!reply->popped.present() && reply->end <= logData->version.get() &&
+	       reply->messages.size() + messages.getLength() < SERVER_KNOBS->TLOG_PEEK_STREAM_REPLY_BYTES &&
+	       now() - start < SERVER_KNOBS->TLOG_PEEK_STREAM_REPLY_TIME) {
+		promise = Promise<TLogPeekReply>();
+		wait(store(next, promise.getFuture()) &&
+		     tLogPeekMessages(promise, self, logData, reply->end, tag, true, reply->onlySpilled));
+		if (next.popped.present() || next.end <= reply->end) {
+			break;
+		}
+		if (!messages.getLength()) {
+			messages.serializeBytes(reply->messages);
+		}
+		messages.serializeBytes(next.messages);
+		reply->end = next.end;
+		reply->onlySpilled = next.onlySpilled;
+		reply->maxKnownVersion = next.maxKnownVersion;
+		reply->minKnownCommittedVersion = next.minKnownCommittedVersion;
+	}
+
+	if (messages.getLength()) {
+		Standalone<StringRef> batched = messages.toValue();
+		reply->arena.dependsOn(batched.arena());
+		reply->messages = batched;
+	}
+	return Void();
+}
+
 // This actor keep pushing TLogPeekStreamReply until it's removed from the cluster or should recover
 ACTOR Future<Void> tLogPeekStream(TLogData* self, TLogPeekStreamRequest req, Reference<LogData> logData) {
 	self->activePeekStreams++;
@@ -2195,6 +2649,10 @@ ACTOR Future<Void> tLogPeekStream(TLogData* self, TLogPeekStreamRequest req, Ref
 		try {
 			wait(req.reply.onReady() && store(reply.rep, future) &&
 			     tLogPeekMessages(promise, self, logData, begin, req.tag, req.returnIfBlocked, onlySpilled));
+			if (reply.rep.messages.size() >= SERVER_KNOBS->DESIRED_TOTAL_BYTES || reply.rep.onlySpilled) {
+				wait(extendPeekStreamReply(self, logData, req.tag, &reply.rep));
+			}
+			compressPeekReply(reply.rep, req.compressionFilter);
 
 			reply.rep.begin = begin;
 			req.reply.send(reply);
@@ -2233,12 +2691,18 @@ ACTOR Future<Void> doQueueCommit(TLogData* self,
 	logData->queueCommittingVersion = ver;
 
 	g_network->setCurrentTask(TaskPriority::TLogCommitReply);
+	state double commitStart = now();
 	Future<Void> c = self->persistentQueue->commit();
+	self->queueCommitBatchVersionsDist->sample(self->queueCommitVersions);
+	self->queueCommitBatchBytesDist->sample(self->diskQueueCommitBytes);
+	self->queueCommitVersions = 0;
 	self->diskQueueCommitBytes = 0;
 	self->largeDiskQueueCommitBytes.set(false);
 
 	wait(ioDegradedOrTimeoutError(
 	    c, SERVER_KNOBS->MAX_STORAGE_COMMIT_TIME, self->degraded, SERVER_KNOBS->TLOG_DEGRADED_DURATION, "TLogCommit"));
+	self->queueCommitDuration.setTotal(now() - commitStart);
+	self->lastQueueCommitEnd = now();
 	if (g_network->isSimulated() && !g_simulator->speedUpSimulation && BUGGIFY_WITH_PROB(0.0001)) {
 		wait(delay(6.0));
 	}
@@ -2288,6 +2752,7 @@ ACTOR Future<Void> doQueueCommit(TLogData* self,
 ACTOR Future<Void> commitQueue(TLogData* self) {
 	state Reference<LogData> logData;
 	state std::vector<Reference<LogData>> missingFinalCommit;
+	state double groupCommitDelay = 0;
 
 	loop {
 		int foundCount = 0;
@@ -2336,11 +2801,18 @@ ACTOR Future<Void> commitQueue(TLogData* self) {
 			choose {
 				when(wait(logData->version.whenAtLeast(
 				    std::max(logData->queueCommittingVersion, logData->queueCommittedVersion.get()) + 1))) {
+					// Versions arriving while a commit is in flight already share the next one, so only a commit
+					// which would start right away for the versions so far is delayed
+					groupCommitDelay = self->groupCommitDelay();
 					while (self->queueCommitBegin != self->queueCommitEnd.get() &&
 					       !self->largeDiskQueueCommitBytes.get()) {
 						wait(self->queueCommitEnd.whenAtLeast(self->queueCommitBegin) ||
 						     self->largeDiskQueueCommitBytes.onChange());
 					}
+					if (groupCommitDelay > 0) {
+						wait(delay(groupCommitDelay, TaskPriority::TLogCommit) ||
+						     self->largeDiskQueueCommitBytes.onChange());
+					}
 					if (logData->queueCommittedVersion.get() == std::numeric_limits<Version>::max()) {
 						break;
 					}
@@ -2414,6 +2886,7 @@ ACTOR Future<Void> tLogCommit(TLogData* self,
 		self->persistentQueue->push(qe, logData);
 
 		self->diskQueueCommitBytes += qe.expectedSize();
+		++self->queueCommitVersions;
 		if (self->diskQueueCommitBytes > SERVER_KNOBS->MAX_QUEUE_COMMIT_BYTES) {
 			self->largeDiskQueueCommitBytes.set(true);
 		}
@@ -2820,8 +3293,15 @@ ACTOR Future<Void> serveTLogInterface(TLogData* self,
 			logData->addActor.send(tLogPeekStream(self, req, logData));
 		}
 		when(TLogPeekRequest req = waitNext(tli.peekMessages.getFuture())) {
-			logData->addActor.send(tLogPeekMessages(
-			    req.reply, self, logData, req.begin, req.tag, req.returnIfBlocked, req.onlySpilled, req.sequence));
+			logData->addActor.send(tLogPeekMessages(req.reply,
+			                                        self,
+			                                        logData,
+			                                        req.begin,
+			                                        req.tag,
+			                                        req.returnIfBlocked,
+			                                        req.onlySpilled,
+			                                        req.sequence,
+			                                        req.compressionFilter));
 		}
 		when(TLogPopRequest req = waitNext(tli.popMessages.getFuture())) {
 			logData->addActor.send(tLogPop(self, req, logData));
@@ -3000,6 +3480,7 @@ ACTOR Future<Void> pullAsyncData(TLogData* self,
 					self->persistentQueue->push(qe, logData);
 
 					self->diskQueueCommitBytes += qe.expectedSize();
+					++self->queueCommitVersions;
 					if (self->diskQueueCommitBytes > SERVER_KNOBS->MAX_QUEUE_COMMIT_BYTES) {
 						self->largeDiskQueueCommitBytes.set(true);
 					}
@@ -3039,6 +3520,7 @@ ACTOR Future<Void> pullAsyncData(TLogData* self,
 						self->persistentQueue->push(qe, logData);
 
 						self->diskQueueCommitBytes += qe.expectedSize();
+						++self->queueCommitVersions;
 						if (self->diskQueueCommitBytes > SERVER_KNOBS->MAX_QUEUE_COMMIT_BYTES) {
 							self->largeDiskQueueCommitBytes.set(true);
 						}
@@ -3328,6 +3810,7 @@ ACTOR Future<Void> restorePersistentState(TLogData* self,
 		Version ver = BinaryReader::fromStringRef<Version>(fVers.get()[idx].value, Unversioned());
 		logData->persistentDataVersion = ver;
 		logData->persistentDataDurableVersion = ver;
+		logData->spillIndexBegin = ver + 1;
 		logData->version.set(ver);
 		logData->recoveryCount =
 		    BinaryReader::fromStringRef<DBRecoveryCount>(fRecoverCounts.get()[idx].value, Unversioned());
@@ -3688,6 +4171,7 @@ ACTOR Future<Void> tLogStart(TLogData* self, InitializeTLogRequest req, Locality
 				self->persistentQueue->push(qe, logData);
 
 				self->diskQueueCommitBytes += qe.expectedSize();
+				++self->queueCommitVersions;
 				if (self->diskQueueCommitBytes > SERVER_KNOBS->MAX_QUEUE_COMMIT_BYTES) {
 					self->largeDiskQueueCommitBytes.set(true);
 				}
@@ -3796,6 +4280,9 @@ ACTOR Future<Void> tLog(IKeyValueStore* persistentData,
 
 		self.sharedActors.send(commitQueue(&self));
 		self.sharedActors.send(updateStorageLoop(&self));
+		if (SERVER_KNOBS->TLOG_COMPRESS_MESSAGE_BLOCKS) {
+			self.sharedActors.send(compressMessageBlocksLoop(&self));
+		}
 		self.sharedActors.send(checkUpdateEncryptionAtRestMode(&self));
 		self.sharedActors.send(traceRole(Role::SHARED_TRANSACTION_LOG, tlogId));
 		state Future<Void> activeSharedChange = Void();
@@ -3919,3 +4406,33 @@ TEST_CASE("Lfdbserver/tlogserver/VersionMessagesOverheadFactor") {
 
 	return Void();
 }
+
+TEST_CASE("/fdbserver/tlogserver/CommitRequestMessageSegments") {
+	Arena arena;
+	std::string expected;
+	VectorRef<StringRef> segments;
+	int segmentCount = deterministicRandom()->randomInt(0, 10);
+	for (int i = 0; i < segmentCount; ++i) {
+		StringRef segment =
+		    StringRef(arena, deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 100)));
+		segments.push_back(arena, segment);
+		expected += segment.toString();
+	}
+
+	std::vector<uint16_t> tLogLocIds;
+	TLogCommitRequest request(SpanContext(), arena, 1, 2, 0, 0, 1, StringRef(), 1, tLogLocIds, Optional<UID>());
+	request.messageSegments = segments;
+
+	// The segments are sent as if they were one string, and arrive as one
+	Value serialized = ObjectWriter::toValue(request, Unversioned());
+	TLogCommitRequest received = ObjectReader::fromStringRef<TLogCommitRequest>(serialized, Unversioned());
+	ASSERT(received.messages == StringRef(expected));
+	ASSERT(received.messageSegments.empty());
+	ASSERT(received.version == 2);
+
+	request.flattenMessageSegments();
+	ASSERT(request.messages == StringRef(expected));
+	ASSERT(request.messageSegments.empty());
+
+	return Void();
+}
@@ -632,8 +632,7 @@ Future<Version> TagPartitionedLogSystem::push(const ILogSystem::PushVersionSet&
 
 		std::vector<Future<Void>> tLogCommitResults;
 		for (size_t loc = 0; loc < it->logServers.size(); loc++) {
-			Standalone<StringRef> msg = data.getMessages(location);
-			data.recordEmptyMessage(location, msg);
+			data.recordEmptyMessage(location);
 			if (SERVER_KNOBS->ENABLE_VERSION_VECTOR_TLOG_UNICAST) {
 				if (tpcvMap.get().contains(location)) {
 					prevVersion = tpcvMap.get()[location];
@@ -644,17 +643,24 @@ Future<Version> TagPartitionedLogSystem::push(const ILogSystem::PushVersionSet&
 			}
 
 			const auto& interface = it->logServers[loc]->get().interf();
-			const auto request = TLogCommitRequest(spanContext,
-			                                       msg.arena(),
-			                                       prevVersion,
-			                                       versionSet.version,
-			                                       versionSet.knownCommittedVersion,
-			                                       versionSet.minKnownCommittedVersion,
-			                                       seqPrevVersion,
-			                                       msg,
-			                                       tLogCount[logGroupLocal],
-			                                       tLogLocIds[logGroupLocal],
-			                                       debugID);
+			Standalone<VectorRef<StringRef>> msg = data.getMessageSegments(location);
+			auto request = TLogCommitRequest(spanContext,
+			                                 msg.arena(),
+			                                 prevVersion,
+			                                 versionSet.version,
+			                                 versionSet.knownCommittedVersion,
+			                                 versionSet.minKnownCommittedVersion,
+			                                 seqPrevVersion,
+			                                 StringRef(),
+			                                 tLogCount[logGroupLocal],
+			                                 tLogLocIds[logGroupLocal],
+			                                 debugID);
+			// The transport gathers the segments straight into its packet buffers; a tlog in this process is handed
+			// the request as is and needs them in one piece.
+			request.messageSegments = msg;
+			if (!interface.commit.isRemoteEndpoint()) {
+				request.flattenMessageSegments();
+			}
 			auto tLogReply = recordPushMetrics(it->connectionResetTrackers[loc],
 			                                   it->tlogPushDistTrackers[loc],
 			                                   interface.address(),
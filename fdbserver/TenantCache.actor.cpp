@@ -79,6 +79,8 @@ public:
 		state Transaction tr(tenantCache->dbcx());
 
 		state double lastTenantListFetchTime = now();
+		// The last modification of the tenant map that the cache reflects
+		state Optional<Versionstamp> lastModification;
 
 		loop {
 			try {
@@ -87,6 +89,19 @@ public:
 					    .detail("RefreshTime", now() - lastTenantListFetchTime);
 				}
 
+				// Every change to the tenant map also sets lastTenantModification, so when it hasn't moved there is no
+				// need to read the whole map again
+				tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::READ_LOCK_AWARE);
+				state Optional<Versionstamp> modification = wait(TenantMetadata::lastTenantModification().get(&tr));
+				if (modification.present() && modification == lastModification) {
+					CODE_PROBE(true, "Tenant cache skipped reading an unchanged tenant map");
+					lastTenantListFetchTime = now();
+					tr.reset();
+					wait(delay(SERVER_KNOBS->TENANT_CACHE_LIST_REFRESH_INTERVAL));
+					continue;
+				}
+
 				state std::vector<std::pair<int64_t, TenantMapEntry>> tenantList =
 				    wait(getTenantList(tenantCache, &tr));
 
@@ -110,6 +125,7 @@ public:
 					    .detail("List", tenantCache->desc());
 				}
 
+				lastModification = modification;
 				lastTenantListFetchTime = now();
 				tr.reset();
 				wait(delay(SERVER_KNOBS->TENANT_CACHE_LIST_REFRESH_INTERVAL));
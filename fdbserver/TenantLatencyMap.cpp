@@ -0,0 +1,138 @@
+/*
+ * TenantLatencyMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/TenantLatencyMap.h"
+#include "flow/UnitTest.h"
+
+const char* TenantLatencyMap::typeName(RequestType type) {
+	switch (type) {
+	case RequestType::PointRead:
+		return "point_read";
+	case RequestType::RangeRead:
+		return "range_read";
+	case RequestType::Commit:
+		return "commit";
+	}
+	UNREACHABLE();
+}
+
+TenantLatencyMap::TenantLatencyMap(std::string const& name, UID id, double loggingInterval)
+  : name(name), id(id), summaryEventHolder(makeReference<EventCacheHolder>(id.toString() + "/" + name + "Summary")) {
+	logger = recurring([this]() { logLatencies(); }, loggingInterval);
+}
+
+void TenantLatencyMap::addMeasurement(int64_t tenantId, RequestType type, double latency, int64_t bytes) {
+	auto key = std::make_pair(tenantId, type);
+	auto it = map.find(key);
+	if (it == map.end()) {
+		if (map.size() >= SERVER_KNOBS->TENANT_LATENCY_MAX_TRACKED) {
+			CODE_PROBE(true, "TenantLatencyMap reached its maximum size");
+			return;
+		}
+		it = map.try_emplace(key, SERVER_KNOBS->TENANT_LATENCY_SKETCH_ACCURACY).first;
+	}
+	if (type == RequestType::RangeRead) {
+		latency /= std::max(1.0, bytes / 1024.0);
+	}
+	double slo =
+	    type == RequestType::Commit ? SERVER_KNOBS->TENANT_COMMIT_LATENCY_SLO : SERVER_KNOBS->TENANT_READ_LATENCY_SLO;
+	auto& latencies = it->second;
+	latencies.sketch.addSample(latency);
+	if (latency > slo) {
+		++latencies.sloMisses;
+	}
+	latencies.lastUpdated = now();
+}
+
+void TenantLatencyMap::logLatencies() {
+	struct Summary {
+		int64_t tenantId;
+		RequestType type;
+		uint64_t count;
+		double median;
+		double p99;
+		double max;
+		int64_t sloMisses;
+	};
+	std::vector<Summary> summaries;
+	for (auto it = map.begin(); it != map.end();) {
+		auto& [key, latencies] = *it;
+		if (latencies.sketch.getPopulationSize() == 0) {
+			if (now() - latencies.lastUpdated > SERVER_KNOBS->TENANT_LATENCY_EXPIRE_AFTER) {
+				CODE_PROBE(true, "TenantLatencyMap erasing expired tenant");
+				it = map.erase(it);
+			} else {
+				++it;
+			}
+			continue;
+		}
+		summaries.push_back(Summary{ key.first,
+		                             key.second,
+		                             latencies.sketch.getPopulationSize(),
+		                             latencies.sketch.median(),
+		                             latencies.sketch.percentile(0.99),
+		                             latencies.sketch.max(),
+		                             latencies.sloMisses });
+		if (latencies.sloMisses > 0) {
+			TraceEvent(name.c_str(), id)
+			    .detail("Tenant", key.first)
+			    .detail("Type", typeName(key.second))
+			    .detail("Count", summaries.back().count)
+			    .detail("Median", summaries.back().median)
+			    .detail("P99", summaries.back().p99)
+			    .detail("Max", summaries.back().max)
+			    .detail("SLOMisses", latencies.sloMisses);
+		}
+		latencies.sketch.clear();
+		latencies.sloMisses = 0;
+		++it;
+	}
+
+	int reported = std::min<int>(summaries.size(), SERVER_KNOBS->TENANT_LATENCY_STATUS_TENANTS);
+	std::partial_sort(
+	    summaries.begin(), summaries.begin() + reported, summaries.end(), [](Summary const& a, Summary const& b) {
+		    return a.sloMisses != b.sloMisses ? a.sloMisses > b.sloMisses : a.p99 > b.p99;
+	    });
+	TraceEvent te((name + "Summary").c_str(), id);
+	te.detail("Tracked", map.size()).detail("Reported", reported);
+	for (int i = 0; i < reported; i++) {
+		te.detail(format("Tenant%d", i), summaries[i].tenantId)
+		    .detail(format("Type%d", i), typeName(summaries[i].type))
+		    .detail(format("Count%d", i), summaries[i].count)
+		    .detail(format("Median%d", i), summaries[i].median)
+		    .detail(format("P99%d", i), summaries[i].p99)
+		    .detail(format("Max%d", i), summaries[i].max)
+		    .detail(format("SLOMisses%d", i), summaries[i].sloMisses);
+	}
+	te.trackLatest(summaryEventHolder->trackingKey);
+}
+
+TEST_CASE("/fdbserver/TenantLatencyMap/MaxSize") {
+	TenantLatencyMap map("TestTenantLatencies", deterministicRandom()->randomUniqueID(), 10.0);
+	for (int64_t tenant = 0; tenant < SERVER_KNOBS->TENANT_LATENCY_MAX_TRACKED + 2; tenant++) {
+		map.addMeasurement(tenant, TenantLatencyMap::RequestType::PointRead, deterministicRandom()->random01());
+	}
+	ASSERT_EQ(map.size(), SERVER_KNOBS->TENANT_LATENCY_MAX_TRACKED);
+	map.logLatencies();
+	// Tracked tenants haven't expired, even with no requests in the last interval
+	map.logLatencies();
+	ASSERT_EQ(map.size(), SERVER_KNOBS->TENANT_LATENCY_MAX_TRACKED);
+	return Void();
+}
@@ -74,13 +74,11 @@ Reference<TLogTestContext> initTLogTestContext(TestTLogOptions tLogOptions,
 	return context;
 }
 
-// Create and start a tLog. If optional parmeters are set, the tLog is a new generation of "tLogID"
-// as described by initReq. Otherwise, it is a newborn generation 0 tLog.
 ACTOR Future<Void> getTLogCreateActor(Reference<TLogTestContext> pTLogTestContext,
                                       TestTLogOptions tLogOptions,
                                       uint16_t processID,
-                                      InitializeTLogRequest* initReq = nullptr,
-                                      UID tLogID = UID()) {
+                                      InitializeTLogRequest* initReq,
+                                      UID tLogID) {
 
 	// build per-tLog state.
 	state Reference<TLogContext> pTLogContext = pTLogTestContext->pTLogContextList[processID];
@@ -62,8 +62,10 @@ public:
 	  : thisServerID(thisServerID), maxTagsTracked(maxTagsTracked), minRateTracked(minRateTracked),
 	    busiestReadTagEventHolder(makeReference<EventCacheHolder>(thisServerID.toString() + "/BusiestReadTag")) {}
 
-	void addRequest(Optional<TagSet> const& tags, int64_t bytes) {
-		auto const cost = getReadOperationCost(bytes);
+	void addRequest(Optional<TagSet> const& tags, int64_t bytes, double serviceSeconds) {
+		// Bytes alone underprice reads that are slow to serve, such as small random reads that miss the cache
+		auto const cost = std::max<double>(getReadOperationCost(bytes),
+		                                   serviceSeconds * SERVER_KNOBS->STORAGE_READ_TAG_COST_PER_SECOND);
 		intervalTotalCost += cost;
 		if (tags.present()) {
 			for (auto const& tag : tags.get()) {
@@ -117,8 +119,8 @@ TransactionTagCounter::TransactionTagCounter(UID thisServerID, int maxTagsTracke
 
 TransactionTagCounter::~TransactionTagCounter() = default;
 
-void TransactionTagCounter::addRequest(Optional<TagSet> const& tags, int64_t bytes) {
-	return impl->addRequest(tags, bytes);
+void TransactionTagCounter::addRequest(Optional<TagSet> const& tags, int64_t bytes, double serviceSeconds) {
+	return impl->addRequest(tags, bytes, serviceSeconds);
 }
 
 void TransactionTagCounter::startNewInterval() {
@@ -183,3 +185,26 @@ TEST_CASE("/fdbserver/TransactionTagCounter/IgnoreBelowMinRate") {
 	}
 	return Void();
 }
+
+TEST_CASE("/fdbserver/TransactionTagCounter/ServiceTime") {
+	state TransactionTagCounter counter(UID(), /*maxTagsTracked=*/2, /*minRateTracked=*/0.0);
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("storage_read_tag_cost_per_second",
+	                                                          KnobValueRef::create(double{ 1e9 }));
+	counter.startNewInterval();
+	{
+		wait(delay(1.0));
+		// tagA reads more bytes, but tagB's single read kept the server busy for much longer
+		for (int i = 0; i < 10; i++) {
+			counter.addRequest(getTagSet("tagA"_sr), 10 * CLIENT_KNOBS->TAG_THROTTLING_PAGE_SIZE, 1e-6);
+		}
+		counter.addRequest(getTagSet("tagB"_sr), 1, 0.01);
+		counter.startNewInterval();
+		auto const busiestTags = counter.getBusiestTags();
+		ASSERT_EQ(busiestTags.size(), 2);
+		auto const& busiest = busiestTags[0].rate > busiestTags[1].rate ? busiestTags[0] : busiestTags[1];
+		ASSERT(busiest.tag == "tagB"_sr);
+	}
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("storage_read_tag_cost_per_second",
+	                                                          KnobValueRef::create(double{ 0.0 }));
+	return Void();
+}
@@ -25,6 +25,7 @@
 #include "fdbclient/Tuple.h"
 #include "fdbrpc/DDSketch.h"
 #include "fdbrpc/simulator.h"
+#include "fdbserver/CoroFlow.h"
 #include "fdbserver/DeltaTree.h"
 #include "fdbserver/IKeyValueStore.h"
 #include "fdbserver/IPager.h"
@@ -40,6 +41,7 @@
 #include "flow/Histogram.h"
 #include "flow/IAsyncFile.h"
 #include "flow/IRandom.h"
+#include "flow/IThreadPool.h"
 #include "flow/Knobs.h"
 #include "flow/ObjectSerializer.h"
 #include "flow/PriorityMultiLock.actor.h"
@@ -47,6 +49,7 @@
 #include "flow/serialize.h"
 #include "flow/Trace.h"
 #include "flow/UnitTest.h"
+#include "flow/xxhash.h"
 #include "fmt/format.h"
 
 #include <boost/intrusive/list.hpp>
@@ -54,6 +57,7 @@
 #include <limits>
 #include <map>
 #include <random>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -1459,8 +1463,13 @@ struct RedwoodMetrics {
 		unsigned int pagerProbeMiss;
 		unsigned int pagerEvictUnhit;
 		unsigned int pagerEvictFail;
+		unsigned int pagerCachePromote;
+		unsigned int pagerCacheDemote;
+		unsigned int pagerEncodeOffloaded;
 		unsigned int btreeLeafPreload;
 		unsigned int btreeLeafPreloadExt;
+		unsigned int btreeLeafFilterSkip;
+		unsigned int btreeSeekPathReuse;
 		unsigned int readRequestDecryptTimeNS;
 	};
 
@@ -1636,12 +1645,14 @@ class ObjectCache : NonCopyable {
 	typedef std::unordered_map<IndexType, Entry> CacheT;
 
 	struct Entry : public boost::intrusive::list_base_hook<> {
-		Entry() : hits(0), size(0) {}
+		Entry() : hits(0), size(0), isProtected(false) {}
 		IndexType index;
 		ObjectType item;
 		int hits;
 		int size;
 		bool ownedByEvictor;
+		// Whether the entry is in the Evictor's protected segment, only used by the scan resistant policy
+		bool isProtected;
 		CacheT* pCache;
 	};
 
@@ -1652,6 +1663,12 @@ public:
 	// Not all objects tracked by the Evictor are in its evictionOrder, as ObjectCaches
 	// using this Evictor can temporarily remove entries to an external order but they
 	// must eventually give them back with moveIn() or remove them with reclaim().
+	//
+	// With REDWOOD_PAGE_CACHE_SCAN_RESISTANT set, the Evictor is a segmented LRU. New entries start in the
+	// probationary segment (evictionOrder) and move to the protected segment (protectedOrder) on their first hit.
+	// When the protected segment exceeds its share of the size limit its oldest entries are demoted back to the
+	// end of the probationary segment, and eviction always starts with the probationary segment, so a scan of
+	// pages which are never read again can only displace other entries which were not reused either.
 	class Evictor : NonCopyable {
 	public:
 		Evictor(int64_t sizeLimit = 0) : sizeLimit(sizeLimit) {}
@@ -1672,15 +1689,35 @@ public:
 		// but the entry size is still counted against the evictor
 		void moveOut(Entry& e, EvictionOrderT& dest) {
 			ASSERT(e.ownedByEvictor);
-			dest.splice(dest.end(), evictionOrder, EvictionOrderT::s_iterator_to(e));
+			dest.splice(dest.end(), orderOf(e), EvictionOrderT::s_iterator_to(e));
+			unprotect(e);
 			e.ownedByEvictor = false;
 			++movedOutCount;
 		}
 
-		// Move an entry to the back of the eviction order if it is in the eviction order
+		// Move an entry to the back of the eviction order if it is in the eviction order.
+		// Under the scan resistant policy, this promotes the entry to the protected segment.
 		void moveToBack(Entry& e) {
 			ASSERT(e.ownedByEvictor);
-			evictionOrder.splice(evictionOrder.end(), evictionOrder, EvictionOrderT::s_iterator_to(e));
+			if (e.isProtected || !SERVER_KNOBS->REDWOOD_PAGE_CACHE_SCAN_RESISTANT) {
+				EvictionOrderT& order = orderOf(e);
+				order.splice(order.end(), order, EvictionOrderT::s_iterator_to(e));
+				return;
+			}
+
+			protectedOrder.splice(protectedOrder.end(), evictionOrder, EvictionOrderT::s_iterator_to(e));
+			e.isProtected = true;
+			protectedSize += e.size;
+			++g_redwoodMetrics.metric.pagerCachePromote;
+
+			// Demote the oldest protected entries, but never the one just promoted
+			int64_t protectedLimit = sizeLimit * SERVER_KNOBS->REDWOOD_PAGE_CACHE_PROTECTED_FRACTION;
+			while (protectedSize > protectedLimit && protectedOrder.size() > 1) {
+				Entry& toDemote = protectedOrder.front();
+				evictionOrder.splice(evictionOrder.end(), protectedOrder, protectedOrder.begin());
+				unprotect(toDemote);
+				++g_redwoodMetrics.metric.pagerCacheDemote;
+			}
 		}
 
 		// Move entire contents of an external eviction order containing entries whose size is part of
@@ -1707,7 +1744,8 @@ public:
 			sizeUsed -= e.size;
 			// If e is in evictionOrder then remove it
 			if (e.ownedByEvictor) {
-				evictionOrder.erase(EvictionOrderT::s_iterator_to(e));
+				orderOf(e).erase(EvictionOrderT::s_iterator_to(e));
+				unprotect(e);
 				e.ownedByEvictor = false;
 			} else {
 				// Otherwise, it wasn't so it had to be a movedOut item so decrement the count
@@ -1718,13 +1756,15 @@ public:
 		void trim(int additionalSpaceNeeded = 0) {
 			int attemptsLeft = FLOW_KNOBS->MAX_EVICT_ATTEMPTS;
 			// While the cache is too big, evict the oldest entry until the oldest entry can't be evicted.
+			// The protected segment is only used once the probationary segment is empty.
 			while (attemptsLeft-- > 0 && sizeUsed > (sizeLimit - reservedSize - additionalSpaceNeeded) &&
-			       !evictionOrder.empty()) {
-				Entry& toEvict = evictionOrder.front();
+			       (!evictionOrder.empty() || !protectedOrder.empty())) {
+				EvictionOrderT& order = !evictionOrder.empty() ? evictionOrder : protectedOrder;
+				Entry& toEvict = order.front();
 
 				debug_printf("Evictor count=%d sizeUsed=%" PRId64 " sizeLimit=%" PRId64 " sizePenalty=%" PRId64
 				             " needed=%d  Trying to evict %s evictable %d\n",
-				             (int)evictionOrder.size(),
+				             (int)getCountUsed(),
 				             sizeUsed,
 				             sizeLimit,
 				             reservedSize,
@@ -1734,7 +1774,7 @@ public:
 
 				if (!toEvict.item.evictable()) {
 					// shift the front to the back
-					evictionOrder.shift_forward(1);
+					order.shift_forward(1);
 					++g_redwoodMetrics.metric.pagerEvictFail;
 					break;
 				} else {
@@ -1743,32 +1783,39 @@ public:
 					}
 					sizeUsed -= toEvict.size;
 					debug_printf("Evicting %s\n", ::toString(toEvict.index).c_str());
-					evictionOrder.pop_front();
+					order.pop_front();
+					unprotect(toEvict);
 					toEvict.pCache->erase(toEvict.index);
 				}
 			}
 		}
 
-		int64_t getCountUsed() const { return evictionOrder.size() + movedOutCount; }
+		int64_t getCountUsed() const { return evictionOrder.size() + protectedOrder.size() + movedOutCount; }
 		int64_t getCountMoved() const { return movedOutCount; }
+		int64_t getCountProtected() const { return protectedOrder.size(); }
 		int64_t getSizeUsed() const { return sizeUsed + reservedSize; }
+		int64_t getSizeProtected() const { return protectedSize; }
 
 		// Only to be used in tests at a point where all ObjectCache instances should be destroyed.
 		bool empty() const { return reservedSize == 0 && sizeUsed == 0 && getCountUsed() == 0; }
 
 		std::string toString() const {
 			std::string s = format("Evictor {sizeLimit=%" PRId64 " sizeUsed=%" PRId64 " countUsed=%" PRId64
-			                       " sizePenalty=%" PRId64 " movedOutCount=%" PRId64,
+			                       " sizePenalty=%" PRId64 " movedOutCount=%" PRId64 " protectedSize=%" PRId64,
 			                       sizeLimit,
 			                       sizeUsed,
 			                       getCountUsed(),
 			                       reservedSize,
-			                       movedOutCount);
-			for (auto& entry : evictionOrder) {
-				s += format("\n\tindex %s  size %d  evictable %d\n",
-				            ::toString(entry.index).c_str(),
-				            entry.size,
-				            entry.item.evictable());
+			                       movedOutCount,
+			                       protectedSize);
+			for (auto* order : { &evictionOrder, &protectedOrder }) {
+				for (auto& entry : *order) {
+					s += format("\n\tindex %s  size %d  evictable %d  protected %d\n",
+					            ::toString(entry.index).c_str(),
+					            entry.size,
+					            entry.item.evictable(),
+					            entry.isProtected);
+				}
 			}
 			s += "}\n";
 			return s;
@@ -1780,9 +1827,23 @@ public:
 		int64_t sizeLimit;
 
 	private:
+		EvictionOrderT& orderOf(const Entry& e) { return e.isProtected ? protectedOrder : evictionOrder; }
+
+		// Must be called after e is removed from protectedOrder
+		void unprotect(Entry& e) {
+			if (e.isProtected) {
+				protectedSize -= e.size;
+				e.isProtected = false;
+			}
+		}
+
 		EvictionOrderT evictionOrder;
+		// Entries which have been hit since they were last added or demoted, only used by the scan resistant policy
+		EvictionOrderT protectedOrder;
 		// Size of all entries in the eviction order or held in external eviction orders
 		int64_t sizeUsed = 0;
+		// Size of all entries in protectedOrder
+		int64_t protectedSize = 0;
 		// Number of items that have been moveOut()'d to other evictionOrders and aren't back yet
 		int64_t movedOutCount = 0;
 	};
@@ -1898,6 +1959,30 @@ Future<T> forwardError(Future<T> f, Promise<Void> target) {
 
 constexpr int initialVersion = invalidVersion;
 
+// Encodes (encrypts and checksums) pages for DWALPager on its encoding threads. The page is only accessed by raw
+// pointer, its reference is held on the network thread until the encoding is done.
+struct PageEncodingWorker final : IThreadPoolReceiver {
+	void init() override {}
+
+	struct EncodeAction final : TypedAction<PageEncodingWorker, EncodeAction> {
+		ArenaPage* page;
+		PhysicalPageID pageID;
+		ThreadReturnPromise<Void> result;
+
+		EncodeAction(ArenaPage* page, PhysicalPageID pageID) : page(page), pageID(pageID) {}
+		double getTimeEstimate() const override { return 0; }
+	};
+
+	void action(EncodeAction& a) {
+		try {
+			a.page->preWrite(a.pageID);
+			a.result.send(Void());
+		} catch (Error& e) {
+			a.result.sendError(e);
+		}
+	}
+};
+
 class DWALPagerSnapshot;
 
 // An implementation of IPager2 that supports atomicUpdate() of a page without forcing a change to new page ID.
@@ -1942,6 +2027,18 @@ public:
 	};
 	typedef ObjectCache<LogicalPageID, PageCacheEntry> PageCacheT;
 
+	// A filter kept for the user of the pager describing the content of a physical page, such as a summary of the keys
+	// in it. Filters are only ever dropped, when their page is written or when they are evicted, so there is nothing
+	// to wait for.
+	struct PageFilterEntry {
+		Standalone<StringRef> filter;
+
+		bool evictable() const { return true; }
+		Future<Void> onEvictable() const { return Void(); }
+		Future<Void> cancel() const { return Void(); }
+	};
+	typedef ObjectCache<PhysicalPageID, PageFilterEntry> PageFilterCacheT;
+
 	int64_t* getPageCachePenaltySource() override { return &pageCache.evictor().reservedSize; }
 
 	constexpr static PhysicalPageID primaryHeaderPageID = 0;
@@ -2034,6 +2131,13 @@ public:
 			g_redwoodMetricsActor = redwoodMetricsLogger();
 		}
 
+		if (SERVER_KNOBS->REDWOOD_PAGE_ENCODING_THREADS > 0) {
+			encodingThreads = createPureWorkThreadPool();
+			for (int i = 0; i < SERVER_KNOBS->REDWOOD_PAGE_ENCODING_THREADS; ++i) {
+				encodingThreads->addThread(new PageEncodingWorker(), "fdb-rw-encode");
+			}
+		}
+
 		commitFuture = Void();
 		recoverFuture = forwardError(recover(this), errorPromise);
 	}
@@ -2424,7 +2528,27 @@ public:
 
 	// Get a new, previously available page ID.  The page will be considered in-use after the next commit
 	// regardless of whether or not it was written to, until it is returned to the pager via freePage()
-	ACTOR static Future<LogicalPageID> newPageID_impl(DWALPager* self) {
+	// If hot is set then the page is expected to be replaced soon, which only matters when allocating from the pool.
+	ACTOR static Future<LogicalPageID> newPageID_impl(DWALPager* self, bool hot) {
+		// Allocate from the pool of free pages if it is in use, refilling it from the free list when needed
+		if (SERVER_KNOBS->REDWOOD_PAGE_ALLOCATION_POOL_SIZE > 1 && !self->flushingQueues) {
+			if (self->allocationPool.empty()) {
+				wait(refillAllocationPool(self));
+			}
+			if (!self->allocationPool.empty()) {
+				// New pages of a commit are allocated roughly in key order, so handing out the lowest IDs first
+				// places a rewritten range's pages near each other and in order in the file. Pages which will soon be
+				// replaced come from the other end of the pool so they don't interleave with them.
+				auto i = hot ? std::prev(self->allocationPool.end()) : self->allocationPool.begin();
+				LogicalPageID id = *i;
+				self->allocationPool.erase(i);
+				debug_printf("DWALPager(%s) newPageID() returning %s from allocation pool\n",
+				             self->filename.c_str(),
+				             toString(id).c_str());
+				return id;
+			}
+		}
+
 		// First try the free list
 		Optional<LogicalPageID> freePageID = wait(self->freeList.pop());
 		if (freePageID.present()) {
@@ -2459,7 +2583,42 @@ public:
 		return id;
 	}
 
-	Future<LogicalPageID> newPageID() override { return newPageID_impl(this); }
+	Future<LogicalPageID> newPageID() override { return newPageID_impl(this, false); }
+
+	// Moves up to REDWOOD_PAGE_ALLOCATION_POOL_SIZE pages from the front of the free list into the allocation pool
+	ACTOR static Future<Void> refillAllocationPool(DWALPager* self) {
+		state std::vector<LogicalPageID> ids;
+		loop {
+			if (ids.size() >= SERVER_KNOBS->REDWOOD_PAGE_ALLOCATION_POOL_SIZE) {
+				break;
+			}
+			Optional<LogicalPageID> id = wait(self->freeList.pop());
+			if (!id.present()) {
+				break;
+			}
+			ids.push_back(id.get());
+		}
+
+		// A commit may have started flushing the free list meanwhile, in which case the pages must go back to it
+		for (LogicalPageID id : ids) {
+			if (self->flushingQueues) {
+				self->freeList.pushFront(id);
+			} else {
+				self->allocationPool.insert(id);
+			}
+		}
+		return Void();
+	}
+
+	// Pages in the allocation pool have been popped from the free list but not handed out, so they must be
+	// returned to the free list before it is flushed or they would be lost.
+	void returnAllocationPool() {
+		// Push in descending order so that the lowest page ID is the next one popped
+		for (auto i = allocationPool.rbegin(); i != allocationPool.rend(); ++i) {
+			freeList.pushFront(*i);
+		}
+		allocationPool.clear();
+	}
 
 	void growPager(int64_t pages) { header.pageCount += pages; }
 
@@ -2582,25 +2741,52 @@ public:
 			page = page->clone();
 		}
 
-		page->preWrite(pageIDs.front());
-
-		int blockSize = header ? smallestPhysicalBlock : physicalPageSize;
 		Future<Void> f;
-		if (pageIDs.size() == 1) {
-			f = writePhysicalBlock(this, page, 0, blockSize, pageIDs.front(), reason, level, header);
+		// The copy is private to this write, so it can be encrypted by another thread while the network thread goes
+		// on building and writing other pages of the commit.
+		if (copy && encodingThreads && !header) {
+			auto* action = new PageEncodingWorker::EncodeAction(page.getPtr(), pageIDs.front());
+			Future<Void> encoded = uncancellable(holdWhile(page, action->result.getFuture()));
+			encodingThreads->post(action);
+			f = writeEncodedPhysicalPage(this, reason, level, pageIDs, page, encoded);
 		} else {
-			std::vector<Future<Void>> writers;
-			for (int i = 0; i < pageIDs.size(); ++i) {
-				Future<Void> p = writePhysicalBlock(this, page, i, blockSize, pageIDs[i], reason, level, header);
-				writers.push_back(p);
-			}
-			f = waitForAll(writers);
+			page->preWrite(pageIDs.front());
+			f = writePhysicalBlocks(reason, level, pageIDs, page, header);
 		}
 
 		operations.push_back(f);
 		return f;
 	}
 
+	Future<Void> writePhysicalBlocks(PagerEventReasons reason,
+	                                 unsigned int level,
+	                                 const Standalone<VectorRef<PhysicalPageID>>& pageIDs,
+	                                 Reference<ArenaPage> page,
+	                                 bool header) {
+		int blockSize = header ? smallestPhysicalBlock : physicalPageSize;
+		if (pageIDs.size() == 1) {
+			return writePhysicalBlock(this, page, 0, blockSize, pageIDs.front(), reason, level, header);
+		}
+		std::vector<Future<Void>> writers;
+		for (int i = 0; i < pageIDs.size(); ++i) {
+			Future<Void> p = writePhysicalBlock(this, page, i, blockSize, pageIDs[i], reason, level, header);
+			writers.push_back(p);
+		}
+		return waitForAll(writers);
+	}
+
+	ACTOR static Future<Void> writeEncodedPhysicalPage(DWALPager* self,
+	                                                   PagerEventReasons reason,
+	                                                   unsigned int level,
+	                                                   Standalone<VectorRef<PhysicalPageID>> pageIDs,
+	                                                   Reference<ArenaPage> page,
+	                                                   Future<Void> encoded) {
+		wait(encoded);
+		++g_redwoodMetrics.metric.pagerEncodeOffloaded;
+		wait(self->writePhysicalBlocks(reason, level, pageIDs, page, false));
+		return Void();
+	}
+
 	Future<Void> writeHeaderPage(PhysicalPageID pageID, Reference<ArenaPage> page) {
 		return writePhysicalPage(
 		    PagerEventReasons::MetaData, nonBtreeLevel, VectorRef<PhysicalPageID>(&pageID, 1), page, true);
@@ -2651,6 +2837,12 @@ public:
 
 		// Always update the page contents immediately regardless of what happened above.
 		cacheEntry.readFuture = data;
+
+		// Any filter kept for the page describes its old contents
+		PageFilterEntry* filterEntry = pageFilterCache.getIfExists(pageIDs.front());
+		if (filterEntry != nullptr) {
+			filterEntry->filter = Standalone<StringRef>();
+		}
 	}
 
 	Future<LogicalPageID> atomicUpdatePage(PagerEventReasons reason,
@@ -2659,7 +2851,8 @@ public:
 	                                       Reference<ArenaPage> data,
 	                                       Version v) override {
 		debug_printf("DWALPager(%s) op=writeAtomic %s @%" PRId64 "\n", filename.c_str(), toString(pageID).c_str(), v);
-		Future<LogicalPageID> f = map(newPageID(), [=](LogicalPageID newPageID) {
+		// The new page is a remapped version of pageID, which remap cleanup will copy back over pageID and free
+		Future<LogicalPageID> f = map(newPageID_impl(this, true), [=](LogicalPageID newPageID) {
 			updatePage(reason, level, VectorRef<LogicalPageID>(&newPageID, 1), data);
 			// TODO:  Possibly limit size of remap queue since it must be recovered on cold start
 			RemappedPage r{ v, pageID, newPageID };
@@ -3063,6 +3256,23 @@ public:
 		return cacheEntry.readFuture;
 	}
 
+	// Returns the filter set for the physical page that pageID maps to at version v, if it hasn't been dropped since
+	Optional<Standalone<StringRef>> getPageFilter(LogicalPageID pageID, Version v) {
+		PageFilterEntry* entry = pageFilterCache.getIfExists(getPhysicalPageID(pageID, v));
+		if (entry == nullptr || entry->filter.empty()) {
+			return Optional<Standalone<StringRef>>();
+		}
+		return entry->filter;
+	}
+
+	// The caller must have read pageID at version v and must still hold a snapshot at v, so that the physical page
+	// can't have been written since the read.
+	void setPageFilter(LogicalPageID pageID, Version v, Standalone<StringRef> filter) {
+		if (SERVER_KNOBS->REDWOOD_LEAF_KEY_FILTER_MEMORY > 0) {
+			pageFilterCache.get(getPhysicalPageID(pageID, v), filter.size()).filter = filter;
+		}
+	}
+
 	PhysicalPageID getPhysicalPageID(LogicalPageID pageID, Version v) {
 		auto i = remappedPages.find(pageID);
 
@@ -3515,6 +3725,10 @@ public:
 	ACTOR static Future<Void> flushQueues(DWALPager* self) {
 		ASSERT(self->remapCleanupFuture.isReady());
 
+		// Queue pages allocated while flushing bypass the allocation pool, so the pool is empty once the flush is done
+		self->flushingQueues = true;
+		self->returnAllocationPool();
+
 		// Flush remap queue and related queues separately, they are not involved in free page management
 		wait(self->remapQueue.flush());
 		wait(self->extentFreeList.flush());
@@ -3545,6 +3759,7 @@ public:
 		}
 		self->freeList.finishFlush();
 		self->delayedFreeList.finishFlush();
+		self->flushingQueues = false;
 
 		return Void();
 	}
@@ -3676,6 +3891,12 @@ public:
 		debug_printf("DWALPager(%s) shutdown destroy page cache\n", self->filename.c_str());
 		wait(self->extentCache.clear());
 		wait(self->pageCache.clear());
+		wait(self->pageFilterCache.clear());
+
+		if (self->encodingThreads) {
+			debug_printf("DWALPager(%s) shutdown stop encoding threads\n", self->filename.c_str());
+			wait(self->encodingThreads->stop());
+		}
 
 		debug_printf("DWALPager(%s) shutdown remappedPagesMap: %s\n",
 		             self->filename.c_str(),
@@ -3729,7 +3950,8 @@ public:
 		// free queue, but this doesn't seem necessary.
 
 		// Amount of space taken up by all of the items in the free lists
-		int64_t reusablePageSpace = (freeList.numEntries + delayedFreeList.numEntries) * physicalPageSize;
+		int64_t reusablePageSpace =
+		    (freeList.numEntries + delayedFreeList.numEntries + allocationPool.size()) * physicalPageSize;
 		// Amount of space taken up by the free list queues themselves, as if we were to pop and use
 		// items on the free lists the space the items are stored in would also become usable
 		int64_t reusableQueueSpace = (freeList.numPages + delayedFreeList.numPages) * physicalPageSize;
@@ -3748,6 +3970,16 @@ public:
 
 	int64_t getPageCacheCount() override { return pageCache.getCount(); }
 	int64_t getPageCount() override { return header.pageCount; }
+
+	// The page cache of a memory only pager holds all of its pages, so its limit is left alone
+	int64_t getConfiguredPageCacheSize() const override { return memoryOnly ? 0 : pageCacheBytes; }
+
+	void setPageCacheSizeLimit(int64_t bytes) override {
+		if (!memoryOnly) {
+			pageCache.evictor().sizeLimit = bytes;
+			pageCache.evictor().trim();
+		}
+	}
 	int64_t getExtentCacheCount() override { return extentCache.getCount(); }
 
 	ACTOR static Future<Void> getUserPageCount_cleanup(DWALPager* self) {
@@ -3915,6 +4147,10 @@ private:
 	PageCacheT::Evictor extentCacheDummyEvictor{ std::numeric_limits<int64_t>::max() };
 	PageCacheT extentCache{ &extentCacheDummyEvictor };
 
+	// Page filters have their own memory budget, separate from the page cache
+	PageFilterCacheT::Evictor pageFilterEvictor{ SERVER_KNOBS->REDWOOD_LEAF_KEY_FILTER_MEMORY };
+	PageFilterCacheT pageFilterCache{ &pageFilterEvictor };
+
 	Promise<Void> closedPromise;
 	Promise<Void> errorPromise;
 	Future<Void> commitFuture;
@@ -3923,6 +4159,9 @@ private:
 	// other operations that need to be waited on before a commit can finish.
 	std::vector<Future<Void>> operations;
 
+	// Encrypts pages being written off the network thread; null unless REDWOOD_PAGE_ENCODING_THREADS > 0
+	Reference<IThreadPool> encodingThreads;
+
 	Future<Void> recoverFuture;
 	Future<Void> remapCleanupFuture;
 	bool remapCleanupStop;
@@ -3931,6 +4170,11 @@ private:
 
 	LogicalPageQueueT freeList;
 
+	// Free pages taken from the front of freeList in batches so that they can be handed out in page ID order,
+	// only used if REDWOOD_PAGE_ALLOCATION_POOL_SIZE > 1
+	std::set<LogicalPageID> allocationPool;
+	bool flushingQueues = false;
+
 	// The delayed free list will be approximately in Version order.
 	// TODO: Make this an ordered container some day.
 	DelayedFreePageQueueT delayedFreeList;
@@ -3993,6 +4237,14 @@ public:
 
 	Version getVersion() const override { return version; }
 
+	Optional<Standalone<StringRef>> getPageFilter(LogicalPageID pageID) override {
+		return pager->getPageFilter(pageID, version);
+	}
+
+	void setPageFilter(LogicalPageID pageID, Standalone<StringRef> filter) override {
+		pager->setPageFilter(pageID, version, filter);
+	}
+
 	void addref() override { ReferenceCounted<DWALPagerSnapshot>::addref(); }
 
 	void delref() override { ReferenceCounted<DWALPagerSnapshot>::delref(); }
@@ -4186,6 +4438,15 @@ struct RedwoodRecordRef {
 		return skipLen + commonPrefixLength(key, other.key, skipLen);
 	}
 
+	// The 8 key bytes starting at skipLen, zero padded, as a big endian integer for a DeltaTree2 search index
+	inline uint64_t getSearchWord(int skipLen) const {
+		uint64_t word = 0;
+		if (key.size() > skipLen) {
+			memcpy(&word, key.begin() + skipLen, std::min<int>(key.size() - skipLen, sizeof(word)));
+		}
+		return bigEndian64(word);
+	}
+
 	// Compares and orders by key, version, chunk.total, chunk.start, value
 	// This is the same order that delta compression uses for prefix borrowing
 	int compare(const RedwoodRecordRef& rhs, int skip = 0) const {
@@ -4681,6 +4942,57 @@ struct BTreePage {
 	}
 };
 
+// A Bloom filter over the keys of a leaf page, which lets point reads of keys that are not in the page return without
+// reading it. The first byte is the number of probes and the rest is the bit array, in whole 64 bit words. Each probe
+// is derived from a single 64 bit hash of the key.
+struct LeafKeyFilter {
+	static std::pair<uint64_t, uint64_t> hashes(KeyRef key) {
+		uint64_t h = XXH3_64bits(key.begin(), key.size());
+		// The second hash must be odd so that the probes cycle through every bit position when the size is a power
+		// of two.
+		return { h, (h >> 32 | h << 32) | 1 };
+	}
+
+	// Returns a filter of about bitsPerKey bits for each record in the page, erased or not, at cursor
+	static Standalone<StringRef> build(BTreePage::BinaryTree::Cursor cursor, int bitsPerKey) {
+		int words = std::max<int64_t>(1, ((int64_t)cursor.tree->numItems * bitsPerKey + 63) / 64);
+		Standalone<StringRef> filter = makeString(1 + words * sizeof(uint64_t));
+		uint8_t* data = mutateString(filter);
+		// bitsPerKey * ln(2) probes minimizes the false positive rate
+		data[0] = std::clamp(bitsPerKey * 69 / 100, 1, 30);
+		memset(data + 1, 0, words * sizeof(uint64_t));
+
+		uint64_t bits = words * 64;
+		if (cursor.moveFirst()) {
+			do {
+				auto [h, delta] = hashes(cursor.get().key);
+				for (int i = 0; i < data[0]; ++i, h += delta) {
+					uint64_t bit = h % bits;
+					data[1 + bit / 8] |= 1 << (bit % 8);
+				}
+			} while (cursor.moveNext());
+		}
+		return filter;
+	}
+
+	// Returns false only if key was not in the page the filter was built from
+	static bool mayContain(StringRef filter, KeyRef key) {
+		if (filter.size() < 1 + sizeof(uint64_t)) {
+			return true;
+		}
+		const uint8_t* data = filter.begin();
+		uint64_t bits = (filter.size() - 1) / sizeof(uint64_t) * 64;
+		auto [h, delta] = hashes(key);
+		for (int i = 0; i < data[0]; ++i, h += delta) {
+			uint64_t bit = h % bits;
+			if (!(data[1 + bit / 8] & (1 << (bit % 8)))) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
 struct BoundaryRefAndPage {
 	Standalone<RedwoodRecordRef> lowerBound;
 	Reference<ArenaPage> firstPage;
@@ -5002,6 +5314,9 @@ public:
 
 	StorageBytes getStorageBytes() const { return m_pager->getStorageBytes(); }
 
+	int64_t getConfiguredPageCacheSize() const { return m_pager->getConfiguredPageCacheSize(); }
+	void setPageCacheSizeLimit(int64_t bytes) { m_pager->setPageCacheSizeLimit(bytes); }
+
 	// Set key to value as of the next commit
 	// The new value is not readable until after the next commit is completed.
 	void set(KeyValueRef keyValue) {
@@ -5031,12 +5346,35 @@ public:
 		m_pBuffer->erase(iBegin, iEnd);
 	}
 
+	// Replace the contents of range with data, which must be sorted and within range, as of the next commit. This is
+	// the same as clearing range and setting each pair, but the values are not copied: the buffer holds a reference
+	// to dataArena instead.
+	void replaceRange(KeyRangeRef range, VectorRef<KeyValueRef> data, const Arena& dataArena) {
+		clear(range);
+		m_pBuffer->dependsOn(dataArena);
+		int64_t keyBytes = 0;
+		int64_t valueBytes = 0;
+		for (const KeyValueRef& kv : data) {
+			ASSERT(range.contains(kv.key));
+			m_pBuffer->insert(kv.key).mutation().setBoundaryValue(kv.value);
+			keyBytes += kv.key.size();
+			valueBytes += kv.value.size();
+		}
+		m_mutationCount += data.size();
+		g_redwoodMetrics.metric.opSet += data.size();
+		g_redwoodMetrics.metric.opSetKeyBytes += keyBytes;
+		g_redwoodMetrics.metric.opSetValueBytes += valueBytes;
+	}
+
 	void setOldestReadableVersion(Version v) { m_newOldestVersion = v; }
 
 	Version getOldestReadableVersion() const { return m_pager->getOldestReadableVersion(); }
 
 	Version getLastCommittedVersion() const { return m_pager->getLastCommittedVersion(); }
 
+	// The page size of an existing file is the one it was created with, not necessarily the one the pager was given
+	int getLogicalPageSize() const { return m_pager->getLogicalPageSize(); }
+
 	// VersionedBTree takes ownership of pager
 	VersionedBTree(IPager2* pager,
 	               std::string name,
@@ -5557,6 +5895,9 @@ public:
 			return T(arena, object);
 		}
 
+		// Keep other alive for as long as the buffer, so that mutations can refer to memory it owns
+		void dependsOn(const Arena& other) { arena.dependsOn(other); }
+
 		const_iterator upper_bound(const KeyRef& k) const { return mutations.upper_bound(k); }
 
 		const_iterator lower_bound(const KeyRef& k) const { return mutations.lower_bound(k); }
@@ -6299,7 +6640,8 @@ private:
 	                                                         BTreeNodeLinkRef id,
 	                                                         int priority,
 	                                                         bool forLazyClear,
-	                                                         bool cacheable) {
+	                                                         bool cacheable,
+	                                                         bool noHit = false) {
 
 		debug_printf("readPage() op=read%s %s @%" PRId64 "\n",
 		             forLazyClear ? "ForDeferredClear" : "",
@@ -6309,12 +6651,12 @@ private:
 		state Reference<const ArenaPage> page;
 		if (id.size() == 1) {
 			Reference<const ArenaPage> p =
-			    wait(snapshot->getPhysicalPage(reason, level, id.front(), priority, cacheable, false));
+			    wait(snapshot->getPhysicalPage(reason, level, id.front(), priority, cacheable, noHit));
 			page = std::move(p);
 		} else {
 			ASSERT(!id.empty());
 			Reference<const ArenaPage> p =
-			    wait(snapshot->getMultiPhysicalPage(reason, level, id, priority, cacheable, false));
+			    wait(snapshot->getMultiPhysicalPage(reason, level, id, priority, cacheable, noHit));
 			page = std::move(p);
 		}
 		debug_printf("readPage() op=readComplete %s @%" PRId64 " \n", toString(id).c_str(), snapshot->getVersion());
@@ -6350,8 +6692,10 @@ private:
 			                            upperBound)
 			                 .c_str());
 
-			// Store decode cache into page based on height
-			if (((BTreePage*)page->data())->height >= SERVER_KNOBS->REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT) {
+			// Store decode cache into page based on height, or if it will hold a leaf search index
+			int height = ((BTreePage*)page->data())->height;
+			if (height >= SERVER_KNOBS->REDWOOD_DECODECACHE_REUSE_MIN_HEIGHT ||
+			    (height == 1 && SERVER_KNOBS->REDWOOD_LEAF_SEARCH_INDEX)) {
 				page->extra = cache;
 			}
 		}
@@ -7684,6 +8028,25 @@ public:
 		bool valid;
 		std::vector<PathEntry> path;
 
+		// A range prefetch started by prefetch(), which keeps a window of leaves ahead of the cursor preloaded as the
+		// cursor moves through them
+		struct RangePrefetch {
+			Key rangeEnd;
+			bool forward;
+			int recordsLeft;
+			int64_t bytesLeft;
+			int estRecordsPerPage;
+			// The leaf the cursor was on when the window was last topped up
+			Reference<const ArenaPage> leaf;
+			// The level 2 page whose child links are being preloaded and the last link preloaded from it
+			Reference<const ArenaPage> parent;
+			BTreePage::BinaryTree::Cursor link;
+			bool parentDone;
+			// Leaves preloaded which the cursor has not reached yet
+			int ahead;
+		};
+		Optional<RangePrefetch> rangePrefetch;
+
 	public:
 		BTreeCursor() : reason(PagerEventReasons::MAXEVENTREASONS) {}
 
@@ -7735,6 +8098,25 @@ public:
 		PathEntry& back() { return path.back(); }
 		void popPath() { path.pop_back(); }
 
+		// Under the scan resistant page cache policy, background reads such as fetchKeys, consistency scans and audits
+		// can still use and add to the page cache but won't protect the pages they touch from eviction.
+		bool readCountsAsHit() const {
+			if (!SERVER_KNOBS->REDWOOD_PAGE_CACHE_SCAN_RESISTANT || !options.present()) {
+				return true;
+			}
+			return options.get().cacheResult && options.get().type != ReadType::FETCH &&
+			       options.get().type != ReadType::LOW;
+		}
+
+		// Point reads on leaf pages are the bulk of the seeks done by cursors, so when leaf pages keep their decode
+		// caches they also keep a search index for them.
+		static void buildLeafSearchIndex(const ArenaPage* page, BTreePage::BinaryTree::Cursor& cursor) {
+			if (SERVER_KNOBS->REDWOOD_LEAF_SEARCH_INDEX && page->extra.valid() &&
+			    ((const BTreePage*)page->data())->isLeaf()) {
+				cursor.buildSearchIndex();
+			}
+		}
+
 		Future<Void> pushPage(const BTreePage::BinaryTree::Cursor& link) {
 			debug_printf("pushPage(link=%s)\n", link.get().toString(false).c_str());
 			return map(readPage(btree,
@@ -7744,9 +8126,11 @@ public:
 			                    link.get().getChildPage(),
 			                    ioMaxPriority,
 			                    false,
-			                    !options.present() || options.get().cacheResult || path.back().btPage()->height != 2),
+			                    !options.present() || options.get().cacheResult || path.back().btPage()->height != 2,
+			                    !readCountsAsHit()),
 			           [=](Reference<const ArenaPage> p) {
 				           BTreePage::BinaryTree::Cursor cursor = btree->getCursor(p.getPtr(), link);
+				           buildLeafSearchIndex(p.getPtr(), cursor);
 #if REDWOOD_DEBUG
 				           path.push_back({ p, cursor, link.get().getChildPage() });
 #else
@@ -7773,10 +8157,12 @@ public:
 			debug_printf("pushPage(root=%s)\n", ::toString(id).c_str());
 			return map(readPage(btree, reason, btree->m_header.height, pager.getPtr(), id, ioMaxPriority, false, true),
 			           [=](Reference<const ArenaPage> p) {
+				           BTreePage::BinaryTree::Cursor cursor = btree->getCursor(p.getPtr(), dbBegin, dbEnd);
+				           buildLeafSearchIndex(p.getPtr(), cursor);
 #if REDWOOD_DEBUG
-				           path.push_back({ p, btree->getCursor(p.getPtr(), dbBegin, dbEnd), id });
+				           path.push_back({ p, cursor, id });
 #else
-					    path.push_back({ p, btree->getCursor(p.getPtr(), dbBegin, dbEnd) });
+					    path.push_back({ p, cursor });
 #endif
 				           return Void();
 			           });
@@ -7795,6 +8181,7 @@ public:
 			path.clear();
 			path.reserve(6);
 			valid = false;
+			rangePrefetch.reset();
 			return root.empty() ? Void() : pushPage(root);
 		}
 
@@ -7807,14 +8194,41 @@ public:
 		//     If there is a record in the tree > query then moveNext() will move to it.
 		// If non-zero is returned then the cursor is valid and the return value is logically equivalent
 		// to query.compare(cursor.get())
-		ACTOR Future<int> seek_impl(BTreeCursor* self, RedwoodRecordRef query) {
+		// With useKeyFilter, the leaf page query would be in is skipped if its key filter shows that query's key can't
+		// be in it, leaving the cursor invalid at the leaf's parent, and otherwise the leaf's filter is built if it has
+		// none. This is only useful for point reads, which don't need the records around query.
+		// With reusePath, the seek starts from the deepest page on the current path whose key range contains query
+		// rather than from the root, which saves the internal page lookups shared by a batch of nearby point reads.
+		ACTOR Future<int> seek_impl(BTreeCursor* self, RedwoodRecordRef query, bool useKeyFilter, bool reusePath) {
 			state RedwoodRecordRef internalPageQuery = query.withMaxPageID();
-			self->path.resize(1);
+			state LogicalPageID leafID = invalidLogicalPageID;
+			state bool buildFilter = false;
+			int keep = 1;
+			if (reusePath) {
+				// path[keep] is the child page linked by path[keep - 1]'s cursor, covering [link, next link)
+				while (keep < self->path.size()) {
+					const BTreePage::BinaryTree::Cursor& link = self->path[keep - 1].cursor;
+					if (!link.valid() || !(link.get() < internalPageQuery) ||
+					    link.next().getOrUpperBound() < internalPageQuery) {
+						break;
+					}
+					++keep;
+				}
+				if (keep > 1) {
+					++g_redwoodMetrics.metric.btreeSeekPathReuse;
+				}
+			}
+			self->path.resize(keep);
 			debug_printf("seek(%s) start cursor = %s\n", query.toString().c_str(), self->toString().c_str());
 
 			loop {
 				auto& entry = self->path.back();
 				if (entry.btPage()->isLeaf()) {
+					if (buildFilter) {
+						self->pager->setPageFilter(
+						    leafID,
+						    LeafKeyFilter::build(entry.cursor, SERVER_KNOBS->REDWOOD_LEAF_KEY_FILTER_BITS_PER_KEY));
+					}
 					int cmp = entry.cursor.seek(query);
 					self->valid = entry.cursor.valid() && !entry.cursor.isErased();
 					debug_printf("seek(%s) loop exit cmp=%d cursor=%s\n",
@@ -7831,6 +8245,19 @@ public:
 				if (entry.cursor.seekLessThan(internalPageQuery) && entry.cursor.get().value.present()) {
 					debug_printf(
 					    "seek(%s) loop seek success cursor=%s\n", query.toString().c_str(), self->toString().c_str());
+					if (useKeyFilter && entry.btPage()->height == 2) {
+						leafID = entry.cursor.get().getChildPage().front();
+						Optional<Standalone<StringRef>> filter = self->pager->getPageFilter(leafID);
+						if (filter.present() && !LeafKeyFilter::mayContain(filter.get(), query.key)) {
+							++g_redwoodMetrics.metric.btreeLeafFilterSkip;
+							self->valid = false;
+							debug_printf("seek(%s) loop exit filtered cursor=%s\n",
+							             query.toString().c_str(),
+							             self->toString().c_str());
+							return 0;
+						}
+						buildFilter = !filter.present();
+					}
 					Future<Void> f = self->pushPage(entry.cursor);
 					wait(f);
 				} else {
@@ -7842,75 +8269,220 @@ public:
 			}
 		}
 
-		Future<int> seek(RedwoodRecordRef query) { return path.empty() ? 0 : seek_impl(this, query); }
+		Future<int> seek(RedwoodRecordRef query, bool useKeyFilter = false, bool reusePath = false) {
+			rangePrefetch.reset();
+			return path.empty() ? 0 : seek_impl(this, query, useKeyFilter, reusePath);
+		}
 
-		ACTOR Future<Void> seekGTE_impl(BTreeCursor* self, RedwoodRecordRef query) {
+		// With useKeyFilter, the cursor may be left invalid instead of moving past a leaf page which does not contain
+		// query's key, see seek()
+		ACTOR Future<Void> seekGTE_impl(BTreeCursor* self, RedwoodRecordRef query, bool useKeyFilter, bool reusePath) {
 			debug_printf("seekGTE(%s) start\n", query.toString().c_str());
-			int cmp = wait(self->seek(query));
+			int cmp = wait(self->seek(query, useKeyFilter, reusePath));
+			if (useKeyFilter && !self->path.empty() && !self->path.back().btPage()->isLeaf()) {
+				return Void();
+			}
 			if (cmp > 0 || (cmp == 0 && !self->isValid())) {
 				wait(self->moveNext());
 			}
 			return Void();
 		}
 
-		Future<Void> seekGTE(RedwoodRecordRef query) { return seekGTE_impl(this, query); }
+		Future<Void> seekGTE(RedwoodRecordRef query, bool useKeyFilter = false, bool reusePath = false) {
+			return seekGTE_impl(this, query, useKeyFilter, reusePath);
+		}
 
-		// Start fetching sibling nodes in the forward or backward direction, stopping after recordLimit or byteLimit
+		// Start fetching sibling nodes in the forward or backward direction, stopping after recordLimit or byteLimit.
+		// Up to REDWOOD_KVSTORE_RANGE_PREFETCH_LEAVES leaves ahead of the cursor are read concurrently, and the window
+		// is topped up each time the cursor moves to another leaf, including leaves under later level 2 pages, until
+		// the limits or rangeEnd are reached or the cursor is seeked elsewhere.
 		void prefetch(KeyRef rangeEnd, bool directionForward, int recordLimit, int byteLimit) {
+			rangePrefetch.reset();
+
 			// Prefetch scans level 2 so if there are less than 2 nodes in the path there is no level 2
 			if (path.size() < 2) {
 				return;
 			}
 
 			auto firstLeaf = path.back().btPage();
+			ASSERT(path[path.size() - 2].btPage()->height == 2);
+
+			RangePrefetch p;
+			p.rangeEnd = rangeEnd;
+			p.forward = directionForward;
 
 			// We know the first leaf's record count, so assume they are all relevant to the query,
 			// even though some may not be.
-			int recordsRead = firstLeaf->tree()->numItems;
+			p.recordsLeft = recordLimit - firstLeaf->tree()->numItems;
 
 			// We can't know for sure how many records are in a node without reading it, so just guess
 			// that siblings have about the same record count as the first leaf.
-			int estRecordsPerPage = recordsRead;
+			p.estRecordsPerPage = firstLeaf->tree()->numItems;
 
 			// Use actual KVBytes stored for the first leaf, but use node capacity for siblings below
-			int bytesRead = firstLeaf->kvBytes;
+			p.bytesLeft = (int64_t)byteLimit - firstLeaf->kvBytes;
 
-			// Cursor for moving through siblings.
-			// Note that only immediate siblings under the same parent are considered for prefetch so far.
-			BTreePage::BinaryTree::Cursor c = path[path.size() - 2].cursor;
-			ASSERT(path[path.size() - 2].btPage()->height == 2);
+			p.leaf = path.back().page;
+			p.parent = path[path.size() - 2].page;
+			p.link = path[path.size() - 2].cursor;
+			p.parentDone = false;
+			p.ahead = 0;
+			rangePrefetch = p;
+			continuePrefetch();
+		}
+
+		// Called whenever the cursor may have reached another leaf, to keep the prefetch window full
+		void continuePrefetch() {
+			if (!rangePrefetch.present() || path.size() < 2 || !path.back().btPage()->isLeaf()) {
+				return;
+			}
+
+			RangePrefetch& p = rangePrefetch.get();
+			if (path.back().page != p.leaf) {
+				p.leaf = path.back().page;
+				if (p.ahead > 0) {
+					--p.ahead;
+				}
+			}
+
+			// Once the cursor reaches a leaf under another parent, carry on preloading from that parent's child links.
+			// The leaves ahead of it under the old parent have all been reached by now.
+			const PathEntry& parent = path[path.size() - 2];
+			if (parent.page != p.parent) {
+				CODE_PROBE(true, "Redwood range prefetch continued under the next parent");
+				p.parent = parent.page;
+				p.link = parent.cursor;
+				p.parentDone = false;
+				p.ahead = 0;
+			}
 
 			// The loop conditions are split apart into different if blocks for readability.
-			// While query limits are not exceeded
-			while (recordsRead < recordLimit && bytesRead < byteLimit) {
+			// While query limits are not exceeded and the window is not full
+			while (!p.parentDone && p.ahead < SERVER_KNOBS->REDWOOD_KVSTORE_RANGE_PREFETCH_LEAVES &&
+			       p.recordsLeft > 0 && p.bytesLeft > 0) {
 				// If prefetching right siblings
-				if (directionForward) {
-					// If there is no right sibling or its lower boundary is greater
-					// or equal to than the range end then stop.
-					if (!c.moveNext() || c.get().key >= rangeEnd) {
+				if (p.forward) {
+					// If there is no right sibling then wait for the cursor to move to the next parent, and if
+					// its lower boundary is greater than or equal to the range end then stop.
+					if (!p.link.moveNext()) {
+						p.parentDone = true;
 						break;
 					}
+					if (p.link.get().key >= p.rangeEnd) {
+						rangePrefetch.reset();
+						return;
+					}
 				} else {
 					// Prefetching left siblings
-					// If the current leaf lower boundary is less than or equal to the range end
-					// or there is no left sibling then stop
-					if (c.get().key <= rangeEnd || !c.movePrev()) {
+					// If the current leaf lower boundary is less than or equal to the range end then stop, and
+					// if there is no left sibling then wait for the cursor to move to the previous parent.
+					if (p.link.get().key <= p.rangeEnd) {
+						rangePrefetch.reset();
+						return;
+					}
+					if (!p.link.movePrev()) {
+						p.parentDone = true;
 						break;
 					}
 				}
 
 				// Prefetch the sibling if the link is not null
-				if (c.get().value.present()) {
-					BTreeNodeLinkRef childPage = c.get().getChildPage();
-					if (childPage.size() > 0)
+				if (p.link.get().value.present()) {
+					BTreeNodeLinkRef childPage = p.link.get().getChildPage();
+					if (childPage.size() > 0) {
 						preLoadPage(pager.getPtr(), childPage, ioLeafPriority);
-					recordsRead += estRecordsPerPage;
+						++p.ahead;
+					}
+					p.recordsLeft -= p.estRecordsPerPage;
 					// Use sibling node capacity as an estimate of bytes read.
-					bytesRead += childPage.size() * this->btree->m_blockSize;
+					p.bytesLeft -= childPage.size() * this->btree->m_blockSize;
 				}
 			}
 		}
 
+		// Estimates the bytes of the records from this cursor's record through end's record, inclusive, from only the
+		// pages already on the two cursors' paths, which must be valid cursors into the same snapshot with this one
+		// not after end. The leaves at either end are counted exactly. Each subtree between the two paths is assumed
+		// to hold as many bytes per block as those leaves, and as many children per internal page as the internal
+		// pages on the paths at its height.
+		int64_t estimateBytesTo(const BTreeCursor& end) const {
+			ASSERT(valid && end.valid && path.size() == end.path.size());
+			const PathEntry& first = path.back();
+			const PathEntry& last = end.path.back();
+			int64_t bytes = 0;
+
+			if (first.page == last.page) {
+				for (BTreePage::BinaryTree::Cursor c = first.cursor; c.valid(); c.moveNext()) {
+					bytes += c.get().kvBytes();
+					if (c == last.cursor) {
+						break;
+					}
+				}
+				return bytes;
+			}
+
+			for (BTreePage::BinaryTree::Cursor c = first.cursor; c.valid(); c.moveNext()) {
+				bytes += c.get().kvBytes();
+			}
+			for (BTreePage::BinaryTree::Cursor c = last.cursor; c.valid(); c.movePrev()) {
+				bytes += c.get().kvBytes();
+			}
+
+			// The leaves differ, so there is at least one internal page above them
+			int leafIndex = path.size() - 1;
+			int leafBlocks = path[leafIndex - 1].cursor.get().getChildPage().size() +
+			                 end.path[leafIndex - 1].cursor.get().getChildPage().size();
+			double bytesPerBlock = (double)(first.btPage()->kvBytes + last.btPage()->kvBytes) / leafBlocks;
+
+			// Estimated bytes beneath a page of each height, where leaves are assumed to be one block
+			std::vector<double> subtreeBytes(path.size() + 1);
+			subtreeBytes[1] = bytesPerBlock;
+			for (int height = 2; height < path.size(); ++height) {
+				int i = path.size() - height;
+				double fanout = (path[i].btPage()->tree()->numItems + end.path[i].btPage()->tree()->numItems) / 2.0;
+				subtreeBytes[height] = fanout * subtreeBytes[height - 1];
+			}
+
+			auto linkBytes = [&](const BTreePage::BinaryTree::Cursor& link, int childHeight) -> double {
+				if (!link.get().value.present()) {
+					return 0;
+				}
+				if (childHeight == 1) {
+					return link.get().getChildPage().size() * bytesPerBlock;
+				}
+				return subtreeBytes[childHeight];
+			};
+
+			// The deepest page the two paths share, where they take different links
+			int shared = 0;
+			while (path[shared + 1].page == end.path[shared + 1].page) {
+				++shared;
+			}
+
+			// Count the links between the two paths, which are those between the links the paths take in the shared
+			// page, and those after this path's links and before end's path's links in the pages below it.
+			double covered = 0;
+			for (int i = shared; i < leafIndex; ++i) {
+				int childHeight = path.size() - i - 1;
+				BTreePage::BinaryTree::Cursor c = path[i].cursor;
+				if (i == shared) {
+					while (c.moveNext() && !(c == end.path[i].cursor)) {
+						covered += linkBytes(c, childHeight);
+					}
+				} else {
+					while (c.moveNext()) {
+						covered += linkBytes(c, childHeight);
+					}
+					c = end.path[i].cursor;
+					while (c.movePrev()) {
+						covered += linkBytes(c, childHeight);
+					}
+				}
+			}
+
+			return bytes + (int64_t)covered;
+		}
+
 		ACTOR Future<Void> seekLT_impl(BTreeCursor* self, RedwoodRecordRef query) {
 			debug_printf("seekLT(%s) start\n", query.toString().c_str());
 			int cmp = wait(self->seek(query));
@@ -7976,6 +8548,7 @@ public:
 			}
 
 			self->valid = true;
+			self->continuePrefetch();
 
 			debug_printf("move%s() exit cursor=%s\n", forward ? "Next" : "Prev", self->toString(1).c_str());
 			return Void();
@@ -8131,6 +8704,16 @@ public:
 
 	StorageBytes getStorageBytes() const override { return m_tree->getStorageBytes(); }
 
+	int64_t getConfiguredCacheSize() const override { return m_tree->getConfiguredPageCacheSize(); }
+	void setCacheSizeLimit(int64_t bytes) override { m_tree->setPageCacheSizeLimit(bytes); }
+
+	// A Redwood file keeps the page size it was created with, so when REDWOOD_DEFAULT_PAGE_SIZE is changed for a
+	// process its existing storage servers must be replaced, such as by the perpetual storage wiggle, to use it.
+	bool isWrongConfigured() const override {
+		return m_init.isReady() && !m_init.isError() &&
+		       m_tree->getLogicalPageSize() != SERVER_KNOBS->REDWOOD_DEFAULT_PAGE_SIZE;
+	}
+
 	Future<Void> getError() const override { return delayed(getErrorNoDelay()); }
 
 	Future<Void> getErrorNoDelay() const { return m_errorPromise.getFuture() || m_tree->getError(); };
@@ -8145,6 +8728,15 @@ public:
 		m_tree->set(keyValue);
 	}
 
+	// Fetched blocks are sorted, so they go into the mutation buffer as one run without copying their values
+	Future<Void> replaceRange(KeyRange range, Standalone<VectorRef<KeyValueRef>> data) override {
+		debug_printf("REPLACERANGE %s %d pairs\n", printable(range).c_str(), data.size());
+		if (!range.empty()) {
+			m_tree->replaceRange(range, data, data.arena());
+		}
+		return Void();
+	}
+
 	Future<RangeResult> readRange(KeyRangeRef keys,
 	                              int rowLimit,
 	                              int byteLimit,
@@ -8302,7 +8894,7 @@ public:
 		    &cur, self->m_tree->getLastCommittedVersion(), PagerEventReasons::PointRead, options));
 
 		++g_redwoodMetrics.metric.opGet;
-		wait(cur.seekGTE(key));
+		wait(cur.seekGTE(key, SERVER_KNOBS->REDWOOD_LEAF_KEY_FILTER_MEMORY > 0));
 		if (cur.isValid() && cur.get().key == key) {
 			// Return a Value whose arena depends on the source page arena
 			Value v;
@@ -8328,6 +8920,62 @@ public:
 		}));
 	}
 
+	// The keys are looked up in order with one cursor, so each seek only descends from the lowest page on the previous
+	// key's path which also covers the next key.
+	ACTOR static Future<std::vector<Optional<Value>>> readValues_impl(KeyValueStoreRedwood* self,
+	                                                                  Standalone<VectorRef<KeyRef>> keys,
+	                                                                  std::vector<int> maxLengths,
+	                                                                  Optional<ReadOptions> options) {
+		state VersionedBTree::BTreeCursor cur;
+		wait(self->m_tree->initBTreeCursor(
+		    &cur, self->m_tree->getLastCommittedVersion(), PagerEventReasons::PointRead, options));
+
+		state std::vector<Optional<Value>> values;
+		state int i = 0;
+		values.reserve(keys.size());
+		for (; i < keys.size(); ++i) {
+			++g_redwoodMetrics.metric.opGet;
+			wait(cur.seekGTE(keys[i], SERVER_KNOBS->REDWOOD_LEAF_KEY_FILTER_MEMORY > 0, true));
+			if (cur.isValid() && cur.get().key == keys[i]) {
+				Value v;
+				v.arena().dependsOn(cur.back().page->getArena());
+				v.contents() = cur.get().value.get();
+				if (!maxLengths.empty() && v.size() > maxLengths[i]) {
+					v.contents() = v.substr(0, maxLengths[i]);
+				}
+				g_redwoodMetrics.kvSizeReadByGet->sample(cur.get().kvBytes());
+				values.push_back(v);
+			} else {
+				values.push_back(Optional<Value>());
+			}
+		}
+		return values;
+	}
+
+	Future<std::vector<Optional<Value>>> readValues(Standalone<VectorRef<KeyRef>> keys,
+	                                                std::vector<int> maxLengths,
+	                                                Optional<ReadOptions> options) override {
+		return catchError(readValues_impl(this, keys, maxLengths, options));
+	}
+
+	ACTOR static Future<Optional<int64_t>> estimateRangeBytes_impl(KeyValueStoreRedwood* self, KeyRange keys) {
+		state VersionedBTree::BTreeCursor first;
+		state VersionedBTree::BTreeCursor last;
+		state Version v = self->m_tree->getLastCommittedVersion();
+		wait(self->m_tree->initBTreeCursor(&first, v, PagerEventReasons::RangeRead) &&
+		     self->m_tree->initBTreeCursor(&last, v, PagerEventReasons::RangeRead));
+		wait(first.seekGTE(keys.begin) && last.seekLT(keys.end));
+
+		if (!first.isValid() || !last.isValid() || first.get().key >= keys.end) {
+			return Optional<int64_t>(0);
+		}
+		return Optional<int64_t>(first.estimateBytesTo(last));
+	}
+
+	Future<Optional<int64_t>> estimateRangeBytes(KeyRangeRef keys) override {
+		return catchError(estimateRangeBytes_impl(this, keys));
+	}
+
 	~KeyValueStoreRedwood() override{};
 
 private:
@@ -8857,6 +9505,8 @@ RedwoodRecordRef randomRedwoodRecordRef(const std::string& keyBuffer, const std:
 void RedwoodMetrics::getFields(TraceEvent* e, std::string* s, bool skipZeroes) {
 	std::pair<const char*, unsigned int> metrics[] = { { "BTreePreload", metric.btreeLeafPreload },
 		                                               { "BTreePreloadExt", metric.btreeLeafPreloadExt },
+		                                               { "BTreeLeafFilterSkip", metric.btreeLeafFilterSkip },
+		                                               { "BTreeSeekPathReuse", metric.btreeSeekPathReuse },
 		                                               { "", 0 },
 		                                               { "OpSet", metric.opSet },
 		                                               { "OpSetKeyBytes", metric.opSetKeyBytes },
@@ -8877,6 +9527,9 @@ void RedwoodMetrics::getFields(TraceEvent* e, std::string* s, bool skipZeroes) {
 		                                               { "PagerProbeMiss", metric.pagerProbeMiss },
 		                                               { "PagerEvictUnhit", metric.pagerEvictUnhit },
 		                                               { "PagerEvictFail", metric.pagerEvictFail },
+		                                               { "PagerCachePromote", metric.pagerCachePromote },
+		                                               { "PagerCacheDemote", metric.pagerCacheDemote },
+		                                               { "PagerEncodeOffloaded", metric.pagerEncodeOffloaded },
 		                                               { "", 0 },
 		                                               { "PagerRemapFree", metric.pagerRemapFree },
 		                                               { "PagerRemapCopy", metric.pagerRemapCopy },
@@ -8916,6 +9569,8 @@ void RedwoodMetrics::getFields(TraceEvent* e, std::string* s, bool skipZeroes) {
 	std::pair<const char*, int64_t> cacheMetrics[] = { { "PageCacheCount", evictor->getCountUsed() },
 		                                               { "PageCacheMoved", evictor->getCountMoved() },
 		                                               { "PageCacheSize", evictor->getSizeUsed() },
+		                                               { "PageCacheProtectedCount", evictor->getCountProtected() },
+		                                               { "PageCacheProtectedSize", evictor->getSizeProtected() },
 		                                               { "DecodeCacheSize", evictor->reservedSize } };
 
 	if (e != nullptr) {
@@ -9016,6 +9671,70 @@ void RedwoodMetrics::getIOLockFields(TraceEvent* e, std::string* s) {
 	}
 }
 
+namespace {
+struct TestCacheObject {
+	bool evictable() const { return true; }
+	Future<Void> onEvictable() const { return Void(); }
+	Future<Void> cancel() const { return Void(); }
+};
+
+// Reads a small working set repeatedly while scanning many more entries once each, then scans some more, and returns
+// how many entries of the working set are still cached
+int scanObjectCache(bool scanResistant) {
+	typedef ObjectCache<int, TestCacheObject> TestCacheT;
+	const int workingSet = 10;
+	const int cacheSize = 100;
+	IKnobCollection::getMutableGlobalKnobCollection().setKnob("redwood_page_cache_scan_resistant",
+	                                                          KnobValueRef::create(bool{ scanResistant }));
+
+	TestCacheT::Evictor evictor(cacheSize);
+	TestCacheT cache(&evictor);
+	for (int i = 0; i < workingSet; ++i) {
+		cache.get(i, 1);
+		cache.get(i, 1);
+	}
+	ASSERT(evictor.getCountProtected() == (scanResistant ? workingSet : 0));
+
+	for (int i = workingSet; i < workingSet + 10 * cacheSize; ++i) {
+		cache.get(i, 1);
+		if (i % (2 * cacheSize) == 0) {
+			for (int j = 0; j < workingSet; ++j) {
+				cache.get(j, 1);
+			}
+		}
+	}
+	for (int i = 0; i < 2 * cacheSize; ++i) {
+		cache.get(-1 - i, 1);
+	}
+	ASSERT(evictor.getSizeUsed() <= cacheSize);
+	ASSERT(evictor.getSizeProtected() <= cacheSize / 2);
+
+	int cached = 0;
+	for (int i = 0; i < workingSet; ++i) {
+		cached += cache.getIfExists(i) != nullptr;
+	}
+
+	Future<Void> cleared = cache.clear();
+	ASSERT(cleared.isReady() && evictor.empty());
+	return cached;
+}
+} // namespace
+
+TEST_CASE("/redwood/correctness/unit/ObjectCache/scanResistant") {
+	bool scanResistant = SERVER_KNOBS->REDWOOD_PAGE_CACHE_SCAN_RESISTANT;
+	double protectedFraction = SERVER_KNOBS->REDWOOD_PAGE_CACHE_PROTECTED_FRACTION;
+	auto& g_knobs = IKnobCollection::getMutableGlobalKnobCollection();
+	g_knobs.setKnob("redwood_page_cache_protected_fraction", KnobValueRef::create(double{ 0.5 }));
+
+	// Under plain LRU the scans flush the working set, while the segmented LRU keeps all of it
+	ASSERT(scanObjectCache(false) == 0);
+	ASSERT(scanObjectCache(true) == 10);
+
+	g_knobs.setKnob("redwood_page_cache_scan_resistant", KnobValueRef::create(bool{ scanResistant }));
+	g_knobs.setKnob("redwood_page_cache_protected_fraction", KnobValueRef::create(double{ protectedFraction }));
+	return Void();
+}
+
 TEST_CASE("/redwood/correctness/unit/RedwoodRecordRef") {
 	ASSERT(RedwoodRecordRef::Delta::LengthFormatSizes[0] == 3);
 	ASSERT(RedwoodRecordRef::Delta::LengthFormatSizes[1] == 4);
@@ -9507,6 +10226,127 @@ TEST_CASE("Lredwood/correctness/unit/deltaTree/RedwoodRecordRef2") {
 	return Void();
 }
 
+// Seeks with a search index must land on the same items as seeks without one
+TEST_CASE("/redwood/correctness/unit/deltaTree/searchIndex") {
+	typedef DeltaTree2<RedwoodRecordRef> Tree;
+	RedwoodRecordRef prev;
+	RedwoodRecordRef next("\xff\xff\xff\xff"_sr);
+
+	// Keys share a long prefix and often the following 8 bytes too, so both the word search and the full comparisons
+	// among equal words are exercised
+	Arena arena;
+	std::string prefix = deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 20));
+	auto randomRecord = [&]() {
+		std::string k = prefix + deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 3));
+		if (deterministicRandom()->coinflip()) {
+			k += std::string(8, 'x');
+			k += deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(0, 3));
+		}
+		RedwoodRecordRef rec;
+		rec.key = StringRef(arena, k);
+		if (deterministicRandom()->coinflip()) {
+			rec.value = StringRef(arena, deterministicRandom()->randomAlphaNumeric(4));
+		}
+		return rec;
+	};
+
+	std::set<RedwoodRecordRef> uniqueItems;
+	const int N = deterministicRandom()->randomInt(1, 500);
+	for (int i = 0; i < N; ++i) {
+		uniqueItems.insert(randomRecord());
+	}
+	std::vector<RedwoodRecordRef> items(uniqueItems.begin(), uniqueItems.end());
+
+	int bufferSize = items.size() * 100;
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[bufferSize]);
+	Tree* tree = (Tree*)buffer.get();
+	tree->build(bufferSize, &items[0], &items[items.size()], &prev, &next);
+
+	Tree::Cursor plain(makeReference<Tree::DecodeCache>(prev, next), tree);
+	Tree::Cursor indexed(makeReference<Tree::DecodeCache>(prev, next), tree);
+	indexed.buildSearchIndex();
+	ASSERT(indexed.hasSearchIndex());
+
+	// Erased items are still in the index
+	for (int i = 0; i < items.size() / 4; ++i) {
+		indexed.erase(items[deterministicRandom()->randomInt(0, items.size())]);
+	}
+	ASSERT(indexed.hasSearchIndex());
+
+	for (int i = 0; i < 10000; ++i) {
+		RedwoodRecordRef query = randomRecord();
+		if (deterministicRandom()->coinflip()) {
+			query = items[deterministicRandom()->randomInt(0, items.size())];
+		}
+		bool found = plain.seekLessThanOrEqual(query);
+		ASSERT(indexed.seekLessThanOrEqual(query) == found);
+		ASSERT(!found || plain.get() == indexed.get());
+		found = plain.seekGreaterThan(query);
+		ASSERT(indexed.seekGreaterThan(query) == found);
+		ASSERT(!found || plain.get() == indexed.get());
+	}
+
+	// Inserting through the DecodeCache drops the index
+	while (true) {
+		RedwoodRecordRef rec = randomRecord();
+		if (uniqueItems.count(rec) == 0) {
+			if (indexed.insert(rec)) {
+				ASSERT(!indexed.hasSearchIndex());
+			}
+			break;
+		}
+	}
+
+	return Void();
+}
+
+TEST_CASE("/redwood/correctness/unit/leafKeyFilter") {
+	typedef DeltaTree2<RedwoodRecordRef> Tree;
+	RedwoodRecordRef prev;
+	RedwoodRecordRef next("\xff\xff\xff\xff"_sr);
+
+	Arena arena;
+	std::set<Key> keys;
+	const int N = deterministicRandom()->randomInt(100, 1000);
+	while (keys.size() < N) {
+		keys.insert(Key(deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(1, 20))));
+	}
+	std::vector<RedwoodRecordRef> items;
+	for (auto& k : keys) {
+		items.push_back(RedwoodRecordRef(k, "v"_sr));
+	}
+
+	int bufferSize = items.size() * 100;
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[bufferSize]);
+	Tree* tree = (Tree*)buffer.get();
+	tree->build(bufferSize, &items[0], &items[items.size()], &prev, &next);
+	Tree::Cursor c(makeReference<Tree::DecodeCache>(prev, next), tree);
+
+	Standalone<StringRef> filter = LeafKeyFilter::build(c, 10);
+	for (auto& k : keys) {
+		ASSERT(LeafKeyFilter::mayContain(filter, k));
+	}
+
+	// 10 bits per key should give about 1% false positives
+	int falsePositives = 0;
+	const int queries = 10000;
+	for (int i = 0; i < queries; ++i) {
+		Key k(deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(21, 30)));
+		falsePositives += LeafKeyFilter::mayContain(filter, k);
+	}
+	printf("leafKeyFilter: %d keys, %d bytes, %d of %d missing keys passed\n",
+	       N,
+	       filter.size(),
+	       falsePositives,
+	       queries);
+	ASSERT(falsePositives < queries / 20);
+
+	// An empty or truncated filter can't rule anything out
+	ASSERT(LeafKeyFilter::mayContain(StringRef(), "a"_sr));
+
+	return Void();
+}
+
 TEST_CASE("Lredwood/correctness/unit/deltaTree/IntIntPair") {
 	const int N = 200;
 	IntIntPair lowerBound = { 0, 0 };
@@ -11576,6 +12416,111 @@ void setAuthMode(EncodingType encodingType) {
 }
 } // anonymous namespace
 
+TEST_CASE("/redwood/correctness/readValues") {
+	state std::string fileName = "unittest.redwood-v1";
+	deleteFile(fileName);
+	state IKeyValueStore* kvs = new KeyValueStoreRedwood(
+	    fileName, UID(), {}, EncryptionAtRestMode::DISABLED, XXHash64, makeReference<NullEncryptionKeyProvider>());
+	wait(kvs->init());
+
+	// Enough records for a multi-level tree, so that consecutive keys share some but not all of their paths
+	state std::map<Key, Value> data;
+	while (data.size() < 20000) {
+		Key k = StringRef(format("key/%08d", deterministicRandom()->randomInt(0, 1e8)));
+		Value v = makeString(deterministicRandom()->randomInt(0, 100));
+		deterministicRandom()->randomBytes(mutateString(v), v.size());
+		data[k] = v;
+		kvs->set(KeyValueRef(k, v));
+	}
+	wait(kvs->commit());
+
+	state int round = 0;
+	state Standalone<VectorRef<KeyRef>> keys;
+	state std::vector<int> maxLengths;
+	state std::vector<Optional<Value>> values;
+	state std::vector<Optional<Value>> prefixes;
+	for (; round < 20; ++round) {
+		keys = Standalone<VectorRef<KeyRef>>();
+		maxLengths.clear();
+		std::set<Key> sample;
+		while (sample.size() < 200) {
+			if (deterministicRandom()->coinflip()) {
+				auto it = data.lower_bound(StringRef(format("key/%08d", deterministicRandom()->randomInt(0, 1e8))));
+				if (it != data.end()) {
+					sample.insert(it->first);
+				}
+			} else {
+				sample.insert(StringRef(format("key/%08d/missing", deterministicRandom()->randomInt(0, 1e8))));
+			}
+		}
+		for (const auto& k : sample) {
+			keys.push_back_deep(keys.arena(), k);
+			maxLengths.push_back(deterministicRandom()->randomInt(0, 120));
+		}
+
+		wait(store(values, kvs->readValues(keys)) && store(prefixes, kvs->readValues(keys, maxLengths)));
+		ASSERT_EQ(values.size(), keys.size());
+		ASSERT_EQ(prefixes.size(), keys.size());
+		for (int i = 0; i < keys.size(); ++i) {
+			auto it = data.find(keys[i]);
+			if (it == data.end()) {
+				ASSERT(!values[i].present() && !prefixes[i].present());
+			} else {
+				ASSERT(values[i].present() && values[i].get() == it->second);
+				int prefixLength = std::min<int>(it->second.size(), maxLengths[i]);
+				ASSERT(prefixes[i].present() && prefixes[i].get() == it->second.substr(0, prefixLength));
+			}
+		}
+	}
+
+	wait(closeKVS(kvs, true /*dispose*/));
+	return Void();
+}
+
+TEST_CASE("/redwood/correctness/estimateRangeBytes") {
+	state std::string fileName = "unittest.redwood-v1";
+	deleteFile(fileName);
+	state IKeyValueStore* kvs = new KeyValueStoreRedwood(
+	    fileName, UID(), {}, EncryptionAtRestMode::DISABLED, XXHash64, makeReference<NullEncryptionKeyProvider>());
+	wait(kvs->init());
+
+	state std::map<Key, Value> data;
+	while (data.size() < 20000) {
+		Key k = StringRef(format("key/%08d", deterministicRandom()->randomInt(0, 1e8)));
+		Value v = makeString(deterministicRandom()->randomInt(0, 100));
+		deterministicRandom()->randomBytes(mutateString(v), v.size());
+		data[k] = v;
+		kvs->set(KeyValueRef(k, v));
+	}
+	wait(kvs->commit());
+
+	state int round = 0;
+	for (; round < 200; ++round) {
+		// Ranges of a few records are within one or two leaves, so they are counted exactly
+		state bool small = deterministicRandom()->coinflip();
+		auto it = data.lower_bound(StringRef(format("key/%08d", deterministicRandom()->randomInt(0, 1e8))));
+		int records = small ? deterministicRandom()->randomInt(0, 5) : deterministicRandom()->randomInt(2000, 20000);
+		Key begin = it == data.end() ? Key("key0"_sr) : it->first;
+		int64_t bytes = 0;
+		for (; it != data.end() && records > 0; ++it, --records) {
+			bytes += it->first.size() + it->second.size();
+		}
+		state KeyRange range = KeyRangeRef(begin, it == data.end() ? Key("key0"_sr) : it->first);
+		state int64_t actual = bytes;
+
+		Optional<int64_t> estimate = wait(kvs->estimateRangeBytes(range));
+		ASSERT(estimate.present());
+		if (small) {
+			ASSERT_EQ(estimate.get(), actual);
+		} else {
+			ASSERT(estimate.get() > actual / 2 && estimate.get() < actual * 2);
+		}
+	}
+
+	wait(closeKVS(kvs, true /*dispose*/));
+	return Void();
+}
+
 TEST_CASE("/redwood/correctness/EnforceEncodingType") {
 	state const std::vector<std::pair<EncodingType, EncodingType>> testCases = {
 		{ XXHash64, XOREncryption_TestOnly }, { AESEncryption, AESEncryptionWithAuth }
@@ -49,6 +49,7 @@
 #include "fdbclient/SimpleIni.h"
 #include "fdbrpc/AsyncFileCached.actor.h"
 #include "fdbrpc/IPAllowList.h"
+#include "fdbrpc/MetricsHttpServer.h"
 #include "fdbrpc/FlowProcess.actor.h"
 #include "fdbrpc/Net2FileSystem.h"
 #include "fdbrpc/PerfMetric.h"
@@ -134,7 +135,8 @@ enum {
 	OPT_METRICSPREFIX, OPT_LOGGROUP, OPT_LOCALITY, OPT_IO_TRUST_SECONDS, OPT_IO_TRUST_WARN_ONLY, OPT_FILESYSTEM, OPT_PROFILER_RSS_SIZE, OPT_KVFILE,
 	OPT_TRACE_FORMAT, OPT_WHITELIST_BINPATH, OPT_BLOB_CREDENTIAL_FILE, OPT_CONFIG_PATH, OPT_USE_TEST_CONFIG_DB, OPT_NO_CONFIG_DB, OPT_FAULT_INJECTION, OPT_PROFILER, OPT_PRINT_SIMTIME,
 	OPT_FLOW_PROCESS_NAME, OPT_FLOW_PROCESS_ENDPOINT, OPT_IP_TRUSTED_MASK, OPT_KMS_CONN_DISCOVERY_URL_FILE, OPT_KMS_CONNECTOR_TYPE, OPT_KMS_REST_ALLOW_NOT_SECURE_CONECTION, OPT_KMS_CONN_VALIDATION_TOKEN_DETAILS,
-	OPT_KMS_CONN_GET_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_LATEST_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_BLOB_METADATA_ENDPOINT, OPT_NEW_CLUSTER_KEY, OPT_AUTHZ_PUBLIC_KEY_FILE, OPT_USE_FUTURE_PROTOCOL_VERSION, OPT_CONSISTENCY_CHECK_URGENT_MODE
+	OPT_KMS_CONN_GET_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_LATEST_ENCRYPTION_KEYS_ENDPOINT, OPT_KMS_CONN_GET_BLOB_METADATA_ENDPOINT, OPT_NEW_CLUSTER_KEY, OPT_AUTHZ_PUBLIC_KEY_FILE, OPT_USE_FUTURE_PROTOCOL_VERSION, OPT_CONSISTENCY_CHECK_URGENT_MODE,
+	OPT_CPU_AFFINITY, OPT_HELPER_CPU_AFFINITY, OPT_METRICS_HTTP_ADDRESS
 };
 
 CSimpleOpt::SOption g_rgOptions[] = {
@@ -184,6 +186,9 @@ CSimpleOpt::SOption g_rgOptions[] = {
 	{ OPT_STORAGEMEMLIMIT,       "-M",                          SO_REQ_SEP },
 	{ OPT_STORAGEMEMLIMIT,       "--storage-memory",            SO_REQ_SEP },
 	{ OPT_CACHEMEMLIMIT,         "--cache-memory",              SO_REQ_SEP },
+	{ OPT_CPU_AFFINITY,          "--cpu-affinity",              SO_REQ_SEP },
+	{ OPT_HELPER_CPU_AFFINITY,   "--helper-cpu-affinity",       SO_REQ_SEP },
+	{ OPT_METRICS_HTTP_ADDRESS,  "--metrics-http-address",      SO_REQ_SEP },
 	{ OPT_MACHINEID,             "-i",                          SO_REQ_SEP },
 	{ OPT_MACHINEID,             "--machine-id",                SO_REQ_SEP },
 	{ OPT_DCID,                  "-a",                          SO_REQ_SEP },
@@ -692,6 +697,19 @@ static void printUsage(const char* name, bool devhelp) {
 	                 " The amount of memory to use for caching disk pages."
 	                 " The default value is 2GiB. When specified without a unit,"
 	                 " MiB is assumed.");
+	printOptionUsage("--cpu-affinity CPUS",
+	                 " Pins the network thread to the first of CPUS, a list like"
+	                 " 0-3,8. Other threads run on the rest of CPUS or, given a"
+	                 " single CPU, on the other hardware threads of its core."
+	                 " Linux only.");
+	printOptionUsage("--helper-cpu-affinity CPUS",
+	                 " CPUs for threads other than the network thread, such as"
+	                 " the storage engine and TLS handshake threads, in place of"
+	                 " those chosen by --cpu-affinity. Linux only.");
+	printOptionUsage("--metrics-http-address ADDRESS",
+	                 " Serves this process's counters and histograms in the"
+	                 " OpenMetrics text format on GET /metrics at ADDRESS,"
+	                 " specified as IP_ADDRESS:PORT. Disabled by default.");
 	printOptionUsage("-c CLASS, --class CLASS",
 	                 " Machine class (valid options are storage, transaction,"
 	                 " resolution, grv_proxy, commit_proxy, master, test, unset, stateless, log, router,"
@@ -710,7 +728,7 @@ static void printUsage(const char* name, bool devhelp) {
 		                 " Server role (valid options are fdbd, test, multitest,"
 		                 " simulation, networktestclient, networktestserver, restore"
 		                 " consistencycheck, consistencycheckurgent, kvfileintegritycheck, kvfilegeneratesums, "
-		                 "kvfiledump, unittests)."
+		                 "kvfiledump, kvstorebench, unittests)."
 		                 " The default is `fdbd'.");
 #ifdef _WIN32
 		printOptionUsage("-n, --newconsole", " Create a new console.");
@@ -779,6 +797,22 @@ static void printUsage(const char* name, bool devhelp) {
 		       " - FDB_DUMP_ENDKEY: end key for the dump, default is \"\\xff\\xff\"\n"
 		       " - FDB_DUMP_DEBUG: print key-values to stderr in escaped format\n");
 
+		printf("\n"
+		       "The 'kvstorebench' role benchmarks a storage engine in the directory 'kvstorebench' under '--datadir'\n"
+		       "(default: the current directory), which it empties first unless told not to load data. It loads a\n"
+		       "dataset, then runs clients issuing a mix of point reads, range reads and writes, and reports their\n"
+		       "throughput and latencies, write amplification and memory. It is configured by --test-PARAMNAME:\n"
+		       " - storeType: engine, as for 'configure' (default: ssd-redwood-1)\n"
+		       " - keyCount, keySize, valueSize: dataset shape (default: 1000000, 32, 100)\n"
+		       " - load: 0 to reuse the dataset of a previous run with keep=1 (default: 1)\n"
+		       " - keep: 1 to keep the store afterwards instead of deleting it (default: 0)\n"
+		       " - seconds, clients: length of the run and concurrent requests (default: 60, 64)\n"
+		       " - readFraction, scanFraction: point and range reads, the rest being writes (default: 0.8, 0.1)\n"
+		       " - scanLength: rows per range read (default: 100)\n"
+		       " - commitSize, commitInterval: writes per commit and seconds between commits (default: 1000, 0.1)\n"
+		       " - memoryLimit, pageCacheBytes: memory engine limit and page cache size (default: 2e9, knob)\n"
+		       "Write amplification is taken from the counters of the whole device holding the directory.\n");
+
 		printf(
 		    "\n"
 		    "The 'changedescription' role replaces the old cluster key in all coordinators' data file to the specified "
@@ -1045,6 +1079,7 @@ enum class ServerRole {
 	KVFileGenerateIOLogChecksums,
 	KVFileIntegrityCheck,
 	KVFileDump,
+	KVStoreBench,
 	MultiTester,
 	NetworkTestClient,
 	NetworkTestServer,
@@ -1084,6 +1119,8 @@ struct CLIOptions {
 	               // SERVER_KNOBS->COMMIT_BATCHES_MEM_BYTES_HARD_LIMIT
 	uint64_t virtualMemLimit = 0; // unlimited
 	uint64_t storageMemLimit = 1LL << 30;
+	std::vector<int> cpuAffinity, helperCpuAffinity;
+	Optional<NetworkAddress> metricsHttpAddress;
 	bool buggifyEnabled = false, faultInjectionEnabled = true, restarting = false;
 	Optional<Standalone<StringRef>> zoneId;
 	Optional<Standalone<StringRef>> dcId;
@@ -1322,6 +1359,8 @@ private:
 					role = ServerRole::KVFileGenerateIOLogChecksums;
 				else if (!strcmp(sRole, "kvfiledump"))
 					role = ServerRole::KVFileDump;
+				else if (!strcmp(sRole, "kvstorebench"))
+					role = ServerRole::KVStoreBench;
 				else if (!strcmp(sRole, "consistencycheck"))
 					role = ServerRole::ConsistencyCheck;
 				else if (!strcmp(sRole, "consistencycheckurgent"))
@@ -1569,6 +1608,31 @@ private:
 				}
 				storageMemLimit = ti.get();
 				break;
+			case OPT_CPU_AFFINITY:
+				if (!parseCpuList(args.OptionArg(), cpuAffinity)) {
+					fprintf(stderr, "ERROR: Could not parse CPU list from `%s'\n", args.OptionArg());
+					printHelpTeaser(argv[0]);
+					flushAndExit(FDB_EXIT_ERROR);
+				}
+				break;
+			case OPT_HELPER_CPU_AFFINITY:
+				if (!parseCpuList(args.OptionArg(), helperCpuAffinity)) {
+					fprintf(stderr, "ERROR: Could not parse CPU list from `%s'\n", args.OptionArg());
+					printHelpTeaser(argv[0]);
+					flushAndExit(FDB_EXIT_ERROR);
+				}
+				break;
+			case OPT_METRICS_HTTP_ADDRESS:
+				try {
+					metricsHttpAddress = NetworkAddress::parse(args.OptionArg());
+				} catch (Error&) {
+					fprintf(stderr,
+					        "ERROR: Could not parse network address `%s' (specify as IP_ADDRESS:PORT)\n",
+					        args.OptionArg());
+					printHelpTeaser(argv[0]);
+					flushAndExit(FDB_EXIT_ERROR);
+				}
+				break;
 			case OPT_CACHEMEMLIMIT:
 				ti = parse_with_suffix(args.OptionArg(), "MiB");
 				if (!ti.present()) {
@@ -1823,7 +1887,7 @@ private:
 		    });
 		if ((role != ServerRole::Simulation && role != ServerRole::CreateTemplateDatabase &&
 		     role != ServerRole::KVFileIntegrityCheck && role != ServerRole::KVFileGenerateIOLogChecksums &&
-		     role != ServerRole::KVFileDump && role != ServerRole::UnitTests) ||
+		     role != ServerRole::KVFileDump && role != ServerRole::KVStoreBench && role != ServerRole::UnitTests) ||
 		    autoPublicAddress) {
 
 			if (seedSpecified && !fileExists(connFile)) {
@@ -2213,6 +2277,25 @@ int main(int argc, char* argv[]) {
 		Future<Void> memoryUsageMonitor = startMemoryUsageMonitor(opts.memLimit);
 		setMemoryQuota(opts.virtualMemLimit);
 
+		if (role != ServerRole::Simulation && (!opts.cpuAffinity.empty() || !opts.helperCpuAffinity.empty())) {
+			std::vector<int> networkCpus;
+			std::vector<int> helperCpus = opts.helperCpuAffinity;
+			if (!opts.cpuAffinity.empty()) {
+				networkCpus.push_back(opts.cpuAffinity[0]);
+				if (helperCpus.empty()) {
+					helperCpus.assign(opts.cpuAffinity.begin() + 1, opts.cpuAffinity.end());
+				}
+				if (helperCpus.empty()) {
+					helperCpus = getCpuSiblings(networkCpus[0]);
+				}
+			}
+			bool placed = setThreadPlacement(networkCpus, helperCpus);
+			TraceEvent(placed ? SevInfo : SevWarnAlways, "ThreadPlacement")
+			    .detail("Applied", placed)
+			    .detail("NetworkThreadCPUs", formatCpuList(networkCpus))
+			    .detail("HelperThreadCPUs", formatCpuList(helperCpus));
+		}
+
 		Future<Optional<Void>> f;
 
 		if (role == ServerRole::Simulation) {
@@ -2402,6 +2485,9 @@ int main(int argc, char* argv[]) {
 				                      opts.configDBType,
 				                      opts.consistencyCheckUrgentMode));
 				actors.push_back(histogramReport());
+				if (opts.metricsHttpAddress.present()) {
+					actors.push_back(metricsHttpServer(opts.metricsHttpAddress.get()));
+				}
 				// actors.push_back( recurring( []{}, .001 ) );  // for ASIO latency measurement
 
 				f = stopAfter(waitForAll(actors));
@@ -2520,6 +2606,9 @@ int main(int argc, char* argv[]) {
 		} else if (role == ServerRole::KVFileDump) {
 			f = stopAfter(KVFileDump(opts.kvFile));
 			g_network->run();
+		} else if (role == ServerRole::KVStoreBench) {
+			f = stopAfter(kvStoreBench(opts.dataFolder.size() ? opts.dataFolder : ".", opts.testParams));
+			g_network->run();
 		} else if (role == ServerRole::ChangeClusterKey) {
 			Key newClusterKey(opts.newClusterKey);
 			Key oldClusterKey = opts.connectionFile->getConnectionString().clusterKey();
@@ -21,6 +21,7 @@
 #ifndef FDBSERVER_BLOBWORKER_H
 #define FDBSERVER_BLOBWORKER_H
 
+#include "fdbclient/BlobGranuleFileCache.h"
 #include "fdbclient/BlobWorkerCommon.h"
 
 #include "fdbserver/BlobGranuleServerCommon.actor.h"
@@ -158,6 +159,8 @@ struct BlobWorkerData : NonCopyable, ReferenceCounted<BlobWorkerData> {
 	// FIXME: refactor out the parts of this that are just for interacting with blob stores from the backup business
 	// logic
 	Reference<BlobConnectionProvider> bstore;
+	// local cache of files read back from bstore, if BLOB_WORKER_DISK_CACHE_BYTES is set
+	Reference<BlobGranuleDiskCache> diskCache;
 	KeyRangeMap<GranuleRangeMetadata> granuleMetadata;
 	BGTenantMap tenantData;
 	Reference<AsyncVar<ServerDBInfo> const> dbInfo;
@@ -213,6 +216,7 @@ struct BlobWorkerData : NonCopyable, ReferenceCounted<BlobWorkerData> {
 	          SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 	    encryptMode(EncryptionAtRestMode::DISABLED) {}
 
+	void initDiskCache(const std::string& folder);
 	bool managerEpochOk(int64_t epoch);
 	bool isFull();
 	void triggerReadDrivenCompaction();
@@ -62,5 +62,15 @@ ACTOR Future<Optional<std::string>> getBytesSamplingFromSSTFiles(std::string fol
 
 void checkContent(std::unordered_set<std::string> dataFiles, UID logId);
 
+// Reads the pairs of the SST files of a bulk load task within range, merged into one sorted stream, and sends them to
+// results in blocks of about blockBytes, the last one with more set to false, as if read from a database. This lets
+// fetchKeys() load a task into a storage engine that can't ingest the files directly. If reading fails,
+// bulkload_task_failed is sent.
+ACTOR Future<Void> bulkLoadReadSSTFiles(PromiseStream<RangeResult> results,
+                                        std::unordered_set<std::string> dataFiles,
+                                        KeyRange range,
+                                        int blockBytes,
+                                        UID logId);
+
 #include "flow/unactorcompiler.h"
 #endif
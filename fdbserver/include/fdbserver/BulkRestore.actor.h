@@ -0,0 +1,47 @@
+/*
+ * BulkRestore.actor.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(NO_INTELLISENSE) && !defined(FDBSERVER_BULKRESTORE_ACTOR_G_H)
+#define FDBSERVER_BULKRESTORE_ACTOR_G_H
+#include "fdbserver/BulkRestore.actor.g.h"
+#elif !defined(FDBSERVER_BULKRESTORE_ACTOR_H)
+#define FDBSERVER_BULKRESTORE_ACTOR_H
+#pragma once
+
+#include "fdbclient/BackupContainer.h"
+#include "fdbclient/NativeAPI.actor.h"
+#include "flow/actorcompiler.h" // has to be last include
+
+// A bulk restore restores a range from a backup without committing the snapshot through transactions. The range files
+// of the snapshot are split into shards of about SERVER_KNOBS->BULK_RESTORE_SHARD_BYTES, each converted into a sorted
+// SST file and ingested by a bulk load task. Once every shard is loaded, the mutation logs are decoded in batches and
+// applied by transactions, in version order within each shard and in parallel across shards.
+//
+// restoreRange must be within normal keys, empty, and not written to by anyone else until the restore is done. folder
+// is where the SST files are written, and must be readable from every storage server. The backup must not be
+// encrypted, and its mutation logs must not be partitioned.
+ACTOR Future<Void> bulkRestore(Database cx,
+                               Reference<IBackupContainer> container,
+                               KeyRange restoreRange,
+                               Version targetVersion,
+                               std::string folder);
+
+#include "flow/unactorcompiler.h"
+#endif
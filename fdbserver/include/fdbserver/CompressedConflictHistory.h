@@ -0,0 +1,95 @@
+/*
+ * CompressedConflictHistory.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_COMPRESSEDCONFLICTHISTORY_H
+#define FDBSERVER_COMPRESSEDCONFLICTHISTORY_H
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fdbclient/FDBTypes.h"
+
+// A memory-compact alternative to the resolver's SkipList version history, selected by
+// RESOLVER_USE_COMPRESSED_CONFLICT_HISTORY.
+//
+// Like the SkipList, it stores a step function over the key space: each entry (key, version) says that every key from
+// key up to the next entry was last written at version. Entries are grouped into blocks of up to MaxBlockEntries,
+// indexed by a std::map on the block's first key. Within a block each key is stored as the length of the prefix it
+// shares with the previous key plus the remaining suffix, and each version as a varint delta below the block's
+// maximum version, so the long and heavily shared keys typical of a wide MVCC window cost a few bytes per entry
+// instead of a full copy plus per-level pointers. The per-block minimum and maximum versions let reads skip blocks
+// with no writes newer than the read snapshot, and let removeBefore() skip blocks with nothing to forget, without
+// decoding them.
+class CompressedConflictHistory : NonCopyable {
+public:
+	static constexpr int MaxBlockEntries = 64;
+
+	explicit CompressedConflictHistory(Version version = 0);
+
+	// Returns true if any key in [begin, end) was written after version. As with the SkipList, an empty range checks
+	// the version of the key begin.
+	bool anyWriteAfter(StringRef begin, StringRef end, Version version) const;
+
+	// Records that every key in each of the ranges was written at version. The ranges must be sorted and disjoint.
+	void addConflictRanges(const std::pair<StringRef, StringRef>* ranges, int count, Version version);
+
+	// Versions older than oldestVersion no longer affect any check, so adjacent entries older than it can be merged.
+	// Examines roughly maxEntries entries, resuming where the previous call stopped and wrapping around at the end.
+	void removeBefore(Version oldestVersion, int maxEntries);
+
+	int64_t entryCount() const;
+	size_t blockCount() const { return blocks.size(); }
+	// Approximate heap footprint, including the index
+	int64_t bytes() const;
+
+private:
+	struct Block {
+		std::string data; // count entries, the first with no shared prefix
+		int count = 0;
+		Version minVersion = 0;
+		Version maxVersion = 0;
+	};
+
+	struct Entry {
+		StringRef key;
+		Version version;
+	};
+
+	using BlockMap = std::map<Key, Block, std::less<>>;
+
+	BlockMap::const_iterator blockContaining(StringRef key) const;
+	static void decode(const Block& block, std::vector<Entry>& entries, Arena& arena);
+	// Appends (key, version) to a step function being built, dropping entries that don't change the version
+	static void pushEntry(std::vector<Entry>& out, StringRef key, Version version);
+	// Replaces the blocks [first, last) with blocks holding entries
+	BlockMap::iterator replaceBlocks(BlockMap::iterator first,
+	                                 BlockMap::iterator last,
+	                                 const std::vector<Entry>& entries);
+
+	// Always holds a block whose first key is the empty key, so every key is covered by some entry
+	BlockMap blocks;
+	Key removalCursor;
+};
+
+#endif
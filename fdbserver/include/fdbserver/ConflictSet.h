@@ -29,9 +29,14 @@
 #include "fdbserver/ResolverBug.h"
 
 struct ConflictSet;
-ConflictSet* newConflictSet();
+// parallelism > 1 lets ConflictBatch::detectConflicts split the work for large batches over that many key space
+// partitions, each processed on its own thread (see RESOLVER_CONFLICT_DETECTION_PARALLELISM). compressedHistory
+// stores the write history in a CompressedConflictHistory instead of the SkipList; write insertion is then serial.
+ConflictSet* newConflictSet(int parallelism = 1, bool compressedHistory = false);
 void clearConflictSet(ConflictSet*, Version);
 void destroyConflictSet(ConflictSet*);
+// Approximate memory used by the write history. Walks the whole structure, so not for use on every batch.
+int64_t getConflictSetBytes(ConflictSet*);
 
 struct ConflictBatch {
 	explicit ConflictBatch(ConflictSet*,
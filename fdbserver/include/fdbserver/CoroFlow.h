@@ -25,6 +25,7 @@
 #pragma once
 
 #include "fdbrpc/fdbrpc.h"
+#include "fdbrpc/simulator.h"
 #include "flow/IThreadPool.h"
 
 class CoroThreadPool {
@@ -39,6 +40,19 @@ protected:
 	~CoroThreadPool() {}
 };
 
+// A pool for CPU bound work whose only effect is what it sends back, such as encryption and page encoding. In
+// simulation its threads are coroutines on the network thread, unless FLOW_KNOBS->SIM_POOL_THREADS real threads may
+// run its actions alongside the simulation without changing its outcome.
+inline Reference<IThreadPool> createPureWorkThreadPool() {
+	if (!g_network->isSimulated()) {
+		return createGenericThreadPool();
+	}
+	if (FLOW_KNOBS->SIM_POOL_THREADS > 0) {
+		return createDeterministicThreadPool();
+	}
+	return CoroThreadPool::createThreadPool();
+}
+
 template <class T>
 inline T waitForAndGet(Future<T> f) {
 	if (!f.isReady())
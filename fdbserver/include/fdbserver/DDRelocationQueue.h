@@ -115,6 +115,7 @@ struct DDQueueInitParams {
 	PromiseStream<Promise<int64_t>> const& getAverageShardBytes;
 	int const& teamSize;
 	int const& singleRegionTeamSize;
+	KeyValueStoreType storageServerStoreType;
 	PromiseStream<RelocateShard> const& relocationProducer;
 	FutureStream<RelocateShard> const& relocationConsumer;
 	PromiseStream<GetMetricsRequest> const& getShardMetrics;
@@ -258,6 +259,7 @@ public:
 	int64_t bytesWritten;
 	int teamSize;
 	int singleRegionTeamSize;
+	KeyValueStoreType storageServerStoreType; // The configured storage engine, which decides the default data move type
 
 	std::map<UID, Busyness> busymap; // UID is serverID
 	std::map<UID, Busyness> destBusymap; // UID is serverID
@@ -86,6 +86,8 @@ public:
 
 	// Read hot detection
 	PromiseStream<KeyRange> readHotShard;
+	// The read hot ranges assigned to storage cache servers, with the last time each was found read hot
+	std::vector<std::pair<KeyRange, double>> cachedReadHotRanges;
 
 	// The reference to trackerCancelled must be extracted by actors,
 	// because by the time (trackerCancelled == true) this memory cannot
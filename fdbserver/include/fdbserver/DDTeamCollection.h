@@ -456,6 +456,10 @@ protected:
 	// Return a vector of futures wait for all data is moved to other teams.
 	Future<Void> excludeStorageServersForWiggle(const UID& id);
 
+	// Marks the server's address as wiggling, returns the future set once it is removed unless the address is already
+	// excluded for another reason
+	Optional<Future<Void>> excludeStorageServerForWiggle(const Reference<TCServerInfo>& info);
+
 	// Include wiggled storage servers by setting their status from `WIGGLING`
 	// to `NONE`. The storage recruiter will recruit them as new storage servers
 	void includeStorageServersForWiggle();
@@ -136,6 +136,10 @@ public:
 
 	virtual Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(KeyRange const& keys) const = 0;
 
+	// Adds keys to, or removes them from, the ranges held by storage cache servers. Returns false without changing
+	// anything if keys are to be added and the cluster has no cache servers.
+	virtual Future<bool> changeCachedRange(KeyRange const& keys, bool add) const = 0;
+
 	virtual Future<HealthMetrics> getHealthMetrics(bool detailed = false) const = 0;
 
 	virtual Future<Optional<Value>> readRebalanceDDIgnoreKey() const = 0;
@@ -221,6 +225,8 @@ public:
 
 	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(KeyRange const& keys) const override;
 
+	Future<bool> changeCachedRange(KeyRange const& keys, bool add) const override;
+
 	Future<HealthMetrics> getHealthMetrics(bool detailed) const override;
 
 	Future<Optional<Value>> readRebalanceDDIgnoreKey() const override;
@@ -301,6 +307,8 @@ public:
 		UNREACHABLE();
 	}
 
+	Future<bool> changeCachedRange(KeyRange const& keys, bool add) const override { UNREACHABLE(); }
+
 	Future<HealthMetrics> getHealthMetrics(bool detailed = false) const override;
 
 	Future<std::vector<ProcessData>> getWorkers() const override;
@@ -60,6 +60,7 @@ public:
 		SIZE_SPLIT,
 		WRITE_SPLIT,
 		TENANT_SPLIT,
+		READ_SPLIT,
 		__COUNT
 	};
 	RelocateReason(Value v) : value(v) { ASSERT(value != __COUNT); }
@@ -82,6 +83,8 @@ public:
 			return "WriteSplit";
 		case TENANT_SPLIT:
 			return "TenantSplit";
+		case READ_SPLIT:
+			return "ReadSplit";
 		case __COUNT:
 			ASSERT(false);
 		}
@@ -775,6 +778,10 @@ struct StorageWiggler : ReferenceCounted<StorageWiggler> {
 
 	// It's guarantee that When a.metadata >= b.metadata, if !necessary(a) then !necessary(b)
 	bool necessary(const UID& serverId, const StorageMetadataType& metadata) const;
+	// whether the server is still queued and necessary to wiggle
+	bool necessary(const UID& serverId) const;
+	// bytes that wiggling the server would have to move, if its metrics are known
+	Optional<int64_t> estimatedWiggleBytes(const UID& serverId) const;
 
 	// try to return the next storage server that is necessary to wiggle
 	Optional<UID> getNextServerId(bool necessaryOnly = true);
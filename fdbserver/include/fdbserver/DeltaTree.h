@@ -24,6 +24,8 @@
 #include "flow/Arena.h"
 #include "fdbclient/FDBTypes.h"
 #include "fdbserver/Knobs.h"
+#include <concepts>
+#include <memory>
 #include <string.h>
 
 #define DELTATREE_DEBUG 0
@@ -939,6 +941,16 @@ private:
 //    // For debugging, return a useful human-readable string representation of *this
 //    std::string toString() const;
 //
+// T types which can be searched with a DeltaTree2 search index, see DeltaTree2::Cursor::buildSearchIndex()
+//
+//    // Returns the bytes of the key starting at skipLen, as a fixed width integer which orders the same as the keys it
+//    // was taken from except that different keys may produce the same word.
+//    uint64_t getSearchWord(int skipLen) const;
+template <typename T>
+concept DeltaTreeSearchable = requires(const T& t) {
+	{ t.getSearchWord(0) } -> std::convertible_to<uint64_t>;
+};
+
 #pragma pack(push, 1)
 template <typename T, typename DeltaT = typename T::Delta>
 struct DeltaTree2 {
@@ -1093,11 +1105,27 @@ public:
 		// Index 0 is always the root
 		std::vector<DecodedNode> decodedNodes;
 
+		// Every node of one version of the tree in sorted order, along with the search word of each node's item.
+		// Only valid for the tree it was built from, as long as nothing has been inserted through this DecodeCache.
+		struct SearchIndex {
+			const DeltaTree2* tree;
+			uint32_t nodeBytesUsed;
+			// Length of the prefix shared by every item in the tree, which the search words start after
+			int prefixLen;
+			std::vector<uint64_t> words;
+			std::vector<int16_t> nodeIndexes;
+		};
+		std::unique_ptr<SearchIndex> searchIndex;
+
 		DecodedNode& get(int index) { return decodedNodes[index]; }
 
 		void updateUsedMemory() {
 			int usedNow = sizeof(DeltaTree2) + arena.getSize(FastInaccurateEstimate::True) +
 			              (decodedNodes.capacity() * sizeof(DecodedNode));
+			if (searchIndex) {
+				usedNow += sizeof(SearchIndex) + searchIndex->words.capacity() * sizeof(uint64_t) +
+				           searchIndex->nodeIndexes.capacity() * sizeof(int16_t);
+			}
 			if (pMemoryTracker != nullptr) {
 				*pMemoryTracker += (usedNow - lastKnownUsedMemory);
 			}
@@ -1115,6 +1143,7 @@ public:
 
 		void clear() {
 			decodedNodes.clear();
+			searchIndex.reset();
 			Arena a;
 			lowerBound = T(a, lowerBound);
 			upperBound = T(a, upperBound);
@@ -1351,6 +1380,12 @@ public:
 		// Otherwise, returns the result of s.compare(item at cursor position)
 		// Does not skip/avoid deleted nodes.
 		int seek(const T& s, int skipLen = 0) {
+			if constexpr (DeltaTreeSearchable<T>) {
+				if (hasSearchIndex()) {
+					return seekIndexed(s, skipLen);
+				}
+			}
+
 			nodeIndex = -1;
 			item.reset();
 			deltatree_printf("seek(%s) start %s\n", s.toString().c_str(), toString().c_str());
@@ -1376,6 +1411,112 @@ public:
 			return cmp;
 		}
 
+		// Whether the DecodeCache holds a search index which is valid for this cursor's tree
+		bool hasSearchIndex() const {
+			if (!cache->searchIndex) {
+				return false;
+			}
+			const auto& index = *cache->searchIndex;
+			return index.tree == tree && index.nodeBytesUsed == tree->nodeBytesUsed;
+		}
+
+		// Builds a search index for this cursor's tree in its DecodeCache, if the DecodeCache has none.
+		// Once it exists, seek() on the tree is a branch-free binary search over the search words of all of the
+		// items followed by full comparisons only among the items whose words are the same as the query's, instead
+		// of a walk down the tree comparing against each node on the path. Building the index decodes every node
+		// once, so it is only worthwhile for a tree which will be searched many times without being modified.
+		// Does not change the cursor position.
+		void buildSearchIndex()
+		    requires DeltaTreeSearchable<T>
+		{
+			// An index for another copy of the tree is kept, so that readers of different versions of a page don't
+			// take turns rebuilding it
+			if (tree->numItems == 0 || cache->searchIndex) {
+				return;
+			}
+
+			auto index = std::make_unique<typename DecodeCache::SearchIndex>();
+			index->tree = tree;
+			index->nodeBytesUsed = tree->nodeBytesUsed;
+			index->nodeIndexes.reserve(tree->numItems);
+
+			// Visit every node in order, including deleted nodes as seek() does
+			Cursor c(cache, tree);
+			int nIndex = c.rootIndex();
+			while (nIndex != -1) {
+				c.nodeIndex = nIndex;
+				nIndex = c.getLeftChildIndex(nIndex);
+			}
+			while (c.valid()) {
+				index->nodeIndexes.push_back(c.nodeIndex);
+				c._moveNext();
+			}
+
+			const T first = get(cache->get(index->nodeIndexes.front()));
+			const T last = get(cache->get(index->nodeIndexes.back()));
+			index->prefixLen = first.getCommonPrefixLen(last, 0);
+			index->words.reserve(index->nodeIndexes.size());
+			for (int i : index->nodeIndexes) {
+				index->words.push_back(get(cache->get(i)).getSearchWord(index->prefixLen));
+			}
+
+			cache->searchIndex = std::move(index);
+		}
+
+		// Returns the position of the first word in [words, words + n) which is not less than w, or with orEqual set
+		// the first which is greater than w. n must be at least 1.
+		static int searchWords(const uint64_t* words, int n, uint64_t w, bool orEqual) {
+			const uint64_t* base = words;
+			while (n > 1) {
+				int half = n / 2;
+				uint64_t probe = base[half - 1];
+				base += (probe < w || (orEqual && probe == w)) ? half : 0;
+				n -= half;
+			}
+			return (base - words) + (*base < w || (orEqual && *base == w));
+		}
+
+		// seek() using the search index, which must be valid for tree. Lands on the greatest item not greater than s,
+		// or on the first item if there is none, which is always a node seek() without an index could have reached.
+		int seekIndexed(const T& s, int skipLen) {
+			const auto& index = *cache->searchIndex;
+			const int n = index.nodeIndexes.size();
+			deltatree_printf("seekIndexed(%s) start %s\n", s.toString().c_str(), toString().c_str());
+
+			// Find the range [lo, hi] which must contain the position of the first item greater than s.  Items before
+			// lo have smaller words than s so are less than s, and items at or after hi have greater words so are
+			// greater than s.  If s does not have the shared prefix then its word means nothing.
+			int lo = 0;
+			int hi = n;
+			nodeIndex = index.nodeIndexes.front();
+			item.reset();
+			if (s.getCommonPrefixLen(get(), 0) >= index.prefixLen) {
+				uint64_t w = s.getSearchWord(index.prefixLen);
+				lo = searchWords(index.words.data(), n, w, false);
+				if (lo < n) {
+					hi = lo + searchWords(index.words.data() + lo, n - lo, w, true);
+				}
+			}
+
+			// Resolve the range with full comparisons
+			while (lo < hi) {
+				int mid = lo + (hi - lo) / 2;
+				nodeIndex = index.nodeIndexes[mid];
+				item.reset();
+				if (s.compare(get(), skipLen) >= 0) {
+					lo = mid + 1;
+				} else {
+					hi = mid;
+				}
+			}
+
+			nodeIndex = index.nodeIndexes[lo > 0 ? lo - 1 : 0];
+			item.reset();
+			int cmp = s.compare(get(), skipLen);
+			deltatree_printf("seekIndexed(%s) done cmp=%d %s\n", s.toString().c_str(), cmp, toString().c_str());
+			return cmp;
+		}
+
 		bool moveFirst() {
 			nodeIndex = -1;
 			item.reset();
@@ -1620,6 +1761,10 @@ public:
 			// Give k opportunity to populate its cache partial record
 			k.updateCache(cache->get(childIndex).partial, cache->arena);
 
+			// Any search index no longer describes the tree, and could be mistaken for an index of a different copy of
+			// the tree later.
+			cache->searchIndex.reset();
+
 			DeltaT& childDelta = childNode->delta(tree->largeNodes);
 			deltatree_printf("insert(%s) writing delta from %s\n", k.toString().c_str(), base->toString().c_str());
 			int written = k.writeDelta(childDelta, *base, commonPrefix);
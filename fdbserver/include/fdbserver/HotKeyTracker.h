@@ -0,0 +1,95 @@
+/*
+ * HotKeyTracker.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "fdbclient/FDBTypes.h"
+
+// A Space-Saving sketch (Metwally et al.) of the heaviest hitters among keys and key ranges. It counts at most capacity
+// of them at once: one that arrives when the sketch is full replaces the one counted least, taking over its count as
+// its error. Any key making up more than 1/capacity of the total is guaranteed to be counted, and each count
+// overstates the true count by at most its error. A single key is a range with an empty end.
+class SpaceSavingSketch {
+public:
+	struct Item {
+		KeyRef begin;
+		KeyRef end;
+		int64_t count;
+		int64_t error;
+	};
+
+	explicit SpaceSavingSketch(int capacity) : capacity(capacity) {}
+
+	void add(KeyRef begin, KeyRef end, int64_t weight = 1);
+	// The n largest counts, largest first, referring to memory that is valid until the sketch next changes
+	std::vector<Item> top(int n) const;
+	int64_t getTotal() const { return total; }
+	int size() const { return counts.size(); }
+	void clear();
+
+private:
+	typedef std::pair<Key, Key> Range;
+
+	struct RangeLess {
+		using is_transparent = void;
+		template <class A, class B>
+		bool operator()(A const& a, B const& b) const {
+			int c = StringRef(a.first).compare(b.first);
+			return c < 0 || (c == 0 && StringRef(a.second) < StringRef(b.second));
+		}
+	};
+
+	int capacity;
+	int64_t total = 0;
+	std::map<Range, std::pair<int64_t, int64_t>, RangeLess> counts; // count and error
+	std::set<std::pair<int64_t, Range>> byCount;
+};
+
+// The keys and ranges read from and written to a storage server the most, over windows of HOT_KEY_TRACKER_WINDOW
+// seconds
+class HotKeyTracker {
+public:
+	HotKeyTracker();
+
+	void addRead(KeyRef key) { add(false, key, KeyRef()); }
+	void addRead(KeyRangeRef range) { add(false, range.begin, range.end); }
+	void addWrite(KeyRef key) { add(true, key, KeyRef()); }
+	void addWrite(KeyRangeRef range) { add(true, range.begin, range.end); }
+
+	// The hottest reads or writes of the last complete window, or of the current one until the first completes, and
+	// the length of that window
+	std::vector<SpaceSavingSketch::Item> top(bool writes, int n, double* elapsed);
+
+private:
+	void add(bool write, KeyRef begin, KeyRef end);
+	void rotate();
+
+	bool enabled;
+	double windowStart;
+	double lastWindowLength = 0;
+	// the current window, then the last complete one, of reads and of writes
+	SpaceSavingSketch reads[2];
+	SpaceSavingSketch writes[2];
+};
@@ -85,4 +85,9 @@ void GenerateIOLogChecksumFile(std::string filename);
 Future<Void> KVFileCheck(std::string const& filename, bool const& integrity);
 Future<Void> KVFileDump(std::string const& filename);
 
+class UnitTestParameters;
+
+// Benchmarks a storage engine in a directory under folder, configured by params. See the kvstorebench role's help.
+Future<Void> kvStoreBench(std::string const& folder, UnitTestParameters const& params);
+
 #endif
@@ -739,6 +739,13 @@ public:
 
 	virtual Key getMetaKey() const = 0;
 
+	// The pager can keep a small filter for its user alongside the version of a page visible to this snapshot, such as
+	// a summary of the keys in the page. It is dropped when the page is written or the pager needs the memory, so
+	// getPageFilter() may return nothing at any time. setPageFilter() should only be given a filter built from
+	// a read of pageID through this snapshot.
+	virtual Optional<Standalone<StringRef>> getPageFilter(LogicalPageID pageID) = 0;
+	virtual void setPageFilter(LogicalPageID pageID, Standalone<StringRef> filter) = 0;
+
 	virtual ~IPagerSnapshot() {}
 
 	virtual void addref() = 0;
@@ -878,6 +885,12 @@ public:
 	// increment/decrement the value at this pointer based on their memory footprint.
 	virtual int64_t* getPageCachePenaltySource() = 0;
 
+	// The page cache size the pager was created with, or 0 if its page cache can't be resized
+	virtual int64_t getConfiguredPageCacheSize() const = 0;
+
+	// Sets the most memory the page cache may use. Lowering the limit evicts pages to get within it.
+	virtual void setPageCacheSizeLimit(int64_t bytes) = 0;
+
 protected:
 	~IPager2() {} // Destruction should be done using close()/dispose() from the IClosable interface
 };
@@ -216,6 +216,7 @@ struct ILogSystem {
 		bool onlySpilled;
 		bool parallelGetMore;
 		bool usePeekStream;
+		CompressionFilter compressionFilter; // Requested for peeks that cross regions, see peekCompressionFilter()
 		int sequence;
 		Deque<Future<TLogPeekReply>> futureResults;
 		Future<Void> interfaceChanged;
@@ -795,17 +796,21 @@ struct LogPushData : NonCopyable {
 	template <class T>
 	void writeTypedMessage(T const& item, bool metadataMessage = false, bool allLocations = false);
 
-	Standalone<StringRef> getMessages(int loc) const { return messagesWriter[loc].toValue(); }
+	// Returns a copy of the messages for the tlog at location "loc".
+	Standalone<StringRef> getMessages(int loc) const;
+
+	// Returns the messages for the tlog at location "loc" as the pieces of the shared message buffer they are made
+	// of, without copying them. Their concatenation is what getMessages() returns.
+	Standalone<VectorRef<StringRef>> getMessageSegments(int loc) const;
 
 	// Returns all locations' messages, including empty ones.
 	std::vector<Standalone<StringRef>> getAllMessages() const;
 
 	// Records if a tlog (specified by "loc") will receive an empty version batch message.
-	// "value" is the message returned by getMessages() call.
-	void recordEmptyMessage(int loc, const Standalone<StringRef>& value);
+	void recordEmptyMessage(int loc);
 
 	// Returns the ratio of empty messages in this version batch.
-	// MUST be called after getMessages() and recordEmptyMessage().
+	// MUST be called after recordEmptyMessage().
 	float getEmptyMessageRatio() const;
 
 	// Returns the total number of mutations. Subsequence is initialized to 1, so subtract 1 to get count.
@@ -824,8 +829,18 @@ private:
 	std::vector<Tag> next_message_tags;
 	std::vector<Tag> prev_tags;
 	std::set<Tag> written_tags;
-	std::vector<BinaryWriter> messagesWriter;
-	std::vector<bool> messagesWritten; // if messagesWriter has written anything
+	struct Span {
+		int offset;
+		int length;
+	};
+
+	// Every message is serialized once into messages, and each location keeps the spans of it that the location's
+	// tlog receives, so a message pushed to several tlogs is neither copied per tlog nor assembled into a per-tlog
+	// buffer that the transport would then copy again. Each location's spans begin with the protocol version header.
+	BinaryWriter messages;
+	int headerLength;
+	std::vector<std::vector<Span>> locationSpans;
+	std::vector<bool> messagesWritten; // if a location has anything beyond the header
 	std::vector<int> msg_locations;
 	// Stores message locations that have had span information written to them
 	// for the current transaction. Adding transaction info will reset this
@@ -841,6 +856,11 @@ private:
 	// written.
 	bool writeTransactionInfo(int location, uint32_t subseq);
 
+	// Adds the bytes of messages in [offset, offset + length) to the end of the given location's messages
+	void appendSpan(int location, int offset, int length);
+
+	int getMessagesLength(int location) const;
+
 	Tag chooseRouterTag() {
 		return savedRandomRouterTag.present() ? savedRandomRouterTag.get() : logSystem->getRandomRouterTag();
 	}
@@ -858,8 +878,6 @@ void LogPushData::writeTypedMessage(T const& item, bool metadataMessage, bool al
 	msg_locations.clear();
 	logSystem->getPushLocations(prev_tags, msg_locations, allLocations);
 
-	BinaryWriter bw(AssumeVersion(g_network->protocolVersion()));
-
 	// Metadata messages (currently LogProtocolMessage is the only metadata
 	// message) should be written before span information. If this isn't a
 	// metadata message, make sure all locations have had transaction info
@@ -887,26 +905,19 @@ void LogPushData::writeTypedMessage(T const& item, bool metadataMessage, bool al
 	}
 
 	uint32_t subseq = this->subsequence++;
-	bool first = true;
-	int firstOffset = -1, firstLength = -1;
-	for (int loc : msg_locations) {
-		BinaryWriter& wr = messagesWriter[loc];
-
-		if (first) {
-			firstOffset = wr.getLength();
-			wr << uint32_t(0) << subseq << uint16_t(prev_tags.size());
-			for (auto& tag : prev_tags)
-				wr << tag;
-			wr << item;
-			firstLength = wr.getLength() - firstOffset;
-			*(uint32_t*)((uint8_t*)wr.getData() + firstOffset) = firstLength - sizeof(uint32_t);
-			DEBUG_TAGS_AND_MESSAGE(
-			    "ProxyPushLocations", invalidVersion, StringRef(((uint8_t*)wr.getData() + firstOffset), firstLength))
-			    .detail("PushLocations", msg_locations);
-			first = false;
-		} else {
-			BinaryWriter& from = messagesWriter[msg_locations[0]];
-			wr.serializeBytes((uint8_t*)from.getData() + firstOffset, firstLength);
+	if (!msg_locations.empty()) {
+		int offset = messages.getLength();
+		messages << uint32_t(0) << subseq << uint16_t(prev_tags.size());
+		for (auto& tag : prev_tags)
+			messages << tag;
+		messages << item;
+		int length = messages.getLength() - offset;
+		*(uint32_t*)((uint8_t*)messages.getData() + offset) = length - sizeof(uint32_t);
+		DEBUG_TAGS_AND_MESSAGE(
+		    "ProxyPushLocations", invalidVersion, StringRef(((uint8_t*)messages.getData() + offset), length))
+		    .detail("PushLocations", msg_locations);
+		for (int loc : msg_locations) {
+			appendSpan(loc, offset, length);
 		}
 	}
 	written_tags.insert(next_message_tags.begin(), next_message_tags.end());
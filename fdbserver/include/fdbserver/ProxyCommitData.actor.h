@@ -35,7 +35,9 @@
 #include "fdbserver/LogSystemDiskQueueAdapter.h"
 #include "fdbserver/MasterInterface.h"
 #include "fdbserver/ResolverInterface.h"
+#include "fdbserver/TenantLatencyMap.h"
 #include "flow/IRandom.h"
+#include "flow/IThreadPool.h"
 
 #include "flow/actorcompiler.h" // This must be the last #include.
 
@@ -74,6 +76,7 @@ struct ProxyStats {
 	LatencySample commitLatencySample;
 	LatencySample encryptionLatencySample;
 	LatencyBands commitLatencyBands;
+	TenantLatencyMap tenantCommitLatencies;
 
 	// Ratio of tlogs receiving empty commit messages.
 	LatencySample commitBatchingEmptyMessageRatio;
@@ -160,6 +163,7 @@ struct ProxyStats {
 	                            SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 	                            SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 	    commitLatencyBands("CommitLatencyBands", id, SERVER_KNOBS->STORAGE_LOGGING_DELAY),
+	    tenantCommitLatencies("TenantCommitLatencies", id, SERVER_KNOBS->STORAGE_LOGGING_DELAY),
 	    commitBatchingEmptyMessageRatio("CommitBatchingEmptyMessageRatio",
 	                                    id,
 	                                    SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
@@ -233,10 +237,89 @@ struct ExpectedIdempotencyIdCountForKey {
 	Version commitVersion = invalidVersion;
 	int16_t idempotencyIdCount = 0;
 	uint8_t batchIndexHighByte = 0;
+	// The idempotency key this proxy wrote just before this one, if no other key can lie between the two. Otherwise
+	// previousKeyVersion is invalidVersion.
+	Version previousKeyVersion = invalidVersion;
+	uint8_t previousKeyBatchIndexHighByte = 0;
 
 	ExpectedIdempotencyIdCountForKey() {}
-	ExpectedIdempotencyIdCountForKey(Version commitVersion, int16_t idempotencyIdCount, uint8_t batchIndexHighByte)
-	  : commitVersion(commitVersion), idempotencyIdCount(idempotencyIdCount), batchIndexHighByte(batchIndexHighByte) {}
+	ExpectedIdempotencyIdCountForKey(Version commitVersion,
+	                                 int16_t idempotencyIdCount,
+	                                 uint8_t batchIndexHighByte,
+	                                 Version previousKeyVersion,
+	                                 uint8_t previousKeyBatchIndexHighByte)
+	  : commitVersion(commitVersion), idempotencyIdCount(idempotencyIdCount), batchIndexHighByte(batchIndexHighByte),
+	    previousKeyVersion(previousKeyVersion), previousKeyBatchIndexHighByte(previousKeyBatchIndexHighByte) {}
+};
+
+// A flattened copy of the shards in a KeyRangeMap<ServerCacheInfo> such as ProxyCommitData::keyInfo, so that the
+// commit path can find a key's shard with a binary search over contiguous arrays instead of a walk down the map's tree.
+// The search compares the first 8 bytes of keys as integers, and only compares whole keys among the shards whose
+// begin keys share the key's first 8 bytes. The last shard found is checked first, since the keys of a transaction are
+// often close together. The index points into the map, so it must be rebuilt whenever the map's ranges change.
+class KeyInfoIndex {
+public:
+	void rebuild(KeyRangeMap<ServerCacheInfo>& map, uint64_t generation) {
+		prefixes.clear();
+		begins.clear();
+		infos.clear();
+		KeyRef end;
+		for (auto r : map.ranges()) {
+			prefixes.push_back(keyPrefix(r.begin()));
+			begins.push_back(r.begin());
+			infos.push_back(&r.value());
+			end = r.end();
+		}
+		begins.push_back(end);
+		hint = 0;
+		this->generation = generation;
+	}
+
+	bool isCurrent(uint64_t generation) const { return !infos.empty() && this->generation == generation; }
+
+	int size() const { return infos.size(); }
+	KeyRef begin(int i) const { return begins[i]; }
+	KeyRef end(int i) const { return begins[i + 1]; }
+	ServerCacheInfo& info(int i) const { return *infos[i]; }
+
+	// Returns the index of the shard containing key
+	int find(KeyRef key) {
+		if (hint < size() && begins[hint] <= key && key < begins[hint + 1]) {
+			return hint;
+		}
+
+		// The last shard whose begin key's prefix is at most key's, without branching on the comparisons
+		uint64_t p = keyPrefix(key);
+		int i = 0;
+		for (int n = prefixes.size(); n > 1;) {
+			int half = n / 2;
+			i = prefixes[i + half] <= p ? i + half : i;
+			n -= half;
+		}
+		if (prefixes[i] == p) {
+			int first = std::lower_bound(prefixes.begin(), prefixes.begin() + i, p) - prefixes.begin();
+			i = std::upper_bound(begins.begin() + first, begins.begin() + i + 1, key) - begins.begin() - 1;
+		}
+		hint = i;
+		return i;
+	}
+
+	// The first 8 bytes of key as a big endian integer, padded with zeros, which orders the same as keys do
+	// except that keys sharing their first 8 bytes compare equal
+	static uint64_t keyPrefix(KeyRef key) {
+		uint64_t p = 0;
+		for (int i = 0; i < 8; ++i) {
+			p = (p << 8) | (i < key.size() ? key[i] : 0);
+		}
+		return p;
+	}
+
+private:
+	std::vector<uint64_t> prefixes;
+	std::vector<KeyRef> begins; // with the end of the last shard after them
+	std::vector<ServerCacheInfo*> infos;
+	int hint = 0;
+	uint64_t generation = 0;
 };
 
 struct ProxyCommitData {
@@ -268,6 +351,8 @@ struct ProxyCommitData {
 	// only tracks normalKeys. This is used for tracking versions for systemKeys.
 	Deque<Version> systemKeyVersions;
 	KeyRangeMap<ServerCacheInfo> keyInfo; // keyrange -> all storage servers in all DCs for the keyrange
+	uint64_t keyInfoGeneration = 0; // incremented whenever the ranges of keyInfo change
+	KeyInfoIndex keyInfoIndex; // see getKeyInfoIndex()
 	KeyRangeMap<bool> cacheInfo;
 	std::map<Key, ApplyMutationsData> uid_applyMutationsData;
 	bool firstProxy;
@@ -314,24 +399,76 @@ struct ProxyCommitData {
 
 	PromiseStream<ExpectedIdempotencyIdCountForKey> expectedIdempotencyIdCountForKey;
 	Standalone<VectorRef<MutationRef>> idempotencyClears;
+	// The idempotency key most recently written by this proxy, and the commit version of the last batch to pass
+	// post-resolution. While each batch's prevVersion is the version of the one before it, no other proxy has
+	// committed in between, so the next key written directly follows the last one.
+	Version lastIdempotencyKeyVersion = invalidVersion;
+	uint8_t lastIdempotencyKeyBatchIndexHighByte = 0;
+	Version lastPostResolutionVersion = invalidVersion;
 
 	AsyncVar<bool> triggerCommit;
 
 	uint16_t commitProxyIndex; // decided when the cluster controller recruits commit proxies
 	std::shared_ptr<AccumulativeChecksumBuilder> acsBuilder = nullptr;
+
+	// Encrypts the mutations of large batches off the network thread; null unless COMMIT_PROXY_ENCRYPTION_THREADS > 0
+	// and encryption is enabled
+	Reference<IThreadPool> encryptionThreads;
 	LogEpoch epoch;
 
 	// The tag related to a storage server rarely change, so we keep a vector of tags for each key range to be slightly
 	// more CPU efficient. When a tag related to a storage server does change, we empty out all of these vectors to
 	// signify they must be repopulated. We do not repopulate them immediately to avoid a slow task.
 	const std::vector<Tag>& tagsForKey(StringRef key) {
-		auto& tags = keyInfo[key].tags;
-		if (!tags.size()) {
-			auto& r = keyInfo.rangeContaining(key).value();
-			r.populateTags();
-			return r.tags;
+		ServerCacheInfo& info = shardInfoForKey(key);
+		info.populateTags();
+		return info.tags;
+	}
+
+	// The commit path's view of keyInfo, rebuilt first if keyInfo has changed since it was last used.
+	KeyInfoIndex& getKeyInfoIndex() {
+		if (!keyInfoIndex.isCurrent(keyInfoGeneration)) {
+			keyInfoIndex.rebuild(keyInfo, keyInfoGeneration);
+		}
+		return keyInfoIndex;
+	}
+
+	ServerCacheInfo& shardInfoForKey(StringRef key) {
+		if (!SERVER_KNOBS->COMMIT_PROXY_KEY_INFO_INDEX) {
+			return keyInfo.rangeContaining(key).value();
+		}
+		KeyInfoIndex& index = getKeyInfoIndex();
+		return index.info(index.find(key));
+	}
+
+	// Returns the shard containing range, or nullptr if range spans more than one shard
+	ServerCacheInfo* singleShardInfo(KeyRangeRef range) {
+		if (!SERVER_KNOBS->COMMIT_PROXY_KEY_INFO_INDEX) {
+			auto r = keyInfo.rangeContaining(range.begin);
+			return range.end <= r.end() ? &r.value() : nullptr;
+		}
+		KeyInfoIndex& index = getKeyInfoIndex();
+		int i = index.find(range.begin);
+		return range.end <= index.end(i) ? &index.info(i) : nullptr;
+	}
+
+	// Calls f(ServerCacheInfo&) for each shard intersecting range, in order, and returns how many there were
+	template <class F>
+	int forEachShardInfo(KeyRangeRef range, F f) {
+		int count = 0;
+		if (!SERVER_KNOBS->COMMIT_PROXY_KEY_INFO_INDEX) {
+			for (auto r : keyInfo.intersectingRanges(range)) {
+				f(r.value());
+				++count;
+			}
+			return count;
+		}
+		KeyInfoIndex& index = getKeyInfoIndex();
+		for (int i = index.find(range.begin); i < index.size() && index.begin(i) < range.end; ++i) {
+			f(index.info(i));
+			++count;
 		}
-		return tags;
+		return count;
 	}
 
 	bool needsCacheTag(KeyRangeRef range) {
@@ -135,6 +135,8 @@ struct RatekeeperLimits {
 
 	double bwLagTarget;
 
+	limitReason_t reason;
+
 	TransactionPriority priority;
 	std::string context;
 
@@ -151,6 +153,82 @@ struct RatekeeperLimits {
 	                 double bwLagTarget);
 };
 
+// One input to, or decision of, ratekeeper. When RATEKEEPER_RECORD_DIR is set, ratekeeper records these so that its
+// decisions can be replayed with other knobs by Ratekeeper::replay().
+struct RatekeeperRecord {
+	enum Type : uint8_t {
+		StorageAdded, // locality
+		StorageQueue, // storageReply and acceptingRequests
+		StorageFailed,
+		StorageRemoved,
+		TLogAdded,
+		TLogQueue, // tlogReply
+		TLogFailed,
+		TLogRemoved,
+		Released, // released and batchReleased
+		Configuration, // storageTeamSize and remoteDC
+		Decision, // tpsLimit, batchTpsLimit and their reasons
+	};
+
+	double time = 0;
+	uint8_t type = 0;
+	UID id;
+	LocalityData locality;
+	StorageQueuingMetricsReply storageReply;
+	bool acceptingRequests = false;
+	TLogQueuingMetricsReply tlogReply;
+	int64_t released = 0;
+	int64_t batchReleased = 0;
+	int32_t storageTeamSize = 0;
+	Optional<Key> remoteDC;
+	double tpsLimit = 0;
+	double batchTpsLimit = 0;
+	int32_t reason = 0;
+	int32_t batchReason = 0;
+
+	RatekeeperRecord() = default;
+	RatekeeperRecord(Type type, UID id) : type(type), id(id) {}
+
+	// Only the fields used by each type are written
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, time, type, id);
+		switch (type) {
+		case StorageAdded:
+			serializer(ar, locality);
+			break;
+		case StorageQueue:
+			serializer(ar, storageReply, acceptingRequests);
+			break;
+		case TLogQueue:
+			serializer(ar, tlogReply);
+			break;
+		case Released:
+			serializer(ar, released, batchReleased);
+			break;
+		case Configuration:
+			serializer(ar, storageTeamSize, remoteDC);
+			break;
+		case Decision:
+			serializer(ar, tpsLimit, batchTpsLimit, reason, batchReason);
+			break;
+		default:
+			break;
+		}
+	}
+};
+
+// How the decisions replayed from a recording compare to the recorded ones, using the default priority limits
+struct RatekeeperReplaySummary {
+	int64_t records = 0;
+	int64_t decisions = 0;
+	int64_t changedDecisions = 0; // The limit differs by more than 1%, or the reason differs
+	int64_t recordedLimitedDecisions = 0;
+	int64_t limitedDecisions = 0;
+	double recordedMeanTPSLimit = 0; // Limits over 1e6 count as 1e6, like the Ratekeeper.TPSLimit metric
+	double meanTPSLimit = 0;
+};
+
 class Ratekeeper {
 	friend class RatekeeperImpl;
 
@@ -211,6 +289,12 @@ class Ratekeeper {
 	bool anyBlobRanges;
 	Optional<Key> remoteDC;
 	Optional<UID> ssHighWriteQueue;
+	// The storage server left out of the default priority limit, whose hot shards are throttled instead
+	Optional<UID> ssLocallyThrottled;
+
+	// Records not yet written to the recording, while recording
+	bool recording;
+	std::vector<RatekeeperRecord> pendingRecords;
 
 	double getRecoveryDuration(Version ver) const {
 		auto it = version_recovery.lower_bound(ver);
@@ -228,6 +312,17 @@ class Ratekeeper {
 
 	Ratekeeper(UID id, Database db);
 
+	void record(RatekeeperRecord&& r) {
+		if (recording) {
+			r.time = now();
+			pendingRecords.push_back(std::move(r));
+		}
+	}
+	void recordConfiguration();
+	void recordDecision();
+	Future<Void> writeRecording();
+	void updateTpsHistory();
+
 	Future<Void> configurationMonitor();
 	void updateCommitCostEstimation(UIDTransactionTagMap<TransactionCommitCostEstimation> const& costEstimation);
 	void updateRate(RatekeeperLimits* limits);
@@ -248,6 +343,10 @@ class Ratekeeper {
 
 public:
 	static Future<Void> run(RatekeeperInterface rkInterf, Reference<AsyncVar<ServerDBInfo> const> dbInfo);
+
+	// Feeds a recording into a new ratekeeper, at the pace it was recorded, and compares its decisions with the current
+	// knobs to the recorded ones. Time only passes quickly enough for this in simulation.
+	static Future<RatekeeperReplaySummary> replay(Database db, std::string recordFile);
 };
 
 #endif // FDBSERVER_RATEKEEPER_H
@@ -43,6 +43,28 @@ struct ProcessIssues {
 	ProcessIssues(NetworkAddress address, Standalone<VectorRef<StringRef>> issues) : address(address), issues(issues) {}
 };
 
+struct WorkerEvents : std::map<NetworkAddress, TraceEventFields> {};
+
+// The latest MachineMetrics, ProcessMetrics, NetworkMetrics, error, TraceFileOpenError, ProgramStart and
+// PeerNetworkMetrics events of each worker, each with the addresses of the workers that didn't reply
+using StatusWorkerEvents = std::vector<Optional<std::pair<WorkerEvents, std::set<std::string>>>>;
+
+// Asks every worker for the events that status needs from each of them
+Future<StatusWorkerEvents> getStatusWorkerEvents(std::vector<WorkerDetails> const& workers);
+
+// Status worker events, kept up to date in the background while status is being requested so that a request needn't
+// wait for every worker to reply
+struct StatusWorkerEventCache {
+	StatusWorkerEvents events;
+	std::set<NetworkAddress> addresses; // The workers that the events were fetched from
+	double updated = 0; // When the fetch of the events began
+	double lastRequested = 0;
+	AsyncTrigger requested;
+
+	// The events of these workers, if the cache is recent and has every one of them
+	Optional<StatusWorkerEvents> get(std::vector<WorkerDetails> const& workers) const;
+};
+
 Future<StatusReply> clusterGetStatus(
     Reference<AsyncVar<struct ServerDBInfo>> const& db,
     Database const& cx,
@@ -57,11 +79,11 @@ Future<StatusReply> clusterGetStatus(
     Version const& dcStorageServerVersionDifference,
     ConfigBroadcaster const* const& conifgBroadcaster,
     Optional<UnversionedMetaclusterRegistrationEntry> const& metaclusterRegistration,
-    metacluster::MetaclusterMetrics const& metaclusterMetrics);
+    metacluster::MetaclusterMetrics const& metaclusterMetrics,
+    Optional<StatusWorkerEvents> const& cachedWorkerEvents);
 
 StatusReply clusterGetFaultToleranceStatus(const std::string& statusString);
 
-struct WorkerEvents : std::map<NetworkAddress, TraceEventFields> {};
 ACTOR Future<Optional<std::pair<WorkerEvents, std::set<std::string>>>> latestEventOnWorkers(
     std::vector<WorkerDetails> workers,
     std::string eventName);
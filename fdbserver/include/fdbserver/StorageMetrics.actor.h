@@ -132,7 +132,8 @@ struct StorageServerMetrics {
 	                       int64_t versionLag,
 	                       double lastUpdate,
 	                       int64_t bytesDurable,
-	                       int64_t bytesInput) const;
+	                       int64_t bytesInput,
+	                       bool storageEngineWrongConfigured = false) const;
 
 	Future<Void> waitMetrics(WaitMetricsRequest req, Future<Void> delay);
 
@@ -34,6 +34,17 @@ class TCMachineInfo;
 class TCMachineTeamInfo;
 class DDTeamCollection;
 
+// Forecasts the next sample of a metric with Holt's linear smoothing, which tracks both its level and its trend, so
+// that a server whose load is climbing is seen as busier than its latest sample
+class LoadForecast {
+	Optional<double> level;
+	double trend = 0;
+
+public:
+	void update(double sample, double alpha, double beta);
+	double predict() const { return level.present() ? std::max(0.0, level.get() + trend) : 0.0; }
+};
+
 class TCServerInfo : public ReferenceCounted<TCServerInfo> {
 	friend class TCServerInfoImpl;
 	friend class DDTeamCollectionUnitTest;
@@ -57,13 +68,18 @@ class TCServerInfo : public ReferenceCounted<TCServerInfo> {
 	ErrorOr<GetStorageMetricsReply> metrics;
 	Optional<HealthMetrics::StorageStats> storageStats;
 	Optional<double> storageQueueTooLongStartTime; // When a storage queue becomes long
+	LoadForecast writeBandwidthForecast, readOpsForecast, cpuForecast;
 
 	// Last time when server notified teamTracker that the queue is long
 	// We do not want repeatedly notify teamTracker in present of long
 	// queue lastTimeNotifyLongStorageQueue is used to support this
 	Optional<double> lastTimeNotifyLongStorageQueue;
 
-	void setMetrics(GetStorageMetricsReply serverMetrics) { this->metrics = serverMetrics; }
+	void setMetrics(GetStorageMetricsReply serverMetrics) {
+		this->metrics = serverMetrics;
+		updateLoadForecasts();
+	}
+	void updateLoadForecasts();
 	void setStorageStats(HealthMetrics::StorageStats stats) { storageStats = stats; }
 	void markTeamUnhealthy(int teamIndex);
 
@@ -79,6 +95,9 @@ public:
 	LocalityEntry localityEntry;
 	Promise<Void> updated;
 	AsyncVar<bool> wrongStoreTypeToRemove;
+	// Set when the server reports that its storage engine was created with settings it would no longer be created
+	// with, so that the perpetual wiggle replaces it
+	AsyncVar<bool> storageEngineWrongConfigured;
 	AsyncVar<bool> ssVersionTooFarBehind;
 	AsyncVar<int64_t> longStorageQueue; // set when the storage queue remains too long for a while
 
@@ -123,6 +142,9 @@ public:
 
 	std::pair<int64_t, int64_t> spaceBytes(bool includeInFlight = true) const;
 	int64_t loadBytes() const;
+	double predictedWriteBandwidth() const { return writeBandwidthForecast.predict(); }
+	double predictedReadOps() const { return readOpsForecast.predict(); }
+	double predictedCpu() const { return cpuForecast.predict(); }
 	bool hasHealthyAvailableSpace(double minAvailableSpaceRatio) const;
 
 	Future<Void> updateServerMetrics();
@@ -232,6 +254,10 @@ public:
 
 	double getAverageCPU() const override;
 
+	// The predicted utilization of the busiest server in the team: the mean of its predicted CPU as a fraction and its
+	// predicted write bandwidth and read ops relative to the given averages, so that an average server scores about 1
+	double getPredictedUtilization(double avgWriteBandwidth, double avgReadOps) const;
+
 	bool hasLowerCpu(double cpuThreshold) const override {
 		return getAverageCPU() <= std::min(cpuThreshold, SERVER_KNOBS->MAX_DEST_CPU_PERCENT);
 	}
@@ -27,6 +27,7 @@
 #include "fdbclient/MutationList.h"
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbrpc/TimedRequest.h"
+#include "flow/CompressionUtils.h"
 #include <iterator>
 
 struct TLogInterface {
@@ -203,17 +204,27 @@ struct VerUpdateRef {
 struct TLogPeekReply {
 	constexpr static FileIdentifier file_identifier = 11365689;
 	Arena arena;
-	StringRef messages;
+	StringRef messages; // When received, points into the packet, which arena holds, so pass-through costs no copy
 	Version end;
 	Optional<Version> popped;
 	Version maxKnownVersion;
 	Version minKnownCommittedVersion;
 	Optional<Version> begin;
 	bool onlySpilled = false;
+	CompressionFilter compressionFilter = CompressionFilter::NONE; // How messages is compressed
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, messages, end, popped, maxKnownVersion, minKnownCommittedVersion, begin, onlySpilled, arena);
+		serializer(ar,
+		           messages,
+		           end,
+		           popped,
+		           maxKnownVersion,
+		           minKnownCommittedVersion,
+		           begin,
+		           onlySpilled,
+		           compressionFilter,
+		           arena);
 	}
 };
 
@@ -224,19 +235,24 @@ struct TLogPeekRequest {
 	bool returnIfBlocked;
 	bool onlySpilled;
 	Optional<std::pair<UID, int>> sequence;
+	// The compression the peer would like the reply in. TLogs that predate it, or that do not support the filter,
+	// reply uncompressed.
+	CompressionFilter compressionFilter = CompressionFilter::NONE;
 	ReplyPromise<TLogPeekReply> reply;
 
 	TLogPeekRequest(Version begin,
 	                Tag tag,
 	                bool returnIfBlocked,
 	                bool onlySpilled,
-	                Optional<std::pair<UID, int>> sequence = Optional<std::pair<UID, int>>())
-	  : begin(begin), tag(tag), returnIfBlocked(returnIfBlocked), onlySpilled(onlySpilled), sequence(sequence) {}
+	                Optional<std::pair<UID, int>> sequence = Optional<std::pair<UID, int>>(),
+	                CompressionFilter compressionFilter = CompressionFilter::NONE)
+	  : begin(begin), tag(tag), returnIfBlocked(returnIfBlocked), onlySpilled(onlySpilled), sequence(sequence),
+	    compressionFilter(compressionFilter) {}
 	TLogPeekRequest() {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, begin, tag, returnIfBlocked, onlySpilled, sequence, reply);
+		serializer(ar, begin, tag, returnIfBlocked, onlySpilled, sequence, reply, compressionFilter);
 	}
 };
 
@@ -261,15 +277,21 @@ struct TLogPeekStreamRequest {
 	Tag tag;
 	bool returnIfBlocked;
 	int limitBytes;
+	CompressionFilter compressionFilter = CompressionFilter::NONE; // As in TLogPeekRequest
 	ReplyPromiseStream<TLogPeekStreamReply> reply;
 
 	TLogPeekStreamRequest() {}
-	TLogPeekStreamRequest(Version version, Tag tag, bool returnIfBlocked, int limitBytes)
-	  : begin(version), tag(tag), returnIfBlocked(returnIfBlocked), limitBytes(limitBytes) {}
+	TLogPeekStreamRequest(Version version,
+	                      Tag tag,
+	                      bool returnIfBlocked,
+	                      int limitBytes,
+	                      CompressionFilter compressionFilter = CompressionFilter::NONE)
+	  : begin(version), tag(tag), returnIfBlocked(returnIfBlocked), limitBytes(limitBytes),
+	    compressionFilter(compressionFilter) {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, begin, tag, returnIfBlocked, limitBytes, reply);
+		serializer(ar, begin, tag, returnIfBlocked, limitBytes, reply, compressionFilter);
 	}
 };
 
@@ -318,6 +340,56 @@ struct TLogCommitReply {
 	}
 };
 
+namespace detail {
+// Serializes exactly like the StringRef it wraps, except that when segments are given their concatenation is saved
+// instead, copying each segment straight into the buffer being written.
+class GatheredStringSerdesWrapper {
+	StringRef* value;
+	VectorRef<StringRef> const* segments;
+
+public:
+	// Flatbuffer implementation requires default constructor
+	GatheredStringSerdesWrapper() noexcept : value(nullptr), segments(nullptr) {}
+
+	GatheredStringSerdesWrapper(StringRef& s, VectorRef<StringRef> const& segments) noexcept
+	  : value(&s), segments(&segments) {}
+
+	StringRef& get() const noexcept { return *value; }
+	VectorRef<StringRef> const& getSegments() const noexcept { return *segments; }
+};
+} // namespace detail
+
+template <>
+struct dynamic_size_traits<detail::GatheredStringSerdesWrapper> : std::true_type {
+	template <class Context>
+	static size_t size(const detail::GatheredStringSerdesWrapper& t, Context&) {
+		if (t.getSegments().empty()) {
+			return t.get().size();
+		}
+		size_t size = 0;
+		for (const auto& segment : t.getSegments()) {
+			size += segment.size();
+		}
+		return size;
+	}
+
+	template <class Context>
+	static void save(uint8_t* out, const detail::GatheredStringSerdesWrapper& t, Context&) {
+		if (t.getSegments().empty()) {
+			std::copy(t.get().begin(), t.get().end(), out);
+			return;
+		}
+		for (const auto& segment : t.getSegments()) {
+			out = std::copy(segment.begin(), segment.end(), out);
+		}
+	}
+
+	template <class Context>
+	static void load(const uint8_t* ptr, size_t sz, detail::GatheredStringSerdesWrapper& t, Context& context) {
+		dynamic_size_traits<StringRef>::load(ptr, sz, t.get(), context);
+	}
+};
+
 struct TLogCommitRequest : TimedRequest {
 	constexpr static FileIdentifier file_identifier = 4022206;
 	SpanContext spanContext;
@@ -325,6 +397,9 @@ struct TLogCommitRequest : TimedRequest {
 	Version prevVersion, version, knownCommittedVersion, minKnownCommittedVersion, seqPrevVersion;
 
 	StringRef messages; // Each message prefixed by a 4-byte length
+	// If not empty, sent in place of messages as their concatenation, so that the sender does not have to assemble
+	// messages in one buffer before the transport copies it again. Never set on a received request.
+	VectorRef<StringRef> messageSegments;
 
 	ReplyPromise<TLogCommitReply> reply;
 	uint16_t tLogCount;
@@ -347,15 +422,45 @@ struct TLogCommitRequest : TimedRequest {
 	    knownCommittedVersion(knownCommittedVersion), minKnownCommittedVersion(minKnownCommittedVersion),
 	    seqPrevVersion(seqPrevVersion), messages(messages), tLogCount(tLogCount), tLogLocIds(tLogLocIds),
 	    debugID(debugID) {}
+
+	// Replaces messageSegments with a copy of their concatenation in messages, for receivers that are handed the
+	// request without it being serialized.
+	void flattenMessageSegments() {
+		int length = 0;
+		for (const auto& segment : messageSegments) {
+			length += segment.size();
+		}
+		uint8_t* out = new (arena) uint8_t[length];
+		messages = StringRef(out, length);
+		for (const auto& segment : messageSegments) {
+			out = std::copy(segment.begin(), segment.end(), out);
+		}
+		messageSegments = VectorRef<StringRef>();
+	}
+
 	template <class Ar>
 	void serialize(Ar& ar) {
+		if constexpr (is_fb_function<Ar>) {
+			auto m = detail::GatheredStringSerdesWrapper(messages, messageSegments);
+			serializeFields(ar, m);
+		} else {
+			if (!ar.isDeserializing && !messageSegments.empty()) {
+				flattenMessageSegments();
+			}
+			serializeFields(ar, messages);
+		}
+	}
+
+private:
+	template <class Ar, class Messages>
+	void serializeFields(Ar& ar, Messages& m) {
 		serializer(ar,
 		           prevVersion,
 		           version,
 		           knownCommittedVersion,
 		           minKnownCommittedVersion,
 		           seqPrevVersion,
-		           messages,
+		           m,
 		           reply,
 		           debugID,
 		           tLogCount,
@@ -0,0 +1,58 @@
+/*
+ * TenantLatencyMap.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+
+#include "fdbrpc/DDSketch.h"
+#include "fdbserver/Knobs.h"
+#include "flow/flow.h"
+
+// Latencies of the requests made within each tenant, so that tenants can be held to latency objectives and the ones
+// suffering the most under contention can be found. Every logging interval, each tenant that missed its objective is
+// traced, and the ones that missed it the most are summarized in an event tracked for status.
+class TenantLatencyMap {
+public:
+	enum class RequestType { PointRead, RangeRead, Commit };
+	static const char* typeName(RequestType type);
+
+	TenantLatencyMap(std::string const& name, UID id, double loggingInterval);
+
+	// Range read latencies are normalized by the kilobytes returned, so that reads of different sizes compare
+	void addMeasurement(int64_t tenantId, RequestType type, double latency, int64_t bytes = 0);
+	void logLatencies();
+	int size() const { return map.size(); }
+
+private:
+	struct Latencies {
+		DDSketch<double> sketch;
+		int64_t sloMisses = 0;
+		double lastUpdated;
+
+		explicit Latencies(double accuracy) : sketch(accuracy), lastUpdated(now()) {}
+	};
+
+	std::string name;
+	UID id;
+	std::map<std::pair<int64_t, RequestType>, Latencies> map;
+	Reference<EventCacheHolder> summaryEventHolder;
+	Future<Void> logger;
+};
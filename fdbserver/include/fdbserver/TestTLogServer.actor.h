@@ -132,5 +132,19 @@ struct TLogTestContext : NonCopyable, public ReferenceCounted<TLogTestContext> {
 	const uint32_t primaryLocality = 0;
 };
 
+Reference<TLogTestContext> initTLogTestContext(TestTLogOptions tLogOptions,
+                                               Optional<Reference<TLogTestContext>> oldTLogTestContext);
+
+// Create and start a tLog. If optional parmeters are set, the tLog is a new generation of "tLogID"
+// as described by initReq. Otherwise, it is a newborn generation 0 tLog.
+ACTOR Future<Void> getTLogCreateActor(Reference<TLogTestContext> pTLogTestContext,
+                                      TestTLogOptions tLogOptions,
+                                      uint16_t processID,
+                                      InitializeTLogRequest* initReq = nullptr,
+                                      UID tLogID = UID());
+
+// Wait for the tLogs of pTLogTestContext to be created, add them to its log system config and signal them started
+ACTOR Future<Void> buildTLogSet(Reference<TLogTestContext> pTLogTestContext);
+
 #include "flow/unactorcompiler.h"
 #endif // FDBSERVER_TEST_TLOG_ACTOR_G_H
@@ -31,8 +31,9 @@ public:
 	TransactionTagCounter(UID thisServerID, int maxTagsTracked, double minRateTracked);
 	~TransactionTagCounter();
 
-	// Update counters tracking the busyness of each tag in the current interval
-	void addRequest(Optional<TagSet> const& tags, int64_t bytes);
+	// Update counters tracking the busyness of each tag in the current interval. A read that kept the storage server
+	// busy for serviceSeconds costs at least serviceSeconds * STORAGE_READ_TAG_COST_PER_SECOND.
+	void addRequest(Optional<TagSet> const& tags, int64_t bytes, double serviceSeconds = 0);
 
 	// Save current set of busy tags and reset counters for next interval
 	void startNewInterval();
@@ -1218,11 +1218,13 @@ class IDiskQueue;
 ACTOR Future<Void> blobWorker(BlobWorkerInterface bwi,
                               ReplyPromise<InitializeBlobWorkerReply> blobWorkerReady,
                               Reference<AsyncVar<ServerDBInfo> const> dbInfo,
-                              IKeyValueStore* persistentData);
+                              IKeyValueStore* persistentData,
+                              std::string folder);
 ACTOR Future<Void> blobWorker(BlobWorkerInterface bwi,
                               Promise<Void> recovered,
                               Reference<AsyncVar<ServerDBInfo> const> dbInfo,
-                              IKeyValueStore* persistentData);
+                              IKeyValueStore* persistentData,
+                              std::string folder);
 ACTOR Future<Void> encryptKeyProxyServer(EncryptKeyProxyInterface ei,
                                          Reference<AsyncVar<ServerDBInfo>> db,
                                          EncryptionAtRestMode encryptMode);
@@ -34,6 +34,7 @@ struct MockDDTestWorkload : public TestWorkload {
 	double meanDelay = 0.05;
 	double maxKeyspace = 0.1; // range space
 	int maxByteSize = 1024, minByteSize = 32; // single point value size. The Key size is fixed to 16 bytes
+	int machineCount = 0; // machines in the mock cluster, or 0 for the simulation default
 
 	// shared by all Mock Workload
 	std::shared_ptr<MockGlobalState> sharedMgs;
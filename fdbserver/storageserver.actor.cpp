@@ -22,6 +22,7 @@
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <list>
 #include <type_traits>
 #include <unordered_map>
 
@@ -67,6 +68,7 @@
 #include "fdbclient/TransactionLineage.h"
 #include "fdbclient/Tuple.h"
 #include "fdbclient/VersionedMap.h"
+#include "fdbclient/VersionedBTreeMap.h"
 #include "fdbrpc/sim_validation.h"
 #include "fdbrpc/Smoother.h"
 #include "fdbrpc/Stats.h"
@@ -74,6 +76,7 @@
 #include "fdbserver/BulkLoadUtil.actor.h"
 #include "fdbserver/DataDistribution.actor.h"
 #include "fdbserver/FDBExecHelper.actor.h"
+#include "fdbserver/HotKeyTracker.h"
 #include "fdbclient/GetEncryptCipherKeys.h"
 #include "fdbserver/IKeyValueStore.h"
 #include "fdbserver/Knobs.h"
@@ -91,10 +94,12 @@
 #include "fdbserver/SpanContextMessage.h"
 #include "fdbserver/StorageMetrics.actor.h"
 #include "fdbserver/TLogInterface.h"
+#include "fdbserver/TenantLatencyMap.h"
 #include "fdbserver/TransactionTagCounter.h"
 #include "fdbserver/WaitFailure.h"
 #include "fdbserver/WorkerInterface.actor.h"
 #include "fdbserver/BlobGranuleServerCommon.actor.h"
+#include "fdbserver/CoroFlow.h"
 #include "fdbserver/StorageCorruptionBug.h"
 #include "fdbserver/StorageServerUtils.h"
 #include "flow/ActorCollection.h"
@@ -109,6 +114,7 @@
 #include "flow/Trace.h"
 #include "flow/Util.h"
 #include "flow/genericactors.actor.h"
+#include "flow/xxhash.h"
 
 #include "flow/actorcompiler.h" // This must be the last #include.
 
@@ -440,11 +446,12 @@ struct AddingShard : NonCopyable {
 
 class ShardInfo : public ReferenceCounted<ShardInfo>, NonCopyable {
 	ShardInfo(KeyRange keys, std::unique_ptr<AddingShard>&& adding, StorageServer* readWrite)
-	  : adding(std::move(adding)), readWrite(readWrite), keys(keys), shardId(0LL), desiredShardId(0LL), version(0) {}
+	  : adding(std::move(adding)), readWrite(readWrite), keys(keys), shardId(0LL), desiredShardId(0LL), version(0),
+	    lastWriteTime(now()) {}
 	ShardInfo(KeyRange keys, std::shared_ptr<MoveInShard> moveInShard)
 	  : adding(nullptr), readWrite(nullptr), moveInShard(moveInShard), keys(keys),
 	    shardId(moveInShard->meta->destShardId()), desiredShardId(moveInShard->meta->destShardId()),
-	    version(moveInShard->meta->createVersion) {}
+	    version(moveInShard->meta->createVersion), lastWriteTime(now()) {}
 
 public:
 	// A shard has 4 mutual exclusive states: adding, moveInShard, readWrite and notAssigned.
@@ -456,6 +463,9 @@ public:
 	uint64_t shardId;
 	uint64_t desiredShardId;
 	Version version;
+	// When a mutation was last applied to the shard, or when it was created. Shards are recreated whenever they are
+	// split, merged or change state, so this errs on the side of the shard looking recently written.
+	double lastWriteTime;
 
 	static ShardInfo* newNotAssigned(KeyRange keys) { return new ShardInfo(keys, nullptr, nullptr); }
 	static ShardInfo* newReadWrite(KeyRange keys, StorageServer* data) { return new ShardInfo(keys, nullptr, data); }
@@ -635,6 +645,12 @@ struct StorageServerDisk {
 		++(*kvGets);
 		return storage->readValuePrefix(key, maxLength, options);
 	}
+	Future<std::vector<Optional<Value>>> readValues(Standalone<VectorRef<KeyRef>> keys,
+	                                                std::vector<int> maxLengths = std::vector<int>(),
+	                                                Optional<ReadOptions> options = Optional<ReadOptions>()) {
+		*kvGets += keys.size();
+		return storage->readValues(keys, maxLengths, options);
+	}
 	Future<RangeResult> readRange(KeyRangeRef keys,
 	                              int rowLimit = 1 << 30,
 	                              int byteLimit = 1 << 30,
@@ -659,6 +675,9 @@ struct StorageServerDisk {
 
 	KeyValueStoreType getKeyValueStoreType() const { return storage->getType(); }
 	StorageBytes getStorageBytes() const { return storage->getStorageBytes(); }
+	int64_t getConfiguredCacheSize() const { return storage->getConfiguredCacheSize(); }
+	void setCacheSizeLimit(int64_t bytes) { storage->setCacheSizeLimit(bytes); }
+	bool isWrongConfigured() const { return storage->isWrongConfigured(); }
 	std::tuple<size_t, size_t, size_t> getSize() const { return storage->getSize(); }
 
 	Future<EncryptionAtRestMode> encryptionMode() { return storage->encryptionMode(); }
@@ -760,12 +779,18 @@ struct UpdateEagerReadInfo {
 	}
 };
 
+// The structure holding the MVCC window. Both have the same interface, so this is chosen at build time.
+#ifdef SS_VERSIONED_BTREE_MAP
+typedef VersionedBTreeMap<KeyRef, ValueOrClearToRef> StorageVersionedMap;
+#else
+typedef VersionedMap<KeyRef, ValueOrClearToRef> StorageVersionedMap;
+#endif
+
 const int VERSION_OVERHEAD =
     64 + sizeof(Version) + sizeof(Standalone<VerUpdateRef>) + // mutationLog, 64b overhead for map
     2 * (64 + sizeof(Version) +
-         sizeof(Reference<VersionedMap<KeyRef, ValueOrClearToRef>::PTreeT>)); // versioned map [ x2 for
-                                                                              // createNewVersion(version+1) ], 64b
-                                                                              // overhead for map
+         sizeof(StorageVersionedMap::Tree)); // versioned map [ x2 for createNewVersion(version+1) ], 64b
+                                             // overhead for map
 
 static int mvccStorageBytes(MutationRef const& m) {
 	return mvccStorageBytes(m.param1.size() + m.param2.size());
@@ -786,6 +811,8 @@ struct ChangeFeedInfo : ReferenceCounted<ChangeFeedInfo> {
 	Version metadataVersion = invalidVersion; // Last update to the change feed metadata. Used for reasoning about
 	                                          // fetched metadata vs local metadata
 	Version emptyVersion = 0; // The change feed does not have any mutations before emptyVersion
+	// Bumped whenever durable mutations below durableVersion may change, so that cached disk reads are not reused
+	uint64_t diskReadGeneration = 0;
 	KeyRange range;
 	Key id;
 	AsyncTrigger newMutations;
@@ -842,6 +869,7 @@ struct ChangeFeedInfo : ReferenceCounted<ChangeFeedInfo> {
 		updateMetadataVersion(destroyVersion);
 		removing = true;
 		destroyed = true;
+		++diskReadGeneration;
 		moved(range);
 		newMutations.trigger();
 	}
@@ -858,6 +886,12 @@ struct ChangeFeedInfo : ReferenceCounted<ChangeFeedInfo> {
 
 class ServerWatchMetadata : public ReferenceCounted<ServerWatchMetadata> {
 public:
+	// A watch request waiting for this key to change
+	struct PendingReply {
+		ReplyPromise<WatchValueReply> reply;
+		double startTime;
+	};
+
 	Key key;
 	Optional<Value> value;
 	Version version;
@@ -866,6 +900,8 @@ public:
 	Optional<TagSet> tags;
 	Optional<UID> debugID;
 	int64_t tenantId;
+	// Every request watching this key, oldest first. They are all answered by one watchValueSendReplies() actor.
+	std::deque<PendingReply> pendingReplies;
 
 	ServerWatchMetadata(Key key,
 	                    Optional<Value> value,
@@ -876,6 +912,14 @@ public:
 	  : key(key), value(value), version(version), tags(tags), debugID(debugID), tenantId(tenantId) {}
 };
 
+// A range watch, fired by the first mutation to its range
+struct RangeWatch : ReferenceCounted<RangeWatch> {
+	KeyRange range;
+	Promise<Version> fired;
+
+	explicit RangeWatch(KeyRange range) : range(range) {}
+};
+
 struct BusiestWriteTagContext {
 	const std::string busiestWriteTagTrackingKey;
 	UID ratekeeperID;
@@ -989,7 +1033,7 @@ struct TenantSSInfo {
 };
 
 struct StorageServer : public IStorageMetricsService {
-	typedef VersionedMap<KeyRef, ValueOrClearToRef> VersionedData;
+	typedef StorageVersionedMap VersionedData;
 
 private:
 	// versionedData contains sets and clears.
@@ -1045,6 +1089,17 @@ public:
 	std::map<Version, std::vector<CheckpointMetaData>> pendingCheckpoints; // Pending checkpoint requests
 	std::unordered_map<UID, CheckpointMetaData> checkpoints; // Existing and deleting checkpoints
 	std::unordered_map<UID, ICheckpointReader*> liveCheckpointReaders; // Active checkpoint readers
+	struct InFlightValueRead {
+		Future<Optional<Value>> value;
+		// The contents of the storage engine can't have changed since the read was issued while these are the same
+		Version storageVersion;
+		uint64_t shardChangeCounter;
+	};
+	// Storage engine reads issued by getValueQ, if STORAGE_COALESCE_VALUE_READS. Completed reads are removed by the
+	// requests waiting on them, or replaced by the next read of the key.
+	std::map<Key, InFlightValueRead, std::less<>> inFlightValueReads;
+	// Destroys the nodes of versionedData left behind by forgotten versions, if STORAGE_RECLAIM_VERSIONS_IN_BACKGROUND
+	Reference<IThreadPool> versionReclaimThread;
 	VersionedMap<int64_t, TenantSSInfo> tenantMap;
 	std::map<Version, std::vector<PendingNewShard>>
 	    pendingAddRanges; // Pending requests to add ranges to physical shards
@@ -1095,6 +1150,32 @@ public:
 	void deleteWatchMetadata(KeyRef key, int64_t tenantId);
 	void clearWatchMetadata();
 
+	// range watch operations
+	void addRangeWatch(Reference<RangeWatch> watch);
+	void removeRangeWatch(Reference<RangeWatch> watch);
+	// Fires the range watches on range, or on key
+	void triggerRangeWatches(KeyRangeRef range, Version version);
+	void triggerRangeWatches(KeyRef key, Version version);
+	void fireRangeWatches(const std::vector<Reference<RangeWatch>>& watches, Version version);
+
+	// change feed disk read cache operations
+	// Sets rows to what a read of feed's durable mutations in [begin, end), limited to byteLimit, would return, if a
+	// cached read covers it
+	bool readCachedChangeFeedDisk(Reference<ChangeFeedInfo> const& feed,
+	                              Version begin,
+	                              Version end,
+	                              int byteLimit,
+	                              RangeResult* rows);
+	// Caches the rows read from [begin, end) of feed's durable mutations, as of generation and durableVersion
+	void cacheChangeFeedDiskRead(Reference<ChangeFeedInfo> const& feed,
+	                             uint64_t generation,
+	                             Version begin,
+	                             Version end,
+	                             Version durableVersion,
+	                             int byteLimit,
+	                             RangeResult const& rows);
+	void invalidateChangeFeedDiskReads(ChangeFeedInfo* feed);
+
 	// tenant map operations
 	void insertTenant(TenantMapEntry const& tenant, Version version, bool persist);
 	void clearTenants(StringRef startTenant, StringRef endTenant, Version version);
@@ -1289,6 +1370,20 @@ public:
 
 	KeyRangeMap<std::vector<Reference<ChangeFeedInfo>>> keyChangeFeed;
 	std::unordered_map<Key, Reference<ChangeFeedInfo>> uidChangeFeed;
+
+	// A recent read of a change feed's durable mutations, which holds every row of the feed with a version in
+	// [begin, end)
+	struct ChangeFeedDiskRead {
+		Reference<ChangeFeedInfo> feed;
+		uint64_t generation;
+		Version begin;
+		Version end;
+		RangeResult rows;
+	};
+	// Most recently used first. Streams of the same feed catching up from disk, such as blob workers after a split,
+	// read the same versions one after the other, so they can share one storage read.
+	std::list<ChangeFeedDiskRead> changeFeedDiskReadCache;
+	int64_t changeFeedDiskReadCacheBytes = 0;
 	Deque<std::pair<std::vector<Key>, Version>> changeFeedVersions;
 	std::map<UID, PromiseStream<Key>> changeFeedDestroys;
 	std::set<Key> currentChangeFeeds;
@@ -1332,6 +1427,11 @@ public:
 	int64_t versionLag; // An estimate for how many versions it takes for the data to move from the logs to this storage
 	                    // server
 
+	// Readable shards with no writes for STORAGE_COLD_SHARD_AGE, and their sampled bytes, as of the last count by
+	// trackColdShards(). This is how much could move to a cheaper tier, such as blob granules, if it were evicted.
+	int64_t coldShards = 0;
+	int64_t coldBytes = 0;
+
 	Optional<UID> sourceTLogID; // the tLog from which the latest batch of versions were fetched
 
 	ProtocolVersion logProtocol;
@@ -1356,10 +1456,14 @@ public:
 	CoalescedKeyRangeMap<bool, int64_t, KeyBytesMetric<int64_t>> byteSampleClears;
 	AsyncVar<bool> byteSampleClearsTooLarge;
 	Future<Void> byteSampleRecovery;
+	Future<Void> changeFeedRecovery = Void();
 	Future<Void> durableInProgress;
 
 	AsyncMap<Key, bool> watches;
 	AsyncMap<int64_t, bool> tenantWatches;
+	HotKeyTracker hotKeys;
+	KeyRangeMap<std::vector<Reference<RangeWatch>>> rangeWatches;
+	int64_t numRangeWatches = 0;
 	int64_t watchBytes;
 	int64_t numWatches;
 	AsyncVar<bool> noRecentUpdates;
@@ -1397,6 +1501,37 @@ public:
 		return ssLock->lock(readPriorityRanks[readType]);
 	}
 
+	// As above, but while reads are waiting, a busy tag's normal or high priority reads wait with those one priority
+	// below, whose weight in ssLock is smaller, rather than delaying every other read of their own priority
+	Future<PriorityMultiLock::Lock> getReadLock(const Optional<ReadOptions>& options, const Optional<TagSet>& tags) {
+		int readType = (int)(options.present() ? options.get().type : ReadType::NORMAL);
+		readType = std::clamp<int>(readType, 0, readPriorityRanks.size() - 1);
+		if (readType > (int)ReadType::LOW && ssLock->getWaitersCount() > 0 && isBusyReadTag(tags)) {
+			CODE_PROBE(true, "Busy tag read deprioritized");
+			++counters.busyTagReadsDeprioritized;
+			--readType;
+		}
+		return ssLock->lock(readPriorityRanks[readType]);
+	}
+
+	// True if one of tags had at least STORAGE_SERVER_BUSY_TAG_READ_FRACTION of the busyness of the last interval
+	bool isBusyReadTag(const Optional<TagSet>& tags) const {
+		if (!tags.present() || SERVER_KNOBS->STORAGE_SERVER_BUSY_TAG_READ_FRACTION <= 0) {
+			return false;
+		}
+		for (auto const& busyTag : transactionTagCounter.getBusiestTags()) {
+			if (busyTag.fractionalBusyness < SERVER_KNOBS->STORAGE_SERVER_BUSY_TAG_READ_FRACTION) {
+				continue;
+			}
+			for (auto const& tag : tags.get()) {
+				if (tag == busyTag.tag) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
 	FlowLock serveAuditStorageParallelismLock;
 
 	int64_t instanceID;
@@ -1417,6 +1552,14 @@ public:
 	int64_t lastBytesInputEBrake;
 	Version lastDurableVersionEBrake;
 
+	// The storage queue size at which update() stops taking in versions, lowered below the e-brake's hard limit by
+	// memoryGovernor() once the storage engine's cache can't give up any more memory
+	int64_t memoryGovernorQueueLimit = std::numeric_limits<int64_t>::max();
+
+	// Read versions pinned by clients, as pin ID -> (pinned version, expire version), which update() keeps
+	// desiredOldestVersion from passing. Refreshed by watchPinnedReadVersions().
+	std::map<UID, std::pair<Version, Version>> pinnedReadVersions;
+
 	int maxQueryQueue;
 	int getAndResetMaxQueryQueueSize() {
 		int val = maxQueryQueue;
@@ -1434,9 +1577,10 @@ public:
 
 	struct Counters : CommonStorageCounters {
 
-		Counter allQueries, systemKeyQueries, getKeyQueries, getValueQueries, getRangeQueries, getRangeSystemKeyQueries,
-		    getRangeStreamQueries, lowPriorityQueries, rowsQueried, watchQueries, emptyQueries, feedRowsQueried,
-		    feedBytesQueried, feedStreamQueries, rejectedFeedStreamQueries, feedVersionQueries;
+		Counter allQueries, systemKeyQueries, getKeyQueries, getValueQueries, getValuesQueries, getRangeQueries,
+		    getRangeSystemKeyQueries, getRangeStreamQueries, lowPriorityQueries, rowsQueried, watchQueries,
+		    watchRangeQueries, emptyQueries, feedRowsQueried, feedBytesQueried, feedStreamQueries,
+		    rejectedFeedStreamQueries, feedVersionQueries;
 
 		// counters related to getMappedRange queries
 		Counter getMappedRangeBytesQueried, finishedGetMappedRangeSecondaryQueries, getMappedRangeQueries,
@@ -1457,6 +1601,8 @@ public:
 		// ClearRange operations issued by FDB, instead of from users, e.g., ClearRange operations to remove a shard
 		// from a storage server, as in removeDataRange().
 		Counter kvSystemClearRanges;
+		// Sets of sampled keys whose sampled size didn't change, so the byte sample was left as it was.
+		Counter byteSampleUnchangedSets;
 		// Bytes of the mutations that have been removed from memory because they durable. The counting is same as
 		// bytesInput, instead of the actual bytes taken in the storages, so that (bytesInput - bytesDurable) can
 		// reflect the current memory footprint of MVCC.
@@ -1474,6 +1620,8 @@ public:
 		Counter wrongShardServer;
 		Counter fetchedVersions;
 		Counter fetchesFromLogs;
+		// Fetches of bulk load tasks that read the task's SST files instead of the source servers, and their bytes
+		Counter bulkLoadFetches, bulkLoadBytes;
 		// The following counters measure how many of lookups in the getMappedRangeQueries are effective. "Miss"
 		// means fallback if fallback is enabled, otherwise means failure (so that another layer could implement
 		// fallback).
@@ -1485,14 +1633,26 @@ public:
 		Counter kvGetBytes;
 		// The number of keys read from storage engine by eagerReads.
 		Counter eagerReadsKeys;
+		// The number of atomic op keys eagerReads didn't read, because their latest value was in versionedData.
+		Counter eagerReadsInMemory;
+		// The number of rows filtered range reads scanned and left out of their replies.
+		Counter filteredRangeRowsSkipped;
 		// The count of readValue operation to the storage engine.
 		Counter kvGets;
+		// The count of getValue requests which shared a storage engine read issued for another request.
+		Counter coalescedKvGets;
 		// The count of readValue operation to the storage engine.
 		Counter kvScans;
 		// The count of commit operation to the storage engine.
 		Counter kvCommits;
 		// The count of change feed reads that hit disk
 		Counter changeFeedDiskReads;
+		// The count of reads by a busy tag that were queued one priority lower
+		Counter busyTagReadsDeprioritized;
+		// The count of change feed disk reads answered from a recent read of the same versions
+		Counter changeFeedDiskReadCacheHits;
+		// The count of pinned read versions given up before they expired, to keep the storage queue within budget
+		Counter pinnedReadVersionsReleased;
 		// The count of ChangeServerKeys actions.
 		Counter changeServerKeysAssigned;
 		Counter changeServerKeysUnassigned;
@@ -1517,6 +1677,7 @@ public:
 		LatencySample updateEncryptionLatencySample;
 
 		LatencyBands readLatencyBands;
+		TenantLatencyMap tenantReadLatencies;
 		LatencySample mappedRangeSample; // Samples getMappedRange latency
 		LatencySample mappedRangeRemoteSample; // Samples getMappedRange remote subquery latency
 		LatencySample mappedRangeLocalSample; // Samples getMappedRange local subquery latency
@@ -1524,16 +1685,19 @@ public:
 		explicit Counters(StorageServer* self)
 		  : CommonStorageCounters("StorageServer", self->thisServerID.toString(), &self->metrics),
 		    allQueries("QueryQueue", cc), systemKeyQueries("SystemKeyQueries", cc), getKeyQueries("GetKeyQueries", cc),
-		    getValueQueries("GetValueQueries", cc), getRangeQueries("GetRangeQueries", cc),
+		    getValueQueries("GetValueQueries", cc), getValuesQueries("GetValuesQueries", cc),
+		    getRangeQueries("GetRangeQueries", cc),
 		    getRangeSystemKeyQueries("GetRangeSystemKeyQueries", cc),
 		    getMappedRangeQueries("GetMappedRangeQueries", cc), getRangeStreamQueries("GetRangeStreamQueries", cc),
 		    lowPriorityQueries("LowPriorityQueries", cc), rowsQueried("RowsQueried", cc),
-		    watchQueries("WatchQueries", cc), emptyQueries("EmptyQueries", cc), feedRowsQueried("FeedRowsQueried", cc),
+		    watchQueries("WatchQueries", cc), watchRangeQueries("WatchRangeQueries", cc),
+		    emptyQueries("EmptyQueries", cc), feedRowsQueried("FeedRowsQueried", cc),
 		    feedBytesQueried("FeedBytesQueried", cc), feedStreamQueries("FeedStreamQueries", cc),
 		    rejectedFeedStreamQueries("RejectedFeedStreamQueries", cc), feedVersionQueries("FeedVersionQueries", cc),
 		    logicalBytesInput("LogicalBytesInput", cc), logicalBytesMoveInOverhead("LogicalBytesMoveInOverhead", cc),
 		    kvCommitLogicalBytes("KVCommitLogicalBytes", cc), kvClearRanges("KVClearRanges", cc),
 		    kvClearSingleKey("KVClearSingleKey", cc), kvSystemClearRanges("KVSystemClearRanges", cc),
+		    byteSampleUnchangedSets("ByteSampleUnchangedSets", cc),
 		    bytesDurable("BytesDurable", cc), feedBytesFetched("FeedBytesFetched", cc),
 		    sampledBytesCleared("SampledBytesCleared", cc), atomicMutations("AtomicMutations", cc),
 		    changeFeedMutations("ChangeFeedMutations", cc),
@@ -1542,11 +1706,17 @@ public:
 		    fetchWaitingCount("FetchWaitingCount", cc), fetchExecutingMS("FetchExecutingMS", cc),
 		    fetchExecutingCount("FetchExecutingCount", cc), readsRejected("ReadsRejected", cc),
 		    wrongShardServer("WrongShardServer", cc), fetchedVersions("FetchedVersions", cc),
-		    fetchesFromLogs("FetchesFromLogs", cc), quickGetValueHit("QuickGetValueHit", cc),
+		    fetchesFromLogs("FetchesFromLogs", cc), bulkLoadFetches("BulkLoadFetches", cc),
+		    bulkLoadBytes("BulkLoadBytes", cc), quickGetValueHit("QuickGetValueHit", cc),
 		    quickGetValueMiss("QuickGetValueMiss", cc), quickGetKeyValuesHit("QuickGetKeyValuesHit", cc),
 		    quickGetKeyValuesMiss("QuickGetKeyValuesMiss", cc), kvScanBytes("KVScanBytes", cc),
-		    kvGetBytes("KVGetBytes", cc), eagerReadsKeys("EagerReadsKeys", cc), kvGets("KVGets", cc),
-		    kvScans("KVScans", cc), kvCommits("KVCommits", cc), changeFeedDiskReads("ChangeFeedDiskReads", cc),
+		    kvGetBytes("KVGetBytes", cc), eagerReadsKeys("EagerReadsKeys", cc),
+		    eagerReadsInMemory("EagerReadsInMemory", cc), filteredRangeRowsSkipped("FilteredRangeRowsSkipped", cc),
+		    kvGets("KVGets", cc),
+		    coalescedKvGets("CoalescedKVGets", cc), kvScans("KVScans", cc), kvCommits("KVCommits", cc),
+		    changeFeedDiskReads("ChangeFeedDiskReads", cc), busyTagReadsDeprioritized("BusyTagReadsDeprioritized", cc),
+		    changeFeedDiskReadCacheHits("ChangeFeedDiskReadCacheHits", cc),
+		    pinnedReadVersionsReleased("PinnedReadVersionsReleased", cc),
 		    getMappedRangeBytesQueried("GetMappedRangeBytesQueried", cc),
 		    finishedGetMappedRangeQueries("FinishedGetMappedRangeQueries", cc),
 		    finishedGetMappedRangeSecondaryQueries("FinishedGetMappedRangeSecondaryQueries", cc),
@@ -1578,6 +1748,7 @@ public:
 		                        SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
 		                        SERVER_KNOBS->LATENCY_SKETCH_ACCURACY),
 		    readLatencyBands("ReadLatencyBands", self->thisServerID, SERVER_KNOBS->STORAGE_LOGGING_DELAY),
+		    tenantReadLatencies("TenantReadLatencies", self->thisServerID, SERVER_KNOBS->STORAGE_LOGGING_DELAY),
 		    mappedRangeSample("GetMappedRangeMetrics",
 		                      self->thisServerID,
 		                      SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
@@ -1607,7 +1778,10 @@ public:
 			specialCounter(cc, "StorageVersion", [self]() { return self->storageVersion(); });
 			specialCounter(cc, "DurableVersion", [self]() { return self->durableVersion.get(); });
 			specialCounter(cc, "DesiredOldestVersion", [self]() { return self->desiredOldestVersion.get(); });
+			specialCounter(cc, "PinnedReadVersions", [self]() { return self->pinnedReadVersions.size(); });
 			specialCounter(cc, "VersionLag", [self]() { return self->versionLag; });
+			specialCounter(cc, "ColdShards", [self]() { return self->coldShards; });
+			specialCounter(cc, "ColdBytes", [self]() { return self->coldBytes; });
 			specialCounter(cc, "LocalRate", [self] { return int64_t(self->currentRate() * 100); });
 
 			specialCounter(
@@ -1742,6 +1916,12 @@ public:
 		this->storage.kvGets = &counters.kvGets;
 		this->storage.kvScans = &counters.kvScans;
 		this->storage.kvCommits = &counters.kvCommits;
+
+		if (SERVER_KNOBS->STORAGE_RECLAIM_VERSIONS_IN_BACKGROUND) {
+			versionReclaimThread =
+			    g_network->isSimulated() ? CoroThreadPool::createThreadPool() : createGenericThreadPool();
+			versionReclaimThread->addThread(new VersionedMapReclaimer(), "fdb-ss-reclaim");
+		}
 	}
 
 	//~StorageServer() { fclose(log); }
@@ -1825,6 +2005,40 @@ public:
 	// This is the maximum version that might be read from storage (the minimum version is durableVersion)
 	Version storageVersion() const { return oldestVersion.get(); }
 
+	// Reads key from the storage engine for getValueQ, joining a read of the key already in flight if it would return
+	// the same value. Sets joined if it did. Call finishValueRead() once the read is done.
+	Future<Optional<Value>> readValueCoalesced(KeyRef key, Optional<ReadOptions> const& options, bool& joined) {
+		joined = false;
+		if (!SERVER_KNOBS->STORAGE_COALESCE_VALUE_READS) {
+			return storage.readValue(key, options);
+		}
+
+		auto it = inFlightValueReads.find(key);
+		if (it != inFlightValueReads.end()) {
+			const InFlightValueRead& read = it->second;
+			if (!read.value.isReady() && read.storageVersion == storageVersion() &&
+			    read.shardChangeCounter == shardChangeCounter) {
+				joined = true;
+				++counters.coalescedKvGets;
+				return read.value;
+			}
+			inFlightValueReads.erase(it);
+		}
+
+		Future<Optional<Value>> value = storage.readValue(key, options);
+		if (!value.isReady()) {
+			inFlightValueReads[Key(key)] = InFlightValueRead{ value, storageVersion(), shardChangeCounter };
+		}
+		return value;
+	}
+
+	void finishValueRead(KeyRef key) {
+		auto it = inFlightValueReads.find(key);
+		if (it != inFlightValueReads.end() && it->second.value.isReady()) {
+			inFlightValueReads.erase(it);
+		}
+	}
+
 	bool isReadable(KeyRangeRef const& keys) const override {
 		auto sh = shards.intersectingRanges(keys);
 		for (auto i = sh.begin(); i != sh.end(); ++i)
@@ -1862,6 +2076,15 @@ public:
 		                (currentRate() < 1e-6 ? 1e6 : 1.0 / currentRate()));
 	}
 
+	// Fills in the load a reply reports back to loadBalance(), so that clients can steer reads away from this server
+	// while it is behind.
+	void setReplyLoad(LoadBalancedReply& reply) const {
+		reply.penalty = getPenalty();
+		reply.versionLag = versionLag;
+		reply.busyness = g_network->isSimulated() ? deterministicRandom()->random01()
+		                                          : g_network->networkInfo.metrics.lastRunLoopBusyness;
+	}
+
 	// Normally the storage server prefers to serve read requests over making mutations
 	// durable to disk. However, when the storage server falls to far behind on
 	// making mutations durable, this function will change the priority to prefer writes.
@@ -1885,6 +2108,7 @@ public:
 		}
 		Reply reply;
 		reply.error = err;
+		setReplyLoad(reply);
 		reply.penalty = penalty;
 		promise.send(reply);
 	}
@@ -1991,7 +2215,8 @@ public:
 		                          versionLag,
 		                          lastUpdate,
 		                          counters.bytesDurable.getValue(),
-		                          counters.bytesInput.getValue());
+		                          counters.bytesInput.getValue(),
+		                          storage.isWrongConfigured());
 	}
 
 	void getSplitMetrics(const SplitMetricsRequest& req) override { this->metrics.splitMetrics(req); }
@@ -2095,6 +2320,60 @@ void StorageServer::clearWatchMetadata() {
 	watchMap.clear();
 }
 
+// rangeWatches Operations
+void StorageServer::addRangeWatch(Reference<RangeWatch> watch) {
+	auto rs = rangeWatches.modify(watch->range);
+	for (auto r = rs.begin(); r != rs.end(); ++r) {
+		r->value().push_back(watch);
+	}
+	rangeWatches.coalesce(watch->range.contents());
+	++numRangeWatches;
+}
+
+void StorageServer::removeRangeWatch(Reference<RangeWatch> watch) {
+	auto rs = rangeWatches.modify(watch->range);
+	for (auto r = rs.begin(); r != rs.end(); ++r) {
+		auto& watchList = r->value();
+		for (int i = 0; i < watchList.size(); i++) {
+			if (watchList[i] == watch) {
+				swapAndPop(&watchList, i--);
+			}
+		}
+	}
+	rangeWatches.coalesce(watch->range.contents());
+	--numRangeWatches;
+}
+
+void StorageServer::triggerRangeWatches(KeyRangeRef range, Version version) {
+	if (!numRangeWatches) {
+		return;
+	}
+	std::vector<Reference<RangeWatch>> watches;
+	for (auto& r : rangeWatches.intersectingRanges(range)) {
+		watches.insert(watches.end(), r.value().begin(), r.value().end());
+	}
+	fireRangeWatches(watches, version);
+}
+
+void StorageServer::triggerRangeWatches(KeyRef key, Version version) {
+	if (!numRangeWatches) {
+		return;
+	}
+	// Copied, since firing a watch removes it from the map
+	std::vector<Reference<RangeWatch>> watches = rangeWatches[key];
+	fireRangeWatches(watches, version);
+}
+
+void StorageServer::fireRangeWatches(const std::vector<Reference<RangeWatch>>& watches, Version version) {
+	for (auto& watch : watches) {
+		// A watch spanning several ranges of the map is listed once for each of them
+		if (!watch->fired.isSet()) {
+			removeRangeWatch(watch);
+			watch->fired.send(version);
+		}
+	}
+}
+
 #ifndef __INTEL_COMPILER
 #pragma endregion
 #endif
@@ -2450,8 +2729,14 @@ std::shared_ptr<MoveInShard> StorageServer::getMoveInShard(const UID& dataMoveId
 	return shard;
 }
 
+// Seconds a read has kept this server busy since it stopped waiting for its version, or 0 if it never got that far
+static double readServiceTime(double readStart) {
+	return readStart > 0 ? g_network->timer() - readStart : 0;
+}
+
 ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 	state int64_t resultSize = 0;
+	state double readStart = 0;
 	Span span("SS:getValue"_loc, req.spanContext);
 	// Temporarily disabled -- this path is hit a lot
 	// getCurrentLineage()->modify(&TransactionLineage::txID) = req.spanContext.first();
@@ -2468,7 +2753,7 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 		// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 		// so we need to downgrade here
 		wait(data->getQueryDelay());
-		state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+		state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tags));
 
 		// Track time from requestTime through now as read queueing wait time
 		state double queueWaitEnd = g_network->timer();
@@ -2482,7 +2767,8 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 		state Optional<Value> v;
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.spanContext));
-		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
+		readStart = g_network->timer();
+		data->counters.readVersionWaitSample.addMeasurement(readStart - queueWaitEnd);
 
 		if (req.options.present() && req.options.get().debugID.present())
 			g_traceBatch.addEvent("GetValueDebug",
@@ -2500,6 +2786,7 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 			throw wrong_shard_server();
 		}
 
+		data->hotKeys.addRead(req.key);
 		state int path = 0;
 		auto i = data->data().at(version).lastLessOrEqual(req.key);
 		if (i && i->isValue() && i.key() == req.key) {
@@ -2507,8 +2794,12 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 			path = 1;
 		} else if (!i || !i->isClearTo() || i->getEndKey() <= req.key) {
 			path = 2;
-			Optional<Value> vv = wait(data->storage.readValue(req.key, req.options));
-			data->counters.kvGetBytes += vv.expectedSize();
+			state bool joined;
+			Optional<Value> vv = wait(data->readValueCoalesced(req.key, req.options, joined));
+			data->finishValueRead(req.key);
+			if (!joined) {
+				data->counters.kvGetBytes += vv.expectedSize();
+			}
 			// Validate that while we were reading the data we didn't lose the version or shard
 			if (version < data->storageVersion()) {
 				CODE_PROBE(true, "transaction_too_old after readValue");
@@ -2565,7 +2856,7 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 		//	TraceEvent(SevDebug, "SSGetValueCached").detail("Key", req.key);
 
 		GetValueReply reply(v, cached);
-		reply.penalty = data->getPenalty();
+		data->setReplyLoad(reply);
 		req.reply.send(reply);
 	} catch (Error& e) {
 		if (!canReplyWith(e))
@@ -2575,7 +2866,142 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 
 	// Key size is not included in "BytesQueried", but still contributes to cost,
 	// so it must be accounted for here.
-	data->transactionTagCounter.addRequest(req.tags, req.key.size() + resultSize);
+	data->transactionTagCounter.addRequest(req.tags, req.key.size() + resultSize, readServiceTime(readStart));
+
+	++data->counters.finishedQueries;
+
+	double duration = g_network->timer() - req.requestTime();
+	data->counters.readLatencySample.addMeasurement(duration);
+	data->counters.readValueLatencySample.addMeasurement(duration);
+	if (data->latencyBandConfig.present()) {
+		int maxReadBytes =
+		    data->latencyBandConfig.get().readConfig.maxReadBytes.orDefault(std::numeric_limits<int>::max());
+		data->counters.readLatencyBands.addMeasurement(duration, 1, Filtered(resultSize > maxReadBytes));
+	}
+	if (req.tenantInfo.hasTenant()) {
+		data->counters.tenantReadLatencies.addMeasurement(
+		    req.tenantInfo.tenantId, TenantLatencyMap::RequestType::PointRead, duration);
+	}
+
+	return Void();
+}
+
+// Serves a GetValuesRequest as getValueQ would serve a GetValueRequest for each of its keys, waiting for the version
+// and the read lock once and reading the keys missing from the versioned data from the storage engine concurrently.
+ACTOR Future<Void> getValuesQ(StorageServer* data, GetValuesRequest req) {
+	state int64_t resultSize = 0;
+	state double readStart = 0;
+	state int64_t keyBytes = 0;
+	Span span("SS:getValues"_loc, req.spanContext);
+
+	try {
+		++data->counters.getValuesQueries;
+		++data->counters.allQueries;
+		data->maxQueryQueue = std::max<int>(
+		    data->maxQueryQueue, data->counters.allQueries.getValue() - data->counters.finishedQueries.getValue());
+
+		// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
+		// so we need to downgrade here
+		wait(data->getQueryDelay());
+		state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tags));
+
+		// Track time from requestTime through now as read queueing wait time
+		state double queueWaitEnd = g_network->timer();
+		data->counters.readQueueWaitSample.addMeasurement(queueWaitEnd - req.requestTime());
+
+		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
+		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.spanContext));
+		readStart = g_network->timer();
+		data->counters.readVersionWaitSample.addMeasurement(readStart - queueWaitEnd);
+
+		data->checkTenantEntry(version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
+		if (req.tenantInfo.hasTenant()) {
+			for (auto& key : req.keys) {
+				key = key.withPrefix(req.tenantInfo.prefix.get(), req.arena);
+			}
+		}
+		state uint64_t changeCounter = data->shardChangeCounter;
+
+		state GetValuesReply reply;
+		reply.values.resize(reply.arena, req.keys.size());
+		// The storage engine reads, and the indices of the keys they are for
+		state std::vector<Future<Optional<Value>>> reads;
+		state std::vector<int> readKeys;
+		state std::vector<bool> readJoined;
+		auto view = data->data().at(version);
+		for (int k = 0; k < req.keys.size(); k++) {
+			const KeyRef& key = req.keys[k];
+			keyBytes += key.size();
+			if (key.startsWith(systemKeys.begin)) {
+				++data->counters.systemKeyQueries;
+			}
+			if (!data->shards[key]->isReadable()) {
+				throw wrong_shard_server();
+			}
+
+			auto i = view.lastLessOrEqual(key);
+			if (i && i->isValue() && i.key() == key) {
+				reply.values[k] = ValueRef(reply.arena, i->getValue());
+			} else if (!i || !i->isClearTo() || i->getEndKey() <= key) {
+				bool joined;
+				reads.push_back(data->readValueCoalesced(key, req.options, joined));
+				readKeys.push_back(k);
+				readJoined.push_back(joined);
+			}
+		}
+
+		if (!reads.empty()) {
+			wait(waitForAll(reads));
+			// Validate that while we were reading the data we didn't lose the version or shards
+			if (version < data->storageVersion()) {
+				CODE_PROBE(true, "transaction_too_old after readValue in getValuesQ");
+				throw transaction_too_old();
+			}
+			for (int r = 0; r < reads.size(); r++) {
+				const KeyRef& key = req.keys[readKeys[r]];
+				data->checkChangeCounter(changeCounter, key);
+				data->finishValueRead(key);
+				const Optional<Value>& v = reads[r].get();
+				if (!readJoined[r]) {
+					data->counters.kvGetBytes += v.expectedSize();
+				}
+				if (v.present()) {
+					reply.arena.dependsOn(v.get().arena());
+					reply.values[readKeys[r]] = v.get();
+				}
+			}
+		}
+
+		for (int k = 0; k < req.keys.size(); k++) {
+			data->hotKeys.addRead(req.keys[k]);
+			const Optional<ValueRef>& v = reply.values[k];
+			if (v.present()) {
+				++data->counters.rowsQueried;
+				resultSize += v.get().size();
+				data->counters.bytesQueried += v.get().size();
+			} else {
+				++data->counters.emptyQueries;
+			}
+
+			if (SERVER_KNOBS->READ_SAMPLING_ENABLED) {
+				// If the read yields no value, randomly sample the empty read.
+				int64_t bytesReadPerKSecond =
+				    v.present()
+				        ? std::max((int64_t)(req.keys[k].size() + v.get().size()), SERVER_KNOBS->EMPTY_READ_PENALTY)
+				        : SERVER_KNOBS->EMPTY_READ_PENALTY;
+				data->metrics.notifyBytesReadPerKSecond(req.keys[k], bytesReadPerKSecond);
+			}
+		}
+
+		data->setReplyLoad(reply);
+		req.reply.send(reply);
+	} catch (Error& e) {
+		if (!canReplyWith(e))
+			throw;
+		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
+	}
+
+	data->transactionTagCounter.addRequest(req.tags, keyBytes + resultSize, readServiceTime(readStart));
 
 	++data->counters.finishedQueries;
 
@@ -2593,8 +3019,10 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 
 // Pessimistic estimate the number of overhead bytes used by each
 // watch. Watch key references are stored in an AsyncMap<Key,bool>, and actors
-// must be kept alive until the watch is finished.
-extern size_t WATCH_OVERHEAD_WATCHQ, WATCH_OVERHEAD_WATCHIMPL;
+// must be kept alive until the watch is finished. WATCH_OVERHEAD_WATCHQ is the
+// cost of each request, and WATCH_OVERHEAD_WATCHIMPL of each watched key.
+// WATCH_OVERHEAD_WATCHRANGE is the cost of each range watch, besides its range.
+extern size_t WATCH_OVERHEAD_WATCHQ, WATCH_OVERHEAD_WATCHIMPL, WATCH_OVERHEAD_WATCHRANGE;
 
 ACTOR Future<Version> watchWaitForValueChange(StorageServer* data, SpanContext parent, KeyRef key, int64_t tenantId) {
 	state Location spanLocation = "SS:watchWaitForValueChange"_loc;
@@ -2725,64 +3153,200 @@ ACTOR Future<Version> watchWaitForValueChange(StorageServer* data, SpanContext p
 	}
 }
 
-void checkCancelWatchImpl(StorageServer* data, WatchValueRequest req) {
-	Reference<ServerWatchMetadata> metadata = data->getWatchMetadata(req.key.contents(), req.tenantInfo.tenantId);
-	if (metadata.isValid() && metadata->versionPromise.getFutureReferenceCount() == 1) {
-		// last watch timed out so cancel watch_impl and delete key from the map
-		data->deleteWatchMetadata(req.key.contents(), req.tenantInfo.tenantId);
+// Removes metadata from the watch map, unless a newer watch on the same key has already replaced it
+void removeWatchMetadata(StorageServer* data, Reference<ServerWatchMetadata> metadata) {
+	if (data->getWatchMetadata(metadata->key, metadata->tenantId) == metadata) {
+		data->deleteWatchMetadata(metadata->key, metadata->tenantId);
+	}
+}
+
+// Releases the accounting for the oldest count requests watching metadata's key, and drops them
+void popWatchReplies(StorageServer* data, Reference<ServerWatchMetadata> metadata, size_t count) {
+	data->numWatches -= count;
+	data->watchBytes -= count * WATCH_OVERHEAD_WATCHQ;
+	metadata->pendingReplies.erase(metadata->pendingReplies.begin(), metadata->pendingReplies.begin() + count);
+}
+
+// Answers every request watching metadata's key, so that a watched key costs one actor however many clients watch it.
+// Requests are queued in arrival order, so the front one is always the next to time out.
+ACTOR Future<Void> watchValueSendReplies(StorageServer* data, Reference<ServerWatchMetadata> metadata) {
+	state Future<Version> resp = metadata->versionPromise.getFuture();
+	state double watchTimeout;
+
+	try {
+		loop {
+			watchTimeout = -1;
+			if (data->noRecentUpdates.get()) {
+				watchTimeout = CLIENT_KNOBS->FAST_WATCH_TIMEOUT;
+			} else if (!BUGGIFY) {
+				watchTimeout = CLIENT_KNOBS->WATCH_TIMEOUT;
+			}
+			double timeoutDelay =
+			    watchTimeout < 0
+			        ? -1
+			        : std::max(watchTimeout - (now() - metadata->pendingReplies.front().startTime), 0.0);
+
+			choose {
+				when(Version ver = wait(resp)) {
+					// fire watch
+					for (auto& pending : metadata->pendingReplies) {
+						pending.reply.send(WatchValueReply{ ver });
+					}
+					popWatchReplies(data, metadata, metadata->pendingReplies.size());
+					removeWatchMetadata(data, metadata);
+					return Void();
+				}
+				when(wait(timeoutDelay < 0 ? Never() : delay(timeoutDelay))) {
+					// time out every watch that has waited long enough
+					size_t timedOut = 0;
+					for (auto& pending : metadata->pendingReplies) {
+						if (now() - pending.startTime < watchTimeout) {
+							break;
+						}
+						data->sendErrorWithPenalty(pending.reply, timed_out(), data->getPenalty());
+						timedOut++;
+					}
+					popWatchReplies(data, metadata, timedOut);
+					if (metadata->pendingReplies.empty()) {
+						// last watch timed out so cancel watch_impl and delete key from the map
+						removeWatchMetadata(data, metadata);
+						metadata->watch_impl.cancel();
+						return Void();
+					}
+				}
+				when(wait(data->noRecentUpdates.onChange())) {}
+			}
+		}
+	} catch (Error& e) {
+		if (canReplyWith(e)) {
+			for (auto& pending : metadata->pendingReplies) {
+				data->sendErrorWithPenalty(pending.reply, e, data->getPenalty());
+			}
+		}
+		popWatchReplies(data, metadata, metadata->pendingReplies.size());
+		removeWatchMetadata(data, metadata);
 		metadata->watch_impl.cancel();
+
+		if (!canReplyWith(e))
+			throw e;
+		return Void();
 	}
 }
 
-ACTOR Future<Void> watchValueSendReply(StorageServer* data,
-                                       WatchValueRequest req,
-                                       Future<Version> resp,
-                                       SpanContext spanContext) {
-	state Span span("SS:watchValue"_loc, spanContext);
-	state double startTime = now();
+// Queues req to be answered when metadata's watch fires or times out, starting the key's reply actor for its first
+// request
+void addWatchReply(StorageServer* data, Reference<ServerWatchMetadata> metadata, const WatchValueRequest& req) {
 	++data->counters.watchQueries;
 	++data->numWatches;
 	data->watchBytes += WATCH_OVERHEAD_WATCHQ;
+	metadata->pendingReplies.push_back(ServerWatchMetadata::PendingReply{ req.reply, now() });
+	if (metadata->pendingReplies.size() == 1) {
+		data->actors.add(watchValueSendReplies(data, metadata));
+	}
+}
 
-	loop {
-		double timeoutDelay = -1;
-		if (data->noRecentUpdates.get()) {
-			timeoutDelay = std::max(CLIENT_KNOBS->FAST_WATCH_TIMEOUT - (now() - startTime), 0.0);
-		} else if (!BUGGIFY) {
-			timeoutDelay = std::max(CLIENT_KNOBS->WATCH_TIMEOUT - (now() - startTime), 0.0);
+// Returns the version of a mutation to range after version. The versioned data holds every mutation since the durable
+// version, so a watch from before that fires right away, as it can't tell whether the range changed.
+Optional<Version> rangeChangedSince(StorageServer* data, KeyRangeRef range, Version version) {
+	if (version < data->durableVersion.get()) {
+		CODE_PROBE(true, "Range watch from before the durable version");
+		return data->version.get();
+	}
+
+	auto view = data->data().atLatest();
+	auto i = view.lastLessOrEqual(range.begin);
+	if (i && (i.key() < range.begin && (!i->isClearTo() || i->getEndKey() <= range.begin))) {
+		++i;
+	} else if (!i) {
+		i = view.begin();
+	}
+	for (; i != view.end() && i.key() < range.end; ++i) {
+		if (i.insertVersion() > version) {
+			return i.insertVersion();
 		}
+	}
+	return Optional<Version>();
+}
+
+void finishRangeWatch(StorageServer* data, Reference<RangeWatch> watch, int64_t watchBytes) {
+	if (!watch->fired.isSet()) {
+		data->removeRangeWatch(watch);
+	}
+	data->watchBytes -= watchBytes;
+	--data->numWatches;
+}
+
+ACTOR Future<Void> watchRangeQ(StorageServer* data, WatchRangeRequest req) {
+	state Span span("SS:watchRange"_loc, req.spanContext);
+	state Reference<RangeWatch> watch;
+	state int64_t watchBytes = 0;
+	state double startTime;
+
+	getCurrentLineage()->modify(&TransactionLineage::txID) = req.spanContext.traceID;
+	++data->counters.watchRangeQueries;
+	try {
+		wait(success(waitForVersionNoTooOld(data, req.version)));
+		data->checkTenantEntry(latestVersion, req.tenantInfo, false);
+		if (req.tenantInfo.hasTenant()) {
+			req.range = req.range.withPrefix(req.tenantInfo.prefix.get());
+		}
+		for (auto shard : data->shards.intersectingRanges(req.range)) {
+			if (!shard.value()->isReadable()) {
+				throw wrong_shard_server();
+			}
+		}
+
+		// Mutations up to the latest version are in the versioned data, and later ones will fire the watch
+		Optional<Version> changed = rangeChangedSince(data, req.range, req.version);
+		if (changed.present()) {
+			req.reply.send(WatchRangeReply{ changed.get() });
+			return Void();
+		}
+		if (data->watchBytes > SERVER_KNOBS->MAX_STORAGE_SERVER_WATCH_BYTES) {
+			CODE_PROBE(true, "Too many watches, range watch reverting to polling");
+			throw watch_cancelled();
+		}
+
+		watch = makeReference<RangeWatch>(req.range);
+		data->addRangeWatch(watch);
+		watchBytes = req.range.expectedSize() + WATCH_OVERHEAD_WATCHRANGE;
+		data->watchBytes += watchBytes;
+		++data->numWatches;
+		startTime = now();
+
+		loop {
+			double timeoutDelay = -1;
+			if (data->noRecentUpdates.get()) {
+				timeoutDelay = std::max(CLIENT_KNOBS->FAST_WATCH_TIMEOUT - (now() - startTime), 0.0);
+			} else if (!BUGGIFY) {
+				timeoutDelay = std::max(CLIENT_KNOBS->WATCH_TIMEOUT - (now() - startTime), 0.0);
+			}
 
-		try {
 			choose {
-				when(Version ver = wait(resp)) {
+				when(Version ver = wait(watch->fired.getFuture())) {
 					// fire watch
-					req.reply.send(WatchValueReply{ ver });
-					checkCancelWatchImpl(data, req);
-					--data->numWatches;
-					data->watchBytes -= WATCH_OVERHEAD_WATCHQ;
-					return Void();
+					req.reply.send(WatchRangeReply{ ver });
+					break;
 				}
 				when(wait(timeoutDelay < 0 ? Never() : delay(timeoutDelay))) {
 					// watch timed out
 					data->sendErrorWithPenalty(req.reply, timed_out(), data->getPenalty());
-					checkCancelWatchImpl(data, req);
-					--data->numWatches;
-					data->watchBytes -= WATCH_OVERHEAD_WATCHQ;
-					return Void();
+					break;
 				}
 				when(wait(data->noRecentUpdates.onChange())) {}
 			}
-		} catch (Error& e) {
-			data->watchBytes -= WATCH_OVERHEAD_WATCHQ;
-			checkCancelWatchImpl(data, req);
-			--data->numWatches;
-
-			if (!canReplyWith(e))
-				throw e;
-			data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
-			return Void();
 		}
+	} catch (Error& e) {
+		if (watch.isValid()) {
+			finishRangeWatch(data, watch, watchBytes);
+		}
+		if (!canReplyWith(e))
+			throw e;
+		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
+		return Void();
 	}
+	finishRangeWatch(data, watch, watchBytes);
+	return Void();
 }
 
 // Finds a checkpoint.
@@ -2997,7 +3561,7 @@ ACTOR Future<Void> fetchCheckpointKeyValuesQ(StorageServer* self, FetchCheckpoin
 }
 
 ACTOR Future<Void> overlappingChangeFeedsQ(StorageServer* data, OverlappingChangeFeedsRequest req) {
-	wait(delay(0));
+	wait(data->changeFeedRecovery && delay(0));
 	try {
 		wait(success(waitForVersionNoTooOld(data, req.minVersion)));
 	} catch (Error& e) {
@@ -3235,6 +3799,106 @@ static std::deque<Standalone<EncryptedMutationsAndVersionRef>>::const_iterator s
 // NORMAL -> NORMAL (always)
 enum FeedDiskReadState { STARTING, NORMAL, DISK_CATCHUP };
 
+static Version changeFeedDurableRowVersion(KeyValueRef const& row) {
+	return decodeChangeFeedDurableKey(row.key).second;
+}
+
+// Returns the first of rows, all of one feed, with a version of at least version
+static const KeyValueRef* changeFeedDurableRowsFrom(RangeResult const& rows, Key const& feedId, Version version) {
+	Key key = changeFeedDurableKey(feedId, version);
+	return std::lower_bound(
+	    rows.begin(), rows.end(), key, [](KeyValueRef const& row, Key const& key) { return row.key < key; });
+}
+
+bool StorageServer::readCachedChangeFeedDisk(Reference<ChangeFeedInfo> const& feed,
+                                             Version begin,
+                                             Version end,
+                                             int byteLimit,
+                                             RangeResult* rows) {
+	if (feed->removing) {
+		return false;
+	}
+	for (auto it = changeFeedDiskReadCache.begin(); it != changeFeedDiskReadCache.end(); ++it) {
+		if (it->feed != feed || it->generation != feed->diskReadGeneration || begin < it->begin || begin >= it->end) {
+			continue;
+		}
+		// Counts bytes the way getChangeFeedMutations does, which is never less than the storage engines count them,
+		// so a read from the same version runs out of bytes no later than the read that was cached did
+		const KeyValueRef* first = changeFeedDurableRowsFrom(it->rows, feed->id, begin);
+		const KeyValueRef* last = first;
+		int remainingBytes = byteLimit;
+		while (last != it->rows.end() && remainingBytes > 0 && changeFeedDurableRowVersion(*last) < end) {
+			remainingBytes -= sizeof(KeyValueRef) + last->expectedSize();
+			++last;
+		}
+		if (remainingBytes > 0 && end > it->end) {
+			// Reading from disk could return rows after the cached ones
+			continue;
+		}
+		*rows = RangeResult();
+		rows->arena().dependsOn(it->rows.arena());
+		rows->append(rows->arena(), first, last - first);
+		rows->more = remainingBytes <= 0;
+		changeFeedDiskReadCache.splice(changeFeedDiskReadCache.begin(), changeFeedDiskReadCache, it);
+		return true;
+	}
+	return false;
+}
+
+void StorageServer::cacheChangeFeedDiskRead(Reference<ChangeFeedInfo> const& feed,
+                                            uint64_t generation,
+                                            Version begin,
+                                            Version end,
+                                            Version durableVersion,
+                                            int byteLimit,
+                                            RangeResult const& rows) {
+	if (SERVER_KNOBS->CHANGE_FEED_DISK_READ_CACHE_BYTES <= 0 || feed->removing ||
+	    generation != feed->diskReadGeneration) {
+		return;
+	}
+	// Versions that were not durable before the read may still be written, and a read that hit its limit says
+	// nothing about the versions after its last row
+	end = std::min(end, durableVersion + 1);
+	if (rows.more) {
+		if (rows.empty()) {
+			return;
+		}
+		end = std::min(end, changeFeedDurableRowVersion(rows.back()) + 1);
+	}
+	if (end <= begin) {
+		return;
+	}
+
+	RangeResult cached;
+	cached.arena().dependsOn(rows.arena());
+	cached.append(cached.arena(), rows.begin(), changeFeedDurableRowsFrom(rows, feed->id, end) - rows.begin());
+	for (auto it = changeFeedDiskReadCache.begin(); it != changeFeedDiskReadCache.end(); ++it) {
+		if (it->feed == feed && it->begin == begin) {
+			changeFeedDiskReadCacheBytes -= it->rows.expectedSize();
+			changeFeedDiskReadCache.erase(it);
+			break;
+		}
+	}
+	changeFeedDiskReadCacheBytes += cached.expectedSize();
+	changeFeedDiskReadCache.push_front(ChangeFeedDiskRead{ feed, generation, begin, end, cached });
+	while (changeFeedDiskReadCacheBytes > SERVER_KNOBS->CHANGE_FEED_DISK_READ_CACHE_BYTES) {
+		changeFeedDiskReadCacheBytes -= changeFeedDiskReadCache.back().rows.expectedSize();
+		changeFeedDiskReadCache.pop_back();
+	}
+}
+
+void StorageServer::invalidateChangeFeedDiskReads(ChangeFeedInfo* feed) {
+	++feed->diskReadGeneration;
+	for (auto it = changeFeedDiskReadCache.begin(); it != changeFeedDiskReadCache.end();) {
+		if (it->feed.getPtr() == feed) {
+			changeFeedDiskReadCacheBytes -= it->rows.expectedSize();
+			it = changeFeedDiskReadCache.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
 ACTOR Future<std::pair<ChangeFeedStreamReply, bool>> getChangeFeedMutations(StorageServer* data,
                                                                             Reference<ChangeFeedInfo> feedInfo,
                                                                             ChangeFeedStreamRequest req,
@@ -3378,15 +4042,26 @@ ACTOR Future<std::pair<ChangeFeedStreamReply, bool>> getChangeFeedMutations(Stor
 		// The delay(0) is technically only necessary if we did not immediately acquire the lock, but isn't a big deal
 		// to do always
 		wait(delay(0));
-		state RangeResult res = wait(
-		    data->storage.readRange(KeyRangeRef(changeFeedDurableKey(req.rangeID, std::max(req.begin, emptyVersion)),
-		                                        changeFeedDurableKey(req.rangeID, req.end)),
-		                            1 << 30,
-		                            remainingDurableBytes,
-		                            req.options));
+		state Version readBegin = std::max(req.begin, emptyVersion);
+		state RangeResult res;
+		if (data->readCachedChangeFeedDisk(feedInfo, readBegin, req.end, remainingDurableBytes, &res)) {
+			++data->counters.changeFeedDiskReadCacheHits;
+		} else {
+			// Both are taken before the read, since data that becomes durable or is fetched during it may be missed
+			state Version durableBeforeRead = feedInfo->durableVersion;
+			state uint64_t diskReadGeneration = feedInfo->diskReadGeneration;
+			wait(store(res,
+			           data->storage.readRange(KeyRangeRef(changeFeedDurableKey(req.rangeID, readBegin),
+			                                               changeFeedDurableKey(req.rangeID, req.end)),
+			                                   1 << 30,
+			                                   remainingDurableBytes,
+			                                   req.options)));
+			data->counters.kvScanBytes += res.logicalSize();
+			++data->counters.changeFeedDiskReads;
+			data->cacheChangeFeedDiskRead(
+			    feedInfo, diskReadGeneration, readBegin, req.end, durableBeforeRead, remainingDurableBytes, res);
+		}
 		ssReadLock.release();
-		data->counters.kvScanBytes += res.logicalSize();
-		++data->counters.changeFeedDiskReads;
 
 		if (!req.range.empty()) {
 			data->checkChangeCounter(changeCounter, req.range);
@@ -3793,6 +4468,7 @@ ACTOR Future<Void> changeFeedStreamQ(StorageServer* data, ChangeFeedStreamReques
 		}
 
 		data->activeFeedQueries++;
+		wait(data->changeFeedRecovery);
 
 		if (req.replyBufferSize <= 0) {
 			req.reply.setByteLimit(SERVER_KNOBS->CHANGEFEEDSTREAM_LIMIT_BYTES);
@@ -3994,13 +4670,18 @@ ACTOR Future<Void> changeFeedVersionUpdateQ(StorageServer* data, ChangeFeedVersi
 }
 
 #ifdef NO_INTELLISENSE
-size_t WATCH_OVERHEAD_WATCHQ =
-    sizeof(WatchValueSendReplyActorState<WatchValueSendReplyActor>) + sizeof(WatchValueSendReplyActor);
+size_t WATCH_OVERHEAD_WATCHQ = sizeof(ServerWatchMetadata::PendingReply);
 size_t WATCH_OVERHEAD_WATCHIMPL =
-    sizeof(WatchWaitForValueChangeActorState<WatchWaitForValueChangeActor>) + sizeof(WatchWaitForValueChangeActor);
+    sizeof(WatchWaitForValueChangeActorState<WatchWaitForValueChangeActor>) + sizeof(WatchWaitForValueChangeActor) +
+    sizeof(WatchValueSendRepliesActorState<WatchValueSendRepliesActor>) + sizeof(WatchValueSendRepliesActor);
+// Each range watch adds up to two ranges to rangeWatches, and is listed in each range it covers
+size_t WATCH_OVERHEAD_WATCHRANGE =
+    sizeof(WatchRangeQActorState<WatchRangeQActor>) + sizeof(WatchRangeQActor) + sizeof(RangeWatch) +
+    2 * (sizeof(MapPair<Key, std::vector<Reference<RangeWatch>>>) + sizeof(Reference<RangeWatch>));
 #else
 size_t WATCH_OVERHEAD_WATCHQ = 0; // only used in IDE so value is irrelevant
 size_t WATCH_OVERHEAD_WATCHIMPL = 0;
+size_t WATCH_OVERHEAD_WATCHRANGE = 0;
 #endif
 
 ACTOR Future<Void> getShardState_impl(StorageServer* data, GetShardStateRequest req) {
@@ -4194,6 +4875,106 @@ ACTOR Future<GetValueReqAndResultRef> quickGetValue(StorageServer* data,
 	}
 }
 
+// Looks up keys as quickGetValue() does, but in batches: one GetValuesRequest for the keys served here, and one
+// transaction read, which sends a request per storage team, for the rest. A key repeated in keys is looked up once.
+ACTOR Future<std::vector<GetValueReqAndResultRef>> quickGetValues(StorageServer* data,
+                                                                 Standalone<VectorRef<KeyRef>> keys,
+                                                                 Version version,
+                                                                 Arena* a,
+                                                                 // To provide span context, tags, debug ID to
+                                                                 // underlying lookups.
+                                                                 GetMappedKeyValuesRequest* pOriginalReq) {
+	state double getValuesStart = g_network->timer();
+	state std::vector<GetValueReqAndResultRef> results(keys.size());
+	// The index of the first occurrence of each key, whose result the others copy
+	state std::vector<int> firstIndex(keys.size());
+	state Standalone<VectorRef<KeyRef>> localKeys;
+	state std::vector<int> localIndexes;
+	state Standalone<VectorRef<KeyRef>> remoteKeys;
+	state std::vector<int> remoteIndexes;
+	localKeys.arena().dependsOn(keys.arena());
+	remoteKeys.arena().dependsOn(keys.arena());
+
+	std::map<KeyRef, int> seen;
+	for (int i = 0; i < keys.size(); i++) {
+		results[i].key = keys[i];
+		auto [it, inserted] = seen.try_emplace(keys[i], i);
+		firstIndex[i] = it->second;
+		if (!inserted) {
+			continue;
+		}
+		if (data->shards[keys[i]]->isReadable()) {
+			localKeys.push_back(localKeys.arena(), keys[i]);
+			localIndexes.push_back(i);
+		} else {
+			remoteKeys.push_back(remoteKeys.arena(), keys[i]);
+			remoteIndexes.push_back(i);
+		}
+	}
+	CODE_PROBE(seen.size() < keys.size(), "Mapped point lookups shared a record");
+
+	if (!localKeys.empty()) {
+		state bool localDone = false;
+		try {
+			// As in quickGetValue(), this does not use readGuard, since throttling is done for the original request
+			GetValuesRequest req(pOriginalReq->spanContext,
+			                     pOriginalReq->tenantInfo,
+			                     localKeys,
+			                     version,
+			                     pOriginalReq->tags,
+			                     pOriginalReq->options,
+			                     VersionVector());
+			data->actors.add(getValuesQ(data, req));
+			GetValuesReply reply = wait(req.reply.getFuture());
+			if (!reply.error.present()) {
+				data->counters.quickGetValueHit += localKeys.size();
+				a->dependsOn(reply.arena);
+				for (int i = 0; i < localIndexes.size(); i++) {
+					results[localIndexes[i]].result = reply.values[i];
+				}
+				data->counters.mappedRangeLocalSample.addMeasurement(g_network->timer() - getValuesStart);
+				localDone = true;
+			}
+			// Otherwise fallback.
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			// Fallback.
+		}
+		if (!localDone) {
+			// A shard moved away, for instance, so read them all from wherever they are now
+			remoteKeys.append(remoteKeys.arena(), localKeys.begin(), localKeys.size());
+			remoteIndexes.insert(remoteIndexes.end(), localIndexes.begin(), localIndexes.end());
+		}
+	}
+
+	if (!remoteKeys.empty()) {
+		data->counters.quickGetValueMiss += remoteKeys.size();
+		if (!SERVER_KNOBS->QUICK_GET_VALUE_FALLBACK) {
+			throw quick_get_value_miss();
+		}
+		Optional<Reference<Tenant>> tenant = pOriginalReq->tenantInfo.hasTenant()
+		                                         ? makeReference<Tenant>(pOriginalReq->tenantInfo.tenantId)
+		                                         : Optional<Reference<Tenant>>();
+		state Transaction tr(data->cx, tenant);
+		tr.setVersion(version);
+		// TODO: is DefaultPromiseEndpoint the best priority for this?
+		tr.trState->taskID = TaskPriority::DefaultPromiseEndpoint;
+		state double remoteStart = g_network->timer();
+		std::vector<Optional<Value>> values = wait(tr.getMulti(remoteKeys, Snapshot::True));
+		for (int i = 0; i < remoteIndexes.size(); i++) {
+			copyOptionalValue(a, results[remoteIndexes[i]], values[i]);
+		}
+		data->counters.mappedRangeRemoteSample.addMeasurement(g_network->timer() - remoteStart);
+	}
+
+	for (int i = 0; i < keys.size(); i++) {
+		results[i].result = results[firstIndex[i]].result;
+	}
+	return results;
+}
+
 // If limit>=0, it returns the first rows in the range (sorted ascending), otherwise the last rows (sorted descending).
 // readRange has O(|result|) + O(log |data|) cost
 ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
@@ -4449,6 +5230,87 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 	return result;
 }
 
+// Like readRange, but returns only the rows that match filter, if there is one, so that only they count against limit
+// and *pLimitBytes. With aggregate, the rows are added up into the reply's aggregate instead of being returned, and the
+// limits don't apply. At most FILTERED_RANGE_READ_MAX_SCAN_BYTES, or AGGREGATE_RANGE_READ_MAX_SCAN_BYTES, are scanned.
+// If the scan stops before the end of range, more is set and readThrough is the last key scanned, whether or not it
+// matched.
+ACTOR Future<GetKeyValuesReply> readFilteredRange(StorageServer* data,
+                                                  Version version,
+                                                  KeyRange range,
+                                                  int limit,
+                                                  int* pLimitBytes,
+                                                  SpanContext parentSpan,
+                                                  Optional<ReadOptions> options,
+                                                  Optional<KeyRef> tenantPrefix,
+                                                  Optional<KeyValueFilterRef> filter,
+                                                  bool aggregate) {
+	state GetKeyValuesReply result;
+	state int scanBytes = aggregate ? SERVER_KNOBS->AGGREGATE_RANGE_READ_MAX_SCAN_BYTES
+	                                : SERVER_KNOBS->FILTERED_RANGE_READ_MAX_SCAN_BYTES;
+	state bool forward = limit >= 0;
+	state RangeAggregate totals;
+	state Span span("SS:readFilteredRange"_loc, parentSpan);
+	result.version = version;
+	result.cached = false;
+
+	loop {
+		// Rows that don't match are dropped, so read in pieces of at least a full reply
+		state int pieceStartBytes = std::min(scanBytes, std::max(*pLimitBytes, CLIENT_KNOBS->REPLY_BYTE_LIMIT));
+		state int pieceBytes = pieceStartBytes;
+		GetKeyValuesReply piece = wait(readRange(
+		    data, version, range, forward ? 1 << 30 : -(1 << 30), &pieceBytes, span.context, options, tenantPrefix));
+		scanBytes -= pieceStartBytes - pieceBytes;
+		result.cached = piece.cached;
+		result.arena.dependsOn(piece.arena);
+
+		bool full = false;
+		for (auto& kv : piece.data) {
+			if (filter.present() && !filter.get().matches(kv)) {
+				++data->counters.filteredRangeRowsSkipped;
+				continue;
+			}
+			if (aggregate) {
+				totals.add(kv);
+				continue;
+			}
+			result.data.push_back(result.arena, kv);
+			*pLimitBytes -= sizeof(KeyValueRef) + kv.expectedSize();
+			limit += forward ? -1 : 1;
+			if (limit == 0 || *pLimitBytes <= 0) {
+				full = true;
+				break;
+			}
+		}
+
+		if (full) {
+			result.more = true;
+			break;
+		}
+		if (!piece.more || piece.data.empty()) {
+			result.more = false;
+			break;
+		}
+		if (scanBytes <= 0) {
+			CODE_PROBE(true, "Filtered range read stopped at its scan limit");
+			result.more = true;
+			result.readThrough = piece.data.back().key;
+			break;
+		}
+
+		KeyRef last = addPrefix(piece.data.back().key, tenantPrefix, result.arena);
+		if (forward) {
+			range = KeyRangeRef(keyAfter(last), range.end);
+		} else {
+			range = KeyRangeRef(range.begin, last);
+		}
+	}
+	if (aggregate) {
+		result.aggregate = totals;
+	}
+	return result;
+}
+
 ACTOR Future<Key> findKey(StorageServer* data,
                           KeySelectorRef sel,
                           Version version,
@@ -4659,6 +5521,7 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 {
 	state Span span("SS:getKeyValues"_loc, req.spanContext);
 	state int64_t resultSize = 0;
+	state double readStart = 0;
 
 	getCurrentLineage()->modify(&TransactionLineage::txID) = req.spanContext.traceID;
 
@@ -4674,7 +5537,7 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 	// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 	// so we need to downgrade here
 	wait(data->getQueryDelay());
-	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tags));
 
 	// Track time from requestTime through now as read queueing wait time
 	state double queueWaitEnd = g_network->timer();
@@ -4695,7 +5558,8 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 		    .detail("DebugID",
 		            req.options.present() && req.options.get().debugID.present() ? req.options.get().debugID.get()
 		                                                                         : UID());
-		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
+		readStart = g_network->timer();
+		data->counters.readVersionWaitSample.addMeasurement(readStart - queueWaitEnd);
 
 		data->checkTenantEntry(version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
 		if (req.tenantInfo.hasTenant()) {
@@ -4736,6 +5600,9 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 		        : findKey(data, req.end, version, searchRange, &offset2, span.context, req.options);
 		state Key begin = wait(fBegin);
 		state Key end = wait(fEnd);
+		if (begin < end) {
+			data->hotKeys.addRead(KeyRangeRef(begin, end));
+		}
 
 		if (req.options.present() && req.options.get().debugID.present())
 			g_traceBatch.addEvent(
@@ -4765,7 +5632,7 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 			GetKeyValuesReply none;
 			none.version = version;
 			none.more = false;
-			none.penalty = data->getPenalty();
+			data->setReplyLoad(none);
 
 			data->checkChangeCounter(changeCounter,
 			                         KeyRangeRef(std::min<KeyRef>(req.begin.getKey(), req.end.getKey()),
@@ -4779,14 +5646,30 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 			state int remainingLimitBytes = req.limitBytes;
 
 			state double kvReadRange = g_network->timer();
-			GetKeyValuesReply _r = wait(readRange(data,
-			                                      version,
-			                                      KeyRangeRef(begin, end),
-			                                      req.limit,
-			                                      &remainingLimitBytes,
-			                                      span.context,
-			                                      req.options,
-			                                      req.tenantInfo.prefix));
+			state GetKeyValuesReply _r;
+			if (req.filter.present() || req.aggregate) {
+				wait(store(_r,
+				           readFilteredRange(data,
+				                             version,
+				                             KeyRangeRef(begin, end),
+				                             req.limit,
+				                             &remainingLimitBytes,
+				                             span.context,
+				                             req.options,
+				                             req.tenantInfo.prefix,
+				                             req.filter,
+				                             req.aggregate)));
+			} else {
+				wait(store(_r,
+				           readRange(data,
+				                     version,
+				                     KeyRangeRef(begin, end),
+				                     req.limit,
+				                     &remainingLimitBytes,
+				                     span.context,
+				                     req.options,
+				                     req.tenantInfo.prefix)));
+			}
 			const double duration = g_network->timer() - kvReadRange;
 			data->counters.kvReadRangeLatencySample.addMeasurement(duration);
 			GetKeyValuesReply r = _r;
@@ -4825,11 +5708,18 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 				    addPrefix(r.data[r.data.size() - 1].key, req.tenantInfo.prefix, req.arena), bytesReadPerKSecond);
 			}
 
-			r.penalty = data->getPenalty();
+			data->setReplyLoad(r);
 			if (g_network->isSimulated()) {
 				maybeInjectConsistencyScanCorruption(data->thisServerID, req, r);
 			}
-			req.reply.send(r);
+			if (req.compressionFilter != CompressionFilter::NONE &&
+			    totalByteSize >= SERVER_KNOBS->RANGE_REPLY_COMPRESSION_MIN_BYTES) {
+				GetKeyValuesReply compressed = r;
+				compressed.compress(req.compressionFilter);
+				req.reply.send(compressed);
+			} else {
+				req.reply.send(r);
+			}
 
 			resultSize = req.limitBytes - remainingLimitBytes;
 			data->counters.bytesQueried += resultSize;
@@ -4844,7 +5734,7 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
 	}
 
-	data->transactionTagCounter.addRequest(req.tags, resultSize);
+	data->transactionTagCounter.addRequest(req.tags, resultSize, readServiceTime(readStart));
 	++data->counters.finishedQueries;
 
 	double duration = g_network->timer() - req.requestTime();
@@ -4861,10 +5751,112 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 		                                                        abs(req.begin.offset) > maxSelectorOffset ||
 		                                                        abs(req.end.offset) > maxSelectorOffset));
 	}
+	if (req.tenantInfo.hasTenant()) {
+		data->counters.tenantReadLatencies.addMeasurement(
+		    req.tenantInfo.tenantId, TenantLatencyMap::RequestType::RangeRead, duration, resultSize);
+	}
 
 	return Void();
 }
 
+// Each key and value seeds the hash of the next, so the boundaries between them are part of the checksum.
+static uint64_t checkSumKeyValues(VectorRef<KeyValueRef> const& kvs, uint64_t checkSum) {
+	for (const auto& kv : kvs) {
+		checkSum = XXH3_64bits_withSeed(kv.key.begin(), kv.key.size(), checkSum);
+		checkSum = XXH3_64bits_withSeed(kv.value.begin(), kv.value.size(), checkSum);
+	}
+	return checkSum;
+}
+
+// Checksums one range at its version, stopping at the first key past limitBytes so that replicas with the same data
+// cover the same range
+ACTOR Future<CheckSumMetaData> getRangeCheckSum(StorageServer* data,
+                                                KeyRange range,
+                                                Optional<Version> readVersion,
+                                                int limitBytes,
+                                                Optional<ReadOptions> options,
+                                                SpanContext spanContext) {
+	state Version version = wait(waitForVersion(data, readVersion.orDefault(latestVersion), spanContext));
+	state uint64_t changeCounter = data->shardChangeCounter;
+	state KeyRange shard = getShardKeyRange(data, firstGreaterOrEqual(range.begin));
+	if (!shard.contains(range.begin) || range.end > shard.end) {
+		throw wrong_shard_server();
+	}
+
+	state uint64_t checkSum = 0;
+	state int64_t bytes = 0;
+	state Key begin = range.begin;
+	state int requestedBytes;
+	state int remainingLimitBytes;
+	loop {
+		requestedBytes = limitBytes > 0 ? std::min<int64_t>(limitBytes - bytes, CLIENT_KNOBS->REPLY_BYTE_LIMIT)
+		                                : CLIENT_KNOBS->REPLY_BYTE_LIMIT;
+		remainingLimitBytes = requestedBytes;
+		GetKeyValuesReply r = wait(readRange(data,
+		                                     version,
+		                                     KeyRangeRef(begin, range.end),
+		                                     std::numeric_limits<int>::max(),
+		                                     &remainingLimitBytes,
+		                                     spanContext,
+		                                     options,
+		                                     Optional<KeyRef>()));
+		data->checkChangeCounter(changeCounter, range);
+		checkSum = checkSumKeyValues(r.data, checkSum);
+		bytes += requestedBytes - remainingLimitBytes;
+		if (!r.more || r.data.empty()) {
+			break;
+		}
+		begin = keyAfter(r.data.back().key);
+		if (limitBytes > 0 && bytes >= limitBytes) {
+			range = KeyRangeRef(range.begin, begin);
+			break;
+		}
+	}
+
+	data->counters.bytesQueried += bytes;
+	CheckSumMetaData result;
+	result.range = range;
+	result.version = version;
+	result.checkSumValue =
+	    StringRef(result.range.arena(), StringRef(reinterpret_cast<const uint8_t*>(&checkSum), sizeof(checkSum)));
+	result.bytes = bytes;
+	return result;
+}
+
+ACTOR Future<Void> getStorageCheckSumQ(StorageServer* data, GetStorageCheckSumRequest req) {
+	state Span span("SS:getStorageCheckSum"_loc);
+	state GetStorageCheckSumReply reply;
+	state int i = 0;
+
+	if (req.checkSumMethod != static_cast<uint8_t>(CheckSumMethod::XXH3)) {
+		req.reply.sendError(not_implemented());
+		return Void();
+	}
+
+	++data->counters.allQueries;
+	wait(data->getQueryDelay());
+	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+
+	try {
+		for (i = 0; i < req.ranges.size(); i++) {
+			CheckSumMetaData checkSum = wait(getRangeCheckSum(
+			    data, req.ranges[i].first, req.ranges[i].second, req.limitBytes, req.options, span.context));
+			reply.checkSums.push_back(checkSum);
+			reply.checkSums.back().checkSumValue = StringRef(reply.arena, checkSum.checkSumValue);
+		}
+		reply.checkSumMethod = req.checkSumMethod;
+		data->setReplyLoad(reply);
+		req.reply.send(reply);
+	} catch (Error& e) {
+		if (!canReplyWith(e))
+			throw;
+		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
+	}
+
+	++data->counters.finishedQueries;
+	return Void();
+}
+
 ACTOR Future<GetRangeReqAndResultRef> quickGetKeyValues(
     StorageServer* data,
     StringRef prefix,
@@ -5544,6 +6536,76 @@ ACTOR Future<Void> auditStorageServerShardQ(StorageServer* data, AuditStorageReq
 	return Void();
 }
 
+// Compares this server's digest of range with those of the servers in serverListValues, covering up to digestBytes of
+// it. Returns the digest they all agree on, or nothing if they differ or one of them cannot compute digests, in which
+// case unsupported is set.
+ACTOR Future<Optional<CheckSumMetaData>> auditStorageReplicaDigests(StorageServer* data,
+                                                                    AuditStorageRequest req,
+                                                                    std::vector<Optional<Value>> serverListValues,
+                                                                    KeyRange range,
+                                                                    Version version,
+                                                                    int digestBytes,
+                                                                    bool* unsupported) {
+	state GetStorageCheckSumRequest checkSumReq({ { range, version } }, req.id, CheckSumMethod::XXH3);
+	checkSumReq.limitBytes = digestBytes;
+	state std::vector<Future<ErrorOr<GetStorageCheckSumReply>>> fs;
+	for (const auto& v : serverListValues) {
+		if (!v.present()) {
+			TraceEvent(SevWarn, "SSAuditStorageShardReplicaRemoteServerNotFound", data->thisServerID)
+			    .detail("AuditID", req.id)
+			    .detail("AuditRange", req.range)
+			    .detail("AuditType", req.type);
+			throw audit_storage_failed();
+		}
+		StorageServerInterface remoteServer = decodeServerListValue(v.get());
+		resetReply(checkSumReq);
+		fs.push_back(remoteServer.getCheckSum.getReplyUnlessFailedFor(checkSumReq, 2, 0));
+	}
+	resetReply(checkSumReq);
+	data->actors.add(getStorageCheckSumQ(data, checkSumReq));
+	fs.push_back(errorOr(checkSumReq.reply.getFuture()));
+	std::vector<ErrorOr<GetStorageCheckSumReply>> reps = wait(getAll(fs));
+
+	for (int i = 0; i < reps.size(); ++i) {
+		if (reps[i].isError() && reps[i].getError().code() == error_code_not_implemented) {
+			*unsupported = true;
+			return Optional<CheckSumMetaData>();
+		}
+		Optional<Error> e = reps[i].isError() ? reps[i].getError() : reps[i].get().error;
+		if (e.present()) {
+			TraceEvent(SevWarn, "SSAuditStorageShardReplicaGetCheckSumError", data->thisServerID)
+			    .errorUnsuppressed(e.get())
+			    .detail("AuditID", req.id)
+			    .detail("AuditRange", req.range)
+			    .detail("AuditType", req.type)
+			    .detail("ReplyIndex", i)
+			    .detail("RangeRead", range);
+			throw e.get();
+		}
+		if (reps[i].get().checkSums.size() != 1) {
+			throw audit_storage_failed();
+		}
+	}
+
+	// The last one of reps is local
+	const CheckSumMetaData& local = reps.back().get().checkSums[0];
+	for (int i = 0; i < reps.size() - 1; ++i) {
+		const CheckSumMetaData& remote = reps[i].get().checkSums[0];
+		if (remote.range != local.range || remote.checkSumValue != local.checkSumValue) {
+			TraceEvent(SevInfo, "SSAuditStorageShardReplicaDigestMismatch", data->thisServerID)
+			    .detail("AuditID", req.id)
+			    .detail("AuditRange", req.range)
+			    .detail("DigestRange", range)
+			    .detail("DigestBytes", digestBytes)
+			    .detail("LocalRangeEnd", local.range.end)
+			    .detail("RemoteRangeEnd", remote.range.end)
+			    .detail("Version", version);
+			return Optional<CheckSumMetaData>();
+		}
+	}
+	return local;
+}
+
 ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRequest req) {
 	ASSERT(req.getType() == AuditType::ValidateHA || req.getType() == AuditType::ValidateReplica);
 	wait(data->serveAuditStorageParallelismLock.take(TaskPriority::DefaultYield));
@@ -5577,11 +6639,19 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 	state double rateLimiterTotalWaitTime = 0;
 	state Reference<IRateControl> rateLimiter =
 	    Reference<IRateControl>(new SpeedLimit(SERVER_KNOBS->AUDIT_STORAGE_RATE_PER_SERVER_MAX, 1));
+	// Ranges are first compared by their digests, which only needs the data read where they differ. After a mismatch
+	// the digest range shrinks by AUDIT_STORAGE_DIGEST_FANOUT each round, so the differing keys are found in a
+	// logarithmic number of rounds, and then read and compared below to report them.
+	state int digestBytes = SERVER_KNOBS->AUDIT_STORAGE_DIGEST_BYTES;
+	state Optional<CheckSumMetaData> digestAgreed;
+	state bool digestUnsupported = false;
+	state int64_t digestValidatedBytes = 0;
 
 	try {
 		loop {
 			try {
 				readBytes = 0;
+				digestAgreed.reset();
 				rangeToRead = KeyRangeRef(rangeToReadBegin, req.range.end);
 				TraceEvent(SevDebug, "SSAuditStorageShardReplicaNewRoundBegin", data->thisServerID)
 				    .suppressFor(10.0)
@@ -5610,130 +6680,219 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 				// Decide version to compare
 				wait(store(version, tr.getReadVersion()));
 
-				// Read remote servers
-				for (const auto& v : serverListValues) {
-					if (!v.present()) {
-						TraceEvent(SevWarn, "SSAuditStorageShardReplicaRemoteServerNotFound", data->thisServerID)
-						    .detail("AuditID", req.id)
-						    .detail("AuditRange", req.range)
-						    .detail("AuditType", req.type);
-						throw audit_storage_failed();
-					}
-					StorageServerInterface remoteServer = decodeServerListValue(v.get());
-
-					GetKeyValuesRequest req;
-					req.begin = firstGreaterOrEqual(rangeToRead.begin);
-					req.end = firstGreaterOrEqual(rangeToRead.end);
-					req.limit = limit;
-					req.limitBytes = limitBytes;
-					req.version = version;
-					req.tags = TagSet();
-					fs.push_back(remoteServer.getKeyValues.getReplyUnlessFailedFor(req, 2, 0));
-				}
-
-				// Read local server
-				GetKeyValuesRequest localReq;
-				localReq.begin = firstGreaterOrEqual(rangeToRead.begin);
-				localReq.end = firstGreaterOrEqual(rangeToRead.end);
-				localReq.limit = limit;
-				localReq.limitBytes = limitBytes;
-				localReq.version = version;
-				localReq.tags = TagSet();
-				data->actors.add(getKeyValuesQ(data, localReq));
-				fs.push_back(errorOr(localReq.reply.getFuture()));
-				std::vector<ErrorOr<GetKeyValuesReply>> reps = wait(getAll(fs));
-				// Note: getAll() must keep the order of fs
-
-				// Check read result
-				for (int i = 0; i < reps.size(); ++i) {
-					if (reps[i].isError()) {
-						TraceEvent(SevWarn, "SSAuditStorageShardReplicaGetKeyValuesError", data->thisServerID)
-						    .errorUnsuppressed(reps[i].getError())
-						    .detail("AuditID", req.id)
-						    .detail("AuditRange", req.range)
-						    .detail("AuditType", req.type)
-						    .detail("ReplyIndex", i)
-						    .detail("RangeRead", rangeToRead);
-						throw reps[i].getError();
+				if (digestBytes > limitBytes && !serverListValues.empty()) {
+					wait(store(digestAgreed,
+					           auditStorageReplicaDigests(data,
+					                                      req,
+					                                      serverListValues,
+					                                      rangeToRead,
+					                                      version,
+					                                      digestBytes,
+					                                      &digestUnsupported)));
+					if (digestAgreed.present()) {
+						const CheckSumMetaData& agreed = digestAgreed.get();
+						int64_t bytes = agreed.bytes * (serverListValues.size() + 1);
+						readBytes += bytes;
+						validatedBytes += bytes;
+						digestValidatedBytes += agreed.bytes;
+						claimRange = KeyRangeRef(rangeToRead.begin, agreed.range.end);
+						complete = claimRange.end == req.range.end;
+					} else if (digestUnsupported) {
+						CODE_PROBE(true, "Audit storage replica falls back to reads for servers without digests");
+						digestBytes = 0;
+					} else {
+						CODE_PROBE(true, "Audit storage replica narrows down digest mismatch");
+						digestBytes /= std::max(2, SERVER_KNOBS->AUDIT_STORAGE_DIGEST_FANOUT);
 					}
-					if (reps[i].get().error.present()) {
-						TraceEvent(SevWarn, "SSAuditStorageShardReplicaGetKeyValuesError", data->thisServerID)
-						    .errorUnsuppressed(reps[i].get().error.get())
-						    .detail("AuditID", req.id)
-						    .detail("AuditRange", req.range)
-						    .detail("AuditType", req.type)
-						    .detail("ReplyIndex", i)
-						    .detail("RangeRead", rangeToRead);
-						throw reps[i].get().error.get();
+				}
+
+				if (!digestAgreed.present()) {
+					// Read remote servers
+					for (const auto& v : serverListValues) {
+						if (!v.present()) {
+							TraceEvent(SevWarn, "SSAuditStorageShardReplicaRemoteServerNotFound", data->thisServerID)
+							    .detail("AuditID", req.id)
+							    .detail("AuditRange", req.range)
+							    .detail("AuditType", req.type);
+							throw audit_storage_failed();
+						}
+						StorageServerInterface remoteServer = decodeServerListValue(v.get());
+
+						GetKeyValuesRequest req;
+						req.begin = firstGreaterOrEqual(rangeToRead.begin);
+						req.end = firstGreaterOrEqual(rangeToRead.end);
+						req.limit = limit;
+						req.limitBytes = limitBytes;
+						req.version = version;
+						req.tags = TagSet();
+						fs.push_back(remoteServer.getKeyValues.getReplyUnlessFailedFor(req, 2, 0));
 					}
-					readBytes = readBytes + reps[i].get().data.expectedSize();
-					validatedBytes = validatedBytes + reps[i].get().data.expectedSize();
-					// If any of reps finishes read, we think we complete
-					// Even some rep does not finish read, this unfinished rep has more key than
-					// the complete rep, which will lead to missKey inconsistency in
-					// this round of check
-					if (!reps[i].get().more) {
-						complete = true;
+
+					// Read local server
+					GetKeyValuesRequest localReq;
+					localReq.begin = firstGreaterOrEqual(rangeToRead.begin);
+					localReq.end = firstGreaterOrEqual(rangeToRead.end);
+					localReq.limit = limit;
+					localReq.limitBytes = limitBytes;
+					localReq.version = version;
+					localReq.tags = TagSet();
+					data->actors.add(getKeyValuesQ(data, localReq));
+					fs.push_back(errorOr(localReq.reply.getFuture()));
+					std::vector<ErrorOr<GetKeyValuesReply>> reps = wait(getAll(fs));
+					// Note: getAll() must keep the order of fs
+
+					// Check read result
+					for (int i = 0; i < reps.size(); ++i) {
+						if (reps[i].isError()) {
+							TraceEvent(SevWarn, "SSAuditStorageShardReplicaGetKeyValuesError", data->thisServerID)
+							    .errorUnsuppressed(reps[i].getError())
+							    .detail("AuditID", req.id)
+							    .detail("AuditRange", req.range)
+							    .detail("AuditType", req.type)
+							    .detail("ReplyIndex", i)
+							    .detail("RangeRead", rangeToRead);
+							throw reps[i].getError();
+						}
+						if (reps[i].get().error.present()) {
+							TraceEvent(SevWarn, "SSAuditStorageShardReplicaGetKeyValuesError", data->thisServerID)
+							    .errorUnsuppressed(reps[i].get().error.get())
+							    .detail("AuditID", req.id)
+							    .detail("AuditRange", req.range)
+							    .detail("AuditType", req.type)
+							    .detail("ReplyIndex", i)
+							    .detail("RangeRead", rangeToRead);
+							throw reps[i].get().error.get();
+						}
+						readBytes = readBytes + reps[i].get().data.expectedSize();
+						validatedBytes = validatedBytes + reps[i].get().data.expectedSize();
+						// If any of reps finishes read, we think we complete
+						// Even some rep does not finish read, this unfinished rep has more key than
+						// the complete rep, which will lead to missKey inconsistency in
+						// this round of check
+						if (!reps[i].get().more) {
+							complete = true;
+						}
 					}
-				}
 
-				// Validation
-				claimRange = rangeToRead;
-				const GetKeyValuesReply& local = reps.back().get();
-				if (serverListValues.size() != reps.size() - 1) {
-					TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
-					           "SSAuditStorageShardReplicaRepsLengthWrong",
-					           data->thisServerID)
-					    .detail("ServerListValuesSize", serverListValues.size())
-					    .detail("RepsSize", reps.size());
-					throw audit_storage_cancelled();
-				}
-				if (reps.size() == 1) {
-					// if no other server to compare
-					TraceEvent(SevWarn, "SSAuditStorageShardReplicaNothingToCompare", data->thisServerID)
-					    .detail("AuditID", req.id)
-					    .detail("AuditRange", req.range)
-					    .detail("AuditType", req.type)
-					    .detail("TargetServers", describe(req.targetServers));
-					complete = true;
-				}
-				// Compare local and each remote one by one
-				// The last one of reps is local, so skip it
-				for (int repIdx = 0; repIdx < reps.size() - 1; repIdx++) {
-					const GetKeyValuesReply& remote = reps[repIdx].get();
-					// serverListValues and reps should be same order
-					if (!serverListValues[repIdx].present()) { // if not, already throw audit_storage_failed
+					// Validation
+					claimRange = rangeToRead;
+					const GetKeyValuesReply& local = reps.back().get();
+					if (serverListValues.size() != reps.size() - 1) {
 						TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
-						           "SSAuditStorageShardReplicaRepIdxNotPresent",
+						           "SSAuditStorageShardReplicaRepsLengthWrong",
 						           data->thisServerID)
-						    .detail("RepIdx", repIdx);
+						    .detail("ServerListValuesSize", serverListValues.size())
+						    .detail("RepsSize", reps.size());
 						throw audit_storage_cancelled();
 					}
-					const StorageServerInterface& remoteServer = decodeServerListValue(serverListValues[repIdx].get());
-					Key lastKey = rangeToRead.begin;
-					const int end = std::min(local.data.size(), remote.data.size());
-					bool missingKey = local.data.size() != remote.data.size();
-					// Compare each key one by one
-					std::string error;
-					int i = 0;
-					for (; i < end; ++i) {
-						KeyValueRef remoteKV = remote.data[i];
-						KeyValueRef localKV = local.data[i];
-						if (!req.range.contains(remoteKV.key) || !req.range.contains(localKV.key)) {
-							TraceEvent(SevWarn, "SSAuditStorageShardReplicaKeyOutOfRange", data->thisServerID)
-							    .detail("AuditRange", req.range)
-							    .detail("RemoteServer", remoteServer.toString())
-							    .detail("LocalKey", localKV.key)
-							    .detail("RemoteKey", remoteKV.key);
-							throw wrong_shard_server();
+					if (reps.size() == 1) {
+						// if no other server to compare
+						TraceEvent(SevWarn, "SSAuditStorageShardReplicaNothingToCompare", data->thisServerID)
+						    .detail("AuditID", req.id)
+						    .detail("AuditRange", req.range)
+						    .detail("AuditType", req.type)
+						    .detail("TargetServers", describe(req.targetServers));
+						complete = true;
+					}
+					// Compare local and each remote one by one
+					// The last one of reps is local, so skip it
+					for (int repIdx = 0; repIdx < reps.size() - 1; repIdx++) {
+						const GetKeyValuesReply& remote = reps[repIdx].get();
+						// serverListValues and reps should be same order
+						if (!serverListValues[repIdx].present()) { // if not, already throw audit_storage_failed
+							TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
+							           "SSAuditStorageShardReplicaRepIdxNotPresent",
+							           data->thisServerID)
+							    .detail("RepIdx", repIdx);
+							throw audit_storage_cancelled();
 						}
-						// Check if mismatch
-						if (remoteKV.key != localKV.key) {
-							error = format("Key Mismatch: local server (%016llx): %s, remote server(%016llx) %s",
-							               data->thisServerID.first(),
-							               Traceable<StringRef>::toString(localKV.key).c_str(),
-							               remoteServer.uniqueID.first(),
-							               Traceable<StringRef>::toString(remoteKV.key).c_str());
+						const StorageServerInterface& remoteServer =
+						    decodeServerListValue(serverListValues[repIdx].get());
+						Key lastKey = rangeToRead.begin;
+						const int end = std::min(local.data.size(), remote.data.size());
+						bool missingKey = local.data.size() != remote.data.size();
+						// Compare each key one by one
+						std::string error;
+						int i = 0;
+						for (; i < end; ++i) {
+							KeyValueRef remoteKV = remote.data[i];
+							KeyValueRef localKV = local.data[i];
+							if (!req.range.contains(remoteKV.key) || !req.range.contains(localKV.key)) {
+								TraceEvent(SevWarn, "SSAuditStorageShardReplicaKeyOutOfRange", data->thisServerID)
+								    .detail("AuditRange", req.range)
+								    .detail("RemoteServer", remoteServer.toString())
+								    .detail("LocalKey", localKV.key)
+								    .detail("RemoteKey", remoteKV.key);
+								throw wrong_shard_server();
+							}
+							// Check if mismatch
+							if (remoteKV.key != localKV.key) {
+								error = format("Key Mismatch: local server (%016llx): %s, remote server(%016llx) %s",
+								               data->thisServerID.first(),
+								               Traceable<StringRef>::toString(localKV.key).c_str(),
+								               remoteServer.uniqueID.first(),
+								               Traceable<StringRef>::toString(remoteKV.key).c_str());
+								TraceEvent(SevError, "SSAuditStorageShardReplicaError", data->thisServerID)
+								    .setMaxFieldLength(-1)
+								    .setMaxEventLength(-1)
+								    .detail("AuditId", req.id)
+								    .detail("AuditRange", req.range)
+								    .detail("ErrorMessage", error)
+								    .detail("Version", version)
+								    .detail("ClaimRange", claimRange);
+								errors.push_back(error);
+								break;
+							} else if (remoteKV.value != localKV.value) {
+								error = format(
+								    "Value Mismatch for Key %s: local server (%016llx): %s, remote server(%016llx) %s",
+								    Traceable<StringRef>::toString(localKV.key).c_str(),
+								    data->thisServerID.first(),
+								    Traceable<StringRef>::toString(localKV.value).c_str(),
+								    remoteServer.uniqueID.first(),
+								    Traceable<StringRef>::toString(remoteKV.value).c_str());
+								TraceEvent(SevError, "SSAuditStorageShardReplicaError", data->thisServerID)
+								    .setMaxFieldLength(-1)
+								    .setMaxEventLength(-1)
+								    .detail("AuditId", req.id)
+								    .detail("AuditRange", req.range)
+								    .detail("ErrorMessage", error)
+								    .detail("Version", version)
+								    .detail("ClaimRange", claimRange);
+								errors.push_back(error);
+								break;
+							} else {
+								TraceEvent(SevVerbose, "SSAuditStorageShardReplicaValidatedKey", data->thisServerID)
+								    .detail("Key", localKV.key);
+							}
+							++numValidatedKeys;
+							lastKey = localKV.key;
+						}
+						KeyRange completeRange = Standalone(KeyRangeRef(rangeToRead.begin, keyAfter(lastKey)));
+						if (completeRange.empty() || claimRange.begin != completeRange.begin) {
+							TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
+							           "SSAuditStorageShardReplicaCompleteRangeUnexpected",
+							           data->thisServerID)
+							    .detail("ClaimRange", claimRange)
+							    .detail("CompleteRange", completeRange);
+							throw audit_storage_cancelled();
+						}
+						claimRange = claimRange & completeRange;
+						if (!error.empty()) { // if key or value mismatch detected
+							continue; // check next remote server
+						}
+						if (!local.more && !remote.more && local.data.size() == remote.data.size()) {
+							continue; // check next remote server
+						} else if (i >= local.data.size() && !local.more && i < remote.data.size()) {
+							if (!missingKey) {
+								TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
+								           "SSAuditStorageShardReplicaMissingKeyUnexpected",
+								           data->thisServerID);
+							}
+							std::string error =
+							    format("Missing key(s) form local server (%lld), next key: %s, remote server(%016llx) ",
+							           data->thisServerID.first(),
+							           Traceable<StringRef>::toString(remote.data[i].key).c_str(),
+							           remoteServer.uniqueID.first());
 							TraceEvent(SevError, "SSAuditStorageShardReplicaError", data->thisServerID)
 							    .setMaxFieldLength(-1)
 							    .setMaxEventLength(-1)
@@ -5743,90 +6902,31 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 							    .detail("Version", version)
 							    .detail("ClaimRange", claimRange);
 							errors.push_back(error);
-							break;
-						} else if (remoteKV.value != localKV.value) {
-							error = format(
-							    "Value Mismatch for Key %s: local server (%016llx): %s, remote server(%016llx) %s",
-							    Traceable<StringRef>::toString(localKV.key).c_str(),
-							    data->thisServerID.first(),
-							    Traceable<StringRef>::toString(localKV.value).c_str(),
-							    remoteServer.uniqueID.first(),
-							    Traceable<StringRef>::toString(remoteKV.value).c_str());
+							continue; // check next remote server
+						} else if (i >= remote.data.size() && !remote.more && i < local.data.size()) {
+							if (!missingKey) {
+								TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
+								           "SSAuditStorageShardReplicaMissingKeyUnexpected",
+								           data->thisServerID);
+							}
+							std::string error =
+							    format("Missing key(s) form remote server (%lld), next local server(%016llx) key: %s",
+							           remoteServer.uniqueID.first(),
+							           data->thisServerID.first(),
+							           Traceable<StringRef>::toString(local.data[i].key).c_str());
 							TraceEvent(SevError, "SSAuditStorageShardReplicaError", data->thisServerID)
 							    .setMaxFieldLength(-1)
 							    .setMaxEventLength(-1)
 							    .detail("AuditId", req.id)
 							    .detail("AuditRange", req.range)
 							    .detail("ErrorMessage", error)
-							    .detail("Version", version)
-							    .detail("ClaimRange", claimRange);
-							errors.push_back(error);
-							break;
-						} else {
-							TraceEvent(SevVerbose, "SSAuditStorageShardReplicaValidatedKey", data->thisServerID)
-							    .detail("Key", localKV.key);
-						}
-						++numValidatedKeys;
-						lastKey = localKV.key;
-					}
-					KeyRange completeRange = Standalone(KeyRangeRef(rangeToRead.begin, keyAfter(lastKey)));
-					if (completeRange.empty() || claimRange.begin != completeRange.begin) {
-						TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
-						           "SSAuditStorageShardReplicaCompleteRangeUnexpected",
-						           data->thisServerID)
-						    .detail("ClaimRange", claimRange)
-						    .detail("CompleteRange", completeRange);
-						throw audit_storage_cancelled();
-					}
-					claimRange = claimRange & completeRange;
-					if (!error.empty()) { // if key or value mismatch detected
-						continue; // check next remote server
-					}
-					if (!local.more && !remote.more && local.data.size() == remote.data.size()) {
-						continue; // check next remote server
-					} else if (i >= local.data.size() && !local.more && i < remote.data.size()) {
-						if (!missingKey) {
-							TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
-							           "SSAuditStorageShardReplicaMissingKeyUnexpected",
-							           data->thisServerID);
-						}
-						std::string error =
-						    format("Missing key(s) form local server (%lld), next key: %s, remote server(%016llx) ",
-						           data->thisServerID.first(),
-						           Traceable<StringRef>::toString(remote.data[i].key).c_str(),
-						           remoteServer.uniqueID.first());
-						TraceEvent(SevError, "SSAuditStorageShardReplicaError", data->thisServerID)
-						    .setMaxFieldLength(-1)
-						    .setMaxEventLength(-1)
-						    .detail("AuditId", req.id)
-						    .detail("AuditRange", req.range)
-						    .detail("ErrorMessage", error)
-						    .detail("Version", version)
-						    .detail("ClaimRange", claimRange);
-						errors.push_back(error);
-						continue; // check next remote server
-					} else if (i >= remote.data.size() && !remote.more && i < local.data.size()) {
-						if (!missingKey) {
-							TraceEvent(g_network->isSimulated() ? SevError : SevWarnAlways,
-							           "SSAuditStorageShardReplicaMissingKeyUnexpected",
-							           data->thisServerID);
+							    .detail("Version", version)
+							    .detail("ClaimRange", claimRange);
+							errors.push_back(error);
+							continue; // check next remote server
 						}
-						std::string error =
-						    format("Missing key(s) form remote server (%lld), next local server(%016llx) key: %s",
-						           remoteServer.uniqueID.first(),
-						           data->thisServerID.first(),
-						           Traceable<StringRef>::toString(local.data[i].key).c_str());
-						TraceEvent(SevError, "SSAuditStorageShardReplicaError", data->thisServerID)
-						    .setMaxFieldLength(-1)
-						    .setMaxEventLength(-1)
-						    .detail("AuditId", req.id)
-						    .detail("AuditRange", req.range)
-						    .detail("ErrorMessage", error)
-						    .detail("Version", version)
-						    .detail("ClaimRange", claimRange);
-						errors.push_back(error);
-						continue; // check next remote server
 					}
+
 				}
 
 				TraceEvent(SevInfo, "SSAuditStorageStatisticValidateReplica", data->thisServerID)
@@ -5899,6 +6999,7 @@ ACTOR Future<Void> auditStorageShardReplicaQ(StorageServer* data, AuditStorageRe
 						    .detail("CheckTimes", checkTimes)
 						    .detail("NumValidatedKeys", numValidatedKeys)
 						    .detail("ValidatedBytes", validatedBytes)
+						    .detail("DigestValidatedBytes", digestValidatedBytes)
 						    .detail("RateLimiterTotalWaitTime", rateLimiterTotalWaitTime)
 						    .detail("TotalTime", now() - startTime);
 						break;
@@ -6121,6 +7222,11 @@ ACTOR Future<GetMappedKeyValuesReply> mapKeyValues(StorageServer* data,
 
 	for (; (offset < sz) && (*remainingLimitBytes > 0); offset += SERVER_KNOBS->MAX_PARALLEL_QUICK_GET_VALUE) {
 		// Divide into batches of MAX_PARALLEL_QUICK_GET_VALUE subqueries
+		state Standalone<VectorRef<KeyRef>> mappedKeys;
+		// For each subquery, the earlier one in the batch with the same mapped key, whose result it reuses, or -1
+		state std::vector<int> sameAs;
+		mappedKeys = Standalone<VectorRef<KeyRef>>();
+		sameAs.clear();
 		for (int i = 0; i + offset < sz && i < SERVER_KNOBS->MAX_PARALLEL_QUICK_GET_VALUE; i++) {
 			KeyValueRef* it = &input.data[i + offset];
 			MappedKeyValueRef* kvm = &kvms[i];
@@ -6130,14 +7236,38 @@ ACTOR Future<GetMappedKeyValuesReply> mapKeyValues(StorageServer* data,
 			Key mappedKey = constructMappedKey(it, vt, mappedKeyFormatTuple);
 			// Make sure the mappedKey is always available, so that it's good even we want to get key asynchronously.
 			result.arena.dependsOn(mappedKey.arena());
+			mappedKeys.push_back(mappedKeys.arena(), mappedKey);
 
 			// std::cout << "key:" << printable(kvm->key) << ", value:" << printable(kvm->value)
 			//          << ", mappedKey:" << printable(mappedKey) << std::endl;
 
-			subqueries.push_back(
-			    mapSubquery(data, input.version, pOriginalReq, &result.arena, isRangeQuery, it, kvm, mappedKey));
+			// Index entries next to each other often point into the same record, whose range is then read once
+			sameAs.push_back(isRangeQuery && i > 0 && mappedKeys[i - 1] == mappedKey
+			                     ? (sameAs[i - 1] >= 0 ? sameAs[i - 1] : i - 1)
+			                     : -1);
+			if (isRangeQuery && sameAs[i] < 0) {
+				subqueries.push_back(
+				    mapSubquery(data, input.version, pOriginalReq, &result.arena, isRangeQuery, it, kvm, mappedKey));
+			}
+		}
+		if (isRangeQuery) {
+			wait(waitForAll(subqueries));
+			for (int i = 0; i < sameAs.size(); i++) {
+				if (sameAs[i] >= 0) {
+					CODE_PROBE(true, "Mapped range lookups shared a record");
+					kvms[i].key = input.data[i + offset].key;
+					kvms[i].value = input.data[i + offset].value;
+					kvms[i].reqAndResult = kvms[sameAs[i]].reqAndResult;
+				}
+			}
+		} else {
+			// Point lookups go out as one batch of reads here and one per remote storage team
+			std::vector<GetValueReqAndResultRef> values =
+			    wait(quickGetValues(data, mappedKeys, input.version, &result.arena, pOriginalReq));
+			for (int i = 0; i < values.size(); i++) {
+				kvms[i].reqAndResult = values[i];
+			}
 		}
-		wait(waitForAll(subqueries));
 		if (pOriginalReq->options.present() && pOriginalReq->options.get().debugID.present())
 			g_traceBatch.addEvent("TransactionDebug",
 			                      pOriginalReq->options.get().debugID.get().first(),
@@ -6355,6 +7485,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 {
 	state Span span("SS:getMappedKeyValues"_loc, req.spanContext);
 	state int64_t resultSize = 0;
+	state double readStart = 0;
 
 	getCurrentLineage()->modify(&TransactionLineage::txID) = req.spanContext.traceID;
 
@@ -6369,7 +7500,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 	// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 	// so we need to downgrade here
 	wait(data->getQueryDelay());
-	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tags));
 
 	// Track time from requestTime through now as read queueing wait time
 	state double queueWaitEnd = g_network->timer();
@@ -6382,7 +7513,8 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 		// VERSION_VECTOR change
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, span.context));
-		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
+		readStart = g_network->timer();
+		data->counters.readVersionWaitSample.addMeasurement(readStart - queueWaitEnd);
 
 		data->checkTenantEntry(
 		    req.version, req.tenantInfo, req.options.present() ? req.options.get().lockAware : false);
@@ -6469,7 +7601,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 			GetMappedKeyValuesReply none;
 			none.version = version;
 			none.more = false;
-			none.penalty = data->getPenalty();
+			data->setReplyLoad(none);
 
 			data->checkChangeCounter(changeCounter,
 			                         KeyRangeRef(std::min<KeyRef>(req.begin.getKey(), req.end.getKey()),
@@ -6521,7 +7653,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 				//                ASSERT(r.data.size() <= std::abs(req.limit));
 			}
 
-			r.penalty = data->getPenalty();
+			data->setReplyLoad(r);
 			req.reply.send(r);
 
 			resultSize = req.limitBytes - remainingLimitBytes;
@@ -6537,7 +7669,7 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 		data->sendErrorWithPenalty(req.reply, e, data->getPenalty());
 	}
 
-	data->transactionTagCounter.addRequest(req.tags, resultSize);
+	data->transactionTagCounter.addRequest(req.tags, resultSize, readServiceTime(readStart));
 	++data->counters.finishedQueries;
 	++data->counters.finishedGetMappedRangeQueries;
 
@@ -6555,6 +7687,10 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 		                                                        abs(req.begin.offset) > maxSelectorOffset ||
 		                                                        abs(req.end.offset) > maxSelectorOffset));
 	}
+	if (req.tenantInfo.hasTenant()) {
+		data->counters.tenantReadLatencies.addMeasurement(
+		    req.tenantInfo.tenantId, TenantLatencyMap::RequestType::RangeRead, duration, resultSize);
+	}
 
 	return Void();
 }
@@ -6666,7 +7802,7 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 		} else {
 			loop {
 				wait(req.reply.onReady());
-				state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+				state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tags));
 
 				if (version < data->oldestVersion.get()) {
 					throw transaction_too_old();
@@ -6774,6 +7910,7 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 	state Span span("SS:getKey"_loc, req.spanContext);
 	state int64_t resultSize = 0;
+	state double readStart = 0;
 
 	getCurrentLineage()->modify(&TransactionLineage::txID) = req.spanContext.traceID;
 
@@ -6785,7 +7922,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 	// Active load balancing runs at a very high priority (to obtain accurate queue lengths)
 	// so we need to downgrade here
 	wait(data->getQueryDelay());
-	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options));
+	state PriorityMultiLock::Lock readLock = wait(data->getReadLock(req.options, req.tags));
 
 	// Track time from requestTime through now as read queueing wait time
 	state double queueWaitEnd = g_network->timer();
@@ -6794,7 +7931,8 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 	try {
 		Version commitVersion = getLatestCommitVersion(req.ssLatestCommitVersions, data->tag);
 		state Version version = wait(waitForVersion(data, commitVersion, req.version, req.spanContext));
-		data->counters.readVersionWaitSample.addMeasurement(g_network->timer() - queueWaitEnd);
+		readStart = g_network->timer();
+		data->counters.readVersionWaitSample.addMeasurement(readStart - queueWaitEnd);
 
 		data->checkTenantEntry(version, req.tenantInfo, req.options.map(&ReadOptions::lockAware).orDefault(false));
 		if (req.tenantInfo.hasTenant()) {
@@ -6831,6 +7969,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 		resultSize = k.size();
 		data->counters.bytesQueried += resultSize;
 		++data->counters.rowsQueried;
+		data->hotKeys.addRead(k);
 
 		// Check if the desired key might be cached
 		auto cached = data->cachedRangeMap[absoluteKey];
@@ -6839,7 +7978,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 		// shard.begin).detail("End", shard.end);
 
 		GetKeyReply reply(updated, cached);
-		reply.penalty = data->getPenalty();
+		data->setReplyLoad(reply);
 
 		req.reply.send(reply);
 	} catch (Error& e) {
@@ -6852,7 +7991,7 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 	// SOMEDAY: The size reported here is an undercount of the bytes read due to the fact that we have to scan for the
 	// key It would be more accurate to count all the read bytes, but it's not critical because this function is only
 	// used if read-your-writes is disabled
-	data->transactionTagCounter.addRequest(req.tags, resultSize);
+	data->transactionTagCounter.addRequest(req.tags, resultSize, readServiceTime(readStart));
 
 	++data->counters.finishedQueries;
 
@@ -6868,6 +8007,10 @@ ACTOR Future<Void> getKeyQ(StorageServer* data, GetKeyRequest req) {
 		data->counters.readLatencyBands.addMeasurement(
 		    duration, 1, Filtered(resultSize > maxReadBytes || abs(req.sel.offset) > maxSelectorOffset));
 	}
+	if (req.tenantInfo.hasTenant()) {
+		data->counters.tenantReadLatencies.addMeasurement(
+		    req.tenantInfo.tenantId, TenantLatencyMap::RequestType::PointRead, duration);
+	}
 
 	return Void();
 }
@@ -6919,19 +8062,41 @@ ACTOR Future<Void> doEagerReads(StorageServer* data, UpdateEagerReadInfo* eager)
 		eager->keyEnd = keyEndVal;
 	}
 
-	std::vector<Future<Optional<Value>>> value(eager->keys.size());
-	for (int i = 0; i < value.size(); i++)
-		value[i] = data->storage.readValuePrefix(eager->keys[i].first, eager->keys[i].second, options);
+	// Atomic ops on a key whose latest value, or a clear of it, is still in versionedData are converted from that, so
+	// hot keys need no read. update() holds durableVersionLock until the batch is applied, so changeDurableVersion()
+	// can't forget these entries meanwhile. Only removeDataRange() can, and it clears the keys on disk as well.
+	// The keys are sorted, so the storage engine can serve the rest as one batch.
+	Standalone<VectorRef<KeyRef>> keys;
+	std::vector<int> maxLengths;
+	state std::vector<int> readIndexes;
+	keys.reserve(keys.arena(), eager->keys.size());
+	maxLengths.reserve(eager->keys.size());
+	auto const& latest = data->data().atLatest();
+	for (int i = 0; i < eager->keys.size(); i++) {
+		KeyRef key = eager->keys[i].first;
+		auto it = latest.lastLessOrEqual(key);
+		if (it != latest.end() && ((it->isValue() && it.key() == key) || (it->isClearTo() && it->getEndKey() > key))) {
+			continue;
+		}
+		keys.push_back(keys.arena(), key);
+		maxLengths.push_back(eager->keys[i].second);
+		readIndexes.push_back(i);
+	}
+	CODE_PROBE(readIndexes.size() < eager->keys.size(), "Eager reads skipped keys in versionedData");
+	data->counters.eagerReadsInMemory += eager->keys.size() - readIndexes.size();
 
-	state Future<std::vector<Optional<Value>>> futureValues = getAll(value);
+	state Future<std::vector<Optional<Value>>> futureValues =
+	    keys.empty() ? Future<std::vector<Optional<Value>>>(std::vector<Optional<Value>>())
+	                 : data->storage.readValues(keys, std::move(maxLengths), options);
 	std::vector<Optional<Value>> optionalValues = wait(futureValues);
-	for (const auto& value : optionalValues) {
-		if (value.present()) {
-			data->counters.kvGetBytes += value.expectedSize();
+	eager->value = std::vector<Optional<Value>>(eager->keys.size());
+	for (int i = 0; i < optionalValues.size(); i++) {
+		if (optionalValues[i].present()) {
+			data->counters.kvGetBytes += optionalValues[i].expectedSize();
 		}
+		eager->value[readIndexes[i]] = std::move(optionalValues[i]);
 	}
-	data->counters.eagerReadsKeys += eager->keys.size();
-	eager->value = optionalValues;
+	data->counters.eagerReadsKeys += readIndexes.size();
 
 	return Void();
 }
@@ -7562,6 +8727,122 @@ ACTOR Future<Void> tryGetRange(PromiseStream<RangeResult> results, Transaction*
 	}
 }
 
+// A piece of the range tryGetRangeParallel fetches
+struct FetchRangePiece : ReferenceCounted<FetchRangePiece> {
+	KeyRange keys;
+	// Each block, and whether it holds FETCH_BLOCK_BYTES of the read ahead budget. The last one has no more.
+	PromiseStream<std::pair<RangeResult, bool>> blocks;
+	// Sent once the piece's blocks are being delivered, after which its reads no longer wait for the budget
+	Promise<Void> delivering;
+
+	explicit FetchRangePiece(KeyRange keys) : keys(keys) {}
+};
+
+ACTOR Future<Void> fetchRangePiece(Reference<FetchRangePiece> piece, Transaction* tr, FlowLock* readAhead) {
+	state KeySelectorRef begin = firstGreaterOrEqual(piece->keys.begin);
+	state KeySelectorRef end = firstGreaterOrEqual(piece->keys.end);
+
+	try {
+		loop {
+			state bool reserved = false;
+			if (!piece->delivering.isSet()) {
+				choose {
+					when(wait(readAhead->take(TaskPriority::DefaultYield, SERVER_KNOBS->FETCH_BLOCK_BYTES))) {
+						reserved = true;
+					}
+					when(wait(piece->delivering.getFuture())) {}
+				}
+			}
+			GetRangeLimits limits(GetRangeLimits::ROW_LIMIT_UNLIMITED, SERVER_KNOBS->FETCH_BLOCK_BYTES);
+			limits.minRows = 0;
+			state RangeResult rep = wait(tr->getRange(begin, end, limits, Snapshot::True));
+			piece->blocks.send(std::make_pair(rep, reserved));
+
+			if (!rep.more) {
+				return Void();
+			}
+			begin = rep.nextBeginKeySelector();
+		}
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		piece->blocks.sendError(e);
+		return Void();
+	}
+}
+
+// Fetches keys into results like tryGetRange, but reads up to FETCH_KEYS_SUBRANGE_PARALLELISM pieces of them, split
+// about every FETCH_KEYS_SUBRANGE_BYTES, at once, so that moving one large shard isn't limited to one read at a time.
+// Blocks are still sent in key order. The pieces read ahead of the one being sent hold at most
+// FETCH_KEYS_READ_AHEAD_BYTES of blocks between them.
+ACTOR Future<Void> tryGetRangeParallel(PromiseStream<RangeResult> results, Transaction* tr, KeyRange keys) {
+	// Declared first, so that it outlives the fetchers holding it
+	state FlowLock readAhead(SERVER_KNOBS->FETCH_KEYS_READ_AHEAD_BYTES);
+	state std::vector<Reference<FetchRangePiece>> pieces;
+	state std::vector<Future<Void>> fetchers;
+	state Standalone<VectorRef<KeyRef>> splitPoints;
+	state int started = 0;
+	state int i = 0;
+
+	if (!SERVER_KNOBS->FETCH_USING_STREAMING && SERVER_KNOBS->FETCH_KEYS_SUBRANGE_PARALLELISM > 1) {
+		try {
+			wait(store(splitPoints, tr->getRangeSplitPoints(keys, SERVER_KNOBS->FETCH_KEYS_SUBRANGE_BYTES)));
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			// Split points only decide how the range is read, so read it in one piece
+			TraceEvent(SevWarn, "FetchKeysSplitPointsError").error(e).detail("Keys", keys);
+		}
+	}
+	for (int p = 0; p + 1 < splitPoints.size(); p++) {
+		if (splitPoints[p] < splitPoints[p + 1]) {
+			pieces.push_back(makeReference<FetchRangePiece>(KeyRangeRef(splitPoints[p], splitPoints[p + 1])));
+		}
+	}
+	if (pieces.size() <= 1) {
+		wait(tryGetRange(results, tr, keys));
+		return Void();
+	}
+	CODE_PROBE(true, "Fetching keys in parallel pieces");
+
+	try {
+		for (; i < pieces.size(); i++) {
+			for (; started < pieces.size() && started < i + SERVER_KNOBS->FETCH_KEYS_SUBRANGE_PARALLELISM; started++) {
+				fetchers.push_back(fetchRangePiece(pieces[started], tr, &readAhead));
+			}
+			pieces[i]->delivering.send(Void());
+
+			loop {
+				state std::pair<RangeResult, bool> block = waitNext(pieces[i]->blocks.getFuture());
+				if (block.second) {
+					readAhead.release(SERVER_KNOBS->FETCH_BLOCK_BYTES);
+				}
+				bool last = !block.first.more;
+				if (last && i + 1 < pieces.size()) {
+					// The caller goes on from the end of this piece, where the next one begins
+					block.first.more = true;
+					block.first.arena().dependsOn(pieces[i]->keys.arena());
+					block.first.setReadThrough(pieces[i]->keys.end);
+				}
+				results.send(block.first);
+				if (last) {
+					break;
+				}
+			}
+		}
+		results.sendError(end_of_stream());
+		return Void();
+	} catch (Error& e) {
+		if (e.code() == error_code_actor_cancelled) {
+			throw;
+		}
+		results.sendError(e);
+		throw;
+	}
+}
+
 // Read blob granules metadata. It keeps retrying until reaching maxRetryCount.
 // The key range should not cross tenant boundary.
 ACTOR Future<Standalone<VectorRef<BlobGranuleChunkRef>>> tryReadBlobGranuleChunks(Transaction* tr,
@@ -7724,7 +9005,7 @@ std::tuple<KeyRange, Version, Version, Version> decodeChangeFeedSSValue(ValueRef
 ACTOR Future<Void> changeFeedPopQ(StorageServer* self, ChangeFeedPopRequest req) {
 	// if a SS restarted and is way behind, wait for it to at least have caught up through the pop version
 	wait(self->version.whenAtLeast(req.version));
-	wait(delay(0));
+	wait(self->changeFeedRecovery && delay(0));
 
 	if (!self->isReadable(req.range)) {
 		req.reply.sendError(wrong_shard_server());
@@ -7892,6 +9173,7 @@ ACTOR Future<Version> fetchChangeFeedApplier(StorageServer* data,
 					                                       remoteResult[remoteLoc].knownCommittedVersion)));
 					++data->counters.kvSystemClearRanges;
 					changeFeedInfo->fetchVersion = std::max(changeFeedInfo->fetchVersion, remoteVersion);
+					data->invalidateChangeFeedDiskReads(changeFeedInfo.getPtr());
 
 					if (firstVersion == invalidVersion) {
 						firstVersion = remoteVersion;
@@ -8227,6 +9509,7 @@ ACTOR Future<std::vector<Key>> fetchChangeFeedMetadata(StorageServer* data,
 					// reset fetch versions because everything previously fetched was cleaned up
 					changeFeedInfo->fetchVersion = invalidVersion;
 					changeFeedInfo->durableFetchVersion = NotifiedVersion();
+					data->invalidateChangeFeedDiskReads(changeFeedInfo.getPtr());
 					addMutationToLog = true;
 				}
 			}
@@ -8445,12 +9728,58 @@ bool fetchKeyCanRetry(const Error& e) {
 	case error_code_commit_proxy_memory_limit_exceeded:
 	case error_code_storage_replica_comparison_error:
 	case error_code_unreachable_storage_replica:
+	case error_code_bulkload_task_failed:
 		return true;
 	default:
 		return false;
 	}
 }
 
+// Returns the bulk load task of the data move which assigned keys to this server, if it is a bulk load. Physical moves
+// ingest the task's files in fetchShard(). Logical ones, and physical ones that fell back to logical, come here.
+ACTOR Future<Optional<BulkLoadState>> getBulkLoadStateForFetchKeys(StorageServer* data, KeyRange keys) {
+	state Transaction tr(data->cx);
+	state UID dataMoveId;
+	loop {
+		tr.setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+		tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+		tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+		try {
+			// The last server keys boundary at or before keys.begin holds the id of the data move
+			RangeResult assignment = wait(tr.getRange(
+			    KeyRangeRef(data->sk, keyAfter(data->sk.withSuffix(keys.begin))), 1, Snapshot::False, Reverse::True));
+			if (assignment.empty()) {
+				return Optional<BulkLoadState>();
+			}
+			bool assigned = false;
+			bool emptyRange = false;
+			DataMoveType dataMoveType = DataMoveType::LOGICAL;
+			DataMovementReason dataMoveReason = DataMovementReason::INVALID;
+			decodeServerKeysValue(assignment[0].value, assigned, emptyRange, dataMoveType, dataMoveId, dataMoveReason);
+			if (!assigned ||
+			    (dataMoveType != DataMoveType::LOGICAL_BULKLOAD && dataMoveType != DataMoveType::PHYSICAL_BULKLOAD)) {
+				return Optional<BulkLoadState>();
+			}
+			break;
+		} catch (Error& e) {
+			wait(tr.onError(e));
+		}
+	}
+
+	// The data move id may have been generated by an old binary, which did not encode the type, so only the data move
+	// metadata can tell whether this really is a bulk load
+	state Optional<BulkLoadState> bulkLoadState =
+	    wait(getBulkLoadStateFromDataMove(data->cx, dataMoveId, data->thisServerID));
+	if (bulkLoadState.present() && !bulkLoadState.get().getRange().contains(keys)) {
+		TraceEvent(SevWarnAlways, "SSBulkLoadTaskRangeMismatch", data->thisServerID)
+		    .detail("DataMoveID", dataMoveId)
+		    .detail("Range", keys)
+		    .detail("BulkLoadTask", bulkLoadState.get().toString());
+		return Optional<BulkLoadState>();
+	}
+	return bulkLoadState;
+}
+
 ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 	state const UID fetchKeysID = deterministicRandom()->randomUniqueID();
 	state TraceInterval interval("FetchKeys");
@@ -8483,7 +9812,7 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 	// delay(0) to force a return to the run loop before the work of fetchKeys is started.
 	//  This allows adding->start() to be called inline with CSK.
 	try {
-		wait(data->coreStarted.getFuture() && delay(0));
+		wait(data->coreStarted.getFuture() && data->changeFeedRecovery && delay(0));
 
 		// On SS Reboot, durableVersion == latestVersion, so any mutations we add to the mutation log would be
 		// skipped if added before latest version advances. To ensure this doesn't happen, we wait for version to
@@ -8552,6 +9881,21 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 			std::vector<Key> _cfToFetch = wait(fetchCFMetadata);
 			changeFeedsToFetch = _cfToFetch;
 		}
+
+		state Optional<BulkLoadState> bulkLoadState;
+		if (SERVER_KNOBS->SHARD_ENCODE_LOCATION_METADATA && !isFullRestore) {
+			wait(store(bulkLoadState, getBulkLoadStateForFetchKeys(data, keys)));
+		}
+		if (bulkLoadState.present()) {
+			if (bulkLoadState.get().getTransportMethod() != BulkLoadTransportMethod::CP) {
+				throw not_implemented();
+			}
+			++data->counters.bulkLoadFetches;
+			TraceEvent(SevInfo, "SSBulkLoadTaskFetchKeys", data->thisServerID)
+			    .detail("FKID", fetchKeysID)
+			    .detail("Range", keys)
+			    .detail("BulkLoadTask", bulkLoadState.get().toString());
+		}
 		wait(data->durableVersionLock.take());
 
 		shard->phase = AddingShard::Fetching;
@@ -8649,8 +9993,16 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 					hold = tryGetRange(results, &tr, keys);
 					rangeEnd = keys.end;
 				}
+			} else if (bulkLoadState.present()) {
+				// The task's files hold the data of the whole range, so they are read in place of the source servers
+				hold = bulkLoadReadSSTFiles(results,
+				                            bulkLoadState.get().getDataFiles(),
+				                            keys,
+				                            SERVER_KNOBS->FETCH_BLOCK_BYTES,
+				                            data->thisServerID);
+				rangeEnd = keys.end;
 			} else {
-				hold = tryGetRange(results, &tr, keys);
+				hold = tryGetRangeParallel(results, &tr, keys);
 				rangeEnd = keys.end;
 			}
 
@@ -8692,6 +10044,9 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 						}
 					}
 					metricReporter.addFetchedBytes(expectedBlockSize, this_block.size());
+					if (bulkLoadState.present()) {
+						data->counters.bulkLoadBytes += expectedBlockSize;
+					}
 					totalBytes += expectedBlockSize;
 
 					if (shard->reason != DataMovementReason::INVALID &&
@@ -8708,8 +10063,8 @@ ACTOR Future<Void> fetchKeys(StorageServer* data, AddingShard* shard) {
 
 					// Write this_block to storage
 					state Standalone<VectorRef<KeyValueRef>> blockData(this_block, this_block.arena());
-					state Key blockEnd =
-					    this_block.size() > 0 && this_block.more ? keyAfter(this_block.back().key) : keys.end;
+					// Up to where the next block begins, which may be past this block's last key
+					state Key blockEnd = this_block.more ? this_block.getReadThrough() : keys.end;
 					state KeyRange blockRange(KeyRangeRef(blockBegin, blockEnd));
 					wait(data->storage.replaceRange(blockRange, blockData));
 
@@ -9972,6 +11327,7 @@ void ShardInfo::addMutation(Version version,
 	} else if (moveInShard) {
 		moveInShard->addMutation(version, fromFetch, mutation, encryptedMutation);
 	} else if (readWrite) {
+		lastWriteTime = now();
 		readWrite->addMutation(
 		    version, fromFetch, mutation, encryptedMutation, this->keys, readWrite->updateEagerReads);
 	} else if (mutation.type != MutationRef::ClearRange) {
@@ -10170,6 +11526,7 @@ void cleanUpChangeFeeds(StorageServer* data, const KeyRangeRef& keys, Version ve
 			if (feed != data->uidChangeFeed.end()) {
 				feed->second->updateMetadataVersion(version);
 				feed->second->removing = true;
+				data->invalidateChangeFeedDiskReads(feed->second.getPtr());
 				feed->second->moved(feed->second->range);
 				feed->second->newMutations.trigger();
 			}
@@ -10285,6 +11642,7 @@ void changeServerKeys(StorageServer* data,
 			}
 			data->addShard(ShardInfo::newNotAssigned(range));
 			data->watches.triggerRange(range.begin, range.end);
+			data->triggerRangeWatches(range, version);
 		} else if (!dataAvailable) {
 			// SOMEDAY: Avoid restarting adding/transferred shards
 			// bypass fetchkeys; shard is known empty at initial cluster version
@@ -10538,6 +11896,7 @@ void changeServerKeysWithPhysicalShards(StorageServer* data,
 			updatedShards.push_back(StorageServerShard::notAssigned(range, cVer));
 			data->pendingRemoveRanges[cVer].push_back(range);
 			data->watches.triggerRange(range.begin, range.end);
+			data->triggerRangeWatches(range, version);
 			TraceEvent(sevDm, "SSUnassignShard", data->thisServerID)
 			    .detail("Range", range)
 			    .detail("NowAssigned", nowAssigned)
@@ -10740,6 +12099,14 @@ void StorageServer::addMutation(Version version,
 
 		applyChangeFeedMutation(
 		    this, expanded.type == MutationRef::ClearRange ? nonExpanded : expanded, encrypt, version, shard);
+
+		if (expanded.type == MutationRef::ClearRange) {
+			triggerRangeWatches(KeyRangeRef(nonExpanded.param1, nonExpanded.param2), version);
+			hotKeys.addWrite(KeyRangeRef(nonExpanded.param1, nonExpanded.param2));
+		} else {
+			triggerRangeWatches(expanded.param1, version);
+			hotKeys.addWrite(expanded.param1);
+		}
 	}
 	applyMutation(this, expanded, mLog.arena(), mutableData(), version);
 
@@ -10879,11 +12246,9 @@ private:
 			// which does not encode the data move type information. In this case, the value of conductBulkLoad is not
 			// reliable. So, we rely on data move metadata to decide if the data move is a bulk load task, rather than
 			// relying on the data move ID.
-			// TODO(BulkLoad): remove after logical move based bulk loading has been implmented
 			if (!enablePSM && conductBulkLoad) {
-				// Currently, since the bulk load has not been implemented for logical data move, it is easy to decide
-				// that this case is caused by a illegal data move id generated by an old binary. In this case, we
-				// revert it back to a normal data move.
+				// Logical data moves find their bulk load task in fetchKeys(), from the data move metadata, so the
+				// physical shard move path must not look for one.
 				conductBulkLoad = false;
 			}
 			processedStartKey = true;
@@ -11035,6 +12400,7 @@ private:
 				// reset fetch versions because everything previously fetched was cleaned up
 				feed->second->fetchVersion = invalidVersion;
 				feed->second->durableFetchVersion = NotifiedVersion();
+				data->invalidateChangeFeedDiskReads(feed->second.getPtr());
 			}
 			if (feed != data->uidChangeFeed.end()) {
 				feed->second->updateMetadataVersion(currentVersion);
@@ -11357,15 +12723,88 @@ ACTOR Future<Void> tssDelayForever() {
 	}
 }
 
+// Clear range eager reads expand each clear up to the next key in storage, so that it can merge with neighbouring clears
+// in the MVCC layer. Engines which clear a range in time independent of its size don't need them, and each one is a
+// storage read the whole update waits for.
+static bool clearRangeEagerReadsEnabled(KeyValueStoreType storeType) {
+	switch (storeType) {
+	case KeyValueStoreType::SSD_ROCKSDB_V1:
+	case KeyValueStoreType::SSD_SHARDED_ROCKSDB:
+		return SERVER_KNOBS->ROCKSDB_ENABLE_CLEAR_RANGE_EAGER_READS;
+	case KeyValueStoreType::SSD_REDWOOD_V1:
+		return SERVER_KNOBS->REDWOOD_ENABLE_CLEAR_RANGE_EAGER_READS;
+	default:
+		return SERVER_KNOBS->ENABLE_CLEAR_RANGE_EAGER_READS;
+	}
+}
+
+// Returns the oldest version the pins still need kept readable, or MAX_VERSION if there is none. Pins that have expired
+// or that are older than oldestVersion, and so can no longer be read at, are erased. If overBudget, the oldest of the
+// remaining pins is given up as well and returned in released.
+Version pinnedReadVersionFloor(std::map<UID, std::pair<Version, Version>>& pins,
+                               Version version,
+                               Version oldestVersion,
+                               bool overBudget,
+                               Optional<std::pair<UID, Version>>& released) {
+	auto oldestPin = [&pins]() {
+		return std::min_element(
+		    pins.begin(), pins.end(), [](auto const& a, auto const& b) { return a.second.first < b.second.first; });
+	};
+
+	for (auto it = pins.begin(); it != pins.end();) {
+		if (it->second.second <= version || it->second.first < oldestVersion) {
+			it = pins.erase(it);
+		} else {
+			++it;
+		}
+	}
+	if (pins.empty()) {
+		return MAX_VERSION;
+	}
+
+	auto oldest = oldestPin();
+	if (overBudget) {
+		released = std::make_pair(oldest->first, oldest->second.first);
+		pins.erase(oldest);
+		if (pins.empty()) {
+			return MAX_VERSION;
+		}
+		oldest = oldestPin();
+	}
+	return oldest->second.first;
+}
+
+TEST_CASE("/fdbserver/storageserver/pinnedReadVersionFloor") {
+	UID expired(1, 0), passed(2, 0), oldest(3, 0), newest(4, 0);
+	std::map<UID, std::pair<Version, Version>> pins;
+	pins[expired] = std::make_pair(100, 500);
+	pins[passed] = std::make_pair(150, 2000);
+	pins[oldest] = std::make_pair(300, 2000);
+	pins[newest] = std::make_pair(400, 2000);
+
+	Optional<std::pair<UID, Version>> released;
+	ASSERT_EQ(pinnedReadVersionFloor(pins, 1000, 200, false, released), 300);
+	ASSERT(!released.present());
+	ASSERT_EQ(pins.size(), 2);
+
+	// Over budget, the oldest pin goes first
+	ASSERT_EQ(pinnedReadVersionFloor(pins, 1000, 300, true, released), 400);
+	ASSERT(released.present() && released.get().first == oldest && released.get().second == 300);
+	ASSERT_EQ(pins.size(), 1);
+
+	released.reset();
+	ASSERT_EQ(pinnedReadVersionFloor(pins, 1000, 400, true, released), MAX_VERSION);
+	ASSERT(released.present() && released.get().first == newest);
+	ASSERT(pins.empty());
+
+	return Void();
+}
+
 ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 	state double updateStart = g_network->timer();
 	state double decryptionTime = 0;
 	state double start;
-	state bool enableClearRangeEagerReads =
-	    (data->storage.getKeyValueStoreType() == KeyValueStoreType::SSD_ROCKSDB_V1 ||
-	     data->storage.getKeyValueStoreType() == KeyValueStoreType::SSD_SHARDED_ROCKSDB)
-	        ? SERVER_KNOBS->ROCKSDB_ENABLE_CLEAR_RANGE_EAGER_READS
-	        : SERVER_KNOBS->ENABLE_CLEAR_RANGE_EAGER_READS;
+	state bool enableClearRangeEagerReads = clearRangeEagerReadsEnabled(data->storage.getKeyValueStoreType());
 	state UpdateEagerReadInfo eager(enableClearRangeEagerReads);
 	try {
 
@@ -11382,6 +12821,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			hardLimit = SERVER_KNOBS->STORAGE_HARD_LIMIT_BYTES_SPEED_UP_SIM;
 			hardLimitOverage = SERVER_KNOBS->STORAGE_HARD_LIMIT_BYTES_OVERAGE_SPEED_UP_SIM;
 		}
+		hardLimit = std::min(hardLimit, data->memoryGovernorQueueLimit);
 		state double waitStartT = 0;
 		if (data->queueSize() >= hardLimit && data->durableVersion.get() < data->desiredOldestVersion.get() &&
 		    ((data->desiredOldestVersion.get() - SERVER_KNOBS->STORAGE_HARD_LIMIT_VERSION_OVERAGE >
@@ -11448,6 +12888,12 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			throw worker_removed();
 		}
 
+		// Mutations can't be applied to change feeds that are still being restored
+		if (!data->changeFeedRecovery.isReady()) {
+			CODE_PROBE(true, "Storage server update waiting for change feed restore");
+			wait(data->changeFeedRecovery);
+		}
+
 		++data->counters.updateBatches;
 		data->lastTLogVersion = cursor->getMaxKnownVersion();
 		if (cursor->getMinKnownCommittedVersion() > data->knownCommittedVersion.get()) {
@@ -11473,6 +12919,9 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 		state Reference<ILogSystem::IPeekCursor> cloneCursor2 = cursor->cloneNoMore();
 		state Optional<std::unordered_map<BlobCipherDetails, Reference<BlobCipherKey>>> cipherKeys;
 		state bool collectingCipherKeys = false;
+		// The mutations of cloneCursor2 as deserialized by the eager read pass, in message order, so that they are
+		// parsed once per update rather than once per pass. They point into the cursor's arena.
+		state std::vector<MutationRef> decodedMutations;
 
 		// Collect eager read keys.
 		// If encrypted mutation is encountered, we collect cipher details and fetch cipher keys, then start over.
@@ -11488,6 +12937,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			Reference<ILogSystem::IPeekCursor> cloneCursor1 = cloneCursor2->cloneNoMore();
 
 			cloneCursor1->setProtocolVersion(data->logProtocol);
+			decodedMutations.clear();
 
 			for (; cloneCursor1->hasMessage(); cloneCursor1->nextMessage()) {
 				ArenaReader& cloneReader = *cloneCursor1->reader();
@@ -11509,6 +12959,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 				} else {
 					MutationRef msg;
 					cloneReader >> msg;
+					decodedMutations.push_back(msg);
 					ASSERT(data->encryptionMode.present());
 					ASSERT(!data->encryptionMode.get().isEncryptionEnabled() || msg.isEncrypted() ||
 					       isBackupLogMutation(msg) || isAccumulativeChecksumMutation(msg));
@@ -11632,6 +13083,7 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 		state SpanContext spanContext = SpanContext();
 		state double beforeTLogMsgsUpdates = now();
 		state std::set<Key> updatedChangeFeeds;
+		state int decodedIndex = 0;
 		for (; cloneCursor2->hasMessage(); cloneCursor2->nextMessage()) {
 			if (mutationBytes > SERVER_KNOBS->DESIRED_UPDATE_BYTES) {
 				mutationBytes = 0;
@@ -11679,9 +13131,10 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 				rd >> scm;
 				spanContext = scm.spanContext;
 			} else {
-				MutationRef msg;
+				ASSERT(decodedIndex < decodedMutations.size());
+				MutationRef msg = decodedMutations[decodedIndex++];
 				MutationRefAndCipherKeys encryptedMutation;
-				rd >> msg;
+				cloneCursor2->getMessage(); // Consumes the message, which the eager read pass already deserialized
 				ASSERT(data->encryptionMode.present());
 				ASSERT(!data->encryptionMode.get().isEncryptionEnabled() || msg.isEncrypted() ||
 				       isBackupLogMutation(msg) || isAccumulativeChecksumMutation(msg));
@@ -11864,6 +13317,28 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 			if (data->primaryLocality == tagLocalitySpecial || data->tag.locality == data->primaryLocality) {
 				proposedOldestVersion = std::max(proposedOldestVersion, data->lastTLogVersion - maxVersionsInMemory);
 			}
+
+			// Hold the window open for pinned read versions, within the budget for what that keeps in memory
+			Optional<std::pair<UID, Version>> releasedPin;
+			Version pinnedFloor = pinnedReadVersionFloor(
+			    data->pinnedReadVersions,
+			    data->version.get(),
+			    data->desiredOldestVersion.get(),
+			    data->queueSize() >=
+			        std::min(SERVER_KNOBS->STORAGE_PINNED_READ_VERSION_MAX_BYTES, data->memoryGovernorQueueLimit),
+			    releasedPin);
+			if (releasedPin.present()) {
+				CODE_PROBE(true, "Storage server released a pinned read version to stay within budget");
+				++data->counters.pinnedReadVersionsReleased;
+				TraceEvent(SevWarn, "PinnedReadVersionReleased", data->thisServerID)
+				    .suppressFor(1.0)
+				    .detail("PinID", releasedPin.get().first)
+				    .detail("PinnedVersion", releasedPin.get().second)
+				    .detail("Version", data->version.get())
+				    .detail("QueueSize", data->queueSize());
+			}
+			proposedOldestVersion = std::min(proposedOldestVersion, pinnedFloor);
+
 			proposedOldestVersion = std::min(proposedOldestVersion, data->version.get() - 1);
 			proposedOldestVersion = std::max(proposedOldestVersion, data->oldestVersion.get());
 			proposedOldestVersion = std::max(proposedOldestVersion, data->desiredOldestVersion.get());
@@ -12270,7 +13745,8 @@ ACTOR Future<Void> updateStorage(StorageServer* data) {
 			// "before", since oldestVersion.set() may trigger waiting actors) forgetVersionsBeforeAsync visibly
 			// forgets immediately (without waiting) but asynchronously frees memory.
 			Future<Void> finishedForgetting =
-			    data->mutableData().forgetVersionsBeforeAsync(newOldestVersion, TaskPriority::UpdateStorage) &&
+			    data->mutableData().forgetVersionsBeforeAsync(
+			        newOldestVersion, TaskPriority::UpdateStorage, data->versionReclaimThread) &&
 			    data->tenantMap.forgetVersionsBeforeAsync(newOldestVersion, TaskPriority::UpdateStorage);
 			data->oldestVersion.set(newOldestVersion);
 			wait(finishedForgetting);
@@ -12981,6 +14457,45 @@ ACTOR Future<Void> restoreByteSample(StorageServer* data,
 	return Void();
 }
 
+// Loads the metadata of every change feed on this storage server. Nothing else in restoreDurableState depends on it, so
+// with STORAGE_LAZY_CHANGE_FEED_RESTORE it runs in the background as changeFeedRecovery.
+ACTOR Future<Void> restoreChangeFeeds(StorageServer* data, RangeResult changeFeeds, Version version) {
+	state double start = now();
+	state int feedLoc;
+	for (feedLoc = 0; feedLoc < changeFeeds.size(); feedLoc++) {
+		Key changeFeedId = changeFeeds[feedLoc].key.removePrefix(persistChangeFeedKeys.begin);
+		KeyRange changeFeedRange;
+		Version popVersion, stopVersion, metadataVersion;
+		std::tie(changeFeedRange, popVersion, stopVersion, metadataVersion) =
+		    decodeChangeFeedSSValue(changeFeeds[feedLoc].value);
+		TraceEvent(SevDebug, "RestoringChangeFeed", data->thisServerID)
+		    .detail("FeedID", changeFeedId)
+		    .detail("Range", changeFeedRange)
+		    .detail("StopVersion", stopVersion)
+		    .detail("PopVer", popVersion)
+		    .detail("MetadataVersion", metadataVersion);
+		Reference<ChangeFeedInfo> changeFeedInfo(new ChangeFeedInfo());
+		changeFeedInfo->range = changeFeedRange;
+		changeFeedInfo->id = changeFeedId;
+		changeFeedInfo->durableVersion = version;
+		changeFeedInfo->storageVersion = version;
+		changeFeedInfo->emptyVersion = popVersion - 1;
+		changeFeedInfo->stopVersion = stopVersion;
+		changeFeedInfo->metadataVersion = metadataVersion;
+		data->uidChangeFeed[changeFeedId] = changeFeedInfo;
+		auto rs = data->keyChangeFeed.modify(changeFeedRange);
+		for (auto r = rs.begin(); r != rs.end(); ++r) {
+			r->value().push_back(changeFeedInfo);
+		}
+		wait(yield());
+	}
+	data->keyChangeFeed.coalesce(allKeys);
+	TraceEvent("RestoredChangeFeeds", data->thisServerID)
+	    .detail("Feeds", changeFeeds.size())
+	    .detail("Duration", now() - start);
+	return Void();
+}
+
 ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* storage) {
 	state Future<Optional<Value>> fFormat = storage->readValue(persistFormat.key);
 	state Future<Optional<Value>> fID = storage->readValue(persistID);
@@ -13154,35 +14669,11 @@ ACTOR Future<bool> restoreDurableState(StorageServer* data, IKeyValueStore* stor
 
 	state RangeResult changeFeeds = fChangeFeeds.get();
 	data->bytesRestored += changeFeeds.logicalSize();
-	state int feedLoc;
-	for (feedLoc = 0; feedLoc < changeFeeds.size(); feedLoc++) {
-		Key changeFeedId = changeFeeds[feedLoc].key.removePrefix(persistChangeFeedKeys.begin);
-		KeyRange changeFeedRange;
-		Version popVersion, stopVersion, metadataVersion;
-		std::tie(changeFeedRange, popVersion, stopVersion, metadataVersion) =
-		    decodeChangeFeedSSValue(changeFeeds[feedLoc].value);
-		TraceEvent(SevDebug, "RestoringChangeFeed", data->thisServerID)
-		    .detail("FeedID", changeFeedId)
-		    .detail("Range", changeFeedRange)
-		    .detail("StopVersion", stopVersion)
-		    .detail("PopVer", popVersion)
-		    .detail("MetadataVersion", metadataVersion);
-		Reference<ChangeFeedInfo> changeFeedInfo(new ChangeFeedInfo());
-		changeFeedInfo->range = changeFeedRange;
-		changeFeedInfo->id = changeFeedId;
-		changeFeedInfo->durableVersion = version;
-		changeFeedInfo->storageVersion = version;
-		changeFeedInfo->emptyVersion = popVersion - 1;
-		changeFeedInfo->stopVersion = stopVersion;
-		changeFeedInfo->metadataVersion = metadataVersion;
-		data->uidChangeFeed[changeFeedId] = changeFeedInfo;
-		auto rs = data->keyChangeFeed.modify(changeFeedRange);
-		for (auto r = rs.begin(); r != rs.end(); ++r) {
-			r->value().push_back(changeFeedInfo);
-		}
-		wait(yield());
+	if (SERVER_KNOBS->STORAGE_LAZY_CHANGE_FEED_RESTORE) {
+		data->changeFeedRecovery = restoreChangeFeeds(data, changeFeeds, version);
+	} else {
+		wait(restoreChangeFeeds(data, changeFeeds, version));
 	}
-	data->keyChangeFeed.coalesce(allKeys);
 
 	state RangeResult tenantMap = fTenantMap.get();
 	state int tenantMapLoc;
@@ -13307,8 +14798,15 @@ void StorageServer::byteSampleApplySet(KeyValueRef kv, Version ver) {
 	const KeyRef key = kv.key;
 
 	auto old = byteSample.find(key);
-	if (old != byteSample.end())
+	if (old != byteSample.end()) {
+		// Overwriting a sampled key with a value of the same size is common, and changes neither the sample in memory
+		// nor the one on disk, which was written when the in-memory entry was
+		if (sampleInfo.inSample && byteSample.getMetric(old) == sampleInfo.sampledSize) {
+			++counters.byteSampleUnchangedSets;
+			return;
+		}
 		delta = -byteSample.getMetric(old);
+	}
 	if (sampleInfo.inSample) {
 		delta += sampleInfo.sampledSize;
 		byteSample.insert(key, sampleInfo.sampledSize);
@@ -13497,6 +14995,7 @@ Future<Void> StorageServerMetrics::waitMetrics(WaitMetricsRequest req, Future<Vo
 #endif
 
 ACTOR Future<Void> waitMetricsTenantAware_internal(StorageServer* self, WaitMetricsRequest req) {
+	state StorageMetrics metrics;
 	if (req.tenantInfo.hasTenant()) {
 		try {
 			// The call to `waitForMinVersion()` can throw `future_version()`.
@@ -13515,6 +15014,24 @@ ACTOR Future<Void> waitMetricsTenantAware_internal(StorageServer* self, WaitMetr
 
 	if (!self->isReadable(req.keys)) {
 		self->sendErrorWithPenalty(req.reply, wrong_shard_server(), self->getPenalty());
+	} else if (SERVER_KNOBS->STORAGE_KVS_RANGE_SIZE_ESTIMATE && req.min.allZero() && req.max.allZero()) {
+		// Requests which only want the current metrics, such as from getEstimatedRangeSizeBytes(), get their size from
+		// the storage engine if it can estimate it, since the byte sample is noisy for small ranges. Mutations which
+		// are not durable yet are left out, the same as the byte sample leaves out unsampled keys.
+		metrics = self->metrics.getMetrics(req.keys);
+		try {
+			Optional<int64_t> bytes = wait(self->storage.getKeyValueStore()->estimateRangeBytes(req.keys));
+			if (bytes.present()) {
+				CODE_PROBE(true, "Storage server range size estimated by the storage engine");
+				metrics.bytes = bytes.get();
+			}
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			TraceEvent(SevWarn, "StorageEngineRangeSizeEstimateError", self->thisServerID).error(e);
+		}
+		req.reply.send(metrics);
 	} else {
 		wait(self->metrics.waitMetrics(req, delayJittered(SERVER_KNOBS->STORAGE_METRIC_TIMEOUT)));
 	}
@@ -13637,6 +15154,16 @@ ACTOR Future<Void> serveGetValueRequests(StorageServer* self, FutureStream<GetVa
 	}
 }
 
+ACTOR Future<Void> serveGetValuesRequests(StorageServer* self, FutureStream<GetValuesRequest> getValues) {
+	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::GetValue;
+	loop {
+		GetValuesRequest req = waitNext(getValues);
+		// Warning: This code is executed at extremely high priority (TaskPriority::LoadBalancedEndpoint), so
+		// downgrade before doing real work
+		self->actors.add(self->readGuard(req, getValuesQ));
+	}
+}
+
 ACTOR Future<Void> serveGetKeyValuesRequests(StorageServer* self, FutureStream<GetKeyValuesRequest> getKeyValues) {
 	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::GetKeyValues;
 	loop {
@@ -13720,7 +15247,7 @@ ACTOR Future<Void> serveWatchValueRequestsImpl(StorageServer* self, FutureStream
 			KeyRef key = self->setWatchMetadata(metadata);
 			metadata->watch_impl = forward(watchWaitForValueChange(self, span.context, key, req.tenantInfo.tenantId),
 			                               metadata->versionPromise);
-			self->actors.add(watchValueSendReply(self, req, metadata->versionPromise.getFuture(), span.context));
+			addWatchReply(self, metadata, req);
 		}
 		// case 2: there is a watch in the map and it has the same value so just update version
 		else if (metadata->value == req.value) {
@@ -13742,7 +15269,7 @@ ACTOR Future<Void> serveWatchValueRequestsImpl(StorageServer* self, FutureStream
 				}
 			}
 
-			self->actors.add(watchValueSendReply(self, req, metadata->versionPromise.getFuture(), span.context));
+			addWatchReply(self, metadata, req);
 		}
 		// case 3: version in map has a lower version so trigger watch and create a new entry in map
 		else if (req.version > metadata->version) {
@@ -13756,7 +15283,7 @@ ACTOR Future<Void> serveWatchValueRequestsImpl(StorageServer* self, FutureStream
 			metadata->watch_impl = forward(watchWaitForValueChange(self, span.context, key, req.tenantInfo.tenantId),
 			                               metadata->versionPromise);
 
-			self->actors.add(watchValueSendReply(self, req, metadata->versionPromise.getFuture(), span.context));
+			addWatchReply(self, metadata, req);
 		}
 		// case 4: version in the map is higher so immediately trigger watch
 		else if (req.version < metadata->version) {
@@ -13790,8 +15317,7 @@ ACTOR Future<Void> serveWatchValueRequestsImpl(StorageServer* self, FutureStream
 						metadata->watch_impl =
 						    forward(watchWaitForValueChange(self, span.context, key, req.tenantInfo.tenantId),
 						            metadata->versionPromise);
-						self->actors.add(
-						    watchValueSendReply(self, req, metadata->versionPromise.getFuture(), span.context));
+						addWatchReply(self, metadata, req);
 					} else {
 						req.reply.send(WatchValueReply{ latest });
 					}
@@ -13825,6 +15351,16 @@ ACTOR Future<Void> serveWatchValueRequests(StorageServer* self, FutureStream<Wat
 	}
 }
 
+ACTOR Future<Void> serveWatchRangeRequests(StorageServer* self, FutureStream<WatchRangeRequest> watchRange) {
+	getCurrentLineage()->modify(&TransactionLineage::operation) = TransactionLineage::Operation::WatchValue;
+	loop {
+		WatchRangeRequest req = waitNext(watchRange);
+		if (self->shouldRead(req)) {
+			self->actors.add(watchRangeQ(self, req));
+		}
+	}
+}
+
 ACTOR Future<Void> serveChangeFeedStreamRequests(StorageServer* self,
                                                  FutureStream<ChangeFeedStreamRequest> changeFeedStream) {
 	loop {
@@ -13859,6 +15395,104 @@ ACTOR Future<Void> serveChangeFeedVersionUpdateRequests(
 	}
 }
 
+ACTOR Future<Void> trackColdShards(StorageServer* self) {
+	if (SERVER_KNOBS->STORAGE_COLD_SHARD_CHECK_INTERVAL <= 0.0) {
+		return Void();
+	}
+
+	loop {
+		wait(delay(SERVER_KNOBS->STORAGE_COLD_SHARD_CHECK_INTERVAL, TaskPriority::UpdateStorage));
+		int64_t shards = 0;
+		int64_t bytes = 0;
+		const double coldBefore = now() - SERVER_KNOBS->STORAGE_COLD_SHARD_AGE;
+		for (auto& shard : self->shards.ranges()) {
+			if (shard.value() && shard.value()->isReadable() && shard.value()->lastWriteTime < coldBefore) {
+				++shards;
+				bytes += self->metrics.byteSample.getEstimate(shard.range());
+			}
+		}
+		self->coldShards = shards;
+		self->coldBytes = bytes;
+	}
+}
+
+// Keeps the memory held by the storage queue, the storage engine's cache and, outside of simulation where it is shared
+// by every process, FastAllocator's free magazines within STORAGE_MEMORY_BUDGET_BYTES. The cache gets whatever the
+// queue leaves, down to a fraction of its configured size, and once it can't shrink any further ingestion is throttled
+// by lowering the queue size at which update() applies the e-brake.
+ACTOR Future<Void> memoryGovernor(StorageServer* self) {
+	if (SERVER_KNOBS->STORAGE_MEMORY_BUDGET_BYTES <= 0) {
+		return Void();
+	}
+
+	state int64_t maxCacheBytes = self->storage.getConfiguredCacheSize();
+	// Not the configured size, so that the first pass sets the limit in case an earlier storage server in this process
+	// left the shared cache resized
+	state int64_t cacheBytes = -1;
+	loop {
+		wait(delay(SERVER_KNOBS->STORAGE_MEMORY_BUDGET_INTERVAL, TaskPriority::UpdateStorage));
+		const int64_t budget = SERVER_KNOBS->STORAGE_MEMORY_BUDGET_BYTES;
+		const int64_t queueBytes = self->queueSize();
+		const int64_t unusedBytes = g_network->isSimulated() ? 0 : getTotalUnusedAllocatedMemory();
+		const int64_t minCacheBytes = maxCacheBytes * SERVER_KNOBS->STORAGE_MEMORY_BUDGET_MIN_CACHE_FRACTION;
+
+		int64_t newCacheBytes = std::clamp(budget - queueBytes - unusedBytes, minCacheBytes, maxCacheBytes);
+		// Resizing evicts, so small changes are left until they add up
+		if (maxCacheBytes > 0 && newCacheBytes != cacheBytes &&
+		    (std::abs(newCacheBytes - cacheBytes) >= maxCacheBytes / 100 || newCacheBytes == minCacheBytes ||
+		     newCacheBytes == maxCacheBytes)) {
+			CODE_PROBE(newCacheBytes < maxCacheBytes, "Storage memory governor shrank the storage engine cache");
+			cacheBytes = newCacheBytes;
+			self->storage.setCacheSizeLimit(cacheBytes);
+		}
+
+		self->memoryGovernorQueueLimit =
+		    std::max<int64_t>(budget - minCacheBytes - unusedBytes,
+		                      budget * SERVER_KNOBS->STORAGE_MEMORY_BUDGET_MIN_QUEUE_FRACTION);
+		CODE_PROBE(queueBytes >= self->memoryGovernorQueueLimit, "Storage memory governor throttled ingestion");
+
+		TraceEvent("StorageMemoryGovernor", self->thisServerID)
+		    .suppressFor(30.0)
+		    .detail("Budget", budget)
+		    .detail("QueueBytes", queueBytes)
+		    .detail("UnusedAllocatedBytes", unusedBytes)
+		    .detail("CacheBytes", cacheBytes)
+		    .detail("MaxCacheBytes", maxCacheBytes)
+		    .detail("QueueLimit", self->memoryGovernorQueueLimit);
+	}
+}
+
+// Keeps pinnedReadVersions in step with pinnedReadVersionKeys, reading them again whenever pinnedReadVersionsChangeKey
+// changes
+ACTOR Future<Void> watchPinnedReadVersions(StorageServer* self) {
+	state Reference<ReadYourWritesTransaction> tr = makeReference<ReadYourWritesTransaction>(self->cx);
+	state Future<Void> watchFuture;
+	loop {
+		try {
+			tr->setOption(FDBTransactionOptions::LOCK_AWARE);
+			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr->setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+			RangeResult pins = wait(tr->getRange(pinnedReadVersionKeys, CLIENT_KNOBS->TOO_MANY));
+			const Version maxLifetimeVersions =
+			    SERVER_KNOBS->STORAGE_PINNED_READ_VERSION_MAX_LIFETIME * SERVER_KNOBS->VERSIONS_PER_SECOND;
+			std::map<UID, std::pair<Version, Version>> pinnedReadVersions;
+			for (auto const& pin : pins) {
+				auto [version, expireVersion] = decodePinnedReadVersionValue(pin.value);
+				pinnedReadVersions[decodePinnedReadVersionKey(pin.key)] =
+				    std::make_pair(version, std::min(expireVersion, version + maxLifetimeVersions));
+			}
+			self->pinnedReadVersions = std::move(pinnedReadVersions);
+
+			watchFuture = tr->watch(pinnedReadVersionsChangeKey);
+			wait(tr->commit());
+			wait(watchFuture);
+			tr->reset();
+		} catch (Error& e) {
+			wait(tr->onError(e));
+		}
+	}
+}
+
 ACTOR Future<Void> storageEngineConsistencyCheck(StorageServer* self) {
 	if (SERVER_KNOBS->STORAGE_SHARD_CONSISTENCY_CHECK_INTERVAL <= 0.0) {
 		return Void();
@@ -13954,6 +15588,35 @@ ACTOR Future<Void> reportStorageServerState(StorageServer* self) {
 	}
 }
 
+// The tenant of a hot key is found from its prefix, since only the hottest keys are ever reported
+static GetHotKeysReply getHotKeys(StorageServer* self, int limit) {
+	GetHotKeysReply reply;
+	auto tenants = self->tenantMap.atLatest();
+	for (bool write : { false, true }) {
+		double elapsed;
+		for (auto const& item : self->hotKeys.top(write, limit, &elapsed)) {
+			HotKeyMetrics metrics;
+			metrics.begin = item.begin;
+			if (!item.end.empty()) {
+				metrics.end = Key(item.end);
+			}
+			metrics.write = write;
+			if (item.begin.size() >= TenantAPI::PREFIX_SIZE && !item.begin.startsWith(systemKeys.begin)) {
+				int64_t tenantId = TenantAPI::prefixToId(item.begin.substr(0, TenantAPI::PREFIX_SIZE),
+				                                         EnforceValidTenantId::False);
+				if (tenants.find(tenantId) != tenants.end()) {
+					metrics.tenantId = tenantId;
+				}
+			}
+			metrics.count = item.count;
+			metrics.error = item.error;
+			metrics.opsPerSecond = elapsed > 0 ? item.count / elapsed : 0;
+			reply.hotKeys.push_back(metrics);
+		}
+	}
+	return reply;
+}
+
 ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface ssi) {
 	state Future<Void> doUpdate = Void();
 	state bool updateReceived = false; // true iff the current update() actor assigned to doUpdate has already
@@ -13970,11 +15633,13 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 	self->actors.add(logLongByteSampleRecovery(self->byteSampleRecovery));
 	self->actors.add(checkBehind(self));
 	self->actors.add(serveGetValueRequests(self, ssi.getValue.getFuture()));
+	self->actors.add(serveGetValuesRequests(self, ssi.getValues.getFuture()));
 	self->actors.add(serveGetKeyValuesRequests(self, ssi.getKeyValues.getFuture()));
 	self->actors.add(serveGetMappedKeyValuesRequests(self, ssi.getMappedKeyValues.getFuture()));
 	self->actors.add(serveGetKeyValuesStreamRequests(self, ssi.getKeyValuesStream.getFuture()));
 	self->actors.add(serveGetKeyRequests(self, ssi.getKey.getFuture()));
 	self->actors.add(serveWatchValueRequests(self, ssi.watchValue.getFuture()));
+	self->actors.add(serveWatchRangeRequests(self, ssi.watchRange.getFuture()));
 	self->actors.add(serveChangeFeedStreamRequests(self, ssi.changeFeedStream.getFuture()));
 	self->actors.add(serveOverlappingChangeFeedsRequests(self, ssi.overlappingChangeFeeds.getFuture()));
 	self->actors.add(serveChangeFeedPopRequests(self, ssi.changeFeedPop.getFuture()));
@@ -13982,6 +15647,9 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 	self->actors.add(traceRole(Role::STORAGE_SERVER, ssi.id()));
 	self->actors.add(reportStorageServerState(self));
 	self->actors.add(storageEngineConsistencyCheck(self));
+	self->actors.add(trackColdShards(self));
+	self->actors.add(memoryGovernor(self));
+	self->actors.add(watchPinnedReadVersions(self));
 
 	self->transactionTagCounter.startNewInterval();
 	self->actors.add(
@@ -14170,9 +15838,11 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 
 				req.reply.send(reply);
 			}
+			when(GetHotKeysRequest req = waitNext(ssi.getHotKeys.getFuture())) {
+				req.reply.send(getHotKeys(self, req.limit));
+			}
 			when(GetStorageCheckSumRequest req = waitNext(ssi.getCheckSum.getFuture())) {
-				TraceEvent(SevError, "GetStorageCheckSumHasNotImplemented", ssi.id());
-				req.reply.sendError(not_implemented());
+				self->actors.add(getStorageCheckSumQ(self, req));
 			}
 			when(wait(self->actors.getResult())) {}
 		}
@@ -14698,6 +16368,7 @@ ACTOR Future<Void> storageServer(IKeyValueStore* persistentData,
 		if (self.byteSampleRecovery.isValid()) {
 			self.byteSampleRecovery.cancel();
 		}
+		self.changeFeedRecovery.cancel();
 
 		if (recovered.canBeSet())
 			recovered.send(Void());
@@ -14764,7 +16435,7 @@ Possibilities:
 void versionedMapTest() {
 	VersionedMap<int, int> vm;
 
-	printf("SS Ptree node is %zu bytes\n", sizeof(StorageServer::VersionedData::PTreeT));
+	printf("SS Ptree node is %zu bytes\n", sizeof(VersionedMap<KeyRef, ValueOrClearToRef>::PTreeT));
 
 	const int NSIZE = sizeof(VersionedMap<int, int>::PTreeT);
 	const int ASIZE = NSIZE <= 64 ? 64 : nextFastAllocatedSize(NSIZE);
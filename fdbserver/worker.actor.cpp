@@ -2433,7 +2433,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 					filesClosed.add(data->onClosed());
 
 					Promise<Void> recovery;
-					Future<Void> bw = blobWorker(recruited, recovery, dbInfo, data);
+					Future<Void> bw = blobWorker(recruited, recovery, dbInfo, data, folder);
 					recoveries.push_back(recovery.getFuture());
 					bw = handleIOErrors(bw, data, recruited.id());
 					blobWorkerFuture = bw;
@@ -3141,7 +3141,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 					}
 
 					ReplyPromise<InitializeBlobWorkerReply> blobWorkerReady = req.reply;
-					Future<Void> bw = blobWorker(recruited, blobWorkerReady, dbInfo, data);
+					Future<Void> bw = blobWorker(recruited, blobWorkerReady, dbInfo, data, folder);
 					if (SERVER_KNOBS->BLOB_WORKER_DISK_ENABLED && req.storeType != KeyValueStoreType::END) {
 						bw = handleIOErrors(bw, data, recruited.id());
 					}
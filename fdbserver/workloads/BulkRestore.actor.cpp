@@ -0,0 +1,197 @@
+/*
+ * BulkRestore.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/BackupAgent.actor.h"
+#include "fdbclient/BackupContainer.h"
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbrpc/simulator.h"
+#include "fdbserver/BulkRestore.actor.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Backs up a range while writing to it, then bulk restores it to a version after the backup's snapshot and checks
+// that it matches what was read at that version
+struct BulkRestoreWorkload : TestWorkload {
+	static constexpr auto NAME = "BulkRestore";
+
+	FileBackupAgent backupAgent;
+	int nodeCount;
+	int mutationCount;
+	KeyRange restoreRange;
+	RangeResult expected;
+	bool pass = true;
+
+	BulkRestoreWorkload(WorkloadContext const& wcx) : TestWorkload(wcx) {
+		nodeCount = getOption(options, "nodeCount"_sr, 1000);
+		mutationCount = getOption(options, "mutationCount"_sr, 200);
+		restoreRange = prefixRange("bulkRestore/"_sr);
+	}
+
+	// Bulk loading races with these in changing the DD mode, as in the BulkLoading workload
+	void disableFailureInjectionWorkloads(std::set<std::string>& out) const override {
+		out.insert({ "RandomMoveKeys",
+		             "DataLossRecovery",
+		             "IDDTxnProcessorApiCorrectness",
+		             "PerpetualWiggleStatsWorkload",
+		             "PhysicalShardMove",
+		             "StorageCorruption",
+		             "StorageServerCheckpointRestoreTest",
+		             "ValidateStorage" });
+	}
+
+	Key keyForIndex(int i) const { return restoreRange.begin.withSuffix(format("%08d", i)); }
+
+	ACTOR static Future<Void> writeInitialData(BulkRestoreWorkload* self, Database cx) {
+		state int begin = 0;
+		while (begin < self->nodeCount) {
+			state Transaction tr(cx);
+			loop {
+				try {
+					for (int i = begin; i < std::min(begin + 100, self->nodeCount); i++) {
+						tr.set(self->keyForIndex(i), deterministicRandom()->randomAlphaNumeric(100));
+					}
+					wait(tr.commit());
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+			begin += 100;
+		}
+		return Void();
+	}
+
+	// Makes each kind of mutation the logs can hold, one transaction at a time
+	ACTOR static Future<Void> mutate(BulkRestoreWorkload* self, Database cx) {
+		state int i = 0;
+		for (; i < self->mutationCount; i++) {
+			state Transaction tr(cx);
+			state int op = deterministicRandom()->randomInt(0, 4);
+			state int index = deterministicRandom()->randomInt(0, self->nodeCount);
+			loop {
+				try {
+					if (op == 0) {
+						tr.set(self->keyForIndex(index), deterministicRandom()->randomAlphaNumeric(100));
+					} else if (op == 1) {
+						tr.clear(self->keyForIndex(index));
+					} else if (op == 2) {
+						tr.clear(KeyRangeRef(self->keyForIndex(index), self->keyForIndex(index + 10)));
+					} else {
+						tr.atomicOp(self->keyForIndex(index),
+						            BinaryWriter::toValue<int64_t>(deterministicRandom()->randomInt(1, 100),
+						                                           Unversioned()),
+						            MutationRef::AddValue);
+					}
+					wait(tr.commit());
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+		return Void();
+	}
+
+	ACTOR static Future<RangeResult> readRange(BulkRestoreWorkload* self, Database cx, Version* readVersion) {
+		state Transaction tr(cx);
+		loop {
+			try {
+				RangeResult result = wait(tr.getRange(self->restoreRange, CLIENT_KNOBS->TOO_MANY));
+				ASSERT(!result.more);
+				if (readVersion) {
+					*readVersion = tr.getReadVersion().get();
+				}
+				return result;
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+	}
+
+	ACTOR static Future<Void> clearRange(BulkRestoreWorkload* self, Database cx) {
+		state Transaction tr(cx);
+		loop {
+			try {
+				tr.clear(self->restoreRange);
+				wait(tr.commit());
+				return Void();
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+	}
+
+	ACTOR static Future<Void> _start(BulkRestoreWorkload* self, Database cx) {
+		// Network partitions between the CC and DD can keep the bulk load tasks from completing
+		disableConnectionFailures("BulkRestore");
+
+		wait(writeInitialData(self, cx));
+
+		state std::string tagName = "bulkRestore";
+		state Standalone<VectorRef<KeyRangeRef>> backupRanges;
+		backupRanges.push_back_deep(backupRanges.arena(), self->restoreRange);
+		wait(self->backupAgent.submitBackup(
+		    cx, "file://simfdb/backups/"_sr, {}, 0, 1000000, tagName, backupRanges, false, StopWhenDone::False));
+		wait(success(self->backupAgent.waitBackup(cx, tagName, StopWhenDone::False)));
+		TraceEvent("BulkRestoreWorkloadBackupRestorable").log();
+
+		// Everything from here on is only in the mutation logs
+		wait(mutate(self, cx));
+		state Version targetVersion = invalidVersion;
+		wait(store(self->expected, readRange(self, cx, &targetVersion)));
+
+		state Reference<IBackupContainer> container;
+		wait(self->backupAgent.discontinueBackup(cx, Key(tagName)));
+		wait(success(self->backupAgent.waitBackup(cx, tagName, StopWhenDone::True, &container)));
+		TraceEvent("BulkRestoreWorkloadBackupDone").detail("TargetVersion", targetVersion);
+
+		wait(clearRange(self, cx));
+		wait(bulkRestore(cx, container, self->restoreRange, targetVersion, "bulkRestore"));
+
+		RangeResult restored = wait(readRange(self, cx, nullptr));
+		if (restored.size() != self->expected.size()) {
+			TraceEvent(SevError, "BulkRestoreWorkloadWrongKeyCount")
+			    .detail("Expected", self->expected.size())
+			    .detail("Restored", restored.size());
+			self->pass = false;
+			return Void();
+		}
+		for (int i = 0; i < restored.size(); i++) {
+			if (restored[i].key != self->expected[i].key || restored[i].value != self->expected[i].value) {
+				TraceEvent(SevError, "BulkRestoreWorkloadWrongKeyValue")
+				    .detail("ExpectedKey", self->expected[i].key)
+				    .detail("ExpectedValue", self->expected[i].value)
+				    .detail("RestoredKey", restored[i].key)
+				    .detail("RestoredValue", restored[i].value);
+				self->pass = false;
+				return Void();
+			}
+		}
+		TraceEvent("BulkRestoreWorkloadVerified").detail("Keys", restored.size());
+		return Void();
+	}
+
+	Future<Void> setup(Database const& cx) override { return Void(); }
+	Future<Void> start(Database const& cx) override { return clientId ? Void() : _start(this, cx); }
+	Future<bool> check(Database const& cx) override { return pass; }
+	void getMetrics(std::vector<PerfMetric>& m) override {}
+};
+
+WorkloadFactory<BulkRestoreWorkload> BulkRestoreWorkloadFactory;
@@ -1148,23 +1148,29 @@ struct FuzzApiCorrectnessWorkload : TestWorkload {
 			if (op == MutationRef::SetVersionstampedValue && value.size() >= 4) {
 				pos = littleEndian32(*(int32_t*)&value.end()[-4]);
 			}
+			// Whether the values of a SetVersionstampedKeys are well formed and small enough is left to the client
+			bool manyKeys = op == MutationRef::SetVersionstampedKeys;
+			bool invalidVersionstamp =
+			    (op == MutationRef::SetVersionstampedKey && (pos < 0 || pos + 10 > key.size() - 4)) ||
+			    (op == MutationRef::SetVersionstampedValue && (pos < 0 || pos + 10 > value.size() - 4));
+			ExceptionContract::occurance_t valueTooLarge =
+			    manyKeys ? ExceptionContract::Possible
+			             : ExceptionContract::requiredIf(value.size() > CLIENT_KNOBS->VALUE_SIZE_LIMIT);
 
 			contract = { std::make_pair(error_code_key_too_large,
 				                        key.size() > getMaxWriteKeySize(key, true)    ? ExceptionContract::Always
 				                        : key.size() > getMaxWriteKeySize(key, false) ? ExceptionContract::Possible
 				                                                                      : ExceptionContract::Never),
-				         std::make_pair(error_code_value_too_large,
-				                        ExceptionContract::requiredIf(value.size() > CLIENT_KNOBS->VALUE_SIZE_LIMIT)),
+				         std::make_pair(error_code_value_too_large, valueTooLarge),
 				         std::make_pair(error_code_invalid_mutation_type,
 				                        ExceptionContract::requiredIf(!isValidMutationType(op) ||
-				                                                      !isAtomicOp((MutationRef::Type)op))),
+				                                                      (!isAtomicOp((MutationRef::Type)op) &&
+				                                                       !manyKeys))),
 				         std::make_pair(error_code_key_outside_legal_range,
 				                        ExceptionContract::requiredIf((key >= workload->getMaxKey(tr)))),
 				         std::make_pair(error_code_client_invalid_operation,
-				                        ExceptionContract::requiredIf((op == MutationRef::SetVersionstampedKey &&
-				                                                       (pos < 0 || pos + 10 > key.size() - 4)) ||
-				                                                      (op == MutationRef::SetVersionstampedValue &&
-				                                                       (pos < 0 || pos + 10 > value.size() - 4)))) };
+				                        manyKeys ? ExceptionContract::Possible
+				                                 : ExceptionContract::requiredIf(invalidVersionstamp)) };
 		}
 
 		void callback(Reference<ITransaction> tr) override { tr->atomicOp(key, value, (FDBMutationTypes::Option)op); }
@@ -1232,12 +1232,8 @@ struct MetaclusterRestoreWorkload : TestWorkload {
 			}
 
 			// Delete the former ERROR tenants so that the cluster is in a consistent state for subsequent testing
-			std::vector<Future<Void>> deleteFutures;
-			for (TenantName const& tenantName : tenantsInErrorState) {
-				deleteFutures.push_back(metacluster::deleteTenant(self->managementDb, tenantName));
-			}
-
-			wait(waitForAll(deleteFutures));
+			wait(metacluster::deleteTenants(
+			    self->managementDb, std::vector<TenantName>(tenantsInErrorState.begin(), tenantsInErrorState.end())));
 		}
 
 		return Void();
@@ -0,0 +1,144 @@
+/*
+ * MockDDBenchmark.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/workloads/MockDDTest.h"
+#include "fdbserver/MockDataDistributor.h"
+#include "fdbserver/DDTxnProcessor.h"
+#include "fdbrpc/ContinuousSample.h"
+#include "flow/Platform.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace {
+
+struct MoveStats {
+	int64_t moves = 0;
+	int64_t bytesMoved = 0;
+	ContinuousSample<double> latency{ 1000 };
+};
+
+// Counts the data moves DD issues against the mock cluster, and how long the mock takes to carry each one out
+class BenchmarkTxnProcessor : public DDMockTxnProcessor {
+	std::shared_ptr<MoveStats> stats;
+
+public:
+	BenchmarkTxnProcessor(std::shared_ptr<MockGlobalState> mgs, std::shared_ptr<MoveStats> stats)
+	  : DDMockTxnProcessor(mgs), stats(stats) {}
+
+	Future<Void> moveKeys(const MoveKeysParams& params) override {
+		stats->moves++;
+		if (params.keys.present()) {
+			auto [srcTeams, destTeams] = mgs->shardMapping->getTeamsForFirstShard(params.keys.get());
+			if (!srcTeams.empty() && !srcTeams.front().servers.empty() &&
+			    mgs->allServers.count(srcTeams.front().servers.front())) {
+				stats->bytesMoved +=
+				    mgs->allServers.at(srcTeams.front().servers.front())->sumRangeSize(params.keys.get());
+			}
+		}
+		double start = now();
+		return map(DDMockTxnProcessor::moveKeys(params), [stats = stats, start](Void) {
+			stats->latency.addSample(now() - start);
+			return Void();
+		});
+	}
+};
+
+} // namespace
+
+// Runs the whole data distributor against a synthetic mock cluster, which can have far more servers and shards than a
+// simulated one, and reports how many moves it makes and the CPU it needs to make them, so that regressions in DD
+// scalability show up as changes in these metrics
+class MockDDBenchmarkWorkload : public MockDDTestWorkload {
+public:
+	static constexpr auto NAME = "MockDDBenchmark";
+	Reference<DDSharedContext> ddcx;
+	Reference<BenchmarkTxnProcessor> mock;
+	std::shared_ptr<MoveStats> stats = std::make_shared<MoveStats>();
+	MockDataDistributor dataDistributor;
+	ActorCollection actors;
+
+	// Storage servers get created on every process up front, rather than only for the initial team
+	bool storagePerProcess = true;
+
+	double setupCpuSeconds = 0, runCpuSeconds = 0, runSeconds = 0;
+
+	explicit MockDDBenchmarkWorkload(WorkloadContext const& wcx)
+	  : MockDDTestWorkload(wcx),
+	    ddcx(makeReference<DDSharedContext>(
+	        DataDistributorInterface(LocalityData(), deterministicRandom()->randomUniqueID()))) {
+		storagePerProcess = getOption(options, "storagePerProcess"_sr, storagePerProcess);
+	}
+
+	Future<Void> setup(Database const& cx) override {
+		if (!enabled)
+			return Void();
+		double startCpu = getProcessorTimeProcess();
+		MockDDTestWorkload::setup(cx);
+		populateMgs();
+		if (storagePerProcess) {
+			sharedMgs->addStoragePerProcess();
+		}
+		mock = makeReference<BenchmarkTxnProcessor>(sharedMgs, stats);
+		setupCpuSeconds = getProcessorTimeProcess() - startCpu;
+		return Void();
+	}
+
+	ACTOR static Future<Void> _start(MockDDBenchmarkWorkload* self) {
+		state double startCpu = getProcessorTimeProcess();
+		state double startTime = now();
+		self->actors.add(waitForAll(self->sharedMgs->runAllMockServers()));
+		self->actors.add(self->dataDistributor.run(self->ddcx, self->mock));
+		wait(delay(self->testDuration));
+		self->runCpuSeconds = getProcessorTimeProcess() - startCpu;
+		self->runSeconds = now() - startTime;
+		self->actors.clear(true);
+		TraceEvent("MockDDBenchmarkResult")
+		    .detail("Servers", self->sharedMgs->allServers.size())
+		    .detail("Moves", self->stats->moves)
+		    .detail("BytesMoved", self->stats->bytesMoved)
+		    .detail("SetupCpuSeconds", self->setupCpuSeconds)
+		    .detail("RunCpuSeconds", self->runCpuSeconds);
+		return Void();
+	}
+
+	Future<Void> start(Database const& cx) override {
+		if (!enabled)
+			return Void();
+		return _start(this);
+	}
+
+	Future<bool> check(Database const& cx) override { return true; }
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		if (!enabled)
+			return;
+		int64_t moves = stats->moves;
+		m.emplace_back("Servers", sharedMgs->allServers.size(), Averaged::False);
+		m.emplace_back("Moves", moves, Averaged::False);
+		m.emplace_back("Moves/sec", runSeconds > 0 ? moves / runSeconds : 0, Averaged::False);
+		m.emplace_back("Bytes Moved", stats->bytesMoved, Averaged::False);
+		m.emplace_back("Setup CPU (s)", setupCpuSeconds, Averaged::False);
+		m.emplace_back("Run CPU (s)", runCpuSeconds, Averaged::False);
+		m.emplace_back("CPU per Move (ms)", moves ? 1000.0 * runCpuSeconds / moves : 0, Averaged::False);
+		m.emplace_back("Median Move Latency (s)", stats->latency.median(), Averaged::False);
+		m.emplace_back("99% Move Latency (s)", stats->latency.percentile(0.99), Averaged::False);
+	}
+};
+
+WorkloadFactory<MockDDBenchmarkWorkload> MockDDBenchmarkWorkload;
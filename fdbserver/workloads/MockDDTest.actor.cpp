@@ -32,6 +32,7 @@ MockDDTestWorkload::MockDDTestWorkload(WorkloadContext const& wcx) : TestWorkloa
 	simpleConfig = getOption(options, "simpleConfig"_sr, simpleConfig);
 	testDuration = getOption(options, "testDuration"_sr, testDuration);
 	meanDelay = getOption(options, "meanDelay"_sr, meanDelay);
+	machineCount = getOption(options, "machineCount"_sr, machineCount);
 
 	// mock data population setting
 	maxKeyspace = getOption(options, "maxKeyspace"_sr, maxKeyspace);
@@ -113,6 +114,9 @@ Future<Void> MockDDTestWorkload::setup(Database const& cx) {
 	testConfig.minimumReplication = 1;
 	testConfig.logAntiQuorum = 0;
 	testConfig.singleRegion = true;
+	if (machineCount > 0) {
+		testConfig.machineCount = machineCount;
+	}
 	BasicSimulationConfig dbConfig = generateBasicSimulationConfig(testConfig);
 
 	// initialize sharedMgs
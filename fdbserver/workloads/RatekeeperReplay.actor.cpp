@@ -0,0 +1,67 @@
+/*
+ * RatekeeperReplay.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/Ratekeeper.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Replays a recording made with RATEKEEPER_RECORD_DIR set through a ratekeeper with this test's knobs, and reports how
+// its decisions differ from the recorded ones. Run it with the knobs to try, e.g.
+//   fdbserver -r simulation -f tests/rare/RatekeeperReplay.toml --knob_target_bytes_per_storage_server=2000000000
+struct RatekeeperReplayWorkload : TestWorkload {
+	static constexpr auto NAME = "RatekeeperReplay";
+
+	std::string recordFile;
+	RatekeeperReplaySummary summary;
+
+	RatekeeperReplayWorkload(WorkloadContext const& wcx) : TestWorkload(wcx) {
+		recordFile = getOption(options, "recordFile"_sr, ""_sr).toString();
+	}
+
+	ACTOR static Future<Void> _start(RatekeeperReplayWorkload* self, Database cx) {
+		RatekeeperReplaySummary summary = wait(Ratekeeper::replay(cx, self->recordFile));
+		self->summary = summary;
+		return Void();
+	}
+
+	Future<Void> start(Database const& cx) override {
+		if (clientId != 0) {
+			return Void();
+		}
+		return _start(this, cx);
+	}
+
+	Future<bool> check(Database const& cx) override { return clientId != 0 || summary.decisions > 0; }
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		if (clientId != 0) {
+			return;
+		}
+		m.emplace_back("Records", summary.records, Averaged::False);
+		m.emplace_back("Decisions", summary.decisions, Averaged::False);
+		m.emplace_back("Changed Decisions", summary.changedDecisions, Averaged::False);
+		m.emplace_back("Recorded Limited Decisions", summary.recordedLimitedDecisions, Averaged::False);
+		m.emplace_back("Limited Decisions", summary.limitedDecisions, Averaged::False);
+		m.emplace_back("Recorded Mean TPS Limit", summary.recordedMeanTPSLimit, Averaged::False);
+		m.emplace_back("Mean TPS Limit", summary.meanTPSLimit, Averaged::False);
+	}
+};
+
+WorkloadFactory<RatekeeperReplayWorkload> RatekeeperReplayWorkloadFactory;
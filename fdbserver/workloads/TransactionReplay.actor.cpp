@@ -0,0 +1,397 @@
+/*
+ * TransactionReplay.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/ClientLogEvents.h"
+#include "fdbrpc/DDSketch.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/IAsyncFile.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Replays a file written by a client with the transaction_capture_file database option against the cluster under test,
+// keeping the captured spacing of transactions and of the operations within them (scaled by speedup), and reports the
+// captured and replayed latencies of each kind of operation side by side. Transactions are spread over the clients.
+// With captureTransactions set, the first client makes the capture itself before replaying it, which is how the
+// workload tests itself; otherwise point captureFile at a capture copied from a real cluster, e.g.
+//   fdbserver -r simulation -f tests/rare/TransactionReplay.toml
+//
+// Transactions that used tenants or the system keyspace are skipped, since their keys are not meaningful on another
+// cluster. Failed operations are counted rather than retried, so that the replay keeps to the captured schedule.
+struct TransactionReplayWorkload : TestWorkload {
+	static constexpr auto NAME = "TransactionReplay";
+
+	enum OpType { GET_READ_VERSION = 0, GET, GET_RANGE, COMMIT, OP_TYPES };
+	static constexpr const char* opNames[OP_TYPES] = { "GRV", "Get", "GetRange", "Commit" };
+
+	struct CapturedOp {
+		OpType type;
+		double offset; // from the start of the transaction
+		double latency; // negative if the operation failed when captured
+		KeyRef key;
+		KeyRef endKey;
+		int rangeBytes = 0;
+		CommitTransactionRef commit;
+	};
+
+	struct CapturedTransaction {
+		double startTs = 0;
+		FdbClientLogEvents::TransactionPriorityType priority = FdbClientLogEvents::TransactionPriorityType::UNSET;
+		std::vector<CapturedOp> ops;
+	};
+
+	std::string captureFile;
+	double speedup;
+	int captureTransactions;
+
+	Arena arena;
+	std::vector<CapturedTransaction> transactions;
+	int64_t records = 0;
+	int64_t skipped = 0;
+	int64_t replayed = 0;
+	int64_t errors = 0;
+	DDSketch<double> capturedLatencies[OP_TYPES];
+	DDSketch<double> replayedLatencies[OP_TYPES];
+
+	TransactionReplayWorkload(WorkloadContext const& wcx) : TestWorkload(wcx) {
+		captureFile = getOption(options, "captureFile"_sr, "transactions.capture"_sr).toString();
+		speedup = getOption(options, "speedup"_sr, 1.0);
+		captureTransactions = getOption(options, "captureTransactions"_sr, 0);
+	}
+
+	// Parses the events of one transaction as written by TransactionLogInfo, returning false if it must be skipped
+	bool parseTransaction(StringRef record, CapturedTransaction& tr) {
+		BinaryReader reader(record, Unversioned());
+		ProtocolVersion protocolVersion;
+		reader >> protocolVersion;
+		if (!protocolVersion.hasTenants()) {
+			return false;
+		}
+		reader.setProtocolVersion(protocolVersion);
+
+		bool first = true;
+		while (!reader.empty()) {
+			FdbClientLogEvents::Event event;
+			reader >> event;
+			if (event.tenant.present()) {
+				return false;
+			}
+			CapturedOp op;
+			switch (event.type) {
+			case FdbClientLogEvents::EventType::GET_VERSION_LATENCY: {
+				FdbClientLogEvents::EventGetVersion_V3 e;
+				reader >> e;
+				op.type = GET_READ_VERSION;
+				op.latency = e.latency;
+				tr.priority = e.priorityType;
+				break;
+			}
+			case FdbClientLogEvents::EventType::GET_LATENCY: {
+				FdbClientLogEvents::EventGet e;
+				reader >> e;
+				op.type = GET;
+				op.latency = e.latency;
+				op.key = KeyRef(arena, e.key);
+				break;
+			}
+			case FdbClientLogEvents::EventType::GET_RANGE_LATENCY: {
+				FdbClientLogEvents::EventGetRange e;
+				reader >> e;
+				op.type = GET_RANGE;
+				op.latency = e.latency;
+				op.key = KeyRef(arena, e.startKey);
+				op.endKey = KeyRef(arena, e.endKey);
+				op.rangeBytes = e.rangeSize;
+				break;
+			}
+			case FdbClientLogEvents::EventType::COMMIT_LATENCY: {
+				FdbClientLogEvents::EventCommit_V2 e;
+				reader >> e;
+				op.type = COMMIT;
+				op.latency = e.latency;
+				op.commit = CommitTransactionRef(arena, e.req.transaction);
+				break;
+			}
+			case FdbClientLogEvents::EventType::ERROR_GET: {
+				FdbClientLogEvents::EventGetError e;
+				reader >> e;
+				continue;
+			}
+			case FdbClientLogEvents::EventType::ERROR_GET_RANGE: {
+				FdbClientLogEvents::EventGetRangeError e;
+				reader >> e;
+				continue;
+			}
+			case FdbClientLogEvents::EventType::ERROR_COMMIT: {
+				// Still offered to the cluster, since the attempt was part of the captured load
+				FdbClientLogEvents::EventCommitError e;
+				reader >> e;
+				op.type = COMMIT;
+				op.latency = -1;
+				op.commit = CommitTransactionRef(arena, e.req.transaction);
+				break;
+			}
+			default:
+				TraceEvent(SevWarnAlways, "TransactionReplayUnknownEvent").detail("EventType", event.type);
+				return false;
+			}
+
+			if (op.type == GET || op.type == GET_RANGE) {
+				if (op.key >= systemKeys.begin) {
+					return false;
+				}
+			} else if (op.type == COMMIT) {
+				for (auto& m : op.commit.mutations) {
+					if (m.param1 >= systemKeys.begin) {
+						return false;
+					}
+				}
+			}
+			if (first || event.startTs < tr.startTs) {
+				tr.startTs = event.startTs;
+				first = false;
+			}
+			op.offset = event.startTs;
+			tr.ops.push_back(op);
+		}
+		for (auto& op : tr.ops) {
+			op.offset -= tr.startTs;
+		}
+		std::stable_sort(tr.ops.begin(), tr.ops.end(), [](const CapturedOp& a, const CapturedOp& b) {
+			return a.offset < b.offset;
+		});
+		return !tr.ops.empty();
+	}
+
+	ACTOR static Future<Void> readCapture(TransactionReplayWorkload* self) {
+		state Reference<IAsyncFile> file = wait(IAsyncFileSystem::filesystem()->open(
+		    self->captureFile, IAsyncFile::OPEN_NO_AIO | IAsyncFile::OPEN_READONLY | IAsyncFile::OPEN_UNCACHED, 0));
+		state int64_t size = wait(file->size());
+		state Standalone<StringRef> data = makeString(size);
+		int readSize = wait(file->read(mutateString(data), size, 0));
+		ASSERT_EQ(readSize, size);
+
+		// Each record is a little endian length followed by that many bytes of events
+		int64_t offset = 0;
+		int64_t index = 0;
+		while (offset + (int64_t)sizeof(int32_t) <= size) {
+			int32_t length = littleEndian32(*(const int32_t*)(data.begin() + offset));
+			offset += sizeof(int32_t);
+			if (length < 0 || offset + length > size) {
+				TraceEvent(SevWarnAlways, "TransactionReplayTruncatedCapture")
+				    .detail("File", self->captureFile)
+				    .detail("Offset", offset);
+				break;
+			}
+			StringRef record = data.substr(offset, length);
+			offset += length;
+			++self->records;
+			CapturedTransaction tr;
+			if (!self->parseTransaction(record, tr)) {
+				++self->skipped;
+				continue;
+			}
+			if (index++ % self->clientCount == self->clientId) {
+				self->transactions.push_back(std::move(tr));
+			}
+		}
+		TraceEvent("TransactionReplayCaptureRead")
+		    .detail("File", self->captureFile)
+		    .detail("Records", self->records)
+		    .detail("Skipped", self->skipped)
+		    .detail("Transactions", self->transactions.size());
+		return Void();
+	}
+
+	void recordOp(const CapturedOp& op, double latency) {
+		if (op.latency >= 0) {
+			capturedLatencies[op.type].addSample(op.latency);
+		}
+		replayedLatencies[op.type].addSample(latency);
+	}
+
+	ACTOR static Future<Void> replayRead(TransactionReplayWorkload* self, Transaction* tr, const CapturedOp* op) {
+		state double start = now();
+		try {
+			if (op->type == GET) {
+				wait(success(tr->get(op->key)));
+			} else {
+				wait(success(tr->getRange(
+				    KeyRangeRef(op->key, op->endKey),
+				    GetRangeLimits(GetRangeLimits::ROW_LIMIT_UNLIMITED, std::max(op->rangeBytes, 1)))));
+			}
+			self->recordOp(*op, now() - start);
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			++self->errors;
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> replayTransaction(TransactionReplayWorkload* self,
+	                                            Database cx,
+	                                            const CapturedTransaction* captured,
+	                                            double start) {
+		state Transaction tr(cx);
+		state std::vector<Future<Void>> reads;
+		state int i = 0;
+		state double opStart;
+		if (captured->priority == FdbClientLogEvents::TransactionPriorityType::PRIORITY_BATCH) {
+			tr.setOption(FDBTransactionOptions::PRIORITY_BATCH);
+		} else if (captured->priority == FdbClientLogEvents::TransactionPriorityType::PRIORITY_IMMEDIATE) {
+			tr.setOption(FDBTransactionOptions::PRIORITY_SYSTEM_IMMEDIATE);
+		}
+		try {
+			for (; i < captured->ops.size(); i++) {
+				wait(delayUntil(start + captured->ops[i].offset / self->speedup));
+				const CapturedOp& op = captured->ops[i];
+				if (op.type == GET || op.type == GET_RANGE) {
+					reads.push_back(replayRead(self, &tr, &op));
+					continue;
+				}
+
+				if (op.type == COMMIT) {
+					// The captured transaction could only have built its commit from the reads before it
+					wait(waitForAll(reads));
+					for (auto& m : captured->ops[i].commit.mutations) {
+						if (m.type == MutationRef::SetValue) {
+							tr.set(m.param1, m.param2, AddConflictRange::False);
+						} else if (m.type == MutationRef::ClearRange) {
+							tr.clear(KeyRangeRef(m.param1, m.param2), AddConflictRange::False);
+						} else {
+							tr.atomicOp(m.param1, m.param2, (MutationRef::Type)m.type, AddConflictRange::False);
+						}
+					}
+					for (auto& r : captured->ops[i].commit.read_conflict_ranges) {
+						tr.addReadConflictRange(r);
+					}
+					for (auto& r : captured->ops[i].commit.write_conflict_ranges) {
+						tr.addWriteConflictRange(r);
+					}
+				}
+				opStart = now();
+				if (captured->ops[i].type == COMMIT) {
+					wait(tr.commit());
+				} else {
+					wait(success(tr.getReadVersion()));
+				}
+				self->recordOp(captured->ops[i], now() - opStart);
+			}
+			wait(waitForAll(reads));
+			++self->replayed;
+		} catch (Error& e) {
+			if (e.code() == error_code_actor_cancelled) {
+				throw;
+			}
+			++self->errors;
+		}
+		return Void();
+	}
+
+	ACTOR static Future<Void> replay(TransactionReplayWorkload* self, Database cx) {
+		wait(readCapture(self));
+		if (self->transactions.empty()) {
+			return Void();
+		}
+		state std::vector<Future<Void>> replays;
+		state double firstCaptured = self->transactions[0].startTs;
+		state double start = now();
+		state int i = 0;
+		for (; i < self->transactions.size(); i++) {
+			wait(delayUntil(start + (self->transactions[i].startTs - firstCaptured) / self->speedup));
+			replays.push_back(replayTransaction(self, cx, &self->transactions[i], now()));
+		}
+		wait(waitForAll(replays));
+
+		TraceEvent ev("TransactionReplayLatency");
+		ev.detail("Transactions", self->transactions.size())
+		    .detail("Replayed", self->replayed)
+		    .detail("Errors", self->errors)
+		    .detail("Speedup", self->speedup);
+		for (int type = 0; type < OP_TYPES; type++) {
+			std::string name = opNames[type];
+			ev.detail(name + "Count", self->replayedLatencies[type].getPopulationSize())
+			    .detail(name + "CapturedMedian", self->capturedLatencies[type].median())
+			    .detail(name + "ReplayedMedian", self->replayedLatencies[type].median())
+			    .detail(name + "CapturedP99", self->capturedLatencies[type].percentile(.99))
+			    .detail(name + "ReplayedP99", self->replayedLatencies[type].percentile(.99));
+		}
+		return Void();
+	}
+
+	// Makes a small capture of transactions that read and then write keys, for the replay to test on
+	ACTOR static Future<Void> capture(TransactionReplayWorkload* self, Database cx) {
+		state int i = 0;
+		state Transaction tr;
+		state Key key;
+		cx->setOption(FDBDatabaseOptions::TRANSACTION_CAPTURE_FILE, StringRef(self->captureFile));
+		for (; i < self->captureTransactions; i++) {
+			tr = Transaction(cx);
+			key = StringRef(format("transactionReplay/%06d", deterministicRandom()->randomInt(0, 1000)));
+			loop {
+				try {
+					wait(success(tr.get(key)));
+					wait(success(tr.getRange(KeyRangeRef("transactionReplay/"_sr, "transactionReplay0"_sr), 10)));
+					tr.set(key, deterministicRandom()->randomAlphaNumeric(deterministicRandom()->randomInt(1, 100)));
+					wait(tr.commit());
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+			wait(delay(deterministicRandom()->random01() * 0.1));
+		}
+		// Hands the last transaction to the writer, then waits for it to flush and stop before the file is read back
+		tr = Transaction();
+		cx->setOption(FDBDatabaseOptions::TRANSACTION_CAPTURE_FILE, ""_sr);
+		wait(delay(2 * CLIENT_KNOBS->TRANSACTION_CAPTURE_FLUSH_INTERVAL + 1.0));
+		return Void();
+	}
+
+	Future<Void> setup(Database const& cx) override {
+		if (clientId != 0 || captureTransactions <= 0) {
+			return Void();
+		}
+		return capture(this, cx);
+	}
+
+	Future<Void> start(Database const& cx) override { return replay(this, cx); }
+
+	Future<bool> check(Database const& cx) override { return clientId != 0 || replayed > 0; }
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		// Every client reads the whole capture, so only the first reports on it
+		if (clientId == 0) {
+			m.emplace_back("Captured Transactions", records, Averaged::False);
+			m.emplace_back("Skipped Transactions", skipped, Averaged::False);
+		}
+		m.emplace_back("Replayed Transactions", replayed, Averaged::False);
+		m.emplace_back("Replay Errors", errors, Averaged::False);
+		for (int type = 0; type < OP_TYPES; type++) {
+			std::string name = opNames[type];
+			m.emplace_back(name + " Captured Median (ms)", 1000 * capturedLatencies[type].median(), Averaged::True);
+			m.emplace_back(name + " Replayed Median (ms)", 1000 * replayedLatencies[type].median(), Averaged::True);
+			m.emplace_back(name + " Captured P99 (ms)", 1000 * capturedLatencies[type].percentile(.99), Averaged::True);
+			m.emplace_back(name + " Replayed P99 (ms)", 1000 * replayedLatencies[type].percentile(.99), Averaged::True);
+		}
+	}
+};
+
+WorkloadFactory<TransactionReplayWorkload> TransactionReplayWorkloadFactory;
@@ -36,6 +36,7 @@ void forceLinkSimExternalConnectionTests();
 void forceLinkMutationLogReaderTests();
 void forceLinkSimKmsConnectorTests();
 void forceLinkIThreadPoolTests();
+void forceLinkWorkerPoolTests();
 void forceLinkTokenSignTests();
 void forceLinkJsonWebKeySetTests();
 void forceLinkVersionVectorTests();
@@ -107,6 +108,7 @@ struct UnitTestWorkload : TestWorkload {
 		forceLinkMutationLogReaderTests();
 		forceLinkSimKmsConnectorTests();
 		forceLinkIThreadPoolTests();
+		forceLinkWorkerPoolTests();
 		forceLinkTokenSignTests();
 		forceLinkJsonWebKeySetTests();
 		forceLinkVersionVectorTests();
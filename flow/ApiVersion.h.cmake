@@ -83,6 +83,12 @@ public: // introduced features
     API_VERSION_FEATURE(@FDB_AV_GET_CLIENT_STATUS@, GetClientStatus);
     API_VERSION_FEATURE(@FDB_AV_INITIALIZE_TRACE_ON_SETUP@, InitializeTraceOnSetup);
     API_VERSION_FEATURE(@FDB_AV_TENANT_GET_ID@, TenantGetId);
+    API_VERSION_FEATURE(@FDB_AV_GET_MULTI@, GetMulti);
+    API_VERSION_FEATURE(@FDB_AV_GET_RANGE_STREAM@, GetRangeStream);
+    API_VERSION_FEATURE(@FDB_AV_GET_DATABASE_METRICS@, GetDatabaseMetrics);
+    API_VERSION_FEATURE(@FDB_AV_WATCH_RANGE@, WatchRange);
+    API_VERSION_FEATURE(@FDB_AV_TRANSACTION_BATCH@, TransactionBatch);
+    API_VERSION_FEATURE(@FDB_AV_TRANSACTION_PROFILES@, TransactionProfiles);
 };
 
 #endif // FLOW_CODE_API_VERSION_H
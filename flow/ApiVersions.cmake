@@ -25,3 +25,9 @@ set(FDB_AV_FUTURE_GET_DOUBLE                "730")
 set(FDB_AV_GET_CLIENT_STATUS                "730")
 set(FDB_AV_INITIALIZE_TRACE_ON_SETUP        "730")
 set(FDB_AV_TENANT_GET_ID                    "730")
+set(FDB_AV_GET_MULTI                        "740")
+set(FDB_AV_GET_RANGE_STREAM                 "740")
+set(FDB_AV_GET_DATABASE_METRICS             "740")
+set(FDB_AV_WATCH_RANGE                      "740")
+set(FDB_AV_TRANSACTION_BATCH                "740")
+set(FDB_AV_TRANSACTION_PROFILES             "740")
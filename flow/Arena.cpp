@@ -105,6 +105,42 @@ void makeNoAccess(void*, size_t) {}
 void makeDefined(void*, size_t) {}
 void makeUndefined(void*, size_t) {}
 #endif
+
+bool isHugePageArenaSize(size_t size) {
+	return FLOW_KNOBS && FLOW_KNOBS->HUGE_PAGE_ARENA_MIN_BYTES > 0 && size >= FLOW_KNOBS->HUGE_PAGE_ARENA_MIN_BYTES;
+}
+
+// Huge blocks come from malloc, or from allocateHugePages once they are HUGE_PAGE_ARENA_MIN_BYTES, in which case size
+// is rounded up to whole huge pages. Either way they are released by freeHugeBlock().
+uint8_t* allocateHugeBlock(int& size) {
+	if (keepalive_allocator::isActive()) [[unlikely]]
+		return static_cast<uint8_t*>(keepalive_allocator::allocate(size));
+	void* p;
+	if (isHugePageArenaSize(size)) {
+		size = (size + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+		g_hugePageArenaMemory.fetch_add(size);
+		p = allocateHugePages(size);
+	} else {
+		p = malloc(size);
+		if (!p)
+			platform::outOfMemory();
+	}
+	if (g_allocSamplingRate.load(std::memory_order_relaxed)) [[unlikely]]
+		sampleAllocation(p, size);
+	return static_cast<uint8_t*>(p);
+}
+
+void freeHugeBlock(void* ptr, size_t size) {
+	if (keepalive_allocator::isActive()) [[unlikely]] {
+		keepalive_allocator::invalidate(ptr);
+		return;
+	}
+	if (isHugePageArenaSize(size) && size % kHugePageBytes == 0)
+		g_hugePageArenaMemory.fetch_sub(size);
+	if (g_allocSamplesLive.load(std::memory_order_relaxed)) [[unlikely]]
+		sampleDeallocation(ptr);
+	free(ptr);
+}
 } // namespace
 
 Arena::Arena() : impl(nullptr) {}
@@ -152,6 +188,45 @@ size_t Arena::getSize(FastInaccurateEstimate fastInaccurateEstimate) const {
 	return 0;
 }
 
+bool Arena::tryReset() {
+	if (!impl)
+		return false;
+	ArenaBlock* b = impl.getPtr();
+	allowAccess(b);
+	// Whoever else could add a reference already holds one, so a count of one cannot change under us
+	bool result = b->debugGetReferenceCount() == 1 && (b->isTiny() || b->nextBlockOffset == 0);
+	if (result)
+		b->reset();
+	disallowAccess(b);
+	return result;
+}
+
+Arena ArenaPool::acquire() {
+	if (!pooled.empty()) {
+		Arena arena = std::move(pooled.back());
+		pooled.pop_back();
+		return arena;
+	}
+	return reservedSize ? Arena(reservedSize) : Arena();
+}
+
+void ArenaPool::release(Arena&& arena) {
+	if (!arena.impl)
+		return;
+	ArenaBlock* b = arena.impl.getPtr();
+	allowAccess(b);
+	bool singleBlock = b->isTiny() || b->nextBlockOffset == 0;
+	size_t used = singleBlock ? b->used() : b->estimatedTotalSize();
+	size_t size = b->size();
+	disallowAccess(b);
+
+	reservedSize = std::max(used, reservedSize - reservedSize / 8);
+	// Only keep blocks big enough for what recent arenas needed, so reusing one doesn't mean growing it again
+	if (pooled.size() < maxPooled && size >= reservedSize && arena.tryReset())
+		pooled.push_back(std::move(arena));
+	arena = Arena();
+}
+
 bool Arena::hasFree(size_t size, const void* address) {
 	if (impl) {
 		allowAccess(impl.getPtr());
@@ -414,7 +489,7 @@ ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 #ifdef ALLOC_INSTRUMENTATION
 			allocInstr["ArenaHugeKB"].alloc((reqSize + 1023) >> 10);
 #endif
-			b = (ArenaBlock*)allocateAndMaybeKeepalive(reqSize);
+			b = (ArenaBlock*)allocateHugeBlock(reqSize);
 			b->tinySize = b->tinyUsed = NOT_TINY;
 			b->bigSize = reqSize;
 			b->totalSizeEstimate = b->bigSize;
@@ -449,6 +524,20 @@ ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 	return b;
 }
 
+void ArenaBlock::reset() {
+	if (secure) {
+		wipeUsed();
+		secure = 0;
+	}
+	if (isTiny()) {
+		tinyUsed = TINY_HEADER;
+	} else {
+		bigUsed = sizeof(ArenaBlock);
+		totalSizeEstimate = bigSize;
+	}
+	makeNoAccess(reinterpret_cast<uint8_t*>(this) + used(), unused());
+}
+
 void ArenaBlock::destroy() {
 	// If the stack never contains more than one item, nothing will be allocated from stackArena.
 	// If stackArena is used, it will always be a linked list, so destroying *it* will not create another arena
@@ -525,7 +614,7 @@ void ArenaBlock::destroyLeaf() {
 			allocInstr["ArenaHugeKB"].dealloc((bigSize + 1023) >> 10);
 #endif
 			g_hugeArenaMemory.fetch_sub(bigSize);
-			freeOrMaybeKeepalive(this);
+			freeHugeBlock(this, bigSize);
 		}
 	}
 }
@@ -799,6 +888,32 @@ TEST_CASE("/flow/Arena/Size") {
 	return Void();
 }
 
+TEST_CASE("/flow/Arena/Pool") {
+	ArenaPool pool(1);
+
+	Arena a = pool.acquire();
+	const void* block = makeString(1000, a).begin();
+	pool.release(std::move(a));
+	ASSERT(pool.getReservedSize() >= 1000);
+	ASSERT_EQ(pool.getPooledCount(), 1);
+
+	// The pooled arena is reset, so allocations start over in the same block
+	Arena b = pool.acquire();
+	ASSERT_EQ(pool.getPooledCount(), 0);
+	ASSERT(b.hasFree(1000, block));
+	ASSERT(makeString(1000, b).begin() == block);
+
+	// Arenas still referenced elsewhere are not reused
+	Arena c = b;
+	pool.release(std::move(b));
+	ASSERT_EQ(pool.getPooledCount(), 0);
+
+	// A fresh arena reserves what recent arenas needed up front
+	Arena d = pool.acquire();
+	ASSERT(d.getSize() >= 1000);
+	return Void();
+}
+
 // Test that x.dependsOn(x) works, and is effectively a no-op.
 TEST_CASE("/flow/Arena/SelfRef") {
 	Arena a(4096);
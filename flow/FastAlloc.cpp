@@ -113,6 +113,20 @@ template <int Size>
 void* FastAllocator<Size>::freelist = nullptr;
 
 std::atomic<int64_t> g_hugeArenaMemory(0);
+std::atomic<int64_t> g_hugePageMagazineMemory(0);
+std::atomic<int64_t> g_hugePageArenaMemory(0);
+
+void* allocateHugePages(size_t size) {
+	ASSERT(size % kHugePageBytes == 0);
+	void* p = aligned_alloc(kHugePageBytes, size);
+	if (!p)
+		platform::outOfMemory();
+#ifdef __linux__
+	// Best effort: without THP support, or with it disabled, this is an ordinary allocation
+	madvise(p, size, MADV_HUGEPAGE);
+#endif
+	return p;
+}
 
 double hugeArenaLastLogged = 0;
 std::map<std::string, std::pair<int, int64_t>> hugeArenaTraces;
@@ -135,6 +149,153 @@ void hugeArenaSample(int size) {
 	}
 }
 
+std::atomic<int> g_allocSamplingRate(0);
+std::atomic<int64_t> g_allocSamplesLive(0);
+
+namespace {
+
+constexpr int kAllocSampleStackDepth = 32;
+constexpr int kAllocSampleShards = 16;
+
+struct AllocSampleStack {
+	std::vector<void*> frames;
+	int64_t liveBytes = 0; // Estimated: each sample stands for sampling rate allocations
+	int64_t liveSamples = 0;
+};
+
+struct AllocSample {
+	uint32_t stack;
+	int64_t bytes;
+};
+
+// Sampled pointers are sharded so that, while anything sampled is live, every release does not contend on one lock.
+// The stacks table is only touched by sampled allocations and their releases.
+struct AllocSampleData {
+	struct Shard {
+		ThreadSpinLock lock;
+		std::unordered_map<void*, AllocSample> samples;
+	};
+	Shard shards[kAllocSampleShards];
+	ThreadSpinLock stacksLock;
+	std::unordered_map<uint32_t, AllocSampleStack> stacks;
+	double lastLogged = 0;
+
+	Shard& shard(void* ptr) { return shards[(reinterpret_cast<uintptr_t>(ptr) >> 4) % kAllocSampleShards]; }
+};
+
+// Never destroyed, since memory may be released after static destructors have run
+AllocSampleData& allocSampleData() {
+	static AllocSampleData* data = new AllocSampleData();
+	return *data;
+}
+
+thread_local int allocSampleCountdown = 0;
+thread_local bool allocSampleEntered = false;
+
+} // namespace
+
+void sampleAllocation(void* ptr, size_t size) {
+	int rate = g_allocSamplingRate.load(std::memory_order_relaxed);
+	if (rate <= 0 || allocSampleEntered)
+		return;
+	// The countdown may be left over from a larger rate
+	if (--allocSampleCountdown > 0 && allocSampleCountdown < rate)
+		return;
+	allocSampleCountdown = rate;
+	allocSampleEntered = true;
+
+	void* frames[kAllocSampleStackDepth];
+	int depth = platform::raw_backtrace(frames, kAllocSampleStackDepth);
+	uint32_t stack = crc32c_append(0xfdbeefdb, reinterpret_cast<uint8_t*>(frames), depth * sizeof(void*));
+	int64_t bytes = int64_t(size) * rate;
+
+	AllocSampleData& data = allocSampleData();
+	{
+		ThreadSpinLockHolder holder(data.stacksLock);
+		auto& s = data.stacks[stack];
+		if (s.frames.empty())
+			s.frames.assign(frames, frames + depth);
+		s.liveBytes += bytes;
+		s.liveSamples++;
+	}
+	{
+		auto& shard = data.shard(ptr);
+		ThreadSpinLockHolder holder(shard.lock);
+		shard.samples[ptr] = AllocSample{ stack, bytes };
+	}
+	g_allocSamplesLive.fetch_add(1, std::memory_order_relaxed);
+	allocSampleEntered = false;
+}
+
+void sampleDeallocation(void* ptr) {
+	if (allocSampleEntered)
+		return;
+	allocSampleEntered = true;
+	AllocSampleData& data = allocSampleData();
+	Optional<AllocSample> sample;
+	{
+		auto& shard = data.shard(ptr);
+		ThreadSpinLockHolder holder(shard.lock);
+		auto it = shard.samples.find(ptr);
+		if (it != shard.samples.end()) {
+			sample = it->second;
+			shard.samples.erase(it);
+		}
+	}
+	if (sample.present()) {
+		g_allocSamplesLive.fetch_sub(1, std::memory_order_relaxed);
+		ThreadSpinLockHolder holder(data.stacksLock);
+		auto& s = data.stacks[sample.get().stack];
+		s.liveBytes -= sample.get().bytes;
+		s.liveSamples--;
+	}
+	allocSampleEntered = false;
+}
+
+// Called periodically by the system monitor: applies ALLOC_SAMPLING_RATE and traces the call stacks holding the most
+// sampled memory. Allocations sampled before the rate changed stay tracked until they are released.
+void logAllocationSamples() {
+	g_allocSamplingRate.store(FLOW_KNOBS->ALLOC_SAMPLING_RATE, std::memory_order_relaxed);
+	AllocSampleData& data = allocSampleData();
+	if (now() - data.lastLogged < FLOW_KNOBS->ALLOC_SAMPLING_LOGGING_INTERVAL ||
+	    (FLOW_KNOBS->ALLOC_SAMPLING_RATE <= 0 && g_allocSamplesLive.load() == 0))
+		return;
+	data.lastLogged = now();
+
+	// Copy out under the lock; tracing allocates, and so may itself be sampled
+	std::vector<AllocSampleStack> stacks;
+	{
+		ThreadSpinLockHolder holder(data.stacksLock);
+		for (auto it = data.stacks.begin(); it != data.stacks.end();) {
+			if (it->second.liveSamples == 0) {
+				it = data.stacks.erase(it);
+			} else {
+				stacks.push_back(it->second);
+				++it;
+			}
+		}
+	}
+	std::sort(stacks.begin(), stacks.end(), [](const AllocSampleStack& a, const AllocSampleStack& b) {
+		return a.liveBytes > b.liveBytes;
+	});
+
+	int64_t totalBytes = 0;
+	for (const auto& s : stacks)
+		totalBytes += s.liveBytes;
+	TraceEvent("AllocationSampling")
+	    .detail("SampleRate", FLOW_KNOBS->ALLOC_SAMPLING_RATE)
+	    .detail("LiveSamples", g_allocSamplesLive.load())
+	    .detail("Stacks", stacks.size())
+	    .detail("EstimatedLiveBytes", totalBytes);
+	for (int i = 0; i < stacks.size() && i < FLOW_KNOBS->ALLOC_SAMPLING_MAX_LOGGED_STACKS; i++) {
+		TraceEvent("AllocationSample")
+		    .detail("Rank", i)
+		    .detail("EstimatedLiveBytes", stacks[i].liveBytes)
+		    .detail("LiveSamples", stacks[i].liveSamples)
+		    .detail("Backtrace", platform::format_backtrace(stacks[i].frames.data(), stacks[i].frames.size()));
+	}
+}
+
 #ifdef ALLOC_INSTRUMENTATION
 INIT_SEG std::map<const char*, AllocInstrInfo> allocInstr;
 INIT_SEG std::unordered_map<int64_t, std::pair<uint32_t, size_t>> memSample;
@@ -420,6 +581,8 @@ void* FastAllocator<Size>::allocate() {
 #if defined(ALLOC_INSTRUMENTATION) || defined(ALLOC_INSTRUMENTATION_STDOUT)
 	recordAllocation(p, Size);
 #endif
+	if (g_allocSamplingRate.load(std::memory_order_relaxed)) [[unlikely]]
+		sampleAllocation(p, Size);
 	return p;
 }
 
@@ -468,6 +631,8 @@ void FastAllocator<Size>::release(void* ptr) {
 #if defined(ALLOC_INSTRUMENTATION) || defined(ALLOC_INSTRUMENTATION_STDOUT)
 	recordDeallocation(ptr);
 #endif
+	if (g_allocSamplesLive.load(std::memory_order_relaxed)) [[unlikely]]
+		sampleDeallocation(ptr);
 }
 
 template <int Size>
@@ -527,6 +692,19 @@ FastAllocator<Size>::ThreadData::ThreadData() {
 	count = 0;
 }
 
+// Links the elements of a new magazine into a free list
+template <int Size>
+void FastAllocator<Size>::initMagazine(void** block) {
+	// void** block = new void*[ magazine_size * PSize ];
+	for (int i = 0; i < magazine_size - 1; i++) {
+		block[i * PSize + 1] = block[i * PSize] = &block[(i + 1) * PSize];
+		check(&block[i * PSize], false);
+	}
+
+	block[(magazine_size - 1) * PSize + 1] = block[(magazine_size - 1) * PSize] = nullptr;
+	check(&block[(magazine_size - 1) * PSize], false);
+}
+
 template <int Size>
 void FastAllocator<Size>::getMagazine() {
 	ThreadData& thr = threadData();
@@ -592,17 +770,30 @@ void FastAllocator<Size>::getMagazine() {
 #else
 	const bool includeGuardPages = true;
 #endif
-	block = (void**)::allocate(magazine_size * Size, /*allowLargePages*/ false, includeGuardPages);
-#endif
-
-	// void** block = new void*[ magazine_size * PSize ];
-	for (int i = 0; i < magazine_size - 1; i++) {
-		block[i * PSize + 1] = block[i * PSize] = &block[(i + 1) * PSize];
-		check(&block[i * PSize], false);
+	if (FLOW_KNOBS && FLOW_KNOBS->FAST_ALLOC_HUGE_PAGES &&
+	    !(includeGuardPages && FLOW_KNOBS->FAST_ALLOC_ALLOW_GUARD_PAGES)) {
+		// A huge page is carved into magazines rather than stranding most of it behind one. The ones this thread does
+		// not take go to the global pool, after their free lists are built here, so they are first touched (and placed
+		// on a NUMA node) by the thread that asked for memory.
+		const int magazines = kHugePageBytes / (magazine_size * Size);
+		uint8_t* page = (uint8_t*)allocateHugePages(kHugePageBytes);
+		for (int m = 1; m < magazines; m++) {
+			initMagazine((void**)(page + m * magazine_size * Size));
+		}
+		EnterCriticalSection(&globalData()->mutex);
+		for (int m = 1; m < magazines; m++) {
+			globalData()->magazines.push_back(page + m * magazine_size * Size);
+		}
+		globalData()->totalMemory.fetch_add((magazines - 1) * magazine_size * Size);
+		LeaveCriticalSection(&globalData()->mutex);
+		g_hugePageMagazineMemory.fetch_add(kHugePageBytes);
+		block = (void**)page;
+	} else {
+		block = (void**)::allocate(magazine_size * Size, /*allowLargePages*/ false, includeGuardPages);
 	}
+#endif
 
-	block[(magazine_size - 1) * PSize + 1] = block[(magazine_size - 1) * PSize] = nullptr;
-	check(&block[(magazine_size - 1) * PSize], false);
+	initMagazine(block);
 	thr.freelist = block;
 	thr.count = magazine_size;
 }
@@ -663,6 +854,23 @@ template class FastAllocator<4096>;
 template class FastAllocator<8192>;
 template class FastAllocator<16384>;
 
+TEST_CASE("/flow/FastAlloc/AllocationSampling") {
+	int rate = g_allocSamplingRate.exchange(1);
+	int64_t live = g_allocSamplesLive.load();
+	uint8_t buffers[2][64];
+	sampleAllocation(buffers[0], sizeof(buffers[0]));
+	sampleAllocation(buffers[1], sizeof(buffers[1]));
+	ASSERT_EQ(g_allocSamplesLive.load(), live + 2);
+	g_allocSamplingRate.store(0);
+	// Releasing an allocation sampled before sampling was disabled still clears it
+	sampleDeallocation(buffers[0]);
+	sampleDeallocation(buffers[1]);
+	sampleDeallocation(buffers[1]);
+	ASSERT_EQ(g_allocSamplesLive.load(), live);
+	g_allocSamplingRate.store(rate);
+	return Void();
+}
+
 #ifdef USE_JEMALLOC
 TEST_CASE("/jemalloc/4k_aligned_usable_size") {
 	void* ptr;
@@ -20,6 +20,8 @@
 
 #include <flow/Histogram.h>
 #include <flow/flow.h>
+#include <flow/OTELMetrics.h>
+#include <flow/TDMetric.actor.h>
 #include <flow/UnitTest.h>
 // TODO: remove dependency on fdbrpc.
 
@@ -106,38 +108,90 @@ void Histogram::writeToLog(double elapsed) {
 		e.detail("Elapsed", elapsed);
 	int totalCount = 0;
 	for (uint32_t i = 0; i < 32; i++) {
-		uint64_t value = uint64_t(1) << (i + 1);
-
 		if (buckets[i]) {
 			totalCount += buckets[i];
-			switch (unit) {
-			case Unit::milliseconds:
-				// value stored in microseconds, so divide by 1000 before writing
-				e.detail(format("LessThan%u.%03u", int(value / 1000), int(value % 1000)), buckets[i]);
-				break;
-			case Unit::bytes:
-			case Unit::bytes_per_second:
-				e.detail(format("LessThan%" PRIu64, value), buckets[i]);
-				break;
-			case Unit::percentageLinear:
-				e.detail(format("LessThan%f", (i + 1) * 0.04), buckets[i]);
-				break;
-			case Unit::countLinear:
-				value = uint64_t((i + 1) * ((upperBound - lowerBound) / 31.0));
-				e.detail(format("LessThan%" PRIu64, value), buckets[i]);
-				break;
-			case Unit::MAXHISTOGRAMUNIT:
+			if (unit == Unit::MAXHISTOGRAMUNIT) {
 				e.detail(format("Default%u", i), buckets[i]);
-				break;
-			default:
-				ASSERT(false);
+			} else {
+				e.detail("LessThan" + bucketUpperBound(i), buckets[i]);
 			}
 		}
 	}
 	e.detail("TotalCount", totalCount);
+	exportMetrics();
+	for (uint32_t i = 0; i < 32; i++) {
+		loggedBuckets[i] += buckets[i];
+	}
 	clear();
 }
 
+std::string Histogram::bucketUpperBound(uint32_t bucket) const {
+	uint64_t value = uint64_t(1) << (bucket + 1);
+	switch (unit) {
+	case Unit::milliseconds:
+		// value stored in microseconds, so divide by 1000 before writing
+		return format("%u.%03u", int(value / 1000), int(value % 1000));
+	case Unit::bytes:
+	case Unit::bytes_per_second:
+		return format("%" PRIu64, value);
+	case Unit::percentageLinear:
+		return format("%f", (bucket + 1) * 0.04);
+	case Unit::countLinear:
+		value = uint64_t((bucket + 1) * ((upperBound - lowerBound) / 31.0));
+		return format("%" PRIu64, value);
+	case Unit::MAXHISTOGRAMUNIT:
+		return format("%u", bucket);
+	default:
+		ASSERT(false);
+		return "";
+	}
+}
+
+// Hands the buckets filled since the last report to the metrics collection, if one is being emitted. For OTLP that is
+// a delta sum with a point per bucket carrying its upper bound as the "le" attribute, and for statsd a counter per
+// bucket.
+void Histogram::exportMetrics() const {
+	MetricCollection* metrics = MetricCollection::getMetricCollection();
+	if (metrics == nullptr) {
+		return;
+	}
+	std::string metricName = group + "." + op;
+	switch (knobToMetricModel(FLOW_KNOBS->METRICS_DATA_MODEL)) {
+	case MetricsDataModel::OTLP: {
+		NetworkAddress addr = g_network->getLocalAddress();
+		std::string ip_str = addr.ip.toString();
+		std::string port_str = std::to_string(addr.port);
+		// Histograms are registered by name, which is therefore enough to tell them apart
+		UID id(std::hash<std::string>()(name()), 0x48697374);
+		OTEL::OTELSum& sum = metrics->sumMap[id];
+		sum.name = metricName;
+		sum.aggregation = OTEL::AGGREGATION_TEMPORALITY_DELTA;
+		for (uint32_t i = 0; i < 32; i++) {
+			if (buckets[i]) {
+				sum.points.emplace_back(static_cast<int64_t>(buckets[i]));
+				sum.points.back().addAttribute("le", bucketUpperBound(i));
+				sum.points.back().addAttribute("unit", UnitToStringMapper[(size_t)unit]);
+				sum.points.back().addAttribute("ip", ip_str);
+				sum.points.back().addAttribute("port", port_str);
+			}
+		}
+		break;
+	}
+	case MetricsDataModel::STATSD: {
+		for (uint32_t i = 0; i < 32; i++) {
+			if (buckets[i]) {
+				metrics->statsd_message.push_back(createStatsdMessage(
+				    metricName + ".le_" + bucketUpperBound(i), StatsDMetric::COUNTER, std::to_string(buckets[i])));
+			}
+		}
+		break;
+	}
+	case MetricsDataModel::NONE:
+	default: {
+	}
+	}
+}
+
 std::string Histogram::drawHistogram() {
 
 	std::stringstream result;
@@ -70,15 +70,26 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( SATURATION_PROFILING_LOG_INTERVAL,                   0.5 ); // A value of 0 means use RUN_LOOP_PROFILING_INTERVAL
 	init( SATURATION_PROFILING_MAX_LOG_INTERVAL,               5.0 );
 	init( SATURATION_PROFILING_LOG_BACKOFF,                    2.0 );
+	init( CONTINUOUS_PROFILING_INTERVAL,                       1.0 ); // A value of 0 disables continuous profiling, which also needs run loop profiling
+	init( CONTINUOUS_PROFILING_LOG_INTERVAL,                  60.0 );
+	init( CONTINUOUS_PROFILING_MAX_STACKS,                    1000 );
+	init( CONTINUOUS_PROFILING_MAX_LOGGED_STACKS,               20 );
 
 	init( FAST_ALLOC_LOGGING_BYTES,                           10e6 );
 	init( FAST_ALLOC_ALLOW_GUARD_PAGES,                      false );
+	init( FAST_ALLOC_HUGE_PAGES,                             false );
+	init( HUGE_PAGE_ARENA_MIN_BYTES,                             0 ); if( randomize && BUGGIFY ) HUGE_PAGE_ARENA_MIN_BYTES = 2<<20;
 	init( HUGE_ARENA_LOGGING_BYTES,                          100e6 );
 	init( HUGE_ARENA_LOGGING_INTERVAL,                         5.0 );
+	init( ALLOC_SAMPLING_RATE,                                   0 ); if( randomize && BUGGIFY ) ALLOC_SAMPLING_RATE = 10000;
+	init( ALLOC_SAMPLING_LOGGING_INTERVAL,                    60.0 ); if( randomize && BUGGIFY ) ALLOC_SAMPLING_LOGGING_INTERVAL = 5.0;
+	init( ALLOC_SAMPLING_MAX_LOGGED_STACKS,                     50 );
 	init( ABORT_ON_FAILURE,                                  false );
 
 	init( MEMORY_USAGE_CHECK_INTERVAL,                         1.0 );
 
+	init( WORKER_POOL_THREADS,                                   4 );
+
 	// Chaos testing - enabled for simulation by default
 	init( ENABLE_CHAOS_FEATURES,                       isSimulated );
 	init( CHAOS_LOGGING_INTERVAL,                              5.0 );
@@ -121,6 +132,8 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( INCOMPATIBLE_PEER_DELAY_BEFORE_LOGGING,              5.0 );
 	init( PING_LOGGING_INTERVAL,                               3.0 );
 	init( PING_SKETCH_ACCURACY,                                0.1 );
+	init( PEER_METRICS_LOGGING_INTERVAL,                       5.0 );
+	init( PEER_METRICS_MAX_PEERS,                               10 ); if( randomize && BUGGIFY ) PEER_METRICS_MAX_PEERS = deterministicRandom()->randomInt(0, 3);
 
 	init( TLS_CERT_REFRESH_DELAY_SECONDS,                 12*60*60 );
 	init( TLS_SERVER_CONNECTION_THROTTLE_TIMEOUT,              9.0 );
@@ -132,6 +145,8 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( TLS_HANDSHAKE_THREAD_STACKSIZE,                64 * 1024 );
 	init( TLS_MALLOC_ARENA_MAX,                                  6 );
 	init( TLS_HANDSHAKE_LIMIT,                                1000 );
+	init( TLS_HANDSHAKE_CONNECT_RESERVE,                       100 ); if( randomize && BUGGIFY ) TLS_HANDSHAKE_CONNECT_RESERVE = deterministicRandom()->randomInt(0, 3);
+	init( TLS_WRITE_COALESCE_BYTES,                          16384 );
 
 	init( NETWORK_TEST_CLIENT_COUNT,                            30 );
 	init( NETWORK_TEST_REPLY_SIZE,                           600e3 );
@@ -157,8 +172,11 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( BUGGIFY_SIM_PAGE_CACHE_64K,                          1e6 );
 	init( BLOB_WORKER_PAGE_CACHE,                            500e6 );
 	init( MAX_EVICT_ATTEMPTS,                                  100 ); if( randomize && BUGGIFY ) MAX_EVICT_ATTEMPTS = 2;
-	init( CACHE_EVICTION_POLICY,                          "random" );
+	init( CACHE_EVICTION_POLICY,                          "random" ); if( randomize && BUGGIFY ) CACHE_EVICTION_POLICY = deterministicRandom()->coinflip() ? "lru" : "clock";
 	init( PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION,                 0.1 ); if( randomize && BUGGIFY ) PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION = 0.0; else if( randomize && BUGGIFY ) PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION = 1.0;
+	init( PAGE_CACHE_READ_AHEAD_PAGES,                           4 ); if( randomize && BUGGIFY ) PAGE_CACHE_READ_AHEAD_PAGES = deterministicRandom()->randomInt(0, 65);
+	init( PAGE_CACHE_READ_AHEAD_AFTER,                           2 ); if( randomize && BUGGIFY ) PAGE_CACHE_READ_AHEAD_AFTER = 0;
+	init( PAGE_CACHE_BYPASS_READ_BYTES,                          0 ); if( randomize && BUGGIFY ) PAGE_CACHE_BYPASS_READ_BYTES = 65536;
 	init( FLOW_CACHEDFILE_WRITE_IO_SIZE,                         0 );
 	if ( randomize && BUGGIFY) {
 		// Choose 16KB to 64KB as I/O size
@@ -172,6 +190,9 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	//AsyncFileEncrypted
 	init( ENCRYPTION_BLOCK_SIZE,                              4096 );
 	init( MAX_DECRYPTED_BLOCKS,                                 10 );
+	init( ENCRYPTION_THREADS,                                    2 ); if( randomize && BUGGIFY ) ENCRYPTION_THREADS = deterministicRandom()->randomInt(0, 5);
+	init( ENCRYPTION_WRITE_BATCH_BLOCKS,                        16 ); if( randomize && BUGGIFY ) ENCRYPTION_WRITE_BATCH_BLOCKS = 1;
+	init( ENCRYPTION_MAX_PENDING_WRITES,                         8 ); if( randomize && BUGGIFY ) ENCRYPTION_MAX_PENDING_WRITES = deterministicRandom()->randomInt(0, 3);
 
 	//AsyncFileKAIO
 	init( MAX_OUTSTANDING,                                      64 );
@@ -181,8 +202,16 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( KAIO_LATENCY_SKETCH_ACCURACY,                       0.01 );
 
 	init( PAGE_WRITE_CHECKSUM_HISTORY,                           0 ); if( randomize && BUGGIFY ) PAGE_WRITE_CHECKSUM_HISTORY = 10000000;
+	init( PAGE_WRITE_CHECKSUM_SAMPLE_PAGES,                      1 ); if( randomize && BUGGIFY ) PAGE_WRITE_CHECKSUM_SAMPLE_PAGES = deterministicRandom()->randomInt(2, 9);
 	init( DISABLE_POSIX_KERNEL_AIO,                              0 );
 
+	//AsyncFileIOUring
+	init( USE_IO_URING,                                          0 );
+	init( IO_URING_QUEUE_DEPTH,                                256 );
+	init( IO_URING_MIN_SUBMIT,                                   0 );
+	init( IO_URING_SQPOLL,                                   false );
+	init( IO_URING_SQPOLL_IDLE_MS,                            1000 );
+
 	//AsyncFileNonDurable
 	init( NON_DURABLE_MAX_WRITE_DELAY,                         2.0 ); if( randomize && BUGGIFY ) NON_DURABLE_MAX_WRITE_DELAY = 5.0;
 	init( MAX_PRIOR_MODIFICATION_DELAY,                        1.0 ); if( randomize && BUGGIFY ) MAX_PRIOR_MODIFICATION_DELAY = 10.0;
@@ -210,6 +239,8 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	//Net2 and FlowTransport
 	init( MIN_COALESCE_DELAY,                                10e-6 ); if( randomize && BUGGIFY ) MIN_COALESCE_DELAY = 0;
 	init( MAX_COALESCE_DELAY,                                20e-6 ); if( randomize && BUGGIFY ) MAX_COALESCE_DELAY = 0;
+	init( ADAPTIVE_COALESCE_MAX_DELAY,                       50e-6 ); if( randomize && BUGGIFY ) ADAPTIVE_COALESCE_MAX_DELAY = 0; // No more than MAX_COALESCE_DELAY disables adapting
+	init( ADAPTIVE_COALESCE_TARGET_BYTES,                    16384 );
 	init( SLOW_LOOP_CUTOFF,                          15.0 / 1000.0 );
 	init( SLOW_LOOP_SAMPLING_RATE,                             0.1 );
 	init( TSC_YIELD_TIME,                                  1000000 );
@@ -223,10 +254,13 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( PACKET_WARNING,                                  2LL<<20 );  // 2MB packet warning quietly allows for 1MB system messages
 	init( TIME_OFFSET_LOGGING_INTERVAL,                       60.0 );
 	init( MAX_PACKET_SEND_BYTES,                        128 * 1024 );
+	init( PEER_PRIORITY_LANE_MIN_PRIORITY,                       0 ); // A value of 0 sends every packet to a peer in order
 	init( MIN_PACKET_BUFFER_BYTES,                        4 * 1024 );
 	init( MIN_PACKET_BUFFER_FREE_BYTES,                        256 );
+	init( REUSE_PACKET_BUFFERS,                               true ); if( randomize && BUGGIFY ) REUSE_PACKET_BUFFERS = false;
 	init( FLOW_TCP_NODELAY,                                      1 );
 	init( FLOW_TCP_QUICKACK,                                     0 );
+	init( FLOW_TCP_BUSY_POLL,                                    0 ); // Microseconds; 0 leaves busy polling to the net.core.busy_read sysctl
 	init( RESOLVE_PREFER_IPV4_ADDR,                          false );  // Default to prefer IPv6 addresses. Set to true to prefer IPv4 addresses.
 
 	//Sim2
@@ -241,6 +275,7 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( MAX_BUGGIFIED_DELAY,                                   0 ); if( randomize && BUGGIFY ) MAX_BUGGIFIED_DELAY =  0.2 * deterministicRandom()->random01();
 	init( MAX_RUNLOOP_SLEEP_DELAY,                               0 );
 	init( SIM_CONNECT_ERROR_MODE, deterministicRandom()->randomInt(0,3) );
+	init( SIM_POOL_THREADS,                                      0 ); // Real threads running pure work pools in simulation; 0 runs them as coroutines
 
 	//Tracefiles
 	init( ZERO_LENGTH_FILE_PAD,                                  1 );
@@ -281,6 +316,17 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( SECOND_REQUEST_MULTIPLIER_DECAY,                 0.00025 );
 	init( SECOND_REQUEST_BUDGET_GROWTH,                       0.05 );
 	init( SECOND_REQUEST_MAX_BUDGET,                         100.0 );
+	init( LOAD_BALANCE_HEDGE_QUANTILE,                        0.95 ); if( randomize && BUGGIFY ) LOAD_BALANCE_HEDGE_QUANTILE = deterministicRandom()->coinflip() ? 0.0 : 0.5; // A second request is sent once the first has taken longer than this quantile of the server's recent latencies; 0 disables it
+	init( LOAD_BALANCE_HEDGE_MIN_SAMPLES,                      100 ); if( randomize && BUGGIFY ) LOAD_BALANCE_HEDGE_MIN_SAMPLES = 10;
+	init( LOAD_BALANCE_HEDGE_WINDOW_SAMPLES,                  1000 ); if( randomize && BUGGIFY ) LOAD_BALANCE_HEDGE_WINDOW_SAMPLES = 100;
+	init( LOAD_BALANCE_HEDGE_SKETCH_ERROR,                    0.05 );
+	init( LOAD_BALANCE_LAGGING_VERSIONS,                   1000000 ); if( randomize && BUGGIFY ) LOAD_BALANCE_LAGGING_VERSIONS = 10000; // A storage server this many versions behind the tlogs gets the full LOAD_BALANCE_LAGGING_PENALTY
+	init( LOAD_BALANCE_LAGGING_PENALTY,                       10.0 ); // In outstanding requests
+	init( LOAD_BALANCE_BUSYNESS_PENALTY,                       4.0 ); if( randomize && BUGGIFY ) LOAD_BALANCE_BUSYNESS_PENALTY = 0.0; // In outstanding requests, for a storage server which is always busy
+	init( LOAD_BALANCE_SERVER_LOAD_EXPIRATION,                 1.0 );
+	init( LOAD_BALANCE_MAX_HEDGE_RATE,                        0.05 ); if( randomize && BUGGIFY ) LOAD_BALANCE_MAX_HEDGE_RATE = 0.5; // The fraction of latency aware requests which may send a second request
+	init( LOAD_BALANCE_ZONE_LOCAL_MAX_OUTSTANDING,            10.0 ); if( randomize && BUGGIFY ) LOAD_BALANCE_ZONE_LOCAL_MAX_OUTSTANDING = 1.0; // In outstanding requests, including load penalties
+	init( LOAD_BALANCE_ZONE_LOCAL_MAX_LATENCY,               0.005 ); if( randomize && BUGGIFY ) LOAD_BALANCE_ZONE_LOCAL_MAX_LATENCY = 0.0005;
 	init( ALTERNATIVES_FAILURE_RESET_TIME,                     5.0 );
 	init( ALTERNATIVES_FAILURE_MIN_DELAY,                     0.05 );
 	init( ALTERNATIVES_FAILURE_DELAY_RATIO,                    0.2 );
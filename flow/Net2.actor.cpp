@@ -78,6 +78,9 @@
 extern "C" intptr_t g_stackYieldLimit;
 intptr_t g_stackYieldLimit = 0;
 
+// What the network thread is running, for the continuous profiler's signal handler: a TaskPriority, or 0 when idle
+volatile int net2SampledPriority = 0;
+
 using namespace boost::asio::ip;
 
 #if defined(__linux__) || defined(__FreeBSD__)
@@ -95,6 +98,12 @@ volatile int net2backtraces_count = 0;
 volatile void** other_backtraces = nullptr;
 sigset_t sigprof_set;
 
+#if defined(__linux__)
+// Filled by the SIGPROF handler with continuous profiler samples, and emptied by the run loop with SIGPROF blocked
+volatile ContinuousProfilingSample net2ContinuousSamples[ContinuousProfilingSample::MAX_PENDING];
+volatile int net2ContinuousSamplesCount = 0;
+#endif
+
 void initProfiling() {
 	net2backtraces = new volatile void*[net2backtraces_max];
 	other_backtraces = new volatile void*[net2backtraces_max];
@@ -120,6 +129,79 @@ namespace N2 { // No indent, it's the whole file
 class Peer;
 class Connection;
 
+// Counts the continuous profiler's samples of the network thread by priority and stack, and periodically logs the
+// busiest stacks as ContinuousProfileStack events, whose counts can be folded into a flame graph
+class ContinuousProfile {
+public:
+	using Stack = std::pair<int, std::vector<void*>>; // The priority, then the frames
+
+	void add(int priority, void* const* frames, int length) {
+		++samples;
+		if (priority == 0) {
+			++idleSamples;
+			return;
+		}
+		Stack stack(priority, std::vector<void*>(frames, frames + length));
+		auto it = counts.find(stack);
+		if (it != counts.end()) {
+			++it->second;
+		} else if (counts.size() < FLOW_KNOBS->CONTINUOUS_PROFILING_MAX_STACKS) {
+			counts.emplace(std::move(stack), 1);
+		} else {
+			++droppedSamples;
+		}
+	}
+
+	// The stacks with the most samples, busiest first
+	std::vector<std::pair<int64_t, const Stack*>> top(int limit) const {
+		std::vector<std::pair<int64_t, const Stack*>> result;
+		result.reserve(counts.size());
+		for (const auto& [stack, count] : counts) {
+			result.emplace_back(count, &stack);
+		}
+		auto end = result.begin() + std::min<size_t>(limit, result.size());
+		std::partial_sort(result.begin(), end, result.end(), [](const auto& a, const auto& b) {
+			return a.first > b.first;
+		});
+		result.erase(end, result.end());
+		return result;
+	}
+
+	int64_t getSamples() const { return samples; }
+	int64_t getIdleSamples() const { return idleSamples; }
+
+	void logIfDue(double now) {
+		if (nextLog == 0) {
+			nextLog = now + FLOW_KNOBS->CONTINUOUS_PROFILING_LOG_INTERVAL;
+		}
+		if (now < nextLog) {
+			return;
+		}
+		TraceEvent("ContinuousProfile")
+		    .detail("Samples", samples)
+		    .detail("IdleSamples", idleSamples)
+		    .detail("DroppedSamples", droppedSamples)
+		    .detail("Stacks", counts.size());
+		for (const auto& [count, stack] : top(FLOW_KNOBS->CONTINUOUS_PROFILING_MAX_LOGGED_STACKS)) {
+			TraceEvent("ContinuousProfileStack")
+			    .detail("Priority", stack->first)
+			    .detail("Samples", count)
+			    .detail("Trace",
+			            platform::format_backtrace(const_cast<void**>(stack->second.data()), stack->second.size()));
+		}
+		counts.clear();
+		samples = idleSamples = droppedSamples = 0;
+		nextLog = now + FLOW_KNOBS->CONTINUOUS_PROFILING_LOG_INTERVAL;
+	}
+
+private:
+	std::map<Stack, int64_t> counts;
+	int64_t samples = 0;
+	int64_t idleSamples = 0;
+	int64_t droppedSamples = 0; // Samples of new stacks seen after CONTINUOUS_PROFILING_MAX_STACKS
+	double nextLog = 0;
+};
+
 // Outlives main
 Net2* g_net2 = nullptr;
 
@@ -180,6 +262,7 @@ public:
 	void setCurrentTask(TaskPriority taskID) override {
 		currentTaskID = taskID;
 		priorityMetric = (int64_t)taskID;
+		net2SampledPriority = static_cast<int>(taskID);
 	}
 	void onMainThread(Promise<Void>&& signal, TaskPriority taskID) override;
 	bool isOnMainThread() const override { return thread_network == this; }
@@ -259,8 +342,9 @@ public:
 	uint64_t numYields;
 
 	NetworkMetrics::PriorityStats* lastPriorityStats;
+	ContinuousProfile continuousProfile;
 
-	struct PromiseTask final : public FastAllocated<PromiseTask> {
+	struct PromiseTask final : public TaskQueueNode, public FastAllocated<PromiseTask> {
 		Promise<Void> promise;
 		swift::Job* _Nullable swiftJob = nullptr;
 		PromiseTask() {}
@@ -351,6 +435,29 @@ static udp::endpoint udpEndpoint(NetworkAddress const& n) {
 	return udp::endpoint(tcpAddress(n.ip), n.port);
 }
 
+// Has reads from the socket that find no data poll the NIC's receive queue for up to FLOW_TCP_BUSY_POLL microseconds
+// before giving up, rather than waiting for an interrupt. This spends CPU to cut latency between hosts on a fast
+// network; the epoll wait of the run loop busy polls too only when the net.core.busy_poll sysctl is also set.
+static void setBusyPoll(tcp::socket& socket, UID id) {
+	if (FLOW_KNOBS->FLOW_TCP_BUSY_POLL <= 0)
+		return;
+#ifdef __linux__
+	boost::system::error_code error;
+	socket.set_option(
+	    boost::asio::detail::socket_option::integer<SOL_SOCKET, SO_BUSY_POLL>(FLOW_KNOBS->FLOW_TCP_BUSY_POLL), error);
+	if (error) {
+		// Values above net.core.busy_read need CAP_NET_ADMIN
+		TraceEvent(SevWarnAlways, "N2_BusyPollError", id)
+		    .suppressFor(60.0)
+		    .detail("BusyPoll", FLOW_KNOBS->FLOW_TCP_BUSY_POLL)
+		    .detail("ErrorCode", error.value())
+		    .detail("Message", error.message());
+	}
+#else
+	TraceEvent(SevWarn, "N2_InitWarn").suppressFor(60.0).detail("Message", "SO_BUSY_POLL not supported");
+#endif
+}
+
 class BindPromise {
 	Promise<Void> p;
 	std::variant<const char*, AuditedEvent> errContext;
@@ -547,6 +654,7 @@ private:
 			TraceEvent(SevWarn, "N2_InitWarn").detail("Message", "TCP_QUICKACK not supported");
 #endif
 		}
+		setBusyPoll(socket, id);
 		platform::setCloseOnExec(socket.native_handle());
 	}
 
@@ -983,6 +1091,8 @@ public:
 			}
 		}
 
+		wait(g_network->networkInfo.acceptHandshakeLock->take());
+		state FlowLock::Releaser acceptReleaser(*g_network->networkInfo.acceptHandshakeLock);
 		wait(g_network->networkInfo.handshakeLock->take());
 		state FlowLock::Releaser releaser(*g_network->networkInfo.handshakeLock);
 
@@ -1133,8 +1243,14 @@ public:
 		boost::system::error_code err;
 		++g_net2->countWrites;
 
-		size_t sent = ssl_sock.write_some(
-		    boost::iterator_range<SendBufferIterator>(SendBufferIterator(data, limit), SendBufferIterator()), err);
+		size_t sent;
+		int coalesced = coalesce(data, limit);
+		if (coalesced) {
+			sent = ssl_sock.write_some(boost::asio::const_buffer(coalesceBuffer.get(), coalesced), err);
+		} else {
+			sent = ssl_sock.write_some(
+			    boost::iterator_range<SendBufferIterator>(SendBufferIterator(data, limit), SendBufferIterator()), err);
+		}
 
 		if (err) {
 			// Since there was an error, sent's value can't be used to infer that the buffer has data and the limit is
@@ -1178,11 +1294,37 @@ private:
 	NetworkAddress peer_address;
 	Reference<ReferencedObject<boost::asio::ssl::context>> sslContext;
 	bool has_trusted_peer;
+	std::unique_ptr<uint8_t[]> coalesceBuffer;
+
+	// An ssl::stream encrypts only the first buffer of a sequence per write_some, so a short remainder at the head of
+	// the chain would go out as a record and a send of its own. In that case this copies up to
+	// TLS_WRITE_COALESCE_BYTES from the head of the chain into coalesceBuffer to be written as one, returning how many
+	// bytes it copied, or 0 when the chain should be written as it is.
+	int coalesce(SendBuffer const* data, int limit) {
+		int capacity = std::min(limit, FLOW_KNOBS->TLS_WRITE_COALESCE_BYTES);
+		while (data && !data->bytes_unsent()) {
+			data = data->next;
+		}
+		if (!data || !data->next || data->bytes_unsent() >= capacity) {
+			return 0;
+		}
+		if (!coalesceBuffer) {
+			coalesceBuffer.reset(new uint8_t[FLOW_KNOBS->TLS_WRITE_COALESCE_BYTES]);
+		}
+		int size = 0;
+		for (; data && size < capacity; data = data->next) {
+			int n = std::min(capacity - size, data->bytes_unsent());
+			memcpy(coalesceBuffer.get() + size, data->data() + data->bytes_sent, n);
+			size += n;
+		}
+		return size;
+	}
 
 	void init() {
 		// Socket settings that have to be set after connect or accept succeeds
 		socket.non_blocking(true);
 		socket.set_option(boost::asio::ip::tcp::no_delay(true));
+		setBusyPoll(socket, id);
 		platform::setCloseOnExec(socket.native_handle());
 	}
 
@@ -1281,7 +1423,7 @@ Net2::Net2(const TLSConfig& tlsConfig, bool useThreadPool, bool useMetrics)
     currentTaskID(TaskPriority::DefaultYield), stopped(false), started(false), numYields(0),
     lastPriorityStats(nullptr) {
 	// Until run() is called, yield() will always yield
-	TraceEvent("Net2Starting").log();
+	TraceEvent("Net2Starting").detail("Reactor", N2::ASIOReactor::backendName());
 
 	// Set the global members
 	if (useMetrics) {
@@ -1497,6 +1639,7 @@ void Net2::run() {
 			tscBegin = timestampCounter();
 			taskBegin = nnow;
 			trackAtPriority(TaskPriority::RunCycleFunction, taskBegin);
+			net2SampledPriority = static_cast<int>(TaskPriority::RunCycleFunction);
 			runFunc();
 			double taskEnd = timer_monotonic();
 			trackAtPriority(TaskPriority::RunLoop, taskEnd);
@@ -1518,6 +1661,7 @@ void Net2::run() {
 				trackAtPriority(TaskPriority::Zero, sleepStart);
 				awakeMetric = false;
 				priorityMetric = 0;
+				net2SampledPriority = 0;
 				reactor.sleep(sleepTime);
 				awakeMetric = true;
 			}
@@ -1526,6 +1670,7 @@ void Net2::run() {
 		tscBegin = timestampCounter();
 		taskBegin = timer_monotonic();
 		trackAtPriority(TaskPriority::ASIOReactor, taskBegin);
+		net2SampledPriority = static_cast<int>(TaskPriority::ASIOReactor);
 		reactor.react();
 		tasksSinceReact = 0;
 
@@ -1556,6 +1701,7 @@ void Net2::run() {
 			++countTasks;
 			currentTaskID = taskQueue.getReadyTaskID();
 			priorityMetric = static_cast<int64_t>(currentTaskID);
+			net2SampledPriority = static_cast<int>(currentTaskID);
 			PromiseTask* task = taskQueue.getReadyTask();
 			taskQueue.popReadyTask();
 
@@ -1568,6 +1714,10 @@ void Net2::run() {
 				TraceEvent(SevError, "TaskError").error(unknown_error());
 			}
 
+			auto& priorityStats = networkInfo.metrics.taskPriorityStats[currentTaskID];
+			priorityStats.cycles += timestampCounter() - tscBegin;
+			++priorityStats.tasks;
+
 			if (currentTaskID < minTaskID) {
 				trackAtPriority(currentTaskID, taskBegin);
 				minTaskID = currentTaskID;
@@ -1597,6 +1747,7 @@ void Net2::run() {
 		}
 
 		trackAtPriority(TaskPriority::RunLoop, taskBegin);
+		net2SampledPriority = static_cast<int>(TaskPriority::RunLoop);
 
 		queueSize = taskQueue.getNumReadyTasks();
 		FDB_TRACE_PROBE(run_loop_done, queueSize);
@@ -1623,8 +1774,19 @@ void Net2::run() {
 			net2backtraces_overflow = false;
 			net2backtraces_count = 0;
 
+			int continuousSamples = net2ContinuousSamplesCount;
+			for (int i = 0; i < continuousSamples; i++) {
+				auto& sample = const_cast<ContinuousProfilingSample&>(net2ContinuousSamples[i]);
+				continuousProfile.add(sample.priority, sample.frames, sample.length);
+			}
+			net2ContinuousSamplesCount = 0;
+
 			pthread_sigmask(SIG_SETMASK, &orig_set, nullptr);
 
+			if (continuousSamples) {
+				continuousProfile.logIfDue(timer_monotonic());
+			}
+
 			if (was_overflow) {
 				TraceEvent("Net2RunLoopProfilerOverflow")
 				    .detail("SignalsReceived", signal_count)
@@ -2156,6 +2318,79 @@ THREAD_HANDLE startThreadF(F&& func) {
 	return g_network->startThread(Thing::start, t);
 }
 
+// Ready tasks must come out by TaskPriority, then in the order they were added, timers included
+TEST_CASE("flow/Net2/TaskQueue/ReadyOrder") {
+	struct Element : TaskQueueNode {
+		TaskPriority priority;
+		int sequence;
+	};
+	static const TaskPriority priorities[] = { TaskPriority::Max,          TaskPriority::RunLoop,
+		                                       TaskPriority::ReadSocket,   TaskPriority::DefaultOnMainThread,
+		                                       TaskPriority::DefaultDelay, TaskPriority::DefaultYield,
+		                                       TaskPriority::Low,          TaskPriority::Zero };
+	TaskQueue<Element> queue;
+	std::vector<std::unique_ptr<Element>> elements;
+	std::set<std::pair<int, int>> expected; // (-priority, sequence) of the tasks that should be ready
+	std::vector<Element*> timers;
+	auto& rand = *deterministicRandom();
+	for (int round = 0; round < 100; round++) {
+		for (int i = rand.randomInt(0, 50); i > 0; i--) {
+			elements.push_back(std::make_unique<Element>());
+			Element* e = elements.back().get();
+			e->priority = priorities[rand.randomInt(0, std::size(priorities))];
+			e->sequence = elements.size();
+			if (rand.coinflip()) {
+				queue.addReady(e->priority, e);
+				expected.emplace(-int(e->priority), e->sequence);
+			} else {
+				queue.addTimer(round, e->priority, e);
+				timers.push_back(e);
+			}
+		}
+		if (rand.coinflip()) {
+			queue.processReadyTimers(round);
+			for (Element* e : timers)
+				expected.emplace(-int(e->priority), e->sequence);
+			timers.clear();
+		}
+		ASSERT_EQ(queue.getNumReadyTasks(), expected.size());
+		for (int i = rand.randomInt(0, expected.size() + 1); i > 0; i--) {
+			ASSERT(queue.hasReadyTask());
+			Element* e = queue.getReadyTask();
+			ASSERT(std::make_pair(-int(e->priority), e->sequence) == *expected.begin());
+			ASSERT(queue.getReadyTaskID() == e->priority);
+			ASSERT_EQ(queue.getReadyTaskPriority() >> 32, int64_t(e->priority) - 1);
+			queue.popReadyTask();
+			expected.erase(expected.begin());
+		}
+	}
+	return Void();
+}
+
+TEST_CASE("flow/Net2/ContinuousProfile/Aggregate") {
+	void* a[] = { (void*)0x10, (void*)0x20 };
+	void* b[] = { (void*)0x10, (void*)0x30 };
+	N2::ContinuousProfile profile;
+	for (int i = 0; i < 3; i++) {
+		profile.add(static_cast<int>(TaskPriority::DefaultEndpoint), b, 2);
+	}
+	profile.add(static_cast<int>(TaskPriority::DefaultEndpoint), a, 2);
+	profile.add(static_cast<int>(TaskPriority::DefaultDelay), b, 2);
+	profile.add(0, a, 2);
+	ASSERT_EQ(profile.getSamples(), 6);
+	ASSERT_EQ(profile.getIdleSamples(), 1);
+
+	// The same stack at another priority is counted apart, and idle samples are not counted as stacks
+	auto top = profile.top(10);
+	ASSERT_EQ(top.size(), 3);
+	ASSERT_EQ(top[0].first, 3);
+	ASSERT(top[0].second->first == static_cast<int>(TaskPriority::DefaultEndpoint));
+	ASSERT(top[0].second->second == std::vector<void*>(b, b + 2));
+	ASSERT_EQ(top[1].first + top[2].first, 2);
+	ASSERT_EQ(profile.top(1).size(), 1);
+	return Void();
+}
+
 TEST_CASE("flow/Net2/ThreadSafeQueue/Interface") {
 	ThreadSafeQueue<int> tq;
 	ASSERT(!tq.pop().present());
@@ -2177,6 +2412,32 @@ TEST_CASE("flow/Net2/ThreadSafeQueue/Interface") {
 	return Void();
 }
 
+TEST_CASE("flow/Net2/IntrusiveThreadSafeQueue/Interface") {
+	struct Element : ThreadSafeQueueNode {
+		int value;
+		explicit Element(int value) : value(value) {}
+	};
+	Element elements[] = { Element(1), Element(2), Element(3) };
+	IntrusiveThreadSafeQueue<Element> tq;
+	ASSERT(tq.pop() == nullptr);
+	ASSERT(tq.canSleep());
+
+	ASSERT(tq.push(&elements[0]) == true);
+	ASSERT(!tq.canSleep());
+	ASSERT(tq.push(&elements[1]) == false);
+
+	ASSERT(tq.pop() == &elements[0]);
+	// A popped element may be pushed again
+	ASSERT(tq.push(&elements[0]) == false);
+	ASSERT(tq.push(&elements[2]) == false);
+	ASSERT(tq.pop() == &elements[1]);
+	ASSERT(tq.pop() == &elements[0]);
+	ASSERT(tq.pop()->value == 3);
+	ASSERT(tq.pop() == nullptr);
+	ASSERT(tq.canSleep());
+	return Void();
+}
+
 // A helper struct used by queueing tests which use multiple threads.
 struct QueueTestThreadState {
 	QueueTestThreadState(int threadId, int toProduce) : threadId(threadId), toProduce(toProduce) {}
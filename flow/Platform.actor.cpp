@@ -2255,6 +2255,121 @@ void setAffinity(int proc) {
 #endif
 }
 
+bool parseCpuList(std::string const& list, std::vector<int>& cpus) {
+	// As many CPUs as a Linux cpu_set_t can hold
+	constexpr int maxCpus = 1024;
+	cpus.clear();
+	std::stringstream ss(list);
+	std::string item;
+	while (std::getline(ss, item, ',')) {
+		int first, last, consumed = 0;
+		if (sscanf(item.c_str(), "%d-%d%n", &first, &last, &consumed) == 2 && consumed == item.size()) {
+		} else if (sscanf(item.c_str(), "%d%n", &first, &consumed) == 1 && consumed == item.size()) {
+			last = first;
+		} else {
+			return false;
+		}
+		if (first < 0 || last < first || last >= maxCpus) {
+			return false;
+		}
+		for (int cpu = first; cpu <= last; cpu++) {
+			cpus.push_back(cpu);
+		}
+	}
+	std::sort(cpus.begin(), cpus.end());
+	cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+	return !cpus.empty();
+}
+
+std::string formatCpuList(std::vector<int> const& cpus) {
+	std::string list;
+	for (int i = 0; i < cpus.size();) {
+		int j = i;
+		while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+			j++;
+		}
+		if (!list.empty()) {
+			list += ",";
+		}
+		list += j == i ? std::to_string(cpus[i]) : format("%d-%d", cpus[i], cpus[j]);
+		i = j + 1;
+	}
+	return list;
+}
+
+std::vector<int> getCpuSiblings(int cpu) {
+	std::vector<int> siblings;
+#ifdef __linux__
+	std::ifstream file(format("/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu));
+	std::string list;
+	std::vector<int> cpus;
+	if (file && std::getline(file, list) && parseCpuList(list, cpus)) {
+		for (int sibling : cpus) {
+			if (sibling != cpu) {
+				siblings.push_back(sibling);
+			}
+		}
+	}
+#endif
+	return siblings;
+}
+
+namespace {
+std::vector<int> networkThreadCpus;
+std::vector<int> helperThreadCpus;
+#ifdef __linux__
+// What startThread() restricts new threads to once setThreadPlacement() is called: the helper CPUs, or if those
+// weren't given, every CPU the process could use before the network thread was pinned
+cpu_set_t startThreadCpus;
+bool startThreadCpusSet = false;
+#endif
+} // namespace
+
+bool setThreadPlacement(std::vector<int> const& networkCpus, std::vector<int> const& helperCpus) {
+#ifdef __linux__
+	// On Linux, a pid of 0 is the calling thread rather than the whole process
+	cpu_set_t allowed;
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) {
+		return false;
+	}
+	cpu_set_t helpers = allowed;
+	if (!helperCpus.empty()) {
+		CPU_ZERO(&helpers);
+		for (int cpu : helperCpus) {
+			if (!CPU_ISSET(cpu, &allowed)) {
+				return false;
+			}
+			CPU_SET(cpu, &helpers);
+		}
+	}
+	if (!networkCpus.empty()) {
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (int cpu : networkCpus) {
+			CPU_SET(cpu, &set);
+		}
+		if (sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+			return false;
+		}
+	}
+	startThreadCpus = helpers;
+	startThreadCpusSet = true;
+	networkThreadCpus = networkCpus;
+	helperThreadCpus = helperCpus;
+	return true;
+#else
+	return networkCpus.empty() && helperCpus.empty();
+#endif
+}
+
+std::vector<int> const& getNetworkThreadCpus() {
+	return networkThreadCpus;
+}
+
+std::vector<int> const& getHelperThreadCpus() {
+	return helperThreadCpus;
+}
+
 namespace platform {
 
 int getRandomSeed() {
@@ -2928,6 +3043,12 @@ THREAD_HANDLE startThread(void* (*func)(void*), void* arg, int stackSize, const
 			TraceEvent(SevWarnAlways, "StartThreadInvalidStackSize").detail("StackSize", stackSize);
 		};
 	}
+#if defined(__linux__)
+	// Threads otherwise inherit the affinity of the thread starting them, which is usually the pinned network thread
+	if (startThreadCpusSet) {
+		pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &startThreadCpus);
+	}
+#endif
 
 	pthread_create(&t, &attr, func, arg);
 	pthread_attr_destroy(&attr);
@@ -3778,11 +3899,18 @@ extern volatile bool net2backtraces_overflow;
 extern volatile int net2backtraces_count;
 extern std::atomic<int64_t> net2RunLoopIterations;
 extern std::atomic<int64_t> net2RunLoopSleeps;
+extern volatile ContinuousProfilingSample net2ContinuousSamples[ContinuousProfilingSample::MAX_PENDING];
+extern volatile int net2ContinuousSamplesCount;
+extern volatile int net2SampledPriority;
 extern void initProfiling();
 
 namespace {
 
 std::atomic<double> checkThreadTime;
+// Why the check thread last signalled the network thread. A SIGPROF with neither set came from elsewhere, and is
+// handled as a run loop sample.
+std::atomic<bool> runLoopSampleRequested = false;
+std::atomic<bool> continuousSampleRequested = false;
 std::mutex loopProfilerThreadMutex;
 std::optional<pthread_t> loopProfilerThread;
 std::atomic<bool> loopProfilerStopRequested = false;
@@ -3832,6 +3960,25 @@ int64_t getNumProfilesCaptured() {
 	}
 }
 
+#ifdef __linux__
+// Async signal safe. Samples beyond those the network thread has room for are dropped.
+static void takeContinuousSample() {
+	if (net2ContinuousSamplesCount >= ContinuousProfilingSample::MAX_PENDING) {
+		return;
+	}
+	ContinuousProfilingSample& sample =
+	    const_cast<ContinuousProfilingSample&>(net2ContinuousSamples[net2ContinuousSamplesCount]);
+	sample.priority = net2SampledPriority;
+#if defined(USE_SANITIZER)
+	// As in profileHandler, calling backtrace may deadlock in sanitizer builds
+	sample.length = 0;
+#else
+	sample.length = backtrace(sample.frames, ContinuousProfilingSample::MAX_FRAMES);
+#endif
+	++net2ContinuousSamplesCount;
+}
+#endif
+
 void profileHandler(int sig) {
 #ifdef __linux__
 	if (chainedAction.sa_handler != SIG_DFL && chainedAction.sa_handler != SIG_IGN &&
@@ -3843,11 +3990,22 @@ void profileHandler(int sig) {
 	// async safe in Linux.
 	if (profileThreadId != syscall(__NR_gettid)) {
 		return;
-	} else if (!profilingEnabled) {
+	}
+
+	bool continuousSample = continuousSampleRequested.exchange(false);
+	bool runLoopSample = runLoopSampleRequested.exchange(false);
+	if (!profilingEnabled) {
 		++numProfilesDisabled;
 		return;
 	}
 
+	if (continuousSample) {
+		takeContinuousSample();
+		if (!runLoopSample) {
+			return;
+		}
+	}
+
 	++net2backtraces_count;
 
 	if (!net2backtraces || net2backtraces_max - net2backtraces_offset < 50) {
@@ -3921,6 +4079,7 @@ void* checkThread(void* arg) {
 
 	double slowTaskLogInterval = minSlowTaskLogInterval;
 	double saturatedLogInterval = minSaturationLogInterval;
+	double lastContinuousSample = 0;
 
 	while (!loopProfilerStopRequested) {
 		threadSleep(FLOW_KNOBS->RUN_LOOP_PROFILING_INTERVAL);
@@ -3953,6 +4112,7 @@ void* checkThread(void* arg) {
 
 				lastSlowTaskSignal = t;
 				checkThreadTime.store(lastSlowTaskSignal);
+				runLoopSampleRequested.store(true);
 				pthread_kill(mainThread, SIGPROF);
 			}
 		} else {
@@ -3975,6 +4135,7 @@ void* checkThread(void* arg) {
 
 				if (!slowTask) {
 					checkThreadTime.store(lastSaturatedSignal);
+					runLoopSampleRequested.store(true);
 					pthread_kill(mainThread, SIGPROF);
 				}
 			}
@@ -3983,6 +4144,15 @@ void* checkThread(void* arg) {
 			lastRunLoopSleeps = currentRunLoopSleeps;
 			saturatedLogInterval = minSaturationLogInterval;
 		}
+
+		if (FLOW_KNOBS->CONTINUOUS_PROFILING_INTERVAL > 0) {
+			double t = timer();
+			if (t - lastContinuousSample >= FLOW_KNOBS->CONTINUOUS_PROFILING_INTERVAL) {
+				lastContinuousSample = t;
+				continuousSampleRequested.store(true);
+				pthread_kill(mainThread, SIGPROF);
+			}
+		}
 	}
 	return nullptr;
 #else
@@ -4449,3 +4619,18 @@ TEST_CASE("/flow/Platform/directoryOps") {
 	ASSERT(errors == 0);
 	return Void();
 }
+
+TEST_CASE("/flow/Platform/cpuList") {
+	std::vector<int> cpus;
+	ASSERT(parseCpuList("0-3,8", cpus) && cpus == std::vector<int>({ 0, 1, 2, 3, 8 }));
+	ASSERT(parseCpuList("8,2,2-3", cpus) && cpus == std::vector<int>({ 2, 3, 8 }));
+	ASSERT(parseCpuList("5", cpus) && cpus == std::vector<int>({ 5 }));
+	for (const char* malformed : { "", "3-1", "1,,2", "1-", "a", "-1", "4096" }) {
+		ASSERT(!parseCpuList(malformed, cpus));
+	}
+
+	ASSERT_EQ(formatCpuList({ 0, 1, 2, 3, 8 }), "0-3,8");
+	ASSERT_EQ(formatCpuList({ 1, 3, 4 }), "1,3-4");
+	ASSERT_EQ(formatCpuList({}), "");
+	return Void();
+}
@@ -118,6 +118,8 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 			    .detail("Memory", currentStats.processMemory)
 			    .detail("ResidentMemory", currentStats.processResidentMemory)
 			    .detail("UnusedAllocatedMemory", getTotalUnusedAllocatedMemory())
+			    .detail("NetworkThreadCPUs", formatCpuList(getNetworkThreadCpus()))
+			    .detail("HelperThreadCPUs", formatCpuList(getHelperThreadCpus()))
 			    .detail("MbpsSent",
 			            ((netData.bytesSent - statState->networkState.bytesSent) * 8e-6) / currentStats.elapsed)
 			    .detail("MbpsReceived",
@@ -198,10 +200,14 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 			    .DETAILALLOCATORMEMUSAGE(8192)
 			    .DETAILALLOCATORMEMUSAGE(16384)
 			    .detail("HugeArenaMemory", g_hugeArenaMemory.load())
+			    .detail("HugePageArenaMemory", g_hugePageArenaMemory.load())
+			    .detail("HugePageMagazineMemory", g_hugePageMagazineMemory.load())
 			    .detail("DCID", machineState.dcId)
 			    .detail("ZoneID", machineState.zoneId)
 			    .detail("MachineID", machineState.machineId);
 
+			logAllocationSamples();
+
 			uint64_t total_memory = 0;
 			total_memory += FastAllocator<16>::getTotalMemory();
 			total_memory += FastAllocator<32>::getTotalMemory();
@@ -291,6 +297,25 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 				n.detail(format("PriorityBusy%d", itr.first).c_str(), itr.second);
 			}
 
+			// PriorityCPUX measures the time spent running tasks at exactly priority X, as counted by the timestamp
+			// counter around each task, and PriorityTasksX how many of them ran. Unlike PriorityBusyX, the time of a
+			// lower priority task is not counted against the higher priority tasks that ran before it.
+			auto& taskPriorityStats = g_network->networkInfo.metrics.taskPriorityStats;
+			uint64_t tscNow = timestampCounter();
+			uint64_t tscBegin = g_network->networkInfo.metrics.taskPriorityStatsBegin;
+			if (tscBegin > 0 && tscNow > tscBegin && currentStats.elapsed > 0) {
+				double secondsPerCycle = currentStats.elapsed / (tscNow - tscBegin);
+				for (auto const& [priority, stats] : taskPriorityStats) {
+					double seconds = stats.cycles * secondsPerCycle;
+					if (seconds / currentStats.elapsed >= FLOW_KNOBS->MIN_LOGGED_PRIORITY_BUSY_FRACTION) {
+						n.detail(format("PriorityCPU%d", priority).c_str(), seconds);
+						n.detail(format("PriorityTasks%d", priority).c_str(), stats.tasks);
+					}
+				}
+			}
+			taskPriorityStats.clear();
+			g_network->networkInfo.metrics.taskPriorityStatsBegin = tscNow;
+
 			bool firstTracker = true;
 			for (auto& itr : g_network->networkInfo.metrics.starvationTrackers) {
 				if (itr.active) {
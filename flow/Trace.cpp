@@ -260,7 +260,7 @@ public:
 		struct WriteBuffer final : TypedAction<WriterThread, WriteBuffer> {
 			std::vector<TraceEventFields> events;
 
-			WriteBuffer(std::vector<TraceEventFields> events) : events(events) {}
+			WriteBuffer(std::vector<TraceEventFields>&& events) : events(std::move(events)) {}
 			double getTimeEstimate() const override { return .001; }
 		};
 		void action(WriteBuffer& a) {
@@ -386,7 +386,8 @@ public:
 		fields.setAnnotated();
 	}
 
-	void writeEvent(TraceEventFields fields, std::string trackLatestKey, bool trackError) {
+	// Takes ownership of fields, which callers on the network thread would otherwise copy once per event
+	void writeEvent(TraceEventFields&& fields, const std::string& trackLatestKey, bool trackError) {
 		MutexHolder hold(mutex);
 
 		annotateEvent(fields);
@@ -403,8 +404,9 @@ public:
 
 		// FIXME: What if we are using way too much memory for buffer?
 		ASSERT(!isOpen() || fields.isAnnotated());
-		eventBuffer.push_back(fields);
 		bufferLength += fields.sizeBytes();
+		eventBuffer.push_back(std::move(fields));
+		const TraceEventFields& event = eventBuffer.back();
 
 		if (g_network && g_network->isSimulated()) {
 			// Throw an error if we have queued up a large number of events in simulation. This makes it easier to
@@ -413,7 +415,7 @@ public:
 			// identify where the process is actually stuck.
 			if (bufferLength > 1e8) {
 				fprintf(stderr, "Trace log buffer overflow\n");
-				fprintf(stderr, "Last event: %s\n", fields.toString().c_str());
+				fprintf(stderr, "Last event: %s\n", event.toString().c_str());
 				// Setting this to 0 avoids a recurse from the assertion trace event and also prevents a situation where
 				// we roll the trace log only to log the single assertion event when using --crash.
 				bufferLength = 0;
@@ -425,10 +427,10 @@ public:
 		}
 
 		if (trackError) {
-			latestEventCache.setLatestError(fields);
+			latestEventCache.setLatestError(event);
 		}
 		if (!trackLatestKey.empty()) {
-			latestEventCache.set(trackLatestKey, fields);
+			latestEventCache.set(trackLatestKey, event);
 		}
 	}
 
@@ -1352,7 +1354,7 @@ void BaseTraceEvent::log() {
 					auto name = fmt::format("TraceEvent::{}", type);
 					ProcessEvents::trigger(StringRef(name), this, success());
 				}
-				g_traceLog.writeEvent(fields, trackingKey, severity > SevWarnAlways);
+				g_traceLog.writeEvent(std::move(fields), trackingKey, severity > SevWarnAlways);
 
 				if (g_traceLog.isOpen()) {
 					// Log Metrics
@@ -1515,21 +1517,21 @@ void TraceBatch::dump() {
 		if (g_network->isSimulated()) {
 			attachBatch[i].fields.addField("Machine", machine);
 		}
-		g_traceLog.writeEvent(attachBatch[i].fields, "", false);
+		g_traceLog.writeEvent(std::move(attachBatch[i].fields), "", false);
 	}
 
 	for (int i = 0; i < eventBatch.size(); i++) {
 		if (g_network->isSimulated()) {
 			eventBatch[i].fields.addField("Machine", machine);
 		}
-		g_traceLog.writeEvent(eventBatch[i].fields, "", false);
+		g_traceLog.writeEvent(std::move(eventBatch[i].fields), "", false);
 	}
 
 	for (int i = 0; i < buggifyBatch.size(); i++) {
 		if (g_network->isSimulated()) {
 			buggifyBatch[i].fields.addField("Machine", machine);
 		}
-		g_traceLog.writeEvent(buggifyBatch[i].fields, "", false);
+		g_traceLog.writeEvent(std::move(buggifyBatch[i].fields), "", false);
 	}
 
 	onMainThreadVoid([]() { g_traceLog.flush(); });
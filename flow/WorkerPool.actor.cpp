@@ -0,0 +1,181 @@
+/*
+ * WorkerPool.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flow/WorkerPool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "flow/Knobs.h"
+#include "flow/ThreadPrimitives.h"
+#include "flow/UnitTest.h"
+#include "flow/actorcompiler.h" // has to be last include
+
+void forceLinkWorkerPoolTests() {}
+
+namespace {
+
+class WorkerPool {
+public:
+	explicit WorkerPool(int threads) {
+		for (int i = 0; i < threads; i++)
+			queues.push_back(std::make_unique<Queue>());
+		for (int i = 0; i < threads; i++)
+			g_network->startThread(start, new Worker{ this, i }, 0, "fdb-worker");
+	}
+
+	void post(WorkerPoolTask* task, TaskPriority priority) {
+		int index = currentWorker >= 0 ? currentWorker : nextQueue.fetch_add(1) % queues.size();
+		{
+			Queue& q = *queues[index];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			q.jobs.push(Job{ static_cast<int>(priority), sequence.fetch_add(1), task });
+		}
+		{
+			// Counted under sleepMutex so that a worker about to sleep cannot miss it
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			pending++;
+		}
+		wake.notify_one();
+	}
+
+private:
+	struct Job {
+		int priority;
+		uint64_t sequence;
+		WorkerPoolTask* task;
+
+		// Highest priority first, then in the order posted
+		bool operator<(const Job& r) const {
+			return priority != r.priority ? priority < r.priority : sequence > r.sequence;
+		}
+	};
+
+	struct alignas(MAX_CACHE_LINE_SIZE) Queue {
+		std::mutex mutex;
+		std::priority_queue<Job> jobs;
+	};
+
+	struct Worker {
+		WorkerPool* pool;
+		int index;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::atomic<uint64_t> sequence{ 0 };
+	std::atomic<uint32_t> nextQueue{ 0 };
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	int64_t pending = 0; // Jobs queued and not yet taken, guarded by sleepMutex
+
+	static thread_local int currentWorker;
+
+	THREAD_FUNC start(void* arg) {
+		std::unique_ptr<Worker> worker(static_cast<Worker*>(arg));
+		currentWorker = worker->index;
+		worker->pool->run(worker->index);
+		THREAD_RETURN;
+	}
+
+	// Takes the best job from our own queue, or else steals one from the first other queue that has any
+	WorkerPoolTask* take(int index) {
+		for (int i = 0; i < queues.size(); i++) {
+			Queue& q = *queues[(index + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(q.mutex);
+			if (!q.jobs.empty()) {
+				WorkerPoolTask* task = q.jobs.top().task;
+				q.jobs.pop();
+				return task;
+			}
+		}
+		return nullptr;
+	}
+
+	void run(int index) {
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				wake.wait(lock, [this] { return pending > 0; });
+				pending--;
+			}
+			// A job is ours to take now, though another worker may have claimed the one counted and left us theirs
+			WorkerPoolTask* task = nullptr;
+			while (!(task = take(index)))
+				std::this_thread::yield();
+			task->run();
+			delete task;
+		}
+	}
+};
+
+thread_local int WorkerPool::currentWorker = -1;
+
+// Created on first use and never destroyed, since its threads run until the process exits
+WorkerPool* workerPool() {
+	static WorkerPool* pool = new WorkerPool(FLOW_KNOBS->WORKER_POOL_THREADS);
+	return pool;
+}
+
+} // namespace
+
+bool workerPoolEnabled() {
+	return !g_network->isSimulated() && FLOW_KNOBS->WORKER_POOL_THREADS > 0;
+}
+
+void postToWorkerPool(WorkerPoolTask* task, TaskPriority priority) {
+	ASSERT(workerPoolEnabled());
+	workerPool()->post(task, priority);
+}
+
+static Future<Void> incrementOnWorkerPool(std::shared_ptr<std::atomic<int>> counter) {
+	return onWorkerPool([counter]() { ++*counter; }, TaskPriority::DefaultYield);
+}
+
+TEST_CASE("/flow/WorkerPool/Offload") {
+	state std::vector<Future<int>> results;
+	for (int i = 0; i < 100; i++) {
+		results.push_back(onWorkerPool([i]() {
+			int sum = 0;
+			for (int j = 0; j <= i; j++)
+				sum += j;
+			return sum;
+		}));
+	}
+	wait(waitForAll(results));
+	for (int i = 0; i < results.size(); i++)
+		ASSERT_EQ(results[i].get(), i * (i + 1) / 2);
+
+	state std::shared_ptr<std::atomic<int>> ran = std::make_shared<std::atomic<int>>(0);
+	wait(incrementOnWorkerPool(ran));
+	ASSERT_EQ(ran->load(), 1);
+
+	try {
+		wait(success(onWorkerPool([]() -> int { throw io_error(); })));
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT_EQ(e.code(), error_code_io_error);
+	}
+	return Void();
+}
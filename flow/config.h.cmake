@@ -1,4 +1,5 @@
 #cmakedefine ALLOC_INSTRUMENTATION
+#cmakedefine FAST_ALLOC_LARGE_OBJECTS
 #cmakedefine NDEBUG
 #cmakedefine FDB_RELEASE
 #ifdef FDB_RELEASE
@@ -31,4 +32,5 @@
 # cmakedefine DTRACE_PROBES
 # cmakedefine HAS_ALIGNED_ALLOC
 # cmakedefine USE_JEMALLOC
+# cmakedefine WITH_LIBURING
 #endif // WIN32
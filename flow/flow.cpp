@@ -112,6 +112,10 @@ void setThreadLocalDeterministicRandomSeed(uint32_t seed) {
 	seededDebugRandom = Reference<IRandom>(new DeterministicRandom(seed));
 }
 
+void setThreadLocalDeterministicRandom(Reference<IRandom> random) {
+	seededRandom = random;
+}
+
 Reference<IRandom> debugRandom() {
 	return seededDebugRandom;
 }
@@ -134,10 +134,35 @@ public:
 
 	bool sameArena(const Arena& other) const { return impl.getPtr() == other.impl.getPtr(); }
 
+	// If nothing else references this Arena and it is a single block, discards everything allocated in it but keeps
+	// the block for further allocations. Otherwise returns false and leaves the Arena as it is.
+	bool tryReset();
+
 private:
+	friend class ArenaPool;
 	Reference<struct ArenaBlock> impl;
 };
 
+// Hands out Arenas for code that repeatedly builds arenas of about the same shape, such as an actor allocating one per
+// request. An Arena given back to release() is reset and handed out again if nothing else still references it;
+// otherwise acquire() reserves a single block of the size recently needed, rather than growing a chain of blocks.
+// Not thread safe.
+class ArenaPool : NonCopyable {
+public:
+	explicit ArenaPool(int maxPooled = 4) : maxPooled(maxPooled) {}
+
+	Arena acquire();
+	void release(Arena&& arena);
+
+	size_t getReservedSize() const { return reservedSize; }
+	int getPooledCount() const { return pooled.size(); }
+
+private:
+	std::vector<Arena> pooled;
+	int maxPooled;
+	size_t reservedSize = 0; // Decaying maximum of the bytes used by released arenas
+};
+
 template <>
 struct scalar_traits<Arena> : std::true_type {
 	constexpr static size_t size = 0;
@@ -204,6 +229,7 @@ struct ArenaBlock : NonCopyable, ThreadSafeReferenceCounted<ArenaBlock> {
 	static void* allocate(Reference<ArenaBlock>& self, int bytes, IsSecureMem isSecure = IsSecureMem::False);
 	// Return an appropriately-sized ArenaBlock to store the given data
 	static ArenaBlock* create(int dataSize, Reference<ArenaBlock>& next);
+	void reset();
 	void destroy();
 	void destroyLeaf();
 	static void* operator new(size_t s) = delete;
@@ -42,6 +42,21 @@ public:
 
 	void wake();
 
+	// Name of the event demultiplexer boost::asio was configured with, reported in the Net2Starting trace event
+	static constexpr const char* backendName() {
+#if defined(BOOST_ASIO_HAS_IO_URING) && defined(BOOST_ASIO_DISABLE_EPOLL)
+		return "io_uring";
+#elif defined(BOOST_ASIO_HAS_EPOLL)
+		return "epoll";
+#elif defined(BOOST_ASIO_HAS_KQUEUE)
+		return "kqueue";
+#elif defined(BOOST_ASIO_HAS_IOCP)
+		return "iocp";
+#else
+		return "select";
+#endif
+	}
+
 	boost::asio::io_service ios;
 	boost::asio::io_service::work
 	    do_not_stop; // Reactor needs to keep running when there is nothing to do until stopped explicitly
@@ -71,6 +86,7 @@ private:
 
 	public:
 		EventFD(ASIOReactor* reactor) : sd(reactor->ios, open()) {}
+		explicit EventFD(boost::asio::io_service& ios) : sd(ios, open()) {}
 		~EventFD() override {
 			sd.close(); // Also closes the fd, I assume...
 		}
@@ -99,6 +115,9 @@ private:
 public:
 	static IEventFD* getEventFD() { return static_cast<IEventFD*>((void*)g_network->global(INetwork::enEventFD)); }
 	static EventFD* newEventFD(ASIOReactor& reactor) { return new EventFD(&reactor); }
+	// Creates an additional eventfd serviced by the given reactor's io_service, for completion sources (such as
+	// io_uring) that must not share the default one with AsyncFileKAIO.
+	static EventFD* newEventFD(boost::asio::io_service& ios) { return new EventFD(ios); }
 #endif
 };
 
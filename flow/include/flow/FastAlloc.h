@@ -167,12 +167,30 @@ private:
 	}
 	static void* freelist;
 
+	static void initMagazine(void** block);
 	static void getMagazine();
 	static void releaseMagazine(void*);
 };
 
 extern std::atomic<int64_t> g_hugeArenaMemory;
 void hugeArenaSample(int size);
+
+inline constexpr size_t kHugePageBytes = 2 << 20;
+// Allocates size bytes, a multiple of kHugePageBytes, aligned to them and advised to be backed by transparent huge
+// pages. The memory is released with free().
+void* allocateHugePages(size_t size);
+extern std::atomic<int64_t> g_hugePageMagazineMemory;
+extern std::atomic<int64_t> g_hugePageArenaMemory;
+
+// Allocation sampling for release binaries. When g_allocSamplingRate is nonzero, one in every that many FastAllocator
+// and huge Arena allocations records its call stack, and the estimated bytes still live per call stack are traced by
+// logAllocationSamples(). The rate follows FLOW_KNOBS->ALLOC_SAMPLING_RATE, so it can be changed at runtime.
+extern std::atomic<int> g_allocSamplingRate;
+extern std::atomic<int64_t> g_allocSamplesLive;
+void sampleAllocation(void* ptr, size_t size);
+void sampleDeallocation(void* ptr);
+void logAllocationSamples();
+
 void releaseAllThreadMagazines();
 int64_t getTotalUnusedAllocatedMemory();
 
@@ -250,6 +268,16 @@ inline constexpr int nextFastAllocatedSize(int x) {
 		return 16384;
 }
 
+// FastAllocated objects and allocateFast() blocks up to this size come from FastAllocator's size classes, and larger
+// ones from the system allocator. With FAST_ALLOC_LARGE_OBJECTS this covers the states of most actors and coroutine
+// frames, which are typically from a few hundred bytes to a few kilobytes, so that spawning an actor per request does
+// not go to malloc.
+#ifdef FAST_ALLOC_LARGE_OBJECTS
+inline constexpr int kMaxFastAllocatedObjectSize = 8192;
+#else
+inline constexpr int kMaxFastAllocatedObjectSize = 256;
+#endif
+
 template <class Object>
 class FastAllocated {
 public:
@@ -258,7 +286,7 @@ public:
 			abort();
 		INSTRUMENT_ALLOCATE(typeid(Object).name());
 
-		if constexpr (sizeof(Object) <= 256) {
+		if constexpr (sizeof(Object) <= kMaxFastAllocatedObjectSize) {
 			void* p = FastAllocator < sizeof(Object) <= 64 ? 64 : nextFastAllocatedSize(sizeof(Object)) > ::allocate();
 			return p;
 		} else {
@@ -270,7 +298,7 @@ public:
 	static void operator delete(void* s) {
 		INSTRUMENT_RELEASE(typeid(Object).name());
 
-		if constexpr (sizeof(Object) <= 256) {
+		if constexpr (sizeof(Object) <= kMaxFastAllocatedObjectSize) {
 			FastAllocator<sizeof(Object) <= 64 ? 64 : nextFastAllocatedSize(sizeof(Object))>::release(s);
 		} else {
 			delete[] reinterpret_cast<uint8_t*>(s);
@@ -294,6 +322,18 @@ public:
 		return FastAllocator<128>::allocate();
 	if (size <= 256)
 		return FastAllocator<256>::allocate();
+	if constexpr (kMaxFastAllocatedObjectSize >= 8192) {
+		if (size <= 512)
+			return FastAllocator<512>::allocate();
+		if (size <= 1024)
+			return FastAllocator<1024>::allocate();
+		if (size <= 2048)
+			return FastAllocator<2048>::allocate();
+		if (size <= 4096)
+			return FastAllocator<4096>::allocate();
+		if (size <= 8192)
+			return FastAllocator<8192>::allocate();
+	}
 	return new uint8_t[size];
 }
 
@@ -310,6 +350,18 @@ inline void freeFast(int size, void* ptr) {
 		return FastAllocator<128>::release(ptr);
 	if (size <= 256)
 		return FastAllocator<256>::release(ptr);
+	if constexpr (kMaxFastAllocatedObjectSize >= 8192) {
+		if (size <= 512)
+			return FastAllocator<512>::release(ptr);
+		if (size <= 1024)
+			return FastAllocator<1024>::release(ptr);
+		if (size <= 2048)
+			return FastAllocator<2048>::release(ptr);
+		if (size <= 4096)
+			return FastAllocator<4096>::release(ptr);
+		if (size <= 8192)
+			return FastAllocator<8192>::release(ptr);
+	}
 	delete[] (uint8_t*)ptr;
 }
 
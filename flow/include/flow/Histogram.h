@@ -39,6 +39,7 @@ public:
 	void registerHistogram(Histogram* h);
 	void unregisterHistogram(Histogram* h);
 	Histogram* lookupHistogram(std::string const& name);
+	std::map<std::string, Histogram*> const& getHistograms() const { return histograms; }
 	void logReport(double elapsed = -1.0);
 	void clear();
 
@@ -164,15 +165,26 @@ public:
 	}
 	void writeToLog(double elapsed = -1.0);
 
+	// The upper bound of a bucket's values, in the histogram's unit, as written to the log
+	std::string bucketUpperBound(uint32_t bucket) const;
+
+	// Samples that ever landed in the bucket, including those already written to the log
+	uint64_t cumulativeCount(uint32_t bucket) const { return loggedBuckets[bucket] + buckets[bucket]; }
+
 	std::string name() const { return generateName(this->group, this->op); }
 
 	std::string drawHistogram();
 
+private:
+	void exportMetrics() const;
+
+public:
 	std::string const group;
 	std::string const op;
 	Unit const unit;
 	Reference<HistogramRegistry> registry;
 	uint32_t buckets[32];
+	uint64_t loggedBuckets[32] = {};
 	uint32_t lowerBound;
 	uint32_t upperBound;
 };
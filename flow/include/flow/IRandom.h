@@ -198,6 +198,9 @@ extern FILE* randLog;
 // Sets the seed for the deterministic random number generator on the current thread
 void setThreadLocalDeterministicRandomSeed(uint32_t seed);
 
+// Replaces the deterministic random number generator on the current thread, leaving debugRandom() as it is
+void setThreadLocalDeterministicRandom(Reference<IRandom> random);
+
 // Returns the random number generator that can be seeded. This generator should only
 // be used in contexts where the choice to call it is deterministic.
 //
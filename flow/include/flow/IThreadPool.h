@@ -83,6 +83,8 @@ template <class T>
 class ThreadReturnPromise : NonCopyable {
 public:
 	ThreadReturnPromise() {}
+	// Results sent from another thread are delivered to the g_network thread at the given priority
+	explicit ThreadReturnPromise(TaskPriority mainThreadPriority) : mainThreadPriority(mainThreadPriority) {}
 	~ThreadReturnPromise() {
 		if (promise.isValid())
 			sendError(broken_promise());
@@ -98,20 +100,21 @@ public:
 		tagAndForward(&promise, t, signal.getFuture());
 		g_network->onMainThread(std::move(signal),
 		                        g_network->isOnMainThread() ? incrementPriorityIfEven(g_network->getCurrentTask())
-		                                                    : TaskPriority::DefaultOnMainThread);
+		                                                    : mainThreadPriority);
 	}
 	void sendError(Error e) { // Can be called safely from another thread.  Call send or sendError at most once.
 		Promise<Void> signal;
 		tagAndForwardError(&promise, e, signal.getFuture());
 		g_network->onMainThread(std::move(signal),
 		                        g_network->isOnMainThread() ? incrementPriorityIfEven(g_network->getCurrentTask())
-		                                                    : TaskPriority::DefaultOnMainThread);
+		                                                    : mainThreadPriority);
 	}
 	bool isValid() const { return promise.isValid(); }
 	bool canBeSet() const { return promise.canBeSet(); }
 
 private:
 	Promise<T> promise;
+	TaskPriority mainThreadPriority = TaskPriority::DefaultOnMainThread;
 };
 
 template <class T>
@@ -131,12 +131,19 @@ public:
 
 	double FAST_ALLOC_LOGGING_BYTES;
 	bool FAST_ALLOC_ALLOW_GUARD_PAGES;
+	bool FAST_ALLOC_HUGE_PAGES; // Back FastAllocator magazines with transparent huge pages
+	int64_t HUGE_PAGE_ARENA_MIN_BYTES; // Arena blocks this large are backed by transparent huge pages, 0 to disable
 	double HUGE_ARENA_LOGGING_BYTES;
 	double HUGE_ARENA_LOGGING_INTERVAL;
+	int ALLOC_SAMPLING_RATE; // One in this many FastAllocator and huge Arena allocations is sampled, 0 to disable
+	double ALLOC_SAMPLING_LOGGING_INTERVAL;
+	int ALLOC_SAMPLING_MAX_LOGGED_STACKS;
 	// This setting allows to let the fdbserver abort instead of exit to generate coredumps
 	// in case of a failure.
 	bool ABORT_ON_FAILURE;
 
+	int WORKER_POOL_THREADS; // Threads for onWorkerPool() work, 0 to run it on the network thread
+
 	double MEMORY_USAGE_CHECK_INTERVAL;
 
 	// Chaos testing
@@ -166,6 +173,10 @@ public:
 	double SATURATION_PROFILING_LOG_INTERVAL;
 	double SATURATION_PROFILING_MAX_LOG_INTERVAL;
 	double SATURATION_PROFILING_LOG_BACKOFF;
+	double CONTINUOUS_PROFILING_INTERVAL; // Seconds between the network thread samples logged as ContinuousProfileStack
+	double CONTINUOUS_PROFILING_LOG_INTERVAL;
+	int CONTINUOUS_PROFILING_MAX_STACKS;
+	int CONTINUOUS_PROFILING_MAX_LOGGED_STACKS;
 
 	// connectionMonitor
 	double CONNECTION_MONITOR_LOOP_TIME;
@@ -187,6 +198,8 @@ public:
 	double INCOMPATIBLE_PEER_DELAY_BEFORE_LOGGING;
 	double PING_LOGGING_INTERVAL;
 	double PING_SKETCH_ACCURACY;
+	double PEER_METRICS_LOGGING_INTERVAL;
+	int PEER_METRICS_MAX_PEERS; // The most peers, those with the slowest pings, in each PeerNetworkMetrics event
 
 	int TLS_CERT_REFRESH_DELAY_SECONDS;
 	double TLS_SERVER_CONNECTION_THROTTLE_TIMEOUT;
@@ -198,6 +211,8 @@ public:
 	int TLS_HANDSHAKE_THREAD_STACKSIZE;
 	int TLS_MALLOC_ARENA_MAX;
 	int TLS_HANDSHAKE_LIMIT;
+	int TLS_HANDSHAKE_CONNECT_RESERVE;
+	int TLS_WRITE_COALESCE_BYTES; // Largest TLS write assembled from several send buffers, 0 to disable
 
 	int NETWORK_TEST_CLIENT_COUNT;
 	int NETWORK_TEST_REPLY_SIZE;
@@ -222,9 +237,12 @@ public:
 	int64_t BUGGIFY_SIM_PAGE_CACHE_4K;
 	int64_t BUGGIFY_SIM_PAGE_CACHE_64K;
 	int64_t BLOB_WORKER_PAGE_CACHE;
-	std::string CACHE_EVICTION_POLICY; // for now, "random", "lru", are supported
+	std::string CACHE_EVICTION_POLICY; // for now, "random", "lru" and "clock" are supported
 	int MAX_EVICT_ATTEMPTS;
 	double PAGE_CACHE_TRUNCATE_LOOKUP_FRACTION;
+	int PAGE_CACHE_READ_AHEAD_PAGES; // pages read in past the end of a sequential read, 0 disables read-ahead
+	int PAGE_CACHE_READ_AHEAD_AFTER; // back to back sequential reads of a file before reading ahead of them
+	int64_t PAGE_CACHE_BYPASS_READ_BYTES; // aligned reads this large skip the page cache, 0 never skips it
 	double TOO_MANY_CONNECTIONS_CLOSED_RESET_DELAY;
 	int TOO_MANY_CONNECTIONS_CLOSED_TIMEOUT;
 	int PEER_UNAVAILABLE_FOR_LONG_TIME_TIMEOUT;
@@ -237,6 +255,9 @@ public:
 	// AsyncFileEncrypted
 	int ENCRYPTION_BLOCK_SIZE;
 	int MAX_DECRYPTED_BLOCKS;
+	int ENCRYPTION_THREADS; // threads encrypting the blocks of all encrypted files, 0 encrypts on the network thread
+	int ENCRYPTION_WRITE_BATCH_BLOCKS; // most whole blocks of a write encrypted and written together
+	int ENCRYPTION_MAX_PENDING_WRITES; // block writes in flight before a write waits for the oldest
 
 	// AsyncFileKAIO
 	int MAX_OUTSTANDING;
@@ -246,8 +267,16 @@ public:
 	double KAIO_LATENCY_SKETCH_ACCURACY;
 
 	int PAGE_WRITE_CHECKSUM_HISTORY;
+	int PAGE_WRITE_CHECKSUM_SAMPLE_PAGES; // one in this many written pages gets a checksum history entry
 	int DISABLE_POSIX_KERNEL_AIO;
 
+	// AsyncFileIOUring, only available when built WITH_LIBURING
+	int USE_IO_URING; // 0: disabled, 1: only files opened with OPEN_IO_URING, 2: all unbuffered files instead of KAIO
+	int IO_URING_QUEUE_DEPTH;
+	int IO_URING_MIN_SUBMIT;
+	bool IO_URING_SQPOLL;
+	int IO_URING_SQPOLL_IDLE_MS;
+
 	// AsyncFileNonDurable
 	double NON_DURABLE_MAX_WRITE_DELAY;
 	double MAX_PRIOR_MODIFICATION_DELAY;
@@ -275,6 +304,8 @@ public:
 	// Net2
 	double MIN_COALESCE_DELAY;
 	double MAX_COALESCE_DELAY;
+	double ADAPTIVE_COALESCE_MAX_DELAY;
+	int ADAPTIVE_COALESCE_TARGET_BYTES;
 	double SLOW_LOOP_CUTOFF;
 	double SLOW_LOOP_SAMPLING_RATE;
 	int64_t TSC_YIELD_TIME;
@@ -289,10 +320,13 @@ public:
 	int64_t PACKET_WARNING; // 2MB packet warning quietly allows for 1MB system messages
 	double TIME_OFFSET_LOGGING_INTERVAL;
 	int MAX_PACKET_SEND_BYTES;
+	int PEER_PRIORITY_LANE_MIN_PRIORITY; // Packets sent at this TaskPriority or higher may overtake lower priority ones
 	int MIN_PACKET_BUFFER_BYTES;
 	int MIN_PACKET_BUFFER_FREE_BYTES;
+	bool REUSE_PACKET_BUFFERS;
 	int FLOW_TCP_NODELAY;
 	int FLOW_TCP_QUICKACK;
+	int FLOW_TCP_BUSY_POLL;
 	bool RESOLVE_PREFER_IPV4_ADDR;
 
 	// Sim2
@@ -308,6 +342,7 @@ public:
 	double MAX_BUGGIFIED_DELAY;
 	double MAX_RUNLOOP_SLEEP_DELAY;
 	int SIM_CONNECT_ERROR_MODE;
+	int SIM_POOL_THREADS;
 	double SIM_SPEEDUP_AFTER_SECONDS;
 	int MAX_TRACE_LINES;
 
@@ -348,6 +383,19 @@ public:
 	double SECOND_REQUEST_MULTIPLIER_DECAY;
 	double SECOND_REQUEST_BUDGET_GROWTH;
 	double SECOND_REQUEST_MAX_BUDGET;
+	double LOAD_BALANCE_HEDGE_QUANTILE;
+	int LOAD_BALANCE_HEDGE_MIN_SAMPLES;
+	int LOAD_BALANCE_HEDGE_WINDOW_SAMPLES;
+	double LOAD_BALANCE_HEDGE_SKETCH_ERROR;
+	double LOAD_BALANCE_MAX_HEDGE_RATE;
+	int64_t LOAD_BALANCE_LAGGING_VERSIONS;
+	double LOAD_BALANCE_LAGGING_PENALTY;
+	double LOAD_BALANCE_BUSYNESS_PENALTY;
+	double LOAD_BALANCE_SERVER_LOAD_EXPIRATION;
+	// A replica in the client's own zone, when the client prefers those, stops being the only choice while it has more
+	// than this many of the client's requests outstanding or answers slower than this many seconds
+	double LOAD_BALANCE_ZONE_LOCAL_MAX_OUTSTANDING;
+	double LOAD_BALANCE_ZONE_LOCAL_MAX_LATENCY;
 	double ALTERNATIVES_FAILURE_RESET_TIME;
 	double ALTERNATIVES_FAILURE_MIN_DELAY;
 	double ALTERNATIVES_FAILURE_DELAY_RATIO;
@@ -73,6 +73,14 @@ public:
 			unsent_last = last;
 	}
 
+	// The bytes waiting to be sent, found by walking the queue
+	int64_t unsentBytes() const {
+		int64_t bytes = 0;
+		for (SendBuffer* b = unsent_first; b; b = b->next)
+			bytes += b->bytes_unsent();
+		return bytes;
+	}
+
 	// false if there is anything unsent
 	bool empty() const { return !unsent_first || unsent_first->bytes_sent == unsent_first->bytes_written; }
 
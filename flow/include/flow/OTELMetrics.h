@@ -115,6 +115,8 @@ public:
 	OTELGauge() {}
 	OTELGauge(const std::string& n) : name{ n } {}
 	OTELGauge(const std::string& n, double v) : name{ n } { points.emplace_back(v); }
+	// Estimated the same way as for OTELSum
+	uint32_t getMsgpackBytes() const { return name.size() + 4 + points.size() * NumberDataPoint::MsgpackBytes; }
 };
 
 class HistogramDataPoint {
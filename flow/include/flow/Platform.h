@@ -315,6 +315,22 @@ void* allocate(size_t length, bool allowLargePages, bool includeGuardPages);
 
 void setAffinity(int proc);
 
+// Parses a list of CPUs as taken by taskset(1), such as "0-3,8", into the sorted CPU numbers. Returns false if it is
+// malformed.
+bool parseCpuList(std::string const& list, std::vector<int>& cpus);
+std::string formatCpuList(std::vector<int> const& cpus);
+
+// Returns the other hardware threads on the same core as cpu, or nothing if the platform doesn't report them
+std::vector<int> getCpuSiblings(int cpu);
+
+// Pins the calling thread, which should be the network thread, to networkCpus, and restricts the threads startThread()
+// starts from then on, such as the storage engines' and TLS handshake thread pools, to helperCpus. Threads those start
+// in turn, like RocksDB's background threads, inherit the restriction. Either may be empty to leave the threads
+// unrestricted. Returns false if the placement could not be applied on this platform.
+bool setThreadPlacement(std::vector<int> const& networkCpus, std::vector<int> const& helperCpus);
+std::vector<int> const& getNetworkThreadCpus();
+std::vector<int> const& getHelperThreadCpus();
+
 void threadSleep(double seconds);
 
 void threadYield(); // Attempt to yield to other processes or threads
@@ -481,6 +497,14 @@ typedef struct {
 	void* frames[];
 } ProfilingSample;
 
+// A stack taken by the continuous profiler along with the priority the network thread was running at, 0 when idle
+struct ContinuousProfilingSample {
+	enum { MAX_FRAMES = 32, MAX_PENDING = 64 };
+	int priority;
+	int length;
+	void* frames[MAX_FRAMES];
+};
+
 dev_t getDeviceId(std::string path);
 #endif
 
@@ -22,15 +22,24 @@
 #define FLOW_TASK_QUEUE_H
 #pragma once
 
+#include <bit>
 #include <queue>
 #include <vector>
+#include "flow/Deque.h"
 #include "flow/TDMetric.actor.h"
 #include "flow/network.h"
 #include "flow/ThreadSafeQueue.h"
 
+// Tasks added to a TaskQueue from other threads are linked into it through this base, so addReadyThreadSafe() doesn't
+// allocate.
+struct TaskQueueNode : ThreadSafeQueueNode {
+	TaskPriority threadReadyTaskID = TaskPriority::DefaultYield;
+};
+
 template <typename Task>
 // A queue of ordered tasks, both ready to execute, and delayed for later execution.
 // All functions must be called on the main thread, except for addReadyThreadSafe() which can be called from any thread.
+// Task must derive from TaskQueueNode.
 class TaskQueue {
 public:
 	TaskQueue() : tasksIssued(0), ready(FLOW_KNOBS->READY_QUEUE_RESERVED_SIZE) {}
@@ -48,7 +57,8 @@ public:
 			processThreadReady();
 			addReady(taskID, t);
 		} else {
-			if (threadReady.push(std::make_pair(taskID, t)))
+			t->threadReadyTaskID = taskID;
+			if (threadReady.push(t))
 				return true;
 		}
 		return false;
@@ -88,11 +98,10 @@ public:
 	void processThreadReady() {
 		[[maybe_unused]] int numReady = 0;
 		while (true) {
-			Optional<std::pair<TaskPriority, Task*>> t = threadReady.pop();
-			if (!t.present())
+			Task* t = threadReady.pop();
+			if (!t)
 				break;
-			ASSERT(t.get().second != nullptr);
-			addReady(t.get().first, t.get().second);
+			addReady(t->threadReadyTaskID, t);
 			++numReady;
 		}
 		FDB_TRACE_PROBE(run_loop_thread_ready, numReady);
@@ -112,8 +121,7 @@ public:
 	}
 
 	void clear() {
-		decltype(ready) _1;
-		ready.swap(_1);
+		ready.clear();
 		decltype(timers) _2;
 		timers.swap(_2);
 	}
@@ -135,12 +143,101 @@ private:
 		bool operator<(DelayedTask const& rhs) const { return at > rhs.at; } // Ordering is reversed for priority_queue
 	};
 
-	template <class T>
-	class ReadyQueue : public std::priority_queue<T, std::vector<T>> {
+	// Tasks ready to run, in the order of a priority_queue of OrderedTask: by TaskPriority, then first in first out.
+	// Each TaskPriority below kBucketedPriorities has its own FIFO, and a two level bitmap finds the highest nonempty
+	// one, so pushing and popping a task doesn't cost a heap operation. Higher priorities, such as TaskPriority::Max,
+	// are rare and go on a heap, which is always served first.
+	class ReadyQueue {
 	public:
-		typedef typename std::priority_queue<T, std::vector<T>>::size_type size_type;
-		ReadyQueue(size_type capacity = 0) { reserve(capacity); };
-		void reserve(size_type capacity) { this->c.reserve(capacity); }
+		explicit ReadyQueue(size_t capacity = 0) : bucketOf(kBucketedPriorities, -1) { overflow.reserve(capacity); }
+
+		void push(OrderedTask const& t) {
+			++count;
+			int p = static_cast<int>(t.taskID);
+			if (p < 0 || p >= kBucketedPriorities) {
+				overflow.push(t);
+				return;
+			}
+			int& b = bucketOf[p];
+			if (b < 0) {
+				b = buckets.size();
+				buckets.emplace_back();
+			}
+			Deque<OrderedTask>& q = buckets[b];
+			q.push_back(t);
+			// Timers keep the FIFO priority they were given when added, so a timer may belong ahead of newer tasks
+			for (int i = q.size() - 1; i > 0 && q[i - 1].priority < q[i].priority; i--)
+				std::swap(q[i - 1], q[i]);
+			if (q.size() == 1) {
+				words[p / 64] |= uint64_t(1) << (p % 64);
+				summary[p / 4096] |= uint64_t(1) << (p / 64 % 64);
+				topPriority = std::max(topPriority, p);
+			}
+		}
+
+		OrderedTask const& top() const {
+			if (!overflow.empty())
+				return overflow.top();
+			return buckets[bucketOf[topPriority]].front();
+		}
+
+		void pop() {
+			--count;
+			if (!overflow.empty()) {
+				overflow.pop();
+				return;
+			}
+			Deque<OrderedTask>& q = buckets[bucketOf[topPriority]];
+			q.pop_front();
+			if (q.empty()) {
+				int p = topPriority;
+				words[p / 64] &= ~(uint64_t(1) << (p % 64));
+				if (!words[p / 64])
+					summary[p / 4096] &= ~(uint64_t(1) << (p / 64 % 64));
+				topPriority = highestBucket();
+			}
+		}
+
+		bool empty() const { return count == 0; }
+		size_t size() const { return count; }
+
+		void clear() {
+			for (auto& q : buckets)
+				q.clear();
+			std::fill(std::begin(words), std::end(words), 0);
+			std::fill(std::begin(summary), std::end(summary), 0);
+			topPriority = -1;
+			decltype(overflow) empty;
+			overflow.swap(empty);
+			count = 0;
+		}
+
+	private:
+		static constexpr int kBucketedPriorities = 1 << 15;
+
+		class Heap : public std::priority_queue<OrderedTask, std::vector<OrderedTask>> {
+		public:
+			void reserve(size_t capacity) { this->c.reserve(capacity); }
+		};
+
+		// -1 if there are no bucketed tasks
+		int highestBucket() const {
+			for (int s = std::size(summary) - 1; s >= 0; s--) {
+				if (summary[s]) {
+					int w = s * 64 + std::bit_width(summary[s]) - 1;
+					return w * 64 + std::bit_width(words[w]) - 1;
+				}
+			}
+			return -1;
+		}
+
+		std::vector<int> bucketOf; // Index in buckets of each priority's FIFO, or -1 before its first task
+		std::vector<Deque<OrderedTask>> buckets;
+		uint64_t words[kBucketedPriorities / 64] = {}; // Bit p is set iff priority p has tasks
+		uint64_t summary[kBucketedPriorities / 4096] = {}; // Bit w is set iff words[w] is nonzero
+		int topPriority = -1; // Highest priority with bucketed tasks
+		Heap overflow;
+		size_t count = 0;
 	};
 
 	// Returns a unique priority value for a task which preserves FIFO ordering
@@ -148,8 +245,8 @@ private:
 	int64_t getFIFOPriority(TaskPriority taskId) { return (int64_t(taskId) << 32) - (++tasksIssued); }
 	uint64_t tasksIssued;
 
-	ReadyQueue<OrderedTask> ready;
-	ThreadSafeQueue<std::pair<TaskPriority, Task*>> threadReady;
+	ReadyQueue ready;
+	IntrusiveThreadSafeQueue<Task> threadReady;
 
 	std::priority_queue<DelayedTask, std::vector<DelayedTask>> timers;
 
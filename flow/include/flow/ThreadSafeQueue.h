@@ -10,6 +10,8 @@
 // the consumer thread to block when the queue is empty with a minimum of overhead.  A caller
 // can ignore this facility by simply not calling canSleep and ignoring the return value of push().
 
+// IntrusiveThreadSafeQueue<T> links the pushed elements themselves rather than copying them into allocated nodes.
+
 // Based in part on the queue at
 // http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue which is covered by this
 // BSD license:
@@ -44,18 +46,18 @@ interpreted as representing official policies, either expressed or implied, of D
 #include <drd.h>
 #endif
 
+// The link which an element of an IntrusiveThreadSafeQueue must inherit.
+struct ThreadSafeQueueNode {
+	std::atomic<ThreadSafeQueueNode*> next;
+	ThreadSafeQueueNode() : next(nullptr) {}
+};
+
+// T must derive from ThreadSafeQueueNode.  The queue doesn't own its elements, and an element may be in at most one
+// queue at a time.
 template <class T>
-class ThreadSafeQueue : NonCopyable {
-	struct BaseNode {
-		std::atomic<BaseNode*> next;
-		BaseNode() : next(nullptr) {}
-	};
+class IntrusiveThreadSafeQueue : NonCopyable {
+	typedef ThreadSafeQueueNode BaseNode;
 
-	struct Node : BaseNode, FastAllocated<Node> {
-		T data;
-		Node(T const& data) : data(data) {}
-		Node(T&& data) : data(std::move(data)) {}
-	};
 	std::atomic<BaseNode*> head;
 	BaseNode* tail;
 	BaseNode stub, sleeping;
@@ -120,7 +122,7 @@ class ThreadSafeQueue : NonCopyable {
 	}
 
 public:
-	ThreadSafeQueue() {
+	IntrusiveThreadSafeQueue() {
 #if VALGRIND
 		ANNOTATE_HAPPENS_AFTER(&this->head);
 #endif
@@ -128,17 +130,9 @@ public:
 		this->tail = &this->stub;
 		this->sleepy = false;
 	}
-	~ThreadSafeQueue() {
-		while (pop().present())
-			;
-	}
 
 	// If push() returns true, the consumer may be sleeping and should be woken
-	template <class U>
-	bool push(U&& data) {
-		Node* n = new Node(std::forward<U>(data));
-		return pushNode(n) == &sleeping;
-	}
+	bool push(T* element) { return pushNode(element) == &sleeping; }
 
 	///////////// The below functions may only be called by a single, consumer thread //////////////////
 
@@ -166,7 +160,8 @@ public:
 		return ok;
 	}
 
-	Optional<T> pop() {
+	// Returns nullptr if the queue is empty
+	T* pop() {
 		BaseNode* b = popNode();
 		if (b == &sleeping) {
 			sleepy = false;
@@ -176,10 +171,40 @@ public:
 			ASSERT(false);
 		if (b == &stub)
 			ASSERT(false);
-		if (!b)
-			return Optional<T>();
+		return static_cast<T*>(b);
+	}
+};
+
+template <class T>
+class ThreadSafeQueue : NonCopyable {
+	struct Node : ThreadSafeQueueNode, FastAllocated<Node> {
+		T data;
+		Node(T const& data) : data(data) {}
+		Node(T&& data) : data(std::move(data)) {}
+	};
+	IntrusiveThreadSafeQueue<Node> queue;
+
+public:
+	~ThreadSafeQueue() {
+		while (pop().present())
+			;
+	}
 
-		Node* n = (Node*)b;
+	// If push() returns true, the consumer may be sleeping and should be woken
+	template <class U>
+	bool push(U&& data) {
+		return queue.push(new Node(std::forward<U>(data)));
+	}
+
+	///////////// The below functions may only be called by a single, consumer thread //////////////////
+
+	// If canSleep returns true, then the queue is empty and the next push() will return true
+	bool canSleep() { return queue.canSleep(); }
+
+	Optional<T> pop() {
+		Node* n = queue.pop();
+		if (!n)
+			return Optional<T>();
 		T data = std::move(n->data);
 		delete n;
 		return Optional<T>(std::move(data));
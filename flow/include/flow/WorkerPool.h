@@ -0,0 +1,105 @@
+/*
+ * WorkerPool.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_WORKERPOOL_H
+#define FLOW_WORKERPOOL_H
+#pragma once
+
+#include <type_traits>
+
+#include "flow/flow.h"
+#include "flow/genericactors.actor.h"
+#include "flow/IThreadPool.h"
+
+// The worker pool is a process-wide set of FLOW_KNOBS->WORKER_POOL_THREADS threads for CPU-heavy work, such as
+// encryption, compression or checksums, that would otherwise stall the network thread. Unlike an IThreadPool it is
+// shared by every role in the process and needs no receiver: onWorkerPool(fn) runs fn on some worker and returns its
+// result on the network thread.
+//
+// Each worker has its own queue, ordered by TaskPriority so that higher priority work goes first, and idle workers
+// steal from the others' queues. Work posted from a worker goes on that worker's queue. In simulation, or with no
+// worker threads, fn runs on the network thread instead, at the given priority.
+
+class WorkerPoolTask {
+public:
+	virtual ~WorkerPoolTask() = default;
+	virtual void run() = 0;
+};
+
+// True when onWorkerPool() work runs on worker threads rather than on the network thread
+bool workerPoolEnabled();
+
+// Queues task, which is deleted after it has run, on the worker pool. Requires workerPoolEnabled().
+void postToWorkerPool(WorkerPoolTask* task, TaskPriority priority);
+
+namespace detail {
+
+template <class Fn>
+using WorkerPoolResult = std::conditional_t<std::is_void_v<std::invoke_result_t<Fn&>>, Void, std::invoke_result_t<Fn&>>;
+
+template <class Fn>
+WorkerPoolResult<Fn> invokeForWorkerPool(Fn& fn) {
+	if constexpr (std::is_void_v<std::invoke_result_t<Fn&>>) {
+		fn();
+		return Void();
+	} else {
+		return fn();
+	}
+}
+
+template <class Fn>
+class WorkerPoolCall final : public WorkerPoolTask {
+public:
+	WorkerPoolCall(Fn&& fn, TaskPriority priority) : fn(std::move(fn)), result(priority) {}
+
+	Future<WorkerPoolResult<Fn>> getFuture() const { return result.getFuture(); }
+
+	void run() override {
+		try {
+			result.send(invokeForWorkerPool(fn));
+		} catch (Error& e) {
+			result.sendError(e);
+		} catch (...) {
+			result.sendError(unknown_error());
+		}
+	}
+
+private:
+	Fn fn;
+	ThreadReturnPromise<WorkerPoolResult<Fn>> result;
+};
+
+} // namespace detail
+
+// Runs fn on the worker pool and returns its result, or Void if it returns nothing, on the network thread at the given
+// priority. fn must not touch network thread state: it should own, or only read, everything it uses, since the caller
+// may be cancelled while it runs. Errors thrown by fn are returned through the future.
+template <class Fn>
+Future<detail::WorkerPoolResult<Fn>> onWorkerPool(Fn fn, TaskPriority priority = TaskPriority::DefaultOnMainThread) {
+	if (!workerPoolEnabled()) {
+		return map(delay(0, priority), [fn = std::move(fn)](Void) mutable { return detail::invokeForWorkerPool(fn); });
+	}
+	auto call = new detail::WorkerPoolCall<Fn>(std::move(fn), priority);
+	auto result = call->getFuture();
+	postToWorkerPool(call, priority);
+	return result;
+}
+
+#endif
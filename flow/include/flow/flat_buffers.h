@@ -688,11 +688,19 @@ void for_each(F&& f, Members&&... members) {
 struct VTableSet {
 	// Precondition: vtable is in offsets
 	int getOffset(const VTable* vtable) const {
-		return std::lower_bound(offsets.begin(), offsets.end(), std::make_pair(vtable, -1))->second;
+		// Consecutive tables are mostly of the same type, e.g. the elements of a vector, and are looked up once for
+		// sizing and again for writing, so remember the last lookup. VTableSets are thread local.
+		if (vtable != lastVTable) {
+			lastOffset = std::lower_bound(offsets.begin(), offsets.end(), std::make_pair(vtable, -1))->second;
+			lastVTable = vtable;
+		}
+		return lastOffset;
 	}
 	// Sorted map
 	std::vector<std::pair<const VTable*, int>> offsets;
 	std::vector<uint8_t> packed_tables;
+	mutable const VTable* lastVTable = nullptr;
+	mutable int lastOffset = 0;
 };
 
 template <class Context>
@@ -79,6 +79,15 @@ struct NetworkMetrics {
 
 	static const std::vector<int> starvationBins;
 
+	// Network thread time spent running tasks at each priority, in timestamp counter cycles, and how many of them ran.
+	// Reset each time they are logged.
+	struct TaskPriorityStats {
+		uint64_t cycles = 0;
+		uint64_t tasks = 0;
+	};
+	std::unordered_map<TaskPriority, TaskPriorityStats> taskPriorityStats;
+	uint64_t taskPriorityStatsBegin = 0; // timestamp counter when taskPriorityStats were last reset
+
 	NetworkMetrics()
 	  : lastRunLoopBusyness(0), networkBusyness(0),
 	    starvationTrackerNetworkBusyness(PriorityStats(static_cast<TaskPriority>(starvationBins.at(0)))) {
@@ -99,6 +108,8 @@ struct NetworkMetrics {
 		networkBusyness = rhs.networkBusyness.load();
 		starvationTrackers = rhs.starvationTrackers;
 		starvationTrackerNetworkBusyness = rhs.starvationTrackerNetworkBusyness;
+		taskPriorityStats = rhs.taskPriorityStats;
+		taskPriorityStatsBegin = rhs.taskPriorityStatsBegin;
 		return *this;
 	}
 };
@@ -113,6 +124,9 @@ struct NetworkInfo {
 
 	std::map<std::pair<IPAddress, uint16_t>, std::pair<int, double>> serverTLSConnectionThrottler;
 	FlowLock* handshakeLock;
+	// Taken before handshakeLock by accepted connections only, so that a storm of incoming handshakes cannot hold the
+	// permits reserved for the connections this process makes itself
+	FlowLock* acceptHandshakeLock;
 
 	NetworkInfo();
 	~NetworkInfo();
@@ -447,7 +447,11 @@ TEST_CASE("/flow/network/ipV6Preferred") {
 	return Void();
 }
 
-NetworkInfo::NetworkInfo() : handshakeLock(new FlowLock(FLOW_KNOBS->TLS_HANDSHAKE_LIMIT)) {}
+NetworkInfo::NetworkInfo()
+  : handshakeLock(new FlowLock(FLOW_KNOBS->TLS_HANDSHAKE_LIMIT)),
+    acceptHandshakeLock(new FlowLock(
+        std::max(1, FLOW_KNOBS->TLS_HANDSHAKE_LIMIT - FLOW_KNOBS->TLS_HANDSHAKE_CONNECT_RESERVE))) {}
 NetworkInfo::~NetworkInfo() {
+	delete acceptHandshakeLock;
 	delete handshakeLock;
 }
@@ -142,6 +142,7 @@ static void bench_serialize_deltas(benchmark::State& state) {
 	int targetBytes = state.range(0);
 	int chunkSize = state.range(1);
 	bool enableEncryption = state.range(2);
+	bool columnar = state.range(3);
 
 	Standalone<GranuleDeltas> delta = deltaGen.getDelta(targetBytes);
 	KeyRange range = deltaGen.getRange();
@@ -156,13 +157,57 @@ static void bench_serialize_deltas(benchmark::State& state) {
 
 	uint32_t serializedBytes = 0;
 	for (auto _ : state) {
-		Value serialized = serializeChunkedDeltaFile(fileName, delta, range, chunkSize, compressFilter, cipherKeysCtx);
+		Value serialized =
+		    serializeChunkedDeltaFile(fileName, delta, range, chunkSize, compressFilter, cipherKeysCtx, columnar);
 		serializedBytes += serialized.size();
 	}
 	state.SetBytesProcessed(static_cast<long>(state.iterations()) * targetBytes);
 	state.counters["serialized_bytes"] = serializedBytes;
 }
 
+// Benchmark reading the deltas back, split by version into range(1) delta files, and merging them, without a snapshot
+static void bench_materialize_deltas(benchmark::State& state) {
+	int targetBytes = state.range(0);
+	int fileCount = state.range(1);
+	bool columnar = state.range(2);
+
+	Standalone<GranuleDeltas> delta = deltaGen.getDelta(targetBytes);
+	KeyRange range = deltaGen.getRange();
+
+	Standalone<BlobGranuleChunkRef> chunk;
+	std::vector<Value> files;
+	std::vector<StringRef> fileData;
+	int perFile = (delta.size() + fileCount - 1) / fileCount;
+	for (int begin = 0; begin < delta.size(); begin += perFile) {
+		Standalone<GranuleDeltas> fileDeltas;
+		fileDeltas.arena().dependsOn(delta.arena());
+		for (int i = begin; i < std::min<int>(begin + perFile, delta.size()); i++) {
+			fileDeltas.push_back(fileDeltas.arena(), delta[i]);
+		}
+		files.push_back(serializeChunkedDeltaFile(
+		    "testdelta"_sr, fileDeltas, range, 32 * 1024, Optional<CompressionFilter>(), {}, columnar));
+		fileData.push_back(files.back());
+		chunk.deltaFiles.emplace_back_deep(chunk.arena(),
+		                                   "testdelta" + std::to_string(files.size()),
+		                                   0,
+		                                   files.back().size(),
+		                                   files.back().size(),
+		                                   fileDeltas.back().version);
+	}
+	chunk.keyRange = range;
+	chunk.includedVersion = delta.back().version;
+
+	int64_t outputRows = 0;
+	for (auto _ : state) {
+		GranuleMaterializeStats stats;
+		RangeResult result =
+		    materializeBlobGranule(chunk, range, 0, chunk.includedVersion, Optional<StringRef>(), fileData, stats);
+		outputRows += result.size();
+	}
+	state.SetBytesProcessed(static_cast<long>(state.iterations()) * targetBytes);
+	state.counters["output_rows"] = outputRows;
+}
+
 // Benchmark sorting deltas
 static void bench_sort_deltas(benchmark::State& state) {
 	int targetBytes = state.range(0);
@@ -177,12 +222,23 @@ static void bench_sort_deltas(benchmark::State& state) {
 
 // Benchmark serialization for granule deltas 128KB, 512KB and 1024KB. Chunk size 32KB
 BENCHMARK(bench_serialize_deltas)
-    ->Args({ 128 * 1024, 32 * 1024, false })
-    ->Args({ 512 * 1024, 32 * 1024, false })
-    ->Args({ 1024 * 1024, 32 * 1024, false })
-    ->Args({ 128 * 1024, 32 * 1024, true })
-    ->Args({ 512 * 1024, 32 * 1024, true })
-    ->Args({ 1024 * 1024, 32 * 1024, true });
+    ->ArgNames({ "bytes", "chunk", "encryption", "columnar" })
+    ->Args({ 128 * 1024, 32 * 1024, false, false })
+    ->Args({ 512 * 1024, 32 * 1024, false, false })
+    ->Args({ 1024 * 1024, 32 * 1024, false, false })
+    ->Args({ 128 * 1024, 32 * 1024, true, false })
+    ->Args({ 512 * 1024, 32 * 1024, true, false })
+    ->Args({ 1024 * 1024, 32 * 1024, true, false })
+    ->Args({ 1024 * 1024, 32 * 1024, false, true })
+    ->Args({ 1024 * 1024, 32 * 1024, true, true });
+
+// Benchmark materializing 1024KB of deltas from one file and from many, in each format
+BENCHMARK(bench_materialize_deltas)
+    ->ArgNames({ "bytes", "files", "columnar" })
+    ->Args({ 1024 * 1024, 1, false })
+    ->Args({ 1024 * 1024, 1, true })
+    ->Args({ 1024 * 1024, 16, false })
+    ->Args({ 1024 * 1024, 16, true });
 
 // Benchmark sorting for granule deltas 128KB, 512KB and 1024KB. Chunk size 32KB
 BENCHMARK(bench_sort_deltas)->Args({ 128 * 1024 })->Args({ 512 * 1024 })->Args({ 1024 * 1024 });
\ No newline at end of file
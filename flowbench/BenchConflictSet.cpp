@@ -0,0 +1,117 @@
+/*
+ * BenchConflictSet.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbserver/ConflictSet.h"
+
+enum class ConflictHistoryType {
+	SkipList,
+	Compressed,
+};
+
+namespace {
+
+// Tuple-like keys under a handful of tables, so neighbouring keys share long prefixes as they do in practice. One
+// percent of the rows receive half of the accesses.
+KeyRef makeKey(Arena& arena, int rows) {
+	const int table = deterministicRandom()->randomInt(0, 8);
+	const int row = deterministicRandom()->coinflip() ? deterministicRandom()->randomInt(0, std::max(rows / 100, 1))
+	                                                  : deterministicRandom()->randomInt(0, rows);
+	return KeyRef(arena, format("app/tenant%02d/table/%08d/row", table, row));
+}
+
+KeyRangeRef makeRange(Arena& arena, int rows) {
+	KeyRef begin = makeKey(arena, rows);
+	// Mostly point accesses, with the occasional short scan
+	if (deterministicRandom()->random01() < 0.9)
+		return KeyRangeRef(begin, keyAfter(begin, arena));
+	KeyRef end = makeKey(arena, rows);
+	return begin < end ? KeyRangeRef(begin, end) : KeyRangeRef(begin, keyAfter(begin, arena));
+}
+
+std::vector<CommitTransactionRef> makeBatch(Arena& arena, int transactions, int rows, Version readVersion) {
+	std::vector<CommitTransactionRef> trs(transactions);
+	for (auto& tr : trs) {
+		for (int i = 0; i < 4; i++)
+			tr.read_conflict_ranges.push_back(arena, makeRange(arena, rows));
+		for (int i = 0; i < 2; i++)
+			tr.write_conflict_ranges.push_back(arena, makeRange(arena, rows));
+		tr.read_snapshot = readVersion;
+	}
+	return trs;
+}
+
+} // namespace
+
+// Resolves batches of transactions against a history holding the last `window` batches of writes, i.e. the MVCC
+// window MAX_WRITE_TRANSACTION_LIFE_VERSIONS keeps alive, and reports the memory the history settles at.
+template <ConflictHistoryType type>
+static void bench_conflict_set(benchmark::State& state) {
+	const int window = state.range(0);
+	const int transactions = 1000;
+	const int rows = 10000000;
+
+	ConflictSet* cs = newConflictSet(1, type == ConflictHistoryType::Compressed);
+	Version version = 0;
+	auto resolve = [&](const std::vector<CommitTransactionRef>& trs) {
+		Version oldest = std::max<Version>(0, version - window);
+		ConflictBatch batch(cs);
+		for (const auto& tr : trs)
+			batch.addTransaction(tr, oldest);
+		std::vector<int> nonConflicting;
+		batch.detectConflicts(version, oldest, nonConflicting);
+		benchmark::DoNotOptimize(nonConflicting);
+		version++;
+	};
+
+	// Fill the window before measuring
+	for (int i = 0; i < window; i++) {
+		Arena arena;
+		resolve(makeBatch(arena, transactions, rows, std::max<Version>(0, version - 1)));
+	}
+
+	const int batchCount = 64;
+	Arena arena;
+	std::vector<std::vector<CommitTransactionRef>> batches;
+	for (int i = 0; i < batchCount; i++)
+		batches.push_back(makeBatch(arena, transactions, rows, 0));
+
+	int next = 0;
+	for (auto _ : state) {
+		auto& trs = batches[next++ % batchCount];
+		for (auto& tr : trs)
+			tr.read_snapshot = std::max<Version>(0, version - 1);
+		resolve(trs);
+	}
+
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * transactions);
+	state.counters["HistoryBytes"] = getConflictSetBytes(cs);
+	destroyConflictSet(cs);
+}
+
+BENCHMARK_TEMPLATE(bench_conflict_set, ConflictHistoryType::SkipList)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_conflict_set, ConflictHistoryType::Compressed)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->ReportAggregatesOnly(true);
@@ -0,0 +1,201 @@
+/*
+ * BenchDeltaTree.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbserver/DeltaTree.h"
+#include "flowbench/GlobalData.h"
+
+namespace {
+
+// A key which DeltaTree2 stores as the suffix it does not share with its base, as Redwood stores its records. The
+// records themselves are defined with the pager, so this keeps just the part that matters for searching a page.
+struct KeyRecord {
+	KeyRecord() {}
+	explicit KeyRecord(KeyRef key) : key(key) {}
+	KeyRecord(Arena& arena, const KeyRecord& toCopy) : key(arena, toCopy.key) {}
+
+	typedef KeyRecord Partial;
+
+#pragma pack(push, 1)
+	struct Delta {
+		uint16_t prefixLen;
+		uint16_t suffixLen;
+		uint8_t flags;
+
+		enum { PREFIX_SOURCE = 1, DELETED = 2 };
+
+		uint8_t* suffix() { return (uint8_t*)(this + 1); }
+
+		KeyRecord apply(const Partial& cache) { return cache; }
+
+		KeyRecord apply(Arena& arena, const KeyRecord& base, Optional<Partial>& cache) {
+			uint8_t* key = new (arena) uint8_t[prefixLen + suffixLen];
+			memcpy(key, base.key.begin(), prefixLen);
+			memcpy(key + prefixLen, suffix(), suffixLen);
+			cache = KeyRecord(KeyRef(key, prefixLen + suffixLen));
+			return cache.get();
+		}
+
+		void setPrefixSource(bool val) { flags = val ? (flags | PREFIX_SOURCE) : (flags & ~PREFIX_SOURCE); }
+		bool getPrefixSource() const { return flags & PREFIX_SOURCE; }
+		void setDeleted(bool val) { flags = val ? (flags | DELETED) : (flags & ~DELETED); }
+		bool getDeleted() const { return flags & DELETED; }
+
+		int size() const { return sizeof(Delta) + suffixLen; }
+
+		std::string toString() const {
+			return format("DELTA{prefixLen=%d suffixLen=%d flags=%d}", prefixLen, suffixLen, flags);
+		}
+	};
+#pragma pack(pop)
+
+	void updateCache(Optional<Partial>& cache, Arena& arena) const { cache = KeyRecord(arena, *this); }
+
+	int getCommonPrefixLen(const KeyRecord& other, int skip = 0) const {
+		return commonPrefixLength(key, other.key, std::min({ skip, key.size(), other.key.size() }));
+	}
+
+	int compare(const KeyRecord& rhs, int skip = 0) const {
+		return key.compareSuffix(rhs.key, std::min({ skip, key.size(), rhs.key.size() }));
+	}
+
+	bool operator<(const KeyRecord& rhs) const { return compare(rhs) < 0; }
+
+	uint64_t getSearchWord(int skipLen) const {
+		uint64_t word = 0;
+		if (key.size() > skipLen) {
+			memcpy(&word, key.begin() + skipLen, std::min<int>(key.size() - skipLen, sizeof(word)));
+		}
+		return bigEndian64(word);
+	}
+
+	int deltaSize(const KeyRecord& base, int skipLen, bool worstcase) const {
+		return sizeof(Delta) + key.size() - (worstcase ? 0 : getCommonPrefixLen(base, skipLen));
+	}
+
+	int writeDelta(Delta& d, const KeyRecord& base, int commonPrefix = -1) const {
+		if (commonPrefix < 0) {
+			commonPrefix = getCommonPrefixLen(base, 0);
+		}
+		d.prefixLen = commonPrefix;
+		d.suffixLen = key.size() - commonPrefix;
+		d.flags = 0;
+		memcpy(d.suffix(), key.begin() + commonPrefix, d.suffixLen);
+		return d.size();
+	}
+
+	std::string toString() const { return key.printable(); }
+
+	KeyRef key;
+};
+
+typedef DeltaTree2<KeyRecord> KeyTree;
+
+// One page's worth of records: size consecutive keys out of a much larger keyspace, bounded by the keys on either side
+// of the page
+struct DeltaTreeFixture {
+	Standalone<VectorRef<KeyRef>> allKeys;
+	std::vector<KeyRecord> records;
+	KeyRecord lowerBound, upperBound;
+	std::vector<uint8_t> buffer;
+
+	explicit DeltaTreeFixture(int size) : allKeys(getSortedTupleKeys(size * 64)) {
+		const int begin = deterministicRandom()->randomInt(1, allKeys.size() - size - 1);
+		for (int i = begin; i < begin + size; i++)
+			records.emplace_back(allKeys[i]);
+		lowerBound = KeyRecord(allKeys[begin - 1]);
+		upperBound = KeyRecord(allKeys[begin + size]);
+
+		int bytes = sizeof(KeyTree);
+		for (const auto& r : records)
+			bytes += KeyTree::Node::headerSize(true) + r.deltaSize(lowerBound, 0, true);
+		// Room for rewriting records, as inserts do
+		buffer.resize(bytes * 2);
+		build();
+	}
+
+	KeyTree* tree() { return (KeyTree*)buffer.data(); }
+
+	void build() {
+		tree()->build(buffer.size(), &records.front(), &records.back() + 1, &lowerBound, &upperBound);
+	}
+
+	const KeyRecord& randomRecord() const { return records[deterministicRandom()->randomInt(0, records.size())]; }
+
+	KeyTree::Cursor cursor() {
+		return KeyTree::Cursor(makeReference<KeyTree::DecodeCache>(lowerBound, upperBound), tree());
+	}
+};
+
+} // namespace
+
+static void bench_delta_tree_build(benchmark::State& state) {
+	DeltaTreeFixture f(state.range(0));
+	for (auto _ : state) {
+		f.build();
+		benchmark::DoNotOptimize(f.tree()->size());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * f.records.size());
+	state.counters["BytesPerRecord"] = (double)f.tree()->size() / f.records.size();
+}
+
+// Point lookups in a page which has already been decoded by earlier lookups, with or without the search index
+template <bool indexed>
+static void bench_delta_tree_seek(benchmark::State& state) {
+	DeltaTreeFixture f(state.range(0));
+	KeyTree::Cursor c = f.cursor();
+	if (indexed) {
+		c.buildSearchIndex();
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(c.seekLessThanOrEqual(f.randomRecord()));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// Decodes a whole page in order, as a range read across it does
+static void bench_delta_tree_scan(benchmark::State& state) {
+	DeltaTreeFixture f(state.range(0));
+	for (auto _ : state) {
+		KeyTree::Cursor c = f.cursor();
+		for (c.moveFirst(); c.valid(); c.moveNext())
+			benchmark::DoNotOptimize(c.get().key);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * f.records.size());
+}
+
+// Deletes and restores records in place, as updates to a page do before it is rebuilt
+static void bench_delta_tree_erase_insert(benchmark::State& state) {
+	DeltaTreeFixture f(state.range(0));
+	KeyTree::Cursor c = f.cursor();
+	for (auto _ : state) {
+		const KeyRecord& r = f.randomRecord();
+		c.erase(r);
+		c.insert(r);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK(bench_delta_tree_build)->RangeMultiplier(4)->Range(16, 1024)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_delta_tree_seek, false)->RangeMultiplier(4)->Range(16, 1024)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_delta_tree_seek, true)->RangeMultiplier(4)->Range(16, 1024)->ReportAggregatesOnly(true);
+BENCHMARK(bench_delta_tree_scan)->RangeMultiplier(4)->Range(16, 1024)->ReportAggregatesOnly(true);
+BENCHMARK(bench_delta_tree_erase_insert)->RangeMultiplier(4)->Range(16, 1024)->ReportAggregatesOnly(true);
@@ -0,0 +1,75 @@
+/*
+ * BenchEndpointMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbrpc/EndpointMap.h"
+#include "flow/IRandom.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+struct NullReceiver final : NetworkMessageReceiver {
+	void receive(ArenaObjectReader&) override {}
+	bool isPublic() const override { return false; }
+};
+
+} // namespace
+
+// Looks up endpoints in random order, the way messages for many endpoints arrive, in a map of 2^range(0) endpoints.
+// With range(1) set, the entry for each token is prefetched one message ahead, as scanPackets does while it checksums.
+static void bench_endpoint_map_dispatch(benchmark::State& state) {
+	const int count = 1 << state.range(0);
+	const bool prefetch = state.range(1);
+	EndpointMap endpoints(0);
+	NullReceiver receiver;
+	std::vector<Endpoint::Token> tokens;
+	tokens.reserve(count);
+	for (int i = 0; i < count; i++) {
+		Endpoint::Token token = deterministicRandom()->randomUniqueID();
+		endpoints.insert(&receiver, token, TaskPriority::DefaultEndpoint);
+		tokens.push_back(token);
+	}
+	deterministicRandom()->randomShuffle(tokens);
+
+	int next = 0;
+	for (auto _ : state) {
+		const Endpoint::Token& token = tokens[next];
+		next = next + 1 < count ? next + 1 : 0;
+		if (prefetch)
+			endpoints.prefetch(tokens[next].second());
+		benchmark::DoNotOptimize(endpoints.getPriority(token));
+		benchmark::DoNotOptimize(endpoints.get(token));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK(bench_endpoint_map_dispatch)
+    ->Args({ 10, false })
+    ->Args({ 10, true })
+    ->Args({ 14, false })
+    ->Args({ 14, true })
+    ->Args({ 18, false })
+    ->Args({ 18, true })
+    ->Args({ 20, false })
+    ->Args({ 20, true })
+    ->ReportAggregatesOnly(true);
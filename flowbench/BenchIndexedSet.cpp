@@ -0,0 +1,88 @@
+/*
+ * BenchIndexedSet.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "flow/IndexedSet.h"
+#include "flowbench/GlobalData.h"
+
+namespace {
+
+// The storage server's byte sample: sampled keys with their sizes, summed over ranges to estimate shard sizes
+struct ByteSampleFixture {
+	Standalone<VectorRef<KeyRef>> keys;
+	IndexedSet<Key, int64_t> sample;
+
+	explicit ByteSampleFixture(int size) : keys(getSortedTupleKeys(size)) {
+		for (const auto& k : keys)
+			sample.insert(k, deterministicRandom()->randomInt(100, 10000));
+	}
+
+	const KeyRef& randomKey() const { return keys[deterministicRandom()->randomInt(0, keys.size())]; }
+};
+
+} // namespace
+
+// Replaces samples as writes change the sizes of keys
+static void bench_indexed_set_insert_erase(benchmark::State& state) {
+	ByteSampleFixture f(state.range(0));
+	for (auto _ : state) {
+		const KeyRef& k = f.randomKey();
+		f.sample.erase(k);
+		f.sample.insert(k, deterministicRandom()->randomInt(100, 10000));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_indexed_set_find(benchmark::State& state) {
+	ByteSampleFixture f(state.range(0));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(f.sample.find(f.randomKey()));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// Estimates the size of a random range, as for shard and read sampling metrics
+static void bench_indexed_set_sum_range(benchmark::State& state) {
+	ByteSampleFixture f(state.range(0));
+	for (auto _ : state) {
+		KeyRef begin = f.randomKey();
+		KeyRef end = f.randomKey();
+		if (end < begin)
+			std::swap(begin, end);
+		benchmark::DoNotOptimize(f.sample.sumRange(begin, end));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// Finds the key at a given running total, as when choosing where to split a shard
+static void bench_indexed_set_index(benchmark::State& state) {
+	ByteSampleFixture f(state.range(0));
+	const int64_t total = f.sample.sumTo(f.sample.end());
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(f.sample.index(deterministicRandom()->randomInt64(0, total)));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK(bench_indexed_set_insert_erase)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->ReportAggregatesOnly(true);
+BENCHMARK(bench_indexed_set_find)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->ReportAggregatesOnly(true);
+BENCHMARK(bench_indexed_set_sum_range)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->ReportAggregatesOnly(true);
+BENCHMARK(bench_indexed_set_index)->RangeMultiplier(16)->Range(1 << 10, 1 << 18)->ReportAggregatesOnly(true);
@@ -0,0 +1,104 @@
+/*
+ * BenchKeyRangeMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/KeyRangeMap.h"
+#include "flowbench/GlobalData.h"
+
+namespace {
+
+// A map with a distinct value for each range between consecutive keys, as the storage server keeps for its shards
+// and the versions they became available at
+template <class Map>
+struct KeyRangeMapFixture {
+	Standalone<VectorRef<KeyRef>> keys;
+	Map map;
+
+	explicit KeyRangeMapFixture(int size) : keys(getSortedTupleKeys(size)) {
+		for (int i = 0; i + 1 < keys.size(); i++)
+			map.insert(KeyRangeRef(keys[i], keys[i + 1]), i + 1);
+	}
+
+	int randomIndex() const { return deterministicRandom()->randomInt(0, keys.size() - 1); }
+};
+
+} // namespace
+
+// Reassigns a range, splitting the ranges at either end
+template <class Map>
+static void bench_key_range_map_insert(benchmark::State& state) {
+	KeyRangeMapFixture<Map> f(state.range(0));
+	for (auto _ : state) {
+		const int i = f.randomIndex();
+		const int j = std::min<int>(i + deterministicRandom()->randomInt(1, 4), f.keys.size() - 1);
+		Arena arena;
+		f.map.insert(KeyRangeRef(keyAfter(f.keys[i], arena), f.keys[j]), deterministicRandom()->randomInt(1, 1e6));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+template <class Map>
+static void bench_key_range_map_range_containing(benchmark::State& state) {
+	KeyRangeMapFixture<Map> f(state.range(0));
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(f.map.rangeContaining(f.keys[f.randomIndex()]).value());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// Visits the ranges a short read touches
+template <class Map>
+static void bench_key_range_map_intersecting_ranges(benchmark::State& state) {
+	KeyRangeMapFixture<Map> f(state.range(0));
+	const int length = 10;
+	for (auto _ : state) {
+		const int i = f.randomIndex();
+		const int j = std::min<int>(i + length, f.keys.size() - 1);
+		for (auto r : f.map.intersectingRanges(KeyRangeRef(f.keys[i], f.keys[j])))
+			benchmark::DoNotOptimize(r.value());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_key_range_map_insert, KeyRangeMap<int>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_key_range_map_insert, CoalescedKeyRangeMap<int>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_key_range_map_range_containing, KeyRangeMap<int>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_key_range_map_range_containing, CoalescedKeyRangeMap<int>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_key_range_map_intersecting_ranges, KeyRangeMap<int>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_key_range_map_intersecting_ranges, CoalescedKeyRangeMap<int>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
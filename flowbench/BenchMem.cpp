@@ -23,6 +23,8 @@
 
 #include "benchmark/benchmark.h"
 
+#include "flow/Arena.h"
+
 static void bench_memcmp(benchmark::State& state) {
 	constexpr int kLength = 10000;
 	std::unique_ptr<char[]> b1{ new char[kLength] };
@@ -47,5 +49,49 @@ static void bench_memcpy(benchmark::State& state) {
 	}
 }
 
+// Builds one arena per iteration out of state.range(0) allocations of 40 bytes, as for a small request or reply
+static void allocateArena(Arena& arena, int allocations) {
+	for (int i = 0; i < allocations; i++)
+		benchmark::DoNotOptimize(new (arena) uint8_t[40]);
+}
+
+static void bench_arena_churn(benchmark::State& state) {
+	for (auto _ : state) {
+		Arena arena;
+		allocateArena(arena, state.range(0));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+static void bench_arena_pool(benchmark::State& state) {
+	ArenaPool pool;
+	for (auto _ : state) {
+		Arena arena = pool.acquire();
+		allocateArena(arena, state.range(0));
+		pool.release(std::move(arena));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// An actor state or similar object of Size bytes, allocated and freed as for one request
+template <int Size>
+static void bench_fast_allocated(benchmark::State& state) {
+	struct Object : FastAllocated<Object> {
+		uint8_t data[Size];
+	};
+	for (auto _ : state) {
+		Object* o = new Object;
+		benchmark::DoNotOptimize(o);
+		delete o;
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
 BENCHMARK(bench_memcmp);
 BENCHMARK(bench_memcpy);
+BENCHMARK_TEMPLATE(bench_fast_allocated, 200);
+BENCHMARK_TEMPLATE(bench_fast_allocated, 400);
+BENCHMARK_TEMPLATE(bench_fast_allocated, 1500);
+BENCHMARK_TEMPLATE(bench_fast_allocated, 6000);
+BENCHMARK(bench_arena_churn)->RangeMultiplier(4)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
+BENCHMARK(bench_arena_pool)->RangeMultiplier(4)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
@@ -0,0 +1,100 @@
+/*
+ * BenchMessageSerialization.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/CommitTransaction.h"
+#include "fdbclient/StorageServerInterface.h"
+#include "flow/ObjectSerializer.h"
+#include "flowbench/GlobalData.h"
+
+// Serializes and deserializes the hottest RPC payloads. The requests themselves carry a ReplyPromise, which needs
+// FlowTransport, so the commit benchmark serializes what a CommitTransactionRequest carries besides it.
+
+namespace {
+
+struct CommitTransactionMessage {
+	constexpr static FileIdentifier file_identifier = 9174046;
+	CommitTransactionRef transaction;
+	uint32_t flags = 0;
+	Optional<UID> debugID;
+	Arena arena;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, transaction, flags, debugID, arena);
+	}
+};
+
+template <class T>
+size_t roundTrip(const T& message, T& out) {
+	Standalone<StringRef> buffer = ObjectWriter::toValue(message, Unversioned());
+	ObjectReader reader(buffer.begin(), Unversioned());
+	reader.deserialize(out);
+	return buffer.size();
+}
+
+} // namespace
+
+static void bench_serialize_get_value_reply(benchmark::State& state) {
+	GetValueReply reply(Optional<Value>(Standalone<StringRef>(getKV(0, state.range(0)).value)), false);
+	GetValueReply out;
+	size_t size = 0;
+	for (auto _ : state) {
+		size = roundTrip(reply, out);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.counters.insert({ { "Size", size } });
+}
+
+static void bench_serialize_get_key_values_reply(benchmark::State& state) {
+	GetKeyValuesReply reply;
+	for (int i = 0; i < state.range(0); i++)
+		reply.data.push_back_deep(reply.arena, getKV(24, 100));
+	reply.more = true;
+	GetKeyValuesReply out;
+	size_t size = 0;
+	for (auto _ : state) {
+		size = roundTrip(reply, out);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.counters.insert({ { "Rows", state.range(0) }, { "Size", size } });
+}
+
+static void bench_serialize_commit_transaction(benchmark::State& state) {
+	CommitTransactionMessage message;
+	for (int i = 0; i < state.range(0); i++) {
+		KeyValueRef kv = getKV(24, 100);
+		message.transaction.set(message.arena, kv.key, kv.value);
+		message.transaction.read_conflict_ranges.push_back(message.arena, singleKeyRange(kv.key, message.arena));
+	}
+	message.transaction.read_snapshot = 100000;
+	CommitTransactionMessage out;
+	size_t size = 0;
+	for (auto _ : state) {
+		size = roundTrip(message, out);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.counters.insert({ { "Mutations", state.range(0) }, { "Size", size } });
+}
+
+BENCHMARK(bench_serialize_get_value_reply)->Range(1 << 4, 1 << 12)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_key_values_reply)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_commit_transaction)->Range(1, 1 << 10)->ReportAggregatesOnly(true);
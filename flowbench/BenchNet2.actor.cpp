@@ -24,6 +24,7 @@
 #include "flow/flow.h"
 #include "flow/DeterministicRandom.h"
 #include "flow/network.h"
+#include "flow/TaskQueue.h"
 #include "flow/ThreadHelper.actor.h"
 
 #include "flow/actorcompiler.h" // This must be the last #include.
@@ -63,6 +64,35 @@ static void bench_net2(benchmark::State& benchState) {
 
 BENCHMARK(bench_net2)->Range(1, 1 << 16)->ReportAggregatesOnly(true);
 
+// The run loop's ready queue on its own: state.range(0) tasks at a commit proxy's mix of priorities are added, then
+// run, per iteration
+static void bench_task_queue(benchmark::State& benchState) {
+	struct Task : TaskQueueNode {};
+	static const TaskPriority priorities[] = { TaskPriority::ReadSocket,       TaskPriority::ProxyCommit,
+		                                       TaskPriority::ProxyCommitBatcher, TaskPriority::ProxyResolverReply,
+		                                       TaskPriority::DefaultPromiseEndpoint, TaskPriority::DefaultOnMainThread,
+		                                       TaskPriority::DefaultYield,     TaskPriority::DefaultEndpoint };
+	const int taskCount = benchState.range(0);
+	TaskQueue<Task> queue;
+	std::vector<Task> tasks(taskCount);
+	std::vector<TaskPriority> taskPriorities;
+	DeterministicRandom rand(platform::getRandomSeed());
+	for (int i = 0; i < taskCount; i++)
+		taskPriorities.push_back(priorities[rand.randomInt(0, std::size(priorities))]);
+
+	for (auto _ : benchState) {
+		for (int i = 0; i < taskCount; i++)
+			queue.addReady(taskPriorities[i], &tasks[i]);
+		while (queue.hasReadyTask()) {
+			benchmark::DoNotOptimize(queue.getReadyTask());
+			queue.popReadyTask();
+		}
+	}
+	benchState.SetItemsProcessed(taskCount * static_cast<long>(benchState.iterations()));
+}
+
+BENCHMARK(bench_task_queue)->Range(1, 1 << 16)->ReportAggregatesOnly(true);
+
 static constexpr bool DELAY = false;
 static constexpr bool YIELD = true;
 
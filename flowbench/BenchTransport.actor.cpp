@@ -0,0 +1,295 @@
+/*
+ * BenchTransport.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbrpc/FlowTransport.h"
+#include "fdbrpc/WellKnownEndpoints.h"
+#include "fdbrpc/fdbrpc.h"
+#include "flow/MkCert.h"
+#include "flow/TLSConfig.actor.h"
+#include "flow/ThreadHelper.actor.h"
+#include "flowbench/BenchTransport.h"
+
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+extern char** environ;
+
+namespace {
+
+const char* SERVER_ENV = "FLOWBENCH_TRANSPORT_SERVER"; // <address pipe fd>,<lifetime pipe fd>,<1 for TLS>
+const char* CERT_ENV = "FLOWBENCH_TRANSPORT_CERT";
+const char* KEY_ENV = "FLOWBENCH_TRANSPORT_KEY";
+const char* CA_ENV = "FLOWBENCH_TRANSPORT_CA";
+
+constexpr int MAX_REPLY_BYTES = 1 << 20;
+
+struct EchoReply {
+	constexpr static FileIdentifier file_identifier = 3990321;
+	Arena arena;
+	StringRef payload;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, payload, arena);
+	}
+};
+
+struct EchoRequest {
+	constexpr static FileIdentifier file_identifier = 3990322;
+	Arena arena;
+	StringRef payload;
+	int replyBytes = 0;
+	ReplyPromise<EchoReply> reply;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, payload, replyBytes, reply, arena);
+	}
+};
+
+struct TLSCreds {
+	std::string certBytes;
+	std::string keyBytes;
+	std::string caBytes;
+};
+
+// The server's credentials, for passing on to it when it is started
+TLSCreds serverCreds;
+
+TLSCreds makeCreds(mkcert::ESide side) {
+	Arena arena;
+	auto chain = mkcert::makeCertChain(arena, 1, side);
+	return TLSCreds{ chain.front().certPem.toString(), chain.front().privateKeyPem.toString(), "" };
+}
+
+} // namespace
+
+ACTOR static Future<Void> echoServer(RequestStream<EchoRequest> echo) {
+	state std::string replyPayload(MAX_REPLY_BYTES, 'r');
+	loop {
+		EchoRequest req = waitNext(echo.getFuture());
+		EchoReply reply;
+		reply.payload = StringRef(replyPayload).substr(0, std::clamp(req.replyBytes, 0, MAX_REPLY_BYTES));
+		req.reply.send(reply);
+	}
+}
+
+bool isTransportBenchServer() {
+	return getenv(SERVER_ENV) != nullptr;
+}
+
+int runTransportBenchServer() {
+	int addressFd, lifetimeFd, tls;
+	if (sscanf(getenv(SERVER_ENV), "%d,%d,%d", &addressFd, &lifetimeFd, &tls) != 3) {
+		fprintf(stderr, "Malformed %s\n", SERVER_ENV);
+		return 1;
+	}
+
+	TLSConfig tlsConfig(TLSEndpointType::SERVER);
+	if (tls) {
+		tlsConfig.setCertificateBytes(getenv(CERT_ENV));
+		tlsConfig.setKeyBytes(getenv(KEY_ENV));
+		tlsConfig.setCABytes(getenv(CA_ENV));
+	}
+	g_network = newNet2(tlsConfig);
+	FlowTransport::createInstance(false, 1, WLTOKEN_RESERVED_COUNT);
+	NetworkAddress address = NetworkAddress::parse(tls ? "127.0.0.1:0:tls" : "127.0.0.1:0");
+	Future<Void> listener = FlowTransport::transport().bind(address, address);
+	RequestStream<EchoRequest> echo;
+	Future<Void> server = echoServer(echo);
+
+	// Binding to port 0 picks a free port, which the benchmarking process reads back
+	NetworkAddress listening = FlowTransport::transport().getLocalAddresses().address;
+	UID token = echo.getEndpoint().token;
+	if (::write(addressFd, &listening, sizeof(listening)) != sizeof(listening) ||
+	    ::write(addressFd, &token, sizeof(token)) != sizeof(token)) {
+		return 1;
+	}
+	::close(addressFd);
+
+	std::thread([]() { g_network->run(); }).detach();
+	// Nothing is ever written to the lifetime pipe, so this returns when the benchmarking process exits
+	char c;
+	while (::read(lifetimeFd, &c, 1) > 0) {
+	}
+	// The network thread is still running, and there is nothing to flush, so skip the destructors
+	::_exit(0);
+}
+
+void configureTransportBenchTLS() {
+	TLSCreds clientCreds = makeCreds(mkcert::ESide::Client);
+	serverCreds = makeCreds(mkcert::ESide::Server);
+	// Each side trusts the other's self-signed certificate
+	clientCreds.caBytes = serverCreds.certBytes;
+	serverCreds.caBytes = clientCreds.certBytes;
+	setNetworkOption(FDBNetworkOptions::TLS_CERT_BYTES, StringRef(clientCreds.certBytes));
+	setNetworkOption(FDBNetworkOptions::TLS_KEY_BYTES, StringRef(clientCreds.keyBytes));
+	setNetworkOption(FDBNetworkOptions::TLS_CA_BYTES, StringRef(clientCreds.caBytes));
+}
+
+// Starts the echo server for plain or TLS connections the first time it is needed, and returns its endpoint
+static Endpoint transportBenchServer(bool tls) {
+	static std::mutex mutex;
+	static std::map<bool, Endpoint> servers;
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = servers.find(tls);
+	if (it != servers.end()) {
+		return it->second;
+	}
+
+	// Both pipes are closed on exec, except for the ends the server is told to use
+	int addressPipe[2], lifetimePipe[2];
+	if (::pipe2(addressPipe, O_CLOEXEC) || ::pipe2(lifetimePipe, O_CLOEXEC)) {
+		throw std::runtime_error("pipe failed");
+	}
+	std::vector<std::string> serverEnv = {
+		format("%s=%d,%d,%d", SERVER_ENV, addressPipe[1], lifetimePipe[0], tls ? 1 : 0),
+		std::string(CERT_ENV) + "=" + serverCreds.certBytes,
+		std::string(KEY_ENV) + "=" + serverCreds.keyBytes,
+		std::string(CA_ENV) + "=" + serverCreds.caBytes,
+	};
+	std::vector<char*> envp;
+	for (char** e = environ; *e; e++) {
+		envp.push_back(*e);
+	}
+	for (auto& e : serverEnv) {
+		envp.push_back(e.data());
+	}
+	envp.push_back(nullptr);
+	char name[] = "flowbench";
+	char* argv[] = { name, nullptr };
+
+	// Only async-signal-safe calls are allowed between fork and exec, since this process has other threads
+	pid_t pid = fork();
+	if (pid == 0) {
+		fcntl(addressPipe[1], F_SETFD, 0);
+		fcntl(lifetimePipe[0], F_SETFD, 0);
+		execve("/proc/self/exe", argv, envp.data());
+		_exit(127);
+	}
+	::close(addressPipe[1]);
+	::close(lifetimePipe[0]);
+	if (pid < 0) {
+		throw std::runtime_error("fork failed");
+	}
+	// The write end of lifetimePipe stays open, and so the server running, until this process exits
+
+	Endpoint endpoint;
+	UID token;
+	bool ok = ::read(addressPipe[0], &endpoint.addresses.address, sizeof(NetworkAddress)) == sizeof(NetworkAddress) &&
+	          ::read(addressPipe[0], &token, sizeof(token)) == sizeof(token);
+	::close(addressPipe[0]);
+	if (!ok) {
+		throw std::runtime_error("transport benchmark server did not start");
+	}
+	endpoint.token = token;
+	servers[tls] = endpoint;
+	return endpoint;
+}
+
+ACTOR static Future<Void> timedEcho(RequestStream<EchoRequest> echo,
+                                    StringRef payload,
+                                    int replyBytes,
+                                    std::vector<double>* latencies) {
+	state double start = timer();
+	EchoRequest req;
+	req.payload = payload;
+	req.replyBytes = replyBytes;
+	EchoReply reply = wait(echo.getReply(req));
+	benchmark::DoNotOptimize(reply.payload.size());
+	latencies->push_back(timer() - start);
+	return Void();
+}
+
+static double percentile(std::vector<double>& samples, double p) {
+	if (samples.empty()) {
+		return 0;
+	}
+	auto it = samples.begin() + std::min<size_t>(samples.size() - 1, samples.size() * p);
+	std::nth_element(samples.begin(), it, samples.end());
+	return *it;
+}
+
+// Each iteration sends range(3) requests of range(1) bytes at once, over TLS if range(0) is set, and waits for their
+// replies of range(2) bytes. Latencies are for single RPCs, measured from the send to the reply.
+ACTOR static Future<Void> benchTransportActor(benchmark::State* benchState, Endpoint server) {
+	state RequestStream<EchoRequest> echo(server);
+	state std::string payload(benchState->range(1), 'q');
+	state int replyBytes = benchState->range(2);
+	state int concurrency = benchState->range(3);
+	state std::vector<double> latencies;
+
+	// Connect, and complete the TLS handshake, before timing anything
+	wait(timedEcho(echo, StringRef(payload), replyBytes, &latencies));
+	latencies.clear();
+
+	while (benchState->KeepRunning()) {
+		state std::vector<Future<Void>> rpcs;
+		for (int i = 0; i < concurrency; i++) {
+			rpcs.push_back(timedEcho(echo, StringRef(payload), replyBytes, &latencies));
+		}
+		wait(waitForAll(rpcs));
+	}
+	benchState->SetItemsProcessed(concurrency * static_cast<long>(benchState->iterations()));
+	benchState->SetBytesProcessed((payload.size() + replyBytes) * concurrency *
+	                              static_cast<long>(benchState->iterations()));
+	benchState->counters["p50_us"] = percentile(latencies, 0.5) * 1e6;
+	benchState->counters["p99_us"] = percentile(latencies, 0.99) * 1e6;
+	return Void();
+}
+
+static void bench_transport_rpc(benchmark::State& benchState) {
+	Endpoint server = transportBenchServer(benchState.range(0));
+	onMainThread([&benchState, server] { return benchTransportActor(&benchState, server); }).blockUntilReady();
+}
+
+// Request shapes: a point read (small request and reply), a commit (1KB request, small reply) and a range read
+// (small request, 80KB reply), one at a time and with many outstanding
+BENCHMARK(bench_transport_rpc)
+    ->ArgNames({ "tls", "request", "reply", "concurrency" })
+    ->Args({ false, 64, 64, 1 })
+    ->Args({ false, 64, 64, 64 })
+    ->Args({ false, 1024, 64, 1 })
+    ->Args({ false, 1024, 64, 64 })
+    ->Args({ false, 64, 80000, 1 })
+    ->Args({ false, 64, 80000, 16 })
+    ->Args({ true, 64, 64, 1 })
+    ->Args({ true, 64, 64, 64 })
+    ->Args({ true, 1024, 64, 1 })
+    ->Args({ true, 1024, 64, 64 })
+    ->Args({ true, 64, 80000, 1 })
+    ->Args({ true, 64, 80000, 16 })
+    ->UseRealTime()
+    ->ReportAggregatesOnly(true);
@@ -0,0 +1,120 @@
+/*
+ * BenchVersionedMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/VersionedBTreeMap.h"
+#include "fdbclient/VersionedMap.h"
+
+namespace {
+
+// The storage server's use: a few versions' worth of writes on top of a large map, with readers at older versions
+template <class Map>
+struct VersionedMapFixture {
+	Arena arena;
+	std::vector<KeyRef> keys;
+	Map map;
+
+	explicit VersionedMapFixture(int size) {
+		for (int i = 0; i < size; i++)
+			keys.push_back(KeyRef(arena, format("app/table/%08d/row", deterministicRandom()->randomInt(0, 1e8))));
+		map.createNewVersion(1);
+		for (const auto& k : keys)
+			map.insert(k, ValueOrClearToRef::value(k));
+	}
+
+	// Writes batch random keys in each of the next versions
+	void write(int versions, int batch) {
+		for (int v = 0; v < versions; v++) {
+			map.createNewVersion(map.getLatestVersion() + 1);
+			for (int i = 0; i < batch; i++) {
+				const KeyRef& k = keys[deterministicRandom()->randomInt(0, keys.size())];
+				map.insert(k, ValueOrClearToRef::value(k));
+			}
+		}
+	}
+};
+
+} // namespace
+
+template <class Map>
+static void bench_versioned_map_insert(benchmark::State& state) {
+	VersionedMapFixture<Map> f(state.range(0));
+	const int batch = 1000;
+	for (auto _ : state) {
+		f.write(1, batch);
+		f.map.forgetVersionsBefore(std::max<Version>(1, f.map.getLatestVersion() - 100));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * batch);
+}
+
+template <class Map>
+static void bench_versioned_map_lookup(benchmark::State& state) {
+	VersionedMapFixture<Map> f(state.range(0));
+	f.write(100, 100);
+	// Half the lookups are at the oldest retained version, as for reads at the start of the MVCC window
+	auto oldest = f.map.at(1);
+	auto latest = f.map.atLatest();
+	int i = 0;
+	for (auto _ : state) {
+		const KeyRef& k = f.keys[deterministicRandom()->randomInt(0, f.keys.size())];
+		benchmark::DoNotOptimize((i++ & 1) ? oldest.find(k) : latest.find(k));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+template <class Map>
+static void bench_versioned_map_scan(benchmark::State& state) {
+	VersionedMapFixture<Map> f(state.range(0));
+	f.write(100, 100);
+	auto view = f.map.atLatest();
+	const int length = 100;
+	for (auto _ : state) {
+		auto it = view.lower_bound(f.keys[deterministicRandom()->randomInt(0, f.keys.size())]);
+		for (int i = 0; i < length && it; i++, ++it)
+			benchmark::DoNotOptimize(it.key());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * length);
+}
+
+BENCHMARK_TEMPLATE(bench_versioned_map_insert, VersionedMap<KeyRef, ValueOrClearToRef>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_map_insert, VersionedBTreeMap<KeyRef, ValueOrClearToRef>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_map_lookup, VersionedMap<KeyRef, ValueOrClearToRef>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_map_lookup, VersionedBTreeMap<KeyRef, ValueOrClearToRef>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_map_scan, VersionedMap<KeyRef, ValueOrClearToRef>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_versioned_map_scan, VersionedBTreeMap<KeyRef, ValueOrClearToRef>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->ReportAggregatesOnly(true);
@@ -0,0 +1,80 @@
+/*
+ * BenchWriteMap.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/WriteMap.h"
+#include "flowbench/GlobalData.h"
+
+namespace {
+
+// A transaction's writes: mostly sets, some atomic adds and the occasional clear of a few rows
+void writeTransaction(WriteMap& writes, const Standalone<VectorRef<KeyRef>>& keys, int count) {
+	static const ValueRef value = "0123456789012345678901234567890123456789"_sr;
+	static const ValueRef one = "\x01\x00\x00\x00\x00\x00\x00\x00"_sr;
+	for (int i = 0; i < count; i++) {
+		const int k = deterministicRandom()->randomInt(0, keys.size() - 4);
+		const double r = deterministicRandom()->random01();
+		if (r < 0.8) {
+			writes.mutate(keys[k], MutationRef::SetValue, value, true);
+		} else if (r < 0.95) {
+			writes.mutate(keys[k], MutationRef::AddValue, one, true);
+		} else {
+			writes.clear(KeyRangeRef(keys[k], keys[k + deterministicRandom()->randomInt(1, 4)]), true);
+		}
+	}
+}
+
+} // namespace
+
+// Writes a transaction's worth of mutations into an empty map then walks it, as committing does
+static void bench_write_map_transaction(benchmark::State& state) {
+	const int count = state.range(0);
+	const Standalone<VectorRef<KeyRef>> keys = getSortedTupleKeys(1 << 16);
+	for (auto _ : state) {
+		Arena arena;
+		WriteMap writes(&arena);
+		writeTransaction(writes, keys, count);
+		WriteMap::iterator it(&writes);
+		for (it.skip(allKeys.begin); it.beginKey() < allKeys.end; ++it) {
+			if (it.is_operation())
+				benchmark::DoNotOptimize(it.op().size());
+		}
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()) * count);
+}
+
+// Reads fall through the map to find whether the transaction wrote the key, as read-your-writes does for every read
+static void bench_write_map_lookup(benchmark::State& state) {
+	const int count = state.range(0);
+	const Standalone<VectorRef<KeyRef>> keys = getSortedTupleKeys(1 << 16);
+	Arena arena;
+	WriteMap writes(&arena);
+	writeTransaction(writes, keys, count);
+	for (auto _ : state) {
+		WriteMap::iterator it(&writes);
+		it.skip(keys[deterministicRandom()->randomInt(0, keys.size())]);
+		benchmark::DoNotOptimize(it.type());
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK(bench_write_map_transaction)->RangeMultiplier(8)->Range(8, 1 << 12)->ReportAggregatesOnly(true);
+BENCHMARK(bench_write_map_lookup)->RangeMultiplier(8)->Range(8, 1 << 12)->ReportAggregatesOnly(true);
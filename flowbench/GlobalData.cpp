@@ -18,7 +18,10 @@
  * limitations under the License.
  */
 
+#include <set>
+
 #include "fdbclient/FDBTypes.h"
+#include "fdbclient/Tuple.h"
 #include "flow/IRandom.h"
 
 static constexpr size_t globalDataSize = 1 << 20;
@@ -42,3 +45,20 @@ KeyRef getKey(size_t keySize) {
 	ASSERT(keySize);
 	return KeyRef(globalData, keySize);
 }
+
+KeyRef getTupleKey(Arena& arena, int table, int64_t row) {
+	return KeyRef(arena, Tuple::makeTuple("app"_sr, table, "row"_sr, row).pack());
+}
+
+Standalone<VectorRef<KeyRef>> getSortedTupleKeys(int count) {
+	Standalone<VectorRef<KeyRef>> keys;
+	std::set<std::pair<int, int64_t>> rows;
+	while (rows.size() < count) {
+		rows.emplace(deterministicRandom()->randomInt(0, 8), deterministicRandom()->randomInt64(0, 1e12));
+	}
+	keys.reserve(keys.arena(), count);
+	for (const auto& [table, row] : rows) {
+		keys.push_back(keys.arena(), getTupleKey(keys.arena(), table, row));
+	}
+	return keys;
+}
@@ -22,6 +22,7 @@
 #include "fdbclient/NativeAPI.actor.h"
 #include "fdbclient/ThreadSafeTransaction.h"
 #include "flow/ThreadHelper.actor.h"
+#include "flowbench/BenchTransport.h"
 #include <thread>
 
 ACTOR template <class T>
@@ -37,10 +38,14 @@ Future<T> stopNetworkAfter(Future<T> what) {
 }
 
 int main(int argc, char** argv) {
+	if (isTransportBenchServer()) {
+		return runTransportBenchServer();
+	}
 	benchmark::Initialize(&argc, argv);
 	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
 		return 1;
 	}
+	configureTransportBenchTLS();
 	setupNetwork();
 	Promise<Void> benchmarksDone;
 	std::thread benchmarkThread([&]() {
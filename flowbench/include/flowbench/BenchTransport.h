@@ -0,0 +1,39 @@
+/*
+ * BenchTransport.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2024 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOWBENCH_BENCHTRANSPORT_H
+#define FLOWBENCH_BENCHTRANSPORT_H
+#pragma once
+
+// The FlowTransport benchmarks send RPCs over loopback to a second flowbench process, which runs an echo server on a
+// transport of its own. flowbench starts it on first use by running itself again with the server's settings in its
+// environment.
+
+// True in the echo server process
+bool isTransportBenchServer();
+
+// Runs the echo server until the benchmarking process exits, and returns the exit code of the server process
+int runTransportBenchServer();
+
+// Makes up TLS credentials for both processes and configures this one with its own. Must be called before the
+// network is set up.
+void configureTransportBenchTLS();
+
+#endif
@@ -28,6 +28,13 @@
 KeyValueRef getKV(size_t keySize, size_t valueSize);
 KeyRef getKey(size_t keySize);
 
+// A row key packed as the tuple ("app", table, "row", row), the way layers lay out their data, so that the keys of a
+// table share a prefix and order by row
+KeyRef getTupleKey(Arena& arena, int table, int64_t row);
+
+// count distinct tuple row keys spread over a few tables, in sorted order
+Standalone<VectorRef<KeyRef>> getSortedTupleKeys(int count);
+
 // Pre-generate a vector of T using a lambda then return them
 // via next() one by one with wrap-around
 template <typename T>
@@ -400,6 +400,25 @@ Future<Void> createTenant(Reference<DB> db,
 	return Void();
 }
 
+// Creates each of the tenants, running up to CLIENT_KNOBS->METACLUSTER_TENANT_BATCH_CONCURRENCY creations at a time
+ACTOR template <class DB>
+Future<Void> createTenants(Reference<DB> db,
+                           std::vector<MetaclusterTenantMapEntry> tenantEntries,
+                           AssignClusterAutomatically assignClusterAutomatically,
+                           IgnoreCapacityLimit ignoreCapacityLimit) {
+	std::vector<std::function<Future<Void>()>> creates;
+	for (auto const& tenantEntry : tenantEntries) {
+		creates.push_back([db = db,
+		                   tenantEntry,
+		                   assignClusterAutomatically = assignClusterAutomatically,
+		                   ignoreCapacityLimit = ignoreCapacityLimit]() {
+			return createTenant(db, tenantEntry, assignClusterAutomatically, ignoreCapacityLimit);
+		});
+	}
+	wait(internal::runConcurrently(creates, CLIENT_KNOBS->METACLUSTER_TENANT_BATCH_CONCURRENCY));
+	return Void();
+}
+
 } // namespace metacluster
 
 #include "flow/unactorcompiler.h"
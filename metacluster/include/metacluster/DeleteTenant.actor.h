@@ -213,6 +213,17 @@ Future<Void> deleteTenant(Reference<DB> db, int64_t id) {
 	return Void();
 }
 
+// Deletes each of the tenants, running up to CLIENT_KNOBS->METACLUSTER_TENANT_BATCH_CONCURRENCY deletions at a time
+ACTOR template <class DB>
+Future<Void> deleteTenants(Reference<DB> db, std::vector<TenantName> names) {
+	std::vector<std::function<Future<Void>()>> deletes;
+	for (auto const& name : names) {
+		deletes.push_back([db = db, name]() { return deleteTenant(db, name); });
+	}
+	wait(internal::runConcurrently(deletes, CLIENT_KNOBS->METACLUSTER_TENANT_BATCH_CONCURRENCY));
+	return Void();
+}
+
 } // namespace metacluster
 
 #include "flow/unactorcompiler.h"
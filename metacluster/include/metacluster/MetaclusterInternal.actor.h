@@ -34,6 +34,7 @@
 #include "flow/FastRef.h"
 #include "flow/IRandom.h"
 #include "flow/Platform.h"
+#include "flow/genericactors.actor.h"
 
 #include "metacluster/MetaclusterMetadata.h"
 #include "metacluster/MetaclusterTypes.h"
@@ -86,6 +87,27 @@ void updateClusterCapacityIndex(Transaction tr,
 	}
 }
 
+ACTOR template <class Operation>
+Future<Void> runWithLock(FlowLock* lock, Operation operation) {
+	wait(lock->take());
+	state FlowLock::Releaser releaser(*lock);
+	wait(operation());
+	return Void();
+}
+
+// Runs every operation, with at most concurrency of them in flight at a time. Throws the first error encountered,
+// cancelling the operations that have not finished.
+ACTOR template <class Operation>
+Future<Void> runConcurrently(std::vector<Operation> operations, int concurrency) {
+	state FlowLock lock(concurrency);
+	state std::vector<Future<Void>> running;
+	for (auto const& operation : operations) {
+		running.push_back(runWithLock(&lock, operation));
+	}
+	wait(waitForAll(running));
+	return Void();
+}
+
 } // namespace metacluster::internal
 
 #include "flow/unactorcompiler.h"
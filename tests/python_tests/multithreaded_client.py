@@ -20,6 +20,12 @@ parser.add_argument(
     default=3,
     help="Number of threads to use.  Zero implies local client",
 )
+parser.add_argument(
+    "--distribute-transactions",
+    default=False,
+    action="store_true",
+    help="Spread the transactions of each database over all of the threads",
+)
 parser.add_argument(
     "--build-dir",
     metavar="DIR",
@@ -46,6 +52,7 @@ import fdb
 # ../tests/loopback_cluster/run_cluster.sh . 3 '../tests/python_tests/multithreaded_client.py loopback-cluster-*/fdb.cluster --threads 1 --skip-so-files'
 # ../tests/loopback_cluster/run_cluster.sh . 3 '../tests/python_tests/multithreaded_client.py loopback-cluster-*/fdb.cluster --threads 0'
 # ../tests/loopback_cluster/run_cluster.sh . 3 '../tests/python_tests/multithreaded_client.py loopback-cluster-*/fdb.cluster --threads 0 --skip-so-files'
+# ../tests/loopback_cluster/run_cluster.sh . 3 '../tests/python_tests/multithreaded_client.py loopback-cluster-*/fdb.cluster --distribute-transactions'
 
 ## This fails (unsupported configuration):
 # ../tests/loopback_cluster/run_cluster.sh . 3 '../tests/python_tests/multithreaded_client.py loopback-cluster-*/fdb.cluster --threads 2 --skip-so-files'
@@ -65,6 +72,9 @@ if not args.skip_so_files:
 if args.threads > 0:
     fdb.options.set_client_threads_per_version(args.threads)
 
+if args.distribute_transactions:
+    fdb.options.set_client_threads_distribute_transactions()
+
 dbs = []
 for v in args.cluster_file:
     dbs.append(fdb.open(cluster_file=v))